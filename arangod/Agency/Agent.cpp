@@ -24,13 +24,17 @@
 #include "Agent.h"
 
 #include <velocypack/Iterator.h>
+#include <velocypack/Validator.h>
 #include <velocypack/velocypack-aliases.h>
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
 #include "Agency/GossipCallback.h"
+#include "Agency/SnapshotCallback.h"
 #include "Basics/ConditionLocker.h"
+#include "Basics/StringUtils.h"
 #include "RestServer/DatabaseFeature.h"
 #include "RestServer/QueryRegistryFeature.h"
 #include "VocBase/vocbase.h"
@@ -42,15 +46,29 @@ using namespace std::chrono;
 namespace arangodb {
 namespace consensus {
 
+/// Maximal number of packages of log entries sent to a follower, which it
+/// has not answered yet
+static size_t const maxAppendEntriesInFlight = 4;
+
+/// Size of the chunks, in which compaction snapshots are sent to followers
+static uint64_t const snapshotChunkSize = 1024 * 1024;
+
 /// Agent configuration
 Agent::Agent(config_t const& config)
   : Thread("Agent"),
     _config(config),
     _commitIndex(0),
     _lastApplied(0),
+    _readDBIndex(0),
+    _leaseExpiry(0),
     _spearhead(this),
     _readDB(this),
     _transient(this),
+    _snapshotIndex(0),
+    _snapshotTerm(0),
+    _stagedSnapshotIndex(0),
+    _stagedSnapshotTerm(0),
+    _stagedSnapshotTotal(0),
     _nextCompactionAfter(_config.compactionStepSize()),
     _activator(nullptr),
     _compactor(this),
@@ -229,7 +247,8 @@ AgentInterface::raft_commit_t Agent::waitFor(index_t index, double timeout) {
 }
 
 //  AgentCallback reports id of follower and its highest processed index
-void Agent::reportIn(std::string const& peerId, index_t index, size_t toLog) {
+void Agent::reportIn(std::string const& peerId, index_t index, size_t toLog,
+                     TimePoint const& sent) {
 
   auto startTime = system_clock::now();
 
@@ -246,12 +265,33 @@ void Agent::reportIn(std::string const& peerId, index_t index, size_t toLog) {
     }
     _lastAcked[peerId] = t;
 
+    // The lease is based on the time the acknowledged requests were sent,
+    // the followers received them later and refuse votes until the
+    // election timeout has passed after that
+    if (peerId != id() && sent > _lastAckedSent[peerId]) {
+      _lastAckedSent[peerId] = sent;
+      size_t const needed = size() / 2;  // not counting myself
+      if (needed > 0) {
+        std::vector<TimePoint> acked;
+        for (auto const& i : _config.active()) {
+          if (i != id()) {
+            acked.push_back(_lastAckedSent[i]);
+          }
+        }
+        _leaseExpiry =
+          leaseExpiry(std::move(acked), needed,
+                      0.9 * _config.minPing() * _config.timeoutMult())
+            .time_since_epoch().count();
+      }
+    }
+
+    if (toLog > 0 && _inFlight[peerId] > 0) { // package callback
+      LOG_TOPIC(TRACE, Logger::AGENCY) << "Got call back of " << toLog << " logs";
+      --_inFlight[peerId];
+    }
+
     if (index > _confirmed[peerId]) {  // progress this follower?
       _confirmed[peerId] = index;
-      if (toLog > 0) { // We want to reset the wait time only if a package callback
-        LOG_TOPIC(TRACE, Logger::AGENCY) << "Got call back of " << toLog << " logs";
-        _earliestPackage[peerId] = system_clock::now();
-      }
     }
 
     if (index > _commitIndex) {  // progress last commit?
@@ -274,6 +314,7 @@ void Agent::reportIn(std::string const& peerId, index_t index, size_t toLog) {
             _state.slices(
               _commitIndex + 1, index), _commitIndex, _constituent.term(),
               true /* inform others by callbacks */ );
+          _readDBIndex = index;
         }
 
         MUTEX_LOCKER(liLocker, _liLock);
@@ -297,6 +338,122 @@ void Agent::reportIn(std::string const& peerId, index_t index, size_t toLog) {
     CONDITION_LOCKER(guard, _waitForCV);
     guard.broadcast();
   }
+
+  if (toLog > 0 || (peerId == id() && index > 0 && size() > 1)) {
+    // Send the next package right away, if there is one
+    CONDITION_LOCKER(guard, _appendCV);
+    guard.broadcast();
+  }
+}
+
+// Leader may answer reads without confirming leadership during the lease
+bool Agent::hasReadLease() const {
+  if (size() == 1) {
+    return true;
+  }
+  return system_clock::now().time_since_epoch().count() < _leaseExpiry.load();
+}
+
+// End of a read lease from the send times acknowledged by the followers
+TimePoint Agent::leaseExpiry(std::vector<TimePoint> sent, size_t needed,
+                             double timeout) {
+  if (needed == 0 || sent.size() < needed) {
+    return TimePoint();
+  }
+  std::nth_element(sent.begin(), sent.begin() + (needed - 1), sent.end(),
+                   std::greater<TimePoint>());
+  if (sent[needed - 1] == TimePoint()) {
+    // not enough acknowledgements in this term yet
+    return TimePoint();
+  }
+  return sent[needed - 1] +
+    std::chrono::duration_cast<system_clock::duration>(
+      std::chrono::duration<double>(timeout));
+}
+
+//  AgentCallback reports a rejected or failed package to a follower
+void Agent::reportFailed(std::string const& peerId, size_t toLog) {
+
+  if (toLog == 0) {
+    return;
+  }
+
+  {
+    MUTEX_LOCKER(ioLocker, _ioLock);
+    // the follower may have lost a staged snapshot, it reports how much it
+    // still has with the next chunk
+    _snapshotStaged.erase(peerId);
+    if (_inFlight[peerId] > 0) {
+      --_inFlight[peerId];
+    }
+    _sentUpTo[peerId] = _confirmed[peerId];
+    // the packages sent after the failed one will probably be rejected as
+    // well. retry from the last confirmed index, but not right away
+    _earliestPackage[peerId] = system_clock::now() +
+      std::chrono::duration_cast<system_clock::duration>(
+        std::chrono::duration<double>(0.25 * _config.minPing()));
+  }
+
+  CONDITION_LOCKER(guard, _appendCV);
+  guard.broadcast();
+}
+
+//  SnapshotCallback reports a chunk of a snapshot staged by a follower
+void Agent::reportSnapshot(std::string const& peerId, index_t index,
+                           uint64_t staged, bool ok) {
+
+  {
+    MUTEX_LOCKER(ioLocker, _ioLock);
+    _snapshotInFlight[peerId] = false;
+    if (ok && index == _snapshotIndex) {
+      _snapshotStaged[peerId] = staged;
+    }
+  }
+
+  // Send the next chunk right away
+  if (ok) {
+    CONDITION_LOCKER(guard, _appendCV);
+    guard.broadcast();
+  }
+}
+
+/// Followers stage chunks of the leader's snapshot
+bool Agent::recvSnapshotChunkRPC(
+  term_t term, std::string const& leaderId, index_t index,
+  term_t snapshotTerm, uint64_t offset, uint64_t total,
+  std::string const& data, uint64_t& staged) {
+
+  if (term < _constituent.term()) {
+    LOG_TOPIC(DEBUG, Logger::AGENCY)
+      << "Not accepting snapshot chunk from " << leaderId << " in term "
+      << term;
+    return false;
+  }
+
+  MUTEX_LOCKER(ioLocker, _ioLock);
+
+  if (_stagedSnapshotIndex != index || _stagedSnapshotTerm != snapshotTerm ||
+      _stagedSnapshotTotal != total) {
+    // A different snapshot, start over
+    _stagedSnapshot.clear();
+    _stagedSnapshot.reserve(total);
+    _stagedSnapshotIndex = index;
+    _stagedSnapshotTerm = snapshotTerm;
+    _stagedSnapshotTotal = total;
+  }
+
+  // Chunks, which do not continue the staged bytes, are answered with the
+  // offset to resume from
+  if (offset == _stagedSnapshot.size() && offset + data.size() <= total) {
+    _stagedSnapshot.append(data);
+  }
+  staged = _stagedSnapshot.size();
+
+  LOG_TOPIC(DEBUG, Logger::AGENCY)
+    << "Staged " << staged << " of " << total << " bytes of snapshot "
+    << index << " from " << leaderId;
+
+  return true;
 }
 
 /// Followers' append entries
@@ -322,10 +479,12 @@ bool Agent::recvAppendEntriesRPC(
     return false;
   }
 
-  // Check whether we have got a snapshot in the first position:
+  // Check whether we have got a snapshot in the first position, either
+  // inline or staged before by installSnapshot:
   bool gotSnapshot = payload.length() > 0 &&
                      payload[0].isObject() &&
-                     !payload[0].get("readDB").isNone();
+                     (!payload[0].get("readDB").isNone() ||
+                      payload[0].get("staged").isTrue());
 
   // In case of a snapshot, there are three possibilities:
   //   1. Our highest log index is smaller than the snapshot index, in this 
@@ -368,12 +527,49 @@ bool Agent::recvAppendEntriesRPC(
       // Now we must completely erase our log and compaction snapshots and
       // start from the snapshot
       Store snapshot(this, "snapshot");
-      snapshot = payload[0].get("readDB");
+      if (payload[0].get("staged").isTrue()) {
+        std::string staged;
+        {
+          MUTEX_LOCKER(ioLocker, _ioLock);
+          if (_stagedSnapshotIndex == snapshotIndex &&
+              _stagedSnapshotTerm == snapshotTerm &&
+              _stagedSnapshot.size() == _stagedSnapshotTotal) {
+            staged.swap(_stagedSnapshot);
+            _stagedSnapshotIndex = 0;
+            _stagedSnapshotTerm = 0;
+            _stagedSnapshotTotal = 0;
+          }
+        }
+        if (staged.empty()) {
+          LOG_TOPIC(DEBUG, Logger::AGENCY)
+            << "Snapshot " << snapshotIndex << " is not staged completely.";
+          return false;
+        }
+        try {
+          VPackValidator validator;
+          uint8_t const* start =
+            reinterpret_cast<uint8_t const*>(staged.data());
+          validator.validate(start, staged.size());
+          snapshot = VPackSlice(start);
+        } catch (std::exception const& e) {
+          LOG_TOPIC(ERR, Logger::AGENCY)
+            << "Received invalid snapshot " << snapshotIndex << ": "
+            << e.what();
+          return false;
+        }
+      } else {
+        snapshot = payload[0].get("readDB");
+      }
       if (!_state.restoreLogFromSnapshot(snapshot, snapshotIndex, snapshotTerm)) {
         LOG_TOPIC(ERR, Logger::AGENCY)
           << "Could not restore received log snapshot.";
         return false;
       }
+      {
+        MUTEX_LOCKER(ioLocker, _ioLock);
+        _readDB = snapshot;
+        _readDBIndex = snapshotIndex;
+      }
       // Now the log is empty, but this will soon be rectified.
       { 
         MUTEX_LOCKER(liLocker, _liLock);
@@ -420,6 +616,15 @@ bool Agent::recvAppendEntriesRPC(
   {
     MUTEX_LOCKER(ioLocker, _ioLock);
     _commitIndex = std::min(leaderCommitIndex, _lastApplied);
+
+    // Keep the committed store current to answer reads marked stale ok
+    if (_commitIndex > _readDBIndex) {
+      MUTEX_LOCKER(mutexLocker, _compactionLock);
+      _readDB.applyLogEntries(
+        _state.slices(_readDBIndex + 1, _commitIndex), _commitIndex,
+        _constituent.term(), false /* do not perform callbacks */);
+      _readDBIndex = _commitIndex;
+    }
   }
   
   if (_commitIndex >= _nextCompactionAfter) {
@@ -429,6 +634,51 @@ bool Agent::recvAppendEntriesRPC(
   return ok;
 }
 
+/// Leader sends the next chunk of a snapshot to a follower
+void Agent::sendSnapshotChunk(
+  std::string const& followerId, term_t t,
+  std::shared_ptr<Builder> const& snapshot, index_t snapshotIndex,
+  term_t snapshotTerm, uint64_t offset) {
+
+  auto cc = ClusterComm::instance();
+  if (cc == nullptr) {
+    // nullptr only happens during controlled shutdown
+    return;
+  }
+
+  uint64_t const total = snapshot->size();
+  uint64_t const length = (std::min)(snapshotChunkSize, total - offset);
+
+  std::stringstream path;
+  path << "/_api/agency_priv/installSnapshot?term=" << t << "&leaderId="
+       << id() << "&index=" << snapshotIndex << "&snapshotTerm="
+       << snapshotTerm << "&offset=" << offset << "&total=" << total;
+
+  Builder builder;
+  { VPackObjectBuilder guard(&builder);
+    builder.add("data", VPackValue(basics::StringUtils::encodeBase64(
+      std::string(reinterpret_cast<char const*>(snapshot->data()) + offset,
+                  length)))); }
+
+  {
+    MUTEX_LOCKER(ioLocker, _ioLock);
+    _snapshotInFlight[followerId] = true;
+  }
+
+  LOG_TOPIC(DEBUG, Logger::AGENCY)
+    << "Sending " << length << " bytes at " << offset << " of " << total
+    << " of snapshot " << snapshotIndex << " to follower " << followerId;
+
+  auto headerFields =
+    std::make_unique<std::unordered_map<std::string, std::string>>();
+  cc->asyncRequest(
+    "1", 1, _config.poolAt(followerId),
+    arangodb::rest::RequestType::POST, path.str(),
+    std::make_shared<std::string>(builder.toJson()), headerFields,
+    std::make_shared<SnapshotCallback>(this, followerId, snapshotIndex),
+    (std::max)(10.0, _config.minPing() * _config.timeoutMult()), true);
+}
+
 /// Leader's append entries
 void Agent::sendAppendEntriesRPC() {
 
@@ -440,7 +690,7 @@ void Agent::sendAppendEntriesRPC() {
     return;
   }
 
-  // _lastSent, _lastHighest and _confirmed only accessed in main thread
+  // _lastSent and _lastHighest only accessed in main thread
   std::string const myid = id();
   
   for (auto const& followerId : _config.active()) {
@@ -449,13 +699,18 @@ void Agent::sendAppendEntriesRPC() {
 
       term_t t(0);
 
-      index_t lastConfirmed, commitIndex;
+      index_t lastConfirmed, commitIndex, sentUpTo;
+      size_t inFlight;
+      TimePoint earliestPackage;
       auto startTime = system_clock::now();
       {
         MUTEX_LOCKER(ioLocker, _ioLock);
         t = this->term();
         lastConfirmed = _confirmed[followerId];
         commitIndex = _commitIndex;
+        inFlight = _inFlight[followerId];
+        sentUpTo = _sentUpTo[followerId];
+        earliestPackage = _earliestPackage[followerId];
       }
       duration<double> lockTime = system_clock::now() - startTime;
       if (lockTime.count() > 0.1) {
@@ -483,12 +738,24 @@ void Agent::sendAppendEntriesRPC() {
       TRI_ASSERT(!unconfirmed.empty());
 
       index_t highest = unconfirmed.back().index;
+      index_t lowest = unconfirmed.front().index;
+
+      // Entries already on their way need not be sent again. Once nothing
+      // is in flight anymore, everything unconfirmed is sent again, which
+      // also repairs lost or rejected packages.
+      index_t base = lastConfirmed;
+      if (inFlight > 0 && sentUpTo > lastConfirmed && sentUpTo >= lowest) {
+        base = sentUpTo;
+      }
+      bool windowOpen = inFlight == 0 ||
+        (inFlight < maxAppendEntriesInFlight && lowest <= lastConfirmed);
+      bool sendEntries = windowOpen && highest > base &&
+        (system_clock::now() - earliestPackage).count() > 0;
 
       // _lastSent, _lastHighest: local and single threaded access
       duration<double> m = system_clock::now() - _lastSent[followerId];
 
-      if (highest == _lastHighest[followerId] &&
-          m.count() < 0.25 * _config.minPing()) {
+      if (!sendEntries && m.count() < 0.25 * _config.minPing()) {
         // I intentionally left here _config.minPing() without the
         // _config.timeoutMult(), if things are getting tight on the
         // system, we still send out empty heartbeats every 1/4 minpings,
@@ -504,37 +771,75 @@ void Agent::sendAppendEntriesRPC() {
           << timepointToString(_lastAcked[followerId])
           << " lastSent: " << timepointToString(_lastSent[followerId]);
       }
-      index_t lowest = unconfirmed.front().index;
 
       bool needSnapshot = false;
-      Store snapshot(this, "snapshot");
-      index_t snapshotIndex;
-      term_t snapshotTerm;
+      std::shared_ptr<Builder> snapshot;
+      index_t snapshotIndex = 0;
+      term_t snapshotTerm = 0;
       if (lowest > lastConfirmed) {
         // Ooops, compaction has thrown away so many log entries that
         // we cannot actually update the follower. We need to send our
-        // latest snapshot instead:
+        // latest snapshot instead. It is serialized once and staged on the
+        // follower in chunks, before appendEntries refers to it:
         needSnapshot = true;
-        bool success = false;
-        try {
-          success = _state.loadLastCompactedSnapshot(snapshot,
-              snapshotIndex, snapshotTerm);
-        } catch (std::exception const& e) {
-          LOG_TOPIC(WARN, Logger::AGENCY)
-            << "Exception thrown by loadLastCompactedSnapshot: "
-            << e.what();
-        }
-        if (!success) {
-          LOG_TOPIC(WARN, Logger::AGENCY)
-            << "Could not load last compacted snapshot, not sending appendEntriesRPC!";
-          continue;
+        if (_snapshot == nullptr || _snapshotIndex < lowest) {
+          Store store(this, "snapshot");
+          bool success = false;
+          try {
+            success = _state.loadLastCompactedSnapshot(store,
+                snapshotIndex, snapshotTerm);
+          } catch (std::exception const& e) {
+            LOG_TOPIC(WARN, Logger::AGENCY)
+              << "Exception thrown by loadLastCompactedSnapshot: "
+              << e.what();
+          }
+          if (!success) {
+            LOG_TOPIC(WARN, Logger::AGENCY)
+              << "Could not load last compacted snapshot, not sending appendEntriesRPC!";
+            continue;
+          }
+          auto serialized = std::make_shared<Builder>();
+          { VPackArrayBuilder guard(serialized.get());
+            store.dumpToBuilder(*serialized); }
+          MUTEX_LOCKER(ioLocker, _ioLock);
+          _snapshot = serialized;
+          _snapshotIndex = snapshotIndex;
+          _snapshotTerm = snapshotTerm;
+          _snapshotStaged.clear();
+          _snapshotInFlight.clear();
         }
+        snapshot = _snapshot;
+        snapshotIndex = _snapshotIndex;
+        snapshotTerm = _snapshotTerm;
         if (snapshotTerm == 0) {
           // No shapshot yet
           needSnapshot = false;
         }
       }
 
+      if (needSnapshot) {
+        uint64_t staged;
+        bool chunkInFlight;
+        {
+          MUTEX_LOCKER(ioLocker, _ioLock);
+          staged = _snapshotStaged[followerId];
+          chunkInFlight = _snapshotInFlight[followerId];
+        }
+        uint64_t const total = snapshot->size();
+        if (staged < total) {
+          if (!chunkInFlight) {
+            sendSnapshotChunk(followerId, t, snapshot, snapshotIndex,
+                              snapshotTerm, staged);
+          }
+          // Only heartbeats until the follower has staged everything
+          if (m.count() < 0.25 * _config.minPing()) {
+            continue;
+          }
+          needSnapshot = false;
+          sendEntries = false;
+        }
+      }
+
       // RPC path
       std::stringstream path;
       index_t prevLogIndex = unconfirmed.front().index;
@@ -542,6 +847,15 @@ void Agent::sendAppendEntriesRPC() {
       if (needSnapshot) {
         prevLogIndex = snapshotIndex;
         prevLogTerm = snapshotTerm;
+      } else if (sendEntries && base > lastConfirmed) {
+        // pipelined package, continues after the last one sent
+        for (auto const& entry : unconfirmed) {
+          if (entry.index == base) {
+            prevLogIndex = entry.index;
+            prevLogTerm = entry.term;
+            break;
+          }
+        }
       }
       path << "/_api/agency_priv/appendEntries?term=" << t << "&leaderId="
            << id() << "&prevLogIndex=" << prevLogIndex
@@ -552,21 +866,17 @@ void Agent::sendAppendEntriesRPC() {
       // Body
       Builder builder;
       builder.add(VPackValue(VPackValueType::Array));
-      if (
-          ((system_clock::now() - _earliestPackage[followerId]).count() > 0)) {
+      if (sendEntries) {
         if (needSnapshot) {
           { VPackObjectBuilder guard(&builder);
-            builder.add(VPackValue("readDB"));
-            { VPackArrayBuilder guard2(&builder);
-              snapshot.dumpToBuilder(builder);
-            }
+            builder.add("staged", VPackValue(true));
             builder.add("term", VPackValue(snapshotTerm));
             builder.add("index", VPackValue(snapshotIndex));
           }
         }
         for (size_t i = 0; i < unconfirmed.size(); ++i) {
           auto const& entry = unconfirmed.at(i);
-          if (entry.index > lastConfirmed) {
+          if (entry.index > base) {
             builder.add(VPackValue(VPackValueType::Object));
             builder.add("index", VPackValue(entry.index));
             builder.add("term", VPackValue(entry.term));
@@ -595,6 +905,11 @@ void Agent::sendAppendEntriesRPC() {
           << (needSnapshot ? " and a snapshot" : "")
           << " to follower " << followerId << ". Message: "
           << builder.toJson();
+
+        // counted before sending, the callback may come back right away
+        MUTEX_LOCKER(ioLocker, _ioLock);
+        ++_inFlight[followerId];
+        _sentUpTo[followerId] = highest;
       }
 
       // Send request
@@ -614,14 +929,10 @@ void Agent::sendAppendEntriesRPC() {
       _lastHighest[followerId]     = highest;
 
       if (toLog > 0) {
-        _earliestPackage[followerId] = system_clock::now() + toLog * dt;
         LOG_TOPIC(DEBUG, Logger::AGENCY)
-          << "Appending " << unconfirmed.size() - 1 << " entries up to index "
+          << "Appending " << toLog << " entries up to index "
           << highest << " to follower " << followerId << ". Message: "
-          << builder.toJson() 
-          << ". Next real log contact to " << followerId<< " in: " 
-          <<  std::chrono::duration<double, std::milli>(
-            _earliestPackage[followerId]-system_clock::now()).count() << "ms";
+          << builder.toJson() << ". Packages in flight: " << inFlight + 1;
       } else {
         LOG_TOPIC(TRACE, Logger::AGENCY)
           << "Just keeping follower " << followerId
@@ -673,6 +984,7 @@ query_t Agent::activate(query_t const& everything) {
         // no need to lock via _readDB._compactionLock here
         _readDB.applyLogEntries(batch, commitIndex, _constituent.term(),
                                 false  /* do not perform callbacks */);
+        _readDBIndex = commitIndex;
         _spearhead = _readDB;
       }
 
@@ -1042,10 +1354,17 @@ write_ret_t Agent::write(query_t const& query, bool discardStartup) {
 }
 
 /// Read from store
-read_ret_t Agent::read(query_t const& query) {
+read_ret_t Agent::read(query_t const& query, bool staleOk) {
 
   auto leader = _constituent.leaderID();
   if (leader != id()) {
+    if (staleOk && active()) {
+      // Committed data as far as the leader has told us, the store has
+      // its own lock
+      auto result = std::make_shared<arangodb::velocypack::Builder>();
+      std::vector<bool> success = _readDB.read(query, result);
+      return read_ret_t(true, leader, success, result);
+    }
     return read_ret_t(false, leader);
   }
 
@@ -1056,15 +1375,19 @@ read_ret_t Agent::read(query_t const& query) {
     }
   }
 
-  MUTEX_LOCKER(ioLocker, _ioLock);
-  // Only leader else redirect
-  if (challengeLeadership()) {
-    _constituent.candidate();
-    _preparing = false;
-    return read_ret_t(false, NO_LEADER);
+  // Within the lease, no other leader can have committed anything, so
+  // there is no need to take the write lock and check the followers
+  if (!hasReadLease()) {
+    MUTEX_LOCKER(ioLocker, _ioLock);
+    // Only leader else redirect
+    if (challengeLeadership()) {
+      _constituent.candidate();
+      _preparing = false;
+      return read_ret_t(false, NO_LEADER);
+    }
   }
 
-  // Retrieve data from readDB
+  // Retrieve data from readDB, the store has its own lock
   auto result = std::make_shared<arangodb::velocypack::Builder>();
   std::vector<bool> success = _readDB.read(query, result);
 
@@ -1269,6 +1592,13 @@ bool Agent::prepareLead() {
     for (auto const& i : _config.active()) {
       _lastAcked[i] = system_clock::now();
     }
+    // the lease needs acknowledgements from this term
+    _lastAckedSent.clear();
+    _leaseExpiry = 0;
+    _inFlight.clear();
+    _sentUpTo.clear();
+    _snapshotStaged.clear();
+    _snapshotInFlight.clear();
     _leaderSince = system_clock::now();
   }
   
@@ -1457,6 +1787,7 @@ arangodb::consensus::index_t Agent::rebuildDBs() {
     _readDB.applyLogEntries(logs, _commitIndex, _constituent.term(),
         false  /* do not send callbacks */);
   }
+  _readDBIndex = _commitIndex;
   _spearhead = _readDB;
 
   MUTEX_LOCKER(liLocker, _liLock);
@@ -1536,6 +1867,7 @@ Agent& Agent::operator=(VPackSlice const& compaction) {
   try {
     _commitIndex = arangodb::basics::StringUtils::uint64(
       compaction.get("_key").copyString());
+    _readDBIndex = _commitIndex;
     MUTEX_LOCKER(liLocker, _liLock);
     _lastApplied = _commitIndex;
   } catch (std::exception const& e) {
@@ -113,8 +113,9 @@ class Agent : public arangodb::Thread,
   ///        persisting the agency configuration
   write_ret_t write(query_t const&, bool discardStartup = false) override;
 
-  /// @brief Read from agency
-  read_ret_t read(query_t const&);
+  /// @brief Read from agency. If stale reads are ok, followers answer from
+  ///        their own committed key-value store
+  read_ret_t read(query_t const&, bool staleOk = false);
 
   /// @brief Inquire success of logs given clientIds
   inquire_ret_t inquire(query_t const&);
@@ -137,6 +138,15 @@ class Agent : public arangodb::Thread,
                             index_t prevIndex, term_t prevTerm,
                             index_t leaderCommitIndex, query_t const& queries);
 
+  /// @brief Received by followers to stage a chunk of the leader's
+  ///        compaction snapshot, which the next appendEntries refers to.
+  ///        `staged` is set to the number of bytes staged so far, from
+  ///        where the leader resumes.
+  bool recvSnapshotChunkRPC(term_t term, std::string const& leaderId,
+                            index_t index, term_t snapshotTerm,
+                            uint64_t offset, uint64_t total,
+                            std::string const& data, uint64_t& staged);
+
   /// @brief Invoked by leader to replicate log entries ($5.3);
   ///        also used as heartbeat ($5.2).
   void sendAppendEntriesRPC();
@@ -166,8 +176,27 @@ class Agent : public arangodb::Thread,
   /// @brief Start orderly shutdown of threads
   void beginShutdown() override final;
 
-  /// @brief Report appended entries from AgentCallback
-  void reportIn(std::string const&, index_t, size_t = 0);
+  /// @brief Report appended entries from AgentCallback, with the time the
+  /// acknowledged request was sent
+  void reportIn(std::string const&, index_t, size_t = 0,
+                TimePoint const& sent = TimePoint());
+
+  /// @brief Report a failed or rejected package from AgentCallback
+  void reportFailed(std::string const&, size_t);
+
+  /// @brief Report bytes of snapshot `index` staged by a follower from
+  ///        SnapshotCallback, failed chunks report no progress
+  void reportSnapshot(std::string const&, index_t, uint64_t staged, bool ok);
+
+  /// @brief Whether the read lease of the leader is valid
+  bool hasReadLease() const;
+
+  /// @brief End of a read lease, given the send times of the requests last
+  /// acknowledged by the followers. The lease lasts for the given fraction
+  /// of the election timeout after the needed-th latest send time, and is
+  /// the epoch if fewer followers have acknowledged anything
+  static TimePoint leaseExpiry(std::vector<TimePoint> sent, size_t needed,
+                               double timeout);
 
   /// @brief Wait for slaves to confirm appended entries
   AgentInterface::raft_commit_t waitFor(index_t last_entry, double timeout = 2.0) override;
@@ -269,6 +298,12 @@ class Agent : public arangodb::Thread,
   /// @brief Notify inactive pool members of changes in configuration
   void notifyInactive() const;
 
+  /// @brief Send chunk of a compaction snapshot at offset to a follower
+  void sendSnapshotChunk(std::string const& followerId, term_t t,
+                         std::shared_ptr<Builder> const& snapshot,
+                         index_t snapshotIndex, term_t snapshotTerm,
+                         uint64_t offset);
+
   /// @brief Activate this agent in single agent mode.
   bool activateAgency();
 
@@ -309,6 +344,17 @@ class Agent : public arangodb::Thread,
   /// to 0, increases monotonically)
   index_t _lastApplied;
 
+  /// @brief Index of highest log entry applied to _readDB. On followers, the
+  /// entries are applied once the leader reports them committed
+  index_t _readDBIndex;
+
+  /// @brief End of the leader's read lease, in system clock ticks. A
+  /// follower does not vote for another candidate within the election
+  /// timeout after it last heard from its leader (see Constituent::vote).
+  /// So during the lease no other leader can have been elected, since a
+  /// majority has received requests sent by the leader within the timeout.
+  std::atomic<int64_t> _leaseExpiry;
+
   /// @brief Spearhead (write) kv-store
   Store _spearhead;
 
@@ -330,8 +376,30 @@ class Agent : public arangodb::Thread,
 
   std::map<std::string, TimePoint> _lastAcked;
   std::map<std::string, TimePoint> _lastSent;
+  /// @brief Send time of the latest acknowledged request per follower
+  std::map<std::string, TimePoint> _lastAckedSent;
   std::map<std::string, TimePoint> _earliestPackage;
 
+  /// @brief Packages of entries sent to followers, but not yet answered,
+  /// and the highest index sent to them
+  std::map<std::string, size_t> _inFlight;
+  std::map<std::string, index_t> _sentUpTo;
+
+  /// @brief Last compaction snapshot, serialized once for followers, which
+  /// are behind the log. Bytes of it staged by followers and whether a chunk
+  /// is on its way to them
+  std::shared_ptr<Builder> _snapshot;
+  index_t _snapshotIndex;
+  term_t _snapshotTerm;
+  std::map<std::string, uint64_t> _snapshotStaged;
+  std::map<std::string, bool> _snapshotInFlight;
+
+  /// @brief Snapshot chunks received by a follower from its leader
+  std::string _stagedSnapshot;
+  index_t _stagedSnapshotIndex;
+  term_t _stagedSnapshotTerm;
+  uint64_t _stagedSnapshotTotal;
+
   /**< @brief RAFT consistency lock:
      _spearhead
      _read_db
@@ -339,6 +407,8 @@ class Agent : public arangodb::Thread,
      _lastAcked
      _confirmed
      _nextCompactionAfter
+     _snapshotIndex, _snapshotStaged, _snapshotInFlight
+     _stagedSnapshot*
    */
   mutable arangodb::Mutex _ioLock;
 
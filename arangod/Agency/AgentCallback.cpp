@@ -34,7 +34,7 @@ AgentCallback::AgentCallback() :
 AgentCallback::AgentCallback(Agent* agent, std::string const& slaveID,
                              index_t last, size_t toLog)
   : _agent(agent), _last(last), _slaveID(slaveID), _toLog(toLog),
-    _startTime(TRI_microtime())  {}
+    _startTime(TRI_microtime()), _sendTime(std::chrono::system_clock::now()) {}
 
 void AgentCallback::shutdown() { _agent = 0; }
 
@@ -45,6 +45,7 @@ bool AgentCallback::operator()(arangodb::ClusterCommResult* res) {
       if (!body->slice().get("success").isTrue()) {
         LOG_TOPIC(DEBUG, Logger::CLUSTER)
           << "Got negative answer from follower, will retry later.";
+        _agent->reportFailed(_slaveID, _toLog);
       } else {
         Slice senderTimeStamp = body->slice().get("senderTimeStamp");
         if (senderTimeStamp.isInteger()) {
@@ -65,7 +66,7 @@ bool AgentCallback::operator()(arangodb::ClusterCommResult* res) {
           
         LOG_TOPIC(DEBUG, Logger::CLUSTER)
           << body->slice().toJson();
-        _agent->reportIn(_slaveID, _last, _toLog);
+        _agent->reportIn(_slaveID, _last, _toLog, _sendTime);
       }
     }
     LOG_TOPIC(TRACE, Logger::AGENCY) 
@@ -75,6 +76,9 @@ bool AgentCallback::operator()(arangodb::ClusterCommResult* res) {
       << _slaveID << "), time("
       << TRI_microtime() - _startTime << ")";
   } else {
+    if (_agent) {
+      _agent->reportFailed(_slaveID, _toLog);
+    }
     LOG_TOPIC(WARN, Logger::AGENCY) 
       << "Got bad callback from AppendEntriesRPC: "
       << "comm_status(" << res->status
@@ -48,6 +48,7 @@ class AgentCallback : public arangodb::ClusterCommCallback {
   std::string _slaveID;
   size_t _toLog;
   double _startTime;
+  std::chrono::system_clock::time_point _sendTime;
 
 };
 }
@@ -381,6 +381,27 @@ bool Constituent::vote(term_t termOfPeer, std::string id, index_t prevLogIndex,
 
   MUTEX_LOCKER(guard, _castLock);
 
+  // Leader stickiness: while we have heard from our leader within the
+  // election timeout, refuse to vote and do not even adopt the term. The
+  // leader relies on this for its read lease, see Agent::hasReadLease
+  double const timeout =
+    _agent->config().minPing() * _agent->config().timeoutMult();
+  if (_role == LEADER) {
+    if (_agent->hasReadLease()) {
+      LOG_TOPIC(DEBUG, Logger::AGENCY)
+        << "not voting for " << id << " in term " << termOfPeer
+        << ", we are leading and our lease is valid";
+      return false;
+    }
+  } else if (_leaderID != NO_LEADER && _leaderID != id &&
+             leaderRecentlySeen(TRI_microtime(), _lastHeartbeatSeen,
+                                timeout)) {
+    LOG_TOPIC(DEBUG, Logger::AGENCY)
+      << "not voting for " << id << " in term " << termOfPeer
+      << ", we have heard from leader " << _leaderID << " recently";
+    return false;
+  }
+
   if (termOfPeer > _term) {
     termNoLock(termOfPeer);
 
@@ -430,6 +451,12 @@ bool Constituent::vote(term_t termOfPeer, std::string id, index_t prevLogIndex,
   return false;   // do not vote for this uninformed guy!
 }
 
+/// @brief Whether the leader was heard from within the election timeout
+bool Constituent::leaderRecentlySeen(double now, double lastHeartbeatSeen,
+                                     double timeout) {
+  return lastHeartbeatSeen > 0.0 && now - lastHeartbeatSeen < timeout;
+}
+
 /// @brief Call to election
 void Constituent::callElection() {
 
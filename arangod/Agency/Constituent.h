@@ -103,6 +103,11 @@ class Constituent : public Thread {
 
   friend class Agent;
 
+  // Whether a leader heard from at lastHeartbeatSeen is still alive for
+  // the purpose of voting, i.e. within the election timeout
+  static bool leaderRecentlySeen(double now, double lastHeartbeatSeen,
+                                 double timeout);
+
  private:
   // update leaderId and term if inactive
   void update(std::string const&, term_t);
@@ -31,42 +31,28 @@
 #include <velocypack/velocypack-aliases.h>
 
 #include <deque>
-#include <regex>
 
 using namespace arangodb::consensus;
 using namespace arangodb::basics;
 
-struct NotEmpty {
-  bool operator()(const std::string& s) { return !s.empty(); }
-};
-
-struct Empty {
-  bool operator()(const std::string& s) { return s.empty(); }
-};
-
-/// @brief Split strings by separator
+/// @brief Split strings by separator, runs of separators count as one and
+///        empty segments are dropped
 inline static std::vector<std::string> split(const std::string& str,
                                              char separator) {
 
   std::vector<std::string> result;
-  if (str.empty()) {
-    return result;
-  }
-  std::regex reg("/+");
-  std::string key = std::regex_replace(str, reg, "/");
-
-  if (!key.empty() && key.front() == '/') { key.erase(0,1); }
-  if (!key.empty() && key.back()  == '/') { key.pop_back(); }
-  
   std::string::size_type p = 0;
-  std::string::size_type q;
-  while ((q = key.find(separator, p)) != std::string::npos) {
-    result.emplace_back(key, p, q - p);
+  std::string::size_type const n = str.size();
+  while (p < n) {
+    std::string::size_type q = str.find(separator, p);
+    if (q == std::string::npos) {
+      q = n;
+    }
+    if (q > p) {
+      result.emplace_back(str, p, q - p);
+    }
     p = q + 1;
   }
-  result.emplace_back(key, p);
-  result.erase(std::find_if(result.rbegin(), result.rend(), NotEmpty()).base(),
-               result.end());
   return result;
 }
 
@@ -76,7 +62,8 @@ Node::Node(std::string const& name)
       _parent(nullptr),
       _store(nullptr),
       _vecBufDirty(true),
-      _isArray(false) {}
+      _isArray(false),
+      _cacheExpiry() {}
 
 /// Construct with node name in tree structure
 Node::Node(std::string const& name, Node* parent)
@@ -84,7 +71,8 @@ Node::Node(std::string const& name, Node* parent)
       _parent(parent),
       _store(nullptr),
       _vecBufDirty(true),
-      _isArray(false) {}
+      _isArray(false),
+      _cacheExpiry() {}
 
 /// Construct for store
 Node::Node(std::string const& name, Store* store)
@@ -92,7 +80,8 @@ Node::Node(std::string const& name, Store* store)
       _parent(nullptr),
       _store(store),
       _vecBufDirty(true),
-      _isArray(false) {}
+      _isArray(false),
+      _cacheExpiry() {}
 
 /// Default dtor
 Node::~Node() {}
@@ -156,7 +145,9 @@ Node::Node(Node&& other)
       _value(std::move(other._value)),
       _vecBuf(std::move(other._vecBuf)),
       _vecBufDirty(std::move(other._vecBufDirty)),
-      _isArray(std::move(other._isArray)) {
+      _isArray(std::move(other._isArray)),
+      _cache(std::move(other._cache)),
+      _cacheExpiry(std::move(other._cacheExpiry)) {
   // The _children map has been moved here, therefore we must
   // correct the _parent entry of all direct children:
   for (auto& child : _children) {
@@ -173,7 +164,9 @@ Node::Node(Node const& other)
       _value(other._value),
       _vecBuf(other._vecBuf),
       _vecBufDirty(other._vecBufDirty),
-      _isArray(other._isArray) {
+      _isArray(other._isArray),
+      _cache(other._cache),
+      _cacheExpiry(other._cacheExpiry) {
   for (auto const& p : other._children) {
     auto copy = std::make_shared<Node>(*p.second);
     copy->_parent = this;   // new children have us as _parent!
@@ -188,6 +181,7 @@ Node& Node::operator=(VPackSlice const& slice) {
   // 3. copy from rhs buffer to my buffer
   // Must not copy _parent, _ttl, _observers
   removeTimeToLive();
+  invalidateCache();
   _children.clear();
   _value.clear();
   if (slice.isArray()) {
@@ -213,6 +207,7 @@ Node& Node::operator=(Node&& rhs) {
   // 2. move children map over
   // 3. move value over
   // Must not move over rhs's _parent, _observers
+  invalidateCache();
   _nodeName = std::move(rhs._nodeName);
   _children = std::move(rhs._children);
   // The _children map has been moved here, therefore we must
@@ -225,6 +220,8 @@ Node& Node::operator=(Node&& rhs) {
   _vecBufDirty = std::move(rhs._vecBufDirty);
   _isArray = std::move(rhs._isArray);
   _ttl = std::move(rhs._ttl);
+  _cache = std::move(rhs._cache);
+  _cacheExpiry = std::move(rhs._cacheExpiry);
   return *this;
 }
 
@@ -235,6 +232,7 @@ Node& Node::operator=(Node const& rhs) {
   // 3. move from rhs to buffer pointer
   // Must not move rhs's _parent, _observers
   removeTimeToLive();
+  invalidateCache();
   _nodeName = rhs._nodeName;
   _children.clear();
   for (auto const& p : rhs._children) {
@@ -247,6 +245,8 @@ Node& Node::operator=(Node const& rhs) {
   _vecBufDirty = rhs._vecBufDirty;
   _isArray = rhs._isArray;
   _ttl = rhs._ttl;
+  _cache = rhs._cache;  // immutable once built, safe to share
+  _cacheExpiry = rhs._cacheExpiry;
   return *this;
 }
 
@@ -279,6 +279,7 @@ bool Node::removeChild(std::string const& key) {
   }
   found->second->removeTimeToLive();
   _children.erase(found);
+  invalidateCache();
   return true;
 }
 
@@ -287,38 +288,34 @@ NodeType Node::type() const { return _children.size() ? NODE : LEAF; }
 
 /// lh-value at path vector
 Node& Node::operator()(std::vector<std::string> const& pv) {
-  if (!pv.empty()) {
-    std::string const& key = pv.front();
-    if (_children.find(key) == _children.end()) {
-      _children[key] = std::make_shared<Node>(key, this);
+  Node* cur = this;
+  for (auto const& key : pv) {
+    auto it = cur->_children.find(key);
+    if (it == cur->_children.end()) {
+      cur->invalidateCache();
+      it = cur->_children.emplace(
+        key, std::make_shared<Node>(key, cur)).first;
     }
-    auto pvc(pv);
-    pvc.erase(pvc.begin());
-    TRI_ASSERT(_children[key]->_parent == this);
-    return (*_children[key])(pvc);
-  } else {
-    return *this;
+    TRI_ASSERT(it->second->_parent == cur);
+    cur = it->second.get();
   }
+  return *cur;
 }
 
 // rh-value at path vector
 Node const& Node::operator()(std::vector<std::string> const& pv) const {
-  if (!pv.empty()) {
-    auto const& key = pv.front();
-    auto const it = _children.find(key);
-    if (it == _children.end() ||
+  Node const* cur = this;
+  for (auto const& key : pv) {
+    auto const it = cur->_children.find(key);
+    if (it == cur->_children.end() ||
         (it->second->_ttl != std::chrono::system_clock::time_point() &&
         it->second->_ttl < std::chrono::system_clock::now())) {
       throw StoreException(std::string("Node ") + key + " not found!");
     }
-    auto const& child = *_children.at(key);
-    TRI_ASSERT(child._parent == this);
-    auto pvc(pv);
-    pvc.erase(pvc.begin());
-    return child(pvc);
-  } else {
-    return *this;
+    TRI_ASSERT(it->second->_parent == cur);
+    cur = it->second.get();
   }
+  return *cur;
 }
 
 // lh-value at path
@@ -371,6 +368,7 @@ bool Node::addTimeToLive(long millis) {
       std::chrono::system_clock::now() + std::chrono::milliseconds(millis);
   store().timeTable().insert(std::pair<TimePoint, std::string>(tkey, uri()));
   _ttl = tkey;
+  invalidateCache();
   return true;
 }
 
@@ -379,6 +377,7 @@ bool Node::removeTimeToLive() {
   if (_ttl != std::chrono::system_clock::time_point()) {
     store().removeTTL(uri());
     _ttl = std::chrono::system_clock::time_point();
+    invalidateCache();
   }
   return true;
 }
@@ -675,6 +674,7 @@ bool Node::applieOp(VPackSlice const& slice) {
 
   if (oper == "delete") {
     if (_parent == nullptr) {  // root node
+      invalidateCache();
       _children.clear();
       _value.clear();
       return true;
@@ -701,6 +701,7 @@ bool Node::applieOp(VPackSlice const& slice) {
     handle<UNOBSERVE>(slice);
     if (_children.empty() && _value.empty()) {
       if (_parent == nullptr) {  // root node
+        invalidateCache();
         _children.clear();
         _value.clear();
         return true;
@@ -724,22 +725,17 @@ bool Node::applieOp(VPackSlice const& slice) {
 
 // Apply slice to this node
 bool Node::applies(VPackSlice const& slice) {
-  std::regex reg("/+");
 
   if (slice.isObject()) {
     if (slice.isEmptyObject()) {
       *this = slice;
     }
     for (auto const& i : VPackObjectIterator(slice)) {
-      std::string key = std::regex_replace(i.key.copyString(), reg, "/");
+      std::string key = i.key.copyString();
       if (key.find('/') != std::string::npos) {
         (*this)(key).applies(i.value);
       } else {
-        auto found = _children.find(key);
-        if (found == _children.end()) {
-          _children[key] = std::make_shared<Node>(key, this);
-        }
-        _children[key]->applies(i.value);
+        (*this)(std::vector<std::string>{key}).applies(i.value);
       }
     }
   } else {
@@ -749,20 +745,69 @@ bool Node::applies(VPackSlice const& slice) {
   return true;
 }
 
+// Earliest of two expiry times, default time point meaning no expiry
+static inline TimePoint earliest(TimePoint const& a, TimePoint const& b) {
+  if (a == TimePoint()) {
+    return b;
+  }
+  if (b == TimePoint()) {
+    return a;
+  }
+  return (std::min)(a, b);
+}
+
+bool Node::cacheValid(TimePoint const& now) const {
+  return _cache != nullptr &&
+    (_cacheExpiry == TimePoint() || _cacheExpiry >= now);
+}
+
+void Node::invalidateCache() {
+  for (Node* cur = this; cur != nullptr; cur = cur->_parent) {
+    cur->_cache.reset();
+  }
+}
+
+TimePoint Node::buildObject(Builder& builder, bool showHidden) const {
+  auto const now = std::chrono::system_clock::now();
+  TimePoint expiry;
+
+  VPackObjectBuilder guard(&builder);
+  for (auto const& child : _children) {
+    auto const& cptr = child.second;
+    if ((cptr->_ttl != TimePoint() && cptr->_ttl < now) ||
+        (child.first[0] == '.' && !showHidden )) {
+      continue;
+    }
+    expiry = earliest(expiry, cptr->_ttl);
+    builder.add(VPackValue(child.first));
+    if (cptr->type() == NODE) {
+      if (cptr->cacheValid(now)) {
+        builder.add(Slice(cptr->_cache->data()));
+        expiry = earliest(expiry, cptr->_cacheExpiry);
+      } else {
+        expiry = earliest(expiry, cptr->buildObject(builder, false));
+      }
+    } else if (!cptr->slice().isNone()) {
+      builder.add(cptr->slice());
+    }
+  }
+
+  return expiry;
+}
+
 void Node::toBuilder(Builder& builder, bool showHidden) const {
 
-  typedef std::chrono::system_clock clock;
   try {
     if (type() == NODE) {
-      VPackObjectBuilder guard(&builder);
-      for (auto const& child : _children) {
-        auto const& cptr = child.second;
-        if ((cptr->_ttl != clock::time_point() && cptr->_ttl < clock::now()) ||
-            (child.first[0] == '.' && !showHidden )) {
-          continue;
+      if (showHidden) {
+        buildObject(builder, true);
+      } else {
+        if (!cacheValid(std::chrono::system_clock::now())) {
+          Builder tmp;
+          _cacheExpiry = buildObject(tmp, false);
+          _cache = tmp.steal();
         }
-        builder.add(VPackValue(child.first));
-        cptr->toBuilder(builder);
+        builder.add(Slice(_cache->data()));
       }
     } else {
       if (!slice().isNone()) {
@@ -786,7 +831,10 @@ std::ostream& Node::print(std::ostream& o) const {
   return o;
 }
 
-Node::Children& Node::children() { return _children; }
+Node::Children& Node::children() {
+  invalidateCache();  // children may be modified through the reference
+  return _children;
+}
 
 Node::Children const& Node::children() const { return _children; }
 
@@ -920,6 +968,7 @@ Slice Node::getArray() const {
 
 
 void Node::clear() {
+  invalidateCache();
   _children.clear();
   _ttl = std::chrono::system_clock::time_point();
   _value.clear();
@@ -163,7 +163,8 @@ class Node {
   template <Operation Oper>
   bool handle(arangodb::velocypack::Slice const&);
 
-  /// @brief Create Builder representing this store
+  /// @brief Create Builder representing this store. Without hidden keys,
+  ///        the serialized subtree is kept until the next write below
   void toBuilder(Builder&, bool showHidden = false) const;
 
   /// @brief Create Builder representing this store
@@ -259,6 +260,16 @@ class Node {
 
   void rebuildVecBuf() const;
 
+  /// @brief Serialize children into an object, returns earliest expiry of
+  ///        any serialized node or a default time point if none expires
+  TimePoint buildObject(Builder&, bool showHidden) const;
+
+  /// @brief Is the serialized subtree still valid at given time
+  bool cacheValid(TimePoint const&) const;
+
+  /// @brief Drop serialized subtree of this node and all its parents
+  void invalidateCache();
+
   std::string _nodeName;  ///< @brief my name
   Node* _parent;           ///< @brief parent
   Store* _store;           ///< @brief Store
@@ -268,6 +279,8 @@ class Node {
   mutable Buffer<uint8_t> _vecBuf;
   mutable bool _vecBufDirty;
   bool _isArray;
+  mutable std::shared_ptr<Buffer<uint8_t>> _cache; ///< @brief serialized me
+  mutable TimePoint _cacheExpiry;  ///< @brief first ttl within _cache
 };
 
 inline std::ostream& operator<<(std::ostream& o, Node const& n) {
@@ -564,7 +564,12 @@ inline RestStatus RestAgencyHandler::handleRead() {
       return RestStatus::DONE;
     }
 
-    if (_agent->size() > 1 && _agent->leaderID() == NO_LEADER) {
+    // reads marked as stale ok may be answered by followers
+    bool found;
+    std::string const& staleOk = _request->value("stale", found);
+    bool const stale = found && StringUtils::boolean(staleOk);
+
+    if (_agent->size() > 1 && _agent->leaderID() == NO_LEADER && !stale) {
       Builder body;
       body.openObject();
       body.add("message", VPackValue("No leader"));
@@ -574,7 +579,7 @@ inline RestStatus RestAgencyHandler::handleRead() {
       return RestStatus::DONE;
     }
 
-    read_ret_t ret = _agent->read(query);
+    read_ret_t ret = _agent->read(query, stale);
 
     if (ret.accepted) {  // I am leading
       if (ret.success.size() == 1 && !ret.success.at(0)) {
@@ -41,6 +41,7 @@ class RestAgencyHandler : public RestBaseHandler {
   char const* name() const override final { return "RestAgencyHandler"; }
   bool isDirect() const override;
   bool needsOwnThread() const { return true; }
+  size_t queue() const override { return JobQueue::CLUSTER_QUEUE; }
   RestStatus execute() override;
 
  private:
@@ -30,6 +30,7 @@
 #include <velocypack/Builder.h>
 #include <velocypack/velocypack-aliases.h>
 
+#include "Basics/StringUtils.h"
 #include "Logger/Logger.h"
 #include "Rest/HttpRequest.h"
 #include "Rest/Version.h"
@@ -116,6 +117,31 @@ RestStatus RestAgencyPrivHandler::execute() {
         } else {
           return reportBadQuery();  // bad query
         }
+      } else if (suffixes[0] == "installSnapshot") {  // snapshot chunk
+        if (_request->requestType() != rest::RequestType::POST) {
+          return reportMethodNotAllowed();
+        }
+        term_t snapshotTerm;
+        arangodb::consensus::index_t index;
+        uint64_t offset, total;
+        if (readValue("term", term) && readValue("leaderId", id) &&
+            readValue("index", index) &&
+            readValue("snapshotTerm", snapshotTerm) &&
+            readValue("offset", offset) && readValue("total", total)) {
+          auto query = _request->toVelocyPackBuilderPtr();
+          VPackSlice data = query->slice().get("data");
+          if (!data.isString()) {
+            return reportBadQuery("expecting snapshot chunk in data");
+          }
+          uint64_t staged = 0;
+          bool ret = _agent->recvSnapshotChunkRPC(
+              term, id, index, snapshotTerm, offset, total,
+              basics::StringUtils::decodeBase64(data.copyString()), staged);
+          result.add("success", VPackValue(ret));
+          result.add("staged", VPackValue(staged));
+        } else {
+          return reportBadQuery();  // bad query
+        }
       } else if (suffixes[0] == "requestVote") {  // requestVote
         int64_t timeoutMult = 1;
         readValue("timeoutMult", timeoutMult);
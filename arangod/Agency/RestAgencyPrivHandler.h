@@ -68,6 +68,7 @@ class RestAgencyPrivHandler : public arangodb::RestBaseHandler {
   char const* name() const override final { return "RestAgencyPrivHandler"; }
   bool isDirect() const override;
   bool needsOwnThread() const { return true; }
+  size_t queue() const override { return JobQueue::CLUSTER_QUEUE; }
   RestStatus execute() override;
 
  private:
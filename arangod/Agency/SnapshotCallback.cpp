@@ -0,0 +1,54 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2016 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Kaveh Vahedipour
+////////////////////////////////////////////////////////////////////////////////
+
+#include "SnapshotCallback.h"
+
+#include "Agency/Agent.h"
+
+using namespace arangodb::consensus;
+using namespace arangodb::velocypack;
+
+SnapshotCallback::SnapshotCallback(Agent* agent, std::string const& followerId,
+                                   index_t index)
+  : _agent(agent), _followerId(followerId), _index(index) {}
+
+bool SnapshotCallback::operator()(arangodb::ClusterCommResult* res) {
+  if (res->status == CL_COMM_SENT) {
+    auto body = res->result->getBodyVelocyPack();
+    Slice staged = body->slice().get("staged");
+    if (body->slice().get("success").isTrue() && staged.isInteger()) {
+      _agent->reportSnapshot(
+        _followerId, _index, staged.getNumber<uint64_t>(), true);
+      return true;
+    }
+    LOG_TOPIC(DEBUG, Logger::AGENCY)
+      << "Follower " << _followerId << " did not accept chunk of snapshot "
+      << _index << ": " << body->slice().toJson();
+  } else {
+    LOG_TOPIC(WARN, Logger::AGENCY)
+      << "Got bad callback from installSnapshot: comm_status("
+      << res->status << "), follower(" << _followerId << ")";
+  }
+  _agent->reportSnapshot(_followerId, _index, 0, false);
+  return true;
+}
@@ -87,18 +87,33 @@ inline static std::string stringify(index_t index) {
 bool State::persist(index_t index, term_t term,
                     arangodb::velocypack::Slice const& entry,
                     std::string const& clientId) const {
+  auto buf = std::make_shared<Buffer<uint8_t>>();
+  buf->append((char const*)entry.begin(), entry.byteSize());
+  return persist(std::vector<log_t>{log_t(index, term, buf, clientId)});
+}
 
-  LOG_TOPIC(TRACE, Logger::AGENCY) << "persist index=" << index
-    << " term=" << term << " entry: " << entry.toJson();
+/// Persist entries, all of them in one transaction with a single sync
+bool State::persist(std::vector<log_t> const& entries) const {
 
+  if (entries.empty()) {
+    return true;
+  }
+
+  LOG_TOPIC(TRACE, Logger::AGENCY) << "persist indices="
+    << entries.front().index << "-" << entries.back().index;
+
+  std::string const now = timestamp();
   Builder body;
   {
-    VPackObjectBuilder b(&body);
-    body.add("_key", Value(stringify(index)));
-    body.add("term", Value(term));
-    body.add("request", entry);
-    body.add("clientId", Value(clientId));
-    body.add("timestamp", Value(timestamp()));
+    VPackArrayBuilder a(&body);
+    for (auto const& entry : entries) {
+      VPackObjectBuilder b(&body);
+      body.add("_key", Value(stringify(entry.index)));
+      body.add("term", Value(entry.term));
+      body.add("request", VPackSlice(entry.entry->data()));
+      body.add("clientId", Value(entry.clientId));
+      body.add("timestamp", Value(now));
+    }
   }
 
   TRI_ASSERT(_vocbase != nullptr);
@@ -107,7 +122,9 @@ bool State::persist(index_t index, term_t term,
   SingleCollectionTransaction trx(
     transactionContext, "log", AccessMode::Type::WRITE);
 
-  trx.addHint(transaction::Hints::Hint::SINGLE_OPERATION);
+  if (entries.size() == 1) {
+    trx.addHint(transaction::Hints::Hint::SINGLE_OPERATION);
+  }
   Result res = trx.begin();
   if (!res.ok()) {
     THROW_ARANGO_EXCEPTION(res);
@@ -122,12 +139,17 @@ bool State::persist(index_t index, term_t term,
     return false;
   }
 
+  if (result.successful() && !result.countErrorCodes.empty()) {
+    // with an array of documents, errors are reported per document
+    result.code = result.countErrorCodes.begin()->first;
+  }
   res = trx.finish(result.code);
 
-  LOG_TOPIC(TRACE, Logger::AGENCY) << "persist done index=" << index
-    << " term=" << term << " entry: " << entry.toJson() << " ok:" << res.ok();
+  LOG_TOPIC(TRACE, Logger::AGENCY) << "persist done indices="
+    << entries.front().index << "-" << entries.back().index
+    << " ok:" << res.ok();
 
-  return res.ok();
+  return res.ok() && result.code == TRI_ERROR_NO_ERROR;
 }
 
 
@@ -148,6 +170,10 @@ std::vector<index_t> State::log(
 
   TRI_ASSERT(slice.length() == applicable.size());
   MUTEX_LOCKER(mutexLocker, _logLock); 
+
+  // all applicable transactions go to disk together
+  std::vector<log_t> entries;
+  index_t next = _log.back().index + 1;
   
   for (auto const& i : VPackArrayIterator(slice)) {
 
@@ -160,11 +186,16 @@ std::vector<index_t> State::log(
     
     if (applicable[j]) {
       std::string clientId((i.length()==3) ? i[2].copyString() : "");
-      idx[j] = logNonBlocking(_log.back().index+1, i[0], term, clientId, true);
+      auto buf = std::make_shared<Buffer<uint8_t>>();
+      buf->append((char const*)i[0].begin(), i[0].byteSize());
+      entries.emplace_back(next, term, buf, clientId);
+      idx[j] = next++;
     }
     ++j;
   }
 
+  logNonBlocking(entries, true);
+
   return idx;
   
 }
@@ -182,13 +213,24 @@ index_t State::logNonBlocking(
   index_t idx, velocypack::Slice const& slice, term_t term,
   std::string const& clientId, bool leading) {
 
-  TRI_ASSERT(!_log.empty()); // log must not ever be empty
-
   auto buf = std::make_shared<Buffer<uint8_t>>();
   
   buf->append((char const*)slice.begin(), slice.byteSize());
+
+  return logNonBlocking(
+    std::vector<log_t>{log_t(idx, term, buf, clientId)}, leading);
+}
+
+/// Log transactions
+index_t State::logNonBlocking(std::vector<log_t> const& entries, bool leading) {
+
+  TRI_ASSERT(!_log.empty()); // log must not ever be empty
+
+  if (entries.empty()) {
+    return _log.back().index;
+  }
   
-  if (!persist(idx, term, slice, clientId)) {         // log to disk or die
+  if (!persist(entries)) {         // log to disk or die
     if (leading) {
       LOG_TOPIC(FATAL, Logger::AGENCY)
         << "RAFT leader fails to persist log entries!"
@@ -203,7 +245,9 @@ index_t State::logNonBlocking(
   }
 
   try {
-    _log.push_back(log_t(idx, term, buf, clientId));  // log to RAM or die
+    for (auto const& entry : entries) {
+      _log.push_back(entry);  // log to RAM or die
+    }
   } catch (std::bad_alloc const&) {
     if (leading) {
       LOG_TOPIC(FATAL, Logger::AGENCY)
@@ -220,8 +264,10 @@ index_t State::logNonBlocking(
 
   if (leading) {
     try {
-      _clientIdLookupTable.emplace(            // keep track of client or die
-        std::pair<std::string, index_t>(clientId, idx));
+      for (auto const& entry : entries) {   // keep track of client or die
+        _clientIdLookupTable.emplace(
+          std::pair<std::string, index_t>(entry.clientId, entry.index));
+      }
     } catch (...) {
       LOG_TOPIC(FATAL, Logger::AGENCY)
         << "RAFT leader fails to expand client lookup table!"
@@ -246,20 +292,22 @@ index_t State::log(query_t const& transactions, size_t ndups) {
   TRI_ASSERT(nqs > ndups);
 
   MUTEX_LOCKER(mutexLocker, _logLock);  // log entries must stay in order
-  std::string clientId;
 
+  // all received entries go to disk together
+  std::vector<log_t> entries;
+  entries.reserve(nqs - ndups);
   for (size_t i = ndups; i < nqs; ++i) {
     VPackSlice const& slice = slices[i];
-
-    // first to disk
-    if (logNonBlocking(
-          slice.get("index").getUInt(), slice.get("query"),
-          slice.get("term").getUInt(), slice.get("clientId").copyString())==0) {
-      break;
-    }
-
+    VPackSlice query = slice.get("query");
+    auto buf = std::make_shared<Buffer<uint8_t>>();
+    buf->append((char const*)query.begin(), query.byteSize());
+    entries.emplace_back(
+      slice.get("index").getUInt(), slice.get("term").getUInt(), buf,
+      slice.get("clientId").copyString());
   }
 
+  logNonBlocking(entries, false);
+
   return _log.empty() ? 0 : _log.back().index;
 }
 
@@ -598,12 +646,20 @@ bool State::loadPersisted() {
 /// `index` to 0 if there is no compacted snapshot.
 bool State::loadLastCompactedSnapshot(Store& store, index_t& index,
                                       term_t& term) {
+  size_t deltas;
+  return loadCompactedSnapshot(store, index, term, deltas);
+}
+
+/// Load last full compaction snapshot and apply later deltas
+bool State::loadCompactedSnapshot(Store& store, index_t& index,
+                                  term_t& term, size_t& deltas) {
   auto bindVars = std::make_shared<VPackBuilder>();
   bindVars->openObject();
   bindVars->close();
- 
+
   std::string const aql(
-      std::string("FOR c IN compact SORT c._key DESC LIMIT 1 RETURN c"));
+      std::string("FOR c IN compact FILTER c.readDB != null "
+                  "SORT c._key DESC LIMIT 1 RETURN c"));
   arangodb::aql::Query query(false, _vocbase, aql::QueryString(aql), bindVars,
                              nullptr, arangodb::aql::PART_MAIN);
 
@@ -614,25 +670,27 @@ bool State::loadLastCompactedSnapshot(Store& store, index_t& index,
   }
 
   VPackSlice result = queryResult.result->slice();
-  
+
+  // No full compaction snapshot yet, deltas start from the empty store
+  index = 0;
+  term = 0;
+  deltas = 0;
+  std::string key;
+
   if (result.isArray()) {
     if (result.length() == 1) {
       VPackSlice i = result[0];
       VPackSlice ii = i.resolveExternals();
       try {
         store = ii.get("readDB");
-        index = basics::StringUtils::uint64(ii.get("_key").copyString());
+        key = ii.get("_key").copyString();
+        index = basics::StringUtils::uint64(key);
         term = ii.get("term").getNumber<uint64_t>();
-        return true;
       } catch (std::exception const& e) {
         LOG_TOPIC(ERR, Logger::AGENCY) << e.what() << " " << __FILE__
                                        << __LINE__;
+        return false;
       }
-    } else if (result.length() == 0) {
-      // No compaction snapshot yet
-      index = 0;
-      term = 0;
-      return true;
     }
   } else {
     // We should never be here! Just die!
@@ -641,43 +699,81 @@ bool State::loadLastCompactedSnapshot(Store& store, index_t& index,
     FATAL_ERROR_EXIT();
   }
 
-  return false;
-}
-
-/// Load compaction collection
-bool State::loadCompacted() {
-  auto bindVars = std::make_shared<VPackBuilder>();
+  // Deltas persisted after the full snapshot, in order
+  bindVars = std::make_shared<VPackBuilder>();
   bindVars->openObject();
+  bindVars->add("key", VPackValue(key));
   bindVars->close();
 
-  std::string const aql(
-      std::string("FOR c IN compact SORT c._key DESC LIMIT 1 RETURN c"));
-  arangodb::aql::Query query(false, _vocbase, aql::QueryString(aql), bindVars,
-                             nullptr, arangodb::aql::PART_MAIN);
+  std::string const daql(
+      std::string("FOR c IN compact FILTER c._key > @key SORT c._key "
+                  "RETURN c"));
+  arangodb::aql::Query dquery(false, _vocbase, aql::QueryString(daql),
+                              bindVars, nullptr, arangodb::aql::PART_MAIN);
 
-  auto queryResult = query.execute(QueryRegistryFeature::QUERY_REGISTRY);
+  queryResult = dquery.execute(QueryRegistryFeature::QUERY_REGISTRY);
 
   if (queryResult.code != TRI_ERROR_NO_ERROR) {
     THROW_ARANGO_EXCEPTION_MESSAGE(queryResult.code, queryResult.details);
   }
 
-  VPackSlice result = queryResult.result->slice();
+  result = queryResult.result->slice();
 
-  if (result.isArray() && result.length()) {
-    MUTEX_LOCKER(logLock, _logLock);
+  if (result.isArray()) {
     for (auto const& i : VPackArrayIterator(result)) {
-      auto ii = i.resolveExternals();
-      buffer_t tmp = std::make_shared<arangodb::velocypack::Buffer<uint8_t>>();
-      (*_agent) = ii;
+      VPackSlice ii = i.resolveExternals();
       try {
-        _cur = basics::StringUtils::uint64(ii.get("_key").copyString());
+        if (ii.get("base").getNumber<uint64_t>() != index) {
+          LOG_TOPIC(ERR, Logger::AGENCY)
+            << "Compaction delta " << ii.get("_key").copyString()
+            << " does not continue compaction snapshot " << index;
+          return false;
+        }
+        std::vector<VPackSlice> logs;
+        for (auto const& entry : VPackArrayIterator(ii.get("log"))) {
+          logs.push_back(entry);
+        }
+        index = basics::StringUtils::uint64(ii.get("_key").copyString());
+        term = ii.get("term").getNumber<uint64_t>();
+        store.applyLogEntries(logs, index, term,
+                              false  /* do not perform callbacks */);
+        ++deltas;
       } catch (std::exception const& e) {
         LOG_TOPIC(ERR, Logger::AGENCY) << e.what() << " " << __FILE__
                                        << __LINE__;
+        return false;
       }
     }
   }
 
+  return true;
+}
+
+/// Load compaction collection
+bool State::loadCompacted() {
+  Store store(_agent, "snapshot");
+  index_t index;
+  term_t term;
+  if (!loadLastCompactedSnapshot(store, index, term)) {
+    return false;
+  }
+
+  if (index > 0) {
+    std::stringstream i_str;
+    i_str << std::setw(20) << std::setfill('0') << index;
+
+    Builder compaction;
+    { VPackObjectBuilder c(&compaction);
+      compaction.add(VPackValue("readDB"));
+      { VPackArrayBuilder a(&compaction);
+        store.dumpToBuilder(compaction); }
+      compaction.add("_key", VPackValue(i_str.str())); }
+
+    MUTEX_LOCKER(logLock, _logLock);
+    (*_agent) = compaction.slice();
+    _cur = index;
+  }
+
   // We can be sure that every compacted snapshot only contains index entries
   // that have been written and agreed upon by an absolute majority of agents.
   if (!_log.empty()) {
@@ -840,7 +936,8 @@ bool State::compact(index_t cind) {
   Store snapshot(_agent, "snapshot");
   index_t index;
   term_t term;
-  if (!loadLastCompactedSnapshot(snapshot, index, term)) {
+  size_t deltas;
+  if (!loadCompactedSnapshot(snapshot, index, term, deltas)) {
     return false;
   }
   if (index > cind) {
@@ -850,6 +947,25 @@ bool State::compact(index_t cind) {
     return false;
   } else if (index == cind) {
     return true;  // already have snapshot for this index
+  } else if (deltas < maxCompactionDeltas) {
+    // Only persist the log entries since the last compaction, the full
+    // store is written every maxCompactionDeltas compactions:
+    MUTEX_LOCKER(mutexLocker, _agent->_compactionLock);
+
+    Builder entries;
+    { VPackArrayBuilder e(&entries);
+      for (auto const& slice : slices(index + 1, cind)) {
+        entries.add(slice);
+      }}
+    log_t last = at(cind);
+
+    mutexLocker.unlock();
+
+    if (!persistCompactionDelta(cind, last.term, index, entries.slice())) {
+      LOG_TOPIC(ERR, Logger::AGENCY)
+        << "Could not persist compaction delta.";
+      return false;
+    }
   } else {  // now we know index < cind
     // Apply log entries to snapshot up to and including index cind:
     MUTEX_LOCKER(mutexLocker, _agent->_compactionLock);
@@ -925,7 +1041,8 @@ bool State::compactPersisted(index_t cind) {
   return true;
 }
 
-/// Remove outdated compaction snapshots
+/// Remove outdated compaction snapshots, but never the last full snapshot,
+/// which later deltas build on
 bool State::removeObsolete(index_t cind) {
   if (cind > 3 * _agent->config().compactionStepSize()) {
     auto bindVars = std::make_shared<VPackBuilder>();
@@ -936,8 +1053,11 @@ bool State::removeObsolete(index_t cind) {
     i_str << std::setw(20) << std::setfill('0')
           << -3 * _agent->config().compactionStepSize() + cind;
 
-    std::string const aql(std::string("FOR c IN compact FILTER c._key < \"") +
-                          i_str.str() + "\" REMOVE c IN compact");
+    std::string const aql(
+      std::string("LET full = FIRST(FOR f IN compact FILTER f.readDB != null "
+                  "SORT f._key DESC LIMIT 1 RETURN f._key) "
+                  "FOR c IN compact FILTER c._key < \"") +
+      i_str.str() + "\" && c._key < full REMOVE c IN compact");
 
     arangodb::aql::Query query(false, _vocbase, aql::QueryString(aql),
                                bindVars, nullptr, arangodb::aql::PART_MAIN);
@@ -1024,6 +1144,44 @@ bool State::persistCompactionSnapshot(index_t cind,
   return false;
 }
 
+/// Persist a compaction delta
+bool State::persistCompactionDelta(index_t cind,
+                                   arangodb::consensus::term_t term,
+                                   index_t base,
+                                   VPackSlice const& entries) {
+  if (checkCollection("compact")) {
+    std::stringstream i_str;
+    i_str << std::setw(20) << std::setfill('0') << cind;
+
+    Builder delta;
+    { VPackObjectBuilder d(&delta);
+      delta.add("log", entries);
+      delta.add("base", VPackValue(base));
+      delta.add("term", VPackValue(static_cast<double>(term)));
+      delta.add("_key", VPackValue(i_str.str())); }
+
+    TRI_ASSERT(_vocbase != nullptr);
+    auto transactionContext =
+        std::make_shared<transaction::StandaloneContext>(_vocbase);
+    SingleCollectionTransaction trx(
+      transactionContext, "compact", AccessMode::Type::WRITE);
+
+    Result res = trx.begin();
+
+    if (!res.ok()) {
+      THROW_ARANGO_EXCEPTION(res);
+    }
+
+    auto result = trx.insert("compact", delta.slice(), _options);
+    res = trx.finish(result.code);
+
+    return res.ok();
+  }
+
+  LOG_TOPIC(ERR, Logger::AGENCY) << "Failed to persist delta for compaction!";
+  return false;
+}
+
 /// @brief restoreLogFromSnapshot, needed in the follower, this erases the
 /// complete log and persists the given snapshot. After this operation, the
 /// log is empty and something ought to be appended to it rather quickly.
@@ -1036,6 +1194,19 @@ bool State::restoreLogFromSnapshot(Store& snapshot,
       << "Could not persist received log snapshot.";
     return false;
   }
+
+  // Younger compaction snapshots and deltas of our own are no longer valid
+  {
+    std::stringstream i_str;
+    i_str << std::setw(20) << std::setfill('0') << index;
+    std::string const aql(
+      std::string("FOR c IN compact FILTER c._key > \"") + i_str.str() +
+      "\" REMOVE c IN compact");
+    arangodb::aql::Query query(
+      false, _vocbase, aql::QueryString(aql), nullptr, nullptr,
+      arangodb::aql::PART_MAIN);
+    query.execute(_queryRegistry);
+  }
   // Now we need to completely erase our log, both persisted and volatile:
   LOG_TOPIC(DEBUG, Logger::AGENCY)
       << "Removing complete log because of new snapshot.";
@@ -150,8 +150,9 @@ class State {
 
   /// @brief load a compacted snapshot, returns true if successfull and false
   /// otherwise. In case of success store and index are modified. The store
-  /// is reset to the state after log index `index` has been applied. Sets
-  /// `index` to 0 if there is no compacted snapshot.
+  /// is reset to the state after log index `index` has been applied, i.e.
+  /// the last full snapshot with all later deltas. Sets `index` to 0 if
+  /// there is no compacted snapshot.
   bool loadLastCompactedSnapshot(Store& store, index_t& index, term_t& term);
 
   /// @brief Persist a compaction snapshot
@@ -172,11 +173,18 @@ class State {
   index_t logNonBlocking(
     index_t idx, velocypack::Slice const& slice, term_t term,
     std::string const& clientId = std::string(), bool leading = false);
+
+  /// @brief Log consecutive log entries with a single write to disk. Must be
+  /// guarded by caller.
+  index_t logNonBlocking(std::vector<log_t> const& entries, bool leading);
   
   /// @brief Save currentTerm, votedFor, log entries
   bool persist(index_t, term_t, arangodb::velocypack::Slice const&,
                std::string const&) const;
 
+  /// @brief Save log entries in one transaction
+  bool persist(std::vector<log_t> const& entries) const;
+
   bool saveCompacted();
 
   /// @brief Load collection from persistent store
@@ -209,6 +217,21 @@ class State {
   /// @brief Persist read database
   bool persistReadDB(arangodb::consensus::index_t cind);
 
+  /// @brief Load last compacted snapshot as above, also counts the deltas
+  /// applied on top of the last full snapshot
+  bool loadCompactedSnapshot(Store& store, index_t& index, term_t& term,
+                             size_t& deltas);
+
+  /// @brief Persist the log entries since the previous compaction snapshot
+  /// `base` instead of a full snapshot
+  bool persistCompactionDelta(arangodb::consensus::index_t cind,
+                              arangodb::consensus::term_t term,
+                              arangodb::consensus::index_t base,
+                              arangodb::velocypack::Slice const& entries);
+
+  /// @brief Number of deltas persisted between two full compaction snapshots
+  static constexpr size_t maxCompactionDeltas = 8;
+
   /// @brief Our agent
   Agent* _agent;
 
@@ -36,49 +36,109 @@
 #include <velocypack/Slice.h>
 #include <velocypack/velocypack-aliases.h>
 
+#include <algorithm>
 #include <ctime>
 #include <iomanip>
-#include <regex>
 
 using namespace arangodb::consensus;
 using namespace arangodb::basics;
 
-/// Non-Emptyness of string
-struct NotEmpty {
-  bool operator()(const std::string& s) { return !s.empty(); }
-};
+/// Seconds, for which notifications of observers are collected and
+/// coalesced before they are sent
+static double const notifyWindow = 0.01;
 
 /// Emptyness of string
 struct Empty {
   bool operator()(const std::string& s) { return s.empty(); }
 };
 
-/// @brief Split strings by separator
+/// @brief Split strings by separator, runs of separators count as one and
+///        empty segments are dropped
 inline static std::vector<std::string> split(const std::string& str,
                                              char separator) {
 
   std::vector<std::string> result;
-  if (str.empty()) {
-    return result;
-  }
-  std::regex reg("/+");
-  std::string key = std::regex_replace(str, reg, "/");
-
-  if (!key.empty() && key.front() == '/') { key.erase(0,1); }
-  if (!key.empty() && key.back()  == '/') { key.pop_back(); }
-  
   std::string::size_type p = 0;
-  std::string::size_type q;
-  while ((q = key.find(separator, p)) != std::string::npos) {
-    result.emplace_back(key, p, q - p);
+  std::string::size_type const n = str.size();
+  while (p < n) {
+    std::string::size_type q = str.find(separator, p);
+    if (q == std::string::npos) {
+      q = n;
+    }
+    if (q > p) {
+      result.emplace_back(str, p, q - p);
+    }
     p = q + 1;
   }
-  result.emplace_back(key, p);
-  result.erase(std::find_if(result.rbegin(), result.rend(), NotEmpty()).base(),
-               result.end());
   return result;
 }
 
+/// @brief Replace runs of slashes by a single one
+inline static std::string collapseSlashes(std::string const& str) {
+  std::string result;
+  result.reserve(str.size());
+  for (char c : str) {
+    if (c != '/' || result.empty() || result.back() != '/') {
+      result.push_back(c);
+    }
+  }
+  return result;
+}
+
+/// @brief Paths selected by a read query. Selected subtrees are marked
+///        complete, their ancestors are only walked
+struct ReadSelection {
+  ReadSelection() : complete(false) {}
+  bool complete;
+  std::map<std::string, std::unique_ptr<ReadSelection>> children;
+
+  /// @brief Select path, complete subtrees cover everything below them
+  void select(std::vector<std::string> const& pv, bool whole) {
+    ReadSelection* cur = this;
+    for (auto const& key : pv) {
+      if (cur->complete) {
+        return;
+      }
+      auto& child = cur->children[key];
+      if (child == nullptr) {
+        child.reset(new ReadSelection());
+      }
+      cur = child.get();
+    }
+    if (whole) {
+      cur->complete = true;
+      cur->children.clear();
+    }
+  }
+
+  /// @brief Serialize selection of node, hidden keys only on top level.
+  ///        Walked nodes, which are not complete, need not exist.
+  void toBuilder(Node const* node, Builder& builder, bool showHidden) const {
+    if (complete) {
+      TRI_ASSERT(node != nullptr);
+      node->toBuilder(builder, showHidden);
+    } else if (children.empty()) {
+      builder.add(arangodb::basics::VelocyPackHelper::EmptyObjectValue());
+    } else {
+      VPackObjectBuilder guard(&builder);
+      for (auto const& child : children) {
+        if (child.first[0] == '.' && !showHidden) {
+          continue;
+        }
+        Node const* sub = nullptr;
+        if (node != nullptr) {
+          auto const it = node->children().find(child.first);
+          if (it != node->children().end()) {
+            sub = it->second.get();
+          }
+        }
+        builder.add(VPackValue(child.first));
+        child.second->toBuilder(sub, builder, false);
+      }
+    }
+  }
+};
+
 /// Build endpoint from URL
 inline static bool endpointPathFromUrl(std::string const& url,
                                        std::string& endpoint,
@@ -114,7 +174,8 @@ inline static bool endpointPathFromUrl(std::string const& url,
 
 /// Ctor with name
 Store::Store(Agent* agent, std::string const& name)
-  : Thread(name), _agent(agent), _node(name, this) {}
+  : Thread(name), _agent(agent), _pendingTerm(0), _pendingIndex(0),
+    _changes(0), _journalStart(0), _node(name, this) {}
 
 /// Move constructor. note: this is not thread-safe!
 Store::Store(Store&& other)
@@ -123,6 +184,9 @@ Store::Store(Store&& other)
     _timeTable(std::move(other._timeTable)),
     _observerTable(std::move(other._observerTable)),
     _observedTable(std::move(other._observedTable)),
+    _journal(std::move(other._journal)),
+    _changes(other._changes),
+    _journalStart(other._journalStart),
     _node(std::move(other._node)) {}
 
 /// Copy assignment operator
@@ -134,6 +198,7 @@ Store& Store::operator=(Store const& rhs) {
     _observerTable = rhs._observerTable;
     _observedTable = rhs._observedTable;
     _node = rhs._node;
+    resetJournal();
   }
   return *this;
 }
@@ -147,6 +212,7 @@ Store& Store::operator=(Store&& rhs) {
     _observerTable = std::move(rhs._observerTable);
     _observedTable = std::move(rhs._observedTable);
     _node = std::move(rhs._node);
+    resetJournal();
   }
   return *this;
 }
@@ -317,51 +383,21 @@ std::vector<bool> Store::applyLogEntries(
       }
     }
     
-    // Sort by URLS to avoid multiple callbacks
-    std::vector<std::string> urls;
-    for (auto it = in.begin(), end = in.end(); it != end;
-         it = in.upper_bound(it->first)) {
-      urls.push_back(it->first);
-    }
-    
-    // Callback
-
-    for (auto const& url : urls) {
-      Builder body;  // host
-      { VPackObjectBuilder b(&body);
-        body.add("term", VPackValue(term));
-        body.add("index", VPackValue(index));
-        auto ret = in.equal_range(url);
-        std::string currentKey;
-        for (auto it = ret.first; it != ret.second; ++it) {
-          if (currentKey != it->second->key) {
-            if (!currentKey.empty()) {
-              body.close();
-            }
-            body.add(it->second->key, VPackValue(VPackValueType::Object));
-            currentKey = it->second->key;
-          }
-          body.add(VPackValue(it->second->modified));
-          { VPackObjectBuilder b(&body);
-            body.add("op", VPackValue(it->second->oper)); }
-        }
-        if (!currentKey.empty()) {
-          body.close();
-        }
+    // Coalesce with notifications, which are not yet sent, the store
+    // thread sends them once the window has passed
+    if (!in.empty()) {
+      MUTEX_LOCKER(notifyLocker, _notifyLock);
+      bool wasEmpty = _pendingNotify.empty();
+      for (auto const& i : in) {
+        _pendingNotify[i.first][i.second->key][i.second->modified] =
+          i.second->oper;
       }
-      
-      std::string endpoint, path;
-      if (endpointPathFromUrl(url, endpoint, path)) {
-        auto headerFields =
-          std::make_unique<std::unordered_map<std::string, std::string>>();
-        
-        arangodb::ClusterComm::instance()->asyncRequest(
-          "1", 1, endpoint, rest::RequestType::POST, path,
-          std::make_shared<std::string>(body.toString()), headerFields,
-          std::make_shared<StoreCallback>(path, body.toJson()), 1.0, true, 0.01);
-        
-      } else {
-        LOG_TOPIC(WARN, Logger::AGENCY) << "Malformed URL " << url;
+      _pendingTerm = term;
+      _pendingIndex = index;
+      if (wasEmpty) {
+        _pendingSince = std::chrono::steady_clock::now();
+        CONDITION_LOCKER(guard, _cv);
+        _cv.signal();
       }
     }
   }
@@ -536,26 +572,25 @@ bool Store::read(VPackSlice const& query, Builder& ret) const {
   auto cut = std::remove_if(query_strs.begin(), query_strs.end(), Empty());
   query_strs.erase(cut, query_strs.end());
 
-  // Create response tree
-  Node copy("copy");
+  // Select response tree, serialized directly from the store without
+  // copying the selected subtrees
+  ReadSelection selection;
   MUTEX_LOCKER(storeLocker, _storeLock); // Freeze KV-Store for read
   for (auto const path : query_strs) {
     std::vector<std::string> pv = split(path, '/');
     size_t e = _node.exists(pv).size();
     if (e == pv.size()) {  // existing
-      copy(pv) = _node(pv);
+      selection.select(pv, true);
     } else {  // non-existing
       for (size_t i = 0; i < pv.size() - e + 1; ++i) {
         pv.pop_back();
       }
-      if (copy(pv).type() == LEAF && copy(pv).slice().isNone()) {
-        copy(pv) = arangodb::basics::VelocyPackHelper::EmptyObjectValue();
-      }
+      selection.select(pv, false);
     }
   }
 
   // Into result builder
-  copy.toBuilder(ret, showHidden);
+  selection.toBuilder(&_node, ret, showHidden);
 
   return success;
 }
@@ -626,6 +661,97 @@ bool Store::start() {
 }
 
 /// Work ttls and callbacks
+/// Send notifications, whose coalescing window has passed. Callbacks of
+/// the cluster's AgencyCallbackRegistry on the same endpoint are sent in a
+/// single request
+void Store::sendNotifications() {
+
+  notify_map_t pending;
+  term_t term;
+  index_t index;
+  {
+    MUTEX_LOCKER(notifyLocker, _notifyLock);
+    if (_pendingNotify.empty() ||
+        std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - _pendingSince).count() <
+        notifyWindow) {
+      return;
+    }
+    pending.swap(_pendingNotify);
+    term = _pendingTerm;
+    index = _pendingIndex;
+  }
+
+  // Body of notifications of one url
+  auto toBuilder = [&](Builder& body,
+                       notify_map_t::mapped_type const& keys) {
+    VPackObjectBuilder b(&body);
+    body.add("term", VPackValue(term));
+    body.add("index", VPackValue(index));
+    for (auto const& key : keys) {
+      body.add(VPackValue(key.first));
+      VPackObjectBuilder k(&body);
+      for (auto const& modified : key.second) {
+        body.add(VPackValue(modified.first));
+        VPackObjectBuilder o(&body);
+        body.add("op", VPackValue(modified.second));
+      }
+    }
+  };
+
+  auto send = [](std::string const& endpoint, std::string const& path,
+                 Builder const& body) {
+    auto headerFields =
+      std::make_unique<std::unordered_map<std::string, std::string>>();
+    arangodb::ClusterComm::instance()->asyncRequest(
+      "1", 1, endpoint, rest::RequestType::POST, path,
+      std::make_shared<std::string>(body.toString()), headerFields,
+      std::make_shared<StoreCallback>(path, body.toJson()), 1.0, true, 0.01);
+  };
+
+  // Group registry callbacks by endpoint
+  std::string const callbacksPath("/_api/agency/agency-callbacks/");
+  std::map<std::string, std::vector<notify_map_t::const_iterator>> batches;
+
+  for (auto it = pending.cbegin(); it != pending.cend(); ++it) {
+    std::string endpoint, path;
+    if (!endpointPathFromUrl(it->first, endpoint, path)) {
+      LOG_TOPIC(WARN, Logger::AGENCY) << "Malformed URL " << it->first;
+      continue;
+    }
+    if (path.compare(0, callbacksPath.size(), callbacksPath) == 0 &&
+        path.size() > callbacksPath.size()) {
+      batches[endpoint].push_back(it);
+    } else {
+      Builder body;
+      toBuilder(body, it->second);
+      send(endpoint, path, body);
+    }
+  }
+
+  for (auto const& batch : batches) {
+    Builder body;
+    std::string path;
+    if (batch.second.size() == 1) {
+      std::string endpoint;
+      endpointPathFromUrl(batch.second.front()->first, endpoint, path);
+      toBuilder(body, batch.second.front()->second);
+    } else {
+      path = callbacksPath.substr(0, callbacksPath.size() - 1);
+      VPackObjectBuilder b(&body);
+      body.add(VPackValue("callbacks"));
+      VPackObjectBuilder c(&body);
+      for (auto const& it : batch.second) {
+        std::string endpoint, cbPath;
+        endpointPathFromUrl(it->first, endpoint, cbPath);
+        body.add(VPackValue(cbPath.substr(callbacksPath.size())));
+        toBuilder(body, it->second);
+      }
+    }
+    send(batch.first, path, body);
+  }
+}
+
 void Store::run() {
   while (!this->isStopping()) {  // Check timetable and remove overage entries
 
@@ -640,6 +766,23 @@ void Store::run() {
       }
     }
 
+    {  // any notifications waiting?
+      MUTEX_LOCKER(notifyLocker, _notifyLock);
+      if (!_pendingNotify.empty()) {
+        auto n = std::chrono::duration_cast<std::chrono::microseconds>(
+          _pendingSince + std::chrono::duration_cast<
+            std::chrono::steady_clock::duration>(
+              std::chrono::duration<double>(notifyWindow)) -
+          std::chrono::steady_clock::now());
+        if (n.count() <= 0) {
+          n = std::chrono::microseconds{1};
+        }
+        if (t == std::chrono::microseconds{0} || n < t) {
+          t = n;
+        }
+      }
+    }
+
     {
       CONDITION_LOCKER(guard, _cv);
       if (t != std::chrono::microseconds{0}) {
@@ -649,6 +792,8 @@ void Store::run() {
       }
     }
 
+    sendNotifications();
+
     toClear = clearExpired();
     if (_agent && _agent->leading()) {
       //_agent->write(toClear);
@@ -661,13 +806,12 @@ bool Store::applies(arangodb::velocypack::Slice const& transaction) {
   std::vector<std::string> keys;
   std::vector<std::string> abskeys;
   std::vector<size_t> idx;
-  std::regex reg("/+");
   size_t counter = 0;
 
   for (const auto& atom : VPackObjectIterator(transaction)) {
     std::string key(atom.key.copyString());
     keys.push_back(key);
-    key = std::regex_replace(key, reg, "/");
+    key = collapseSlashes(key);
     abskeys.push_back(((key[0] == '/') ? key : std::string("/") + key));
     idx.push_back(counter++);
   }
@@ -686,11 +830,46 @@ bool Store::applies(arangodb::velocypack::Slice const& transaction) {
     } else {
       _node(abskeys.at(i)).applies(value);
     }
+    journal(abskeys.at(i));
   }
 
   return true;
 }
 
+/// Record written key, guarded by caller
+void Store::journal(std::string const& key) {
+  _journal.emplace_back(++_changes, key);
+  if (_journal.size() > maxJournalSize) {
+    _journalStart = _journal.front().first;
+    _journal.pop_front();
+  }
+}
+
+/// Drop journal, guarded by caller
+void Store::resetJournal() {
+  _journal.clear();
+  _journalStart = ++_changes;
+}
+
+/// Keys written after change count since
+bool Store::changedKeys(
+  uint64_t& since, std::vector<std::string>& keys) const {
+  MUTEX_LOCKER(storeLocker, _storeLock);
+  bool complete = (since >= _journalStart);
+  if (complete) {
+    // Entries are in ascending order of their change count
+    auto it = std::upper_bound(
+      _journal.begin(), _journal.end(), since,
+      [](uint64_t s, std::pair<uint64_t, std::string> const& e) {
+        return s < e.first; });
+    for (; it != _journal.end(); ++it) {
+      keys.push_back(it->second);
+    }
+  }
+  since = _changes;
+  return complete;
+}
+
 
 // Clear my data
 void Store::clear() {
@@ -699,6 +878,7 @@ void Store::clear() {
   _observerTable.clear();
   _observedTable.clear();
   _node.clear();
+  resetJournal();
 }
 
 
@@ -709,6 +889,7 @@ Store& Store::operator=(VPackSlice const& slice) {
 
   MUTEX_LOCKER(storeLocker, _storeLock);
   _node.applies(slice[0]);
+  resetJournal();
 
   TRI_ASSERT(slice[1].isObject());
   for (auto const& entry : VPackObjectIterator(slice[1])) {
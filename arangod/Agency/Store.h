@@ -28,6 +28,8 @@
 #include "Basics/Thread.h"
 #include "Node.h"
 
+#include <deque>
+
 namespace arangodb {
 namespace consensus {
 
@@ -121,6 +123,11 @@ class Store : public arangodb::Thread {
   /// @brief Notify observers
   void notifyObservers() const;
 
+  /// @brief Keys written since change count `since`, which is advanced to
+  ///        the current count. False, if the journal no longer reaches back
+  ///        that far and everything must be considered changed
+  bool changedKeys(uint64_t& since, std::vector<std::string>& keys) const;
+
   /// @brief See how far the path matches anything in store
   size_t matchPath(std::vector<std::string> const& pv) const;
 
@@ -159,12 +166,21 @@ class Store : public arangodb::Thread {
   /// @brief Check precondition
   check_ret_t check(arangodb::velocypack::Slice const&, CheckMode = FIRST_FAIL) const;
 
+  /// @brief Record key written by a transaction, guarded by caller
+  void journal(std::string const& key);
+
+  /// @brief Drop journal, all readers must consider everything changed
+  void resetJournal();
+
   /// @brief Clear entries, whose time to live has expired
   query_t clearExpired() const;
 
   /// @brief Run thread
   void run() override final;
 
+  /// @brief Send coalesced notifications of observers, once due
+  void sendNotifications();
+
  private:
   /// @brief Condition variable guarding removal of expired entries
   mutable arangodb::basics::ConditionVariable _cv;
@@ -183,6 +199,27 @@ class Store : public arangodb::Thread {
   std::multimap<std::string, std::string> _observerTable;
   std::multimap<std::string, std::string> _observedTable;
 
+  /// @brief Observer url -> observed key -> modified key -> operation
+  typedef std::map<std::string, std::map<std::string,
+    std::map<std::string, std::string>>> notify_map_t;
+
+  /// @brief Notifications of observers, which are not yet sent, with the
+  /// term and index of the latest change and the time of the first
+  arangodb::Mutex _notifyLock;
+  notify_map_t _pendingNotify;
+  term_t _pendingTerm;
+  index_t _pendingIndex;
+  std::chrono::steady_clock::time_point _pendingSince;
+
+  /// @brief Recently written keys with their change count, covers the
+  ///        changes after _journalStart up to _changes (only used in root node)
+  std::deque<std::pair<uint64_t, std::string>> _journal;
+  uint64_t _changes;
+  uint64_t _journalStart;
+
+  /// @brief Maximum number of keys kept in journal
+  static constexpr size_t maxJournalSize = 16384;
+
   /// @brief Root node
   Node _node;
 };
@@ -31,6 +31,7 @@
 #include "Agency/FailedServer.h"
 #include "Agency/Job.h"
 #include "Agency/JobContext.h"
+#include "Agency/MoveShard.h"
 #include "Agency/RemoveFollower.h"
 #include "Agency/Store.h"
 #include "ApplicationFeatures/ApplicationServer.h"
@@ -55,6 +56,12 @@ Supervision::Supervision()
   _okThreshold(1.5),
   _jobId(0),
   _jobIdMax(0),
+  _rebalanceInterval(60.),
+  _lastRebalance(),
+  _changeCount(0),
+  _clusterChanged(true),
+  _fullScanInterval(30.),
+  _lastFullScan(),
   _selfShutdown(false),
   _upgraded(false) {}
 
@@ -73,6 +80,7 @@ static std::string const targetShortID = "/Target/MapUniqueToShortID/";
 static std::string const currentServersRegisteredPrefix =
   "/Current/ServersRegistered";
 static std::string const foxxmaster = "/Current/Foxxmaster";
+static std::string const rebalanceShardsPrefix = "/Target/RebalanceShards";
 
 
 void Supervision::upgradeOne(Builder& builder) {
@@ -455,15 +463,76 @@ std::vector<check_t> Supervision::checkCoordinators() {
   return ret;
 }
 
+// Note written key, guarded by callers
+void Supervision::noteChange(std::string const& key) {
+  // Writes to or above the agency prefix may touch anything
+  if (key.size() <= _agencyPrefix.size()) {
+    if (_agencyPrefix.compare(0, key.size(), key) == 0) {
+      _clusterChanged = true;
+    }
+    return;
+  }
+  if (key.compare(0, _agencyPrefix.size(), _agencyPrefix) != 0 ||
+      key[_agencyPrefix.size()] != '/') {
+    return;
+  }
+  std::string const rel = key.substr(_agencyPrefix.size());
+
+  // Heartbeats, server registrations and Current are read directly in
+  // each cycle, the evaluated parts only depend on Plan, Target and
+  // Supervision
+  if (rel.compare(0, 5, "/Sync") == 0 ||
+      rel.compare(0, 8, "/Current") == 0 ||
+      rel == "/Plan/Version" ||
+      rel.compare(0, 15, "/Plan/Databases") == 0 ||
+      rel.compare(0, 18, "/Plan/Coordinators") == 0) {
+    return;
+  }
+
+  if (rel.compare(0, planColPrefix.size(), planColPrefix) == 0) {
+    // Plan/Collections/<database>/<collection>/...
+    size_t const db = planColPrefix.size();
+    size_t const col = rel.find('/', db);
+    if (col != std::string::npos && col > db && col + 1 < rel.size()) {
+      size_t const end = rel.find('/', col + 1);
+      _dirtyCollections.emplace(rel.substr(
+        db, (end == std::string::npos ? rel.size() : end) - db));
+      return;
+    }
+  }
+
+  _clusterChanged = true;
+}
+
 // Update local agency snapshot, guarded by callers
 bool Supervision::updateSnapshot() {
 
   if (_agent == nullptr || this->isStopping()) {
     return false;
   }
-  
-  if (_agent->readDB().has(_agencyPrefix)) {
-    _snapshot = _agent->readDB().get(_agencyPrefix);
+
+  // Changes must be fetched before the copy, such that later ones are
+  // noted again in the next round
+  std::vector<std::string> changed;
+  bool known = _agent->readDB().changedKeys(_changeCount, changed);
+
+  auto now = std::chrono::steady_clock::now();
+  if (!known || _lastFullScan == std::chrono::steady_clock::time_point() ||
+      std::chrono::duration<double>(now - _lastFullScan).count() >=
+      _fullScanInterval) {
+    _lastFullScan = now;
+    _clusterChanged = true;
+  } else {
+    for (auto const& key : changed) {
+      noteChange(key);
+    }
+  }
+
+  // Unchanged snapshot needs no copy, the store is large
+  if (_clusterChanged || !changed.empty()) {
+    if (_agent->readDB().has(_agencyPrefix)) {
+      _snapshot = _agent->readDB().get(_agencyPrefix);
+    }
   }
   
   if (_agent->transient().has(_agencyPrefix)) {
@@ -550,6 +619,10 @@ void Supervision::run() {
           if (!handleJobs()) {
             break;
           }
+        } else {
+          // Whoever leads next, evaluates everything first
+          _clusterChanged = true;
+          _dirtyCollections.clear();
         }
       }
       _cv.wait(static_cast<uint64_t>(1000000 * _frequency));
@@ -624,10 +697,17 @@ void Supervision::handleShutdown() {
 bool Supervision::handleJobs() {
   // Do supervision
   
-  shrinkCluster();
+  // Jobs and rebalancing are driven by time as much as by changes
+  if (_clusterChanged || !_dirtyCollections.empty()) {
+    shrinkCluster();
+  }
+  rebalanceShards();
   enforceReplication();
   workJobs();
 
+  _clusterChanged = false;
+  _dirtyCollections.clear();
+
   return true;
 }
 
@@ -647,71 +727,94 @@ void Supervision::workJobs() {
 }
 
 
+// Guarded by caller
 void Supervision::enforceReplication() {
   auto const& plannedDBs = _snapshot(planColPrefix).children();
 
-  for (const auto& db_ : plannedDBs) { // Planned databases
-    auto const& db = *(db_.second);
-    for (const auto& col_ : db.children()) { // Planned collections
-      auto const& col = *(col_.second);
-      
-      size_t replicationFactor;
-      if (col.has("replicationFactor") && col("replicationFactor").isUInt()) {
-        replicationFactor = col("replicationFactor").getUInt();
-      } else {
-        LOG_TOPIC(DEBUG, Logger::SUPERVISION)
-          << "no replicationFactor entry in " << col.toJson();
-        continue;
+  if (_clusterChanged) {
+    for (const auto& db_ : plannedDBs) { // Planned databases
+      for (const auto& col_ : db_.second->children()) { // Planned collections
+        enforceReplication(db_.first, col_.first, *(col_.second));
       }
+    }
+    return;
+  }
 
-      // mop: satellites => distribute to every server
-      if (replicationFactor == 0) {
-        auto available = Job::availableServers(_snapshot);
-        replicationFactor = available.size();
-      }
-      
-      bool clone = col.has("distributeShardsLike");
+  for (auto const& dirty : _dirtyCollections) { // Changed collections
+    size_t const pos = dirty.find('/');
+    std::string const database = dirty.substr(0, pos);
+    std::string const collection = dirty.substr(pos + 1);
+    auto const db_ = plannedDBs.find(database);
+    if (db_ == plannedDBs.end()) {
+      continue;
+    }
+    auto const& cols = db_->second->children();
+    auto const col_ = cols.find(collection);
+    if (col_ != cols.end()) {
+      enforceReplication(database, collection, *(col_->second));
+    }
+  }
+}
 
-      if (!clone) {
-        for (auto const& shard_ : col("shards").children()) { // Pl shards
-          auto const& shard = *(shard_.second);
-          
-          size_t actualReplicationFactor = shard.slice().length();
-          if (actualReplicationFactor != replicationFactor) {
-            // Check that there is not yet an addFollower or removeFollower
-            // or moveShard job in ToDo for this shard:
-            auto const& todo = _snapshot(toDoPrefix).children();
-            bool found = false;
-            for (auto const& pair : todo) {
-              auto const& job = pair.second;
-              if (job->has("type") &&
-                  ((*job)("type").getString() == "addFollower" ||
-                   (*job)("type").getString() == "removeFollower" ||
-                   (*job)("type").getString() == "moveShard") &&
-                  job->has("shard") &&
-                  (*job)("shard").getString() == shard_.first) {
-                found = true;
-                LOG_TOPIC(DEBUG, Logger::SUPERVISION) << "already found "
-                  "addFollower or removeFollower job in ToDo, not scheduling "
-                  "again for shard " << shard_.first;
-                break;
-              }
-            }
-            // Check that shard is not locked:
-            if (_snapshot.has(blockedShardsPrefix + shard_.first)) {
-              found = true;
-            }
-            if (!found) {
-              if (actualReplicationFactor < replicationFactor) {
-                AddFollower(
-                  _snapshot, _agent, std::to_string(_jobId++), "supervision",
-                  db_.first, col_.first, shard_.first).run();
-              } else {
-                RemoveFollower(
-                  _snapshot, _agent, std::to_string(_jobId++), "supervision",
-                  db_.first, col_.first, shard_.first).run();
-              }
-            }
+// Guarded by caller
+void Supervision::enforceReplication(
+  std::string const& database, std::string const& collection, Node const& col) {
+
+  size_t replicationFactor;
+  if (col.has("replicationFactor") && col("replicationFactor").isUInt()) {
+    replicationFactor = col("replicationFactor").getUInt();
+  } else {
+    LOG_TOPIC(DEBUG, Logger::SUPERVISION)
+      << "no replicationFactor entry in " << col.toJson();
+    return;
+  }
+
+  // mop: satellites => distribute to every server
+  if (replicationFactor == 0) {
+    auto available = Job::availableServers(_snapshot);
+    replicationFactor = available.size();
+  }
+  
+  bool clone = col.has("distributeShardsLike");
+
+  if (!clone) {
+    for (auto const& shard_ : col("shards").children()) { // Pl shards
+      auto const& shard = *(shard_.second);
+      
+      size_t actualReplicationFactor = shard.slice().length();
+      if (actualReplicationFactor != replicationFactor) {
+        // Check that there is not yet an addFollower or removeFollower
+        // or moveShard job in ToDo for this shard:
+        auto const& todo = _snapshot(toDoPrefix).children();
+        bool found = false;
+        for (auto const& pair : todo) {
+          auto const& job = pair.second;
+          if (job->has("type") &&
+              ((*job)("type").getString() == "addFollower" ||
+               (*job)("type").getString() == "removeFollower" ||
+               (*job)("type").getString() == "moveShard") &&
+              job->has("shard") &&
+              (*job)("shard").getString() == shard_.first) {
+            found = true;
+            LOG_TOPIC(DEBUG, Logger::SUPERVISION) << "already found "
+              "addFollower or removeFollower job in ToDo, not scheduling "
+              "again for shard " << shard_.first;
+            break;
+          }
+        }
+        // Check that shard is not locked:
+        if (_snapshot.has(blockedShardsPrefix + shard_.first)) {
+          found = true;
+        }
+        if (!found) {
+          if (actualReplicationFactor < replicationFactor) {
+            AddFollower(
+              _snapshot, _agent, std::to_string(_jobId++), "supervision",
+              database, collection, shard_.first).run();
+          } else {
+            RemoveFollower(
+              _snapshot, _agent, std::to_string(_jobId++), "supervision",
+              database, collection, shard_.first).run();
           }
         }
       }
@@ -846,6 +949,167 @@ void Supervision::shrinkCluster() {
   }
 }
 
+// Rebalance shards if applicable, guarded by caller
+void Supervision::rebalanceShards() {
+
+  // Only if switched on in Target
+  if (!_snapshot.has(rebalanceShardsPrefix) ||
+      !_snapshot(rebalanceShardsPrefix).isBool() ||
+      !_snapshot(rebalanceShardsPrefix).getBool()) {
+    return;
+  }
+
+  auto const& todo = _snapshot(toDoPrefix).children();
+  auto const& pending = _snapshot(pendingPrefix).children();
+
+  if (!todo.empty() || !pending.empty()) { // This is low priority
+    return;
+  }
+
+  // At most one rebalancing job per interval
+  auto now = std::chrono::steady_clock::now();
+  if (_lastRebalance != std::chrono::steady_clock::time_point() &&
+      std::chrono::duration<double>(now - _lastRebalance).count() <
+      _rebalanceInterval) {
+    return;
+  }
+
+  // Healthy servers, which are not blocked by other jobs
+  std::unordered_map<std::string, size_t> leaders;
+  std::unordered_map<std::string, size_t> shards;
+  for (auto const& srv : Job::availableServers(_snapshot)) {
+    if (serverHealth(srv) == HEALTH_STATUS_GOOD &&
+        !_snapshot.has(blockedServersPrefix + srv)) {
+      leaders[srv] = 0;
+      shards[srv] = 0;
+    }
+  }
+
+  if (leaders.size() < 2) {
+    return;
+  }
+
+  struct Candidate {
+    std::string database;
+    std::string collection;
+    std::string shard;
+    std::vector<std::string> servers;
+  };
+  std::vector<Candidate> candidates;
+
+  // Count leaders and shards per server. Shards of clones and satellites
+  // count, but only shards of prototypes can be moved
+  for (auto const& db_ : _snapshot(planColPrefix).children()) {
+    for (auto const& col_ : db_.second->children()) {
+      auto const& col = *(col_.second);
+      if (!col.has("shards")) {
+        continue;
+      }
+      bool movable = !col.has("distributeShardsLike") &&
+        !(col.has("replicationFactor") && col("replicationFactor").isUInt() &&
+          col("replicationFactor").getUInt() == 0);
+
+      for (auto const& shard_ : col("shards").children()) {
+        VPackSlice servers = shard_.second->slice();
+        if (!servers.isArray() || servers.length() == 0) {
+          continue;
+        }
+        Candidate candidate;
+        for (auto const& srv : VPackArrayIterator(servers)) {
+          std::string s = srv.copyString();
+          auto it = shards.find(s);
+          if (it != shards.end()) {
+            ++(it->second);
+          }
+          candidate.servers.emplace_back(std::move(s));
+        }
+        auto it = leaders.find(candidate.servers[0]);
+        if (it != leaders.end()) {
+          ++(it->second);
+        }
+        if (movable && !_snapshot.has(blockedShardsPrefix + shard_.first)) {
+          candidate.database = db_.first;
+          candidate.collection = col_.first;
+          candidate.shard = shard_.first;
+          candidates.emplace_back(std::move(candidate));
+        }
+      }
+    }
+  }
+
+  // Servers with most and fewest entries of the given count
+  auto extremes = [](std::unordered_map<std::string, size_t> const& counts) {
+    auto minmax = std::minmax_element(
+      counts.begin(), counts.end(),
+      [](std::pair<std::string const, size_t> const& a,
+         std::pair<std::string const, size_t> const& b) {
+        return a.second < b.second ||
+          (a.second == b.second && a.first < b.first); });
+    return std::make_pair(minmax.second->first, minmax.first->first);
+  };
+
+  // Servers sorted by number of leaders, then number of shards
+  std::vector<std::string> targets;
+  for (auto const& it : leaders) {
+    targets.push_back(it.first);
+  }
+  std::sort(targets.begin(), targets.end(),
+            [&](std::string const& a, std::string const& b) {
+              if (leaders[a] != leaders[b]) {
+                return leaders[a] < leaders[b];
+              }
+              if (shards[a] != shards[b]) {
+                return shards[a] < shards[b];
+              }
+              return a < b; });
+
+  auto holds = [](Candidate const& c, std::string const& srv) {
+    return std::find(c.servers.begin(), c.servers.end(), srv) !=
+      c.servers.end();
+  };
+
+  auto schedule = [&](Candidate const& c, std::string const& from,
+                      std::string const& to, bool isLeader) {
+    LOG_TOPIC(INFO, Logger::SUPERVISION)
+      << "Rebalancing: moving " << (isLeader ? "leader" : "follower")
+      << " of shard " << c.shard << " from " << from << " to " << to;
+    MoveShard(_snapshot, _agent, std::to_string(_jobId++), "supervision",
+              c.database, c.collection, c.shard, from, to, isLeader).run();
+    _lastRebalance = now;
+  };
+
+  // First even out leaders, all writes go to the leader
+  auto leaderRange = extremes(leaders);
+  std::string const& from = leaderRange.first;
+  if (leaders[from] >= leaders[leaderRange.second] + 2) {
+    for (auto const& to : targets) {
+      if (leaders[to] + 2 > leaders[from]) {
+        break;
+      }
+      for (auto const& c : candidates) {
+        if (c.servers[0] == from && !holds(c, to)) {
+          schedule(c, from, to, true);
+          return;
+        }
+      }
+    }
+  }
+
+  // Then even out the number of shards, as a measure of disk usage
+  auto shardRange = extremes(shards);
+  std::string const& fullest = shardRange.first;
+  std::string const& emptiest = shardRange.second;
+  if (shards[fullest] >= shards[emptiest] + 2) {
+    for (auto const& c : candidates) {
+      if (c.servers[0] != fullest && holds(c, fullest) &&
+          !holds(c, emptiest)) {
+        schedule(c, fullest, emptiest, false);
+        return;
+      }
+    }
+  }
+}
+
 // Start thread
 bool Supervision::start() {
   Thread::start();
@@ -31,6 +31,7 @@
 #include "Basics/Thread.h"
 
 #include <chrono>
+#include <set>
 
 namespace arangodb {
 namespace consensus {
@@ -136,8 +137,16 @@ class Supervision : public arangodb::Thread {
   void missingPrototype();
 
   /// @brief Check for inconsistencies in replication factor vs dbs entries
+  ///        of changed collections, or of all after cluster wide changes
   void enforceReplication();
 
+  /// @brief Check replication factor vs dbs entries of one collection
+  void enforceReplication(std::string const& database,
+                          std::string const& collection, Node const& col);
+
+  /// @brief Note key written in agency since last snapshot
+  void noteChange(std::string const& key);
+
   /// @brief Move shard from one db server to other db server
   bool moveShard(std::string const& from, std::string const& to);
 
@@ -160,11 +169,14 @@ class Supervision : public arangodb::Thread {
   /// @brief Perform sanity checking
   bool doChecks();
 
-  /// @brief update my local agency snapshot
+  /// @brief update my local agency snapshot, if anything has changed
   bool updateSnapshot();
 
   void shrinkCluster();
 
+  /// @brief Even out leaders and shards across DB servers, if enabled
+  void rebalanceShards();
+
   bool isShuttingDown();
 
   bool handleJobs();
@@ -187,6 +199,25 @@ class Supervision : public arangodb::Thread {
   uint64_t _jobId;
   uint64_t _jobIdMax;
 
+  /// @brief Minimal number of seconds between two rebalancing jobs
+  double _rebalanceInterval;
+  std::chrono::steady_clock::time_point _lastRebalance;
+
+  /// @brief Change count of read store, up to which changes are noted
+  uint64_t _changeCount;
+
+  /// @brief Collections changed in plan since last evaluation, as
+  ///        "database/collection"
+  std::set<std::string> _dirtyCollections;
+
+  /// @brief Change outside of single collections, all need evaluation
+  bool _clusterChanged;
+
+  /// @brief Seconds between two evaluations of everything, regardless of
+  ///        noted changes
+  double _fullScanInterval;
+  std::chrono::steady_clock::time_point _lastFullScan;
+
   // mop: this feels very hacky...we have a hen and egg problem here
   // we are using /Shutdown in the agency to determine that the cluster should
   // shutdown. When every member is down we should of course not persist this
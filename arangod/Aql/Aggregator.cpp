@@ -50,6 +50,15 @@ std::unique_ptr<Aggregator> Aggregator::fromTypeString(transaction::Methods* trx
   if (type == "AVERAGE" || type == "AVG") {
     return std::make_unique<AggregatorAverage>(trx);
   }
+  if (type == "SUM_STEP2") {
+    return std::make_unique<AggregatorSumStep2>(trx);
+  }
+  if (type == "AVERAGE_STEP1") {
+    return std::make_unique<AggregatorAverageStep1>(trx);
+  }
+  if (type == "AVERAGE_STEP2") {
+    return std::make_unique<AggregatorAverageStep2>(trx);
+  }
   if (type == "VARIANCE_POPULATION" || type == "VARIANCE") {
     return std::make_unique<AggregatorVariance>(trx, true);
   }
@@ -99,6 +108,37 @@ bool Aggregator::requiresInput(std::string const& type) {
   return true;
 }
 
+std::string Aggregator::pushToDBServerAs(std::string const& type) {
+  if (type == "LENGTH" || type == "COUNT") {
+    return "LENGTH";
+  }
+  if (type == "MIN" || type == "MAX" || type == "SUM") {
+    return type;
+  }
+  if (type == "AVERAGE" || type == "AVG") {
+    return "AVERAGE_STEP1";
+  }
+  // not supported for distributed aggregation
+  return "";
+}
+
+std::string Aggregator::runOnCoordinatorAs(std::string const& type) {
+  if (type == "LENGTH" || type == "COUNT") {
+    // sum up the partial counts
+    return "SUM";
+  }
+  if (type == "MIN" || type == "MAX") {
+    return type;
+  }
+  if (type == "SUM") {
+    return "SUM_STEP2";
+  }
+  if (type == "AVERAGE" || type == "AVG") {
+    return "AVERAGE_STEP2";
+  }
+  THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "invalid aggregator type");
+}
+
 void AggregatorLength::reset() { count = 0; }
 
 void AggregatorLength::reduce(AqlValue const&) {
@@ -194,6 +234,34 @@ AqlValue AggregatorSum::stealValue() {
   return temp;
 }
 
+void AggregatorSumStep2::reset() {
+  sum = 0.0;
+  invalid = false;
+}
+
+void AggregatorSumStep2::reduce(AqlValue const& cmpValue) {
+  // a partial sum is null only if the DB server saw a value that makes the
+  // sum invalid, so unlike in SUM it must not be ignored
+  if (!invalid && cmpValue.isNumber()) {
+    sum += cmpValue.toDouble(trx);
+    return;
+  }
+
+  invalid = true;
+}
+
+AqlValue AggregatorSumStep2::stealValue() {
+  if (invalid || std::isnan(sum) || sum == HUGE_VAL || sum == -HUGE_VAL) {
+    return AqlValue(arangodb::basics::VelocyPackHelper::NullValue());
+  }
+
+  builder.clear();
+  builder.add(VPackValue(sum));
+  AqlValue temp(builder.slice());
+  reset();
+  return temp;
+}
+
 void AggregatorAverage::reset() {
   count = 0;
   sum = 0.0;
@@ -235,6 +303,87 @@ AqlValue AggregatorAverage::stealValue() {
   return temp;
 }
 
+void AggregatorAverageStep1::reset() {
+  count = 0;
+  sum = 0.0;
+  invalid = false;
+}
+
+void AggregatorAverageStep1::reduce(AqlValue const& cmpValue) {
+  if (!invalid) {
+    if (cmpValue.isNull(true)) {
+      // ignore `null` values here
+      return;
+    }
+    if (cmpValue.isNumber()) {
+      double const number = cmpValue.toDouble(trx);
+      if (!std::isnan(number) && number != HUGE_VAL &&
+          number != -HUGE_VAL) {
+        sum += number;
+        ++count;
+        return;
+      }
+    }
+  }
+
+  invalid = true;
+}
+
+AqlValue AggregatorAverageStep1::stealValue() {
+  if (invalid || std::isnan(sum) || sum == HUGE_VAL || sum == -HUGE_VAL) {
+    // an invalid partial result makes the final result invalid, too
+    return AqlValue(arangodb::basics::VelocyPackHelper::NullValue());
+  }
+
+  builder.clear();
+  builder.openArray();
+  builder.add(VPackValue(sum));
+  builder.add(VPackValue(count));
+  builder.close();
+  AqlValue temp(builder.slice());
+  reset();
+  return temp;
+}
+
+void AggregatorAverageStep2::reset() {
+  count = 0;
+  sum = 0.0;
+  invalid = false;
+}
+
+void AggregatorAverageStep2::reduce(AqlValue const& cmpValue) {
+  if (!invalid && cmpValue.isArray()) {
+    bool mustDestroy;
+    AqlValue partialSum = cmpValue.at(trx, 0, mustDestroy, false);
+    AqlValueGuard sumGuard(partialSum, mustDestroy);
+    AqlValue partialCount = cmpValue.at(trx, 1, mustDestroy, false);
+    AqlValueGuard countGuard(partialCount, mustDestroy);
+
+    if (partialSum.isNumber() && partialCount.isNumber()) {
+      sum += partialSum.toDouble(trx);
+      count += partialCount.toInt64(trx);
+      return;
+    }
+  }
+
+  invalid = true;
+}
+
+AqlValue AggregatorAverageStep2::stealValue() {
+  if (invalid || count == 0 || std::isnan(sum) || sum == HUGE_VAL ||
+      sum == -HUGE_VAL) {
+    return AqlValue(arangodb::basics::VelocyPackHelper::NullValue());
+  }
+
+  TRI_ASSERT(count > 0);
+
+  builder.clear();
+  builder.add(VPackValue(sum / count));
+  AqlValue temp(builder.slice());
+  reset();
+  return temp;
+}
+
 void AggregatorVarianceBase::reset() {
   count = 0;
   sum = 0.0;
@@ -57,6 +57,15 @@ struct Aggregator {
   static bool isSupported(std::string const&);
   static bool requiresInput(std::string const&);
 
+  /// @brief name of the aggregator that produces the partial state of
+  /// the given aggregator on a DB server. returns an empty string if the
+  /// aggregator cannot be split into a DB server and a coordinator part
+  static std::string pushToDBServerAs(std::string const&);
+
+  /// @brief name of the aggregator that merges the partial states produced
+  /// by pushToDBServerAs() on the coordinator
+  static std::string runOnCoordinatorAs(std::string const&);
+
   transaction::Methods* trx;
 
   arangodb::velocypack::Builder builder;
@@ -121,6 +130,23 @@ struct AggregatorSum final : public Aggregator {
   bool invalid;
 };
 
+/// @brief second step of a distributed SUM, run on the coordinator. adds
+/// up the partial sums of the DB servers. an invalid (null) partial sum
+/// makes the result invalid, as it would have on a single server
+struct AggregatorSumStep2 final : public Aggregator {
+  explicit AggregatorSumStep2(transaction::Methods* trx)
+      : Aggregator(trx), sum(0.0), invalid(false) {}
+
+  char const* name() const override final { return "SUM_STEP2"; }
+
+  void reset() override final;
+  void reduce(AqlValue const&) override final;
+  AqlValue stealValue() override final;
+
+  double sum;
+  bool invalid;
+};
+
 struct AggregatorAverage final : public Aggregator {
   explicit AggregatorAverage(transaction::Methods* trx)
       : Aggregator(trx), count(0), sum(0.0), invalid(false) {}
@@ -136,6 +162,40 @@ struct AggregatorAverage final : public Aggregator {
   bool invalid;
 };
 
+/// @brief first step of a distributed AVERAGE, run on the DB servers.
+/// produces the partial state [sum, count] of its input
+struct AggregatorAverageStep1 final : public Aggregator {
+  explicit AggregatorAverageStep1(transaction::Methods* trx)
+      : Aggregator(trx), count(0), sum(0.0), invalid(false) {}
+
+  char const* name() const override final { return "AVERAGE_STEP1"; }
+
+  void reset() override final;
+  void reduce(AqlValue const&) override final;
+  AqlValue stealValue() override final;
+
+  uint64_t count;
+  double sum;
+  bool invalid;
+};
+
+/// @brief second step of a distributed AVERAGE, run on the coordinator.
+/// merges the partial states produced by AVERAGE_STEP1
+struct AggregatorAverageStep2 final : public Aggregator {
+  explicit AggregatorAverageStep2(transaction::Methods* trx)
+      : Aggregator(trx), count(0), sum(0.0), invalid(false) {}
+
+  char const* name() const override final { return "AVERAGE_STEP2"; }
+
+  void reset() override final;
+  void reduce(AqlValue const&) override final;
+  AqlValue stealValue() override final;
+
+  uint64_t count;
+  double sum;
+  bool invalid;
+};
+
 struct AggregatorVarianceBase : public Aggregator {
   AggregatorVarianceBase(transaction::Methods* trx, bool population)
       : Aggregator(trx),
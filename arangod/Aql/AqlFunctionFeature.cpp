@@ -240,7 +240,8 @@ void AqlFunctionFeature::addStringFunctions() {
        &Functions::CharLength});
   add({"LOWER", "AQL_LOWER", ".", true, true, false, true, true, &Functions::Lower});
   add({"UPPER", "AQL_UPPER", ".", true, true, false, true, true, &Functions::Upper});
-  add({"SUBSTRING", "AQL_SUBSTRING", ".,.|.", true, true, false, true, true});
+  add({"SUBSTRING", "AQL_SUBSTRING", ".,.|.", true, true, false, true, true,
+       &Functions::Substring});
   add({"CONTAINS", "AQL_CONTAINS", ".,.|.", true, true, false, true, true,
        &Functions::Contains});
   add({"LIKE", "AQL_LIKE", ".,.|.", true, true, false, true, true,
@@ -249,8 +250,10 @@ void AqlFunctionFeature::addStringFunctions() {
        &Functions::RegexTest});
   add({"REGEX_REPLACE", "AQL_REGEX_REPLACE", ".,.,.|.", true, true, false, true,
        true, &Functions::RegexReplace});
-  add({"LEFT", "AQL_LEFT", ".,.", true, true, false, true, true});
-  add({"RIGHT", "AQL_RIGHT", ".,.", true, true, false, true, true});
+  add({"LEFT", "AQL_LEFT", ".,.", true, true, false, true, true,
+       &Functions::Left});
+  add({"RIGHT", "AQL_RIGHT", ".,.", true, true, false, true, true,
+       &Functions::Right});
   add({"TRIM", "AQL_TRIM", ".|.", true, true, false, true, true});
   add({"LTRIM", "AQL_LTRIM", ".|.", true, true, false, true, true});
   add({"RTRIM", "AQL_RTRIM", ".|.", true, true, false, true, true});
@@ -361,8 +364,8 @@ void AqlFunctionFeature::addListFunctions() {
        &Functions::SortedUnique});
   add({"SLICE", "AQL_SLICE", ".,.|.", true, true, false, true, true,
        &Functions::Slice});
-  add({"REVERSE", "AQL_REVERSE", ".", true, true, false, true,
-       true});  // note: REVERSE() can be applied on strings, too
+  add({"REVERSE", "AQL_REVERSE", ".", true, true, false, true, true,
+       &Functions::Reverse});  // note: REVERSE() can be applied on strings, too
   add({"FIRST", "AQL_FIRST", ".", true, true, false, true, true,
        &Functions::First});
   add({"LAST", "AQL_LAST", ".", true, true, false, true, true,
@@ -58,7 +58,8 @@ AqlItemBlock::AqlItemBlock(ResourceMonitor* resourceMonitor, size_t nrItems, Reg
 }
 
 /// @brief create the block from VelocyPack, note that this can throw
-AqlItemBlock::AqlItemBlock(ResourceMonitor* resourceMonitor, VPackSlice const slice)
+AqlItemBlock::AqlItemBlock(ResourceMonitor* resourceMonitor, VPackSlice const slice,
+                           bool copyValues)
     : _nrItems(0), _nrRegs(0), _resourceMonitor(resourceMonitor) {
   TRI_ASSERT(resourceMonitor != nullptr);
 
@@ -147,7 +148,8 @@ AqlItemBlock::AqlItemBlock(ResourceMonitor* resourceMonitor, VPackSlice const sl
             }
           } else if (n == 1) {
             // a VelocyPack value
-            AqlValue a(rawIterator.value());
+            AqlValue a = copyValues ? AqlValue(rawIterator.value())
+                                    : AqlValue(rawIterator.value().begin());
             rawIterator.next();
             try {
               setValue(i, column, a);  // if this throws, a is destroyed again
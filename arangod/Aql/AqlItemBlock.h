@@ -64,17 +64,44 @@ class AqlItemBlock {
   /// @brief create the block
   AqlItemBlock(ResourceMonitor*, size_t nrItems, RegisterId nrRegs);
 
-  AqlItemBlock(ResourceMonitor*, arangodb::velocypack::Slice const);
+  /// @brief create the block from its serialized form (see toVelocyPack).
+  /// if copyValues is false, the values of the block point into the memory
+  /// of the slice instead of copying it. the caller must then keep that
+  /// memory alive for as long as any of the values may be used, which is
+  /// until the end of the query, as values are passed on between blocks
+  AqlItemBlock(ResourceMonitor*, arangodb::velocypack::Slice const,
+               bool copyValues = true);
 
   /// @brief destroy the block
   ~AqlItemBlock() { 
     destroy(); 
-    decreaseMemoryUsage(sizeof(AqlValue) * _nrItems * _nrRegs);
+    if (_resourceMonitor != nullptr) {
+      decreaseMemoryUsage(sizeof(AqlValue) * _nrItems * _nrRegs);
+    }
   }
 
  private:
   void destroy();
 
+  /// @brief detach an empty block from the resource monitor of its query,
+  /// so that it can be handed to another query
+  void detachResourceMonitor() {
+    TRI_ASSERT(_valueCount.empty());
+    TRI_ASSERT(_resourceMonitor != nullptr);
+    decreaseMemoryUsage(sizeof(AqlValue) * _nrItems * _nrRegs);
+    _resourceMonitor = nullptr;
+  }
+
+  /// @brief attach a detached block to the resource monitor of the query
+  /// that reuses it
+  void attachResourceMonitor(ResourceMonitor* resourceMonitor) {
+    TRI_ASSERT(_resourceMonitor == nullptr);
+    TRI_ASSERT(resourceMonitor != nullptr);
+    // may throw. the block stays detached in this case
+    resourceMonitor->increaseMemoryUsage(sizeof(AqlValue) * _nrItems * _nrRegs);
+    _resourceMonitor = resourceMonitor;
+  }
+
   inline void increaseMemoryUsage(size_t value) {
     _resourceMonitor->increaseMemoryUsage(value);
   }
@@ -247,6 +274,15 @@ class AqlItemBlock {
   
   inline size_t capacity() const { return _data.size(); }
 
+  /// @brief approximate memory used by the block and the values it manages
+  size_t memoryUsage() const {
+    size_t total = sizeof(AqlValue) * _nrItems * _nrRegs;
+    for (auto const& it : _valueCount) {
+      total += it.first.memoryUsage();
+    }
+    return total;
+  }
+
   /// @brief shrink the block to the specified number of rows
   /// if sweep is set, then the superfluous rows are cleaned
   /// if sweep is not set, the caller has to ensure that the
@@ -26,12 +26,25 @@
 
 using namespace arangodb::aql;
 
+thread_local AqlItemBlockManager::Bucket
+    AqlItemBlockManager::_recycled[AqlItemBlockManager::NumRecycledBuckets];
+
 /// @brief create the manager
 AqlItemBlockManager::AqlItemBlockManager(ResourceMonitor* resourceMonitor) 
     : _resourceMonitor(resourceMonitor) {}
 
-/// @brief destroy the manager
-AqlItemBlockManager::~AqlItemBlockManager() { }
+/// @brief destroy the manager. hands the cached blocks over to the
+/// thread's recycled blocks
+AqlItemBlockManager::~AqlItemBlockManager() {
+  for (size_t i = 0; i < NumRecycledBuckets; ++i) {
+    while (!_buckets[i].empty() && !_recycled[i].full()) {
+      AqlItemBlock* block = _buckets[i].pop();
+      block->detachResourceMonitor();
+      _recycled[i].push(block);
+    }
+  }
+  // remaining blocks are deleted by the Bucket destructors
+}
 
 /// @brief request a block with the specified size
 AqlItemBlock* AqlItemBlockManager::requestBlock(size_t nrItems,
@@ -59,6 +72,23 @@ AqlItemBlock* AqlItemBlockManager::requestBlock(size_t nrItems,
     }
   }
 
+  if (block == nullptr) {
+    // try blocks left over by previous queries on this thread
+    i = Bucket::getId(targetSize);
+    if (i < NumRecycledBuckets && !_recycled[i].empty()) {
+      block = _recycled[i].pop();
+      TRI_ASSERT(block != nullptr);
+      try {
+        block->attachResourceMonitor(_resourceMonitor);
+        block->eraseAll();
+        block->rescale(nrItems, nrRegs);
+      } catch (...) {
+        delete block;
+        throw;
+      }
+    }
+  }
+
   if (block == nullptr) {
     block = new AqlItemBlock(_resourceMonitor, nrItems, nrRegs);
     // LOG_TOPIC(TRACE, arangodb::Logger::FIXME) << "created AqlItemBlock with dimensions " << block->size() << " x " << block->getNrRegs();
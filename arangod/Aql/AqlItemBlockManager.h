@@ -136,6 +136,15 @@ class AqlItemBlockManager {
   };
 
   Bucket _buckets[NumBuckets];
+
+  /// @brief buckets with the largest block sizes are not recycled across
+  /// queries, so that idle threads do not keep huge blocks alive
+  static constexpr size_t NumRecycledBuckets = 10;
+
+  /// @brief blocks left over by finished queries, reused by later queries
+  /// on the same thread. these blocks are not attached to any resource
+  /// monitor
+  static thread_local Bucket _recycled[NumRecycledBuckets];
 };
 
 }
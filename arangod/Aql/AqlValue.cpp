@@ -493,6 +493,85 @@ AqlValue AqlValue::get(transaction::Methods* trx,
   return AqlValue(arangodb::basics::VelocyPackHelper::NullValue());
 }
 
+/// @brief objects with at most this many attributes are searched linearly
+/// when the attribute is not found at the remembered position, so that its
+/// new position can be remembered. larger objects use the regular lookup
+static constexpr VPackValueLength MaxPositionScanLength = 32;
+
+/// @brief get the (object) element by name, trying the remembered position
+/// first
+AqlValue AqlValue::get(transaction::Methods* trx, std::string const& name,
+                       size_t& position, bool& mustDestroy,
+                       bool doCopy) const {
+  mustDestroy = false;
+  switch (type()) {
+    case VPACK_SLICE_POINTER:
+      doCopy = false;
+    // fall-through intentional
+    case VPACK_INLINE:
+    // fall-through intentional
+    case VPACK_MANAGED_SLICE:
+    // fall-through intentional
+    case VPACK_MANAGED_BUFFER: {
+      VPackSlice s(slice());
+      if (!s.isObject()) {
+        break;
+      }
+
+      auto matches = [&s, &name](VPackValueLength i, VPackSlice& value) {
+        VPackSlice key = s.keyAt(i, false);
+        value = VPackSlice(key.start() + key.byteSize());
+        if (key.isString()) {
+          return key.isEqualString(name);
+        }
+        // translated attribute name
+        return s.keyAt(i, true).isEqualString(name);
+      };
+
+      VPackValueLength const n = s.length();
+      VPackSlice found;
+      if (position < n && matches(position, found)) {
+        // same layout as the previous object
+      } else if (n <= MaxPositionScanLength) {
+        found = VPackSlice();
+        for (VPackValueLength i = 0; i < n; ++i) {
+          VPackSlice value;
+          if (matches(i, value)) {
+            position = static_cast<size_t>(i);
+            found = value;
+            break;
+          }
+        }
+      } else {
+        found = s.get(name);
+      }
+
+      if (found.isCustom()) {
+        // _id needs special treatment
+        mustDestroy = true;
+        return AqlValue(trx->extractIdString(s));
+      }
+      if (!found.isNone()) {
+        if (doCopy) {
+          mustDestroy = true;
+          return AqlValue(found);
+        }
+        // return a reference to an existing slice
+        return AqlValue(found.begin());
+      }
+      break;
+    }
+    case DOCVEC:
+    case RANGE: {
+      // will return null
+      break;
+    }
+  }
+
+  // default is to return null
+  return AqlValue(arangodb::basics::VelocyPackHelper::NullValue());
+}
+
 /// @brief get the (object) element(s) by name
 AqlValue AqlValue::get(transaction::Methods* trx,
                        std::vector<std::string> const& names, 
@@ -449,6 +449,13 @@ struct AqlValue final {
   /// @brief get the (object) element by name(s)
   AqlValue get(transaction::Methods* trx,
                std::string const& name, bool& mustDestroy, bool copy) const;
+  /// @brief get the (object) element by name, trying the position at
+  /// which the attribute was found in the previous object first. documents
+  /// of the same collection mostly share their layout, so the position
+  /// usually matches. <position> is updated when the attribute is found at
+  /// another position
+  AqlValue get(transaction::Methods* trx, std::string const& name,
+               size_t& position, bool& mustDestroy, bool copy) const;
   AqlValue get(transaction::Methods* trx,
                std::vector<std::string> const& names, bool& mustDestroy,
                bool copy) const;
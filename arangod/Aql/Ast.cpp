@@ -2047,6 +2047,46 @@ TopLevelAttributes Ast::getReferencedAttributes(AstNode const* node,
   return result;
 }
 
+bool Ast::getReferencedAttributes(AstNode const* node,
+                                  Variable const* variable,
+                                  std::unordered_set<std::string>& attributes) {
+  auto doNothingVisitor = [](AstNode const* node, void* data) -> void {};
+
+  // traversal state
+  char const* attributeName = nullptr;
+  size_t nameLength = 0;
+  bool result = true;
+
+  auto visitor = [&](AstNode const* node, void* data) -> void {
+    if (node == nullptr || !result) {
+      return;
+    }
+
+    if (node->type == NODE_TYPE_ATTRIBUTE_ACCESS) {
+      attributeName = node->getStringValue();
+      nameLength = node->getStringLength();
+      return;
+    }
+
+    if (node->type == NODE_TYPE_REFERENCE &&
+        static_cast<Variable const*>(node->getData()) == variable) {
+      if (attributeName == nullptr) {
+        // the variable is used as a whole, e.g. FUNC(value) or value[0]
+        result = false;
+        return;
+      }
+      attributes.emplace(attributeName, nameLength);
+    }
+
+    attributeName = nullptr;
+    nameLength = 0;
+  };
+
+  traverseReadOnly(node, visitor, doNothingVisitor, doNothingVisitor, nullptr);
+
+  return result;
+}
+
 bool Ast::populateSingleAttributeAccess(AstNode const* node,
                                         Variable const* variable,
                                         std::vector<std::string>& attributeName) {
@@ -2924,6 +2964,14 @@ AstNode* Ast::optimizeFunctionCall(AstNode* node) {
       // replace IS_NULL(x) function call with `x == null`
       return createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_EQ, args->getMemberUnchecked(0), createNodeValueNull()); 
     }
+  } else if (func->externalName == "CALL" || func->externalName == "APPLY") {
+    // replace CALL("NAME", ...) and APPLY("NAME", [...]) with a direct call
+    // if NAME is a built-in function with a C++ implementation, so that
+    // the call does not need a V8 context
+    AstNode* call = optimizeIndirectFunctionCall(node);
+    if (call != node) {
+      return optimizeFunctionCall(call);
+    }
   }
 
   if (!func->isDeterministic) {
@@ -2939,6 +2987,69 @@ AstNode* Ast::optimizeFunctionCall(AstNode* node) {
   return executeConstExpression(node);
 }
 
+/// @brief turns a CALL or APPLY of a built-in function with a C++
+/// implementation into a direct call of the function. returns the original
+/// node if the function name or the arguments are not known in advance
+AstNode* Ast::optimizeIndirectFunctionCall(AstNode* node) {
+  auto func = static_cast<Function*>(node->getData());
+  auto args = node->getMember(0);
+  size_t const n = args->numMembers();
+
+  if (n == 0 || !args->getMember(0)->isStringValue()) {
+    return node;
+  }
+
+  std::string const name(args->getMember(0)->getStringValue(),
+                         args->getMember(0)->getStringLength());
+  auto normalized = normalizeFunctionName(name.c_str());
+
+  if (!normalized.second) {
+    // user-defined functions are still called via V8
+    return node;
+  }
+
+  Function const* callee = nullptr;
+  try {
+    callee = _query->executor()->getFunctionByName(normalized.first);
+  } catch (...) {
+    // unknown function. leave it to CALL to report this at runtime
+    return node;
+  }
+
+  if (callee->implementation == nullptr || !callee->conversions.empty() ||
+      callee->externalName == "CALL" || callee->externalName == "APPLY") {
+    return node;
+  }
+
+  AstNode* calleeArgs = createNodeArray();
+
+  if (func->externalName == "CALL") {
+    for (size_t i = 1; i < n; ++i) {
+      calleeArgs->addMember(args->getMemberUnchecked(i));
+    }
+  } else if (n == 2) {
+    auto params = args->getMember(1);
+    if (params->type != NODE_TYPE_ARRAY) {
+      // arguments only known at runtime
+      return node;
+    }
+    for (size_t i = 0; i < params->numMembers(); ++i) {
+      calleeArgs->addMember(params->getMemberUnchecked(i));
+    }
+  }
+
+  auto numExpectedArguments = callee->numArguments();
+  size_t const numArguments = calleeArgs->numMembers();
+
+  if (numArguments < numExpectedArguments.first ||
+      numArguments > numExpectedArguments.second) {
+    // keep reporting the mismatch at runtime
+    return node;
+  }
+
+  return createNodeFunctionCall(normalized.first.c_str(), calleeArgs);
+}
+
 /// @brief optimizes a reference to a variable
 /// references are replaced with constants if possible
 AstNode* Ast::optimizeReference(AstNode* node) {
@@ -3362,15 +3473,7 @@ std::pair<std::string, bool> Ast::normalizeFunctionName(char const* name) {
 AstNode* Ast::createNode(AstNodeType type) {
   TRI_ASSERT(_query != nullptr);
 
-  auto node = new AstNode(type);
-
-  try {
-    // register the node so it gets freed automatically later
-    _query->addNode(node);
-  } catch (...) {
-    delete node;
-    throw;
-  }
-
-  return node;
+  // the node is allocated in the query's node arena and freed
+  // automatically later
+  return _query->createNode(type);
 }
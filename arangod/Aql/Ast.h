@@ -387,6 +387,12 @@ class Ast {
   /// @brief determines the top-level attributes in an expression, grouped by
   /// variable
   static TopLevelAttributes getReferencedAttributes(AstNode const*, bool&);
+
+  /// @brief determines the top-level attributes of the variable used in an
+  /// expression. returns false if the variable is used in any other way than
+  /// via an attribute access
+  static bool getReferencedAttributes(AstNode const*, Variable const*,
+                                      std::unordered_set<std::string>&);
   
   static bool populateSingleAttributeAccess(AstNode const* node,
                                             Variable const* variable,
@@ -473,6 +479,9 @@ class Ast {
   /// @brief optimizes a call to a built-in function
   AstNode* optimizeFunctionCall(AstNode*);
 
+  /// @brief optimizes CALL and APPLY of built-in functions
+  AstNode* optimizeIndirectFunctionCall(AstNode*);
+
   /// @brief optimizes a reference to a variable
   AstNode* optimizeReference(AstNode*);
 
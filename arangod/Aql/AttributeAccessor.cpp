@@ -37,7 +37,8 @@ AttributeAccessor::AttributeAccessor(
     std::vector<std::string>&& attributeParts, Variable const* variable)
     : _attributeParts(attributeParts),
       _variable(variable),
-      _type(EXTRACT_MULTI) {
+      _type(EXTRACT_MULTI),
+      _position(0) {
 
   TRI_ASSERT(_variable != nullptr);
   TRI_ASSERT(!_attributeParts.empty());
@@ -97,7 +98,7 @@ AqlValue AttributeAccessor::getDynamic(transaction::Methods* trx,
   switch (_type) {
     case EXTRACT_SINGLE:
       // use optimized version for single attribute (e.g. variable.attr)
-      return value.get(trx, _attributeParts[0], mustDestroy, true);
+      return value.get(trx, _attributeParts[0], _position, mustDestroy, true);
     case EXTRACT_MULTI:
       // use general version for multiple attributes (e.g. variable.attr.subattr)
       return value.get(trx, _attributeParts, mustDestroy, true);
@@ -79,6 +79,10 @@ class AttributeAccessor {
 
   /// @brief type of the accessor
   AccessorType _type;
+
+  /// @brief position of the attribute in the previously accessed object,
+  /// for EXTRACT_SINGLE
+  size_t _position;
 };
 
 }  // namespace arangodb::aql
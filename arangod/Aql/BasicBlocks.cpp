@@ -302,11 +302,10 @@ bool FilterBlock::hasMore() {
   }
 
   if (_buffer.empty()) {
-    // QUESTION: Is this sensible? Asking whether there is more might
-    // trigger an expensive fetching operation, even if later on only
-    // a single document is needed due to a LIMIT...
-    // However, how should we know this here?
-    if (!getBlock(DefaultBatchSize(), DefaultBatchSize())) {
+    // asking whether there is more might trigger an expensive fetching
+    // operation. if a LIMIT follows, the batch size starts at the limit
+    // hint and only grows if the filter lets too few rows pass
+    if (!getBlock(batchSize(), batchSize())) {
       _done = true;
       return false;
     }
@@ -397,9 +396,9 @@ int LimitBlock::getOrSkipSome(size_t atLeast, size_t atMost, bool skipping,
 
     if (_fullCount) {
       // if fullCount is set, we must fetch all elements from the
-      // dependency. we'll use the default batch size for this
-      atLeast = DefaultBatchSize();
-      atMost = DefaultBatchSize();
+      // dependency. we'll use the regular batch size for this
+      atLeast = batchSize();
+      atMost = batchSize();
 
       // suck out all data from the dependencies
       while (true) {
@@ -23,6 +23,7 @@
 
 #include "CalculationBlock.h"
 #include "Aql/AqlItemBlock.h"
+#include "Aql/ColumnarExpression.h"
 #include "Aql/ExecutionEngine.h"
 #include "Aql/Functions.h"
 #include "Aql/Query.h"
@@ -78,6 +79,12 @@ CalculationBlock::CalculationBlock(ExecutionEngine* engine,
     _conditionReg = it->second.registerId;
     TRI_ASSERT(_conditionReg < ExecutionNode::MaxRegisterId);
   }
+
+  if (!_isReference && en->_conditionVariable == nullptr &&
+      !_expression->isV8()) {
+    // simple numeric expressions can be evaluated one column at a time
+    _columnar = ColumnarExpression::create(_expression->node(), _inVars, _inRegs);
+  }
 }
 
 CalculationBlock::~CalculationBlock() {}
@@ -156,6 +163,12 @@ void CalculationBlock::doEvaluation(AqlItemBlock* result) {
   if (!_expression->isV8()) {
     // an expression that does not require V8
 
+    if (_columnar != nullptr && _columnar->execute(_trx, result, _outReg)) {
+      // all values of the block were handled by the columnar evaluator
+      throwIfKilled();  // check if we were aborted
+      return;
+    }
+
     Functions::InitializeThreadContext();
     try {
       executeExpression(result);
@@ -165,13 +178,16 @@ void CalculationBlock::doEvaluation(AqlItemBlock* result) {
       throw;
     }
   } else {
-    bool const isRunningInCluster = transaction()->state()->isRunningInCluster();
+    // the next evaluation may happen on another thread, in the cluster and
+    // for streaming cursors, whose batches come from different requests
+    bool const exitContext = transaction()->state()->isRunningInCluster() ||
+                             _engine->getQuery()->isStreaming();
 
     // must have a V8 context here to protect Expression::execute()
     arangodb::basics::ScopeGuard guard{
         [&]() -> void { _engine->getQuery()->enterContext(); },
         [&]() -> void {
-          if (isRunningInCluster) {
+          if (exitContext) {
             // must invalidate the expression now as we might be called from
             // different threads
             _expression->invalidate();
@@ -31,6 +31,7 @@ namespace arangodb {
 namespace aql {
 
 class AqlItemBlock;
+class ColumnarExpression;
 
 class ExecutionEngine;
 
@@ -73,6 +74,10 @@ class CalculationBlock final : public ExecutionBlock {
 
   /// @brief whether or not the expression is a simple variable reference
   bool _isReference;
+
+  /// @brief block-at-a-time evaluator for the expression, if the expression
+  /// is simple enough
+  std::unique_ptr<ColumnarExpression> _columnar;
 };
 
 }  // namespace arangodb::aql
@@ -56,6 +56,61 @@ using namespace arangodb::aql;
 using VelocyPackHelper = arangodb::basics::VelocyPackHelper;
 using StringBuffer = arangodb::basics::StringBuffer;
 
+namespace {
+
+/// @brief loser tree for the k-way merge in GatherBlock. it finds the input
+/// with the smallest head with O(log k) comparisons per row, instead of the
+/// O(k) comparisons of scanning all inputs. inputs that have run dry must
+/// compare greater than all others
+template <typename Less>
+class LoserTree {
+ public:
+  LoserTree(size_t size, Less const& less) : _size(size), _less(less), _tree(size) {
+    TRI_ASSERT(_size > 0);
+    // play the initial tournament. winners[n] is the winner of the subtree
+    // at node n, the leaves of input i are at _size + i
+    std::vector<size_t> winners(2 * _size);
+    for (size_t i = 0; i < _size; ++i) {
+      winners[_size + i] = i;
+    }
+    for (size_t n = _size - 1; n > 0; --n) {
+      size_t left = winners[2 * n];
+      size_t right = winners[2 * n + 1];
+      if (_less(right, left)) {
+        winners[n] = right;
+        _tree[n] = left;
+      } else {
+        winners[n] = left;
+        _tree[n] = right;
+      }
+    }
+    _tree[0] = winners[1];
+  }
+
+  /// @brief the input with the smallest head
+  size_t top() const { return _tree[0]; }
+
+  /// @brief restore the tree after the head of top() has changed
+  void replay() {
+    size_t winner = _tree[0];
+    for (size_t n = (_size + winner) / 2; n > 0; n /= 2) {
+      if (_less(_tree[n], winner)) {
+        std::swap(_tree[n], winner);
+      }
+    }
+    _tree[0] = winner;
+  }
+
+ private:
+  size_t const _size;
+  Less const& _less;
+  /// @brief _tree[0] is the overall winner, the other nodes keep the loser
+  /// of the match played there
+  std::vector<size_t> _tree;
+};
+
+}  // namespace
+
 GatherBlock::GatherBlock(ExecutionEngine* engine, GatherNode const* en)
     : ExecutionBlock(engine, en),
       _sortRegisters(),
@@ -103,6 +158,14 @@ int GatherBlock::shutdown(int errorCode) {
   DEBUG_BEGIN_BLOCK();
   // don't call default shutdown method since it does the wrong thing to
   // _gatherBlockBuffer
+
+  // let all shards shut down in parallel
+  for (auto& dep : _dependencies) {
+    if (dep->getPlanNode()->getType() == ExecutionNode::REMOTE) {
+      static_cast<RemoteBlock*>(dep)->startShutdown(errorCode);
+    }
+  }
+
   int ret = TRI_ERROR_NO_ERROR;
   for (auto it = _dependencies.begin(); it != _dependencies.end(); ++it) {
     int res = (*it)->shutdown(errorCode);
@@ -136,6 +199,13 @@ int GatherBlock::shutdown(int errorCode) {
 /// @brief initializeCursor
 int GatherBlock::initializeCursor(AqlItemBlock* items, size_t pos) {
   DEBUG_BEGIN_BLOCK();
+  // let all shards initialize their cursors in parallel
+  for (auto& dep : _dependencies) {
+    if (dep->getPlanNode()->getType() == ExecutionNode::REMOTE) {
+      static_cast<RemoteBlock*>(dep)->startInitializeCursor(items, pos);
+    }
+  }
+
   int res = ExecutionBlock::initializeCursor(items, pos);
 
   if (res != TRI_ERROR_NO_ERROR) {
@@ -254,6 +324,7 @@ AqlItemBlock* GatherBlock::getSome(size_t atLeast, size_t atMost) {
 
   // the simple case . . .
   if (_isSimple) {
+    prefetchDependencies(_atDep, atLeast, atMost);
     auto res = _dependencies.at(_atDep)->getSome(atLeast, atMost);
     while (res == nullptr && _atDep < _dependencies.size() - 1) {
       _atDep++;
@@ -273,7 +344,9 @@ AqlItemBlock* GatherBlock::getSome(size_t atLeast, size_t atMost) {
   // pull more blocks from dependencies . . .
   TRI_ASSERT(_gatherBlockBuffer.size() == _dependencies.size());
   TRI_ASSERT(_gatherBlockBuffer.size() == _gatherBlockPos.size());
- 
+
+  prefetchDependencies(0, atLeast, atMost);
+
   for (size_t i = 0; i < _dependencies.size(); i++) {
     if (_gatherBlockBuffer.at(i).empty()) {
       if (getBlock(i, atLeast, atMost)) {
@@ -306,6 +379,10 @@ AqlItemBlock* GatherBlock::getSome(size_t atLeast, size_t atMost) {
 
   // comparison function
   OurLessThan ourLessThan(_trx, _gatherBlockBuffer, _sortRegisters);
+  auto lessThan = [this, &ourLessThan](size_t a, size_t b) {
+    return ourLessThan(_gatherBlockPos[a], _gatherBlockPos[b]);
+  };
+  LoserTree<decltype(lessThan)> tree(_gatherBlockPos.size(), lessThan);
   AqlItemBlock* example = _gatherBlockBuffer.at(index).front();
   size_t nrRegs = example->getNrRegs();
 
@@ -314,8 +391,7 @@ AqlItemBlock* GatherBlock::getSome(size_t atLeast, size_t atMost) {
 
   for (size_t i = 0; i < toSend; i++) {
     // get the next smallest row from the buffer . . .
-    std::pair<size_t, size_t> val = *(std::min_element(
-        _gatherBlockPos.begin(), _gatherBlockPos.end(), ourLessThan));
+    std::pair<size_t, size_t> val = _gatherBlockPos[tree.top()];
 
     // copy the row in to the outgoing block . . .
     for (RegisterId col = 0; col < nrRegs; col++) {
@@ -358,6 +434,7 @@ AqlItemBlock* GatherBlock::getSome(size_t atLeast, size_t atMost) {
         // this
       }
     }
+    tree.replay();
   }
 
   traceGetSomeEnd(res.get());
@@ -370,12 +447,15 @@ AqlItemBlock* GatherBlock::getSome(size_t atLeast, size_t atMost) {
 /// @brief skipSome
 size_t GatherBlock::skipSome(size_t atLeast, size_t atMost) {
   DEBUG_BEGIN_BLOCK();
+  traceSkipSomeBegin();
   if (_done) {
+    traceSkipSomeEnd(0);
     return 0;
   }
 
   // the simple case . . .
   if (_isSimple) {
+    prefetchDependencies(_atDep, atLeast, atMost);
     auto skipped = _dependencies.at(_atDep)->skipSome(atLeast, atMost);
     while (skipped == 0 && _atDep < _dependencies.size() - 1) {
       _atDep++;
@@ -384,6 +464,7 @@ size_t GatherBlock::skipSome(size_t atLeast, size_t atMost) {
     if (skipped == 0) {
       _done = true;
     }
+    traceSkipSomeEnd(skipped);
     return skipped;
   }
 
@@ -391,6 +472,8 @@ size_t GatherBlock::skipSome(size_t atLeast, size_t atMost) {
   size_t available = 0;  // nr of available rows
   TRI_ASSERT(_dependencies.size() != 0);
 
+  prefetchDependencies(0, atLeast, atMost);
+
   // pull more blocks from dependencies . . .
   for (size_t i = 0; i < _dependencies.size(); i++) {
     if (_gatherBlockBuffer.at(i).empty()) {
@@ -410,6 +493,7 @@ size_t GatherBlock::skipSome(size_t atLeast, size_t atMost) {
 
   if (available == 0) {
     _done = true;
+    traceSkipSomeEnd(0);
     return 0;
   }
 
@@ -417,11 +501,14 @@ size_t GatherBlock::skipSome(size_t atLeast, size_t atMost) {
 
   // comparison function
   OurLessThan ourLessThan(_trx, _gatherBlockBuffer, _sortRegisters);
+  auto lessThan = [this, &ourLessThan](size_t a, size_t b) {
+    return ourLessThan(_gatherBlockPos[a], _gatherBlockPos[b]);
+  };
+  LoserTree<decltype(lessThan)> tree(_gatherBlockPos.size(), lessThan);
 
   for (size_t i = 0; i < skipped; i++) {
     // get the next smallest row from the buffer . . .
-    std::pair<size_t, size_t> val = *(std::min_element(
-        _gatherBlockPos.begin(), _gatherBlockPos.end(), ourLessThan));
+    std::pair<size_t, size_t> val = _gatherBlockPos[tree.top()];
 
     // renew the _gatherBlockPos and clean up the buffer if necessary
     _gatherBlockPos.at(val.first).second++;
@@ -432,8 +519,10 @@ size_t GatherBlock::skipSome(size_t atLeast, size_t atMost) {
       _gatherBlockBuffer.at(val.first).pop_front();
       _gatherBlockPos.at(val.first) = std::make_pair(val.first, 0);
     }
+    tree.replay();
   }
 
+  traceSkipSomeEnd(skipped);
   return skipped;
 
   // cppcheck-suppress style
@@ -460,6 +549,21 @@ bool GatherBlock::getBlock(size_t i, size_t atLeast, size_t atMost) {
   DEBUG_END_BLOCK();
 }
 
+/// @brief let all remote dependencies produce their next block in parallel
+void GatherBlock::prefetchDependencies(size_t first, size_t atLeast,
+                                       size_t atMost) {
+  for (size_t i = first; i < _dependencies.size(); i++) {
+    if (!_isSimple && !_gatherBlockBuffer.at(i).empty()) {
+      // still has rows to merge
+      continue;
+    }
+    ExecutionBlock* dependency = _dependencies[i];
+    if (dependency->getPlanNode()->getType() == ExecutionNode::REMOTE) {
+      static_cast<RemoteBlock*>(dependency)->prefetch(atLeast, atMost);
+    }
+  }
+}
+
 /// @brief OurLessThan: comparison method for elements of _gatherBlockPos
 bool GatherBlock::OurLessThan::operator()(std::pair<size_t, size_t> const& a,
                                           std::pair<size_t, size_t> const& b) {
@@ -1176,9 +1280,7 @@ static bool throwExceptionAfterBadSyncRequest(ClusterCommResult* res,
     int errorNum = TRI_ERROR_INTERNAL;
     if (res->result != nullptr) {
       errorNum = TRI_ERROR_NO_ERROR;
-      arangodb::basics::StringBuffer const& responseBodyBuf(res->result->getBody());
-      std::shared_ptr<VPackBuilder> builder = VPackParser::fromJson(
-          responseBodyBuf.c_str(), responseBodyBuf.length());
+      std::shared_ptr<VPackBuilder> builder = res->result->getBodyVelocyPack();
       VPackSlice slice = builder->slice();
 
       if (!slice.hasKey("error") || slice.get("error").getBoolean()) {
@@ -1237,7 +1339,17 @@ RemoteBlock::RemoteBlock(ExecutionEngine* engine, RemoteNode const* en,
       _ownName(ownName),
       _queryId(queryId),
       _isResponsibleForInitializeCursor(
-          en->isResponsibleForInitializeCursor()) {
+          en->isResponsibleForInitializeCursor()),
+      _prefetch(arangodb::ServerState::instance()->isCoordinator()),
+      _prefetchTransactionId(0),
+      _prefetchOperationId(0),
+      _prefetched(),
+      _prefetchExhausted(false),
+      _startedTransactionId(0),
+      _startedOperationId(0),
+      _startedUrlPart(),
+      _retainedResponses(),
+      _retainedResponsesSize(0) {
   TRI_ASSERT(!queryId.empty());
   TRI_ASSERT(
       (arangodb::ServerState::instance()->isCoordinator() && ownName.empty()) ||
@@ -1245,7 +1357,25 @@ RemoteBlock::RemoteBlock(ExecutionEngine* engine, RemoteNode const* en,
        !ownName.empty()));
 }
 
-RemoteBlock::~RemoteBlock() {}
+RemoteBlock::~RemoteBlock() {
+  if (_prefetchOperationId != 0 || _startedOperationId != 0) {
+    // nobody is interested in the answers anymore
+    auto cc = ClusterComm::instance();
+    if (cc != nullptr) {
+      if (_prefetchOperationId != 0) {
+        cc->drop("AQL", _prefetchTransactionId, _prefetchOperationId, "");
+      }
+      if (_startedOperationId != 0) {
+        cc->drop("AQL", _startedTransactionId, _startedOperationId, "");
+      }
+    }
+  }
+
+  if (_retainedResponsesSize > 0) {
+    _engine->getQuery()->resourceMonitor()->decreaseMemoryUsage(
+        _retainedResponsesSize);
+  }
+}
 
 /// @brief local helper to send a request
 std::unique_ptr<ClusterCommResult> RemoteBlock::sendRequest(
@@ -1275,7 +1405,8 @@ std::unique_ptr<ClusterCommResult> RemoteBlock::sendRequest(
                               arangodb::basics::StringUtils::urlEncode(
                                   _engine->getQuery()->trx()->vocbase()->name()) +
                               urlPart + _queryId,
-                          body, headers, defaultTimeOut);
+                          body, headers, defaultTimeOut,
+                          ClusterCommTransport::VST);
 
       return result;
     }
@@ -1286,6 +1417,194 @@ std::unique_ptr<ClusterCommResult> RemoteBlock::sendRequest(
   DEBUG_END_BLOCK();
 }
 
+/// @brief local helper to send a request without waiting for its answer
+uint64_t RemoteBlock::sendAsyncRequest(TRI_voc_tick_t transactionId,
+                                       arangodb::rest::RequestType type,
+                                       std::string const& urlPart,
+                                       std::string const& body) const {
+  auto cc = ClusterComm::instance();
+  if (cc == nullptr) {
+    // nullptr only happens on controlled shutdown
+    return 0;
+  }
+
+  auto headers = std::make_unique<std::unordered_map<std::string, std::string>>();
+  if (!_ownName.empty()) {
+    headers->emplace("Shard-Id", _ownName);
+  }
+
+  ++_engine->_stats.httpRequests;
+  return cc->asyncRequest(
+      "AQL", transactionId, _server, type,
+      std::string("/_db/") +
+          arangodb::basics::StringUtils::urlEncode(
+              _engine->getQuery()->trx()->vocbase()->name()) +
+          urlPart + _queryId,
+      std::make_shared<std::string const>(body), headers, nullptr,
+      defaultTimeOut, false, -1.0, ClusterCommTransport::VST);
+}
+
+/// @brief send the next getSome request ahead of time
+void RemoteBlock::sendPrefetch(size_t atLeast, size_t atMost) {
+  TRI_ASSERT(_prefetchOperationId == 0);
+  TRI_ASSERT(_prefetched == nullptr);
+
+  VPackBuilder builder;
+  builder.openObject();
+  builder.add("atLeast", VPackValue(atLeast));
+  builder.add("atMost", VPackValue(atMost));
+  builder.close();
+
+  _prefetchTransactionId = TRI_NewTickServer();
+  _prefetchOperationId =
+      sendAsyncRequest(_prefetchTransactionId, rest::RequestType::PUT,
+                       "/_api/aql/getSome/", builder.slice().toJson());
+}
+
+/// @brief wait for the response of an outstanding prefetch request
+void RemoteBlock::awaitPrefetch() const {
+  if (_prefetchOperationId == 0) {
+    return;
+  }
+
+  uint64_t const operationId = _prefetchOperationId;
+  _prefetchOperationId = 0;
+
+  auto cc = ClusterComm::instance();
+  if (cc == nullptr) {
+    // nullptr only happens on controlled shutdown
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_SHUTTING_DOWN);
+  }
+
+  ClusterCommResult res;
+  {
+    JobGuard guard(SchedulerFeature::SCHEDULER);
+    guard.block();
+    res = cc->wait("AQL", _prefetchTransactionId, operationId, "",
+                   defaultTimeOut);
+  }
+
+  if (res.status != CL_COMM_RECEIVED) {
+    throwExceptionAfterBadSyncRequest(&res, false);
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_CLUSTER_AQL_COMMUNICATION);
+  }
+
+  VPackSlice responseBody = res.answer->payload();
+  if (!responseBody.isObject() ||
+      VelocyPackHelper::getBooleanValue(responseBody, "error", false)) {
+    int errorNum = VelocyPackHelper::readNumericValue<int>(
+        responseBody, "errorNum", TRI_ERROR_CLUSTER_AQL_COMMUNICATION);
+    std::string errorMessage = VelocyPackHelper::getStringValue(
+        responseBody, "errorMessage", "");
+    if (errorMessage.empty()) {
+      THROW_ARANGO_EXCEPTION(errorNum);
+    }
+    THROW_ARANGO_EXCEPTION_MESSAGE(errorNum, errorMessage);
+  }
+
+  if (VelocyPackHelper::getBooleanValue(responseBody, "exhausted", true)) {
+    _prefetchExhausted = true;
+    return;
+  }
+
+  auto response = std::make_shared<VPackBuilder>();
+  response->add(responseBody);
+  _prefetched.reset(blockFromResponse(response));
+}
+
+/// @brief create a block from a getSome response
+AqlItemBlock* RemoteBlock::blockFromResponse(
+    std::shared_ptr<VPackBuilder> const& response) const {
+  ResourceMonitor* resourceMonitor = _engine->getQuery()->resourceMonitor();
+  VPackSlice slice = response->slice();
+  size_t const size = static_cast<size_t>(slice.byteSize());
+
+  if (_retainedResponsesSize + size > MaxRetainedResponsesSize) {
+    // too much kept already, copy the values
+    return new AqlItemBlock(resourceMonitor, slice);
+  }
+
+  resourceMonitor->increaseMemoryUsage(size);
+  try {
+    _retainedResponses.emplace_back(response);
+  } catch (...) {
+    resourceMonitor->decreaseMemoryUsage(size);
+    throw;
+  }
+  _retainedResponsesSize += size;
+
+  return new AqlItemBlock(resourceMonitor, slice, false);
+}
+
+/// @brief send a getSome request ahead of time if there is none pending
+void RemoteBlock::prefetch(size_t atLeast, size_t atMost) {
+  if (!_prefetch || _prefetchOperationId != 0 || _prefetched != nullptr ||
+      _prefetchExhausted) {
+    return;
+  }
+  sendPrefetch(atLeast, atMost);
+}
+
+/// @brief wait for an outstanding prefetch request and drop its result
+void RemoteBlock::discardPrefetch() {
+  awaitPrefetch();
+  _prefetched.reset();
+  _prefetchExhausted = false;
+}
+
+/// @brief send an initializeCursor or shutdown request ahead of time
+void RemoteBlock::startRequest(std::string const& urlPart,
+                               std::string const& body) {
+  TRI_ASSERT(_startedOperationId == 0);
+  _startedTransactionId = TRI_NewTickServer();
+  _startedOperationId = sendAsyncRequest(
+      _startedTransactionId, rest::RequestType::PUT, urlPart, body);
+  _startedUrlPart = urlPart;
+}
+
+/// @brief wait for the request started for urlPart
+std::unique_ptr<ClusterCommResult> RemoteBlock::takeStartedRequest(
+    std::string const& urlPart) {
+  if (_startedOperationId == 0) {
+    return nullptr;
+  }
+
+  uint64_t const operationId = _startedOperationId;
+  _startedOperationId = 0;
+
+  auto cc = ClusterComm::instance();
+  if (cc == nullptr) {
+    // nullptr only happens on controlled shutdown
+    return std::make_unique<ClusterCommResult>();
+  }
+
+  if (urlPart != _startedUrlPart) {
+    // the caller did not follow up with the request it started, so the
+    // answer is of no use
+    cc->drop("AQL", _startedTransactionId, operationId, "");
+    return nullptr;
+  }
+
+  auto res = std::make_unique<ClusterCommResult>();
+  {
+    JobGuard guard(SchedulerFeature::SCHEDULER);
+    guard.block();
+    *res = cc->wait("AQL", _startedTransactionId, operationId, "",
+                    defaultTimeOut);
+  }
+
+  // map the status of an asynchronous answer to the one sendRequest
+  // reports, so that the callers can handle both alike
+  if (res->status == CL_COMM_RECEIVED) {
+    if (res->result != nullptr && res->result->wasHttpError()) {
+      res->status = CL_COMM_ERROR;
+    } else {
+      res->status = CL_COMM_SENT;
+    }
+  }
+  return res;
+}
+
 /// @brief initialize
 int RemoteBlock::initialize() {
   DEBUG_BEGIN_BLOCK();
@@ -1301,10 +1620,7 @@ int RemoteBlock::initialize() {
 
   // If we get here, then res->result is the response which will be
   // a serialized AqlItemBlock:
-  StringBuffer const& responseBodyBuf(res->result->getBody());
-
-  std::shared_ptr<VPackBuilder> builder =
-      VPackParser::fromJson(responseBodyBuf.c_str(), responseBodyBuf.length());
+  std::shared_ptr<VPackBuilder> builder = res->result->getBodyVelocyPack();
   VPackSlice slice = builder->slice();
 
   if (slice.hasKey("code")) {
@@ -1316,16 +1632,9 @@ int RemoteBlock::initialize() {
   DEBUG_END_BLOCK();
 }
 
-/// @brief initializeCursor, could be called multiple times
-int RemoteBlock::initializeCursor(AqlItemBlock* items, size_t pos) {
-  DEBUG_BEGIN_BLOCK();
-  // For every call we simply forward via HTTP
-
-  if (!_isResponsibleForInitializeCursor) {
-    // do nothing...
-    return TRI_ERROR_NO_ERROR;
-  }
-
+/// @brief body of an initializeCursor request
+std::string RemoteBlock::initializeCursorBody(AqlItemBlock* items,
+                                              size_t pos) const {
   VPackOptions options(VPackOptions::Defaults);
   options.buildUnindexedArrays = true;
   options.buildUnindexedObjects = true;
@@ -1349,18 +1658,48 @@ int RemoteBlock::initializeCursor(AqlItemBlock* items, size_t pos) {
 
   builder.close();
 
-  std::string bodyString(builder.slice().toJson());
+  return builder.slice().toJson();
+}
 
-  std::unique_ptr<ClusterCommResult> res = sendRequest(
-      rest::RequestType::PUT, "/_api/aql/initializeCursor/", bodyString);
+/// @brief send the initializeCursor request without waiting for its answer
+void RemoteBlock::startInitializeCursor(AqlItemBlock* items, size_t pos) {
+  // rows fetched ahead of time belong to the previous cursor
+  discardPrefetch();
+
+  if (!_isResponsibleForInitializeCursor) {
+    return;
+  }
+
+  // drops a request that was started but never picked up
+  takeStartedRequest("");
+  startRequest("/_api/aql/initializeCursor/", initializeCursorBody(items, pos));
+}
+
+/// @brief initializeCursor, could be called multiple times
+int RemoteBlock::initializeCursor(AqlItemBlock* items, size_t pos) {
+  DEBUG_BEGIN_BLOCK();
+  // For every call we simply forward via HTTP
+
+  // rows fetched ahead of time belong to the previous cursor
+  discardPrefetch();
+
+  if (!_isResponsibleForInitializeCursor) {
+    // do nothing...
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  std::unique_ptr<ClusterCommResult> res =
+      takeStartedRequest("/_api/aql/initializeCursor/");
+  if (res == nullptr) {
+    res = sendRequest(rest::RequestType::PUT, "/_api/aql/initializeCursor/",
+                      initializeCursorBody(items, pos));
+  }
   throwExceptionAfterBadSyncRequest(res.get(), false);
 
   // If we get here, then res->result is the response which will be
   // a serialized AqlItemBlock:
-  StringBuffer const& responseBodyBuf(res->result->getBody());
   {
-    std::shared_ptr<VPackBuilder> builder = VPackParser::fromJson(
-        responseBodyBuf.c_str(), responseBodyBuf.length());
+    std::shared_ptr<VPackBuilder> builder = res->result->getBodyVelocyPack();
 
     VPackSlice slice = builder->slice();
   
@@ -1374,15 +1713,40 @@ int RemoteBlock::initializeCursor(AqlItemBlock* items, size_t pos) {
   DEBUG_END_BLOCK();
 }
 
+/// @brief send the shutdown request without waiting for its answer
+void RemoteBlock::startShutdown(int errorCode) {
+  try {
+    discardPrefetch();
+  } catch (...) {
+    // the query is shut down anyway
+    _prefetched.reset();
+  }
+
+  // drops a request that was started but never picked up
+  takeStartedRequest("");
+  startRequest("/_api/aql/shutdown/",
+               "{\"code\":" + std::to_string(errorCode) + "}");
+}
+
 /// @brief shutdown, will be called exactly once for the whole query
 int RemoteBlock::shutdown(int errorCode) {
   DEBUG_BEGIN_BLOCK();
 
   // For every call we simply forward via HTTP
 
+  try {
+    discardPrefetch();
+  } catch (...) {
+    // the query is shut down anyway
+    _prefetched.reset();
+  }
+
   std::unique_ptr<ClusterCommResult> res =
-      sendRequest(rest::RequestType::PUT, "/_api/aql/shutdown/",
-                  std::string("{\"code\":" + std::to_string(errorCode) + "}"));
+      takeStartedRequest("/_api/aql/shutdown/");
+  if (res == nullptr) {
+    res = sendRequest(rest::RequestType::PUT, "/_api/aql/shutdown/",
+                      "{\"code\":" + std::to_string(errorCode) + "}");
+  }
   try {
     if (throwExceptionAfterBadSyncRequest(res.get(), true)) {
       // artificially ignore error in case query was not found during shutdown
@@ -1395,9 +1759,7 @@ int RemoteBlock::shutdown(int errorCode) {
     throw;
   }
 
-  StringBuffer const& responseBodyBuf(res->result->getBody());
-  std::shared_ptr<VPackBuilder> builder =
-      VPackParser::fromJson(responseBodyBuf.c_str(), responseBodyBuf.length());
+  std::shared_ptr<VPackBuilder> builder = res->result->getBodyVelocyPack();
   VPackSlice slice = builder->slice();
    
   if (slice.isObject()) {
@@ -1439,30 +1801,54 @@ AqlItemBlock* RemoteBlock::getSome(size_t atLeast, size_t atMost) {
   
   traceGetSomeBegin();
 
-  VPackBuilder builder;
-  builder.openObject();
-  builder.add("atLeast", VPackValue(atLeast));
-  builder.add("atMost", VPackValue(atMost));
-  builder.close();
+  awaitPrefetch();
 
-  std::string bodyString(builder.slice().toJson());
+  std::unique_ptr<AqlItemBlock> r;
+  if (_prefetched != nullptr) {
+    // use the block fetched ahead of time
+    size_t const n = _prefetched->size();
+    if (n <= atMost) {
+      r = std::move(_prefetched);
+    } else {
+      r.reset(_prefetched->slice(0, atMost));
+      _prefetched.reset(_prefetched->slice(atMost, n));
+    }
+  } else if (_prefetchExhausted) {
+    traceGetSomeEnd(nullptr);
+    return nullptr;
+  } else {
+    VPackBuilder builder;
+    builder.openObject();
+    builder.add("atLeast", VPackValue(atLeast));
+    builder.add("atMost", VPackValue(atMost));
+    builder.close();
 
-  std::unique_ptr<ClusterCommResult> res =
-      sendRequest(rest::RequestType::PUT, "/_api/aql/getSome/", bodyString);
-  throwExceptionAfterBadSyncRequest(res.get(), false);
+    std::string bodyString(builder.slice().toJson());
 
-  // If we get here, then res->result is the response which will be
-  // a serialized AqlItemBlock:
-  std::shared_ptr<VPackBuilder> responseBodyBuilder =
-      res->result->getBodyVelocyPack();
-  VPackSlice responseBody = responseBodyBuilder->slice();
+    std::unique_ptr<ClusterCommResult> res =
+        sendRequest(rest::RequestType::PUT, "/_api/aql/getSome/", bodyString);
+    throwExceptionAfterBadSyncRequest(res.get(), false);
 
-  if (VelocyPackHelper::getBooleanValue(responseBody, "exhausted", true)) {
-    traceGetSomeEnd(nullptr);
-    return nullptr;
+    // If we get here, then res->result is the response which will be
+    // a serialized AqlItemBlock:
+    std::shared_ptr<VPackBuilder> responseBodyBuilder =
+        res->result->getBodyVelocyPack();
+    VPackSlice responseBody = responseBodyBuilder->slice();
+
+    if (VelocyPackHelper::getBooleanValue(responseBody, "exhausted", true)) {
+      traceGetSomeEnd(nullptr);
+      return nullptr;
+    }
+
+    r.reset(blockFromResponse(responseBodyBuilder));
+  }
+
+  if (_prefetch && _prefetched == nullptr) {
+    // let the remote side produce the next block while the caller
+    // processes this one
+    sendPrefetch(atLeast, atMost);
   }
 
-  auto r = std::make_unique<AqlItemBlock>(_engine->getQuery()->resourceMonitor(), responseBody);
   traceGetSomeEnd(r.get());
   return r.release();
 
@@ -1473,6 +1859,27 @@ AqlItemBlock* RemoteBlock::getSome(size_t atLeast, size_t atMost) {
 /// @brief skipSome
 size_t RemoteBlock::skipSome(size_t atLeast, size_t atMost) {
   DEBUG_BEGIN_BLOCK();
+  traceSkipSomeBegin();
+
+  // first skip the rows fetched ahead of time
+  awaitPrefetch();
+  size_t skippedLocally = 0;
+  if (_prefetched != nullptr) {
+    size_t const n = _prefetched->size();
+    skippedLocally = (std::min)(n, atMost);
+    if (skippedLocally == n) {
+      _prefetched.reset();
+    } else {
+      _prefetched.reset(_prefetched->slice(skippedLocally, n));
+    }
+  }
+  if (skippedLocally >= atLeast || _prefetchExhausted) {
+    traceSkipSomeEnd(skippedLocally);
+    return skippedLocally;
+  }
+  atLeast -= skippedLocally;
+  atMost -= skippedLocally;
+
   // For every call we simply forward via HTTP
 
   VPackBuilder builder;
@@ -1489,19 +1896,18 @@ size_t RemoteBlock::skipSome(size_t atLeast, size_t atMost) {
 
   // If we get here, then res->result is the response which will be
   // a serialized AqlItemBlock:
-  StringBuffer const& responseBodyBuf(res->result->getBody());
   {
-    std::shared_ptr<VPackBuilder> builder = VPackParser::fromJson(
-        responseBodyBuf.c_str(), responseBodyBuf.length());
+    std::shared_ptr<VPackBuilder> builder = res->result->getBodyVelocyPack();
     VPackSlice slice = builder->slice();
 
     if (!slice.hasKey("error") || slice.get("error").getBoolean()) {
       THROW_ARANGO_EXCEPTION(TRI_ERROR_CLUSTER_AQL_COMMUNICATION);
     }
-    size_t skipped = 0;
+    size_t skipped = skippedLocally;
     if (slice.hasKey("skipped")) {
-      skipped = slice.get("skipped").getNumericValue<size_t>();
+      skipped += slice.get("skipped").getNumericValue<size_t>();
     }
+    traceSkipSomeEnd(skipped);
     return skipped;
   }
 
@@ -1512,6 +1918,14 @@ size_t RemoteBlock::skipSome(size_t atLeast, size_t atMost) {
 /// @brief hasMore
 bool RemoteBlock::hasMore() {
   DEBUG_BEGIN_BLOCK();
+  awaitPrefetch();
+  if (_prefetched != nullptr) {
+    return true;
+  }
+  if (_prefetchExhausted) {
+    return false;
+  }
+
   // For every call we simply forward via HTTP
   std::unique_ptr<ClusterCommResult> res =
       sendRequest(rest::RequestType::GET, "/_api/aql/hasMore/", std::string());
@@ -1519,9 +1933,7 @@ bool RemoteBlock::hasMore() {
 
   // If we get here, then res->result is the response which will be
   // a serialized AqlItemBlock:
-  StringBuffer const& responseBodyBuf(res->result->getBody());
-  std::shared_ptr<VPackBuilder> builder =
-      VPackParser::fromJson(responseBodyBuf.c_str(), responseBodyBuf.length());
+  std::shared_ptr<VPackBuilder> builder = res->result->getBodyVelocyPack();
   VPackSlice slice = builder->slice();
 
   if (!slice.hasKey("error") || slice.get("error").getBoolean()) {
@@ -1540,6 +1952,9 @@ bool RemoteBlock::hasMore() {
 /// @brief count
 int64_t RemoteBlock::count() const {
   DEBUG_BEGIN_BLOCK();
+  // the remote query cannot handle a second request at the same time
+  awaitPrefetch();
+
   // For every call we simply forward via HTTP
   std::unique_ptr<ClusterCommResult> res =
       sendRequest(rest::RequestType::GET, "/_api/aql/count/", std::string());
@@ -1547,9 +1962,7 @@ int64_t RemoteBlock::count() const {
 
   // If we get here, then res->result is the response which will be
   // a serialized AqlItemBlock:
-  StringBuffer const& responseBodyBuf(res->result->getBody());
-  std::shared_ptr<VPackBuilder> builder =
-      VPackParser::fromJson(responseBodyBuf.c_str(), responseBodyBuf.length());
+  std::shared_ptr<VPackBuilder> builder = res->result->getBodyVelocyPack();
   VPackSlice slice = builder->slice();
 
   if (!slice.hasKey("error") || slice.get("error").getBoolean()) {
@@ -1569,6 +1982,11 @@ int64_t RemoteBlock::count() const {
 /// @brief remaining
 int64_t RemoteBlock::remaining() {
   DEBUG_BEGIN_BLOCK();
+  awaitPrefetch();
+  if (_prefetchExhausted) {
+    return _prefetched == nullptr ? 0 : static_cast<int64_t>(_prefetched->size());
+  }
+
   // For every call we simply forward via HTTP
   std::unique_ptr<ClusterCommResult> res = sendRequest(
       rest::RequestType::GET, "/_api/aql/remaining/", std::string());
@@ -1576,9 +1994,7 @@ int64_t RemoteBlock::remaining() {
 
   // If we get here, then res->result is the response which will be
   // a serialized AqlItemBlock:
-  StringBuffer const& responseBodyBuf(res->result->getBody());
-  std::shared_ptr<VPackBuilder> builder =
-      VPackParser::fromJson(responseBodyBuf.c_str(), responseBodyBuf.length());
+  std::shared_ptr<VPackBuilder> builder = res->result->getBodyVelocyPack();
   VPackSlice slice = builder->slice();
 
   if (!slice.hasKey("error") || slice.get("error").getBoolean()) {
@@ -1589,6 +2005,9 @@ int64_t RemoteBlock::remaining() {
   if (slice.hasKey("remaining")) {
     remaining = slice.get("remaining").getNumericValue<int64_t>();
   }
+  if (_prefetched != nullptr) {
+    remaining += static_cast<int64_t>(_prefetched->size());
+  }
   return remaining;
 
   // cppcheck-suppress style
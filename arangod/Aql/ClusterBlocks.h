@@ -80,6 +80,11 @@ class GatherBlock : public ExecutionBlock {
   /// non-simple case only
   bool getBlock(size_t i, size_t atLeast, size_t atMost);
 
+  /// @brief let all remote dependencies starting at `first` produce their
+  /// next block in parallel, so that pulling from them does not wait for
+  /// one round-trip per shard in turn
+  void prefetchDependencies(size_t first, size_t atLeast, size_t atMost);
+
   /// @brief _gatherBlockBuffer: buffer the incoming block from each dependency
   /// separately
   std::vector<std::deque<AqlItemBlock*>> _gatherBlockBuffer;
@@ -328,12 +333,64 @@ class RemoteBlock : public ExecutionBlock {
   /// @brief remaining
   int64_t remaining() override final;
 
+  /// @brief send a getSome request ahead of time unless there is one in
+  /// flight already or its result has not been picked up yet
+  void prefetch(size_t atLeast, size_t atMost);
+
+  /// @brief send the initializeCursor request without waiting for its
+  /// answer, which is picked up by the next call to initializeCursor
+  void startInitializeCursor(AqlItemBlock* items, size_t pos);
+
+  /// @brief send the shutdown request without waiting for its answer,
+  /// which is picked up by the call to shutdown
+  void startShutdown(int errorCode);
+
   /// @brief internal method to send a request
  private:
   std::unique_ptr<arangodb::ClusterCommResult> sendRequest(
       rest::RequestType type, std::string const& urlPart,
       std::string const& body) const;
 
+  /// @brief internal method to send a request without waiting for its
+  /// answer, returns the operation id or 0 during shutdown
+  uint64_t sendAsyncRequest(TRI_voc_tick_t transactionId,
+                            rest::RequestType type, std::string const& urlPart,
+                            std::string const& body) const;
+
+  /// @brief send an initializeCursor or shutdown request ahead of time
+  void startRequest(std::string const& urlPart, std::string const& body);
+
+  /// @brief wait for the request started by startRequest for urlPart and
+  /// return its answer in the form sendRequest would have. returns a
+  /// nullptr if no such request is pending
+  std::unique_ptr<arangodb::ClusterCommResult> takeStartedRequest(
+      std::string const& urlPart);
+
+  /// @brief body of an initializeCursor request
+  std::string initializeCursorBody(AqlItemBlock* items, size_t pos) const;
+
+  /// @brief send the next getSome request ahead of time, so that the remote
+  /// side produces the next block while we process the current one
+  void sendPrefetch(size_t atLeast, size_t atMost);
+
+  /// @brief wait for the response of an outstanding prefetch request and
+  /// keep its block in _prefetched. must be called before any other request
+  /// is sent, as the remote query can only handle one request at a time
+  void awaitPrefetch() const;
+
+  /// @brief wait for an outstanding prefetch request and drop its result
+  void discardPrefetch();
+
+  /// @brief create a block from a getSome response. while the responses
+  /// kept so far are below MaxRetainedResponsesSize, the response is kept
+  /// until the query ends and the values of the block point into it
+  /// instead of being copied one by one
+  AqlItemBlock* blockFromResponse(
+      std::shared_ptr<arangodb::velocypack::Builder> const& response) const;
+
+  /// @brief maximum total size of the getSome responses kept by a block
+  static constexpr size_t MaxRetainedResponsesSize = 64 * 1024 * 1024;
+
   /// @brief our server, can be like "shard:S1000" or like "server:Claus"
   std::string _server;
 
@@ -347,6 +404,33 @@ class RemoteBlock : public ExecutionBlock {
   /// @brief whether or not this block will forward initialize, 
   /// initializeCursor or shutDown requests
   bool const _isResponsibleForInitializeCursor;
+
+  /// @brief whether or not getSome requests are sent ahead of time. only
+  /// done on the coordinator
+  bool const _prefetch;
+
+  /// @brief ids of the outstanding prefetch request, 0 if there is none
+  mutable TRI_voc_tick_t _prefetchTransactionId;
+  mutable uint64_t _prefetchOperationId;
+
+  /// @brief block received for a prefetch request, not yet returned
+  mutable std::unique_ptr<AqlItemBlock> _prefetched;
+
+  /// @brief whether a prefetch request reported that the remote side is
+  /// exhausted
+  mutable bool _prefetchExhausted;
+
+  /// @brief ids and url of the request sent by startRequest, the operation
+  /// id is 0 if there is none
+  TRI_voc_tick_t _startedTransactionId;
+  uint64_t _startedOperationId;
+  std::string _startedUrlPart;
+
+  /// @brief getSome responses referenced by the values of the blocks we
+  /// returned, and their total size
+  mutable std::vector<std::shared_ptr<arangodb::velocypack::Builder>>
+      _retainedResponses;
+  mutable size_t _retainedResponsesSize;
 };
 
 }  // namespace arangodb::aql
@@ -26,6 +26,8 @@
 #include "Aql/AqlValue.h"
 #include "Aql/AqlItemBlock.h"
 #include "Aql/ExecutionEngine.h"
+#include "Aql/Query.h"
+#include "Aql/SpillFile.h"
 #include "Basics/Exceptions.h"
 #include "Basics/VelocyPackHelper.h"
 #include "VocBase/vocbase.h"
@@ -519,6 +521,64 @@ void SortedCollectBlock::skipGroup() {
   _currentGroup.reset();
 }
 
+CollectSpillPolicy::CollectSpillPolicy(size_t threshold, size_t numPartitions)
+    : _threshold(threshold),
+      _partitions(numPartitions, 0),
+      _frozen(numPartitions, false),
+      _memoryUsage(0),
+      _nextFreeze(threshold) {
+  TRI_ASSERT(numPartitions > 0);
+}
+
+/// @brief the partition of a group
+size_t CollectSpillPolicy::partition(size_t hash, size_t level) const {
+  // use the upper bits of the hash, the lower ones pick the bucket inside
+  // the partition's hash table. each level uses the next four bits
+  uint64_t const value = static_cast<uint64_t>(hash);
+  return static_cast<size_t>((value >> (24 + 4 * (level % 8))) %
+                             _partitions.size());
+}
+
+/// @brief account for the memory of new groups in a partition
+void CollectSpillPolicy::add(size_t partition, size_t memoryUsage) {
+  TRI_ASSERT(partition < _partitions.size());
+  _partitions[partition] += memoryUsage;
+  _memoryUsage += memoryUsage;
+
+  if (_threshold > 0 && _memoryUsage >= _nextFreeze) {
+    freeze();
+    _nextFreeze = _memoryUsage + _threshold / _partitions.size();
+  }
+}
+
+/// @brief freeze the largest partitions until the frozen ones hold at least
+/// half of the memory of all groups, but at least one
+void CollectSpillPolicy::freeze() {
+  size_t frozen = 0;
+  for (size_t i = 0; i < _partitions.size(); ++i) {
+    if (_frozen[i]) {
+      frozen += _partitions[i];
+    }
+  }
+
+  do {
+    size_t largest = _partitions.size();
+    for (size_t i = 0; i < _partitions.size(); ++i) {
+      if (!_frozen[i] &&
+          (largest == _partitions.size() ||
+           _partitions[i] > _partitions[largest])) {
+        largest = i;
+      }
+    }
+    if (largest == _partitions.size()) {
+      // all partitions are frozen
+      break;
+    }
+    _frozen[largest] = true;
+    frozen += _partitions[largest];
+  } while (frozen < _memoryUsage / 2);
+}
+
 HashedCollectBlock::HashedCollectBlock(ExecutionEngine* engine,
                                        CollectNode const* en)
     : ExecutionBlock(engine, en),
@@ -579,62 +639,154 @@ HashedCollectBlock::HashedCollectBlock(ExecutionEngine* engine,
 
 HashedCollectBlock::~HashedCollectBlock() {}
 
-int HashedCollectBlock::getOrSkipSome(size_t atLeast, size_t atMost,
-                                      bool skipping, AqlItemBlock*& result,
-                                      size_t& skipped) {
-  TRI_ASSERT(result == nullptr && skipped == 0);
+HashedCollectBlock::Partition::Partition(transaction::Methods* trx, size_t num)
+    : groups(1024, GroupKeyHash(trx, num), GroupKeyEqual(trx)),
+      pendingRows(0) {}
+
+HashedCollectBlock::Partition::~Partition() {}
+
+int HashedCollectBlock::initializeCursor(AqlItemBlock* items, size_t pos) {
+  // removes the temporary files of spilled partitions
+  _spilled.clear();
+  return ExecutionBlock::initializeCursor(items, pos);
+}
 
+bool HashedCollectBlock::hasMore() {
   if (_done) {
-    return TRI_ERROR_NO_ERROR;
+    return false;
   }
+  // the groups of spilled partitions are still to be returned, while the
+  // dependency is already exhausted
+  if (!_spilled.empty()) {
+    return true;
+  }
+  return ExecutionBlock::hasMore();
+}
 
-  if (_buffer.empty()) {
-    if (!ExecutionBlock::getBlock(atLeast, atMost)) {
-      // done
-      _done = true;
-
-      return TRI_ERROR_NO_ERROR;
+/// @brief destroy all groups of a map, including their keys
+void HashedCollectBlock::destroyGroups(GroupMap& groups) {
+  for (auto& it : groups) {
+    for (auto& key : it.first) {
+      const_cast<AqlValue*>(&key)->destroy();
     }
-    _pos = 0;  // this is in the first block
+    delete it.second;
   }
+  groups.clear();
+}
 
+/// @brief aggregate a row into its group. creates the group if it does not
+/// yet exist and mayCreate is true. returns false if the group does
+/// not exist and was not created
+bool HashedCollectBlock::aggregateRow(GroupMap& groups, AqlItemBlock const* cur,
+                                      size_t pos,
+                                      std::vector<AqlValue> const& groupValues,
+                                      bool mayCreate, size_t& memoryUsage) {
   auto* en = static_cast<CollectNode const*>(_exeNode);
 
-  // If we get here, we do have _buffer.front()
-  AqlItemBlock* cur = _buffer.front();
-  TRI_ASSERT(cur != nullptr);
-  size_t const curNrRegs = cur->getNrRegs();
+  // now check if we already know this group
+  auto it = groups.find(groupValues);
 
-  TRI_ASSERT(_aggregateRegisters.size() == en->_aggregateVariables.size());
+  if (it == groups.end()) {
+    if (!mayCreate) {
+      return false;
+    }
 
-  std::unordered_map<std::vector<AqlValue>, AggregateValuesType*, GroupKeyHash,
-                     GroupKeyEqual> allGroups(1024,
-                                              GroupKeyHash(_trx, _groupRegisters.size()),
-                                              GroupKeyEqual(_trx));
+    // new group
+    size_t const n = _groupRegisters.size();
+    std::vector<AqlValue> group;
+    group.reserve(n);
 
-  // cleanup function for group values
-  auto cleanup = [&allGroups]() -> void {
-    for (auto& it : allGroups) {
-      delete it.second;
+    // copy the group values before they get invalidated
+    try {
+      for (size_t i = 0; i < n; ++i) {
+        group.emplace_back(
+            cur->getValueReference(pos, _groupRegisters[i].second).clone());
+        memoryUsage += sizeof(AqlValue) + group.back().memoryUsage();
+      }
+    } catch (...) {
+      for (auto& it2 : group) {
+        it2.destroy();
+      }
+      throw;
     }
-  };
 
-  // prevent memory leaks by always cleaning up the groups
-  TRI_DEFER(cleanup());
+    auto aggregateValues = std::make_unique<AggregateValuesType>();
 
-  auto buildResult = [&](AqlItemBlock const* src) {
-    RegisterId nrRegs = en->getRegisterPlan()->nrRegs[en->getDepth()];
+    if (en->_aggregateVariables.empty()) {
+      // no aggregate registers. this means we'll only count the number of
+      // items
+      if (en->_count) {
+        aggregateValues->emplace_back(std::make_unique<AggregatorLength>(_trx, 1));
+      }
+    } else {
+      // we do have aggregate registers. create them as empty AqlValues
+      aggregateValues->reserve(_aggregateRegisters.size());
+
+      // initialize aggregators
+      size_t j = 0;
+      for (auto const& r : en->_aggregateVariables) {
+        aggregateValues->emplace_back(Aggregator::fromTypeString(_trx, r.second.second));
+        aggregateValues->back()->reduce(
+            GetValueForRegister(cur, pos, _aggregateRegisters[j].second));
+        ++j;
+      }
+    }
 
-    std::unique_ptr<AqlItemBlock> result(requestBlock(allGroups.size(), nrRegs));
+    // rough estimate for the hash table node and the aggregators
+    memoryUsage += 64 + sizeof(AggregateValuesType) +
+                   aggregateValues->size() * 64;
 
-    if (src != nullptr) {
-      inheritRegisters(src, result.get(), 0);
+    // note: aggregateValues may be a nullptr!
+    groups.emplace(group, aggregateValues.get());
+    aggregateValues.release();
+  } else {
+    // existing group
+    auto aggregateValues = (*it).second;
+
+    if (en->_aggregateVariables.empty()) {
+      // no aggregate registers. simply increase the counter
+      if (en->_count) {
+        TRI_ASSERT(!aggregateValues->empty());
+        aggregateValues->back()->reduce(AqlValue());
+      }
+    } else {
+      // apply the aggregators for the group
+      TRI_ASSERT(aggregateValues->size() == _aggregateRegisters.size());
+      size_t j = 0;
+      for (auto const& r : _aggregateRegisters) {
+        (*aggregateValues)[j]->reduce(
+            GetValueForRegister(cur, pos, r.second));
+        ++j;
+      }
     }
+  }
 
-    TRI_ASSERT(!en->_count || _collectRegister != ExecutionNode::MaxRegisterId);
+  return true;
+}
 
-    size_t row = 0;
-    for (auto& it : allGroups) {
+/// @brief build the result block for all groups of the given maps. the
+/// group keys and values are moved into the result
+AqlItemBlock* HashedCollectBlock::buildResult(std::vector<GroupMap*> const& maps,
+                                              AqlItemBlock const* src) {
+  auto* en = static_cast<CollectNode const*>(_exeNode);
+  RegisterId nrRegs = en->getRegisterPlan()->nrRegs[en->getDepth()];
+  RegisterId const curNrRegs = src->getNrRegs();
+
+  size_t total = 0;
+  for (auto const& groups : maps) {
+    total += groups->size();
+  }
+  TRI_ASSERT(total > 0);
+
+  std::unique_ptr<AqlItemBlock> result(requestBlock(total, nrRegs));
+
+  inheritRegisters(src, result.get(), 0);
+
+  TRI_ASSERT(!en->_count || _collectRegister != ExecutionNode::MaxRegisterId);
+
+  size_t row = 0;
+  for (auto const& groups : maps) {
+    for (auto& it : *groups) {
       auto& keys = it.first;
       TRI_ASSERT(it.second != nullptr);
 
@@ -658,164 +810,234 @@ int HashedCollectBlock::getOrSkipSome(size_t atLeast, size_t atMost,
         result->setValue(row, _collectRegister,
                          it.second->back()->stealValue());
       }
-      
+
       if (row > 0) {
         // re-use already copied AQLValues for remaining registers
-        result->copyValuesFromFirstRow(row, static_cast<RegisterId>(curNrRegs));
+        result->copyValuesFromFirstRow(row, curNrRegs);
       }
 
-
       ++row;
     }
+  }
 
-    return result.release();
-  };
-
-  std::vector<AqlValue> groupValues;
-  size_t const n = _groupRegisters.size();
-  groupValues.reserve(n);
-
-  std::vector<AqlValue> group;
-  group.reserve(n);
+  return result.release();
+}
 
-  try {
-    while (skipped < atMost) {
-      TRI_IF_FAILURE("HashedCollectBlock::getOrSkipSomeOuter") {
-        THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
-      }
+/// @brief copy a row into the pending block of a frozen partition
+void HashedCollectBlock::spillRow(Partition& partition, AqlItemBlock const* cur,
+                                  size_t pos) {
+  RegisterId const nrRegs = cur->getNrRegs();
 
-      throwIfKilled();  // check if we were aborted
+  if (partition.pending == nullptr) {
+    partition.pending.reset(requestBlock(DefaultBatchSize(), nrRegs));
+    partition.pendingRows = 0;
+  }
 
-      groupValues.clear();
+  for (RegisterId r = 0; r < nrRegs; ++r) {
+    AqlValue const& a = cur->getValueReference(pos, r);
+    if (a.isEmpty()) {
+      continue;
+    }
+    AqlValue b = a.clone();
+    try {
+      partition.pending->setValue(partition.pendingRows, r, b);
+    } catch (...) {
+      b.destroy();
+      throw;
+    }
+  }
 
-      // for hashing simply re-use the aggregate registers, without cloning
-      // their contents
-      for (size_t i = 0; i < n; ++i) {
-        groupValues.emplace_back(
-            cur->getValueReference(_pos, _groupRegisters[i].second));
-      }
+  if (++partition.pendingRows == DefaultBatchSize()) {
+    flushPartition(partition);
+  }
+}
 
-      // now check if we already know this group
-      auto it = allGroups.find(groupValues);
+/// @brief write the pending block of a partition to its temporary file
+void HashedCollectBlock::flushPartition(Partition& partition) {
+  if (partition.pending == nullptr) {
+    return;
+  }
 
-      if (it == allGroups.end()) {
-        // new group
-        group.clear();
+  if (partition.spill == nullptr) {
+    partition.spill.reset(new SpillFile(_trx));
+  }
 
-        // copy the group values before they get invalidated
-        for (size_t i = 0; i < n; ++i) {
-          group.emplace_back(
-              cur->getValueReference(_pos, _groupRegisters[i].second).clone());
-        }
+  if (partition.pendingRows < partition.pending->size()) {
+    partition.pending->shrink(partition.pendingRows, false);
+  }
+  partition.spill->write(partition.pending.get());
 
-        auto aggregateValues = std::make_unique<AggregateValuesType>();
+  AqlItemBlock* block = partition.pending.release();
+  returnBlock(block);
+  partition.pendingRows = 0;
+}
 
-        if (en->_aggregateVariables.empty()) {
-          // no aggregate registers. this means we'll only count the number of
-          // items
-          if (en->_count) {
-            aggregateValues->emplace_back(std::make_unique<AggregatorLength>(_trx, 1));
-          }
-        } else {
-          // we do have aggregate registers. create them as empty AqlValues
-          aggregateValues->reserve(_aggregateRegisters.size());
-
-          // initialize aggregators
-          size_t j = 0;
-          for (auto const& r : en->_aggregateVariables) {
-            aggregateValues->emplace_back(Aggregator::fromTypeString(_trx, r.second.second));
-            aggregateValues->back()->reduce(
-                GetValueForRegister(cur, _pos, _aggregateRegisters[j].second));
-            ++j;
-          }
-        }
+/// @brief aggregate all rows returned by next
+AqlItemBlock* HashedCollectBlock::aggregate(
+    std::function<AqlItemBlock*()> const& next, size_t level) {
+  size_t const n = _groupRegisters.size();
 
-        // note: aggregateValues may be a nullptr!
-        allGroups.emplace(group, aggregateValues.get());
-        aggregateValues.release();
-      } else {
-        // existing group
-        auto aggregateValues = (*it).second;
-
-        if (en->_aggregateVariables.empty()) {
-          // no aggregate registers. simply increase the counter
-          if (en->_count) {
-            TRI_ASSERT(!aggregateValues->empty());
-            aggregateValues->back()->reduce(AqlValue());
-          }
-        } else {
-          // apply the aggregators for the group
-          TRI_ASSERT(aggregateValues->size() == _aggregateRegisters.size());
-          size_t j = 0;
-          for (auto const& r : _aggregateRegisters) {
-            (*aggregateValues)[j]->reduce(
-                GetValueForRegister(cur, _pos, r.second));
-            ++j;
-          }
-        }
-      }
+  // if a spill threshold is set, the groups are hash-partitioned. a frozen
+  // partition still aggregates rows of its existing groups, but writes all
+  // rows of new groups to disk
+  size_t const threshold =
+      _engine->getQuery()->queryOptions().collectSpillThreshold;
+  size_t const numPartitions = (threshold > 0 ? NumPartitions : 1);
+  CollectSpillPolicy policy(threshold, numPartitions);
+
+  std::vector<std::unique_ptr<Partition>> partitions;
+  partitions.reserve(numPartitions);
+  for (size_t i = 0; i < numPartitions; ++i) {
+    partitions.emplace_back(std::make_unique<Partition>(_trx, n));
+  }
 
-      if (++_pos >= cur->size()) {
-        _buffer.pop_front();
-        _pos = 0;
+  // cleanup function for group values
+  auto cleanup = [&partitions]() -> void {
+    for (auto& it : partitions) {
+      destroyGroups(it->groups);
+    }
+  };
 
-        bool hasMore = !_buffer.empty();
+  // prevent memory leaks by always cleaning up the groups
+  TRI_DEFER(cleanup());
 
-        if (!hasMore) {
-          hasMore = ExecutionBlock::getBlock(atLeast, atMost);
-        }
+  GroupKeyHash hasher(_trx, n);
 
-        if (!hasMore) {
-          // no more input. we're done
-          try {
-            // emit last buffered group
-            if (!skipping) {
-              TRI_IF_FAILURE("HashedCollectBlock::getOrSkipSome") {
-                THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
-              }
+  std::vector<AqlValue> groupValues;
+  groupValues.reserve(n);
 
-              throwIfKilled();
-            }
+  // the last block is kept for inheriting the registers of the result
+  AqlItemBlock* cur = next();
+  TRI_ASSERT(cur != nullptr);
 
-            ++skipped;
-            result = buildResult(cur);
+  try {
+    while (true) {
+      for (size_t pos = 0; pos < cur->size(); ++pos) {
+        TRI_IF_FAILURE("HashedCollectBlock::getOrSkipSomeOuter") {
+          THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
+        }
 
-            returnBlock(cur);
-            _done = true;
+        throwIfKilled();  // check if we were aborted
 
-            groupValues.clear();
+        groupValues.clear();
 
-            return TRI_ERROR_NO_ERROR;
-          } catch (...) {
-            returnBlock(cur);
-            throw;
-          }
+        // for hashing simply re-use the aggregate registers, without cloning
+        // their contents
+        for (size_t i = 0; i < n; ++i) {
+          groupValues.emplace_back(
+              cur->getValueReference(pos, _groupRegisters[i].second));
         }
 
-        // hasMore
+        size_t index = 0;
+        if (numPartitions > 1) {
+          index = policy.partition(hasher(groupValues), level);
+        }
+        Partition& partition = *partitions[index];
+
+        size_t memoryUsage = 0;
+        if (!aggregateRow(partition.groups, cur, pos, groupValues,
+                          !policy.isFrozen(index), memoryUsage)) {
+          spillRow(partition, cur, pos);
+        } else if (memoryUsage > 0 && threshold > 0) {
+          policy.add(index, memoryUsage);
+        }
+      }
 
-        returnBlock(cur);
-        cur = _buffer.front();
+      AqlItemBlock* following = next();
+      if (following == nullptr) {
+        break;
       }
+      returnBlock(cur);
+      cur = following;
     }
-  } catch (...) {
-    // clean up
-    for (auto& it : allGroups) {
-      for (auto& it2 : it.first) {
-        const_cast<AqlValue*>(&it2)->destroy();
+
+    TRI_IF_FAILURE("HashedCollectBlock::getOrSkipSome") {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
+    }
+
+    std::vector<GroupMap*> maps;
+    for (auto& it : partitions) {
+      flushPartition(*it);
+      if (it->spill != nullptr) {
+        SpilledPartition spilled;
+        spilled.file = std::move(it->spill);
+        spilled.level = level + 1;
+        _spilled.emplace_back(std::move(spilled));
+      }
+      if (!it->groups.empty()) {
+        maps.emplace_back(&it->groups);
       }
     }
+
+    AqlItemBlock* result = buildResult(maps, cur);
+    returnBlock(cur);
+    return result;
+  } catch (...) {
+    returnBlock(cur);
     throw;
   }
+}
 
-  groupValues.clear();
+int HashedCollectBlock::getOrSkipSome(size_t atLeast, size_t atMost,
+                                      bool skipping, AqlItemBlock*& result,
+                                      size_t& skipped) {
+  TRI_ASSERT(result == nullptr && skipped == 0);
 
-  if (!skipping) {
-    TRI_ASSERT(skipped > 0);
+  std::unique_ptr<AqlItemBlock> res;
+
+  if (!_spilled.empty()) {
+    // all input has been consumed by a previous call. now aggregate the
+    // spilled partitions, one per call. the groups of a spilled partition
+    // are disjoint from the groups returned before. rows of new groups that
+    // do not fit into memory are spilled again, split on the next level
+    SpilledPartition spilled(std::move(_spilled.back()));
+    _spilled.pop_back();
+
+    ResourceMonitor* resourceMonitor = _engine->getQuery()->resourceMonitor();
+    spilled.file->rewind();
+
+    res.reset(aggregate(
+        [&spilled, resourceMonitor]() -> AqlItemBlock* {
+          return spilled.file->read(resourceMonitor);
+        },
+        spilled.level));
+  } else {
+    if (_done) {
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    if (_buffer.empty()) {
+      if (!ExecutionBlock::getBlock(atLeast, atMost)) {
+        // done
+        _done = true;
+
+        return TRI_ERROR_NO_ERROR;
+      }
+    }
+    TRI_ASSERT(_pos == 0);
+
+    res.reset(aggregate(
+        [this, atLeast, atMost]() -> AqlItemBlock* {
+          if (_buffer.empty() && !ExecutionBlock::getBlock(atLeast, atMost)) {
+            return nullptr;
+          }
+          AqlItemBlock* cur = _buffer.front();
+          _buffer.pop_front();
+          _pos = 0;
+          return cur;
+        },
+        0));
   }
 
-  result = buildResult(nullptr);
+  _done = _spilled.empty();
 
+  skipped = res->size();
+  if (skipping) {
+    AqlItemBlock* block = res.release();
+    returnBlock(block);
+  } else {
+    result = res.release();
+  }
   return TRI_ERROR_NO_ERROR;
 }
 
@@ -852,3 +1074,70 @@ bool HashedCollectBlock::GroupKeyEqual::operator()(
 
   return true;
 }
+
+CountCollectBlock::CountCollectBlock(ExecutionEngine* engine,
+                                     CollectNode const* en)
+    : ExecutionBlock(engine, en),
+      _collectRegister(ExecutionNode::MaxRegisterId) {
+  TRI_ASSERT(en->_groupVariables.empty());
+  TRI_ASSERT(en->_aggregateVariables.empty());
+  TRI_ASSERT(en->_count && en->_outVariable != nullptr);
+
+  auto const& registerPlan = en->getRegisterPlan()->varInfo;
+  auto it = registerPlan.find(en->_outVariable->id);
+  TRI_ASSERT(it != registerPlan.end());
+  _collectRegister = (*it).second.registerId;
+  TRI_ASSERT(_collectRegister > 0 &&
+             _collectRegister < ExecutionNode::MaxRegisterId);
+}
+
+int CountCollectBlock::getOrSkipSome(size_t atLeast, size_t atMost,
+                                     bool skipping, AqlItemBlock*& result,
+                                     size_t& skipped) {
+  TRI_ASSERT(result == nullptr && skipped == 0);
+
+  if (_done) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  TRI_ASSERT(_dependencies.size() == 1);
+
+  // fetch the first input row only, as its registers are inherited by the
+  // result. all other rows are skipped, which allows index and collection
+  // scans to count them without looking at the documents
+  uint64_t count = 0;
+
+  if (ExecutionBlock::getBlock(1, 1)) {
+    count += _buffer.front()->size();
+
+    size_t skippedHere;
+    do {
+      throwIfKilled();  // check if we were aborted
+
+      skippedHere = _dependencies[0]->skipSome(SkipBatchSize, SkipBatchSize);
+      count += skippedHere;
+    } while (skippedHere == SkipBatchSize);
+  }
+
+  _done = true;
+  skipped = 1;
+
+  if (skipping) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  std::unique_ptr<AqlItemBlock> res(requestBlock(
+      1, getPlanNode()->getRegisterPlan()->nrRegs[getPlanNode()->getDepth()]));
+
+  if (!_buffer.empty()) {
+    AqlItemBlock* cur = _buffer.front();
+    inheritRegisters(cur, res.get(), 0);
+    _buffer.pop_front();
+    returnBlock(cur);
+  }
+
+  res->setValue(0, _collectRegister, AqlValue(count));
+
+  result = res.release();
+  return TRI_ERROR_NO_ERROR;
+}
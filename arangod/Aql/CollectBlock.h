@@ -33,6 +33,8 @@
 
 #include <velocypack/Builder.h>
 
+#include <functional>
+
 namespace arangodb {
 namespace transaction {
 class Methods;
@@ -42,6 +44,7 @@ namespace aql {
 struct Aggregator;
 class AqlItemBlock;
 class ExecutionEngine;
+class SpillFile;
   
 typedef std::vector<std::unique_ptr<Aggregator>> AggregateValuesType;
 
@@ -122,16 +125,56 @@ class SortedCollectBlock final : public ExecutionBlock {
   arangodb::velocypack::Builder _builder;
 };
 
+/// @brief decides which hash partition the groups of a HashedCollectBlock
+/// go to, and which partitions are frozen. once the groups use more memory
+/// than the threshold, the largest partitions holding at least half of that
+/// memory are frozen in one batch. the next batch is frozen after the
+/// remaining partitions have grown by another share of the threshold, so
+/// the groups use at most about twice the threshold
+class CollectSpillPolicy {
+ public:
+  CollectSpillPolicy(size_t threshold, size_t numPartitions);
+
+  /// @brief the partition of a group. spilled partitions are split again
+  /// on the next level, which uses other bits of the hash
+  size_t partition(size_t hash, size_t level) const;
+
+  /// @brief account for the memory of new groups in a partition
+  void add(size_t partition, size_t memoryUsage);
+
+  bool isFrozen(size_t partition) const { return _frozen[partition]; }
+
+  size_t memoryUsage() const { return _memoryUsage; }
+
+ private:
+  /// @brief freeze the next batch of partitions
+  void freeze();
+
+ private:
+  size_t const _threshold;
+  std::vector<size_t> _partitions;
+  std::vector<bool> _frozen;
+  size_t _memoryUsage;
+  size_t _nextFreeze;
+};
+
 class HashedCollectBlock : public ExecutionBlock {
  public:
   HashedCollectBlock(ExecutionEngine*, CollectNode const*);
   ~HashedCollectBlock();
 
+  int initializeCursor(AqlItemBlock* items, size_t pos) override;
+
+  bool hasMore() override;
+
  private:
   int getOrSkipSome(size_t atLeast, size_t atMost, bool skipping,
                     AqlItemBlock*& result, size_t& skipped) override;
 
  private:
+  /// @brief number of hash partitions used when a spill threshold is set
+  static constexpr size_t NumPartitions = 16;
+
   /// @brief pairs, consisting of out register and in register
   std::vector<std::pair<RegisterId, RegisterId>> _groupRegisters;
 
@@ -165,6 +208,77 @@ class HashedCollectBlock : public ExecutionBlock {
 
     transaction::Methods* _trx;
   };
+
+  typedef std::unordered_map<std::vector<AqlValue>, AggregateValuesType*,
+                             GroupKeyHash, GroupKeyEqual> GroupMap;
+
+  /// @brief a hash partition of the groups. once a partition is frozen,
+  /// rows of groups it does not know yet are written to a temporary file
+  /// and aggregated after all groups in memory have been returned
+  struct Partition {
+    Partition(transaction::Methods* trx, size_t num);
+    ~Partition();
+
+    GroupMap groups;
+    std::unique_ptr<SpillFile> spill;
+    std::unique_ptr<AqlItemBlock> pending;
+    size_t pendingRows;
+  };
+
+  /// @brief a spilled partition and the level it is split on
+  struct SpilledPartition {
+    std::unique_ptr<SpillFile> file;
+    size_t level;
+  };
+
+  /// @brief destroy all groups of a map, including their keys
+  static void destroyGroups(GroupMap& groups);
+
+  /// @brief aggregate a row into its group. creates the group if it does not
+  /// yet exist and mayCreate is true. returns false if the group does
+  /// not exist and was not created
+  bool aggregateRow(GroupMap& groups, AqlItemBlock const* cur, size_t pos,
+                    std::vector<AqlValue> const& groupValues, bool mayCreate,
+                    size_t& memoryUsage);
+
+  /// @brief build the result block for all groups of the given maps. the
+  /// group keys and values are moved into the result
+  AqlItemBlock* buildResult(std::vector<GroupMap*> const& maps,
+                            AqlItemBlock const* src);
+
+  /// @brief copy a row into the pending block of a frozen partition
+  void spillRow(Partition& partition, AqlItemBlock const* cur, size_t pos);
+
+  /// @brief write the pending block of a partition to its temporary file
+  void flushPartition(Partition& partition);
+
+  /// @brief aggregate all rows returned by next, which returns nullptr at
+  /// the end. partitions spilled on the way are added to _spilled
+  AqlItemBlock* aggregate(std::function<AqlItemBlock*()> const& next,
+                          size_t level);
+
+  /// @brief spilled partitions that still need to be aggregated
+  std::vector<SpilledPartition> _spilled;
+};
+
+/// @brief COLLECT WITH COUNT INTO without any groups or aggregates. the
+/// input rows are skipped instead of being fetched, so that the blocks
+/// below can count them without materializing any documents
+class CountCollectBlock final : public ExecutionBlock {
+ public:
+  CountCollectBlock(ExecutionEngine*, CollectNode const*);
+  ~CountCollectBlock() = default;
+
+ private:
+  int getOrSkipSome(size_t atLeast, size_t atMost, bool skipping,
+                    AqlItemBlock*& result, size_t& skipped) override;
+
+ private:
+  /// @brief number of rows requested from the dependency per skip call
+  static constexpr size_t SkipBatchSize = 10000;
+
+  /// @brief the register that receives the count
+  RegisterId _collectRegister;
 };
 
 }  // namespace arangodb::aql
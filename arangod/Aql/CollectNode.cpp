@@ -24,6 +24,7 @@
 #include "CollectNode.h"
 #include "Aql/Ast.h"
 #include "Aql/ExecutionPlan.h"
+#include "Aql/SelectivityEstimator.h"
 #include "Aql/VariableGenerator.h"
 #include "Aql/WalkerWorker.h"
 
@@ -191,6 +192,7 @@ struct UserVarFinder final : public WalkerWorker<ExecutionNode> {
       depth = 0;
     } else if (en->getType() == ExecutionNode::ENUMERATE_COLLECTION ||
                en->getType() == ExecutionNode::INDEX ||
+               en->getType() == ExecutionNode::HASH_JOIN ||
                en->getType() == ExecutionNode::ENUMERATE_LIST ||
                en->getType() == ExecutionNode::TRAVERSAL ||
                en->getType() == ExecutionNode::SHORTEST_PATH ||
@@ -274,9 +276,25 @@ double CollectNode::estimateCost(size_t& nrItems) const {
   // Nevertheless, the optimizer does not do much with CollectNodes
   // and thus this potential overestimation does not really matter.
 
+  double groups = 1.0;
+  bool groupsKnown = !_groupVariables.empty();
+  SelectivityEstimator estimator(_plan);
+  for (auto const& p : _groupVariables) {
+    double distinct;
+    if (!estimator.distinctValues(p.second, distinct)) {
+      groupsKnown = false;
+      break;
+    }
+    groups *= distinct;
+  }
+
   if (_count && _groupVariables.empty()) {
     // we are known to only produce a single output row
     nrItems = 1;
+  } else if (groupsKnown) {
+    // there cannot be more groups than combinations of distinct values
+    nrItems = (std::min)(nrItems,
+                         static_cast<size_t>(std::ceil(groups)));
   } else {
     // we do not know how many rows the COLLECT with produce...
     // the worst case is that there will be as many output rows as input rows
@@ -44,6 +44,7 @@ class RedundantCalculationsReplacer;
 /// @brief class CollectNode
 class CollectNode : public ExecutionNode {
   friend class ExecutionNode;
+  friend class CountCollectBlock;
   friend class ExecutionBlock;
   friend class HashedCollectBlock;
   friend class RedundantCalculationsReplacer;
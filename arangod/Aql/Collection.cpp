@@ -32,6 +32,7 @@
 #include "Cluster/ClusterInfo.h"
 #include "Cluster/ClusterMethods.h"
 #include "Cluster/ServerState.h"
+#include "StorageEngine/PhysicalCollection.h"
 #include "Transaction/Methods.h"
 #include "VocBase/LogicalCollection.h"
 #include "VocBase/vocbase.h"
@@ -87,6 +88,17 @@ size_t Collection::count(transaction::Methods* trx) const {
   return static_cast<size_t>(numDocuments);
 }
 
+/// @brief returns the attribute statistics of the local collection
+std::shared_ptr<arangodb::AttributeStatistics const>
+Collection::attributeStatistics() const {
+  if (arangodb::ServerState::instance()->isCoordinator() ||
+      collection == nullptr) {
+    // statistics are only kept by the storage engine of the DB servers
+    return nullptr;
+  }
+  return collection->getPhysical()->attributeStatistics();
+}
+
 /// @brief returns the collection's plan id
 TRI_voc_cid_t Collection::getPlanId() const {
   return getCollection()->cid();
@@ -119,7 +131,7 @@ std::shared_ptr<std::vector<std::string>> Collection::shardIds(std::unordered_se
   // use the simple method first
   auto copy = shardIds();
 
-  if (includedShards.empty()) {
+  if (includedShards.empty() && restrictedShards.empty()) {
     // no shards given => return them all!
     return copy;
   }
@@ -129,7 +141,12 @@ std::shared_ptr<std::vector<std::string>> Collection::shardIds(std::unordered_se
 
   // post-filter the result
   for (auto const& it : *copy) {
-    if (includedShards.find(it) == includedShards.end()) {
+    if (!includedShards.empty() &&
+        includedShards.find(it) == includedShards.end()) {
+      continue;
+    }
+    if (!restrictedShards.empty() &&
+        restrictedShards.find(it) == restrictedShards.end()) {
       continue;
     }
     result->emplace_back(it);
@@ -29,6 +29,8 @@
 #include "VocBase/vocbase.h"
 
 namespace arangodb {
+class AttributeStatistics;
+
 namespace transaction {
 class Methods;
 }
@@ -52,6 +54,18 @@ struct Collection {
   /// @brief remove the current shard
   inline void resetCurrentShard() { currentShard = ""; }
 
+  /// @brief restrict the query to a single shard of the collection. the
+  /// filtered list of shard ids will only contain this shard
+  inline void restrictToShard(std::string const& shard) {
+    restrictedShards = {shard};
+  }
+
+  /// @brief restrict the query to some shards of the collection, e.g. the
+  /// ones of a range-sharded collection that can match a range filter
+  inline void restrictToShards(std::unordered_set<std::string> const& shards) {
+    restrictedShards = shards;
+  }
+
   /// @brief get the collection id
   TRI_voc_cid_t cid() const;
 
@@ -100,6 +114,11 @@ struct Collection {
   /// @brief check if collection is a satellite collection
   bool isSatellite() const;
 
+  /// @brief returns the attribute statistics of the LOCAL collection, or
+  /// nullptr if there are none
+  std::shared_ptr<arangodb::AttributeStatistics const> attributeStatistics()
+      const;
+
  private:
 
   arangodb::LogicalCollection* collection;
@@ -108,6 +127,9 @@ struct Collection {
   /// only be filled during plan creation
   std::string currentShard;
 
+  /// @brief the only shards the query needs, if found by the optimizer
+  std::unordered_set<std::string> restrictedShards;
+
  public:
   std::string const name;
   TRI_vocbase_t* vocbase;
@@ -0,0 +1,402 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "ColumnarExpression.h"
+#include "Aql/AqlItemBlock.h"
+#include "Aql/AqlValue.h"
+#include "Aql/Variable.h"
+
+#include <velocypack/Slice.h>
+#include <velocypack/velocypack-aliases.h>
+
+#include <cmath>
+
+using namespace arangodb::aql;
+
+namespace {
+
+/// @brief largest integer that can be represented exactly in a double
+constexpr double maxExactInteger = 9007199254740992.0;
+
+/// @brief extract a double from a slice, if this can be done without
+/// changing the semantics of arithmetic or comparisons
+inline bool sliceToDouble(VPackSlice slice, double& result) {
+  if (slice.isDouble()) {
+    result = slice.getDouble();
+    return std::isfinite(result);
+  }
+  if (slice.isSmallInt() || slice.isInt()) {
+    int64_t v = slice.getInt();
+    result = static_cast<double>(v);
+    return (result <= maxExactInteger && result >= -maxExactInteger);
+  }
+  if (slice.isUInt()) {
+    uint64_t v = slice.getUInt();
+    result = static_cast<double>(v);
+    return (result <= maxExactInteger);
+  }
+  return false;
+}
+
+/// @brief whether all values of a column are finite. the regular code path
+/// turns NaN and +/-inf into null after each operator, which then behaves
+/// like 0 in arithmetic and differently from numbers in comparisons
+inline bool allFinite(double const* values, size_t n) {
+  bool finite = true;
+  for (size_t i = 0; i < n; ++i) {
+    finite &= std::isfinite(values[i]);
+  }
+  return finite;
+}
+
+}  // namespace
+
+/// @brief try to create a columnar evaluator for the expression
+std::unique_ptr<ColumnarExpression> ColumnarExpression::create(
+    AstNode const* node, std::vector<Variable const*> const& inVars,
+    std::vector<RegisterId> const& inRegs) {
+  TRI_ASSERT(node != nullptr);
+
+  std::unique_ptr<ColumnarExpression> expression(new ColumnarExpression());
+  size_t result;
+  if (!expression->compile(node, inVars, inRegs, result)) {
+    return nullptr;
+  }
+
+  if (expression->_ops.size() < 2) {
+    // a single load or a constant. there is nothing to gain here
+    return nullptr;
+  }
+
+  TRI_ASSERT(result == expression->_ops.size() - 1);
+  expression->_columns.resize(expression->_ops.size());
+  return expression;
+}
+
+/// @brief recursively translate an AST node into ops
+bool ColumnarExpression::compile(AstNode const* node,
+                                 std::vector<Variable const*> const& inVars,
+                                 std::vector<RegisterId> const& inRegs,
+                                 size_t& result) {
+  Op op;
+  op.type = OpType::CONSTANT;
+  op.nodeType = node->type;
+  op.reg = 0;
+  op.value = 0.0;
+  op.lhs = 0;
+  op.rhs = 0;
+  op.producesBoolean = false;
+
+  switch (node->type) {
+    case NODE_TYPE_VALUE: {
+      if (!node->isNumericValue()) {
+        return false;
+      }
+      op.type = OpType::CONSTANT;
+      op.value = node->getDoubleValue();
+      break;
+    }
+
+    case NODE_TYPE_REFERENCE:
+    case NODE_TYPE_ATTRIBUTE_ACCESS: {
+      // collect the attribute path (in reverse order) until we reach the
+      // variable
+      AstNode const* current = node;
+      while (current->type == NODE_TYPE_ATTRIBUTE_ACCESS) {
+        op.path.emplace_back(current->getStringValue(),
+                             current->getStringLength());
+        current = current->getMemberUnchecked(0);
+      }
+      if (current->type != NODE_TYPE_REFERENCE) {
+        return false;
+      }
+      std::reverse(op.path.begin(), op.path.end());
+
+      auto v = static_cast<Variable const*>(current->getData());
+      size_t i = 0;
+      for (; i < inVars.size(); ++i) {
+        if (inVars[i] == v) {
+          break;
+        }
+      }
+      if (i == inVars.size()) {
+        return false;
+      }
+      op.type = OpType::LOAD;
+      op.reg = inRegs[i];
+      break;
+    }
+
+    case NODE_TYPE_OPERATOR_UNARY_MINUS: {
+      if (!compile(node->getMemberUnchecked(0), inVars, inRegs, op.lhs) ||
+          _ops[op.lhs].producesBoolean) {
+        return false;
+      }
+      op.type = OpType::NEGATE;
+      break;
+    }
+
+    case NODE_TYPE_OPERATOR_BINARY_PLUS:
+    case NODE_TYPE_OPERATOR_BINARY_MINUS:
+    case NODE_TYPE_OPERATOR_BINARY_TIMES:
+    case NODE_TYPE_OPERATOR_BINARY_DIV:
+    case NODE_TYPE_OPERATOR_BINARY_MOD:
+    case NODE_TYPE_OPERATOR_BINARY_EQ:
+    case NODE_TYPE_OPERATOR_BINARY_NE:
+    case NODE_TYPE_OPERATOR_BINARY_LT:
+    case NODE_TYPE_OPERATOR_BINARY_LE:
+    case NODE_TYPE_OPERATOR_BINARY_GT:
+    case NODE_TYPE_OPERATOR_BINARY_GE: {
+      if (!compile(node->getMemberUnchecked(0), inVars, inRegs, op.lhs) ||
+          !compile(node->getMemberUnchecked(1), inVars, inRegs, op.rhs) ||
+          _ops[op.lhs].producesBoolean || _ops[op.rhs].producesBoolean) {
+        // booleans as inputs for arithmetic or comparisons have different
+        // semantics than numbers. leave them to the regular code path
+        return false;
+      }
+      bool isArithmetic = (node->type == NODE_TYPE_OPERATOR_BINARY_PLUS ||
+                           node->type == NODE_TYPE_OPERATOR_BINARY_MINUS ||
+                           node->type == NODE_TYPE_OPERATOR_BINARY_TIMES ||
+                           node->type == NODE_TYPE_OPERATOR_BINARY_DIV ||
+                           node->type == NODE_TYPE_OPERATOR_BINARY_MOD);
+      op.type = isArithmetic ? OpType::ARITHMETIC : OpType::COMPARISON;
+      op.producesBoolean = !isArithmetic;
+      break;
+    }
+
+    case NODE_TYPE_OPERATOR_BINARY_AND:
+    case NODE_TYPE_OPERATOR_BINARY_OR: {
+      // AND and OR return one of their operands, so they only produce a
+      // boolean if both operands are booleans
+      if (!compile(node->getMemberUnchecked(0), inVars, inRegs, op.lhs) ||
+          !compile(node->getMemberUnchecked(1), inVars, inRegs, op.rhs) ||
+          !_ops[op.lhs].producesBoolean || !_ops[op.rhs].producesBoolean) {
+        return false;
+      }
+      op.type = OpType::LOGICAL;
+      op.producesBoolean = true;
+      break;
+    }
+
+    default: {
+      return false;
+    }
+  }
+
+  _ops.emplace_back(std::move(op));
+  result = _ops.size() - 1;
+  return true;
+}
+
+/// @brief unpack a register (or an attribute of it) into a column
+bool ColumnarExpression::load(Op const& op, AqlItemBlock const* block,
+                              std::vector<double>& column) const {
+  size_t const n = block->size();
+  double* out = column.data();
+
+  for (size_t i = 0; i < n; ++i) {
+    AqlValue const& value = block->getValueReference(i, op.reg);
+    if (value.isDocvec() || value.isRange() || value.isEmpty()) {
+      return false;
+    }
+    VPackSlice slice = value.slice();
+    if (!op.path.empty()) {
+      if (!slice.isObject()) {
+        return false;
+      }
+      slice = slice.get(op.path);
+    }
+    if (!sliceToDouble(slice, out[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/// @brief evaluate the expression for all rows of the block
+bool ColumnarExpression::execute(transaction::Methods*, AqlItemBlock* block,
+                                 RegisterId outReg) {
+  size_t const n = block->size();
+  size_t const nrOps = _ops.size();
+
+  // phase 1: compute all columns. nothing is written into the block yet,
+  // so we can still bail out at any point
+  for (size_t o = 0; o < nrOps; ++o) {
+    Op const& op = _ops[o];
+    std::vector<double>& column = _columns[o];
+    column.resize(n);
+    double* out = column.data();
+
+    switch (op.type) {
+      case OpType::LOAD: {
+        if (!load(op, block, column)) {
+          return false;
+        }
+        break;
+      }
+
+      case OpType::CONSTANT: {
+        double const value = op.value;
+        for (size_t i = 0; i < n; ++i) {
+          out[i] = value;
+        }
+        break;
+      }
+
+      case OpType::NEGATE: {
+        double const* a = _columns[op.lhs].data();
+        for (size_t i = 0; i < n; ++i) {
+          out[i] = -a[i];
+        }
+        break;
+      }
+
+      case OpType::ARITHMETIC: {
+        double const* a = _columns[op.lhs].data();
+        double const* b = _columns[op.rhs].data();
+        switch (op.nodeType) {
+          case NODE_TYPE_OPERATOR_BINARY_PLUS:
+            for (size_t i = 0; i < n; ++i) {
+              out[i] = a[i] + b[i];
+            }
+            break;
+          case NODE_TYPE_OPERATOR_BINARY_MINUS:
+            for (size_t i = 0; i < n; ++i) {
+              out[i] = a[i] - b[i];
+            }
+            break;
+          case NODE_TYPE_OPERATOR_BINARY_TIMES:
+            for (size_t i = 0; i < n; ++i) {
+              out[i] = a[i] * b[i];
+            }
+            break;
+          case NODE_TYPE_OPERATOR_BINARY_DIV:
+          case NODE_TYPE_OPERATOR_BINARY_MOD: {
+            // division by zero must produce a warning, which is left to
+            // the regular code path
+            bool hasZero = false;
+            for (size_t i = 0; i < n; ++i) {
+              hasZero |= (b[i] == 0.0);
+            }
+            if (hasZero) {
+              return false;
+            }
+            if (op.nodeType == NODE_TYPE_OPERATOR_BINARY_DIV) {
+              for (size_t i = 0; i < n; ++i) {
+                out[i] = a[i] / b[i];
+              }
+            } else {
+              for (size_t i = 0; i < n; ++i) {
+                out[i] = fmod(a[i], b[i]);
+              }
+            }
+            break;
+          }
+          default: {
+            TRI_ASSERT(false);
+            return false;
+          }
+        }
+        if (!allFinite(out, n)) {
+          // overflow. leave the null results to the regular code path
+          return false;
+        }
+        break;
+      }
+
+      case OpType::COMPARISON: {
+        double const* a = _columns[op.lhs].data();
+        double const* b = _columns[op.rhs].data();
+        switch (op.nodeType) {
+          case NODE_TYPE_OPERATOR_BINARY_EQ:
+            for (size_t i = 0; i < n; ++i) {
+              out[i] = (a[i] == b[i]) ? 1.0 : 0.0;
+            }
+            break;
+          case NODE_TYPE_OPERATOR_BINARY_NE:
+            for (size_t i = 0; i < n; ++i) {
+              out[i] = (a[i] != b[i]) ? 1.0 : 0.0;
+            }
+            break;
+          case NODE_TYPE_OPERATOR_BINARY_LT:
+            for (size_t i = 0; i < n; ++i) {
+              out[i] = (a[i] < b[i]) ? 1.0 : 0.0;
+            }
+            break;
+          case NODE_TYPE_OPERATOR_BINARY_LE:
+            for (size_t i = 0; i < n; ++i) {
+              out[i] = (a[i] <= b[i]) ? 1.0 : 0.0;
+            }
+            break;
+          case NODE_TYPE_OPERATOR_BINARY_GT:
+            for (size_t i = 0; i < n; ++i) {
+              out[i] = (a[i] > b[i]) ? 1.0 : 0.0;
+            }
+            break;
+          case NODE_TYPE_OPERATOR_BINARY_GE:
+            for (size_t i = 0; i < n; ++i) {
+              out[i] = (a[i] >= b[i]) ? 1.0 : 0.0;
+            }
+            break;
+          default: {
+            TRI_ASSERT(false);
+            return false;
+          }
+        }
+        break;
+      }
+
+      case OpType::LOGICAL: {
+        double const* a = _columns[op.lhs].data();
+        double const* b = _columns[op.rhs].data();
+        if (op.nodeType == NODE_TYPE_OPERATOR_BINARY_AND) {
+          for (size_t i = 0; i < n; ++i) {
+            out[i] = a[i] * b[i];
+          }
+        } else {
+          for (size_t i = 0; i < n; ++i) {
+            out[i] = (a[i] + b[i] != 0.0) ? 1.0 : 0.0;
+          }
+        }
+        break;
+      }
+    }
+  }
+
+  // phase 2: write the result column into the block. all values produced
+  // here are inline values, so they do not require any memory management
+  Op const& last = _ops.back();
+  double const* result = _columns.back().data();
+
+  if (last.producesBoolean) {
+    for (size_t i = 0; i < n; ++i) {
+      block->setValue(i, outReg, AqlValue(result[i] != 0.0));
+    }
+  } else {
+    for (size_t i = 0; i < n; ++i) {
+      TRI_ASSERT(std::isfinite(result[i]));
+      block->setValue(i, outReg, AqlValue(result[i]));
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_AQL_COLUMNAR_EXPRESSION_H
+#define ARANGOD_AQL_COLUMNAR_EXPRESSION_H 1
+
+#include "Basics/Common.h"
+#include "Aql/AstNode.h"
+#include "Aql/types.h"
+
+namespace arangodb {
+namespace transaction {
+class Methods;
+}
+
+namespace aql {
+class AqlItemBlock;
+struct Variable;
+
+/// @brief a block-at-a-time evaluator for simple numeric expressions.
+/// Instead of interpreting the expression AST once per row, the input
+/// registers are first unpacked into one contiguous array of doubles per
+/// input (a column), and then each operator of the expression is applied
+/// to its full input columns in a tight loop. The loops do not contain any
+/// type dispatch, so the compiler can auto-vectorize them.
+///
+/// Supported are references to variables, (nested) attribute accesses on
+/// variables, numeric constants, unary minus, the binary arithmetic
+/// operators and the comparison operators ==, !=, <, <=, > and >=, plus
+/// logical AND and OR of comparison results.
+///
+/// If any input value of a block is not a number (or an integer that cannot
+/// be represented exactly as a double), if a division by zero would happen,
+/// or if an arithmetic result is not finite, execute() returns false without
+/// touching the block, and the caller must evaluate the expression
+/// row-by-row using the regular Expression::execute() code path, which then
+/// also takes care of proper type casting and warnings.
+class ColumnarExpression {
+ private:
+  enum class OpType : uint8_t {
+    LOAD,       // register value, optionally with an attribute path
+    CONSTANT,   // numeric constant
+    NEGATE,     // unary minus
+    ARITHMETIC, // +, -, *, /, %
+    COMPARISON, // ==, !=, <, <=, >, >=
+    LOGICAL     // && and || on boolean inputs
+  };
+
+  struct Op {
+    OpType type;
+    AstNodeType nodeType;
+    RegisterId reg;
+    std::vector<std::string> path;
+    double value;
+    size_t lhs;
+    size_t rhs;
+    bool producesBoolean;
+  };
+
+ public:
+  ColumnarExpression(ColumnarExpression const&) = delete;
+  ColumnarExpression& operator=(ColumnarExpression const&) = delete;
+
+  /// @brief try to create a columnar evaluator for the expression. returns
+  /// a nullptr if the expression contains anything that is not supported
+  static std::unique_ptr<ColumnarExpression> create(
+      AstNode const* node, std::vector<Variable const*> const& inVars,
+      std::vector<RegisterId> const& inRegs);
+
+  /// @brief evaluate the expression for all rows of the block and write the
+  /// results into register outReg. returns false if the block contains
+  /// values that cannot be handled, in which case the block is unmodified
+  bool execute(transaction::Methods*, AqlItemBlock*, RegisterId outReg);
+
+ private:
+  ColumnarExpression() = default;
+
+  /// @brief recursively translate an AST node into ops, returns false if
+  /// the node cannot be handled
+  bool compile(AstNode const*, std::vector<Variable const*> const&,
+               std::vector<RegisterId> const&, size_t& result);
+
+  /// @brief unpack a register (or an attribute of it) into a column
+  bool load(Op const&, AqlItemBlock const*, std::vector<double>&) const;
+
+ private:
+  /// @brief the ops, in evaluation order. the last op produces the result
+  std::vector<Op> _ops;
+
+  /// @brief scratch space, one column per op. kept around between calls so
+  /// that the memory is not re-allocated for every block
+  std::vector<std::vector<double>> _columns;
+};
+
+}  // namespace arangodb::aql
+}  // namespace arangodb
+
+#endif
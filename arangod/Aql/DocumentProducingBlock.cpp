@@ -31,6 +31,9 @@
 #include "StorageEngine/EngineSelectorFeature.h"
 #include "StorageEngine/StorageEngine.h"
 #include "Transaction/Helpers.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/velocypack-aliases.h>
       
 using namespace arangodb;
 using namespace arangodb::aql;
@@ -123,6 +126,36 @@ DocumentProducingBlock::DocumentProducingFunction DocumentProducingBlock::buildC
     };
   }
 
+  if (!_node->projections().empty()) {
+    // return an object with only the requested top-level attributes, so that
+    // the rest of the document is neither copied nor kept in memory
+    auto builder = std::make_shared<VPackBuilder>();
+    return [this, builder](AqlItemBlock* res, VPackSlice slice, size_t registerId, size_t& row, size_t fromRow) {
+      builder->clear();
+      builder->openObject();
+      for (auto const& attribute : _node->projections()) {
+        VPackSlice found = slice.get(attribute);
+        if (found.isNone()) {
+          continue;
+        }
+        if (found.isCustom()) {
+          // _id as a custom type needs special treatment
+          builder->add(attribute, VPackValue(transaction::helpers::extractIdString(_trxPtr->resolver(), found, slice)));
+        } else {
+          builder->add(attribute, found);
+        }
+      }
+      builder->close();
+      res->setValue(row, static_cast<arangodb::aql::RegisterId>(registerId),
+                    AqlValue(*builder));
+      if (row != fromRow) {
+        // re-use already copied AQLValues
+        res->copyValuesFromRow(row, static_cast<RegisterId>(registerId), fromRow);
+      }
+      ++row;
+    };
+  }
+
   // return the document as is
   return [this](AqlItemBlock* res, VPackSlice slice, size_t registerId, size_t& row, size_t fromRow) {
     uint8_t const* vpack = slice.begin();
@@ -51,6 +51,15 @@ DocumentProducingNode::DocumentProducingNode(ExecutionPlan* plan,
       }
     }
   }
+
+  if (slice.hasKey("projections")) {
+    VPackSlice p = slice.get("projections");
+    if (p.isArray()) {
+      for (auto const& it : VPackArrayIterator(p)) {
+        _projections.emplace_back(it.copyString());
+      }
+    }
+  }
 }
   
 void DocumentProducingNode::toVelocyPack(arangodb::velocypack::Builder& builder) const {
@@ -64,4 +73,12 @@ void DocumentProducingNode::toVelocyPack(arangodb::velocypack::Builder& builder)
     }
     builder.close();
   }
+
+  if (!_projections.empty()) {
+    builder.add("projections", VPackValue(VPackValueType::Array));
+    for (auto const& it : _projections) {
+      builder.add(VPackValue(it));
+    }
+    builder.close();
+  }
 }
@@ -57,6 +57,19 @@ class DocumentProducingNode {
     _projection = std::move(attributeNames);
   }
   
+  /// @brief top-level attributes of the partial documents to produce
+  std::vector<std::string> const& projections() const {
+    return _projections;
+  }
+
+  void setProjections(std::vector<std::string> const& attributeNames) {
+    _projections = attributeNames;
+  }
+
+  void setProjections(std::vector<std::string>&& attributeNames) {
+    _projections = std::move(attributeNames);
+  }
+
   void toVelocyPack(arangodb::velocypack::Builder& builder) const;
 
  protected:
@@ -64,6 +77,10 @@ class DocumentProducingNode {
 
   /// @brief produce only the following attribute (with possible subattributes)
   std::vector<std::string> _projection;
+
+  /// @brief produce objects with only the following top-level attributes
+  /// instead of the entire documents
+  std::vector<std::string> _projections;
 };
 
 }
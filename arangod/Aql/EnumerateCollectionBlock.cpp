@@ -31,6 +31,8 @@
 #include "Cluster/FollowerInfo.h"
 #include "Cluster/ServerState.h"
 #include "StorageEngine/DocumentIdentifierToken.h"
+#include "StorageEngine/TransactionCollection.h"
+#include "StorageEngine/TransactionState.h"
 #include "Transaction/Helpers.h"
 #include "Transaction/Methods.h"
 #include "Utils/OperationCursor.h"
@@ -50,10 +52,57 @@ EnumerateCollectionBlock::EnumerateCollectionBlock(
           _trx->indexScan(_collection->getName(),
                           (ep->_random ? transaction::Methods::CursorType::ANY
                                        : transaction::Methods::CursorType::ALL),
-                          _mmdr.get(), 0, UINT64_MAX, 1000, false)) {
+                          _mmdr.get(), 0, UINT64_MAX, 1000, false)),
+      _logicalCollection(nullptr),
+      _consumed(0) {
   TRI_ASSERT(_cursor->successful());
 }
 
+/// @brief rewind the cursor for the next input row
+void EnumerateCollectionBlock::resetCursor() {
+  _cursor->reset();
+  _consumed = 0;
+}
+
+/// @brief number of documents the cursor has not yet produced for the
+/// current input row. the collection's document count is maintained by
+/// the storage engine, so this does not touch any documents. the count is
+/// taken when the collection is locked, so it only matches what the cursor
+/// reads if no other transaction can change the collection in between and
+/// the transaction has not committed parts of its changes yet
+uint64_t EnumerateCollectionBlock::remainingDocuments() {
+  if (static_cast<EnumerateCollectionNode const*>(_exeNode)->_random) {
+    return UINT64_MAX;
+  }
+
+  TransactionState* state = _trx->state();
+  if (state->hasIntermediateCommits()) {
+    return UINT64_MAX;
+  }
+
+  if (_logicalCollection == nullptr) {
+    TRI_voc_cid_t cid = _trx->addCollectionAtRuntime(_collection->getName());
+    _logicalCollection = _trx->documentCollection(cid);
+    TRI_ASSERT(_logicalCollection != nullptr);
+  }
+
+  if (!state->isReadOnlyTransaction()) {
+    TransactionCollection* trxCollection =
+        state->collection(_logicalCollection->cid(), AccessMode::Type::READ);
+    if (trxCollection == nullptr ||
+        !AccessMode::isExclusive(trxCollection->accessType())) {
+      return UINT64_MAX;
+    }
+  }
+
+  uint64_t total = _logicalCollection->numberDocuments(_trx);
+
+  if (_consumed > total) {
+    return UINT64_MAX;
+  }
+  return total - _consumed;
+}
+
 int EnumerateCollectionBlock::initialize() {
   DEBUG_BEGIN_BLOCK();
 
@@ -110,7 +159,7 @@ int EnumerateCollectionBlock::initializeCursor(AqlItemBlock* items,
   }
 
   DEBUG_BEGIN_BLOCK();
-  _cursor->reset();
+  resetCursor();
   DEBUG_END_BLOCK();
 
   return TRI_ERROR_NO_ERROR;
@@ -145,13 +194,13 @@ AqlItemBlock* EnumerateCollectionBlock::getSome(size_t,  // atLeast,
       needMore = false;
 
       if (_buffer.empty()) {
-        size_t toFetch = (std::min)(DefaultBatchSize(), atMost);
+        size_t toFetch = (std::min)(batchSize(), atMost);
         if (!ExecutionBlock::getBlock(toFetch, toFetch)) {
           _done = true;
           return nullptr;
         }
         _pos = 0;  // this is in the first block
-        _cursor->reset();
+        resetCursor();
       }
 
       // If we get here, we do have _buffer.front()
@@ -161,7 +210,7 @@ AqlItemBlock* EnumerateCollectionBlock::getSome(size_t,  // atLeast,
         needMore = true;
         // we have exhausted this cursor
         // re-initialize fetching of documents
-        _cursor->reset();
+        resetCursor();
         if (++_pos >= cur->size()) {
           _buffer.pop_front();  // does not throw
           returnBlock(cur);
@@ -211,6 +260,7 @@ AqlItemBlock* EnumerateCollectionBlock::getSome(size_t,  // atLeast,
 
     // If the collection is actually empty we cannot forward an empty block
   } while (send == 0);
+  _consumed += send;
   _engine->_stats.scannedFull += static_cast<int64_t>(send);
   TRI_ASSERT(res != nullptr);
 
@@ -232,42 +282,57 @@ AqlItemBlock* EnumerateCollectionBlock::getSome(size_t,  // atLeast,
 
 size_t EnumerateCollectionBlock::skipSome(size_t atLeast, size_t atMost) {
   DEBUG_BEGIN_BLOCK();
+  traceSkipSomeBegin();
   size_t skipped = 0;
   TRI_ASSERT(_cursor != nullptr);
 
   if (_done) {
+    traceSkipSomeEnd(skipped);
     return skipped;
   }
 
   while (skipped < atLeast) {
     if (_buffer.empty()) {
-      size_t toFetch = (std::min)(DefaultBatchSize(), atMost);
+      size_t toFetch = (std::min)(batchSize(), atMost);
       if (!getBlock(toFetch, toFetch)) {
         _done = true;
+        traceSkipSomeEnd(skipped);
         return skipped;
       }
       _pos = 0;  // this is in the first block
-      _cursor->reset();
+      resetCursor();
     }
 
     // if we get here, then _buffer.front() exists
     AqlItemBlock* cur = _buffer.front();
     uint64_t skippedHere = 0;
 
-    if (_cursor->hasMore()) {
-      int res = _cursor->skip(atMost - skipped, skippedHere);
+    bool exhausted = false;
 
-      if (res != TRI_ERROR_NO_ERROR) {
-        THROW_ARANGO_EXCEPTION(res);
+    if (_cursor->hasMore()) {
+      uint64_t remaining = remainingDocuments();
+
+      if (remaining <= atMost - skipped) {
+        // all remaining documents are skipped for this input row. their
+        // number is known, so there is no need to move the cursor
+        skippedHere = remaining;
+        exhausted = true;
+      } else {
+        int res = _cursor->skip(atMost - skipped, skippedHere);
+
+        if (res != TRI_ERROR_NO_ERROR) {
+          THROW_ARANGO_EXCEPTION(res);
+        }
+        _consumed += skippedHere;
       }
     }
 
     skipped += skippedHere;
 
-    if (skipped < atLeast) {
-      TRI_ASSERT(!_cursor->hasMore());
+    if (exhausted || skipped < atLeast) {
+      TRI_ASSERT(exhausted || !_cursor->hasMore());
       // not skipped enough re-initialize fetching of documents
-      _cursor->reset();
+      resetCursor();
       if (++_pos >= cur->size()) {
         _buffer.pop_front();  // does not throw
         returnBlock(cur);
@@ -278,6 +343,7 @@ size_t EnumerateCollectionBlock::skipSome(size_t atLeast, size_t atMost) {
 
   _engine->_stats.scannedFull += static_cast<int64_t>(skipped);
   // We skipped atLeast documents
+  traceSkipSomeEnd(skipped);
   return skipped;
 
   // cppcheck-suppress style
@@ -34,6 +34,7 @@
 namespace arangodb {
 
 struct DocumentIdentifierToken;
+class LogicalCollection;
 class ManagedDocumentResult;
 struct OperationCursor;
 
@@ -63,6 +64,14 @@ class EnumerateCollectionBlock final : public ExecutionBlock, public DocumentPro
   // things to skip overall.
   size_t skipSome(size_t atLeast, size_t atMost) override final;
 
+ private:
+  /// @brief rewind the cursor for the next input row
+  void resetCursor();
+
+  /// @brief number of documents the cursor has not yet produced for the
+  /// current input row, or UINT64_MAX if this cannot be determined cheaply
+  uint64_t remainingDocuments();
+
  private:
   /// @brief collection
   Collection* _collection;
@@ -71,6 +80,12 @@ class EnumerateCollectionBlock final : public ExecutionBlock, public DocumentPro
 
   /// @brief cursor
   std::unique_ptr<OperationCursor> _cursor;
+
+  /// @brief the collection as seen by the transaction, used for counting
+  LogicalCollection* _logicalCollection;
+
+  /// @brief number of documents produced or skipped since the last reset
+  uint64_t _consumed;
 };
 
 }  // namespace arangodb::aql
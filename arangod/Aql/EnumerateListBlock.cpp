@@ -84,7 +84,7 @@ AqlItemBlock* EnumerateListBlock::getSome(size_t, size_t atMost) {
     // try again!
 
     if (_buffer.empty()) {
-      size_t toFetch = (std::min)(DefaultBatchSize(), atMost);
+      size_t toFetch = (std::min)(batchSize(), atMost);
       if (!ExecutionBlock::getBlock(toFetch, toFetch)) {
         _done = true;
         traceGetSomeEnd(nullptr);
@@ -170,7 +170,9 @@ AqlItemBlock* EnumerateListBlock::getSome(size_t, size_t atMost) {
 
 size_t EnumerateListBlock::skipSome(size_t atLeast, size_t atMost) {
   DEBUG_BEGIN_BLOCK();  
+  traceSkipSomeBegin();
   if (_done) {
+    traceSkipSomeEnd(0);
     return 0;
   }
 
@@ -178,9 +180,10 @@ size_t EnumerateListBlock::skipSome(size_t atLeast, size_t atMost) {
 
   while (skipped < atLeast) {
     if (_buffer.empty()) {
-      size_t toFetch = (std::min)(DefaultBatchSize(), atMost);
+      size_t toFetch = (std::min)(batchSize(), atMost);
       if (!ExecutionBlock::getBlock(toFetch, toFetch)) {
         _done = true;
+        traceSkipSomeEnd(skipped);
         return skipped;
       }
       _pos = 0;  // this is in the first block
@@ -226,6 +229,7 @@ size_t EnumerateListBlock::skipSome(size_t atLeast, size_t atMost) {
       }
     }
   }
+  traceSkipSomeEnd(skipped);
   return skipped;
   DEBUG_END_BLOCK();  
 }
@@ -31,6 +31,19 @@
 #include "Aql/Query.h"
 
 using namespace arangodb::aql;
+
+/// @brief smallest number of rows requested from a dependency in one batch,
+/// unless a limit hint asks for fewer
+static size_t const MinBatchSize = 16;
+
+/// @brief largest number of rows requested from a dependency in one batch
+static size_t const MaxBatchSize = 4 * ExecutionBlock::DefaultBatchSize();
+
+/// @brief approximate amount of memory one batch should occupy
+static size_t const BatchMemoryTarget = 4 * 1024 * 1024;
+
+/// @brief fraction of the remaining query memory budget one batch may use
+static size_t const BatchMemoryBudgetShare = 4;
   
 ExecutionBlock::ExecutionBlock(ExecutionEngine* engine, ExecutionNode const* ep)
     : _engine(engine),
@@ -38,7 +51,12 @@ ExecutionBlock::ExecutionBlock(ExecutionEngine* engine, ExecutionNode const* ep)
       _exeNode(ep),
       _pos(0),
       _done(false),
-      _tracing(engine->getQuery()->queryOptions().tracing) {
+      _tracing(engine->getQuery()->queryOptions().tracing),
+      _limitHint(0),
+      _batchSize(DefaultBatchSize()),
+      _profile(engine->getQuery()->queryOptions().profile >= 2),
+      _profileDepth(0),
+      _profileStart(0.0) {
   TRI_ASSERT(_trx != nullptr);
 }
 
@@ -102,10 +120,55 @@ int ExecutionBlock::initializeCursor(AqlItemBlock* items, size_t pos) {
   _buffer.clear();
 
   _done = false;
+  setLimitHint(_limitHint);
   return TRI_ERROR_NO_ERROR;
   DEBUG_END_BLOCK();
 }
 
+/// @brief sets the maximum number of rows the downstream blocks are
+/// expected to need, 0 if unknown
+void ExecutionBlock::setLimitHint(size_t value) {
+  _limitHint = value;
+  _batchSize = DefaultBatchSize();
+  if (value > 0 && value < _batchSize) {
+    _batchSize = value;
+  }
+}
+
+/// @brief adapts the batch size to a batch fetched from the dependency
+void ExecutionBlock::adaptBatchSize(AqlItemBlock const* block) {
+  size_t const rows = block->size();
+
+  if (rows == 0) {
+    return;
+  }
+
+  size_t const rowSize = (std::max)(block->memoryUsage() / rows,
+                                    static_cast<size_t>(1));
+  size_t target = BatchMemoryTarget / rowSize;
+
+  // do not let a single batch take more than a fraction of what is left of
+  // the query's memory limit
+  ResourceMonitor const* monitor = _engine->getQuery()->resourceMonitor();
+  size_t const limit = monitor->maxResources.memoryUsage;
+  size_t const used = monitor->currentResources.memoryUsage;
+  if (limit > 0) {
+    size_t const available = (limit > used) ? limit - used : 0;
+    target = (std::min)(target,
+                        available / (BatchMemoryBudgetShare * rowSize));
+  }
+
+  target = (std::max)(MinBatchSize, (std::min)(MaxBatchSize, target));
+
+  if (_limitHint > 0) {
+    // downstream needs more rows than the hint suggested, e.g. because of
+    // a FILTER. grow the batches gradually
+    target = (std::min)(target, (std::max)(MinBatchSize, 2 * _batchSize));
+  }
+
+  _batchSize = target;
+}
+
 /// @brief whether or not the query was killed
 bool ExecutionBlock::isKilled() const { return _engine->getQuery()->killed(); }
 
@@ -153,8 +216,27 @@ int ExecutionBlock::shutdown(int errorCode) {
   return ret;
 }
 
+void ExecutionBlock::profileBegin() {
+  if (_profileDepth++ == 0) {
+    _profileStart = TRI_microtime();
+  }
+}
+
+void ExecutionBlock::profileEnd(size_t items) {
+  TRI_ASSERT(_profileDepth > 0);
+  if (--_profileDepth == 0) {
+    auto& stats = _engine->_stats.nodes[getPlanNode()->id()];
+    ++stats.calls;
+    stats.items += items;
+    stats.runtime += TRI_microtime() - _profileStart;
+  }
+}
+
 // Trace the start of a getSome call
-void ExecutionBlock::traceGetSomeBegin() const {
+void ExecutionBlock::traceGetSomeBegin() {
+  if (_profile) {
+    profileBegin();
+  }
   if (_tracing > 0) {
     auto node = getPlanNode();
     LOG_TOPIC(INFO, Logger::QUERIES) << "getSome type="
@@ -164,7 +246,10 @@ void ExecutionBlock::traceGetSomeBegin() const {
 }
 
 // Trace the end of a getSome call, potentially with result
-void ExecutionBlock::traceGetSomeEnd(AqlItemBlock const* result) const {
+void ExecutionBlock::traceGetSomeEnd(AqlItemBlock const* result) {
+  if (_profile) {
+    profileEnd(result == nullptr ? 0 : result->size());
+  }
   if (_tracing > 0) {
     auto node = getPlanNode();
     LOG_TOPIC(INFO, Logger::QUERIES) << "getSome done type="
@@ -188,6 +273,32 @@ void ExecutionBlock::traceGetSomeEnd(AqlItemBlock const* result) const {
   }
 }
 
+// Trace the start of a skipSome call
+void ExecutionBlock::traceSkipSomeBegin() {
+  if (_profile) {
+    profileBegin();
+  }
+  if (_tracing > 0) {
+    auto node = getPlanNode();
+    LOG_TOPIC(INFO, Logger::QUERIES) << "skipSome type="
+      << node->getTypeString() << " this=" << (uintptr_t) this
+      << " id=" << node->id();
+  }
+}
+
+// Trace the end of a skipSome call
+void ExecutionBlock::traceSkipSomeEnd(size_t skipped) {
+  if (_profile) {
+    profileEnd(skipped);
+  }
+  if (_tracing > 0) {
+    auto node = getPlanNode();
+    LOG_TOPIC(INFO, Logger::QUERIES) << "skipSome done type="
+      << node->getTypeString() << " this=" << (uintptr_t) this
+      << " id=" << node->id() << " skipped=" << skipped;
+  }
+}
+
 /// @brief getSome, gets some more items, semantic is as follows: not
 /// more than atMost items may be delivered. The method tries to
 /// return a block of at least atLeast items, however, it may return
@@ -282,6 +393,8 @@ bool ExecutionBlock::getBlock(size_t atLeast, size_t atMost) {
     return false;
   }
 
+  adaptBatchSize(docs.get());
+
   TRI_IF_FAILURE("ExecutionBlock::getBlock") {
     THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
   }
@@ -327,6 +440,7 @@ void ExecutionBlock::clearRegisters(AqlItemBlock* result) {
 size_t ExecutionBlock::skipSome(size_t atLeast, size_t atMost) {
   DEBUG_BEGIN_BLOCK();
   TRI_ASSERT(0 < atLeast && atLeast <= atMost);
+  traceSkipSomeBegin();
   size_t skipped = 0;
 
   AqlItemBlock* result = nullptr;
@@ -338,6 +452,7 @@ size_t ExecutionBlock::skipSome(size_t atLeast, size_t atMost) {
     THROW_ARANGO_EXCEPTION(out);
   }
 
+  traceSkipSomeEnd(skipped);
   return skipped;
   DEBUG_END_BLOCK();
 }
@@ -367,7 +482,7 @@ bool ExecutionBlock::hasMore() {
   if (!_buffer.empty()) {
     return true;
   }
-  if (getBlock(DefaultBatchSize(), DefaultBatchSize())) {
+  if (getBlock(batchSize(), batchSize())) {
     _pos = 0;
     return true;
   }
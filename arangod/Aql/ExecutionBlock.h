@@ -89,6 +89,17 @@ class ExecutionBlock {
   /// @brief batch size value
   static constexpr inline size_t DefaultBatchSize() { return 1000; }
 
+  /// @brief number of rows to request from the dependency in one batch.
+  /// this starts at the default batch size, or at the limit hint if one is
+  /// set, and is adapted to the observed row size and the memory budget of
+  /// the query with every batch fetched
+  size_t batchSize() const { return _batchSize; }
+
+  /// @brief sets the maximum number of rows the downstream blocks are
+  /// expected to need, 0 if unknown. batches start at this size and grow
+  /// only if more rows are requested
+  void setLimitHint(size_t);
+
   /// @brief returns the register id for a variable id
   /// will return ExecutionNode::MaxRegisterId for an unknown variable
   RegisterId getRegister(VariableId id) const;
@@ -155,8 +166,11 @@ class ExecutionBlock {
   /// if it returns an actual block, it must contain at least one item.
   virtual AqlItemBlock* getSome(size_t atLeast, size_t atMost);
 
-  void traceGetSomeBegin() const;
-  void traceGetSomeEnd(AqlItemBlock const*) const;
+  void traceGetSomeBegin();
+  void traceGetSomeEnd(AqlItemBlock const*);
+
+  void traceSkipSomeBegin();
+  void traceSkipSomeEnd(size_t skipped);
 
  protected:
   /// @brief request an AqlItemBlock from the memory manager
@@ -184,6 +198,9 @@ class ExecutionBlock {
   /// cleanup can use this method, internal use only
   AqlItemBlock* getSomeWithoutRegisterClearout(size_t atLeast, size_t atMost);
 
+  /// @brief adapts the batch size to a batch fetched from the dependency
+  void adaptBatchSize(AqlItemBlock const*);
+
   /// @brief clearRegisters, clears out registers holding values that are no
   /// longer needed by later nodes
   void clearRegisters(AqlItemBlock* result);
@@ -246,6 +263,31 @@ class ExecutionBlock {
 
   /// A copy of the tracing value in the options:
   int64_t _tracing;
+
+  /// @brief maximum number of rows the downstream blocks are expected to
+  /// need, 0 if unknown
+  size_t _limitHint;
+
+  /// @brief number of rows to request from the dependency in one batch
+  size_t _batchSize;
+
+ private:
+  /// @brief start profiling a getSome/skipSome call
+  void profileBegin();
+
+  /// @brief finish profiling a getSome/skipSome call that produced or
+  /// skipped <items> rows, and add the call to the engine's statistics
+  void profileEnd(size_t items);
+
+  /// @brief whether or not the block's calls are profiled
+  bool const _profile;
+
+  /// @brief nesting depth of profiled calls, so that calls a block makes
+  /// to itself are not counted twice
+  size_t _profileDepth;
+
+  /// @brief start time of the outermost profiled call
+  double _profileStart;
 };
 
 }  // namespace arangodb::aql
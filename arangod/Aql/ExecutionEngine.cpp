@@ -33,20 +33,27 @@
 #include "Aql/EnumerateCollectionBlock.h"
 #include "Aql/EnumerateListBlock.h"
 #include "Aql/ExecutionNode.h"
+#include "Aql/HashJoinBlock.h"
 #include "Aql/IndexBlock.h"
 #include "Aql/ModificationBlocks.h"
 #include "Aql/Query.h"
 #include "Aql/SortBlock.h"
+#include "Aql/SortLimitBlock.h"
 #include "Aql/SubqueryBlock.h"
 #include "Aql/TraversalBlock.h"
 #include "Aql/ShortestPathBlock.h"
 #include "Aql/ShortestPathNode.h"
+#include "Aql/QueryList.h"
+#include "Aql/QueryUsage.h"
 #include "Aql/WalkerWorker.h"
 #include "Basics/Exceptions.h"
+#include "Basics/StaticStrings.h"
+#include "Basics/StringUtils.h"
 #include "Basics/VelocyPackHelper.h"
 #include "Cluster/ClusterComm.h"
 #include "Cluster/ClusterInfo.h"
 #include "Cluster/CollectionLockState.h"
+#include "Cluster/ServerState.h"
 #include "Cluster/TraverserEngineRegistry.h"
 #include "Logger/Logger.h"
 #include "Transaction/Methods.h"
@@ -82,6 +89,53 @@ struct TraverserEngineShardLists {
 /// Typedef for a complicated mapping used in TraverserEngines.
 typedef std::unordered_map<ServerID, TraverserEngineShardLists> Serv2ColMap;
 
+/// @brief passes the number of rows a LIMIT needs on to the blocks it
+/// depends on, so they start with small batches. blocks that consume all
+/// of their input (sorts, collects) do not pass on a hint
+static void PropagateLimitHints(ExecutionBlock* block, size_t hint) {
+  auto const node = block->getPlanNode();
+
+  switch (node->getType()) {
+    case ExecutionNode::LIMIT: {
+      auto limitNode = static_cast<LimitNode const*>(node);
+      if (limitNode->fullCount()) {
+        // must fetch everything anyway
+        hint = 0;
+      } else {
+        size_t needed = limitNode->limit();
+        if (hint > 0 && hint < needed) {
+          needed = hint;
+        }
+        hint = limitNode->offset() + needed;
+      }
+      break;
+    }
+    case ExecutionNode::SORT:
+    case ExecutionNode::COLLECT:
+    case ExecutionNode::REMOTE:
+    case ExecutionNode::SCATTER:
+    case ExecutionNode::DISTRIBUTE:
+    case ExecutionNode::GATHER:
+      hint = 0;
+      break;
+    case ExecutionNode::SUBQUERY:
+      // the subquery is executed fully for every input row
+      PropagateLimitHints(static_cast<SubqueryBlock*>(block)->getSubquery(),
+                          0);
+      break;
+    default:
+      break;
+  }
+
+  // the block requests rows on behalf of its consumers, so the hint
+  // describes how many rows it should fetch from its dependencies
+  block->setLimitHint(hint);
+
+  for (auto const& it : block->getDependencies()) {
+    PropagateLimitHints(it, hint);
+  }
+}
+
 /// @brief helper function to create a block
 static ExecutionBlock* CreateBlock(
     ExecutionEngine* engine, ExecutionNode const* en,
@@ -98,6 +152,9 @@ static ExecutionBlock* CreateBlock(
       return new EnumerateCollectionBlock(
           engine, static_cast<EnumerateCollectionNode const*>(en));
     }
+    case ExecutionNode::HASH_JOIN: {
+      return new HashJoinBlock(engine, static_cast<HashJoinNode const*>(en));
+    }
     case ExecutionNode::ENUMERATE_LIST: {
       return new EnumerateListBlock(engine,
                                     static_cast<EnumerateListNode const*>(en));
@@ -119,7 +176,11 @@ static ExecutionBlock* CreateBlock(
       return new LimitBlock(engine, static_cast<LimitNode const*>(en));
     }
     case ExecutionNode::SORT: {
-      return new SortBlock(engine, static_cast<SortNode const*>(en));
+      auto sortNode = static_cast<SortNode const*>(en);
+      if (sortNode->limit() > 0) {
+        return new SortLimitBlock(engine, sortNode);
+      }
+      return new SortBlock(engine, sortNode);
     }
     case ExecutionNode::COLLECT: {
       auto aggregationMethod =
@@ -133,6 +194,10 @@ static ExecutionBlock* CreateBlock(
                  CollectOptions::CollectMethod::COLLECT_METHOD_SORTED) {
         return new SortedCollectBlock(engine,
                                       static_cast<CollectNode const*>(en));
+      } else if (aggregationMethod ==
+                 CollectOptions::CollectMethod::COLLECT_METHOD_COUNT) {
+        return new CountCollectBlock(engine,
+                                     static_cast<CollectNode const*>(en));
       }
 
       THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL,
@@ -205,7 +270,10 @@ ExecutionEngine::ExecutionEngine(Query* query)
       _resultRegister(0),
       _wasShutdown(false),
       _previouslyLockedShards(nullptr),
-      _lockedShards(nullptr) {
+      _lockedShards(nullptr),
+      _traceId(),
+      _traceShard(),
+      _tracedItems(0) {
   _blocks.reserve(8);
 }
 
@@ -378,15 +446,18 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
           idOfRemoteNode(idOfRemoteNode),
           collection(nullptr),
           auxiliaryCollections(),
+          coShardedCollections(),
           populated(false) {}
 
     void populate() {
+      std::vector<Collection*> shardedCollections;
       // mop: compiler should inline that I suppose :S
       auto collectionFn = [&](Collection* col) -> void {
         if (col->isSatellite()) {
           auxiliaryCollections.emplace(col);
         } else {
           collection = col;
+          shardedCollections.emplace_back(col);
         }
       };
       Collection* localCollection = nullptr;
@@ -420,6 +491,15 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
       if (collection != nullptr && collection->isSatellite()) {
         auxiliaryCollections.erase(collection);
       }
+      // all other sharded collections have been joined to the collection
+      // on their shard keys by the optimizer
+      for (auto const& col : shardedCollections) {
+        if (col != collection &&
+            std::find(coShardedCollections.begin(), coShardedCollections.end(),
+                      col) == coShardedCollections.end()) {
+          coShardedCollections.emplace_back(col);
+        }
+      }
       populated = true;
     }
 
@@ -438,6 +518,13 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
       return auxiliaryCollections;
     }
 
+    std::vector<Collection*> const& getCoShardedCollections() {
+      if (!populated) {
+        populate();
+      }
+      return coShardedCollections;
+    }
+
     EngineLocation const location;
     size_t const id;
     std::vector<ExecutionNode*> nodes;
@@ -445,6 +532,8 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
     size_t idOfRemoteNode;          // id of the remote node
     Collection* collection;
     std::unordered_set<Collection*> auxiliaryCollections;
+    // collections that use the shard at the same position as collection
+    std::vector<Collection*> coShardedCollections;
     bool populated;
     // in the original plan that needs this engine
   };
@@ -470,6 +559,14 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
 
   std::unordered_map<std::string, std::string> queryIds;
 
+  // servers that the parts for a shard are sent to, if not its leader.
+  // only read-only queries accepting some staleness use followers
+  std::unordered_map<std::string, std::string> shardDestinations;
+  bool useFollowers = false;
+
+  // shards of the pending instantiation requests
+  std::unordered_map<arangodb::OperationID, std::string> operationShards;
+
   std::unordered_set<Collection*> auxiliaryCollections;
   // this map allows to find the queries which are the parts of the big
   // query. There are two cases, the first is for the remote queries on
@@ -512,6 +609,39 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
 
   ~CoordinatorInstanciator() {}
 
+  /// @brief id shared by all parts of the query on the DB servers
+  std::string traceId() const {
+    return arangodb::ServerState::instance()->getId() + ":" +
+           arangodb::basics::StringUtils::itoa(query->id());
+  }
+
+  /// @brief destination of all requests for the query parts on a shard
+  std::string destination(std::string const& shardId) const {
+    auto it = shardDestinations.find(shardId);
+    if (it != shardDestinations.end()) {
+      return it->second;
+    }
+    return "shard:" + shardId;
+  }
+
+  /// @brief pick the replica that runs the query parts on a shard. once
+  /// chosen, all parts for the shard go there, so that the main part
+  /// holds the locks for the dependent ones
+  void chooseDestination(EngineInfo* info, std::string const& shardId) {
+    if (!useFollowers || !info->getAuxiliaryCollections().empty() ||
+        !info->getCoShardedCollections().empty() ||
+        shardDestinations.find(shardId) != shardDestinations.end()) {
+      // the shards of satellite and co-sharded collections are only known
+      // to be in sync on the leader
+      return;
+    }
+    std::string server = arangodb::ClusterInfo::instance()->getReadServer(
+        shardId, query->queryOptions().maxStaleness / 1000.0);
+    if (!server.empty()) {
+      shardDestinations.emplace(shardId, "server:" + server);
+    }
+  }
+
   /// @brief generatePlanForOneShard
   void generatePlanForOneShard(VPackBuilder& builder, size_t nr,
                                EngineInfo* info, QueryId& connectedId,
@@ -584,6 +714,15 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
       result.add("type", VPackValue(AccessMode::typeString(collection->accessType)));
       result.close();
     }
+
+    // co-sharded collections have their current shard set to the one on
+    // the same server
+    for (auto const& coShardedCollection : info->getCoShardedCollections()) {
+      result.openObject();
+      result.add("name", VPackValue(coShardedCollection->getName()));
+      result.add("type", VPackValue(AccessMode::typeString(coShardedCollection->accessType)));
+      result.close();
+    }
     result.close(); // collections
 
     result.add(VPackObjectIterator(planSlice));
@@ -618,9 +757,13 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
 
       auto headers = std::make_unique<std::unordered_map<std::string, std::string>>();
       (*headers)["X-Arango-Nolock"] = shardId;  // Prevent locking
-      cc->asyncRequest("", coordTransactionID, "shard:" + shardId,
-                       arangodb::rest::RequestType::POST,
-                       url, body, headers, nullptr, 90.0);
+      // lets the DB server attribute the part to this query
+      (*headers)[StaticStrings::TraceIdHeader] = traceId();
+      arangodb::OperationID operationId =
+          cc->asyncRequest("", coordTransactionID, destination(shardId),
+                           arangodb::rest::RequestType::POST,
+                           url, body, headers, nullptr, 90.0);
+      operationShards.emplace(operationId, shardId);
     }
   }
 
@@ -655,9 +798,15 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
           // std::cout << "DB SERVER ANSWERED WITHOUT ERROR: " <<
           // res.answer->body() << ", REMOTENODEID: " << info.idOfRemoteNode <<
           // " SHARDID:"  << res.shardID << ", QUERYID: " << queryId << "\n";
+          // requests sent to a server directly do not carry the shard
+          std::string shardId = res.shardID;
+          auto it = operationShards.find(res.operationID);
+          if (it != operationShards.end()) {
+            shardId = it->second;
+          }
           std::string theID =
               arangodb::basics::StringUtils::itoa(info->idOfRemoteNode) + ":" +
-              res.shardID;
+              shardId;
 
           if (info->part == arangodb::aql::PART_MAIN) {
             queryId += "*";
@@ -687,8 +836,49 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
     }
   }
 
-  /// @brief distributePlansToShards, for a single Scatter/Gather block
-  void distributePlansToShards(EngineInfo* info, QueryId connectedId) {
+  /// @brief a DB server part whose instantiation requests were sent, but
+  /// whose answers were not yet collected
+  struct PendingInstantiation {
+    PendingInstantiation(EngineInfo* info,
+                         arangodb::CoordTransactionID coordTransactionID)
+        : info(info), coordTransactionID(coordTransactionID) {}
+
+    EngineInfo* info;
+    arangodb::CoordTransactionID coordTransactionID;
+  };
+
+  /// @brief collect the query ids of all pending DB server parts. all
+  /// answers are picked up even if one of the parts failed, so that the
+  /// query ids of the successfully instantiated parts are known for cleanup
+  void aggregatePendingQueryIds(std::vector<PendingInstantiation>& pending) {
+    std::exception_ptr error;
+
+    auto cc = arangodb::ClusterComm::instance();
+    if (cc != nullptr) {
+      // nullptr only happens on controlled shutdown
+      for (auto& it : pending) {
+        try {
+          aggregateQueryIds(it.info, cc, it.coordTransactionID,
+                            it.info->getCollection());
+        } catch (...) {
+          if (error == nullptr) {
+            error = std::current_exception();
+          }
+        }
+      }
+    }
+    pending.clear();
+
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  /// @brief distributePlansToShards, for a single Scatter/Gather block.
+  /// only sends the requests, the answers are collected by
+  /// aggregatePendingQueryIds
+  void distributePlansToShards(EngineInfo* info, QueryId connectedId,
+                               std::vector<PendingInstantiation>& pending) {
     //LOG_TOPIC(ERR, arangodb::Logger::FIXME) << "distributePlansToShards: " << info.id;
     Collection* collection = info->getCollection();
 
@@ -706,10 +896,24 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
       // iterate over all shards of the collection
       size_t nr = 0;
       auto shardIds = collection->shardIds(_includedShards);
+      auto allShardIds = collection->shardIds();
+      auto const& coShardedCollections = info->getCoShardedCollections();
       for (auto const& shardId : *shardIds) {
         // inject the current shard id into the collection
         VPackBuilder b;
         collection->setCurrentShard(shardId);
+        if (!coShardedCollections.empty()) {
+          // and the shard at the same position into co-sharded collections
+          size_t position =
+              std::find(allShardIds->begin(), allShardIds->end(), shardId) -
+              allShardIds->begin();
+          for (auto const& coShardedCollection : coShardedCollections) {
+            auto coShardIds = coShardedCollection->shardIds();
+            TRI_ASSERT(position < coShardIds->size());
+            coShardedCollection->setCurrentShard((*coShardIds)[position]);
+          }
+        }
+        chooseDestination(info, shardId);
         generatePlanForOneShard(b, nr++, info, connectedId, shardId, true);
 
         distributePlanToShard(coordTransactionID, info,
@@ -717,12 +921,15 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
                               b.slice());
       }
       collection->resetCurrentShard();
+      for (auto const& coShardedCollection : coShardedCollections) {
+        coShardedCollection->resetCurrentShard();
+      }
       for (auto const& auxiliaryCollection: auxiliaryCollections) {
         TRI_ASSERT(auxiliaryCollection->shardIds()->size() == 1);
         auxiliaryCollection->resetCurrentShard();
       }
 
-      aggregateQueryIds(info, cc, coordTransactionID, collection);
+      pending.emplace_back(info, coordTransactionID);
     }
   }
 
@@ -807,7 +1014,7 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
               idThere.pop_back();
             }
             ExecutionBlock* r = new RemoteBlock(engine.get(), remoteNode,
-                                                "shard:" + shardId,  // server
+                                                destination(shardId),  // server
                                                 "",                  // ownName
                                                 idThere);            // queryId
 
@@ -1080,12 +1287,27 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
   ExecutionEngine* buildEngines() {
     ExecutionEngine* engine = nullptr;
     QueryId id = 0;
+    // DB server parts are set up in parallel. their answers are only
+    // needed when the next coordinator part creates its RemoteBlocks
+    std::vector<PendingInstantiation> pending;
+
+    useFollowers = query->queryOptions().maxStaleness > 0.0;
+    for (auto const& info : engines) {
+      for (auto const& node : info.nodes) {
+        if (node->isModificationNode()) {
+          // writes and the reads they depend on must see the leader's data
+          useFollowers = false;
+        }
+      }
+    }
 
     for (auto it = engines.rbegin(); it != engines.rend(); ++it) {
       EngineInfo* info = &(*it);
       //LOG_TOPIC(ERR, arangodb::Logger::FIXME) << "Doing engine: " << it->id << " location:"
       //          << it->location;
       if (info->location == COORDINATOR) {
+        aggregatePendingQueryIds(pending);
+
         // create a coordinator-based engine
         engine = buildEngineCoordinator(info);
         TRI_ASSERT(engine != nullptr);
@@ -1118,10 +1340,12 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
       } else {
         // create an engine on a remote DB server
         // hand in the previous engine's id
-        distributePlansToShards(info, id);
+        distributePlansToShards(info, id, pending);
       }
     }
 
+    aggregatePendingQueryIds(pending);
+
     TRI_ASSERT(engine != nullptr);
     // return the last created coordinator-based engine
     // this is the local engine that we'll use to run the query
@@ -1180,6 +1404,24 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
 };
   
 /// @brief shutdown, will be called exactly once for the whole query
+/// @brief getSome, the CPU time and reads are added to the query's usage
+AqlItemBlock* ExecutionEngine::getSome(size_t atLeast, size_t atMost) {
+  QueryUsageTracker tracker(_query->usage(), _stats);
+  return _root->getSome(atLeast, atMost);
+}
+
+/// @brief skipSome
+size_t ExecutionEngine::skipSome(size_t atLeast, size_t atMost) {
+  QueryUsageTracker tracker(_query->usage(), _stats);
+  return _root->skipSome(atLeast, atMost);
+}
+
+/// @brief skip
+bool ExecutionEngine::skip(size_t number, size_t& actuallySkipped) {
+  QueryUsageTracker tracker(_query->usage(), _stats);
+  return _root->skip(number, actuallySkipped);
+}
+
 int ExecutionEngine::shutdown(int errorCode) {
   int res = TRI_ERROR_NO_ERROR;
   if (_root != nullptr && !_wasShutdown) {
@@ -1198,6 +1440,26 @@ int ExecutionEngine::shutdown(int errorCode) {
  
     // prevent a duplicate shutdown
     _wasShutdown = true;
+
+    if (!_traceId.empty()) {
+      ExecutionSnippetStats snippet;
+      snippet.server = arangodb::ServerState::instance()->getId();
+      snippet.shard = _traceShard;
+      snippet.started = _query->startTime();
+      snippet.runtime = TRI_microtime() - snippet.started;
+      snippet.items = _tracedItems;
+
+      auto queryList = _query->vocbase()->queryList();
+      if (queryList->trackSlowQueries() &&
+          queryList->slowQueryThreshold() >= 0.0 &&
+          snippet.runtime >= queryList->slowQueryThreshold()) {
+        LOG_TOPIC(WARN, Logger::QUERIES)
+            << "slow query part: trace id '" << _traceId << "', shard '"
+            << snippet.shard << "', items: " << snippet.items
+            << ", took: " << Logger::FIXED(snippet.runtime);
+      }
+      _stats.snippets.emplace_back(std::move(snippet));
+    }
   }
 
   return res;
@@ -1331,7 +1593,8 @@ ExecutionEngine* ExecutionEngine::instantiateFromPlan(
                 "/_db/" +
                 arangodb::basics::StringUtils::urlEncode(vocbase->name()) +
                 "/_api/aql/lock/" + queryId);
-            res = cc->syncRequest("", coordTransactionID, "shard:" + shardId,
+            res = cc->syncRequest("", coordTransactionID,
+                                  inst->destination(shardId),
                                   RequestType::PUT, url, "{}", headers, 90.0);
           }
           if (res->status != CL_COMM_SENT) {
@@ -1371,7 +1634,8 @@ ExecutionEngine* ExecutionEngine::instantiateFromPlan(
                   "/_api/aql/shutdown/" + queryId);
               std::unordered_map<std::string, std::string> headers;
               auto res =
-                  cc->syncRequest("", coordTransactionID, "shard:" + shardId,
+                  cc->syncRequest("", coordTransactionID,
+                                  inst->destination(shardId),
                                   arangodb::rest::RequestType::PUT,
                                   url, "{\"code\": 0}", headers, 120.0);
               // Ignore result, we need to try to remove all.
@@ -1445,6 +1709,8 @@ ExecutionEngine* ExecutionEngine::instantiateFromPlan(
           static_cast<ReturnBlock*>(root)->returnInheritedResults());
     }
 
+    PropagateLimitHints(root, 0);
+
     engine->_root = root;
 
     if (plan->isResponsibleForInitialize()) {
@@ -76,23 +76,17 @@ class ExecutionEngine {
   /// @brief shutdown, will be called exactly once for the whole query
   int shutdown(int errorCode);
 
-  /// @brief getSome
-  AqlItemBlock* getSome(size_t atLeast, size_t atMost) {
-    return _root->getSome(atLeast, atMost);
-  }
+  /// @brief getSome, the CPU time and reads are added to the query's usage
+  AqlItemBlock* getSome(size_t atLeast, size_t atMost);
 
   /// @brief skipSome
-  size_t skipSome(size_t atLeast, size_t atMost) {
-    return _root->skipSome(atLeast, atMost);
-  }
+  size_t skipSome(size_t atLeast, size_t atMost);
 
   /// @brief getOne
-  AqlItemBlock* getOne() { return _root->getSome(1, 1); }
+  AqlItemBlock* getOne() { return getSome(1, 1); }
 
   /// @brief skip
-  bool skip(size_t number, size_t& actuallySkipped) { 
-    return _root->skip(number, actuallySkipped); 
-  }
+  bool skip(size_t number, size_t& actuallySkipped);
 
   /// @brief hasMore
   inline bool hasMore() const { return _root->hasMore(); }
@@ -124,6 +118,17 @@ class ExecutionEngine {
     return _lockedShards;
   }
 
+  /// @brief mark the engine as a part of the cluster query with the given
+  /// trace id, running for the given shard. such engines add their timing
+  /// to the statistics on shutdown
+  void trace(std::string const& traceId, std::string const& shard) {
+    _traceId = traceId;
+    _traceShard = shard;
+  }
+
+  /// @brief count rows returned or skipped for the coordinator
+  void traceItems(size_t items) { _tracedItems += items; }
+
  public:
   /// @brief execution statistics for the query
   /// note that the statistics are modification by execution blocks
@@ -154,6 +159,15 @@ class ExecutionEngine {
 
   /// @brief _lockedShards, these are the shards we have locked for our query
   std::unordered_set<std::string>* _lockedShards;
+
+  /// @brief trace id of the cluster query, empty if not a traced part
+  std::string _traceId;
+
+  /// @brief shard of the traced part
+  std::string _traceShard;
+
+  /// @brief rows returned or skipped by the traced part
+  size_t _tracedItems;
 };
 }
 }
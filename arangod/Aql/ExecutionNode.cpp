@@ -29,9 +29,11 @@
 #include "Aql/Collection.h"
 #include "Aql/CollectNode.h"
 #include "Aql/ExecutionPlan.h"
+#include "Aql/HashJoinNode.h"
 #include "Aql/IndexNode.h"
 #include "Aql/ModificationNodes.h"
 #include "Aql/Query.h"
+#include "Aql/SelectivityEstimator.h"
 #include "Aql/SortNode.h"
 #include "Aql/TraversalNode.h"
 #include "Aql/ShortestPathNode.h"
@@ -73,7 +75,8 @@ std::unordered_map<int, std::string const> const ExecutionNode::TypeNames{
     {static_cast<int>(NORESULTS), "NoResultsNode"},
     {static_cast<int>(UPSERT), "UpsertNode"},
     {static_cast<int>(TRAVERSAL), "TraversalNode"},
-    {static_cast<int>(SHORTEST_PATH), "ShortestPathNode"}};
+    {static_cast<int>(SHORTEST_PATH), "ShortestPathNode"},
+    {static_cast<int>(HASH_JOIN), "HashJoinNode"}};
 
 /// @brief returns the type name of the node
 std::string const& ExecutionNode::getTypeString() const {
@@ -258,6 +261,8 @@ ExecutionNode* ExecutionNode::fromVPackFactory(
       return new TraversalNode(plan, slice);
     case SHORTEST_PATH:
       return new ShortestPathNode(plan, slice);
+    case HASH_JOIN:
+      return new HashJoinNode(plan, slice);
   }
   return nullptr;
 }
@@ -550,7 +555,7 @@ ExecutionNode const* ExecutionNode::getLoop() const {
     auto type = node->getType();
 
     if (type == ENUMERATE_COLLECTION || type == INDEX || type == TRAVERSAL ||
-        type == ENUMERATE_LIST || type == SHORTEST_PATH) {
+        type == ENUMERATE_LIST || type == SHORTEST_PATH || type == HASH_JOIN) {
       return node;
     }
   }
@@ -825,6 +830,22 @@ void ExecutionNode::RegisterPlan::after(ExecutionNode* en) {
       break;
     }
 
+    case ExecutionNode::HASH_JOIN: {
+      depth++;
+      nrRegsHere.emplace_back(1);
+      // create a copy of the last value here
+      // this is requried because back returns a reference and emplace/push_back
+      // may invalidate all references
+      RegisterId registerId = 1 + nrRegs.back();
+      nrRegs.emplace_back(registerId);
+
+      auto ep = static_cast<HashJoinNode const*>(en);
+      TRI_ASSERT(ep != nullptr);
+      varInfo.emplace(ep->outVariable()->id, VarInfo(depth, totalNrRegs));
+      totalNrRegs++;
+      break;
+    }
+
     case ExecutionNode::ENUMERATE_LIST: {
       depth++;
       nrRegsHere.emplace_back(1);
@@ -1176,6 +1197,7 @@ ExecutionNode* EnumerateCollectionNode::clone(ExecutionPlan* plan,
                                        outVariable, _random);
 
   c->setProjection(_projection);
+  c->setProjections(_projections);
 
   cloneHelper(c, plan, withDependencies, withProperties);
 
@@ -1632,16 +1654,24 @@ ExecutionNode* FilterNode::clone(ExecutionPlan* plan, bool withDependencies,
 /// @brief estimateCost
 double FilterNode::estimateCost(size_t& nrItems) const {
   double depCost = _dependencies.at(0)->getCost(nrItems);
-  // We are pessimistic here by not reducing the nrItems. However, in the
-  // worst case the filter does not reduce the items at all. Furthermore,
-  // no optimizer rule introduces FilterNodes, thus it is not important
-  // that they appear to lower the costs. Note that contrary to this,
-  // an IndexNode does lower the costs, it also has a better idea
-  // to what extent the number of items is reduced. On the other hand it
-  // is important that a FilterNode produces additional costs, otherwise
-  // the rule throwing away a FilterNode that is already covered by an
-  // IndexNode cannot reduce the costs.
-  return depCost + nrItems;
+  // Without attribute statistics we are pessimistic here by not reducing
+  // the nrItems. However, in the worst case the filter does not reduce the
+  // items at all. Furthermore, no optimizer rule introduces FilterNodes,
+  // thus it is not important that they appear to lower the costs. Note that
+  // contrary to this, an IndexNode does lower the costs, it also has a
+  // better idea to what extent the number of items is reduced. On the other
+  // hand it is important that a FilterNode produces additional costs,
+  // otherwise the rule throwing away a FilterNode that is already covered by
+  // an IndexNode cannot reduce the costs.
+  double const cost = depCost + nrItems;
+
+  double selectivity;
+  bool complete;
+  if (SelectivityEstimator(_plan).selectivity(_inVariable, selectivity,
+                                              complete)) {
+    nrItems = static_cast<size_t>(std::ceil(nrItems * selectivity));
+  }
+  return cost;
 }
 
 ReturnNode::ReturnNode(ExecutionPlan* plan, arangodb::velocypack::Slice const& base)
@@ -128,7 +128,8 @@ class ExecutionNode {
     UPSERT = 21,
     TRAVERSAL = 22,
     INDEX = 23,
-    SHORTEST_PATH = 24
+    SHORTEST_PATH = 24,
+    HASH_JOIN = 25
   };
 
   ExecutionNode() = delete;
@@ -854,6 +855,9 @@ class LimitNode : public ExecutionNode {
   /// @brief tell the node to fully count what it will limit
   void setFullCount() { _fullCount = true; }
 
+  /// @brief whether or not the node fully counts what it limits
+  bool fullCount() const { return _fullCount; }
+
   /// @brief return the offset value
   size_t offset() const { return _offset; }
 
@@ -131,6 +131,10 @@ static std::unique_ptr<graph::BaseOptions> CreateTraversalOptions(
                 "due to unpredictable results. Use 'path' "
                 "or 'none' instead");
           }
+        } else if (name == "prune") {
+          VPackBuilder prune;
+          value->toVelocyPackValue(prune);
+          options->setPruneVertices(prune.slice());
         }
       }
     }
@@ -169,6 +173,11 @@ static std::unique_ptr<graph::BaseOptions> CreateShortestPathOptions(
               std::string(value->getStringValue(), value->getStringLength());
         } else if (name == "defaultWeight" && value->isNumericValue()) {
           options->defaultWeight = value->getDoubleValue();
+        } else if (name == "heuristicAttribute" && value->isStringValue()) {
+          options->heuristicAttribute =
+              std::string(value->getStringValue(), value->getStringLength());
+        } else if (name == "heuristicFactor" && value->isNumericValue()) {
+          options->heuristicFactor = value->getDoubleValue();
         }
       }
     }
@@ -1978,7 +1987,8 @@ bool ExecutionPlan::isDeadSimple() const {
         nodeType == ExecutionNode::ENUMERATE_LIST ||
         nodeType == ExecutionNode::TRAVERSAL ||
         nodeType == ExecutionNode::SHORTEST_PATH ||
-        nodeType == ExecutionNode::INDEX) {
+        nodeType == ExecutionNode::INDEX ||
+        nodeType == ExecutionNode::HASH_JOIN) {
       // these node types are not simple
       return false;
     }
@@ -25,6 +25,7 @@
 #include "Basics/Exceptions.h"
 
 #include <velocypack/Builder.h>
+#include <velocypack/Iterator.h>
 #include <velocypack/Value.h>
 #include <velocypack/velocypack-aliases.h>
 
@@ -47,6 +48,33 @@ void ExecutionStats::toVelocyPack(VPackBuilder& builder) const {
   }
       
   builder.add("executionTime", VPackValue(executionTime));
+
+  if (!nodes.empty()) {
+    builder.add("nodes", VPackValue(VPackValueType::Array));
+    for (auto const& it : nodes) {
+      builder.openObject();
+      builder.add("id", VPackValue(it.first));
+      builder.add("calls", VPackValue(it.second.calls));
+      builder.add("items", VPackValue(it.second.items));
+      builder.add("runtime", VPackValue(it.second.runtime));
+      builder.close();
+    }
+    builder.close();
+  }
+
+  if (!snippets.empty()) {
+    builder.add("snippets", VPackValue(VPackValueType::Array));
+    for (auto const& it : snippets) {
+      builder.openObject();
+      builder.add("server", VPackValue(it.server));
+      builder.add("shard", VPackValue(it.shard));
+      builder.add("started", VPackValue(it.started));
+      builder.add("runtime", VPackValue(it.runtime));
+      builder.add("items", VPackValue(it.items));
+      builder.close();
+    }
+    builder.close();
+  }
   builder.close();
 }
 
@@ -94,4 +122,30 @@ ExecutionStats::ExecutionStats(VPackSlice const& slice)
   if (slice.hasKey("fullCount")) {
     fullCount = slice.get("fullCount").getNumber<int64_t>();
   }
+
+  // per-node statistics are only present if profiling was requested
+  VPackSlice nodesSlice = slice.get("nodes");
+  if (nodesSlice.isArray()) {
+    for (auto const& it : VPackArrayIterator(nodesSlice)) {
+      ExecutionNodeStats node;
+      node.calls = it.get("calls").getNumber<size_t>();
+      node.items = it.get("items").getNumber<size_t>();
+      node.runtime = it.get("runtime").getNumber<double>();
+      nodes[it.get("id").getNumber<size_t>()].add(node);
+    }
+  }
+
+  // snippet timings are only reported by the parts of cluster queries
+  VPackSlice snippetsSlice = slice.get("snippets");
+  if (snippetsSlice.isArray()) {
+    for (auto const& it : VPackArrayIterator(snippetsSlice)) {
+      ExecutionSnippetStats snippet;
+      snippet.server = it.get("server").copyString();
+      snippet.shard = it.get("shard").copyString();
+      snippet.started = it.get("started").getNumber<double>();
+      snippet.runtime = it.get("runtime").getNumber<double>();
+      snippet.items = it.get("items").getNumber<size_t>();
+      snippets.emplace_back(std::move(snippet));
+    }
+  }
 }
@@ -29,12 +29,58 @@
 #include <velocypack/Builder.h>
 #include <velocypack/Slice.h>
 
+#include <map>
+#include <vector>
+
 namespace arangodb {
 namespace velocypack {
 class Builder;
 }
 namespace aql {
 
+/// @brief statistics of a single execution node, only collected when the
+/// query is profiled per node
+struct ExecutionNodeStats {
+  ExecutionNodeStats() : calls(0), items(0), runtime(0.0) {}
+
+  void add(ExecutionNodeStats const& summand) {
+    calls += summand.calls;
+    items += summand.items;
+    runtime += summand.runtime;
+  }
+
+  /// @brief number of getSome/skipSome calls of the node's blocks
+  size_t calls;
+
+  /// @brief number of rows produced or skipped by the node's blocks
+  size_t items;
+
+  /// @brief wall-clock time spent in the node's blocks, including the
+  /// time spent in their dependencies
+  double runtime;
+};
+
+/// @brief timing of a query part that ran on a DB server, reported to the
+/// coordinator when the part is shut down
+struct ExecutionSnippetStats {
+  ExecutionSnippetStats() : started(0.0), runtime(0.0), items(0) {}
+
+  /// @brief id of the DB server that ran the part
+  std::string server;
+
+  /// @brief shard the part was instantiated for
+  std::string shard;
+
+  /// @brief wall-clock time of the DB server when the part was instantiated
+  double started;
+
+  /// @brief time from the instantiation of the part until its shutdown
+  double runtime;
+
+  /// @brief number of rows the part returned or skipped for the coordinator
+  size_t items;
+};
+
 struct ExecutionStats {
   ExecutionStats();
 
@@ -62,6 +108,11 @@ struct ExecutionStats {
       // fullCount may be negative, don't add it then
       fullCount += summand.fullCount;
     }
+    for (auto const& it : summand.nodes) {
+      nodes[it.first].add(it.second);
+    }
+    snippets.insert(snippets.end(), summand.snippets.begin(),
+                    summand.snippets.end());
     // intentionally no modification of executionTime
   }
 
@@ -74,6 +125,8 @@ struct ExecutionStats {
     httpRequests = 0;
     fullCount = -1;
     executionTime = 0.0;
+    nodes.clear();
+    snippets.clear();
   }
 
   /// @brief number of successfully executed write operations
@@ -100,6 +153,13 @@ struct ExecutionStats {
   /// @brief query execution time (wall-clock time). value will be set from 
   /// the outside
   double executionTime;
+
+  /// @brief per-node statistics, keyed by execution node id. only
+  /// populated when the query is profiled per node
+  std::map<size_t, ExecutionNodeStats> nodes;
+
+  /// @brief timings of the parts of a cluster query that ran on DB servers
+  std::vector<ExecutionSnippetStats> snippets;
 };
 }
 }
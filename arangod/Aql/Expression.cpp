@@ -155,6 +155,9 @@ AqlValue Expression::execute(transaction::Methods* trx, ExpressionContext* ctx,
     }
 
     case SIMPLE: {
+      if (_compiled) {
+        return _compiled(trx, mustDestroy);
+      }
       return executeSimpleExpression(_node, trx, mustDestroy, true);
     }
 
@@ -205,6 +208,10 @@ void Expression::replaceVariables(
   
   if ((_type == ATTRIBUTE_SYSTEM || _type == ATTRIBUTE_DYNAMIC) && _accessor != nullptr) {
     _accessor->replaceVariable(replacements);
+  } else if (_type == SIMPLE) {
+    // the compiled function still points to the old nodes
+    _compiled = nullptr;
+    _built = false;
   }
 
   invalidate();
@@ -233,6 +240,7 @@ void Expression::replaceVariableReference(Variable const* variable,
     _type = UNPROCESSED;
   } else if (_type == SIMPLE) {
     // must rebuild the expression completely, as it may have changed drastically
+    _compiled = nullptr;
     _built = false;
     _type = UNPROCESSED;
     _node->clearFlagsRecursive(); // recursively delete the node's flags
@@ -262,6 +270,7 @@ void Expression::replaceAttributeAccess(Variable const* variable,
     _type = UNPROCESSED;
   } else if (_type == SIMPLE) {
     // must rebuild the expression completely, as it may have changed drastically
+    _compiled = nullptr;
     _built = false;
     _type = UNPROCESSED;
     _node->clearFlagsRecursive(); // recursively delete the node's flags
@@ -470,11 +479,140 @@ void Expression::buildExpression(transaction::Methods* trx) {
       // pass which variables do not need to be fully constructed
       _func->setAttributeRestrictions(_attributes);
     }
+  } else if (_type == SIMPLE && _isDeterministic) {
+    // lower the expression into a tree of closures once, so executing it
+    // does not need to dispatch on the node types again for every call
+    _compiled = compileSimpleExpression(_node, true);
   }
 
   _built = true;
 }
 
+/// @brief compile an expression of type SIMPLE into a tree of closures.
+/// node types without a specialized implementation are handed to the
+/// regular interpreter, so every simple expression can be compiled
+Expression::CompiledFunction Expression::compileSimpleExpression(
+    AstNode const* node, bool doCopy) {
+  switch (node->type) {
+    case NODE_TYPE_VALUE: {
+      // the value is computed once and will not be copied
+      AqlValue const value(node->computeValue().begin());
+      return [value](transaction::Methods*, bool& mustDestroy) {
+        mustDestroy = false;
+        return value;
+      };
+    }
+
+    case NODE_TYPE_REFERENCE: {
+      return [this, node, doCopy](transaction::Methods* trx, bool& mustDestroy) {
+        return executeSimpleExpressionReference(node, trx, mustDestroy, doCopy);
+      };
+    }
+
+    case NODE_TYPE_ATTRIBUTE_ACCESS: {
+      // pre-resolve the full attribute path and look it up in one go
+      std::vector<std::string> path;
+      AstNode const* member = node;
+      while (member->type == NODE_TYPE_ATTRIBUTE_ACCESS) {
+        path.insert(path.begin(), member->getString());
+        member = member->getMemberUnchecked(0);
+      }
+      CompiledFunction base = compileSimpleExpression(member, false);
+      return [base, path](transaction::Methods* trx, bool& mustDestroy) {
+        AqlValue result = base(trx, mustDestroy);
+        AqlValueGuard guard(result, mustDestroy);
+        if (path.size() == 1) {
+          return result.get(trx, path[0], mustDestroy, true);
+        }
+        return result.get(trx, path, mustDestroy, true);
+      };
+    }
+
+    case NODE_TYPE_OPERATOR_UNARY_NOT: {
+      CompiledFunction operand = compileSimpleExpression(node->getMember(0), false);
+      return [operand](transaction::Methods* trx, bool& mustDestroy) {
+        AqlValue value = operand(trx, mustDestroy);
+        AqlValueGuard guard(value, mustDestroy);
+        bool const operandIsTrue = value.toBoolean();
+        mustDestroy = false; // only a boolean
+        return AqlValue(!operandIsTrue);
+      };
+    }
+
+    case NODE_TYPE_OPERATOR_BINARY_AND:
+    case NODE_TYPE_OPERATOR_BINARY_OR: {
+      CompiledFunction lhs = compileSimpleExpression(node->getMemberUnchecked(0), true);
+      CompiledFunction rhs = compileSimpleExpression(node->getMemberUnchecked(1), true);
+      bool const isAnd = (node->type == NODE_TYPE_OPERATOR_BINARY_AND);
+      return [lhs, rhs, isAnd](transaction::Methods* trx, bool& mustDestroy) {
+        AqlValue left = lhs(trx, mustDestroy);
+        if (left.toBoolean() != isAnd) {
+          // AND with a false left operand or OR with a true one
+          return left;
+        }
+        if (mustDestroy) { left.destroy(); }
+        return rhs(trx, mustDestroy);
+      };
+    }
+
+    case NODE_TYPE_OPERATOR_BINARY_EQ:
+    case NODE_TYPE_OPERATOR_BINARY_NE:
+    case NODE_TYPE_OPERATOR_BINARY_LT:
+    case NODE_TYPE_OPERATOR_BINARY_LE:
+    case NODE_TYPE_OPERATOR_BINARY_GT:
+    case NODE_TYPE_OPERATOR_BINARY_GE:
+    case NODE_TYPE_OPERATOR_BINARY_IN:
+    case NODE_TYPE_OPERATOR_BINARY_NIN: {
+      CompiledFunction lhs = compileSimpleExpression(node->getMemberUnchecked(0), false);
+      CompiledFunction rhs = compileSimpleExpression(node->getMemberUnchecked(1), false);
+      return [this, node, lhs, rhs](transaction::Methods* trx, bool& mustDestroy) {
+        AqlValue left = lhs(trx, mustDestroy);
+        AqlValueGuard guardLeft(left, mustDestroy);
+        AqlValue right = rhs(trx, mustDestroy);
+        AqlValueGuard guardRight(right, mustDestroy);
+        mustDestroy = false; // we're returning a boolean only
+        return compareValues(node, left, right, trx);
+      };
+    }
+
+    case NODE_TYPE_OPERATOR_BINARY_PLUS:
+    case NODE_TYPE_OPERATOR_BINARY_MINUS:
+    case NODE_TYPE_OPERATOR_BINARY_TIMES:
+    case NODE_TYPE_OPERATOR_BINARY_DIV:
+    case NODE_TYPE_OPERATOR_BINARY_MOD: {
+      CompiledFunction lhs = compileSimpleExpression(node->getMemberUnchecked(0), true);
+      CompiledFunction rhs = compileSimpleExpression(node->getMemberUnchecked(1), true);
+      return [this, node, lhs, rhs](transaction::Methods* trx, bool& mustDestroy) {
+        AqlValue left = lhs(trx, mustDestroy);
+        AqlValueGuard guardLeft(left, mustDestroy);
+        AqlValue right = rhs(trx, mustDestroy);
+        AqlValueGuard guardRight(right, mustDestroy);
+        mustDestroy = false;
+        return arithmeticValues(node, left, right, trx);
+      };
+    }
+
+    case NODE_TYPE_OPERATOR_TERNARY: {
+      CompiledFunction condition = compileSimpleExpression(node->getMember(0), false);
+      CompiledFunction truePart = compileSimpleExpression(node->getMemberUnchecked(1), true);
+      CompiledFunction falsePart = compileSimpleExpression(node->getMemberUnchecked(2), true);
+      return [condition, truePart, falsePart](transaction::Methods* trx, bool& mustDestroy) {
+        AqlValue value = condition(trx, mustDestroy);
+        bool const isTrue = value.toBoolean();
+        if (mustDestroy) { value.destroy(); }
+        return isTrue ? truePart(trx, mustDestroy) : falsePart(trx, mustDestroy);
+      };
+    }
+
+    default: {
+      // everything else is left to the interpreter
+      return [this, node, doCopy](transaction::Methods* trx, bool& mustDestroy) {
+        return executeSimpleExpression(node, trx, mustDestroy, doCopy);
+      };
+    }
+  }
+}
+
 /// @brief execute an expression of type SIMPLE, the convention is that
 /// the resulting AqlValue will be destroyed outside eventually
 AqlValue Expression::executeSimpleExpression(
@@ -1126,7 +1264,13 @@ AqlValue Expression::executeSimpleExpressionComparison(
   AqlValueGuard guardRight(right, mustDestroy);
 
   mustDestroy = false; // we're returning a boolean only
+  return compareValues(node, left, right, trx);
+}
 
+/// @brief apply a comparison operator to two already evaluated operands
+AqlValue Expression::compareValues(AstNode const* node, AqlValue const& left,
+                                   AqlValue const& right,
+                                   transaction::Methods* trx) const {
   if (node->type == NODE_TYPE_OPERATOR_BINARY_IN ||
       node->type == NODE_TYPE_OPERATOR_BINARY_NIN) {
     // IN and NOT IN
@@ -1535,19 +1679,23 @@ AqlValue Expression::executeSimpleExpressionArithmetic(
   AqlValueGuard guardRhs(rhs, mustDestroy);
 
   mustDestroy = false;
+  return arithmeticValues(node, lhs, rhs, trx);
+}
 
+/// @brief apply an arithmetic operator to two already evaluated operands
+AqlValue Expression::arithmeticValues(AstNode const* node, AqlValue const& lhs,
+                                      AqlValue const& rhs,
+                                      transaction::Methods* trx) const {
   bool failed = false;
   double l = lhs.toDouble(trx, failed);
 
   if (failed) {
-    TRI_ASSERT(!mustDestroy);
     l = 0.0;
   }
 
   double r = rhs.toDouble(trx, failed);
 
   if (failed) {
-    TRI_ASSERT(!mustDestroy);
     r = 0.0;
   }
 
@@ -1555,17 +1703,14 @@ AqlValue Expression::executeSimpleExpressionArithmetic(
     if (node->type == NODE_TYPE_OPERATOR_BINARY_DIV) {
       // division by zero
       RegisterWarning(_ast, "/", TRI_ERROR_QUERY_DIVISION_BY_ZERO);
-      TRI_ASSERT(!mustDestroy);
       return AqlValue(VelocyPackHelper::NullValue());
     } else if (node->type == NODE_TYPE_OPERATOR_BINARY_MOD) {
       // modulo zero
       RegisterWarning(_ast, "%", TRI_ERROR_QUERY_DIVISION_BY_ZERO);
-      TRI_ASSERT(!mustDestroy);
       return AqlValue(VelocyPackHelper::NullValue());
     }
   }
 
-  mustDestroy = false;
   double result;
 
   switch (node->type) {
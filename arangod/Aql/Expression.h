@@ -33,6 +33,8 @@
 #include <velocypack/Builder.h>
 #include <velocypack/Slice.h>
 
+#include <functional>
+
 namespace arangodb {
 namespace transaction {
 class Methods;
@@ -57,6 +59,9 @@ class Expression {
  public:
   enum ExpressionType : uint32_t { UNPROCESSED, JSON, V8, SIMPLE, ATTRIBUTE_SYSTEM, ATTRIBUTE_DYNAMIC };
 
+  /// @brief a simple expression lowered into a tree of closures
+  typedef std::function<AqlValue(transaction::Methods*, bool&)> CompiledFunction;
+
   Expression(Expression const&) = delete;
   Expression& operator=(Expression const&) = delete;
   Expression() = delete;
@@ -226,6 +231,17 @@ class Expression {
   /// executable code)
   void buildExpression(transaction::Methods*);
 
+  /// @brief compile an expression of type SIMPLE into a tree of closures
+  CompiledFunction compileSimpleExpression(AstNode const*, bool doCopy);
+
+  /// @brief apply a comparison operator to two already evaluated operands
+  AqlValue compareValues(AstNode const*, AqlValue const&, AqlValue const&,
+                         transaction::Methods*) const;
+
+  /// @brief apply an arithmetic operator to two already evaluated operands
+  AqlValue arithmeticValues(AstNode const*, AqlValue const&, AqlValue const&,
+                            transaction::Methods*) const;
+
   /// @brief execute an expression of type SIMPLE
   AqlValue executeSimpleExpression(AstNode const*,
                                    transaction::Methods*,
@@ -372,6 +388,9 @@ class Expression {
   std::unordered_map<Variable const*, std::unordered_set<std::string>>
       _attributes;
 
+  /// @brief the compiled version of a deterministic SIMPLE expression
+  CompiledFunction _compiled;
+
   /// @brief variables only temporarily valid during execution
   std::unordered_map<Variable const*, arangodb::velocypack::Slice> _variables;
 
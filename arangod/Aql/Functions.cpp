@@ -83,6 +83,18 @@ static AqlValue NumberValue(transaction::Methods* trx, double value, bool nullif
 }
 
 /// @brief validate the number of parameters
+/// @brief clamps a number of characters to the range of string offsets
+/// used by ICU, negative lengths are treated as 0
+static int32_t ClampedLength(int64_t length) {
+  if (length <= 0) {
+    return 0;
+  }
+  if (length > INT32_MAX) {
+    return INT32_MAX;
+  }
+  return static_cast<int32_t>(length);
+}
+
 void Functions::ValidateParameters(VPackFunctionParameters const& parameters,
                                    char const* function, int minParams,
                                    int maxParams) {
@@ -677,6 +689,38 @@ AqlValue Functions::MergeParameters(arangodb::aql::Query* query,
   return AqlValue(builder);
 }
 
+/// @brief sorts an array of slices. the comparator may use the collection
+/// name resolver of the transaction, which is not thread-safe, so the sort
+/// stays on the calling thread
+template <typename Less>
+static void SortSlices(std::vector<VPackSlice>& values, Less const& less) {
+  std::sort(values.begin(), values.end(), less);
+}
+
+/// @brief collects the slices of an array into a sorted vector without
+/// duplicates
+template <typename Less>
+static void SortedUniqueSlices(VPackSlice array, Less const& less,
+                               std::vector<VPackSlice>& result) {
+  result.clear();
+  result.reserve(static_cast<size_t>(array.length()));
+  for (auto const& it : VPackArrayIterator(array)) {
+    if (!it.isNone()) {
+      result.emplace_back(it);
+    }
+  }
+
+  SortSlices(result, less);
+
+  // the values are sorted, so two values are equal if the first one is not
+  // less than the second one
+  result.erase(std::unique(result.begin(), result.end(),
+                           [&less](VPackSlice const& lhs, VPackSlice const& rhs) {
+                             return !less(lhs, rhs);
+                           }),
+               result.end());
+}
+
 /// @brief internal recursive flatten helper
 static void FlattenList(VPackSlice const& array, size_t maxDepth,
                         size_t curDepth, VPackBuilder& result) {
@@ -1231,6 +1275,136 @@ AqlValue Functions::Upper(arangodb::aql::Query* query,
   return AqlValue(utf8.c_str(), utf8.length());
 }
 
+/// @brief function LEFT
+AqlValue Functions::Left(arangodb::aql::Query* query,
+                         transaction::Methods* trx,
+                         VPackFunctionParameters const& parameters) {
+  ValidateParameters(parameters, "LEFT", 2, 2);
+
+  AqlValue value = ExtractFunctionParameterValue(trx, parameters, 0);
+  int64_t length =
+      ExtractFunctionParameterValue(trx, parameters, 1).toInt64(trx);
+
+  transaction::StringBufferLeaser buffer(trx);
+  arangodb::basics::VPackStringBufferAdapter adapter(buffer->stringBuffer());
+
+  AppendAsString(trx, adapter, value);
+
+  UnicodeString s(buffer->c_str(), buffer->length());
+  int32_t const end = s.moveIndex32(0, ClampedLength(length));
+
+  std::string utf8;
+  s.tempSubString(0, end).toUTF8String(utf8);
+
+  return AqlValue(utf8.c_str(), utf8.length());
+}
+
+/// @brief function RIGHT
+AqlValue Functions::Right(arangodb::aql::Query* query,
+                          transaction::Methods* trx,
+                          VPackFunctionParameters const& parameters) {
+  ValidateParameters(parameters, "RIGHT", 2, 2);
+
+  AqlValue value = ExtractFunctionParameterValue(trx, parameters, 0);
+  int64_t length =
+      ExtractFunctionParameterValue(trx, parameters, 1).toInt64(trx);
+
+  transaction::StringBufferLeaser buffer(trx);
+  arangodb::basics::VPackStringBufferAdapter adapter(buffer->stringBuffer());
+
+  AppendAsString(trx, adapter, value);
+
+  UnicodeString s(buffer->c_str(), buffer->length());
+  int32_t const start = s.moveIndex32(s.length(), -ClampedLength(length));
+
+  std::string utf8;
+  s.tempSubString(start).toUTF8String(utf8);
+
+  return AqlValue(utf8.c_str(), utf8.length());
+}
+
+/// @brief function SUBSTRING
+AqlValue Functions::Substring(arangodb::aql::Query* query,
+                              transaction::Methods* trx,
+                              VPackFunctionParameters const& parameters) {
+  ValidateParameters(parameters, "SUBSTRING", 2, 3);
+
+  AqlValue value = ExtractFunctionParameterValue(trx, parameters, 0);
+  int64_t offset =
+      ExtractFunctionParameterValue(trx, parameters, 1).toInt64(trx);
+
+  transaction::StringBufferLeaser buffer(trx);
+  arangodb::basics::VPackStringBufferAdapter adapter(buffer->stringBuffer());
+
+  AppendAsString(trx, adapter, value);
+
+  UnicodeString s(buffer->c_str(), buffer->length());
+
+  // a negative offset is counted from the end of the string
+  int32_t const start =
+      (offset < 0)
+          ? s.moveIndex32(s.length(), -ClampedLength(-(std::max)(
+                                          offset, int64_t(-INT32_MAX))))
+          : s.moveIndex32(0, ClampedLength(offset));
+  int32_t end = s.length();
+
+  if (parameters.size() == 3) {
+    AqlValue length = ExtractFunctionParameterValue(trx, parameters, 2);
+    if (!length.isNull(true)) {
+      end = s.moveIndex32(start, ClampedLength(length.toInt64(trx)));
+    }
+  }
+
+  std::string utf8;
+  s.tempSubString(start, end - start).toUTF8String(utf8);
+
+  return AqlValue(utf8.c_str(), utf8.length());
+}
+
+/// @brief function REVERSE
+AqlValue Functions::Reverse(arangodb::aql::Query* query,
+                            transaction::Methods* trx,
+                            VPackFunctionParameters const& parameters) {
+  ValidateParameters(parameters, "REVERSE", 1, 1);
+
+  AqlValue value = ExtractFunctionParameterValue(trx, parameters, 0);
+
+  if (value.isArray()) {
+    AqlValueMaterializer materializer(trx);
+    VPackSlice slice = materializer.slice(value, false);
+
+    std::vector<VPackSlice> members;
+    members.reserve(static_cast<size_t>(slice.length()));
+    for (auto const& it : VPackArrayIterator(slice)) {
+      members.emplace_back(it);
+    }
+
+    transaction::BuilderLeaser builder(trx);
+    builder->openArray();
+    for (auto it = members.rbegin(); it != members.rend(); ++it) {
+      builder->add(*it);
+    }
+    builder->close();
+    return AqlValue(builder.get());
+  }
+
+  if (value.isString()) {
+    VPackValueLength l;
+    char const* p = value.slice().getString(l);
+
+    // reverses code points, surrogate pairs are kept intact
+    UnicodeString s(p, static_cast<int32_t>(l));
+    s.reverse();
+
+    std::string utf8;
+    s.toUTF8String(utf8);
+    return AqlValue(utf8.c_str(), utf8.length());
+  }
+
+  RegisterWarning(query, "REVERSE", TRI_ERROR_QUERY_ARRAY_EXPECTED);
+  return AqlValue(arangodb::basics::VelocyPackHelper::NullValue());
+}
+
 /// @brief function LIKE
 AqlValue Functions::Like(arangodb::aql::Query* query,
                          transaction::Methods* trx,
@@ -1935,10 +2109,14 @@ AqlValue Functions::Unique(arangodb::aql::Query* query,
   AqlValueMaterializer materializer(trx);
   VPackSlice slice = materializer.slice(value, false);
 
+  // size the set for the input up front instead of rehashing while
+  // inserting
   auto options = trx->transactionContextPtr()->getVPackOptions();
   std::unordered_set<VPackSlice, arangodb::basics::VelocyPackHelper::VPackHash,
                      arangodb::basics::VelocyPackHelper::VPackEqual>
-      values(512, arangodb::basics::VelocyPackHelper::VPackHash(),
+      values((std::max)(static_cast<size_t>(512),
+                        static_cast<size_t>(slice.length())),
+             arangodb::basics::VelocyPackHelper::VPackHash(),
              arangodb::basics::VelocyPackHelper::VPackEqual(options));
 
   for (auto const& s : VPackArrayIterator(slice)) {
@@ -1973,12 +2151,8 @@ AqlValue Functions::SortedUnique(arangodb::aql::Query* query,
   VPackSlice slice = materializer.slice(value, false);
 
   arangodb::basics::VelocyPackHelper::VPackLess<true> less(trx->transactionContext()->getVPackOptions(), &slice, &slice);
-  std::set<VPackSlice, arangodb::basics::VelocyPackHelper::VPackLess<true>> values(less);
-  for (auto const& it : VPackArrayIterator(slice)) {
-    if (!it.isNone()) {
-      values.insert(it);
-    }
-  }
+  std::vector<VPackSlice> values;
+  SortedUniqueSlices(slice, less, values);
 
   transaction::BuilderLeaser builder(trx);
   builder->openArray();
@@ -2087,17 +2261,18 @@ AqlValue Functions::UnionDistinct(arangodb::aql::Query* query,
 }
 
 /// @brief function INTERSECTION
+/// the arrays are sorted and intersected by merging them, which does not
+/// need to allocate memory per element
 AqlValue Functions::Intersection(arangodb::aql::Query* query,
                                  transaction::Methods* trx,
                                  VPackFunctionParameters const& parameters) {
   ValidateParameters(parameters, "INTERSECTION", 2);
 
-  auto options = trx->transactionContextPtr()->getVPackOptions();
-  std::unordered_map<VPackSlice, size_t,
-                     arangodb::basics::VelocyPackHelper::VPackHash,
-                     arangodb::basics::VelocyPackHelper::VPackEqual>
-      values(512, arangodb::basics::VelocyPackHelper::VPackHash(),
-             arangodb::basics::VelocyPackHelper::VPackEqual(options));
+  arangodb::basics::VelocyPackHelper::VPackLess<false> less(
+      trx->transactionContextPtr()->getVPackOptions());
+  std::vector<VPackSlice> values;
+  std::vector<VPackSlice> current;
+  std::vector<VPackSlice> merged;
 
   size_t const n = parameters.size();
   std::vector<AqlValueMaterializer> materializers;
@@ -2110,32 +2285,30 @@ AqlValue Functions::Intersection(arangodb::aql::Query* query,
       RegisterWarning(query, "INTERSECTION", TRI_ERROR_QUERY_ARRAY_EXPECTED);
       return AqlValue(arangodb::basics::VelocyPackHelper::NullValue());
     }
-    
+
+    if (i > 0 && values.empty()) {
+      // intersection is already empty, but all parameters must be arrays
+      continue;
+    }
+
     materializers.emplace_back(trx);
     VPackSlice slice = materializers.back().slice(value, false);
 
-    for (auto const& it : VPackArrayIterator(slice)) {
-      if (i == 0) {
-        // round one
-
-        TRI_IF_FAILURE("AqlFunctions::OutOfMemory1") {
-          THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
-        }
+    TRI_IF_FAILURE("AqlFunctions::OutOfMemory1") {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
+    }
 
-        values.emplace(it, 1);
-      } else {
-        // check if we have seen the same element before
-        auto found = values.find(it);
-        if (found != values.end()) {
-          // already seen
-          if ((*found).second < i) {
-            (*found).second = 0;
-          } else {
-            (*found).second = i + 1;
-          }
-        }
-      }
+    if (i == 0) {
+      // round one
+      SortedUniqueSlices(slice, less, values);
+      continue;
     }
+
+    SortedUniqueSlices(slice, less, current);
+    merged.clear();
+    std::set_intersection(values.begin(), values.end(), current.begin(),
+                          current.end(), std::back_inserter(merged), less);
+    values.swap(merged);
   }
 
   TRI_IF_FAILURE("AqlFunctions::OutOfMemory2") {
@@ -2145,9 +2318,7 @@ AqlValue Functions::Intersection(arangodb::aql::Query* query,
   transaction::BuilderLeaser builder(trx);
   builder->openArray();
   for (auto const& it : values) {
-    if (it.second == n) {
-      builder->add(it.first);
-    }
+    builder->add(it);
   }
   builder->close();
 
@@ -2502,6 +2673,8 @@ AqlValue Functions::Slice(arangodb::aql::Query* query,
 }
 
 /// @brief function Minus
+/// the arrays are sorted and subtracted by merging them, which does not
+/// need to allocate memory per element
 AqlValue Functions::Minus(arangodb::aql::Query* query,
                           transaction::Methods* trx,
                           VPackFunctionParameters const& parameters) {
@@ -2515,25 +2688,21 @@ AqlValue Functions::Minus(arangodb::aql::Query* query,
     return AqlValue(arangodb::basics::VelocyPackHelper::NullValue());
   }
 
-  auto options = trx->transactionContextPtr()->getVPackOptions();
-  std::unordered_map<VPackSlice, size_t,
-                     arangodb::basics::VelocyPackHelper::VPackHash,
-                     arangodb::basics::VelocyPackHelper::VPackEqual>
-      contains(512, arangodb::basics::VelocyPackHelper::VPackHash(),
-               arangodb::basics::VelocyPackHelper::VPackEqual(options));
+  arangodb::basics::VelocyPackHelper::VPackLess<false> less(
+      trx->transactionContextPtr()->getVPackOptions());
 
-  // Fill the original map
+  // Fill the original values
   AqlValueMaterializer materializer(trx);
   VPackSlice arraySlice = materializer.slice(baseArray, false);
-  
-  VPackArrayIterator it(arraySlice);
-  while (it.valid()) {
-    contains.emplace(it.value(), it.index());
-    it.next();
-  }
 
-  // Iterate through all following parameters and delete found elements from the
-  // map
+  std::vector<VPackSlice> values;
+  SortedUniqueSlices(arraySlice, less, values);
+
+  std::vector<VPackSlice> current;
+  std::vector<VPackSlice> remaining;
+
+  // Iterate through all following parameters and remove found elements from
+  // the values
   for (size_t k = 1; k < parameters.size(); ++k) {
     AqlValue next = ExtractFunctionParameterValue(trx, parameters, k);
     if (!next.isArray()) {
@@ -2541,24 +2710,27 @@ AqlValue Functions::Minus(arangodb::aql::Query* query,
                       TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
       return AqlValue(arangodb::basics::VelocyPackHelper::NullValue());
     }
-  
+
+    if (values.empty()) {
+      // nothing left to remove, but all parameters must be arrays
+      continue;
+    }
+
     AqlValueMaterializer materializer(trx);
     VPackSlice arraySlice = materializer.slice(next, false);
 
-    for (auto const& search : VPackArrayIterator(arraySlice)) {
-      auto find = contains.find(search);
-
-      if (find != contains.end()) {
-        contains.erase(find);
-      }
-    }
+    SortedUniqueSlices(arraySlice, less, current);
+    remaining.clear();
+    std::set_difference(values.begin(), values.end(), current.begin(),
+                        current.end(), std::back_inserter(remaining), less);
+    values.swap(remaining);
   }
 
   // We omit the normalize part from js, cannot occur here
   transaction::BuilderLeaser builder(trx);
   builder->openArray();
-  for (auto const& it : contains) {
-    builder->add(it.first);
+  for (auto const& it : values) {
+    builder->add(it);
   }
   builder->close();
   return AqlValue(builder.get());
@@ -145,6 +145,14 @@ struct Functions {
    static AqlValue Upper(arangodb::aql::Query*,
                               transaction::Methods*,
                               VPackFunctionParameters const&);
+   static AqlValue Left(arangodb::aql::Query*, transaction::Methods*,
+                        VPackFunctionParameters const&);
+   static AqlValue Right(arangodb::aql::Query*, transaction::Methods*,
+                         VPackFunctionParameters const&);
+   static AqlValue Substring(arangodb::aql::Query*, transaction::Methods*,
+                             VPackFunctionParameters const&);
+   static AqlValue Reverse(arangodb::aql::Query*, transaction::Methods*,
+                           VPackFunctionParameters const&);
    static AqlValue Like(arangodb::aql::Query*, transaction::Methods*,
                         VPackFunctionParameters const&);
    static AqlValue RegexTest(arangodb::aql::Query*, transaction::Methods*,
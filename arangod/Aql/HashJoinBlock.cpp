@@ -0,0 +1,367 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "HashJoinBlock.h"
+#include "Aql/AqlItemBlock.h"
+#include "Aql/AqlValue.h"
+#include "Aql/Collection.h"
+#include "Aql/ExecutionEngine.h"
+#include "Aql/Query.h"
+#include "Basics/Exceptions.h"
+#include "StorageEngine/DocumentIdentifierToken.h"
+#include "Transaction/Methods.h"
+#include "Utils/OperationCursor.h"
+#include "VocBase/ManagedDocumentResult.h"
+
+#include <velocypack/Iterator.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+using namespace arangodb::aql;
+
+HashJoinBlock::HashJoinBlock(ExecutionEngine* engine, HashJoinNode const* ep)
+    : ExecutionBlock(engine, ep),
+      _collection(ep->_collection),
+      _probeRegister(ExecutionNode::MaxRegisterId),
+      _outRegister(ExecutionNode::MaxRegisterId),
+      _built(false),
+      _probed(false),
+      _memoryUsage(0) {
+  auto const& registerPlan = ep->getRegisterPlan()->varInfo;
+
+  auto it = registerPlan.find(ep->_probeVariable->id);
+  TRI_ASSERT(it != registerPlan.end());
+  _probeRegister = (*it).second.registerId;
+
+  it = registerPlan.find(ep->_outVariable->id);
+  TRI_ASSERT(it != registerPlan.end());
+  _outRegister = (*it).second.registerId;
+
+  TRI_ASSERT(_probeRegister < ExecutionNode::MaxRegisterId);
+  TRI_ASSERT(_outRegister < ExecutionNode::MaxRegisterId);
+}
+
+HashJoinBlock::~HashJoinBlock() {
+  if (_memoryUsage > 0) {
+    _engine->getQuery()->resourceMonitor()->decreaseMemoryUsage(_memoryUsage);
+  }
+}
+
+/// @brief memory used by the build side. the hash table nodes are
+/// estimated as a key/value pair plus two pointers
+size_t HashJoinBlock::memoryUsage(VPackBuilder const& documents,
+                                  VPackBuilder const& keys, size_t entries,
+                                  size_t buckets) {
+  return static_cast<size_t>(documents.buffer()->capacity()) +
+         static_cast<size_t>(keys.buffer()->capacity()) +
+         entries * (2 * sizeof(VPackSlice) + 2 * sizeof(void*)) +
+         buckets * sizeof(void*);
+}
+
+/// @brief add the build attribute values of all documents to keys. the
+/// values are copied because attribute values may be computed (e.g. _id)
+/// or be returned inline
+void HashJoinBlock::buildKeys(transaction::Methods* trx, VPackSlice documents,
+                              std::vector<std::string> const& attribute,
+                              VPackBuilder& keys) {
+  keys.openArray();
+  for (auto const& document : VPackArrayIterator(documents)) {
+    AqlValue value(AqlValueHintNoCopy(document.begin()));
+    bool mustDestroy;
+    AqlValue key = value.get(trx, attribute, mustDestroy, false);
+    AqlValueGuard guard(key, mustDestroy);
+
+    AqlValueMaterializer materializer(trx);
+    VPackSlice slice = materializer.slice(key, false);
+    if (slice.isNone()) {
+      slice = VPackSlice::nullSlice();
+    }
+    keys.add(slice);
+  }
+  keys.close();
+}
+
+/// @brief insert all documents into the table. documents with equal keys
+/// are all kept
+void HashJoinBlock::fillHashTable(VPackSlice documents, VPackSlice keys,
+                                  HashTable& table) {
+  VPackArrayIterator it(documents);
+  for (auto const& key : VPackArrayIterator(keys)) {
+    TRI_ASSERT(it.valid());
+    table.emplace(key, it.value());
+    it.next();
+  }
+  TRI_ASSERT(!it.valid());
+}
+
+/// @brief look up the matches of a probe value. the returned iterators
+/// point into the table, so the probe value may be destroyed afterwards
+std::pair<HashJoinBlock::HashTable::const_iterator,
+          HashJoinBlock::HashTable::const_iterator>
+HashJoinBlock::lookup(transaction::Methods* trx, HashTable const& table,
+                      AqlValue const& value,
+                      std::vector<std::string> const& attribute) {
+  bool mustDestroy;
+  AqlValue key = value.get(trx, attribute, mustDestroy, false);
+  AqlValueGuard guard(key, mustDestroy);
+
+  AqlValueMaterializer materializer(trx);
+  VPackSlice slice = materializer.slice(key, false);
+  if (slice.isNone()) {
+    slice = VPackSlice::nullSlice();
+  }
+
+  return table.equal_range(slice);
+}
+
+/// @brief account for the current memory usage of the build side
+void HashJoinBlock::trackMemoryUsage() {
+  size_t usage =
+      memoryUsage(_documents, _keys, _table.size(), _table.bucket_count());
+
+  // the build side never shrinks while the block is alive
+  if (usage > _memoryUsage) {
+    _engine->getQuery()->resourceMonitor()->increaseMemoryUsage(usage -
+                                                                _memoryUsage);
+    _memoryUsage = usage;
+  }
+}
+
+int HashJoinBlock::initializeCursor(AqlItemBlock* items, size_t pos) {
+  DEBUG_BEGIN_BLOCK();
+  int res = ExecutionBlock::initializeCursor(items, pos);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  // the hash table is kept, so it is built only once, even if the
+  // block is used inside a subquery
+  _probed = false;
+
+  return TRI_ERROR_NO_ERROR;
+
+  // cppcheck-suppress style
+  DEBUG_END_BLOCK();
+}
+
+/// @brief read all documents of the collection and build the hash table
+void HashJoinBlock::buildHashTable() {
+  DEBUG_BEGIN_BLOCK();
+  TRI_ASSERT(!_built);
+
+  auto ep = static_cast<HashJoinNode const*>(getPlanNode());
+  ManagedDocumentResult mmdr;
+  std::unique_ptr<OperationCursor> cursor(
+      _trx->indexScan(_collection->getName(),
+                      transaction::Methods::CursorType::ALL, &mmdr, 0,
+                      UINT64_MAX, 1000, false));
+  TRI_ASSERT(cursor->successful());
+
+  size_t count = 0;
+  _documents.clear();
+  _documents.openArray();
+  while (cursor->nextDocument([&](DocumentIdentifierToken const&, VPackSlice slice) {
+    _documents.add(slice);
+    ++count;
+  }, 1000)) {
+    trackMemoryUsage();
+    throwIfKilled();  // check if we were aborted
+  }
+  _documents.close();
+  trackMemoryUsage();
+
+  _engine->_stats.scannedFull += static_cast<int64_t>(count);
+
+  // extract the build attribute of all documents
+  _keys.clear();
+  buildKeys(_trx, _documents.slice(), ep->_buildAttribute, _keys);
+
+  _table.clear();
+  _table.reserve(count);
+  trackMemoryUsage();
+
+  fillHashTable(_documents.slice(), _keys.slice(), _table);
+  trackMemoryUsage();
+
+  _built = true;
+  DEBUG_END_BLOCK();
+}
+
+/// @brief fetch the next input row and look up its matches. returns
+/// false if there is no more input
+bool HashJoinBlock::probe(size_t atMost) {
+  DEBUG_BEGIN_BLOCK();
+  if (_buffer.empty()) {
+    size_t toFetch = (std::min)(batchSize(), atMost);
+    if (!ExecutionBlock::getBlock(toFetch, toFetch)) {
+      return false;
+    }
+    _pos = 0;  // this is in the first block
+  }
+
+  auto ep = static_cast<HashJoinNode const*>(getPlanNode());
+  AqlItemBlock* cur = _buffer.front();
+
+  _matches = lookup(_trx, _table, cur->getValueReference(_pos, _probeRegister),
+                    ep->_probeAttribute);
+  _probed = true;
+
+  return true;
+  DEBUG_END_BLOCK();
+}
+
+/// @brief move on to the next input row, after all matches of the
+/// current one have been consumed
+void HashJoinBlock::nextInputRow() {
+  TRI_ASSERT(!_buffer.empty());
+  _probed = false;
+
+  AqlItemBlock* cur = _buffer.front();
+  if (++_pos >= cur->size()) {
+    _buffer.pop_front();  // does not throw
+    returnBlock(cur);
+    _pos = 0;
+  }
+}
+
+/// @brief getSome
+AqlItemBlock* HashJoinBlock::getSome(size_t,  // atLeast,
+                                     size_t atMost) {
+  DEBUG_BEGIN_BLOCK();
+  traceGetSomeBegin();
+
+  if (_done) {
+    traceGetSomeEnd(nullptr);
+    return nullptr;
+  }
+
+  if (!_built) {
+    buildHashTable();
+  }
+
+  RegisterId const nrRegs =
+      getPlanNode()->getRegisterPlan()->nrRegs[getPlanNode()->getDepth()];
+  std::unique_ptr<AqlItemBlock> res(requestBlock(atMost, nrRegs));
+
+  size_t send = 0;
+  // the row of res that has the registers of the current input row
+  size_t copyFromRow = 0;
+  bool inherited = false;
+
+  while (send < atMost) {
+    if (!_probed) {
+      if (!probe(atMost)) {
+        _done = true;
+        break;
+      }
+      inherited = false;
+    }
+
+    AqlItemBlock* cur = _buffer.front();
+    RegisterId const curRegs = cur->getNrRegs();
+    TRI_ASSERT(curRegs <= res->getNrRegs());
+
+    while (send < atMost && _matches.first != _matches.second) {
+      if (!inherited) {
+        // only copy the registers of the input row once
+        inheritRegisters(cur, res.get(), _pos, send);
+        copyFromRow = send;
+        inherited = true;
+      } else {
+        res->copyValuesFromRow(send, curRegs, copyFromRow);
+      }
+
+      // the documents are owned by this block, so there is no need to
+      // copy them
+      res->setValue(send, _outRegister,
+                    AqlValue(AqlValueHintNoCopy((*_matches.first).second.begin())));
+      ++send;
+      ++_matches.first;
+    }
+
+    if (_matches.first == _matches.second) {
+      nextInputRow();
+    }
+
+    throwIfKilled();  // check if we were aborted
+  }
+
+  if (send == 0) {
+    AqlItemBlock* dummy = res.release();
+    returnBlock(dummy);
+    traceGetSomeEnd(nullptr);
+    return nullptr;
+  }
+
+  if (send < atMost) {
+    res->shrink(send, false);
+  }
+
+  // Clear out registers no longer needed later:
+  clearRegisters(res.get());
+
+  traceGetSomeEnd(res.get());
+
+  return res.release();
+
+  // cppcheck-suppress style
+  DEBUG_END_BLOCK();
+}
+
+size_t HashJoinBlock::skipSome(size_t atLeast, size_t atMost) {
+  DEBUG_BEGIN_BLOCK();
+  traceSkipSomeBegin();
+  size_t skipped = 0;
+
+  if (_done) {
+    traceSkipSomeEnd(skipped);
+    return skipped;
+  }
+
+  if (!_built) {
+    buildHashTable();
+  }
+
+  while (skipped < atLeast) {
+    if (!_probed) {
+      if (!probe(atMost)) {
+        _done = true;
+        break;
+      }
+    }
+
+    while (skipped < atMost && _matches.first != _matches.second) {
+      ++skipped;
+      ++_matches.first;
+    }
+
+    if (_matches.first == _matches.second) {
+      nextInputRow();
+    }
+  }
+
+  traceSkipSomeEnd(skipped);
+  return skipped;
+
+  // cppcheck-suppress style
+  DEBUG_END_BLOCK();
+}
@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_AQL_HASH_JOIN_BLOCK_H
+#define ARANGOD_AQL_HASH_JOIN_BLOCK_H 1
+
+#include "Aql/ExecutionBlock.h"
+#include "Aql/HashJoinNode.h"
+#include "Basics/VelocyPackHelper.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/Slice.h>
+
+namespace arangodb {
+
+namespace aql {
+class AqlItemBlock;
+struct AqlValue;
+struct Collection;
+class ExecutionEngine;
+
+class HashJoinBlock final : public ExecutionBlock {
+ public:
+  HashJoinBlock(ExecutionEngine* engine, HashJoinNode const* ep);
+
+  ~HashJoinBlock();
+
+  /// @brief initializeCursor
+  int initializeCursor(AqlItemBlock* items, size_t pos) override;
+
+  /// @brief getSome
+  AqlItemBlock* getSome(size_t atLeast, size_t atMost) override final;
+
+  // skip between atLeast and atMost, returns the number actually skipped . . .
+  // will only return less than atLeast if there aren't atLeast many
+  // things to skip overall.
+  size_t skipSome(size_t atLeast, size_t atMost) override final;
+
+  typedef std::unordered_multimap<
+      arangodb::velocypack::Slice, arangodb::velocypack::Slice,
+      arangodb::basics::VelocyPackHelper::VPackHash,
+      arangodb::basics::VelocyPackHelper::VPackEqual> HashTable;
+
+  /// @brief memory used by the build side, for the given documents and
+  /// build attribute values and a hash table with the given number of
+  /// entries and buckets
+  static size_t memoryUsage(arangodb::velocypack::Builder const& documents,
+                            arangodb::velocypack::Builder const& keys,
+                            size_t entries, size_t buckets);
+
+  /// @brief add the values of the attribute of all documents to keys, in
+  /// the order of the documents. a missing attribute is added as null
+  static void buildKeys(transaction::Methods* trx,
+                        arangodb::velocypack::Slice documents,
+                        std::vector<std::string> const& attribute,
+                        arangodb::velocypack::Builder& keys);
+
+  /// @brief insert all documents into the table, using the values
+  /// produced by buildKeys
+  static void fillHashTable(arangodb::velocypack::Slice documents,
+                            arangodb::velocypack::Slice keys,
+                            HashTable& table);
+
+  /// @brief the documents in the table whose build attribute value equals
+  /// the attribute of the probe value. a missing attribute equals null
+  static std::pair<HashTable::const_iterator, HashTable::const_iterator>
+  lookup(transaction::Methods* trx, HashTable const& table,
+         AqlValue const& value, std::vector<std::string> const& attribute);
+
+ private:
+  /// @brief read all documents of the collection and build the hash table
+  void buildHashTable();
+
+  /// @brief fetch the next input row and look up its matches. returns
+  /// false if there is no more input
+  bool probe(size_t atMost);
+
+  /// @brief move on to the next input row, after all matches of the
+  /// current one have been consumed
+  void nextInputRow();
+
+  /// @brief account for the current memory usage of the build side in the
+  /// query's resource monitor. throws if the memory limit is exceeded
+  void trackMemoryUsage();
+
+ private:
+  /// @brief collection
+  Collection const* _collection;
+
+  /// @brief register to read the probe value from
+  RegisterId _probeRegister;
+
+  /// @brief register to write the documents to
+  RegisterId _outRegister;
+
+  /// @brief whether or not the hash table has been built
+  bool _built;
+
+  /// @brief whether or not _matches belongs to the current input row
+  bool _probed;
+
+  /// @brief all documents of the collection
+  arangodb::velocypack::Builder _documents;
+
+  /// @brief the build attribute values of all documents, in the same order
+  arangodb::velocypack::Builder _keys;
+
+  /// @brief build attribute value => document
+  HashTable _table;
+
+  /// @brief memory of the build side accounted for in the query's resource
+  /// monitor
+  size_t _memoryUsage;
+
+  /// @brief matches for the current input row that were not yet returned
+  std::pair<HashTable::const_iterator, HashTable::const_iterator> _matches;
+};
+
+}  // namespace arangodb::aql
+}  // namespace arangodb
+
+#endif
@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "HashJoinNode.h"
+#include "Aql/Ast.h"
+#include "Aql/Collection.h"
+#include "Aql/ExecutionPlan.h"
+#include "Aql/Query.h"
+#include "Transaction/Methods.h"
+
+#include <velocypack/Iterator.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+using namespace arangodb::aql;
+
+/// @brief read an attribute path from VelocyPack
+static std::vector<std::string> AttributeFromVelocyPack(VPackSlice const& base,
+                                                        char const* name) {
+  VPackSlice slice = base.get(name);
+
+  if (!slice.isArray()) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(
+        TRI_ERROR_INTERNAL,
+        std::string("unexpected value for HashJoinNode ") + name);
+  }
+
+  std::vector<std::string> result;
+  for (auto const& it : VPackArrayIterator(slice)) {
+    result.emplace_back(it.copyString());
+  }
+  return result;
+}
+
+/// @brief write an attribute path to VelocyPack
+static void AttributeToVelocyPack(VPackBuilder& nodes, char const* name,
+                                  std::vector<std::string> const& attribute) {
+  nodes.add(VPackValue(name));
+  nodes.openArray();
+  for (auto const& it : attribute) {
+    nodes.add(VPackValue(it));
+  }
+  nodes.close();
+}
+
+HashJoinNode::HashJoinNode(ExecutionPlan* plan, size_t id,
+                           TRI_vocbase_t* vocbase, Collection const* collection,
+                           Variable const* outVariable,
+                           std::vector<std::string> const& buildAttribute,
+                           Variable const* probeVariable,
+                           std::vector<std::string> const& probeAttribute)
+    : ExecutionNode(plan, id),
+      _vocbase(vocbase),
+      _collection(collection),
+      _outVariable(outVariable),
+      _buildAttribute(buildAttribute),
+      _probeVariable(probeVariable),
+      _probeAttribute(probeAttribute) {
+  TRI_ASSERT(_vocbase != nullptr);
+  TRI_ASSERT(_collection != nullptr);
+  TRI_ASSERT(_outVariable != nullptr);
+  TRI_ASSERT(_probeVariable != nullptr);
+  TRI_ASSERT(!_buildAttribute.empty());
+  TRI_ASSERT(!_probeAttribute.empty());
+}
+
+HashJoinNode::HashJoinNode(ExecutionPlan* plan,
+                           arangodb::velocypack::Slice const& base)
+    : ExecutionNode(plan, base),
+      _vocbase(plan->getAst()->query()->vocbase()),
+      _collection(plan->getAst()->query()->collections()->get(
+          base.get("collection").copyString())),
+      _outVariable(Variable::varFromVPack(plan->getAst(), base, "outVariable")),
+      _buildAttribute(AttributeFromVelocyPack(base, "buildAttribute")),
+      _probeVariable(
+          Variable::varFromVPack(plan->getAst(), base, "probeVariable")),
+      _probeAttribute(AttributeFromVelocyPack(base, "probeAttribute")) {
+  TRI_ASSERT(_vocbase != nullptr);
+  TRI_ASSERT(_collection != nullptr);
+}
+
+/// @brief toVelocyPack, for HashJoinNode
+void HashJoinNode::toVelocyPackHelper(VPackBuilder& nodes, bool verbose) const {
+  ExecutionNode::toVelocyPackHelperGeneric(nodes,
+                                           verbose);  // call base class method
+
+  nodes.add("database", VPackValue(_vocbase->name()));
+  nodes.add("collection", VPackValue(_collection->getName()));
+
+  nodes.add(VPackValue("outVariable"));
+  _outVariable->toVelocyPack(nodes);
+  AttributeToVelocyPack(nodes, "buildAttribute", _buildAttribute);
+
+  nodes.add(VPackValue("probeVariable"));
+  _probeVariable->toVelocyPack(nodes);
+  AttributeToVelocyPack(nodes, "probeAttribute", _probeAttribute);
+
+  // And close it:
+  nodes.close();
+}
+
+/// @brief clone ExecutionNode recursively
+ExecutionNode* HashJoinNode::clone(ExecutionPlan* plan, bool withDependencies,
+                                   bool withProperties) const {
+  auto outVariable = _outVariable;
+  auto probeVariable = _probeVariable;
+  if (withProperties) {
+    auto allVars = plan->getAst()->variables();
+    outVariable = allVars->createVariable(outVariable);
+    // the probe variable is set by another node. map it to the variable of
+    // the new AST, as cloneHelper() does, if that was already cloned
+    probeVariable = allVars->getVariable(_probeVariable->id);
+    if (probeVariable == nullptr) {
+      probeVariable = allVars->createVariable(_probeVariable);
+    }
+    TRI_ASSERT(outVariable != nullptr);
+    TRI_ASSERT(probeVariable != nullptr);
+  }
+
+  auto c = new HashJoinNode(plan, _id, _vocbase, _collection, outVariable,
+                            _buildAttribute, probeVariable, _probeAttribute);
+
+  cloneHelper(c, plan, withDependencies, withProperties);
+
+  return static_cast<ExecutionNode*>(c);
+}
+
+/// @brief the cost of a hash join node is one scan of the collection for
+/// building the hash table plus one lookup per incoming item. without any
+/// selectivity information we assume one match per lookup. inserting a
+/// document into the hash table is more expensive than a lookup, so of two
+/// otherwise equal plans the one building from the smaller collection wins
+double HashJoinNode::estimateCost(size_t& nrItems) const {
+  size_t incoming;
+  double depCost = _dependencies.at(0)->getCost(incoming);
+  transaction::Methods* trx = _plan->getAst()->query()->trx();
+  size_t count = _collection->count(trx);
+  nrItems = incoming;
+  return depCost + count * 3.0 + incoming + 1.0;
+}
@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_AQL_HASH_JOIN_NODE_H
+#define ARANGOD_AQL_HASH_JOIN_NODE_H 1
+
+#include "Basics/Common.h"
+#include "Aql/ExecutionNode.h"
+#include "Aql/types.h"
+#include "VocBase/voc-types.h"
+#include "VocBase/vocbase.h"
+
+#include <velocypack/Slice.h>
+
+namespace arangodb {
+
+namespace aql {
+struct Collection;
+class ExecutionBlock;
+class ExecutionPlan;
+struct Variable;
+
+/// @brief class HashJoinNode. enumerates all documents of a collection that
+/// have an attribute value equal to an attribute value of an input row.
+/// on first use, the documents of the collection are read into a hash table
+/// keyed by the build attribute, which is then probed with the probe
+/// attribute of every input row
+class HashJoinNode : public ExecutionNode {
+  friend class ExecutionBlock;
+  friend class HashJoinBlock;
+
+ public:
+  HashJoinNode(ExecutionPlan* plan, size_t id, TRI_vocbase_t* vocbase,
+               Collection const* collection, Variable const* outVariable,
+               std::vector<std::string> const& buildAttribute,
+               Variable const* probeVariable,
+               std::vector<std::string> const& probeAttribute);
+
+  HashJoinNode(ExecutionPlan*, arangodb::velocypack::Slice const& base);
+
+  /// @brief return the type of the node
+  NodeType getType() const override final { return HASH_JOIN; }
+
+  /// @brief return the database
+  TRI_vocbase_t* vocbase() const { return _vocbase; }
+
+  /// @brief return the collection
+  Collection const* collection() const { return _collection; }
+
+  /// @brief return the out variable
+  Variable const* outVariable() const { return _outVariable; }
+
+  /// @brief return the probe variable
+  Variable const* probeVariable() const { return _probeVariable; }
+
+  /// @brief export to VelocyPack
+  void toVelocyPackHelper(arangodb::velocypack::Builder&,
+                          bool) const override final;
+
+  /// @brief clone ExecutionNode recursively
+  ExecutionNode* clone(ExecutionPlan* plan, bool withDependencies,
+                       bool withProperties) const override final;
+
+  /// @brief getVariablesSetHere
+  std::vector<Variable const*> getVariablesSetHere() const override final {
+    return std::vector<Variable const*>{_outVariable};
+  }
+
+  /// @brief getVariablesUsedHere, returning a vector
+  std::vector<Variable const*> getVariablesUsedHere() const override final {
+    return std::vector<Variable const*>{_probeVariable};
+  }
+
+  /// @brief getVariablesUsedHere, modifying the set in-place
+  void getVariablesUsedHere(
+      std::unordered_set<Variable const*>& vars) const override final {
+    vars.emplace(_probeVariable);
+  }
+
+  /// @brief estimateCost
+  double estimateCost(size_t&) const override final;
+
+ private:
+  /// @brief the database
+  TRI_vocbase_t* _vocbase;
+
+  /// @brief collection
+  Collection const* _collection;
+
+  /// @brief output variable, for the documents of the collection
+  Variable const* _outVariable;
+
+  /// @brief attribute path of the documents to build the hash table from
+  std::vector<std::string> _buildAttribute;
+
+  /// @brief input variable to probe the hash table with
+  Variable const* _probeVariable;
+
+  /// @brief attribute path of the probe variable
+  std::vector<std::string> _probeAttribute;
+};
+
+}  // namespace arangodb::aql
+}  // namespace arangodb
+
+#endif
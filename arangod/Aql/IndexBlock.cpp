@@ -33,7 +33,10 @@
 #include "Basics/ScopeGuard.h"
 #include "Basics/StaticStrings.h"
 #include "Cluster/ServerState.h"
+#include "Indexes/Index.h"
 #include "StorageEngine/DocumentIdentifierToken.h"
+#include "StorageEngine/EngineSelectorFeature.h"
+#include "StorageEngine/StorageEngine.h"
 #include "Utils/OperationCursor.h"
 #include "V8/v8-globals.h"
 #include "VocBase/LogicalCollection.h"
@@ -58,7 +61,10 @@ IndexBlock::IndexBlock(ExecutionEngine* engine, IndexNode const* en)
       _hasV8Expression(false),
       _indexesExhausted(false),
       _isLastIndex(false),
-      _returned(0) {
+      _returned(0),
+      _useBatchLookups(false),
+      _batchPrepared(false),
+      _coveringProducer(buildCoveringCallback(en)) {
   _mmdr.reset(new ManagedDocumentResult);
 
   if (_condition != nullptr) {
@@ -91,6 +97,54 @@ IndexBlock::IndexBlock(ExecutionEngine* engine, IndexNode const* en)
 
 IndexBlock::~IndexBlock() { cleanupNonConstExpressions(); }
 
+/// @brief build the function that produces the projection from the
+/// indexed values, for covering index nodes. the index iterator hands out
+/// an array with one value per index attribute in this case
+DocumentProducingBlock::DocumentProducingFunction
+IndexBlock::buildCoveringCallback(IndexNode const* en) {
+  if (!en->isCovering()) {
+    return nullptr;
+  }
+
+  if (!produceResult()) {
+    // the callback does not look at the values at all
+    return _documentProducer;
+  }
+
+  TRI_ASSERT(_indexes.size() == 1);
+  size_t const position = en->coveringAttribute();
+  auto const& fields = _indexes[0].getIndex()->fields();
+  TRI_ASSERT(position < fields.size());
+
+  // the projection may refer to a sub-attribute of the indexed value
+  auto const& projection = en->projection();
+  TRI_ASSERT(fields[position].size() <= projection.size());
+  std::vector<std::string> subAttributes(
+      projection.begin() + fields[position].size(), projection.end());
+
+  return [position, subAttributes](AqlItemBlock* res, VPackSlice slice,
+                                   size_t registerId, size_t& row,
+                                   size_t fromRow) {
+    VPackSlice value = slice.at(position);
+    if (!subAttributes.empty()) {
+      value = value.isObject() ? value.get(subAttributes) : VPackSlice();
+    }
+    if (value.isNone()) {
+      // attribute not found
+      value = VPackSlice::nullSlice();
+    }
+    // the indexed values are owned by the index iterator, so they must be
+    // copied
+    res->setValue(row, static_cast<arangodb::aql::RegisterId>(registerId),
+                  AqlValue(AqlValueHintCopy(value.begin())));
+    if (row != fromRow) {
+      // re-use already copied AQLValues
+      res->copyValuesFromRow(row, static_cast<RegisterId>(registerId), fromRow);
+    }
+    ++row;
+  };
+}
+
 /// @brief adds a UNIQUE() to a dynamic IN condition
 arangodb::aql::AstNode* IndexBlock::makeUnique(
     arangodb::aql::AstNode* node) const {
@@ -240,6 +294,8 @@ int IndexBlock::initialize() {
     }
   }
 
+  _useBatchLookups = canUseBatchLookups();
+
   return res;
 
   // cppcheck-suppress style
@@ -422,7 +478,8 @@ bool IndexBlock::skipIndex(size_t atMost) {
 // this is called every time we need to fetch data from the indexes
 bool IndexBlock::readIndex(
     size_t atMost,
-    IndexIterator::DocumentCallback const& callback) {
+    IndexIterator::DocumentCallback const& callback,
+    IndexIterator::DocumentCallback const& coveringCallback) {
   DEBUG_BEGIN_BLOCK();
   // this is called every time we want to read the index.
   // For the primary key index, this only reads the index once, and never
@@ -456,7 +513,15 @@ bool IndexBlock::readIndex(
 
     TRI_ASSERT(atMost >= _returned);
   
-    if (_cursor->nextDocument(callback, atMost - _returned)) {
+    bool hasMore;
+    if (coveringCallback && _cursor->hasCovering()) {
+      // the index values are sufficient, the documents are not needed
+      hasMore = _cursor->nextCovering(coveringCallback, atMost - _returned);
+    } else {
+      hasMore = _cursor->nextDocument(callback, atMost - _returned);
+    }
+
+    if (hasMore) {
       // We have returned enough.
       // And this index could return more.
       // We are good.
@@ -482,6 +547,7 @@ int IndexBlock::initializeCursor(AqlItemBlock* items, size_t pos) {
   _returned = 0;
   _pos = 0;
   _currentIndex = 0;
+  _batchPrepared = false;
 
   return TRI_ERROR_NO_ERROR;
 
@@ -498,6 +564,12 @@ AqlItemBlock* IndexBlock::getSome(size_t atLeast, size_t atMost) {
     return nullptr;
   }
 
+  if (_useBatchLookups) {
+    AqlItemBlock* res = getSomeBatched(atMost);
+    traceGetSomeEnd(res);
+    return res;
+  }
+
   TRI_ASSERT(atMost > 0);
   size_t curRegs;
 
@@ -540,9 +612,20 @@ AqlItemBlock* IndexBlock::getSome(size_t atLeast, size_t atMost) {
     };
   }
 
+  IndexIterator::DocumentCallback coveringCallback;
+  if (_coveringProducer) {
+    // covering indexes are only used with a single index, so there
+    // are no uniqueness checks
+    TRI_ASSERT(_indexes.size() == 1);
+    coveringCallback = [&](DocumentIdentifierToken const&, VPackSlice slice) {
+      TRI_ASSERT(res.get() != nullptr);
+      _coveringProducer(res.get(), slice, curRegs, _returned, copyFromRow);
+    };
+  }
+
   do {
     if (_buffer.empty()) {
-      size_t toFetch = (std::min)(DefaultBatchSize(), atMost);
+      size_t toFetch = (std::min)(batchSize(), atMost);
       if (!ExecutionBlock::getBlock(toFetch, toFetch) || (!initIndexes())) {
         _done = true;
         break;
@@ -557,7 +640,7 @@ AqlItemBlock* IndexBlock::getSome(size_t atLeast, size_t atMost) {
         _pos = 0;
       }
       if (_buffer.empty()) {
-        if (!ExecutionBlock::getBlock(DefaultBatchSize(), DefaultBatchSize())) {
+        if (!ExecutionBlock::getBlock(batchSize(), batchSize())) {
           _done = true;
           break;
         }
@@ -584,7 +667,7 @@ AqlItemBlock* IndexBlock::getSome(size_t atLeast, size_t atMost) {
 
     // Read the next elements from the indexes
     auto saveReturned = _returned;
-    _indexesExhausted = !readIndex(atMost, callback);
+    _indexesExhausted = !readIndex(atMost, callback, coveringCallback);
     if (_returned == saveReturned) {
       // No results. Kill the registers:
       for (size_t i = 0; i < curRegs; ++i) {
@@ -623,15 +706,23 @@ AqlItemBlock* IndexBlock::getSome(size_t atLeast, size_t atMost) {
 /// @brief skipSome
 size_t IndexBlock::skipSome(size_t atLeast, size_t atMost) {
   DEBUG_BEGIN_BLOCK();
+  traceSkipSomeBegin();
   if (_done) {
+    traceSkipSomeEnd(0);
     return 0;
   }
 
+  if (_useBatchLookups) {
+    size_t skipped = skipSomeBatched(atLeast, atMost);
+    traceSkipSomeEnd(skipped);
+    return skipped;
+  }
+
   _returned = 0;
 
   while (_returned < atLeast) {
     if (_buffer.empty()) {
-      size_t toFetch = (std::min)(DefaultBatchSize(), atMost);
+      size_t toFetch = (std::min)(batchSize(), atMost);
       if (!ExecutionBlock::getBlock(toFetch, toFetch) || (!initIndexes())) {
         _done = true;
         break;
@@ -647,7 +738,7 @@ size_t IndexBlock::skipSome(size_t atLeast, size_t atMost) {
         _pos = 0;
       }
       if (_buffer.empty()) {
-        if (!ExecutionBlock::getBlock(DefaultBatchSize(), DefaultBatchSize())) {
+        if (!ExecutionBlock::getBlock(batchSize(), batchSize())) {
           _done = true;
           break;
         }
@@ -667,6 +758,7 @@ size_t IndexBlock::skipSome(size_t atLeast, size_t atMost) {
     _indexesExhausted = !skipIndex(atMost);
   }
 
+  traceSkipSomeEnd(_returned);
   return _returned;
 
   // cppcheck-suppress style
@@ -709,3 +801,235 @@ arangodb::OperationCursor* IndexBlock::orderCursor(size_t currentIndex) {
 
   return _cursors[currentIndex].get();
 }
+
+/// @brief whether or not the lookups for all rows of an input block can
+/// be done in one batch. this is the case for a single primary index
+/// with a condition of the form "doc._key == expression"
+bool IndexBlock::canUseBatchLookups() const {
+  if (_condition == nullptr || _hasV8Expression ||
+      _nonConstExpressions.size() != 1 || _indexes.size() != 1 ||
+      arangodb::ServerState::instance()->isRunningInCluster()) {
+    return false;
+  }
+
+  if (_indexes[0].getIndex()->type() !=
+      arangodb::Index::TRI_IDX_TYPE_PRIMARY_INDEX) {
+    return false;
+  }
+
+  if (_condition->numMembers() != 1 ||
+      _condition->getMemberUnchecked(0)->numMembers() != 1) {
+    return false;
+  }
+
+  auto leaf = _condition->getMemberUnchecked(0)->getMemberUnchecked(0);
+  if (leaf->type != NODE_TYPE_OPERATOR_BINARY_EQ) {
+    return false;
+  }
+
+  auto const& nce = _nonConstExpressions[0];
+  TRI_ASSERT(nce->orMember == 0 && nce->andMember == 0);
+  auto attribute = leaf->getMember(1 - nce->operatorMember);
+
+  auto en = static_cast<IndexNode const*>(getPlanNode());
+  return (attribute->type == NODE_TYPE_ATTRIBUTE_ACCESS &&
+          attribute->stringEquals(StaticStrings::KeyString) &&
+          attribute->getMember(0)->type == NODE_TYPE_REFERENCE &&
+          static_cast<Variable const*>(attribute->getMember(0)->getData()) ==
+              en->outVariable());
+}
+
+/// @brief look up the documents for all rows of the current input block.
+/// the keys are evaluated first, then sorted and deduplicated, so that
+/// each distinct key is looked up only once and in key order
+void IndexBlock::executeBatchLookups() {
+  DEBUG_BEGIN_BLOCK();
+  TRI_ASSERT(!_buffer.empty());
+
+  AqlItemBlock* cur = _buffer.front();
+  size_t const n = cur->size();
+  auto exp = _nonConstExpressions[0]->expression;
+
+  // pairs of key and row
+  std::vector<std::pair<std::string, size_t>> keys;
+  keys.reserve(n);
+
+  Functions::InitializeThreadContext();
+  try {
+    for (size_t row = 0; row < n; ++row) {
+      bool mustDestroy;
+      AqlValue a =
+          exp->execute(_trx, cur, row, _inVars[0], _inRegs[0], mustDestroy);
+      AqlValueGuard guard(a, mustDestroy);
+
+      if (a.isString()) {
+        // other types of values cannot match any _key
+        keys.emplace_back(a.slice().copyString(), row);
+      }
+    }
+    Functions::DestroyThreadContext();
+  } catch (...) {
+    Functions::DestroyThreadContext();
+    throw;
+  }
+
+  std::sort(keys.begin(), keys.end());
+
+  bool const useRawPointers =
+      EngineSelectorFeature::ENGINE->useRawDocumentPointers();
+
+  _batchDocuments.clear();
+  _batchDocuments.resize(n, nullptr);
+  _batchBuilder.clear();
+  _batchBuilder.openArray();
+
+  // position of each row's document in _batchBuilder
+  std::vector<std::pair<size_t, size_t>> positions;
+  size_t found = 0;
+  bool lastFound = false;
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (i == 0 || keys[i].first != keys[i - 1].first) {
+      Result res =
+          _trx->documentFastPathLocal(_collection->getName(), keys[i].first, *_mmdr);
+
+      if (res.fail()) {
+        if (res.errorNumber() != TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND) {
+          THROW_ARANGO_EXCEPTION(res);
+        }
+        lastFound = false;
+      } else {
+        lastFound = true;
+        if (!useRawPointers) {
+          _batchBuilder.add(VPackSlice(_mmdr->vpack()));
+          ++found;
+        }
+      }
+    }
+
+    if (lastFound) {
+      if (useRawPointers) {
+        _batchDocuments[keys[i].second] = _mmdr->vpack();
+      } else {
+        positions.emplace_back(found - 1, keys[i].second);
+      }
+    }
+  }
+
+  _batchBuilder.close();
+
+  if (!positions.empty()) {
+    // the documents are only at their final memory location now
+    VPackSlice documents = _batchBuilder.slice();
+    for (auto const& it : positions) {
+      _batchDocuments[it.second] = documents.at(it.first).begin();
+    }
+  }
+
+  throwIfKilled();  // check if we were aborted
+  DEBUG_END_BLOCK();
+}
+
+/// @brief move on to the next input row, for batch lookups
+void IndexBlock::nextBatchRow() {
+  AqlItemBlock* cur = _buffer.front();
+  if (++_pos >= cur->size()) {
+    _buffer.pop_front();  // does not throw
+    returnBlock(cur);
+    _pos = 0;
+    _batchPrepared = false;
+  }
+}
+
+/// @brief getSome, for batch lookups
+AqlItemBlock* IndexBlock::getSomeBatched(size_t atMost) {
+  DEBUG_BEGIN_BLOCK();
+  std::unique_ptr<AqlItemBlock> res(
+      requestBlock(atMost,
+      getPlanNode()->getRegisterPlan()->nrRegs[getPlanNode()->getDepth()]));
+  _returned = 0;
+
+  while (_returned < atMost) {
+    if (_buffer.empty()) {
+      size_t toFetch = (std::min)(batchSize(), atMost);
+      if (!ExecutionBlock::getBlock(toFetch, toFetch)) {
+        _done = true;
+        break;
+      }
+      _pos = 0;  // this is in the first block
+      _batchPrepared = false;
+    }
+
+    if (!_batchPrepared) {
+      executeBatchLookups();
+      _batchPrepared = true;
+    }
+
+    AqlItemBlock* cur = _buffer.front();
+    uint8_t const* document = _batchDocuments[_pos];
+
+    if (document != nullptr) {
+      RegisterId const curRegs = cur->getNrRegs();
+      TRI_ASSERT(curRegs <= res->getNrRegs());
+
+      inheritRegisters(cur, res.get(), _pos, _returned);
+      _documentProducer(res.get(), VPackSlice(document), curRegs, _returned,
+                        _returned);
+      ++_engine->_stats.scannedIndex;
+    }
+
+    nextBatchRow();
+  }
+
+  if (_returned == 0) {
+    AqlItemBlock* dummy = res.release();
+    returnBlock(dummy);
+    return nullptr;
+  }
+  if (_returned < atMost) {
+    res->shrink(_returned, false);
+  }
+
+  // Clear out registers no longer needed later:
+  clearRegisters(res.get());
+
+  return res.release();
+
+  // cppcheck-suppress style
+  DEBUG_END_BLOCK();
+}
+
+/// @brief skipSome, for batch lookups
+size_t IndexBlock::skipSomeBatched(size_t atLeast, size_t atMost) {
+  DEBUG_BEGIN_BLOCK();
+  _returned = 0;
+
+  while (_returned < atLeast) {
+    if (_buffer.empty()) {
+      size_t toFetch = (std::min)(batchSize(), atMost);
+      if (!ExecutionBlock::getBlock(toFetch, toFetch)) {
+        _done = true;
+        break;
+      }
+      _pos = 0;  // this is in the first block
+      _batchPrepared = false;
+    }
+
+    if (!_batchPrepared) {
+      executeBatchLookups();
+      _batchPrepared = true;
+    }
+
+    if (_batchDocuments[_pos] != nullptr) {
+      ++_returned;
+      ++_engine->_stats.scannedIndex;
+    }
+
+    nextBatchRow();
+  }
+
+  return _returned;
+
+  // cppcheck-suppress style
+  DEBUG_END_BLOCK();
+}
@@ -33,6 +33,8 @@
 #include "Indexes/IndexIterator.h"
 #include "StorageEngine/DocumentIdentifierToken.h"
 
+#include <velocypack/Builder.h>
+
 namespace arangodb {
 class ManagedDocumentResult;
 struct OperationCursor;
@@ -103,11 +105,32 @@ class IndexBlock final : public ExecutionBlock, public DocumentProducingBlock {
   bool skipIndex(size_t atMost);
 
   /// @brief continue fetching of documents
-  bool readIndex(size_t atMost, IndexIterator::DocumentCallback const&);
+  bool readIndex(size_t atMost, IndexIterator::DocumentCallback const&,
+                 IndexIterator::DocumentCallback const&);
+
+  /// @brief build the function that produces the projection from the
+  /// indexed values, for covering index nodes
+  DocumentProducingFunction buildCoveringCallback(IndexNode const* en);
 
   /// @brief frees the memory for all non-constant expressions
   void cleanupNonConstExpressions();
 
+  /// @brief whether or not the lookups for all rows of an input block can
+  /// be done in one batch
+  bool canUseBatchLookups() const;
+
+  /// @brief look up the documents for all rows of the current input block
+  void executeBatchLookups();
+
+  /// @brief getSome, for batch lookups
+  AqlItemBlock* getSomeBatched(size_t atMost);
+
+  /// @brief skipSome, for batch lookups
+  size_t skipSomeBatched(size_t atLeast, size_t atMost);
+
+  /// @brief move on to the next input row, for batch lookups
+  void nextBatchRow();
+
   /// @brief order a cursor for the index at the specified position
   OperationCursor* orderCursor(size_t currentIndex);
 
@@ -164,6 +187,25 @@ class IndexBlock final : public ExecutionBlock, public DocumentProducingBlock {
   /// @brief Counter how many documents have been returned/skipped
   ///        during one call.
   size_t _returned;
+
+  /// @brief whether or not the primary key lookups of a whole input block
+  /// are done in one batch
+  bool _useBatchLookups;
+
+  /// @brief whether or not _batchDocuments belongs to _buffer.front()
+  bool _batchPrepared;
+
+  /// @brief the document found for each row of the current input block,
+  /// or a nullptr if there is none
+  std::vector<uint8_t const*> _batchDocuments;
+
+  /// @brief copies of the documents found in the current batch, if the
+  /// storage engine does not hand out stable document pointers
+  arangodb::velocypack::Builder _batchBuilder;
+
+  /// @brief produces the projection from the indexed values; only set if
+  /// the projection is covered by the index
+  DocumentProducingFunction _coveringProducer;
 };
 
 }  // namespace arangodb::aql
@@ -27,6 +27,7 @@
 #include "Aql/Condition.h"
 #include "Aql/ExecutionPlan.h"
 #include "Aql/Query.h"
+#include "Aql/SelectivityEstimator.h"
 #include "Transaction/Methods.h"
 
 #include <velocypack/Iterator.h>
@@ -46,7 +47,9 @@ IndexNode::IndexNode(ExecutionPlan* plan, size_t id, TRI_vocbase_t* vocbase,
         _collection(collection),
         _indexes(indexes),
         _condition(condition),
-        _reverse(reverse) {
+        _reverse(reverse),
+        _covering(false),
+        _coveringAttribute(0) {
   TRI_ASSERT(_vocbase != nullptr);
   TRI_ASSERT(_collection != nullptr);
   TRI_ASSERT(_condition != nullptr);
@@ -61,7 +64,9 @@ IndexNode::IndexNode(ExecutionPlan* plan, arangodb::velocypack::Slice const& bas
           base.get("collection").copyString())),
       _indexes(),
       _condition(nullptr),
-      _reverse(base.get("reverse").getBoolean()) {
+      _reverse(base.get("reverse").getBoolean()),
+      _covering(false),
+      _coveringAttribute(0) {
   VPackSlice indexes = base.get("indexes");
 
   if (!indexes.isArray()) {
@@ -84,6 +89,11 @@ IndexNode::IndexNode(ExecutionPlan* plan, arangodb::velocypack::Slice const& bas
   _condition = Condition::fromVPack(plan, condition);
 
   TRI_ASSERT(_condition != nullptr);
+
+  VPackSlice covering = base.get("coveringIndexAttribute");
+  if (covering.isNumber()) {
+    setCovering(covering.getNumber<size_t>());
+  }
 }
 
 /// @brief toVelocyPack, for IndexNode
@@ -109,6 +119,9 @@ void IndexNode::toVelocyPackHelper(VPackBuilder& nodes, bool verbose) const {
   nodes.add(VPackValue("condition"));
   _condition->toVelocyPack(nodes, verbose);
   nodes.add("reverse", VPackValue(_reverse));
+  if (_covering) {
+    nodes.add("coveringIndexAttribute", VPackValue(_coveringAttribute));
+  }
 
   // And close it:
   nodes.close();
@@ -124,6 +137,11 @@ ExecutionNode* IndexNode::clone(ExecutionPlan* plan, bool withDependencies,
 
   auto c = new IndexNode(plan, _id, _vocbase, _collection, outVariable,
                          _indexes, _condition->clone(), _reverse);
+  c->setProjection(_projection);
+  c->setProjections(_projections);
+  if (_covering) {
+    c->setCovering(_coveringAttribute);
+  }
 
   cloneHelper(c, plan, withDependencies, withProperties);
 
@@ -144,6 +162,7 @@ double IndexNode::estimateCost(size_t& nrItems) const {
   double totalCost = 0.0;
 
   auto root = _condition->root();
+  SelectivityEstimator estimator(_plan);
 
   for (size_t i = 0; i < _indexes.size(); ++i) {
     double estimatedCost = 0.0;
@@ -160,6 +179,15 @@ double IndexNode::estimateCost(size_t& nrItems) const {
         trx->supportsFilterCondition(_indexes[i], condition,
                                      _outVariable, itemsInCollection,
                                      estimatedItems, estimatedCost)) {
+      // the index estimates assume uniformly distributed values. prefer the
+      // attribute statistics, which know about the most common values
+      double selectivity;
+      bool complete;
+      if (estimator.selectivity(condition, selectivity, complete) &&
+          complete) {
+        estimatedItems = static_cast<size_t>(
+            std::ceil(itemsInCollection * selectivity));
+      }
       totalItems += estimatedItems;
       totalCost += estimatedCost;
     } else {
@@ -104,6 +104,20 @@ class IndexNode : public ExecutionNode, public DocumentProducingNode {
   /// @brief getIndexes, hand out the indexes used
   std::vector<transaction::Methods::IndexHandle> const& getIndexes() const { return _indexes; }
 
+  /// @brief whether or not the projection can be produced from the index
+  /// values alone, without looking up the documents
+  bool isCovering() const { return _covering; }
+
+  /// @brief position of the index attribute that covers the projection
+  size_t coveringAttribute() const { return _coveringAttribute; }
+
+  /// @brief mark the node as covering, using the index attribute at the
+  /// specified position for the projection
+  void setCovering(size_t attribute) {
+    _covering = true;
+    _coveringAttribute = attribute;
+  }
+
  private:
   /// @brief the database
   TRI_vocbase_t* _vocbase;
@@ -119,6 +133,12 @@ class IndexNode : public ExecutionNode, public DocumentProducingNode {
 
   /// @brief the index sort order - this is the same order for all indexes
   bool _reverse;
+
+  /// @brief whether or not the projection is covered by the index
+  bool _covering;
+
+  /// @brief position of the index attribute that covers the projection
+  size_t _coveringAttribute;
 };
 
 }  // namespace arangodb::aql
@@ -75,13 +75,18 @@ ModificationBlock::~ModificationBlock() {}
 
 /// @brief get some - this accumulates all input and calls the work() method
 AqlItemBlock* ModificationBlock::getSome(size_t atLeast, size_t atMost) {
-  // for UPSERT operations, we read and write data in the same collection
-  // we cannot use any batching here because if the search document is not
-  // found, the UPSERTs INSERT operation may create it. after that, the
-  // search document is present and we cannot use an already queried result
-  // from the initial search batch
+  // for UPSERT operations, we read and write data in the same collection.
+  // when reading and writing in lockstep, we cannot use any batching here
+  // because if the search document is not found, the UPSERTs INSERT
+  // operation may create it. after that, the search document is present and
+  // we cannot use an already queried result from the initial search batch.
+  // when the complete input is read first, all searches happen before any
+  // write anyway, so the input can be fetched and written in batches, which
+  // turns the per-row inserts and updates into one array operation each
   traceGetSomeBegin();
-  if (getPlanNode()->getType() == ExecutionNode::NodeType::UPSERT) {
+  if (getPlanNode()->getType() == ExecutionNode::NodeType::UPSERT &&
+      !static_cast<ModificationNode const*>(_exeNode)
+           ->_options.readCompleteInput) {
     atLeast = 1;
     atMost = 1;
   }
@@ -60,6 +60,9 @@ struct OptimizerRule {
 
     inlineSubqueriesRule_pass1,
 
+    // reduce subqueries that are only counted or whose first result is used
+    optimizeSubqueriesRule_pass1,
+
     // split and-combined filters into multiple smaller filters
     splitFiltersRule_pass1,
 
@@ -163,7 +166,11 @@ struct OptimizerRule {
     removeTraversalPathVariable_pass6,
     prepareTraversalsRule_pass6,
 
-    // simplify an EnumerationCollectionNode that fetches an
+    // replace full collection scans in inner loops that are joined via
+    // an equality FILTER by hash joins
+    hashJoinRule_pass6,
+
+    // simplify an EnumerationCollectionNode or IndexNode that fetches an
     // entire document to a projection of this document
     reduceExtractionToProjectionRule_pass6,
 
@@ -173,6 +180,9 @@ struct OptimizerRule {
     /// Pass 9: patch update statements
     patchUpdateStatementsRule_pass9,
 
+    /// Pass 9: let SORT nodes followed by a LIMIT only keep the top rows
+    sortLimitRule_pass9,
+
     /// "Pass 10": final transformations for the cluster
     // make operations on sharded collections use distribute
     distributeInClusterRule_pass10,
@@ -201,7 +211,20 @@ struct OptimizerRule {
 #endif
 
     // recognize that a RemoveNode can be moved to the shards
-    undistributeRemoveAfterEnumCollRule_pass10
+    undistributeRemoveAfterEnumCollRule_pass10,
+
+    // run joins of co-sharded collections on the DB servers
+    removeCoShardedJoinsRule_pass10,
+
+    // split COLLECT into a partial COLLECT on the DB servers and a
+    // merging COLLECT on the coordinator
+    collectInClusterRule_pass10,
+
+    // push LIMIT on top of a GatherNode to the DB servers
+    distributeLimitToClusterRule_pass10,
+
+    // only use the shard that the shard key conditions point to
+    restrictToSingleShardRule_pass10
   };
 
 
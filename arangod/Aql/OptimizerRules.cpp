@@ -23,6 +23,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "OptimizerRules.h"
+#include "Aql/Aggregator.h"
 #include "Aql/ClusterNodes.h"
 #include "Aql/CollectNode.h"
 #include "Aql/CollectOptions.h"
@@ -33,6 +34,7 @@
 #include "Aql/ExecutionNode.h"
 #include "Aql/ExecutionPlan.h"
 #include "Aql/Function.h"
+#include "Aql/HashJoinNode.h"
 #include "Aql/IndexNode.h"
 #include "Aql/ModificationNodes.h"
 #include "Aql/Optimizer.h"
@@ -48,9 +50,12 @@
 #include "Basics/SmallVector.h"
 #include "Basics/StaticStrings.h"
 #include "Basics/StringBuffer.h"
+#include "Basics/StringUtils.h"
+#include "Basics/VelocyPackHelper.h"
 #include "Cluster/ClusterInfo.h"
 #include "Indexes/Index.h"
 #include "Transaction/Methods.h"
+#include "VocBase/LogicalCollection.h"
 #include "VocBase/TraverserOptions.h"
 
 #include <boost/optional.hpp>
@@ -890,6 +895,17 @@ void arangodb::aql::specializeCollectRule(Optimizer* opt,
 
     auto const& groupVariables = collectNode->groupVariables();
 
+    if (groupVariables.empty() && collectNode->count() &&
+        collectNode->aggregateVariables().empty()) {
+      // a total count of the input rows. the rows only need to be skipped
+      // but never fetched, so no SORT or hash table is required
+      collectNode->aggregationMethod(
+          CollectOptions::CollectMethod::COLLECT_METHOD_COUNT);
+      collectNode->specialized();
+      modified = true;
+      continue;
+    }
+
     // test if we can use an alternative version of COLLECT with a hash table
     bool const canUseHashAggregation =
         (!groupVariables.empty() &&
@@ -2067,7 +2083,269 @@ static bool NextPermutationTuple(std::vector<size_t>& data,
   return false;
 }
 
-/// @brief interchange adjacent EnumerateCollectionNodes in all possible ways
+/// @brief maximum length of a run of adjacent enumerations that is still
+/// permuted exhaustively. longer runs would produce too many plans, so a
+/// single order is determined greedily for them instead
+static size_t const MaxPermutedEnumerations = 4;
+
+/// @brief estimated fraction of rows that pass an equality filter that
+/// cannot be answered by an index
+static double const UnindexedEqualitySelectivity = 0.1;
+
+/// @brief an equality condition on an attribute of a loop variable, either
+/// against another loop variable of the same run or against a value that is
+/// known before the run (other == nullptr)
+struct EnumerationCondition {
+  Variable const* variable;
+  std::vector<arangodb::basics::AttributeName> attribute;
+  Variable const* other;
+};
+
+/// @brief collects all equality conditions on the loop variables <vars> from
+/// the and-combined condition <node>
+static void CollectEnumerationConditions(
+    AstNode const* node, std::unordered_set<Variable const*> const& vars,
+    std::vector<EnumerationCondition>& conditions) {
+  if (node->type == NODE_TYPE_OPERATOR_BINARY_AND ||
+      node->type == NODE_TYPE_OPERATOR_NARY_AND) {
+    for (size_t i = 0; i < node->numMembers(); ++i) {
+      CollectEnumerationConditions(node->getMemberUnchecked(i), vars,
+                                   conditions);
+    }
+    return;
+  }
+
+  if (node->type != NODE_TYPE_OPERATOR_BINARY_EQ) {
+    return;
+  }
+
+  for (size_t i = 0; i < 2; ++i) {
+    auto lhs = node->getMember(i);
+    auto rhs = node->getMember(1 - i);
+
+    std::pair<Variable const*, std::vector<arangodb::basics::AttributeName>>
+        access;
+    if (!lhs->isAttributeAccessForVariable(access) ||
+        vars.find(access.first) == vars.end()) {
+      continue;
+    }
+
+    std::unordered_set<Variable const*> used;
+    Ast::getReferencedVariables(rhs, used);
+
+    Variable const* other = nullptr;
+    bool eligible = true;
+    for (auto const& v : used) {
+      if (vars.find(v) != vars.end()) {
+        if (other != nullptr || v == access.first) {
+          // depends on more than one other loop variable, or on itself
+          eligible = false;
+          break;
+        }
+        other = v;
+      }
+    }
+
+    if (eligible) {
+      conditions.emplace_back(
+          EnumerationCondition{access.first, access.second, other});
+    }
+  }
+}
+
+/// @brief returns the best selectivity estimate of an index of <collection>
+/// whose first field is <attribute>, or 0 if there is no such index
+static double BestIndexSelectivity(
+    transaction::Methods* trx, Collection const* collection,
+    std::vector<arangodb::basics::AttributeName> const& attribute) {
+  double best = 0.0;
+  for (auto const& index : trx->indexesForCollection(collection->getName())) {
+    auto const& fields = index->fields();
+    if (fields.empty() || fields[0] != attribute || index->sparse() ||
+        !index->hasSelectivityEstimate()) {
+      continue;
+    }
+    best = (std::max)(best, index->selectivityEstimate());
+  }
+  return best;
+}
+
+/// @brief determines an order for the run of adjacent enumeration nodes
+/// <nodes> (ordered from the innermost to the outermost loop), using the
+/// collection sizes and the selectivity estimates of the indexes that can
+/// serve the equality conditions following the run. the outermost loop is
+/// picked first, and then repeatedly the loop that adds the least estimated
+/// cost given the loops already placed. the result is in the same format as
+/// <nodes>, and empty if the original order is kept
+static std::vector<size_t> GreedyEnumerationOrder(
+    ExecutionPlan* plan, std::vector<ExecutionNode*> const& nodes) {
+  transaction::Methods* trx = plan->getAst()->query()->trx();
+
+  std::unordered_set<Variable const*> vars;
+  for (auto const& n : nodes) {
+    for (auto const& v : n->getVariablesSetHere()) {
+      vars.emplace(v);
+    }
+  }
+
+  // gather the equality conditions of the filters following the run
+  std::vector<EnumerationCondition> conditions;
+  auto current = nodes[0]->getFirstParent();
+  while (current != nullptr && (current->getType() == EN::CALCULATION ||
+                                current->getType() == EN::FILTER)) {
+    if (current->getType() == EN::FILTER) {
+      auto setter = plan->getVarSetBy(
+          current->getVariablesUsedHere()[0]->id);
+      if (setter != nullptr && setter->getType() == EN::CALCULATION) {
+        CollectEnumerationConditions(
+            static_cast<CalculationNode*>(setter)->expression()->node(), vars,
+            conditions);
+      }
+    }
+    current = current->getFirstParent();
+  }
+
+  std::vector<double> baseRows;
+  std::vector<std::unordered_set<Variable const*>> required;
+  for (auto const& n : nodes) {
+    if (n->getType() == EN::ENUMERATE_COLLECTION) {
+      auto collection = static_cast<EnumerateCollectionNode const*>(n)->collection();
+      baseRows.emplace_back(
+          (std::max)(1.0, static_cast<double>(collection->count(trx))));
+    } else {
+      // same assumption as in EnumerateListNode::estimateCost
+      baseRows.emplace_back(100.0);
+    }
+
+    std::unordered_set<Variable const*> used;
+    for (auto const& v : n->getVariablesUsedHere()) {
+      if (vars.find(v) != vars.end()) {
+        used.emplace(v);
+      }
+    }
+    required.emplace_back(std::move(used));
+  }
+
+  std::unordered_map<std::string, double> selectivities;
+  std::unordered_set<Variable const*> placed;
+  std::vector<bool> done(nodes.size(), false);
+  // picked from the outermost to the innermost loop
+  std::vector<size_t> picked;
+  double outerRows = 1.0;
+
+  while (picked.size() < nodes.size()) {
+    size_t best = nodes.size();
+    double bestCost = 0.0;
+    double bestRows = 0.0;
+
+    // iterate from the original outermost loop, so ties keep the original
+    // order
+    for (size_t i = nodes.size(); i-- > 0;) {
+      if (done[i]) {
+        continue;
+      }
+
+      bool available = true;
+      for (auto const& v : required[i]) {
+        if (placed.find(v) == placed.end()) {
+          available = false;
+          break;
+        }
+      }
+      if (!available) {
+        continue;
+      }
+
+      auto variable = nodes[i]->getVariablesSetHere()[0];
+      double scanned = baseRows[i];
+      double rows = baseRows[i];
+
+      for (auto const& c : conditions) {
+        if (c.variable != variable ||
+            (c.other != nullptr && placed.find(c.other) == placed.end())) {
+          continue;
+        }
+
+        double selectivity = 0.0;
+        if (nodes[i]->getType() == EN::ENUMERATE_COLLECTION) {
+          auto collection =
+              static_cast<EnumerateCollectionNode const*>(nodes[i])->collection();
+          std::string key;
+          arangodb::basics::TRI_AttributeNamesToString(c.attribute, key, true);
+          key = collection->getName() + "/" + key;
+
+          auto it = selectivities.find(key);
+          if (it == selectivities.end()) {
+            it = selectivities.emplace(
+                key, BestIndexSelectivity(trx, collection, c.attribute)).first;
+          }
+          selectivity = (*it).second;
+        }
+
+        if (selectivity > 0.0) {
+          // an index lookup only produces the matching documents
+          scanned = (std::min)(scanned, 1.0 / selectivity);
+          rows = (std::min)(rows, 1.0 / selectivity);
+        } else {
+          rows = (std::max)(1.0, rows * UnindexedEqualitySelectivity);
+        }
+      }
+
+      double cost = outerRows * scanned;
+      if (best == nodes.size() || cost < bestCost ||
+          (cost == bestCost && rows < bestRows)) {
+        best = i;
+        bestCost = cost;
+        bestRows = rows;
+      }
+    }
+
+    if (best == nodes.size()) {
+      // dependencies cannot be satisfied. should not happen
+      return std::vector<size_t>();
+    }
+
+    done[best] = true;
+    placed.emplace(nodes[best]->getVariablesSetHere()[0]);
+    picked.emplace_back(best);
+    outerRows = (std::max)(1.0, outerRows * bestRows);
+  }
+
+  // convert to the innermost-first format of <nodes>
+  std::vector<size_t> order(picked.rbegin(), picked.rend());
+  for (size_t i = 0; i < order.size(); ++i) {
+    if (order[i] != i) {
+      return order;
+    }
+  }
+  return std::vector<size_t>();
+}
+
+/// @brief reorders the run of adjacent enumeration nodes <nodes> of another
+/// plan (ordered from the innermost to the outermost loop) in <plan> as given
+/// by <order>
+static void ReorderEnumerations(ExecutionPlan* plan,
+                                std::vector<ExecutionNode*> const& nodes,
+                                std::vector<size_t> const& order) {
+  std::vector<ExecutionNode*> newNodes;
+  for (auto const& n : nodes) {
+    newNodes.emplace_back(plan->getNodeById(n->id()));
+  }
+
+  auto parent = newNodes[0]->getFirstParent();
+  TRI_ASSERT(parent != nullptr);
+
+  for (auto const& n : newNodes) {
+    plan->unlinkNode(n);
+  }
+
+  for (size_t j = order.size(); j-- != 0;) {
+    plan->insertDependency(parent, newNodes[order[j]]);
+  }
+}
+
+/// @brief interchange adjacent EnumerateCollectionNodes in all possible ways,
+/// or in a greedily determined order for long runs of them
 void arangodb::aql::interchangeAdjacentEnumerationsRule(
     Optimizer* opt, std::unique_ptr<ExecutionPlan> plan,
     OptimizerRule const* rule) {
@@ -2087,6 +2365,9 @@ void arangodb::aql::interchangeAdjacentEnumerationsRule(
   std::vector<ExecutionNode*> nodesToPermute;
   std::vector<size_t> permTuple;
   std::vector<size_t> starts;
+  // runs too long for permutation, together with their greedy orders
+  std::vector<std::pair<std::vector<ExecutionNode*>, std::vector<size_t>>>
+      greedyRuns;
 
   // We use that the order of the nodes is such that a node B that is among the
   // recursive dependencies of a node A is later in the vector.
@@ -2120,7 +2401,13 @@ void arangodb::aql::interchangeAdjacentEnumerationsRule(
         nodesSet.erase(nwalker);
       }
 
-      if (nn.size() > 1) {
+      if (nn.size() > MaxPermutedEnumerations) {
+        // trying all orders would create too many plans
+        std::vector<size_t> order = GreedyEnumerationOrder(plan.get(), nn);
+        if (!order.empty()) {
+          greedyRuns.emplace_back(std::move(nn), std::move(order));
+        }
+      } else if (nn.size() > 1) {
         // Move it into the permutation tuple:
         starts.emplace_back(permTuple.size());
 
@@ -2137,7 +2424,10 @@ void arangodb::aql::interchangeAdjacentEnumerationsRule(
   // independently. This is why we need to compute all permutation tuples.
 
   if (!starts.empty()) {
-    NextPermutationTuple(permTuple, starts);  // will never return false
+    if (greedyRuns.empty()) {
+      // skip the identity, which is the original plan
+      NextPermutationTuple(permTuple, starts);  // will never return false
+    }
 
     do {
       // check if we already have enough plans (plus the one plan that we will
@@ -2181,9 +2471,19 @@ void arangodb::aql::interchangeAdjacentEnumerationsRule(
         }
       }
 
+      for (auto const& it : greedyRuns) {
+        ReorderEnumerations(newPlan.get(), it.first, it.second);
+      }
+
       // OK, the new plan is ready, let's report it:
       opt->addPlan(std::move(newPlan), rule, true);
     } while (NextPermutationTuple(permTuple, starts));
+  } else if (!greedyRuns.empty()) {
+    std::unique_ptr<ExecutionPlan> newPlan(plan->clone());
+    for (auto const& it : greedyRuns) {
+      ReorderEnumerations(newPlan.get(), it.first, it.second);
+    }
+    opt->addPlan(std::move(newPlan), rule, true);
   }
 
   opt->addPlan(std::move(plan), rule, false);
@@ -2789,144 +3089,924 @@ void arangodb::aql::distributeSortToClusterRule(
   opt->addPlan(std::move(plan), rule, modified);
 }
 
-/// @brief try to get rid of a RemoteNode->ScatterNode combination which has
-/// only a SingletonNode and possibly some CalculationNodes as dependencies
-void arangodb::aql::removeUnnecessaryRemoteScatterRule(
-    Optimizer* opt, std::unique_ptr<ExecutionPlan> plan,
-    OptimizerRule const* rule) {
+/// @brief whether or not the part of the plan that is executed on the DB
+/// servers below the given RemoteNode only consists of nodes which allow
+/// adding a COLLECT or LIMIT on top of them. data-modification nodes must
+/// see all of their input, so they rule this out
+static bool CanExtendDBServerPart(ExecutionNode const* remoteNode) {
+  TRI_ASSERT(remoteNode->getType() == EN::REMOTE);
+  ExecutionNode const* current = remoteNode->getFirstDependency();
+
+  if (current == nullptr || current->getType() == EN::SCATTER ||
+      current->getType() == EN::DISTRIBUTE) {
+    // this is not the DB server part of the plan
+    return false;
+  }
+
+  while (current != nullptr && current->getType() != EN::REMOTE) {
+    switch (current->getType()) {
+      case EN::SINGLETON:
+      case EN::ENUMERATE_COLLECTION:
+      case EN::INDEX:
+      case EN::ENUMERATE_LIST:
+      case EN::FILTER:
+      case EN::CALCULATION:
+      case EN::SORT:
+      case EN::LIMIT:
+      case EN::COLLECT:
+        break;
+      default:
+        return false;
+    }
+    current = current->getFirstDependency();
+  }
+
+  return true;
+}
+
+/// @brief split COLLECT operations on top of a GatherNode into a partial
+/// COLLECT that runs on each DB server and a COLLECT on the coordinator that
+/// merges the partial results. this rule modifies the plan in place
+void arangodb::aql::collectInClusterRule(Optimizer* opt,
+                                         std::unique_ptr<ExecutionPlan> plan,
+                                         OptimizerRule const* rule) {
   SmallVector<ExecutionNode*>::allocator_type::arena_type a;
   SmallVector<ExecutionNode*> nodes{a};
-  plan->findNodesOfType(nodes, EN::REMOTE, true);
+  plan->findNodesOfType(nodes, EN::COLLECT, true);
 
-  std::unordered_set<ExecutionNode*> toUnlink;
+  bool modified = false;
 
-  for (auto& n : nodes) {
-    // check if the remote node is preceeded by a scatter node and any number of
-    // calculation and singleton nodes. if yes, remove remote and scatter
-    if (!n->hasDependency()) {
+  for (auto const& n : nodes) {
+    auto collectNode = static_cast<CollectNode*>(n);
+
+    auto gather = n->getFirstDependency();
+    if (gather == nullptr || gather->getType() != EN::GATHER) {
       continue;
     }
-
-    auto const dep = n->getFirstDependency();
-    if (dep->getType() != EN::SCATTER) {
+    auto gatherNode = static_cast<GatherNode*>(gather);
+    auto remote = gather->getFirstDependency();
+    if (remote == nullptr || remote->getType() != EN::REMOTE ||
+        !CanExtendDBServerPart(remote)) {
       continue;
     }
 
-    bool canOptimize = true;
-    auto node = dep;
-    while (node != nullptr) {
-      auto const& d = node->getDependencies();
+    if (collectNode->hasOutVariableButNoCount() ||
+        collectNode->hasExpressionVariable()) {
+      // INTO needs to see all documents of a group
+      continue;
+    }
 
-      if (d.size() != 1) {
+    bool eligible = true;
+    for (auto const& it : collectNode->aggregateVariables()) {
+      if (Aggregator::pushToDBServerAs(it.second.second).empty()) {
+        eligible = false;
         break;
       }
+    }
 
-      node = d[0];
-      if (node->getType() != EN::SINGLETON &&
-          node->getType() != EN::CALCULATION) {
-        // found some other node type...
-        // this disqualifies the optimization
-        canOptimize = false;
-        break;
-      }
+    if (!eligible) {
+      continue;
+    }
 
-      if (node->getType() == EN::CALCULATION) {
-        auto calc = static_cast<CalculationNode const*>(node);
-        // check if the expression can be executed on a DB server safely
-        if (!calc->expression()->canRunOnDBServer()) {
-          canOptimize = false;
+    auto variables = plan->getAst()->variables();
+
+    // the DB servers group by the original input variables and produce
+    // temporary variables, which are the input of the coordinator COLLECT
+    std::vector<std::pair<Variable const*, Variable const*>> dbServerGroups;
+    std::vector<std::pair<Variable const*, Variable const*>> coordinatorGroups;
+    for (auto const& it : collectNode->groupVariables()) {
+      Variable const* partial = variables->createTemporaryVariable();
+      dbServerGroups.emplace_back(partial, it.second);
+      coordinatorGroups.emplace_back(it.first, partial);
+    }
+
+    std::vector<std::pair<Variable const*,
+                          std::pair<Variable const*, std::string>>>
+        dbServerAggregates;
+    std::vector<std::pair<Variable const*,
+                          std::pair<Variable const*, std::string>>>
+        coordinatorAggregates;
+    for (auto const& it : collectNode->aggregateVariables()) {
+      Variable const* partial = variables->createTemporaryVariable();
+      dbServerAggregates.emplace_back(
+          partial, std::make_pair(it.second.first,
+                                  Aggregator::pushToDBServerAs(it.second.second)));
+      coordinatorAggregates.emplace_back(
+          it.first, std::make_pair(partial, Aggregator::runOnCoordinatorAs(
+                                                it.second.second)));
+    }
+
+    Variable const* partialCount = nullptr;
+    if (collectNode->count()) {
+      // WITH COUNT INTO: count on the DB servers, sum up on the coordinator
+      partialCount = variables->createTemporaryVariable();
+      coordinatorAggregates.emplace_back(
+          collectNode->outVariable(), std::make_pair(partialCount, "SUM"));
+    }
+
+    // the GatherNode merges by the group values when the partial results
+    // are sorted, but the original variables are gone after the COLLECT
+    SortElementVector elements;
+    if (collectNode->aggregationMethod() ==
+        CollectOptions::CollectMethod::COLLECT_METHOD_SORTED) {
+      for (auto const& element : gatherNode->getElements()) {
+        auto it = std::find_if(dbServerGroups.begin(), dbServerGroups.end(),
+                               [&element](std::pair<Variable const*,
+                                                    Variable const*> const& p) {
+                                 return p.second == element.var;
+                               });
+        if (it == dbServerGroups.end()) {
+          eligible = false;
           break;
         }
+        elements.emplace_back(element);
+        elements.back().var = it->first;
       }
     }
 
-    if (canOptimize) {
-      toUnlink.emplace(n);
-      toUnlink.emplace(dep);
+    if (!eligible) {
+      continue;
     }
-  }
 
-  if (!toUnlink.empty()) {
-    plan->unlinkNodes(toUnlink);
+    auto dbServerCollect = new CollectNode(
+        plan.get(), plan->nextId(), collectNode->getOptions(), dbServerGroups,
+        dbServerAggregates, nullptr, partialCount,
+        std::vector<Variable const*>(), collectNode->variableMap(),
+        partialCount != nullptr, collectNode->isDistinctCommand());
+    dbServerCollect->specialized();
+    plan->registerNode(dbServerCollect);
+    plan->insertDependency(remote, dbServerCollect);
+
+    CollectOptions options = collectNode->getOptions();
+    if (options.method ==
+        CollectOptions::CollectMethod::COLLECT_METHOD_COUNT) {
+      // the partial counts are summed up by a regular aggregate
+      options.method = CollectOptions::CollectMethod::COLLECT_METHOD_SORTED;
+    }
+    auto coordinatorCollect = new CollectNode(
+        plan.get(), plan->nextId(), options, coordinatorGroups,
+        coordinatorAggregates, nullptr, nullptr,
+        std::vector<Variable const*>(), collectNode->variableMap(), false,
+        collectNode->isDistinctCommand());
+    coordinatorCollect->specialized();
+    plan->registerNode(coordinatorCollect);
+    plan->replaceNode(collectNode, coordinatorCollect);
+
+    gatherNode->setElements(elements);
+    modified = true;
   }
 
-  opt->addPlan(std::move(plan), rule, !toUnlink.empty());
+  opt->addPlan(std::move(plan), rule, modified);
 }
 
-/// WalkerWorker for undistributeRemoveAfterEnumColl
-class RemoveToEnumCollFinder final : public WalkerWorker<ExecutionNode> {
-  ExecutionPlan* _plan;
-  std::unordered_set<ExecutionNode*>& _toUnlink;
-  bool _remove;
-  bool _scatter;
-  bool _gather;
-  EnumerateCollectionNode* _enumColl;
-  ExecutionNode* _setter;
-  const Variable* _variable;
-  ExecutionNode* _lastNode;
+/// @brief push a LIMIT on top of a GatherNode to the DB servers, so that each
+/// shard only produces offset + limit rows. the original LIMIT is kept on the
+/// coordinator. this rule modifies the plan in place
+void arangodb::aql::distributeLimitToClusterRule(
+    Optimizer* opt, std::unique_ptr<ExecutionPlan> plan,
+    OptimizerRule const* rule) {
+  SmallVector<ExecutionNode*>::allocator_type::arena_type a;
+  SmallVector<ExecutionNode*> nodes{a};
+  plan->findNodesOfType(nodes, EN::LIMIT, true);
 
- public:
-  RemoveToEnumCollFinder(ExecutionPlan* plan,
-                         std::unordered_set<ExecutionNode*>& toUnlink)
-      : _plan(plan),
-        _toUnlink(toUnlink),
-        _remove(false),
-        _scatter(false),
-        _gather(false),
-        _enumColl(nullptr),
-        _setter(nullptr),
-        _variable(nullptr),
-        _lastNode(nullptr){};
+  bool modified = false;
 
-  ~RemoveToEnumCollFinder() {}
+  for (auto const& n : nodes) {
+    auto limitNode = static_cast<LimitNode const*>(n);
 
-  bool before(ExecutionNode* en) override final {
-    switch (en->getType()) {
-      case EN::REMOVE: {
-        if (_remove) {
-          break;
-        }
+    if (limitNode->fullCount() || limitNode->limit() == 0) {
+      // fullCount needs to see all rows
+      continue;
+    }
 
-        // find the variable we are removing . . .
-        auto rn = static_cast<RemoveNode*>(en);
-        auto varsToRemove = rn->getVariablesUsedHere();
+    size_t total = limitNode->offset() + limitNode->limit();
+    if (total < limitNode->limit()) {
+      // overflow
+      continue;
+    }
 
-        // remove nodes always have one input variable
-        TRI_ASSERT(varsToRemove.size() == 1);
+    // calculations do not change the number of rows, so we can look
+    // beyond them
+    ExecutionNode* current = n->getFirstDependency();
+    while (current != nullptr && current->getType() == EN::CALCULATION) {
+      current = current->getFirstDependency();
+    }
 
-        _setter = _plan->getVarSetBy(varsToRemove[0]->id);
-        TRI_ASSERT(_setter != nullptr);
-        auto enumColl = _setter;
+    if (current == nullptr || current->getType() != EN::GATHER) {
+      continue;
+    }
 
-        if (_setter->getType() == EN::CALCULATION) {
-          // this should be an attribute access for _key
-          auto cn = static_cast<CalculationNode*>(_setter);
-          if (!cn->expression()->isAttributeAccess()) {
-            break;  // abort . . .
-          }
-          // check the variable is the same as the remove variable
-          auto vars = cn->getVariablesSetHere();
-          if (vars.size() != 1 || vars[0]->id != varsToRemove[0]->id) {
-            break;  // abort . . .
-          }
-          // check the remove node's collection is sharded over _key
-          std::vector<std::string> shardKeys = rn->collection()->shardKeys();
-          if (shardKeys.size() != 1 ||
-              shardKeys[0] != StaticStrings::KeyString) {
-            break;  // abort . . .
-          }
+    auto remote = current->getFirstDependency();
+    if (remote == nullptr || remote->getType() != EN::REMOTE ||
+        !CanExtendDBServerPart(remote)) {
+      continue;
+    }
 
-          // set the varsToRemove to the variable in the expression of this
-          // node and also define enumColl
-          varsToRemove = cn->getVariablesUsedHere();
-          TRI_ASSERT(varsToRemove.size() == 1);
-          enumColl = _plan->getVarSetBy(varsToRemove[0]->id);
-          TRI_ASSERT(_setter != nullptr);
-        }
+    auto previous = remote->getFirstDependency();
+    if (previous->getType() == EN::LIMIT &&
+        static_cast<LimitNode const*>(previous)->offset() == 0 &&
+        static_cast<LimitNode const*>(previous)->limit() <= total) {
+      // already limited on the DB servers
+      continue;
+    }
 
-        if (enumColl->getType() != EN::ENUMERATE_COLLECTION) {
-          break;  // abort . . .
-        }
+    auto dbServerLimit = new LimitNode(plan.get(), plan->nextId(), 0, total);
+    plan->registerNode(dbServerLimit);
+    plan->insertDependency(remote, dbServerLimit);
+    modified = true;
+  }
+
+  opt->addPlan(std::move(plan), rule, modified);
+}
+
+static Variable const* GetAttributePath(AstNode const* node,
+                                        std::vector<std::string>& path);
+
+/// @brief whether or not the two collections place documents with equal
+/// shard key values into shards at the same position of their shard lists,
+/// and the leaders of these shards are the same servers
+static bool AreCoSharded(Collection const* outer, Collection const* inner) {
+  if (outer->isSatellite() || inner->isSatellite() || outer->isSmart() ||
+      inner->isSmart()) {
+    return false;
+  }
+
+  if (outer != inner) {
+    auto outerCollection = outer->getCollection();
+    auto innerCollection = inner->getCollection();
+    std::string const outerId =
+        arangodb::basics::StringUtils::itoa(outer->getPlanId());
+    std::string const innerId =
+        arangodb::basics::StringUtils::itoa(inner->getPlanId());
+    std::string const outerLike = outerCollection->distributeShardsLike();
+    std::string const innerLike = innerCollection->distributeShardsLike();
+
+    if (innerLike != outerId && outerLike != innerId &&
+        (innerLike.empty() || innerLike != outerLike)) {
+      return false;
+    }
+  }
+
+  auto outerShards = outer->shardIds();
+  auto innerShards = inner->shardIds();
+  if (outerShards->size() != innerShards->size() ||
+      outer->shardKeys().size() != inner->shardKeys().size()) {
+    return false;
+  }
+
+  auto ci = ClusterInfo::instance();
+  for (size_t i = 0; i < outerShards->size(); ++i) {
+    auto outerServers = ci->getResponsibleServer((*outerShards)[i]);
+    auto innerServers = ci->getResponsibleServer((*innerShards)[i]);
+    if (outerServers->empty() || innerServers->empty() ||
+        outerServers->front() != innerServers->front()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// @brief whether or not the condition (or one of its conjuncts) is an
+/// equality of "outer.outerKey" and "inner.innerKey"
+static bool FindShardKeyEquality(AstNode const* node, Variable const* outer,
+                                 std::string const& outerKey,
+                                 Variable const* inner,
+                                 std::string const& innerKey) {
+  if (node->type == NODE_TYPE_OPERATOR_BINARY_AND ||
+      node->type == NODE_TYPE_OPERATOR_NARY_AND) {
+    for (size_t i = 0; i < node->numMembers(); ++i) {
+      if (FindShardKeyEquality(node->getMemberUnchecked(i), outer, outerKey,
+                               inner, innerKey)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  if (node->type != NODE_TYPE_OPERATOR_BINARY_EQ) {
+    return false;
+  }
+
+  std::vector<std::string> path;
+  for (size_t i = 0; i < 2; ++i) {
+    if (GetAttributePath(node->getMember(i), path) != inner ||
+        arangodb::basics::StringUtils::join(path, ".") != innerKey) {
+      continue;
+    }
+    if (GetAttributePath(node->getMember(1 - i), path) == outer &&
+        arangodb::basics::StringUtils::join(path, ".") == outerKey) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// @brief execute joins of co-sharded collections on the DB servers. this
+/// turns
+///   ... <- Remote <- Gather <- Scatter <- Remote <- (inner part) <- Remote <- Gather
+/// into
+///   ... <- (inner part) <- Remote <- Gather
+/// if the inner part is joined to the outer part on all shard keys, so that
+/// each shard of the outer collection only has to be joined with the shard
+/// at the same position of the inner collection, which is on the same server.
+/// this rule modifies the plan in place
+void arangodb::aql::removeCoShardedJoinsRule(
+    Optimizer* opt, std::unique_ptr<ExecutionPlan> plan,
+    OptimizerRule const* rule) {
+  SmallVector<ExecutionNode*>::allocator_type::arena_type a;
+  SmallVector<ExecutionNode*> nodes{a};
+  plan->findNodesOfType(nodes, EN::SCATTER, true);
+
+  bool modified = false;
+
+  for (auto const& n : nodes) {
+    // the coordinator part between the two DB server parts must be empty
+    auto outerGather = n->getFirstDependency();
+    if (outerGather == nullptr || outerGather->getType() != EN::GATHER ||
+        outerGather->getParents().size() != 1) {
+      continue;
+    }
+    auto outerRemote = outerGather->getFirstDependency();
+    if (outerRemote == nullptr || outerRemote->getType() != EN::REMOTE) {
+      continue;
+    }
+    auto innerRemote = n->getFirstParent();
+    if (innerRemote == nullptr || innerRemote->getType() != EN::REMOTE ||
+        n->getParents().size() != 1) {
+      continue;
+    }
+
+    // the inner part must only read from the inner collection
+    auto collection = static_cast<ScatterNode const*>(n)->collection();
+    std::vector<ExecutionNode*> innerPart;
+    ExecutionNode* inner = nullptr;
+    ExecutionNode* current = innerRemote->getFirstParent();
+    bool eligible = true;
+    while (current != nullptr && current->getType() != EN::REMOTE) {
+      switch (current->getType()) {
+        case EN::ENUMERATE_COLLECTION:
+        case EN::INDEX: {
+          auto c = (current->getType() == EN::INDEX
+                        ? static_cast<IndexNode const*>(current)->collection()
+                        : static_cast<EnumerateCollectionNode const*>(current)
+                              ->collection());
+          if (inner != nullptr || c != collection) {
+            eligible = false;
+          }
+          inner = current;
+          break;
+        }
+        case EN::FILTER:
+        case EN::CALCULATION:
+        case EN::SORT:
+        case EN::ENUMERATE_LIST:
+          break;
+        default:
+          eligible = false;
+          break;
+      }
+      if (!eligible) {
+        break;
+      }
+      innerPart.emplace_back(current);
+      current = current->getFirstParent();
+    }
+
+    if (!eligible || inner == nullptr || current == nullptr) {
+      continue;
+    }
+    auto lastRemote = current;
+    auto lastGather = lastRemote->getFirstParent();
+    if (lastGather == nullptr || lastGather->getType() != EN::GATHER) {
+      continue;
+    }
+
+    auto outerGatherNode = static_cast<GatherNode*>(outerGather);
+    auto lastGatherNode = static_cast<GatherNode*>(lastGather);
+    if (!outerGatherNode->getElements().empty() &&
+        !lastGatherNode->getElements().empty()) {
+      // cannot keep both sort orders
+      continue;
+    }
+
+    auto outerCollection = outerGatherNode->collection();
+    if (!AreCoSharded(outerCollection, collection)) {
+      continue;
+    }
+
+    // the documents of the outer collection in the outer part
+    std::vector<Variable const*> outerVariables;
+    current = outerRemote->getFirstDependency();
+    while (current != nullptr && current->getType() != EN::REMOTE) {
+      if (current->getType() == EN::ENUMERATE_COLLECTION &&
+          static_cast<EnumerateCollectionNode const*>(current)->collection() ==
+              outerCollection) {
+        outerVariables.emplace_back(
+            static_cast<EnumerateCollectionNode const*>(current)->outVariable());
+      } else if (current->getType() == EN::INDEX &&
+                 static_cast<IndexNode const*>(current)->collection() ==
+                     outerCollection) {
+        outerVariables.emplace_back(
+            static_cast<IndexNode const*>(current)->outVariable());
+      }
+      current = current->getFirstDependency();
+    }
+
+    // all conditions the inner documents have to satisfy
+    std::vector<AstNode const*> conditions;
+    if (inner->getType() == EN::INDEX) {
+      auto condition = static_cast<IndexNode const*>(inner)->condition();
+      if (condition != nullptr && condition->root() != nullptr &&
+          condition->root()->numMembers() == 1) {
+        conditions.emplace_back(condition->root()->getMember(0));
+      }
+    }
+    for (auto const& it : innerPart) {
+      if (it->getType() != EN::FILTER) {
+        continue;
+      }
+      auto setter = plan->getVarSetBy(it->getVariablesUsedHere()[0]->id);
+      if (setter != nullptr && setter->getType() == EN::CALCULATION) {
+        conditions.emplace_back(
+            static_cast<CalculationNode const*>(setter)->expression()->node());
+      }
+    }
+
+    // every shard key of the inner collection must be joined to the
+    // matching shard key of the outer collection
+    Variable const* innerVariable =
+        (inner->getType() == EN::INDEX
+             ? static_cast<IndexNode const*>(inner)->outVariable()
+             : static_cast<EnumerateCollectionNode const*>(inner)->outVariable());
+    std::vector<std::string> const outerKeys = outerCollection->shardKeys();
+    std::vector<std::string> const innerKeys = collection->shardKeys();
+    bool joined = false;
+    for (auto const& outerVariable : outerVariables) {
+      joined = true;
+      for (size_t i = 0; i < innerKeys.size() && joined; ++i) {
+        joined = std::any_of(conditions.begin(), conditions.end(),
+                             [&](AstNode const* condition) {
+                               return FindShardKeyEquality(
+                                   condition, outerVariable, outerKeys[i],
+                                   innerVariable, innerKeys[i]);
+                             });
+      }
+      if (joined) {
+        break;
+      }
+    }
+
+    if (!joined) {
+      continue;
+    }
+
+    // move the inner part into the outer part
+    for (auto const& it : innerPart) {
+      plan->unlinkNode(it);
+      plan->insertDependency(outerRemote, it);
+    }
+
+    // and remove scatter and gather of the inner part, keeping the remote
+    // and gather nodes of the outer collection
+    if (outerGatherNode->getElements().empty()) {
+      outerGatherNode->setElements(lastGatherNode->getElements());
+    }
+    plan->unlinkNode(n);
+    plan->unlinkNode(innerRemote);
+    plan->unlinkNode(lastRemote);
+
+    if (plan->isRoot(lastGather)) {
+      plan->unlinkNode(lastGather, true);
+      plan->root(outerGather);
+    } else {
+      SmallVector<ExecutionNode*>::allocator_type::arena_type sa;
+      SmallVector<ExecutionNode*> subqueries{sa};
+      plan->findNodesOfType(subqueries, EN::SUBQUERY, true);
+      for (auto const& it : subqueries) {
+        auto subquery = static_cast<SubqueryNode*>(it);
+        if (subquery->getSubquery() == lastGather) {
+          subquery->setSubquery(outerGather, true);
+        }
+      }
+      plan->unlinkNode(lastGather);
+    }
+    modified = true;
+  }
+
+  opt->addPlan(std::move(plan), rule, modified);
+}
+
+/// @brief collect the constant values that a condition (or one of its
+/// conjuncts) compares attributes of the variable with
+static void FindConstantEqualities(
+    AstNode const* node, Variable const* variable,
+    std::unordered_map<std::string, AstNode const*>& values) {
+  if (node->type == NODE_TYPE_OPERATOR_BINARY_AND ||
+      node->type == NODE_TYPE_OPERATOR_NARY_AND) {
+    for (size_t i = 0; i < node->numMembers(); ++i) {
+      FindConstantEqualities(node->getMemberUnchecked(i), variable, values);
+    }
+    return;
+  }
+
+  if (node->type != NODE_TYPE_OPERATOR_BINARY_EQ) {
+    return;
+  }
+
+  std::vector<std::string> path;
+  for (size_t i = 0; i < 2; ++i) {
+    if (GetAttributePath(node->getMember(i), path) == variable &&
+        node->getMember(1 - i)->isConstant()) {
+      values.emplace(arangodb::basics::StringUtils::join(path, "."),
+                     node->getMember(1 - i));
+      return;
+    }
+  }
+}
+
+namespace {
+/// @brief the tightest constant bounds that a condition (or its conjuncts)
+/// sets for an attribute of the variable
+struct ConstantBounds {
+  VPackBuilder lower;
+  VPackBuilder upper;
+  bool includeUpper = true;
+
+  void restrictLower(AstNode const* value) {
+    VPackBuilder builder;
+    value->toVelocyPackValue(builder);
+    if (lower.isEmpty() || arangodb::basics::VelocyPackHelper::compare(
+                               builder.slice(), lower.slice(), true) > 0) {
+      lower = std::move(builder);
+    }
+  }
+
+  void restrictUpper(AstNode const* value, bool include) {
+    VPackBuilder builder;
+    value->toVelocyPackValue(builder);
+    int cmp = upper.isEmpty() ? -1
+                              : arangodb::basics::VelocyPackHelper::compare(
+                                    builder.slice(), upper.slice(), true);
+    if (cmp < 0 || (cmp == 0 && !include)) {
+      upper = std::move(builder);
+      includeUpper = include;
+    }
+  }
+};
+}
+
+static void FindConstantBounds(AstNode const* node, Variable const* variable,
+                               std::string const& attribute,
+                               ConstantBounds& bounds) {
+  if (node->type == NODE_TYPE_OPERATOR_BINARY_AND ||
+      node->type == NODE_TYPE_OPERATOR_NARY_AND) {
+    for (size_t i = 0; i < node->numMembers(); ++i) {
+      FindConstantBounds(node->getMemberUnchecked(i), variable, attribute,
+                         bounds);
+    }
+    return;
+  }
+
+  if (node->type != NODE_TYPE_OPERATOR_BINARY_EQ &&
+      node->type != NODE_TYPE_OPERATOR_BINARY_LT &&
+      node->type != NODE_TYPE_OPERATOR_BINARY_LE &&
+      node->type != NODE_TYPE_OPERATOR_BINARY_GT &&
+      node->type != NODE_TYPE_OPERATOR_BINARY_GE) {
+    return;
+  }
+
+  std::vector<std::string> path;
+  for (size_t i = 0; i < 2; ++i) {
+    path.clear();
+    AstNode const* value = node->getMember(1 - i);
+    if (GetAttributePath(node->getMember(i), path) != variable ||
+        !value->isConstant() ||
+        arangodb::basics::StringUtils::join(path, ".") != attribute) {
+      continue;
+    }
+    auto type = node->type;
+    if (i == 1) {
+      // the attribute is on the right side: c < a is a > c
+      type = Ast::ReverseOperator(type);
+    }
+    switch (type) {
+      case NODE_TYPE_OPERATOR_BINARY_EQ:
+        bounds.restrictLower(value);
+        bounds.restrictUpper(value, true);
+        break;
+      case NODE_TYPE_OPERATOR_BINARY_LT:
+        bounds.restrictUpper(value, false);
+        break;
+      case NODE_TYPE_OPERATOR_BINARY_LE:
+        bounds.restrictUpper(value, true);
+        break;
+      default:
+        // the shard holding the lower bound holds the values above it, too
+        bounds.restrictLower(value);
+        break;
+    }
+    return;
+  }
+}
+
+/// @brief the shards of the collection that an EnumerateCollectionNode or
+/// IndexNode on a DB server can find documents in, if the index condition
+/// or the FILTERs of its part pin all shard keys to constant values, or
+/// limit the shard key of a range-sharded collection to a constant range.
+/// returns an empty set otherwise
+static std::unordered_set<std::string> FindRestrictedShards(
+    ExecutionPlan const* plan, ExecutionNode const* node,
+    Collection const* collection) {
+  std::unordered_set<std::string> result;
+  std::vector<AstNode const*> conditions;
+  Variable const* variable;
+  if (node->getType() == EN::INDEX) {
+    auto indexNode = static_cast<IndexNode const*>(node);
+    variable = indexNode->outVariable();
+    auto condition = indexNode->condition();
+    if (condition != nullptr && condition->root() != nullptr &&
+        condition->root()->numMembers() == 1) {
+      conditions.emplace_back(condition->root()->getMember(0));
+    }
+  } else {
+    variable = static_cast<EnumerateCollectionNode const*>(node)->outVariable();
+  }
+
+  // the FILTERs up to the end of the DB server part
+  auto current = node->getFirstParent();
+  while (current != nullptr && current->getType() != EN::REMOTE) {
+    if (current->getType() == EN::FILTER) {
+      auto setter = plan->getVarSetBy(current->getVariablesUsedHere()[0]->id);
+      if (setter != nullptr && setter->getType() == EN::CALCULATION) {
+        conditions.emplace_back(
+            static_cast<CalculationNode const*>(setter)->expression()->node());
+      }
+    }
+    current = current->getFirstParent();
+  }
+  if (current == nullptr) {
+    // not a DB server part
+    return result;
+  }
+
+  LogicalCollection* logical = collection->getCollection().get();
+  if (logical->isRangeSharded()) {
+    ConstantBounds bounds;
+    for (auto const& it : conditions) {
+      FindConstantBounds(it, variable, collection->shardKeys()[0], bounds);
+    }
+    if (bounds.lower.isEmpty() && bounds.upper.isEmpty()) {
+      return result;
+    }
+    std::vector<ShardID> shards;
+    int res = ClusterInfo::instance()->getResponsibleShards(
+        logical,
+        bounds.lower.isEmpty() ? VPackSlice::noneSlice() : bounds.lower.slice(),
+        bounds.upper.isEmpty() ? VPackSlice::noneSlice() : bounds.upper.slice(),
+        bounds.includeUpper, shards);
+    if (res == TRI_ERROR_NO_ERROR) {
+      result.insert(shards.begin(), shards.end());
+    }
+    return result;
+  }
+
+  std::unordered_map<std::string, AstNode const*> values;
+  for (auto const& it : conditions) {
+    FindConstantEqualities(it, variable, values);
+  }
+
+  // build a document from the shard key values
+  VPackBuilder builder;
+  builder.openObject();
+  for (auto const& key : collection->shardKeys()) {
+    auto it = values.find(key);
+    if (it == values.end() || key.find('.') != std::string::npos) {
+      return result;
+    }
+    builder.add(VPackValue(key));
+    (*it).second->toVelocyPackValue(builder);
+  }
+  builder.close();
+
+  std::string shard;
+  bool usesDefaultShardingAttributes;
+  int res = ClusterInfo::instance()->getResponsibleShard(
+      logical, builder.slice(), true, shard, usesDefaultShardingAttributes);
+  if (res == TRI_ERROR_NO_ERROR) {
+    result.emplace(shard);
+  }
+  return result;
+}
+
+/// @brief restrict collections to the shards that can hold results. if every
+/// read of a collection pins all of its shard keys to constant values, or
+/// limits the shard key of a range-sharded collection to a constant range,
+/// only the parts for the shards involved are instantiated, locked and
+/// queried, instead of one part per shard. so a point query costs as many
+/// requests as on a single-shard collection.
+/// this rule modifies the collections of the query, not the plan
+void arangodb::aql::restrictToSingleShardRule(
+    Optimizer* opt, std::unique_ptr<ExecutionPlan> plan,
+    OptimizerRule const* rule) {
+  SmallVector<ExecutionNode*>::allocator_type::arena_type a;
+  SmallVector<ExecutionNode*> nodes{a};
+  plan->findNodesOfType(nodes, {EN::TRAVERSAL, EN::SHORTEST_PATH}, true);
+
+  if (!nodes.empty()) {
+    // graph operations may access any collection on any shard
+    opt->addPlan(std::move(plan), rule, false);
+    return;
+  }
+
+  plan->findNodesOfType(
+      nodes, {EN::ENUMERATE_COLLECTION, EN::INDEX, EN::INSERT, EN::UPDATE,
+              EN::REPLACE, EN::REMOVE, EN::UPSERT},
+      true);
+
+  // collection => shards, no shards if the collection cannot be restricted
+  std::unordered_map<Collection const*, std::unordered_set<std::string>>
+      shards;
+  std::unordered_set<Collection const*> unrestricted;
+
+  for (auto const& n : nodes) {
+    Collection const* collection;
+    switch (n->getType()) {
+      case EN::ENUMERATE_COLLECTION:
+        collection = static_cast<EnumerateCollectionNode const*>(n)->collection();
+        break;
+      case EN::INDEX:
+        collection = static_cast<IndexNode const*>(n)->collection();
+        break;
+      default:
+        // modifications may target any shard
+        collection = static_cast<ModificationNode const*>(n)->collection();
+        unrestricted.emplace(collection);
+        continue;
+    }
+
+    std::unordered_set<std::string> restricted;
+    if (!collection->isSatellite() && !collection->isSmart()) {
+      restricted = FindRestrictedShards(plan.get(), n, collection);
+    }
+    if (restricted.empty()) {
+      unrestricted.emplace(collection);
+    } else {
+      // every read must find its documents
+      shards[collection].insert(restricted.begin(), restricted.end());
+    }
+  }
+
+  bool modified = false;
+  for (auto const& it : shards) {
+    if (unrestricted.find(it.first) == unrestricted.end()) {
+      const_cast<Collection*>(it.first)->restrictToShards(it.second);
+      modified = true;
+    }
+  }
+
+  // the plan itself is unchanged, but the rule is reported so that the
+  // restriction shows up in the explain output
+  opt->addPlan(std::move(plan), rule, modified);
+}
+
+/// @brief try to get rid of a RemoteNode->ScatterNode combination which has
+/// only a SingletonNode and possibly some CalculationNodes as dependencies
+void arangodb::aql::removeUnnecessaryRemoteScatterRule(
+    Optimizer* opt, std::unique_ptr<ExecutionPlan> plan,
+    OptimizerRule const* rule) {
+  SmallVector<ExecutionNode*>::allocator_type::arena_type a;
+  SmallVector<ExecutionNode*> nodes{a};
+  plan->findNodesOfType(nodes, EN::REMOTE, true);
+
+  std::unordered_set<ExecutionNode*> toUnlink;
+
+  for (auto& n : nodes) {
+    // check if the remote node is preceeded by a scatter node and any number of
+    // calculation and singleton nodes. if yes, remove remote and scatter
+    if (!n->hasDependency()) {
+      continue;
+    }
+
+    auto const dep = n->getFirstDependency();
+    if (dep->getType() != EN::SCATTER) {
+      continue;
+    }
+
+    bool canOptimize = true;
+    auto node = dep;
+    while (node != nullptr) {
+      auto const& d = node->getDependencies();
+
+      if (d.size() != 1) {
+        break;
+      }
+
+      node = d[0];
+      if (node->getType() != EN::SINGLETON &&
+          node->getType() != EN::CALCULATION) {
+        // found some other node type...
+        // this disqualifies the optimization
+        canOptimize = false;
+        break;
+      }
+
+      if (node->getType() == EN::CALCULATION) {
+        auto calc = static_cast<CalculationNode const*>(node);
+        // check if the expression can be executed on a DB server safely
+        if (!calc->expression()->canRunOnDBServer()) {
+          canOptimize = false;
+          break;
+        }
+      }
+    }
+
+    if (canOptimize) {
+      toUnlink.emplace(n);
+      toUnlink.emplace(dep);
+    }
+  }
+
+  if (!toUnlink.empty()) {
+    plan->unlinkNodes(toUnlink);
+  }
+
+  opt->addPlan(std::move(plan), rule, !toUnlink.empty());
+}
+
+/// WalkerWorker for undistributeRemoveAfterEnumColl
+class RemoveToEnumCollFinder final : public WalkerWorker<ExecutionNode> {
+  ExecutionPlan* _plan;
+  std::unordered_set<ExecutionNode*>& _toUnlink;
+  bool _remove;
+  bool _scatter;
+  bool _gather;
+  EnumerateCollectionNode* _enumColl;
+  ExecutionNode* _setter;
+  const Variable* _variable;
+  ExecutionNode* _lastNode;
+
+ public:
+  RemoveToEnumCollFinder(ExecutionPlan* plan,
+                         std::unordered_set<ExecutionNode*>& toUnlink)
+      : _plan(plan),
+        _toUnlink(toUnlink),
+        _remove(false),
+        _scatter(false),
+        _gather(false),
+        _enumColl(nullptr),
+        _setter(nullptr),
+        _variable(nullptr),
+        _lastNode(nullptr){};
+
+  ~RemoveToEnumCollFinder() {}
+
+  bool before(ExecutionNode* en) override final {
+    switch (en->getType()) {
+      case EN::REMOVE: {
+        if (_remove) {
+          break;
+        }
+
+        // find the variable we are removing . . .
+        auto rn = static_cast<RemoveNode*>(en);
+        auto varsToRemove = rn->getVariablesUsedHere();
+
+        // remove nodes always have one input variable
+        TRI_ASSERT(varsToRemove.size() == 1);
+
+        _setter = _plan->getVarSetBy(varsToRemove[0]->id);
+        TRI_ASSERT(_setter != nullptr);
+        auto enumColl = _setter;
+
+        if (_setter->getType() == EN::CALCULATION) {
+          // this should be an attribute access for _key
+          auto cn = static_cast<CalculationNode*>(_setter);
+          if (!cn->expression()->isAttributeAccess()) {
+            break;  // abort . . .
+          }
+          // check the variable is the same as the remove variable
+          auto vars = cn->getVariablesSetHere();
+          if (vars.size() != 1 || vars[0]->id != varsToRemove[0]->id) {
+            break;  // abort . . .
+          }
+          // check the remove node's collection is sharded over _key
+          std::vector<std::string> shardKeys = rn->collection()->shardKeys();
+          if (shardKeys.size() != 1 ||
+              shardKeys[0] != StaticStrings::KeyString) {
+            break;  // abort . . .
+          }
+
+          // set the varsToRemove to the variable in the expression of this
+          // node and also define enumColl
+          varsToRemove = cn->getVariablesUsedHere();
+          TRI_ASSERT(varsToRemove.size() == 1);
+          enumColl = _plan->getVarSetBy(varsToRemove[0]->id);
+          TRI_ASSERT(_setter != nullptr);
+        }
+
+        if (enumColl->getType() != EN::ENUMERATE_COLLECTION) {
+          break;  // abort . . .
+        }
 
         _enumColl = static_cast<EnumerateCollectionNode*>(enumColl);
 
@@ -3703,6 +4783,240 @@ void arangodb::aql::patchUpdateStatementsRule(
   opt->addPlan(std::move(plan), rule, modified);
 }
 
+/// @brief make SORT nodes that are followed by a LIMIT only keep the top
+/// (offset + limit) rows in a bounded heap instead of sorting all input rows
+void arangodb::aql::sortLimitRule(Optimizer* opt,
+                                  std::unique_ptr<ExecutionPlan> plan,
+                                  OptimizerRule const* rule) {
+  SmallVector<ExecutionNode*>::allocator_type::arena_type a;
+  SmallVector<ExecutionNode*> nodes{a};
+  plan->findNodesOfType(nodes, EN::SORT, true);
+
+  bool modified = false;
+
+  for (auto const& n : nodes) {
+    auto sortNode = static_cast<SortNode*>(n);
+
+    if (sortNode->limit() > 0) {
+      // already limited
+      continue;
+    }
+
+    // calculations do not change the number of rows, so we can look
+    // beyond them
+    ExecutionNode* current = n->getFirstParent();
+    while (current != nullptr && current->getType() == EN::CALCULATION) {
+      current = current->getFirstParent();
+    }
+
+    if (current == nullptr || current->getType() != EN::LIMIT) {
+      continue;
+    }
+
+    auto limitNode = static_cast<LimitNode const*>(current);
+
+    if (limitNode->fullCount() || limitNode->limit() == 0) {
+      // fullCount needs to see all rows
+      continue;
+    }
+
+    size_t total = limitNode->offset() + limitNode->limit();
+    if (total < limitNode->limit()) {
+      // overflow
+      continue;
+    }
+
+    sortNode->setLimit(total);
+    modified = true;
+  }
+
+  opt->addPlan(std::move(plan), rule, modified);
+}
+
+/// @brief extract the variable and the attribute path from an expression
+/// of the form variable.attribute1.attribute2...
+static Variable const* GetAttributePath(AstNode const* node,
+                                        std::vector<std::string>& path) {
+  path.clear();
+  while (node->type == NODE_TYPE_ATTRIBUTE_ACCESS) {
+    path.emplace(path.begin(), node->getString());
+    node = node->getMember(0);
+  }
+
+  if (node->type != NODE_TYPE_REFERENCE || path.empty()) {
+    return nullptr;
+  }
+  return static_cast<Variable const*>(node->getData());
+}
+
+/// @brief find an equality condition "probeVariable.x == outVariable.y" in
+/// a condition, optionally as part of a conjunction
+static bool FindHashJoinCondition(
+    AstNode const* node, Variable const* outVariable,
+    std::unordered_set<Variable const*> const& validBefore,
+    std::vector<std::string>& buildAttribute, Variable const*& probeVariable,
+    std::vector<std::string>& probeAttribute) {
+  if (node->type == NODE_TYPE_OPERATOR_BINARY_AND ||
+      node->type == NODE_TYPE_OPERATOR_NARY_AND) {
+    for (size_t i = 0; i < node->numMembers(); ++i) {
+      if (FindHashJoinCondition(node->getMemberUnchecked(i), outVariable,
+                                validBefore, buildAttribute, probeVariable,
+                                probeAttribute)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  if (node->type != NODE_TYPE_OPERATOR_BINARY_EQ) {
+    return false;
+  }
+
+  for (size_t i = 0; i < 2; ++i) {
+    AstNode const* build = node->getMember(i);
+    AstNode const* probe = node->getMember(1 - i);
+
+    if (GetAttributePath(build, buildAttribute) != outVariable) {
+      continue;
+    }
+
+    probeVariable = GetAttributePath(probe, probeAttribute);
+    if (probeVariable != nullptr && probeVariable != outVariable &&
+        validBefore.find(probeVariable) != validBefore.end()) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/// @brief replace a full collection scan that is joined to an outer loop
+/// via an equality filter by a hash join
+void arangodb::aql::hashJoinRule(Optimizer* opt,
+                                 std::unique_ptr<ExecutionPlan> plan,
+                                 OptimizerRule const* rule) {
+  if (arangodb::ServerState::instance()->isRunningInCluster()) {
+    // the documents of a sharded collection are not all available locally
+    opt->addPlan(std::move(plan), rule, false);
+    return;
+  }
+
+  SmallVector<ExecutionNode*>::allocator_type::arena_type a;
+  SmallVector<ExecutionNode*> nodes{a};
+  plan->findNodesOfType(nodes, EN::ENUMERATE_COLLECTION, true);
+
+  if (nodes.empty()) {
+    opt->addPlan(std::move(plan), rule, false);
+    return;
+  }
+
+  {
+    // the hash table is built once per query and would not see the
+    // changes made by the query itself
+    std::vector<ExecutionNode::NodeType> const types = {
+        EN::INSERT, EN::UPDATE, EN::REPLACE, EN::REMOVE, EN::UPSERT};
+    SmallVector<ExecutionNode*>::allocator_type::arena_type b;
+    SmallVector<ExecutionNode*> modifications{b};
+    plan->findNodesOfType(modifications, types, true);
+
+    if (!modifications.empty()) {
+      opt->addPlan(std::move(plan), rule, false);
+      return;
+    }
+  }
+
+  plan->findVarUsage();
+
+  bool modified = false;
+  std::vector<std::string> buildAttribute;
+  std::vector<std::string> probeAttribute;
+
+  for (auto const& n : nodes) {
+    auto en = static_cast<EnumerateCollectionNode*>(n);
+
+    if (!en->isDeterministic() || !en->projection().empty()) {
+      // random iteration or projection
+      continue;
+    }
+
+    size_t incoming = 0;
+    en->getFirstDependency()->getCost(incoming);
+    if (incoming <= 1) {
+      // the collection is scanned only once anyway
+      continue;
+    }
+
+    Variable const* outVariable = en->outVariable();
+    auto const& validBefore = en->getFirstDependency()->getVarsValid();
+    Variable const* probeVariable = nullptr;
+    bool found = false;
+
+    // look for a FILTER on the documents. calculations and filters do not
+    // depend on the order of rows, so they can be looked beyond
+    ExecutionNode* current = en->getFirstParent();
+    while (current != nullptr && !found &&
+           (current->getType() == EN::CALCULATION ||
+            current->getType() == EN::FILTER)) {
+      if (current->getType() == EN::FILTER) {
+        auto setter =
+            plan->getVarSetBy(current->getVariablesUsedHere()[0]->id);
+
+        if (setter != nullptr && setter->getType() == EN::CALCULATION) {
+          AstNode const* condition =
+              static_cast<CalculationNode const*>(setter)->expression()->node();
+          found = FindHashJoinCondition(condition, outVariable, validBefore,
+                                        buildAttribute, probeVariable,
+                                        probeAttribute);
+        }
+      }
+      current = current->getFirstParent();
+    }
+
+    if (!found) {
+      continue;
+    }
+
+    // the FILTER is kept, it re-checks the condition for all documents
+    // produced by the hash join
+    auto hashJoin = new HashJoinNode(plan.get(), plan->nextId(), en->vocbase(),
+                                     en->collection(), outVariable,
+                                     buildAttribute, probeVariable,
+                                     probeAttribute);
+    plan->registerNode(hashJoin);
+    plan->replaceNode(en, hashJoin);
+    modified = true;
+  }
+
+  opt->addPlan(std::move(plan), rule, modified);
+}
+
+/// @brief finds the top-level attributes of a traversal path variable that
+/// the plan reads. a use of the path as a whole sets `wholePath`
+struct PathComponentsFinder final : public WalkerWorker<ExecutionNode> {
+  Variable const* pathVariable;
+  std::unordered_set<std::string> attributes;
+  bool wholePath;
+
+  explicit PathComponentsFinder(Variable const* variable)
+      : pathVariable(variable), wholePath(false) {}
+
+  bool before(ExecutionNode* en) override final {
+    auto varsUsedHere = en->getVariablesUsedHere();
+    if (std::find(varsUsedHere.begin(), varsUsedHere.end(), pathVariable) ==
+        varsUsedHere.end()) {
+      return false;
+    }
+    if (en->getType() != EN::CALCULATION ||
+        !Ast::getReferencedAttributes(
+            static_cast<CalculationNode*>(en)->expression()->node(),
+            pathVariable, attributes)) {
+      wholePath = true;
+    }
+    // abort the walk once the whole path is needed
+    return wholePath;
+  }
+};
+
 /// @brief optimizes away unused traversal output variables and
 /// merges filter nodes into graph traversal nodes
 void arangodb::aql::optimizeTraversalsRule(Optimizer* opt,
@@ -3744,6 +5058,23 @@ void arangodb::aql::optimizeTraversalsRule(Optimizer* opt,
       // traversal path outVariable not used later
       traversal->setPathOutput(nullptr);
       modified = true;
+    } else if (outVariable != nullptr) {
+      PathComponentsFinder finder(outVariable);
+      plan->root()->walk(&finder);
+      if (!finder.wholePath) {
+        auto options =
+            static_cast<traverser::TraverserOptions*>(traversal->options());
+        if (finder.attributes.find("vertices") == finder.attributes.end() &&
+            options->producePathsVertices) {
+          options->producePathsVertices = false;
+          modified = true;
+        }
+        if (finder.attributes.find("edges") == finder.attributes.end() &&
+            options->producePathsEdges) {
+          options->producePathsEdges = false;
+          modified = true;
+        }
+      }
     }
   }
 
@@ -3874,7 +5205,9 @@ void arangodb::aql::removeFiltersCoveredByTraversal(Optimizer* opt, std::unique_
 }
 
 /// @brief removes redundant path variables, after applying
-/// `removeFiltersCoveredByTraversal`. Should significantly reduce overhead
+/// `removeFiltersCoveredByTraversal`. Should significantly reduce overhead.
+/// if only some components of the path are read, e.g. `LENGTH(p.edges)`,
+/// the traversal does not build the others
 void arangodb::aql::removeTraversalPathVariable(Optimizer* opt,
                                            std::unique_ptr<ExecutionPlan> plan,
                                            OptimizerRule const* rule) {
@@ -3895,6 +5228,23 @@ void arangodb::aql::removeTraversalPathVariable(Optimizer* opt,
       // traversal path outVariable not used later
       traversal->setPathOutput(nullptr);
       modified = true;
+    } else if (outVariable != nullptr) {
+      PathComponentsFinder finder(outVariable);
+      plan->root()->walk(&finder);
+      if (!finder.wholePath) {
+        auto options =
+            static_cast<traverser::TraverserOptions*>(traversal->options());
+        if (finder.attributes.find("vertices") == finder.attributes.end() &&
+            options->producePathsVertices) {
+          options->producePathsVertices = false;
+          modified = true;
+        }
+        if (finder.attributes.find("edges") == finder.attributes.end() &&
+            options->producePathsEdges) {
+          options->producePathsEdges = false;
+          modified = true;
+        }
+      }
     }
   }
   opt->addPlan(std::move(plan), rule, modified);
@@ -4106,6 +5456,220 @@ void arangodb::aql::inlineSubqueriesRule(Optimizer* opt,
   opt->addPlan(std::move(plan), rule, modified);
 }
 
+/// @brief the ways in which the result of a subquery can be consumed
+/// without materializing all of its rows
+enum class SubqueryUsage { UNKNOWN, COUNT, FIRST };
+
+/// @brief returns the function call node if <node> is a call of a single
+/// argument function with a reference to <variable> as its argument
+static AstNode const* SubqueryFunctionCall(AstNode const* node,
+                                           Variable const* variable) {
+  if (node->type != NODE_TYPE_FCALL) {
+    return nullptr;
+  }
+  auto args = node->getMember(0);
+  if (args->numMembers() != 1) {
+    return nullptr;
+  }
+  auto arg = args->getMember(0);
+  if (arg->type != NODE_TYPE_REFERENCE ||
+      static_cast<Variable const*>(arg->getData()) != variable) {
+    return nullptr;
+  }
+  return node;
+}
+
+/// @brief determines how the subquery result <variable> is used in the
+/// expression <node>. returns false if it is used in any other way than as
+/// the only argument of LENGTH()/COUNT() or of FIRST(), or if both kinds of
+/// usage are mixed
+static bool CheckSubqueryUsage(AstNode const* node, Variable const* variable,
+                               SubqueryUsage& usage) {
+  if (node == nullptr) {
+    return true;
+  }
+
+  if (node->type == NODE_TYPE_REFERENCE) {
+    // a direct reference, not wrapped in one of the supported functions
+    return static_cast<Variable const*>(node->getData()) != variable;
+  }
+
+  if (SubqueryFunctionCall(node, variable) != nullptr) {
+    auto func = static_cast<Function const*>(node->getData());
+    SubqueryUsage found = SubqueryUsage::UNKNOWN;
+    if (func->externalName == "LENGTH" || func->externalName == "COUNT") {
+      found = SubqueryUsage::COUNT;
+    } else if (func->externalName == "FIRST") {
+      found = SubqueryUsage::FIRST;
+    }
+    if (found == SubqueryUsage::UNKNOWN ||
+        (usage != SubqueryUsage::UNKNOWN && usage != found)) {
+      return false;
+    }
+    usage = found;
+    return true;
+  }
+
+  size_t const n = node->numMembers();
+  for (size_t i = 0; i < n; ++i) {
+    if (!CheckSubqueryUsage(node->getMemberUnchecked(i), variable, usage)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// @brief reduces subqueries whose results are only used via LENGTH() or
+/// FIRST() so that they produce at most one row per outer row. For example,
+///
+/// LET x = (FOR doc IN collection FILTER doc.value == outer.value RETURN doc)
+/// RETURN LENGTH(x)
+///
+/// is transformed into
+///
+/// LET x = (FOR doc IN collection FILTER doc.value == outer.value
+///          COLLECT WITH COUNT INTO tmp RETURN tmp)
+/// RETURN x[0]
+///
+/// and in case of FIRST(x), a LIMIT 1 is injected before the subquery's
+/// RETURN. Either way the subquery stops building a full result array for
+/// each outer row, and with the LIMIT the inner pipeline stops early.
+void arangodb::aql::optimizeSubqueriesRule(Optimizer* opt,
+                                           std::unique_ptr<ExecutionPlan> plan,
+                                           OptimizerRule const* rule) {
+  SmallVector<ExecutionNode*>::allocator_type::arena_type a;
+  SmallVector<ExecutionNode*> nodes{a};
+  plan->findNodesOfType(nodes, EN::SUBQUERY, true);
+
+  if (nodes.empty()) {
+    opt->addPlan(std::move(plan), rule, false);
+    return;
+  }
+
+  bool modified = false;
+  std::unordered_set<Variable const*> varsUsed;
+  std::vector<CalculationNode*> users;
+
+  for (auto const& n : nodes) {
+    auto subqueryNode = static_cast<SubqueryNode*>(n);
+
+    if (subqueryNode->isModificationQuery()) {
+      // all rows of a modifying subquery must be produced
+      continue;
+    }
+
+    auto returnNode = subqueryNode->getSubquery();
+    TRI_ASSERT(returnNode != nullptr);
+
+    if (returnNode->getType() != EN::RETURN ||
+        !returnNode->hasDependency()) {
+      continue;
+    }
+
+    Variable const* out = subqueryNode->outVariable();
+    TRI_ASSERT(out != nullptr);
+
+    // all nodes that use the subquery result must be calculations that use
+    // it in a supported way
+    SubqueryUsage usage = SubqueryUsage::UNKNOWN;
+    bool eligible = true;
+    users.clear();
+
+    auto current = n->getFirstParent();
+    while (current != nullptr) {
+      varsUsed.clear();
+      current->getVariablesUsedHere(varsUsed);
+      if (varsUsed.find(out) != varsUsed.end()) {
+        if (current->getType() != EN::CALCULATION) {
+          eligible = false;
+          break;
+        }
+        auto calc = static_cast<CalculationNode*>(current);
+        if (!CheckSubqueryUsage(calc->expression()->node(), out, usage)) {
+          eligible = false;
+          break;
+        }
+        users.emplace_back(calc);
+      }
+      current = current->getFirstParent();
+    }
+
+    if (!eligible || usage == SubqueryUsage::UNKNOWN) {
+      continue;
+    }
+
+    auto previous = returnNode->getFirstDependency();
+
+    if (usage == SubqueryUsage::FIRST) {
+      if (previous->getType() == EN::LIMIT &&
+          static_cast<LimitNode const*>(previous)->limit() <= 1) {
+        // already limited
+        continue;
+      }
+      auto limitNode = new LimitNode(plan.get(), plan->nextId(), 0, 1);
+      plan->registerNode(limitNode);
+      plan->insertDependency(returnNode, limitNode);
+      modified = true;
+      continue;
+    }
+
+    TRI_ASSERT(usage == SubqueryUsage::COUNT);
+
+    // count the subquery's rows with a specialized COLLECT that always
+    // produces exactly one row, and return the count
+    auto ast = plan->getAst();
+    Variable* countVariable = ast->variables()->createTemporaryVariable();
+
+    CollectOptions options;
+    auto collectNode = new CollectNode(
+        plan.get(), plan->nextId(), options,
+        std::vector<std::pair<Variable const*, Variable const*>>(),
+        std::vector<std::pair<Variable const*,
+                              std::pair<Variable const*, std::string>>>(),
+        nullptr, countVariable, std::vector<Variable const*>(),
+        ast->variables()->variables(false), true, false);
+    collectNode->aggregationMethod(CollectOptions::CollectMethod::COLLECT_METHOD_COUNT);
+    collectNode->specialized();
+    plan->registerNode(collectNode);
+    plan->insertDependency(returnNode, collectNode);
+
+    auto newReturnNode = new ReturnNode(plan.get(), plan->nextId(), countVariable);
+    plan->registerNode(newReturnNode);
+    returnNode->removeDependencies();
+    newReturnNode->addDependency(collectNode);
+    subqueryNode->setSubquery(newReturnNode, true);
+
+    // the subquery now returns [ count ], so LENGTH(x) becomes x[0]
+    for (auto& calc : users) {
+      Expression* expression = calc->expression();
+      AstNode* root = expression->nodeForModification();
+
+      auto visitor = [&ast, &out](AstNode* node, void*) -> AstNode* {
+        auto call = SubqueryFunctionCall(node, out);
+        if (call == nullptr) {
+          return node;
+        }
+        return ast->createNodeIndexedAccess(call->getMember(0)->getMember(0),
+                                            ast->createNodeValueInt(0));
+      };
+
+      // members may have been replaced in place, so always reset the
+      // expression's internal state
+      expression->replaceNode(Ast::traverseAndModify(root, visitor, nullptr));
+    }
+
+    modified = true;
+  }
+
+  if (modified) {
+    plan->clearVarUsageComputed();
+    plan->invalidateCost();
+    plan->findVarUsage();
+  }
+
+  opt->addPlan(std::move(plan), rule, modified);
+}
+
 struct GeoIndexInfo {
   operator bool() const { return distanceNode && valid; }
   void invalidate() { valid = false; }
@@ -140,6 +140,25 @@ void distributeFilternCalcToClusterRule(Optimizer*, std::unique_ptr<ExecutionPla
 void distributeSortToClusterRule(Optimizer*, std::unique_ptr<ExecutionPlan>,
                                  OptimizerRule const*);
 
+/// @brief run joins of co-sharded collections on their shard keys on the
+/// DB servers, without gathering the outer loop's results on the coordinator
+void removeCoShardedJoinsRule(Optimizer*, std::unique_ptr<ExecutionPlan>,
+                              OptimizerRule const*);
+
+/// @brief split a COLLECT on top of a GatherNode into a partial COLLECT on
+/// the DB servers and a merging COLLECT on the coordinator
+void collectInClusterRule(Optimizer*, std::unique_ptr<ExecutionPlan>,
+                          OptimizerRule const*);
+
+/// @brief push a LIMIT on top of a GatherNode to the DB servers
+void distributeLimitToClusterRule(Optimizer*, std::unique_ptr<ExecutionPlan>,
+                                  OptimizerRule const*);
+
+/// @brief restrict collections to a single shard if all of their reads
+/// pin all shard keys to constant values
+void restrictToSingleShardRule(Optimizer*, std::unique_ptr<ExecutionPlan>,
+                               OptimizerRule const*);
+
 /// @brief try to get rid of a RemoteNode->ScatterNode combination which has
 /// only a SingletonNode and possibly some CalculationNodes as dependencies
 void removeUnnecessaryRemoteScatterRule(Optimizer*, std::unique_ptr<ExecutionPlan>,
@@ -193,6 +212,16 @@ void removeDataModificationOutVariablesRule(Optimizer*, std::unique_ptr<Executio
 void patchUpdateStatementsRule(Optimizer*, std::unique_ptr<ExecutionPlan>,
                                OptimizerRule const*);
 
+/// @brief make SORT nodes that are followed by a LIMIT only keep the top
+/// (offset + limit) rows in a bounded heap
+void sortLimitRule(Optimizer*, std::unique_ptr<ExecutionPlan>,
+                   OptimizerRule const*);
+
+/// @brief replace a full collection scan that is joined to an outer loop
+/// via an equality filter by a hash join
+void hashJoinRule(Optimizer*, std::unique_ptr<ExecutionPlan>,
+                  OptimizerRule const*);
+
 /// @brief optimizes away unused traversal output variables and
 /// merges filter nodes into graph traversal nodes
 void optimizeTraversalsRule(Optimizer* opt, std::unique_ptr<ExecutionPlan> plan,
@@ -213,6 +242,10 @@ void prepareTraversalsRule(Optimizer* opt, std::unique_ptr<ExecutionPlan> plan,
 
 /// @brief moves simple subqueries one level higher
 void inlineSubqueriesRule(Optimizer*, std::unique_ptr<ExecutionPlan>, OptimizerRule const*);
+
+/// @brief reduces subqueries whose results are only used via LENGTH() or
+/// FIRST() so that they produce at most one row per outer row
+void optimizeSubqueriesRule(Optimizer*, std::unique_ptr<ExecutionPlan>, OptimizerRule const*);
   
 void geoIndexRule(aql::Optimizer* opt, std::unique_ptr<aql::ExecutionPlan> plan, aql::OptimizerRule const* rule);
 
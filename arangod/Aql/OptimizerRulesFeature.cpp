@@ -103,6 +103,11 @@ void OptimizerRulesFeature::addRules() {
   registerRule("inline-subqueries", inlineSubqueriesRule,
                OptimizerRule::inlineSubqueriesRule_pass1, DoesNotCreateAdditionalPlans, CanBeDisabled);
 
+  // let subqueries that are only counted or only have their first result
+  // used produce a single row
+  registerRule("optimize-subqueries", optimizeSubqueriesRule,
+               OptimizerRule::optimizeSubqueriesRule_pass1, DoesNotCreateAdditionalPlans, CanBeDisabled);
+
   // move calculations up the dependency chain (to pull them out of
   // inner loops etc.)
   registerRule("move-calculations-up", moveCalculationsUpRule,
@@ -218,6 +223,10 @@ void OptimizerRulesFeature::addRules() {
   registerRule("sort-in-values", sortInValuesRule, OptimizerRule::sortInValuesRule_pass6,
                DoesNotCreateAdditionalPlans, CanBeDisabled);
   
+  // replace joined full collection scans by hash joins
+  registerRule("hash-join", hashJoinRule,
+               OptimizerRule::hashJoinRule_pass6, DoesNotCreateAdditionalPlans, CanBeDisabled);
+
   // remove calculations that are never necessary
   registerRule("remove-unnecessary-calculations-2",
                removeUnnecessaryCalculationsRule,
@@ -230,6 +239,10 @@ void OptimizerRulesFeature::addRules() {
   // patch update statements
   registerRule("patch-update-statements", patchUpdateStatementsRule,
                OptimizerRule::patchUpdateStatementsRule_pass9, DoesNotCreateAdditionalPlans, CanBeDisabled);
+
+  // use a bounded heap for SORT + LIMIT
+  registerRule("sort-limit", sortLimitRule,
+               OptimizerRule::sortLimitRule_pass9, DoesNotCreateAdditionalPlans, CanBeDisabled);
   
   // patch update statements
   OptimizerRulesFeature::registerRule("geo-index-optimizer", geoIndexRule,
@@ -259,6 +272,18 @@ void OptimizerRulesFeature::addRules() {
                  undistributeRemoveAfterEnumCollRule,
                  OptimizerRule::undistributeRemoveAfterEnumCollRule_pass10, DoesNotCreateAdditionalPlans, CanBeDisabled);
 
+    registerRule("remove-co-sharded-joins", removeCoShardedJoinsRule,
+                 OptimizerRule::removeCoShardedJoinsRule_pass10, DoesNotCreateAdditionalPlans, CanBeDisabled);
+
+    registerRule("collect-in-cluster", collectInClusterRule,
+                 OptimizerRule::collectInClusterRule_pass10, DoesNotCreateAdditionalPlans, CanBeDisabled);
+
+    registerRule("distribute-limit-to-cluster", distributeLimitToClusterRule,
+                 OptimizerRule::distributeLimitToClusterRule_pass10, DoesNotCreateAdditionalPlans, CanBeDisabled);
+
+    registerRule("restrict-to-single-shard", restrictToSingleShardRule,
+                 OptimizerRule::restrictToSingleShardRule_pass10, DoesNotCreateAdditionalPlans, CanBeDisabled);
+
 #ifdef USE_ENTERPRISE
     registerRule("remove-satellite-joins",
                  removeSatelliteJoinsRule,
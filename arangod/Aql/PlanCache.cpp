@@ -38,16 +38,26 @@ using namespace arangodb::aql;
 static arangodb::aql::PlanCache Instance;
 
 /// @brief create the plan cache
-PlanCache::PlanCache() : _lock(), _plans() {}
+PlanCache::PlanCache()
+    : _lock(), _plans(), _lru(), _maxEntries(0), _invalidations(0) {}
 
 /// @brief destroy the plan cache
 PlanCache::~PlanCache() {}
 
+/// @brief set the maximum number of plans in the cache
+void PlanCache::setMaxEntries(size_t value) {
+  WRITE_LOCKER(writeLocker, _lock);
+
+  _maxEntries.store(value, std::memory_order_relaxed);
+  evict(value);
+}
+
 /// @brief lookup a plan in the cache
 std::shared_ptr<PlanCacheEntry> PlanCache::lookup(TRI_vocbase_t* vocbase,
                                                   uint64_t queryHash, 
                                                   QueryString const& queryString) {
-  READ_LOCKER(readLocker, _lock);
+  // a lookup modifies the LRU list
+  WRITE_LOCKER(writeLocker, _lock);
 
   auto it = _plans.find(vocbase);
 
@@ -63,16 +73,32 @@ std::shared_ptr<PlanCacheEntry> PlanCache::lookup(TRI_vocbase_t* vocbase,
     return std::shared_ptr<PlanCacheEntry>();
   }
 
-  // plan found in cache
-  return (*it2).second;
+  auto& entry = (*it2).second;
+  
+  if (entry->queryString.size() != queryString.size() ||
+      memcmp(entry->queryString.data(), queryString.data(), queryString.size()) != 0) {
+    // found an entry with a different query string and the same hash
+    return std::shared_ptr<PlanCacheEntry>();
+  }
+
+  // plan found in cache. move it to the front of the LRU list
+  _lru.splice(_lru.begin(), _lru, entry->lruPosition);
+
+  return entry;
 }
 
 /// @brief store a plan in the cache
 void PlanCache::store(
     TRI_vocbase_t* vocbase, uint64_t hash, QueryString const& queryString,
-    ExecutionPlan const* plan) {
+    ExecutionPlan const* plan, bool isModificationQuery) {
+  size_t maxEntries = _maxEntries.load(std::memory_order_relaxed);
+
+  if (maxEntries == 0) {
+    // cache is turned off
+    return;
+  }
  
-  auto entry = std::make_unique<PlanCacheEntry>(queryString.extract(SIZE_MAX), plan->toVelocyPack(plan->getAst(), true)); 
+  auto entry = std::make_shared<PlanCacheEntry>(vocbase, hash, queryString.extract(SIZE_MAX), plan->toVelocyPack(plan->getAst(), true), isModificationQuery); 
 
   WRITE_LOCKER(writeLocker, _lock);
 
@@ -83,17 +109,69 @@ void PlanCache::store(
     it = _plans.emplace(vocbase, std::unordered_map<uint64_t, std::shared_ptr<PlanCacheEntry>>()).first;
   }
 
+  auto it2 = (*it).second.find(hash);
+
+  if (it2 != (*it).second.end()) {
+    // replace an existing entry
+    _lru.erase((*it2).second->lruPosition);
+    (*it).second.erase(it2);
+  }
+
+  // make room for the new entry
+  evict(maxEntries - 1);
+
   // store cache entry
-  (*it).second.emplace(hash, std::move(entry));
+  _lru.push_front(entry.get());
+  entry->lruPosition = _lru.begin();
+  try {
+    // "it" is still valid here: evict() never removes the map of a database
+    // this is called for
+    (*it).second.emplace(hash, std::move(entry));
+  } catch (...) {
+    _lru.pop_front();
+    throw;
+  }
 }
 
 /// @brief invalidate all queries for a particular database
 void PlanCache::invalidate(TRI_vocbase_t* vocbase) {
+  _invalidations.fetch_add(1, std::memory_order_release);
+
+  WRITE_LOCKER(writeLocker, _lock);
+
+  auto it = _plans.find(vocbase);
+
+  if (it == _plans.end()) {
+    return;
+  }
+
+  for (auto const& it2 : (*it).second) {
+    _lru.erase(it2.second->lruPosition);
+  }
+
+  _plans.erase(it);
+}
+
+/// @brief remove all plans
+void PlanCache::clear() {
   WRITE_LOCKER(writeLocker, _lock);
 
-  _plans.erase(vocbase);
+  evict(0);
+}
+
+/// @brief remove the least recently used plans until there are at most
+/// maxEntries plans left
+void PlanCache::evict(size_t maxEntries) {
+  while (_lru.size() > maxEntries) {
+    PlanCacheEntry* entry = _lru.back();
+    _lru.pop_back();
+
+    auto it = _plans.find(entry->vocbase);
+    TRI_ASSERT(it != _plans.end());
+    // this will destroy the entry if no query is using it
+    (*it).second.erase(entry->hash);
+  }
 }
 
 /// @brief get the plan cache instance
 PlanCache* PlanCache::instance() { return &Instance; }
-
@@ -27,6 +27,8 @@
 #include "Basics/Common.h"
 #include "Basics/ReadWriteLock.h"
 
+#include <list>
+
 struct TRI_vocbase_t;
 
 namespace arangodb {
@@ -40,12 +42,24 @@ class QueryString;
 class VariableGenerator;
 
 struct PlanCacheEntry {
-  PlanCacheEntry(std::string&& queryString, 
-                 std::shared_ptr<arangodb::velocypack::Builder>&& builder)
-      : queryString(std::move(queryString)), builder(std::move(builder)) {}
-
-  std::string queryString;
+  PlanCacheEntry(TRI_vocbase_t* vocbase, uint64_t hash,
+                 std::string&& queryString, 
+                 std::shared_ptr<arangodb::velocypack::Builder>&& builder,
+                 bool isModificationQuery)
+      : vocbase(vocbase), 
+        hash(hash), 
+        queryString(std::move(queryString)), 
+        builder(std::move(builder)),
+        isModificationQuery(isModificationQuery) {}
+
+  TRI_vocbase_t* const vocbase;
+  uint64_t const hash;
+  std::string const queryString;
   std::shared_ptr<arangodb::velocypack::Builder> builder;
+  bool const isModificationQuery;
+  
+  /// @brief position of the entry in the LRU list
+  std::list<PlanCacheEntry*>::iterator lruPosition;
 };
 
 class PlanCache {
@@ -60,24 +74,54 @@ class PlanCache {
   ~PlanCache();
 
  public:
+  /// @brief maximum number of plans in the cache. 0 means the cache is off
+  size_t maxEntries() const { return _maxEntries.load(std::memory_order_relaxed); }
+
+  /// @brief set the maximum number of plans in the cache, evicting the
+  /// least recently used plans if required
+  void setMaxEntries(size_t value);
+
   /// @brief lookup a plan in the cache
   std::shared_ptr<PlanCacheEntry> lookup(TRI_vocbase_t*, uint64_t, QueryString const&);
 
   /// @brief store a plan in the cache
-  void store(TRI_vocbase_t*, uint64_t, QueryString const&, ExecutionPlan const*);
+  void store(TRI_vocbase_t*, uint64_t, QueryString const&, ExecutionPlan const*, bool);
 
   /// @brief invalidate all plans for a particular database
   void invalidate(TRI_vocbase_t*);
 
+  /// @brief remove all plans
+  void clear();
+
+  /// @brief number of invalidate() calls so far. plans stored elsewhere
+  /// must be dropped when this changes
+  uint64_t invalidations() const {
+    return _invalidations.load(std::memory_order_acquire);
+  }
+
   /// @brief get the pointer to the global plan cache
   static PlanCache* instance();
 
+ private:
+  /// @brief remove the least recently used plans until there are at most
+  /// the specified number of plans left. must be called under the write lock
+  void evict(size_t maxEntries);
+
  private:
   /// @brief read-write lock for the cache
   arangodb::basics::ReadWriteLock _lock;
 
   /// @brief cached query plans, organized per database
   std::unordered_map<TRI_vocbase_t*, std::unordered_map<uint64_t, std::shared_ptr<PlanCacheEntry>>> _plans;
+
+  /// @brief all cached plans, most recently used first
+  std::list<PlanCacheEntry*> _lru;
+
+  /// @brief maximum number of plans in the cache
+  std::atomic<size_t> _maxEntries;
+
+  /// @brief number of invalidate() calls
+  std::atomic<uint64_t> _invalidations;
 };
 }
 }
@@ -25,10 +25,14 @@
 
 #include "Aql/AqlItemBlock.h"
 #include "Aql/AqlTransaction.h"
+#include "Aql/Collection.h"
+#include "Aql/Condition.h"
 #include "Aql/ExecutionBlock.h"
 #include "Aql/ExecutionEngine.h"
 #include "Aql/ExecutionPlan.h"
 #include "Aql/Executor.h"
+#include "Aql/HashJoinNode.h"
+#include "Aql/IndexNode.h"
 #include "Aql/Optimizer.h"
 #include "Aql/Parser.h"
 #include "Aql/PlanCache.h"
@@ -36,13 +40,20 @@
 #include "Aql/QueryList.h"
 #include "Aql/QueryProfile.h"
 #include "Basics/Exceptions.h"
+#include "Basics/MemoryArenas.h"
+#include "Basics/SmallVector.h"
+#include "Basics/StaticStrings.h"
 #include "Basics/VelocyPackHelper.h"
 #include "Basics/WorkMonitor.h"
 #include "Basics/fasthash.h"
+#include "Cluster/ClusterInfo.h"
+#include "Cluster/ClusterMethods.h"
 #include "Cluster/ServerState.h"
 #include "GeneralServer/AuthenticationFeature.h"
+#include "Indexes/Index.h"
 #include "Logger/Logger.h"
 #include "RestServer/AqlFeature.h"
+#include "StorageEngine/TransactionCollection.h"
 #include "StorageEngine/TransactionState.h"
 #include "Transaction/Methods.h"
 #include "Transaction/StandaloneContext.h"
@@ -58,10 +69,6 @@
 #include <velocypack/Iterator.h>
 #include <velocypack/velocypack-aliases.h>
 
-#ifndef USE_PLAN_CACHE
-#undef USE_PLAN_CACHE
-#endif
-
 using namespace arangodb;
 using namespace arangodb::aql;
 
@@ -69,6 +76,222 @@ namespace {
 static std::atomic<TRI_voc_tick_t> NextQueryId(1);
 
 constexpr uint64_t DontCache = 0;
+
+/// @brief copies a serialized plan (or a part of it), adding the per-node
+/// statistics to every execution node contained in a "nodes" array
+static void AttachNodeStats(
+    VPackBuilder& builder, VPackSlice value,
+    std::unordered_map<size_t, VPackSlice> const& nodeStats, bool isNode) {
+  if (value.isArray()) {
+    builder.openArray();
+    for (auto const& it : VPackArrayIterator(value)) {
+      AttachNodeStats(builder, it, nodeStats, isNode);
+    }
+    builder.close();
+    return;
+  }
+
+  if (!value.isObject()) {
+    builder.add(value);
+    return;
+  }
+
+  builder.openObject();
+  for (auto const& it : VPackObjectIterator(value)) {
+    builder.add(it.key);
+    AttachNodeStats(builder, it.value, nodeStats, it.key.isEqualString("nodes"));
+  }
+  if (isNode) {
+    VPackSlice id = value.get("id");
+    if (id.isNumber()) {
+      auto found = nodeStats.find(id.getNumber<size_t>());
+      if (found != nodeStats.end()) {
+        builder.add(VPackValue("profile"));
+        builder.openObject();
+        builder.add("calls", (*found).second.get("calls"));
+        builder.add("items", (*found).second.get("items"));
+        builder.add("runtime", (*found).second.get("runtime"));
+        builder.close();
+      }
+    }
+  }
+  builder.close();
+}
+
+/// @brief returns a copy of the serialized plan with the per-node query
+/// statistics attached to its nodes
+static std::shared_ptr<VPackBuilder> ProfiledPlan(VPackSlice plan,
+                                                  VPackSlice stats) {
+  std::unordered_map<size_t, VPackSlice> nodeStats;
+  VPackSlice nodes = stats.get("nodes");
+  if (nodes.isArray()) {
+    for (auto const& it : VPackArrayIterator(nodes)) {
+      nodeStats.emplace(it.get("id").getNumber<size_t>(), it);
+    }
+  }
+
+  auto result = std::make_shared<VPackBuilder>();
+  AttachNodeStats(*result, plan, nodeStats, false);
+  return result;
+}
+
+/// @brief collects the document keys from a condition member of the form
+/// `variable._key == value` or `variable._key IN values`. returns false if
+/// the member does not restrict the primary key to constant values
+static bool CollectPrimaryKeys(AstNode const* member, Variable const* variable,
+                               std::unordered_set<std::string>& keys) {
+  if (member->type != NODE_TYPE_OPERATOR_BINARY_EQ &&
+      member->type != NODE_TYPE_OPERATOR_BINARY_IN) {
+    return false;
+  }
+
+  for (size_t i = 0; i < 2; ++i) {
+    if (i == 1 && member->type == NODE_TYPE_OPERATOR_BINARY_IN) {
+      // IN only works with the attribute on the left-hand side
+      break;
+    }
+
+    auto attribute = member->getMemberUnchecked(i);
+    auto value = member->getMemberUnchecked(1 - i);
+
+    if (attribute->type != NODE_TYPE_ATTRIBUTE_ACCESS ||
+        !attribute->stringEquals(StaticStrings::KeyString) ||
+        attribute->getMember(0)->type != NODE_TYPE_REFERENCE ||
+        static_cast<Variable const*>(attribute->getMember(0)->getData()) !=
+            variable ||
+        !value->isConstant()) {
+      continue;
+    }
+
+    if (member->type == NODE_TYPE_OPERATOR_BINARY_EQ) {
+      if (value->isStringValue()) {
+        keys.emplace(value->getStringValue(), value->getStringLength());
+      }
+      // non-string values cannot match any document
+      return true;
+    }
+
+    if (!value->isArray()) {
+      return false;
+    }
+
+    size_t const n = value->numMembers();
+    for (size_t j = 0; j < n; ++j) {
+      auto sub = value->getMemberUnchecked(j);
+      if (sub->isStringValue()) {
+        keys.emplace(sub->getStringValue(), sub->getStringLength());
+      }
+    }
+    return true;
+  }
+
+  return false;
+}
+
+/// @brief determines the document keys a query result depends on. only
+/// collections that are exclusively accessed by primary index lookups with
+/// constant keys are contained in the result, so that writes to other
+/// documents of these collections do not invalidate the cached result
+static QueryCacheKeys CollectQueryCacheKeys(ExecutionPlan* plan) {
+  QueryCacheKeys result;
+
+  if (plan == nullptr) {
+    return result;
+  }
+
+  if (plan->getAst() != nullptr &&
+      plan->getAst()->functionsMayAccessDocuments()) {
+    // functions such as DOCUMENT(), COLLECTION_COUNT(), NEAR(), WITHIN(),
+    // FULLTEXT() or user-defined functions may read arbitrary documents
+    return result;
+  }
+
+  SmallVector<ExecutionNode*>::allocator_type::arena_type a;
+  SmallVector<ExecutionNode*> nodes{a};
+  plan->findNodesOfType(nodes, {ExecutionNode::TRAVERSAL,
+                                ExecutionNode::SHORTEST_PATH},
+                        true);
+
+  if (!nodes.empty()) {
+    // graph operations may read arbitrary documents
+    return result;
+  }
+
+  std::unordered_set<std::string> fullyRead;
+
+  nodes.clear();
+  plan->findNodesOfType(nodes, {ExecutionNode::ENUMERATE_COLLECTION,
+                                ExecutionNode::HASH_JOIN},
+                        true);
+
+  for (auto const& n : nodes) {
+    if (n->getType() == ExecutionNode::ENUMERATE_COLLECTION) {
+      fullyRead.emplace(
+          static_cast<EnumerateCollectionNode const*>(n)->collection()->getName());
+    } else {
+      fullyRead.emplace(
+          static_cast<HashJoinNode const*>(n)->collection()->getName());
+    }
+  }
+
+  nodes.clear();
+  plan->findNodesOfType(nodes, ExecutionNode::INDEX, true);
+
+  for (auto const& n : nodes) {
+    auto en = static_cast<IndexNode const*>(n);
+    std::string const name = en->collection()->getName();
+
+    if (fullyRead.find(name) != fullyRead.end()) {
+      continue;
+    }
+
+    auto const& indexes = en->getIndexes();
+    bool restricted =
+        (en->condition() != nullptr && en->condition()->root() != nullptr &&
+         !indexes.empty());
+
+    for (auto const& index : indexes) {
+      if (!restricted) {
+        break;
+      }
+      restricted = (index.getIndex()->type() ==
+                    arangodb::Index::TRI_IDX_TYPE_PRIMARY_INDEX);
+    }
+
+    std::unordered_set<std::string> keys;
+
+    if (restricted) {
+      // every OR member must restrict the key
+      auto root = en->condition()->root();
+      size_t const numOrs = root->numMembers();
+      restricted = (numOrs > 0);
+
+      for (size_t i = 0; i < numOrs && restricted; ++i) {
+        auto andNode = root->getMemberUnchecked(i);
+        size_t const m = andNode->numMembers();
+        restricted = false;
+
+        for (size_t j = 0; j < m; ++j) {
+          if (CollectPrimaryKeys(andNode->getMemberUnchecked(j),
+                                 en->outVariable(), keys)) {
+            restricted = true;
+            break;
+          }
+        }
+      }
+    }
+
+    if (!restricted) {
+      fullyRead.emplace(name);
+      result.erase(name);
+      continue;
+    }
+
+    result[name].insert(keys.begin(), keys.end());
+  }
+
+  return result;
+}
 }
 
 /// @brief creates a query
@@ -81,6 +304,7 @@ Query::Query(bool contextOwnedByExterior, TRI_vocbase_t* vocbase,
       _resources(&_resourceMonitor),
       _vocbase(vocbase),
       _context(nullptr),
+      _isStreaming(false),
       _queryString(queryString),
       _queryBuilder(),
       _bindParameters(bindParameters),
@@ -161,6 +385,7 @@ Query::Query(bool contextOwnedByExterior, TRI_vocbase_t* vocbase,
       _resources(&_resourceMonitor),
       _vocbase(vocbase),
       _context(nullptr),
+      _isStreaming(false),
       _queryString(),
       _queryBuilder(queryStruct),
       _options(options),
@@ -332,17 +557,17 @@ void Query::prepare(QueryRegistry* registry, uint64_t queryHash) {
 
   std::unique_ptr<ExecutionPlan> plan;
 
-#if USE_PLAN_CACHE
-  if (!_queryString.empty() && 
-      queryHash != DontCache &&
-      _part == PART_MAIN) {
-    // LOG_TOPIC(INFO, Logger::FIXME) << "trying to find query in execution plan cache: '" << _queryString << "', hash: " << queryHash;
+  bool const usePlanCache = canUsePlanCache(queryHash);
+  uint64_t planHash = 0;
+
+  if (usePlanCache) {
+    // the number of plans influences which plan the optimizer picks
+    planHash = fasthash64(&_queryOptions.maxNumberOfPlans, 
+                          sizeof(_queryOptions.maxNumberOfPlans), queryHash);
 
     // store & lookup velocypack plans!!
-    std::shared_ptr<PlanCacheEntry> planCacheEntry = PlanCache::instance()->lookup(_vocbase, queryHash, queryString);
+    std::shared_ptr<PlanCacheEntry> planCacheEntry = planCache()->lookup(_vocbase, planHash, _queryString);
     if (planCacheEntry != nullptr) {
-      // LOG_TOPIC(INFO, Logger::FIXME) << "query found in execution plan cache: '" << _queryString << "'";
-
       TRI_ASSERT(_trx == nullptr); 
       TRI_ASSERT(_collections.empty());
   
@@ -352,22 +577,22 @@ void Query::prepare(QueryRegistry* registry, uint64_t queryHash) {
         _queryOptions.transactionOptions,
         _part == PART_MAIN);
       _trx = trx;
+      _isModificationQuery = planCacheEntry->isModificationQuery;
 
-      VPackBuilder* builder = planCacheEntry->builder.get();
-      VPackSlice slice = builder->slice();
+      VPackSlice slice = planCacheEntry->builder->slice();
       ExecutionPlan::getCollectionsFromVelocyPack(_ast.get(), slice);
       _ast->variables()->fromVelocyPack(slice);
     
       enterState(QueryExecutionState::ValueType::LOADING_COLLECTIONS);
     
-      int res = trx->addCollections(*_collections.collections());
+      Result res = trx->addCollections(*_collections.collections());
       
-      if (res == TRI_ERROR_NO_ERROR) {
+      if (res.ok()) {
         res = _trx->begin();
       }
     
-      if (res != TRI_ERROR_NO_ERROR) {
-        THROW_ARANGO_EXCEPTION_MESSAGE(res, buildErrorMessage(res));
+      if (!res.ok()) {
+        THROW_ARANGO_EXCEPTION(res);
       }
     
       enterState(QueryExecutionState::ValueType::PLAN_INSTANTIATION);
@@ -377,26 +602,24 @@ void Query::prepare(QueryRegistry* registry, uint64_t queryHash) {
       TRI_ASSERT(plan != nullptr);
     }
   }
-#endif
 
   if (plan == nullptr) {
     plan.reset(prepare());
 
     TRI_ASSERT(plan != nullptr);
 
-#if USE_PLAN_CACHE
-    if (!_queryString.empty() && 
-        queryHash != DontCache && 
-        _part == PART_MAIN &&
+    if (usePlanCache &&
         _warnings.empty() && 
         _ast->root()->isCacheable()) {
-      // LOG_TOPIC(INFO, Logger::FIXME) << "storing query in execution plan cache '" << _queryString << "', hash: " << queryHash;
-      PlanCache::instance()->store(_vocbase, queryHash, _queryString, plan.get());
+      planCache()->store(_vocbase, planHash, _queryString, plan.get(), _isModificationQuery);
     }
-#endif
   }
 
   enterState(QueryExecutionState::ValueType::EXECUTION);
+
+  if (_shardRevisions != nullptr) {
+    captureShardRevisions();
+  }
   
   TRI_ASSERT(_engine == nullptr);
   // note that the engine returned here may already be present in our
@@ -516,6 +739,91 @@ ExecutionPlan* Query::prepare() {
   return plan.release();
 }
 
+/// @brief commit the transaction of a successfully executed query and
+/// fill in its statistics, warnings and profile
+void Query::finalize(QueryResult& result) {
+  _trx->commit();
+    
+  LOG_TOPIC(DEBUG, Logger::QUERIES)
+      << TRI_microtime() - _startTime << " "
+      << "Query::finalize: before cleanupPlanAndEngine"
+      << " this: " << (uintptr_t) this;
+   
+  result.context = _trx->transactionContext();
+
+  _engine->_stats.setExecutionTime(runTime());
+  enterState(QueryExecutionState::ValueType::FINALIZATION);
+
+  auto plan = planForProfile();
+  auto stats = std::make_shared<VPackBuilder>();
+  cleanupPlanAndEngine(TRI_ERROR_NO_ERROR, stats.get());
+
+  result.warnings = warningsToVelocyPack();
+  result.stats = std::move(stats);
+
+  if (plan != nullptr) {
+    result.plan = ProfiledPlan(plan->slice(), result.stats->slice());
+  }
+
+  // patch stats in place
+  // we do this because "executionTime" should include the whole span of the execution and we have to set it at the very end
+  double now = TRI_microtime();
+  double const rt = runTime(now);
+  basics::VelocyPackHelper::patchDouble(result.stats->slice().get("executionTime"), rt);
+
+  if (_profile != nullptr && _queryOptions.profile > 0) {
+    _profile->setEnd(QueryExecutionState::ValueType::FINALIZATION, now);
+    result.profile = _profile->toVelocyPack();
+  }
+}
+
+/// @brief prepare an AQL query for streaming its results. the results
+/// are then fetched from the engine batch by batch, and the query must
+/// be finished with finishStreaming()
+void Query::prepareStreaming(QueryRegistry* registry) {
+  TRI_ASSERT(registry != nullptr);
+
+  // V8 contexts must not be held between batches
+  _isStreaming = true;
+
+  // the query result cache is not used for streamed results.
+  // will throw if it fails
+  prepare(registry, hash());
+
+  log();
+
+  TRI_ASSERT(_engine != nullptr);
+}
+
+/// @brief finish a streamed AQL query: commit the transaction and return
+/// the statistics, warnings and profile of the query
+QueryResult Query::finishStreaming() {
+  try {
+    QueryResult result;
+    finalize(result);
+    return result;
+  } catch (arangodb::basics::Exception const& ex) {
+    setExecutionTime();
+    cleanupPlanAndEngine(ex.code());
+    return QueryResult(ex.code(), "AQL: " + ex.message() + QueryExecutionState::toStringWithPrefix(_state));
+  } catch (std::bad_alloc const&) {
+    setExecutionTime();
+    cleanupPlanAndEngine(TRI_ERROR_OUT_OF_MEMORY);
+    return QueryResult(
+        TRI_ERROR_OUT_OF_MEMORY,
+        TRI_errno_string(TRI_ERROR_OUT_OF_MEMORY) + QueryExecutionState::toStringWithPrefix(_state));
+  } catch (std::exception const& ex) {
+    setExecutionTime();
+    cleanupPlanAndEngine(TRI_ERROR_INTERNAL);
+    return QueryResult(TRI_ERROR_INTERNAL, ex.what() + QueryExecutionState::toStringWithPrefix(_state));
+  } catch (...) {
+    setExecutionTime();
+    cleanupPlanAndEngine(TRI_ERROR_INTERNAL);
+    return QueryResult(TRI_ERROR_INTERNAL,
+                       TRI_errno_string(TRI_ERROR_INTERNAL) + QueryExecutionState::toStringWithPrefix(_state));
+  }
+}
+
 /// @brief execute an AQL query
 QueryResult Query::execute(QueryRegistry* registry) {
   LOG_TOPIC(DEBUG, Logger::QUERIES) << TRI_microtime() - _startTime << " "
@@ -524,6 +832,8 @@ QueryResult Query::execute(QueryRegistry* registry) {
   TRI_ASSERT(registry != nullptr);
 
   std::unique_ptr<AqlWorkStack> work;
+  // attribute the memory the query allocates on this thread to AQL
+  MemoryArenaScope arena(MemoryArena::AQL);
 
   try {
     bool useQueryCache = canUseQueryCache();
@@ -535,7 +845,7 @@ QueryResult Query::execute(QueryRegistry* registry) {
           _vocbase, queryHash, _queryString);
       arangodb::aql::QueryCacheResultEntryGuard guard(cacheEntry);
 
-      if (cacheEntry != nullptr) {
+      if (cacheEntry != nullptr && isCurrent(cacheEntry)) {
         // got a result from the query cache
         if(ExecContext::CURRENT != nullptr) {
           AuthInfo* info = AuthenticationFeature::INSTANCE->authInfo();
@@ -561,6 +871,11 @@ QueryResult Query::execute(QueryRegistry* registry) {
       }
     }
 
+    if (useQueryCache && ServerState::instance()->isCoordinator()) {
+      // the result can only be cached with the revisions of its shards
+      _shardRevisions.reset(new QueryCacheRevisions());
+    }
+
     // will throw if it fails
     prepare(registry, queryHash);
 
@@ -574,8 +889,13 @@ QueryResult Query::execute(QueryRegistry* registry) {
 
     log();
 
+    // plans from the plan cache have no AST, but only cacheable queries
+    // are stored in the plan cache
     if (useQueryCache && (_isModificationQuery || !_warnings.empty() ||
-                          !_ast->root()->isCacheable())) {
+                          writtenInTransaction(_trx->state()->collectionNames()) ||
+                          (_ast->root() != nullptr && !_ast->root()->isCacheable()) ||
+                          (ServerState::instance()->isCoordinator() &&
+                           _shardRevisions == nullptr))) {
       useQueryCache = false;
     }
 
@@ -622,7 +942,10 @@ QueryResult Query::execute(QueryRegistry* registry) {
           // finally store the generated result in the query cache
           auto result = QueryCache::instance()->store(
               _vocbase, queryHash, _queryString,
-              resultBuilder, _trx->state()->collectionNames());
+              resultBuilder, _trx->state()->collectionNames(),
+              CollectQueryCacheKeys(_plan.get()),
+              _shardRevisions == nullptr ? QueryCacheRevisions()
+                                         : *_shardRevisions);
 
           if (result == nullptr) {
             THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
@@ -656,39 +979,11 @@ QueryResult Query::execute(QueryRegistry* registry) {
                                       << "Query::execute: before _trx->commit"
                                       << " this: " << (uintptr_t) this;
 
-    _trx->commit();
-    
-    LOG_TOPIC(DEBUG, Logger::QUERIES)
-        << TRI_microtime() - _startTime << " "
-        << "Query::execute: before cleanupPlanAndEngine"
-        << " this: " << (uintptr_t) this;
-   
     QueryResult result; 
-    result.context = _trx->transactionContext();
-
-    _engine->_stats.setExecutionTime(runTime());
-    enterState(QueryExecutionState::ValueType::FINALIZATION);
-
-    auto stats = std::make_shared<VPackBuilder>();
-    cleanupPlanAndEngine(TRI_ERROR_NO_ERROR, stats.get());
-
-    result.warnings = warningsToVelocyPack();
+    finalize(result);
     result.result = std::move(resultBuilder);
-    result.stats = std::move(stats);
-
-    // patch stats in place
-    // we do this because "executionTime" should include the whole span of the execution and we have to set it at the very end
-    double now = TRI_microtime();
-    double const rt = runTime(now);
-    basics::VelocyPackHelper::patchDouble(result.stats->slice().get("executionTime"), rt);
-
-    if (_profile != nullptr && _queryOptions.profile) {
-      _profile->setEnd(QueryExecutionState::ValueType::FINALIZATION, now);
-      result.profile = _profile->toVelocyPack();
-    }
-
 
-    LOG_TOPIC(DEBUG, Logger::QUERIES) << rt << " "
+    LOG_TOPIC(DEBUG, Logger::QUERIES) << runTime() << " "
                                       << "Query::execute:returning"
                                       << " this: " << (uintptr_t) this;
     
@@ -723,6 +1018,8 @@ QueryResultV8 Query::executeV8(v8::Isolate* isolate, QueryRegistry* registry) {
   TRI_ASSERT(registry != nullptr);
 
   std::unique_ptr<AqlWorkStack> work;
+  // attribute the memory the query allocates on this thread to AQL
+  MemoryArenaScope arena(MemoryArena::AQL);
 
   try {
     bool useQueryCache = canUseQueryCache();
@@ -734,7 +1031,7 @@ QueryResultV8 Query::executeV8(v8::Isolate* isolate, QueryRegistry* registry) {
           _vocbase, queryHash, _queryString);
       arangodb::aql::QueryCacheResultEntryGuard guard(cacheEntry);
 
-      if (cacheEntry != nullptr) {
+      if (cacheEntry != nullptr && isCurrent(cacheEntry)) {
         // got a result from the query cache
         if(ExecContext::CURRENT != nullptr) {
           AuthInfo* info = AuthenticationFeature::INSTANCE->authInfo();
@@ -762,6 +1059,11 @@ QueryResultV8 Query::executeV8(v8::Isolate* isolate, QueryRegistry* registry) {
       }
     }
 
+    if (useQueryCache && ServerState::instance()->isCoordinator()) {
+      // the result can only be cached with the revisions of its shards
+      _shardRevisions.reset(new QueryCacheRevisions());
+    }
+
     // will throw if it fails
     prepare(registry, queryHash);
     
@@ -775,8 +1077,13 @@ QueryResultV8 Query::executeV8(v8::Isolate* isolate, QueryRegistry* registry) {
 
     log();
 
+    // plans from the plan cache have no AST, but only cacheable queries
+    // are stored in the plan cache
     if (useQueryCache && (_isModificationQuery || !_warnings.empty() ||
-                          !_ast->root()->isCacheable())) {
+                          writtenInTransaction(_trx->state()->collectionNames()) ||
+                          (_ast->root() != nullptr && !_ast->root()->isCacheable()) ||
+                          (ServerState::instance()->isCoordinator() &&
+                           _shardRevisions == nullptr))) {
       useQueryCache = false;
     }
 
@@ -821,7 +1128,11 @@ QueryResultV8 Query::executeV8(v8::Isolate* isolate, QueryRegistry* registry) {
         if (_warnings.empty()) {
           // finally store the generated result in the query cache
           QueryCache::instance()->store(_vocbase, queryHash, _queryString, builder,
-                                        _trx->state()->collectionNames());
+                                        _trx->state()->collectionNames(),
+                                        CollectQueryCacheKeys(_plan.get()),
+                                        _shardRevisions == nullptr
+                                            ? QueryCacheRevisions()
+                                            : *_shardRevisions);
         }
       } else {
         // iterate over result and return it
@@ -871,19 +1182,24 @@ QueryResultV8 Query::executeV8(v8::Isolate* isolate, QueryRegistry* registry) {
     _engine->_stats.setExecutionTime(runTime());
     enterState(QueryExecutionState::ValueType::FINALIZATION);
 
+    auto plan = planForProfile();
     auto stats = std::make_shared<VPackBuilder>();
     cleanupPlanAndEngine(TRI_ERROR_NO_ERROR, stats.get());
 
     result.warnings = warningsToVelocyPack();
     result.stats = std::move(stats);
 
+    if (plan != nullptr) {
+      result.plan = ProfiledPlan(plan->slice(), result.stats->slice());
+    }
+
     // patch executionTime stats value in place
     // we do this because "executionTime" should include the whole span of the execution and we have to set it at the very end
     double now = TRI_microtime();
     double const rt = runTime(now);
     basics::VelocyPackHelper::patchDouble(result.stats->slice().get("executionTime"), rt);
 
-    if (_profile != nullptr && _queryOptions.profile) {
+    if (_profile != nullptr && _queryOptions.profile > 0) {
       _profile->setEnd(QueryExecutionState::ValueType::FINALIZATION, now);
       result.profile = _profile->toVelocyPack();
     }
@@ -1211,6 +1527,23 @@ uint64_t Query::hash() {
   return hash ^ _bindParameters.hash();
 }
 
+/// @brief whether or not the plan cache can be used for the query
+bool Query::canUsePlanCache(uint64_t queryHash) const {
+  return (!_queryString.empty() &&
+          queryHash != DontCache &&
+          _part == PART_MAIN &&
+          planCache()->maxEntries() > 0 &&
+          !arangodb::ServerState::instance()->isRunningInCluster());
+}
+
+/// @brief the plan cache to use for the query
+PlanCache* Query::planCache() const {
+  if (_planCache != nullptr) {
+    return _planCache.get();
+  }
+  return PlanCache::instance();
+}
+
 /// @brief whether or not the query cache can be used for the query
 bool Query::canUseQueryCache() const {
   if (_queryString.size() < 8) {
@@ -1225,13 +1558,100 @@ bool Query::canUseQueryCache() const {
     // cache mode is set to always on or on-demand... 
     // query will only be cached if `cache` attribute is not set to false
 
-    // cannot use query cache on a coordinator at the moment
-    return !arangodb::ServerState::instance()->isRunningInCluster();
+    // coordinators check the shard revisions of cached results, the parts
+    // of queries on DB servers are not cached
+    return !arangodb::ServerState::instance()->isDBServer();
+  }
+
+  return false;
+}
+
+/// @brief whether a result from the query cache is still current
+bool Query::isCurrent(QueryCacheResultEntry const* entry) {
+  if (writtenInTransaction(entry->_collections)) {
+    // the cached result, stale or not, cannot contain the uncommitted
+    // writes of the surrounding transaction
+    return false;
+  }
+  if (!arangodb::ServerState::instance()->isCoordinator()) {
+    // writes invalidate the results right away
+    return true;
+  }
+  if (entry->_collections.empty()) {
+    return true;
+  }
+
+  // asking for the revisions is much cheaper than running the query
+  QueryCacheRevisions revisions;
+  int res = shardRevisionsOnCoordinator(_vocbase->name(), entry->_collections,
+                                        revisions);
+  if (res != TRI_ERROR_NO_ERROR) {
+    return false;
+  }
+  if (revisions == entry->_revisions) {
+    return true;
   }
 
+  // some shards were written to since, or moved or recreated
+  std::vector<std::string> changed;
+  for (auto const& collection : entry->_collections) {
+    std::shared_ptr<LogicalCollection> collinfo;
+    try {
+      collinfo =
+          ClusterInfo::instance()->getCollection(_vocbase->name(), collection);
+    } catch (...) {
+      changed.emplace_back(collection);
+      continue;
+    }
+    for (auto const& shard : *collinfo->shardIds()) {
+      auto it = entry->_revisions.find(shard.first);
+      if (it == entry->_revisions.end() ||
+          (*it).second != revisions[shard.first]) {
+        changed.emplace_back(collection);
+        break;
+      }
+    }
+  }
+  QueryCache::instance()->invalidate(_vocbase, changed);
   return false;
 }
 
+/// @brief whether the transaction the query runs in has written to one of
+/// the collections
+bool Query::writtenInTransaction(
+    std::vector<std::string> const& collections) const {
+  if (!_contextOwnedByExterior) {
+    // the query is a transaction of its own
+    return false;
+  }
+  TransactionState* state = transaction::V8Context::getParentState();
+  if (state == nullptr) {
+    return false;
+  }
+
+  bool written = false;
+  state->allCollections([&](TransactionCollection* trxColl) {
+    if (trxColl->hasOperations() &&
+        std::find(collections.begin(), collections.end(),
+                  trxColl->collectionName()) != collections.end()) {
+      written = true;
+    }
+    return !written;
+  });
+  return written;
+}
+
+/// @brief remember the revisions of the shards the query reads
+void Query::captureShardRevisions() {
+  TRI_ASSERT(_shardRevisions != nullptr);
+  int res = shardRevisionsOnCoordinator(
+      _vocbase->name(), _trx->state()->collectionNames(), *_shardRevisions);
+  if (res != TRI_ERROR_NO_ERROR) {
+    // the result cannot be cached
+    _shardRevisions.reset();
+  }
+}
+
 /// @brief neatly format exception messages for the users
 std::string Query::buildErrorMessage(int errorCode) const {
   std::string err(TRI_errno_string(errorCode));
@@ -1264,6 +1684,14 @@ void Query::cleanupPlanAndEngine(int errorCode, VPackBuilder* statsBuilder) {
   if (_engine != nullptr) {
     try {
       _engine->shutdown(errorCode);
+      // the part timings are kept for the slow query list, and only
+      // returned with the statistics if the query is profiled
+      if (_queryOptions.profile > 0) {
+        _snippetStats = _engine->_stats.snippets;
+      } else {
+        _snippetStats = std::move(_engine->_stats.snippets);
+        _engine->_stats.snippets.clear();
+      }
       if (statsBuilder != nullptr) {
         _engine->_stats.toVelocyPack(*statsBuilder);
       }
@@ -1283,6 +1711,28 @@ void Query::cleanupPlanAndEngine(int errorCode, VPackBuilder* statsBuilder) {
   _plan.reset();
 }
 
+/// @brief copy of the resources the query used so far. may be called by
+/// other threads while the query is running
+QueryUsageStats Query::usageStats() const {
+  QueryUsageStats stats;
+  stats.memoryUsage = _resourceMonitor.currentResources.memoryUsage;
+  stats.peakMemoryUsage = _resourceMonitor.peakMemoryUsage;
+  stats.cpuTime =
+      static_cast<double>(_usage.cpuTime.load(std::memory_order_relaxed)) /
+      1000000000.0;
+  stats.rowsProcessed = _usage.rowsProcessed.load(std::memory_order_relaxed);
+  stats.blockReads = _usage.blockReads.load(std::memory_order_relaxed);
+  return stats;
+}
+
+/// @brief serializes the executed plan if the query is profiled per node
+std::shared_ptr<VPackBuilder> Query::planForProfile() const {
+  if (_queryOptions.profile < 2 || _plan == nullptr) {
+    return nullptr;
+  }
+  return _plan->toVelocyPack(_ast.get(), false);
+}
+
 /// @brief create a transaction::Context
 std::shared_ptr<transaction::Context> Query::createTransactionContext() {
   if (_contextOwnedByExterior) {
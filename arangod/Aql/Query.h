@@ -30,12 +30,15 @@
 
 #include "Aql/BindParameters.h"
 #include "Aql/Collections.h"
+#include "Aql/ExecutionStats.h"
 #include "Aql/Graphs.h"
+#include "Aql/QueryCache.h"
 #include "Aql/QueryExecutionState.h"
 #include "Aql/QueryOptions.h"
 #include "Aql/QueryResources.h"
 #include "Aql/QueryResultV8.h"
 #include "Aql/QueryString.h"
+#include "Aql/QueryUsage.h"
 #include "Aql/ResourceUsage.h"
 #include "Aql/types.h"
 #include "Basics/Common.h"
@@ -62,6 +65,7 @@ class Ast;
 class ExecutionEngine;
 class ExecutionPlan;
 class Executor;
+class PlanCache;
 class Query;
 struct QueryProfile;
 class QueryRegistry;
@@ -107,11 +111,25 @@ class Query {
 
   QueryOptions const& queryOptions() const { return _queryOptions; }
 
+  /// @brief use the given plan cache instead of the global one, e.g. the
+  /// plans of a prepared statement. must be called before the query is
+  /// prepared
+  void setPlanCache(std::shared_ptr<PlanCache> planCache) {
+    _planCache = std::move(planCache);
+  }
+
   void increaseMemoryUsage(size_t value) { _resourceMonitor.increaseMemoryUsage(value); }
   void decreaseMemoryUsage(size_t value) { _resourceMonitor.decreaseMemoryUsage(value); }
   
   ResourceMonitor* resourceMonitor() { return &_resourceMonitor; }
 
+  /// @brief CPU time, rows and reads of the query so far
+  QueryUsage& usage() { return _usage; }
+
+  /// @brief copy of the resources the query used so far. may be called by
+  /// other threads while the query is running
+  QueryUsageStats usageStats() const;
+
   /// @brief return the start timestamp of the query
   double startTime() const { return _startTime; }
   
@@ -152,6 +170,9 @@ class Query {
   /// @brief add a node to the list of nodes
   void addNode(AstNode* node) { _resources.addNode(node); }
 
+  /// @brief create a node that is freed when the query is destroyed
+  AstNode* createNode(AstNodeType type) { return _resources.createNode(type); }
+
   /// @brief register a string
   /// the string is freed when the query is destroyed
   char* registerString(char const* p, size_t length) { return _resources.registerString(p, length); }
@@ -182,6 +203,16 @@ class Query {
   /// @brief execute an AQL query
   QueryResult execute(QueryRegistry*);
 
+  /// @brief prepare an AQL query for streaming its results from the engine
+  void prepareStreaming(QueryRegistry*);
+
+  /// @brief finish a streamed AQL query, returns statistics and warnings
+  QueryResult finishStreaming();
+
+  /// @brief whether the results are streamed, i.e. fetched in batches that
+  /// may be requested by different threads
+  bool isStreaming() const { return _isStreaming; }
+
   /// @brief execute an AQL query
   /// may only be called with an active V8 handle scope
   QueryResultV8 executeV8(v8::Isolate* isolate, QueryRegistry*);
@@ -238,6 +269,12 @@ class Query {
  
   QueryExecutionState::ValueType state() const { return _state; }
 
+  /// @brief timings of the query parts that ran on DB servers, available
+  /// once the engine has been shut down
+  std::vector<ExecutionSnippetStats> const& snippetStats() const {
+    return _snippetStats;
+  }
+
  private:
   /// @brief initializes the query
   void init();
@@ -253,12 +290,32 @@ class Query {
   /// @brief log a query
   void log();
 
+  /// @brief commit the transaction and fill in statistics and warnings
+  void finalize(QueryResult&);
+
   /// @brief calculate a hash value for the query and bind parameters
   uint64_t hash();
 
   /// @brief whether or not the query cache can be used for the query
   bool canUseQueryCache() const;
 
+  /// @brief whether a result from the query cache is still current. on a
+  /// coordinator this compares the revisions of its shards with the ones it
+  /// was computed from, and invalidates the results of changed collections
+  bool isCurrent(QueryCacheResultEntry const*);
+
+  /// @brief whether the transaction the query runs in has written to one of
+  /// the collections. its results must neither be taken from the query
+  /// cache nor stored in it
+  bool writtenInTransaction(std::vector<std::string> const&) const;
+
+  /// @brief remember the revisions of the shards the query reads, before
+  /// the DB servers take their snapshots
+  void captureShardRevisions();
+
+  /// @brief whether or not the plan cache can be used for the query
+  bool canUsePlanCache(uint64_t queryHash) const;
+
  private:
   /// @brief neatly format exception messages for the users
   std::string buildErrorMessage(int errorCode) const;
@@ -269,6 +326,14 @@ class Query {
   /// @brief cleanup plan and engine for current query
   void cleanupPlanAndEngine(int, VPackBuilder* statsBuilder = nullptr);
 
+  /// @brief the plan cache to use for the query
+  PlanCache* planCache() const;
+
+  /// @brief serializes the executed plan if the query is profiled per
+  /// node, so that the node statistics can be attached to it once the
+  /// engine has been shut down. returns a nullptr otherwise
+  std::shared_ptr<VPackBuilder> planForProfile() const;
+
   /// @brief create a transaction::Context
   std::shared_ptr<transaction::Context> createTransactionContext();
 
@@ -285,6 +350,9 @@ class Query {
   /// @brief resources used by query
   QueryResources _resources;
 
+  /// @brief CPU time, rows and reads of the query
+  QueryUsage _usage;
+
   /// @brief pointer to vocbase the query runs in
   TRI_vocbase_t* _vocbase;
 
@@ -294,6 +362,9 @@ class Query {
   /// @brief the currently used V8 context
   V8Context* _context;
 
+  /// @brief whether the query was prepared with prepareStreaming()
+  bool _isStreaming;
+
   /// @brief graphs used in query, identified by name
   std::unordered_map<std::string, Graph*> _graphs;
   
@@ -339,6 +410,9 @@ class Query {
 
   /// @brief warnings collected during execution
   std::vector<std::pair<int, std::string>> _warnings;
+
+  /// @brief timings of the query parts that ran on DB servers
+  std::vector<ExecutionSnippetStats> _snippetStats;
  
   /// @brief query start time
   double _startTime;
@@ -354,6 +428,14 @@ class Query {
 
   /// @brief whether or not the query is a data modification query
   bool _isModificationQuery;
+
+  /// @brief revisions of the shards the query reads, for storing the result
+  /// in the query cache of a coordinator. nullptr if not captured
+  std::unique_ptr<QueryCacheRevisions> _shardRevisions;
+
+  /// @brief plan cache to use instead of the global one. nullptr if the
+  /// global plan cache is used
+  std::shared_ptr<PlanCache> _planCache;
 };
 }
 }
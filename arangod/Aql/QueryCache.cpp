@@ -26,6 +26,7 @@
 #include "Basics/Exceptions.h"
 #include "Basics/MutexLocker.h"
 #include "Basics/ReadLocker.h"
+#include "Basics/system-functions.h"
 #include "Basics/tri-strings.h"
 #include "Basics/WriteLocker.h"
 #include "VocBase/vocbase.h"
@@ -44,14 +45,22 @@ static size_t MaxResults = 128;  // default value. can be changed later
 /// @brief whether or not the cache is enabled
 static std::atomic<arangodb::aql::QueryCacheMode> Mode(CACHE_ON_DEMAND);
 
+/// @brief maximum age (in milliseconds) of invalidated results that may
+/// still be served
+static std::atomic<uint64_t> MaxStaleness(0);
+
 /// @brief create a cache entry
 QueryCacheResultEntry::QueryCacheResultEntry(
     uint64_t hash, QueryString const& queryString,
-    std::shared_ptr<VPackBuilder> queryResult, std::vector<std::string> const& collections)
+    std::shared_ptr<VPackBuilder> queryResult, std::vector<std::string> const& collections,
+    QueryCacheKeys const& keys, QueryCacheRevisions const& revisions)
     : _hash(hash),
       _queryString(queryString.data(), queryString.size()),
       _queryResult(queryResult),
       _collections(collections),
+      _keys(keys),
+      _revisions(revisions),
+      _invalidatedAt(0.0),
       _prev(nullptr),
       _next(nullptr),
       _refCount(0),
@@ -86,6 +95,7 @@ void QueryCacheResultEntry::unuse() {
 QueryCacheDatabaseEntry::QueryCacheDatabaseEntry()
     : _entriesByHash(),
       _entriesByCollection(),
+      _entriesByKey(),
       _head(nullptr),
       _tail(nullptr),
       _numElements(0) {
@@ -101,6 +111,7 @@ QueryCacheDatabaseEntry::~QueryCacheDatabaseEntry() {
 
   _entriesByHash.clear();
   _entriesByCollection.clear();
+  _entriesByKey.clear();
 }
 
 /// @brief lookup a query result in the database-specific cache
@@ -125,6 +136,13 @@ QueryCacheResultEntry* QueryCacheDatabaseEntry::lookup(
   // found an entry
   auto entry = (*it).second;
 
+  if (entry->_invalidatedAt > 0.0 &&
+      (TRI_microtime() - entry->_invalidatedAt) * 1000.0 >
+          static_cast<double>(MaxStaleness.load(std::memory_order_relaxed))) {
+    // entry was invalidated too long ago
+    return nullptr;
+  }
+
   // mark the entry as being used so noone else can delete it while it is in use
   entry->use();
 
@@ -150,6 +168,17 @@ void QueryCacheDatabaseEntry::store(uint64_t hash,
 
   try {
     for (auto const& it : entry->_collections) {
+      auto keys = entry->_keys.find(it);
+
+      if (keys != entry->_keys.end()) {
+        // result depends on individual documents of the collection only
+        auto& byKey = _entriesByKey[it];
+        for (auto const& key : (*keys).second) {
+          byKey[key].emplace(hash);
+        }
+        continue;
+      }
+
       auto it2 = _entriesByCollection.find(it);
 
       if (it2 == _entriesByCollection.end()) {
@@ -170,6 +199,18 @@ void QueryCacheDatabaseEntry::store(uint64_t hash,
       if (it2 != _entriesByCollection.end()) {
         (*it2).second.erase(hash);
       }
+
+      auto keys = entry->_keys.find(it);
+      auto it3 = _entriesByKey.find(it);
+
+      if (keys != entry->_keys.end() && it3 != _entriesByKey.end()) {
+        for (auto const& key : (*keys).second) {
+          auto it4 = (*it3).second.find(key);
+          if (it4 != (*it3).second.end()) {
+            (*it4).second.erase(hash);
+          }
+        }
+      }
     }
 
     // finally remove entry itself from hash table
@@ -207,27 +248,91 @@ void QueryCacheDatabaseEntry::invalidate(
 void QueryCacheDatabaseEntry::invalidate(std::string const& collection) {
   auto it = _entriesByCollection.find(collection);
 
-  if (it == _entriesByCollection.end()) {
+  if (it != _entriesByCollection.end()) {
+    for (auto& it2 : (*it).second) {
+      invalidateEntry(it2);
+    }
+
+    _entriesByCollection.erase(it);
+  }
+
+  auto it3 = _entriesByKey.find(collection);
+
+  if (it3 != _entriesByKey.end()) {
+    for (auto& it4 : (*it3).second) {
+      for (auto& it5 : it4.second) {
+        invalidateEntry(it5);
+      }
+    }
+
+    _entriesByKey.erase(it3);
+  }
+}
+
+/// @brief invalidate all entries in the database-specific cache that
+/// depend on a particular document of a collection
+void QueryCacheDatabaseEntry::invalidate(std::string const& collection,
+                                         std::string const& key) {
+  // results that read the collection in full depend on any document
+  auto it = _entriesByCollection.find(collection);
+
+  if (it != _entriesByCollection.end()) {
+    for (auto& it2 : (*it).second) {
+      invalidateEntry(it2);
+    }
+
+    _entriesByCollection.erase(it);
+  }
+
+  auto it3 = _entriesByKey.find(collection);
+
+  if (it3 == _entriesByKey.end()) {
     return;
   }
 
-  for (auto& it2 : (*it).second) {
-    auto it3 = _entriesByHash.find(it2);
+  auto it4 = (*it3).second.find(key);
+
+  if (it4 != (*it3).second.end()) {
+    for (auto& it5 : (*it4).second) {
+      invalidateEntry(it5);
+    }
+
+    (*it3).second.erase(it4);
+
+    if ((*it3).second.empty()) {
+      _entriesByKey.erase(it3);
+    }
+  }
+}
+
+/// @brief invalidate a single entry. if stale results are allowed, the
+/// entry is only marked as invalidated and stays in the cache
+void QueryCacheDatabaseEntry::invalidateEntry(uint64_t hash) {
+  auto it = _entriesByHash.find(hash);
 
-    if (it3 != _entriesByHash.end()) {
-      // remove entry from the linked list
-      auto entry = (*it3).second;
-      unlink(entry);
+  if (it == _entriesByHash.end()) {
+    return;
+  }
 
-      // erase it from hash table
-      _entriesByHash.erase(it3);
+  auto entry = (*it).second;
 
-      // delete the object itself
-      tryDelete(entry);
+  if (MaxStaleness.load(std::memory_order_relaxed) > 0) {
+    // keep the entry around until it is replaced or evicted, but never
+    // extend the time it may be served for
+    if (entry->_invalidatedAt == 0.0) {
+      entry->_invalidatedAt = TRI_microtime();
     }
+    return;
   }
 
-  _entriesByCollection.erase(it);
+  // remove entry from the linked list
+  unlink(entry);
+
+  // erase it from hash table
+  _entriesByHash.erase(it);
+
+  // delete the object itself
+  tryDelete(entry);
 }
 
 /// @brief enforce maximum number of results
@@ -313,6 +418,7 @@ VPackBuilder QueryCache::properties() {
   builder.openObject();
   builder.add("mode", VPackValue(modeString(mode())));
   builder.add("maxResults", VPackValue(MaxResults));
+  builder.add("maxStaleness", VPackValue(maxStaleness()));
   builder.close();
 
   return builder;
@@ -382,7 +488,8 @@ QueryCacheResultEntry* QueryCache::lookup(TRI_vocbase_t* vocbase, uint64_t hash,
 QueryCacheResultEntry* QueryCache::store(
     TRI_vocbase_t* vocbase, uint64_t hash, QueryString const& queryString,
     std::shared_ptr<VPackBuilder> result,
-    std::vector<std::string> const& collections) {
+    std::vector<std::string> const& collections,
+    QueryCacheKeys const& keys, QueryCacheRevisions const& revisions) {
 
   if (!result->slice().isArray()) {
     return nullptr;
@@ -393,7 +500,7 @@ QueryCacheResultEntry* QueryCache::store(
 
   // create the cache entry outside the lock
   auto entry = std::make_unique<QueryCacheResultEntry>(
-      hash, queryString, result, collections);
+      hash, queryString, result, collections, keys, revisions);
 
   WRITE_LOCKER(writeLocker, _entriesLock[part]);
 
@@ -442,6 +549,22 @@ void QueryCache::invalidate(TRI_vocbase_t* vocbase, std::string const& collectio
   (*it).second->invalidate(collection);
 }
 
+/// @brief invalidate all queries that depend on a particular document
+void QueryCache::invalidate(TRI_vocbase_t* vocbase, std::string const& collection,
+                            std::string const& key) {
+  auto const part = getPart(vocbase);
+  WRITE_LOCKER(writeLocker, _entriesLock[part]);
+
+  auto it = _entries[part].find(vocbase);
+
+  if (it == _entries[part].end()) {
+    return;
+  }
+
+  // invalidate while holding the lock
+  (*it).second->invalidate(collection, key);
+}
+
 /// @brief invalidate all queries for a particular database
 void QueryCache::invalidate(TRI_vocbase_t* vocbase) {
   QueryCacheDatabaseEntry* databaseQueryCache = nullptr;
@@ -524,6 +647,18 @@ void QueryCache::setMaxResults(size_t value) {
   MaxResults = value;
 }
 
+/// @brief return the maximum age (in milliseconds) of results that may be
+/// served after they have been invalidated
+uint64_t QueryCache::maxStaleness() const {
+  return MaxStaleness.load(std::memory_order_relaxed);
+}
+
+/// @brief sets the maximum age (in milliseconds) of results that may be
+/// served after they have been invalidated
+void QueryCache::setMaxStaleness(uint64_t value) {
+  MaxStaleness.store(value, std::memory_order_release);
+}
+
 /// @brief sets the caching mode
 void QueryCache::setMode(QueryCacheMode value) {
   if (value == mode()) {
@@ -40,11 +40,23 @@ namespace aql {
 /// @brief cache mode
 enum QueryCacheMode { CACHE_ALWAYS_OFF, CACHE_ALWAYS_ON, CACHE_ON_DEMAND };
 
+/// @brief document keys a cached query result depends on, per collection.
+/// collections that are not contained in the map were read in full, so any
+/// write to them invalidates the result
+typedef std::unordered_map<std::string, std::unordered_set<std::string>>
+    QueryCacheKeys;
+
+/// @brief revisions of the shards a cached query result was computed from.
+/// only used on coordinators, which do not see the writes on the DB servers:
+/// a result is only served while its shards still have these revisions
+typedef std::unordered_map<std::string, uint64_t> QueryCacheRevisions;
+
 struct QueryCacheResultEntry {
   QueryCacheResultEntry() = delete;
 
   QueryCacheResultEntry(uint64_t, QueryString const&, std::shared_ptr<arangodb::velocypack::Builder>,
-                        std::vector<std::string> const&);
+                        std::vector<std::string> const&, QueryCacheKeys const&,
+                        QueryCacheRevisions const&);
 
   ~QueryCacheResultEntry() = default;
 
@@ -61,6 +73,12 @@ struct QueryCacheResultEntry {
   std::string const _queryString;
   std::shared_ptr<arangodb::velocypack::Builder> _queryResult;
   std::vector<std::string> const _collections;
+  QueryCacheKeys const _keys;
+  QueryCacheRevisions const _revisions;
+  /// @brief time the entry was invalidated at, 0 if it is still valid.
+  /// invalidated entries are kept and served while the cache is configured
+  /// to allow stale results
+  double _invalidatedAt;
   QueryCacheResultEntry* _prev;
   QueryCacheResultEntry* _next;
   std::atomic<uint32_t> _refCount;
@@ -113,6 +131,14 @@ struct QueryCacheDatabaseEntry {
   /// cache
   void invalidate(std::string const&);
 
+  /// @brief invalidate all entries in the database-specific cache that
+  /// depend on a particular document of a collection
+  void invalidate(std::string const&, std::string const&);
+
+  /// @brief invalidate a single entry. if stale results are allowed, the
+  /// entry is only marked as invalidated and stays in the cache
+  void invalidateEntry(uint64_t);
+
   /// @brief enforce maximum number of results
   void enforceMaxResults(size_t);
 
@@ -134,6 +160,13 @@ struct QueryCacheDatabaseEntry {
   std::unordered_map<std::string, std::unordered_set<uint64_t>>
       _entriesByCollection;
 
+  /// @brief hash table that contains all query results that depend on
+  /// individual documents only. maps from collection names to document keys
+  /// to a set of query results as defined in _entriesByHash
+  std::unordered_map<std::string,
+                     std::unordered_map<std::string, std::unordered_set<uint64_t>>>
+      _entriesByKey;
+
   /// @brief beginning of linked list of result entries
   QueryCacheResultEntry* _head;
 
@@ -184,7 +217,10 @@ class QueryCache {
   /// query result!
   QueryCacheResultEntry* store(TRI_vocbase_t*, uint64_t, QueryString const&,
                                std::shared_ptr<arangodb::velocypack::Builder>,
-                               std::vector<std::string> const&);
+                               std::vector<std::string> const&,
+                               QueryCacheKeys const& = QueryCacheKeys(),
+                               QueryCacheRevisions const& =
+                                   QueryCacheRevisions());
 
   /// @brief invalidate all queries for the given collections
   void invalidate(TRI_vocbase_t*, std::vector<std::string> const&);
@@ -192,6 +228,9 @@ class QueryCache {
   /// @brief invalidate all queries for a particular collection
   void invalidate(TRI_vocbase_t*, std::string const&);
 
+  /// @brief invalidate all queries that depend on a particular document
+  void invalidate(TRI_vocbase_t*, std::string const&, std::string const&);
+
   /// @brief invalidate all queries for a particular database
   void invalidate(TRI_vocbase_t*);
 
@@ -214,6 +253,15 @@ class QueryCache {
   /// @brief sets the maximum number of elements in the cache
   void setMaxResults(size_t);
 
+  /// @brief return the maximum age (in milliseconds) of results that may be
+  /// served after they have been invalidated
+  uint64_t maxStaleness() const;
+
+  /// @brief sets the maximum age (in milliseconds) of results that may be
+  /// served after they have been invalidated. 0 means stale results are
+  /// never served
+  void setMaxStaleness(uint64_t);
+
   /// @brief enable or disable the query cache
   void setMode(QueryCacheMode);
 
@@ -43,9 +43,11 @@ QueryEntryCopy::QueryEntryCopy(TRI_voc_tick_t id,
                                std::string&& queryString, 
                                std::shared_ptr<arangodb::velocypack::Builder> bindParameters,
                                double started,
-                               double runTime, QueryExecutionState::ValueType state)
+                               double runTime, QueryExecutionState::ValueType state,
+                               QueryUsageStats const& usage,
+                               std::shared_ptr<arangodb::velocypack::Builder> snippets)
     : id(id), queryString(std::move(queryString)), bindParameters(bindParameters), 
-      started(started), runTime(runTime), state(state) {}
+      started(started), runTime(runTime), state(state), usage(usage), snippets(snippets) {}
 
 /// @brief create a query list
 QueryList::QueryList(TRI_vocbase_t*)
@@ -147,10 +149,40 @@ void QueryList::remove(Query* query) {
           }
         }
       }
+      // timeline of the parts of a cluster query, and the slowest of them
+      std::shared_ptr<VPackBuilder> snippets;
+      std::string slowestPart;
+      auto const& snippetStats = query->snippetStats();
+      if (!snippetStats.empty()) {
+        snippets = std::make_shared<VPackBuilder>();
+        snippets->openArray();
+        ExecutionSnippetStats const* slowest = nullptr;
+        for (auto const& it : snippetStats) {
+          snippets->openObject();
+          snippets->add("server", VPackValue(it.server));
+          snippets->add("shard", VPackValue(it.shard));
+          snippets->add("started", VPackValue(it.started));
+          snippets->add("runTime", VPackValue(it.runtime));
+          snippets->add("items", VPackValue(it.items));
+          snippets->close();
+          if (slowest == nullptr || it.runtime > slowest->runtime) {
+            slowest = &it;
+          }
+        }
+        snippets->close();
+        slowestPart.append(", slowest part: ");
+        slowestPart.append(slowest->server);
+        if (!slowest->shard.empty()) {
+          slowestPart.append(" (").append(slowest->shard).append(")");
+        }
+      }
+
+      QueryUsageStats const usage = query->usageStats();
+
       if (loadTime >= 0.1) {
-        LOG_TOPIC(WARN, Logger::QUERIES) << "slow query: '" << q << bindParameters << ", took: " << Logger::FIXED(now - started) << ", loading took: " << Logger::FIXED(loadTime);
+        LOG_TOPIC(WARN, Logger::QUERIES) << "slow query: '" << q << bindParameters << ", took: " << Logger::FIXED(now - started) << ", loading took: " << Logger::FIXED(loadTime) << usage.toString() << slowestPart;
       } else {
-        LOG_TOPIC(WARN, Logger::QUERIES) << "slow query: '" << q << bindParameters << ", took: " << Logger::FIXED(now - started);
+        LOG_TOPIC(WARN, Logger::QUERIES) << "slow query: '" << q << bindParameters << ", took: " << Logger::FIXED(now - started) << usage.toString() << slowestPart;
       }
 
       _slow.emplace_back(QueryEntryCopy(
@@ -158,7 +190,7 @@ void QueryList::remove(Query* query) {
           std::move(q),
           _trackBindVars ? query->bindParameters() : nullptr,
           started, now - started,
-          QueryExecutionState::ValueType::FINISHED));
+          QueryExecutionState::ValueType::FINISHED, usage, snippets));
 
       if (++_slowCount > _maxSlowQueries) {
         // free first element
@@ -239,7 +271,7 @@ std::vector<QueryEntryCopy> QueryList::listCurrent() {
                          extractQueryString(query, maxLength),
                          _trackBindVars ? query->bindParameters() : nullptr,
                          started, now - started,
-                         query->state()));
+                         query->state(), query->usageStats()));
     }
   }
 
@@ -26,6 +26,7 @@
 
 #include "Basics/Common.h"
 #include "Aql/QueryExecutionState.h"
+#include "Aql/QueryUsage.h"
 #include "Basics/ReadWriteLock.h"
 #include "VocBase/voc-types.h"
 
@@ -48,7 +49,9 @@ struct QueryEntryCopy {
                   std::shared_ptr<arangodb::velocypack::Builder> bindParameters,
                   double started,
                   double runTime,
-                  QueryExecutionState::ValueType state);
+                  QueryExecutionState::ValueType state,
+                  QueryUsageStats const& usage,
+                  std::shared_ptr<arangodb::velocypack::Builder> snippets = nullptr);
 
   TRI_voc_tick_t const id;
   std::string const queryString;
@@ -56,6 +59,10 @@ struct QueryEntryCopy {
   double const started;
   double const runTime;
   QueryExecutionState::ValueType const state;
+  /// @brief memory, CPU time, rows and reads of the query
+  QueryUsageStats const usage;
+  /// @brief timings of the query parts that ran on DB servers, if any
+  std::shared_ptr<arangodb::velocypack::Builder> const snippets;
 };
 
 class QueryList {
@@ -35,12 +35,15 @@ using namespace arangodb::aql;
   
 QueryOptions::QueryOptions() :
       memoryLimit(0),
+      sortSpillThreshold(0),
+      collectSpillThreshold(0),
       maxNumberOfPlans(0),
       maxWarningCount(10),
       literalSizeThreshold(-1),
       tracing(0),
       satelliteSyncWait(60.0),
-      profile(false),
+      maxStaleness(0.0),
+      profile(0),
       allPlans(false),
       verbosePlans(false),
       silent(false),
@@ -61,6 +64,12 @@ QueryOptions::QueryOptions() :
     memoryLimit = globalLimit;
   }
 
+  // use global spill threshold for sorts
+  sortSpillThreshold = q->sortSpillThreshold();
+
+  // use global spill threshold for hashed collects
+  collectSpillThreshold = q->collectSpillThreshold();
+
   // use global "failOnWarning" value
   failOnWarning = q->failOnWarning();
 
@@ -84,6 +93,14 @@ void QueryOptions::fromVelocyPack(VPackSlice const& slice) {
       memoryLimit = v;
     }
   }
+  value = slice.get("sortSpillThreshold"); 
+  if (value.isNumber()) {
+    sortSpillThreshold = value.getNumber<size_t>();
+  }
+  value = slice.get("collectSpillThreshold"); 
+  if (value.isNumber()) {
+    collectSpillThreshold = value.getNumber<size_t>();
+  }
   value = slice.get("maxNumberOfPlans"); 
   if (value.isNumber()) {
     maxNumberOfPlans = value.getNumber<size_t>();
@@ -107,12 +124,19 @@ void QueryOptions::fromVelocyPack(VPackSlice const& slice) {
   if (value.isNumber()) {
     satelliteSyncWait = value.getNumber<double>();
   }
+  value = slice.get("maxStaleness");
+  if (value.isNumber()) {
+    maxStaleness = value.getNumber<double>();
+  }
+  value = slice.get("profile");
+  if (value.isNumber()) {
+    profile = value.getNumber<int64_t>();
+  } else if (value.isBool()) {
+    // "profile: true" means profiling the query phases only
+    profile = value.getBool() ? 1 : 0;
+  }
 
   // boolean options 
-  value = slice.get("profile");
-  if (value.isBool()) {
-    profile = value.getBool();
-  } 
   value = slice.get("allPlans");
   if (value.isBool()) {
     allPlans = value.getBool();
@@ -181,11 +205,14 @@ void QueryOptions::toVelocyPack(VPackBuilder& builder, bool disableOptimizerRule
   builder.openObject();
 
   builder.add("memoryLimit", VPackValue(memoryLimit));
+  builder.add("sortSpillThreshold", VPackValue(sortSpillThreshold));
+  builder.add("collectSpillThreshold", VPackValue(collectSpillThreshold));
   builder.add("maxNumberOfPlans", VPackValue(maxNumberOfPlans));
   builder.add("maxWarningCount", VPackValue(maxWarningCount));
   builder.add("literalSizeThreshold", VPackValue(literalSizeThreshold));
   builder.add("tracing", VPackValue(tracing));
   builder.add("satelliteSyncWait", VPackValue(satelliteSyncWait));
+  builder.add("maxStaleness", VPackValue(maxStaleness));
   builder.add("profile", VPackValue(profile));
   builder.add("allPlans", VPackValue(allPlans));
   builder.add("verbosePlans", VPackValue(verbosePlans));
@@ -42,12 +42,19 @@ struct QueryOptions {
   void toVelocyPack(arangodb::velocypack::Builder&, bool disableOptimizerRules) const;
 
   size_t memoryLimit;
+  size_t sortSpillThreshold;
+  size_t collectSpillThreshold;
   size_t maxNumberOfPlans;
   size_t maxWarningCount;
   int64_t literalSizeThreshold;
   int64_t tracing;
   double satelliteSyncWait;
-  bool profile;
+  // milliseconds the results of a read-only query may lag behind the shard
+  // leaders. if positive, in-sync followers may execute parts of it
+  double maxStaleness;
+  // 0 = off, 1 = profile query phases, 2 = additionally profile every
+  // execution node
+  int64_t profile;
   bool allPlans;
   bool verbosePlans;
   bool silent;
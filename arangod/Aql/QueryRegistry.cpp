@@ -23,40 +23,47 @@
 
 #include "QueryRegistry.h"
 #include "Aql/ExecutionEngine.h"
+#include "Aql/PlanCache.h"
 #include "Aql/Query.h"
 #include "Basics/ReadLocker.h"
 #include "Basics/WriteLocker.h"
 #include "Cluster/CollectionLockState.h"
 #include "Logger/Logger.h"
 #include "Transaction/Methods.h"
+#include "VocBase/ticks.h"
 
 using namespace arangodb;
 using namespace arangodb::aql;
 
+constexpr size_t PreparedQuery::MaxPlans;
+constexpr size_t QueryRegistry::MaxPrepared;
+
+PreparedQuery::PreparedQuery(
+    std::string&& queryString,
+    std::shared_ptr<arangodb::velocypack::Builder> options,
+    std::vector<std::string>&& bindParameters, double timeToLive)
+    : queryString(std::move(queryString)),
+      options(std::move(options)),
+      bindParameters(std::move(bindParameters)),
+      plans(std::make_shared<PlanCache>()),
+      planInvalidations(PlanCache::instance()->invalidations()),
+      timeToLive(timeToLive),
+      expires(0.0) {
+  plans->setMaxEntries(MaxPlans);
+}
+
 QueryRegistry::~QueryRegistry() {
   std::vector<std::pair<std::string, QueryId>> toDelete;
 
-  {
-    WRITE_LOCKER(writeLocker, _lock);
-
-    try {
-      for (auto& x : _queries) {
-        // x.first is a TRI_vocbase_t* and
-        // x.second is a std::unordered_map<QueryId, QueryInfo*>
-        for (auto& y : x.second) {
-          // y.first is a QueryId and
-          // y.second is a QueryInfo*
-          toDelete.emplace_back(x.first, y.first);
-        }
-      }
-    } catch (...) {
-      // the emplace_back() above might fail
-      // prevent throwing exceptions in the destructor
-    }
+  try {
+    toDelete = allQueries();
+  } catch (...) {
+    // the emplace_back() in allQueries() might fail
+    // prevent throwing exceptions in the destructor
   }
 
-  // note: destroy() will acquire _lock itself, so it must be called without
-  // holding the lock
+  // note: destroy() will acquire the shard locks itself, so it must be
+  // called without holding them
   for (auto& p : toDelete) {
     try {  // just in case
       destroy(p.first, p.second, TRI_ERROR_TRANSACTION_ABORTED);
@@ -70,15 +77,16 @@ void QueryRegistry::insert(QueryId id, Query* query, double ttl) {
   TRI_ASSERT(query != nullptr);
   TRI_ASSERT(query->trx() != nullptr);
   auto vocbase = query->vocbase();
+  Shard& shard = shardFor(id);
 
-  WRITE_LOCKER(writeLocker, _lock);
+  WRITE_LOCKER(writeLocker, shard.lock);
 
-  auto m = _queries.find(vocbase->name());
-  if (m == _queries.end()) {
-    m = _queries.emplace(vocbase->name(),
-                         std::unordered_map<QueryId, QueryInfo*>()).first;
+  auto m = shard.queries.find(vocbase->name());
+  if (m == shard.queries.end()) {
+    m = shard.queries.emplace(vocbase->name(),
+                              std::unordered_map<QueryId, QueryInfo*>()).first;
 
-    TRI_ASSERT(_queries.find(vocbase->name()) != _queries.end());
+    TRI_ASSERT(shard.queries.find(vocbase->name()) != shard.queries.end());
   }
   auto q = m->second.find(id);
   if (q == m->second.end()) {
@@ -92,8 +100,8 @@ void QueryRegistry::insert(QueryId id, Query* query, double ttl) {
     m->second.emplace(id, p.get());
     p.release();
 
-    TRI_ASSERT(_queries.find(vocbase->name())->second.find(id) !=
-                         _queries.find(vocbase->name())->second.end());
+    TRI_ASSERT(shard.queries.find(vocbase->name())->second.find(id) !=
+               shard.queries.find(vocbase->name())->second.end());
 
     // If we have set _noLockHeaders, we need to unset it:
     if (CollectionLockState::_noLockHeaders != nullptr) {
@@ -114,10 +122,14 @@ void QueryRegistry::insert(QueryId id, Query* query, double ttl) {
 /// @brief open
 Query* QueryRegistry::open(TRI_vocbase_t* vocbase, QueryId id) {
   // std::cout << "Taking out query with ID " << id << std::endl;
-  WRITE_LOCKER(writeLocker, _lock);
+  Shard& shard = shardFor(id);
 
-  auto m = _queries.find(vocbase->name());
-  if (m == _queries.end()) {
+  // the read lock keeps the query from being destroyed, and the _isOpen
+  // flag keeps other threads from opening it at the same time
+  READ_LOCKER(readLocker, shard.lock);
+
+  auto m = shard.queries.find(vocbase->name());
+  if (m == shard.queries.end()) {
     return nullptr;
   }
   auto q = m->second.find(id);
@@ -125,11 +137,11 @@ Query* QueryRegistry::open(TRI_vocbase_t* vocbase, QueryId id) {
     return nullptr;
   }
   QueryInfo* qi = q->second;
-  if (qi->_isOpen) {
+  bool expected = false;
+  if (!qi->_isOpen.compare_exchange_strong(expected, true)) {
     THROW_ARANGO_EXCEPTION_MESSAGE(
         TRI_ERROR_INTERNAL, "query with given vocbase and id is already open");
   }
-  qi->_isOpen = true;
 
   // If we had set _noLockHeaders, we need to reset it:
   if (qi->_query->engine()->lockedShards() != nullptr) {
@@ -147,12 +159,14 @@ Query* QueryRegistry::open(TRI_vocbase_t* vocbase, QueryId id) {
 /// @brief close
 void QueryRegistry::close(TRI_vocbase_t* vocbase, QueryId id, double ttl) {
   // std::cout << "Returning query with ID " << id << std::endl;
-  WRITE_LOCKER(writeLocker, _lock);
+  Shard& shard = shardFor(id);
+
+  READ_LOCKER(readLocker, shard.lock);
 
-  auto m = _queries.find(vocbase->name());
-  if (m == _queries.end()) {
-    m = _queries.emplace(vocbase->name(),
-                         std::unordered_map<QueryId, QueryInfo*>()).first;
+  auto m = shard.queries.find(vocbase->name());
+  if (m == shard.queries.end()) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL,
+                                   "query with given vocbase and id not found");
   }
   auto q = m->second.find(id);
   if (q == m->second.end()) {
@@ -160,7 +174,7 @@ void QueryRegistry::close(TRI_vocbase_t* vocbase, QueryId id, double ttl) {
                                    "query with given vocbase and id not found");
   }
   QueryInfo* qi = q->second;
-  if (!qi->_isOpen) {
+  if (!qi->_isOpen.load()) {
     THROW_ARANGO_EXCEPTION_MESSAGE(
         TRI_ERROR_INTERNAL, "query with given vocbase and id is not open");
   }
@@ -171,33 +185,30 @@ void QueryRegistry::close(TRI_vocbase_t* vocbase, QueryId id, double ttl) {
         qi->_query->engine()->lockedShards()) {
       // std::cout << "Resetting _noLockHeaders to nullptr\n";
       CollectionLockState::_noLockHeaders = nullptr;
-    } else {
-      if (CollectionLockState::_noLockHeaders != nullptr) {
-        if (CollectionLockState::_noLockHeaders ==
-            qi->_query->engine()->lockedShards()) {
-          CollectionLockState::_noLockHeaders = nullptr;
-        }
-        // else {
-        // We have not set it, just leave it alone. This happens in particular
-        // on the DBServers, who do not set lockedShards() themselves.
-        // }
-      }
     }
+    // else {
+    // We have not set it, just leave it alone. This happens in particular
+    // on the DBServers, who do not set lockedShards() themselves.
+    // }
   }
 
-  qi->_isOpen = false;
+  // _expires is only read under the write lock, so it can be set before
+  // the query is released to other threads
   qi->_expires = TRI_microtime() + qi->_timeToLive;
+  qi->_isOpen.store(false);
 }
 
 /// @brief destroy
 void QueryRegistry::destroy(std::string const& vocbase, QueryId id,
                             int errorCode) {
-  WRITE_LOCKER(writeLocker, _lock);
+  Shard& shard = shardFor(id);
 
-  auto m = _queries.find(vocbase);
-  if (m == _queries.end()) {
-    m = _queries.emplace(vocbase, std::unordered_map<QueryId, QueryInfo*>())
-            .first;
+  WRITE_LOCKER(writeLocker, shard.lock);
+
+  auto m = shard.queries.find(vocbase);
+  if (m == shard.queries.end()) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL,
+                                   "query with given vocbase and id not found");
   }
   auto q = m->second.find(id);
   if (q == m->second.end()) {
@@ -206,22 +217,19 @@ void QueryRegistry::destroy(std::string const& vocbase, QueryId id,
   }
   QueryInfo* qi = q->second;
 
-  if (qi->_isOpen) {
+  if (qi->_isOpen.load()) {
     qi->_query->killed(true);
     return;
   }
 
-  // If the query is open, we can delete it right away, if not, we need
-  // to register the transaction with the current context and adjust
-  // the debugging counters for transactions:
-  if (!qi->_isOpen) {
-    // If we had set _noLockHeaders, we need to reset it:
-    if (qi->_query->engine()->lockedShards() != nullptr) {
-      if (CollectionLockState::_noLockHeaders == nullptr) {
-        CollectionLockState::_noLockHeaders = qi->_query->engine()->lockedShards();
-      } else {
-        LOG_TOPIC(WARN, arangodb::Logger::FIXME) << "Found strange lockedShards in thread, not overwriting!";
-      }
+  // The query is not open, so we need to register the transaction with the
+  // current context before we delete it.
+  // If we had set _noLockHeaders, we need to reset it:
+  if (qi->_query->engine()->lockedShards() != nullptr) {
+    if (CollectionLockState::_noLockHeaders == nullptr) {
+      CollectionLockState::_noLockHeaders = qi->_query->engine()->lockedShards();
+    } else {
+      LOG_TOPIC(WARN, arangodb::Logger::FIXME) << "Found strange lockedShards in thread, not overwriting!";
     }
   }
 
@@ -243,21 +251,117 @@ void QueryRegistry::destroy(TRI_vocbase_t* vocbase, QueryId id, int errorCode) {
   destroy(vocbase->name(), id, errorCode);
 }
 
+/// @brief insertPrepared
+QueryId QueryRegistry::insertPrepared(std::string const& vocbase,
+                                      std::shared_ptr<PreparedQuery> prepared) {
+  TRI_ASSERT(prepared != nullptr);
+
+  if (_numberPrepared.fetch_add(1) >= MaxPrepared) {
+    _numberPrepared.fetch_sub(1);
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_RESOURCE_LIMIT,
+                                   "too many prepared queries");
+  }
+
+  QueryId id = TRI_NewTickServer();
+  prepared->expires = TRI_microtime() + prepared->timeToLive;
+  Shard& shard = shardFor(id);
+
+  try {
+    WRITE_LOCKER(writeLocker, shard.lock);
+    shard.prepared[vocbase].emplace(id, std::move(prepared));
+  } catch (...) {
+    _numberPrepared.fetch_sub(1);
+    throw;
+  }
+  return id;
+}
+
+/// @brief insertPrepared
+QueryId QueryRegistry::insertPrepared(TRI_vocbase_t* vocbase,
+                                      std::shared_ptr<PreparedQuery> prepared) {
+  return insertPrepared(vocbase->name(), std::move(prepared));
+}
+
+/// @brief lookupPrepared
+std::shared_ptr<PreparedQuery const> QueryRegistry::lookupPrepared(
+    std::string const& vocbase, QueryId id) {
+  Shard& shard = shardFor(id);
+
+  WRITE_LOCKER(writeLocker, shard.lock);
+
+  auto m = shard.prepared.find(vocbase);
+  if (m == shard.prepared.end()) {
+    return nullptr;
+  }
+  auto q = m->second.find(id);
+  if (q == m->second.end()) {
+    return nullptr;
+  }
+
+  auto& prepared = q->second;
+  uint64_t const invalidations = PlanCache::instance()->invalidations();
+  if (prepared->planInvalidations != invalidations) {
+    // collections or indexes may have changed since the plans were made
+    prepared->plans->clear();
+    prepared->planInvalidations = invalidations;
+  }
+
+  prepared->expires = TRI_microtime() + prepared->timeToLive;
+  return prepared;
+}
+
+/// @brief lookupPrepared
+std::shared_ptr<PreparedQuery const> QueryRegistry::lookupPrepared(
+    TRI_vocbase_t* vocbase, QueryId id) {
+  return lookupPrepared(vocbase->name(), id);
+}
+
+/// @brief destroyPrepared
+bool QueryRegistry::destroyPrepared(std::string const& vocbase, QueryId id) {
+  Shard& shard = shardFor(id);
+
+  WRITE_LOCKER(writeLocker, shard.lock);
+
+  auto m = shard.prepared.find(vocbase);
+  if (m == shard.prepared.end() || m->second.erase(id) == 0) {
+    return false;
+  }
+  _numberPrepared.fetch_sub(1);
+  return true;
+}
+
+/// @brief destroyPrepared
+bool QueryRegistry::destroyPrepared(TRI_vocbase_t* vocbase, QueryId id) {
+  return destroyPrepared(vocbase->name(), id);
+}
+
 /// @brief expireQueries
 void QueryRegistry::expireQueries() {
   double now = TRI_microtime();
   std::vector<std::pair<std::string, QueryId>> toDelete;
 
-  {
-    WRITE_LOCKER(writeLocker, _lock);
-    for (auto& x : _queries) {
+  for (auto& shard : _shards) {
+    // the write lock is needed to read the expiration times, which closing
+    // threads set under the read lock
+    WRITE_LOCKER(writeLocker, shard.lock);
+    for (auto& x : shard.prepared) {
+      for (auto it = x.second.begin(); it != x.second.end();) {
+        if (now > it->second->expires) {
+          it = x.second.erase(it);
+          _numberPrepared.fetch_sub(1);
+        } else {
+          ++it;
+        }
+      }
+    }
+    for (auto& x : shard.queries) {
       // x.first is a TRI_vocbase_t* and
       // x.second is a std::unordered_map<QueryId, QueryInfo*>
       for (auto& y : x.second) {
         // y.first is a QueryId and
         // y.second is a QueryInfo*
         QueryInfo*& qi = y.second;
-        if (!qi->_isOpen && now > qi->_expires) {
+        if (!qi->_isOpen.load() && now > qi->_expires) {
           toDelete.emplace_back(x.first, y.first);
         }
       }
@@ -274,26 +378,20 @@ void QueryRegistry::expireQueries() {
 
 /// @brief return number of registered queries
 size_t QueryRegistry::numberRegisteredQueries() {
-  READ_LOCKER(readLocker, _lock);
   size_t sum = 0;
-  for (auto const&m : _queries) {
-    sum += m.second.size();
+  for (auto& shard : _shards) {
+    READ_LOCKER(readLocker, shard.lock);
+    for (auto const& m : shard.queries) {
+      sum += m.second.size();
+    }
   }
   return sum;
 }
 
 /// @brief for shutdown, we need to shut down all queries:
 void QueryRegistry::destroyAll() {
-  std::vector<std::pair<std::string, QueryId>> allQueries;
-  {
-    READ_LOCKER(readlock, _lock);
-    for (auto& p : _queries) {
-      for (auto& q : p.second) {
-        allQueries.emplace_back(p.first, q.first);
-      }
-    }
-  }
-  for (auto& p : allQueries) {
+  std::vector<std::pair<std::string, QueryId>> queries = allQueries();
+  for (auto& p : queries) {
     try {
       destroy(p.first, p.second, TRI_ERROR_SHUTTING_DOWN);
     } catch (...) {
@@ -301,3 +399,17 @@ void QueryRegistry::destroyAll() {
     }
   }
 }
+
+/// @brief the vocbase names and ids of all registered queries
+std::vector<std::pair<std::string, QueryId>> QueryRegistry::allQueries() {
+  std::vector<std::pair<std::string, QueryId>> result;
+  for (auto& shard : _shards) {
+    READ_LOCKER(readLocker, shard.lock);
+    for (auto const& p : shard.queries) {
+      for (auto const& q : p.second) {
+        result.emplace_back(p.first, q.first);
+      }
+    }
+  }
+  return result;
+}
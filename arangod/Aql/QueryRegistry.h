@@ -28,15 +28,52 @@
 #include "Basics/ReadWriteLock.h"
 #include "Aql/types.h"
 
+#include <atomic>
+
 struct TRI_vocbase_t;
 
 namespace arangodb {
+namespace velocypack {
+class Builder;
+}
+
 namespace aql {
+class PlanCache;
 class Query;
 
+/// @brief a prepared statement: a validated query string with its options,
+/// which can be executed repeatedly with different bind parameters
+struct PreparedQuery {
+  /// @brief maximum number of optimized plans kept for a statement
+  static constexpr size_t MaxPlans = 16;
+
+  PreparedQuery(std::string&& queryString,
+                std::shared_ptr<arangodb::velocypack::Builder> options,
+                std::vector<std::string>&& bindParameters, double timeToLive);
+
+  std::string const queryString;
+  /// @brief the attributes of the prepare request other than the query,
+  /// used as defaults for the executions
+  std::shared_ptr<arangodb::velocypack::Builder> const options;
+  /// @brief names of the bind parameters used by the query
+  std::vector<std::string> const bindParameters;
+  /// @brief the optimized plans of the statement. the optimizer replaces
+  /// bind parameters with their values, so there is one plan per set of
+  /// values, looked up like in the global plan cache
+  std::shared_ptr<PlanCache> const plans;
+  /// @brief PlanCache::instance()->invalidations() when the plans were last
+  /// checked. protected by the registry's lock
+  uint64_t planInvalidations;
+  double const timeToLive;  // in seconds
+  double expires;           // UNIX UTC timestamp of expiration
+};
+
 class QueryRegistry {
  public:
-  QueryRegistry() {}
+  /// @brief maximum number of prepared statements of all databases
+  static constexpr size_t MaxPrepared = 4096;
+
+  QueryRegistry() : _numberPrepared(0) {}
 
   ~QueryRegistry();
 
@@ -73,7 +110,38 @@ class QueryRegistry {
 
   void destroy(TRI_vocbase_t* vocbase, QueryId id, int errorCode);
 
-  /// @brief expireQueries, this deletes all expired queries from the registry
+  /// @brief insertPrepared, registers a prepared statement for the vocbase
+  /// and returns its id. The statement is removed if it is not executed for
+  /// its time to live. Throws if there are MaxPrepared statements already
+  QueryId insertPrepared(std::string const& vocbase,
+                         std::shared_ptr<PreparedQuery> prepared);
+
+  QueryId insertPrepared(TRI_vocbase_t* vocbase,
+                         std::shared_ptr<PreparedQuery> prepared);
+
+  /// @brief lookupPrepared, returns the prepared statement with the given id
+  /// or a nullptr and extends its lifetime. The statement stays valid for
+  /// the caller even if it is destroyed concurrently. Its plans are dropped
+  /// if the plan cache was invalidated since the last lookup
+  std::shared_ptr<PreparedQuery const> lookupPrepared(
+      std::string const& vocbase, QueryId id);
+
+  std::shared_ptr<PreparedQuery const> lookupPrepared(TRI_vocbase_t* vocbase,
+                                                      QueryId id);
+
+  /// @brief destroyPrepared, removes a prepared statement, returns false if
+  /// there is none with the given id
+  bool destroyPrepared(std::string const& vocbase, QueryId id);
+
+  bool destroyPrepared(TRI_vocbase_t* vocbase, QueryId id);
+
+  /// @brief return number of prepared statements
+  size_t numberPrepared() const {
+    return _numberPrepared.load(std::memory_order_relaxed);
+  }
+
+  /// @brief expireQueries, this deletes all expired queries and prepared
+  /// statements from the registry
   void expireQueries();
 
   /// @brief return number of registered queries
@@ -88,18 +156,45 @@ class QueryRegistry {
     TRI_vocbase_t* _vocbase;  // the vocbase
     QueryId _id;              // id of the query
     Query* _query;            // the actual query pointer
-    bool _isOpen;             // flag indicating whether or not the query
-                              // is in use
+    std::atomic<bool> _isOpen;  // flag indicating whether or not the query
+                                // is in use
     double _timeToLive;       // in seconds
-    double _expires;          // UNIX UTC timestamp of expiration
+    double _expires;          // UNIX UTC timestamp of expiration, only
+                              // changed by the thread that has the query open
   };
 
-  /// @brief _queries, the actual map of maps for the registry
-  std::unordered_map<std::string, std::unordered_map<QueryId, QueryInfo*>>
-      _queries;
+  /// @brief number of independently locked parts of the registry. queries
+  /// and prepared statements are assigned to a shard by their id
+  static constexpr size_t NumberOfShards = 16;
+
+  /// @brief one part of the registry. opening and closing a query only
+  /// needs the read lock of its shard, the _isOpen flag of the query makes
+  /// sure only one thread has it open. inserting and destroying queries
+  /// needs the write lock
+  struct Shard {
+    /// @brief the actual map of maps for the queries of this shard
+    std::unordered_map<std::string, std::unordered_map<QueryId, QueryInfo*>>
+        queries;
+
+    /// @brief the prepared statements of this shard per vocbase
+    std::unordered_map<
+        std::string,
+        std::unordered_map<QueryId, std::shared_ptr<PreparedQuery>>>
+        prepared;
+
+    /// @brief the read/write lock for access
+    basics::ReadWriteLock lock;
+  };
+
+  Shard& shardFor(QueryId id) { return _shards[id % NumberOfShards]; }
+
+  /// @brief the vocbase names and ids of all registered queries
+  std::vector<std::pair<std::string, QueryId>> allQueries();
+
+  Shard _shards[NumberOfShards];
 
-  /// @brief _lock, the read/write lock for access
-  basics::ReadWriteLock _lock;
+  /// @brief number of prepared statements in all shards
+  std::atomic<size_t> _numberPrepared;
 };
 
 }  // namespace arangodb::aql
@@ -33,6 +33,11 @@ using namespace arangodb::aql;
 namespace {
 /// @brief empty string singleton
 static char const* EmptyString = "";
+
+/// @brief number of nodes in the first arena block. each further block
+/// doubles the size of the previous one, up to MaxNodesPerBlock
+static constexpr size_t MinNodesPerBlock = 64;
+static constexpr size_t MaxNodesPerBlock = 4096;
 }
 
 QueryResources::QueryResources(ResourceMonitor* resourceMonitor)
@@ -54,12 +59,22 @@ QueryResources::~QueryResources() {
   }
   
   _resourceMonitor->decreaseMemoryUsage(_nodes.size() * sizeof(AstNode) + _nodes.capacity() * sizeof(AstNode*));
+
+  // destroy arena nodes and release their blocks at once
+  for (auto& block : _nodeBlocks) {
+    for (size_t i = 0; i < block.used; ++i) {
+      block.nodes[i].~AstNode();
+    }
+    ::operator delete(block.nodes);
+    _resourceMonitor->decreaseMemoryUsage(block.capacity * sizeof(AstNode));
+  }
 }
 
 // TODO: FIXME
 void QueryResources::steal() {
   _strings.clear();
   _nodes.clear();
+  _nodeBlocks.clear();
 }
   
 /// @brief add a node to the list of nodes
@@ -91,6 +106,34 @@ void QueryResources::addNode(AstNode* node) {
   _nodes.emplace_back(node); 
 }
 
+/// @brief create a node in the node arena
+AstNode* QueryResources::createNode(AstNodeType type) {
+  if (_nodeBlocks.empty() ||
+      _nodeBlocks.back().used == _nodeBlocks.back().capacity) {
+    size_t capacity = MinNodesPerBlock;
+    if (!_nodeBlocks.empty()) {
+      capacity = (std::min)(2 * _nodeBlocks.back().capacity, MaxNodesPerBlock);
+    }
+
+    _nodeBlocks.reserve(_nodeBlocks.size() + 1);
+    // may throw
+    _resourceMonitor->increaseMemoryUsage(capacity * sizeof(AstNode));
+    try {
+      auto nodes = static_cast<AstNode*>(::operator new(capacity * sizeof(AstNode)));
+      // will not fail
+      _nodeBlocks.emplace_back(NodeBlock{nodes, capacity, 0});
+    } catch (...) {
+      _resourceMonitor->decreaseMemoryUsage(capacity * sizeof(AstNode));
+      throw;
+    }
+  }
+
+  NodeBlock& block = _nodeBlocks.back();
+  AstNode* node = new (block.nodes + block.used) AstNode(type);
+  ++block.used;
+  return node;
+}
+
 /// @brief register a string
 /// the string is freed when the query is destroyed
 char* QueryResources::registerString(char const* p, size_t length) {
@@ -31,6 +31,7 @@ namespace arangodb {
 namespace aql {
 
 struct AstNode;
+enum AstNodeType : uint32_t;
 struct ResourceMonitor;
 
 class QueryResources {
@@ -46,6 +47,11 @@ class QueryResources {
    
   /// @brief add a node to the list of nodes
   void addNode(AstNode*);
+
+  /// @brief create a node in the node arena. the node is destroyed when the
+  /// query is destroyed, and its memory is released together with the
+  /// other nodes of its arena block
+  AstNode* createNode(AstNodeType);
   
   /// @brief register a string
   /// the string is freed when the query is destroyed
@@ -64,12 +70,22 @@ class QueryResources {
  private:
   char* registerLongString(char* copy, size_t length);
 
+  /// @brief a contiguous block of memory for AST nodes
+  struct NodeBlock {
+    AstNode* nodes;
+    size_t capacity;
+    size_t used;
+  };
+
  private:
   ResourceMonitor* _resourceMonitor;
    
   /// @brief all nodes created in the AST - will be used for freeing them later
   std::vector<AstNode*> _nodes;
 
+  /// @brief arena blocks holding the nodes created via createNode
+  std::vector<NodeBlock> _nodeBlocks;
+
   /// @brief strings created in the query - used for easy memory deallocation
   std::vector<char*> _strings;
   
@@ -65,6 +65,9 @@ struct QueryResult {
   std::shared_ptr<arangodb::velocypack::Builder> result;
   std::shared_ptr<arangodb::velocypack::Builder> stats;
   std::shared_ptr<arangodb::velocypack::Builder> profile;
+  /// @brief the executed plan with per-node statistics, only set if the
+  /// query was profiled per node
+  std::shared_ptr<arangodb::velocypack::Builder> plan;
   std::shared_ptr<transaction::Context> context;
 };
 }
@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "QueryUsage.h"
+#include "Aql/ExecutionStats.h"
+#include "Basics/StringUtils.h"
+
+#include <rocksdb/perf_context.h>
+#include <rocksdb/perf_level.h>
+#include <velocypack/Builder.h>
+#include <velocypack/velocypack-aliases.h>
+
+#include <time.h>
+
+using namespace arangodb;
+using namespace arangodb::aql;
+
+/// @brief CPU time of the current thread, in nanoseconds
+static uint64_t ThreadCpuTime() {
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+    return 0;
+  }
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL +
+         static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void QueryUsageStats::toVelocyPack(VPackBuilder& builder) const {
+  builder.add("memoryUsage", VPackValue(memoryUsage));
+  builder.add("peakMemoryUsage", VPackValue(peakMemoryUsage));
+  builder.add("cpuTime", VPackValue(cpuTime));
+  builder.add("rowsProcessed", VPackValue(rowsProcessed));
+  builder.add("blockReads", VPackValue(blockReads));
+}
+
+std::string QueryUsageStats::toString() const {
+  std::string result(", cpu time: ");
+  result.append(basics::StringUtils::ftoa(cpuTime));
+  result.append(", peak memory: ");
+  result.append(std::to_string(peakMemoryUsage));
+  result.append(", rows: ");
+  result.append(std::to_string(rowsProcessed));
+  result.append(", block reads: ");
+  result.append(std::to_string(blockReads));
+  return result;
+}
+
+QueryUsageTracker::QueryUsageTracker(QueryUsage& usage,
+                                     ExecutionStats const& stats)
+    : _usage(usage),
+      _stats(stats),
+      _cpuTime(ThreadCpuTime()),
+      _perfLevel(static_cast<int>(rocksdb::GetPerfLevel())) {
+  // the perf context is thread-local, counting its reads is cheap
+  if (_perfLevel < static_cast<int>(rocksdb::PerfLevel::kEnableCount)) {
+    rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableCount);
+  }
+  _blockReads = rocksdb::get_perf_context()->block_read_count;
+}
+
+QueryUsageTracker::~QueryUsageTracker() {
+  uint64_t const cpuTime = ThreadCpuTime();
+  if (cpuTime > _cpuTime) {
+    _usage.cpuTime.fetch_add(cpuTime - _cpuTime, std::memory_order_relaxed);
+  }
+
+  uint64_t const blockReads = rocksdb::get_perf_context()->block_read_count;
+  if (blockReads > _blockReads) {
+    _usage.blockReads.fetch_add(blockReads - _blockReads,
+                                std::memory_order_relaxed);
+  }
+  if (_perfLevel < static_cast<int>(rocksdb::PerfLevel::kEnableCount)) {
+    rocksdb::SetPerfLevel(static_cast<rocksdb::PerfLevel>(_perfLevel));
+  }
+
+  _usage.rowsProcessed.store(
+      static_cast<uint64_t>(_stats.scannedFull + _stats.scannedIndex),
+      std::memory_order_relaxed);
+}
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_AQL_QUERY_USAGE_H
+#define ARANGOD_AQL_QUERY_USAGE_H 1
+
+#include "Basics/Common.h"
+
+#include <atomic>
+
+namespace arangodb {
+namespace velocypack {
+class Builder;
+}
+
+namespace aql {
+struct ExecutionStats;
+
+/// @brief resources a query used so far. the counters are updated by the
+/// threads executing the query and read by the ones listing running queries
+struct QueryUsage {
+  QueryUsage() : cpuTime(0), rowsProcessed(0), blockReads(0) {}
+
+  /// @brief CPU time of the executing threads, in nanoseconds
+  std::atomic<uint64_t> cpuTime;
+  /// @brief documents read by full collection scans and index lookups
+  std::atomic<uint64_t> rowsProcessed;
+  /// @brief block reads of RocksDB, which hit the disk or the OS page cache
+  std::atomic<uint64_t> blockReads;
+};
+
+/// @brief copy of the resources of a query, for the lists of running and
+/// slow queries
+struct QueryUsageStats {
+  size_t memoryUsage = 0;
+  size_t peakMemoryUsage = 0;
+  double cpuTime = 0.0;
+  uint64_t rowsProcessed = 0;
+  uint64_t blockReads = 0;
+
+  /// @brief adds the values to an open object
+  void toVelocyPack(arangodb::velocypack::Builder&) const;
+
+  /// @brief appends the values to a log message
+  std::string toString() const;
+};
+
+/// @brief measures the CPU time and block reads of the current thread while
+/// it executes a part of a query, and adds them to the usage of the query.
+/// the number of processed rows is taken from the engine's statistics
+class QueryUsageTracker {
+ public:
+  QueryUsageTracker(QueryUsage& usage, ExecutionStats const& stats);
+  ~QueryUsageTracker();
+
+  QueryUsageTracker(QueryUsageTracker const&) = delete;
+  QueryUsageTracker& operator=(QueryUsageTracker const&) = delete;
+
+ private:
+  QueryUsage& _usage;
+  ExecutionStats const& _stats;
+  uint64_t _cpuTime;
+  uint64_t _blockReads;
+  int _perfLevel;
+};
+}
+}
+
+#endif
@@ -26,6 +26,7 @@
 
 #include "Basics/Common.h"
 #include "Basics/Exceptions.h"
+#include "RestServer/MemoryGovernorFeature.h"
 
 namespace arangodb {
 namespace aql {
@@ -40,8 +41,22 @@ struct ResourceUsage {
 };
 
 struct ResourceMonitor {
-  ResourceMonitor() : currentResources(), maxResources() {}
-  explicit ResourceMonitor(ResourceUsage const& maxResources) : currentResources(), maxResources(maxResources) {}
+  ResourceMonitor() : currentResources(), maxResources(), peakMemoryUsage(0), borrowedMemory(0) {}
+  explicit ResourceMonitor(ResourceUsage const& maxResources) : currentResources(), maxResources(maxResources), peakMemoryUsage(0), borrowedMemory(0) {}
+  
+  // borrowed memory belongs to this monitor only and is never copied
+  ResourceMonitor(ResourceMonitor const& other)
+      : currentResources(other.currentResources), maxResources(other.maxResources), peakMemoryUsage(other.peakMemoryUsage), borrowedMemory(0) {}
+  ResourceMonitor& operator=(ResourceMonitor const& other) {
+    currentResources = other.currentResources;
+    maxResources = other.maxResources;
+    peakMemoryUsage = other.peakMemoryUsage;
+    return *this;
+  }
+
+  ~ResourceMonitor() {
+    returnBorrowed(0);
+  }
  
   void setMemoryLimit(size_t value) {
     maxResources.memoryUsage = value;
@@ -52,20 +67,61 @@ struct ResourceMonitor {
         currentResources.memoryUsage + value > maxResources.memoryUsage) {
       THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_RESOURCE_LIMIT, "query would use more memory than allowed");
     }
+    if (currentResources.memoryUsage + value > borrowedMemory) {
+      borrow(currentResources.memoryUsage + value - borrowedMemory);
+    }
     currentResources.memoryUsage += value;
+    if (currentResources.memoryUsage > peakMemoryUsage) {
+      peakMemoryUsage = currentResources.memoryUsage;
+    }
   }
   
   void decreaseMemoryUsage(size_t value) noexcept {
     TRI_ASSERT(currentResources.memoryUsage >= value);
     currentResources.memoryUsage -= value;
+    if (borrowedMemory >= currentResources.memoryUsage + 2 * MemoryGovernorFeature::chunkSize) {
+      // keep a chunk to avoid going back and forth on every allocation
+      returnBorrowed(currentResources.memoryUsage + MemoryGovernorFeature::chunkSize);
+    }
   }
 
   void clear() {
     currentResources.clear();
+    returnBorrowed(0);
   }
 
   ResourceUsage currentResources;
   ResourceUsage maxResources;
+  // highest memory usage so far
+  size_t peakMemoryUsage;
+  // memory borrowed from the global memory budget
+  size_t borrowedMemory;
+
+ private:
+  void borrow(size_t value) {
+    MemoryGovernorFeature* governor = MemoryGovernorFeature::GOVERNOR;
+    if (governor == nullptr || !governor->isEnabled()) {
+      return;
+    }
+    // round up to full chunks
+    size_t chunk = static_cast<size_t>(MemoryGovernorFeature::chunkSize);
+    value = ((value + chunk - 1) / chunk) * chunk;
+    if (!governor->borrowQueryMemory(value)) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_RESOURCE_LIMIT, "query would use more memory than the server's memory budget allows");
+    }
+    borrowedMemory += value;
+  }
+
+  void returnBorrowed(size_t keep) noexcept {
+    if (borrowedMemory <= keep) {
+      return;
+    }
+    MemoryGovernorFeature* governor = MemoryGovernorFeature::GOVERNOR;
+    if (governor != nullptr) {
+      governor->returnQueryMemory(borrowedMemory - keep);
+    }
+    borrowedMemory = keep;
+  }
 };
 
 }
@@ -65,7 +65,7 @@ RestAqlHandler::RestAqlHandler(GeneralRequest* request,
 }
 
 // returns the queue name
-size_t RestAqlHandler::queue() const { return JobQueue::AQL_QUEUE; }
+size_t RestAqlHandler::queue() const { return JobQueue::CLUSTER_QUEUE; }
 
 bool RestAqlHandler::isDirect() const { return false; }
 
@@ -112,6 +112,17 @@ void RestAqlHandler::createQueryFromVelocyPack() {
     return;
   }
 
+  {
+    // parts of traced cluster queries report their timing on shutdown
+    bool found;
+    std::string const& traceId =
+        _request->header(StaticStrings::TraceIdHeader, found);
+    if (found && !traceId.empty() && query->engine() != nullptr) {
+      std::string const& shard = _request->header("x-arango-nolock", found);
+      query->engine()->trace(traceId, found ? shard : "");
+    }
+  }
+
   // Now the query is ready to go, store it in the registry and return:
   double ttl = 600.0;
   bool found;
@@ -736,6 +747,7 @@ void RestAqlHandler::handleUseQuery(std::string const& operation, Query* query,
           answerBuilder.add("exhausted", VPackValue(true));
           answerBuilder.add("error", VPackValue(false));
         } else {
+          query->engine()->traceItems(items->size());
           try {
             items->toVelocyPack(query->trx(), answerBuilder);
           } catch (...) {
@@ -763,6 +775,7 @@ void RestAqlHandler::handleUseQuery(std::string const& operation, Query* query,
             }
             skipped = block->skipSomeForShard(atLeast, atMost, shardId);
           }
+          query->engine()->traceItems(skipped);
         } catch (...) {
           generateError(rest::ResponseCode::SERVER_ERROR,
                         TRI_ERROR_HTTP_SERVER_ERROR,
@@ -0,0 +1,243 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "SelectivityEstimator.h"
+#include "Aql/AstNode.h"
+#include "Aql/Collection.h"
+#include "Aql/ExecutionNode.h"
+#include "Aql/ExecutionPlan.h"
+#include "Aql/Expression.h"
+#include "Aql/IndexNode.h"
+#include "Aql/Variable.h"
+#include "VocBase/AttributeStatistics.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+using namespace arangodb::aql;
+
+bool SelectivityEstimator::selectivity(AstNode const* node, double& result,
+                                       bool& complete) const {
+  result = 1.0;
+  complete = true;
+
+  if (node == nullptr) {
+    return false;
+  }
+
+  switch (node->type) {
+    case NODE_TYPE_OPERATOR_BINARY_AND:
+    case NODE_TYPE_OPERATOR_NARY_AND: {
+      bool found = false;
+      for (size_t i = 0; i < node->numMembers(); ++i) {
+        double s;
+        bool c;
+        if (selectivity(node->getMemberUnchecked(i), s, c)) {
+          // conditions are assumed to be independent
+          result *= s;
+          complete &= c;
+          found = true;
+        } else {
+          complete = false;
+        }
+      }
+      return found;
+    }
+
+    case NODE_TYPE_OPERATOR_BINARY_OR:
+    case NODE_TYPE_OPERATOR_NARY_OR: {
+      double sum = 0.0;
+      for (size_t i = 0; i < node->numMembers(); ++i) {
+        double s;
+        bool c;
+        if (!selectivity(node->getMemberUnchecked(i), s, c)) {
+          complete = false;
+          return false;
+        }
+        sum += s;
+        complete &= c;
+      }
+      result = (std::min)(sum, 1.0);
+      return true;
+    }
+
+    case NODE_TYPE_OPERATOR_UNARY_NOT: {
+      double s;
+      bool c;
+      if (!selectivity(node->getMember(0), s, c) || !c) {
+        complete = false;
+        return false;
+      }
+      result = 1.0 - s;
+      return true;
+    }
+
+    case NODE_TYPE_OPERATOR_BINARY_EQ:
+    case NODE_TYPE_OPERATOR_BINARY_NE: {
+      double s;
+      if (!equalitySelectivity(node->getMember(0), node->getMember(1), s)) {
+        complete = false;
+        return false;
+      }
+      result = (node->type == NODE_TYPE_OPERATOR_BINARY_EQ) ? s : 1.0 - s;
+      return true;
+    }
+
+    case NODE_TYPE_OPERATOR_BINARY_IN:
+    case NODE_TYPE_OPERATOR_BINARY_NIN: {
+      double s;
+      if (!inSelectivity(node->getMember(0), node->getMember(1), s)) {
+        complete = false;
+        return false;
+      }
+      result = (node->type == NODE_TYPE_OPERATOR_BINARY_IN) ? s : 1.0 - s;
+      return true;
+    }
+
+    case NODE_TYPE_REFERENCE: {
+      return selectivity(static_cast<Variable const*>(node->getData()), result,
+                         complete);
+    }
+
+    default: {
+      complete = false;
+      return false;
+    }
+  }
+}
+
+bool SelectivityEstimator::selectivity(Variable const* variable,
+                                       double& result, bool& complete) const {
+  AstNode const* node = calculationFor(variable);
+  if (node == nullptr) {
+    result = 1.0;
+    complete = false;
+    return false;
+  }
+  return selectivity(node, result, complete);
+}
+
+bool SelectivityEstimator::distinctValues(Variable const* variable,
+                                          double& result) const {
+  AstNode const* node = calculationFor(variable);
+  std::shared_ptr<AttributeStatistics const> statistics;
+  std::string attribute;
+  if (!resolveAttribute(node, statistics, attribute)) {
+    return false;
+  }
+  return statistics->distinctValues(attribute, result);
+}
+
+AstNode const* SelectivityEstimator::calculationFor(
+    Variable const* variable) const {
+  if (variable == nullptr) {
+    return nullptr;
+  }
+  auto setter = _plan->getVarSetBy(variable->id);
+  if (setter == nullptr ||
+      setter->getType() != ExecutionNode::CALCULATION) {
+    return nullptr;
+  }
+  auto expression = static_cast<CalculationNode const*>(setter)->expression();
+  return (expression == nullptr) ? nullptr : expression->node();
+}
+
+bool SelectivityEstimator::resolveAttribute(
+    AstNode const* node, std::shared_ptr<AttributeStatistics const>& statistics,
+    std::string& attribute) const {
+  if (node == nullptr || node->type != NODE_TYPE_ATTRIBUTE_ACCESS ||
+      node->getMember(0)->type != NODE_TYPE_REFERENCE) {
+    return false;
+  }
+
+  auto variable = static_cast<Variable const*>(node->getMember(0)->getData());
+  auto setter = _plan->getVarSetBy(variable->id);
+  if (setter == nullptr) {
+    return false;
+  }
+
+  Collection const* collection = nullptr;
+  if (setter->getType() == ExecutionNode::ENUMERATE_COLLECTION) {
+    collection =
+        static_cast<EnumerateCollectionNode const*>(setter)->collection();
+  } else if (setter->getType() == ExecutionNode::INDEX) {
+    collection = static_cast<IndexNode const*>(setter)->collection();
+  }
+  if (collection == nullptr) {
+    return false;
+  }
+
+  statistics = collection->attributeStatistics();
+  if (statistics == nullptr) {
+    return false;
+  }
+  attribute = node->getString();
+  return true;
+}
+
+bool SelectivityEstimator::equalitySelectivity(AstNode const* lhs,
+                                               AstNode const* rhs,
+                                               double& result) const {
+  std::shared_ptr<AttributeStatistics const> statistics;
+  std::string attribute;
+  if (!resolveAttribute(lhs, statistics, attribute)) {
+    if (!resolveAttribute(rhs, statistics, attribute)) {
+      return false;
+    }
+    std::swap(lhs, rhs);
+  }
+
+  if (!rhs->isConstant()) {
+    // compared to a value only known at runtime
+    return statistics->equalitySelectivity(attribute, VPackSlice::noneSlice(),
+                                           result);
+  }
+
+  VPackBuilder value;
+  rhs->toVelocyPackValue(value);
+  return statistics->equalitySelectivity(attribute, value.slice(), result);
+}
+
+bool SelectivityEstimator::inSelectivity(AstNode const* lhs,
+                                         AstNode const* rhs,
+                                         double& result) const {
+  std::shared_ptr<AttributeStatistics const> statistics;
+  std::string attribute;
+  if (!resolveAttribute(lhs, statistics, attribute) ||
+      rhs->type != NODE_TYPE_ARRAY || !rhs->isConstant()) {
+    return false;
+  }
+
+  double sum = 0.0;
+  VPackBuilder value;
+  for (size_t i = 0; i < rhs->numMembers(); ++i) {
+    value.clear();
+    rhs->getMemberUnchecked(i)->toVelocyPackValue(value);
+    double s;
+    if (!statistics->equalitySelectivity(attribute, value.slice(), s)) {
+      return false;
+    }
+    sum += s;
+  }
+  result = (std::min)(sum, 1.0);
+  return true;
+}
@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_AQL_SELECTIVITY_ESTIMATOR_H
+#define ARANGOD_AQL_SELECTIVITY_ESTIMATOR_H 1
+
+#include "Basics/Common.h"
+
+namespace arangodb {
+class AttributeStatistics;
+
+namespace aql {
+struct AstNode;
+class ExecutionPlan;
+struct Variable;
+
+/// @brief estimates the selectivity of conditions and the number of distinct
+/// values of expressions from the attribute statistics of the collections
+/// that are iterated over in a plan
+class SelectivityEstimator {
+ public:
+  explicit SelectivityEstimator(ExecutionPlan const* plan) : _plan(plan) {}
+
+  /// @brief estimated fraction of the input for which <condition> is true.
+  /// returns false if no part of the condition could be estimated. parts
+  /// that cannot be estimated are assumed to be always true, in which case
+  /// <complete> is set to false
+  bool selectivity(AstNode const* condition, double& result,
+                   bool& complete) const;
+
+  /// @brief estimated fraction of the input for which the value of
+  /// <variable> is true. the variable must be set by a calculation
+  bool selectivity(Variable const* variable, double& result,
+                   bool& complete) const;
+
+  /// @brief estimated number of distinct values of the expression that sets
+  /// <variable>. returns false if it cannot be estimated
+  bool distinctValues(Variable const* variable, double& result) const;
+
+ private:
+  /// @brief the expression node of the calculation setting <variable>, or
+  /// nullptr
+  AstNode const* calculationFor(Variable const* variable) const;
+
+  /// @brief statistics and name of a top-level attribute of a document from
+  /// a collection. returns false if <node> is not such an attribute access or
+  /// the collection has no statistics
+  bool resolveAttribute(AstNode const* node,
+                        std::shared_ptr<AttributeStatistics const>& statistics,
+                        std::string& attribute) const;
+
+  /// @brief selectivity of an equality comparison of <lhs> and <rhs>
+  bool equalitySelectivity(AstNode const* lhs, AstNode const* rhs,
+                           double& result) const;
+
+  /// @brief selectivity of <lhs> IN <rhs>
+  bool inSelectivity(AstNode const* lhs, AstNode const* rhs,
+                     double& result) const;
+
+  ExecutionPlan const* _plan;
+};
+
+}  // namespace aql
+}  // namespace arangodb
+
+#endif
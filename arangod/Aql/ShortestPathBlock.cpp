@@ -280,7 +280,7 @@ AqlItemBlock* ShortestPathBlock::getSome(size_t, size_t atMost) {
     }
 
     if (_buffer.empty()) {
-      size_t toFetch = (std::min)(DefaultBatchSize(), atMost);
+      size_t toFetch = (std::min)(batchSize(), atMost);
       if (!ExecutionBlock::getBlock(toFetch, toFetch)) {
         _done = true;
         traceGetSomeEnd(nullptr);
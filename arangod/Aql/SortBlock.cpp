@@ -24,13 +24,33 @@
 #include "SortBlock.h"
 #include "Aql/AqlItemBlock.h"
 #include "Aql/ExecutionEngine.h"
+#include "Aql/Query.h"
+#include "Aql/SpillFile.h"
 #include "Basics/Exceptions.h"
 #include "VocBase/vocbase.h"
 
 using namespace arangodb::aql;
 
 SortBlock::SortBlock(ExecutionEngine* engine, SortNode const* en)
-    : ExecutionBlock(engine, en), _sortRegisters(), _stable(en->_stable), _mustFetchAll(true) {
+    : ExecutionBlock(engine, en),
+      _sortRegisters(),
+      _stable(en->_stable),
+      _mustFetchAll(true),
+      _runs(engine->getQuery()->resourceMonitor(),
+            [this](AqlItemBlock const* a, size_t posA, AqlItemBlock const* b,
+                   size_t posB) {
+              for (auto const& reg : _sortRegisters) {
+                int cmp = AqlValue::Compare(
+                    _trx, a->getValueReference(posA, reg.first),
+                    b->getValueReference(posB, reg.first), true);
+
+                if (cmp != 0) {
+                  return reg.second ? cmp : -cmp;
+                }
+              }
+              return 0;
+            }),
+      _nrRegs(0) {
   for (auto const& p : en->_elements) {
     auto it = en->getRegisterPlan()->varInfo.find(p.var->id);
     TRI_ASSERT(it != en->getRegisterPlan()->varInfo.end());
@@ -51,6 +71,7 @@ int SortBlock::initializeCursor(AqlItemBlock* items, size_t pos) {
 
   _mustFetchAll = !_done;
   _pos = 0;
+  _runs.clear();
 
   return TRI_ERROR_NO_ERROR;
 
@@ -58,6 +79,12 @@ int SortBlock::initializeCursor(AqlItemBlock* items, size_t pos) {
   DEBUG_END_BLOCK();  
 }
 
+int SortBlock::shutdown(int errorCode) {
+  // removes the temporary files
+  _runs.clear();
+  return ExecutionBlock::shutdown(errorCode);
+}
+
 int SortBlock::getOrSkipSome(size_t atLeast, size_t atMost, bool skipping,
                              AqlItemBlock*& result, size_t& skipped) {
   DEBUG_BEGIN_BLOCK(); 
@@ -65,22 +92,58 @@ int SortBlock::getOrSkipSome(size_t atLeast, size_t atMost, bool skipping,
   TRI_ASSERT(result == nullptr && skipped == 0);
   
   if (_mustFetchAll) {
-    // suck all blocks into _buffer
-    while (getBlock(DefaultBatchSize(), DefaultBatchSize())) {
+    size_t const threshold = _engine->getQuery()->queryOptions().sortSpillThreshold;
+    size_t buffered = 0;
+
+    // suck all blocks into _buffer. if a spill threshold is set and
+    // the buffered blocks exceed it, write them to disk as a sorted run
+    while (getBlock(batchSize(), batchSize())) {
+      if (threshold > 0) {
+        buffered += _buffer.back()->memoryUsage();
+        if (buffered >= threshold) {
+          spillRun();
+          buffered = 0;
+        }
+      }
     }
 
     _mustFetchAll = false;
-    if (!_buffer.empty()) {
+    if (_runs.numberOfRuns() > 0) {
+      if (!_buffer.empty()) {
+        spillRun();
+      }
+      _runs.start();
+    } else if (!_buffer.empty()) {
       doSorting();
     }
   }
 
+  if (_runs.hasMore()) {
+    if (skipping) {
+      skipped = skipFromRuns(atMost);
+      return TRI_ERROR_NO_ERROR;
+    }
+    fillBufferFromRuns(atMost);
+  }
+
   return ExecutionBlock::getOrSkipSome(atLeast, atMost, skipping, result, skipped);
   
   // cppcheck-suppress style
   DEBUG_END_BLOCK();  
 }
 
+bool SortBlock::hasMore() {
+  if (_done) {
+    return false;
+  }
+  // rows still waiting in the sorted runs are not in _buffer, and the
+  // dependency is already exhausted
+  if (_runs.hasMore()) {
+    return true;
+  }
+  return ExecutionBlock::hasMore();
+}
+
 void SortBlock::doSorting() {
   DEBUG_BEGIN_BLOCK();  
 
@@ -241,6 +304,91 @@ void SortBlock::doSorting() {
   DEBUG_END_BLOCK();  
 }
 
+/// @brief sort the current contents of _buffer and write them into a
+/// temporary file as a sorted run
+void SortBlock::spillRun() {
+  DEBUG_BEGIN_BLOCK();
+  TRI_ASSERT(!_buffer.empty());
+
+  doSorting();
+
+  if (_nrRegs == 0) {
+    _nrRegs = _buffer.front()->getNrRegs();
+  }
+
+  std::unique_ptr<SpillFile> file(new SpillFile(_trx));
+  for (auto const& block : _buffer) {
+    file->write(block);
+  }
+  _runs.addRun(std::move(file));
+
+  for (auto& block : _buffer) {
+    returnBlock(block);
+  }
+  _buffer.clear();
+
+  throwIfKilled();  // check if we were aborted
+  DEBUG_END_BLOCK();
+}
+
+/// @brief merge rows from the sorted runs into _buffer until it contains
+/// at least atMost rows or all runs are exhausted
+void SortBlock::fillBufferFromRuns(size_t atMost) {
+  DEBUG_BEGIN_BLOCK();
+  size_t available = 0;
+  for (auto const& block : _buffer) {
+    available += block->size();
+  }
+  if (!_buffer.empty()) {
+    available -= _pos;
+  }
+
+  while (available < atMost && _runs.hasMore()) {
+    std::unique_ptr<AqlItemBlock> next(requestBlock(DefaultBatchSize(), _nrRegs));
+    size_t const rows = _runs.fill(next.get());
+
+    TRI_ASSERT(rows > 0);
+    if (rows < DefaultBatchSize()) {
+      next->shrink(rows, false);
+    }
+
+    _buffer.emplace_back(next.get());
+    next.release();
+    available += rows;
+
+    throwIfKilled();  // check if we were aborted
+  }
+  DEBUG_END_BLOCK();
+}
+
+/// @brief skip up to atMost rows of _buffer and the sorted runs, without
+/// copying the rows of the runs
+size_t SortBlock::skipFromRuns(size_t atMost) {
+  DEBUG_BEGIN_BLOCK();
+  size_t skipped = 0;
+
+  // rows that were already merged into _buffer come first
+  while (skipped < atMost && !_buffer.empty()) {
+    AqlItemBlock* cur = _buffer.front();
+    size_t const n = (std::min)(cur->size() - _pos, atMost - skipped);
+    skipped += n;
+    _pos += n;
+    if (_pos >= cur->size()) {
+      returnBlock(cur);
+      _buffer.pop_front();
+      _pos = 0;
+    }
+  }
+
+  if (skipped < atMost) {
+    skipped += _runs.skip(atMost - skipped);
+  }
+
+  throwIfKilled();  // check if we were aborted
+  return skipped;
+  DEBUG_END_BLOCK();
+}
+
 bool SortBlock::OurLessThan::operator()(std::pair<size_t, size_t> const& a,
                                         std::pair<size_t, size_t> const& b) const {
   for (auto const& reg : _sortRegisters) {
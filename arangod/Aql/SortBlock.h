@@ -27,6 +27,7 @@
 #include "Basics/Common.h"
 #include "Aql/ExecutionBlock.h"
 #include "Aql/SortNode.h"
+#include "Aql/SortedRunMerger.h"
 
 namespace arangodb {
 namespace transaction {
@@ -48,12 +49,28 @@ class SortBlock final : public ExecutionBlock {
 
   int initializeCursor(AqlItemBlock* items, size_t pos) override final;
 
+  int shutdown(int) override final;
+
   int getOrSkipSome(size_t atLeast, size_t atMost, bool skipping, AqlItemBlock*&, size_t& skipped) override final;
 
+  bool hasMore() override final;
+
   /// @brief dosorting
  private:
   void doSorting();
 
+  /// @brief sort the current contents of _buffer and write them into a
+  /// temporary file as a sorted run
+  void spillRun();
+
+  /// @brief merge rows from the sorted runs into _buffer until it contains
+  /// at least atMost rows or all runs are exhausted
+  void fillBufferFromRuns(size_t atMost);
+
+  /// @brief skip up to atMost rows of _buffer and the sorted runs, without
+  /// copying the rows of the runs
+  size_t skipFromRuns(size_t atMost);
+
   /// @brief OurLessThan
   class OurLessThan {
    public:
@@ -81,6 +98,12 @@ class SortBlock final : public ExecutionBlock {
   bool _stable;
 
   bool _mustFetchAll;
+
+  /// @brief sorted runs that were spilled to disk
+  SortedRunMerger _runs;
+
+  /// @brief number of registers of the spilled blocks
+  RegisterId _nrRegs;
 };
 
 }  // namespace arangodb::aql
@@ -0,0 +1,266 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "SortLimitBlock.h"
+#include "Aql/AqlItemBlock.h"
+#include "Aql/ExecutionEngine.h"
+#include "Basics/Exceptions.h"
+#include "VocBase/vocbase.h"
+
+using namespace arangodb::aql;
+
+SortLimitBlock::SortLimitBlock(ExecutionEngine* engine, SortNode const* en)
+    : ExecutionBlock(engine, en),
+      _sortRegisters(),
+      _limit(en->limit()),
+      _sequence(0),
+      _nrRegs(0),
+      _mustFetchAll(true) {
+  TRI_ASSERT(_limit > 0);
+
+  for (auto const& p : en->_elements) {
+    auto it = en->getRegisterPlan()->varInfo.find(p.var->id);
+    TRI_ASSERT(it != en->getRegisterPlan()->varInfo.end());
+    TRI_ASSERT(it->second.registerId < ExecutionNode::MaxRegisterId);
+    _sortRegisters.emplace_back(
+        std::make_pair(it->second.registerId, p.ascending));
+  }
+}
+
+SortLimitBlock::~SortLimitBlock() {
+  for (auto& it : _storage) {
+    delete it;
+  }
+}
+
+int SortLimitBlock::initializeCursor(AqlItemBlock* items, size_t pos) {
+  DEBUG_BEGIN_BLOCK();
+  int res = ExecutionBlock::initializeCursor(items, pos);
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  clearStorage();
+  _mustFetchAll = !_done;
+  _sequence = 0;
+  _pos = 0;
+
+  return TRI_ERROR_NO_ERROR;
+
+  // cppcheck-suppress style
+  DEBUG_END_BLOCK();
+}
+
+int SortLimitBlock::shutdown(int errorCode) {
+  clearStorage();
+  return ExecutionBlock::shutdown(errorCode);
+}
+
+int SortLimitBlock::getOrSkipSome(size_t atLeast, size_t atMost,
+                                  bool skipping, AqlItemBlock*& result,
+                                  size_t& skipped) {
+  DEBUG_BEGIN_BLOCK();
+
+  TRI_ASSERT(result == nullptr && skipped == 0);
+
+  if (_mustFetchAll) {
+    // stream all input blocks through the heap, only keeping the best rows
+    while (getBlock(batchSize(), batchSize())) {
+      AqlItemBlock* cur = _buffer.front();
+      _buffer.pop_front();
+      try {
+        consume(cur);
+      } catch (...) {
+        returnBlock(cur);
+        throw;
+      }
+      returnBlock(cur);
+    }
+
+    _mustFetchAll = false;
+    produceResult();
+  }
+
+  return ExecutionBlock::getOrSkipSome(atLeast, atMost, skipping, result,
+                                       skipped);
+
+  // cppcheck-suppress style
+  DEBUG_END_BLOCK();
+}
+
+/// @brief compare two rows, considering the sort directions
+int SortLimitBlock::compareRows(AqlItemBlock const* a, size_t rowA,
+                                AqlItemBlock const* b, size_t rowB) const {
+  for (auto const& reg : _sortRegisters) {
+    int cmp = AqlValue::Compare(_trx, a->getValueReference(rowA, reg.first),
+                                b->getValueReference(rowB, reg.first), true);
+
+    if (cmp != 0) {
+      return reg.second ? cmp : -cmp;
+    }
+  }
+  return 0;
+}
+
+/// @brief whether entry a is sorted before entry b. ties are broken by
+/// the input order, so the result is the same as with a stable sort
+bool SortLimitBlock::isBefore(Entry const& a, Entry const& b) const {
+  int cmp = compareRows(a.block, a.row, b.block, b.row);
+  if (cmp != 0) {
+    return cmp < 0;
+  }
+  return a.sequence < b.sequence;
+}
+
+/// @brief consume an input block, keeping the rows that qualify
+void SortLimitBlock::consume(AqlItemBlock const* block) {
+  if (_nrRegs == 0) {
+    _nrRegs = block->getNrRegs();
+  }
+  TRI_ASSERT(_nrRegs == block->getNrRegs());
+
+  auto comparator = [this](Entry const& a, Entry const& b) {
+    return isBefore(a, b);
+  };
+
+  size_t const n = block->size();
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t sequence = _sequence++;
+
+    if (_heap.size() < _limit) {
+      // heap is not yet full, every row is taken
+      size_t const slot = _heap.size();
+      if (slot % DefaultBatchSize() == 0) {
+        std::unique_ptr<AqlItemBlock> storage(
+            requestBlock(DefaultBatchSize(), _nrRegs));
+        _storage.emplace_back(storage.get());
+        storage.release();
+      }
+      Entry entry{_storage[slot / DefaultBatchSize()],
+                  slot % DefaultBatchSize(), sequence};
+      copyRow(block, i, entry);
+      _heap.emplace_back(entry);
+      std::push_heap(_heap.begin(), _heap.end(), comparator);
+      continue;
+    }
+
+    // heap is full. the row is only taken if it is better than the worst
+    // row kept so far. as its sequence number is higher than that of all
+    // kept rows, it is not taken on a tie
+    Entry& worst = _heap.front();
+    if (compareRows(block, i, worst.block, worst.row) >= 0) {
+      continue;
+    }
+
+    std::pop_heap(_heap.begin(), _heap.end(), comparator);
+    Entry& slot = _heap.back();
+    for (RegisterId r = 0; r < _nrRegs; ++r) {
+      slot.block->destroyValue(slot.row, r);
+    }
+    slot.sequence = sequence;
+    copyRow(block, i, slot);
+    std::push_heap(_heap.begin(), _heap.end(), comparator);
+  }
+
+  throwIfKilled();  // check if we were aborted
+}
+
+/// @brief copy a row into a heap slot
+void SortLimitBlock::copyRow(AqlItemBlock const* src, size_t row,
+                             Entry& entry) {
+  for (RegisterId r = 0; r < _nrRegs; ++r) {
+    AqlValue const& value = src->getValueReference(row, r);
+    if (value.isEmpty()) {
+      continue;
+    }
+    AqlValue copy = value.clone();
+    try {
+      entry.block->setValue(entry.row, r, copy);
+    } catch (...) {
+      copy.destroy();
+      throw;
+    }
+  }
+}
+
+/// @brief move the heap contents into _buffer, in sort order
+void SortLimitBlock::produceResult() {
+  DEBUG_BEGIN_BLOCK();
+
+  if (_heap.empty()) {
+    clearStorage();
+    return;
+  }
+
+  std::sort(_heap.begin(), _heap.end(),
+            [this](Entry const& a, Entry const& b) { return isBefore(a, b); });
+
+  size_t const sum = _heap.size();
+  size_t count = 0;
+
+  while (count < sum) {
+    size_t sizeNext = (std::min)(sum - count, DefaultBatchSize());
+    AqlItemBlock* next = requestBlock(sizeNext, _nrRegs);
+
+    try {
+      _buffer.emplace_back(next);
+    } catch (...) {
+      delete next;
+      throw;
+    }
+
+    for (size_t i = 0; i < sizeNext; ++i) {
+      Entry const& entry = _heap[count];
+      for (RegisterId r = 0; r < _nrRegs; ++r) {
+        AqlValue a = entry.block->getValue(entry.row, r);
+        if (a.isEmpty()) {
+          continue;
+        }
+        // each value in the storage was cloned individually, so it can be
+        // stolen without checking for other references
+        entry.block->steal(a);
+        try {
+          next->setValue(i, r, a);
+        } catch (...) {
+          a.destroy();
+          throw;
+        }
+        entry.block->eraseValue(entry.row, r);
+      }
+      ++count;
+    }
+  }
+
+  clearStorage();
+
+  // cppcheck-suppress style
+  DEBUG_END_BLOCK();
+}
+
+/// @brief free the heap storage
+void SortLimitBlock::clearStorage() {
+  _heap.clear();
+  for (auto& it : _storage) {
+    returnBlock(it);
+  }
+  _storage.clear();
+  _nrRegs = 0;
+}
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_AQL_SORT_LIMIT_BLOCK_H
+#define ARANGOD_AQL_SORT_LIMIT_BLOCK_H 1
+
+#include "Basics/Common.h"
+#include "Aql/ExecutionBlock.h"
+#include "Aql/SortNode.h"
+
+namespace arangodb {
+namespace transaction {
+class Methods;
+}
+
+namespace aql {
+
+class AqlItemBlock;
+
+class ExecutionEngine;
+
+/// @brief a SORT that is followed by a LIMIT. instead of materializing and
+/// sorting all input rows, only the best <offset + limit> rows seen so far
+/// are kept in a bounded heap, so memory usage is proportional to the limit
+/// rather than to the input. the block produces the kept rows in sort order;
+/// the LIMIT block that follows still applies the offset and the limit
+class SortLimitBlock final : public ExecutionBlock {
+ public:
+  SortLimitBlock(ExecutionEngine*, SortNode const*);
+
+  ~SortLimitBlock();
+
+  int initializeCursor(AqlItemBlock* items, size_t pos) override final;
+
+  int shutdown(int) override final;
+
+  int getOrSkipSome(size_t atLeast, size_t atMost, bool skipping,
+                    AqlItemBlock*&, size_t& skipped) override final;
+
+ private:
+  /// @brief a row kept in the heap
+  struct Entry {
+    AqlItemBlock* block;
+    size_t row;
+    uint64_t sequence;
+  };
+
+  /// @brief compare two rows, considering the sort directions
+  int compareRows(AqlItemBlock const*, size_t, AqlItemBlock const*,
+                  size_t) const;
+
+  /// @brief whether entry a is sorted before entry b
+  bool isBefore(Entry const& a, Entry const& b) const;
+
+  /// @brief consume an input block, keeping the rows that qualify
+  void consume(AqlItemBlock const*);
+
+  /// @brief copy a row into a heap slot
+  void copyRow(AqlItemBlock const*, size_t, Entry&);
+
+  /// @brief move the heap contents into _buffer, in sort order
+  void produceResult();
+
+  /// @brief free the heap storage
+  void clearStorage();
+
+ private:
+  /// @brief pairs, consisting of register and sort direction
+  /// (true = ascending | false = descending)
+  std::vector<std::pair<RegisterId, bool>> _sortRegisters;
+
+  /// @brief maximum number of rows to keep (offset + limit)
+  size_t _limit;
+
+  /// @brief heap of kept rows, with the worst row at the front
+  std::vector<Entry> _heap;
+
+  /// @brief blocks holding the values of the kept rows
+  std::vector<AqlItemBlock*> _storage;
+
+  /// @brief number of rows seen so far, used to keep the sort stable
+  uint64_t _sequence;
+
+  /// @brief number of registers of the input blocks
+  RegisterId _nrRegs;
+
+  bool _mustFetchAll;
+};
+
+}  // namespace arangodb::aql
+}  // namespace arangodb
+
+#endif
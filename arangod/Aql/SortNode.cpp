@@ -26,13 +26,15 @@
 #include "Aql/ExecutionPlan.h"
 #include "Aql/WalkerWorker.h"
 #include "Basics/StringBuffer.h"
+#include "Basics/VelocyPackHelper.h"
 
 using namespace arangodb::basics;
 using namespace arangodb::aql;
 
 SortNode::SortNode(ExecutionPlan* plan, arangodb::velocypack::Slice const& base,
                    SortElementVector const& elements, bool stable)
-    : ExecutionNode(plan, base), _reinsertInCluster(true),  _elements(elements), _stable(stable){}
+    : ExecutionNode(plan, base), _reinsertInCluster(true),  _elements(elements), _stable(stable),
+      _limit(arangodb::basics::VelocyPackHelper::getNumericValue<size_t>(base, "limit", 0)) {}
 
 /// @brief toVelocyPack, for SortNode
 void SortNode::toVelocyPackHelper(VPackBuilder& nodes, bool verbose) const {
@@ -57,6 +59,9 @@ void SortNode::toVelocyPackHelper(VPackBuilder& nodes, bool verbose) const {
     }
   }
   nodes.add("stable", VPackValue(_stable));
+  if (_limit > 0) {
+    nodes.add("limit", VPackValue(_limit));
+  }
 
   // And close it:
   nodes.close();
@@ -196,5 +201,12 @@ double SortNode::estimateCost(size_t& nrItems) const {
   if (nrItems <= 3.0) {
     return depCost + nrItems;
   }
+  if (_limit > 0 && _limit < nrItems) {
+    // bounded heap: every input row is compared against a heap of at most
+    // _limit rows, and only _limit rows are produced
+    double cost = depCost + nrItems * std::log2(static_cast<double>(_limit) + 1.0);
+    nrItems = _limit;
+    return cost;
+  }
   return depCost + nrItems * std::log2(static_cast<double>(nrItems));
 }
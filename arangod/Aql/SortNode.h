@@ -48,12 +48,13 @@ class RedundantCalculationsReplacer;
 class SortNode : public ExecutionNode {
   friend class ExecutionBlock;
   friend class SortBlock;
+  friend class SortLimitBlock;
   friend class RedundantCalculationsReplacer;
 
  public:
   SortNode(ExecutionPlan* plan, size_t id, SortElementVector const& elements,
            bool stable)
-      : ExecutionNode(plan, id), _reinsertInCluster(true), _elements(elements), _stable(stable) {}
+      : ExecutionNode(plan, id), _reinsertInCluster(true), _elements(elements), _stable(stable), _limit(0) {}
 
   SortNode(ExecutionPlan* plan, arangodb::velocypack::Slice const& base,
            SortElementVector const& elements, bool stable);
@@ -64,6 +65,13 @@ class SortNode : public ExecutionNode {
   /// @brief whether or not the sort is stable
   inline bool isStable() const { return _stable; }
 
+  /// @brief maximum number of rows the sort needs to produce, as determined
+  /// by a following LIMIT (offset + limit). 0 means unlimited
+  inline size_t limit() const { return _limit; }
+
+  /// @brief set the maximum number of rows the sort needs to produce
+  void setLimit(size_t limit) { _limit = limit; }
+
   /// @brief export to VelocyPack
   void toVelocyPackHelper(arangodb::velocypack::Builder&,
                           bool) const override final;
@@ -72,6 +80,7 @@ class SortNode : public ExecutionNode {
   ExecutionNode* clone(ExecutionPlan* plan, bool withDependencies,
                        bool withProperties) const override final {
     auto c = new SortNode(plan, _id, _elements, _stable);
+    c->_limit = _limit;
 
     cloneHelper(c, plan, withDependencies, withProperties);
 
@@ -130,6 +139,9 @@ class SortNode : public ExecutionNode {
 
   /// whether or not the sort is stable
   bool _stable;
+
+  /// @brief maximum number of rows to produce (0 = unlimited)
+  size_t _limit;
 };
 
 }  // namespace arangodb::aql
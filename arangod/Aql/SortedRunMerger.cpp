@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "SortedRunMerger.h"
+#include "Aql/AqlItemBlock.h"
+#include "Aql/SpillFile.h"
+
+using namespace arangodb::aql;
+
+SortedRunMerger::SortedRunMerger(ResourceMonitor* resourceMonitor,
+                                 Comparator const& comparator)
+    : _resourceMonitor(resourceMonitor), _comparator(comparator) {}
+
+SortedRunMerger::~SortedRunMerger() {}
+
+/// @brief add a sorted run
+void SortedRunMerger::addRun(std::unique_ptr<SpillFile> file) {
+  TRI_ASSERT(_heap.empty());
+  Run run;
+  run.file = std::move(file);
+  run.pos = 0;
+  _runs.emplace_back(std::move(run));
+}
+
+/// @brief rewind all runs and prepare the merge
+void SortedRunMerger::start() {
+  _heap.clear();
+  _heap.reserve(_runs.size());
+
+  for (size_t i = 0; i < _runs.size(); ++i) {
+    auto& run = _runs[i];
+    run.file->rewind();
+    run.block.reset(run.file->read(_resourceMonitor));
+    run.pos = 0;
+    if (run.block != nullptr) {
+      _heap.emplace_back(i);
+    }
+  }
+
+  std::make_heap(_heap.begin(), _heap.end(),
+                 [this](size_t a, size_t b) { return greater(a, b); });
+}
+
+/// @brief write the next rows into the given block
+size_t SortedRunMerger::fill(AqlItemBlock* block) {
+  size_t row = 0;
+
+  while (row < block->size() && !_heap.empty()) {
+    std::pop_heap(_heap.begin(), _heap.end(),
+                  [this](size_t a, size_t b) { return greater(a, b); });
+    auto const& run = _runs[_heap.back()];
+    TRI_ASSERT(run.block->getNrRegs() == block->getNrRegs());
+
+    for (RegisterId r = 0; r < block->getNrRegs(); ++r) {
+      AqlValue const& a = run.block->getValueReference(run.pos, r);
+      if (a.isEmpty()) {
+        continue;
+      }
+      AqlValue b = a.clone();
+      try {
+        block->setValue(row, r, b);
+      } catch (...) {
+        b.destroy();
+        throw;
+      }
+    }
+    ++row;
+
+    advance();
+  }
+
+  if (_heap.empty()) {
+    // all runs merged. remove the temporary files
+    _runs.clear();
+  }
+  return row;
+}
+
+/// @brief drop up to atMost of the next rows
+size_t SortedRunMerger::skip(size_t atMost) {
+  size_t skipped = 0;
+
+  while (skipped < atMost && !_heap.empty()) {
+    std::pop_heap(_heap.begin(), _heap.end(),
+                  [this](size_t a, size_t b) { return greater(a, b); });
+    ++skipped;
+    advance();
+  }
+
+  if (_heap.empty()) {
+    _runs.clear();
+  }
+  return skipped;
+}
+
+/// @brief remove all runs and their temporary files
+void SortedRunMerger::clear() {
+  _heap.clear();
+  _runs.clear();
+}
+
+bool SortedRunMerger::greater(size_t a, size_t b) const {
+  Run const& left = _runs[a];
+  Run const& right = _runs[b];
+  int cmp = _comparator(left.block.get(), left.pos, right.block.get(),
+                        right.pos);
+  return cmp > 0 || (cmp == 0 && a > b);
+}
+
+/// @brief move the run at the back of the (popped) heap to its next row and
+/// push it again, or remove it if it is exhausted
+void SortedRunMerger::advance() {
+  auto& run = _runs[_heap.back()];
+
+  if (++run.pos >= run.block->size()) {
+    // current block of the run is used up, read the next one
+    run.block.reset(run.file->read(_resourceMonitor));
+    run.pos = 0;
+  }
+
+  if (run.block == nullptr) {
+    // run is exhausted
+    _heap.pop_back();
+  } else {
+    std::push_heap(_heap.begin(), _heap.end(),
+                   [this](size_t a, size_t b) { return greater(a, b); });
+  }
+}
@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_AQL_SORTED_RUN_MERGER_H
+#define ARANGOD_AQL_SORTED_RUN_MERGER_H 1
+
+#include "Basics/Common.h"
+
+#include <functional>
+
+namespace arangodb {
+namespace aql {
+class AqlItemBlock;
+class SpillFile;
+struct ResourceMonitor;
+
+/// @brief stable k-way merge of sorted runs that were written to temporary
+/// files. rows are copied out of the runs only when they are produced,
+/// skipped rows are dropped in place
+class SortedRunMerger {
+ public:
+  /// @brief compares a row of one block with a row of another block,
+  /// returns a negative value, 0 or a positive value
+  typedef std::function<int(AqlItemBlock const*, size_t, AqlItemBlock const*,
+                            size_t)>
+      Comparator;
+
+  SortedRunMerger(ResourceMonitor*, Comparator const&);
+  ~SortedRunMerger();
+
+  SortedRunMerger(SortedRunMerger const&) = delete;
+  SortedRunMerger& operator=(SortedRunMerger const&) = delete;
+
+ public:
+  /// @brief add a sorted run. runs must be added in input order, rows
+  /// comparing equal are produced in that order
+  void addRun(std::unique_ptr<SpillFile>);
+
+  /// @brief number of runs added
+  size_t numberOfRuns() const { return _runs.size(); }
+
+  /// @brief rewind all runs and prepare the merge
+  void start();
+
+  /// @brief whether there are rows left to merge
+  bool hasMore() const { return !_heap.empty(); }
+
+  /// @brief write the next rows into the given block, at most as many as
+  /// the block has rows. returns the number of rows written
+  size_t fill(AqlItemBlock*);
+
+  /// @brief drop up to atMost of the next rows, returns the number dropped
+  size_t skip(size_t atMost);
+
+  /// @brief remove all runs and their temporary files
+  void clear();
+
+ private:
+  /// @brief a sorted run and its current position
+  struct Run {
+    std::unique_ptr<SpillFile> file;
+    std::unique_ptr<AqlItemBlock> block;
+    size_t pos;
+  };
+
+  /// @brief order of the heap, the run with the smallest current row is at
+  /// the front. ties are broken by the run number
+  bool greater(size_t a, size_t b) const;
+
+  /// @brief move the run just popped from the heap to its next row
+  void advance();
+
+ private:
+  ResourceMonitor* _resourceMonitor;
+
+  Comparator const _comparator;
+
+  std::vector<Run> _runs;
+
+  /// @brief heap of indexes into _runs
+  std::vector<size_t> _heap;
+};
+
+}  // namespace arangodb::aql
+}  // namespace arangodb
+
+#endif
@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "SpillFile.h"
+#include "Aql/AqlItemBlock.h"
+#include "Basics/Exceptions.h"
+#include "Basics/OpenFilesTracker.h"
+#include "Basics/files.h"
+#include "Logger/Logger.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/Slice.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+using namespace arangodb::aql;
+
+SpillFile::SpillFile(transaction::Methods* trx)
+    : _trx(trx), _fd(-1), _size(0), _written(0), _read(0) {
+  char* filename = nullptr;
+  std::string errorMessage;
+  long systemError;
+
+  if (TRI_GetTempName("aql", &filename, true, systemError, errorMessage) !=
+          TRI_ERROR_NO_ERROR ||
+      filename == nullptr) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(
+        TRI_ERROR_CANNOT_CREATE_TEMP_FILE,
+        "could not create temporary file for AQL query: " + errorMessage);
+  }
+
+  _filename = filename;
+  TRI_Free(TRI_CORE_MEM_ZONE, filename);
+
+  _fd = TRI_TRACKED_OPEN_FILE(_filename.c_str(), O_RDWR | TRI_O_CLOEXEC);
+
+  if (_fd < 0) {
+    TRI_UnlinkFile(_filename.c_str());
+    THROW_ARANGO_EXCEPTION_MESSAGE(
+        TRI_ERROR_CANNOT_CREATE_TEMP_FILE,
+        "could not open temporary file '" + _filename + "' for AQL query");
+  }
+}
+
+SpillFile::~SpillFile() {
+  if (_fd >= 0) {
+    TRI_TRACKED_CLOSE_FILE(_fd);
+  }
+  int res = TRI_UnlinkFile(_filename.c_str());
+  if (res != TRI_ERROR_NO_ERROR) {
+    LOG_TOPIC(WARN, arangodb::Logger::QUERIES)
+        << "unable to remove temporary file '" << _filename
+        << "': " << TRI_errno_string(res);
+  }
+}
+
+/// @brief append a block to the file
+void SpillFile::write(AqlItemBlock const* block) {
+  TRI_ASSERT(_read == 0);
+
+  VPackBuilder builder;
+  builder.openObject();
+  block->toVelocyPack(_trx, builder);
+  builder.close();
+
+  // each block is stored as its length, followed by the VelocyPack data
+  uint64_t length = builder.size();
+  if (!TRI_WritePointer(_fd, &length, sizeof(length)) ||
+      !TRI_WritePointer(_fd, builder.data(), static_cast<size_t>(length))) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(
+        TRI_ERROR_CANNOT_WRITE_FILE,
+        "could not write to temporary file '" + _filename + "'");
+  }
+
+  _size += sizeof(length) + length;
+  ++_written;
+}
+
+/// @brief finish writing and start reading from the beginning
+void SpillFile::rewind() {
+  if (TRI_LSEEK(_fd, 0, SEEK_SET) != 0) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(
+        TRI_ERROR_SYS_ERROR,
+        "could not rewind temporary file '" + _filename + "'");
+  }
+  _read = 0;
+}
+
+/// @brief read the next block from the file
+AqlItemBlock* SpillFile::read(ResourceMonitor* resourceMonitor) {
+  if (_read == _written) {
+    return nullptr;
+  }
+
+  uint64_t length;
+  if (!TRI_ReadPointer(_fd, &length, sizeof(length))) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(
+        TRI_ERROR_SYS_ERROR,
+        "could not read from temporary file '" + _filename + "'");
+  }
+
+  std::unique_ptr<uint8_t[]> buffer(new uint8_t[static_cast<size_t>(length)]);
+  if (!TRI_ReadPointer(_fd, buffer.get(), static_cast<size_t>(length))) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(
+        TRI_ERROR_SYS_ERROR,
+        "could not read from temporary file '" + _filename + "'");
+  }
+
+  ++_read;
+  return new AqlItemBlock(resourceMonitor, VPackSlice(buffer.get()));
+}
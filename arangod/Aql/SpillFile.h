@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_AQL_SPILL_FILE_H
+#define ARANGOD_AQL_SPILL_FILE_H 1
+
+#include "Basics/Common.h"
+
+namespace arangodb {
+namespace transaction {
+class Methods;
+}
+
+namespace aql {
+class AqlItemBlock;
+struct ResourceMonitor;
+
+/// @brief a temporary file holding a sequence of serialized AqlItemBlocks.
+/// blocks are first appended using write(), and after a call to rewind()
+/// they can be read back in the same order using read(). the file is created
+/// in the user-defined temp path and removed when the object is destroyed
+class SpillFile {
+ public:
+  SpillFile(SpillFile const&) = delete;
+  SpillFile& operator=(SpillFile const&) = delete;
+
+  explicit SpillFile(transaction::Methods*);
+
+  ~SpillFile();
+
+ public:
+  /// @brief append a block to the file
+  void write(AqlItemBlock const*);
+
+  /// @brief finish writing and start reading from the beginning
+  void rewind();
+
+  /// @brief read the next block from the file. returns a nullptr if all
+  /// blocks have been read. the caller takes over ownership of the block
+  AqlItemBlock* read(ResourceMonitor*);
+
+  /// @brief number of bytes written to the file
+  uint64_t size() const { return _size; }
+
+ private:
+  transaction::Methods* _trx;
+
+  /// @brief name of the file
+  std::string _filename;
+
+  /// @brief file descriptor
+  int _fd;
+
+  /// @brief number of bytes written to the file
+  uint64_t _size;
+
+  /// @brief number of blocks written to the file
+  uint64_t _written;
+
+  /// @brief number of blocks read from the file
+  uint64_t _read;
+};
+
+}  // namespace arangodb::aql
+}  // namespace arangodb
+
+#endif
@@ -363,7 +363,7 @@ AqlItemBlock* TraversalBlock::getSome(size_t,  // atLeast,
     }
 
     if (_buffer.empty()) {
-      size_t toFetch = (std::min)(DefaultBatchSize(), atMost);
+      size_t toFetch = (std::min)(batchSize(), atMost);
       if (!ExecutionBlock::getBlock(toFetch, toFetch)) {
         _done = true;
         traceGetSomeEnd(nullptr);
@@ -411,15 +411,21 @@ AqlItemBlock* TraversalBlock::getSome(size_t,  // atLeast,
     // only copy 1st row of registers inherited from previous frame(s)
     inheritRegisters(cur, res.get(), _pos);
 
+    // Every buffered value is handed out exactly once, so it is moved into
+    // the result instead of being copied. The buffer entry is only erased
+    // after setValue succeeded, otherwise freeCaches() still destroys it.
     for (size_t j = 0; j < toSend; j++) {
       if (usesVertexOutput()) {
-        res->setValue(j, _vertexReg, _vertices[_posInPaths].clone());
+        res->setValue(j, _vertexReg, _vertices[_posInPaths]);
+        _vertices[_posInPaths].erase();
       }
       if (usesEdgeOutput()) {
-        res->setValue(j, _edgeReg, _edges[_posInPaths].clone());
+        res->setValue(j, _edgeReg, _edges[_posInPaths]);
+        _edges[_posInPaths].erase();
       }
       if (usesPathOutput()) {
-        res->setValue(j, _pathReg, _paths[_posInPaths].clone());
+        res->setValue(j, _pathReg, _paths[_posInPaths]);
+        _paths[_posInPaths].erase();
       }
       if (j > 0) {
         // re-use already copied AqlValues
@@ -458,9 +464,11 @@ AqlItemBlock* TraversalBlock::getSome(size_t,  // atLeast,
 /// @brief skipSome
 size_t TraversalBlock::skipSome(size_t atLeast, size_t atMost) {
   DEBUG_BEGIN_BLOCK();
+  traceSkipSomeBegin();
   size_t skipped = 0;
 
   if (_done) {
+    traceSkipSomeEnd(skipped);
     return skipped;
   }
 
@@ -471,9 +479,10 @@ size_t TraversalBlock::skipSome(size_t atLeast, size_t atMost) {
 
   while (skipped < atLeast) {
     if (_buffer.empty()) {
-      size_t toFetch = (std::min)(DefaultBatchSize(), atMost);
+      size_t toFetch = (std::min)(batchSize(), atMost);
       if (!ExecutionBlock::getBlock(toFetch, toFetch)) {
         _done = true;
+        traceSkipSomeEnd(skipped);
         return skipped;
       }
       _pos = 0;  // this is in the first block
@@ -502,6 +511,7 @@ size_t TraversalBlock::skipSome(size_t atLeast, size_t atMost) {
     }
   }
   
+  traceSkipSomeEnd(skipped);
   return skipped;
 
   // cppcheck-suppress style
@@ -34,6 +34,7 @@
 #include "Aql/Variable.h"
 #include "Cluster/ClusterComm.h"
 #include "Graph/BaseOptions.h"
+#include "Graph/ClusterTraverserCache.h"
 #include "Indexes/Index.h"
 #include "Utils/CollectionNameResolver.h"
 #include "VocBase/TraverserOptions.h"
@@ -562,16 +563,44 @@ void TraversalNode::prepareOptions() {
     opts->_baseVertexExpression = new Expression(ast, cond);
     TRI_ASSERT(!opts->_baseVertexExpression->isV8());
   }
-  // If we use the path output the cache should activate document
-  // caching otherwise it is not worth it.
+  // Vertex documents are cached across queries, so that hub vertices
+  // are not read again by every traversal that passes them.
   if (ServerState::instance()->isCoordinator()) {
     _options->activateCache(false, engines());
+    if (!_isSmart) {
+      setEdgeLocality();
+    }
   } else {
-    _options->activateCache(false, nullptr);
+    _options->activateCache(true, nullptr);
   }
   _optionsBuilt = true;
 }
 
+/// @brief if every edge collection is sharded by the vertex its edges are
+/// followed from, tell the cache so it only asks the responsible DBServer for
+/// the edges of a vertex (CLUSTER ONLY)
+void TraversalNode::setEdgeLocality() {
+  std::vector<graph::ClusterTraverserCache::EdgeLocality> localities;
+
+  for (size_t i = 0; i < _edgeColls.size(); ++i) {
+    auto collection = _edgeColls[i]->getCollection();
+    std::string const& attribute = (_directions[i] == TRI_EDGE_IN)
+                                       ? StaticStrings::ToString
+                                       : StaticStrings::FromString;
+    std::vector<std::string> const& shardKeys = collection->shardKeys();
+
+    if (shardKeys.size() != 1 || shardKeys[0] != attribute) {
+      // edges of a vertex may be on any server
+      return;
+    }
+    localities.emplace_back(
+        graph::ClusterTraverserCache::EdgeLocality{collection, attribute});
+  }
+
+  auto cache = static_cast<graph::ClusterTraverserCache*>(_options->cache());
+  cache->setEdgeLocality(std::move(localities));
+}
+
 /// @brief remember the condition to execute for early traversal abortion.
 void TraversalNode::setCondition(arangodb::aql::Condition* condition) {
   std::unordered_set<Variable const*> varsUsedByCondition;
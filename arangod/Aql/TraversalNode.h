@@ -205,6 +205,8 @@ class TraversalNode : public GraphNode {
 
  private:
 
+  void setEdgeLocality();
+
 #ifdef TRI_ENABLE_MAINTAINER_MODE
   void checkConditionsDefined() const;
 #endif
@@ -23,6 +23,7 @@
 
 #include "Cache/Cache.h"
 #include "Basics/Common.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/fasthash.h"
 #include "Cache/CachedValue.h"
 #include "Cache/Common.h"
@@ -46,6 +47,8 @@ const uint64_t Cache::minLogSize = 14;
 
 uint64_t Cache::_findStatsCapacity = 16384;
 
+uint64_t Cache::_admissionCapacity = 4096;
+
 Cache::ConstructionGuard::ConstructionGuard() {}
 
 Cache::Cache(ConstructionGuard guard, Manager* manager, Metadata metadata,
@@ -53,10 +56,16 @@ Cache::Cache(ConstructionGuard guard, Manager* manager, Metadata metadata,
              std::function<Table::BucketClearer(Metadata*)> bucketClearer,
              size_t slotsPerBucket)
     : _state(),
+      _name(),
+      _type(CacheType::Plain),
       _enableWindowedStats(enableWindowedStats),
       _findStats(nullptr),
       _findHits(0),
       _findMisses(0),
+      _admission(_admissionCapacity),
+      _compressedTier(),
+      _hotKeysCounter(0),
+      _hotKeysPosition(0),
       _manager(manager),
       _metadata(metadata),
       _table(table),
@@ -64,7 +73,12 @@ Cache::Cache(ConstructionGuard guard, Manager* manager, Metadata metadata,
       _slotsPerBucket(slotsPerBucket),
       _insertsTotal(0),
       _insertEvictions(0),
+      _evictionsTotal(0),
+      _admissionRejections(0),
+      _migrations(0),
       _openOperations(0),
+      _sampledHits(0),
+      _sampledMisses(0),
       _migrateRequestTime(std::chrono::steady_clock::now()),
       _resizeRequestTime(std::chrono::steady_clock::now()) {
   _table->setTypeSpecifics(_bucketClearer, _slotsPerBucket);
@@ -79,6 +93,75 @@ Cache::Cache(ConstructionGuard guard, Manager* manager, Metadata metadata,
   }
 }
 
+void Cache::findBatch(
+    std::vector<std::pair<void const*, uint32_t>> const& keys,
+    std::vector<Finding>& results) {
+  results.clear();
+  results.resize(keys.size());
+
+  std::vector<std::pair<uint32_t, size_t>> order;
+  order.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    TRI_ASSERT(keys[i].first != nullptr);
+    order.emplace_back(hashKey(keys[i].first, keys[i].second), i);
+  }
+  // buckets are addressed by the high bits of the hash
+  std::sort(order.begin(), order.end());
+
+  std::shared_ptr<Table> table;
+  if (!startBatch(table)) {
+    for (auto& result : results) {
+      result.reportError(Result(TRI_ERROR_SHUTTING_DOWN));
+    }
+    return;
+  }
+
+  std::shared_ptr<Cache> self = shared_from_this();
+  for (size_t i = 0; i < order.size(); i++) {
+    if (i + batchPrefetchDistance < order.size()) {
+      table->prefetchBucket(order[i + batchPrefetchDistance].first);
+    }
+    auto const& key = keys[order[i].second];
+    _manager->reportAccess(self);
+    results[order[i].second] =
+        findHashed(order[i].first, key.first, key.second, false);
+  }
+  endOperation();
+}
+
+void Cache::insertBatch(std::vector<CachedValue*> const& values,
+                        std::vector<Result>& results) {
+  results.clear();
+  results.resize(values.size());
+
+  std::vector<std::pair<uint32_t, size_t>> order;
+  order.reserve(values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    TRI_ASSERT(values[i] != nullptr);
+    order.emplace_back(hashKey(values[i]->key(), values[i]->keySize), i);
+  }
+  std::sort(order.begin(), order.end());
+
+  std::shared_ptr<Table> table;
+  if (!startBatch(table)) {
+    for (auto& result : results) {
+      result.reset(TRI_ERROR_SHUTTING_DOWN);
+    }
+    return;
+  }
+
+  std::shared_ptr<Cache> self = shared_from_this();
+  for (size_t i = 0; i < order.size(); i++) {
+    if (i + batchPrefetchDistance < order.size()) {
+      table->prefetchBucket(order[i + batchPrefetchDistance].first);
+    }
+    _manager->reportAccess(self);
+    results[order[i].second] =
+        insertHashed(order[i].first, values[order[i].second], false);
+  }
+  endOperation();
+}
+
 uint64_t Cache::size() {
   uint64_t size = 0;
   _state.lock();
@@ -211,6 +294,20 @@ void Cache::startOperation() { ++_openOperations; }
 
 void Cache::endOperation() { --_openOperations; }
 
+bool Cache::startBatch(std::shared_ptr<Table>& table) {
+  bool ok = _state.lock(triesGuarantee);
+  if (ok) {
+    ok = isOperational();
+    if (ok) {
+      startOperation();
+      // only used for prefetching, the operations fetch the current table
+      table = _table;
+    }
+    _state.unlock();
+  }
+  return ok;
+}
+
 bool Cache::isMigratingLocked() const {
   TRI_ASSERT(_state.isLocked());
   return _state.isSet(State::Flag::migrating);
@@ -275,6 +372,60 @@ uint32_t Cache::hashKey(void const* key, uint32_t keySize) const {
                     fasthash32(key, keySize, 0xdeadbeefUL));
 }
 
+std::vector<std::string> Cache::hotKeys(size_t limit) {
+  std::unordered_map<std::string, uint64_t> frequencies;
+  {
+    MUTEX_LOCKER(guard, _hotKeysLock);
+    for (auto const& it : _hotKeys) {
+      frequencies[it]++;
+    }
+  }
+
+  std::vector<std::pair<std::string, uint64_t>> sorted(frequencies.begin(),
+                                                       frequencies.end());
+  std::sort(sorted.begin(), sorted.end(),
+            [](std::pair<std::string, uint64_t> const& left,
+               std::pair<std::string, uint64_t> const& right) {
+              return left.second > right.second;
+            });
+
+  std::vector<std::string> result;
+  result.reserve((std::min)(limit, sorted.size()));
+  for (auto& it : sorted) {
+    if (result.size() >= limit) {
+      break;
+    }
+    result.emplace_back(std::move(it.first));
+  }
+  return result;
+}
+
+void Cache::recordKey(void const* key, uint32_t keySize) {
+  if (((++_hotKeysCounter) & _hotKeysSampleMask) != 0) {
+    return;
+  }
+  // never make a lookup wait for the sample
+  TRY_MUTEX_LOCKER(guard, _hotKeysLock);
+  if (!guard.isLocked()) {
+    return;
+  }
+  std::string value(static_cast<char const*>(key), keySize);
+  if (_hotKeys.size() < _hotKeysCapacity) {
+    _hotKeys.emplace_back(std::move(value));
+  } else {
+    _hotKeys[_hotKeysPosition] = std::move(value);
+    _hotKeysPosition = (_hotKeysPosition + 1) % _hotKeysCapacity;
+  }
+}
+
+void Cache::recordAccess(uint32_t hash) { _admission.recordAccess(hash); }
+
+bool Cache::admit(uint32_t hash, CachedValue const* candidate) const {
+  TRI_ASSERT(candidate != nullptr);
+  uint32_t victim = hashKey(candidate->key(), candidate->keySize);
+  return (_admission.estimate(hash) > _admission.estimate(victim));
+}
+
 void Cache::recordStat(Stat stat) {
   switch (stat) {
     case Stat::findHit: {
@@ -301,6 +452,7 @@ bool Cache::reportInsert(bool hadEviction) {
   bool shouldMigrate = false;
   if (hadEviction) {
     _insertEvictions++;
+    _evictionsTotal++;
   }
   if (((++_insertsTotal) & _evictionMask) == 0) {
     if (_insertEvictions.load() > _evictionThreshold) {
@@ -317,6 +469,85 @@ bool Cache::reportInsert(bool hadEviction) {
   return shouldMigrate;
 }
 
+bool Cache::reportRejection() {
+  _admissionRejections++;
+  // a rejection means the bucket was full, so count it towards the recent
+  // eviction rate to let the table grow under pressure
+  _insertEvictions++;
+  return reportInsert(false);
+}
+
+void Cache::sampleHitRate() {
+  uint64_t hits = _findHits.load();
+  uint64_t misses = _findMisses.load();
+
+  MUTEX_LOCKER(guard, _hitRateHistoryLock);
+  uint64_t deltaHits = hits - _sampledHits;
+  uint64_t deltaMisses = misses - _sampledMisses;
+  _sampledHits = hits;
+  _sampledMisses = misses;
+
+  double rate = std::nan("");
+  if (deltaHits + deltaMisses > 0) {
+    rate = 100 * (static_cast<double>(deltaHits) /
+                  static_cast<double>(deltaHits + deltaMisses));
+  }
+  _hitRateHistory.emplace_back(rate);
+  while (_hitRateHistory.size() > _hitRateHistoryCapacity) {
+    _hitRateHistory.pop_front();
+  }
+}
+
+CacheStatistics Cache::statistics() {
+  CacheStatistics stats;
+  stats.name = _name;
+  stats.type = _type;
+  stats.usage = 0;
+  stats.usageLimit = 0;
+  stats.allocatedSize = 0;
+  stats.deservedSize = 0;
+  stats.maxSize = 0;
+  stats.tableSize = 0;
+  stats.logSize = 0;
+
+  _state.lock();
+  if (isOperational()) {
+    _metadata.lock();
+    stats.usage = _metadata.usage;
+    stats.usageLimit = _metadata.softUsageLimit;
+    stats.allocatedSize = _metadata.allocatedSize;
+    stats.deservedSize = _metadata.deservedSize;
+    stats.maxSize = _metadata.maxSize;
+    stats.tableSize = _metadata.tableSize;
+    _metadata.unlock();
+    stats.logSize = _table->logSize();
+  }
+  _state.unlock();
+
+  stats.findHits = _findHits.load();
+  stats.findMisses = _findMisses.load();
+  stats.inserts = _insertsTotal.load();
+  stats.evictions = _evictionsTotal.load();
+  stats.rejections = _admissionRejections.load();
+  stats.migrations = _migrations.load();
+  stats.compressedUsage = _compressedTier.usage();
+  stats.compressedLimit = _compressedTier.limit();
+  stats.compressedPromotions = _compressedTier.promotions();
+  std::tie(stats.lifetimeHitRate, stats.windowedHitRate) = hitRates();
+
+  {
+    MUTEX_LOCKER(guard, _hitRateHistoryLock);
+    stats.hitRateHistory.assign(_hitRateHistory.begin(),
+                                _hitRateHistory.end());
+  }
+
+  return stats;
+}
+
+void Cache::setCompressedTierLimit(uint64_t limit) {
+  _compressedTier.setLimit(limit);
+}
+
 Metadata* Cache::metadata() { return &_metadata; }
 
 std::shared_ptr<Table> Cache::table() { return _table; }
@@ -356,6 +587,7 @@ void Cache::shutdown() {
       _state.lock();
     }
     _table->clear();
+    _compressedTier.setLimit(0);
     _state.unlock();
     _manager->reclaimTable(_table);
     _manager->unregisterCache(shared_from_this());
@@ -463,9 +695,12 @@ bool Cache::migrate(std::shared_ptr<Table> newTable) {
   _state.unlock();
 
   // do the actual migration
+  // buckets are migrated in index order so that lookups for buckets behind
+  // the cursor can go to the new table without waiting for the old bucket
   for (uint32_t i = 0; i < _table->size(); i++) {
     migrateBucket(_table->primaryBucket(i), _table->auxiliaryBuckets(i),
                   newTable);
+    _table->advanceMigration(static_cast<uint64_t>(i) + 1);
   }
 
   // swap tables
@@ -489,6 +724,7 @@ bool Cache::migrate(std::shared_ptr<Table> newTable) {
   _metadata.changeTable(_table->memoryUsage());
   _metadata.toggleFlag(State::Flag::migrating);
   _metadata.unlock();
+  _migrations++;
 
   endOperation();
   return true;
@@ -25,11 +25,14 @@
 #define ARANGODB_CACHE_CACHE_H
 
 #include "Basics/Common.h"
+#include "Basics/Mutex.h"
 #include "Basics/Result.h"
 #include "Cache/CachedValue.h"
 #include "Cache/Common.h"
 #include "Cache/Finding.h"
 #include "Cache/FrequencyBuffer.h"
+#include "Cache/CompressedTier.h"
+#include "Cache/FrequencySketch.h"
 #include "Cache/Manager.h"
 #include "Cache/ManagerTasks.h"
 #include "Cache/Metadata.h"
@@ -37,8 +40,10 @@
 #include "Cache/Table.h"
 
 #include <stdint.h>
+#include <deque>
 #include <list>
 #include <memory>
+#include <string>
 
 namespace arangodb {
 namespace cache {
@@ -83,6 +88,28 @@ class Cache : public std::enable_shared_from_this<Cache> {
   virtual Result remove(void const* key, uint32_t keySize) = 0;
   virtual Result blacklist(void const* key, uint32_t keySize) = 0;
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Looks up several keys at once.
+  ///
+  /// Behaves like calling find for each key, with the Finding for keys[i]
+  /// stored in results[i]. The keys are visited in bucket order and each
+  /// bucket is prefetched a few lookups ahead, so large batches spend less
+  /// time waiting for memory. As with find, the Findings must be destroyed
+  /// quickly, in particular before inserting into the same cache.
+  //////////////////////////////////////////////////////////////////////////////
+  void findBatch(std::vector<std::pair<void const*, uint32_t>> const& keys,
+                 std::vector<Finding>& results);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Attempts to insert several values at once.
+  ///
+  /// Behaves like calling insert for each value, with the Result for values[i]
+  /// stored in results[i]. Values which were not inserted remain owned by the
+  /// caller.
+  //////////////////////////////////////////////////////////////////////////////
+  void insertBatch(std::vector<CachedValue*> const& values,
+                   std::vector<Result>& results);
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Returns the total memory usage for this cache in bytes.
   //////////////////////////////////////////////////////////////////////////////
@@ -116,6 +143,30 @@ class Cache : public std::enable_shared_from_this<Cache> {
   //////////////////////////////////////////////////////////////////////////////
   std::pair<double, double> hitRates();
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Returns up to limit of the most frequently looked up keys.
+  ///
+  /// The keys are taken from a sample of recent find operations, including
+  /// misses, and are returned in descending order of frequency.
+  //////////////////////////////////////////////////////////////////////////////
+  std::vector<std::string> hotKeys(size_t limit);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Returns the name the cache was registered under, may be empty.
+  //////////////////////////////////////////////////////////////////////////////
+  std::string const& name() const { return _name; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Returns the current sizes and counters of this cache.
+  //////////////////////////////////////////////////////////////////////////////
+  CacheStatistics statistics();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Sets the memory budget of the compressed second tier; zero
+  /// disables it. Only caches without blacklisting make use of the tier.
+  //////////////////////////////////////////////////////////////////////////////
+  void setCompressedTierLimit(uint64_t limit);
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Check whether the cache is currently in the process of resizing.
   //////////////////////////////////////////////////////////////////////////////
@@ -139,12 +190,33 @@ class Cache : public std::enable_shared_from_this<Cache> {
  protected:
   State _state;
 
+  // set by the manager before the cache is registered, constant afterwards
+  std::string _name;
+  CacheType _type;
+
   static uint64_t _findStatsCapacity;
   bool _enableWindowedStats;
   std::unique_ptr<StatBuffer> _findStats;
   std::atomic<uint64_t> _findHits;
   std::atomic<uint64_t> _findMisses;
 
+  // admission filter; a new entry only displaces an eviction candidate if it
+  // has recently been looked up more often
+  static uint64_t _admissionCapacity;
+  FrequencySketch _admission;
+
+  // optional second tier holding compressed copies of evicted values; its
+  // budget is assigned by the manager during rebalancing
+  CompressedTier _compressedTier;
+
+  // sample of recently looked up keys
+  static constexpr size_t _hotKeysCapacity = 1024;
+  static constexpr uint64_t _hotKeysSampleMask = 63;  // sample 1 in 64 finds
+  std::atomic<uint64_t> _hotKeysCounter;
+  Mutex _hotKeysLock;
+  std::vector<std::string> _hotKeys;
+  size_t _hotKeysPosition;
+
   // allow communication with manager
   Manager* _manager;
   Metadata _metadata;
@@ -157,6 +229,9 @@ class Cache : public std::enable_shared_from_this<Cache> {
   // manage eviction rate
   std::atomic<uint64_t> _insertsTotal;
   std::atomic<uint64_t> _insertEvictions;
+  std::atomic<uint64_t> _evictionsTotal;
+  std::atomic<uint64_t> _admissionRejections;
+  std::atomic<uint64_t> _migrations;
   static constexpr uint64_t _evictionMask = 1023; // check every 1024 insertions
   static constexpr uint64_t _evictionThreshold = 10;  // if more than 10
                                                       // evictions in past 1024
@@ -165,6 +240,13 @@ class Cache : public std::enable_shared_from_this<Cache> {
   // keep track of number of open operations to allow clean shutdown
   std::atomic<uint32_t> _openOperations;
 
+  // hit rates per rebalancing round
+  static constexpr size_t _hitRateHistoryCapacity = 16;
+  Mutex _hitRateHistoryLock;
+  std::deque<double> _hitRateHistory;
+  uint64_t _sampledHits;
+  uint64_t _sampledMisses;
+
   // times to wait until requesting is allowed again
   Manager::time_point _migrateRequestTime;
   Manager::time_point _resizeRequestTime;
@@ -191,8 +273,13 @@ class Cache : public std::enable_shared_from_this<Cache> {
 
   uint32_t hashKey(void const* key, uint32_t keySize) const;
   void recordStat(Stat stat);
+  void recordKey(void const* key, uint32_t keySize);
+  void recordAccess(uint32_t hash);
+  bool admit(uint32_t hash, CachedValue const* candidate) const;
 
   bool reportInsert(bool hadEviction);
+  bool reportRejection();
+  void sampleHitRate();
 
   // management
   Metadata* metadata();
@@ -204,6 +291,15 @@ class Cache : public std::enable_shared_from_this<Cache> {
   bool freeMemory();
   bool migrate(std::shared_ptr<Table> newTable);
 
+  static constexpr size_t batchPrefetchDistance = 4;
+
+  // single operations with precomputed hashes, used by the batch methods
+  virtual Finding findHashed(uint32_t hash, void const* key, uint32_t keySize,
+                             bool singleOperation) = 0;
+  virtual Result insertHashed(uint32_t hash, CachedValue* value,
+                              bool singleOperation) = 0;
+  bool startBatch(std::shared_ptr<Table>& table);
+
   virtual uint64_t freeMemoryFrom(uint32_t hash) = 0;
   virtual void migrateBucket(void* sourcePtr,
                              std::unique_ptr<Table::Subtable> targets,
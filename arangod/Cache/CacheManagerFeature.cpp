@@ -38,6 +38,7 @@
 #include "Logger/LogAppender.h"
 #include "ProgramOptions/ProgramOptions.h"
 #include "ProgramOptions/Section.h"
+#include "RestServer/MemoryGovernorFeature.h"
 #include "Scheduler/Scheduler.h"
 #include "Scheduler/SchedulerFeature.h"
 
@@ -59,10 +60,12 @@ CacheManagerFeature::CacheManagerFeature(
       _cacheSize((TRI_PhysicalMemory >= (static_cast<uint64_t>(4) << 30))
                   ? static_cast<uint64_t>((TRI_PhysicalMemory - (static_cast<uint64_t>(2) << 30)) * 0.3)
                   : (256 << 20)),
+      _compressedSize(0),
       _rebalancingInterval(static_cast<uint64_t>(2 * 1000 * 1000)) {
   setOptional(true);
   requiresElevatedPrivileges(false);
   startsAfter("Scheduler");
+  startsAfter("MemoryGovernor");
 }
 
 CacheManagerFeature::~CacheManagerFeature() {}
@@ -74,6 +77,11 @@ void CacheManagerFeature::collectOptions(
   options->addOption("--cache.size", "size of cache in bytes",
                      new UInt64Parameter(&_cacheSize));
 
+  options->addOption("--cache.compressed-size",
+                     "size of the compressed second cache tier in bytes "
+                     "(0 = disabled)",
+                     new UInt64Parameter(&_compressedSize));
+
   options->addOption("--cache.rebalancing-interval",
                      "microseconds between rebalancing attempts",
                      new UInt64Parameter(&_rebalancingInterval));
@@ -100,15 +108,27 @@ void CacheManagerFeature::start() {
   auto scheduler = SchedulerFeature::SCHEDULER;
   auto ioService = (scheduler == nullptr) ? nullptr : scheduler->ioService();
   _manager.reset(new Manager(ioService, _cacheSize));
+  _manager->setCompressedLimit(_compressedSize);
   MANAGER = _manager.get();
   _rebalancer.reset(
       new CacheRebalancerThread(_manager.get(), _rebalancingInterval));
   _rebalancer->start();
+
+  // let the cache give up memory to queries under a shared memory budget
+  if (MemoryGovernorFeature::GOVERNOR != nullptr) {
+    Manager* manager = _manager.get();
+    MemoryGovernorFeature::GOVERNOR->registerConsumer(
+        "cache", _cacheSize, (std::max)(Manager::minSize, _cacheSize / 4),
+        [manager](uint64_t size) -> bool { return manager->resize(size); });
+  }
   LOG_TOPIC(DEBUG, Logger::STARTUP) << "cache manager has started";
 }
 
 void CacheManagerFeature::beginShutdown() {
   if (_manager != nullptr) {
+    if (MemoryGovernorFeature::GOVERNOR != nullptr) {
+      MemoryGovernorFeature::GOVERNOR->unregisterConsumer("cache");
+    }
     _manager->beginShutdown();
     _rebalancer->beginShutdown();
   }
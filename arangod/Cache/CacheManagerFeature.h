@@ -55,6 +55,7 @@ class CacheManagerFeature final
   std::unique_ptr<cache::Manager> _manager;
   std::unique_ptr<CacheRebalancerThread> _rebalancer;
   uint64_t _cacheSize;
+  uint64_t _compressedSize;
   uint64_t _rebalancingInterval;
 };
 }
@@ -27,6 +27,15 @@
 #include "Basics/Common.h"
 
 #include <stdint.h>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 namespace arangodb {
 namespace cache {
@@ -46,6 +55,69 @@ enum CacheType { Plain, Transactional };
 ////////////////////////////////////////////////////////////////////////////////
 enum class Stat : uint8_t { findHit = 1, findMiss = 2 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Point-in-time view of the sizes and counters of a single cache.
+///
+/// Sizes are in bytes, counters cover the lifetime of the cache. The hit-rate
+/// history holds one value per rebalancing round, oldest first; rounds
+/// without any lookups are reported as NaN.
+////////////////////////////////////////////////////////////////////////////////
+struct CacheStatistics {
+  std::string name;
+  CacheType type;
+  uint64_t usage;
+  uint64_t usageLimit;
+  uint64_t allocatedSize;
+  uint64_t deservedSize;
+  uint64_t maxSize;
+  uint64_t tableSize;
+  uint32_t logSize;
+  uint64_t findHits;
+  uint64_t findMisses;
+  uint64_t inserts;
+  uint64_t evictions;
+  uint64_t rejections;
+  uint64_t migrations;
+  uint64_t compressedUsage;
+  uint64_t compressedLimit;
+  uint64_t compressedPromotions;
+  double lifetimeHitRate;
+  double windowedHitRate;
+  std::vector<double> hitRateHistory;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Checks whether any of the given slot hashes equals hash. Compares
+/// several slots at once where SIMD instructions are available.
+////////////////////////////////////////////////////////////////////////////////
+inline bool containsHash(uint32_t const* hashes, size_t count, uint32_t hash) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  __m256i const needle8 = _mm256_set1_epi32(static_cast<int>(hash));
+  for (; i + 8 <= count; i += 8) {
+    __m256i values = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(hashes + i));
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(values, needle8)) != 0) {
+      return true;
+    }
+  }
+#endif
+#if defined(__SSE2__)
+  __m128i const needle4 = _mm_set1_epi32(static_cast<int>(hash));
+  for (; i + 4 <= count; i += 4) {
+    __m128i values = _mm_loadu_si128(reinterpret_cast<__m128i const*>(hashes + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(values, needle4)) != 0) {
+      return true;
+    }
+  }
+#endif
+  for (; i < count; i++) {
+    if (hashes[i] == hash) {
+      return true;
+    }
+  }
+  return false;
+}
+
 };  // end namespace cache
 };  // end namespace arangodb
 
@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Cache/CompressedTier.h"
+#include "Basics/Common.h"
+#include "Basics/MutexLocker.h"
+#include "Cache/CachedValue.h"
+
+#include <snappy.h>
+
+using namespace arangodb;
+using namespace arangodb::cache;
+
+CompressedTier::CompressedTier()
+    : _limit(0), _promotions(0), _usage(0), _entries(), _index() {}
+
+CompressedTier::~CompressedTier() { clear(); }
+
+void CompressedTier::store(CachedValue const* value) {
+  TRI_ASSERT(value != nullptr);
+  if (!isEnabled()) {
+    return;
+  }
+
+  Entry entry;
+  entry.key.assign(reinterpret_cast<char const*>(value->key()),
+                   value->keySize);
+  snappy::Compress(reinterpret_cast<char const*>(value->value()),
+                   static_cast<size_t>(value->valueSize), &entry.data);
+  if (entry.data.size() >= value->valueSize) {
+    // not worth keeping, the cache tier itself would be cheaper
+    remove(value->key(), value->keySize);
+    return;
+  }
+
+  MUTEX_LOCKER(guard, _lock);
+  auto it = _index.find(entry.key);
+  if (it != _index.end()) {
+    removeLocked(it->second);
+  }
+  uint64_t size = entrySize(entry);
+  if (size > _limit.load()) {
+    return;
+  }
+  _entries.emplace_back(std::move(entry));
+  auto last = std::prev(_entries.end());
+  _index.emplace(last->key, last);
+  _usage += size;
+  evictLocked();
+}
+
+CachedValue* CompressedTier::take(void const* key, uint32_t keySize) {
+  if (!isEnabled()) {
+    return nullptr;
+  }
+
+  std::string data;
+  {
+    MUTEX_LOCKER(guard, _lock);
+    auto it = _index.find(std::string(static_cast<char const*>(key), keySize));
+    if (it == _index.end()) {
+      return nullptr;
+    }
+    removeLocked(it->second, &data);
+  }
+
+  std::string uncompressed;
+  if (!snappy::Uncompress(data.data(), data.size(), &uncompressed)) {
+    return nullptr;
+  }
+  _promotions++;
+  return CachedValue::construct(key, keySize, uncompressed.data(),
+                                static_cast<uint64_t>(uncompressed.size()));
+}
+
+void CompressedTier::remove(void const* key, uint32_t keySize) {
+  if (!isEnabled()) {
+    return;
+  }
+
+  MUTEX_LOCKER(guard, _lock);
+  auto it = _index.find(std::string(static_cast<char const*>(key), keySize));
+  if (it != _index.end()) {
+    removeLocked(it->second);
+  }
+}
+
+void CompressedTier::setLimit(uint64_t limit) {
+  MUTEX_LOCKER(guard, _lock);
+  _limit.store(limit);
+  evictLocked();
+}
+
+void CompressedTier::clear() {
+  MUTEX_LOCKER(guard, _lock);
+  _index.clear();
+  _entries.clear();
+  _usage = 0;
+}
+
+uint64_t CompressedTier::usage() {
+  MUTEX_LOCKER(guard, _lock);
+  return _usage;
+}
+
+uint64_t CompressedTier::entrySize(Entry const& entry) {
+  // the key is held by both the entry and the index
+  return (2 * entry.key.size()) + entry.data.size() + entryOverhead;
+}
+
+void CompressedTier::removeLocked(EntryList::iterator it, std::string* data) {
+  uint64_t size = entrySize(*it);
+  TRI_ASSERT(_usage >= size);
+  _usage -= size;
+  if (data != nullptr) {
+    *data = std::move(it->data);
+  }
+  _index.erase(it->key);
+  _entries.erase(it);
+}
+
+void CompressedTier::evictLocked() {
+  uint64_t limit = _limit.load();
+  while (_usage > limit && !_entries.empty()) {
+    removeLocked(_entries.begin());
+  }
+}
@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_CACHE_COMPRESSED_TIER_H
+#define ARANGODB_CACHE_COMPRESSED_TIER_H
+
+#include "Basics/Common.h"
+#include "Basics/Mutex.h"
+#include "Cache/CachedValue.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace arangodb {
+namespace cache {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Second cache tier holding compressed copies of evicted values.
+///
+/// Values evicted from a cache are stored here compressed with snappy, and
+/// taken back out (and thus removed from the tier) on a lookup miss in the
+/// cache. The tier has its own memory budget, separate from the limits
+/// managed via Metadata; it evicts its least recently stored entries when
+/// over budget. A budget of zero disables the tier.
+////////////////////////////////////////////////////////////////////////////////
+class CompressedTier {
+ public:
+  CompressedTier();
+  ~CompressedTier();
+
+  CompressedTier(CompressedTier const&) = delete;
+  CompressedTier& operator=(CompressedTier const&) = delete;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Whether the tier currently has a budget.
+  //////////////////////////////////////////////////////////////////////////////
+  bool isEnabled() const { return (_limit.load(std::memory_order_relaxed) > 0); }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Stores a compressed copy of the value, replacing any older copy
+  /// for the same key. Values which do not compress are not stored.
+  //////////////////////////////////////////////////////////////////////////////
+  void store(CachedValue const* value);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Removes the copy for the given key from the tier and returns it
+  /// as a newly constructed value, or nullptr if there is none.
+  //////////////////////////////////////////////////////////////////////////////
+  CachedValue* take(void const* key, uint32_t keySize);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Removes the copy for the given key, if any.
+  //////////////////////////////////////////////////////////////////////////////
+  void remove(void const* key, uint32_t keySize);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Changes the budget, evicting entries if necessary.
+  //////////////////////////////////////////////////////////////////////////////
+  void setLimit(uint64_t limit);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Removes all entries.
+  //////////////////////////////////////////////////////////////////////////////
+  void clear();
+
+  uint64_t limit() const { return _limit.load(std::memory_order_relaxed); }
+  uint64_t usage();
+  uint64_t promotions() const { return _promotions.load(); }
+
+ private:
+  struct Entry {
+    std::string key;
+    std::string data;
+  };
+  typedef std::list<Entry> EntryList;
+
+  // bookkeeping overhead per entry, roughly a list node and a map node
+  static constexpr uint64_t entryOverhead = 96;
+
+  static uint64_t entrySize(Entry const& entry);
+  void removeLocked(EntryList::iterator it, std::string* data = nullptr);
+  void evictLocked();
+
+ private:
+  std::atomic<uint64_t> _limit;
+  std::atomic<uint64_t> _promotions;
+  Mutex _lock;
+  uint64_t _usage;
+  // least recently stored entries at the front
+  EntryList _entries;
+  std::unordered_map<std::string, EntryList::iterator> _index;
+};
+
+};  // end namespace cache
+};  // end namespace arangodb
+
+#endif
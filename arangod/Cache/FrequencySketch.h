@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_CACHE_FREQUENCY_SKETCH_H
+#define ARANGODB_CACHE_FREQUENCY_SKETCH_H
+
+#include "Basics/Common.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+
+namespace arangodb {
+namespace cache {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Lockless count-min sketch to estimate recent access frequencies.
+///
+/// Each of the four rows holds 4-bit saturating counters packed sixteen to a
+/// word. Once the number of recorded accesses reaches ten times the width,
+/// all counters are halved, so the estimates follow the recent workload
+/// instead of the lifetime of the cache. Concurrent updates may race with
+/// the halving; the sketch only needs to be approximately right.
+////////////////////////////////////////////////////////////////////////////////
+class FrequencySketch {
+ public:
+  static constexpr uint64_t depth = 4;
+  static constexpr uint64_t countersPerWord = 16;
+  static constexpr uint64_t maxCount = 15;
+
+ private:
+  uint64_t _width;
+  uint64_t _mask;
+  uint64_t _sampleSize;
+  std::atomic<uint64_t> _additions;
+  std::unique_ptr<std::atomic<uint64_t>[]> _words;
+
+ public:
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Initialize with the given number of counters per row (rounded up
+  /// to a power of two, at least one word).
+  //////////////////////////////////////////////////////////////////////////////
+  explicit FrequencySketch(uint64_t width)
+      : _width(0), _mask(0), _sampleSize(0), _additions(0), _words(nullptr) {
+    _width = roundedWidth(width);
+    _mask = _width - 1;
+    _sampleSize = 10 * _width;
+    uint64_t n = numWords(_width);
+    _words.reset(new std::atomic<uint64_t>[n]);
+    for (uint64_t i = 0; i < n; i++) {
+      _words[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Reports the hidden allocation size (not captured by sizeof).
+  //////////////////////////////////////////////////////////////////////////////
+  static uint64_t allocationSize(uint64_t width) {
+    return numWords(roundedWidth(width)) * sizeof(std::atomic<uint64_t>);
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Record an access to the entry with the given hash.
+  //////////////////////////////////////////////////////////////////////////////
+  void recordAccess(uint32_t hash) {
+    bool added = false;
+    for (uint64_t row = 0; row < depth; row++) {
+      uint64_t index = counterIndex(hash, row);
+      std::atomic<uint64_t>& word = _words[index / countersPerWord];
+      uint64_t shift = (index % countersPerWord) * 4;
+      uint64_t expected = word.load(std::memory_order_relaxed);
+      while (((expected >> shift) & maxCount) < maxCount) {
+        uint64_t desired = expected + (static_cast<uint64_t>(1) << shift);
+        if (word.compare_exchange_weak(expected, desired,
+                                       std::memory_order_relaxed)) {
+          added = true;
+          break;
+        }
+      }
+    }
+
+    if (added && (++_additions == _sampleSize)) {
+      age();
+    }
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Estimate the recent access count of the entry with the given hash.
+  //////////////////////////////////////////////////////////////////////////////
+  uint64_t estimate(uint32_t hash) const {
+    uint64_t result = maxCount;
+    for (uint64_t row = 0; row < depth; row++) {
+      uint64_t index = counterIndex(hash, row);
+      uint64_t word =
+          _words[index / countersPerWord].load(std::memory_order_relaxed);
+      uint64_t count = (word >> ((index % countersPerWord) * 4)) & maxCount;
+      result = (std::min)(result, count);
+    }
+    return result;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Remove all access records.
+  //////////////////////////////////////////////////////////////////////////////
+  void clear() {
+    uint64_t n = numWords(_width);
+    for (uint64_t i = 0; i < n; i++) {
+      _words[i].store(0, std::memory_order_relaxed);
+    }
+    _additions = 0;
+  }
+
+ private:
+  static uint64_t roundedWidth(uint64_t width) {
+    uint64_t result = countersPerWord;
+    while (result < width) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  static uint64_t numWords(uint64_t width) {
+    return depth * (width / countersPerWord);
+  }
+
+  uint64_t counterIndex(uint32_t hash, uint64_t row) const {
+    // derive one independent index per row from the single 32-bit hash
+    static uint64_t const seeds[] = {0xc3a5c85c97cb3127ULL,
+                                     0xb492b66fbe98f273ULL,
+                                     0x9ae16a3b2f90404fULL,
+                                     0xcbf29ce484222325ULL};
+    uint64_t h = (static_cast<uint64_t>(hash) + seeds[row]) * seeds[row];
+    h ^= h >> 32;
+    return (row * _width) + (h & _mask);
+  }
+
+  void age() {
+    // halve all counters; the mask clears the bit shifted in from the
+    // neighbouring counter
+    uint64_t n = numWords(_width);
+    for (uint64_t i = 0; i < n; i++) {
+      uint64_t expected = _words[i].load(std::memory_order_relaxed);
+      while (!_words[i].compare_exchange_weak(
+          expected, (expected >> 1) & 0x7777777777777777ULL,
+          std::memory_order_relaxed)) {
+      }
+    }
+    _additions -= (_sampleSize / 2);
+  }
+};
+
+};  // end namespace cache
+};  // end namespace arangodb
+
+#endif
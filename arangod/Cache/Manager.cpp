@@ -24,6 +24,7 @@
 #include "Cache/Manager.h"
 #include "Basics/Common.h"
 #include "Basics/asio-helper.h"
+#include "Basics/system-functions.h"
 #include "Cache/Cache.h"
 #include "Cache/CachedValue.h"
 #include "Cache/Common.h"
@@ -88,6 +89,7 @@ Manager::Manager(boost::asio::io_service* ioService, uint64_t globalLimit,
                        _accessStats.memoryUsage()),
       _spareTableAllocation(0),
       _globalAllocation(_fixedAllocation),
+      _compressedLimit(0),
       _transactions(),
       _ioService(ioService),
       _resizeAttempt(0),
@@ -95,7 +97,8 @@ Manager::Manager(boost::asio::io_service* ioService, uint64_t globalLimit,
       _rebalancingTasks(0),
       _resizingTasks(0),
       _rebalanceCompleted(std::chrono::steady_clock::now() -
-                          Manager::rebalancingGracePeriod) {
+                          Manager::rebalancingGracePeriod),
+      _rebalanceHistory() {
   TRI_ASSERT(_globalAllocation < _globalSoftLimit);
   TRI_ASSERT(_globalAllocation < _globalHardLimit);
   if (enableWindowedStats) {
@@ -114,7 +117,8 @@ Manager::~Manager() { shutdown(); }
 
 std::shared_ptr<Cache> Manager::createCache(CacheType type,
                                             bool enableWindowedStats,
-                                            uint64_t maxSize) {
+                                            uint64_t maxSize,
+                                            std::string const& name) {
   std::shared_ptr<Cache> result(nullptr);
   _state.lock();
   bool allowed = isOperational();
@@ -151,6 +155,9 @@ std::shared_ptr<Cache> Manager::createCache(CacheType type,
   }
 
   if (result.get() != nullptr) {
+    // set before the cache becomes visible to statistics readers
+    result->_name = name;
+    result->_type = type;
     _caches.emplace(result);
   }
   _state.unlock();
@@ -233,6 +240,12 @@ bool Manager::resize(uint64_t newGlobalLimit) {
   return success;
 }
 
+void Manager::setCompressedLimit(uint64_t limit) {
+  _compressedLimit.store(limit);
+}
+
+uint64_t Manager::compressedLimit() const { return _compressedLimit.load(); }
+
 uint64_t Manager::globalLimit() {
   _state.lock();
   uint64_t limit =
@@ -250,6 +263,29 @@ uint64_t Manager::globalAllocation() {
   return allocation;
 }
 
+std::vector<CacheStatistics> Manager::cacheStatistics() {
+  std::vector<CacheStatistics> result;
+  _state.lock();
+  if (isOperational()) {
+    result.reserve(_caches.size());
+    for (auto const& cache : _caches) {
+      result.emplace_back(cache->statistics());
+    }
+  }
+  _state.unlock();
+
+  return result;
+}
+
+std::vector<Manager::RebalanceRecord> Manager::rebalanceHistory() {
+  _state.lock();
+  std::vector<RebalanceRecord> result(_rebalanceHistory.begin(),
+                                      _rebalanceHistory.end());
+  _state.unlock();
+
+  return result;
+}
+
 std::pair<double, double> Manager::globalHitRates() {
   double lifetimeRate = std::nan("");
   double windowedRate = std::nan("");
@@ -439,6 +475,19 @@ std::pair<bool, Manager::time_point> Manager::requestMigrate(
   return std::make_pair(allowed, nextRequest);
 }
 
+std::vector<std::pair<std::shared_ptr<Cache>, uint64_t>>
+Manager::accessFrequencies() {
+  std::vector<std::pair<std::shared_ptr<Cache>, uint64_t>> result;
+  auto stats = _accessStats.getFrequencies();
+  result.reserve(stats->size());
+  for (auto const& s : *stats) {
+    if (auto cache = s.first.lock()) {
+      result.emplace_back(std::move(cache), s.second);
+    }
+  }
+  return result;
+}
+
 void Manager::reportAccess(std::shared_ptr<Cache> cache) {
   // if (((++_accessCounter) & static_cast<uint64_t>(7)) == 0) {  // record 1
   // in
@@ -537,6 +586,8 @@ bool Manager::rebalance(bool onlyCalculate) {
   std::shared_ptr<PriorityList> cacheList = priorityList();
   std::shared_ptr<Cache> cache;
   double weight;
+  uint64_t adjusted = 0;
+  uint64_t compressedLimit = _compressedLimit.load();
   for (auto pair : (*cacheList)) {
     std::tie(cache, weight) = pair;
     uint64_t newDeserved = static_cast<uint64_t>(
@@ -552,12 +603,30 @@ bool Manager::rebalance(bool onlyCalculate) {
 #endif
     Metadata* metadata = cache->metadata();
     metadata->lock();
-    metadata->adjustDeserved(newDeserved);
+    uint64_t oldDeserved = metadata->deservedSize;
+    if (metadata->adjustDeserved(newDeserved) != oldDeserved) {
+      adjusted++;
+    }
     metadata->unlock();
+
+    if (cache->_type == CacheType::Plain) {
+      cache->setCompressedTierLimit(static_cast<uint64_t>(
+          std::floor(weight * static_cast<double>(compressedLimit))));
+    }
   }
 
   if (!onlyCalculate) {
-    shrinkOvergrownCaches(TaskEnvironment::rebalancing);
+    uint64_t shrunk = shrinkOvergrownCaches(TaskEnvironment::rebalancing);
+
+    for (auto const& c : _caches) {
+      c->sampleHitRate();
+    }
+    _rebalanceHistory.emplace_back(
+        RebalanceRecord{TRI_microtime(), static_cast<uint64_t>(_caches.size()),
+                        adjusted, shrunk, _globalAllocation});
+    while (_rebalanceHistory.size() > Manager::rebalanceHistoryCapacity) {
+      _rebalanceHistory.pop_front();
+    }
 
     if (_rebalancingTasks.load() == 0) {
       _rebalanceCompleted = std::chrono::steady_clock::now();
@@ -570,8 +639,9 @@ bool Manager::rebalance(bool onlyCalculate) {
   return true;
 }
 
-void Manager::shrinkOvergrownCaches(Manager::TaskEnvironment environment) {
+uint64_t Manager::shrinkOvergrownCaches(Manager::TaskEnvironment environment) {
   TRI_ASSERT(_state.isLocked());
+  uint64_t shrunk = 0;
   for (std::shared_ptr<Cache> cache : _caches) {
     // skip this cache if it is already resizing or shutdown!
     if (!cache->canResize()) {
@@ -583,10 +653,13 @@ void Manager::shrinkOvergrownCaches(Manager::TaskEnvironment environment) {
 
     if (metadata->allocatedSize > metadata->deservedSize) {
       resizeCache(environment, cache, metadata->newLimit());  // unlocks cache
+      shrunk++;
     } else {
       metadata->unlock();
     }
   }
+
+  return shrunk;
 }
 
 void Manager::freeUnusedTables() {
@@ -38,10 +38,13 @@
 #include <stdint.h>
 #include <atomic>
 #include <chrono>
+#include <deque>
 #include <memory>
 #include <set>
 #include <stack>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace arangodb {
 namespace cache {
@@ -87,6 +90,20 @@ class Manager {
   typedef std::vector<std::pair<std::shared_ptr<Cache>, double>> PriorityList;
   typedef std::chrono::time_point<std::chrono::steady_clock> time_point;
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Outcome of a single rebalancing round.
+  ///
+  /// The timestamp is in seconds since the epoch. Adjusted counts the caches
+  /// whose deserved size changed, shrunk those which had to give memory back.
+  //////////////////////////////////////////////////////////////////////////////
+  struct RebalanceRecord {
+    double timestamp;
+    uint64_t caches;
+    uint64_t adjusted;
+    uint64_t shrunk;
+    uint64_t globalAllocation;
+  };
+
  public:
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Initialize the manager with an io_service and global usage limit.
@@ -106,11 +123,13 @@ class Manager {
   /// recent window in time, rather than over the full lifetime of the cache.
   /// The third parameter controls the maximum size of the cache over its
   /// lifetime. It should likely only be set to a non-default value for
-  /// infrequently accessed or short-lived caches.
+  /// infrequently accessed or short-lived caches. The name is only used to
+  /// identify the cache in statistics.
   //////////////////////////////////////////////////////////////////////////////
   std::shared_ptr<Cache> createCache(CacheType type,
                                      bool enableWindowedStats = false,
-                                     uint64_t maxSize = UINT64_MAX);
+                                     uint64_t maxSize = UINT64_MAX,
+                                     std::string const& name = "");
 
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Destroy the given cache.
@@ -137,6 +156,18 @@ class Manager {
   //////////////////////////////////////////////////////////////////////////////
   uint64_t globalLimit();
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Change the memory budget shared by the compressed second tiers of
+  /// all caches. The budget is distributed during rebalancing, using the same
+  /// weights as the primary allocations. Zero disables the tiers.
+  //////////////////////////////////////////////////////////////////////////////
+  void setCompressedLimit(uint64_t limit);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Report the memory budget of the compressed second tiers.
+  //////////////////////////////////////////////////////////////////////////////
+  uint64_t compressedLimit() const;
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Report the current amoutn of memory allocated to all caches.
   ///
@@ -149,6 +180,24 @@ class Manager {
 
   std::pair<double, double> globalHitRates();
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Report the number of recent accesses to each cache.
+  ///
+  /// These are the access statistics used for rebalancing, thus only caches
+  /// accessed within the recent window are contained.
+  //////////////////////////////////////////////////////////////////////////////
+  std::vector<std::pair<std::shared_ptr<Cache>, uint64_t>> accessFrequencies();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Report the sizes and counters of all registered caches.
+  //////////////////////////////////////////////////////////////////////////////
+  std::vector<CacheStatistics> cacheStatistics();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Report the most recent rebalancing rounds, oldest first.
+  //////////////////////////////////////////////////////////////////////////////
+  std::vector<RebalanceRecord> rebalanceHistory();
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Open a new transaction.
   ///
@@ -200,6 +249,7 @@ class Manager {
   uint64_t _fixedAllocation;
   uint64_t _spareTableAllocation;
   uint64_t _globalAllocation;
+  std::atomic<uint64_t> _compressedLimit;
 
   // transaction management
   TransactionManager _transactions;
@@ -213,6 +263,10 @@ class Manager {
   std::atomic<uint64_t> _resizingTasks;
   Manager::time_point _rebalanceCompleted;
 
+  // outcomes of recent rebalancing rounds, protected by _state
+  static constexpr size_t rebalanceHistoryCapacity = 64;
+  std::deque<RebalanceRecord> _rebalanceHistory;
+
   // friend class tasks and caches to allow access
   friend class Cache;
   friend class FreeMemoryTask;
@@ -259,7 +313,7 @@ class Manager {
   bool rebalance(bool onlyCalculate = false);
 
   // helpers for global resizing
-  void shrinkOvergrownCaches(TaskEnvironment environment);
+  uint64_t shrinkOvergrownCaches(TaskEnvironment environment);
   void freeUnusedTables();
   bool adjustGlobalLimitsIfAllowed(uint64_t newGlobalLimit);
 
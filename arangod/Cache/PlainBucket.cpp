@@ -64,6 +64,20 @@ bool PlainBucket::isFull() const {
   return !hasEmptySlot;
 }
 
+bool PlainBucket::mayContain(uint32_t hash) const {
+  uint32_t snapshot = _state.snapshot();
+  if (State::isSet(snapshot, State::Flag::locked) ||
+      State::isSet(snapshot, State::Flag::migrated)) {
+    return true;
+  }
+
+  // may read torn values if a writer sneaks in, but then the validation
+  // below fails
+  bool found = containsHash(&_cachedHashes[0], slotsData, hash);
+
+  return (found || !_state.validate(snapshot));
+}
+
 CachedValue* PlainBucket::find(uint32_t hash, void const* key, uint32_t keySize,
                                bool moveToFront) {
   TRI_ASSERT(isLocked());
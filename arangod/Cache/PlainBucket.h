@@ -103,6 +103,19 @@ struct PlainBucket {
   CachedValue* find(uint32_t hash, void const* key, uint32_t keySize,
                     bool moveToFront = true);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Checks whether the bucket may contain an entry with the given
+  /// hash. Does not require state to be locked.
+  ///
+  /// Compares all slot hashes optimistically and validates the result against
+  /// concurrent writers. Returns false only if no slot held the hash and the
+  /// bucket did not change meanwhile, so that a lookup can report a miss
+  /// without locking the bucket. Returns true if the hash was found, or if
+  /// the bucket was locked, modified or migrated during the check. In that
+  /// case the caller must lock the bucket and use find().
+  //////////////////////////////////////////////////////////////////////////////
+  bool mayContain(uint32_t hash) const;
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Inserts a given value. Requires state to be locked.
   ///
@@ -43,19 +43,45 @@ using namespace arangodb::cache;
 
 Finding PlainCache::find(void const* key, uint32_t keySize) {
   TRI_ASSERT(key != nullptr);
+  return findHashed(hashKey(key, keySize), key, keySize, true);
+}
+
+Finding PlainCache::findHashed(uint32_t hash, void const* key, uint32_t keySize,
+                               bool singleOperation) {
   Finding result;
-  uint32_t hash = hashKey(key, keySize);
 
   Result status;
   PlainBucket* bucket;
   std::shared_ptr<Table> source;
-  std::tie(status, bucket, source) = getBucket(hash, Cache::triesFast);
+  std::tie(status, bucket, source) =
+      getBucket(hash, Cache::triesFast, singleOperation, false);
 
   if (status.ok()) {
-    result.set(bucket->find(hash, key, keySize));
-    recordStat(result.found() ? Stat::findHit : Stat::findMiss);
-    bucket->unlock();
-    endOperation();
+    // misses are detected without locking the bucket. hits need the lock to
+    // lease the value and to move it to the front
+    if (bucket->mayContain(hash)) {
+      if (bucket->lock(Cache::triesFast)) {
+        result.set(bucket->find(hash, key, keySize));
+        bucket->unlock();
+      } else {
+        status.reset(TRI_ERROR_LOCK_TIMEOUT);
+      }
+    }
+
+    if (status.ok() && !result.found() && _compressedTier.isEnabled()) {
+      promote(hash, key, keySize, result);
+    }
+
+    if (status.ok()) {
+      recordStat(result.found() ? Stat::findHit : Stat::findMiss);
+      recordAccess(hash);
+      recordKey(key, keySize);
+    } else {
+      result.reportError(status);
+    }
+    if (singleOperation) {
+      endOperation();
+    }
   } else {
     result.reportError(status);
   }
@@ -65,16 +91,22 @@ Finding PlainCache::find(void const* key, uint32_t keySize) {
 
 Result PlainCache::insert(CachedValue* value) {
   TRI_ASSERT(value != nullptr);
-  uint32_t hash = hashKey(value->key(), value->keySize);
+  return insertHashed(hashKey(value->key(), value->keySize), value, true);
+}
+
+Result PlainCache::insertHashed(uint32_t hash, CachedValue* value,
+                                bool singleOperation) {
+  TRI_ASSERT(value != nullptr);
 
   Result status;
   PlainBucket* bucket;
   std::shared_ptr<Table> source;
-  std::tie(status, bucket, source) = getBucket(hash, Cache::triesFast);
+  std::tie(status, bucket, source) = getBucket(hash, Cache::triesFast, singleOperation);
 
   if (status.ok()) {
     bool allowed = true;
     bool maybeMigrate = false;
+    CachedValue* evicted = nullptr;
     int64_t change = static_cast<int64_t>(value->size());
     CachedValue* candidate = bucket->find(hash, value->key(), value->keySize);
 
@@ -83,6 +115,11 @@ Result PlainCache::insert(CachedValue* value) {
       if (candidate == nullptr) {
         allowed = false;
         status.reset(TRI_ERROR_ARANGO_BUSY);
+      } else if (!admit(hash, candidate)) {
+        // the victim is more popular than the new entry, keep it
+        allowed = false;
+        maybeMigrate = reportRejection();
+        status.reset(TRI_ERROR_ARANGO_BUSY);
       }
     }
 
@@ -101,9 +138,11 @@ Result PlainCache::insert(CachedValue* value) {
           bucket->evict(candidate, true);
           if (!candidate->sameKey(value->key(), value->keySize)) {
             eviction = true;
+            evicted = candidate;
+          } else {
+            freeValue(candidate);
           }
-          freeValue(candidate);
-      }
+        }
         bucket->insert(hash, value);
         if (!eviction) {
           maybeMigrate = source->slotFilled();
@@ -115,11 +154,25 @@ Result PlainCache::insert(CachedValue* value) {
       }
     }
 
+    // the compressed tier is only changed under the bucket lock, so that
+    // copies of a key cannot be reordered against its inserts and removals
+    if (evicted != nullptr) {
+      _compressedTier.store(evicted);
+    }
+    if (status.ok()) {
+      // the cached value supersedes any compressed copy
+      _compressedTier.remove(value->key(), value->keySize);
+    }
     bucket->unlock();
+    if (evicted != nullptr) {
+      freeValue(evicted);
+    }
     if (maybeMigrate) {
       requestMigrate(_table->idealSize());  // let function do the hard work
     }
-    endOperation();
+    if (singleOperation) {
+      endOperation();
+    }
   }
 
   return status;
@@ -149,12 +202,15 @@ Result PlainCache::remove(void const* key, uint32_t keySize) {
       freeValue(candidate);
       maybeMigrate = source->slotEmptied();
     }
+    _compressedTier.remove(key, keySize);
 
     bucket->unlock();
     if (maybeMigrate) {
       requestMigrate(_table->idealSize());
     }
     endOperation();
+  } else {
+    _compressedTier.remove(key, keySize);
   }
 
   return status;
@@ -166,6 +222,7 @@ Result PlainCache::blacklist(void const* key, uint32_t keySize) {
 
 uint64_t PlainCache::allocationSize(bool enableWindowedStats) {
   return sizeof(PlainCache) +
+         FrequencySketch::allocationSize(_admissionCapacity) +
          (enableWindowedStats ? (sizeof(StatBuffer) +
                                  StatBuffer::allocationSize(_findStatsCapacity))
                               : 0);
@@ -210,11 +267,15 @@ uint64_t PlainCache::freeMemoryFrom(uint32_t hash) {
     if (candidate != nullptr) {
       reclaimed = candidate->size();
       bucket->evict(candidate);
-      freeValue(candidate);
+      _compressedTier.store(candidate);
       maybeMigrate = source->slotEmptied();
     }
 
     bucket->unlock();
+
+    if (candidate != nullptr) {
+      freeValue(candidate);
+    }
   }
 
   if (maybeMigrate) {
@@ -285,8 +346,75 @@ void PlainCache::migrateBucket(void* sourcePtr,
   source->unlock();
 }
 
+void PlainCache::promote(uint32_t hash, void const* key, uint32_t keySize,
+                         Finding& result) {
+  Result status;
+  PlainBucket* bucket;
+  std::shared_ptr<Table> source;
+  std::tie(status, bucket, source) = getBucket(hash, Cache::triesFast, false);
+  if (status.fail()) {
+    return;
+  }
+
+  // the bucket lock orders the promotion against concurrent inserts and
+  // removals of the same key, so a stale copy can never replace a newer value
+  CachedValue* value = bucket->find(hash, key, keySize);
+  if (value != nullptr) {
+    result.set(value);
+    bucket->unlock();
+    return;
+  }
+
+  value = _compressedTier.take(key, keySize);
+  if (value == nullptr) {
+    bucket->unlock();
+    return;
+  }
+
+  bool maybeMigrate = false;
+  int64_t change = static_cast<int64_t>(value->size());
+  CachedValue* candidate = nullptr;
+  if (bucket->isFull()) {
+    candidate = bucket->evictionCandidate();
+  }
+
+  bool allowed = (candidate != nullptr || !bucket->isFull());
+  if (allowed) {
+    if (candidate != nullptr) {
+      change -= static_cast<int64_t>(candidate->size());
+    }
+    _metadata.lock();
+    allowed = _metadata.adjustUsageIfAllowed(change);
+    _metadata.unlock();
+  }
+
+  if (allowed) {
+    if (candidate != nullptr) {
+      bucket->evict(candidate, true);
+      _compressedTier.store(candidate);
+    } else {
+      maybeMigrate = source->slotFilled();
+    }
+    bucket->insert(hash, value);
+    maybeMigrate |= reportInsert(candidate != nullptr);
+    result.set(value);
+  } else {
+    // put the copy back rather than losing it
+    _compressedTier.store(value);
+    candidate = value;
+  }
+
+  bucket->unlock();
+  if (candidate != nullptr) {
+    freeValue(candidate);
+  }
+  if (maybeMigrate) {
+    requestMigrate(_table->idealSize());
+  }
+}
+
 std::tuple<Result, PlainBucket*, std::shared_ptr<Table>> PlainCache::getBucket(
-    uint32_t hash, int64_t maxTries, bool singleOperation) {
+    uint32_t hash, int64_t maxTries, bool singleOperation, bool lockBucket) {
   Result status;
   PlainBucket* bucket = nullptr;
   std::shared_ptr<Table> source(nullptr);
@@ -302,7 +430,8 @@ std::tuple<Result, PlainBucket*, std::shared_ptr<Table>> PlainCache::getBucket(
         _manager->reportAccess(shared_from_this());
       }
 
-      auto pair = _table->fetchAndLockBucket(hash, maxTries);
+      auto pair = lockBucket ? _table->fetchAndLockBucket(hash, maxTries)
+                             : _table->fetchBucket(hash, maxTries);
       bucket = reinterpret_cast<PlainBucket*>(pair.first);
       source = pair.second;
       ok = (bucket != nullptr);
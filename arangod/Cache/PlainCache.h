@@ -110,6 +110,10 @@ class PlainCache final : public Cache {
                                        std::shared_ptr<Table> table,
                                        bool enableWindowedStats);
 
+  virtual Finding findHashed(uint32_t hash, void const* key, uint32_t keySize,
+                             bool singleOperation);
+  virtual Result insertHashed(uint32_t hash, CachedValue* value,
+                              bool singleOperation);
   virtual uint64_t freeMemoryFrom(uint32_t hash);
   virtual void migrateBucket(void* sourcePtr,
                              std::unique_ptr<Table::Subtable> targets,
@@ -117,9 +121,14 @@ class PlainCache final : public Cache {
 
   // helpers
   std::tuple<Result, PlainBucket*, std::shared_ptr<Table>> getBucket(
-      uint32_t hash, int64_t maxTries, bool singleOperation = true);
+      uint32_t hash, int64_t maxTries, bool singleOperation = true,
+      bool lockBucket = true);
   uint32_t getIndex(uint32_t hash, bool useAuxiliary) const;
 
+  // moves the compressed copy of a missed key back into the table
+  void promote(uint32_t hash, void const* key, uint32_t keySize,
+               Finding& result);
+
   static Table::BucketClearer bucketClearer(Metadata* metadata);
 };
 
@@ -66,7 +66,10 @@ bool State::lock(int64_t maxTries, State::CallbackType cb) {
 
 void State::unlock() {
   TRI_ASSERT(isLocked());
-  _state &= ~static_cast<uint32_t>(Flag::locked);
+  // clear the lock bit and increment the version in one step. the version
+  // simply wraps around
+  _state.fetch_add(versionIncrement - static_cast<uint32_t>(Flag::locked),
+                   std::memory_order_release);
 }
 
 bool State::isSet(State::Flag flag) const {
@@ -86,5 +89,20 @@ void State::toggleFlag(State::Flag flag) {
 
 void State::clear() {
   TRI_ASSERT(isLocked());
-  _state = static_cast<uint32_t>(Flag::locked);
+  _state = (_state.load() & ~(versionIncrement - 1)) |
+           static_cast<uint32_t>(Flag::locked);
+}
+
+uint32_t State::snapshot() const {
+  return _state.load(std::memory_order_acquire);
+}
+
+bool State::validate(uint32_t snapshot) const {
+  // order the preceding optimistic reads before re-reading the state
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return (_state.load(std::memory_order_relaxed) == snapshot);
+}
+
+bool State::isSet(uint32_t snapshot, State::Flag flag) {
+  return ((snapshot & static_cast<uint32_t>(flag)) > 0);
 }
@@ -42,6 +42,11 @@ namespace cache {
 /// state is locked and, of course, to lock it. Any flags besides the lock flag
 /// are treated uniformly, and can be checked or toggled. Each flag is defined
 /// via an enum and must correspond to exactly one set bit.
+///
+/// The bits above the flags hold a version which is incremented on every
+/// unlock. This allows optimistic reads of the data guarded by the state: a
+/// reader takes a snapshot, reads without locking, and then validates that
+/// the state still matches the snapshot.
 ////////////////////////////////////////////////////////////////////////////////
 struct State {
   typedef std::function<void()> CallbackType;
@@ -120,7 +125,27 @@ struct State {
   //////////////////////////////////////////////////////////////////////////////
   void clear();
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Takes a snapshot for an optimistic read. Does not require the
+  /// state to be locked.
+  //////////////////////////////////////////////////////////////////////////////
+  uint32_t snapshot() const;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Checks whether the state has not changed since the snapshot was
+  /// taken. Must be called after the optimistic reads.
+  //////////////////////////////////////////////////////////////////////////////
+  bool validate(uint32_t snapshot) const;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Checks whether the given flag is set in a snapshot.
+  //////////////////////////////////////////////////////////////////////////////
+  static bool isSet(uint32_t snapshot, State::Flag flag);
+
  private:
+  // the lowest bit of the version, all flags must be below it
+  static constexpr uint32_t versionIncrement = 0x00000400;
+
   std::atomic<uint32_t> _state;
 };
 
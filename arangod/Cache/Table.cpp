@@ -49,6 +49,10 @@ bool Table::GenericBucket::isMigrated() const {
   return _state.isSet(State::Flag::migrated);
 }
 
+bool Table::GenericBucket::mayBeMigrated() const {
+  return State::isSet(_state.snapshot(), State::Flag::migrated);
+}
+
 Table::Subtable::Subtable(std::shared_ptr<Table> source, GenericBucket* buckets,
                           uint64_t size, uint32_t mask, uint32_t shift)
     : _source(source),
@@ -79,11 +83,13 @@ Table::Table(uint32_t logSize)
       _size(static_cast<uint64_t>(1) << _logSize),
       _shift(32 - _logSize),
       _mask((uint32_t)((_size - 1) << _shift)),
-      _buffer(new uint8_t[(_size * BUCKET_SIZE) + Table::padding]),
+      _buffer(allocateBuffer((_size * BUCKET_SIZE) + Table::padding),
+              BufferDeleter{(_size * BUCKET_SIZE) + Table::padding}),
       _buckets(reinterpret_cast<GenericBucket*>(
           reinterpret_cast<uint64_t>((_buffer.get() + (BUCKET_SIZE - 1))) &
           ~(static_cast<uint64_t>(BUCKET_SIZE - 1)))),
       _auxiliary(nullptr),
+      _migrationCursor(0),
       _bucketClearer(defaultClearer),
       _slotsTotal(_size),
       _slotsUsed(static_cast<uint64_t>(0)) {
@@ -93,6 +99,14 @@ Table::Table(uint32_t logSize)
   _state.unlock();
 }
 
+uint8_t* Table::allocateBuffer(size_t size) {
+  void* buffer = MemoryArenas::allocate(MemoryArena::CACHE, size);
+  if (buffer == nullptr) {
+    throw std::bad_alloc();
+  }
+  return static_cast<uint8_t*>(buffer);
+}
+
 uint64_t Table::allocationSize(uint32_t logSize) {
   return sizeof(Table) + (BUCKET_SIZE * (static_cast<uint64_t>(1) << logSize)) +
          Table::padding;
@@ -112,23 +126,58 @@ std::pair<void*, std::shared_ptr<Table>> Table::fetchAndLockBucket(
   if (ok) {
     ok = !_state.isSet(State::Flag::disabled);
     if (ok) {
-      bucket = &(_buckets[(hash & _mask) >> _shift]);
-      source = shared_from_this();
-      ok = bucket->lock(maxTries);
-      if (ok) {
-        if (bucket->isMigrated()) {
-          bucket->unlock();
+      uint64_t index = (hash & _mask) >> _shift;
+      bool migrated = isBehindMigrationCursor(index);
+      if (!migrated) {
+        bucket = &(_buckets[index]);
+        source = shared_from_this();
+        ok = bucket->lock(maxTries);
+        if (ok) {
+          migrated = bucket->isMigrated();
+          if (migrated) {
+            bucket->unlock();
+          }
+        } else {
+          // the bucket may have been locked by the migration, which has
+          // moved on in the meantime
+          migrated = isBehindMigrationCursor(index);
+        }
+        if (!ok || migrated) {
           bucket = nullptr;
           source.reset();
-          if (_auxiliary.get() != nullptr) {
-            auto pair = _auxiliary->fetchAndLockBucket(hash, maxTries);
-            bucket = reinterpret_cast<GenericBucket*>(pair.first);
-            source = pair.second;
-          }
         }
-      } else {
+      }
+      if (migrated && _auxiliary.get() != nullptr) {
+        auto pair = _auxiliary->fetchAndLockBucket(hash, maxTries);
+        bucket = reinterpret_cast<GenericBucket*>(pair.first);
+        source = pair.second;
+      }
+    }
+    _state.unlock();
+  }
+
+  return std::make_pair(bucket, source);
+}
+
+std::pair<void*, std::shared_ptr<Table>> Table::fetchBucket(
+    uint32_t hash, int64_t maxTries) {
+  GenericBucket* bucket = nullptr;
+  std::shared_ptr<Table> source(nullptr);
+  bool ok = _state.lock(maxTries);
+  if (ok) {
+    ok = !_state.isSet(State::Flag::disabled);
+    if (ok) {
+      uint64_t index = (hash & _mask) >> _shift;
+      bucket = &(_buckets[index]);
+      source = shared_from_this();
+      if (isBehindMigrationCursor(index) || bucket->mayBeMigrated()) {
         bucket = nullptr;
         source.reset();
+        if (_auxiliary.get() != nullptr) {
+          auto pair = _auxiliary->fetchBucket(hash, maxTries);
+          bucket = reinterpret_cast<GenericBucket*>(pair.first);
+          source = pair.second;
+        }
       }
     }
     _state.unlock();
@@ -137,6 +186,18 @@ std::pair<void*, std::shared_ptr<Table>> Table::fetchAndLockBucket(
   return std::make_pair(bucket, source);
 }
 
+void Table::prefetchBucket(uint32_t hash) const {
+#if defined(__GNUC__)
+  auto bucket = reinterpret_cast<char const*>(
+      &(_buckets[(hash & _mask) >> _shift]));
+  for (size_t offset = 0; offset < BUCKET_SIZE; offset += 64) {
+    __builtin_prefetch(bucket + offset);
+  }
+#else
+  (void)hash;
+#endif
+}
+
 std::shared_ptr<Table> Table::setAuxiliary(std::shared_ptr<Table> table) {
   std::shared_ptr<Table> result = table;
   if (table.get() != this) {
@@ -144,8 +205,10 @@ std::shared_ptr<Table> Table::setAuxiliary(std::shared_ptr<Table> table) {
     if (table.get() == nullptr) {
       result = _auxiliary;
       _auxiliary = table;
+      _migrationCursor.store(0, std::memory_order_release);
     } else if (_auxiliary.get() == nullptr) {
       _auxiliary = table;
+      _migrationCursor.store(0, std::memory_order_release);
       result.reset();
     }
     _state.unlock();
@@ -160,6 +223,11 @@ void* Table::primaryBucket(uint64_t index) {
   return &(_buckets[index]);
 }
 
+void Table::advanceMigration(uint64_t migratedBuckets) {
+  TRI_ASSERT(migratedBuckets <= _size);
+  _migrationCursor.store(migratedBuckets, std::memory_order_release);
+}
+
 std::unique_ptr<Table::Subtable> Table::auxiliaryBuckets(uint32_t index) {
   if (!isEnabled()) {
     return std::unique_ptr<Subtable>(nullptr);
@@ -205,6 +273,7 @@ void Table::clear() {
   }
   _bucketClearer = Table::defaultClearer;
   _slotsUsed = 0;
+  _migrationCursor.store(0, std::memory_order_release);
 }
 
 void Table::disable() {
@@ -276,6 +345,10 @@ uint32_t Table::idealSize() {
                      : logSize()));
 }
 
+bool Table::isBehindMigrationCursor(uint64_t index) const {
+  return (index < _migrationCursor.load(std::memory_order_acquire));
+}
+
 void Table::defaultClearer(void* ptr) {
   throw std::invalid_argument("must register a clearer");
 }
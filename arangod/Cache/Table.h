@@ -25,6 +25,7 @@
 #define ARANGODB_CACHE_TABLE_H
 
 #include "Basics/Common.h"
+#include "Basics/MemoryArenas.h"
 #include "Cache/Common.h"
 #include "Cache/State.h"
 
@@ -56,6 +57,7 @@ class Table : public std::enable_shared_from_this<Table> {
     bool lock(int64_t maxTries);
     void unlock();
     bool isMigrated() const;
+    bool mayBeMigrated() const;
   };
   static_assert(sizeof(GenericBucket) == BUCKET_SIZE,
                 "Expected sizeof(GenericBucket) == BUCKET_SIZE.");
@@ -114,12 +116,34 @@ class Table : public std::enable_shared_from_this<Table> {
   /// Returns nullptrs if it could not lock the bucket within maxTries
   /// attempts. If maxTries is negative, it will not limit the number of
   /// attempts. If the primary bucket is migrated, it will attempt a lookup in
-  /// the auxiliary table. The second member of the returned pair is the source
-  /// table for the bucket returned as the first member.
+  /// the auxiliary table. Buckets behind the migration cursor are fetched from
+  /// the auxiliary table directly, without touching the primary bucket. The
+  /// second member of the returned pair is the source table for the bucket
+  /// returned as the first member.
   //////////////////////////////////////////////////////////////////////////////
   std::pair<void*, std::shared_ptr<Table>> fetchAndLockBucket(
       uint32_t hash, int64_t maxTries = -1);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Fetches a pointer to the bucket mapped by the given hash, without
+  /// locking it.
+  ///
+  /// Only meant for optimistic reads, the bucket must be locked before using
+  /// anything but its optimistic read methods. Follows the migration to the
+  /// auxiliary table like fetchAndLockBucket, but as the migration flag is
+  /// read without locking the bucket, the result may be stale.
+  //////////////////////////////////////////////////////////////////////////////
+  std::pair<void*, std::shared_ptr<Table>> fetchBucket(uint32_t hash,
+                                                       int64_t maxTries = -1);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Hints the CPU to load the primary bucket for the given hash.
+  ///
+  /// Does not lock anything and never faults, so it may be called for a
+  /// table which is being migrated.
+  //////////////////////////////////////////////////////////////////////////////
+  void prefetchBucket(uint32_t hash) const;
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Sets the auxiliary table.
   ///
@@ -136,6 +160,16 @@ class Table : public std::enable_shared_from_this<Table> {
   //////////////////////////////////////////////////////////////////////////////
   void* primaryBucket(uint64_t index);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Advances the migration cursor.
+  ///
+  /// Buckets are migrated in index order; once the primary buckets below the
+  /// given index have been marked migrated, lookups for them go straight to
+  /// the auxiliary table. The cursor is reset whenever the auxiliary table
+  /// changes.
+  //////////////////////////////////////////////////////////////////////////////
+  void advanceMigration(uint64_t migratedBuckets);
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Returns a subtable in the auxiliary index which corresponds to the
   /// specified bucket in the primary table.
@@ -194,10 +228,19 @@ class Table : public std::enable_shared_from_this<Table> {
   uint64_t _size;
   uint32_t _shift;
   uint32_t _mask;
-  std::unique_ptr<uint8_t[]> _buffer;
+
+  // the buckets are allocated from the cache's memory arena
+  struct BufferDeleter {
+    size_t size;
+    void operator()(uint8_t* buffer) const {
+      MemoryArenas::deallocate(MemoryArena::CACHE, buffer, size);
+    }
+  };
+  std::unique_ptr<uint8_t, BufferDeleter> _buffer;
   GenericBucket* _buckets;
 
   std::shared_ptr<Table> _auxiliary;
+  std::atomic<uint64_t> _migrationCursor;
 
   BucketClearer _bucketClearer;
 
@@ -207,7 +250,9 @@ class Table : public std::enable_shared_from_this<Table> {
  private:
   void disable();
   bool isEnabled(int64_t maxTries = triesGuarantee);
+  bool isBehindMigrationCursor(uint64_t index) const;
   static void defaultClearer(void* ptr);
+  static uint8_t* allocateBuffer(size_t size);
 };
 
 };  // end namespace cache
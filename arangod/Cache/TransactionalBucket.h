@@ -115,6 +115,15 @@ struct TransactionalBucket {
   CachedValue* find(uint32_t hash, void const* key, uint32_t keySize,
                     bool moveToFront = true);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Checks whether the bucket may contain an entry with the given
+  /// hash. Does not require state to be locked.
+  ///
+  /// Works like PlainBucket::mayContain. Blacklisted hashes are not treated
+  /// specially, as a miss is always a valid answer for them.
+  //////////////////////////////////////////////////////////////////////////////
+  bool mayContain(uint32_t hash) const;
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Inserts a given value if it is not blacklisted. Requires state to
   /// be locked.
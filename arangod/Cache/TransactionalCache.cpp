@@ -44,19 +44,41 @@ using namespace arangodb::cache;
 
 Finding TransactionalCache::find(void const* key, uint32_t keySize) {
   TRI_ASSERT(key != nullptr);
+  return findHashed(hashKey(key, keySize), key, keySize, true);
+}
+
+Finding TransactionalCache::findHashed(uint32_t hash, void const* key, uint32_t keySize,
+                                       bool singleOperation) {
   Finding result;
-  uint32_t hash = hashKey(key, keySize);
 
   Result status;
   TransactionalBucket* bucket;
   std::shared_ptr<Table> source;
-  std::tie(status, bucket, source) = getBucket(hash, Cache::triesFast);
+  std::tie(status, bucket, source) =
+      getBucket(hash, Cache::triesFast, singleOperation, false);
 
   if (status.ok()) {
-    result.set(bucket->find(hash, key, keySize));
-    recordStat(result.found() ? Stat::findHit : Stat::findMiss);
-    bucket->unlock();
-    endOperation();
+    // misses are detected without locking the bucket. hits need the lock to
+    // lease the value and to move it to the front. the blacklist term is
+    // only updated for locked accesses, a miss is always safe
+    if (bucket->mayContain(hash)) {
+      if (bucket->lock(Cache::triesFast)) {
+        bucket->updateBlacklistTerm(_manager->_transactions.term());
+        result.set(bucket->find(hash, key, keySize));
+        bucket->unlock();
+      } else {
+        status.reset(TRI_ERROR_LOCK_TIMEOUT);
+      }
+    }
+
+    if (status.ok()) {
+      recordStat(result.found() ? Stat::findHit : Stat::findMiss);
+      recordAccess(hash);
+      recordKey(key, keySize);
+    }
+    if (singleOperation) {
+      endOperation();
+    }
   }
 
   return result;
@@ -64,12 +86,17 @@ Finding TransactionalCache::find(void const* key, uint32_t keySize) {
 
 Result TransactionalCache::insert(CachedValue* value) {
   TRI_ASSERT(value != nullptr);
-  uint32_t hash = hashKey(value->key(), value->keySize);
+  return insertHashed(hashKey(value->key(), value->keySize), value, true);
+}
+
+Result TransactionalCache::insertHashed(uint32_t hash, CachedValue* value,
+                                        bool singleOperation) {
+  TRI_ASSERT(value != nullptr);
 
   Result status;
   TransactionalBucket* bucket;
   std::shared_ptr<Table> source;
-  std::tie(status, bucket, source) = getBucket(hash, Cache::triesFast);
+  std::tie(status, bucket, source) = getBucket(hash, Cache::triesFast, singleOperation);
 
   if (status.ok()) {
     bool maybeMigrate = false;
@@ -83,6 +110,11 @@ Result TransactionalCache::insert(CachedValue* value) {
         if (candidate == nullptr) {
           allowed = false;
           status.reset(TRI_ERROR_ARANGO_BUSY);
+        } else if (!admit(hash, candidate)) {
+          // the victim is more popular than the new entry, keep it
+          allowed = false;
+          maybeMigrate = reportRejection();
+          status.reset(TRI_ERROR_ARANGO_BUSY);
         }
       }
 
@@ -122,7 +154,9 @@ Result TransactionalCache::insert(CachedValue* value) {
     if (maybeMigrate) {
       requestMigrate(_table->idealSize());  // let function do the hard work
     }
-    endOperation();
+    if (singleOperation) {
+      endOperation();
+    }
   }
 
   return status;
@@ -200,6 +234,7 @@ Result TransactionalCache::blacklist(void const* key, uint32_t keySize) {
 
 uint64_t TransactionalCache::allocationSize(bool enableWindowedStats) {
   return sizeof(TransactionalCache) +
+         FrequencySketch::allocationSize(_admissionCapacity) +
          (enableWindowedStats ? (sizeof(StatBuffer) +
                                  StatBuffer::allocationSize(_findStatsCapacity))
                               : 0);
@@ -370,7 +405,7 @@ void TransactionalCache::migrateBucket(void* sourcePtr,
 
 std::tuple<Result, TransactionalBucket*, std::shared_ptr<Table>>
 TransactionalCache::getBucket(uint32_t hash, int64_t maxTries,
-                              bool singleOperation) {
+                              bool singleOperation, bool lockBucket) {
   Result status;
   TransactionalBucket* bucket = nullptr;
   std::shared_ptr<Table> source(nullptr);
@@ -387,12 +422,15 @@ TransactionalCache::getBucket(uint32_t hash, int64_t maxTries,
       }
 
       uint64_t term = _manager->_transactions.term();
-      auto pair = _table->fetchAndLockBucket(hash, maxTries);
+      auto pair = lockBucket ? _table->fetchAndLockBucket(hash, maxTries)
+                             : _table->fetchBucket(hash, maxTries);
       bucket = reinterpret_cast<TransactionalBucket*>(pair.first);
       source = pair.second;
       ok = (bucket != nullptr);
       if (ok) {
-        bucket->updateBlacklistTerm(term);
+        if (lockBucket) {
+          bucket->updateBlacklistTerm(term);
+        }
       } else {
         status.reset(TRI_ERROR_LOCK_TIMEOUT);
       }
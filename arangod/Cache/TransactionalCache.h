@@ -126,6 +126,10 @@ class TransactionalCache final : public Cache {
                                        std::shared_ptr<Table> table,
                                        bool enableWindowedStats);
 
+  virtual Finding findHashed(uint32_t hash, void const* key, uint32_t keySize,
+                             bool singleOperation);
+  virtual Result insertHashed(uint32_t hash, CachedValue* value,
+                              bool singleOperation);
   virtual uint64_t freeMemoryFrom(uint32_t hash);
   virtual void migrateBucket(void* sourcePtr,
                              std::unique_ptr<Table::Subtable> targets,
@@ -133,7 +137,8 @@ class TransactionalCache final : public Cache {
 
   // helpers
   std::tuple<Result, TransactionalBucket*, std::shared_ptr<Table>> getBucket(
-      uint32_t hash, int64_t maxTries, bool singleOperation = true);
+      uint32_t hash, int64_t maxTries, bool singleOperation = true,
+      bool lockBucket = true);
   uint32_t getIndex(uint32_t hash, bool useAuxiliary) const;
 
   static Table::BucketClearer bucketClearer(Metadata* metadata);
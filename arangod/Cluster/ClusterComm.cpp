@@ -28,12 +28,15 @@
 #include "Basics/ConditionLocker.h"
 #include "Basics/HybridLogicalClock.h"
 #include "Basics/StringUtils.h"
+#include "Cluster/ClusterFeature.h"
 #include "Cluster/ClusterInfo.h"
 #include "Cluster/CollectionLockState.h"
 #include "Cluster/ServerState.h"
+#include "Cluster/VstCommunicator.h"
 #include "GeneralServer/AuthenticationFeature.h"
 #include "Logger/Logger.h"
 #include "RestServer/FeatureCacheFeature.h"
+#include "RestServer/ServerFeature.h"
 #include "Scheduler/JobGuard.h"
 #include "Scheduler/SchedulerFeature.h"
 #include "SimpleHttpClient/ConnectionManager.h"
@@ -239,6 +242,16 @@ ClusterComm::ClusterComm()
   }
 
   _communicator = std::make_shared<communicator::Communicator>();    
+
+  auto cluster = dynamic_cast<ClusterFeature*>(
+      application_features::ApplicationServer::lookupFeature("Cluster"));
+  if (cluster != nullptr && cluster->vstConnectionsPerServer() > 0) {
+    auto server = dynamic_cast<ServerFeature*>(
+        application_features::ApplicationServer::lookupFeature("Server"));
+    _vstCommunicator.reset(new VstCommunicator(
+        static_cast<size_t>(cluster->vstConnectionsPerServer()),
+        server != nullptr ? server->vstMaxSize() : 1024 * 30, _jwt));
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -246,6 +259,9 @@ ClusterComm::ClusterComm()
 ////////////////////////////////////////////////////////////////////////////////
 
 ClusterComm::~ClusterComm() {
+  // the VST callbacks refer to us, so shut that transport down first
+  _vstCommunicator.reset();
+
   if (_backgroundThread != nullptr) {
     _backgroundThread->beginShutdown();
     delete _backgroundThread;
@@ -387,7 +403,8 @@ OperationID ClusterComm::asyncRequest(
     std::shared_ptr<std::string const> body,
     std::unique_ptr<std::unordered_map<std::string, std::string>>& headerFields,
     std::shared_ptr<ClusterCommCallback> callback, ClusterCommTimeout timeout,
-    bool singleRequest, ClusterCommTimeout initTimeout) {
+    bool singleRequest, ClusterCommTimeout initTimeout,
+    ClusterCommTransport transport) {
   auto prepared = prepareRequest(destination, reqtype, body.get(), *headerFields.get());
   std::shared_ptr<ClusterCommResult> result(prepared.first);
   result->clientTransactionID = clientTransactionID;
@@ -467,8 +484,8 @@ OperationID ClusterComm::asyncRequest(
 
   TRI_ASSERT(request != nullptr);
   CONDITION_LOCKER(locker, somethingReceived);
-  auto ticketId = _communicator->addRequest(createCommunicatorDestination(result->endpoint, path),
-               std::move(request), callbacks, opt);
+  auto ticketId = addRequest(result->endpoint, path, std::move(request),
+                             callbacks, opt, transport);
 
   result->operationID = ticketId;
   responses.emplace(ticketId, AsyncResponse{TRI_microtime(), result});
@@ -501,7 +518,7 @@ std::unique_ptr<ClusterCommResult> ClusterComm::syncRequest(
     arangodb::rest::RequestType reqtype, std::string const& path,
     std::string const& body,
     std::unordered_map<std::string, std::string> const& headerFields,
-    ClusterCommTimeout timeout) {
+    ClusterCommTimeout timeout, ClusterCommTransport transport) {
   auto prepared = prepareRequest(destination, reqtype, &body, headerFields);
   std::unique_ptr<ClusterCommResult> result(prepared.first);
   // mop: this is used to distinguish a syncRequest from an asyncRequest while processing
@@ -546,8 +563,8 @@ std::unique_ptr<ClusterCommResult> ClusterComm::syncRequest(
   TRI_ASSERT(request != nullptr);
   result->status = CL_COMM_SENDING;
   CONDITION_LOCKER(isen, cv);
-  _communicator->addRequest(createCommunicatorDestination(result->endpoint, path),
-               std::move(request), callbacks, opt);
+  addRequest(result->endpoint, path, std::move(request), callbacks, opt,
+             transport);
 
   while (!wasSignaled) {
     cv.wait(100000);
@@ -837,7 +854,8 @@ void ClusterCommThread::beginShutdown() {
 size_t ClusterComm::performRequests(std::vector<ClusterCommRequest>& requests,
                                     ClusterCommTimeout timeout, size_t& nrDone,
                                     arangodb::LogTopic const& logTopic,
-                                    bool retryOnCollNotFound) {
+                                    bool retryOnCollNotFound,
+                                    std::function<void(size_t)> const& onAnswer) {
   if (requests.size() == 0) {
     nrDone = 0;
     return 0;
@@ -892,7 +910,7 @@ size_t ClusterComm::performRequests(std::vector<ClusterCommRequest>& requests,
                 "", coordinatorTransactionID, requests[i].destination,
                 requests[i].requestType, requests[i].path, requests[i].body,
                 requests[i].headerFields, nullptr, localTimeout, false,
-                2.0);
+                2.0, requests[i].transport);
 
             opIDtoIndex.insert(std::make_pair(opId, i));
             // It is possible that an error occurs right away, we will notice
@@ -960,6 +978,9 @@ size_t ClusterComm::performRequests(std::vector<ClusterCommRequest>& requests,
           << "got answer from " << requests[index].destination << ":"
           << requests[index].path << " with return code "
           << (int)res.answer_code;
+        if (onAnswer) {
+          onAnswer(index);
+        }
       } else if (res.status == CL_COMM_BACKEND_UNAVAILABLE ||
                  (res.status == CL_COMM_TIMEOUT && !res.sendWasComplete)) {
         // Note that this case includes the refusal of a leader to accept
@@ -1027,11 +1048,11 @@ size_t ClusterComm::performSingleRequest(
   if (req.body == nullptr) {
     req.result = *syncRequest("", coordinatorTransactionID, req.destination,
                               req.requestType, req.path, "",
-                              *(req.headerFields), timeout);
+                              *(req.headerFields), timeout, req.transport);
   } else {
     req.result = *syncRequest("", coordinatorTransactionID, req.destination,
                               req.requestType, req.path, *(req.body),
-                              *(req.headerFields), timeout);
+                              *(req.headerFields), timeout, req.transport);
   }
 
   // mop: helpless attempt to fix segfaulting due to body buffer empty
@@ -1084,6 +1105,30 @@ size_t ClusterComm::performSingleRequest(
              : 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hand a prepared request to the transport. VST is used only if it
+/// was asked for and can carry the request, everything else goes via HTTP
+////////////////////////////////////////////////////////////////////////////////
+
+communicator::Ticket ClusterComm::addRequest(
+    std::string const& endpoint, std::string const& path,
+    std::unique_ptr<HttpRequest> request,
+    communicator::Callbacks const& callbacks,
+    communicator::Options const& options, ClusterCommTransport transport) {
+  if (transport == ClusterCommTransport::VST && _vstCommunicator != nullptr &&
+      VstCommunicator::supportsEndpoint(endpoint)) {
+    auto ticketId = _vstCommunicator->addRequest(
+        endpoint, request->requestType(), path, &request->body(),
+        request->headers(), callbacks, options);
+    if (ticketId != 0) {
+      return ticketId;
+    }
+  }
+  return _communicator->addRequest(
+      createCommunicatorDestination(endpoint, path), std::move(request),
+      callbacks, options);
+}
+
 communicator::Destination ClusterComm::createCommunicatorDestination(std::string const& endpoint, std::string const& path) {
   std::string httpEndpoint;
   if (endpoint.substr(0, 6) == "tcp://") {
@@ -1147,10 +1192,17 @@ std::pair<ClusterCommResult*, HttpRequest*> ClusterComm::prepareRequest(std::str
 #endif
 #endif
 
+  // bodies are JSON, unless the caller sends VelocyPack explicitly
+  ContentType contentType = ContentType::JSON;
+  auto it = headersCopy.find(StaticStrings::ContentTypeHeader);
+  if (it != headersCopy.end() && it->second == StaticStrings::MimeTypeVPack) {
+    contentType = ContentType::VPACK;
+  }
+
   if (body == nullptr) {
-    request = HttpRequest::createHttpRequest(ContentType::JSON, "", 0, headersCopy);
+    request = HttpRequest::createHttpRequest(contentType, "", 0, headersCopy);
   } else {
-    request = HttpRequest::createHttpRequest(ContentType::JSON, body->c_str(), body->length(), headersCopy);
+    request = HttpRequest::createHttpRequest(contentType, body->c_str(), body->length(), headersCopy);
   }
   request->setRequestType(reqtype);
 
@@ -1179,6 +1231,9 @@ std::vector<communicator::Ticket> ClusterComm::activeServerTickets(std::vector<s
 void ClusterComm::disable() {
    _communicator->disable();
    _communicator->abortRequests();
+   if (_vstCommunicator != nullptr) {
+     _vstCommunicator->disable();
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1192,6 +1247,9 @@ void ClusterCommThread::abortRequestsToFailedServers() {
     auto ticketIds = _cc->activeServerTickets(failedServers);
     for (auto const& ticketId: ticketIds) {
       _cc->communicator()->abortRequest(ticketId);
+      if (_cc->_vstCommunicator != nullptr) {
+        _cc->_vstCommunicator->abortRequest(ticketId);
+      }
     }
   }
 }
@@ -1212,6 +1270,9 @@ void ClusterCommThread::run() {
     }
   }
   _cc->communicator()->abortRequests();
+  if (_cc->_vstCommunicator != nullptr) {
+    _cc->_vstCommunicator->abortRequests();
+  }
 
   LOG_TOPIC(DEBUG, Logger::CLUSTER) << "stopped ClusterComm thread";
 }
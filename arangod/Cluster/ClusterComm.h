@@ -44,6 +44,7 @@
 
 namespace arangodb {
 class ClusterCommThread;
+class VstCommunicator;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief type of a client transaction ID
@@ -63,6 +64,14 @@ typedef TRI_voc_tick_t CoordTransactionID;
 
 typedef communicator::Ticket OperationID;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief transport used for a cluster-internal request. VST requests go
+/// over persistent multiplexed connections and deliver VelocyPack bodies,
+/// they fall back to HTTP for endpoints or bodies VST cannot carry
+////////////////////////////////////////////////////////////////////////////////
+
+enum class ClusterCommTransport { HTTP, VST };
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief status of an (a-)synchronous cluster operation
 ////////////////////////////////////////////////////////////////////////////////
@@ -265,8 +274,11 @@ struct ClusterCommResult {
     // containing the body of our response
     // :snake: OPST_CIRCUS
     answer_code = dynamic_cast<HttpResponse*>(response.get())->responseCode();
+    // VST responses carry VelocyPack, which the fake request hands out
+    // without parsing
     HttpRequest* request = HttpRequest::createHttpRequest(
-        ContentType::JSON,
+        response->contentType() == ContentType::VPACK ? ContentType::VPACK
+                                                      : ContentType::JSON,
         dynamic_cast<HttpResponse*>(response.get())->body().c_str(),
         dynamic_cast<HttpResponse*>(response.get())->body().length(), std::unordered_map<std::string,std::string>());
 
@@ -318,6 +330,25 @@ struct ClusterCommCallback {
   virtual bool operator()(ClusterCommResult*) = 0;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ClusterCommCallback calling a function, e.g. to resume a
+/// RestHandler which waits for the answer
+////////////////////////////////////////////////////////////////////////////////
+
+struct ClusterCommFunctionCallback : public ClusterCommCallback {
+  explicit ClusterCommFunctionCallback(
+      std::function<void(ClusterCommResult*)> function)
+      : _function(function) {}
+
+  bool operator()(ClusterCommResult* result) override {
+    _function(result);
+    return true;
+  }
+
+ private:
+  std::function<void(ClusterCommResult*)> _function;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief type of a timeout specification, is meant in seconds
 ////////////////////////////////////////////////////////////////////////////////
@@ -351,9 +382,10 @@ struct ClusterCommRequest {
   std::shared_ptr<std::string const> body;
   std::unique_ptr<std::unordered_map<std::string, std::string>> headerFields;
   ClusterCommResult result;
+  ClusterCommTransport transport;
   bool done;
 
-  ClusterCommRequest() : done(false) {}
+  ClusterCommRequest() : transport(ClusterCommTransport::HTTP), done(false) {}
 
   ClusterCommRequest(std::string const& dest, rest::RequestType type,
                      std::string const& path,
@@ -362,6 +394,7 @@ struct ClusterCommRequest {
         requestType(type),
         path(path),
         body(body),
+        transport(ClusterCommTransport::HTTP),
         done(false) {}
 
   void setHeaders(
@@ -450,7 +483,8 @@ class ClusterComm {
       std::unique_ptr<std::unordered_map<std::string, std::string>>&
           headerFields,
       std::shared_ptr<ClusterCommCallback> callback, ClusterCommTimeout timeout,
-      bool singleRequest = false, ClusterCommTimeout initTimeout = -1.0);
+      bool singleRequest = false, ClusterCommTimeout initTimeout = -1.0,
+      ClusterCommTransport transport = ClusterCommTransport::HTTP);
 
   //////////////////////////////////////////////////////////////////////////////
   /// @brief submit a single HTTP request to a shard synchronously.
@@ -462,7 +496,8 @@ class ClusterComm {
       std::string const& destination, rest::RequestType reqtype,
       std::string const& path, std::string const& body,
       std::unordered_map<std::string, std::string> const& headerFields,
-      ClusterCommTimeout timeout);
+      ClusterCommTimeout timeout,
+      ClusterCommTransport transport = ClusterCommTransport::HTTP);
 
   //////////////////////////////////////////////////////////////////////////////
   /// @brief check on the status of an operation
@@ -516,12 +551,16 @@ class ClusterComm {
   /// should be set to true. In other cases, a "collection not found" should
   /// be treated as a genuine error that is immediately reported to the
   /// client.
+  /// If `onAnswer` is set, it is called with the index of each request as
+  /// soon as its answer has been received for good, so that callers can
+  /// process answers while others are still outstanding.
   //////////////////////////////////////////////////////////////////////////////
 
   size_t performRequests(std::vector<ClusterCommRequest>& requests,
                          ClusterCommTimeout timeout, size_t& nrDone,
                          arangodb::LogTopic const& logTopic,
-                         bool retryOnCollNotFound);
+                         bool retryOnCollNotFound,
+                         std::function<void(size_t)> const& onAnswer = nullptr);
 
   std::shared_ptr<communicator::Communicator> communicator() {
     return _communicator;
@@ -544,6 +583,12 @@ class ClusterComm {
 
   communicator::Destination createCommunicatorDestination(
       std::string const& destination, std::string const& path);
+  communicator::Ticket addRequest(std::string const& endpoint,
+                                 std::string const& path,
+                                 std::unique_ptr<HttpRequest> request,
+                                 communicator::Callbacks const& callbacks,
+                                 communicator::Options const& options,
+                                 ClusterCommTransport transport);
   std::pair<ClusterCommResult*, HttpRequest*> prepareRequest(
       std::string const& destination, arangodb::rest::RequestType reqtype,
       std::string const* body,
@@ -654,6 +699,13 @@ class ClusterComm {
   bool _logConnectionErrors;
 
   std::shared_ptr<communicator::Communicator> _communicator;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief VST transport, nullptr if disabled
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::unique_ptr<VstCommunicator> _vstCommunicator;
+
   bool _authenticationEnabled;
   std::string _jwt;
   std::string _jwtAuthorization;
@@ -45,6 +45,11 @@ ClusterEdgeCursor::ClusterEdgeCursor(StringRef vertexId, uint64_t depth,
       _opts(opts),
       _cache(static_cast<ClusterTraverserCache*>(opts->cache())) {
   TRI_ASSERT(_cache != nullptr);
+  if (_cache->prefetchedEdges(vertexId, depth, _edgeList)) {
+    // the edges were fetched together with the rest of this depth
+    return;
+  }
+
   auto trx = _opts->trx();
   transaction::BuilderLeaser leased(trx);
 
@@ -52,8 +57,8 @@ ClusterEdgeCursor::ClusterEdgeCursor(StringRef vertexId, uint64_t depth,
   b->add(VPackValuePair(vertexId.data(), vertexId.length(),
                         VPackValueType::String));
 
-  fetchEdgesFromEngines(trx->databaseName(), _cache->engines(), b->slice(),
-                        depth, _cache->edges(), _edgeList, _cache->datalake(),
+  fetchEdgesFromEngines(trx->databaseName(), _cache->enginesForVertex(vertexId),
+                        b->slice(), depth, _cache->edges(), _edgeList, _cache->datalake(),
                         *(leased.get()), _cache->filteredDocuments(),
                         _cache->insertedDocuments());
 }
@@ -66,6 +71,11 @@ ClusterEdgeCursor::ClusterEdgeCursor(StringRef vertexId, bool backward,
       _opts(opts),
       _cache(static_cast<ClusterTraverserCache*>(opts->cache())) {
   TRI_ASSERT(_cache != nullptr);
+  if (_cache->prefetchedShortestPathEdges(vertexId, backward, _edgeList)) {
+    // the edges were fetched together with the rest of the frontier
+    return;
+  }
+
   auto trx = _opts->trx();
   transaction::BuilderLeaser leased(trx);
 
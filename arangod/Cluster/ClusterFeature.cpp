@@ -29,6 +29,7 @@
 #include "Basics/files.h"
 #include "Cluster/ClusterComm.h"
 #include "Cluster/ClusterInfo.h"
+#include "Cluster/CoordinatorDocumentCache.h"
 #include "Cluster/HeartbeatThread.h"
 #include "Endpoint/Endpoint.h"
 #include "GeneralServer/AuthenticationFeature.h"
@@ -137,6 +138,25 @@ void ClusterFeature::collectOptions(std::shared_ptr<ProgramOptions> options) {
                      "all synchronous replication timeouts are multiplied by this factor",
                      new DoubleParameter(&_syncReplTimeoutFactor));
 
+  options->addOption("--cluster.synchronous-replication-batch-size",
+                     "maximum number of documents the leader of a shard sends "
+                     "to its followers in one coalesced synchronous "
+                     "replication request",
+                     new UInt64Parameter(&_syncReplBatchSize));
+
+  options->addOption("--cluster.vst-connections-per-server",
+                     "number of persistent VelocyStream connections kept to "
+                     "each other server for cluster-internal requests that "
+                     "ask for it (0 = always use HTTP)",
+                     new UInt64Parameter(&_vstConnectionsPerServer));
+
+  options->addOption("--cluster.document-cache-ttl",
+                     "time (in seconds) a coordinator serves documents read "
+                     "by key from its local cache. AQL writes and writes not "
+                     "made through this coordinator may stay invisible for "
+                     "that long (0 = disable the cache)",
+                     new DoubleParameter(&_documentCacheTtl));
+
   options->addHiddenOption("--cluster.create-waits-for-sync-replication",
                      "active coordinator will wait for all replicas to create collection",
                      new BooleanParameter(&_createWaitsForSyncReplication));
@@ -466,6 +486,7 @@ void ClusterFeature::start() {
   }
 
   if (role == ServerState::ROLE_COORDINATOR) {
+    CoordinatorDocumentCache::initialize(_documentCacheTtl);
     ServerState::instance()->setState(ServerState::STATE_SERVING);
   } else if (role == ServerState::ROLE_PRIMARY) {
     ServerState::instance()->setState(ServerState::STATE_SERVINGASYNC);
@@ -501,6 +522,8 @@ void ClusterFeature::stop() {
 
 
 void ClusterFeature::unprepare() {
+  CoordinatorDocumentCache::cleanup();
+
   if (_enableCluster) {
     if (_heartbeatThread != nullptr) {
       _heartbeatThread->beginShutdown();
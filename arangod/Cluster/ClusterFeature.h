@@ -54,6 +54,14 @@ class ClusterFeature : public application_features::ApplicationFeature {
     return _syncReplTimeoutFactor;
   }
 
+  uint64_t syncReplBatchSize() {
+    return _syncReplBatchSize;
+  }
+
+  uint64_t vstConnectionsPerServer() {
+    return _vstConnectionsPerServer;
+  }
+
  private:
   std::vector<std::string> _agencyEndpoints;
   std::string _agencyPrefix;
@@ -64,6 +72,9 @@ class ClusterFeature : public application_features::ApplicationFeature {
   uint32_t _systemReplicationFactor = 2;
   bool _createWaitsForSyncReplication = true;
   double _syncReplTimeoutFactor = 1.0;
+  uint64_t _syncReplBatchSize = 1000;
+  uint64_t _vstConnectionsPerServer = 4;
+  double _documentCacheTtl = 0.0;
 
  private:
   void reportRole(ServerState::RoleEnum);
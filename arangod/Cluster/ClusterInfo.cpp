@@ -27,6 +27,7 @@
 #include "Basics/ConditionLocker.h"
 #include "Basics/MutexLocker.h"
 #include "Basics/ReadLocker.h"
+#include "Basics/StringRef.h"
 #include "Basics/StringUtils.h"
 #include "Basics/VelocyPackHelper.h"
 #include "Basics/WriteLocker.h"
@@ -201,7 +202,12 @@ ClusterInfo* ClusterInfo::instance() { return _instance.get(); }
 ////////////////////////////////////////////////////////////////////////////////
 
 ClusterInfo::ClusterInfo(AgencyCallbackRegistry* agencyCallbackRegistry)
-    : _agency(), _agencyCallbackRegistry(agencyCallbackRegistry), _uniqid() {
+    : _agency(),
+      _agencyCallbackRegistry(agencyCallbackRegistry),
+      _currentAgencyVersion(0),
+      _currentConfirmed(0.0),
+      _readServerCounter(0),
+      _uniqid() {
   _uniqid._currentValue = 1ULL;
   _uniqid._upperValue = 0ULL;
 
@@ -506,6 +512,18 @@ void ClusterInfo::loadPlan() {
       databasesSlice = planSlice.get("Collections"); //format above
       if (databasesSlice.isObject()) {
         bool isCoordinator = ServerState::instance()->isCoordinator();
+
+        // The previous plan is only ever replaced while holding
+        // _planProt.mutex, so we can look at it without the read lock.
+        // Collections whose plan entry did not change are taken over
+        // from it instead of being rebuilt.
+        VPackSlice oldDatabasesSlice;
+        if (_plan != nullptr && _plan->slice().isObject()) {
+          oldDatabasesSlice = _plan->slice().get("Collections");
+        }
+        size_t reused = 0;
+        size_t rebuilt = 0;
+
         for (auto const& databasePairSlice :
              VPackObjectIterator(databasesSlice)) {
           VPackSlice const& collectionsSlice = databasePairSlice.value;
@@ -527,6 +545,14 @@ void ClusterInfo::loadPlan() {
             continue;
           }
 
+          VPackSlice oldCollectionsSlice;
+          if (oldDatabasesSlice.isObject()) {
+            oldCollectionsSlice = oldDatabasesSlice.get(databaseName);
+          }
+          auto oldDatabase = _plannedCollections.find(databaseName);
+          bool const canReuse = oldCollectionsSlice.isObject() &&
+                                oldDatabase != _plannedCollections.end();
+
           for (auto const& collectionPairSlice :
                VPackObjectIterator(collectionsSlice)) {
             VPackSlice const& collectionSlice = collectionPairSlice.value;
@@ -537,14 +563,41 @@ void ClusterInfo::loadPlan() {
             std::string const collectionId =
                 collectionPairSlice.key.copyString();
 
+            std::shared_ptr<LogicalCollection> oldCollection;
+            if (canReuse) {
+              auto it = oldDatabase->second.find(collectionId);
+              if (it != oldDatabase->second.end()) {
+                oldCollection = it->second;
+              }
+            }
+
+            if (oldCollection != nullptr &&
+                oldCollection->vocbase() == vocbase &&
+                oldCollectionsSlice.get(collectionId).equals(collectionSlice)) {
+              auto shardKeys = _shardKeys.find(collectionId);
+              auto shards = _shards.find(collectionId);
+              if (shardKeys != _shardKeys.end() && shards != _shards.end()) {
+                // unchanged in the plan, take over the existing objects
+                databaseCollections.emplace(
+                    std::make_pair(oldCollection->name(), oldCollection));
+                databaseCollections.emplace(
+                    std::make_pair(collectionId, oldCollection));
+                newShardKeys.emplace(collectionId, shardKeys->second);
+                for (auto const& p : *oldCollection->shardIds()) {
+                  newShardServers.emplace(p.first, p.second);
+                }
+                newShards.emplace(collectionId, shards->second);
+                ++reused;
+                continue;
+              }
+            }
+            ++rebuilt;
+
             decltype(vocbase->lookupCollection(collectionId)->clusterIndexEstimates()) selectivityEstimates;
             double selectivityTTL = 0;
-            if (isCoordinator) {
-              auto collection = _plannedCollections[databaseName][collectionId];
-              if(collection){
-                selectivityEstimates = collection->clusterIndexEstimates(/*do not update*/ true);
-                selectivityTTL = collection->clusterIndexEstimatesTTL();
-              }
+            if (isCoordinator && oldCollection != nullptr) {
+              selectivityEstimates = oldCollection->clusterIndexEstimates(/*do not update*/ true);
+              selectivityTTL = oldCollection->clusterIndexEstimatesTTL();
             }
 
             try {
@@ -636,6 +689,10 @@ void ClusterInfo::loadPlan() {
               std::make_pair(databaseName, databaseCollections));
           swapCollections = true;
         }
+
+        LOG_TOPIC(TRACE, Logger::CLUSTER)
+            << "loaded plan collections, reused " << reused
+            << ", rebuilt " << rebuilt;
       }
 
       WRITE_LOCKER(writeLocker, _planProt.lock);
@@ -684,6 +741,7 @@ void ClusterInfo::loadCurrent() {
   }
 
   // Now contact the agency:
+  double const start = TRI_microtime();
   AgencyCommResult result = _agency.getValues(prefixCurrent);
 
   if (result.successful()) {
@@ -727,14 +785,52 @@ void ClusterInfo::loadCurrent() {
 
       databasesSlice = currentSlice.get("Collections");
       if (databasesSlice.isObject()) {
+        // As in loadPlan, collections whose entry in Current did not
+        // change are taken over from the previous state:
+        VPackSlice oldDatabasesSlice;
+        if (_current != nullptr && _current->slice().isObject()) {
+          oldDatabasesSlice = _current->slice().get("Collections");
+        }
+
         for (auto const& databaseSlice : VPackObjectIterator(databasesSlice)) {
           std::string const databaseName = databaseSlice.key.copyString();
 
+          VPackSlice oldCollectionsSlice;
+          if (oldDatabasesSlice.isObject()) {
+            oldCollectionsSlice = oldDatabasesSlice.get(databaseName);
+          }
+          auto oldDatabase = _currentCollections.find(databaseName);
+          bool const canReuse = oldCollectionsSlice.isObject() &&
+                                oldDatabase != _currentCollections.end();
+
           DatabaseCollectionsCurrent databaseCollections;
           for (auto const& collectionSlice :
                VPackObjectIterator(databaseSlice.value)) {
             std::string const collectionName = collectionSlice.key.copyString();
 
+            if (canReuse && collectionSlice.value.isObject() &&
+                oldCollectionsSlice.get(collectionName)
+                    .equals(collectionSlice.value)) {
+              auto it = oldDatabase->second.find(collectionName);
+              if (it != oldDatabase->second.end()) {
+                bool complete = true;
+                for (auto const& shardSlice :
+                     VPackObjectIterator(collectionSlice.value)) {
+                  auto shard = _shardIds.find(shardSlice.key.copyString());
+                  if (shard == _shardIds.end()) {
+                    complete = false;
+                    break;
+                  }
+                  newShardIds.insert(*shard);
+                }
+                if (complete) {
+                  databaseCollections.insert(
+                      std::make_pair(collectionName, it->second));
+                  continue;
+                }
+              }
+            }
+
             auto collectionDataCurrent =
                 std::make_shared<CollectionInfoCurrent>();
             for (auto const& shardSlice :
@@ -777,6 +873,10 @@ void ClusterInfo::loadCurrent() {
       }
       _currentProt.doneVersion = storedVersion;
       _currentProt.isValid = true;  // will never be reset to false
+
+      VPackSlice version = currentSlice.get("Version");
+      _currentAgencyVersion = version.isInteger() ? version.getUInt() : 0;
+      _currentConfirmed = start;
     } else {
       LOG_TOPIC(ERR, Logger::CLUSTER) << "Current is not an object!";
     }
@@ -1140,6 +1240,25 @@ int ClusterInfo::createCollectionCoordinator(std::string const& databaseName,
                                              VPackSlice const& json,
                                              std::string& errorMsg,
                                              double timeout) {
+  std::vector<ClusterCollectionCreationInfo> infos{
+      ClusterCollectionCreationInfo(collectionID, numberOfShards,
+                                    replicationFactor, json)};
+  return createCollectionsCoordinator(databaseName, infos, waitForReplication,
+                                      errorMsg, timeout);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create many collections of a database in coordinator. all
+/// collections are added to the Plan in one agency transaction, so that the
+/// DBServers create their shards together. the return value is an ArangoDB
+/// error code and the errorMsg is set accordingly. One possible error is a
+/// timeout, a timeout of 0.0 means no timeout.
+////////////////////////////////////////////////////////////////////////////////
+
+int ClusterInfo::createCollectionsCoordinator(
+    std::string const& databaseName,
+    std::vector<ClusterCollectionCreationInfo> const& infos,
+    bool waitForReplication, std::string& errorMsg, double timeout) {
   using arangodb::velocypack::Slice;
 
   AgencyComm ac;
@@ -1148,14 +1267,34 @@ int ClusterInfo::createCollectionCoordinator(std::string const& databaseName,
   double const endTime = TRI_microtime() + realTimeout;
   double const interval = getPollInterval();
 
-  std::string const name =
-      arangodb::basics::VelocyPackHelper::getStringValue(json, "name", "");
+  TRI_ASSERT(!infos.empty());
 
-  std::shared_ptr<ShardMap> otherCidShardMap = nullptr;
-  if (json.hasKey("distributeShardsLike")) {
-    auto const otherCidString = json.get("distributeShardsLike").copyString();
-    if (!otherCidString.empty()) {
-      otherCidShardMap = getCollection(databaseName, otherCidString)->shardIds();
+  std::vector<AgencyPrecondition> precs;
+  std::unordered_set<std::string> lockedShards;
+  std::unordered_set<std::string> names;
+
+  for (auto const& info : infos) {
+    if (!names.emplace(info.name).second) {
+      // the same name twice in one batch
+      events::CreateCollection(info.name, TRI_ERROR_ARANGO_DUPLICATE_NAME);
+      return TRI_ERROR_ARANGO_DUPLICATE_NAME;
+    }
+
+    // Any of the shards of the prototype locked?
+    if (info.json.hasKey("distributeShardsLike")) {
+      auto const otherCidString =
+          info.json.get("distributeShardsLike").copyString();
+      if (!otherCidString.empty()) {
+        auto otherCidShardMap =
+            getCollection(databaseName, otherCidString)->shardIds();
+        for (auto const& shard : *otherCidShardMap) {
+          if (lockedShards.emplace(shard.first).second) {
+            precs.emplace_back(
+                AgencyPrecondition("Supervision/Shards/" + shard.first,
+                                   AgencyPrecondition::Type::EMPTY, true));
+          }
+        }
+      }
     }
   }
 
@@ -1166,92 +1305,137 @@ int ClusterInfo::createCollectionCoordinator(std::string const& databaseName,
     READ_LOCKER(readLocker, _planProt.lock);
     AllCollections::const_iterator it = _plannedCollections.find(databaseName);
     if (it != _plannedCollections.end()) {
-      DatabaseCollections::const_iterator it2 = (*it).second.find(name);
+      for (auto const& info : infos) {
+        DatabaseCollections::const_iterator it2 = (*it).second.find(info.name);
 
-      if (it2 != (*it).second.end()) {
-        // collection already exists!
-        events::CreateCollection(name, TRI_ERROR_ARANGO_DUPLICATE_NAME);
-        return TRI_ERROR_ARANGO_DUPLICATE_NAME;
+        if (it2 != (*it).second.end()) {
+          // collection already exists!
+          events::CreateCollection(info.name, TRI_ERROR_ARANGO_DUPLICATE_NAME);
+          return TRI_ERROR_ARANGO_DUPLICATE_NAME;
+        }
       }
     }
   }
 
   // mop: why do these ask the agency instead of checking cluster info?
   if (!ac.exists("Plan/Databases/" + databaseName)) {
-    events::CreateCollection(name, TRI_ERROR_ARANGO_DATABASE_NOT_FOUND);
+    for (auto const& info : infos) {
+      events::CreateCollection(info.name, TRI_ERROR_ARANGO_DATABASE_NOT_FOUND);
+    }
     return setErrormsg(TRI_ERROR_ARANGO_DATABASE_NOT_FOUND, errorMsg);
   }
 
-  if (ac.exists("Plan/Collections/" + databaseName + "/" + collectionID)) {
-    events::CreateCollection(name, TRI_ERROR_CLUSTER_COLLECTION_ID_EXISTS);
-    return setErrormsg(TRI_ERROR_CLUSTER_COLLECTION_ID_EXISTS, errorMsg);
+  // the ids are checked by the transaction below, without a round trip to
+  // the agency per collection
+  for (auto const& info : infos) {
+    precs.emplace_back(AgencyPrecondition(
+        "Plan/Collections/" + databaseName + "/" + info.collectionID,
+        AgencyPrecondition::Type::EMPTY, true));
   }
 
-  // The following three are used for synchronization between the callback
+  // state of a collection in Current, as seen by the callback
+  struct CreationState {
+    CollectionID collectionID;
+    std::string name;
+    uint64_t numberOfShards;
+    // -1 while the shards are being created
+    int result;
+    std::string errorMessage;
+  };
+
+  // The following are used for synchronization between the callback
   // closure and the main thread executing this function. Note that it can
   // happen that the callback is called only after we return from this
   // function!
-  auto dbServerResult = std::make_shared<int>(-1);
-  auto errMsg = std::make_shared<std::string>();
+  auto states = std::make_shared<std::vector<CreationState>>();
   auto cacheMutex = std::make_shared<Mutex>();
 
-  auto dbServers = getCurrentDBServers();
+  for (auto const& info : infos) {
+    // collections without shards are complete once they are planned
+    states->emplace_back(CreationState{
+        info.collectionID, info.name, info.numberOfShards,
+        info.numberOfShards == 0 ? TRI_ERROR_NO_ERROR : -1, ""});
+  }
+
+  // a single collection is watched directly. for more, one callback on the
+  // collections of the database replaces one callback per collection
+  bool const watchDatabase = (infos.size() > 1);
+
+  auto checkCollection = [this, waitForReplication](
+      CreationState& state, VPackSlice const& result) {
+    if (!result.isObject() || result.length() != (size_t)state.numberOfShards) {
+      return;
+    }
+
+    std::string tmpError = "";
+    for (auto const& p : VPackObjectIterator(result)) {
+      if (arangodb::basics::VelocyPackHelper::getBooleanValue(
+              p.value, "error", false)) {
+        tmpError += " shardID:" + p.key.copyString() + ":";
+        tmpError += arangodb::basics::VelocyPackHelper::getStringValue(
+            p.value, "errorMessage", "");
+        if (p.value.hasKey("errorNum")) {
+          VPackSlice const errorNum = p.value.get("errorNum");
+          if (errorNum.isNumber()) {
+            tmpError += " (errNum=";
+            tmpError += basics::StringUtils::itoa(
+                errorNum.getNumericValue<uint32_t>());
+            tmpError += ")";
+          }
+        }
+      }
+
+      // wait that all followers have created our new collection
+      if (tmpError.empty() && waitForReplication) {
+        std::vector<ServerID> plannedServers;
+        {
+          READ_LOCKER(readLocker, _planProt.lock);
+          auto it = _shardServers.find(p.key.copyString());
+          if (it != _shardServers.end()) {
+            plannedServers = (*it).second;
+          }
+        }
+        std::vector<ServerID> currentServers;
+        VPackSlice servers = p.value.get("servers");
+        if (!servers.isArray()) {
+          return;
+        }
+        for (auto const& server : VPackArrayIterator(servers)) {
+          if (!server.isString()) {
+            return;
+          }
+          currentServers.push_back(server.copyString());
+        }
+        if (!ClusterHelpers::compareServerLists(plannedServers,
+                                                currentServers)) {
+          LOG_TOPIC(DEBUG, Logger::CLUSTER)
+              << "Still waiting for all servers to ACK creation of "
+              << state.name << ". Planned: " << plannedServers
+              << ", Current: " << currentServers;
+          return;
+        }
+      }
+    }
+    if (!tmpError.empty()) {
+      state.errorMessage = "Error in creation of collection:" + tmpError +
+                           " " + __FILE__ + std::to_string(__LINE__);
+      state.result = TRI_ERROR_CLUSTER_COULD_NOT_CREATE_COLLECTION;
+    } else {
+      state.result = setErrormsg(TRI_ERROR_NO_ERROR, state.errorMessage);
+    }
+  };
+
   std::function<bool(VPackSlice const& result)> dbServerChanged =
       [=](VPackSlice const& result) {
         MUTEX_LOCKER(locker, *cacheMutex);
-        if (result.isObject() && result.length() == (size_t)numberOfShards) {
-          std::string tmpError = "";
-          for (auto const& p : VPackObjectIterator(result)) {
-            if (arangodb::basics::VelocyPackHelper::getBooleanValue(
-                    p.value, "error", false)) {
-              tmpError += " shardID:" + p.key.copyString() + ":";
-              tmpError += arangodb::basics::VelocyPackHelper::getStringValue(
-                  p.value, "errorMessage", "");
-              if (p.value.hasKey("errorNum")) {
-                VPackSlice const errorNum = p.value.get("errorNum");
-                if (errorNum.isNumber()) {
-                  tmpError += " (errNum=";
-                  tmpError += basics::StringUtils::itoa(
-                      errorNum.getNumericValue<uint32_t>());
-                  tmpError += ")";
-                }
-              }
-            }
-            
-            // wait that all followers have created our new collection
-            if (tmpError.empty() && waitForReplication) {
-              std::vector<ServerID> plannedServers;
-              {
-                READ_LOCKER(readLocker, _planProt.lock);
-                auto it = _shardServers.find(p.key.copyString());
-                if (it != _shardServers.end()) {
-                  plannedServers = (*it).second;
-                }
-              }
-              std::vector<ServerID> currentServers;
-              VPackSlice servers = p.value.get("servers");
-              if (!servers.isArray()) {
-                return true;
-              }
-              for (auto const& server: VPackArrayIterator(servers)) {
-                if (!server.isString()) {
-                  return true;
-                }
-                currentServers.push_back(server.copyString());
-              }
-              if (!ClusterHelpers::compareServerLists(plannedServers, currentServers)) {
-                LOG_TOPIC(DEBUG, Logger::CLUSTER) << "Still waiting for all servers to ACK creation of " << name
-                  << ". Planned: " << plannedServers << ", Current: " << currentServers;
-                return true;
-              }
-            }
+        for (auto& state : *states) {
+          if (state.result >= 0) {
+            continue;
           }
-          if (!tmpError.empty()) {
-            *errMsg = "Error in creation of collection:" + tmpError + " "
-                + __FILE__ + std::to_string(__LINE__);
-            *dbServerResult = TRI_ERROR_CLUSTER_COULD_NOT_CREATE_COLLECTION;
-          } else {
-            *dbServerResult = setErrormsg(TRI_ERROR_NO_ERROR, *errMsg);
+          if (!watchDatabase) {
+            checkCollection(state, result);
+          } else if (result.isObject()) {
+            checkCollection(state, result.get(state.collectionID));
           }
         }
         return true;
@@ -1262,36 +1446,35 @@ int ClusterInfo::createCollectionCoordinator(std::string const& databaseName,
   // local variables. Therefore we have to protect all accesses to them
   // by a mutex. We use the mutex of the condition variable in the
   // AgencyCallback for this.
+  std::string const watchedKey =
+      watchDatabase
+          ? "Current/Collections/" + databaseName
+          : "Current/Collections/" + databaseName + "/" +
+                infos[0].collectionID;
   auto agencyCallback = std::make_shared<AgencyCallback>(
-      ac, "Current/Collections/" + databaseName + "/" + collectionID,
-      dbServerChanged, true, false);
+      ac, watchedKey, dbServerChanged, true, false);
   _agencyCallbackRegistry->registerCallback(agencyCallback);
   TRI_DEFER(_agencyCallbackRegistry->unregisterCallback(agencyCallback));
 
-  VPackBuilder builder;
-  builder.add(json);
-
-
-  std::vector<AgencyOperation> opers (
-    { AgencyOperation("Plan/Collections/" + databaseName + "/" + collectionID,
-                      AgencyValueOperationType::SET, builder.slice()),
-      AgencyOperation("Plan/Version", AgencySimpleOperationType::INCREMENT_OP)});
-
-  std::vector<AgencyPrecondition> precs;
-
-  // Any of the shards locked?
-  if (otherCidShardMap != nullptr) {
-    for (auto const& shard : *otherCidShardMap) {
-      precs.emplace_back(
-        AgencyPrecondition("Supervision/Shards/" + shard.first,
-                           AgencyPrecondition::Type::EMPTY, true));
-    }
+  std::vector<AgencyOperation> opers;
+  for (auto const& info : infos) {
+    opers.emplace_back(AgencyOperation(
+        "Plan/Collections/" + databaseName + "/" + info.collectionID,
+        AgencyValueOperationType::SET, info.json));
   }
-  
+  opers.emplace_back(
+      AgencyOperation("Plan/Version", AgencySimpleOperationType::INCREMENT_OP));
+
   AgencyGeneralTransaction transaction;
   transaction.transactions.push_back(
     AgencyGeneralTransaction::TransactionType(opers,precs));
-  
+
+  auto reportAll = [&infos](int code) {
+    for (auto const& info : infos) {
+      events::CreateCollection(info.name, code);
+    }
+  };
+
   { // we hold this mutex from now on until we have updated our cache
     // using loadPlan, this is necessary for the callback closure to 
     // see the new planned state for this collection. Otherwise it cannot
@@ -1305,74 +1488,73 @@ int ClusterInfo::createCollectionCoordinator(std::string const& databaseName,
     if (!res.successful()) {
       if (res.httpCode() ==
           (int)arangodb::rest::ResponseCode::PRECONDITION_FAILED) {
-        AgencyCommResult ag = ac.getValues("/");
-
-        if (result.isArray() && result.length() > 0) {
-          if (result[0].isObject()) {
-            auto tres = result[0];
-            if (tres.hasKey(
+        if (result.isArray() && result.length() > 0 && result[0].isObject()) {
+          auto tres = result[0];
+          if (tres.hasKey(
                 std::vector<std::string>(
                   {AgencyCommManager::path(), "Supervision"}))) {
-              for (const auto& s :
-                     VPackObjectIterator(
-                       tres.get(
-                         std::vector<std::string>(
-                           {AgencyCommManager::path(), "Supervision","Shards"})))) {
-                errorMsg += std::string("Shard ") + s.key.copyString();
-                errorMsg += " of prototype collection is blocked by supervision job ";
-                errorMsg += s.value.copyString();
-              }
+            for (const auto& s :
+                   VPackObjectIterator(
+                     tres.get(
+                       std::vector<std::string>(
+                         {AgencyCommManager::path(), "Supervision","Shards"})))) {
+              errorMsg += std::string("Shard ") + s.key.copyString();
+              errorMsg += " of prototype collection is blocked by supervision job ";
+              errorMsg += s.value.copyString();
             }
+            reportAll(TRI_ERROR_CLUSTER_COULD_NOT_CREATE_COLLECTION_IN_PLAN);
             return TRI_ERROR_CLUSTER_COULD_NOT_CREATE_COLLECTION_IN_PLAN;
           }
         }
 
-        if (ag.successful()) {
-          LOG_TOPIC(ERR, Logger::CLUSTER) << "Agency dump:\n"
-                                          << ag.slice().toJson();
-        } else {
-          LOG_TOPIC(ERR, Logger::CLUSTER) << "Could not get agency dump!";
-        }
+        // one of the collection ids is already planned
+        reportAll(TRI_ERROR_CLUSTER_COLLECTION_ID_EXISTS);
+        return setErrormsg(TRI_ERROR_CLUSTER_COLLECTION_ID_EXISTS, errorMsg);
       } else {
         errorMsg += std::string("\nClientId ") + res._clientId;
         errorMsg += std::string("\n") + __FILE__ + std::to_string(__LINE__);
         errorMsg += std::string("\n") + res.errorMessage();
         errorMsg += std::string("\n") + res.errorDetails();
         errorMsg += std::string("\n") + res.body();
-        events::CreateCollection(
-          name, TRI_ERROR_CLUSTER_COULD_NOT_CREATE_COLLECTION_IN_PLAN);
+        reportAll(TRI_ERROR_CLUSTER_COULD_NOT_CREATE_COLLECTION_IN_PLAN);
         return TRI_ERROR_CLUSTER_COULD_NOT_CREATE_COLLECTION_IN_PLAN;
       }
-      
     }
 
     // Update our cache:
     loadPlan();
   }
 
-  if (numberOfShards == 0) {
-    loadCurrent();
-    events::CreateCollection(name, TRI_ERROR_NO_ERROR);
-    return TRI_ERROR_NO_ERROR;
-  }
-
   {
     CONDITION_LOCKER(locker, agencyCallback->_cv);
 
     while (true) {
-      errorMsg = *errMsg;
+      size_t pending = 0;
+      int result = TRI_ERROR_NO_ERROR;
+      {
+        MUTEX_LOCKER(guard, *cacheMutex);
+        for (auto const& state : *states) {
+          if (state.result < 0) {
+            ++pending;
+          } else if (state.result != TRI_ERROR_NO_ERROR &&
+                     result == TRI_ERROR_NO_ERROR) {
+            result = state.result;
+            errorMsg = state.errorMessage;
+          }
+        }
+      }
 
-      if (*dbServerResult >= 0) {
+      if (pending == 0 || result != TRI_ERROR_NO_ERROR) {
         loadCurrent();
-        events::CreateCollection(name, *dbServerResult);
-        return *dbServerResult;
+        reportAll(result);
+        return result;
       }
 
       if (TRI_microtime() > endTime) {
         LOG_TOPIC(ERR, Logger::CLUSTER)
             << "Timeout in _create collection"
-            << ": database: " << databaseName << ", collId:" << collectionID
-            << "\njson: " << json.toString()
+            << ": database: " << databaseName << ", collections: "
+            << infos.size() << ", still creating: " << pending
             << "\ntransaction sent to agency: " << transaction.toJson();
         AgencyCommResult ag = ac.getValues("");
         if (ag.successful()) {
@@ -1382,21 +1564,20 @@ int ClusterInfo::createCollectionCoordinator(std::string const& databaseName,
           LOG_TOPIC(ERR, Logger::CLUSTER) << "Could not get agency dump!";
         }
 
-        // Now we ought to remove the collection again in the Plan:
-        AgencyOperation removeCollection(
-            "Plan/Collections/" + databaseName + "/" + collectionID,
-            AgencySimpleOperationType::DELETE_OP);
-        AgencyOperation increaseVersion("Plan/Version",
-                                        AgencySimpleOperationType::INCREMENT_OP);
+        // Now we ought to remove the collections again in the Plan:
         AgencyWriteTransaction transaction;
+        for (auto const& info : infos) {
+          transaction.operations.push_back(AgencyOperation(
+              "Plan/Collections/" + databaseName + "/" + info.collectionID,
+              AgencySimpleOperationType::DELETE_OP));
+        }
+        transaction.operations.push_back(AgencyOperation(
+            "Plan/Version", AgencySimpleOperationType::INCREMENT_OP));
 
-        transaction.operations.push_back(removeCollection);
-        transaction.operations.push_back(increaseVersion);
-
-        // This is a best effort, in the worst case the collection stays:
+        // This is a best effort, in the worst case the collections stay:
         ac.sendTransactionWithFailover(transaction);
 
-        events::CreateCollection(name, TRI_ERROR_CLUSTER_TIMEOUT);
+        reportAll(TRI_ERROR_CLUSTER_TIMEOUT);
         return setErrormsg(TRI_ERROR_CLUSTER_TIMEOUT, errorMsg);
       }
 
@@ -2708,6 +2889,40 @@ std::shared_ptr<std::vector<ServerID>> ClusterInfo::getResponsibleServer(
   return std::make_shared<std::vector<ServerID>>();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief find a server to read a shard from
+////////////////////////////////////////////////////////////////////////////////
+
+ServerID ClusterInfo::getReadServer(ShardID const& shardID,
+                                    double maxStaleness) {
+  // must be checked before looking at the servers, which may be reloaded
+  // in the meantime
+  bool const mayUseFollower =
+      maxStaleness > 0.0 &&
+      TRI_microtime() - _currentConfirmed.load() <= maxStaleness;
+
+  std::shared_ptr<std::vector<ServerID>> servers =
+      getResponsibleServer(shardID);
+  if (servers->empty()) {
+    return ServerID();
+  }
+  if (!mayUseFollower || servers->size() == 1) {
+    return (*servers)[0];
+  }
+  return (*servers)[_readServerCounter++ % servers->size()];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief note that Current in the agency still had the given version
+////////////////////////////////////////////////////////////////////////////////
+
+void ClusterInfo::confirmCurrent(uint64_t version, double time) {
+  if (version != 0 && version == _currentAgencyVersion.load() &&
+      time > _currentConfirmed.load()) {
+    _currentConfirmed = time;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief find the shard list of a collection, sorted numerically
 ////////////////////////////////////////////////////////////////////////////////
@@ -2806,6 +3021,45 @@ int ClusterInfo::getResponsibleShard(LogicalCollection* collInfo,
   }
 
   int error = TRI_ERROR_NO_ERROR;
+  std::shared_ptr<VPackBuilder> boundaries = collInfo->shardBoundaries();
+  if (boundaries != nullptr && shardKeysPtr->size() == 1) {
+    // range sharding keeps the order of the shard key across the shards
+    std::string const& attribute = shardKeysPtr->at(0);
+    VPackBuilder temporaryBuilder;
+    VPackSlice value = VPackSlice::nullSlice();
+    slice = slice.resolveExternal();
+    if (slice.isObject()) {
+      value = slice.get(attribute).resolveExternal();
+      if (value.isNone()) {
+        if (attribute == StaticStrings::KeyString && !key.empty()) {
+          temporaryBuilder.add(VPackValue(key));
+          value = temporaryBuilder.slice();
+        } else {
+          if (!docComplete) {
+            error = TRI_ERROR_CLUSTER_NOT_ALL_SHARDING_ATTRIBUTES_GIVEN;
+          }
+          value = VPackSlice::nullSlice();
+        }
+      }
+    } else if (slice.isString() && attribute == StaticStrings::KeyString) {
+      // an _id or a _key
+      StringRef subKey(slice);
+      size_t pos = subKey.find('/');
+      if (pos != std::string::npos) {
+        subKey = subKey.substr(pos + 1);
+      }
+      temporaryBuilder.add(VPackValuePair(subKey.data(), subKey.length(),
+                                          VPackValueType::String));
+      value = temporaryBuilder.slice();
+    }
+
+    size_t position =
+        countShardBoundaries(boundaries->slice(), value, true);
+    TRI_ASSERT(position < shards->size());
+    shardID = shards->at(std::min(position, shards->size() - 1));
+    return error;
+  }
+
   uint64_t hash = arangodb::basics::VelocyPackHelper::hashByAttributes(
       slice, *shardKeysPtr, docComplete, error, key);
   static char const* magicPhrase =
@@ -2819,6 +3073,67 @@ int ClusterInfo::getResponsibleShard(LogicalCollection* collInfo,
 }
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief find the shards of a range-sharded collection that can hold shard
+/// key values between lower and upper
+////////////////////////////////////////////////////////////////////////////////
+
+int ClusterInfo::getResponsibleShards(LogicalCollection* collInfo,
+                                      VPackSlice lower, VPackSlice upper,
+                                      bool includeUpper,
+                                      std::vector<ShardID>& result) {
+  std::shared_ptr<VPackBuilder> boundaries = collInfo->shardBoundaries();
+  if (boundaries == nullptr) {
+    return TRI_ERROR_BAD_PARAMETER;
+  }
+
+  auto shards = getShardList(std::to_string(collInfo->planId()));
+  if (shards->empty()) {
+    return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
+  }
+
+  // the shard holding lower is needed no matter whether lower itself is
+  // included, because it holds the values right above it as well
+  size_t first = 0;
+  if (!lower.isNone()) {
+    first = countShardBoundaries(boundaries->slice(), lower, true);
+  }
+  size_t last = shards->size() - 1;
+  if (!upper.isNone()) {
+    last = std::min(
+        last, countShardBoundaries(boundaries->slice(), upper, includeUpper));
+  }
+
+  for (size_t i = first; i <= last && i < shards->size(); ++i) {
+    result.emplace_back(shards->at(i));
+  }
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of the sorted shard boundaries below value
+////////////////////////////////////////////////////////////////////////////////
+
+size_t ClusterInfo::countShardBoundaries(VPackSlice boundaries,
+                                         VPackSlice value, bool includeEqual) {
+  TRI_ASSERT(boundaries.isArray());
+  // binary search for the first boundary that is greater than value (or
+  // greater than or equal to it if includeEqual is not set)
+  size_t low = 0;
+  size_t high = static_cast<size_t>(boundaries.length());
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    int cmp = arangodb::basics::VelocyPackHelper::compare(
+        boundaries.at(middle), value, true);
+    if (cmp < 0 || (cmp == 0 && includeEqual)) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the list of coordinator server names
 ////////////////////////////////////////////////////////////////////////////////
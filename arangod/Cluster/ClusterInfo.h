@@ -208,6 +208,28 @@ class CollectionInfoCurrent {
   std::unordered_map<ShardID, std::shared_ptr<VPackBuilder>> _vpacks;
 };
 
+/// @brief a collection to create with
+/// ClusterInfo::createCollectionsCoordinator
+struct ClusterCollectionCreationInfo {
+  ClusterCollectionCreationInfo(std::string const& collectionID,
+                                uint64_t numberOfShards,
+                                uint64_t replicationFactor,
+                                arangodb::velocypack::Slice const& json)
+      : collectionID(collectionID),
+        numberOfShards(numberOfShards),
+        replicationFactor(replicationFactor),
+        json(json),
+        name(arangodb::basics::VelocyPackHelper::getStringValue(json, "name",
+                                                                "")) {}
+
+  std::string const collectionID;
+  uint64_t const numberOfShards;
+  uint64_t const replicationFactor;
+  /// @brief the definition for the Plan, owned by the caller
+  arangodb::velocypack::Slice const json;
+  std::string const name;
+};
+
 class ClusterInfo {
  private:
 
@@ -358,6 +380,16 @@ class ClusterInfo {
                                   arangodb::velocypack::Slice const& json,
                                   std::string& errorMsg, double timeout);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief create many collections of a database in coordinator, with one
+  /// agency transaction for all of them
+  //////////////////////////////////////////////////////////////////////////////
+
+  int createCollectionsCoordinator(
+      std::string const& databaseName,
+      std::vector<ClusterCollectionCreationInfo> const& infos,
+      bool waitForReplication, std::string& errorMsg, double timeout);
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief drop collection in coordinator
   //////////////////////////////////////////////////////////////////////////////
@@ -455,6 +487,24 @@ class ClusterInfo {
 
   std::shared_ptr<std::vector<ServerID>> getResponsibleServer(ShardID const&);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief find a server to read a shard from. Followers in Current are
+  /// in sync with the leader, so any of them may answer if our view of
+  /// Current was confirmed no longer than maxStaleness seconds ago. The
+  /// replicas take turns then. Otherwise, or if maxStaleness is 0, the
+  /// leader is returned. An empty string is returned if the shard is
+  /// not found.
+  //////////////////////////////////////////////////////////////////////////////
+
+  ServerID getReadServer(ShardID const&, double maxStaleness);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief note that Current in the agency still had the given version at
+  /// the given time, called by the heartbeat
+  //////////////////////////////////////////////////////////////////////////////
+
+  void confirmCurrent(uint64_t version, double time);
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief find the shard list of a collection, sorted numerically
   //////////////////////////////////////////////////////////////////////////////
@@ -470,6 +520,27 @@ class ClusterInfo {
                           bool& usesDefaultShardingAttributes,
                           std::string const& key = "");
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief find the shards of a range-sharded collection that can hold
+  /// shard key values between lower and upper. A none slice stands for an
+  /// open end. Returns TRI_ERROR_BAD_PARAMETER for hash-sharded collections
+  //////////////////////////////////////////////////////////////////////////////
+
+  int getResponsibleShards(LogicalCollection*,
+                           arangodb::velocypack::Slice lower,
+                           arangodb::velocypack::Slice upper,
+                           bool includeUpper, std::vector<ShardID>& result);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief number of the sorted shard boundaries that are less than value,
+  /// or less than or equal to it if includeEqual is set. With includeEqual
+  /// this is the position of the shard responsible for value
+  //////////////////////////////////////////////////////////////////////////////
+
+  static size_t countShardBoundaries(arangodb::velocypack::Slice boundaries,
+                                     arangodb::velocypack::Slice value,
+                                     bool includeEqual);
+
 
   //////////////////////////////////////////////////////////////////////////////
   /// @brief return the list of coordinator server names
@@ -610,6 +681,14 @@ class ClusterInfo {
       _currentDatabases;  // from Current/Databases
   ProtectionData _currentProt;
 
+  // version of Current in the agency that _current was loaded from, and
+  // the last time at which the agency still had this version
+  std::atomic<uint64_t> _currentAgencyVersion;
+  std::atomic<double> _currentConfirmed;
+
+  // picks the replica for the next follower read
+  std::atomic<uint64_t> _readServerCounter;
+
   // We need information about collections, again we have
   // data from Plan and from Current.
   // The information for _shards and _shardKeys are filled from the
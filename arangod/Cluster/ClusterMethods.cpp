@@ -30,6 +30,7 @@
 #include "Basics/VelocyPackHelper.h"
 #include "Cluster/ClusterComm.h"
 #include "Cluster/ClusterInfo.h"
+#include "Cluster/CoordinatorDocumentCache.h"
 #include "Indexes/Index.h"
 #include "Utils/CollectionNameResolver.h"
 #include "Utils/OperationOptions.h"
@@ -39,8 +40,10 @@
 
 #include <velocypack/Buffer.h>
 #include <velocypack/Collection.h>
+#include <velocypack/Dumper.h>
 #include <velocypack/Helpers.h>
 #include <velocypack/Iterator.h>
+#include <velocypack/Sink.h>
 #include <velocypack/Slice.h>
 #include <velocypack/velocypack-aliases.h>
 
@@ -186,36 +189,6 @@ static std::shared_ptr<VPackBuilder> ExtractAnswer(
   return rv;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief merge the baby-object results.
-///        The shard map contains the ordering of elements, the vector in this
-///        Map is expected to be sorted from front to back.
-///        The second map contains the answers for each shard.
-///        The builder in the third parameter will be cleared and will contain
-///        the resulting array. It is guaranteed that the resulting array
-///        indexes
-///        are equal to the original request ordering before it was destructured
-///        for babies.
-////////////////////////////////////////////////////////////////////////////////
-
-static void mergeResults(
-    std::vector<std::pair<ShardID, VPackValueLength>> const& reverseMapping,
-    std::unordered_map<ShardID, std::shared_ptr<VPackBuilder>> const& resultMap,
-    std::shared_ptr<VPackBuilder>& resultBody) {
-  resultBody->clear();
-  resultBody->openArray();
-  for (auto const& pair : reverseMapping) {
-    VPackSlice arr = resultMap.find(pair.first)->second->slice();
-    if (arr.isObject() && arr.hasKey("error") && arr.get("error").isBoolean() && arr.get("error").getBoolean()) {
-      // an error occurred, now rethrow the error
-      int res = arr.get("errorNum").getNumericValue<int>();
-      THROW_ARANGO_EXCEPTION(res);
-    }
-    resultBody->add(arr.at(pair.second));
-  }
-  resultBody->close();
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief merge the baby-object results. (all shards version)
 ///        results contians the result from all shards in any order.
@@ -302,18 +275,191 @@ static void extractErrorCodes(ClusterCommResult const& res,
   }
 }
 
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the documents of a multi-document operation, partitioned by the
+///        responsible shard. The shard of every document is determined once,
+///        documents are referenced as slices into the input instead of being
+///        copied, and each shard answer is taken apart as soon as it arrives.
+///        The final merge in input order then only copies the results.
+////////////////////////////////////////////////////////////////////////////////
+
+class BatchPartition {
+ public:
+  struct Batch {
+    explicit Batch(ShardID const& shard) : shard(shard) {}
+
+    ShardID shard;
+    std::vector<VPackSlice> documents;
+    // keys generated by the coordinator, empty if the document brings its own
+    std::vector<std::string> keys;
+    // the answer of the shard, results point into it
+    std::shared_ptr<VPackBuilder> answer;
+    std::vector<VPackSlice> results;
+    int errorCode = TRI_ERROR_NO_ERROR;
+    bool done = false;
+  };
+
+  explicit BatchPartition(VPackValueLength expected) {
+    _positions.reserve(static_cast<size_t>(expected));
+  }
+
+  std::vector<Batch> const& batches() const { return _batches; }
+
+  void clear() {
+    _batches.clear();
+    _lookup.clear();
+    _positions.clear();
+  }
+
+  void add(ShardID const& shard, VPackSlice document,
+           std::string&& key = std::string()) {
+    size_t index;
+    auto it = _lookup.find(shard);
+    if (it == _lookup.end()) {
+      index = _batches.size();
+      _batches.emplace_back(shard);
+      _lookup.emplace(shard, index);
+    } else {
+      index = it->second;
+    }
+    Batch& batch = _batches[index];
+    _positions.emplace_back(index, batch.documents.size());
+    batch.documents.push_back(document);
+    batch.keys.emplace_back(std::move(key));
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief serialize the documents of a batch straight from the input
+  ///        slices. a single document is sent as is, several as an array
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::shared_ptr<std::string> body(size_t index, bool asArray) const {
+    Batch const& batch = _batches[index];
+    auto body = std::make_shared<std::string>();
+    VPackStringSink sink(body.get());
+    VPackDumper dumper(&sink);
+    VPackBuilder withKey;
+
+    if (asArray) {
+      body->push_back('[');
+    }
+    for (size_t i = 0; i < batch.documents.size(); ++i) {
+      if (i > 0) {
+        body->push_back(',');
+      }
+      if (batch.keys[i].empty()) {
+        dumper.dump(batch.documents[i]);
+      } else {
+        withKey.clear();
+        withKey.openObject();
+        withKey.add(StaticStrings::KeyString, VPackValue(batch.keys[i]));
+        TRI_SanitizeObject(batch.documents[i], withKey);
+        withKey.close();
+        dumper.dump(withKey.slice());
+      }
+    }
+    if (asArray) {
+      body->push_back(']');
+    }
+    return body;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief take apart the answer for a batch. nothing is modified if this
+  ///        throws, so it can be retried later
+  //////////////////////////////////////////////////////////////////////////////
+
+  void consume(size_t index, ClusterCommResult const& res,
+               std::unordered_map<int, size_t>& errorCounter,
+               rest::ResponseCode& responseCode) {
+    Batch& batch = _batches[index];
+    if (batch.done) {
+      return;
+    }
+
+    std::shared_ptr<VPackBuilder> answer;
+    std::vector<VPackSlice> results;
+    int errorCode = TRI_ERROR_NO_ERROR;
+
+    int commError = handleGeneralCommErrors(&res);
+    if (commError != TRI_ERROR_NO_ERROR) {
+      // every document of the shard refers to the same error object
+      answer = std::make_shared<VPackBuilder>();
+      answer->openObject();
+      answer->add("error", VPackValue(true));
+      answer->add("errorNum", VPackValue(commError));
+      answer->close();
+      results.assign(batch.documents.size(), answer->slice());
+    } else {
+      TRI_ASSERT(res.answer != nullptr);
+      answer = res.answer->toVelocyPackBuilderPtr();
+      VPackSlice slice = answer->slice();
+      if (slice.isArray()) {
+        results.reserve(static_cast<size_t>(slice.length()));
+        for (auto const& it : VPackArrayIterator(slice)) {
+          results.push_back(it);
+        }
+      } else if (slice.isObject() && slice.get("error").isTrue()) {
+        // the whole batch failed, this is rethrown by merge()
+        errorCode = slice.get("errorNum").getNumericValue<int>();
+      }
+
+      std::unordered_map<int, size_t> codes;
+      extractErrorCodes(res, codes, true);
+      for (auto const& it : codes) {
+        errorCounter[it.first] += it.second;
+      }
+      responseCode = res.answer_code;
+    }
+
+    batch.answer = std::move(answer);
+    batch.results = std::move(results);
+    batch.errorCode = errorCode;
+    batch.done = true;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief build the result array in the order of the input
+  //////////////////////////////////////////////////////////////////////////////
+
+  void merge(std::shared_ptr<VPackBuilder>& resultBody) const {
+    resultBody->clear();
+    resultBody->openArray();
+    for (auto const& position : _positions) {
+      Batch const& batch = _batches[position.first];
+      if (batch.errorCode != TRI_ERROR_NO_ERROR) {
+        THROW_ARANGO_EXCEPTION(batch.errorCode);
+      }
+      if (position.second >= batch.results.size()) {
+        THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL,
+                                       "invalid answer from shard '" +
+                                           batch.shard + "'");
+      }
+      resultBody->add(batch.results[position.second]);
+    }
+    resultBody->close();
+  }
+
+ private:
+  std::vector<Batch> _batches;
+  std::unordered_map<ShardID, size_t> _lookup;
+  // batch and position within the batch, for every input document
+  std::vector<std::pair<size_t, size_t>> _positions;
+};
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief Distribute one document onto a shard map. If this returns
+/// @brief Distribute one document onto a shard. If this returns
 ///        TRI_ERROR_NO_ERROR the correct shard could be determined, if
-///        it returns sth. else this document is NOT contained in the shardMap
+///        it returns sth. else this document is NOT contained in the partition
 ////////////////////////////////////////////////////////////////////////////////
 
-static int distributeBabyOnShards(
-    std::unordered_map<ShardID, std::vector<VPackValueLength>>& shardMap,
-    ClusterInfo* ci, std::string const& collid,
-    std::shared_ptr<LogicalCollection> collinfo,
-    std::vector<std::pair<ShardID, VPackValueLength>>& reverseMapping,
-    VPackSlice const node, VPackValueLength const index) {
+static int distributeBabyOnShards(BatchPartition& partition, ClusterInfo* ci,
+                                  std::shared_ptr<LogicalCollection> collinfo,
+                                  VPackSlice const node) {
   // Now find the responsible shard:
   bool usesDefaultShardingAttributes;
   ShardID shardID;
@@ -328,33 +474,20 @@ static int distributeBabyOnShards(
   }
 
   // We found the responsible shard. Add it to the list.
-  auto it = shardMap.find(shardID);
-  if (it == shardMap.end()) {
-    std::vector<VPackValueLength> counter({index});
-    shardMap.emplace(shardID, counter);
-    reverseMapping.emplace_back(shardID, 0);
-  } else {
-    it->second.emplace_back(index);
-    reverseMapping.emplace_back(shardID, it->second.size() - 1);
-  }
+  partition.add(shardID, node);
   return TRI_ERROR_NO_ERROR;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief Distribute one document onto a shard map. If this returns
+/// @brief Distribute one new document onto a shard. If this returns
 ///        TRI_ERROR_NO_ERROR the correct shard could be determined, if
-///        it returns sth. else this document is NOT contained in the shardMap.
+///        it returns sth. else this document is NOT contained in the partition.
 ///        Also generates a key if necessary.
 ////////////////////////////////////////////////////////////////////////////////
 
-static int distributeBabyOnShards(
-    std::unordered_map<ShardID,
-                       std::vector<std::pair<VPackValueLength, std::string>>>&
-        shardMap,
-    ClusterInfo* ci, std::string const& collid,
-    std::shared_ptr<LogicalCollection> collinfo,
-    std::vector<std::pair<ShardID, VPackValueLength>>& reverseMapping,
-    VPackSlice const node, VPackValueLength const index) {
+static int distributeNewBabyOnShards(
+    BatchPartition& partition, ClusterInfo* ci, std::string const& collid,
+    std::shared_ptr<LogicalCollection> collinfo, VPackSlice const node) {
   ShardID shardID;
   bool userSpecifiedKey = false;
   std::string _key = "";
@@ -408,60 +541,56 @@ static int distributeBabyOnShards(
   }
 
   // We found the responsible shard. Add it to the list.
-  auto it = shardMap.find(shardID);
-  if (it == shardMap.end()) {
-    std::vector<std::pair<VPackValueLength, std::string>> counter(
-        {{index, _key}});
-    shardMap.emplace(shardID, counter);
-    reverseMapping.emplace_back(shardID, 0);
-  } else {
-    it->second.emplace_back(index, _key);
-    reverseMapping.emplace_back(shardID, it->second.size() - 1);
-  }
+  partition.add(shardID, node, std::move(_key));
   return TRI_ERROR_NO_ERROR;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief Collect the results from all shards (fastpath variant)
-///        All result bodies are stored in resultMap
+/// @brief send one request per batch (in batch order) and take the answers
+///        apart as the shards respond. afterwards all batches are done, those
+///        without an answer carry the communication error
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename T>
-static void collectResultsFromAllShards(
-    std::unordered_map<ShardID, std::vector<T>> const& shardMap,
+static void performBatchRequests(
+    std::shared_ptr<ClusterComm> const& cc, BatchPartition& partition,
     std::vector<ClusterCommRequest>& requests,
     std::unordered_map<int, size_t>& errorCounter,
-    std::unordered_map<ShardID, std::shared_ptr<VPackBuilder>>& resultMap,
     rest::ResponseCode& responseCode) {
+  TRI_ASSERT(requests.size() == partition.batches().size());
   // If none of the shards responds we return a SERVER_ERROR;
   responseCode = rest::ResponseCode::SERVER_ERROR;
-  for (auto const& req : requests) {
-    auto res = req.result;
 
-    int commError = handleGeneralCommErrors(&res);
-    if (commError != TRI_ERROR_NO_ERROR) {
-      auto tmpBuilder = std::make_shared<VPackBuilder>();
-      // If there was no answer whatsoever, we cannot rely on the shardId
-      // being present in the result struct:
-      ShardID sId = req.destination.substr(6);
-      auto weSend = shardMap.find(sId);
-      TRI_ASSERT(weSend != shardMap.end());  // We send sth there earlier.
-      size_t count = weSend->second.size();
-      for (size_t i = 0; i < count; ++i) {
-        tmpBuilder->openObject();
-        tmpBuilder->add("error", VPackValue(true));
-        tmpBuilder->add("errorNum", VPackValue(commError));
-        tmpBuilder->close();
-      }
-      resultMap.emplace(sId, tmpBuilder);
-    } else {
-      TRI_ASSERT(res.answer != nullptr);
-      resultMap.emplace(res.shardID,
-                        res.answer->toVelocyPackBuilderPtr());
-      extractErrorCodes(res, errorCounter, true);
-      responseCode = res.answer_code;
+  size_t nrDone = 0;
+  cc->performRequests(
+      requests, CL_DEFAULT_TIMEOUT, nrDone, Logger::COMMUNICATION, true,
+      [&](size_t index) {
+        try {
+          partition.consume(index, requests[index].result, errorCounter,
+                            responseCode);
+        } catch (...) {
+          // retried and reported below
+        }
+      });
+
+  for (size_t i = 0; i < requests.size(); ++i) {
+    partition.consume(i, requests[i].result, errorCounter, responseCode);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destination of a read from a shard: its leader, or any in-sync
+/// replica if the read accepts some staleness
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string readDestination(ClusterInfo* ci, ShardID const& shard,
+                                   OperationOptions const& options) {
+  if (options.maxStaleness > 0.0) {
+    ServerID server = ci->getReadServer(shard, options.maxStaleness);
+    if (!server.empty()) {
+      return "server:" + server;
     }
   }
+  return "shard:" + shard;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -563,6 +692,29 @@ bool shardKeysChanged(std::string const& dbname, std::string const& collname,
 
 int revisionOnCoordinator(std::string const& dbname,
                           std::string const& collname, TRI_voc_rid_t& rid) {
+  rid = 0;
+
+  std::unordered_map<ShardID, TRI_voc_rid_t> revisions;
+  int res = shardRevisionsOnCoordinator(dbname, {collname}, revisions);
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  for (auto const& it : revisions) {
+    // get the maximum value
+    rid = (std::max)(rid, it.second);
+  }
+  return TRI_ERROR_NO_ERROR;  // the cluster operation was OK, however,
+                              // the DBserver could have reported an error.
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the revisions of all shards of the collections
+////////////////////////////////////////////////////////////////////////////////
+
+int shardRevisionsOnCoordinator(
+    std::string const& dbname, std::vector<std::string> const& collnames,
+    std::unordered_map<ShardID, TRI_voc_rid_t>& result) {
   // Set a few variables needed for our work:
   ClusterInfo* ci = ClusterInfo::instance();
   auto cc = ClusterComm::instance();
@@ -571,37 +723,36 @@ int revisionOnCoordinator(std::string const& dbname,
     return TRI_ERROR_SHUTTING_DOWN;
   }
 
-  // First determine the collection ID from the name:
-  std::shared_ptr<LogicalCollection> collinfo;
-  try {
-    collinfo = ci->getCollection(dbname, collname);
-  } catch (...) {
-    return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
-  }
-  TRI_ASSERT(collinfo != nullptr);
-
-  rid = 0;
-
-  // If we get here, the sharding attributes are not only _key, therefore
-  // we have to contact everybody:
-  auto shards = collinfo->shardIds();
   CoordTransactionID coordTransactionID = TRI_NewTickServer();
+  size_t numRequests = 0;
 
-  for (auto const& p : *shards) {
-    auto headers =
-        std::make_unique<std::unordered_map<std::string, std::string>>();
-    cc->asyncRequest(
-        "", coordTransactionID, "shard:" + p.first,
-        arangodb::rest::RequestType::GET,
-        "/_db/" + StringUtils::urlEncode(dbname) + "/_api/collection/" +
-            StringUtils::urlEncode(p.first) + "/revision",
-        std::shared_ptr<std::string const>(), headers, nullptr, 300.0);
+  for (auto const& collname : collnames) {
+    // First determine the collection ID from the name:
+    std::shared_ptr<LogicalCollection> collinfo;
+    try {
+      collinfo = ci->getCollection(dbname, collname);
+    } catch (...) {
+      return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
+    }
+    TRI_ASSERT(collinfo != nullptr);
+
+    auto shards = collinfo->shardIds();
+    for (auto const& p : *shards) {
+      auto headers =
+          std::make_unique<std::unordered_map<std::string, std::string>>();
+      cc->asyncRequest(
+          "", coordTransactionID, "shard:" + p.first,
+          arangodb::rest::RequestType::GET,
+          "/_db/" + StringUtils::urlEncode(dbname) + "/_api/collection/" +
+              StringUtils::urlEncode(p.first) + "/revision",
+          std::shared_ptr<std::string const>(), headers, nullptr, 300.0);
+      ++numRequests;
+    }
   }
 
   // Now listen to the results:
-  int count;
-  int nrok = 0;
-  for (count = (int)shards->size(); count > 0; count--) {
+  size_t nrok = 0;
+  for (size_t count = numRequests; count > 0; count--) {
     auto res = cc->wait("", coordTransactionID, 0, "", 0.0);
     if (res.status == CL_COMM_RECEIVED) {
       if (res.answer_code == arangodb::rest::ResponseCode::OK) {
@@ -610,29 +761,29 @@ int revisionOnCoordinator(std::string const& dbname,
 
         if (answer.isObject()) {
           VPackSlice r = answer.get("revision");
+          TRI_voc_rid_t rid = 0;
 
           if (r.isString()) {
             VPackValueLength len;
             char const* p = r.getString(len);
             TRI_voc_rid_t cmp = TRI_StringToRid(p, len, false);
 
-            if (cmp != UINT64_MAX && cmp > rid) {
-              // get the maximum value
+            if (cmp != UINT64_MAX) {
               rid = cmp;
             }
           }
+          result[res.shardID] = rid;
           nrok++;
         }
       }
     }
   }
 
-  if (nrok != (int)shards->size()) {
+  if (nrok != numRequests) {
     return TRI_ERROR_INTERNAL;
   }
 
-  return TRI_ERROR_NO_ERROR;  // the cluster operation was OK, however,
-                              // the DBserver could have reported an error.
+  return TRI_ERROR_NO_ERROR;
 }
 
 int warmupOnCoordinator(std::string const& dbname,
@@ -963,25 +1114,20 @@ int createDocumentOnCoordinator(
   TRI_ASSERT(collinfo != nullptr);
 
   std::string const collid = collinfo->cid_as_string();
-  std::unordered_map<
-      ShardID, std::vector<std::pair<VPackValueLength, std::string>>> shardMap;
-  std::vector<std::pair<ShardID, VPackValueLength>> reverseMapping;
   bool useMultiple = slice.isArray();
+  BatchPartition partition(useMultiple ? slice.length() : 1);
 
   int res = TRI_ERROR_NO_ERROR;
 
   if (useMultiple) {
-    VPackValueLength length = slice.length();
-    for (VPackValueLength idx = 0; idx < length; ++idx) {
-      res = distributeBabyOnShards(shardMap, ci, collid, collinfo,
-                                   reverseMapping, slice.at(idx), idx);
+    for (auto const& node : VPackArrayIterator(slice)) {
+      res = distributeNewBabyOnShards(partition, ci, collid, collinfo, node);
       if (res != TRI_ERROR_NO_ERROR) {
         return res;
       }
     }
   } else {
-    res = distributeBabyOnShards(shardMap, ci, collid, collinfo, reverseMapping,
-                                 slice, 0);
+    res = distributeNewBabyOnShards(partition, ci, collid, collinfo, slice);
     if (res != TRI_ERROR_NO_ERROR) {
       return res;
     }
@@ -995,54 +1141,21 @@ int createDocumentOnCoordinator(
       "&returnNew=" + (options.returnNew ? "true" : "false") + "&returnOld=" +
       (options.returnOld ? "true" : "false");
 
-  VPackBuilder reqBuilder;
-
   // Now prepare the requests:
   std::vector<ClusterCommRequest> requests;
-  auto body = std::make_shared<std::string>();
-
-  for (auto const& it : shardMap) {
-    if (!useMultiple) {
-      TRI_ASSERT(it.second.size() == 1);
-      auto idx = it.second.front();
-      if (idx.second.empty()) {
-        body = std::make_shared<std::string>(slice.toJson());
-      } else {
-        reqBuilder.clear();
-        reqBuilder.openObject();
-        reqBuilder.add(StaticStrings::KeyString, VPackValue(idx.second));
-        TRI_SanitizeObject(slice, reqBuilder);
-        reqBuilder.close();
-        body = std::make_shared<std::string>(reqBuilder.slice().toJson());
-      }
-    } else {
-      reqBuilder.clear();
-      reqBuilder.openArray();
-      for (auto const& idx : it.second) {
-        if (idx.second.empty()) {
-          reqBuilder.add(slice.at(idx.first));
-        } else {
-          reqBuilder.openObject();
-          reqBuilder.add(StaticStrings::KeyString, VPackValue(idx.second));
-          TRI_SanitizeObject(slice.at(idx.first), reqBuilder);
-          reqBuilder.close();
-        }
-      }
-      reqBuilder.close();
-      body = std::make_shared<std::string>(reqBuilder.slice().toJson());
-    }
-
+  auto const& batches = partition.batches();
+  for (size_t i = 0; i < batches.size(); ++i) {
     requests.emplace_back(
-        "shard:" + it.first, arangodb::rest::RequestType::POST,
-        baseUrl + StringUtils::urlEncode(it.first) + optsUrlPart, body);
+        "shard:" + batches[i].shard, arangodb::rest::RequestType::POST,
+        baseUrl + StringUtils::urlEncode(batches[i].shard) + optsUrlPart,
+        partition.body(i, useMultiple));
   }
-  
-  // Perform the requests
-  size_t nrDone = 0;
-  cc->performRequests(requests, CL_DEFAULT_TIMEOUT, nrDone, Logger::COMMUNICATION, true);
 
-  // Now listen to the results:
   if (!useMultiple) {
+    // Perform the request
+    size_t nrDone = 0;
+    cc->performRequests(requests, CL_DEFAULT_TIMEOUT, nrDone, Logger::COMMUNICATION, true);
+
     TRI_ASSERT(requests.size() == 1);
     auto const& req = requests[0];
     auto& res = req.result;
@@ -1059,15 +1172,12 @@ int createDocumentOnCoordinator(
     return TRI_ERROR_NO_ERROR;
   }
 
-  std::unordered_map<ShardID, std::shared_ptr<VPackBuilder>> resultMap;
-
-  collectResultsFromAllShards<std::pair<VPackValueLength, std::string>>(
-      shardMap, requests, errorCounter, resultMap, responseCode);
+  performBatchRequests(cc, partition, requests, errorCounter, responseCode);
 
   responseCode =
       (options.waitForSync ? rest::ResponseCode::CREATED
                            : rest::ResponseCode::ACCEPTED);
-  mergeResults(reverseMapping, resultMap, resultBody);
+  partition.merge(resultBody);
 
   // the cluster operation was OK, however,
   // the DBserver could have reported an error.
@@ -1102,6 +1212,13 @@ int deleteDocumentOnCoordinator(
   TRI_ASSERT(collinfo != nullptr);
   bool useDefaultSharding = collinfo->usesDefaultShardKeys();
   std::string collid = collinfo->cid_as_string();
+
+  // drop cached copies once the shards have answered, this also covers
+  // reads which were answered while the operation was running
+  auto documentCache = CoordinatorDocumentCache::instance();
+  TRI_DEFER(if (documentCache != nullptr) {
+    documentCache->invalidate(collid, slice);
+  });
   bool useMultiple = slice.isArray();
 
   std::string const baseUrl =
@@ -1112,8 +1229,6 @@ int deleteDocumentOnCoordinator(
       "&returnOld=" + (options.returnOld ? "true" : "false") + "&ignoreRevs=" +
       (options.ignoreRevs ? "true" : "false");
 
-  VPackBuilder reqBuilder;
-
   if (useDefaultSharding) {
     // fastpath we know which server is responsible.
 
@@ -1121,10 +1236,9 @@ int deleteDocumentOnCoordinator(
     // Send the correct documents to the correct shards
     // Merge the results with static merge helper
 
-    std::unordered_map<ShardID, std::vector<VPackValueLength>> shardMap;
-    std::vector<std::pair<ShardID, VPackValueLength>> reverseMapping;
-    auto workOnOneNode = [&shardMap, &ci, &collid, &collinfo, &reverseMapping](
-        VPackSlice const node, VPackValueLength const index) -> int {
+    BatchPartition partition(useMultiple ? slice.length() : 1);
+    auto workOnOneNode = [&partition, &ci, &collid, &collinfo](
+        VPackSlice const node) -> int {
       // Sort out the _key attribute and identify the shard responsible for it.
 
       StringRef _key(transaction::helpers::extractKeyPart(node));
@@ -1150,28 +1264,20 @@ int deleteDocumentOnCoordinator(
       }
 
       // We found the responsible shard. Add it to the list.
-      auto it = shardMap.find(shardID);
-      if (it == shardMap.end()) {
-        std::vector<VPackValueLength> counter({index});
-        shardMap.emplace(shardID, counter);
-        reverseMapping.emplace_back(shardID, 0);
-      } else {
-        it->second.emplace_back(index);
-        reverseMapping.emplace_back(shardID, it->second.size() - 1);
-      }
+      partition.add(shardID, node);
       return TRI_ERROR_NO_ERROR;
     };
 
     if (useMultiple) {
-      for (VPackValueLength idx = 0; idx < slice.length(); ++idx) {
-        int res = workOnOneNode(slice.at(idx), idx);
+      for (auto const& node : VPackArrayIterator(slice)) {
+        int res = workOnOneNode(node);
         if (res != TRI_ERROR_NO_ERROR) {
           // Is early abortion correct?
           return res;
         }
       }
     } else {
-      int res = workOnOneNode(slice, 0);
+      int res = workOnOneNode(slice);
       if (res != TRI_ERROR_NO_ERROR) {
         return res;
       }
@@ -1181,32 +1287,20 @@ int deleteDocumentOnCoordinator(
 
     // Now prepare the requests:
     std::vector<ClusterCommRequest> requests;
-    auto body = std::make_shared<std::string>();
-    for (auto const& it : shardMap) {
-      if (!useMultiple) {
-        TRI_ASSERT(it.second.size() == 1);
-        body = std::make_shared<std::string>(slice.toJson());
-      } else {
-        reqBuilder.clear();
-        reqBuilder.openArray();
-        for (auto const& idx : it.second) {
-          reqBuilder.add(slice.at(idx));
-        }
-        reqBuilder.close();
-        body = std::make_shared<std::string>(reqBuilder.slice().toJson());
-      }
+    auto const& batches = partition.batches();
+    for (size_t i = 0; i < batches.size(); ++i) {
       requests.emplace_back(
-          "shard:" + it.first,
+          "shard:" + batches[i].shard,
           arangodb::rest::RequestType::DELETE_REQ,
-          baseUrl + StringUtils::urlEncode(it.first) + optsUrlPart, body);
+          baseUrl + StringUtils::urlEncode(batches[i].shard) + optsUrlPart,
+          partition.body(i, useMultiple));
     }
 
-    // Perform the requests
-    size_t nrDone = 0;
-    cc->performRequests(requests, CL_DEFAULT_TIMEOUT, nrDone, Logger::COMMUNICATION, true);
-
-    // Now listen to the results:
     if (!useMultiple) {
+      // Perform the request
+      size_t nrDone = 0;
+      cc->performRequests(requests, CL_DEFAULT_TIMEOUT, nrDone, Logger::COMMUNICATION, true);
+
       TRI_ASSERT(requests.size() == 1);
       auto const& req = requests[0];
       auto& res = req.result;
@@ -1223,10 +1317,8 @@ int deleteDocumentOnCoordinator(
       return TRI_ERROR_NO_ERROR;
     }
 
-    std::unordered_map<ShardID, std::shared_ptr<VPackBuilder>> resultMap;
-    collectResultsFromAllShards<VPackValueLength>(
-        shardMap, requests, errorCounter, resultMap, responseCode);
-    mergeResults(reverseMapping, resultMap, resultBody);
+    performBatchRequests(cc, partition, requests, errorCounter, responseCode);
+    partition.merge(resultBody);
     return TRI_ERROR_NO_ERROR;  // the cluster operation was OK, however,
                                 // the DBserver could have reported an error.
   }
@@ -1334,6 +1426,11 @@ int truncateCollectionOnCoordinator(std::string const& dbname,
   }
   TRI_ASSERT(collinfo != nullptr);
 
+  // entries of the collection are stored under its id, but an epoch
+  // change is cheaper than finding them
+  auto documentCache = CoordinatorDocumentCache::instance();
+  TRI_DEFER(if (documentCache != nullptr) { documentCache->invalidateAll(); });
+
   // Some stuff to prepare cluster-intern requests:
   // We have to contact everybody:
   auto shards = collinfo->shardIds();
@@ -1396,6 +1493,40 @@ int getDocumentOnCoordinator(
 
   std::string collid = collinfo->cid_as_string();
 
+  bool useMultiple = slice.isArray();
+
+  // single documents can be served from the local cache, if enabled
+  auto documentCache = CoordinatorDocumentCache::instance();
+  bool const useCache =
+      documentCache != nullptr && !useMultiple && !options.silent;
+  CoordinatorDocumentCache::Ticket cacheTicket;
+  if (useCache) {
+    auto cached = std::make_shared<VPackBuilder>();
+    if (documentCache->lookup(collid,
+                              transaction::helpers::extractKeyPart(slice),
+                              *cached)) {
+      bool matches = true;
+      if (!options.ignoreRevs && slice.isObject() &&
+          slice.hasKey(StaticStrings::RevString)) {
+        // the caller expects a specific revision, only the leader can
+        // report a mismatch properly
+        VPackSlice rev = cached->slice().get(StaticStrings::RevString);
+        matches = rev.isString() &&
+                  rev.copyString() ==
+                      slice.get(StaticStrings::RevString).copyString();
+      }
+      if (matches) {
+        responseCode = arangodb::rest::ResponseCode::OK;
+        resultBody.swap(cached);
+        return TRI_ERROR_NO_ERROR;
+      }
+    }
+    // taken before the request, so that the answer is not stored if a write
+    // to the key finishes in the meantime
+    cacheTicket = documentCache->ticket(
+        collid, transaction::helpers::extractKeyPart(slice));
+  }
+
   // If _key is the one and only sharding attribute, we can do this quickly,
   // because we can easily determine which shard is responsible for the
   // document. Otherwise we have to contact all shards and ask them to
@@ -1404,27 +1535,21 @@ int getDocumentOnCoordinator(
 
   ShardID shardID;
 
-  std::unordered_map<ShardID, std::vector<VPackValueLength>> shardMap;
-  std::vector<std::pair<ShardID, VPackValueLength>> reverseMapping;
-  bool useMultiple = slice.isArray();
+  BatchPartition partition(useMultiple ? slice.length() : 1);
 
   int res = TRI_ERROR_NO_ERROR;
   bool canUseFastPath = true;
   if (useMultiple) {
-    VPackValueLength length = slice.length();
-    for (VPackValueLength idx = 0; idx < length; ++idx) {
-      res = distributeBabyOnShards(shardMap, ci, collid, collinfo,
-                                   reverseMapping, slice.at(idx), idx);
+    for (auto const& node : VPackArrayIterator(slice)) {
+      res = distributeBabyOnShards(partition, ci, collinfo, node);
       if (res != TRI_ERROR_NO_ERROR) {
         canUseFastPath = false;
-        shardMap.clear();
-        reverseMapping.clear();
+        partition.clear();
         break;
       }
     }
   } else {
-    res = distributeBabyOnShards(shardMap, ci, collid, collinfo, reverseMapping,
-                                 slice, 0);
+    res = distributeBabyOnShards(partition, ci, collinfo, slice);
     if (res != TRI_ERROR_NO_ERROR) {
       canUseFastPath = false;
     }
@@ -1456,14 +1581,14 @@ int getDocumentOnCoordinator(
     // All shard keys are known in all documents.
     // Contact all shards directly with the correct information.
 
-    VPackBuilder reqBuilder;
-
     // Now prepare the requests:
     std::vector<ClusterCommRequest> requests;
     auto body = std::make_shared<std::string>();
-    for (auto const& it : shardMap) {
+    auto const& batches = partition.batches();
+    for (size_t i = 0; i < batches.size(); ++i) {
+      ShardID const& shard = batches[i].shard;
       if (!useMultiple) {
-        TRI_ASSERT(it.second.size() == 1);
+        TRI_ASSERT(batches[i].documents.size() == 1);
         if (!options.ignoreRevs && slice.hasKey(StaticStrings::RevString)) {
           headers->emplace("if-match",
                            slice.get(StaticStrings::RevString).copyString());
@@ -1476,33 +1601,30 @@ int getDocumentOnCoordinator(
 
         // We send to single endpoint
         requests.emplace_back(
-            "shard:" + it.first, reqType,
-            baseUrl + StringUtils::urlEncode(it.first) + "/" +
+            readDestination(ci, shard, options), reqType,
+            baseUrl + StringUtils::urlEncode(shard) + "/" +
                 StringUtils::urlEncode(keySlice.copyString()) +
                 optsUrlPart,
             body);
         requests[0].setHeaders(headers);
       } else {
-        reqBuilder.clear();
-        reqBuilder.openArray();
-        for (auto const& idx : it.second) {
-          reqBuilder.add(slice.at(idx));
-        }
-        reqBuilder.close();
-        body = std::make_shared<std::string>(reqBuilder.slice().toJson());
         // We send to Babies endpoint
         requests.emplace_back(
-            "shard:" + it.first, reqType,
-            baseUrl + StringUtils::urlEncode(it.first) + optsUrlPart, body);
+            readDestination(ci, shard, options), reqType,
+            baseUrl + StringUtils::urlEncode(shard) + optsUrlPart,
+            partition.body(i, true));
       }
     }
 
-    // Perform the requests
-    size_t nrDone = 0;
-    cc->performRequests(requests, CL_DEFAULT_TIMEOUT, nrDone, Logger::COMMUNICATION, true);
+    // Perform the requests, the answers are consumed as VelocyPack
+    for (auto& req : requests) {
+      req.transport = ClusterCommTransport::VST;
+    }
 
-    // Now listen to the results:
     if (!useMultiple) {
+      size_t nrDone = 0;
+      cc->performRequests(requests, CL_DEFAULT_TIMEOUT, nrDone, Logger::COMMUNICATION, true);
+
       TRI_ASSERT(requests.size() == 1);
       auto const& req = requests[0];
       auto res = req.result;
@@ -1516,15 +1638,17 @@ int getDocumentOnCoordinator(
       TRI_ASSERT(res.answer != nullptr);
 
       auto parsedResult = res.answer->toVelocyPackBuilderPtr();
+      if (useCache && responseCode == arangodb::rest::ResponseCode::OK) {
+        documentCache->store(collid,
+                             transaction::helpers::extractKeyPart(slice),
+                             parsedResult->slice(), cacheTicket);
+      }
       resultBody.swap(parsedResult);
       return TRI_ERROR_NO_ERROR;
     }
 
-    std::unordered_map<ShardID, std::shared_ptr<VPackBuilder>> resultMap;
-    collectResultsFromAllShards<VPackValueLength>(
-        shardMap, requests, errorCounter, resultMap, responseCode);
-
-    mergeResults(reverseMapping, resultMap, resultBody);
+    performBatchRequests(cc, partition, requests, errorCounter, responseCode);
+    partition.merge(resultBody);
 
     // the cluster operation was OK, however,
     // the DBserver could have reported an error.
@@ -1547,7 +1671,7 @@ int getDocumentOnCoordinator(
         keySlice = slice.get(StaticStrings::KeyString);
       }
       ClusterCommRequest req(
-          "shard:" + shard, reqType,
+          readDestination(ci, shard, options), reqType,
           baseUrl + StringUtils::urlEncode(shard) + "/" +
               StringUtils::urlEncode(keySlice.copyString()) +
               optsUrlPart,
@@ -1562,12 +1686,15 @@ int getDocumentOnCoordinator(
     auto body = std::make_shared<std::string>(slice.toJson());
     for (auto const& shard : *shardList) {
       requests.emplace_back(
-          "shard:" + shard, reqType,
+          readDestination(ci, shard, options), reqType,
           baseUrl + StringUtils::urlEncode(shard) + optsUrlPart, body);
     }
   }
 
   // Perform the requests
+  for (auto& req : requests) {
+    req.transport = ClusterCommTransport::VST;
+  }
   size_t nrDone = 0;
   cc->performRequests(requests, CL_DEFAULT_TIMEOUT, nrDone, Logger::COMMUNICATION, true);
 
@@ -1727,6 +1854,151 @@ int fetchEdgesFromEngines(
   return TRI_ERROR_NO_ERROR;
 }
 
+/// @brief fetch edges for a whole set of vertices from TraverserEngines
+///        Sends one request per DBServer for all
+///        given vertex _id's and groups the edges
+///        by the vertex they were found for.
+///        addParameters adds the lookup parameters
+///        (depth or direction) to the request body.
+
+static int fetchGroupedEdgesFromEngines(
+    std::string const& dbname,
+    std::unordered_map<ServerID, traverser::TraverserEngineID> const* engines,
+    std::vector<StringRef> const& vertexIds,
+    std::function<void(VPackBuilder&)> const& addParameters,
+    std::unordered_map<StringRef, VPackSlice>& cache,
+    std::unordered_map<StringRef, std::vector<VPackSlice>>& result,
+    std::vector<std::shared_ptr<VPackBuilder>>& datalake,
+    VPackBuilder& builder,
+    size_t& filtered,
+    size_t& read) {
+  auto cc = ClusterComm::instance();
+  if (cc == nullptr) {
+    // nullptr happens only during controlled shutdown
+    return TRI_ERROR_SHUTTING_DOWN;
+  }
+
+  builder.clear();
+  builder.openObject();
+  addParameters(builder);
+  builder.add("grouped", VPackValue(true));
+  builder.add(VPackValue("keys"));
+  builder.openArray();
+  for (auto const& v : vertexIds) {
+    builder.add(VPackValuePair(v.data(), v.length(), VPackValueType::String));
+  }
+  builder.close(); // 'keys' Array
+  builder.close(); // base object
+
+  std::string const url =
+      "/_db/" + StringUtils::urlEncode(dbname) + "/_internal/traverser/edge/";
+
+  std::vector<ClusterCommRequest> requests;
+  auto body = std::make_shared<std::string>(builder.toJson());
+  for (auto const& engine : *engines) {
+    requests.emplace_back("server:" + engine.first, RequestType::PUT,
+                          url + StringUtils::itoa(engine.second), body);
+  }
+
+  // Perform the requests
+  size_t nrDone = 0;
+  cc->performRequests(requests, CL_DEFAULT_TIMEOUT, nrDone, Logger::COMMUNICATION, false);
+
+  result.clear();
+  for (auto const& v : vertexIds) {
+    // vertices without any edge get an empty list as well
+    result[v];
+  }
+
+  // Now listen to the results:
+  for (auto const& req : requests) {
+    bool allCached = true;
+    auto res = req.result;
+    int commError = handleGeneralCommErrors(&res);
+    if (commError != TRI_ERROR_NO_ERROR) {
+      // oh-oh cluster is in a bad state
+      return commError;
+    }
+    TRI_ASSERT(res.answer != nullptr);
+    auto resBody = res.answer->toVelocyPackBuilderPtr();
+    VPackSlice resSlice = resBody->slice();
+    if (!resSlice.isObject()) {
+      // Response has invalid format
+      return TRI_ERROR_HTTP_CORRUPTED_JSON;
+    }
+    filtered += arangodb::basics::VelocyPackHelper::getNumericValue<size_t>(
+        resSlice, "filtered", 0);
+    read += arangodb::basics::VelocyPackHelper::getNumericValue<size_t>(
+        resSlice, "readIndex", 0);
+    VPackSlice edges = resSlice.get("edges");
+    if (!edges.isArray() || edges.length() != vertexIds.size()) {
+      // one list of edges per vertex expected
+      return TRI_ERROR_CLUSTER_GOT_CONTRADICTING_ANSWERS;
+    }
+    size_t i = 0;
+    for (auto const& list : VPackArrayIterator(edges)) {
+      auto& target = result[vertexIds[i++]];
+      for (auto const& e : VPackArrayIterator(list)) {
+        VPackSlice id = e.get(StaticStrings::IdString);
+        StringRef idRef(id);
+        auto resE = cache.find(idRef);
+        if (resE == cache.end()) {
+          // This edge is not yet cached.
+          allCached = false;
+          cache.emplace(idRef, e);
+          target.emplace_back(e);
+        } else {
+          target.emplace_back(resE->second);
+        }
+      }
+    }
+    if (!allCached) {
+      datalake.emplace_back(resBody);
+    }
+  }
+  return TRI_ERROR_NO_ERROR;
+}
+
+/// @brief fetch edges for a whole set of vertices from TraverserEngines
+///        TraversalVariant
+
+int prefetchEdgesFromEngines(
+    std::string const& dbname,
+    std::unordered_map<ServerID, traverser::TraverserEngineID> const* engines,
+    std::vector<StringRef> const& vertexIds,
+    size_t depth,
+    std::unordered_map<StringRef, VPackSlice>& cache,
+    std::unordered_map<StringRef, std::vector<VPackSlice>>& result,
+    std::vector<std::shared_ptr<VPackBuilder>>& datalake,
+    VPackBuilder& builder,
+    size_t& filtered,
+    size_t& read) {
+  return fetchGroupedEdgesFromEngines(
+      dbname, engines, vertexIds,
+      [depth](VPackBuilder& b) { b.add("depth", VPackValue(depth)); }, cache,
+      result, datalake, builder, filtered, read);
+}
+
+/// @brief fetch edges for a whole set of vertices from TraverserEngines
+///        ShortestPathVariant
+
+int prefetchEdgesFromEngines(
+    std::string const& dbname,
+    std::unordered_map<ServerID, traverser::TraverserEngineID> const* engines,
+    std::vector<StringRef> const& vertexIds,
+    bool backward,
+    std::unordered_map<StringRef, VPackSlice>& cache,
+    std::unordered_map<StringRef, std::vector<VPackSlice>>& result,
+    std::vector<std::shared_ptr<VPackBuilder>>& datalake,
+    VPackBuilder& builder,
+    size_t& read) {
+  size_t filtered = 0;
+  return fetchGroupedEdgesFromEngines(
+      dbname, engines, vertexIds,
+      [backward](VPackBuilder& b) { b.add("backward", VPackValue(backward)); },
+      cache, result, datalake, builder, filtered, read);
+}
+
 /// @brief fetch vertices from TraverserEngines
 ///        Contacts all TraverserEngines placed
 ///        on the DBServers for the given list
@@ -2067,6 +2339,13 @@ int modifyDocumentOnCoordinator(
       ci->getCollection(dbname, collname);
   std::string collid = collinfo->cid_as_string();
 
+  // drop cached copies once the shards have answered, this also covers
+  // reads which were answered while the operation was running
+  auto documentCache = CoordinatorDocumentCache::instance();
+  TRI_DEFER(if (documentCache != nullptr) {
+    documentCache->invalidate(collid, slice);
+  });
+
   // We have a fast path and a slow path. The fast path only asks one shard
   // to do the job and the slow path asks them all and expects to get
   // "not found" from all but one shard. We have to cover the following
@@ -2091,30 +2370,25 @@ int modifyDocumentOnCoordinator(
 
   ShardID shardID;
 
-  std::unordered_map<ShardID, std::vector<VPackValueLength>> shardMap;
-  std::vector<std::pair<ShardID, VPackValueLength>> reverseMapping;
   bool useMultiple = slice.isArray();
+  BatchPartition partition(useMultiple ? slice.length() : 1);
 
   int res = TRI_ERROR_NO_ERROR;
   bool canUseFastPath = true;
   if (useMultiple) {
-    VPackValueLength length = slice.length();
-    for (VPackValueLength idx = 0; idx < length; ++idx) {
-      res = distributeBabyOnShards(shardMap, ci, collid, collinfo,
-                                   reverseMapping, slice.at(idx), idx);
+    for (auto const& node : VPackArrayIterator(slice)) {
+      res = distributeBabyOnShards(partition, ci, collinfo, node);
       if (res != TRI_ERROR_NO_ERROR) {
         if (!isPatch) {
           return res;
         }
         canUseFastPath = false;
-        shardMap.clear();
-        reverseMapping.clear();
+        partition.clear();
         break;
       }
     }
   } else {
-    res = distributeBabyOnShards(shardMap, ci, collid, collinfo, reverseMapping,
-                                 slice, 0);
+    res = distributeBabyOnShards(partition, ci, collinfo, slice);
     if (res != TRI_ERROR_NO_ERROR) {
       if (!isPatch) {
         return res;
@@ -2158,40 +2432,31 @@ int modifyDocumentOnCoordinator(
     // All shard keys are known in all documents.
     // Contact all shards directly with the correct information.
     std::vector<ClusterCommRequest> requests;
-    VPackBuilder reqBuilder;
-    auto body = std::make_shared<std::string>();
-    for (auto const& it : shardMap) {
+    auto const& batches = partition.batches();
+    for (size_t i = 0; i < batches.size(); ++i) {
+      ShardID const& shard = batches[i].shard;
       if (!useMultiple) {
-        TRI_ASSERT(it.second.size() == 1);
-        body = std::make_shared<std::string>(slice.toJson());
+        TRI_ASSERT(batches[i].documents.size() == 1);
 
         // We send to single endpoint
         requests.emplace_back(
-            "shard:" + it.first, reqType,
-            baseUrl + StringUtils::urlEncode(it.first) + "/" +
+            "shard:" + shard, reqType,
+            baseUrl + StringUtils::urlEncode(shard) + "/" +
                 StringUtils::urlEncode(slice.get(StaticStrings::KeyString).copyString()) + optsUrlPart,
-            body);
+            partition.body(i, false));
       } else {
-        reqBuilder.clear();
-        reqBuilder.openArray();
-        for (auto const& idx : it.second) {
-          reqBuilder.add(slice.at(idx));
-        }
-        reqBuilder.close();
-        body = std::make_shared<std::string>(reqBuilder.slice().toJson());
         // We send to Babies endpoint
         requests.emplace_back(
-            "shard:" + it.first, reqType,
-            baseUrl + StringUtils::urlEncode(it.first) + optsUrlPart, body);
+            "shard:" + shard, reqType,
+            baseUrl + StringUtils::urlEncode(shard) + optsUrlPart,
+            partition.body(i, true));
       }
     }
 
-    // Perform the requests
-    size_t nrDone = 0;
-    cc->performRequests(requests, CL_DEFAULT_TIMEOUT, nrDone, Logger::COMMUNICATION, true);
-
-    // Now listen to the results:
     if (!useMultiple) {
+      size_t nrDone = 0;
+      cc->performRequests(requests, CL_DEFAULT_TIMEOUT, nrDone, Logger::COMMUNICATION, true);
+
       TRI_ASSERT(requests.size() == 1);
       auto res = requests[0].result;
 
@@ -2207,11 +2472,8 @@ int modifyDocumentOnCoordinator(
       return TRI_ERROR_NO_ERROR;
     }
 
-    std::unordered_map<ShardID, std::shared_ptr<VPackBuilder>> resultMap;
-    collectResultsFromAllShards<VPackValueLength>(
-        shardMap, requests, errorCounter, resultMap, responseCode);
-
-    mergeResults(reverseMapping, resultMap, resultBody);
+    performBatchRequests(cc, partition, requests, errorCounter, responseCode);
+    partition.merge(resultBody);
 
     // the cluster operation was OK, however,
     // the DBserver could have reported an error.
@@ -2434,6 +2696,34 @@ std::unique_ptr<LogicalCollection> ClusterMethods::createCollectionOnCoordinator
 }
 #endif
 
+std::vector<std::unique_ptr<LogicalCollection>>
+ClusterMethods::createCollectionsOnCoordinator(
+    TRI_vocbase_t* vocbase, std::vector<VPackSlice> const& parameters,
+    bool ignoreDistributeShardsLikeErrors, bool waitForSyncReplication) {
+  if (parameters.empty()) {
+    return std::vector<std::unique_ptr<LogicalCollection>>();
+  }
+
+  // temporary collection objects for the sanity checks, like in
+  // createCollectionOnCoordinator
+  std::vector<std::unique_ptr<LogicalCollection>> cols;
+  std::vector<LogicalCollection*> pointers;
+  cols.reserve(parameters.size());
+  pointers.reserve(parameters.size());
+  for (auto const& it : parameters) {
+    cols.emplace_back(new LogicalCollection(vocbase, it));
+    if (cols.back()->isSmart()) {
+      // smart collections consist of several collections
+      THROW_ARANGO_EXCEPTION_MESSAGE(
+          TRI_ERROR_NOT_IMPLEMENTED,
+          "smart collections cannot be created together with others");
+    }
+    pointers.emplace_back(cols.back().get());
+  }
+  return persistCollectionsInAgency(pointers, ignoreDistributeShardsLikeErrors,
+                                    waitForSyncReplication, parameters);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Persist collection in Agency and trigger shard creation process
 ////////////////////////////////////////////////////////////////////////////////
@@ -2441,7 +2731,85 @@ std::unique_ptr<LogicalCollection> ClusterMethods::createCollectionOnCoordinator
 std::unique_ptr<LogicalCollection> ClusterMethods::persistCollectionInAgency(
   LogicalCollection* col, bool ignoreDistributeShardsLikeErrors,
   bool waitForSyncReplication, VPackSlice parameters) {
-  
+  auto result = persistCollectionsInAgency(
+      std::vector<LogicalCollection*>{col}, ignoreDistributeShardsLikeErrors,
+      waitForSyncReplication, std::vector<VPackSlice>{parameters});
+  TRI_ASSERT(result.size() == 1);
+  return std::move(result[0]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Persist collections of one database in Agency with one transaction
+/// and trigger the shard creation process for all of them
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::unique_ptr<LogicalCollection>>
+ClusterMethods::persistCollectionsInAgency(
+    std::vector<LogicalCollection*> const& cols,
+    bool ignoreDistributeShardsLikeErrors, bool waitForSyncReplication,
+    std::vector<VPackSlice> const& parameters) {
+  TRI_ASSERT(!cols.empty());
+  TRI_ASSERT(cols.size() == parameters.size());
+
+  ClusterInfo* ci = ClusterInfo::instance();
+  std::string const& dbName = cols[0]->dbName();
+
+  // the definitions must stay in place while the infos point into them
+  std::vector<VPackBuilder> definitions(cols.size());
+  std::vector<uint64_t> numbersOfShards(cols.size());
+  std::vector<uint64_t> replicationFactors(cols.size());
+  for (size_t i = 0; i < cols.size(); ++i) {
+    TRI_ASSERT(cols[i]->dbName() == dbName);
+    prepareCollectionForAgency(cols[i], ignoreDistributeShardsLikeErrors,
+                               parameters[i], definitions[i],
+                               numbersOfShards[i], replicationFactors[i]);
+  }
+
+  std::vector<ClusterCollectionCreationInfo> infos;
+  infos.reserve(cols.size());
+  for (size_t i = 0; i < cols.size(); ++i) {
+    infos.emplace_back(cols[i]->cid_as_string(), numbersOfShards[i],
+                       replicationFactors[i], definitions[i].slice());
+  }
+
+  // the DBServers create the shards of all collections concurrently, but
+  // a large batch still needs more time than a single collection
+  double const timeout = (std::max)(240.0, 2.0 * infos.size());
+
+  std::string errorMsg;
+  int myerrno = ci->createCollectionsCoordinator(
+      dbName, infos, waitForSyncReplication, errorMsg, timeout);
+
+  if (myerrno != TRI_ERROR_NO_ERROR) {
+    if (errorMsg.empty()) {
+      errorMsg = TRI_errno_string(myerrno);
+    }
+    THROW_ARANGO_EXCEPTION_MESSAGE(myerrno, errorMsg);
+  }
+  ci->loadPlan();
+
+  std::vector<std::unique_ptr<LogicalCollection>> result;
+  result.reserve(cols.size());
+  for (auto const& col : cols) {
+    auto c = ci->getCollection(dbName, col->cid_as_string());
+    // We never get a nullptr here because an exception is thrown if the
+    // collection does not exist. Also, the create collection should have
+    // failed before.
+    TRI_ASSERT(c != nullptr);
+    result.emplace_back(c->clone());
+  }
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief distribute the shards of a collection and build its definition for
+/// the Plan
+////////////////////////////////////////////////////////////////////////////////
+
+void ClusterMethods::prepareCollectionForAgency(
+    LogicalCollection* col, bool ignoreDistributeShardsLikeErrors,
+    VPackSlice parameters, VPackBuilder& definition, uint64_t& numberOfShardsOut,
+    uint64_t& replicationFactorOut) {
   std::string distributeShardsLike = col->distributeShardsLike();
   std::vector<std::string> avoid = col->avoidServers();
   size_t replicationFactor = col->replicationFactor();
@@ -2588,27 +2956,9 @@ std::unique_ptr<LogicalCollection> ClusterMethods::persistCollectionInAgency(
       "count",         "planId", "version", "objectId",
   };
   col->setStatus(TRI_VOC_COL_STATUS_LOADED);
-  VPackBuilder velocy = col->toVelocyPackIgnore(ignoreKeys, false, false);
-
-  std::string errorMsg;
-  int myerrno = ci->createCollectionCoordinator(
-      col->dbName(), col->cid_as_string(),
-      numberOfShards, replicationFactor, waitForSyncReplication, velocy.slice(), errorMsg, 240.0);
-
-  if (myerrno != TRI_ERROR_NO_ERROR) {
-    if (errorMsg.empty()) {
-      errorMsg = TRI_errno_string(myerrno);
-    }
-    THROW_ARANGO_EXCEPTION_MESSAGE(myerrno, errorMsg);
-  }
-  ci->loadPlan();
-
-  auto c = ci->getCollection(col->dbName(), col->cid_as_string());
-  // We never get a nullptr here because an exception is thrown if the
-  // collection does not exist. Also, the create collection should have
-  // failed before.
-  TRI_ASSERT(c != nullptr);
-  return c->clone();
+  definition = col->toVelocyPackIgnore(ignoreKeys, false, false);
+  numberOfShardsOut = numberOfShards;
+  replicationFactorOut = replicationFactor;
 }
 
 /// @brief fetch edges from TraverserEngines
@@ -68,6 +68,14 @@ bool shardKeysChanged(std::string const& dbname, std::string const& collname,
 int revisionOnCoordinator(std::string const& dbname,
                           std::string const& collname, TRI_voc_rid_t&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the revisions of all shards of the collections
+////////////////////////////////////////////////////////////////////////////////
+
+int shardRevisionsOnCoordinator(
+    std::string const& dbname, std::vector<std::string> const& collnames,
+    std::unordered_map<ShardID, TRI_voc_rid_t>& result);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Warmup index caches on Shards
 ////////////////////////////////////////////////////////////////////////////////
@@ -147,6 +155,38 @@ int fetchEdgesFromEngines(
     std::vector<std::shared_ptr<arangodb::velocypack::Builder>>&,
     arangodb::velocypack::Builder&, size_t&, size_t&);
 
+/// @brief fetch edges for a whole set of vertices from TraverserEngines
+///        Sends one request per DBServer for all
+///        given vertex _id's, e.g. a complete level
+///        of a breadth-first search, and groups the
+///        edges by the vertex they were found for.
+///        Storage of the edges works like in
+///        fetchEdgesFromEngines.
+///        TraversalVariant
+
+int prefetchEdgesFromEngines(
+    std::string const& dbname,
+    std::unordered_map<ServerID, traverser::TraverserEngineID> const* engines,
+    std::vector<StringRef> const& vertexIds, size_t depth,
+    std::unordered_map<StringRef, arangodb::velocypack::Slice>& cache,
+    std::unordered_map<StringRef, std::vector<arangodb::velocypack::Slice>>&
+        result,
+    std::vector<std::shared_ptr<arangodb::velocypack::Builder>>& datalake,
+    arangodb::velocypack::Builder& builder, size_t& filtered, size_t& read);
+
+/// @brief fetch edges for a whole set of vertices from TraverserEngines
+///        ShortestPathVariant
+
+int prefetchEdgesFromEngines(
+    std::string const& dbname,
+    std::unordered_map<ServerID, traverser::TraverserEngineID> const* engines,
+    std::vector<StringRef> const& vertexIds, bool backward,
+    std::unordered_map<StringRef, arangodb::velocypack::Slice>& cache,
+    std::unordered_map<StringRef, std::vector<arangodb::velocypack::Slice>>&
+        result,
+    std::vector<std::shared_ptr<arangodb::velocypack::Builder>>& datalake,
+    arangodb::velocypack::Builder& builder, size_t& read);
+
 /// @brief fetch edges from TraverserEngines
 ///        Contacts all TraverserEngines placed
 ///        on the DBServers for the given list
@@ -271,6 +311,15 @@ class ClusterMethods {
       bool ignoreDistributeShardsLikeErrors,
       bool waitForSyncReplication);
 
+  // @brief Create many collections of one database on coordinator, with
+  // one agency transaction for all of them. The collections are returned
+  // in the order of their parameters
+  static std::vector<std::unique_ptr<LogicalCollection>>
+  createCollectionsOnCoordinator(
+      TRI_vocbase_t* vocbase,
+      std::vector<arangodb::velocypack::Slice> const& parameters,
+      bool ignoreDistributeShardsLikeErrors, bool waitForSyncReplication);
+
  private:
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -280,6 +329,26 @@ class ClusterMethods {
   static std::unique_ptr<LogicalCollection> persistCollectionInAgency(
     LogicalCollection* col, bool ignoreDistributeShardsLikeErrors,
     bool waitForSyncReplication, arangodb::velocypack::Slice parameters);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Persist collections of one database in Agency with one transaction
+////////////////////////////////////////////////////////////////////////////////
+
+  static std::vector<std::unique_ptr<LogicalCollection>>
+  persistCollectionsInAgency(
+      std::vector<LogicalCollection*> const& cols,
+      bool ignoreDistributeShardsLikeErrors, bool waitForSyncReplication,
+      std::vector<arangodb::velocypack::Slice> const& parameters);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief distribute the shards of a collection and build its definition
+////////////////////////////////////////////////////////////////////////////////
+
+  static void prepareCollectionForAgency(
+      LogicalCollection* col, bool ignoreDistributeShardsLikeErrors,
+      arangodb::velocypack::Slice parameters,
+      arangodb::velocypack::Builder& definition, uint64_t& numberOfShards,
+      uint64_t& replicationFactor);
 };
 
 }  // namespace arangodb
@@ -0,0 +1,209 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "CoordinatorDocumentCache.h"
+
+#include "Basics/system-functions.h"
+#include "Cache/Cache.h"
+#include "Cache/CacheManagerFeature.h"
+#include "Cache/CachedValue.h"
+#include "Cache/Common.h"
+#include "Cache/Finding.h"
+#include "Cache/Manager.h"
+#include "Logger/Logger.h"
+#include "Transaction/Helpers.h"
+
+#include <velocypack/Iterator.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+
+namespace {
+/// @brief prefix of each cached value, followed by the document
+struct EntryHeader {
+  double expires;
+  uint64_t epoch;
+};
+}
+
+CoordinatorDocumentCache* CoordinatorDocumentCache::_instance = nullptr;
+
+constexpr size_t CoordinatorDocumentCache::NumGenerations;
+
+CoordinatorDocumentCache::CoordinatorDocumentCache(double ttl)
+    : _ttl(ttl), _cache(nullptr), _epoch(0) {
+  for (auto& it : _generations) {
+    it.store(0);
+  }
+  auto cacheManager = CacheManagerFeature::MANAGER;
+  if (cacheManager != nullptr) {
+    _cache = cacheManager->createCache(cache::CacheType::Plain, false,
+                                       UINT64_MAX, "coordinator-documents");
+  }
+}
+
+CoordinatorDocumentCache::~CoordinatorDocumentCache() {
+  if (_cache != nullptr) {
+    auto cacheManager = CacheManagerFeature::MANAGER;
+    if (cacheManager != nullptr) {
+      cacheManager->destroyCache(_cache);
+    }
+  }
+}
+
+void CoordinatorDocumentCache::initialize(double ttl) {
+  TRI_ASSERT(_instance == nullptr);
+  if (ttl <= 0.0) {
+    return;
+  }
+  _instance = new CoordinatorDocumentCache(ttl);
+  LOG_TOPIC(INFO, Logger::CLUSTER)
+      << "caching documents read by key on this coordinator for " << ttl
+      << " s";
+}
+
+void CoordinatorDocumentCache::cleanup() {
+  delete _instance;
+  _instance = nullptr;
+}
+
+std::string CoordinatorDocumentCache::buildKey(std::string const& cid,
+                                               StringRef key) {
+  std::string result;
+  result.reserve(cid.size() + 1 + key.size());
+  result.append(cid);
+  result.push_back('/');
+  result.append(key.data(), key.size());
+  return result;
+}
+
+std::atomic<uint64_t>& CoordinatorDocumentCache::generation(
+    std::string const& cacheKey) const {
+  return _generations[std::hash<std::string>()(cacheKey) % NumGenerations];
+}
+
+CoordinatorDocumentCache::Ticket CoordinatorDocumentCache::ticket(
+    std::string const& cid, StringRef key) const {
+  Ticket result;
+  result.epoch = _epoch.load();
+  result.generation = generation(buildKey(cid, key)).load();
+  return result;
+}
+
+bool CoordinatorDocumentCache::isCurrent(std::string const& cid,
+                                         StringRef key,
+                                         Ticket const& ticket) const {
+  return ticket.epoch == _epoch.load() &&
+         ticket.generation == generation(buildKey(cid, key)).load();
+}
+
+bool CoordinatorDocumentCache::lookup(std::string const& cid, StringRef key,
+                                      VPackBuilder& result) {
+  if (_cache == nullptr) {
+    return false;
+  }
+
+  std::string const cacheKey = buildKey(cid, key);
+  auto f = _cache->find(cacheKey.data(),
+                        static_cast<uint32_t>(cacheKey.size()));
+  if (!f.found()) {
+    return false;
+  }
+
+  cache::CachedValue const* value = f.value();
+  if (value->valueSize <= sizeof(EntryHeader)) {
+    return false;
+  }
+
+  EntryHeader header;
+  memcpy(&header, value->value(), sizeof(EntryHeader));
+  if (header.epoch != _epoch.load() || header.expires < TRI_microtime()) {
+    return false;
+  }
+
+  result.add(VPackSlice(reinterpret_cast<char const*>(value->value()) +
+                        sizeof(EntryHeader)));
+  return true;
+}
+
+void CoordinatorDocumentCache::store(std::string const& cid, StringRef key,
+                                     VPackSlice document,
+                                     Ticket const& ticket) {
+  if (_cache == nullptr || !document.isObject() ||
+      !isCurrent(cid, key, ticket)) {
+    return;
+  }
+
+  EntryHeader header;
+  header.expires = TRI_microtime() + _ttl;
+  header.epoch = ticket.epoch;
+
+  std::string value;
+  value.reserve(sizeof(EntryHeader) + document.byteSize());
+  value.append(reinterpret_cast<char const*>(&header), sizeof(EntryHeader));
+  value.append(document.startAs<char>(), document.byteSize());
+
+  std::string const cacheKey = buildKey(cid, key);
+  std::unique_ptr<cache::CachedValue> entry(cache::CachedValue::construct(
+      cacheKey.data(), static_cast<uint32_t>(cacheKey.size()), value.data(),
+      static_cast<uint64_t>(value.size())));
+  if (entry != nullptr && _cache->insert(entry.get()).ok()) {
+    // the cache owns the entry now
+    entry.release();
+
+    // a write that finished between the check above and the insert may
+    // have removed the key before the entry was there
+    if (generation(cacheKey).load() != ticket.generation) {
+      invalidate(cid, key);
+    }
+  }
+}
+
+void CoordinatorDocumentCache::invalidate(std::string const& cid,
+                                          StringRef key) {
+  if (key.empty()) {
+    return;
+  }
+
+  std::string const cacheKey = buildKey(cid, key);
+  // reads that started before are not stored anymore
+  ++generation(cacheKey);
+  if (_cache == nullptr) {
+    return;
+  }
+  if (_cache->remove(cacheKey.data(), static_cast<uint32_t>(cacheKey.size()))
+          .fail()) {
+    // the entry could not be removed, e.g. because its bucket is busy.
+    // it must not be served anymore, so drop all entries instead
+    invalidateAll();
+  }
+}
+
+void CoordinatorDocumentCache::invalidate(std::string const& cid,
+                                          VPackSlice documents) {
+  if (documents.isArray()) {
+    for (auto const& it : VPackArrayIterator(documents)) {
+      invalidate(cid, transaction::helpers::extractKeyPart(it));
+    }
+  } else {
+    invalidate(cid, transaction::helpers::extractKeyPart(documents));
+  }
+}
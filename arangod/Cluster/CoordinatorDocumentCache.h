@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_CLUSTER_COORDINATOR_DOCUMENT_CACHE_H
+#define ARANGOD_CLUSTER_COORDINATOR_DOCUMENT_CACHE_H 1
+
+#include "Basics/Common.h"
+#include "Basics/StringRef.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/Slice.h>
+
+#include <atomic>
+
+namespace arangodb {
+namespace cache {
+class Cache;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief coordinator-local cache for documents read by key
+///
+/// Documents are kept under their collection id and key for a fixed time
+/// to live. Document API writes through this coordinator remove the affected
+/// keys. Writes through other coordinators, and AQL writes through any
+/// coordinator including this one, only become visible once the entry has
+/// expired. The cache is therefore disabled unless a time to live is
+/// configured.
+///
+/// A read that started before a write may return the old document after the
+/// write removed the key. Readers therefore take a ticket before they send
+/// their request, and the document is only stored if no write to the key
+/// finished in the meantime.
+////////////////////////////////////////////////////////////////////////////////
+class CoordinatorDocumentCache {
+ private:
+  explicit CoordinatorDocumentCache(double ttl);
+
+ public:
+  ~CoordinatorDocumentCache();
+
+  /// @brief returns the cache, nullptr if it is disabled
+  static CoordinatorDocumentCache* instance() { return _instance; }
+
+  /// @brief creates the cache if ttl is positive
+  static void initialize(double ttl);
+
+  /// @brief destroys the cache
+  static void cleanup();
+
+  /// @brief adds a stored copy of the document to result and returns true,
+  /// if an entry for the key exists which has not yet expired
+  bool lookup(std::string const& cid, StringRef key,
+              arangodb::velocypack::Builder& result);
+
+  /// @brief state of the cache for a key, taken before the key is read
+  struct Ticket {
+    uint64_t epoch = 0;
+    uint64_t generation = 0;
+  };
+
+  /// @brief returns the ticket for a read of the key
+  Ticket ticket(std::string const& cid, StringRef key) const;
+
+  /// @brief whether no write to the key finished since the ticket was taken
+  bool isCurrent(std::string const& cid, StringRef key,
+                 Ticket const& ticket) const;
+
+  /// @brief remembers the document as read from its shard, unless the key
+  /// was written to since the ticket was taken
+  void store(std::string const& cid, StringRef key,
+             arangodb::velocypack::Slice document, Ticket const& ticket);
+
+  /// @brief removes the entry for the key
+  void invalidate(std::string const& cid, StringRef key);
+
+  /// @brief removes the entries for all keys in documents, which is a
+  /// single document, key or document handle, or an array of them
+  void invalidate(std::string const& cid,
+                  arangodb::velocypack::Slice documents);
+
+  /// @brief makes all existing entries invalid, e.g. after a truncate
+  void invalidateAll() { ++_epoch; }
+
+ private:
+  static std::string buildKey(std::string const& cid, StringRef key);
+
+  /// @brief write generation of the slot the key belongs to
+  std::atomic<uint64_t>& generation(std::string const& cacheKey) const;
+
+ private:
+  static CoordinatorDocumentCache* _instance;
+
+  double const _ttl;
+  std::shared_ptr<cache::Cache> _cache;
+
+  /// @brief entries stored under an older epoch are ignored
+  std::atomic<uint64_t> _epoch;
+
+  /// @brief number of write generations, keys share them by hash
+  static constexpr size_t NumGenerations = 1024;
+
+  /// @brief increased by each write before its keys are removed
+  mutable std::atomic<uint64_t> _generations[NumGenerations];
+};
+}
+
+#endif
@@ -26,6 +26,7 @@
 #include "Basics/MutexLocker.h"
 #include "Cluster/ClusterInfo.h"
 #include "Cluster/HeartbeatThread.h"
+#include "Cluster/ServerState.h"
 #include "Logger/Logger.h"
 #include "RestServer/DatabaseFeature.h"
 #include "V8/v8-conv.h"
@@ -35,10 +36,30 @@
 #include "V8Server/V8DealerFeature.h"
 #include "VocBase/vocbase.h"
 
+#include <velocypack/Iterator.h>
+#include <velocypack/velocypack-aliases.h>
+
 using namespace arangodb;
 using namespace arangodb::application_features;
 using namespace arangodb::rest;
 
+/// @brief handlePlanChange is run at least this often, even if nothing
+/// concerning this server has changed, so that failed actions are retried
+static double const FullSyncInterval = 30.0;
+
+/// @brief whether a shard is planned on the server
+static bool IsPlannedOn(VPackSlice servers, std::string const& serverId) {
+  if (!servers.isArray()) {
+    return false;
+  }
+  for (auto const& server : VPackArrayIterator(servers)) {
+    if (server.isString() && server.copyString() == serverId) {
+      return true;
+    }
+  }
+  return false;
+}
+
 DBServerAgencySync::DBServerAgencySync(HeartbeatThread* heartbeat)
     : _heartbeat(heartbeat) {}
 
@@ -51,6 +72,84 @@ void DBServerAgencySync::work() {
   _heartbeat->dispatchedJobResult(result);
 }
 
+void DBServerAgencySync::fingerprints(
+    VPackSlice plan, VPackSlice current, std::string const& serverId,
+    std::unordered_map<std::string, uint64_t>& result) {
+  result.clear();
+  if (!plan.isObject()) {
+    return;
+  }
+
+  VPackSlice planDatabases = plan.get("Databases");
+  if (planDatabases.isObject()) {
+    for (auto const& database : VPackObjectIterator(planDatabases)) {
+      result[database.key.copyString()] = database.value.hash();
+    }
+  }
+
+  VPackSlice currentCollections = VPackSlice::noneSlice();
+  VPackSlice currentDatabases = VPackSlice::noneSlice();
+  if (current.isObject()) {
+    currentCollections = current.get("Collections");
+    currentDatabases = current.get("Databases");
+  }
+
+  VPackSlice planCollections = plan.get("Collections");
+  if (planCollections.isObject()) {
+    for (auto const& database : VPackObjectIterator(planCollections)) {
+      std::string const name = database.key.copyString();
+      uint64_t& hash = result[name];
+      if (!database.value.isObject()) {
+        continue;
+      }
+
+      VPackSlice currentDatabase = VPackSlice::noneSlice();
+      if (currentCollections.isObject()) {
+        currentDatabase = currentCollections.get(name);
+      }
+
+      for (auto const& collection : VPackObjectIterator(database.value)) {
+        VPackSlice shards = collection.value.get("shards");
+        if (!shards.isObject()) {
+          continue;
+        }
+        bool planned = false;
+        for (auto const& shard : VPackObjectIterator(shards)) {
+          if (!IsPlannedOn(shard.value, serverId)) {
+            continue;
+          }
+          if (!planned) {
+            // the whole definition, so that changed properties and indexes
+            // are noticed
+            planned = true;
+            hash = collection.key.hash(hash);
+            hash = collection.value.hash(hash);
+          }
+          hash = shard.key.hash(hash);
+          if (currentDatabase.isObject()) {
+            VPackSlice currentShard = currentDatabase.get(
+                std::vector<std::string>(
+                    {collection.key.copyString(), shard.key.copyString()}));
+            if (!currentShard.isNone()) {
+              hash = currentShard.hash(hash);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (currentDatabases.isObject()) {
+    for (auto& it : result) {
+      VPackSlice report = currentDatabases.get(
+          std::vector<std::string>({it.first, serverId}));
+      if (!report.isNone()) {
+        it.second = report.hash(it.second);
+      }
+    }
+  }
+}
+
 DBServerAgencySyncResult DBServerAgencySync::execute() {
   // default to system database
 
@@ -72,6 +171,49 @@ DBServerAgencySyncResult DBServerAgencySync::execute() {
   auto clusterInfo = ClusterInfo::instance();
   auto plan = clusterInfo->getPlan();
   auto current = clusterInfo->getCurrent();
+
+  // the diff of the Plan against the local state in handlePlanChange is
+  // expensive with many shards. it is skipped if nothing concerning this
+  // server has changed since the last successful run
+  DBServerAgencySyncState& state = _heartbeat->agencySyncState();
+  std::unordered_map<std::string, uint64_t> newFingerprints;
+  fingerprints(plan->slice(), current->slice(),
+               ServerState::instance()->getId(), newFingerprints);
+
+  size_t changed = 0;
+  for (auto const& it : newFingerprints) {
+    auto old = state.fingerprints.find(it.first);
+    if (old == state.fingerprints.end() || (*old).second != it.second) {
+      ++changed;
+    }
+  }
+  for (auto const& it : state.fingerprints) {
+    if (newFingerprints.find(it.first) == newFingerprints.end()) {
+      // dropped database
+      ++changed;
+    }
+  }
+
+  if (state.valid && changed == 0 &&
+      startTime < state.lastFullSync + FullSyncInterval &&
+      plan->slice().isObject() && plan->slice().get("Version").isNumber() &&
+      current->slice().isObject() &&
+      current->slice().get("Version").isNumber()) {
+    LOG_TOPIC(DEBUG, Logger::HEARTBEAT)
+      << "DBServerAgencySync::execute nothing changed for this server";
+    result.success = true;
+    result.planVersion = plan->slice().get("Version").getNumber<uint64_t>();
+    result.currentVersion =
+      current->slice().get("Version").getNumber<uint64_t>();
+    return result;
+  }
+
+  LOG_TOPIC(DEBUG, Logger::HEARTBEAT)
+    << "DBServerAgencySync::execute " << changed << " of "
+    << newFingerprints.size() << " database(s) changed for this server";
+
+  // only reused after a successful run
+  state.valid = false;
   
   VocbaseGuard guard(vocbase);
 
@@ -153,7 +295,7 @@ DBServerAgencySyncResult DBServerAgencySync::execute() {
             result.currentVersion =
               static_cast<uint64_t>(value->ToUint32()->Value());
           }
-        } else if (value->IsBoolean() && strcmp(*str, "success")) {
+        } else if (value->IsBoolean() && strcmp(*str, "success") == 0) {
           result.success = TRI_ObjectToBoolean(value);
         }
       }
@@ -164,6 +306,11 @@ DBServerAgencySyncResult DBServerAgencySync::execute() {
     }
     LOG_TOPIC(DEBUG, Logger::HEARTBEAT)
       << "DBServerAgencySync::execute back from JS";
+    if (result.success) {
+      state.fingerprints = std::move(newFingerprints);
+      state.lastFullSync = startTime;
+      state.valid = true;
+    }
     // invalidate our local cache, even if an error occurred
     clusterInfo->flush();
   } catch (...) {
@@ -29,6 +29,10 @@
 namespace arangodb {
 class HeartbeatThread;
 
+namespace velocypack {
+class Slice;
+}
+
 struct DBServerAgencySyncResult {
   bool success;
   uint64_t planVersion;
@@ -43,6 +47,20 @@ struct DBServerAgencySyncResult {
         currentVersion(other.currentVersion) {}
 };
 
+/// @brief what the last successful sync has seen. kept by the heartbeat
+/// thread, and only used by its background job, which runs at most once at
+/// a time
+struct DBServerAgencySyncState {
+  DBServerAgencySyncState() : valid(false), lastFullSync(0.0) {}
+
+  bool valid;
+  /// @brief time handlePlanChange was last run
+  double lastFullSync;
+  /// @brief fingerprint of the Plan and Current of each database, as far
+  /// as they concern this server
+  std::unordered_map<std::string, uint64_t> fingerprints;
+};
+
 class DBServerAgencySync {
   DBServerAgencySync(DBServerAgencySync const&) = delete;
   DBServerAgencySync& operator=(DBServerAgencySync const&) = delete;
@@ -53,6 +71,15 @@ class DBServerAgencySync {
  public:
   void work();
 
+  /// @brief computes a fingerprint of the Plan and Current of each database,
+  /// as far as they concern the given server: the planned database, the
+  /// definitions of the collections with a shard on the server, the Current
+  /// entries of these shards, and the server's report for the database
+  static void fingerprints(arangodb::velocypack::Slice plan,
+                           arangodb::velocypack::Slice current,
+                           std::string const& serverId,
+                           std::unordered_map<std::string, uint64_t>& result);
+
  private:
   DBServerAgencySyncResult execute();
 
@@ -560,6 +560,10 @@ void HeartbeatThread::runCoordinator() {
 
             ClusterInfo::instance()->invalidateCurrent();
             invalidateCoordinators = false;
+          } else {
+            // the agency was read after start, so our view of Current was
+            // still up to date at that time
+            ClusterInfo::instance()->confirmCurrent(currentVersion, start);
           }
         }
 
@@ -78,6 +78,12 @@ class HeartbeatThread : public Thread,
 
   void dispatchedJobResult(DBServerAgencySyncResult);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief state of the last sync, only used by the background job
+  //////////////////////////////////////////////////////////////////////////////
+
+  DBServerAgencySyncState& agencySyncState() { return _agencySyncState; }
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief whether or not the thread has run at least once.
   /// this is used on the coordinator only
@@ -258,6 +264,12 @@ class HeartbeatThread : public Thread,
 
   // when was the javascript sync routine last run?
   double _lastSyncTime;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief state of the last sync, only used by the background job
+  //////////////////////////////////////////////////////////////////////////////
+
+  DBServerAgencySyncState _agencySyncState;
 };
 }
 
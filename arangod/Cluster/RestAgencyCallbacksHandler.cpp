@@ -27,6 +27,9 @@
 #include "Rest/HttpRequest.h"
 #include "Rest/HttpResponse.h"
 
+#include <velocypack/Iterator.h>
+#include <velocypack/velocypack-aliases.h>
+
 using namespace arangodb;
 using namespace arangodb::rest;
 
@@ -42,7 +45,7 @@ bool RestAgencyCallbacksHandler::isDirect() const { return false; }
 RestStatus RestAgencyCallbacksHandler::execute() {
   std::vector<std::string> const& suffixes = _request->decodedSuffixes();
 
-  if (suffixes.size() != 1) {
+  if (suffixes.size() > 1) {
     generateError(rest::ResponseCode::BAD, TRI_ERROR_HTTP_BAD_PARAMETER,
                   "invalid callback");
     return RestStatus::DONE;
@@ -65,8 +68,32 @@ RestStatus RestAgencyCallbacksHandler::execute() {
     return RestStatus::DONE;
   }
 
+  if (suffixes.empty()) {
+    // the agency coalesces notifications of all callbacks on this server
+    VPackSlice callbacks = parsedBody->slice().get("callbacks");
+    if (!callbacks.isObject()) {
+      generateError(rest::ResponseCode::BAD, TRI_ERROR_HTTP_BAD_PARAMETER,
+                    "invalid callback");
+      return RestStatus::DONE;
+    }
+    for (auto const& cb : VPackObjectIterator(callbacks)) {
+      triggerCallback(cb.key.copyString());
+    }
+    resetResponse(arangodb::rest::ResponseCode::ACCEPTED);
+    return RestStatus::DONE;
+  }
+
+  if (triggerCallback(suffixes.at(0))) {
+    resetResponse(arangodb::rest::ResponseCode::ACCEPTED);
+  } else {
+    resetResponse(arangodb::rest::ResponseCode::NOT_FOUND);
+  }
+  return RestStatus::DONE;
+}
+
+bool RestAgencyCallbacksHandler::triggerCallback(std::string const& id) {
   try {
-    std::stringstream ss(suffixes.at(0));
+    std::stringstream ss(id);
     uint32_t index;
     ss >> index;
 
@@ -74,10 +101,9 @@ RestStatus RestAgencyCallbacksHandler::execute() {
     LOG_TOPIC(DEBUG, Logger::CLUSTER)
       << "Agency callback has been triggered. refetching!";
     callback->refetchAndUpdate(true);
-    resetResponse(arangodb::rest::ResponseCode::ACCEPTED);
+    return true;
   } catch (arangodb::basics::Exception const&) {
     // mop: not found...expected
-    resetResponse(arangodb::rest::ResponseCode::NOT_FOUND);
+    return false;
   }
-  return RestStatus::DONE;
 }
@@ -45,9 +45,13 @@ class RestAgencyCallbacksHandler : public RestVocbaseBaseHandler {
  public:
   char const* name() const override final { return "RestAgencyCallbacksHandler"; }
   bool isDirect() const override;
+  size_t queue() const override { return JobQueue::CLUSTER_QUEUE; }
   RestStatus execute() override;
 
  private:
+  /// @brief refetch and update callback with given id, false if unknown
+  bool triggerCallback(std::string const& id);
+
   AgencyCallbackRegistry* _agencyCallbackRegistry;
 };
 }
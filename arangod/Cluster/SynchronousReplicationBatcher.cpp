@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "SynchronousReplicationBatcher.h"
+
+#include "ApplicationFeatures/ApplicationServer.h"
+#include "Basics/ConditionLocker.h"
+#include "Basics/Exceptions.h"
+#include "Basics/StaticStrings.h"
+#include "Cluster/ClusterComm.h"
+#include "Cluster/ClusterFeature.h"
+#include "Cluster/FollowerInfo.h"
+#include "Logger/Logger.h"
+#include "VocBase/LogicalCollection.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/Iterator.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+
+SynchronousReplicationBatcher* SynchronousReplicationBatcher::instance() {
+  static SynchronousReplicationBatcher batcher;
+  return &batcher;
+}
+
+Result SynchronousReplicationBatcher::replicate(
+    LogicalCollection* collection, rest::RequestType type,
+    std::string const& path, VPackSlice docs, size_t count,
+    std::shared_ptr<std::vector<ServerID> const> const& followers,
+    double timeout) {
+  TRI_ASSERT(docs.isArray());
+
+  // operations can only share a request if they go to the same followers
+  std::string key = std::to_string(static_cast<int>(type)) + path;
+  for (auto const& f : *followers) {
+    key.push_back(',');
+    key.append(f);
+  }
+
+  size_t const maxDocuments = batchSize();
+  Operation self{docs, count, timeout, Result(), false};
+
+  CONDITION_LOCKER(guard, _condition);
+  _queues[key].pending.push_back(&self);
+
+  while (!self.done) {
+    Queue& queue = _queues[key];
+    if (queue.active) {
+      guard.wait();
+      continue;
+    }
+
+    // nobody is sending for this shard right now, so send everything which
+    // has queued up so far
+    queue.active = true;
+    std::vector<Operation*> batch;
+    size_t documents = 0;
+    while (!queue.pending.empty() &&
+           (batch.empty() ||
+            documents + queue.pending.front()->count <= maxDocuments)) {
+      documents += queue.pending.front()->count;
+      batch.emplace_back(queue.pending.front());
+      queue.pending.pop_front();
+    }
+
+    guard.unlock();
+    Result res = send(collection, type, path, batch, followers);
+    guard.lock();
+
+    for (auto* op : batch) {
+      op->result = res;
+      op->done = true;
+    }
+    Queue& current = _queues[key];
+    current.active = false;
+    if (current.pending.empty()) {
+      _queues.erase(key);
+    }
+    guard.broadcast();
+  }
+
+  if (self.result.is(TRI_ERROR_CLUSTER_COULD_NOT_DROP_FOLLOWER)) {
+    THROW_ARANGO_EXCEPTION(self.result);
+  }
+  return self.result;
+}
+
+Result SynchronousReplicationBatcher::send(
+    LogicalCollection* collection, rest::RequestType type,
+    std::string const& path, std::vector<Operation*> const& batch,
+    std::shared_ptr<std::vector<ServerID> const> const& followers) {
+  auto cc = arangodb::ClusterComm::instance();
+  if (cc == nullptr) {
+    // nullptr only happens on controlled shutdown
+    return Result();
+  }
+
+  try {
+    auto body = std::make_shared<std::string>();
+    double timeout = 0.0;
+    if (batch.size() == 1) {
+      *body = batch[0]->docs.toJson();
+      timeout = batch[0]->timeout;
+    } else {
+      VPackBuilder payload;
+      payload.openArray();
+      for (auto const* op : batch) {
+        for (auto const& doc : VPackArrayIterator(op->docs)) {
+          payload.add(doc);
+        }
+        timeout = (std::max)(timeout, op->timeout);
+      }
+      payload.close();
+      *body = payload.slice().toJson();
+    }
+
+    std::vector<ClusterCommRequest> requests;
+    for (auto const& f : *followers) {
+      requests.emplace_back("server:" + f, type, path, body);
+    }
+
+    size_t nrDone = 0;
+    size_t nrGood = cc->performRequests(requests, timeout, nrDone,
+                                        Logger::REPLICATION, false);
+    if (nrGood == followers->size()) {
+      return Result();
+    }
+
+    // If any would-be-follower refused to follow there must be a
+    // new leader in the meantime, in this case we must not allow
+    // this operation to succeed, we simply return with a refusal
+    // error (note that we use the follower version, since we have
+    // lost leadership):
+    for (auto const& request : requests) {
+      if (request.done && request.result.status == CL_COMM_RECEIVED &&
+          request.result.answer_code == rest::ResponseCode::NOT_ACCEPTABLE) {
+        return Result(TRI_ERROR_CLUSTER_SHARD_LEADER_RESIGNED);
+      }
+    }
+
+    // Otherwise we drop all followers that were not successful:
+    for (size_t i = 0; i < followers->size(); ++i) {
+      bool replicationWorked =
+          requests[i].done &&
+          requests[i].result.status == CL_COMM_RECEIVED &&
+          (requests[i].result.answer_code == rest::ResponseCode::ACCEPTED ||
+           requests[i].result.answer_code == rest::ResponseCode::CREATED ||
+           requests[i].result.answer_code == rest::ResponseCode::OK);
+      if (replicationWorked) {
+        bool found;
+        requests[i].result.answer->header(StaticStrings::ErrorCodes, found);
+        replicationWorked = !found;
+      }
+      if (!replicationWorked) {
+        auto const& followerInfo = collection->followers();
+        if (followerInfo->remove((*followers)[i])) {
+          LOG_TOPIC(WARN, Logger::REPLICATION)
+              << "synchronous replication: dropping follower "
+              << (*followers)[i] << " for shard " << collection->name();
+        } else {
+          LOG_TOPIC(ERR, Logger::REPLICATION)
+              << "synchronous replication: could not drop follower "
+              << (*followers)[i] << " for shard " << collection->name();
+          return Result(TRI_ERROR_CLUSTER_COULD_NOT_DROP_FOLLOWER);
+        }
+      }
+    }
+  } catch (basics::Exception const& ex) {
+    return Result(ex.code(), ex.what());
+  } catch (std::exception const& ex) {
+    return Result(TRI_ERROR_INTERNAL, ex.what());
+  }
+
+  return Result();
+}
+
+size_t SynchronousReplicationBatcher::batchSize() {
+  // Multithreading is no problem here because the value is only ever set
+  // once in the lifetime of the server.
+  static size_t size = 0;
+  if (size == 0) {
+    auto feature =
+        application_features::ApplicationServer::getFeature<ClusterFeature>(
+            "Cluster");
+    size = (std::max)(static_cast<size_t>(feature->syncReplBatchSize()),
+                      static_cast<size_t>(1));
+  }
+  return size;
+}
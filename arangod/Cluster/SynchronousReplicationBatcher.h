@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_CLUSTER_SYNCHRONOUS_REPLICATION_BATCHER_H
+#define ARANGOD_CLUSTER_SYNCHRONOUS_REPLICATION_BATCHER_H 1
+
+#include "Basics/Common.h"
+#include "Basics/ConditionVariable.h"
+#include "Basics/Result.h"
+#include "Cluster/ClusterInfo.h"
+#include "Rest/CommonDefines.h"
+
+#include <velocypack/Slice.h>
+
+#include <deque>
+#include <unordered_map>
+
+namespace arangodb {
+class LogicalCollection;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief coalesces concurrent synchronous replication requests
+///
+/// Operations on the same shard and of the same type, which wait for their
+/// replication at the same time, are sent to the followers as a single
+/// request. The first waiting thread sends a batch while later ones queue up
+/// behind it; once the batch is confirmed the next waiting thread sends all
+/// operations which have queued up in the meantime. Batches preserve the
+/// order in which operations arrived. Operations within a batch never touch
+/// the same document, since the leader keeps its document locks until the
+/// replication has been confirmed.
+////////////////////////////////////////////////////////////////////////////////
+class SynchronousReplicationBatcher {
+ public:
+  static SynchronousReplicationBatcher* instance();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief replicates the documents in the array docs to all followers,
+  /// blocks until the batch containing them is confirmed. Followers which
+  /// did not apply the batch are dropped. Returns
+  /// TRI_ERROR_CLUSTER_SHARD_LEADER_RESIGNED if a follower refused to follow,
+  /// throws if a follower could not be dropped.
+  //////////////////////////////////////////////////////////////////////////////
+  Result replicate(LogicalCollection* collection, rest::RequestType type,
+                   std::string const& path, VPackSlice docs, size_t count,
+                   std::shared_ptr<std::vector<ServerID> const> const& followers,
+                   double timeout);
+
+ private:
+  struct Operation {
+    VPackSlice docs;
+    size_t count;
+    double timeout;
+    Result result;
+    bool done;
+  };
+
+  struct Queue {
+    Queue() : active(false), pending() {}
+    bool active;
+    std::deque<Operation*> pending;
+  };
+
+  // sends one batch, called without holding _condition
+  Result send(LogicalCollection* collection, rest::RequestType type,
+              std::string const& path, std::vector<Operation*> const& batch,
+              std::shared_ptr<std::vector<ServerID> const> const& followers);
+
+  size_t batchSize();
+
+ private:
+  basics::ConditionVariable _condition;
+  std::unordered_map<std::string, Queue> _queues;
+};
+}
+
+#endif
@@ -233,7 +233,7 @@ void BaseTraverserEngine::getEdges(VPackSlice vertex, size_t depth,
 
       edgeCursor->readAll(
           [&](std::unique_ptr<EdgeDocumentToken>&& eid, VPackSlice edge, size_t cursorId) {
-            if (edge.isString()) {
+            if (edge.isString() || BaseOptions::isPartialEdge(edge)) {
               edge = _opts->cache()->lookupToken(eid.get());
             }
             if (_opts->evaluateEdgeExpression(edge, StringRef(v), depth,
@@ -248,7 +248,7 @@ void BaseTraverserEngine::getEdges(VPackSlice vertex, size_t depth,
         _opts->nextCursor(&mmdr, StringRef(vertex), depth));
     edgeCursor->readAll(
         [&](std::unique_ptr<EdgeDocumentToken>&& eid, VPackSlice edge, size_t cursorId) {
-          if (edge.isString()) {
+          if (edge.isString() || BaseOptions::isPartialEdge(edge)) {
             edge = _opts->cache()->lookupToken(eid.get());
           }
           if (_opts->evaluateEdgeExpression(edge, StringRef(vertex), depth,
@@ -268,6 +268,44 @@ void BaseTraverserEngine::getEdges(VPackSlice vertex, size_t depth,
   builder.close();
 }
 
+void BaseTraverserEngine::getEdgesGrouped(VPackSlice vertices, size_t depth,
+                                          VPackBuilder& builder) {
+  // We just hope someone has locked the shards properly. We have no clue...
+  // Thanks locking
+  if (!vertices.isArray()) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_BAD_PARAMETER);
+  }
+  ManagedDocumentResult mmdr;
+  builder.openObject();
+  builder.add(VPackValue("edges"));
+  builder.openArray();
+  for (VPackSlice v : VPackArrayIterator(vertices)) {
+    TRI_ASSERT(v.isString());
+    StringRef vertexId(v);
+    std::unique_ptr<arangodb::graph::EdgeCursor> edgeCursor(
+        _opts->nextCursor(&mmdr, vertexId, depth));
+
+    builder.openArray();
+    edgeCursor->readAll(
+        [&](std::unique_ptr<EdgeDocumentToken>&& eid, VPackSlice edge, size_t cursorId) {
+          if (edge.isString() || BaseOptions::isPartialEdge(edge)) {
+            edge = _opts->cache()->lookupToken(eid.get());
+          }
+          if (_opts->evaluateEdgeExpression(edge, vertexId, depth,
+                                            cursorId)) {
+            builder.add(edge);
+          }
+        });
+    builder.close();
+  }
+  builder.close();
+  builder.add("readIndex",
+              VPackValue(_opts->cache()->getAndResetInsertedDocuments()));
+  builder.add("filtered",
+              VPackValue(_opts->cache()->getAndResetFilteredDocuments()));
+  builder.close();
+}
+
 void BaseTraverserEngine::getVertexData(VPackSlice vertex, size_t depth,
                                         VPackBuilder& builder) {
   // We just hope someone has locked the shards properly. We have no clue...
@@ -382,7 +420,7 @@ void ShortestPathEngine::getEdges(VPackSlice vertex, bool backward,
 
       edgeCursor->readAll([&](std::unique_ptr<EdgeDocumentToken>&& eid, VPackSlice edge,
                               size_t cursorId) {
-        if (edge.isString()) {
+        if (edge.isString() || BaseOptions::isPartialEdge(edge)) {
           edge = _opts->cache()->lookupToken(eid.get());
         }
         builder.add(edge);
@@ -398,7 +436,7 @@ void ShortestPathEngine::getEdges(VPackSlice vertex, bool backward,
     }
     edgeCursor->readAll([&](std::unique_ptr<EdgeDocumentToken>&& eid, VPackSlice edge,
                             size_t cursorId) {
-      if (edge.isString()) {
+      if (edge.isString() || BaseOptions::isPartialEdge(edge)) {
         edge = _opts->cache()->lookupToken(eid.get());
       }
       builder.add(edge);
@@ -414,6 +452,46 @@ void ShortestPathEngine::getEdges(VPackSlice vertex, bool backward,
   builder.close();
 }
 
+void ShortestPathEngine::getEdgesGrouped(VPackSlice vertices, bool backward,
+                                         VPackBuilder& builder) {
+  // We just hope someone has locked the shards properly. We have no clue...
+  // Thanks locking
+  if (!vertices.isArray()) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_BAD_PARAMETER);
+  }
+
+  std::unique_ptr<arangodb::graph::EdgeCursor> edgeCursor;
+
+  ManagedDocumentResult mmdr;
+  builder.openObject();
+  builder.add(VPackValue("edges"));
+  builder.openArray();
+  for (VPackSlice v : VPackArrayIterator(vertices)) {
+    TRI_ASSERT(v.isString());
+    StringRef vertexId(v);
+    if (backward) {
+      edgeCursor.reset(_opts->nextReverseCursor(&mmdr, vertexId));
+    } else {
+      edgeCursor.reset(_opts->nextCursor(&mmdr, vertexId));
+    }
+
+    builder.openArray();
+    edgeCursor->readAll([&](std::unique_ptr<EdgeDocumentToken>&& eid, VPackSlice edge,
+                            size_t cursorId) {
+      if (edge.isString() || BaseOptions::isPartialEdge(edge)) {
+        edge = _opts->cache()->lookupToken(eid.get());
+      }
+      builder.add(edge);
+    });
+    builder.close();
+  }
+  builder.close();
+  builder.add("readIndex",
+              VPackValue(_opts->cache()->getAndResetInsertedDocuments()));
+  builder.add("filtered", VPackValue(0));
+  builder.close();
+}
+
 TraverserEngine::TraverserEngine(TRI_vocbase_t* vocbase,
                                  arangodb::velocypack::Slice info)
     : BaseTraverserEngine(vocbase, info) {
@@ -440,7 +518,8 @@ TraverserEngine::TraverserEngine(TRI_vocbase_t* vocbase,
     THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
   }
   // We create the cache, but we do not need any engines.
-  _opts->activateCache(false, nullptr);
+  // Vertex documents are shared with the other traversals on this server.
+  _opts->activateCache(true, nullptr);
 }
 
 TraverserEngine::~TraverserEngine() {}
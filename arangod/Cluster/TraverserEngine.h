@@ -112,6 +112,11 @@ class BaseTraverserEngine : public BaseEngine {
   void getEdges(arangodb::velocypack::Slice, size_t,
                 arangodb::velocypack::Builder&);
 
+  // like getEdges, but the edges of each of the given vertices are
+  // returned in a separate array, in the order of the vertices
+  void getEdgesGrouped(arangodb::velocypack::Slice, size_t,
+                       arangodb::velocypack::Builder&);
+
   void getVertexData(arangodb::velocypack::Slice, size_t,
                      arangodb::velocypack::Builder&);
 
@@ -144,6 +149,12 @@ class ShortestPathEngine : public BaseEngine {
                 bool backward,
                 arangodb::velocypack::Builder&);
 
+  // like getEdges, but the edges of each of the given vertices are
+  // returned in a separate array, in the order of the vertices
+  void getEdgesGrouped(arangodb::velocypack::Slice,
+                       bool backward,
+                       arangodb::velocypack::Builder&);
+
   EngineType getType() const override { return SHORTESTPATH; }
 
  protected:
@@ -0,0 +1,743 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "VstCommunicator.h"
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/write.hpp>
+
+#include <array>
+#include <deque>
+#include <map>
+
+#include <velocypack/Builder.h>
+#include <velocypack/Iterator.h>
+#include <velocypack/Parser.h>
+#include <velocypack/Validator.h>
+#include <velocypack/velocypack-aliases.h>
+
+#include "Basics/MutexLocker.h"
+#include "Basics/StaticStrings.h"
+#include "Basics/StringUtils.h"
+#include "GeneralServer/VstNetwork.h"
+#include "Logger/Logger.h"
+#include "Meta/conversion.h"
+#include "Rest/HttpResponse.h"
+
+using namespace arangodb;
+using namespace arangodb::basics;
+
+namespace {
+
+/// @brief tickets of this transport live in their own range, so they never
+/// collide with the ones handed out by the curl-based communicator
+std::atomic<uint64_t> NEXT_VST_TICKET_ID(static_cast<uint64_t>(1) << 62);
+
+/// @brief VST/1.1 sends the total message length in every chunk
+size_t const chunkHeaderSize = chunkHeaderLength(true);
+
+template <typename T>
+T readLittleEndian(char const* p) {
+  T value = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    value |= static_cast<T>(static_cast<uint8_t>(p[i])) << (8 * i);
+  }
+  return value;
+}
+
+boost::posix_time::microseconds toDuration(double seconds) {
+  return boost::posix_time::microseconds(
+      static_cast<int64_t>(seconds * 1000000.0));
+}
+
+/// @brief split "/_db/<name>/path?query" into the fields of a VST request
+/// header. repeated "name[]" parameters are turned into arrays
+void splitPath(std::string const& path, std::string& database,
+               std::string& requestPath, VPackBuilder& parameters) {
+  std::string::size_type query = path.find('?');
+  requestPath = path.substr(0, query);
+  database = StaticStrings::SystemDatabase;
+
+  if (requestPath.compare(0, 5, "/_db/") == 0) {
+    std::string::size_type slash = requestPath.find('/', 5);
+    if (slash == std::string::npos) {
+      database = StringUtils::urlDecode(requestPath.substr(5));
+      requestPath = "/";
+    } else {
+      database = StringUtils::urlDecode(requestPath.substr(5, slash - 5));
+      requestPath = requestPath.substr(slash);
+    }
+  }
+
+  std::map<std::string, std::vector<std::string>> arrays;
+  parameters.openObject();
+  while (query != std::string::npos) {
+    std::string::size_type next = path.find('&', query + 1);
+    std::string part = path.substr(
+        query + 1, next == std::string::npos ? next : next - query - 1);
+    query = next;
+
+    if (part.empty()) {
+      continue;
+    }
+    std::string::size_type eq = part.find('=');
+    std::string key = StringUtils::urlDecode(part.substr(0, eq));
+    std::string value = (eq == std::string::npos)
+                            ? ""
+                            : StringUtils::urlDecode(part.substr(eq + 1));
+
+    if (key.size() > 2 && key.compare(key.size() - 2, 2, "[]") == 0) {
+      arrays[key.substr(0, key.size() - 2)].emplace_back(std::move(value));
+    } else {
+      parameters.add(key, VPackValue(value));
+    }
+  }
+  for (auto const& it : arrays) {
+    parameters.add(VPackValue(it.first));
+    parameters.openArray();
+    for (auto const& value : it.second) {
+      parameters.add(VPackValue(value));
+    }
+    parameters.close();
+  }
+  parameters.close();
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a request in flight, the ticket doubles as VST message id
+////////////////////////////////////////////////////////////////////////////////
+
+struct VstCommunicator::Request {
+  communicator::Ticket ticketId = 0;
+  std::vector<std::unique_ptr<StringBuffer>> chunks;
+  communicator::Callbacks callbacks;
+  communicator::Options options;
+  std::unique_ptr<boost::asio::deadline_timer> timer;
+  std::weak_ptr<Connection> connection;
+  bool done = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a single persistent VST connection, only used on the I/O thread
+////////////////////////////////////////////////////////////////////////////////
+
+class VstCommunicator::Connection
+    : public std::enable_shared_from_this<Connection> {
+ public:
+  Connection(VstCommunicator* communicator, std::string const& host,
+             std::string const& port)
+      : _communicator(communicator),
+        _host(host),
+        _port(port),
+        _state(State::DISCONNECTED),
+        _resolver(communicator->_ioService),
+        _socket(communicator->_ioService),
+        _connectTimer(communicator->_ioService),
+        _writing(false),
+        _authMessageId(0) {}
+
+  bool isBroken() const { return _state == State::BROKEN; }
+
+  size_t load() const { return _waiting.size() + _inFlight.size(); }
+
+  void send(std::shared_ptr<Request> const& request) {
+    request->connection = shared_from_this();
+
+    if (_state == State::CONNECTED) {
+      transmit(request);
+      return;
+    }
+
+    _waiting.push_back(request);
+    if (_state == State::DISCONNECTED) {
+      connect(request->options.connectionTimeout > 0.0
+                  ? request->options.connectionTimeout
+                  : request->options.requestTimeout);
+    }
+  }
+
+  void forget(communicator::Ticket ticketId) {
+    _inFlight.erase(ticketId);
+    _waiting.erase(
+        std::remove_if(_waiting.begin(), _waiting.end(),
+                       [ticketId](std::shared_ptr<Request> const& request) {
+                         return request->ticketId == ticketId;
+                       }),
+        _waiting.end());
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief close the connection. requests that never left fail with "could
+  /// not connect", everything already sent fails with the given error
+  //////////////////////////////////////////////////////////////////////////////
+
+  void shutdown(int inFlightError) {
+    if (_state == State::BROKEN) {
+      return;
+    }
+    _state = State::BROKEN;
+
+    boost::system::error_code ec;
+    _connectTimer.cancel(ec);
+    _resolver.cancel();
+    _socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+    _socket.close(ec);
+
+    auto waiting = std::move(_waiting);
+    auto inFlight = std::move(_inFlight);
+    _waiting.clear();
+    _inFlight.clear();
+    _partials.clear();
+
+    for (auto& request : waiting) {
+      _communicator->complete(request, TRI_SIMPLE_CLIENT_COULD_NOT_CONNECT,
+                              nullptr);
+    }
+    for (auto& it : inFlight) {
+      _communicator->complete(it.second, inFlightError, nullptr);
+    }
+  }
+
+ private:
+  enum class State { DISCONNECTED, CONNECTING, CONNECTED, BROKEN };
+
+  struct Partial {
+    uint32_t expected;
+    uint32_t received;
+    std::string data;
+  };
+
+  void connect(double timeout) {
+    _state = State::CONNECTING;
+    auto self = shared_from_this();
+
+    _connectTimer.expires_from_now(toDuration(timeout));
+    _connectTimer.async_wait([self](boost::system::error_code const& ec) {
+      if (!ec && self->_state == State::CONNECTING) {
+        self->shutdown(TRI_SIMPLE_CLIENT_COULD_NOT_CONNECT);
+      }
+    });
+
+    boost::asio::ip::tcp::resolver::query query(_host, _port);
+    _resolver.async_resolve(
+        query, [self](boost::system::error_code const& ec,
+                      boost::asio::ip::tcp::resolver::iterator it) {
+          if (self->_state != State::CONNECTING) {
+            return;
+          }
+          if (ec) {
+            self->shutdown(TRI_SIMPLE_CLIENT_COULD_NOT_CONNECT);
+            return;
+          }
+          boost::asio::async_connect(
+              self->_socket, it,
+              [self](boost::system::error_code const& ec,
+                     boost::asio::ip::tcp::resolver::iterator) {
+                self->onConnected(ec);
+              });
+        });
+  }
+
+  void onConnected(boost::system::error_code const& ec) {
+    if (_state != State::CONNECTING) {
+      return;
+    }
+    if (ec) {
+      LOG_TOPIC(DEBUG, Logger::COMMUNICATION)
+          << "cannot connect to '" << _host << ":" << _port
+          << "' via VST: " << ec.message();
+      shutdown(TRI_SIMPLE_CLIENT_COULD_NOT_CONNECT);
+      return;
+    }
+
+    boost::system::error_code ignored;
+    _connectTimer.cancel(ignored);
+    _socket.set_option(boost::asio::ip::tcp::no_delay(true), ignored);
+    _state = State::CONNECTED;
+
+    // the preamble switches the server from HTTP to VST/1.1
+    std::unique_ptr<StringBuffer> preamble(
+        new StringBuffer(TRI_UNKNOWN_MEM_ZONE, 16, false));
+    preamble->appendText("VST/1.1\r\n\r\n");
+    _writeQueue.push_back(std::move(preamble));
+
+    if (!_communicator->_jwt.empty()) {
+      VPackBuilder auth;
+      auth.openArray();
+      auth.add(VPackValue(1));
+      auth.add(VPackValue(1000));  // 1000 == authentication
+      auth.add(VPackValue("jwt"));
+      auth.add(VPackValue(_communicator->_jwt));
+      auth.close();
+
+      // the server handles messages in order, so requests can be
+      // pipelined right behind the authentication
+      _authMessageId = NEXT_VST_TICKET_ID++;
+      for (auto& chunk :
+           createChunkForNetwork({auth.slice()}, _authMessageId,
+                                 _communicator->_maxChunkSize,
+                                 ProtocolVersion::VST_1_1)) {
+        _writeQueue.push_back(std::move(chunk));
+      }
+    }
+
+    auto waiting = std::move(_waiting);
+    _waiting.clear();
+    for (auto const& request : waiting) {
+      transmit(request);
+    }
+
+    write();
+    read();
+  }
+
+  void transmit(std::shared_ptr<Request> const& request) {
+    _inFlight.emplace(request->ticketId, request);
+    for (auto& chunk : request->chunks) {
+      _writeQueue.push_back(std::move(chunk));
+    }
+    request->chunks.clear();
+    write();
+  }
+
+  void write() {
+    if (_writing || _writeQueue.empty() || _state != State::CONNECTED) {
+      return;
+    }
+    _writing = true;
+
+    auto self = shared_from_this();
+    StringBuffer const* buffer = _writeQueue.front().get();
+    boost::asio::async_write(
+        _socket, boost::asio::buffer(buffer->c_str(), buffer->length()),
+        [self](boost::system::error_code const& ec, size_t) {
+          self->_writing = false;
+          if (self->_state != State::CONNECTED) {
+            return;
+          }
+          if (ec) {
+            self->shutdown(TRI_ERROR_CLUSTER_TIMEOUT);
+            return;
+          }
+          self->_writeQueue.pop_front();
+          self->write();
+        });
+  }
+
+  void read() {
+    auto self = shared_from_this();
+    _socket.async_read_some(
+        boost::asio::buffer(_readChunk.data(), _readChunk.size()),
+        [self](boost::system::error_code const& ec, size_t length) {
+          if (self->_state != State::CONNECTED) {
+            return;
+          }
+          if (ec) {
+            // connection closed by the server or broken. requests already
+            // sent may have been executed, so report them like a timeout
+            self->shutdown(TRI_ERROR_CLUSTER_TIMEOUT);
+            return;
+          }
+          self->_readBuffer.append(self->_readChunk.data(), length);
+          if (!self->processChunks()) {
+            LOG_TOPIC(WARN, Logger::COMMUNICATION)
+                << "received invalid VST chunk from '" << self->_host << ":"
+                << self->_port << "', closing connection";
+            self->shutdown(TRI_ERROR_INTERNAL);
+            return;
+          }
+          self->read();
+        });
+  }
+
+  bool processChunks() {
+    size_t offset = 0;
+    while (_readBuffer.size() - offset >= chunkHeaderSize) {
+      char const* p = _readBuffer.data() + offset;
+      uint32_t chunkLength = readLittleEndian<uint32_t>(p);
+      if (chunkLength < chunkHeaderSize) {
+        return false;
+      }
+      if (_readBuffer.size() - offset < chunkLength) {
+        break;
+      }
+
+      uint32_t chunkX = readLittleEndian<uint32_t>(p + 4);
+      uint64_t messageId = readLittleEndian<uint64_t>(p + 8);
+      char const* data = p + chunkHeaderSize;
+      size_t dataLength = chunkLength - chunkHeaderSize;
+      bool isFirst = (chunkX & 0x1) != 0;
+      uint32_t number = chunkX >> 1;
+      offset += chunkLength;
+
+      if (isFirst && number == 1) {
+        processMessage(messageId, data, dataLength);
+      } else if (isFirst) {
+        // number is the total number of chunks of this message
+        auto& partial = _partials[messageId];
+        partial.expected = number;
+        partial.received = 1;
+        partial.data.assign(data, dataLength);
+      } else {
+        auto it = _partials.find(messageId);
+        if (it == _partials.end()) {
+          return false;
+        }
+        it->second.data.append(data, dataLength);
+        if (++it->second.received == it->second.expected) {
+          std::string message = std::move(it->second.data);
+          _partials.erase(it);
+          processMessage(messageId, message.data(), message.size());
+        }
+      }
+    }
+    _readBuffer.erase(0, offset);
+    return true;
+  }
+
+  void processMessage(uint64_t messageId, char const* data, size_t length) {
+    if (messageId == _authMessageId) {
+      VPackSlice header(data);
+      if (header.isArray() && header.length() > 2 &&
+          header.at(2).getNumber<int>() != 200) {
+        LOG_TOPIC(ERR, Logger::COMMUNICATION)
+            << "VST authentication at '" << _host << ":" << _port
+            << "' failed";
+      }
+      return;
+    }
+
+    auto it = _inFlight.find(messageId);
+    if (it == _inFlight.end()) {
+      // timed out or aborted in the meantime
+      return;
+    }
+    std::shared_ptr<Request> request = it->second;
+    _inFlight.erase(it);
+
+    int code = 0;
+    std::unique_ptr<HttpResponse> response;
+    try {
+      VPackValidator validator;
+      validator.validate(data, length, true);
+      VPackSlice header(data);
+      code = header.at(2).getNumber<int>();
+
+      response.reset(new HttpResponse(static_cast<rest::ResponseCode>(code)));
+      if (header.length() > 3 && header.at(3).isObject()) {
+        for (auto const& it : VPackObjectIterator(header.at(3))) {
+          response->setHeaderNC(
+              StringUtils::tolower(it.key.copyString()),
+              it.value.isString() ? it.value.copyString() : it.value.toJson());
+        }
+      }
+
+      // the payload is passed on as it is. only user-defined content types
+      // are announced by a header, everything else is VelocyPack
+      size_t headerSize = static_cast<size_t>(header.byteSize());
+      if (headerSize < length) {
+        response->body().appendText(data + headerSize, length - headerSize);
+        if (response->headers().find(StaticStrings::ContentTypeHeader) ==
+            response->headers().end()) {
+          response->setContentType(rest::ContentType::VPACK);
+        }
+      }
+    } catch (std::exception const& ex) {
+      LOG_TOPIC(WARN, Logger::COMMUNICATION)
+          << "cannot parse VST response from '" << _host << ":" << _port
+          << "': " << ex.what();
+      _communicator->complete(request, TRI_ERROR_INTERNAL, nullptr);
+      return;
+    }
+
+    _communicator->complete(request, code < 400 ? TRI_ERROR_NO_ERROR : code,
+                            std::move(response));
+  }
+
+ private:
+  VstCommunicator* _communicator;
+  std::string const _host;
+  std::string const _port;
+  State _state;
+
+  boost::asio::ip::tcp::resolver _resolver;
+  boost::asio::ip::tcp::socket _socket;
+  boost::asio::deadline_timer _connectTimer;
+
+  std::vector<std::shared_ptr<Request>> _waiting;
+  std::unordered_map<communicator::Ticket, std::shared_ptr<Request>> _inFlight;
+
+  std::deque<std::unique_ptr<StringBuffer>> _writeQueue;
+  bool _writing;
+
+  std::array<char, 32768> _readChunk;
+  std::string _readBuffer;
+  std::unordered_map<uint64_t, Partial> _partials;
+  uint64_t _authMessageId;
+};
+
+VstCommunicator::VstCommunicator(size_t connectionsPerEndpoint,
+                                 uint32_t maxChunkSize, std::string const& jwt)
+    : _connectionsPerEndpoint((std::max)(connectionsPerEndpoint, size_t(1))),
+      _maxChunkSize(maxChunkSize),
+      _jwt(jwt),
+      _started(false),
+      _enabled(true) {}
+
+VstCommunicator::~VstCommunicator() {
+  disable();
+
+  bool started;
+  {
+    MUTEX_LOCKER(locker, _startLock);
+    started = _started;
+  }
+  if (started) {
+    // all sockets and timers are gone, so run() returns once the
+    // cancelled handlers have been executed
+    _work.reset();
+    _thread.join();
+  }
+}
+
+bool VstCommunicator::supportsEndpoint(std::string const& endpoint) {
+  return endpoint.compare(0, 6, "tcp://") == 0;
+}
+
+communicator::Ticket VstCommunicator::addRequest(
+    std::string const& endpoint, rest::RequestType type,
+    std::string const& path, std::string const* body,
+    std::unordered_map<std::string, std::string> const& headers,
+    communicator::Callbacks const& callbacks,
+    communicator::Options const& options) {
+  if (!_enabled.load() || !supportsEndpoint(endpoint)) {
+    return 0;
+  }
+
+  std::shared_ptr<VPackBuilder> payload;
+  if (body != nullptr && !body->empty()) {
+    try {
+      payload = VPackParser::fromJson(*body);
+    } catch (...) {
+      // not JSON, leave this one to HTTP
+      return 0;
+    }
+  }
+
+  std::string database;
+  std::string requestPath;
+  VPackBuilder parameters;
+  splitPath(path, database, requestPath, parameters);
+
+  VPackBuilder header;
+  header.openArray();
+  header.add(VPackValue(1));  // version
+  header.add(VPackValue(1));  // 1 == request
+  header.add(VPackValue(database));
+  header.add(VPackValue(static_cast<int>(meta::underlyingValue(type))));
+  header.add(VPackValue(requestPath));
+  header.add(parameters.slice());
+  header.openObject();
+  for (auto const& it : headers) {
+    header.add(it.first, VPackValue(it.second));
+  }
+  header.close();
+  header.close();
+
+  std::vector<VPackSlice> slices{header.slice()};
+  if (payload != nullptr) {
+    slices.push_back(payload->slice());
+  }
+
+  auto request = std::make_shared<Request>();
+  request->ticketId = NEXT_VST_TICKET_ID++;
+  request->chunks = createChunkForNetwork(slices, request->ticketId,
+                                          _maxChunkSize,
+                                          ProtocolVersion::VST_1_1);
+  request->callbacks = callbacks;
+  request->options = options;
+
+  communicator::Ticket ticketId = request->ticketId;
+  std::string host = endpoint.substr(6);
+
+  ensureRunning();
+  _ioService.post([this, request, host]() {
+    if (!_enabled.load()) {
+      complete(request, TRI_COMMUNICATOR_REQUEST_ABORTED, nullptr);
+      return;
+    }
+    _requests.emplace(request->ticketId, request);
+
+    std::weak_ptr<Request> weak(request);
+    request->timer.reset(new boost::asio::deadline_timer(_ioService));
+    request->timer->expires_from_now(
+        toDuration(request->options.requestTimeout));
+    request->timer->async_wait([this, weak](boost::system::error_code const& ec) {
+      auto request = weak.lock();
+      if (!ec && request != nullptr) {
+        complete(request, TRI_ERROR_CLUSTER_TIMEOUT, nullptr);
+      }
+    });
+
+    selectConnection(host)->send(request);
+  });
+
+  return ticketId;
+}
+
+void VstCommunicator::abortRequest(communicator::Ticket ticketId) {
+  MUTEX_LOCKER(locker, _startLock);
+  if (!_started) {
+    return;
+  }
+  _ioService.post([this, ticketId]() {
+    auto it = _requests.find(ticketId);
+    if (it != _requests.end()) {
+      complete(it->second, TRI_COMMUNICATOR_REQUEST_ABORTED, nullptr);
+    }
+  });
+}
+
+void VstCommunicator::abortRequests() {
+  MUTEX_LOCKER(locker, _startLock);
+  if (_started) {
+    _ioService.post([this]() { abortAll(false); });
+  }
+}
+
+void VstCommunicator::disable() {
+  _enabled.store(false);
+
+  MUTEX_LOCKER(locker, _startLock);
+  if (_started) {
+    _ioService.post([this]() { abortAll(true); });
+  }
+}
+
+void VstCommunicator::ensureRunning() {
+  MUTEX_LOCKER(locker, _startLock);
+  if (_started) {
+    return;
+  }
+  _started = true;
+  _work.reset(new boost::asio::io_service::work(_ioService));
+  _thread = std::thread([this]() {
+    while (true) {
+      try {
+        _ioService.run();
+        break;
+      } catch (std::exception const& ex) {
+        LOG_TOPIC(ERR, Logger::COMMUNICATION)
+            << "caught exception in VST communicator: " << ex.what();
+      } catch (...) {
+        LOG_TOPIC(ERR, Logger::COMMUNICATION)
+            << "caught unknown exception in VST communicator";
+      }
+    }
+  });
+}
+
+std::shared_ptr<VstCommunicator::Connection> VstCommunicator::selectConnection(
+    std::string const& endpoint) {
+  auto& pool = _connections[endpoint];
+  pool.erase(std::remove_if(pool.begin(), pool.end(),
+                            [](std::shared_ptr<Connection> const& connection) {
+                              return connection->isBroken();
+                            }),
+             pool.end());
+
+  // prefer the least loaded connection, and only open another one if all
+  // of them are busy
+  std::shared_ptr<Connection> best;
+  for (auto const& connection : pool) {
+    if (best == nullptr || connection->load() < best->load()) {
+      best = connection;
+    }
+  }
+
+  if (best == nullptr ||
+      (best->load() > 0 && pool.size() < _connectionsPerEndpoint)) {
+    std::string host = endpoint;
+    std::string port = "8529";
+    std::string::size_type colon = host.rfind(':');
+    if (colon != std::string::npos && host.find(']', colon) == std::string::npos) {
+      port = host.substr(colon + 1);
+      host = host.substr(0, colon);
+    }
+    if (host.size() > 2 && host.front() == '[' && host.back() == ']') {
+      host = host.substr(1, host.size() - 2);
+    }
+    best = std::make_shared<Connection>(this, host, port);
+    pool.push_back(best);
+  }
+  return best;
+}
+
+void VstCommunicator::complete(std::shared_ptr<Request> request,
+                               int errorCode,
+                               std::unique_ptr<GeneralResponse> response) {
+  if (request->done) {
+    return;
+  }
+  request->done = true;
+
+  if (request->timer != nullptr) {
+    boost::system::error_code ec;
+    request->timer->cancel(ec);
+  }
+  auto connection = request->connection.lock();
+  if (connection != nullptr) {
+    connection->forget(request->ticketId);
+  }
+  _requests.erase(request->ticketId);
+
+  try {
+    if (errorCode == TRI_ERROR_NO_ERROR) {
+      request->callbacks._onSuccess(std::move(response));
+    } else {
+      request->callbacks._onError(errorCode, std::move(response));
+    }
+  } catch (std::exception const& ex) {
+    LOG_TOPIC(WARN, Logger::COMMUNICATION)
+        << "caught exception in VST request callback: " << ex.what();
+  }
+}
+
+void VstCommunicator::abortAll(bool closeConnections) {
+  auto requests = std::move(_requests);
+  _requests.clear();
+  for (auto& it : requests) {
+    complete(it.second, TRI_COMMUNICATOR_REQUEST_ABORTED, nullptr);
+  }
+
+  if (closeConnections) {
+    auto connections = std::move(_connections);
+    _connections.clear();
+    for (auto& it : connections) {
+      for (auto& connection : it.second) {
+        connection->shutdown(TRI_COMMUNICATOR_REQUEST_ABORTED);
+      }
+    }
+  }
+}
@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_CLUSTER_VST_COMMUNICATOR_H
+#define ARANGOD_CLUSTER_VST_COMMUNICATOR_H 1
+
+#include "Basics/Common.h"
+
+#include <boost/asio/io_service.hpp>
+
+#include <thread>
+
+#include "Basics/Mutex.h"
+#include "Rest/CommonDefines.h"
+#include "SimpleHttpClient/Callbacks.h"
+#include "SimpleHttpClient/Communicator.h"
+
+namespace arangodb {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cluster-internal transport speaking VelocyStream
+///
+/// Keeps a small pool of persistent VST/1.1 connections per endpoint and
+/// multiplexes any number of requests over each of them, using the message
+/// id to match responses. Response bodies are handed out as VelocyPack
+/// without any conversion. All socket work happens on a single I/O thread
+/// owned by this object, which also invokes the callbacks.
+////////////////////////////////////////////////////////////////////////////////
+
+class VstCommunicator {
+ public:
+  VstCommunicator(size_t connectionsPerEndpoint, uint32_t maxChunkSize,
+                  std::string const& jwt);
+  ~VstCommunicator();
+
+  VstCommunicator(VstCommunicator const&) = delete;
+  VstCommunicator& operator=(VstCommunicator const&) = delete;
+
+ public:
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief whether or not requests to the endpoint can go through VST
+  //////////////////////////////////////////////////////////////////////////////
+
+  static bool supportsEndpoint(std::string const& endpoint);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief submit a request, the path may carry a /_db/ prefix and a query
+  /// string. returns 0 if the request cannot be expressed in VST (e.g. a
+  /// body that is not JSON), in which case no callback is invoked
+  //////////////////////////////////////////////////////////////////////////////
+
+  communicator::Ticket addRequest(
+      std::string const& endpoint, rest::RequestType type,
+      std::string const& path, std::string const* body,
+      std::unordered_map<std::string, std::string> const& headers,
+      communicator::Callbacks const& callbacks,
+      communicator::Options const& options);
+
+  void abortRequest(communicator::Ticket ticketId);
+  void abortRequests();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief abort everything in flight and refuse all further requests
+  //////////////////////////////////////////////////////////////////////////////
+
+  void disable();
+
+ private:
+  class Connection;
+  struct Request;
+
+  void ensureRunning();
+  std::shared_ptr<Connection> selectConnection(std::string const& endpoint);
+  void complete(std::shared_ptr<Request> request, int errorCode,
+                std::unique_ptr<GeneralResponse> response);
+  void abortAll(bool closeConnections);
+
+ private:
+  size_t const _connectionsPerEndpoint;
+  uint32_t const _maxChunkSize;
+  std::string const _jwt;
+
+  boost::asio::io_service _ioService;
+  std::unique_ptr<boost::asio::io_service::work> _work;
+  std::thread _thread;
+
+  Mutex _startLock;
+  bool _started;
+  std::atomic<bool> _enabled;
+
+  // the following members are only touched on the I/O thread
+  std::unordered_map<std::string, std::vector<std::shared_ptr<Connection>>>
+      _connections;
+  std::unordered_map<communicator::Ticket, std::shared_ptr<Request>> _requests;
+};
+}
+
+#endif
@@ -55,6 +55,7 @@ class arangodb::rest::AsyncCallbackContext {
 AsyncJobResult::AsyncJobResult()
     : _jobId(0),
       _response(nullptr),
+      _memoryUsage(0),
       _stamp(0.0),
       _status(JOB_UNDEFINED),
       _ctx(nullptr),
@@ -65,6 +66,7 @@ AsyncJobResult::AsyncJobResult(IdType jobId, Status status,
                                RestHandler* handler)
     : _jobId(jobId),
       _response(nullptr),
+      _memoryUsage(0),
       _stamp(TRI_microtime()),
       _status(status),
       _ctx(ctx),
@@ -72,8 +74,14 @@ AsyncJobResult::AsyncJobResult(IdType jobId, Status status,
 
 AsyncJobResult::~AsyncJobResult() {}
 
-AsyncJobManager::AsyncJobManager()
-    : _lock(), _jobs() {}
+double const AsyncJobManager::EXPIRY_INTERVAL = 1.0;
+
+AsyncJobManager::AsyncJobManager(uint64_t maxMemoryUsage, double ttl)
+    : _shards(),
+      _memoryUsage(0),
+      _maxMemoryUsage(maxMemoryUsage),
+      _ttl(ttl),
+      _lastExpiry(TRI_microtime()) {}
 
 AsyncJobManager::~AsyncJobManager() {
   // remove all results that haven't been fetched
@@ -87,11 +95,12 @@ AsyncJobManager::~AsyncJobManager() {
 GeneralResponse* AsyncJobManager::getJobResult(AsyncJobResult::IdType jobId,
                                                AsyncJobResult::Status& status,
                                                bool removeFromList) {
-  WRITE_LOCKER(writeLocker, _lock);
+  Shard& s = shard(jobId);
+  WRITE_LOCKER(writeLocker, s._lock);
 
-  auto it = _jobs.find(jobId);
+  auto it = s._jobs.find(jobId);
 
-  if (it == _jobs.end()) {
+  if (it == s._jobs.end()) {
     status = AsyncJobResult::JOB_UNDEFINED;
     return nullptr;
   }
@@ -107,8 +116,10 @@ GeneralResponse* AsyncJobManager::getJobResult(AsyncJobResult::IdType jobId,
     return nullptr;
   }
 
-  // remove the job from the list
-  _jobs.erase(it);
+  // remove the job from the list, ownership of the response goes to the
+  // caller
+  removeResult((*it).second, false);
+  s._jobs.erase(it);
   return response;
 }
 
@@ -117,22 +128,18 @@ GeneralResponse* AsyncJobManager::getJobResult(AsyncJobResult::IdType jobId,
 ////////////////////////////////////////////////////////////////////////////////
 
 bool AsyncJobManager::deleteJobResult(AsyncJobResult::IdType jobId) {
-  WRITE_LOCKER(writeLocker, _lock);
+  Shard& s = shard(jobId);
+  WRITE_LOCKER(writeLocker, s._lock);
 
-  auto it = _jobs.find(jobId);
+  auto it = s._jobs.find(jobId);
 
-  if (it == _jobs.end()) {
+  if (it == s._jobs.end()) {
     return false;
   }
 
-  GeneralResponse* response = (*it).second._response;
-
-  if (response != nullptr) {
-    delete response;
-  }
-
   // remove the job from the list
-  _jobs.erase(it);
+  removeResult((*it).second, true);
+  s._jobs.erase(it);
   return true;
 }
 
@@ -141,51 +148,28 @@ bool AsyncJobManager::deleteJobResult(AsyncJobResult::IdType jobId) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void AsyncJobManager::deleteJobResults() {
-  WRITE_LOCKER(writeLocker, _lock);
-
-  auto it = _jobs.begin();
-
-  while (it != _jobs.end()) {
-    GeneralResponse* response = (*it).second._response;
+  for (auto& s : _shards) {
+    WRITE_LOCKER(writeLocker, s._lock);
 
-    if (response != nullptr) {
-      delete response;
+    for (auto& it : s._jobs) {
+      removeResult(it.second, true);
     }
 
-    ++it;
+    s._jobs.clear();
   }
-
-  _jobs.clear();
 }
 
 void AsyncJobManager::deleteExpiredJobResults(double stamp) {
-  WRITE_LOCKER(writeLocker, _lock);
-
-  auto it = _jobs.begin();
-
-  while (it != _jobs.end()) {
-    AsyncJobResult ajr = (*it).second;
-
-    if (ajr._stamp < stamp) {
-      GeneralResponse* response = ajr._response;
-
-      if (response != nullptr) {
-        delete response;
-      }
-
-      _jobs.erase(it++);
-    } else {
-      ++it;
-    }
-  }
+  expire(stamp, false);
 }
 
 bool AsyncJobManager::cancelJob(AsyncJobResult::IdType jobId) {
-  WRITE_LOCKER(writeLocker, _lock);
+  Shard& s = shard(jobId);
+  WRITE_LOCKER(writeLocker, s._lock);
 
-  auto it = _jobs.find(jobId);
+  auto it = s._jobs.find(jobId);
 
-  if (it == _jobs.end()) {
+  if (it == s._jobs.end()) {
     return false;
   }
 
@@ -219,24 +203,21 @@ std::vector<AsyncJobResult::IdType> AsyncJobManager::byStatus(
     AsyncJobResult::Status status, size_t maxCount) {
   std::vector<AsyncJobResult::IdType> jobs;
 
-  {
-    size_t n = 0;
-    READ_LOCKER(readLocker, _lock);
-    auto it = _jobs.begin();
+  if (maxCount == 0) {
+    return jobs;
+  }
 
-    // iterate the list. the list is sorted by id
-    while (it != _jobs.end()) {
-      AsyncJobResult::IdType jobId = (*it).first;
+  for (auto& s : _shards) {
+    READ_LOCKER(readLocker, s._lock);
 
-      if ((*it).second._status == status) {
-        jobs.emplace_back(jobId);
+    for (auto const& it : s._jobs) {
+      if (it.second._status == status) {
+        jobs.emplace_back(it.first);
 
-        if (++n >= maxCount) {
-          break;
+        if (jobs.size() >= maxCount) {
+          return jobs;
         }
       }
-
-      ++it;
     }
   }
 
@@ -244,10 +225,20 @@ std::vector<AsyncJobResult::IdType> AsyncJobManager::byStatus(
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief initializes an async job
+/// @brief initializes an async job. returns false if the job cannot be
+/// accepted because the stored results already use too much memory
 ////////////////////////////////////////////////////////////////////////////////
 
-void AsyncJobManager::initAsyncJob(RestHandler* handler, char const* hdr) {
+bool AsyncJobManager::initAsyncJob(RestHandler* handler, char const* hdr) {
+  expireIfDue();
+
+  if (_maxMemoryUsage > 0 && _memoryUsage.load() >= _maxMemoryUsage) {
+    LOG_TOPIC(DEBUG, arangodb::Logger::FIXME)
+        << "refusing async job, stored job results use " << _memoryUsage.load()
+        << " bytes";
+    return false;
+  }
+
   AsyncJobResult::IdType jobId = handler->handlerId();
   AsyncCallbackContext* ctx = nullptr;
 
@@ -258,9 +249,11 @@ void AsyncJobManager::initAsyncJob(RestHandler* handler, char const* hdr) {
 
   AsyncJobResult ajr(jobId, AsyncJobResult::JOB_PENDING, ctx, handler);
 
-  WRITE_LOCKER(writeLocker, _lock);
+  Shard& s = shard(jobId);
+  WRITE_LOCKER(writeLocker, s._lock);
 
-  _jobs.emplace(jobId, ajr);
+  s._jobs.emplace(jobId, ajr);
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -273,23 +266,91 @@ void AsyncJobManager::finishAsyncJob(RestHandler* handler) {
   AsyncCallbackContext* ctx = nullptr;
 
   {
-    WRITE_LOCKER(writeLocker, _lock);
-    auto it = _jobs.find(jobId);
+    Shard& s = shard(jobId);
+    WRITE_LOCKER(writeLocker, s._lock);
+    auto it = s._jobs.find(jobId);
 
-    if (it == _jobs.end()) {
+    if (it == s._jobs.end()) {
       return;
     }
 
     ctx = (*it).second._ctx;
 
     if (nullptr != ctx) {
-      _jobs.erase(it);
+      s._jobs.erase(it);
     } else {
+      size_t memoryUsage =
+          (response == nullptr) ? 0 : response->memoryUsage();
+
       (*it).second._response = response.release();
+      (*it).second._memoryUsage = memoryUsage;
       (*it).second._status = AsyncJobResult::JOB_DONE;
       (*it).second._stamp = TRI_microtime();
+
+      _memoryUsage += memoryUsage;
     }
   }
 
   delete ctx;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases the memory accounted for a job result. the caller must
+/// hold the lock of the job's shard
+////////////////////////////////////////////////////////////////////////////////
+
+void AsyncJobManager::removeResult(AsyncJobResult& ajr, bool deleteResponse) {
+  _memoryUsage -= ajr._memoryUsage;
+  ajr._memoryUsage = 0;
+
+  if (deleteResponse && ajr._response != nullptr) {
+    delete ajr._response;
+  }
+
+  ajr._response = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes all jobs older than stamp, optionally only finished ones
+////////////////////////////////////////////////////////////////////////////////
+
+void AsyncJobManager::expire(double stamp, bool doneOnly) {
+  for (auto& s : _shards) {
+    WRITE_LOCKER(writeLocker, s._lock);
+
+    auto it = s._jobs.begin();
+
+    while (it != s._jobs.end()) {
+      AsyncJobResult& ajr = (*it).second;
+
+      if (ajr._stamp < stamp &&
+          (!doneOnly || ajr._status == AsyncJobResult::JOB_DONE)) {
+        removeResult(ajr, true);
+        it = s._jobs.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes the results of finished jobs that outlived the ttl. this is
+/// done at most once per EXPIRY_INTERVAL, by whichever thread gets there first
+////////////////////////////////////////////////////////////////////////////////
+
+void AsyncJobManager::expireIfDue() {
+  if (_ttl <= 0.0) {
+    return;
+  }
+
+  double const now = TRI_microtime();
+  double last = _lastExpiry.load();
+
+  if (now - last < EXPIRY_INTERVAL ||
+      !_lastExpiry.compare_exchange_strong(last, now)) {
+    return;
+  }
+
+  expire(now - _ttl, true);
+}
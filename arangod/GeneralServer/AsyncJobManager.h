@@ -27,6 +27,8 @@
 #include "Basics/Common.h"
 #include "Basics/ReadWriteLock.h"
 
+#include <array>
+
 namespace arangodb {
 class GeneralResponse;
 
@@ -55,6 +57,7 @@ struct AsyncJobResult {
  public:
   IdType _jobId;
   GeneralResponse* _response;
+  size_t _memoryUsage;
   double _stamp;
   Status _status;
   AsyncCallbackContext* _ctx;
@@ -72,8 +75,15 @@ class AsyncJobManager {
  public:
   typedef std::unordered_map<AsyncJobResult::IdType, AsyncJobResult> JobList;
 
+  // jobs are distributed over several independently locked lists so that
+  // concurrent async requests do not all contend for the same lock
+  static size_t const NUMBER_OF_SHARDS = 16;
+
+  // minimal time between two automatic removals of expired results
+  static double const EXPIRY_INTERVAL;
+
  public:
-  AsyncJobManager();
+  AsyncJobManager(uint64_t maxMemoryUsage, double ttl);
   ~AsyncJobManager();
 
  public:
@@ -88,12 +98,42 @@ class AsyncJobManager {
   std::vector<AsyncJobResult::IdType> done(size_t maxCount);
   std::vector<AsyncJobResult::IdType> byStatus(AsyncJobResult::Status,
                                                size_t maxCount);
-  void initAsyncJob(RestHandler*, char const*);
+  bool initAsyncJob(RestHandler*, char const*);
   void finishAsyncJob(RestHandler*);
 
+  uint64_t memoryUsage() const { return _memoryUsage.load(); }
+  uint64_t maxMemoryUsage() const { return _maxMemoryUsage; }
+  double ttl() const { return _ttl; }
+
+ private:
+  struct Shard {
+    basics::ReadWriteLock _lock;
+    JobList _jobs;
+  };
+
+  Shard& shard(AsyncJobResult::IdType jobId) {
+    return _shards[jobId % NUMBER_OF_SHARDS];
+  }
+
+  void removeResult(AsyncJobResult&, bool deleteResponse);
+  void expire(double stamp, bool doneOnly);
+  void expireIfDue();
+
  private:
-  basics::ReadWriteLock _lock;
-  JobList _jobs;
+  std::array<Shard, NUMBER_OF_SHARDS> _shards;
+
+  // memory held by stored responses, in bytes
+  std::atomic<uint64_t> _memoryUsage;
+
+  // new async jobs are refused while the stored responses use more memory
+  // than this. 0 means unlimited
+  uint64_t const _maxMemoryUsage;
+
+  // seconds after which unfetched results of finished jobs are removed.
+  // 0 means results are kept until fetched or deleted
+  double const _ttl;
+
+  std::atomic<double> _lastExpiry;
 };
 }
 }
@@ -137,6 +137,20 @@ void GeneralCommTask::executeRequest(
     return;
   }
 
+  // per-route statistics use the registered prefix, or the handler name
+  // for exact path matches
+  RequestStatistics* stat = statistics(messageId);
+
+  if (stat != nullptr) {
+    std::string route = handler->request()->prefix();
+
+    if (route.empty()) {
+      route = handler->name();
+    }
+
+    RequestStatistics::SET_ROUTE(stat, route);
+  }
+
   // asynchronous request
   bool ok = false;
 
@@ -243,12 +257,17 @@ bool GeneralCommTask::handleRequest(std::shared_ptr<RestHandler> handler) {
   if (handler->isDirect()) {
     isDirect = true;
   } else if (_loop._scheduler->hasQueueCapacity()) {
-    isDirect = true;
+    // a reactor thread must not block its other connections
+    if (_loop._reactor) {
+      isPrio = true;
+    } else {
+      isDirect = true;
+    }
   } else if (ServerState::instance()->isDBServer()) {
     isPrio = true;
   } else if (handler->needsOwnThread()) {
     isPrio = true;
-  } else if (handler->queue() == JobQueue::AQL_QUEUE) {
+  } else if (handler->queue() == JobQueue::CLUSTER_QUEUE) {
     isPrio = true;
   }
 
@@ -327,7 +346,11 @@ bool GeneralCommTask::handleRequestAsync(std::shared_ptr<RestHandler> handler,
   if (jobId != nullptr) {
     store = true;
     *jobId = handler->handlerId();
-    GeneralServerFeature::JOB_MANAGER->initAsyncJob(handler.get(), hdr);
+
+    if (!GeneralServerFeature::JOB_MANAGER->initAsyncJob(handler.get(), hdr)) {
+      // too many unfetched job results
+      return false;
+    }
   }
 
   if (store) {
@@ -346,7 +369,18 @@ bool GeneralCommTask::handleRequestAsync(std::shared_ptr<RestHandler> handler,
       _server, std::move(handler),
       [self, this](std::shared_ptr<RestHandler> h) { h->asyncRunEngine(); });
 
-  return SchedulerFeature::SCHEDULER->queue(std::move(job));
+  uint64_t const id = store ? *jobId : 0;
+
+  if (!SchedulerFeature::SCHEDULER->queue(std::move(job))) {
+    if (store) {
+      // the job will never run, so don't leave it pending forever
+      GeneralServerFeature::JOB_MANAGER->deleteJobResult(id);
+    }
+
+    return false;
+  }
+
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
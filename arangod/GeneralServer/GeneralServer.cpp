@@ -92,12 +92,35 @@ bool GeneralServer::openEndpoint(Endpoint* endpoint) {
     protocolType = ProtocolType::HTTP;
   }
 
-  std::unique_ptr<ListenTask> task(new GeneralListenTask(
-      SchedulerFeature::SCHEDULER->eventLoop(), this, endpoint, protocolType));
-  if (!task->start()) {
-    return false;
+  auto scheduler = SchedulerFeature::SCHEDULER;
+  std::vector<EventLoop> loops = scheduler->reactorLoops();
+  bool const tcp = endpoint->domainType() == Endpoint::DomainType::IPV4 ||
+                   endpoint->domainType() == Endpoint::DomainType::IPV6;
+
+  if (loops.empty() || !tcp) {
+    std::unique_ptr<ListenTask> task(new GeneralListenTask(
+        scheduler->eventLoop(), this, endpoint, protocolType));
+    if (!task->start()) {
+      return false;
+    }
+
+    _listenTasks.emplace_back(std::move(task));
+    return true;
+  }
+
+  // one acceptor per reactor, the kernel spreads the connections and each
+  // connection stays on the reactor that accepted it
+  for (auto const& loop : loops) {
+    std::unique_ptr<ListenTask> task(
+        new GeneralListenTask(loop, this, endpoint, protocolType));
+    task->setReusePort(loops.size() > 1);
+
+    if (!task->start()) {
+      return false;
+    }
+
+    _listenTasks.emplace_back(std::move(task));
   }
 
-  _listenTasks.emplace_back(std::move(task));
   return true;
 }
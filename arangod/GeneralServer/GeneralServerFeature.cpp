@@ -46,6 +46,7 @@
 #include "RestHandler/RestAqlFunctionsHandler.h"
 #include "RestHandler/RestAuthHandler.h"
 #include "RestHandler/RestBatchHandler.h"
+#include "RestHandler/RestCacheHandler.h"
 #include "RestHandler/RestCursorHandler.h"
 #include "RestHandler/RestDatabaseHandler.h"
 #include "RestHandler/RestDebugHandler.h"
@@ -60,8 +61,11 @@
 #include "RestHandler/RestImportHandler.h"
 #include "RestHandler/RestIndexHandler.h"
 #include "RestHandler/RestJobHandler.h"
+#include "RestHandler/RestMemoryHandler.h"
+#include "RestHandler/RestMetricsHandler.h"
 #include "RestHandler/RestPleaseUpgradeHandler.h"
 #include "RestHandler/RestPregelHandler.h"
+#include "RestHandler/RestProfilerHandler.h"
 #include "RestHandler/RestQueryCacheHandler.h"
 #include "RestHandler/RestQueryHandler.h"
 #include "RestHandler/RestShutdownHandler.h"
@@ -124,6 +128,18 @@ void GeneralServerFeature::collectOptions(
   options->addOldOption("server.default-api-compatibility", "");
   options->addOldOption("no-server", "server.rest-server");
 
+  options->addOption("--server.async-jobs-max-memory",
+                     "memory limit (in bytes) for stored results of async "
+                     "jobs, new async jobs are refused above it (0 = "
+                     "unlimited)",
+                     new UInt64Parameter(&_asyncJobsMaxMemory));
+
+  options->addOption("--server.async-jobs-ttl",
+                     "time (in seconds) after which unfetched results of "
+                     "finished async jobs are removed (0 = keep until "
+                     "fetched)",
+                     new DoubleParameter(&_asyncJobsTtl));
+
   options->addSection("http", "HttpServer features");
 
   options->addHiddenOption("--http.allow-method-override",
@@ -240,7 +256,7 @@ void GeneralServerFeature::prepare() {
 }
 
 void GeneralServerFeature::start() {
-  _jobManager.reset(new AsyncJobManager);
+  _jobManager.reset(new AsyncJobManager(_asyncJobsMaxMemory, _asyncJobsTtl));
 
   JOB_MANAGER = _jobManager.get();
 
@@ -504,9 +520,22 @@ void GeneralServerFeature::defineHandlers() {
       "/_admin/work-monitor",
       RestHandlerCreator<WorkMonitorHandler>::createNoData);
 
+  _handlerFactory->addHandler(
+      "/_admin/cache", RestHandlerCreator<RestCacheHandler>::createNoData);
+
   _handlerFactory->addHandler(
       "/_admin/json-echo", RestHandlerCreator<RestEchoHandler>::createNoData);
 
+  _handlerFactory->addPrefixHandler(
+      "/_admin/memory", RestHandlerCreator<RestMemoryHandler>::createNoData);
+
+  _handlerFactory->addHandler(
+      "/_admin/metrics", RestHandlerCreator<RestMetricsHandler>::createNoData);
+
+  _handlerFactory->addHandler(
+      "/_admin/profiler",
+      RestHandlerCreator<RestProfilerHandler>::createNoData);
+
 #ifdef ARANGODB_ENABLE_FAILURE_TESTS
   // This handler is to activate SYS_DEBUG_FAILAT on DB servers
   _handlerFactory->addPrefixHandler(
@@ -95,6 +95,8 @@ class GeneralServerFeature final
 
  private:
   double _keepAliveTimeout = 300.0;
+  uint64_t _asyncJobsMaxMemory = 1024 * 1024 * 1024;
+  double _asyncJobsTtl = 0.0;
   bool _allowMethodOverride;
 
   bool _proxyCheck;
@@ -46,6 +46,38 @@ size_t const HttpCommTask::MaximalBodySize = 1024 * 1024 * 1024;      // 1024 MB
 size_t const HttpCommTask::MaximalPipelineSize = 1024 * 1024 * 1024;  // 1024 MB
 size_t const HttpCommTask::RunCompactEvery = 500;
 
+/// @brief smaller response bodies are not worth compressing
+static size_t const MinCompressionLength = 1024;
+
+/// @brief whether an accept-encoding header value allows deflate
+static bool AcceptsDeflate(std::string const& acceptEncoding) {
+  if (acceptEncoding.empty()) {
+    return false;
+  }
+
+  for (auto const& part : StringUtils::split(acceptEncoding, ',')) {
+    std::vector<std::string> params = StringUtils::split(part, ';');
+    if (params.empty()) {
+      continue;
+    }
+    std::string coding = StringUtils::tolower(StringUtils::trim(params[0]));
+    if (coding != StaticStrings::Deflate) {
+      continue;
+    }
+    // "deflate;q=0" explicitly forbids the coding
+    for (size_t i = 1; i < params.size(); ++i) {
+      std::string param = StringUtils::trim(params[i]);
+      if (param.size() > 2 && param[0] == 'q' && param[1] == '=' &&
+          StringUtils::doubleDecimal(param.substr(2)) <= 0.0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  return false;
+}
+
 HttpCommTask::HttpCommTask(EventLoop loop, GeneralServer* server,
                            std::unique_ptr<Socket> socket,
                            ConnectionInfo&& info, double timeout)
@@ -60,6 +92,7 @@ HttpCommTask::HttpCommTask(EventLoop loop, GeneralServer* server,
       _allowMethodOverride(GeneralServerFeature::allowMethodOverride()),
       _denyCredentials(true),
       _newRequest(true),
+      _acceptDeflate(false),
       _requestType(rest::RequestType::ILLEGAL),
       _fullUrl(),
       _origin(),
@@ -82,6 +115,11 @@ void HttpCommTask::handleSimpleError(rest::ResponseCode code, GeneralRequest con
   std::unique_ptr<GeneralResponse> response(new HttpResponse(code));
   response->setContentType(req.contentTypeResponse());
 
+  if (errorNum == TRI_ERROR_QUEUE_FULL) {
+    // the server is shedding load, ask the client to back off
+    response->setHeaderNC(StaticStrings::RetryAfter, "1");
+  }
+
   VPackBuilder builder;
   builder.openObject();
   builder.add(StaticStrings::Error, VPackValue(true));
@@ -143,6 +181,18 @@ void HttpCommTask::addResponse(HttpResponse* response,
                                   ? rest::ConnectionType::C_CLOSE
                                   : rest::ConnectionType::C_KEEP_ALIVE);
 
+  if (_acceptDeflate && response->allowCompression() &&
+      _requestType != rest::RequestType::HEAD &&
+      response->body().length() >= MinCompressionLength &&
+      response->_headers.find(StaticStrings::ContentEncoding) ==
+          response->_headers.end()) {
+    // compress the body. the response is sent uncompressed if this fails
+    if (response->deflate() != TRI_ERROR_NO_ERROR) {
+      LOG_TOPIC(DEBUG, arangodb::Logger::FIXME)
+          << "unable to deflate response body";
+    }
+  }
+
   size_t const responseBodyLength = response->bodySize();
 
   if (_requestType == rest::RequestType::HEAD) {
@@ -394,6 +444,11 @@ bool HttpCommTask::processRead(double startTime) {
         }
       }
 
+      // check whether the client accepts deflated responses. we need this
+      // later when responding as well
+      _acceptDeflate = AcceptsDeflate(
+          _incompleteRequest->header(StaticStrings::AcceptEncoding));
+
       // store the original request's type. we need it later when responding
       // (original request object gets deleted before responding)
       _requestType = _incompleteRequest->requestType();
@@ -496,7 +551,7 @@ bool HttpCommTask::processRead(double startTime) {
                             "gzip decoding error", 1);
           return false;
         }
-        _incompleteRequest->setBody(uncompressed.c_str(), uncompressed.size());
+        _incompleteRequest->setBody(std::move(uncompressed));
         handled = true;
       } else if (encoding == "deflate") {
         std::string uncompressed;
@@ -506,7 +561,7 @@ bool HttpCommTask::processRead(double startTime) {
                             "gzip deflate error", 1);
           return false;
         }
-        _incompleteRequest->setBody(uncompressed.c_str(), uncompressed.size());
+        _incompleteRequest->setBody(std::move(uncompressed));
         handled = true;
       }
     }
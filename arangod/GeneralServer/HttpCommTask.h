@@ -77,6 +77,7 @@ class HttpCommTask final : public GeneralCommTask {
   bool _denyCredentials;  // whether or not to allow credentialed requests (only
                           // CORS)
   bool _newRequest;       // new request started
+  bool _acceptDeflate;    // whether the client accepts deflated responses
   rest::RequestType _requestType;  // type of request (GET, POST, ...)
   std::string _fullUrl;            // value of requested URL
   std::string _origin;  // value of the HTTP origin header the client sent (if
@@ -70,12 +70,18 @@ int RestEngine::run(std::shared_ptr<rest::RestHandler> handler, bool synchronous
         }
         break;
 
-      case State::RUN:
-        res = handler->runEngine(synchronous);
+      case State::RUN: {
+        bool suspended = false;
+        res = handler->runEngine(synchronous, suspended);
         if (res != TRI_ERROR_NO_ERROR) {
           handler->finalizeEngine();
+        } else if (suspended) {
+          // another thread resumes the handler, it must not be touched
+          // any more by this one
+          return TRI_ERROR_NO_ERROR;
         }
         break;
+      }
 
       case State::WAITING:
         return synchronous ? TRI_ERROR_INTERNAL : TRI_ERROR_NO_ERROR;
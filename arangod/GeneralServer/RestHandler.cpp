@@ -25,10 +25,14 @@
 
 #include <velocypack/Exception.h>
 
+#include "Basics/ConditionLocker.h"
+#include "Basics/ConditionVariable.h"
 #include "Basics/StringUtils.h"
 #include "GeneralServer/GeneralCommTask.h"
 #include "Logger/Logger.h"
 #include "Rest/GeneralRequest.h"
+#include "Scheduler/JobGuard.h"
+#include "Scheduler/SchedulerFeature.h"
 #include "Statistics/RequestStatistics.h"
 #include "Utils/ExecContext.h"
 
@@ -233,7 +237,7 @@ int RestHandler::executeEngine() {
   return TRI_ERROR_INTERNAL;
 }
 
-int RestHandler::runEngine(bool synchron) {
+int RestHandler::runEngine(bool synchron, bool& suspended) {
   TRI_ASSERT(ExecContext::CURRENT == nullptr);
   ExecContext::CURRENT = _request->execContext();
   TRI_DEFER(ExecContext::CURRENT = nullptr);
@@ -256,20 +260,35 @@ int RestHandler::runEngine(bool synchron) {
         case RestStatusElement::State::WAIT_FOR:
           if (!synchron) {
             _engine.setState(RestEngine::State::WAITING);
+            suspended = true;
 
+            // the handler does not hold a thread while waiting. It is
+            // resumed in a scheduler thread and not in the thread finishing
+            // the wait, e.g. the one delivering a ClusterComm answer
             std::shared_ptr<RestHandler> self = shared_from_this();
-            result->callWaitFor([self, this]() {
-              _engine.setState(RestEngine::State::RUN);
-              _engine.asyncRun(self);
+            auto resumed = std::make_shared<std::atomic<bool>>(false);
+
+            result->callWaitFor([self, this, resumed]() {
+              if (resumed->exchange(true)) {
+                return;
+              }
+
+              _engine.queue([self, this]() {
+                _engine.setState(RestEngine::State::RUN);
+                _engine.asyncRun(self);
+              });
             });
 
             return TRI_ERROR_NO_ERROR;
           }
 
-          return TRI_ERROR_INTERNAL;
+          waitSynchronously(result);
+          break;
 
         case RestStatusElement::State::QUEUED:
           if (!synchron) {
+            suspended = true;
+
             std::shared_ptr<RestHandler> self = shared_from_this();
             _engine.queue([self, this]() { _engine.asyncRun(self); });
             return TRI_ERROR_NO_ERROR;
@@ -316,6 +335,38 @@ int RestHandler::runEngine(bool synchron) {
   return TRI_ERROR_INTERNAL;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+void RestHandler::waitSynchronously(std::shared_ptr<RestStatusElement> element) {
+  struct Waiter {
+    basics::ConditionVariable _condition;
+    bool _done = false;
+  };
+
+  auto waiter = std::make_shared<Waiter>();
+
+  element->callWaitFor([waiter]() {
+    CONDITION_LOCKER(guard, waiter->_condition);
+    waiter->_done = true;
+    guard.signal();
+  });
+
+  // let the scheduler start another thread while this one is blocked
+  JobGuard jobGuard(SchedulerFeature::SCHEDULER);
+
+  if (SchedulerFeature::SCHEDULER != nullptr) {
+    jobGuard.block();
+  }
+
+  CONDITION_LOCKER(guard, waiter->_condition);
+
+  while (!waiter->_done) {
+    guard.wait(100 * 1000);
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 protected methods
 // -----------------------------------------------------------------------------
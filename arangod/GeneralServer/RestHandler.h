@@ -132,9 +132,13 @@ class RestHandler : public std::enable_shared_from_this<RestHandler> {
 
   int prepareEngine();
   int executeEngine();
-  int runEngine(bool synchron);
+  int runEngine(bool synchron, bool& suspended);
   int finalizeEngine();
 
+ private:
+  // blocks the current thread until a WAIT_FOR step is resumed
+  void waitSynchronously(std::shared_ptr<RestStatusElement>);
+
  private:
   RestEngine _engine;
   std::function<void(rest::RestHandler*)> _storeResult;
@@ -55,6 +55,10 @@ class RestStatusElement {
                     std::function<void(std::function<void()>)> callback)
       : _state(status), _previous(nullptr), _callWaitFor(callback) {}
 
+  RestStatusElement(State status, std::shared_ptr<RestStatusElement> previous,
+                    std::function<void(std::function<void()>)> callback)
+      : _state(status), _previous(previous), _callWaitFor(callback) {}
+
  public:
   std::shared_ptr<RestStatusElement> previous() const { return _previous; }
   bool isLeaf() const { return _previous == nullptr; }
@@ -82,6 +86,10 @@ class RestStatus {
   static RestStatus const FAIL;
   static RestStatus const QUEUE;
 
+  // suspends the handler until the callback calls its argument. The handler
+  // does not hold a thread while it is suspended and continues in a
+  // scheduler thread, so the argument can be called from any thread, e.g.
+  // in a ClusterCommCallback
   static RestStatus WAIT_FOR(
       std::function<void(std::function<void()>)> callback) {
     return RestStatus(
@@ -118,6 +126,12 @@ class RestStatus {
         }));
   }
 
+  RestStatus waitFor(
+      std::function<void(std::function<void()>)> callback) const {
+    return RestStatus(new RestStatusElement(
+        RestStatusElement::State::WAIT_FOR, _element, callback));
+  }
+
   RestStatus done() {
     return RestStatus(
         new RestStatusElement(RestStatusElement::State::DONE, _element));
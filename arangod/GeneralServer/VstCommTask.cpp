@@ -326,12 +326,8 @@ bool VstCommTask::processRead(double startTime) {
   prv._currentChunkLength = 0;  // we have read a complete chunk
   prv._readBufferOffset = std::distance(_readBuffer.begin(), chunkEnd);
 
-  // clean buffer up to length of chunk
-  if (prv._readBufferOffset > prv._cleanupLength) {
-    _readBuffer.move_front(prv._readBufferOffset);
-    prv._readBufferOffset = 0;  // the positon will be set at the
-                                // begin of this function
-  }
+  // the read buffer is cleaned up in compactify(), after all complete
+  // chunks have been processed
 
   if (doExecute) {
     VPackSlice header = message.header();
@@ -422,6 +418,25 @@ bool VstCommTask::processRead(double startTime) {
   return doExecute;
 }
 
+void VstCommTask::compactify() {
+  auto& prv = _processReadVariables;
+
+  if (prv._readBufferOffset == 0) {
+    return;
+  }
+
+  if (prv._readBufferOffset == _readBuffer.length()) {
+    // everything has been processed, nothing to move
+    _readBuffer.reset();
+    prv._readBufferOffset = 0;
+  } else if (prv._readBufferOffset > prv._cleanupLength) {
+    // move the incomplete chunk to the front once instead of after
+    // every processed chunk
+    _readBuffer.move_front(prv._readBufferOffset);
+    prv._readBufferOffset = 0;
+  }
+}
+
 void VstCommTask::closeTask(rest::ResponseCode code) {
   _processReadVariables._readBufferOffset = 0;
   _processReadVariables._currentChunkLength = 0;
@@ -560,8 +575,20 @@ bool VstCommTask::getMessageFromMultiChunks(
     auto& im = incompleteMessageItr->second;  // incomplete Message
     im._currentChunk++;
     TRI_ASSERT(im._currentChunk == chunkHeader._chunk);
-    im._buffer.append(vpackBegin, std::distance(vpackBegin, chunkEnd));
-    // check buffer longer than length
+
+    // the buffer has been sized for the complete message, a chunk
+    // exceeding it would make the buffer reallocate and copy everything
+    // received so far
+    std::size_t chunkLength = std::distance(vpackBegin, chunkEnd);
+    if (im._length > 0 && im._buffer.byteSize() + chunkLength > im._length) {
+      LOG_TOPIC(DEBUG, Logger::COMMUNICATION)
+          << "VstCommTask: "
+          << "chunk exceeds the announced message length";
+      closeTask(rest::ResponseCode::BAD);
+      return false;
+    }
+
+    im._buffer.append(vpackBegin, chunkLength);
 
     // MESSAGE COMPLETE
     if (im._currentChunk == im._numberOfChunks - 1 /* zero based counting */) {
@@ -107,10 +107,43 @@ inline std::unique_ptr<basics::StringBuffer> createChunkForNetworkDetail(
   return buffer;
 }
 
-// helper functions for sending chunks when given a string buffer as input
-// working version of single chunk message creation
+// reads the concatenation of several slices in consecutive pieces,
+// used to fill the chunks of a message without building the complete
+// message first
+class SliceCursor {
+ public:
+  explicit SliceCursor(std::vector<VPackSlice> const& slices)
+      : _slices(slices), _index(0), _offset(0) {}
+
+  void appendTo(basics::StringBuffer* buffer, std::size_t length) {
+    while (length > 0 && _index < _slices.size()) {
+      VPackSlice const& slice = _slices[_index];
+      std::size_t available = slice.byteSize() - _offset;
+      std::size_t n = (std::min)(available, length);
+
+      buffer->appendText(slice.startAs<char>() + _offset, n);
+      length -= n;
+      _offset += n;
+
+      if (_offset == slice.byteSize()) {
+        ++_index;
+        _offset = 0;
+      }
+    }
+
+    TRI_ASSERT(length == 0);
+  }
+
+ private:
+  std::vector<VPackSlice> const& _slices;
+  std::size_t _index;
+  std::size_t _offset;
+};
+
+// working version of single chunk message creation for a part of a
+// multi chunk message
 inline std::unique_ptr<basics::StringBuffer> createChunkForNetworkDetail(
-    char const* data, std::size_t begin, std::size_t end, bool isFirstChunk,
+    SliceCursor& cursor, std::size_t dataLength, bool isFirstChunk,
     uint32_t chunk, uint64_t id, ProtocolVersion protocolVersion,
     uint64_t totalMessageLength) {
   using basics::StringBuffer;
@@ -127,12 +160,9 @@ inline std::unique_ptr<basics::StringBuffer> createChunkForNetworkDetail(
   chunk <<= 1;
   chunk |= isFirstChunk ? 0x1 : 0x0;
 
-  // get the lenght of VPack data
-  uint32_t dataLength = static_cast<uint32_t>(end - begin);
-
   // calculate length of current chunk
-  uint32_t chunkLength =
-      dataLength + static_cast<uint32_t>(chunkHeaderLength(sendTotalLen));
+  uint32_t chunkLength = static_cast<uint32_t>(dataLength) +
+                         static_cast<uint32_t>(chunkHeaderLength(sendTotalLen));
 
   auto buffer =
       std::make_unique<StringBuffer>(TRI_UNKNOWN_MEM_ZONE, chunkLength, false);
@@ -145,21 +175,19 @@ inline std::unique_ptr<basics::StringBuffer> createChunkForNetworkDetail(
     appendLittleEndian(buffer.get(), totalMessageLength);
   }
 
-  buffer->appendText(data + begin, dataLength);
+  cursor.appendTo(buffer.get(), dataLength);
 
   return buffer;
 }
 
-// this function will be called when we send multiple compressed
-// or uncompressed chunks
+// this function will be called when we send multiple chunks, the payload
+// is copied straight from the slices into the chunks
 inline void send_many(
     std::vector<std::unique_ptr<basics::StringBuffer>>& resultVecRef,
     uint64_t id, std::size_t maxChunkBytes,
-    std::unique_ptr<basics::StringBuffer> completeMessage,
-    std::size_t uncompressedCompleteMessageLength,
+    std::vector<VPackSlice> const& slices, std::size_t totalLen,
     ProtocolVersion protocolVersion) {
-  uint64_t totalLen = completeMessage->length();
-  std::size_t offsetBegin = 0;
+  SliceCursor cursor(slices);
   std::size_t offsetEnd = maxChunkBytes - chunkHeaderLength(true);
   // maximum number of bytes for follow up chunks
   std::size_t maxBytes = maxChunkBytes - chunkHeaderLength(false);
@@ -177,30 +205,26 @@ inline void send_many(
     }
   }
 
+  resultVecRef.reserve(numberOfChunks);
+
   // send first
-  resultVecRef.push_back(
-      createChunkForNetworkDetail(completeMessage->c_str(), offsetBegin,
-                                  offsetEnd, true, numberOfChunks, id,
-                                  protocolVersion, totalLen));
+  resultVecRef.push_back(createChunkForNetworkDetail(
+      cursor, offsetEnd, true, numberOfChunks, id, protocolVersion, totalLen));
 
   std::uint32_t chunkNumber = 0;
   while (offsetEnd + maxBytes <= totalLen) {
     // send middle
-    offsetBegin = offsetEnd;
     offsetEnd += maxBytes;
     chunkNumber++;
     resultVecRef.push_back(createChunkForNetworkDetail(
-        completeMessage->c_str(), offsetBegin, offsetEnd, false, chunkNumber,
-        id, protocolVersion, totalLen));
+        cursor, maxBytes, false, chunkNumber, id, protocolVersion, totalLen));
   }
 
   if (offsetEnd < totalLen) {
     resultVecRef.push_back(createChunkForNetworkDetail(
-        completeMessage->c_str(), offsetEnd, totalLen, false, ++chunkNumber,
-        id, protocolVersion, totalLen));
+        cursor, totalLen - offsetEnd, false, ++chunkNumber, id,
+        protocolVersion, totalLen));
   }
-
-  return;
 }
 
 // this function will be called by client code
@@ -230,29 +254,8 @@ inline std::vector<std::unique_ptr<basics::StringBuffer>> createChunkForNetwork(
     LOG_TOPIC(DEBUG, Logger::COMMUNICATION)
         << "VstCommTask: sending multichunk message";
 
-    // TODO: test if we have smaller slices that fit into chunks
-
-    LOG_TOPIC(DEBUG, Logger::COMMUNICATION)
-        << "VstCommTask: there are slices that do not fit into a single "
-           "totalMessageLength or compression is enabled";
-    // we have big slices that do not fit into single chunks
-    // now we will build one big buffer and split it into pieces
-
-    // reserve buffer
-    auto vstPayload = std::make_unique<basics::StringBuffer>(
-        TRI_UNKNOWN_MEM_ZONE, payloadLength, false);
-
-    // fill buffer
-    for (auto const& slice : slices) {
-      try{
-        LOG_TOPIC(TRACE, Logger::COMMUNICATION) << slice.toJson() << " , " << slice.byteSize();
-      } catch(...){}
-      vstPayload->appendText(slice.startAs<char>(), slice.byteSize());
-    }
-
     // create chunks
-    send_many(rv, id, maxChunkBytes, std::move(vstPayload),
-              payloadLength, protocolVersion);
+    send_many(rv, id, maxChunkBytes, slices, payloadLength, protocolVersion);
   }
   return rv;
 }
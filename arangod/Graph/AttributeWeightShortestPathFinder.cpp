@@ -23,8 +23,10 @@
 
 #include "AttributeWeightShortestPathFinder.h"
 
+#include "Aql/AqlValue.h"
 #include "Basics/Exceptions.h"
 #include "Basics/StringRef.h"
+#include "Cluster/ServerState.h"
 #include "Graph/EdgeCursor.h"
 #include "Graph/EdgeDocumentToken.h"
 #include "Graph/ShortestPathOptions.h"
@@ -36,16 +38,19 @@
 #include <velocypack/Slice.h>
 #include <velocypack/velocypack-aliases.h>
 
+#include <cmath>
+
 using namespace arangodb;
 using namespace arangodb::graph;
 
 AttributeWeightShortestPathFinder::Step::Step()
-    : _weight(0.0), _edge(nullptr), _done(false) {}
+    : _weight(0.0), _distance(0.0), _edge(nullptr), _done(false) {}
 
 AttributeWeightShortestPathFinder::Step::Step(
     arangodb::StringRef const& vert, arangodb::StringRef const& pred,
     double weig, std::unique_ptr<EdgeDocumentToken>&& edge)
     : _weight(weig),
+      _distance(weig),
       _vertex(vert),
       _predecessor(pred),
       _edge(edge.release()),
@@ -61,32 +66,37 @@ AttributeWeightShortestPathFinder::Searcher::Searcher(
       _isBackward(isBackward) {}
 
 void AttributeWeightShortestPathFinder::Searcher::insertNeighbor(
-    Step* step, double newWeight) {
+    Step* step, double newDistance) {
   Step* s = _myInfo._pq.find(step->_vertex);
 
   // Not found, so insert it:
   if (s == nullptr) {
-    step->setWeight(newWeight);
+    step->setDistance(newDistance);
+    step->setWeight(newDistance + _pathFinder->estimate(step->_vertex));
     _myInfo._pq.insert(step->_vertex, step);
     return;
   }
-  if (!s->_done && s->weight() > newWeight) {
+  if (!s->_done && s->distance() > newDistance) {
     s->_predecessor = step->_predecessor;
     s->_edge.swap(step->_edge);
+    // the estimate of a vertex does not change, so the priority is lowered
+    // by exactly the same amount as the distance
+    double newWeight = s->weight() - (s->distance() - newDistance);
+    s->setDistance(newDistance);
     _myInfo._pq.lowerWeight(s->_vertex, newWeight);
   }
   delete step;
 }
 
 void AttributeWeightShortestPathFinder::Searcher::lookupPeer(
-    arangodb::StringRef& vertex, double weight) {
+    arangodb::StringRef& vertex, double distance) {
   Step* s = _peerInfo._pq.find(vertex);
 
   if (s == nullptr) {
     // Not found, nothing more to do
     return;
   }
-  double total = s->weight() + weight;
+  double total = s->distance() + distance;
 
   // Update the highscore:
   if (!_pathFinder->_highscoreSet || total < _pathFinder->_highscore) {
@@ -116,7 +126,7 @@ void AttributeWeightShortestPathFinder::Searcher::lookupPeer(
   // Did we find a solution on our own? This is for the
   // single thread case and for the case that the other
   // thread is too slow to even finish its own start vertex!
-  if (s->weight() == 0) {
+  if (s->distance() == 0) {
     // We have found the target, we have finished all
     // vertices with a smaller weight than this one (and did
     // not succeed), so this must be a best solution:
@@ -146,9 +156,9 @@ bool AttributeWeightShortestPathFinder::Searcher::oneStep() {
   std::vector<Step*> neighbors;
   _pathFinder->expandVertex(_isBackward, v, neighbors);
   for (Step* neighbor : neighbors) {
-    insertNeighbor(neighbor, s->weight() + neighbor->weight());
+    insertNeighbor(neighbor, s->distance() + neighbor->distance());
   }
-  lookupPeer(v, s->weight());
+  lookupPeer(v, s->distance());
 
   Step* s2 = _myInfo._pq.find(v);
   s2->_done = true;
@@ -164,6 +174,8 @@ AttributeWeightShortestPathFinder::AttributeWeightShortestPathFinder(
       _intermediateSet(false),
       _intermediate(),
       _mmdr(new ManagedDocumentResult{}),
+      _useHeuristic(false),
+      _targetCoordinates{0.0, 0.0, false},
       _options(options) {}
 
 AttributeWeightShortestPathFinder::~AttributeWeightShortestPathFinder(){};
@@ -182,6 +194,19 @@ bool AttributeWeightShortestPathFinder::shortestPath(
   StringRef start = _options->cache()->persistString(StringRef(st));
   StringRef target = _options->cache()->persistString(StringRef(ta));
 
+  // The coordinator does not have the vertex documents at hand while
+  // searching, so it cannot compute the estimates
+  _useHeuristic = _options->useHeuristic() &&
+                  !ServerState::instance()->isCoordinator();
+  if (_useHeuristic) {
+    _targetCoordinates = coordinates(target);
+    // without a location of the target there is nothing to aim for
+    _useHeuristic = _targetCoordinates.valid;
+  }
+  // An A* search only gives the shortest path when it runs from the start
+  // all the way to the target, so it does not search from both sides
+  bool const bidirectional = _options->bidirectional && !_useHeuristic;
+
   // Forward with initialization:
   arangodb::StringRef emptyVertex;
   ThreadInfo forward;
@@ -194,7 +219,7 @@ bool AttributeWeightShortestPathFinder::shortestPath(
   // Now the searcher threads:
   Searcher forwardSearcher(this, forward, backward, start, false);
   std::unique_ptr<Searcher> backwardSearcher;
-  if (_options->bidirectional) {
+  if (bidirectional) {
     backwardSearcher.reset(new Searcher(this, backward, forward, target, true));
   }
 
@@ -208,7 +233,7 @@ bool AttributeWeightShortestPathFinder::shortestPath(
     if (!forwardSearcher.oneStep()) {
       break;
     }
-    if (_options->bidirectional && !backwardSearcher->oneStep()) {
+    if (bidirectional && !backwardSearcher->oneStep()) {
       break;
     }
 
@@ -269,6 +294,7 @@ void AttributeWeightShortestPathFinder::inserter(
     auto oldWeight = old->weight();
     if (currentWeight < oldWeight) {
       old->setWeight(currentWeight);
+      old->setDistance(currentWeight);
       old->_predecessor = s;
       old->_edge.swap(edge);
     }
@@ -302,7 +328,13 @@ void AttributeWeightShortestPathFinder::expandVertex(
       StringRef toTmp(transaction::helpers::extractToFromDocument(edge));
       StringRef from = _options->cache()->persistString(fromTmp);
       StringRef to = _options->cache()->persistString(toTmp);
-      double currentWeight = _options->weightEdge(edge);
+      VPackSlice doc = edge;
+      if (BaseOptions::isPartialEdge(edge) &&
+          !edge.hasKey(_options->weightAttribute)) {
+        // the edge index does not store the weight inline
+        doc = _options->cache()->lookupToken(eid.get());
+      }
+      double currentWeight = _options->weightEdge(doc);
       if (from == vertex) {
         inserter(candidates, result, from, to, currentWeight, std::move(eid));
       } else {
@@ -314,6 +346,61 @@ void AttributeWeightShortestPathFinder::expandVertex(
   edgeCursor->readAll(callback);
 }
 
+double AttributeWeightShortestPathFinder::estimate(StringRef const& vertex) {
+  if (!_useHeuristic) {
+    return 0.0;
+  }
+
+  Coordinates const& c = coordinates(vertex);
+  if (!c.valid) {
+    return 0.0;
+  }
+
+  auto toRadians = [](double degrees) -> double {
+    return degrees * (std::acos(-1.0) / 180.0);
+  };
+
+  double p1 = toRadians(c.latitude);
+  double p2 = toRadians(_targetCoordinates.latitude);
+  double d1 = toRadians(_targetCoordinates.latitude - c.latitude);
+  double d2 = toRadians(_targetCoordinates.longitude - c.longitude);
+
+  double a = std::sin(d1 / 2.0) * std::sin(d1 / 2.0) +
+             std::cos(p1) * std::cos(p2) *
+             std::sin(d2 / 2.0) * std::sin(d2 / 2.0);
+
+  double const EARTHRADIAN = 6371000.0; // metres
+  double distance =
+      EARTHRADIAN * 2.0 * std::atan2(std::sqrt(a), std::sqrt(1.0 - a));
+
+  return distance * _options->heuristicFactor;
+}
+
+AttributeWeightShortestPathFinder::Coordinates const&
+AttributeWeightShortestPathFinder::coordinates(StringRef const& vertex) {
+  auto it = _coordinates.find(vertex);
+  if (it != _coordinates.end()) {
+    return it->second;
+  }
+
+  Coordinates c{0.0, 0.0, false};
+  aql::AqlValue doc = _options->cache()->fetchAqlResult(vertex);
+  aql::AqlValueGuard guard(doc, true);
+  VPackSlice slice = doc.slice();
+  if (slice.isObject()) {
+    // same format as a geo index on a single attribute: [latitude, longitude]
+    VPackSlice location = slice.get(_options->heuristicAttribute);
+    if (location.isArray() && location.length() == 2 &&
+        location.at(0).isNumber() && location.at(1).isNumber()) {
+      c.latitude = location.at(0).getNumber<double>();
+      c.longitude = location.at(1).getNumber<double>();
+      c.valid = true;
+    }
+  }
+
+  return _coordinates.emplace(vertex, c).first->second;
+}
+
 /*
 AttributeWeightShortestPathFinder::SearcherTwoThreads::SearcherTwoThreads(
     AttributeWeightShortestPathFinder* pathFinder, ThreadInfo& myInfo,
@@ -51,6 +51,7 @@ class AttributeWeightShortestPathFinder : public ShortestPathFinder {
   struct Step {
    private:
     double _weight;
+    double _distance;
 
    public:
     arangodb::StringRef _vertex;
@@ -64,10 +65,17 @@ class AttributeWeightShortestPathFinder : public ShortestPathFinder {
          arangodb::StringRef const& pred, double weig,
          std::unique_ptr<EdgeDocumentToken>&& edge);
 
+    /// @brief the priority in the queue, i.e. the distance plus the
+    /// estimated remaining distance if a heuristic is used
     double weight() const { return _weight; }
 
     void setWeight(double w) { _weight = w; }
 
+    /// @brief the distance from the start of the search
+    double distance() const { return _distance; }
+
+    void setDistance(double d) { _distance = d; }
+
     arangodb::StringRef const& getKey() const { return _vertex; }
   };
 
@@ -172,13 +180,13 @@ class AttributeWeightShortestPathFinder : public ShortestPathFinder {
     /// @brief Insert a neighbor to the todo list.
     ////////////////////////////////////////////////////////////////////////////////
 
-    void insertNeighbor(Step* step, double newWeight);
+    void insertNeighbor(Step* step, double newDistance);
 
     ////////////////////////////////////////////////////////////////////////////////
     /// @brief Lookup our current vertex in the data of our peer.
     ////////////////////////////////////////////////////////////////////////////////
 
-    void lookupPeer(arangodb::StringRef& vertex, double weight);
+    void lookupPeer(arangodb::StringRef& vertex, double distance);
 
    private:
     AttributeWeightShortestPathFinder* _pathFinder;
@@ -228,6 +236,13 @@ class AttributeWeightShortestPathFinder : public ShortestPathFinder {
   void expandVertex(bool isBackward, arangodb::StringRef const& source,
                     std::vector<Step*>& result);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief lower bound for the distance from the vertex to the target of
+  ///        the current search, 0 if no heuristic is used
+  //////////////////////////////////////////////////////////////////////////////
+
+  double estimate(arangodb::StringRef const& vertex);
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief return the shortest path between the start and target vertex,
   /// multi-threaded version using SearcherTwoThreads.
@@ -290,8 +305,37 @@ class AttributeWeightShortestPathFinder : public ShortestPathFinder {
 
  private:
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief latitude and longitude of a vertex, taken from the heuristic
+  ///        attribute
+  //////////////////////////////////////////////////////////////////////////////
+
+  struct Coordinates {
+    double latitude;
+    double longitude;
+    bool valid;
+  };
+
+  Coordinates const& coordinates(arangodb::StringRef const& vertex);
+
   std::unique_ptr<ManagedDocumentResult> _mmdr;
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief whether the search is an A* search towards the target
+  //////////////////////////////////////////////////////////////////////////////
+
+  bool _useHeuristic;
+
+  Coordinates _targetCoordinates;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief coordinates of all vertices seen so far. The vertex ids are
+  ///        persisted in the cache for the whole query, so this is kept
+  ///        across searches and every vertex document is read only once.
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::unordered_map<arangodb::StringRef, Coordinates> _coordinates;
+
   ShortestPathOptions* _options;
 };
 
@@ -32,6 +32,7 @@
 #include "Graph/TraverserCache.h"
 #include "Graph/TraverserCacheFactory.h"
 #include "Indexes/Index.h"
+#include "Transaction/Helpers.h"
 #include "VocBase/TraverserOptions.h"
 
 #include <velocypack/Builder.h>
@@ -47,7 +48,9 @@ BaseOptions::LookupInfo::LookupInfo()
     : expression(nullptr),
       indexCondition(nullptr),
       conditionNeedUpdate(false),
-      conditionMemberToUpdate(0) {
+      conditionMemberToUpdate(0),
+      expressionUsesWholeEdge(false),
+      expressionAttributesKnown(false) {
   // NOTE: We need exactly one in this case for the optimizer to update
   idxHandles.resize(1);
 };
@@ -60,7 +63,8 @@ BaseOptions::LookupInfo::~LookupInfo() {
 
 BaseOptions::LookupInfo::LookupInfo(arangodb::aql::Query* query,
                                     VPackSlice const& info,
-                                    VPackSlice const& shards) {
+                                    VPackSlice const& shards)
+    : expressionUsesWholeEdge(false), expressionAttributesKnown(false) {
   TRI_ASSERT(shards.isArray());
   idxHandles.reserve(shards.length());
 
@@ -114,7 +118,9 @@ BaseOptions::LookupInfo::LookupInfo(LookupInfo const& other)
       expression(nullptr),
       indexCondition(other.indexCondition),
       conditionNeedUpdate(other.conditionNeedUpdate),
-      conditionMemberToUpdate(other.conditionMemberToUpdate) {
+      conditionMemberToUpdate(other.conditionMemberToUpdate),
+      expressionUsesWholeEdge(false),
+      expressionAttributesKnown(false) {
   if (other.expression != nullptr) {
     expression = other.expression->clone(nullptr);
   }
@@ -158,6 +164,29 @@ double BaseOptions::LookupInfo::estimateCost(size_t& nrItems) const {
   return 1000.0;
 }
 
+bool BaseOptions::LookupInfo::expressionCoveredBy(
+    VPackSlice partialEdge, aql::Variable const* edgeVariable) const {
+  TRI_ASSERT(partialEdge.isObject());
+  if (expression == nullptr) {
+    return true;
+  }
+  if (!expressionAttributesKnown) {
+    expressionAttributes.clear();
+    expressionUsesWholeEdge = !aql::Ast::getReferencedAttributes(
+        expression->node(), edgeVariable, expressionAttributes);
+    expressionAttributesKnown = true;
+  }
+  if (expressionUsesWholeEdge) {
+    return false;
+  }
+  for (auto const& it : expressionAttributes) {
+    if (!partialEdge.hasKey(it)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 std::unique_ptr<BaseOptions> BaseOptions::createOptionsFromSlice(
     transaction::Methods* trx, VPackSlice const& definition) {
   VPackSlice type = definition.get("type");
@@ -323,6 +352,13 @@ arangodb::graph::TraverserCache* BaseOptions::cache() const {
   return _cache.get();
 }
 
+bool BaseOptions::isPartialEdge(VPackSlice edge) {
+  // complete edge documents always carry a _key, the attributes stored by
+  // the edge index never do
+  return edge.isObject() &&
+         transaction::helpers::extractKeyFromDocument(edge).isNone();
+}
+
 void BaseOptions::injectVelocyPackIndexes(VPackBuilder& builder) const {
   TRI_ASSERT(builder.isOpenObject());
 
@@ -62,6 +62,12 @@ struct BaseOptions {
     bool conditionNeedUpdate;
     // Position of _from / _to in the index search condition
     size_t conditionMemberToUpdate;
+    // Top-level edge attributes accessed by the expression, determined
+    // on first use
+    mutable std::unordered_set<std::string> expressionAttributes;
+    // Flag if the expression uses the edge other than by attribute access
+    mutable bool expressionUsesWholeEdge;
+    mutable bool expressionAttributesKnown;
 
     LookupInfo();
     ~LookupInfo();
@@ -76,6 +82,11 @@ struct BaseOptions {
     void buildEngineInfo(arangodb::velocypack::Builder&) const;
 
     double estimateCost(size_t& nrItems) const;
+
+    /// @brief whether or not the expression can be evaluated on the given
+    ///        partial edge, i.e. all attributes it accesses are present
+    bool expressionCoveredBy(arangodb::velocypack::Slice partialEdge,
+                             aql::Variable const* edgeVariable) const;
   };
 
  public:
@@ -112,6 +123,11 @@ struct BaseOptions {
 
   TraverserCache* cache() const;
 
+  /// @brief whether or not an edge handed out by an edge cursor only holds
+  ///        the attributes stored inline in the edge index instead of the
+  ///        complete edge document
+  static bool isPartialEdge(arangodb::velocypack::Slice edge);
+
   /// @brief Build a velocypack for cloning in the plan.
   virtual void toVelocyPack(arangodb::velocypack::Builder&) const = 0;
 
@@ -46,11 +46,6 @@ BreadthFirstEnumerator::PathStep::PathStep(
 
 BreadthFirstEnumerator::PathStep::~PathStep() {}
 
-BreadthFirstEnumerator::PathStep::PathStep(PathStep& other)
-    : sourceIdx(other.sourceIdx),
-      edge(other.edge.release()),
-      vertex(other.vertex) {}
-
 BreadthFirstEnumerator::BreadthFirstEnumerator(Traverser* traverser,
                                                VPackSlice startVertex,
                                                TraverserOptions* opts)
@@ -62,7 +57,7 @@ BreadthFirstEnumerator::BreadthFirstEnumerator(Traverser* traverser,
   _schreier.reserve(32);
   StringRef startVId = _opts->cache()->persistString(StringRef(startVertex));
 
-  _schreier.emplace_back(std::make_unique<PathStep>(startVId));
+  _schreier.emplace_back(startVId);
   _toSearch.emplace_back(NextStep(0));
 }
 
@@ -112,6 +107,16 @@ bool BreadthFirstEnumerator::next() {
       TRI_ASSERT(_toSearchPos < _toSearch.size());
       TRI_ASSERT(_nextDepth.empty());
       TRI_ASSERT(_currentDepth < _opts->maxDepth);
+
+      if (_toSearch.size() > 1) {
+        // let the cache fetch the edges of the whole depth at once
+        std::vector<StringRef> vertices;
+        vertices.reserve(_toSearch.size());
+        for (auto const& step : _toSearch) {
+          vertices.emplace_back(_schreier[step.sourceIdx].vertex);
+        }
+        _opts->cache()->prefetchEdges(vertices, _currentDepth);
+      }
     }
     // This access is always safe.
     // If not it should have bailed out before.
@@ -119,9 +124,15 @@ bool BreadthFirstEnumerator::next() {
 
     _tmpEdges.clear();
     auto const nextIdx = _toSearch[_toSearchPos++].sourceIdx;
-    auto const nextVertex = _schreier[nextIdx]->vertex;
+    auto const nextVertex = _schreier[nextIdx].vertex;
     StringRef vId;
 
+    if (_traverser->isPrunedVertex(nextVertex)) {
+      // The path to this vertex has been returned already,
+      // but it must not be continued.
+      continue;
+    }
+
     std::unique_ptr<EdgeCursor> cursor(
         _opts->nextCursor(_traverser->mmdr(), nextVertex, _currentDepth));
     if (cursor != nullptr) {
@@ -133,7 +144,7 @@ bool BreadthFirstEnumerator::next() {
         
         if (_opts->hasEdgeFilter(_currentDepth, cursorIdx)) {
           VPackSlice edge = e;
-          if (edge.isString()) {
+          if (!_opts->edgeFilterCoveredBy(edge, _currentDepth, cursorIdx)) {
             edge = _opts->cache()->lookupToken(eid.get());
           }
           if (!_traverser->edgeMatchesConditions(edge, nextVertex, _currentDepth,
@@ -143,8 +154,7 @@ bool BreadthFirstEnumerator::next() {
         }
 
         if (_traverser->getSingleVertex(e, nextVertex, _currentDepth, vId)) {
-          _schreier.emplace_back(
-              std::make_unique<PathStep>(nextIdx, std::move(eid), vId));
+          _schreier.emplace_back(nextIdx, std::move(eid), vId);
           if (_currentDepth < _opts->maxDepth - 1) {
             _nextDepth.emplace_back(NextStep(_schreierIndex));
           }
@@ -178,7 +188,7 @@ bool BreadthFirstEnumerator::next() {
 arangodb::aql::AqlValue BreadthFirstEnumerator::lastVertexToAqlValue() {
   TRI_ASSERT(_lastReturned < _schreier.size());
   return _traverser->fetchVertexData(
-      StringRef(_schreier[_lastReturned]->vertex));
+      StringRef(_schreier[_lastReturned].vertex));
 }
 
 arangodb::aql::AqlValue BreadthFirstEnumerator::lastEdgeToAqlValue() {
@@ -188,7 +198,7 @@ arangodb::aql::AqlValue BreadthFirstEnumerator::lastEdgeToAqlValue() {
     return arangodb::aql::AqlValue(
         arangodb::basics::VelocyPackHelper::NullValue());
   }
-  return _opts->cache()->fetchAqlResult(_schreier[_lastReturned]->edge.get());
+  return _opts->cache()->fetchAqlResult(_schreier[_lastReturned].edge.get());
 }
 
 arangodb::aql::AqlValue BreadthFirstEnumerator::pathToAqlValue(
@@ -200,23 +210,27 @@ arangodb::aql::AqlValue BreadthFirstEnumerator::pathToAqlValue(
     // Walk backwards through the path and push everything found on the local
     // stack
     fullPath.emplace_front(cur);
-    cur = _schreier[cur]->sourceIdx;
+    cur = _schreier[cur].sourceIdx;
   }
 
   result.clear();
   result.openObject();
   result.add(VPackValue("edges"));
   result.openArray();
-  for (auto const& idx : fullPath) {
-    _opts->cache()->insertIntoResult(_schreier[idx]->edge.get(), result);
+  if (_opts->producePathsEdges) {
+    for (auto const& idx : fullPath) {
+      _opts->cache()->insertIntoResult(_schreier[idx].edge.get(), result);
+    }
   }
   result.close();  // edges
   result.add(VPackValue("vertices"));
   result.openArray();
-  // Always add the start vertex
-  _traverser->addVertexToVelocyPack(_schreier[0]->vertex, result);
-  for (auto const& idx : fullPath) {
-    _traverser->addVertexToVelocyPack(_schreier[idx]->vertex, result);
+  if (_opts->producePathsVertices) {
+    // Always add the start vertex
+    _traverser->addVertexToVelocyPack(_schreier[0].vertex, result);
+    for (auto const& idx : fullPath) {
+      _traverser->addVertexToVelocyPack(_schreier[idx].vertex, result);
+    }
   }
   result.close();  // vertices
   result.close();
@@ -46,7 +46,7 @@ class BreadthFirstEnumerator final
   struct PathStep {
     size_t sourceIdx;
     std::unique_ptr<graph::EdgeDocumentToken> edge;
-    arangodb::StringRef const vertex;
+    arangodb::StringRef vertex;
 
    public:
     explicit PathStep(arangodb::StringRef const vertex);
@@ -56,7 +56,8 @@ class BreadthFirstEnumerator final
 
     ~PathStep();
 
-    PathStep(PathStep& other);
+    PathStep(PathStep&& other) = default;
+    PathStep& operator=(PathStep&& other) = default;
   };
 
   //////////////////////////////////////////////////////////////////////////////
@@ -75,10 +76,11 @@ class BreadthFirstEnumerator final
   };
 
   //////////////////////////////////////////////////////////////////////////////
-  /// @brief schreier vector to store the visited vertices
+  /// @brief schreier vector to store the visited vertices. The steps are
+  ///        stored inline, not as one allocation per step
   //////////////////////////////////////////////////////////////////////////////
 
-  std::vector<std::unique_ptr<PathStep>> _schreier;
+  std::vector<PathStep> _schreier;
 
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Next free index in schreier vector.
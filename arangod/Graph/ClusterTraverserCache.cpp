@@ -23,8 +23,10 @@
 #include "ClusterTraverserCache.h"
 
 #include "Aql/AqlValue.h"
+#include "Basics/Exceptions.h"
 #include "Basics/StringRef.h"
 #include "Basics/VelocyPackHelper.h"
+#include "Cluster/ClusterMethods.h"
 #include "Graph/EdgeDocumentToken.h"
 #include "Transaction/Methods.h"
 
@@ -40,7 +42,11 @@ using namespace arangodb::graph;
 ClusterTraverserCache::ClusterTraverserCache(
     transaction::Methods* trx,
     std::unordered_map<ServerID, traverser::TraverserEngineID> const* engines)
-    : TraverserCache(trx), _engines(engines) {}
+    : TraverserCache(trx),
+      _prefetchedShortestPath(false),
+      _prefetchedDepth(0),
+      _prefetchedBackward(false),
+      _engines(engines) {}
 
 ClusterTraverserCache::~ClusterTraverserCache() {}
 
@@ -105,3 +111,154 @@ size_t& ClusterTraverserCache::insertedDocuments() {
 size_t& ClusterTraverserCache::filteredDocuments() {
   return _filteredDocuments;
 }
+
+void ClusterTraverserCache::prefetchEdges(std::vector<StringRef> const& vertexIds,
+                                          uint64_t depth) {
+  _prefetchedShortestPath = false;
+  _prefetchedDepth = depth;
+
+  prefetch(vertexIds, [&](EngineMap const* engines,
+                          std::vector<StringRef> const& batch,
+                          EdgesByVertex& result, VPackBuilder& builder) {
+    return prefetchEdgesFromEngines(
+        _trx->databaseName(), engines, batch, depth, _edges, result,
+        _datalake, builder, _filteredDocuments, _insertedDocuments);
+  });
+}
+
+void ClusterTraverserCache::prefetchShortestPathEdges(
+    std::vector<StringRef> const& vertexIds, bool backward) {
+  _prefetchedShortestPath = true;
+  _prefetchedBackward = backward;
+
+  prefetch(vertexIds, [&](EngineMap const* engines,
+                          std::vector<StringRef> const& batch,
+                          EdgesByVertex& result, VPackBuilder& builder) {
+    return prefetchEdgesFromEngines(_trx->databaseName(), engines, batch,
+                                    backward, _edges, result, _datalake,
+                                    builder, _insertedDocuments);
+  });
+}
+
+bool ClusterTraverserCache::prefetchedEdges(StringRef vertexId, uint64_t depth,
+                                            std::vector<VPackSlice>& result) const {
+  if (_prefetchedShortestPath || depth != _prefetchedDepth) {
+    return false;
+  }
+  return lookupPrefetched(vertexId, result);
+}
+
+bool ClusterTraverserCache::prefetchedShortestPathEdges(
+    StringRef vertexId, bool backward, std::vector<VPackSlice>& result) const {
+  if (!_prefetchedShortestPath || backward != _prefetchedBackward) {
+    return false;
+  }
+  return lookupPrefetched(vertexId, result);
+}
+
+void ClusterTraverserCache::prefetch(
+    std::vector<StringRef> const& vertexIds,
+    std::function<int(EngineMap const*, std::vector<StringRef> const&,
+                      EdgesByVertex&, VPackBuilder&)> const& fetch) {
+  _prefetched.clear();
+
+  // vertices are grouped by the engines that have to be asked for them,
+  // which is a single one per vertex if the edge locality is known
+  std::unordered_set<StringRef> requested;
+  std::unordered_map<EngineMap const*, std::vector<StringRef>> batches;
+  EdgesByVertex result;
+  VPackBuilder builder;
+
+  auto flush = [&](EngineMap const* engines, std::vector<StringRef>& batch) {
+    int res = fetch(engines, batch, result, builder);
+    if (res != TRI_ERROR_NO_ERROR) {
+      THROW_ARANGO_EXCEPTION(res);
+    }
+    for (auto& it : result) {
+      _prefetched.emplace(it.first, std::move(it.second));
+    }
+    batch.clear();
+  };
+
+  for (auto const& v : vertexIds) {
+    if (!requested.emplace(v).second) {
+      // vertex is already part of the prefetch
+      continue;
+    }
+    auto engines = enginesForVertex(v);
+    auto& batch = batches[engines];
+    batch.emplace_back(v);
+    if (batch.size() >= PREFETCH_BATCH_SIZE) {
+      flush(engines, batch);
+    }
+  }
+
+  for (auto& it : batches) {
+    if (!it.second.empty()) {
+      flush(it.first, it.second);
+    }
+  }
+}
+
+bool ClusterTraverserCache::lookupPrefetched(
+    StringRef vertexId, std::vector<VPackSlice>& result) const {
+  auto it = _prefetched.find(vertexId);
+  if (it == _prefetched.end()) {
+    return false;
+  }
+  result = it->second;
+  return true;
+}
+
+void ClusterTraverserCache::setEdgeLocality(
+    std::vector<EdgeLocality>&& localities) {
+  _localities = std::move(localities);
+  _singleEngines.clear();
+}
+
+std::unordered_map<ServerID, traverser::TraverserEngineID> const*
+ClusterTraverserCache::enginesForVertex(StringRef vertexId) {
+  if (_localities.empty() || _engines == nullptr) {
+    return _engines;
+  }
+
+  auto ci = ClusterInfo::instance();
+  ServerID server;
+  VPackBuilder doc;
+
+  for (auto const& it : _localities) {
+    doc.clear();
+    doc.openObject();
+    doc.add(it.attribute,
+            VPackValuePair(vertexId.data(), vertexId.length(),
+                           VPackValueType::String));
+    doc.close();
+
+    ShardID shard;
+    bool usesDefaultShardingAttributes;
+    int res = ci->getResponsibleShard(it.collection.get(), doc.slice(), false,
+                                      shard, usesDefaultShardingAttributes);
+    if (res != TRI_ERROR_NO_ERROR) {
+      return _engines;
+    }
+
+    auto servers = ci->getResponsibleServer(shard);
+    if (servers->empty() || (!server.empty() && server != servers->front())) {
+      // edges are spread over several servers, ask everyone
+      return _engines;
+    }
+    server = servers->front();
+  }
+
+  auto engine = _engines->find(server);
+  if (engine == _engines->end()) {
+    // no engine on the responsible server, e.g. during a failover
+    return _engines;
+  }
+
+  auto& single = _singleEngines[server];
+  if (single.empty()) {
+    single.emplace(engine->first, engine->second);
+  }
+  return &single;
+}
@@ -29,6 +29,7 @@
 
 namespace arangodb {
 
+class LogicalCollection;
 class StringRef;
 
 namespace aql {
@@ -47,6 +48,15 @@ class Slice;
 namespace graph {
 
 class ClusterTraverserCache : public TraverserCache {
+ public:
+  /// @brief an edge collection in which all edges of a vertex in the
+  ///        traversed direction are stored in the same shard, because the
+  ///        collection is sharded by _from (outbound) or _to (inbound)
+  struct EdgeLocality {
+    std::shared_ptr<LogicalCollection> collection;
+    std::string attribute;
+  };
+
  public:
   ClusterTraverserCache(
       transaction::Methods* trx,
@@ -88,12 +98,90 @@ class ClusterTraverserCache : public TraverserCache {
   
   arangodb::velocypack::Slice lookupToken(EdgeDocumentToken const* token) override;
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Fetches the edges of all given vertices with one request per
+  ///        DBServer and batch, instead of one request per vertex
+  //////////////////////////////////////////////////////////////////////////////
+
+  void prefetchEdges(std::vector<StringRef> const& vertexIds,
+                     uint64_t depth) override;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Returns the prefetched edges of the vertex at the given depth.
+  ///        Returns false if they were not prefetched.
+  //////////////////////////////////////////////////////////////////////////////
+
+  bool prefetchedEdges(StringRef vertexId, uint64_t depth,
+                       std::vector<arangodb::velocypack::Slice>& result) const;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Shortest path variants of prefetchEdges and prefetchedEdges
+  //////////////////////////////////////////////////////////////////////////////
+
+  void prefetchShortestPathEdges(std::vector<StringRef> const& vertexIds,
+                                 bool backward) override;
+
+  bool prefetchedShortestPathEdges(
+      StringRef vertexId, bool backward,
+      std::vector<arangodb::velocypack::Slice>& result) const;
+
+  /// @brief maximum number of vertices sent to the DBServers in one request
+  static size_t const PREFETCH_BATCH_SIZE = 1000;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Declares that all traversed edge collections are sharded by the
+  ///        vertex the edges are followed from. Edges of a vertex are then
+  ///        only requested from the one DBServer holding them.
+  //////////////////////////////////////////////////////////////////////////////
+
+  void setEdgeLocality(std::vector<EdgeLocality>&& localities);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Returns the engines that have to be asked for the edges of the
+  ///        given vertex. These are all engines unless the edge locality
+  ///        is known.
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::unordered_map<ServerID, traverser::TraverserEngineID> const*
+  enginesForVertex(StringRef vertexId);
+
+ private:
+  typedef std::unordered_map<ServerID, traverser::TraverserEngineID> EngineMap;
+  typedef std::unordered_map<StringRef,
+                             std::vector<arangodb::velocypack::Slice>>
+      EdgesByVertex;
+
+  void prefetch(
+      std::vector<StringRef> const& vertexIds,
+      std::function<int(EngineMap const*, std::vector<StringRef> const&,
+                        EdgesByVertex&, arangodb::velocypack::Builder&)> const&
+          fetch);
+
+  bool lookupPrefetched(StringRef vertexId,
+                        std::vector<arangodb::velocypack::Slice>& result) const;
+
  private:
   std::unordered_map<StringRef, arangodb::velocypack::Slice> _edges;
 
+  /// @brief edges of the vertices of the last prefetch, by vertex
+  EdgesByVertex _prefetched;
+
+  /// @brief what the last prefetch was for: the depth of a traversal, or the
+  ///        direction of a shortest path search
+  bool _prefetchedShortestPath;
+  uint64_t _prefetchedDepth;
+  bool _prefetchedBackward;
+
   std::vector<std::shared_ptr<arangodb::velocypack::Builder>> _datalake;
 
   std::unordered_map<ServerID, traverser::TraverserEngineID> const* _engines;
+
+  std::vector<EdgeLocality> _localities;
+
+  /// @brief single-engine maps handed out by enginesForVertex, by server
+  std::unordered_map<ServerID,
+                     std::unordered_map<ServerID, traverser::TraverserEngineID>>
+      _singleEngines;
 };
 
 }  // namespace graph
@@ -86,7 +86,7 @@ bool ConstantWeightShortestPathFinder::shortestPath(
   while (!_leftClosure.empty() && !_rightClosure.empty()) {
     callback();
 
-    if (_leftClosure.size() < _rightClosure.size()) {
+    if (expandLeft()) {
       if (expandClosure(_leftClosure, _leftFound, _rightFound, false, n)) {
         fillResult(n, result);
         return true;
@@ -101,12 +101,43 @@ bool ConstantWeightShortestPathFinder::shortestPath(
   return false;
 }
 
+bool ConstantWeightShortestPathFinder::expandLeft() const {
+  uint64_t leftCost;
+  uint64_t rightCost;
+  if (expansionCost(_leftClosure, false, leftCost) &&
+      expansionCost(_rightClosure, true, rightCost)) {
+    // expand the side that reads fewer edges, so that the search
+    // does not run into a supernode while the other side is cheap
+    return leftCost < rightCost;
+  }
+  return _leftClosure.size() < _rightClosure.size();
+}
+
+bool ConstantWeightShortestPathFinder::expansionCost(Closure const& closure,
+                                                     bool isBackward,
+                                                     uint64_t& cost) const {
+  cost = 0;
+  for (auto const& v : closure) {
+    uint64_t degree;
+    if (!_options->estimateDegree(v, isBackward, degree)) {
+      return false;
+    }
+    cost += degree;
+  }
+  return true;
+}
+
 bool ConstantWeightShortestPathFinder::expandClosure(Closure& sourceClosure,
                                                      Snippets& sourceSnippets,
                                                      Snippets& targetSnippets,
                                                      bool isBackward,
                                                      StringRef& result) {
   _nextClosure.clear();
+  if (sourceClosure.size() > 1) {
+    // let the cache fetch the edges of the whole frontier at once
+    std::vector<StringRef> vertices(sourceClosure.begin(), sourceClosure.end());
+    _options->cache()->prefetchShortestPathEdges(vertices, isBackward);
+  }
   for (auto& v : sourceClosure) {
     _edges.clear();
     _neighbors.clear();
@@ -116,13 +147,14 @@ bool ConstantWeightShortestPathFinder::expandClosure(Closure& sourceClosure,
 
     for (size_t i = 0; i < neighborsSize; ++i) {
       auto const& n = _neighbors[i];
-      if (sourceSnippets.find(n) == sourceSnippets.end()) {
+      // insert a placeholder first, so the vertex is hashed only once
+      auto inserted = sourceSnippets.emplace(n, nullptr);
+      if (inserted.second) {
         // NOTE: _edges[i] stays intact after move
         // and is reset to a nullptr. So if we crash
         // here no mem-leaks. or undefined behavior
         // Just make sure _edges is not used after
-        sourceSnippets.emplace(
-            n, new PathSnippet(v, std::move(_edges[i])));
+        inserted.first->second = new PathSnippet(v, std::move(_edges[i]));
         auto targetFoundIt = targetSnippets.find(n);
         if (targetFoundIt != targetSnippets.end()) {
           result = n;
@@ -74,6 +74,13 @@ class ConstantWeightShortestPathFinder : public ShortestPathFinder {
 
   void clearVisited();
 
+  /// @brief whether to expand the left closure next. compares the estimated
+  /// number of edges of both frontiers and falls back to their sizes
+  bool expandLeft() const;
+
+  bool expansionCost(Closure const& closure, bool isBackward,
+                     uint64_t& cost) const;
+
   bool expandClosure(Closure& sourceClosure, Snippets& sourceSnippets,
                      Snippets& targetSnippets, bool direction,
                      StringRef& result);
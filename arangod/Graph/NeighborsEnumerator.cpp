@@ -36,11 +36,11 @@ NeighborsEnumerator::NeighborsEnumerator(Traverser* traverser,
                                          VPackSlice const& startVertex,
                                          TraverserOptions* opts)
     : PathEnumerator(traverser, startVertex.copyString(), opts),
+      _position(0),
       _searchDepth(0) {
-  StringRef vId = _traverser->traverserCache()->persistString(StringRef(startVertex));
+  size_t vId = _traverser->traverserCache()->persistStringId(StringRef(startVertex));
   _allFound.insert(vId);
-  _currentDepth.insert(vId);
-  _iterator = _currentDepth.begin();
+  _currentDepth.emplace_back(vId);
 }
 
 bool NeighborsEnumerator::next() {
@@ -51,7 +51,9 @@ bool NeighborsEnumerator::next() {
     }
   }
 
-  if (_iterator == _currentDepth.end() || ++_iterator == _currentDepth.end()) {
+  if (_position >= _currentDepth.size() ||
+      ++_position >= _currentDepth.size()) {
+    auto cache = _opts->cache();
     do {
       // This depth is done. Get next
       if (_opts->maxDepth == _searchDepth) {
@@ -62,13 +64,27 @@ bool NeighborsEnumerator::next() {
 
       _lastDepth.swap(_currentDepth);
       _currentDepth.clear();
-      for (auto const& nextVertex : _lastDepth) {
+      if (_lastDepth.size() > 1) {
+        // let the cache fetch the edges of the whole depth at once
+        std::vector<StringRef> vertices;
+        vertices.reserve(_lastDepth.size());
+        for (auto const& v : _lastDepth) {
+          vertices.emplace_back(cache->persistedString(v));
+        }
+        cache->prefetchEdges(vertices, _searchDepth);
+      }
+      for (auto const& next : _lastDepth) {
+        StringRef const nextVertex = cache->persistedString(next);
+        if (_traverser->isPrunedVertex(nextVertex)) {
+          // returned already, but its neighbors are not searched
+          continue;
+        }
         auto callback = [&](std::unique_ptr<EdgeDocumentToken>&&,
                             VPackSlice other, size_t cursorId) {
           // Counting should be done in readAll
-          StringRef v;
+          size_t v;
           if (other.isString()) {
-            v = _opts->cache()->persistString(StringRef(other));
+            v = cache->persistStringId(StringRef(other));
           } else {
             TRI_ASSERT(other.isObject());
             VPackSlice tmp = transaction::helpers::extractFromFromDocument(other);
@@ -76,14 +92,13 @@ bool NeighborsEnumerator::next() {
               tmp = transaction::helpers::extractToFromDocument(other);
             }
             TRI_ASSERT(tmp.isString());
-            v = _opts->cache()->persistString(StringRef(tmp));
+            v = cache->persistStringId(StringRef(tmp));
           }
 
-          if (_allFound.find(v) == _allFound.end()) {
-            _currentDepth.emplace(v);
-            _allFound.emplace(v);
+          if (_allFound.insert(v)) {
+            _currentDepth.emplace_back(v);
           } else {
-            _opts->cache()->increaseFilterCounter();
+            cache->increaseFilterCounter();
           }
         };
 
@@ -97,15 +112,16 @@ bool NeighborsEnumerator::next() {
       }
       ++_searchDepth;
     } while (_searchDepth < _opts->minDepth);
-    _iterator = _currentDepth.begin();
+    _position = 0;
   }
-  TRI_ASSERT(_iterator != _currentDepth.end());
+  TRI_ASSERT(_position < _currentDepth.size());
   return true;
 }
 
 arangodb::aql::AqlValue NeighborsEnumerator::lastVertexToAqlValue() {
-  TRI_ASSERT(_iterator != _currentDepth.end());
-  return _traverser->fetchVertexData(*_iterator);
+  TRI_ASSERT(_position < _currentDepth.size());
+  return _traverser->fetchVertexData(
+      _opts->cache()->persistedString(_currentDepth[_position]));
 }
 
 arangodb::aql::AqlValue NeighborsEnumerator::lastEdgeToAqlValue() {
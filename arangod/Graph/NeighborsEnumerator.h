@@ -25,6 +25,7 @@
 #define ARANGODB_GRAPH_NEIGHBORSENUMERATOR_H 1
 
 #include "Basics/Common.h"
+#include "Graph/VertexIdSet.h"
 #include "VocBase/PathEnumerator.h"
 
 #include <velocypack/Slice.h>
@@ -34,10 +35,18 @@ namespace graph {
 // @brief Enumerator optimized for neighbors. Does not allow edge access
 
 class NeighborsEnumerator final : public arangodb::traverser::PathEnumerator {
-  std::unordered_set<arangodb::StringRef> _allFound;
-  std::unordered_set<arangodb::StringRef> _currentDepth;
-  std::unordered_set<arangodb::StringRef> _lastDepth;
-  std::unordered_set<arangodb::StringRef>::iterator _iterator;
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Vertices are identified by the dense number the traverser cache
+  ///        assigns to their _id, so the visited set is a bitmap and each
+  ///        _id string is hashed only once.
+  //////////////////////////////////////////////////////////////////////////////
+
+  VertexIdSet _allFound;
+  std::vector<size_t> _currentDepth;
+  std::vector<size_t> _lastDepth;
+
+  /// @brief position of the last returned vertex in _currentDepth
+  size_t _position;
 
   uint64_t _searchDepth;
  
@@ -44,6 +44,8 @@ ShortestPathOptions::ShortestPathOptions(transaction::Methods* trx)
       direction("outbound"),
       weightAttribute(""),
       defaultWeight(1),
+      heuristicAttribute(""),
+      heuristicFactor(0),
       bidirectional(true),
       multiThreaded(true) {}
 
@@ -53,6 +55,8 @@ ShortestPathOptions::ShortestPathOptions(transaction::Methods* trx,
       direction("outbound"),
       weightAttribute(""),
       defaultWeight(1),
+      heuristicAttribute(""),
+      heuristicFactor(0),
       bidirectional(true),
       multiThreaded(true) {
   TRI_ASSERT(info.isObject());
@@ -65,6 +69,10 @@ ShortestPathOptions::ShortestPathOptions(transaction::Methods* trx,
       VelocyPackHelper::getStringValue(info, "weightAttribute", "");
   defaultWeight =
       VelocyPackHelper::getNumericValue<double>(info, "defaultWeight", 1);
+  heuristicAttribute =
+      VelocyPackHelper::getStringValue(info, "heuristicAttribute", "");
+  heuristicFactor =
+      VelocyPackHelper::getNumericValue<double>(info, "heuristicFactor", 0);
 }
 
 ShortestPathOptions::ShortestPathOptions(aql::Query* query, VPackSlice info,
@@ -73,6 +81,8 @@ ShortestPathOptions::ShortestPathOptions(aql::Query* query, VPackSlice info,
       direction("outbound"),
       weightAttribute(""),
       defaultWeight(1),
+      heuristicAttribute(""),
+      heuristicFactor(0),
       bidirectional(true),
       multiThreaded(true) {
   TRI_ASSERT(info.isObject());
@@ -85,6 +95,10 @@ ShortestPathOptions::ShortestPathOptions(aql::Query* query, VPackSlice info,
       VelocyPackHelper::getStringValue(info, "weightAttribute", "");
   defaultWeight =
       VelocyPackHelper::getNumericValue<double>(info, "defaultWeight", 1);
+  heuristicAttribute =
+      VelocyPackHelper::getStringValue(info, "heuristicAttribute", "");
+  heuristicFactor =
+      VelocyPackHelper::getNumericValue<double>(info, "heuristicFactor", 0);
 
   VPackSlice read = info.get("reverseLookupInfos");
   if (!read.isArray()) {
@@ -138,10 +152,16 @@ VPackSlice ShortestPathOptions::getEnd() const { return endBuilder.slice(); }
 
 bool ShortestPathOptions::useWeight() const { return !weightAttribute.empty(); }
 
+bool ShortestPathOptions::useHeuristic() const {
+  return useWeight() && !heuristicAttribute.empty() && heuristicFactor > 0;
+}
+
 void ShortestPathOptions::toVelocyPack(VPackBuilder& builder) const {
   VPackObjectBuilder guard(&builder);
   builder.add("weightAttribute", VPackValue(weightAttribute));
   builder.add("defaultWeight", VPackValue(defaultWeight));
+  builder.add("heuristicAttribute", VPackValue(heuristicAttribute));
+  builder.add("heuristicFactor", VPackValue(heuristicFactor));
   builder.add("type", VPackValue("shortestPath"));
 }
 
@@ -181,6 +201,25 @@ double ShortestPathOptions::weightEdge(VPackSlice edge) {
       edge, weightAttribute.c_str(), defaultWeight);
 }
 
+bool ShortestPathOptions::estimateDegree(StringRef vid, bool backward,
+                                         uint64_t& degree) const {
+  degree = 0;
+  if (_isCoordinator) {
+    return false;
+  }
+  auto const& list = backward ? _reverseLookupInfos : _baseLookupInfos;
+  for (auto const& info : list) {
+    for (auto const& handle : info.idxHandles) {
+      uint64_t d = 0;
+      if (!handle.getIndex()->estimateDegree(vid, d)) {
+        return false;
+      }
+      degree += d;
+    }
+  }
+  return true;
+}
+
 EdgeCursor* ShortestPathOptions::nextCursor(ManagedDocumentResult* mmdr,
                                             StringRef vid) {
   if (_isCoordinator) {
@@ -49,6 +49,12 @@ struct ShortestPathOptions : public BaseOptions {
   std::string direction;
   std::string weightAttribute;
   double defaultWeight;
+  /// @brief vertex attribute holding [latitude, longitude] for an A* search.
+  /// The search only returns a shortest path if every edge weighs at least
+  /// heuristicFactor times the geo distance in metres between its vertices
+  /// and every vertex on the way has such a location.
+  std::string heuristicAttribute;
+  double heuristicFactor;
   bool bidirectional;
   bool multiThreaded;
   std::string end;
@@ -79,6 +85,9 @@ struct ShortestPathOptions : public BaseOptions {
   /// @brief  Test if we have to use a weight attribute
   bool useWeight() const;
 
+  /// @brief  Test if the weighted search can use a distance estimate
+  bool useHeuristic() const;
+
   /// @brief Build a velocypack for cloning in the plan.
   void toVelocyPack(arangodb::velocypack::Builder&) const override;
 
@@ -104,6 +113,10 @@ struct ShortestPathOptions : public BaseOptions {
 
   void fetchVerticesCoordinator(std::deque<StringRef> const& vertexIds);
 
+  /// @brief estimated number of edges the search follows from this vertex,
+  /// false if one of the used indexes cannot estimate it
+  bool estimateDegree(StringRef vid, bool backward, uint64_t& degree) const;
+
  private:
   EdgeCursor* nextCursorCoordinator(StringRef vid);
   EdgeCursor* nextReverseCursorCoordinator(StringRef vid);
@@ -126,11 +126,17 @@ bool TraverserCache::validateFilter(
 
 StringRef TraverserCache::persistString(
     StringRef const idString) {
+  return _persistedById[persistStringId(idString)];
+}
+
+size_t TraverserCache::persistStringId(StringRef const idString) {
   auto it = _persistedStrings.find(idString);
   if (it != _persistedStrings.end()) {
-    return *it;
+    return it->second;
   }
   StringRef res = _stringHeap->registerString(idString.begin(), idString.length());
-  _persistedStrings.emplace(res);
-  return res;
+  size_t id = _persistedById.size();
+  _persistedById.emplace_back(res);
+  _persistedStrings.emplace(res, id);
+  return id;
 }
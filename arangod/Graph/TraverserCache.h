@@ -115,6 +115,27 @@ class TraverserCache {
    //////////////////////////////////////////////////////////////////////////////
    StringRef persistString(StringRef const idString);
 
+   //////////////////////////////////////////////////////////////////////////////
+   /// @brief Persist the given id string and return a dense number for it.
+   ///        Numbers start at 0 and are the same for equal strings, so they
+   ///        can be used as positions in bitmaps or flat arrays.
+   //////////////////////////////////////////////////////////////////////////////
+   size_t persistStringId(StringRef const idString);
+
+   //////////////////////////////////////////////////////////////////////////////
+   /// @brief Return the persisted string for a number handed out by
+   ///        persistStringId
+   //////////////////////////////////////////////////////////////////////////////
+   StringRef persistedString(size_t id) const {
+     TRI_ASSERT(id < _persistedById.size());
+     return _persistedById[id];
+   }
+
+   //////////////////////////////////////////////////////////////////////////////
+   /// @brief Number of distinct strings persisted so far
+   //////////////////////////////////////////////////////////////////////////////
+   size_t numberOfPersistedStrings() const { return _persistedById.size(); }
+
    void increaseFilterCounter() {
      _filteredDocuments++;
    }
@@ -126,6 +147,23 @@ class TraverserCache {
   /// Only valid until the next call to this class
   virtual arangodb::velocypack::Slice lookupToken(EdgeDocumentToken const* token);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Announces that the edges of all given vertices will be read at
+  ///        the given depth, so they can be fetched at once. Does nothing
+  ///        unless fetching edges is expensive per vertex.
+  //////////////////////////////////////////////////////////////////////////////
+
+  virtual void prefetchEdges(std::vector<StringRef> const& vertexIds,
+                             uint64_t depth) {}
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Same as prefetchEdges, for the edges a shortest path search
+  ///        follows in the given direction
+  //////////////////////////////////////////////////////////////////////////////
+
+  virtual void prefetchShortestPathEdges(std::vector<StringRef> const& vertexIds,
+                                         bool backward) {}
+
   protected:
 
    //////////////////////////////////////////////////////////////////////////////
@@ -170,10 +208,15 @@ class TraverserCache {
    std::unique_ptr<arangodb::StringHeap> _stringHeap;
 
    //////////////////////////////////////////////////////////////////////////////
-   /// @brief Set of all strings persisted in the stringHeap. So we can save some
-   ///        memory by not storing them twice.
+   /// @brief All strings persisted in the stringHeap, with their number. So we
+   ///        can save some memory by not storing them twice.
+   //////////////////////////////////////////////////////////////////////////////
+   std::unordered_map<arangodb::StringRef, size_t> _persistedStrings;
+
+   //////////////////////////////////////////////////////////////////////////////
+   /// @brief The persisted strings by number
    //////////////////////////////////////////////////////////////////////////////
-   std::unordered_set<arangodb::StringRef> _persistedStrings;
+   std::vector<arangodb::StringRef> _persistedById;
 };
 
 }
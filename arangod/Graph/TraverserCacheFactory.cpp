@@ -40,7 +40,8 @@ TraverserCache* cacheFactory::CreateCache(
   if (ServerState::instance()->isCoordinator()) {
     return new ClusterTraverserCache(trx, engines);
   }
-  if (activateDocumentCache) {
+  if (activateDocumentCache &&
+      TraverserDocumentCache::sharedCache() != nullptr) {
     return new TraverserDocumentCache(trx);
   }
   return new TraverserCache(trx);
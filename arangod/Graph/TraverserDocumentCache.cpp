@@ -22,6 +22,8 @@
 
 #include "TraverserDocumentCache.h"
 
+#include "Basics/Mutex.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/StringRef.h"
 #include "Basics/VelocyPackHelper.h"
 
@@ -33,6 +35,11 @@
 #include "Cache/Finding.h"
 #include "Cluster/ServerState.h"
 #include "Graph/EdgeDocumentToken.h"
+#include "StorageEngine/DocumentIdentifierToken.h"
+#include "StorageEngine/PhysicalCollection.h"
+#include "Transaction/Helpers.h"
+#include "Transaction/Methods.h"
+#include "VocBase/LogicalCollection.h"
 
 #include <velocypack/Builder.h>
 #include <velocypack/Slice.h>
@@ -41,18 +48,29 @@
 using namespace arangodb;
 using namespace arangodb::graph;
 
-TraverserDocumentCache::TraverserDocumentCache(transaction::Methods* trx)
-    : TraverserCache(trx), _cache(nullptr) {
-  auto cacheManager = CacheManagerFeature::MANAGER;
-  TRI_ASSERT(cacheManager != nullptr);
-  _cache = cacheManager->createCache(cache::CacheType::Plain);
+namespace {
+arangodb::Mutex sharedCacheMutex;
+std::shared_ptr<cache::Cache> sharedCacheInstance;
 }
 
-TraverserDocumentCache::~TraverserDocumentCache() {
-  if (_cache != nullptr) {
+TraverserDocumentCache::TraverserDocumentCache(transaction::Methods* trx)
+    : TraverserCache(trx), _cache(sharedCache()) {}
+
+// The cache is shared, it is destroyed by the cache manager on shutdown
+TraverserDocumentCache::~TraverserDocumentCache() {}
+
+std::shared_ptr<cache::Cache> TraverserDocumentCache::sharedCache() {
+  MUTEX_LOCKER(locker, sharedCacheMutex);
+  if (sharedCacheInstance == nullptr) {
     auto cacheManager = CacheManagerFeature::MANAGER;
-    cacheManager->destroyCache(_cache);
+    if (cacheManager == nullptr) {
+      return nullptr;
+    }
+    // may be nullptr if the manager is shutting down
+    sharedCacheInstance = cacheManager->createCache(
+        cache::CacheType::Plain, false, UINT64_MAX, "traverser-documents");
   }
+  return sharedCacheInstance;
 }
 
 // @brief Only for internal use, Cache::Finding prevents
@@ -63,13 +81,43 @@ cache::Finding TraverserDocumentCache::lookup(StringRef idString) {
   TRI_ASSERT(_cache != nullptr);
   VPackValueLength keySize = idString.length();
   void const* key = idString.data();
-  // uint32_t keySize = static_cast<uint32_t>(idString.byteSize());
-  return _cache->find(key, (uint32_t)keySize);
+  cache::Finding finding = _cache->find(key, (uint32_t)keySize);
+  if (finding.found()) {
+    VPackSlice slice(finding.value()->value());
+    TRI_ASSERT(slice.isObject());
+    TRI_voc_rid_t rid = transaction::helpers::extractRevFromDocument(slice);
+    if (rid == 0 || rid != currentRevision(idString)) {
+      // Cached by another transaction and changed since, or not visible
+      // to this one. Read it from the collection.
+      finding.release();
+    }
+  }
+  return finding;
+}
+
+TRI_voc_rid_t TraverserDocumentCache::currentRevision(StringRef id) {
+  size_t pos = id.find('/');
+  if (pos == std::string::npos) {
+    return 0;
+  }
+  TRI_voc_cid_t cid = _trx->addCollectionAtRuntime(id.substr(0, pos).toString());
+  LogicalCollection* collection = _trx->documentCollection(cid);
+  if (collection == nullptr ||
+      !_trx->isLocked(collection, AccessMode::Type::READ)) {
+    // the primary index must not be read without the collection lock
+    return 0;
+  }
+  _keyBuilder.clear();
+  _keyBuilder.add(VPackValuePair(id.data() + pos + 1, id.length() - pos - 1,
+                                 VPackValueType::String));
+  // Both storage engines store the revision id in the token
+  return collection->getPhysical()->lookupKey(_trx, _keyBuilder.slice())._data;
 }
 
 VPackSlice TraverserDocumentCache::lookupAndCache(StringRef id) {
   VPackSlice result = lookupInCollection(id);
-  if (_cache != nullptr) {
+  // Documents that do not exist are not cached, they cannot be validated
+  if (_cache != nullptr && result.isObject()) {
     void const* key = id.begin();
     auto keySize = static_cast<uint32_t>(id.length());
 
@@ -137,7 +185,7 @@ aql::AqlValue TraverserDocumentCache::fetchAqlResult(StringRef idString) {
 void TraverserDocumentCache::insertDocument(
     StringRef idString, arangodb::velocypack::Slice const& document) {
   ++_insertedDocuments;
-  if (_cache != nullptr) {
+  if (_cache != nullptr && document.isObject()) {
     auto finding = lookup(idString);
     if (!finding.found()) {
       void const* key = idString.data();
@@ -24,6 +24,9 @@
 #define ARANGOD_GRAPH_TRAVERSER_DOCUMENT_CACHE_H 1
 
 #include "Graph/TraverserCache.h"
+#include "VocBase/voc-types.h"
+
+#include <velocypack/Builder.h>
 
 namespace arangodb {
 
@@ -34,6 +37,13 @@ class Finding;
 
 namespace graph {
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief TraverserCache that keeps vertex documents in a hash-cache that is
+///        shared by all traversals on this server. A cached document is only
+///        used if its revision is the one the current transaction sees, so
+///        concurrent writes never leak into a query.
+////////////////////////////////////////////////////////////////////////////////
+
 class TraverserDocumentCache : public TraverserCache {
 
   public:
@@ -81,6 +91,13 @@ class TraverserDocumentCache : public TraverserCache {
 
    bool validateFilter(StringRef idString,
        std::function<bool(arangodb::velocypack::Slice const&)> filterFunc) override;
+
+   //////////////////////////////////////////////////////////////////////////////
+   /// @brief The hash-cache shared by all traversals, created on first use.
+   ///        nullptr if there is no cache manager.
+   //////////////////////////////////////////////////////////////////////////////
+
+   static std::shared_ptr<arangodb::cache::Cache> sharedCache();
  
   protected:
 
@@ -89,15 +106,29 @@ class TraverserDocumentCache : public TraverserCache {
    ///        As long as finding is retained it is guaranteed that the result
    ///        stays valid. Finding should not be retained very long, if it is
    ///        needed for longer, copy the value.
+   ///        Cached documents with another revision than the one visible to
+   ///        this transaction are not found.
    //////////////////////////////////////////////////////////////////////////////
    cache::Finding lookup(StringRef idString);
 
+   //////////////////////////////////////////////////////////////////////////////
+   /// @brief Revision of the document as seen by this transaction, taken from
+   ///        the primary index without reading the document. 0 if it cannot
+   ///        be determined.
+   //////////////////////////////////////////////////////////////////////////////
+   TRI_voc_rid_t currentRevision(StringRef idString);
+
   protected:
 
    //////////////////////////////////////////////////////////////////////////////
    /// @brief The hash-cache that saves documents found in the Database
    //////////////////////////////////////////////////////////////////////////////
    std::shared_ptr<arangodb::cache::Cache> _cache;
+
+   //////////////////////////////////////////////////////////////////////////////
+   /// @brief Reusable builder for primary index lookups
+   //////////////////////////////////////////////////////////////////////////////
+   arangodb::velocypack::Builder _keyBuilder;
  
    //////////////////////////////////////////////////////////////////////////////
    /// @brief Lookup a document from the database and insert it into the cache.
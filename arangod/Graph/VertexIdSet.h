@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_GRAPH_VERTEX_ID_SET_H
+#define ARANGOD_GRAPH_VERTEX_ID_SET_H 1
+
+#include "Basics/Common.h"
+
+namespace arangodb {
+namespace graph {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Set of vertices, identified by the dense numbers handed out by
+///        TraverserCache::persistStringId. It is a bitmap split into pages
+///        of 4096 vertices, and pages are only allocated once a vertex in
+///        them is inserted. This keeps one bit per vertex for large searches
+///        without paying for the whole id range in small ones.
+////////////////////////////////////////////////////////////////////////////////
+
+class VertexIdSet {
+ public:
+  static size_t const PAGE_BITS = 12;
+  static size_t const PAGE_SIZE = size_t(1) << PAGE_BITS;
+  static size_t const WORDS_PER_PAGE = PAGE_SIZE / 64;
+
+ public:
+  VertexIdSet() : _size(0) {}
+
+  VertexIdSet(VertexIdSet const&) = delete;
+  VertexIdSet& operator=(VertexIdSet const&) = delete;
+
+ public:
+  /// @brief inserts the vertex, returns false if it was already contained
+  bool insert(size_t id) {
+    size_t const page = id >> PAGE_BITS;
+
+    if (page >= _pages.size()) {
+      _pages.resize((std::max)(page + 1, _pages.size() * 2));
+    }
+
+    auto& words = _pages[page];
+
+    if (words == nullptr) {
+      // value-initialized, i.e. all bits are cleared
+      words.reset(new uint64_t[WORDS_PER_PAGE]());
+    }
+
+    size_t const bit = id & (PAGE_SIZE - 1);
+    uint64_t const mask = uint64_t(1) << (bit & 63);
+    uint64_t& word = words[bit >> 6];
+
+    if ((word & mask) != 0) {
+      return false;
+    }
+
+    word |= mask;
+    ++_size;
+    return true;
+  }
+
+  bool contains(size_t id) const {
+    size_t const page = id >> PAGE_BITS;
+
+    if (page >= _pages.size() || _pages[page] == nullptr) {
+      return false;
+    }
+
+    size_t const bit = id & (PAGE_SIZE - 1);
+    return (_pages[page][bit >> 6] & (uint64_t(1) << (bit & 63))) != 0;
+  }
+
+  void clear() {
+    _pages.clear();
+    _size = 0;
+  }
+
+  size_t size() const { return _size; }
+
+  bool empty() const { return _size == 0; }
+
+ private:
+  std::vector<std::unique_ptr<uint64_t[]>> _pages;
+
+  size_t _size;
+};
+
+}  // namespace graph
+}  // namespace arangodb
+
+#endif
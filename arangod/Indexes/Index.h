@@ -223,6 +223,10 @@ class Index {
   /// @brief whether or not the index has a selectivity estimate
   virtual bool hasSelectivityEstimate() const = 0;
 
+  /// @brief whether or not the iterators of the index can produce the
+  /// indexed attribute values without looking up the documents
+  virtual bool hasCoveringIterator() const { return false; }
+
   /// @brief return the selectivity estimate of the index
   /// must only be called if hasSelectivityEstimate() returns true
   ///
@@ -234,6 +238,13 @@ class Index {
   virtual double selectivityEstimateLocal(
       arangodb::StringRef const* extra) const;
 
+  /// @brief estimated number of edges of the given vertex in this index.
+  /// only edge indexes that keep per-vertex statistics implement this,
+  /// all others return false
+  virtual bool estimateDegree(arangodb::StringRef const&, uint64_t&) const {
+    return false;
+  }
+
   /// @brief whether or not the index is implicitly unique
   /// this can be the case if the index is not declared as unique,
   /// but contains a unique attribute such as _key
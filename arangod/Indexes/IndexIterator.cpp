@@ -63,6 +63,11 @@ bool IndexIterator::nextDocument(DocumentCallback const& cb, size_t limit) {
   }, limit);
 }
 
+bool IndexIterator::hasCovering() const {
+  // The default index cannot produce the indexed values
+  return false;
+}
+
 /// @brief default implementation for next
 bool IndexIterator::nextExtra(ExtraCallback const&, size_t) {
   TRI_ASSERT(!hasExtra());
@@ -74,6 +79,17 @@ bool IndexIterator::nextExtra(ExtraCallback const&, size_t) {
                                  "relevant collections to arangodb.com");
 }
 
+/// @brief default implementation for nextCovering
+bool IndexIterator::nextCovering(DocumentCallback const&, size_t) {
+  TRI_ASSERT(!hasCovering());
+  THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_NOT_IMPLEMENTED,
+                                 "Requested covering values from an index that "
+                                 "does not support it. This seems to be a bug "
+                                 "in ArangoDB. Please report the query you are "
+                                 "using + the indexes you have defined on the "
+                                 "relevant collections to arangodb.com");
+}
+
 /// @brief default implementation for reset
 void IndexIterator::reset() {}
 
@@ -113,6 +129,41 @@ bool MultiIndexIterator::next(TokenCallback const& callback, size_t limit) {
   return true;
 }
 
+/// @brief whether or not all internal iterators can produce the
+///        indexed attribute values
+bool MultiIndexIterator::hasCovering() const {
+  for (auto const& it : _iterators) {
+    if (!it->hasCovering()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// @brief Get the indexed attribute values of the next elements
+///        If one iterator is exhausted, the next one is used.
+bool MultiIndexIterator::nextCovering(DocumentCallback const& callback, size_t limit) {
+  auto cb = [&limit, &callback] (DocumentIdentifierToken const& token, VPackSlice slice) {
+    --limit;
+    callback(token, slice);
+  };
+  while (limit > 0) {
+    if (_current == nullptr) {
+      return false;
+    }
+    if (!_current->nextCovering(cb, limit)) {
+      _currentIdx++;
+      if (_currentIdx >= _iterators.size()) {
+        _current = nullptr;
+        return false;
+      } else {
+        _current = _iterators.at(_currentIdx);
+      }
+    }
+  }
+  return true;
+}
+
 /// @brief Reset the cursor
 ///        This will reset ALL internal iterators and start all over again
 void MultiIndexIterator::reset() {
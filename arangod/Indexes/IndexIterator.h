@@ -82,10 +82,15 @@ class IndexIterator {
   transaction::Methods* transaction() const { return _trx; }
 
   virtual bool hasExtra() const;
+  virtual bool hasCovering() const;
 
   virtual bool next(TokenCallback const& callback, size_t limit) = 0;
   virtual bool nextDocument(DocumentCallback const& callback, size_t limit);
   virtual bool nextExtra(ExtraCallback const& callback, size_t limit);
+  
+  /// @brief calls the callback with an array of the indexed attribute values
+  /// instead of the document. only supported if hasCovering() returns true
+  virtual bool nextCovering(DocumentCallback const& callback, size_t limit);
 
   virtual void reset();
 
@@ -109,10 +114,16 @@ class EmptyIndexIterator final : public IndexIterator {
 
   char const* typeName() const override { return "empty-index-iterator"; }
 
+  bool hasCovering() const override { return true; }
+
   bool next(TokenCallback const&, size_t) override {
     return false;
   }
 
+  bool nextCovering(DocumentCallback const&, size_t) override {
+    return false;
+  }
+
   void reset() override {}
 
   void skip(uint64_t, uint64_t& skipped) override {
@@ -153,6 +164,14 @@ class MultiIndexIterator final : public IndexIterator {
     ///        all iterators are exhausted
     bool next(TokenCallback const& callback, size_t limit) override;
 
+    /// @brief whether or not all internal iterators can produce the
+    ///        indexed attribute values
+    bool hasCovering() const override;
+
+    /// @brief Get the indexed attribute values of the next elements
+    ///        If one iterator is exhausted, the next one is used.
+    bool nextCovering(DocumentCallback const& callback, size_t limit) override;
+
     /// @brief Reset the cursor
     ///        This will reset ALL internal iterators and start all over again
     void reset() override;
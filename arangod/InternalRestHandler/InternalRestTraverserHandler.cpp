@@ -193,7 +193,16 @@ void InternalRestTraverserHandler::queryEngine() {
           // Save Cast BaseTraverserEngines are all of type TRAVERSER
           auto eng = static_cast<BaseTraverserEngine*>(engine);
           TRI_ASSERT(eng != nullptr);
-          eng->getEdges(keysSlice, depthSlice.getNumericValue<size_t>(), result);
+          if (keysSlice.isArray() &&
+              arangodb::basics::VelocyPackHelper::getBooleanValue(
+                  body, "grouped", false)) {
+            // one array of edges per requested vertex
+            eng->getEdgesGrouped(keysSlice,
+                                 depthSlice.getNumericValue<size_t>(), result);
+          } else {
+            eng->getEdges(keysSlice, depthSlice.getNumericValue<size_t>(),
+                          result);
+          }
           break;
         }
       case BaseEngine::EngineType::SHORTESTPATH:
@@ -207,7 +216,14 @@ void InternalRestTraverserHandler::queryEngine() {
           // Save Cast ShortestPathEngines are all of type SHORTESTPATH
           auto eng = static_cast<ShortestPathEngine*>(engine);
           TRI_ASSERT(eng != nullptr);
-          eng->getEdges(keysSlice, bwSlice.getBoolean(), result);
+          if (keysSlice.isArray() &&
+              arangodb::basics::VelocyPackHelper::getBooleanValue(
+                  body, "grouped", false)) {
+            // one array of edges per requested vertex
+            eng->getEdgesGrouped(keysSlice, bwSlice.getBoolean(), result);
+          } else {
+            eng->getEdges(keysSlice, bwSlice.getBoolean(), result);
+          }
           break;
         }
       default:
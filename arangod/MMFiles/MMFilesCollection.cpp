@@ -30,6 +30,7 @@
 #include "Basics/ReadLocker.h"
 #include "Basics/Result.h"
 #include "Basics/StaticStrings.h"
+#include "Basics/StringRef.h"
 #include "Basics/VelocyPackHelper.h"
 #include "Basics/WriteLocker.h"
 #include "Basics/encoding.h"
@@ -112,6 +113,161 @@ static MMFilesDatafileStatisticsContainer* FindDatafileStats(
   return stats.release();
 }
 
+/// @brief maximum number of datafiles that are scanned concurrently when a
+/// collection is opened
+static constexpr size_t MaxParallelDatafileScans = 8;
+
+/// @brief result of scanning a single datafile when opening a collection
+struct MMFilesDatafileScan {
+  explicit MMFilesDatafileScan(MMFilesDatafile* datafile)
+      : datafile(datafile),
+        stats(),
+        documents(0),
+        deletions(0),
+        maxRevision(0),
+        maxTick(0),
+        hasHeader(false),
+        ok(true) {}
+
+  MMFilesDatafile* datafile;
+  /// @brief document and deletion markers in datafile order. a marker that
+  /// is superseded by a later marker with the same key in the same datafile
+  /// is replaced with a nullptr
+  std::vector<MMFilesMarker const*> markers;
+  /// @brief statistics contribution of the superseded markers
+  MMFilesDatafileStatisticsContainer stats;
+  /// @brief number of superseded document and deletion markers
+  uint64_t documents;
+  uint64_t deletions;
+  /// @brief highest revision id of all superseded markers
+  TRI_voc_rid_t maxRevision;
+  /// @brief highest tick of all data markers in the datafile
+  TRI_voc_tick_t maxTick;
+  bool hasHeader;
+  bool ok;
+};
+
+/// @brief helper class for scanning a datafile when opening a collection.
+/// the task only touches its own datafile and scan result, so tasks for
+/// different datafiles can run concurrently
+class MMFilesDatafileScannerTask : public basics::LocalTask {
+ public:
+  MMFilesDatafileScannerTask(std::shared_ptr<basics::LocalTaskQueue> queue,
+                             MMFilesDatafileScan* scan)
+      : LocalTask(queue), _scan(scan) {}
+
+  void run() {
+    try {
+      scan();
+    } catch (...) {
+      _scan->ok = false;
+      _queue->setStatus(TRI_ERROR_INTERNAL);
+    }
+
+    _queue->join();
+  }
+
+ private:
+  void scan() {
+    MMFilesDatafile* datafile = _scan->datafile;
+    // position of the last marker of each key in _scan->markers
+    std::unordered_map<StringRef, size_t> positions;
+
+    auto cb = [this, &positions](MMFilesMarker const* marker,
+                                 MMFilesDatafile* datafile) -> bool {
+      TRI_voc_tick_t const tick = marker->getTick();
+      MMFilesMarkerType const type = marker->getType();
+
+      if (type == TRI_DF_MARKER_VPACK_DOCUMENT ||
+          type == TRI_DF_MARKER_VPACK_REMOVE) {
+        VPackSlice const slice(reinterpret_cast<char const*>(marker) +
+                               MMFilesDatafileHelper::VPackOffset(type));
+        StringRef key(transaction::helpers::extractKeyFromDocument(slice));
+
+        auto it = positions.find(key);
+        if (it == positions.end()) {
+          positions.emplace(key, _scan->markers.size());
+        } else {
+          supersede(_scan->markers[it->second]);
+          _scan->markers[it->second] = nullptr;
+          it->second = _scan->markers.size();
+        }
+        _scan->markers.emplace_back(marker);
+
+        if (type == TRI_DF_MARKER_VPACK_DOCUMENT) {
+          if (datafile->_dataMin == 0) {
+            datafile->_dataMin = tick;
+          }
+
+          if (tick > datafile->_dataMax) {
+            datafile->_dataMax = tick;
+          }
+        }
+      } else if (type == TRI_DF_MARKER_HEADER) {
+        _scan->hasHeader = true;
+      }
+
+      if (datafile->_tickMin == 0) {
+        datafile->_tickMin = tick;
+      }
+
+      if (tick > datafile->_tickMax) {
+        datafile->_tickMax = tick;
+      }
+
+      if (tick > _scan->maxTick && type != TRI_DF_MARKER_HEADER &&
+          type != TRI_DF_MARKER_FOOTER && type != TRI_DF_MARKER_COL_HEADER &&
+          type != TRI_DF_MARKER_PROLOGUE) {
+        _scan->maxTick = tick;
+      }
+
+      return true;
+    };
+
+    datafile->sequentialAccess();
+    datafile->willNeed();
+
+    _scan->ok = TRI_IterateDatafile(datafile, cb);
+
+    if (datafile->isPhysical() && datafile->isSealed()) {
+      datafile->randomAccess();
+    }
+  }
+
+  /// @brief account for a marker that was overwritten by a later marker
+  /// with the same key in the same datafile. this mirrors what the open
+  /// iterator would have done for the pair of markers
+  void supersede(MMFilesMarker const* marker) {
+    MMFilesMarkerType const type = marker->getType();
+    VPackSlice const slice(reinterpret_cast<char const*>(marker) +
+                           MMFilesDatafileHelper::VPackOffset(type));
+    VPackSlice keySlice;
+    TRI_voc_rid_t revisionId;
+    transaction::helpers::extractKeyAndRevFromDocument(slice, keySlice,
+                                                       revisionId);
+    if (revisionId > _scan->maxRevision) {
+      _scan->maxRevision = revisionId;
+    }
+
+    if (type == TRI_DF_MARKER_VPACK_DOCUMENT) {
+      int64_t size = encoding::alignedSize<int64_t>(
+          MMFilesDatafileHelper::VPackOffset(TRI_DF_MARKER_VPACK_DOCUMENT) +
+          slice.byteSize());
+      // the marker was counted alive first and dead afterwards
+      _scan->stats.sizeAlive +=
+          MMFilesDatafileHelper::AlignedMarkerSize<int64_t>(marker) - size;
+      _scan->stats.numberDead++;
+      _scan->stats.sizeDead += size;
+      ++_scan->documents;
+    } else {
+      _scan->stats.numberDeletions++;
+      ++_scan->deletions;
+    }
+  }
+
+  MMFilesDatafileScan* _scan;
+};
+
 }  // namespace
 
 arangodb::Result MMFilesCollection::updateProperties(VPackSlice const& slice,
@@ -166,6 +322,8 @@ arangodb::Result MMFilesCollection::updateProperties(VPackSlice const& slice,
                                                            _journalSize);
   }
   _doCompact = Helper::getBooleanValue(slice, "doCompact", _doCompact);
+  _compressDatafiles = Helper::getBooleanValue(slice, "compressDatafiles",
+                                               _compressDatafiles);
 
   int64_t count = arangodb::basics::VelocyPackHelper::getNumericValue<int64_t>(
       slice, "count", _initialCount);
@@ -486,6 +644,8 @@ MMFilesCollection::MMFilesCollection(LogicalCollection* collection,
           info, "indexBuckets", defaultIndexBuckets)),
       _useSecondaryIndexes(true),
       _doCompact(Helper::readBooleanValue(info, "doCompact", true)),
+      _compressDatafiles(
+          Helper::readBooleanValue(info, "compressDatafiles", false)),
       _maxTick(0) {
   if (_isVolatile && _logicalCollection->waitForSync()) {
     // Illegal collection configuration
@@ -525,6 +685,7 @@ MMFilesCollection::MMFilesCollection(LogicalCollection* logical,
   _indexBuckets = mmfiles._indexBuckets;
   _path = mmfiles._path;
   _doCompact = mmfiles._doCompact;
+  _compressDatafiles = mmfiles._compressDatafiles;
   _maxTick = mmfiles._maxTick;
 
   // Copy over index definitions
@@ -1134,6 +1295,90 @@ bool MMFilesCollection::iterateDatafilesVector(
   return true;
 }
 
+/// @brief iterate all markers of a collection on load, scanning up to
+/// MaxParallelDatafileScans datafiles concurrently. the scan results are
+/// merged in datafile order, so the outcome is the same as with a sequential
+/// iteration over all markers. only the last marker of each key in a
+/// datafile is applied to the primary index and the revisions cache
+bool MMFilesCollection::iterateDatafilesParallel(
+    std::vector<MMFilesDatafile*> const& files, OpenIteratorState* state) {
+  auto ioService = SchedulerFeature::SCHEDULER->ioService();
+  TRI_ASSERT(ioService != nullptr);
+
+  size_t offset = 0;
+
+  while (offset < files.size()) {
+    size_t const n =
+        (std::min)(MaxParallelDatafileScans, files.size() - offset);
+
+    std::vector<std::unique_ptr<MMFilesDatafileScan>> scans;
+    scans.reserve(n);
+
+    auto queue = std::make_shared<arangodb::basics::LocalTaskQueue>(ioService);
+
+    for (size_t i = 0; i < n; ++i) {
+      scans.emplace_back(new MMFilesDatafileScan(files[offset + i]));
+      auto task = std::make_shared<MMFilesDatafileScannerTask>(
+          queue, scans.back().get());
+      queue->enqueue(task);
+    }
+
+    queue->dispatchAndWait();
+
+    if (queue->status() != TRI_ERROR_NO_ERROR) {
+      return false;
+    }
+
+    for (auto const& scan : scans) {
+      if (!scan->ok) {
+        return false;
+      }
+
+      MMFilesDatafile* datafile = scan->datafile;
+
+      if (scan->hasHeader || !scan->markers.empty()) {
+        // ensure there is a datafile info entry for each datafile of the
+        // collection
+        FindDatafileStats(state, datafile->fid())->update(scan->stats);
+      }
+
+      setRevision(scan->maxRevision, false);
+      state->_documents += scan->documents;
+      state->_deletions += scan->deletions;
+
+      for (MMFilesMarker const* marker : scan->markers) {
+        if (marker == nullptr) {
+          // superseded within the same datafile
+          continue;
+        }
+
+        int res;
+        if (marker->getType() == TRI_DF_MARKER_VPACK_DOCUMENT) {
+          res = OpenIteratorHandleDocumentMarker(marker, datafile, state);
+        } else {
+          res = OpenIteratorHandleDeletionMarker(marker, datafile, state);
+        }
+
+        if (res != TRI_ERROR_NO_ERROR) {
+          return false;
+        }
+
+        if (++state->_operations % 1024 == 0) {
+          state->_mmdr.reset();
+        }
+      }
+
+      if (scan->maxTick > maxTick()) {
+        maxTick(scan->maxTick);
+      }
+    }
+
+    offset += n;
+  }
+
+  return true;
+}
+
 /// @brief closes the datafiles passed in the vector
 bool MMFilesCollection::closeDatafiles(
     std::vector<MMFilesDatafile*> const& files) {
@@ -1157,6 +1402,7 @@ bool MMFilesCollection::closeDatafiles(
 
 void MMFilesCollection::getPropertiesVPack(velocypack::Builder& result) const {
   TRI_ASSERT(result.isOpenObject());
+  result.add("compressDatafiles", VPackValue(_compressDatafiles));
   result.add("count", VPackValue(_initialCount));
   result.add("doCompact", VPackValue(_doCompact));
   result.add("indexBuckets", VPackValue(_indexBuckets));
@@ -1170,6 +1416,7 @@ void MMFilesCollection::getPropertiesVPack(velocypack::Builder& result) const {
 void MMFilesCollection::getPropertiesVPackCoordinator(
     velocypack::Builder& result) const {
   TRI_ASSERT(result.isOpenObject());
+  result.add("compressDatafiles", VPackValue(_compressDatafiles));
   result.add("doCompact", VPackValue(_doCompact));
   result.add("indexBuckets", VPackValue(_indexBuckets));
   result.add("journalSize", VPackValue(_journalSize));
@@ -1830,7 +2077,22 @@ int MMFilesCollection::iterateMarkersOnLoad(transaction::Methods* trx) {
     return OpenIterator(marker, &openState, datafile);
   };
 
-  iterateDatafiles(cb);
+  std::vector<MMFilesDatafile*> files;
+  files.reserve(_datafiles.size() + _compactors.size() + _journals.size());
+  files.insert(files.end(), _datafiles.begin(), _datafiles.end());
+  files.insert(files.end(), _compactors.begin(), _compactors.end());
+  files.insert(files.end(), _journals.begin(), _journals.end());
+
+  StorageEngine* engine = EngineSelectorFeature::ENGINE;
+
+  if (files.size() > 1 && !engine->inRecovery() &&
+      SchedulerFeature::SCHEDULER != nullptr &&
+      SchedulerFeature::SCHEDULER->isRunning() &&
+      !SchedulerFeature::SCHEDULER->isStopping()) {
+    iterateDatafilesParallel(files, &openState);
+  } else {
+    iterateDatafiles(cb);
+  }
 
   LOG_TOPIC(TRACE, arangodb::Logger::FIXME)
       << "found " << openState._documents << " document markers, "
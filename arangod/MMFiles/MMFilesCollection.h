@@ -245,6 +245,9 @@ class MMFilesCollection final : public PhysicalCollection {
 
   bool doCompact() const { return _doCompact; }
 
+  /// @brief whether or not the compactor stores sealed datafiles compressed
+  bool compressDatafiles() const { return _compressDatafiles; }
+
   int64_t uncollectedLogfileEntries() const {
     return _uncollectedLogfileEntries.load();
   }
@@ -436,6 +439,11 @@ class MMFilesCollection final : public PhysicalCollection {
   static bool OpenIterator(MMFilesMarker const* marker, OpenIteratorState* data,
                            MMFilesDatafile* datafile);
 
+  /// @brief iterate all markers of a collection on load, scanning multiple
+  /// datafiles in parallel
+  bool iterateDatafilesParallel(std::vector<MMFilesDatafile*> const& files,
+                                OpenIteratorState* state);
+
   /// @brief create statistics for a datafile, using the stats provided
   void createStats(TRI_voc_fid_t fid,
                    MMFilesDatafileStatisticsContainer const& values) {
@@ -563,6 +571,7 @@ class MMFilesCollection final : public PhysicalCollection {
   bool _useSecondaryIndexes;
 
   bool _doCompact;
+  bool _compressDatafiles;
   TRI_voc_tick_t _maxTick;
 };
 }
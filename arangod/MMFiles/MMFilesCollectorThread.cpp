@@ -41,6 +41,8 @@
 #include "MMFiles/MMFilesPrimaryIndex.h"
 #include "MMFiles/MMFilesWalLogfile.h"
 #include "RestServer/TransactionManagerFeature.h"
+#include "Scheduler/Scheduler.h"
+#include "Scheduler/SchedulerFeature.h"
 #include "StorageEngine/EngineSelectorFeature.h"
 #include "StorageEngine/StorageEngine.h"
 #include "Transaction/Helpers.h"
@@ -227,6 +229,59 @@ static bool ScanMarker(MMFilesMarker const* marker, void* data,
   return true;
 }
 
+/// @brief maximum number of threads transferring the markers of a logfile
+/// into the collections at the same time (including the collector thread)
+static constexpr size_t MaxTransferJobs = 4;
+
+namespace {
+/// @brief the surviving markers of one collection in a logfile
+struct TransferJob {
+  TRI_voc_cid_t collectionId;
+  TRI_voc_tick_t databaseId;
+  int64_t totalOperationsCount;
+  MMFilesOperationsType operations;
+};
+
+/// @brief transfer jobs of a logfile, shared by the collector thread and the
+/// scheduler jobs helping it. each collection is handled by exactly one job,
+/// so the markers of a collection are still transferred in tick order
+struct TransferQueue {
+  arangodb::basics::ConditionVariable condition;
+  std::deque<TransferJob> jobs;
+  std::function<int(TransferJob const&)> transfer;
+  size_t active = 0;
+  int result = TRI_ERROR_NO_ERROR;
+};
+}  // namespace
+
+/// @brief transfer queued jobs until the queue is empty
+static void RunTransferJobs(std::shared_ptr<TransferQueue> queue) {
+  while (true) {
+    TransferJob job;
+    {
+      CONDITION_LOCKER(guard, queue->condition);
+      if (queue->jobs.empty()) {
+        return;
+      }
+      job = std::move(queue->jobs.front());
+      queue->jobs.pop_front();
+      ++queue->active;
+    }
+
+    int res = queue->transfer(job);
+
+    CONDITION_LOCKER(guard, queue->condition);
+    if (res != TRI_ERROR_NO_ERROR && queue->result == TRI_ERROR_NO_ERROR) {
+      // abort early
+      queue->result = res;
+      queue->jobs.clear();
+    }
+    if (--queue->active == 0 && queue->jobs.empty()) {
+      guard.broadcast();
+    }
+  }
+}
+
 /// @brief wait interval for the collector thread when idle
 uint64_t const MMFilesCollectorThread::Interval = 1000000;
 
@@ -781,15 +836,15 @@ int MMFilesCollectorThread::collect(MMFilesWalLogfile* logfile) {
     }
   }
     
-  MMFilesOperationsType sortedOperations;
+  auto queue = std::make_shared<TransferQueue>();
 
-  // now for each collection, write all surviving markers into collection
-  // datafiles
+  // now for each collection, sort all surviving markers by tick
   for (auto it = collectionIds.begin(); it != collectionIds.end(); ++it) {
     auto cid = (*it);
 
+    MMFilesOperationsType sortedOperations;
+    
     // calculate required size for sortedOperations vector
-    sortedOperations.clear();
     {
       size_t requiredSize = 0;
 
@@ -829,45 +884,85 @@ int MMFilesCollectorThread::collect(MMFilesWalLogfile* logfile) {
     }
 
     if (!sortedOperations.empty()) {
-      int res = TRI_ERROR_INTERNAL;
+      queue->jobs.emplace_back(TransferJob{cid, state.collections[cid],
+                                           state.operationsCount[cid],
+                                           std::move(sortedOperations)});
+    }
+  }
 
-      try {
-        res = transferMarkers(logfile, cid, state.collections[cid],
-                              state.operationsCount[cid], sortedOperations);
+  // write the markers into the collection datafiles. the collections are
+  // independent of each other, so up to MaxTransferJobs of them are handled
+  // at the same time
+  queue->transfer = [this, logfile](TransferJob const& job) -> int {
+    int res = TRI_ERROR_INTERNAL;
 
-        TRI_IF_FAILURE("failDuringCollect") {
-          THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
-        }
+    try {
+      res = transferMarkers(logfile, job.collectionId, job.databaseId,
+                            job.totalOperationsCount, job.operations);
 
-      } catch (arangodb::basics::Exception const& ex) {
-        res = ex.code();
-        LOG_TOPIC(TRACE, Logger::COLLECTOR) << "caught exception in collect: " << ex.what();
-      } catch (std::exception const& ex) {
-        res = TRI_ERROR_INTERNAL;
-        LOG_TOPIC(TRACE, Logger::COLLECTOR) << "caught exception in collect: " << ex.what();
-      } catch (...) {
-        res = TRI_ERROR_INTERNAL;
-        LOG_TOPIC(TRACE, Logger::COLLECTOR) << "caught unknown exception in collect";
+      TRI_IF_FAILURE("failDuringCollect") {
+        THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
       }
 
-      if (res != TRI_ERROR_NO_ERROR &&
-          res != TRI_ERROR_ARANGO_DATABASE_NOT_FOUND &&
-          res != TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND) {
-        if (res != TRI_ERROR_ARANGO_FILESYSTEM_FULL) {
-          // other places already log this error, and making the logging
-          // conditional here
-          // prevents the log message from being shown over and over again in
-          // case the
-          // file system is full
-          LOG_TOPIC(WARN, Logger::COLLECTOR) << "got unexpected error in MMFilesCollectorThread::collect: "
-                    << TRI_errno_string(res);
-        }
-        // abort early
-        return res;
+    } catch (arangodb::basics::Exception const& ex) {
+      res = ex.code();
+      LOG_TOPIC(TRACE, Logger::COLLECTOR) << "caught exception in collect: " << ex.what();
+    } catch (std::exception const& ex) {
+      res = TRI_ERROR_INTERNAL;
+      LOG_TOPIC(TRACE, Logger::COLLECTOR) << "caught exception in collect: " << ex.what();
+    } catch (...) {
+      res = TRI_ERROR_INTERNAL;
+      LOG_TOPIC(TRACE, Logger::COLLECTOR) << "caught unknown exception in collect";
+    }
+
+    if (res == TRI_ERROR_ARANGO_DATABASE_NOT_FOUND ||
+        res == TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND) {
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    if (res != TRI_ERROR_NO_ERROR && res != TRI_ERROR_ARANGO_FILESYSTEM_FULL) {
+      // other places already log this error, and making the logging
+      // conditional here
+      // prevents the log message from being shown over and over again in
+      // case the
+      // file system is full
+      LOG_TOPIC(WARN, Logger::COLLECTOR) << "got unexpected error in MMFilesCollectorThread::collect: "
+                << TRI_errno_string(res);
+    }
+    return res;
+  };
+
+  // the helpers are only an accelerator: the collector thread processes the
+  // queue itself, so the collection makes progress even if no scheduler
+  // thread is available. helpers that start after the queue has been
+  // drained return immediately
+  size_t const helpers = (std::min)(MaxTransferJobs, queue->jobs.size());
+  if (SchedulerFeature::SCHEDULER != nullptr &&
+      !SchedulerFeature::SCHEDULER->isStopping()) {
+    for (size_t i = 1; i < helpers; ++i) {
+      try {
+        SchedulerFeature::SCHEDULER->post([queue]() { RunTransferJobs(queue); });
+      } catch (...) {
+        // the collector thread will do the work
+        break;
       }
     }
   }
 
+  RunTransferJobs(queue);
+
+  {
+    // wait until the helpers have finished their current collections
+    CONDITION_LOCKER(guard, queue->condition);
+    while (queue->active > 0) {
+      guard.wait(10 * 1000);
+    }
+
+    if (queue->result != TRI_ERROR_NO_ERROR) {
+      return queue->result;
+    }
+  }
+
   // Error conditions TRI_ERROR_ARANGO_DATABASE_NOT_FOUND and
   // TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND are intentionally ignored
   // here since this can actually happen if someone has dropped things
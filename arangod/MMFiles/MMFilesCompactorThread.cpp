@@ -352,7 +352,7 @@ MMFilesCompactorThread::CompactionInitialContext MMFilesCompactorThread::getComp
 }
 
 /// @brief compact the specified datafiles
-void MMFilesCompactorThread::compactDatafiles(LogicalCollection* collection,
+uint64_t MMFilesCompactorThread::compactDatafiles(LogicalCollection* collection,
     std::vector<CompactionInfo> const& toCompact) {
   TRI_ASSERT(collection != nullptr);
   auto physical = static_cast<MMFilesCollection*>(collection->getPhysical());
@@ -451,7 +451,7 @@ void MMFilesCompactorThread::compactDatafiles(LogicalCollection* collection,
   if (initial._failed) {
     LOG_TOPIC(ERR, Logger::COMPACTOR) << "could not create initialize compaction";
 
-    return;
+    return 0;
   }
 
   LOG_TOPIC(DEBUG, Logger::COMPACTOR) << "compactify called for collection '" << collection->cid() << "' for " << n << " datafiles of total size " << initial._targetSize;
@@ -463,10 +463,10 @@ void MMFilesCompactorThread::compactDatafiles(LogicalCollection* collection,
     compactor = physical->createCompactor(initial._fid, static_cast<TRI_voc_size_t>(initial._targetSize));
   } catch (std::exception const& ex) {
     LOG_TOPIC(ERR, Logger::COMPACTOR) << "could not create compactor file: " << ex.what();
-    return;
+    return 0;
   } catch (...) {
     LOG_TOPIC(ERR, Logger::COMPACTOR) << "could not create compactor file: unknown exception";
-    return;
+    return 0;
   }
 
   TRI_ASSERT(compactor != nullptr);
@@ -482,7 +482,7 @@ void MMFilesCompactorThread::compactDatafiles(LogicalCollection* collection,
 
   if (!res.ok()) {
     LOG_TOPIC(ERR, Logger::COMPACTOR) << "error during compaction: " << res.errorMessage();
-    return;
+    return 0;
   }
 
   // now compact all datafiles
@@ -505,11 +505,17 @@ void MMFilesCompactorThread::compactDatafiles(LogicalCollection* collection,
       // compactor file does not need to be removed now. will be removed on next
       // startup
       // TODO: Remove file
-      return;
+      return 0;
     }
 
   }  // next file
 
+  // number of bytes read from the datafiles and written into the compactor
+  uint64_t bytes = compactor->currentSize();
+  for (auto const& compaction : toCompact) {
+    bytes += compaction._datafile->currentSize();
+  }
+
   physical->_datafileStatistics.replace(compactor->fid(), context->_dfi);
 
   trx.commit();
@@ -523,7 +529,7 @@ void MMFilesCompactorThread::compactDatafiles(LogicalCollection* collection,
   if (physical->closeCompactor(compactor) != TRI_ERROR_NO_ERROR) {
     LOG_TOPIC(ERR, Logger::COMPACTOR) << "could not close compactor file";
     // TODO: how do we recover from this state?
-    return;
+    return bytes;
   }
 
   if (context->_dfi.numberAlive == 0 && context->_dfi.numberDead == 0 &&
@@ -617,16 +623,20 @@ void MMFilesCompactorThread::compactDatafiles(LogicalCollection* collection,
       }
     }
   }
+
+  return bytes;
 }
 
 /// @brief checks all datafiles of a collection
-bool MMFilesCompactorThread::compactCollection(LogicalCollection* collection, bool& wasBlocked) {
+bool MMFilesCompactorThread::compactCollection(LogicalCollection* collection, bool& wasBlocked,
+                                               uint64_t& compactedBytes) {
   // we can hopefully get away without the lock here...
   //  if (! document->isFullyCollected()) {
   //    return false;
   //  }
 
   wasBlocked = false;
+  compactedBytes = 0;
 
   // if we cannot acquire the read lock instantly, we will exit directly.
   // otherwise we'll risk a multi-thread deadlock between synchronizer,
@@ -682,6 +692,14 @@ bool MMFilesCompactorThread::compactCollection(LogicalCollection* collection, bo
     maxSize = maxResultFilesize();
   }
 
+  // with an I/O budget, compact in smaller steps of about a second of the
+  // budget, so that the write lock on the collection is held only briefly
+  // and the pauses between the steps are short
+  uint64_t const maxBytesPerSecond = static_cast<MMFilesEngine*>(EngineSelectorFeature::ENGINE)->compactionMaxBytesPerSecond();
+  if (maxBytesPerSecond > 0 && maxSize > maxBytesPerSecond) {
+    maxSize = (std::max)(maxBytesPerSecond, static_cast<uint64_t>(8 * 1024 * 1024));
+  }
+
   if (start >= n || numDocuments == 0) {
     start = 0;
   }
@@ -840,7 +858,7 @@ bool MMFilesCompactorThread::compactCollection(LogicalCollection* collection, bo
   TRI_ASSERT(reason != nullptr);
   physical->setCompactionStatus(reason);
   physical->setNextCompactionStartIndex(start);
-  compactDatafiles(collection, toCompact);
+  compactedBytes = compactDatafiles(collection, toCompact);
 
   return true;
 }
@@ -866,95 +884,119 @@ void MMFilesCompactorThread::run() {
     TRI_vocbase_t::State state = _vocbase->state();
 
     try {
-      engine->tryPreventCompaction(_vocbase, [this, &numCompacted, &collections](TRI_vocbase_t* vocbase) {
-        // compaction is currently allowed
-        numCompacted = 0;
-        try {
-          // copy all collections
-          collections = _vocbase->collections(false);
-        } catch (...) {
-          collections.clear();
-        }
+      numCompacted = 0;
+      try {
+        // copy all collections. dropped collections are kept alive by the
+        // database, so the pointers remain valid outside the lock
+        collections = _vocbase->collections(false);
+      } catch (...) {
+        collections.clear();
+      }
 
-        for (auto& collection : collections) {
-          bool worked = false;
+      sortByDeadShare(collections);
 
-          auto callback = [this, &collection, &worked]() -> void {
-            if (collection->status() != TRI_VOC_COL_STATUS_LOADED &&
-                collection->status() != TRI_VOC_COL_STATUS_UNLOADING) {
-              return;
-            }
+      for (auto& collection : collections) {
+        bool worked = false;
+        uint64_t compactedBytes = 0;
+
+        auto callback = [this, &collection, &worked, &compactedBytes]() -> void {
+          if (collection->status() != TRI_VOC_COL_STATUS_LOADED &&
+              collection->status() != TRI_VOC_COL_STATUS_UNLOADING) {
+            return;
+          }
 
-            bool doCompact = static_cast<MMFilesCollection*>(collection->getPhysical())->doCompact();
+          bool doCompact = static_cast<MMFilesCollection*>(collection->getPhysical())->doCompact();
 
-            // for document collection, compactify datafiles
-            if (collection->status() == TRI_VOC_COL_STATUS_LOADED && doCompact) {
-              // check whether someone else holds a read-lock on the compaction
-              // lock
-              
-              auto physical = static_cast<MMFilesCollection*>(collection->getPhysical());
-              TRI_ASSERT(physical != nullptr);
+          // for document collection, compactify datafiles
+          if (collection->status() == TRI_VOC_COL_STATUS_LOADED && doCompact) {
+            // check whether someone else holds a read-lock on the compaction
+            // lock. this also keeps the other compactor threads of this
+            // database away from the collection
+            
+            auto physical = static_cast<MMFilesCollection*>(collection->getPhysical());
+            TRI_ASSERT(physical != nullptr);
 
-              MMFilesTryCompactionLocker compactionLocker(physical);
+            MMFilesTryCompactionLocker compactionLocker(physical);
 
-              if (!compactionLocker.isLocked()) {
-                // someone else is holding the compactor lock, we'll not compact
-                return;
-              }
+            if (!compactionLocker.isLocked()) {
+              // someone else is holding the compactor lock, we'll not compact
+              return;
+            }
 
-              try {
-                double const now = TRI_microtime();
-                if (physical->lastCompactionStamp() + compactionCollectionInterval() <= now) {
-                  auto ce = arangodb::MMFilesCollection::toMMFilesCollection(
-                                collection)
-                                ->ditches()
-                                ->createMMFilesCompactionDitch(__FILE__, __LINE__);
-
-                  if (ce == nullptr) {
-                    // out of memory
-                    LOG_TOPIC(WARN, Logger::COMPACTOR) << "out of memory when trying to create compaction ditch";
-                  } else {
-                    try {
-                      bool wasBlocked = false;
-                      worked = compactCollection(collection, wasBlocked);
-
-                      if (!worked && !wasBlocked) {
-                        // set compaction stamp
-                        physical->lastCompactionStamp(now);
-                      }
-                      // if we worked or were blocked, then we don't set the compaction stamp to
-                      // force another round of compaction
-                    } catch (...) {
-                      LOG_TOPIC(ERR, Logger::COMPACTOR) << "an unknown exception occurred during compaction";
-                      // in case an error occurs, we must still free this ditch
+            try {
+              double const now = TRI_microtime();
+              if (physical->lastCompactionStamp() + compactionCollectionInterval() <= now) {
+                auto ce = arangodb::MMFilesCollection::toMMFilesCollection(
+                              collection)
+                              ->ditches()
+                              ->createMMFilesCompactionDitch(__FILE__, __LINE__);
+
+                if (ce == nullptr) {
+                  // out of memory
+                  LOG_TOPIC(WARN, Logger::COMPACTOR) << "out of memory when trying to create compaction ditch";
+                } else {
+                  try {
+                    bool wasBlocked = false;
+                    worked = compactCollection(collection, wasBlocked, compactedBytes);
+
+                    if (!worked && !wasBlocked && physical->compressDatafiles()) {
+                      // nothing left to compact. compress the sealed
+                      // datafiles one at a time
+                      worked = compressDatafile(collection, compactedBytes);
                     }
 
-                    arangodb::MMFilesCollection::toMMFilesCollection(collection)
-                        ->ditches()
-                        ->freeDitch(ce);
+                    if (!worked && !wasBlocked) {
+                      // set compaction stamp
+                      physical->lastCompactionStamp(now);
+                    }
+                    // if we worked or were blocked, then we don't set the compaction stamp to
+                    // force another round of compaction
+                  } catch (...) {
+                    LOG_TOPIC(ERR, Logger::COMPACTOR) << "an unknown exception occurred during compaction";
+                    // in case an error occurs, we must still free this ditch
                   }
+
+                  arangodb::MMFilesCollection::toMMFilesCollection(collection)
+                      ->ditches()
+                      ->freeDitch(ce);
                 }
-              } catch (...) {
-                // in case an error occurs, we must still relase the lock
-                LOG_TOPIC(ERR, Logger::COMPACTOR) << "an unknown exception occurred during compaction";
               }
+            } catch (...) {
+              // in case an error occurs, we must still relase the lock
+              LOG_TOPIC(ERR, Logger::COMPACTOR) << "an unknown exception occurred during compaction";
             }
-          };
-
-          if (!collection->tryExecuteWhileStatusLocked(callback)) {
-            continue;
           }
+        };
 
-          if (worked) {
-            ++numCompacted;
+        // the compaction is allowed collection by collection, so that
+        // threads preventing compaction only wait for a single collection
+        bool allowed = engine->tryRunCompaction(_vocbase, [&collection, &callback](TRI_vocbase_t*) {
+          collection->tryExecuteWhileStatusLocked(callback);
+        });
+
+        if (!allowed) {
+          // compaction is currently disallowed. try again later
+          break;
+        }
 
-            // signal the cleanup thread that we worked and that it can now wake
-            // up
+        if (worked) {
+          ++numCompacted;
+
+          // signal the cleanup thread that we worked and that it can now wake
+          // up
+          {
             CONDITION_LOCKER(locker, _condition);
             locker.signal();
           }
+
+          // stay within the I/O budget. this happens outside of all locks
+          throttle(engine->reserveCompactionBandwidth(compactedBytes));
         }
-      }, true);
+
+        if (isStopping()) {
+          break;
+        }
+      }
 
       if (numCompacted > 0) {
         // no need to sleep long or go into wait state if we worked.
@@ -979,6 +1021,97 @@ void MMFilesCompactorThread::run() {
   LOG_TOPIC(DEBUG, Logger::COMPACTOR) << "shutting down compactor thread";
 }
 
+/// @brief replaces the first uncompressed datafile of a collection with a
+/// compressed copy on disk. the caller must hold the compaction lock, which
+/// keeps the datafile from being compacted away meanwhile. journals and
+/// compaction files are never compressed
+bool MMFilesCompactorThread::compressDatafile(LogicalCollection* collection,
+                                              uint64_t& compressedBytes) {
+  compressedBytes = 0;
+
+  MMFilesCollection* physical = static_cast<MMFilesCollection*>(collection->getPhysical());
+  TRI_ASSERT(physical != nullptr);
+
+  MMFilesDatafile* datafile = nullptr;
+
+  {
+    TRY_READ_LOCKER(readLocker, physical->_filesLock);
+
+    if (!readLocker.isLocked() || !physical->_compactors.empty()) {
+      // a compaction file may still be waiting to replace its datafile
+      return false;
+    }
+
+    for (auto const& it : physical->_datafiles) {
+      if (it->isPhysical() && it->isSealed() && !it->isCompressed()) {
+        datafile = it;
+        break;
+      }
+    }
+  }
+
+  if (datafile == nullptr) {
+    return false;
+  }
+
+  // temp files are removed on startup
+  std::string tempName("temp-" + std::to_string(datafile->fid()) + ".db.compressed");
+  std::string tempFilename = arangodb::basics::FileUtils::buildFilename(physical->path(), tempName);
+
+  int res = datafile->compress(tempFilename);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    LOG_TOPIC(WARN, Logger::COMPACTOR) << "unable to compress datafile '" << datafile->getName() << "': " << TRI_errno_string(res);
+    return false;
+  }
+
+  LOG_TOPIC(DEBUG, Logger::COMPACTOR) << "compressed datafile '" << datafile->getName() << "' of collection '" << collection->name() << "'";
+
+  compressedBytes = datafile->currentSize();
+  return true;
+}
+
+/// @brief order collections so that the ones with the highest share of dead
+/// data are compacted first
+void MMFilesCompactorThread::sortByDeadShare(std::vector<LogicalCollection*>& collections) {
+  std::vector<std::pair<double, LogicalCollection*>> shares;
+  shares.reserve(collections.size());
+
+  for (auto& collection : collections) {
+    MMFilesDatafileStatisticsContainer dfi = static_cast<MMFilesCollection*>(collection->getPhysical())->_datafileStatistics.all();
+    double share = 0.0;
+    if (dfi.sizeDead > 0) {
+      share = static_cast<double>(dfi.sizeDead) / (static_cast<double>(dfi.sizeDead) + static_cast<double>(dfi.sizeAlive));
+    }
+    shares.emplace_back(share, collection);
+  }
+
+  std::stable_sort(shares.begin(), shares.end(),
+                   [](std::pair<double, LogicalCollection*> const& lhs,
+                      std::pair<double, LogicalCollection*> const& rhs) {
+                     return lhs.first > rhs.first;
+                   });
+
+  for (size_t i = 0; i < shares.size(); ++i) {
+    collections[i] = shares[i].second;
+  }
+}
+
+/// @brief pause until the specified point in time (as returned by
+/// TRI_microtime), or until the thread is stopped
+void MMFilesCompactorThread::throttle(double until) {
+  while (!isStopping() && _vocbase->state() == TRI_vocbase_t::State::NORMAL) {
+    double const wait = until - TRI_microtime();
+
+    if (wait <= 0.0) {
+      break;
+    }
+
+    CONDITION_LOCKER(locker, _condition);
+    _condition.wait(static_cast<uint64_t>((std::min)(wait, 1.0) * 1000.0 * 1000.0));
+  }
+}
+
 /// @brief determine the number of documents in the collection
 uint64_t MMFilesCompactorThread::getNumberOfDocuments(LogicalCollection* collection) {
   SingleCollectionTransaction trx(
@@ -81,11 +81,26 @@ class MMFilesCompactorThread final : public Thread {
     transaction::Methods* trx, LogicalCollection* collection,
     std::vector<CompactionInfo> const& toCompact);
 
-  /// @brief compact the specified datafiles
-  void compactDatafiles(LogicalCollection* collection, std::vector<CompactionInfo> const&);
+  /// @brief compact the specified datafiles. returns the number of bytes read
+  /// and written
+  uint64_t compactDatafiles(LogicalCollection* collection, std::vector<CompactionInfo> const&);
 
   /// @brief checks all datafiles of a collection
-  bool compactCollection(LogicalCollection* collection, bool& wasBlocked);
+  bool compactCollection(LogicalCollection* collection, bool& wasBlocked,
+                         uint64_t& compactedBytes);
+
+  /// @brief replaces one sealed datafile of the collection with a
+  /// compressed copy on disk
+  bool compressDatafile(LogicalCollection* collection,
+                        uint64_t& compressedBytes);
+
+  /// @brief order collections so that the ones with the highest share of
+  /// dead data are compacted first
+  void sortByDeadShare(std::vector<LogicalCollection*>& collections);
+
+  /// @brief pause until the specified point in time, or until the thread is
+  /// stopped
+  void throttle(double until);
 
   int removeCompactor(LogicalCollection* collection, MMFilesDatafile* datafile);
 
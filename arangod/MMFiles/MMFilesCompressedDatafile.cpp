@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MMFilesCompressedDatafile.h"
+#include "Basics/OpenFilesTracker.h"
+#include "Basics/files.h"
+#include "Logger/Logger.h"
+
+#include "zlib.h"
+
+using namespace arangodb;
+
+namespace {
+
+/// @brief magic bytes at the start of a compressed datafile
+static char const Magic[8] = {'A', 'R', 'Z', 'D', 'F', 'I', 'L', 'E'};
+
+/// @brief version of the compressed datafile format
+static uint32_t const Version = 1;
+
+/// @brief reads length bytes from the file position offset
+static bool ReadAt(int fd, uint64_t offset, void* buffer, size_t length) {
+  if (TRI_LSEEK(fd, static_cast<off_t>(offset), SEEK_SET) !=
+      static_cast<off_t>(offset)) {
+    return false;
+  }
+  return TRI_ReadPointer(fd, buffer, length);
+}
+
+}
+
+/// @brief whether or not the data starts with a compressed datafile header
+bool MMFilesCompressedDatafile::isCompressed(char const* data, size_t length) {
+  return (length >= sizeof(Magic) && memcmp(data, Magic, sizeof(Magic)) == 0);
+}
+
+/// @brief writes the first size bytes of data into a new compressed datafile
+int MMFilesCompressedDatafile::write(std::string const& filename,
+                                     char const* data, uint64_t size) {
+  uint64_t const numBlocks = (size + BlockSize() - 1) / BlockSize();
+
+  Header header;
+  memcpy(&header._magic[0], Magic, sizeof(Magic));
+  header._version = Version;
+  header._blockSize = BlockSize();
+  header._size = size;
+  header._numBlocks = numBlocks;
+  header._indexOffset = 0;
+
+  int fd = TRI_TRACKED_CREATE_FILE(filename.c_str(),
+                                   O_CREAT | O_EXCL | O_RDWR | TRI_O_CLOEXEC,
+                                   S_IRUSR | S_IWUSR);
+
+  if (fd < 0) {
+    return TRI_set_errno(TRI_ERROR_SYS_ERROR);
+  }
+
+  int res = TRI_ERROR_NO_ERROR;
+
+  try {
+    std::vector<BlockInfo> index;
+    index.reserve(static_cast<size_t>(numBlocks));
+
+    std::unique_ptr<Bytef[]> compressed(new Bytef[compressBound(BlockSize())]);
+    uint64_t offset = sizeof(Header);
+
+    // write a preliminary header, it is rewritten at the end
+    if (!TRI_WritePointer(fd, &header, sizeof(Header))) {
+      res = TRI_ERROR_SYS_ERROR;
+    }
+
+    for (uint64_t i = 0; i < numBlocks && res == TRI_ERROR_NO_ERROR; ++i) {
+      uint64_t const start = i * BlockSize();
+      uLong const length =
+          static_cast<uLong>((std::min)(size - start, static_cast<uint64_t>(BlockSize())));
+      uLongf compressedLength = compressBound(BlockSize());
+
+      if (compress2(compressed.get(), &compressedLength,
+                    reinterpret_cast<Bytef const*>(data + start), length,
+                    Z_DEFAULT_COMPRESSION) != Z_OK) {
+        res = TRI_ERROR_INTERNAL;
+        break;
+      }
+
+      if (!TRI_WritePointer(fd, compressed.get(), compressedLength)) {
+        res = TRI_ERROR_SYS_ERROR;
+        break;
+      }
+
+      index.emplace_back(BlockInfo{offset, compressedLength});
+      offset += compressedLength;
+    }
+
+    if (res == TRI_ERROR_NO_ERROR) {
+      header._indexOffset = offset;
+
+      if (!TRI_WritePointer(fd, index.data(), index.size() * sizeof(BlockInfo)) ||
+          TRI_LSEEK(fd, 0, SEEK_SET) != 0 ||
+          !TRI_WritePointer(fd, &header, sizeof(Header)) ||
+          !TRI_fsync(fd)) {
+        res = TRI_ERROR_SYS_ERROR;
+      }
+    }
+  } catch (...) {
+    res = TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  TRI_TRACKED_CLOSE_FILE(fd);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    LOG_TOPIC(ERR, Logger::DATAFILES) << "cannot write compressed datafile '"
+                                      << filename << "': " << TRI_errno_string(res);
+    TRI_UnlinkFile(filename.c_str());
+  }
+
+  return res;
+}
+
+/// @brief reads the uncompressed size from the header of a compressed datafile
+int MMFilesCompressedDatafile::readSize(int fd, uint64_t& size) {
+  Header header;
+
+  if (!ReadAt(fd, 0, &header, sizeof(Header)) ||
+      !isCompressed(&header._magic[0], sizeof(header._magic)) ||
+      header._version != Version || header._blockSize == 0 ||
+      header._numBlocks !=
+          (header._size + header._blockSize - 1) / header._blockSize) {
+    return TRI_ERROR_ARANGO_CORRUPTED_DATAFILE;
+  }
+
+  size = header._size;
+  return TRI_ERROR_NO_ERROR;
+}
+
+/// @brief decompresses a compressed datafile into the buffer
+int MMFilesCompressedDatafile::read(int fd, char* buffer, uint64_t size) {
+  Header header;
+
+  if (!ReadAt(fd, 0, &header, sizeof(Header)) ||
+      !isCompressed(&header._magic[0], sizeof(header._magic)) ||
+      header._version != Version || header._size != size ||
+      header._blockSize == 0 ||
+      header._numBlocks != (size + header._blockSize - 1) / header._blockSize) {
+    return TRI_ERROR_ARANGO_CORRUPTED_DATAFILE;
+  }
+
+  try {
+    std::vector<BlockInfo> index(static_cast<size_t>(header._numBlocks));
+
+    if (!ReadAt(fd, header._indexOffset, index.data(),
+                index.size() * sizeof(BlockInfo))) {
+      return TRI_ERROR_ARANGO_CORRUPTED_DATAFILE;
+    }
+
+    uLong const maxLength = compressBound(header._blockSize);
+    std::unique_ptr<Bytef[]> compressed(new Bytef[maxLength]);
+
+    for (uint64_t i = 0; i < header._numBlocks; ++i) {
+      BlockInfo const& block = index[static_cast<size_t>(i)];
+      uint64_t const start = i * header._blockSize;
+      uLongf length = static_cast<uLongf>(
+          (std::min)(size - start, static_cast<uint64_t>(header._blockSize)));
+      uLongf const expected = length;
+
+      if (block._length > maxLength ||
+          !ReadAt(fd, block._offset, compressed.get(),
+                  static_cast<size_t>(block._length)) ||
+          uncompress(reinterpret_cast<Bytef*>(buffer + start), &length,
+                     compressed.get(), static_cast<uLong>(block._length)) != Z_OK ||
+          length != expected) {
+        // zlib verifies the checksum of each block
+        return TRI_ERROR_ARANGO_CORRUPTED_DATAFILE;
+      }
+    }
+  } catch (...) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
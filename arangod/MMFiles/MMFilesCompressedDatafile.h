@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_MMFILES_MMFILES_COMPRESSED_DATAFILE_H
+#define ARANGOD_MMFILES_MMFILES_COMPRESSED_DATAFILE_H 1
+
+#include "Basics/Common.h"
+
+namespace arangodb {
+namespace MMFilesCompressedDatafile {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief on-disk layout of a compressed datafile
+///
+/// a compressed datafile contains the image of a sealed datafile, split into
+/// blocks of BlockSize() bytes that are compressed individually. the file
+/// starts with a Header, followed by the compressed blocks, followed by the
+/// block index (one BlockInfo per block)
+////////////////////////////////////////////////////////////////////////////////
+
+struct Header {
+  char _magic[8];
+  uint32_t _version;
+  uint32_t _blockSize;
+  uint64_t _size;         // size of the uncompressed datafile
+  uint64_t _numBlocks;
+  uint64_t _indexOffset;  // file offset of the block index
+};
+
+struct BlockInfo {
+  uint64_t _offset;  // file offset of the compressed block
+  uint64_t _length;  // length of the compressed block
+};
+
+static_assert(sizeof(Header) == 40, "invalid size for compressed datafile header");
+static_assert(sizeof(BlockInfo) == 16, "invalid size for compressed datafile block info");
+
+/// @brief uncompressed size of a block
+constexpr inline uint32_t BlockSize() { return 64 * 1024; }
+
+/// @brief whether or not the data starts with a compressed datafile header
+bool isCompressed(char const* data, size_t length);
+
+/// @brief writes the first size bytes of data into a new compressed
+/// datafile. the file is synced to disk before returning
+int write(std::string const& filename, char const* data, uint64_t size);
+
+/// @brief reads the header of the compressed datafile opened as fd and
+/// returns the uncompressed size of the datafile in size
+int readSize(int fd, uint64_t& size);
+
+/// @brief decompresses the compressed datafile opened as fd into the
+/// buffer, which must be able to hold the uncompressed size
+int read(int fd, char* buffer, uint64_t size);
+
+}
+}
+
+#endif
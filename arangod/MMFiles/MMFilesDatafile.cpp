@@ -33,6 +33,7 @@
 #include "Basics/memory-map.h"
 #include "Basics/tri-strings.h"
 #include "Logger/Logger.h"
+#include "MMFiles/MMFilesCompressedDatafile.h"
 #include "MMFiles/MMFilesDatafileHelper.h"
 #include "VocBase/ticks.h"
 
@@ -792,6 +793,35 @@ int MMFilesDatafile::rename(std::string const& filename) {
   return TRI_ERROR_NO_ERROR;
 }
 
+/// @brief replaces the datafile on disk with a compressed copy
+int MMFilesDatafile::compress(std::string const& tempFilename) {
+  // this function must not be called for non-physical datafiles
+  TRI_ASSERT(isPhysical());
+
+  if (!_isSealed || _isCompressed) {
+    return TRI_ERROR_ARANGO_ILLEGAL_STATE;
+  }
+
+  int res = MMFilesCompressedDatafile::write(tempFilename, _data, _currentSize);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  // the rename is atomic. our mapping keeps the uncompressed file alive
+  res = TRI_RenameFile(tempFilename.c_str(), _filename.c_str());
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    LOG_TOPIC(ERR, arangodb::Logger::DATAFILES) << "cannot replace datafile '" << _filename << "' with compressed file '" << tempFilename << "': " << TRI_errno_string(res);
+    TRI_UnlinkFile(tempFilename.c_str());
+    return res;
+  }
+
+  _isCompressed = true;
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 /// @brief seals a datafile, writes a footer, sets it to read-only
 int MMFilesDatafile::seal() {
   if (_state == TRI_DF_STATE_READ) {
@@ -984,6 +1014,7 @@ MMFilesDatafile::MMFilesDatafile(std::string const& filename, int fd, void* mmHa
           _full(false),
           _isSealed(false),
           _lockedInMemory(false),
+          _isCompressed(false),
           _data(data),
           _next(data + currentSize),
           _tickMin(0),
@@ -1004,6 +1035,7 @@ MMFilesDatafile::MMFilesDatafile(std::string const& filename, int fd, void* mmHa
     sequentialAccess();
   }
   dontDump();
+  TRI_MMFileApplyPolicies(_data, _initSize, fd == -1);
 }
   
 MMFilesDatafile::~MMFilesDatafile() {
@@ -1198,6 +1230,7 @@ int MMFilesDatafile::truncateAndSeal(TRI_voc_size_t position) {
   _next = (char*)(data) + position;
   _currentSize = position;
   // do not change _initSize!
+  TRI_MMFileApplyPolicies(_data, _initSize, fd == -1);
   TRI_ASSERT(_initSize == _maximalSize);
   TRI_ASSERT(maximalSize <= _initSize);
   _maximalSize = static_cast<TRI_voc_size_t>(maximalSize);
@@ -1783,6 +1816,14 @@ MMFilesDatafile* MMFilesDatafile::open(std::string const& filename, bool ignoreF
     return nullptr;
   }
 
+  if (datafile->_isCompressed && !datafile->_isSealed) {
+    // only sealed datafiles are compressed, and the decompressed image
+    // cannot be written back
+    LOG_TOPIC(ERR, arangodb::Logger::FIXME) << "compressed datafile '" << datafile->getName() << "' is not sealed";
+    TRI_set_errno(TRI_ERROR_ARANGO_CORRUPTED_DATAFILE);
+    return nullptr;
+  }
+
   // change to read-write if no footer has been found
   if (!datafile->_isSealed) {
     if (!datafile->readWrite()) {
@@ -1865,6 +1906,10 @@ MMFilesDatafile* MMFilesDatafile::openHelper(std::string const& filename, bool i
     return nullptr;
   }
 
+  if (MMFilesCompressedDatafile::isCompressed(&buffer[0], static_cast<size_t>(toRead))) {
+    return openCompressedHelper(filename, fd, fid);
+  }
+
   char const* ptr = reinterpret_cast<char*>(&buffer[0]);
   char const* end = static_cast<char const*>(ptr) + len;
   MMFilesDatafileHeaderMarker const* header = reinterpret_cast<MMFilesDatafileHeaderMarker const*>(&buffer[0]);
@@ -1936,6 +1981,78 @@ MMFilesDatafile* MMFilesDatafile::openHelper(std::string const& filename, bool i
   }
 }
 
+/// @brief opens a compressed datafile. the datafile is decompressed into an
+/// anonymous memory region, and the file descriptor is kept open so that the
+/// datafile can be renamed and closed like any other physical datafile
+MMFilesDatafile* MMFilesDatafile::openCompressedHelper(std::string const& filename,
+                                                       int fd, TRI_voc_fid_t fid) {
+#ifdef TRI_MMAP_ANONYMOUS
+  uint64_t size = 0;
+  int res = MMFilesCompressedDatafile::readSize(fd, size);
+
+  if (res == TRI_ERROR_NO_ERROR &&
+      (size < sizeof(MMFilesDatafileHeaderMarker) + sizeof(MMFilesDatafileFooterMarker) ||
+       size > static_cast<uint64_t>((std::numeric_limits<TRI_voc_size_t>::max)()))) {
+    res = TRI_ERROR_ARANGO_CORRUPTED_DATAFILE;
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_set_errno(res);
+    TRI_TRACKED_CLOSE_FILE(fd);
+
+    LOG_TOPIC(ERR, arangodb::Logger::FIXME) << "corrupted header in compressed datafile '" << filename << "'";
+    return nullptr;
+  }
+
+  void* data;
+  void* mmHandle;
+  res = TRI_MMFile(nullptr, static_cast<size_t>(size), PROT_WRITE | PROT_READ,
+                   TRI_MMAP_ANONYMOUS | MAP_PRIVATE, -1, &mmHandle, 0, &data);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_set_errno(res);
+    TRI_TRACKED_CLOSE_FILE(fd);
+
+    LOG_TOPIC(ERR, arangodb::Logger::FIXME) << "cannot allocate memory for compressed datafile '" << filename << "': " << TRI_errno_string(res);
+    return nullptr;
+  }
+
+  res = MMFilesCompressedDatafile::read(fd, static_cast<char*>(data), size);
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    res = TRI_ProtectMMFile(data, static_cast<size_t>(size), PROT_READ, fd);
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_set_errno(res);
+    TRI_UNMMFile(data, static_cast<size_t>(size), -1, &mmHandle);
+    TRI_TRACKED_CLOSE_FILE(fd);
+
+    LOG_TOPIC(ERR, arangodb::Logger::FIXME) << "cannot decompress datafile '" << filename << "': " << TRI_errno_string(res);
+    return nullptr;
+  }
+
+  TRI_voc_size_t const s = static_cast<TRI_voc_size_t>(size);
+
+  try {
+    auto datafile = new MMFilesDatafile(filename, fd, mmHandle, s, s, fid, static_cast<char*>(data));
+    datafile->_isCompressed = true;
+    return datafile;
+  } catch (...) {
+    TRI_UNMMFile(data, static_cast<size_t>(size), -1, &mmHandle);
+    TRI_TRACKED_CLOSE_FILE(fd);
+
+    return nullptr;
+  }
+#else
+  TRI_set_errno(TRI_ERROR_NOT_IMPLEMENTED);
+  TRI_TRACKED_CLOSE_FILE(fd);
+
+  LOG_TOPIC(ERR, arangodb::Logger::FIXME) << "compressed datafile '" << filename << "' cannot be opened on this platform";
+  return nullptr;
+#endif
+}
+
 /// @brief returns information about the datafile
 DatafileScan MMFilesDatafile::scan(std::string const& path) {
   // this function must not be called for non-physical datafiles
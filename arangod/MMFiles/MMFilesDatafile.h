@@ -261,6 +261,14 @@ struct MMFilesDatafile {
   void setState(TRI_df_state_e state) { _state = state; }
   
   bool isSealed() const { return _isSealed; }
+
+  /// @brief whether or not the datafile is stored compressed on disk
+  bool isCompressed() const { return _isCompressed; }
+
+  /// @brief replaces the sealed datafile on disk with a compressed copy,
+  /// which is written to tempFilename first. the datafile stays mapped from
+  /// the uncompressed file until it is closed
+  int compress(std::string const& tempFilename);
   
   char* advanceWritePosition(size_t size) {
     char* old = _next;
@@ -286,6 +294,10 @@ struct MMFilesDatafile {
   /// @brief opens a datafile
   static MMFilesDatafile* openHelper(std::string const& filename, bool ignoreErrors);
 
+  /// @brief opens a compressed datafile, decompressing it into memory
+  static MMFilesDatafile* openCompressedHelper(std::string const& filename,
+                                               int fd, TRI_voc_fid_t fid);
+
   /// @brief create the initial datafile header marker
   int writeInitialHeaderMarker(TRI_voc_fid_t fid, TRI_voc_size_t maximalSize);
 
@@ -311,6 +323,7 @@ struct MMFilesDatafile {
                // room
   bool _isSealed;  // true, if footer has been written
   bool _lockedInMemory;  // whether or not the datafile is locked in memory (mlock) 
+  bool _isCompressed;  // whether or not the file on disk is compressed
 
  public:
   char* _data;  // start of the data array
@@ -66,6 +66,18 @@ void MMFilesDocumentOperation::setVPack(uint8_t const* vpack) {
   _newRevision._vpack = vpack;
 }
 
+StringRef MMFilesDocumentOperation::key() const {
+  uint8_t const* vpack =
+      _newRevision.empty() ? _oldRevision._vpack : _newRevision._vpack;
+
+  if (vpack == nullptr) {
+    return StringRef();
+  }
+
+  return StringRef(
+      transaction::helpers::extractKeyFromDocument(VPackSlice(vpack)));
+}
+
 void MMFilesDocumentOperation::setRevisions(DocumentDescriptor const& oldRevision,
                                      DocumentDescriptor const& newRevision) {
   TRI_ASSERT(_oldRevision.empty());
@@ -25,6 +25,7 @@
 #define ARANGOD_MMFILES_DOCUMENT_OPERATION_H 1
 
 #include "Basics/Common.h"
+#include "Basics/StringRef.h"
 #include "VocBase/voc-types.h"
 
 namespace arangodb {
@@ -61,6 +62,9 @@ struct MMFilesDocumentOperation {
   TRI_voc_document_operation_e type() const { return _type; }
 
   LogicalCollection* collection() const { return _collection; }
+
+  /// @brief key of the document affected by the operation
+  StringRef key() const;
  
   void indexed() noexcept {
     TRI_ASSERT(_status == StatusType::CREATED);
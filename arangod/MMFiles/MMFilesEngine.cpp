@@ -32,6 +32,7 @@
 #include "Basics/build.h"
 #include "Basics/encoding.h"
 #include "Basics/files.h"
+#include "Basics/memory-map.h"
 #include "MMFiles/MMFilesAqlFunctions.h"
 #include "MMFiles/MMFilesCleanupThread.h"
 #include "MMFiles/MMFilesCollection.h"
@@ -54,6 +55,8 @@
 #include "MMFiles/MMFilesView.h"
 #include "MMFiles/MMFilesWalRecoveryFeature.h"
 #include "MMFiles/mmfiles-replication-dump.h"
+#include "ProgramOptions/ProgramOptions.h"
+#include "ProgramOptions/Section.h"
 #include "Random/RandomGenerator.h"
 #include "RestServer/DatabaseFeature.h"
 #include "RestServer/DatabasePathFeature.h"
@@ -147,7 +150,12 @@ std::string const MMFilesEngine::FeatureName("MMFilesEngine");
 MMFilesEngine::MMFilesEngine(application_features::ApplicationServer* server)
     : StorageEngine(server, EngineName, FeatureName, new MMFilesIndexFactory()),
       _isUpgrade(false),
-      _maxTick(0) {
+      _maxTick(0),
+      _compactionThreads(1),
+      _compactionMaxBytesPerSecond(0),
+      _mmapHugePages(false),
+      _mmapNumaInterleave(false),
+      _compactionBandwidthUsedUntil(0.0) {
   startsAfter("MMFilesPersistentIndex"); // yes, intentional!
     
   server->addFeature(new MMFilesWalRecoveryFeature(server));
@@ -190,10 +198,37 @@ Result MMFilesEngine::dropDatabase(TRI_vocbase_t* database) {
 }
 
 // add the storage engine's specifc options to the global list of options
-void MMFilesEngine::collectOptions(std::shared_ptr<options::ProgramOptions>) {}
+void MMFilesEngine::collectOptions(std::shared_ptr<options::ProgramOptions> options) {
+  options->addSection("compaction", "Configure the MMFiles compactor");
+
+  options->addOption("--compaction.threads",
+                     "number of compactor threads per database",
+                     new options::UInt64Parameter(&_compactionThreads));
+
+  options->addOption("--compaction.max-bytes-per-second",
+                     "maximum number of bytes per second all compactor threads "
+                     "together may read and write (0 = unlimited)",
+                     new options::UInt64Parameter(&_compactionMaxBytesPerSecond));
+
+  options->addSection("mmfiles", "Configure the MMFiles memory mappings");
+
+  options->addOption("--mmfiles.huge-pages",
+                     "use transparent huge pages for large index memory (has no "
+                     "effect on datafiles, which are file-backed)",
+                     new options::BooleanParameter(&_mmapHugePages));
+
+  options->addOption("--mmfiles.numa-interleave",
+                     "interleave datafiles and index memory over all NUMA nodes",
+                     new options::BooleanParameter(&_mmapNumaInterleave));
+}
 
 // validate the storage engine's specific options
-void MMFilesEngine::validateOptions(std::shared_ptr<options::ProgramOptions>) {}
+void MMFilesEngine::validateOptions(std::shared_ptr<options::ProgramOptions>) {
+  if (_compactionThreads < 1 || _compactionThreads > 16) {
+    LOG_TOPIC(FATAL, arangodb::Logger::COMPACTOR) << "invalid value for --compaction.threads. Please use a value between 1 and 16";
+    FATAL_ERROR_EXIT();
+  }
+}
 
 // preparation phase for storage engine. can be used for internal setup.
 // the storage engine must not start any threads here or write any files
@@ -222,6 +257,9 @@ void MMFilesEngine::start() {
 
   TRI_ASSERT(EngineSelectorFeature::ENGINE == this);
 
+  // must happen before the first datafile is mapped
+  TRI_SetMMFilePolicies(_mmapHugePages, _mmapNumaInterleave);
+
   // test if the "databases" directory is present and writable
   verifyDirectories();
 
@@ -2606,6 +2644,50 @@ bool MMFilesEngine::tryPreventCompaction(
   return false;
 }
 
+bool MMFilesEngine::tryRunCompaction(
+    TRI_vocbase_t* vocbase, std::function<void(TRI_vocbase_t*)> const& callback) {
+  // compactor threads only exclude each other per collection, via the
+  // collection's compaction lock
+  TRY_READ_LOCKER(locker, _compactionBlockersLock);
+
+  if (!locker.isLocked()) {
+    return false;
+  }
+
+  double const now = TRI_microtime();
+
+  // check if we have a still-valid compaction blocker
+  auto it = _compactionBlockers.find(vocbase);
+
+  if (it != _compactionBlockers.end()) {
+    for (auto const& blocker : (*it).second) {
+      if (blocker._expires > now) {
+        // found a compaction blocker
+        return false;
+      }
+    }
+  }
+
+  callback(vocbase);
+  return true;
+}
+
+double MMFilesEngine::reserveCompactionBandwidth(uint64_t bytes) {
+  uint64_t const maxBytesPerSecond = _compactionMaxBytesPerSecond;
+
+  if (maxBytesPerSecond == 0) {
+    return 0.0;
+  }
+
+  double const now = TRI_microtime();
+
+  MUTEX_LOCKER(locker, _compactionBandwidthLock);
+  // unused budget does not accumulate, so idle periods do not allow bursts
+  _compactionBandwidthUsedUntil = (std::max)(_compactionBandwidthUsedUntil, now) +
+      static_cast<double>(bytes) / static_cast<double>(maxBytesPerSecond);
+  return _compactionBandwidthUsedUntil;
+}
+
 int MMFilesEngine::shutdownDatabase(TRI_vocbase_t* vocbase) {
   try {
     stopCompactor(vocbase);
@@ -2671,63 +2753,60 @@ int MMFilesEngine::stopCleanup(TRI_vocbase_t* vocbase) {
   return TRI_ERROR_NO_ERROR;
 }
 
-// start the compactor thread for the database
+// start the compactor threads for the database
 int MMFilesEngine::startCompactor(TRI_vocbase_t* vocbase) {
-  std::unique_ptr<MMFilesCompactorThread> thread;
+  MUTEX_LOCKER(locker, _threadsLock);
 
-  {
-    MUTEX_LOCKER(locker, _threadsLock);
+  auto it = _compactorThreads.find(vocbase);
 
-    auto it = _compactorThreads.find(vocbase);
+  if (it != _compactorThreads.end()) {
+    return TRI_ERROR_INTERNAL;
+  }
 
-    if (it != _compactorThreads.end()) {
-      return TRI_ERROR_INTERNAL;
-    }
+  auto& threads = _compactorThreads.emplace(vocbase, std::vector<MMFilesCompactorThread*>()).first->second;
+  threads.reserve(_compactionThreads);
 
-    thread.reset(new MMFilesCompactorThread(vocbase));
-    _compactorThreads.emplace(vocbase, thread.get());
-  }
+  for (uint64_t i = 0; i < _compactionThreads; ++i) {
+    std::unique_ptr<MMFilesCompactorThread> thread(new MMFilesCompactorThread(vocbase));
 
-  TRI_ASSERT(thread != nullptr);
+    if (!thread->start()) {
+      LOG_TOPIC(ERR, arangodb::Logger::FIXME)
+          << "could not start compactor thread";
+      // the threads started so far remain registered and are stopped
+      // together with the database
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
 
-  if (!thread->start()) {
-    LOG_TOPIC(ERR, arangodb::Logger::FIXME)
-        << "could not start compactor thread";
-    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    threads.emplace_back(thread.release());
   }
 
-  thread.release();
   return TRI_ERROR_NO_ERROR;
 }
 
-// signal the compactor thread to stop
+// signal the compactor threads to stop
 int MMFilesEngine::beginShutdownCompactor(TRI_vocbase_t* vocbase) {
-  MMFilesCompactorThread* thread = nullptr;
-
-  {
-    MUTEX_LOCKER(locker, _threadsLock);
-
-    auto it = _compactorThreads.find(vocbase);
+  MUTEX_LOCKER(locker, _threadsLock);
 
-    if (it == _compactorThreads.end()) {
-      // already stopped
-      return TRI_ERROR_NO_ERROR;
-    }
+  auto it = _compactorThreads.find(vocbase);
 
-    thread = (*it).second;
+  if (it == _compactorThreads.end()) {
+    // already stopped
+    return TRI_ERROR_NO_ERROR;
   }
 
-  TRI_ASSERT(thread != nullptr);
+  for (auto& thread : (*it).second) {
+    TRI_ASSERT(thread != nullptr);
 
-  thread->beginShutdown();
-  thread->signal();
+    thread->beginShutdown();
+    thread->signal();
+  }
 
   return TRI_ERROR_NO_ERROR;
 }
 
-// stop and delete the compactor thread for the database
+// stop and delete the compactor threads for the database
 int MMFilesEngine::stopCompactor(TRI_vocbase_t* vocbase) {
-  MMFilesCompactorThread* thread = nullptr;
+  std::vector<MMFilesCompactorThread*> threads;
 
   {
     MUTEX_LOCKER(locker, _threadsLock);
@@ -2739,20 +2818,24 @@ int MMFilesEngine::stopCompactor(TRI_vocbase_t* vocbase) {
       return TRI_ERROR_NO_ERROR;
     }
 
-    thread = (*it).second;
+    threads = std::move((*it).second);
     _compactorThreads.erase(it);
   }
 
-  TRI_ASSERT(thread != nullptr);
-
-  thread->beginShutdown();
-  thread->signal();
+  for (auto& thread : threads) {
+    TRI_ASSERT(thread != nullptr);
 
-  while (thread->isRunning()) {
-    usleep(5000);
+    thread->beginShutdown();
+    thread->signal();
   }
 
-  delete thread;
+  for (auto& thread : threads) {
+    while (thread->isRunning()) {
+      usleep(5000);
+    }
+
+    delete thread;
+  }
 
   return TRI_ERROR_NO_ERROR;
 }
@@ -86,6 +86,9 @@ class MMFilesEngine final : public StorageEngine {
   void stop() override;
   
   bool supportsDfdb() const override { return true; }
+
+  bool supportsBackgroundIndexing() const override { return false; }
+  bool supportsParallelDatabaseOpening() const override { return false; }
   
   bool useRawDocumentPointers() override { return true; }
 
@@ -330,6 +333,26 @@ class MMFilesEngine final : public StorageEngine {
                             std::function<void(TRI_vocbase_t*)> const& callback,
                             bool checkForActiveBlockers);
 
+  /// @brief a callback function that is run while compaction is allowed.
+  /// the compactor threads can run such callbacks concurrently, but not
+  /// while someone else prevents compaction
+  bool tryRunCompaction(TRI_vocbase_t* vocbase,
+                        std::function<void(TRI_vocbase_t*)> const& callback);
+
+  /// @brief number of compactor threads per database
+  uint64_t compactionThreads() const { return _compactionThreads; }
+
+  /// @brief maximum number of bytes per second the compactor threads of all
+  /// databases may read and write (0 = unlimited)
+  uint64_t compactionMaxBytesPerSecond() const {
+    return _compactionMaxBytesPerSecond;
+  }
+
+  /// @brief charge the compaction I/O budget with the bytes a compaction
+  /// has read and written. returns the point in time (in seconds, as
+  /// returned by TRI_microtime) until which the compactor should pause.
+  double reserveCompactionBandwidth(uint64_t bytes);
+
   int shutdownDatabase(TRI_vocbase_t* vocbase) override;
 
   int openCollection(TRI_vocbase_t* vocbase, LogicalCollection* collection,
@@ -450,11 +473,11 @@ class MMFilesEngine final : public StorageEngine {
   // stop and delete the cleanup thread for the database
   int stopCleanup(TRI_vocbase_t* vocbase);
 
-  // start the compactor thread for the database
+  // start the compactor threads for the database
   int startCompactor(TRI_vocbase_t* vocbase);
-  // signal the compactor thread to stop
+  // signal the compactor threads to stop
   int beginShutdownCompactor(TRI_vocbase_t* vocbase);
-  // stop and delete the compactor thread for the database
+  // stop and delete the compactor threads for the database
   int stopCompactor(TRI_vocbase_t* vocbase);
 
   /// @brief writes a drop-database marker into the log
@@ -469,6 +492,19 @@ class MMFilesEngine final : public StorageEngine {
   std::string _databasePath;
   bool _isUpgrade;
   TRI_voc_tick_t _maxTick;
+  uint64_t _compactionThreads;
+  uint64_t _compactionMaxBytesPerSecond;
+  // use transparent huge pages for large index memory. file-backed
+  // datafiles cannot use them
+  bool _mmapHugePages;
+  // interleave datafiles and index memory over all NUMA nodes
+  bool _mmapNumaInterleave;
+
+  // lock for the compaction I/O budget
+  arangodb::Mutex _compactionBandwidthLock;
+  // point in time until which the compaction I/O budget is used up,
+  // protected by _compactionBandwidthLock
+  double _compactionBandwidthUsedUntil;
   std::vector<std::pair<std::string, std::string>> _deleted;
 
   arangodb::basics::ReadWriteLock mutable _pathsLock;
@@ -498,7 +534,8 @@ class MMFilesEngine final : public StorageEngine {
   // lock for threads
   arangodb::Mutex _threadsLock;
   // per-database compactor threads, protected by _threadsLock
-  std::unordered_map<TRI_vocbase_t*, MMFilesCompactorThread*> _compactorThreads;
+  std::unordered_map<TRI_vocbase_t*, std::vector<MMFilesCompactorThread*>>
+      _compactorThreads;
   // per-database cleanup threads, protected by _threadsLock
   std::unordered_map<TRI_vocbase_t*, MMFilesCleanupThread*> _cleanupThreads;
 };
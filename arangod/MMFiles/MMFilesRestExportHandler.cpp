@@ -46,6 +46,9 @@ MMFilesRestExportHandler::MMFilesRestExportHandler(GeneralRequest* request,
     : RestVocbaseBaseHandler(request, response), _restrictions() {}
 
 RestStatus MMFilesRestExportHandler::execute() {
+  // exported batches can be big. let the transport compress them
+  _response->setAllowCompression(true);
+
   if (ServerState::instance()->isCoordinator()) {
     generateError(rest::ResponseCode::NOT_IMPLEMENTED,
                   TRI_ERROR_CLUSTER_UNSUPPORTED,
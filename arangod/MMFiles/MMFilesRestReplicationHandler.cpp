@@ -124,7 +124,7 @@ RestStatus MMFilesRestReplicationHandler::execute() {
       handleCommandDetermineOpenTransactions();
     } else if (command == "batch") {
       if (ServerState::instance()->isCoordinator()) {
-        handleTrampolineCoordinator();
+        return handleTrampolineCoordinator();
       } else {
         handleCommandBatch();
       }
@@ -138,7 +138,7 @@ RestStatus MMFilesRestReplicationHandler::execute() {
         goto BAD_CALL;
       }
       if (ServerState::instance()->isCoordinator()) {
-        handleTrampolineCoordinator();
+        return handleTrampolineCoordinator();
       } else {
         handleCommandInventory();
       }
@@ -167,8 +167,11 @@ RestStatus MMFilesRestReplicationHandler::execute() {
         goto BAD_CALL;
       }
 
+      // dump chunks are large and compress well
+      _response->setAllowCompression(true);
+
       if (ServerState::instance()->isCoordinator()) {
-        handleTrampolineCoordinator();
+        return handleTrampolineCoordinator();
       } else {
         handleCommandDump();
       }
@@ -733,7 +736,7 @@ void MMFilesRestReplicationHandler::handleCommandBarrier() {
 /// @brief forward a command in the coordinator case
 ////////////////////////////////////////////////////////////////////////////////
 
-void MMFilesRestReplicationHandler::handleTrampolineCoordinator() {
+RestStatus MMFilesRestReplicationHandler::handleTrampolineCoordinator() {
   bool useVst = false;
   if (_request->transportType() == Endpoint::TransportType::VST) {
     useVst = true;
@@ -748,7 +751,7 @@ void MMFilesRestReplicationHandler::handleTrampolineCoordinator() {
   if (DBserver.empty()) {
     generateError(rest::ResponseCode::BAD, TRI_ERROR_HTTP_BAD_PARAMETER,
                   "need \"DBserver\" parameter");
-    return;
+    return RestStatus::DONE;
   }
 
   std::string const& dbname = _request->databaseName();
@@ -777,10 +780,11 @@ void MMFilesRestReplicationHandler::handleTrampolineCoordinator() {
     // nullptr happens only during controlled shutdown
     generateError(rest::ResponseCode::BAD, TRI_ERROR_SHUTTING_DOWN,
                   "shutting down server");
-    return;
+    return RestStatus::DONE;
   }
 
-  std::unique_ptr<ClusterCommResult> res;
+  std::shared_ptr<std::string const> body;
+
   if (!useVst) {
     HttpRequest* httpRequest = dynamic_cast<HttpRequest*>(_request.get());
     if (httpRequest == nullptr) {
@@ -788,67 +792,87 @@ void MMFilesRestReplicationHandler::handleTrampolineCoordinator() {
                                      "invalid request type");
     }
 
-    // Send a synchronous request to that shard using ClusterComm:
-    res = cc->syncRequest("", TRI_NewTickServer(), "server:" + DBserver,
-                          _request->requestType(),
-                          "/_db/" + StringUtils::urlEncode(dbname) +
-                              _request->requestPath() + params,
-                          httpRequest->body(), *headers, 300.0);
+    body = std::make_shared<std::string const>(httpRequest->body());
   } else {
     // do we need to handle multiple payloads here - TODO
     // here we switch vorm vst to http?!
     // i am not allowed to change cluster comm!
-    res = cc->syncRequest("", TRI_NewTickServer(), "server:" + DBserver,
-                          _request->requestType(),
-                          "/_db/" + StringUtils::urlEncode(dbname) +
-                              _request->requestPath() + params,
-                          _request->payload().toJson(), *headers, 300.0);
-  }
+    body = std::make_shared<std::string const>(_request->payload().toJson());
+  }
+
+  std::string const destination = "server:" + DBserver;
+  std::string const path = "/_db/" + StringUtils::urlEncode(dbname) +
+                           _request->requestPath() + params;
+  auto const requestType = _request->requestType();
+  auto result = std::make_shared<ClusterCommResult>();
+
+  // do not block a thread while the DBserver is working, the handler
+  // continues as soon as the answer has arrived
+  auto send = [cc, destination, requestType, path, body, headers,
+               result](std::function<void()> next) {
+    auto headerFields =
+        std::make_unique<std::unordered_map<std::string, std::string>>(
+            *headers);
+    auto callback = std::make_shared<ClusterCommFunctionCallback>(
+        [result, next](ClusterCommResult* res) {
+          *result = *res;
+          next();
+        });
+
+    cc->asyncRequest("", TRI_NewTickServer(), destination, requestType, path,
+                     body, headerFields, callback, 300.0, true);
+  };
+
+  auto forward = [this, result, useVst]() {
+    ClusterCommResult const& res = *result;
+
+    if (res.status == CL_COMM_TIMEOUT) {
+      // No reply, we give up:
+      generateError(rest::ResponseCode::BAD, TRI_ERROR_CLUSTER_TIMEOUT,
+                    "timeout within cluster");
+      return;
+    }
+    if (res.status == CL_COMM_BACKEND_UNAVAILABLE) {
+      // there is no result
+      generateError(rest::ResponseCode::BAD, TRI_ERROR_CLUSTER_CONNECTION_LOST,
+                    "lost connection within cluster");
+      return;
+    }
+    if (res.status == CL_COMM_ERROR) {
+      // This could be a broken connection or an Http error:
+      TRI_ASSERT(nullptr != res.result && res.result->isComplete());
+      // In this case a proper HTTP error was reported by the DBserver,
+      // we simply forward the result.
+      // We intentionally fall through here.
+    }
 
-  if (res->status == CL_COMM_TIMEOUT) {
-    // No reply, we give up:
-    generateError(rest::ResponseCode::BAD, TRI_ERROR_CLUSTER_TIMEOUT,
-                  "timeout within cluster");
-    return;
-  }
-  if (res->status == CL_COMM_BACKEND_UNAVAILABLE) {
-    // there is no result
-    generateError(rest::ResponseCode::BAD, TRI_ERROR_CLUSTER_CONNECTION_LOST,
-                  "lost connection within cluster");
-    return;
-  }
-  if (res->status == CL_COMM_ERROR) {
-    // This could be a broken connection or an Http error:
-    TRI_ASSERT(nullptr != res->result && res->result->isComplete());
-    // In this case a proper HTTP error was reported by the DBserver,
-    // we simply forward the result.
-    // We intentionally fall through here.
-  }
+    bool dummy;
+    resetResponse(
+        static_cast<rest::ResponseCode>(res.result->getHttpReturnCode()));
 
-  bool dummy;
-  resetResponse(
-      static_cast<rest::ResponseCode>(res->result->getHttpReturnCode()));
+    _response->setContentType(
+        res.result->getHeaderField(StaticStrings::ContentTypeHeader, dummy));
 
-  _response->setContentType(
-      res->result->getHeaderField(StaticStrings::ContentTypeHeader, dummy));
+    if (!useVst) {
+      HttpResponse* httpResponse = dynamic_cast<HttpResponse*>(_response.get());
+      if (_response == nullptr) {
+        THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL,
+                                       "invalid response type");
+      }
+      httpResponse->body().swap(&(res.result->getBody()));
+    } else {
+      // TODO copy all payloads
+      VPackSlice slice = res.result->getBodyVelocyPack()->slice();
+      _response->setPayload(slice, true);  // do we need to generate the body?!
+    }
 
-  if (!useVst) {
-    HttpResponse* httpResponse = dynamic_cast<HttpResponse*>(_response.get());
-    if (_response == nullptr) {
-      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL,
-                                     "invalid response type");
+    auto const& resultHeaders = res.result->getHeaderFields();
+    for (auto const& it : resultHeaders) {
+      _response->setHeader(it.first, it.second);
     }
-    httpResponse->body().swap(&(res->result->getBody()));
-  } else {
-    // TODO copy all payloads
-    VPackSlice slice = res->result->getBodyVelocyPack()->slice();
-    _response->setPayload(slice, true);  // do we need to generate the body?!
-  }
+  };
 
-  auto const& resultHeaders = res->result->getHeaderFields();
-  for (auto const& it : resultHeaders) {
-    _response->setHeader(it.first, it.second);
-  }
+  return RestStatus::WAIT_FOR(send).then(forward).done();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2824,6 +2848,10 @@ void MMFilesRestReplicationHandler::handleCommandMakeSlave() {
       body, "sslProtocol", defaults._sslProtocol);
   config._chunkSize = VelocyPackHelper::getNumericValue<uint64_t>(
       body, "chunkSize", defaults._chunkSize);
+  config._initialSyncParallelism = VelocyPackHelper::getNumericValue<uint64_t>(
+      body, "initialSyncParallelism", defaults._initialSyncParallelism);
+  config._applyParallelism = VelocyPackHelper::getNumericValue<uint64_t>(
+      body, "applyParallelism", defaults._applyParallelism);
   config._autoStart = true;
   config._adaptivePolling = VelocyPackHelper::getBooleanValue(
       body, "adaptivePolling", defaults._adaptivePolling);
@@ -3017,6 +3045,8 @@ void MMFilesRestReplicationHandler::handleCommandSync() {
   config._includeSystem = includeSystem;
   config._verbose = verbose;
   config._useCollectionId = useCollectionId;
+  config._initialSyncParallelism = VelocyPackHelper::getNumericValue<uint64_t>(
+      body, "initialSyncParallelism", config._initialSyncParallelism);
 
   // wait until all data in current logfile got synced
   MMFilesLogfileManager::instance()->waitForSync(5.0);
@@ -3146,6 +3176,10 @@ void MMFilesRestReplicationHandler::handleCommandApplierSetConfig() {
       body, "sslProtocol", config._sslProtocol);
   config._chunkSize = VelocyPackHelper::getNumericValue<uint64_t>(
       body, "chunkSize", config._chunkSize);
+  config._initialSyncParallelism = VelocyPackHelper::getNumericValue<uint64_t>(
+      body, "initialSyncParallelism", config._initialSyncParallelism);
+  config._applyParallelism = VelocyPackHelper::getNumericValue<uint64_t>(
+      body, "applyParallelism", config._applyParallelism);
   config._autoStart =
       VelocyPackHelper::getBooleanValue(body, "autoStart", config._autoStart);
   config._adaptivePolling = VelocyPackHelper::getBooleanValue(
@@ -51,6 +51,7 @@ class MMFilesRestReplicationHandler : public RestVocbaseBaseHandler {
   char const* name() const override final {
     return "MMFilesRestReplicationHandler";
   }
+  size_t queue() const override { return JobQueue::BACKGROUND_QUEUE; }
 
  public:
   //////////////////////////////////////////////////////////////////////////////
@@ -160,7 +161,7 @@ class MMFilesRestReplicationHandler : public RestVocbaseBaseHandler {
   /// @brief forward a command in the coordinator case
   //////////////////////////////////////////////////////////////////////////////
 
-  void handleTrampolineCoordinator();
+  RestStatus handleTrampolineCoordinator();
 
   //////////////////////////////////////////////////////////////////////////////
   /// @brief return the inventory (current replication and collection state)
@@ -26,6 +26,7 @@
 #include "Cluster/ClusterMethods.h"
 #include "Cluster/ServerState.h"
 #include "MMFiles/MMFilesLogfileManager.h"
+#include "MMFiles/MMFilesWalSlots.h"
 
 using namespace arangodb;
 using namespace arangodb::rest;
@@ -63,6 +64,11 @@ RestStatus MMFilesRestWalHandler::execute() {
       properties();
       return RestStatus::DONE;
     }
+  } else if (operation == "sync") {
+    if (type == rest::RequestType::GET) {
+      syncStatistics();
+      return RestStatus::DONE;
+    }
   } else {
     generateError(rest::ResponseCode::BAD, TRI_ERROR_HTTP_BAD_PARAMETER,
                   "expecting /_admin/wal/<operation>");
@@ -203,6 +209,44 @@ void MMFilesRestWalHandler::flush() {
   generateResult(rest::ResponseCode::OK, basics::VelocyPackHelper::EmptyObjectValue());
 }
 
+/// @brief adds a time distribution, in seconds
+static void AddDistribution(VPackBuilder& builder, std::string const& name,
+                            basics::StatisticsDistribution const& dist) {
+  builder.add(name, VPackValue(VPackValueType::Object));
+  builder.add("sum", VPackValue(dist._total));
+  builder.add("count", VPackValue(dist._count));
+
+  builder.add("cuts", VPackValue(VPackValueType::Array));
+  for (auto const& it : dist._cuts) {
+    builder.add(VPackValue(it));
+  }
+  builder.close();
+
+  builder.add("counts", VPackValue(VPackValueType::Array));
+  for (auto const& it : dist._counts) {
+    builder.add(VPackValue(it));
+  }
+  builder.close();
+
+  builder.close();
+}
+
+void MMFilesRestWalHandler::syncStatistics() {
+  basics::StatisticsDistribution syncTime;
+  basics::StatisticsDistribution durableTime;
+  MMFilesLogfileManager::instance()->slots()->syncStatistics(syncTime, durableTime);
+
+  VPackBuilder builder;
+  builder.openObject();
+  // time from starting the writeback of a region until it was durable
+  AddDistribution(builder, "syncTime", syncTime);
+  // time waitForSync writers waited until their data was durable
+  AddDistribution(builder, "durableTime", durableTime);
+  builder.close();
+
+  generateResult(rest::ResponseCode::OK, builder.slice());
+}
+
 void MMFilesRestWalHandler::transactions() {
   auto const& info =
       MMFilesLogfileManager::instance()->runningTransactions();
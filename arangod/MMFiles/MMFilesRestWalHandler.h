@@ -41,6 +41,7 @@ class MMFilesRestWalHandler : public RestVocbaseBaseHandler {
   void flush();
   void transactions();
   void properties();
+  void syncStatistics();
 };
 }
 
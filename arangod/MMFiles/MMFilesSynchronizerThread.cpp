@@ -45,6 +45,10 @@ static constexpr inline uint64_t syncWaitersMask() {
 /// for use in _waiters only
 static constexpr inline int asyncWaitersBits() { return 32; }
 
+/// @brief maximum number of regions synced in one go, before the waiters
+/// are checked again
+static constexpr inline int maxRegionsPerSync() { return 64; }
+
 MMFilesSynchronizerThread::MMFilesSynchronizerThread(MMFilesLogfileManager* logfileManager,
                                        uint64_t syncInterval)
     : Thread("WalSynchronizer"),
@@ -91,15 +95,7 @@ void MMFilesSynchronizerThread::run() {
 
       try {
         // sync as much as we can in this loop
-        bool checkMore = false;
-
-        while (true) {
-          int res = doSync(checkMore);
-
-          if (res != TRI_ERROR_NO_ERROR || !checkMore) {
-            break;
-          }
-        }
+        doSync();
       } catch (arangodb::basics::Exception const& ex) {
         int res = ex.code();
         LOG_TOPIC(ERR, arangodb::Logger::FIXME) << "got unexpected error in synchronizerThread: "
@@ -139,18 +135,68 @@ void MMFilesSynchronizerThread::run() {
   }
 }
 
-/// @brief synchronize an unsynchronized region
-int MMFilesSynchronizerThread::doSync(bool& checkMore) {
-  checkMore = false;
+/// @brief synchronize as many regions as are available. regions are
+/// pipelined: the writeback of the next region is started before waiting
+/// for the previous one to become durable, so that their I/O overlaps
+int MMFilesSynchronizerThread::doSync() {
+  MMFilesWalSlots* slots = _logfileManager->slots();
 
-  // get region to sync
-  MMFilesWalSyncRegion region = _logfileManager->slots()->getSyncRegion();
-  MMFilesWalLogfile::IdType const id = region.logfileId;
+  MMFilesWalSyncRegion pending;
+  double pendingStart = 0.0;
+
+  for (int i = 0; ; ++i) {
+    MMFilesWalSyncRegion next;
+
+    if (i < maxRegionsPerSync()) {
+      // get the region behind the one that is still being synced
+      next = slots->getSyncRegion(pending.logfileId == 0 ? nullptr : &pending);
+    }
+
+    double const nextStart = TRI_microtime();
+
+    // an id of 0 means an empty region...
+    if (next.logfileId != 0) {
+      startSync(next);
+    }
+
+    if (pending.logfileId != 0) {
+      int res = finishSync(pending, pendingStart);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        // the next region has not been returned, and will be handed out
+        // again in the next round
+        return res;
+      }
+    }
 
-  // an id of 0 means an empty region...
-  if (id == 0) {
-    return TRI_ERROR_NO_ERROR;
+    if (next.logfileId == 0) {
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    pending = next;
+    pendingStart = nextStart;
   }
+}
+
+/// @brief start writing back a region without waiting for it
+void MMFilesSynchronizerThread::startSync(MMFilesWalSyncRegion const& region) {
+  TRI_ASSERT(region.logfile != nullptr);
+
+  int fd = getLogfileDescriptor(region.logfileId);
+  TRI_ASSERT(fd >= 0);
+
+  int64_t offset = static_cast<int64_t>(region.mem - region.logfile->df()->data());
+
+  // failing to start the writeback early is harmless, finishSync does
+  // the real work
+  TRI_StartFlushMMFile(fd, offset, region.size);
+}
+
+/// @brief make a region durable and return it to the slots
+int MMFilesSynchronizerThread::finishSync(MMFilesWalSyncRegion const& region,
+                                          double startTime) {
+  MMFilesWalLogfile::IdType const id = region.logfileId;
+  TRI_ASSERT(id != 0);
 
   // now perform the actual syncing
   auto status = region.logfileStatus;
@@ -161,9 +207,9 @@ int MMFilesSynchronizerThread::doSync(bool& checkMore) {
   int fd = getLogfileDescriptor(region.logfileId);
   TRI_ASSERT(fd >= 0);
 
-  double startTime = TRI_microtime();
   bool result = TRI_MSync(fd, region.mem, region.mem + region.size);
-  if (TRI_microtime() - startTime > 1.0) {
+  double const syncTime = TRI_microtime() - startTime;
+  if (syncTime > 1.0) {
     LOG_TOPIC(DEBUG, arangodb::Logger::FIXME) << "Long sync logfile " << id << ", region "
       << (void*) region.mem << ", size " << region.size;
   }
@@ -209,9 +255,8 @@ int MMFilesSynchronizerThread::doSync(bool& checkMore) {
     }
   }
 
-  checkMore = region.checkMore;
-
   _logfileManager->slots()->returnSyncRegion(region);
+  _logfileManager->slots()->addSyncTime(syncTime);
   return TRI_ERROR_NO_ERROR;
 }
 
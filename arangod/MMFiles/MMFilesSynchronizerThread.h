@@ -28,6 +28,7 @@
 #include "Basics/ConditionVariable.h"
 #include "Basics/Thread.h"
 #include "MMFiles/MMFilesWalLogfile.h"
+#include "MMFiles/MMFilesWalSyncRegion.h"
 
 namespace arangodb {
 class MMFilesLogfileManager;
@@ -53,8 +54,14 @@ class MMFilesSynchronizerThread final : public Thread {
   void run() override;
 
  private:
-  /// @brief synchronize an unsynchronized region
-  int doSync(bool&);
+  /// @brief synchronize as many regions as are available
+  int doSync();
+
+  /// @brief start writing back a region without waiting for it
+  void startSync(MMFilesWalSyncRegion const&);
+
+  /// @brief make a region durable and return it to the slots
+  int finishSync(MMFilesWalSyncRegion const&, double);
 
   /// @brief get a logfile descriptor (it caches the descriptor for performance)
   int getLogfileDescriptor(MMFilesWalLogfile::IdType);
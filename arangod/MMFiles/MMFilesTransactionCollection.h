@@ -64,6 +64,8 @@ class MMFilesTransactionCollection final : public TransactionCollection {
 
   void freeOperations(transaction::Methods* activeTrx, bool mustRollback) override;
 
+  AccessMode::Type accessType() const override { return _accessType; }
+
   bool canAccess(AccessMode::Type accessType) const override;
   int updateUsage(AccessMode::Type accessType, int nestingLevel) override;
   int use(int nestingLevel) override;
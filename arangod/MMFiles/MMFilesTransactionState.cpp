@@ -168,6 +168,7 @@ Result MMFilesTransactionState::commitTransaction(transaction::Methods* activeTr
     }
 
     updateStatus(transaction::Status::COMMITTED);
+    applyViewChanges();
 
     // if a write query, clear the query cache for the participating collections
     if (AccessMode::isWriteOrExclusive(_type) &&
@@ -323,8 +324,7 @@ int MMFilesTransactionState::addOperation(TRI_voc_rid_t revisionId,
     }
     operation.handled();
 
-    arangodb::aql::QueryCache::instance()->invalidate(
-        _vocbase, collection->name());
+    invalidateQueryCache(collection->name(), operation.key());
 
     physical->increaseUncollectedLogfileEntries(1);
   } else {
@@ -332,6 +332,7 @@ int MMFilesTransactionState::addOperation(TRI_voc_rid_t revisionId,
     TransactionCollection* trxCollection = this->collection(collection->cid(), AccessMode::Type::WRITE);
     
     std::unique_ptr<MMFilesDocumentOperation> copy(operation.clone());
+    StringRef const key = copy->key();
    
     TRI_IF_FAILURE("TransactionOperationPushBack") {
       THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG); 
@@ -349,8 +350,7 @@ int MMFilesTransactionState::addOperation(TRI_voc_rid_t revisionId,
     operation.swapped();
     _hasOperations = true;
     
-    arangodb::aql::QueryCache::instance()->invalidate(
-        _vocbase, collection->name());
+    invalidateQueryCache(collection->name(), key);
   }
 
   physical->setRevision(revisionId, false);
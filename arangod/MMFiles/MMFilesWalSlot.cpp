@@ -37,7 +37,7 @@ MMFilesWalSlot::MMFilesWalSlot()
 
 /// @brief return the slot status as a string
 std::string MMFilesWalSlot::statusText() const {
-  switch (_status) {
+  switch (status()) {
     case StatusType::UNUSED:
       return "unused";
     case StatusType::USED:
@@ -131,7 +131,7 @@ void MMFilesWalSlot::setUnused() {
   _logfile = nullptr;
   _mem = nullptr;
   _size = 0;
-  _status = StatusType::UNUSED;
+  _status.store(StatusType::UNUSED, std::memory_order_release);
 }
 
 /// @brief mark as slot as used
@@ -143,7 +143,7 @@ void MMFilesWalSlot::setUsed(void* mem, uint32_t size, MMFilesWalLogfile* logfil
   _logfile = logfile;
   _mem = mem;
   _size = size;
-  _status = StatusType::USED;
+  _status.store(StatusType::USED, std::memory_order_release);
 }
 
 /// @brief mark as slot as returned
@@ -151,8 +151,8 @@ void MMFilesWalSlot::setReturned(bool waitForSync) {
   TRI_ASSERT(_logfile != nullptr);
   TRI_ASSERT(isUsed());
   if (waitForSync) {
-    _status = StatusType::RETURNED_WFS;
+    _status.store(StatusType::RETURNED_WFS, std::memory_order_release);
   } else {
-    _status = StatusType::RETURNED;
+    _status.store(StatusType::RETURNED, std::memory_order_release);
   }
 }
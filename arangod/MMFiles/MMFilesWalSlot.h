@@ -27,6 +27,8 @@
 #include "Basics/Common.h"
 #include "MMFiles/MMFilesWalLogfile.h"
 
+#include <atomic>
+
 namespace arangodb {
 class MMFilesWalSlots;
 class MMFilesWalMarker;
@@ -84,20 +86,28 @@ class MMFilesWalSlot {
 
  private:
   /// @brief whether or not the slot is unused
-  inline bool isUnused() const { return _status == StatusType::UNUSED; }
+  inline bool isUnused() const { return status() == StatusType::UNUSED; }
 
   /// @brief whether or not the slot is used
-  inline bool isUsed() const { return _status == StatusType::USED; }
+  inline bool isUsed() const { return status() == StatusType::USED; }
 
   /// @brief whether or not the slot is returned
   inline bool isReturned() const {
-    return (_status == StatusType::RETURNED ||
-            _status == StatusType::RETURNED_WFS);
+    StatusType status = this->status();
+    return (status == StatusType::RETURNED ||
+            status == StatusType::RETURNED_WFS);
   }
 
   /// @brief whether or not a sync was requested for the slot
   inline bool waitForSync() const {
-    return (_status == StatusType::RETURNED_WFS);
+    return (status() == StatusType::RETURNED_WFS);
+  }
+
+  /// @brief return the slot status. slots are returned by their writers
+  /// without holding the slots lock, so the status is read with acquire
+  /// semantics to make the marker data visible to the synchronizer
+  inline StatusType status() const {
+    return _status.load(std::memory_order_acquire);
   }
 
   /// @brief mark as slot as unused
@@ -127,7 +137,7 @@ class MMFilesWalSlot {
   uint32_t _size;
 
   /// @brief slot status
-  StatusType _status; 
+  std::atomic<StatusType> _status;
 };
 
 static_assert(sizeof(MMFilesWalSlot) == 32, "invalid slot size");
@@ -36,6 +36,14 @@ using namespace arangodb;
   
 static uint32_t const PrologueSize = encoding::alignedSize<uint32_t>(sizeof(MMFilesPrologueMarker));
 
+/// @brief cuts for the sync time distributions, in seconds
+static basics::StatisticsVector SyncTimeCuts() {
+  basics::StatisticsVector cuts;
+  cuts << 0.0001 << 0.0005 << 0.001 << 0.002 << 0.005 << 0.01 << 0.02
+       << 0.05 << 0.1 << 0.5 << 1.0;
+  return cuts;
+}
+
 /// @brief create the slots
 MMFilesWalSlots::MMFilesWalSlots(MMFilesLogfileManager* logfileManager, size_t numberOfSlots,
              MMFilesWalSlot::TickType tick)
@@ -46,6 +54,7 @@ MMFilesWalSlots::MMFilesWalSlots(MMFilesLogfileManager* logfileManager, size_t n
       _numberOfSlots(numberOfSlots),
       _freeSlots(numberOfSlots),
       _waiting(0),
+      _tickWaiters(0),
       _handoutIndex(0),
       _recycleIndex(0),
       _logfile(nullptr),
@@ -54,6 +63,9 @@ MMFilesWalSlots::MMFilesWalSlots(MMFilesLogfileManager* logfileManager, size_t n
       _lastCommittedDataTick(0),
       _numEvents(0),
       _numEventsSync(0),
+      _statisticsLock(),
+      _syncTime(SyncTimeCuts()),
+      _durableTime(SyncTimeCuts()),
       _lastDatabaseId(0),
       _lastCollectionId(0), 
       _shutdown(false) {
@@ -77,10 +89,10 @@ void MMFilesWalSlots::statistics(MMFilesWalSlot::TickType& lastAssignedTick,
                        uint64_t& numEventsSync) {
   MUTEX_LOCKER(mutexLocker, _lock);
   lastAssignedTick = _lastAssignedTick;
-  lastCommittedTick = _lastCommittedTick;
+  lastCommittedTick = _lastCommittedTick.load();
   lastCommittedDataTick = _lastCommittedDataTick;
-  numEvents = _numEvents;
-  numEventsSync = _numEventsSync;
+  numEvents = _numEvents.load(std::memory_order_relaxed);
+  numEventsSync = _numEventsSync.load(std::memory_order_relaxed);
 }
   
 /// @brief initially set the last ticks on start
@@ -89,8 +101,8 @@ void MMFilesWalSlots::setLastTick(MMFilesWalSlot::TickType const& tick) {
   if (tick > _lastAssignedTick) {
     _lastAssignedTick = tick;
   }
-  if (tick > _lastCommittedTick) {
-    _lastCommittedTick = tick;
+  if (tick > _lastCommittedTick.load()) {
+    _lastCommittedTick.store(tick);
   }
   if (tick > _lastCommittedDataTick) {
     _lastCommittedDataTick = tick;
@@ -131,9 +143,10 @@ int MMFilesWalSlots::flush(bool waitForSync) {
 }
 
 /// @brief return the last committed tick
+/// this does not use the slots lock, as it is polled by all threads waiting
+/// for their markers to be synced
 MMFilesWalSlot::TickType MMFilesWalSlots::lastCommittedTick() {
-  MUTEX_LOCKER(mutexLocker, _lock);
-  return _lastCommittedTick;
+  return _lastCommittedTick.load(std::memory_order_acquire);
 }
 
 /// @brief return the next unused slot
@@ -300,13 +313,7 @@ MMFilesWalSlotInfo MMFilesWalSlots::nextUnused(TRI_voc_tick_t databaseId, TRI_vo
       hasWaited = true;
     }
 
-    bool mustWait;
-    {
-      MUTEX_LOCKER(mutexLocker, _lock);
-      mustWait = (_freeSlots < 2);
-    }
-
-    if (mustWait) {
+    if (_freeSlots.load() < 2) {
       guard.wait(10 * 1000);
     }
   }
@@ -322,20 +329,20 @@ int MMFilesWalSlots::returnUsed(MMFilesWalSlotInfo& slotInfo, bool wakeUpSynchro
   TRI_ASSERT(!waitUntilSyncDone || waitForSyncRequested);
 
   MMFilesWalSlot::TickType tick = slotInfo.slot->tick();
-  MMFilesMarker const* marker = reinterpret_cast<MMFilesMarker const*>(slotInfo.slot->mem());
-  MMFilesWalLogfile const* logfile = slotInfo.logfile;
 
   TRI_ASSERT(tick > 0);
 
-  {
-    MUTEX_LOCKER(mutexLocker, _lock);
-    TRI_UpdateTicksDatafile(logfile->df(), marker);
-    slotInfo.slot->setReturned(waitForSyncRequested);
-    if (waitForSyncRequested) {
-      ++_numEventsSync;
-    } else {
-      ++_numEvents;
-    }
+  // returning a slot does not need the slots lock. only this thread can
+  // modify the slot until it is returned, and the synchronizer picks it up
+  // via its status. the logfile's tick range is updated by the synchronizer
+  // when it returns the slot's region in order (see returnSyncRegion)
+  // note: the slot may be recycled right after this call, so it must not
+  // be accessed anymore afterwards
+  slotInfo.slot->setReturned(waitForSyncRequested);
+  if (waitForSyncRequested) {
+    _numEventsSync.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    _numEvents.fetch_add(1, std::memory_order_relaxed);
   }
 
   wakeUpSynchronizer |= waitForSyncRequested;
@@ -351,14 +358,20 @@ int MMFilesWalSlots::returnUsed(MMFilesWalSlotInfo& slotInfo, bool wakeUpSynchro
       return TRI_ERROR_SHUTTING_DOWN;
     }
 
-    waitForTick(tick);
+    double const startTime = TRI_microtime();
+    bool synced = waitForTick(tick);
+
+    if (synced) {
+      MUTEX_LOCKER(statisticsLocker, _statisticsLock);
+      _durableTime.addFigure(TRI_microtime() - startTime);
+    }
   }
 
   return TRI_ERROR_NO_ERROR;
 }
 
 /// @brief get the next synchronisable region
-MMFilesWalSyncRegion MMFilesWalSlots::getSyncRegion() {
+MMFilesWalSyncRegion MMFilesWalSlots::getSyncRegion(MMFilesWalSyncRegion const* previous) {
   bool sealRequested = false;
   MMFilesWalSyncRegion region;
 
@@ -366,6 +379,21 @@ MMFilesWalSyncRegion MMFilesWalSlots::getSyncRegion() {
 
   size_t slotIndex = _recycleIndex;
 
+  if (previous != nullptr) {
+    TRI_ASSERT(previous->logfileId != 0);
+    TRI_ASSERT(previous->firstSlotIndex == _recycleIndex);
+
+    slotIndex = previous->lastSlotIndex;
+    if (++slotIndex >= _numberOfSlots) {
+      slotIndex = 0;
+    }
+
+    if (slotIndex == _recycleIndex) {
+      // the previous region covers all slots
+      return region;
+    }
+  }
+
   while (true) {
     MMFilesWalSlot const* slot = &_slots[slotIndex];
     TRI_ASSERT(slot != nullptr);
@@ -449,8 +477,8 @@ void MMFilesWalSlots::returnSyncRegion(MMFilesWalSyncRegion const& region) {
 
       // note last tick
       MMFilesWalSlot::TickType tick = slot->tick();
-      TRI_ASSERT(tick >= _lastCommittedTick);
-      _lastCommittedTick = tick;
+      TRI_ASSERT(tick >= _lastCommittedTick.load());
+      _lastCommittedTick.store(tick, std::memory_order_release);
 
       // update the data tick
       MMFilesMarker const* m =
@@ -483,7 +511,7 @@ void MMFilesWalSlots::returnSyncRegion(MMFilesWalSyncRegion const& region) {
   // signal that we have done something
   CONDITION_LOCKER(guard, _condition);
 
-  if (_waiting > 0 || region.waitForSync) {
+  if (_waiting > 0 || _tickWaiters.load() > 0 || region.waitForSync) {
     _condition.broadcast();
   }
 }
@@ -523,7 +551,7 @@ int MMFilesWalSlots::closeLogfile(MMFilesWalSlot::TickType& lastCommittedTick, b
     {
       MUTEX_LOCKER(mutexLocker, _lock);
 
-      lastCommittedTick = _lastCommittedTick;
+      lastCommittedTick = _lastCommittedTick.load();
 
       MMFilesWalSlot* slot = &_slots[_handoutIndex];
       TRI_ASSERT(slot != nullptr);
@@ -611,13 +639,7 @@ int MMFilesWalSlots::closeLogfile(MMFilesWalSlot::TickType& lastCommittedTick, b
       hasWaited = true;
     }
 
-    bool mustWait;
-    {
-      MUTEX_LOCKER(mutexLocker, _lock);
-      mustWait = (_freeSlots < 2);
-    }
-
-    if (mustWait) {
+    if (_freeSlots.load() < 2) {
       guard.wait(10 * 1000);
     }
     
@@ -721,20 +743,48 @@ size_t MMFilesWalSlots::nextHandoutIndex() const {
 /// @brief wait until all data has been synced up to a certain marker
 bool MMFilesWalSlots::waitForTick(MMFilesWalSlot::TickType tick) {
   static uint64_t const SleepTime = 10000;
-  static int const MaxIterations = 30 * 1000 * 1000 / SleepTime;
-  int iterations = 0;
+  static double const MaxWaitTime = 30.0;
 
-  // wait until data has been committed to disk
-  do {
-    if (lastCommittedTick() >= tick) {
-      return true;
-    }
+  if (lastCommittedTick() >= tick) {
+    return true;
+  }
+
+  // returnSyncRegion broadcasts while there are waiters. the committed tick
+  // is checked again under the condition lock, so that a broadcast cannot
+  // get lost between the check and the wait
+  ++_tickWaiters;
+  bool synced = false;
 
+  {
+    double const end = TRI_microtime() + MaxWaitTime;
     CONDITION_LOCKER(guard, _condition);
-    guard.wait(SleepTime);
-  } while (++iterations < MaxIterations);
 
-  return false;
+    do {
+      if (lastCommittedTick() >= tick) {
+        synced = true;
+        break;
+      }
+
+      guard.wait(SleepTime);
+    } while (TRI_microtime() < end);
+  }
+
+  --_tickWaiters;
+  return synced;
+}
+
+/// @brief note how long it took to sync a region
+void MMFilesWalSlots::addSyncTime(double value) {
+  MUTEX_LOCKER(statisticsLocker, _statisticsLock);
+  _syncTime.addFigure(value);
+}
+
+/// @brief get the distributions of the sync times
+void MMFilesWalSlots::syncStatistics(basics::StatisticsDistribution& syncTime,
+                                     basics::StatisticsDistribution& durableTime) {
+  MUTEX_LOCKER(statisticsLocker, _statisticsLock);
+  syncTime = _syncTime;
+  durableTime = _durableTime;
 }
 
 /// @brief request a new logfile which can satisfy a marker of the
@@ -30,6 +30,9 @@
 #include "MMFiles/MMFilesWalSlot.h"
 #include "MMFiles/MMFilesWalSyncRegion.h"
 #include "MMFiles/MMFilesWalLogfile.h"
+#include "Statistics/figures.h"
+
+#include <atomic>
 
 namespace arangodb {
 class MMFilesLogfileManager;
@@ -111,8 +114,9 @@ class MMFilesWalSlots {
   int returnUsed(MMFilesWalSlotInfo&, bool wakeUpSynchronizer,
                  bool waitForSyncRequested, bool waitUntilSyncDone);
 
-  /// @brief get the next synchronizable region
-  MMFilesWalSyncRegion getSyncRegion();
+  /// @brief get the next synchronizable region. if previous is given, the
+  /// region starts behind it. previous must not have been returned yet
+  MMFilesWalSyncRegion getSyncRegion(MMFilesWalSyncRegion const* previous = nullptr);
 
   /// @brief return a region to the freelist
   void returnSyncRegion(MMFilesWalSyncRegion const&);
@@ -147,6 +151,14 @@ class MMFilesWalSlots {
   /// @brief wait until all data has been synced up to a certain marker
   bool waitForTick(MMFilesWalSlot::TickType);
 
+  /// @brief note how long it took to sync a region
+  void addSyncTime(double);
+
+  /// @brief get the distributions of the region sync times and of the times
+  /// waitForSync writers waited for their markers to become durable
+  void syncStatistics(basics::StatisticsDistribution& syncTime,
+                      basics::StatisticsDistribution& durableTime);
+
   /// @brief request a new logfile which can satisfy a marker of the
   /// specified size
   int newLogfile(uint32_t, MMFilesWalLogfile::StatusType& status);
@@ -158,7 +170,8 @@ class MMFilesWalSlots {
   /// @brief condition variable for slots
   basics::ConditionVariable _condition;
 
-  /// @brief mutex protecting the slots interface
+  /// @brief mutex protecting the slot handout and the logfile rotation.
+  /// returning slots and reading the committed tick do not acquire it
   Mutex _lock;
 
   /// @brief all slots
@@ -168,11 +181,14 @@ class MMFilesWalSlots {
   size_t const _numberOfSlots;
 
   /// @brief the number of currently free slots
-  size_t _freeSlots;
+  std::atomic<size_t> _freeSlots;
 
   /// @brief whether or not someone is waiting for a slot
   uint32_t _waiting;
 
+  /// @brief number of threads waiting in waitForTick
+  std::atomic<uint32_t> _tickWaiters;
+
   /// @brief the index of the slot to hand out next
   size_t _handoutIndex;
 
@@ -186,16 +202,25 @@ class MMFilesWalSlots {
   MMFilesWalSlot::TickType _lastAssignedTick;
 
   /// @brief last committed tick value
-  MMFilesWalSlot::TickType _lastCommittedTick;
+  std::atomic<MMFilesWalSlot::TickType> _lastCommittedTick;
 
   /// @brief last committed data tick value
   MMFilesWalSlot::TickType _lastCommittedDataTick;
 
   /// @brief number of log events handled
-  uint64_t _numEvents;
+  std::atomic<uint64_t> _numEvents;
 
   /// @brief number of sync log events handled
-  uint64_t _numEventsSync;
+  std::atomic<uint64_t> _numEventsSync;
+
+  /// @brief mutex protecting the sync time distributions
+  Mutex _statisticsLock;
+
+  /// @brief time it took to sync a region
+  basics::StatisticsDistribution _syncTime;
+
+  /// @brief time waitForSync writers waited for their markers to be synced
+  basics::StatisticsDistribution _durableTime;
   
   /// @brief last written database id (in prologue marker)
   TRI_voc_tick_t _lastDatabaseId;
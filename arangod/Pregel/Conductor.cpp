@@ -94,6 +94,11 @@ Conductor::Conductor(uint64_t executionNumber, TRI_vocbase_t* vocbase,
   if (!_storeResults) {
     LOG_TOPIC(DEBUG, Logger::PREGEL) << "Will keep results in-memory";
   }
+  // checkpoints are only taken at global barriers
+  VPackSlice checkpoints = config.get(Utils::checkpointIntervalKey);
+  if (checkpoints.isInteger() && !_asyncMode) {
+    _checkpointInterval = checkpoints.getUInt();
+  }
 }
 
 Conductor::~Conductor() {
@@ -208,6 +213,11 @@ bool Conductor::_startGlobalStep() {
   } else {
     LOG_TOPIC(DEBUG, Logger::PREGEL) << "Conductor started new gss "
                                      << _globalSuperstep;
+    // workers write a checkpoint when starting these supersteps
+    if (_checkpointInterval > 0 && _globalSuperstep > 0 &&
+        _globalSuperstep % _checkpointInterval == 0) {
+      _checkpointGSS = _globalSuperstep;
+    }
   }
   return res == TRI_ERROR_NO_ERROR;
 }
@@ -330,17 +340,47 @@ void Conductor::finishedRecoveryStep(VPackSlice const& data) {
 
   // the recovery mechanism might be gathering state information
   _aggregators->aggregateValues(data);
+  if (_rollingBack) {
+    VPackSlice restored = data.get(Utils::checkpointRestoredKey);
+    _checkpointRestored =
+        _checkpointRestored && restored.isBool() && restored.getBool();
+  }
   if (_respondedServers.size() != _dbServers.size()) {
     return;
   }
 
-  // only compensations supported
+  int res = TRI_ERROR_NO_ERROR;
+  if (_rollingBack) {
+    _rollingBack = false;
+    if (!_checkpointRestored) {
+      cancel();
+      LOG_TOPIC(INFO, Logger::PREGEL) << "Rollback failed";
+      return;
+    }
+    LOG_TOPIC(INFO, Logger::PREGEL) << "Rolled back to gss "
+                                    << _globalSuperstep;
+
+    VPackBuilder b;
+    b.openObject();
+    b.add(Utils::executionNumberKey, VPackValue(_executionNumber));
+    b.add(Utils::globalSuperstepKey, VPackValue(_globalSuperstep));
+    b.close();
+    res = _sendToAllDBServers(Utils::finalizeRecoveryPath, b);
+    if (res == TRI_ERROR_NO_ERROR) {
+      _state = ExecutionState::RUNNING;
+      _startGlobalStep();
+    } else {
+      cancel();
+      LOG_TOPIC(INFO, Logger::PREGEL) << "Recovery failed";
+    }
+    return;
+  }
+
   bool proceed = false;
   if (_masterContext) {
     proceed = proceed || _masterContext->postCompensation();
   }
 
-  int res = TRI_ERROR_NO_ERROR;
   if (proceed) {
     // reset values which are calculated during the superstep
     _aggregators->resetValues();
@@ -390,7 +430,8 @@ void Conductor::startRecovery() {
   MUTEX_LOCKER(guard, _callbackMutex);
   if (_state != ExecutionState::RUNNING && _state != ExecutionState::IN_ERROR) {
     return;  // maybe we are already in recovery mode
-  } else if (_algorithm->supportsCompensation() == false) {
+  } else if (_checkpointGSS == 0 &&
+             _algorithm->supportsCompensation() == false) {
     LOG_TOPIC(ERR, Logger::PREGEL) << "Algorithm does not support recovery";
     cancel();
     return;
@@ -435,8 +476,13 @@ void Conductor::startRecovery() {
       return;  // seems like we are canceled
     }
 
-    // Let's try recovery
-    if (_masterContext) {
+    // Let's try recovery, rolling back to a checkpoint is preferred
+    // over compensating the lost state
+    _rollingBack = _checkpointGSS > 0;
+    _checkpointRestored = true;
+    if (_rollingBack) {
+      _globalSuperstep = _checkpointGSS;
+    } else if (_masterContext) {
       bool proceed = _masterContext->preCompensation();
       if (!proceed) {
         cancel();
@@ -445,7 +491,9 @@ void Conductor::startRecovery() {
 
     VPackBuilder additionalKeys;
     additionalKeys.openObject();
-    additionalKeys.add(Utils::recoveryMethodKey, VPackValue(Utils::compensate));
+    additionalKeys.add(
+        Utils::recoveryMethodKey,
+        VPackValue(_rollingBack ? Utils::rollback : Utils::compensate));
     _aggregators->serializeValues(b);
     additionalKeys.close();
     _aggregators->resetValues();
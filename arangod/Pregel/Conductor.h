@@ -80,6 +80,14 @@ class Conductor {
   bool _asyncMode = false;
   bool _lazyLoading = false;
   bool _storeResults = false;
+  /// workers write a checkpoint every n supersteps, 0 if disabled
+  uint64_t _checkpointInterval = 0;
+  /// last superstep every worker was told to checkpoint, 0 if none
+  uint64_t _checkpointGSS = 0;
+  /// recovering by rolling back to _checkpointGSS
+  bool _rollingBack = false;
+  /// false if any worker could not restore its checkpoint
+  bool _checkpointRestored = true;
 
   /// persistent tracking of active vertices, send messages, runtimes
   StatsManager _statistics;
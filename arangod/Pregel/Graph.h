@@ -68,17 +68,19 @@ class Edge {
 
   // PregelShard _sourceShard;
   PregelShard _targetShard;
-  PregelKey _toKey;
+  // points into the key table of the GraphStore, every distinct target
+  // key is stored once
+  PregelKey const* _toKey;
   E _data;
 
  public:
   // EdgeEntry() : _nextEntryOffset(0), _dataSize(0), _vertexIDSize(0) {}
-  Edge() : _targetShard(InvalidPregelShard) {}
-  Edge(PregelShard target, PregelKey const& key)
+  Edge() : _targetShard(InvalidPregelShard), _toKey(nullptr) {}
+  Edge(PregelShard target, PregelKey const* key)
       : _targetShard(target), _toKey(key), _data(0) {}
 
   // size_t getSize() { return sizeof(EdgeEntry) + _vertexIDSize + _dataSize; }
-  PregelKey const& toKey() const { return _toKey; }
+  PregelKey const& toKey() const { return *_toKey; }
   // size_t getDataSize() { return _dataSize; }
   inline E* data() {
     return &_data;  // static_cast<E>(this + sizeof(EdgeEntry) + _vertexIDSize);
@@ -54,6 +54,9 @@
 using namespace arangodb;
 using namespace arangodb::pregel;
 
+/// number of vertices written with one bulk update
+static size_t const storeBatchSize = 1000;
+
 static uint64_t TRI_totalSystemMemory() {
 #ifdef _MSC_VER
   MEMORYSTATUSEX status;
@@ -122,11 +125,18 @@ std::unordered_map<ShardID, uint64_t> GraphStore<V, E>::_preallocateMemory() {
   
   size_t requiredMem = vCount * _graphFormat->estimatedVertexSize() +
                        eCount * _graphFormat->estimatedEdgeSize();
-  if (!_config->lazyLoading() && requiredMem > totalMemory / 2) {
+  if (!_config->lazyLoading() &&
+      (_config->useMemoryMaps() || requiredMem > totalMemory / 2)) {
+    LOG_TOPIC(DEBUG, Logger::PREGEL) << "Using memory mapped files";
+    // vertices and edges are read in order during a superstep
     if (_graphFormat->estimatedVertexSize() > 0) {
-      _vertexData = new MappedFileBuffer<V>(vCount);
+      auto vertexData = new MappedFileBuffer<V>(vCount);
+      vertexData->sequentialAccess();
+      _vertexData = vertexData;
     }
-    _edges = new MappedFileBuffer<Edge<E>>(eCount);
+    auto edges = new MappedFileBuffer<Edge<E>>(eCount);
+    edges->sequentialAccess();
+    _edges = edges;
   } else {
     if (_graphFormat->estimatedVertexSize() > 0) {
       _vertexData = new VectorTypedBuffer<V>(vCount);
@@ -163,20 +173,27 @@ void GraphStore<V, E>::loadShards(WorkerConfig* config,
     std::map<CollectionID, std::vector<ShardID>> const& edgeCollMap =
     _config->edgeCollectionShards();
     
-    // calculating sum of all ith edge shards and set it as
-    // starting offset for all i+1 edge shards
+    // calculating sum of all ith edge shards. The edges of all ith vertex
+    // shards are stored behind the edges of all edge shards before them
+    std::vector<uint64_t> edgeShardSizes;
     for (auto const& pair : edgeCollMap) {
       std::vector<ShardID> const& edgeShards = pair.second;
-      if (_edgeShardsOffset.size() == 0) {
-        _edgeShardsOffset.resize(edgeShards.size()+1);
-        std::fill(_edgeShardsOffset.begin(), _edgeShardsOffset.end(), 0);
+      if (edgeShardSizes.empty()) {
+        edgeShardSizes.resize(edgeShards.size(), 0);
       } else {
-        TRI_ASSERT(_edgeShardsOffset.size() == edgeShards.size()+1);
+        TRI_ASSERT(edgeShardSizes.size() == edgeShards.size());
       }
       for (size_t i = 0; i < edgeShards.size(); i++) {
-        _edgeShardsOffset[i+1] += shardSizes[edgeShards[i]];
+        edgeShardSizes[i] += shardSizes[edgeShards[i]];
       }
     }
+    _edgeShardsOffset.reset(
+        new std::atomic<uint64_t>[edgeShardSizes.size()]);
+    uint64_t edgeOffset = 0;
+    for (size_t i = 0; i < edgeShardSizes.size(); i++) {
+      _edgeShardsOffset[i] = edgeOffset;
+      edgeOffset += edgeShardSizes[i];
+    }
     
     for (auto const& pair : vertexCollMap) {
       std::vector<ShardID> const& vertexShards = pair.second;
@@ -208,10 +225,12 @@ void GraphStore<V, E>::loadShards(WorkerConfig* config,
         // update to next offset
         vertexOffset += shardSizes[vertexShard];
       }
-      
-      while (_runningThreads > 0) {
-        usleep(5000);
-      }
+    }
+
+    // all vertex shards are loaded in parallel, also the ones of
+    // different collections
+    while (_runningThreads > 0) {
+      usleep(5000);
     }
     scheduler->post(callback);
   });
@@ -283,7 +302,10 @@ void GraphStore<V, E>::loadDocument(WorkerConfig* config,
     _localVerticeCount++;
   }
 
-  // load edges
+  // load edges, lazy loading shares a single key table
+  std::unordered_set<PregelKey>& keys =
+      _keyTables.empty() ? _createKeyTable() : *_keyTables.front();
+  std::vector<Edge<E>> edges;
   std::map<CollectionID, std::vector<ShardID>> const& vertexMap =
       _config->vertexCollectionShards();
   std::map<CollectionID, std::vector<ShardID>> const& edgeMap =
@@ -295,11 +317,21 @@ void GraphStore<V, E>::loadDocument(WorkerConfig* config,
       size_t pos = (size_t)(it - vertexShards.begin());
       for (auto const& pair2 : edgeMap) {
         std::vector<ShardID> const& edgeShards = pair2.second;
-        _loadEdges(trx.get(), edgeShards[pos], entry, documentId);
+        _loadEdges(trx.get(), edgeShards[pos], documentId, keys, edges);
       }
       break;
     }
   }
+
+  entry._edgeDataOffset = _localEdgeCount;
+  while (_edges->size() < _localEdgeCount + edges.size()) {
+    // lazy loading always uses vector backed storage
+    ((VectorTypedBuffer<Edge<E>>*)_edges)->appendEmptyElement();
+  }
+  std::copy(edges.begin(), edges.end(),
+            _edges->data() + entry._edgeDataOffset);
+  entry._edgeCount = edges.size();
+  _localEdgeCount += edges.size();
   if (!trx->commit().ok()) {
     LOG_TOPIC(WARN, Logger::PREGEL)
         << "Pregel worker: Failed to commit on a read transaction";
@@ -317,6 +349,21 @@ RangeIterator<VertexEntry> GraphStore<V, E>::vertexIterator(size_t start,
   return RangeIterator<VertexEntry>(_index.data() + start, end - start);
 }
 
+template <typename V, typename E>
+VertexEntry* GraphStore<V, E>::lookupVertex(PregelShard shard,
+                                            PregelKey const& key) {
+  // rebuild after more vertices were loaded
+  if (_vertexLookup.size() != _index.size()) {
+    _vertexLookup.clear();
+    _vertexLookup.reserve(_index.size());
+    for (size_t i = 0; i < _index.size(); i++) {
+      _vertexLookup.emplace(_index[i].pregelId(), i);
+    }
+  }
+  auto const& it = _vertexLookup.find(PregelID(shard, key));
+  return it != _vertexLookup.end() ? &_index[it->second] : nullptr;
+}
+
 template <typename V, typename E>
 V* GraphStore<V, E>::mutableVertexData(VertexEntry const* entry) {
   return _vertexData->data() + entry->_vertexDataOffset;
@@ -332,6 +379,52 @@ void GraphStore<V, E>::replaceVertexData(VertexEntry const* entry, void* data,
       << "Don't use this function with varying sizes";
 }
 
+template <typename V, typename E>
+bool GraphStore<V, E>::snapshotVertices(VPackBuilder& b) const {
+  if (!std::is_trivially_copyable<V>::value) {
+    return false;
+  }
+  // per vertex the value followed by the active flag
+  size_t const entrySize = (_vertexData ? sizeof(V) : 0) + 1;
+  std::string buffer;
+  buffer.reserve(_index.size() * entrySize);
+  for (VertexEntry const& entry : _index) {
+    if (_vertexData) {
+      buffer.append(reinterpret_cast<char const*>(_vertexData->data() +
+                                                  entry._vertexDataOffset),
+                    sizeof(V));
+    }
+    buffer.push_back(entry._active ? 1 : 0);
+  }
+  b.add(VPackValuePair(reinterpret_cast<uint8_t const*>(buffer.data()),
+                       buffer.size(), VPackValueType::Binary));
+  return true;
+}
+
+template <typename V, typename E>
+bool GraphStore<V, E>::restoreVertices(VPackSlice snapshot) {
+  if (!std::is_trivially_copyable<V>::value || !snapshot.isBinary()) {
+    return false;
+  }
+  size_t const entrySize = (_vertexData ? sizeof(V) : 0) + 1;
+  VPackValueLength length;
+  uint8_t const* ptr = snapshot.getBinary(length);
+  if (length != _index.size() * entrySize) {
+    LOG_TOPIC(WARN, Logger::PREGEL) << "Checkpoint does not match the "
+                                    << "loaded vertices";
+    return false;
+  }
+  for (VertexEntry& entry : _index) {
+    if (_vertexData) {
+      memcpy(_vertexData->data() + entry._vertexDataOffset, ptr, sizeof(V));
+      ptr += sizeof(V);
+    }
+    entry._active = *ptr != 0;
+    ptr++;
+  }
+  return true;
+}
+
 template <typename V, typename E>
 RangeIterator<Edge<E>> GraphStore<V, E>::edgeIterator(
     VertexEntry const* entry) {
@@ -339,6 +432,13 @@ RangeIterator<Edge<E>> GraphStore<V, E>::edgeIterator(
                                 entry->_edgeCount);
 }
 
+template <typename V, typename E>
+std::unordered_set<PregelKey>& GraphStore<V, E>::_createKeyTable() {
+  MUTEX_LOCKER(guard, _keyTablesMutex);
+  _keyTables.emplace_back(new std::unordered_set<PregelKey>());
+  return *_keyTables.back();
+}
+
 template <typename V, typename E>
 std::unique_ptr<transaction::Methods> GraphStore<V, E>::_createTransaction() {
   transaction::Options transactionOptions;
@@ -379,6 +479,9 @@ void GraphStore<V, E>::_loadVertices(size_t i,
   LogicalCollection* collection = cursor->collection();
   uint64_t number = collection->numberDocuments(trx.get());
   _graphFormat->willLoadVertices(number);
+  std::unordered_set<PregelKey>& keys = _createKeyTable();
+  std::vector<Edge<E>> edges;
+  uint64_t edgeCount = 0;
 
   auto cb = [&](DocumentIdentifierToken const& token, VPackSlice slice) {
     if (slice.isExternal()) {
@@ -387,7 +490,6 @@ void GraphStore<V, E>::_loadVertices(size_t i,
     VertexEntry& ventry = _index[vertexOffset];
     ventry._shard = sourceShard;
     ventry._key = transaction::helpers::extractKeyFromDocument(slice).copyString();
-    ventry._edgeDataOffset = _edgeShardsOffset[i];
 
     // load vertex data
     std::string documentId = trx->extractIdString(slice);
@@ -396,12 +498,27 @@ void GraphStore<V, E>::_loadVertices(size_t i,
       V* ptr = _vertexData->data() + vertexOffset;
       _graphFormat->copyVertexData(documentId, slice, ptr, sizeof(V));
     }
-    // load edges
+    // load edges. The vertex shards of other collections write into the
+    // same region of the edge buffer concurrently, so the edges are
+    // collected first and the space for them is reserved afterwards
+    edges.clear();
     for (ShardID const& edgeShard : edgeShards) {
-      _loadEdges(trx.get(), edgeShard, ventry, documentId);
+      _loadEdges(trx.get(), edgeShard, documentId, keys, edges);
     }
+    ventry._edgeDataOffset =
+        edges.empty() ? 0 : _edgeShardsOffset[i].fetch_add(edges.size());
+    ventry._edgeCount = edges.size();
+    if (ventry._edgeDataOffset + edges.size() > _edges->size()) {
+      LOG_TOPIC(ERR, Logger::PREGEL) << "Pregel did not preallocate enough "
+                                     << "space for all edges. This hints "
+                                     << "at a bug with collection count()";
+      TRI_ASSERT(false);
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_INTERNAL);
+    }
+    std::copy(edges.begin(), edges.end(),
+              _edges->data() + ventry._edgeDataOffset);
+    edgeCount += edges.size();
     vertexOffset++;
-    _edgeShardsOffset[i] += ventry._edgeCount;
   };
   while (cursor->nextDocument(cb, 1000)) {
     if (_destroyed) {
@@ -410,8 +527,9 @@ void GraphStore<V, E>::_loadVertices(size_t i,
     }
   }
   
-  // Add all new vertices
+  // Add all new vertices and edges
   _localVerticeCount += (vertexOffset - originalVertexOffset);
+  _localEdgeCount += edgeCount;
 
   if (!trx->commit().ok()) {
     LOG_TOPIC(WARN, Logger::PREGEL)
@@ -422,12 +540,9 @@ void GraphStore<V, E>::_loadVertices(size_t i,
 template <typename V, typename E>
 void GraphStore<V, E>::_loadEdges(transaction::Methods* trx,
                                   ShardID const& edgeShard,
-                                  VertexEntry& vertexEntry,
-                                  std::string const& documentID) {
-  size_t added = 0;
-  size_t offset = vertexEntry._edgeDataOffset + vertexEntry._edgeCount;
-  // moving pointer to edge
-
+                                  std::string const& documentID,
+                                  std::unordered_set<PregelKey>& keys,
+                                  std::vector<Edge<E>>& edges) {
   traverser::EdgeCollectionInfo info(trx, edgeShard, TRI_EDGE_OUT,
                                      StaticStrings::FromString, 0);
   ManagedDocumentResult mmdr;
@@ -443,38 +558,24 @@ void GraphStore<V, E>::_loadEdges(transaction::Methods* trx,
       slice = slice.resolveExternal();
     }
 
-    // If this is called from loadDocument we didn't preallocate the vector
-    if (_edges->size() <= offset) {
-      if (!_config->lazyLoading()) {
-        LOG_TOPIC(ERR, Logger::PREGEL) << "Pregel did not preallocate enough "
-                                       << "space for all edges. This hints "
-                                       << "at a bug with collection count()";
-        TRI_ASSERT(false);
-        THROW_ARANGO_EXCEPTION(TRI_ERROR_INTERNAL);
-      }
-      // lazy loading always uses vector backed storage
-      ((VectorTypedBuffer<Edge<E>>*)_edges)->appendEmptyElement();
-    }
-    
     std::string toValue = slice.get(StaticStrings::ToString).copyString();
     std::size_t pos = toValue.find('/');
     std::string collectionName = toValue.substr(0, pos);
-    Edge<E>* edge = _edges->data() + offset;
-    edge->_toKey = toValue.substr(pos + 1, toValue.length() - pos - 1);
+    Edge<E> edge;
+    edge._toKey = &(*keys.emplace(toValue, pos + 1).first);
 
     // resolve the shard of the target vertex.
     ShardID responsibleShard;
     int res =
         Utils::resolveShard(_config, collectionName, StaticStrings::KeyString,
-                            edge->_toKey, responsibleShard);
+                            *edge._toKey, responsibleShard);
 
     if (res == TRI_ERROR_NO_ERROR) {
       // PregelShard sourceShard = (PregelShard)_config->shardId(edgeShard);
-      edge->_targetShard = (PregelShard)_config->shardId(responsibleShard);
-      _graphFormat->copyEdgeData(slice, edge->data(), sizeof(E));
-      if (edge->_targetShard != (PregelShard)-1) {
-        added++;
-        offset++;
+      edge._targetShard = (PregelShard)_config->shardId(responsibleShard);
+      _graphFormat->copyEdgeData(slice, edge.data(), sizeof(E));
+      if (edge._targetShard != (PregelShard)-1) {
+        edges.push_back(edge);
       } else {
         LOG_TOPIC(ERR, Logger::PREGEL)
             << "Could not resolve target shard of edge";
@@ -490,10 +591,6 @@ void GraphStore<V, E>::_loadEdges(transaction::Methods* trx,
       break;
     }
   }
-
-  // Add up all added elements
-  vertexEntry._edgeCount += added;
-  _localEdgeCount += added;
 }
 
 /// Loops over the array starting a new transaction for different shards
@@ -522,6 +619,9 @@ void GraphStore<V, E>::_storeVertices(std::vector<ShardID> const& globalShards,
       transaction::Options transactionOptions;
       transactionOptions.waitForSync = false;
       transactionOptions.allowImplicitCollections = false;
+      // commit every batch on its own, results become visible while
+      // storing and no transaction has to hold all updates of a shard
+      transactionOptions.intermediateCommitCount = storeBatchSize;
       trx.reset(new transaction::UserTransaction(
           transaction::StandaloneContext::Create(_vocbaseGuard.vocbase()), {},
           {shard}, {}, transactionOptions));
@@ -534,7 +634,8 @@ void GraphStore<V, E>::_storeVertices(std::vector<ShardID> const& globalShards,
     transaction::BuilderLeaser b(trx.get());
     b->openArray();
     size_t buffer = 0;
-    while (it != it.end() && it->shard() == currentShard && buffer < 1000) {
+    while (it != it.end() && it->shard() == currentShard &&
+           buffer < storeBatchSize) {
       // This loop will fill a buffer of vertices until we run into a new
       // collection
       // or there are no more vertices for to store (or the buffer is full)
@@ -580,17 +681,25 @@ void GraphStore<V, E>::storeResults(WorkerConfig* config,
 
   double now = TRI_microtime();
   size_t total = _index.size();
-  size_t delta = _index.size() / _config->localVertexShardIDs().size();
-  if (delta < 1000) {
-    delta = _index.size();
+  if (total == 0) {
+    callback();
+    return;
+  }
+  // one range per thread, but not smaller than a few batches
+  size_t delta = total / std::max<uint64_t>(_config->parallelism(), 1);
+  delta = std::max<size_t>(delta, 4 * storeBatchSize);
+  std::vector<std::pair<size_t, size_t>> ranges;
+  for (size_t start = 0; start < total; start += delta) {
+    ranges.emplace_back(start, std::min(start + delta, total));
   }
-  size_t start = 0, end = delta;
 
   TRI_ASSERT(SchedulerFeature::SCHEDULER != nullptr);
   boost::asio::io_service* ioService = SchedulerFeature::SCHEDULER->ioService();
   TRI_ASSERT(ioService != nullptr);
-  do {
-    _runningThreads++;
+  // count all threads upfront, a fast thread must not see a zero early
+  _runningThreads = static_cast<uint32_t>(ranges.size());
+  for (auto const& range : ranges) {
+    size_t start = range.first, end = range.second;
     ioService->post([this, start, end, now, callback] {
       try {
         RangeIterator<VertexEntry> it = vertexIterator(start, end);
@@ -606,12 +715,7 @@ void GraphStore<V, E>::storeResults(WorkerConfig* config,
         callback();
       }
     });
-    start = end;
-    end = end + delta;
-    if (total < end + delta) {  // swallow the rest
-      end = total;
-    }
-  } while (start != end);
+  }
 }
 
 template class arangodb::pregel::GraphStore<int64_t, int64_t>;
@@ -27,6 +27,8 @@
 #include <cstdint>
 #include <cstdio>
 #include <set>
+#include <type_traits>
+#include <unordered_set>
 #include "Basics/Mutex.h"
 #include "Cluster/ClusterInfo.h"
 #include "Pregel/Graph.h"
@@ -34,6 +36,10 @@
 #include "Pregel/Iterators.h"
 #include "Pregel/TypedBuffer.h"
 
+#include <velocypack/Builder.h>
+#include <velocypack/Slice.h>
+#include <velocypack/velocypack-aliases.h>
+
 struct TRI_vocbase_t;
 
 namespace arangodb {
@@ -75,6 +81,10 @@ class GraphStore {
   RangeIterator<VertexEntry> vertexIterator(size_t start, size_t count);
   RangeIterator<Edge<E>> edgeIterator(VertexEntry const* entry);
 
+  /// find a loaded vertex, nullptr if it is not present. Builds a lookup
+  /// table on first use. NOT THREAD SAFE
+  VertexEntry* lookupVertex(PregelShard shard, PregelKey const& key);
+
   /// get the pointer to the vertex
   V* mutableVertexData(VertexEntry const* entry);
   /// does nothing currently
@@ -82,14 +92,24 @@ class GraphStore {
 
   /// Write results to database
   void storeResults(WorkerConfig* config, std::function<void()> callback);
+
+  /// Copy vertex values and active flags into a binary value, used for
+  /// checkpoints. Returns false if the vertex type can not be copied bytewise
+  bool snapshotVertices(VPackBuilder& b) const;
+  /// Restore a snapshot taken from exactly the same set of vertices
+  bool restoreVertices(VPackSlice snapshot);
   
 private:
   std::unordered_map<ShardID, uint64_t> _preallocateMemory();
   void _loadVertices(size_t i, ShardID const& vertexShard,
                      std::vector<ShardID> const& edgeShards,
                      uint64_t vertexOffset);
+  /// appends the outgoing edges of the vertex in this shard to `edges`
   void _loadEdges(transaction::Methods* trx, ShardID const& shard,
-                  VertexEntry& vertexEntry, std::string const& documentID);
+                  std::string const& documentID,
+                  std::unordered_set<PregelKey>& keys,
+                  std::vector<Edge<E>>& edges);
+  std::unordered_set<PregelKey>& _createKeyTable();
   void _storeVertices(std::vector<ShardID> const& globalShards,
                       RangeIterator<VertexEntry>& it);
   std::unique_ptr<transaction::Methods> _createTransaction();
@@ -101,17 +121,25 @@ private:
   
   /// Holds vertex keys and pointers to vertex data and edges
   std::vector<VertexEntry> _index;
+  /// Position of a vertex in _index, only built when needed
+  std::unordered_map<PregelID, size_t> _vertexLookup;
   /// Vertex data
   TypedBuffer<V>* _vertexData = nullptr;
   /// Edges (and data)
   TypedBuffer<Edge<E>>* _edges = nullptr;
+  /// Target keys of the edges. Edges only hold a pointer to their key,
+  /// so a vertex with many incoming edges stores its key once per table.
+  /// Every loading thread fills its own table
+  std::vector<std::unique_ptr<std::unordered_set<PregelKey>>> _keyTables;
+  Mutex _keyTablesMutex;
   
   // cache the amount of vertices
   std::set<ShardID> _loadedShards;
-  // hold the current position where the ith vertex shard can
-  // start to write its data. At the end the offset should equal the
-  // sum of the counts of all ith edge shards
-  std::vector<uint64_t> _edgeShardsOffset;
+  // hold the current position where the ith vertex shards can
+  // write their edges. The ith shards of all vertex collections are
+  // loaded concurrently and reserve their space here. At the end the
+  // offset should equal the start of the edges of the (i+1)th shards
+  std::unique_ptr<std::atomic<uint64_t>[]> _edgeShardsOffset;
   
   // actual count of loaded vertices / edges
   std::atomic<uint64_t> _localVerticeCount;
@@ -48,26 +48,29 @@ void InCache<M>::parseMessages(VPackSlice const& incomingData) {
   // temporary variables
   VPackValueLength i = 0;
   PregelKey key;
+  size_t stripe = 0;
   PregelShard shard = (PregelShard)shardSlice.getUInt();
-  MUTEX_LOCKER(guard, this->_bucketLocker[shard]);
+  auto& locks = this->_bucketLocker[shard];
 
   for (VPackSlice current : VPackArrayIterator(messages)) {
     if (i % 2 == 0) {  // TODO support multiple recipients
       key = current.copyString();
+      stripe = _stripe(key);
     } else {
+      MUTEX_LOCKER(guard, locks[stripe]);
       if (current.isArray()) {
         VPackValueLength c = 0;
         for (VPackSlice val : VPackArrayIterator(current)) {
           M newValue;
           _format->unwrapValue(val, newValue);
-          _set(shard, key, newValue);
+          _set(shard, stripe, key, newValue);
           c++;
         }
         this->_containedMessageCount += c;
       } else {
         M newValue;
         _format->unwrapValue(current, newValue);
-        _set(shard, key, newValue);
+        _set(shard, stripe, key, newValue);
         this->_containedMessageCount++;
       }
     }
@@ -84,15 +87,16 @@ void InCache<M>::parseMessages(VPackSlice const& incomingData) {
 template <typename M>
 void InCache<M>::storeMessageNoLock(PregelShard shard,
                                     PregelKey const& vertexId, M const& data) {
-  this->_set(shard, vertexId, data);
+  this->_set(shard, _stripe(vertexId), vertexId, data);
   this->_containedMessageCount++;
 }
 
 template <typename M>
 void InCache<M>::storeMessage(PregelShard shard, PregelKey const& vertexId,
                               M const& data) {
-  MUTEX_LOCKER(guard, this->_bucketLocker[shard]);
-  this->_set(shard, vertexId, data);
+  size_t stripe = _stripe(vertexId);
+  MUTEX_LOCKER(guard, this->_bucketLocker[shard][stripe]);
+  this->_set(shard, stripe, vertexId, data);
   this->_containedMessageCount++;
 }
 
@@ -113,9 +117,9 @@ ArrayInCache<M>::ArrayInCache(WorkerConfig const* config,
 }
 
 template <typename M>
-void ArrayInCache<M>::_set(PregelShard shard, PregelKey const& key,
-                           M const& newValue) {
-  HMap& vertexMap(_shardMap[shard]);
+void ArrayInCache<M>::_set(PregelShard shard, size_t stripe,
+                           PregelKey const& key, M const& newValue) {
+  HMap& vertexMap(_shardMap[shard][stripe]);
   vertexMap[key].push_back(newValue);
 }
 
@@ -127,17 +131,23 @@ void ArrayInCache<M>::mergeCache(WorkerConfig const& config,
 
   // ranomize access to buckets, don't wait for the lock
   std::set<PregelShard> const& shardIDs = config.localPregelShardIDs();
-  std::vector<PregelShard> randomized(shardIDs.begin(), shardIDs.end());
+  std::vector<std::pair<PregelShard, size_t>> randomized;
+  for (PregelShard shardId : shardIDs) {
+    for (size_t stripe = 0; stripe < InCache<M>::NUM_STRIPES; ++stripe) {
+      randomized.emplace_back(shardId, stripe);
+    }
+  }
   std::random_shuffle(randomized.begin(), randomized.end());
 
   size_t i = 0;
   do {
     i = (i + 1) % randomized.size();
-    PregelShard shardId = randomized[i];
+    PregelShard shardId = randomized[i].first;
+    size_t stripe = randomized[i].second;
 
     auto const& it = other->_shardMap.find(shardId);
-    if (it != other->_shardMap.end() && it->second.size() > 0) {
-      TRY_MUTEX_LOCKER(guard, this->_bucketLocker[shardId]);
+    if (it != other->_shardMap.end() && it->second[stripe].size() > 0) {
+      TRY_MUTEX_LOCKER(guard, this->_bucketLocker[shardId][stripe]);
       if (guard.isLocked() == false) {
         if (i == 0) {   // eventually we hit the last one
           usleep(100);  // don't busy wait
@@ -146,8 +156,8 @@ void ArrayInCache<M>::mergeCache(WorkerConfig const& config,
       }
 
       // only access bucket after we acquired the lock
-      HMap& myVertexMap = _shardMap[shardId];
-      for (auto& vertexMessage : it->second) {
+      HMap& myVertexMap = _shardMap[shardId][stripe];
+      for (auto& vertexMessage : it->second[stripe]) {
         std::vector<M>& a = myVertexMap[vertexMessage.first];
         std::vector<M> const& b = vertexMessage.second;
         a.insert(a.end(), b.begin(), b.end());
@@ -161,7 +171,7 @@ void ArrayInCache<M>::mergeCache(WorkerConfig const& config,
 template <typename M>
 MessageIterator<M> ArrayInCache<M>::getMessages(PregelShard shard,
                                                 PregelKey const& key) {
-  HMap const& vertexMap = _shardMap[shard];
+  HMap const& vertexMap = _shardMap[shard][this->_stripe(key)];
   auto vmsg = vertexMap.find(key);
   if (vmsg != vertexMap.end()) {
     M const* ptr = vmsg->second.data();
@@ -175,7 +185,9 @@ template <typename M>
 void ArrayInCache<M>::clear() {
   for (auto& pair : _shardMap) {
     // MUTEX_LOCKER(guard, this->_bucketLocker[pair.first]);
-    pair.second.clear();
+    for (HMap& vertexMap : pair.second) {
+      vertexMap.clear();
+    }
   }
   this->_containedMessageCount = 0;
 }
@@ -183,7 +195,7 @@ void ArrayInCache<M>::clear() {
 /// Deletes one entry. DOES NOT LOCK
 template <typename M>
 void ArrayInCache<M>::erase(PregelShard shard, PregelKey const& key) {
-  HMap& vertexMap = _shardMap[shard];
+  HMap& vertexMap = _shardMap[shard][this->_stripe(key)];
   auto const& it = vertexMap.find(key);
   if (it != vertexMap.end()) {
     vertexMap.erase(it);
@@ -196,10 +208,11 @@ void ArrayInCache<M>::forEach(
     std::function<void(PregelShard, PregelKey const&, M const&)> func) {
   for (auto const& pair : _shardMap) {
     PregelShard shard = pair.first;
-    HMap const& vertexMap = pair.second;
-    for (auto& vertexMsgs : vertexMap) {
-      for (M const& val : vertexMsgs.second) {
-        func(shard, vertexMsgs.first, val);
+    for (HMap const& vertexMap : pair.second) {
+      for (auto& vertexMsgs : vertexMap) {
+        for (M const& val : vertexMsgs.second) {
+          func(shard, vertexMsgs.first, val);
+        }
       }
     }
   }
@@ -223,9 +236,9 @@ CombiningInCache<M>::CombiningInCache(WorkerConfig const* config,
 }
 
 template <typename M>
-void CombiningInCache<M>::_set(PregelShard shard, PregelKey const& key,
-                               M const& newValue) {
-  HMap& vertexMap = _shardMap[shard];
+void CombiningInCache<M>::_set(PregelShard shard, size_t stripe,
+                               PregelKey const& key, M const& newValue) {
+  HMap& vertexMap = _shardMap[shard][stripe];
   auto vmsg = vertexMap.find(key);
   if (vmsg != vertexMap.end()) {  // got a message for the same vertex
     _combiner->combine(vmsg->second, newValue);
@@ -242,17 +255,23 @@ void CombiningInCache<M>::mergeCache(WorkerConfig const& config,
 
   // ranomize access to buckets, don't wait for the lock
   std::set<PregelShard> const& shardIDs = config.localPregelShardIDs();
-  std::vector<PregelShard> randomized(shardIDs.begin(), shardIDs.end());
+  std::vector<std::pair<PregelShard, size_t>> randomized;
+  for (PregelShard shardId : shardIDs) {
+    for (size_t stripe = 0; stripe < InCache<M>::NUM_STRIPES; ++stripe) {
+      randomized.emplace_back(shardId, stripe);
+    }
+  }
   std::random_shuffle(randomized.begin(), randomized.end());
 
   size_t i = 0;
   do {
     i = (i + 1) % randomized.size();
-    PregelShard shardId = randomized[i];
+    PregelShard shardId = randomized[i].first;
+    size_t stripe = randomized[i].second;
 
     auto const& it = other->_shardMap.find(shardId);
-    if (it != other->_shardMap.end() && it->second.size() > 0) {
-      TRY_MUTEX_LOCKER(guard, this->_bucketLocker[shardId]);
+    if (it != other->_shardMap.end() && it->second[stripe].size() > 0) {
+      TRY_MUTEX_LOCKER(guard, this->_bucketLocker[shardId][stripe]);
       if (guard.isLocked() == false) {
         if (i == 0) {   // eventually we hit the last one
           usleep(100);  // don't busy wait
@@ -261,8 +280,8 @@ void CombiningInCache<M>::mergeCache(WorkerConfig const& config,
       }
 
       // only access bucket after we acquired the lock
-      HMap& myVertexMap = _shardMap[shardId];
-      for (auto& vertexMessage : it->second) {
+      HMap& myVertexMap = _shardMap[shardId][stripe];
+      for (auto& vertexMessage : it->second[stripe]) {
         auto vmsg = myVertexMap.find(vertexMessage.first);
         if (vmsg != myVertexMap.end()) {  // got a message for the same vertex
           _combiner->combine(vmsg->second, vertexMessage.second);
@@ -279,7 +298,7 @@ void CombiningInCache<M>::mergeCache(WorkerConfig const& config,
 template <typename M>
 MessageIterator<M> CombiningInCache<M>::getMessages(PregelShard shard,
                                                     PregelKey const& key) {
-  HMap const& vertexMap = _shardMap[shard];
+  HMap const& vertexMap = _shardMap[shard][this->_stripe(key)];
   auto vmsg = vertexMap.find(key);
   if (vmsg != vertexMap.end()) {
     return MessageIterator<M>(&vmsg->second);
@@ -291,7 +310,9 @@ MessageIterator<M> CombiningInCache<M>::getMessages(PregelShard shard,
 template <typename M>
 void CombiningInCache<M>::clear() {
   for (auto& pair : _shardMap) {
-    pair.second.clear();
+    for (HMap& vertexMap : pair.second) {
+      vertexMap.clear();
+    }
   }
   this->_containedMessageCount = 0;
 }
@@ -299,7 +320,7 @@ void CombiningInCache<M>::clear() {
 /// Deletes one entry. DOES NOT LOCK
 template <typename M>
 void CombiningInCache<M>::erase(PregelShard shard, PregelKey const& key) {
-  HMap& vertexMap = _shardMap[shard];
+  HMap& vertexMap = _shardMap[shard][this->_stripe(key)];
   auto const& it = vertexMap.find(key);
   if (it != vertexMap.end()) {
     vertexMap.erase(it);
@@ -314,9 +335,10 @@ void CombiningInCache<M>::forEach(
         func) {
   for (auto const& pair : _shardMap) {
     PregelShard shard = pair.first;
-    HMap const& vertexMap = pair.second;
-    for (auto& vertexMessage : vertexMap) {
-      func(shard, vertexMessage.first, vertexMessage.second);
+    for (HMap const& vertexMap : pair.second) {
+      for (auto& vertexMessage : vertexMap) {
+        func(shard, vertexMessage.first, vertexMessage.second);
+      }
     }
   }
 }
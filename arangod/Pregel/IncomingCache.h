@@ -25,6 +25,7 @@
 
 #include <velocypack/velocypack-aliases.h>
 #include <velocypack/vpack.h>
+#include <array>
 #include <atomic>
 #include <string>
 
@@ -46,16 +47,27 @@ cases. For example threaded
 processing */
 template <typename M>
 class InCache {
+ public:
+  /// @brief the vertices of every shard are distributed over this many
+  /// buckets by the hash of their key. Each bucket has its own lock, so
+  /// that threads storing messages for the same shard rarely contend
+  static size_t const NUM_STRIPES = 16;
+
  protected:
-  mutable std::map<PregelShard, arangodb::Mutex> _bucketLocker;
+  mutable std::map<PregelShard, std::array<arangodb::Mutex, NUM_STRIPES>>
+      _bucketLocker;
   std::atomic<uint64_t> _containedMessageCount;
   MessageFormat<M> const* _format;
 
   /// Initialize format and mutex map.
   /// @param config can be null if you don't want locks
   explicit InCache(MessageFormat<M> const* format);
-  virtual void _set(PregelShard shard, PregelKey const& vertexId,
-                    M const& data) = 0;
+  virtual void _set(PregelShard shard, size_t stripe,
+                    PregelKey const& vertexId, M const& data) = 0;
+
+  static size_t _stripe(PregelKey const& key) {
+    return std::hash<PregelKey>()(key) % NUM_STRIPES;
+  }
 
  public:
   virtual ~InCache(){};
@@ -95,10 +107,10 @@ class InCache {
 template <typename M>
 class ArrayInCache : public InCache<M> {
   typedef std::unordered_map<PregelKey, std::vector<M>> HMap;
-  std::map<PregelShard, HMap> _shardMap;
+  std::map<PregelShard, std::array<HMap, InCache<M>::NUM_STRIPES>> _shardMap;
 
  protected:
-  void _set(PregelShard shard, PregelKey const& vertexId,
+  void _set(PregelShard shard, size_t stripe, PregelKey const& vertexId,
             M const& data) override;
 
  public:
@@ -121,10 +133,10 @@ class CombiningInCache : public InCache<M> {
   typedef std::unordered_map<PregelKey, M> HMap;
 
   MessageCombiner<M> const* _combiner;
-  std::map<PregelShard, HMap> _shardMap;
+  std::map<PregelShard, std::array<HMap, InCache<M>::NUM_STRIPES>> _shardMap;
 
  protected:
-  void _set(PregelShard shard, PregelKey const& vertexId,
+  void _set(PregelShard shard, size_t stripe, PregelKey const& vertexId,
             M const& data) override;
 
  public:
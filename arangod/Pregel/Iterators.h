@@ -155,6 +155,44 @@ class RangeIterator {
    return _current != _end ? static_cast<EdgeEntry<E>>(_current) : nullptr;
    }*/
 };
+
+/// Iterates over a list of pointers, like RangeIterator it yields T*
+template <typename T>
+class PointerIterator {
+ private:
+  T* const* _data;
+  size_t _current, _size;
+
+ public:
+  typedef PointerIterator<T> iterator;
+  typedef const PointerIterator<T> const_iterator;
+
+  PointerIterator(T* const* v, size_t size)
+      : _data(v), _current(0), _size(size) {}
+
+  iterator begin() const { return PointerIterator(_data, _size); }
+  iterator end() const {
+    auto it = PointerIterator(_data, _size);
+    it._current = it._size;
+    return it;
+  }
+
+  // prefix ++
+  PointerIterator& operator++() {
+    _current++;
+    return *this;
+  }
+
+  T* operator*() const { return _data[_current]; }
+
+  T* operator->() const { return _data[_current]; }
+
+  bool operator!=(PointerIterator<T> const& other) const {
+    return _current != other._current;
+  }
+
+  size_t size() const { return _size; }
+};
 }
 }
 #endif
@@ -38,6 +38,23 @@
 using namespace arangodb;
 using namespace arangodb::pregel;
 
+/// @brief adds a request that sends the messages in `data` to a shard.
+/// The body is VelocyPack instead of JSON, numeric message values take a
+/// fraction of the space and the receiver does not have to parse them
+static void addMessagesRequest(std::vector<ClusterCommRequest>& requests,
+                               ShardID const& shardId,
+                               std::string const& baseUrl, VPackSlice data) {
+  auto body = std::make_shared<std::string>(data.startAs<char>(),
+                                            data.byteSize());
+  requests.emplace_back("shard:" + shardId, rest::RequestType::POST,
+                        baseUrl + Utils::messagesPath, body);
+  auto headers =
+      std::make_unique<std::unordered_map<std::string, std::string>>();
+  headers->emplace(StaticStrings::ContentTypeHeader,
+                   StaticStrings::MimeTypeVPack);
+  requests.back().setHeaders(headers);
+}
+
 template <typename M>
 OutCache<M>::OutCache(WorkerConfig* state, MessageFormat<M> const* format)
     : _config(state), _format(format) {
@@ -126,9 +143,7 @@ void ArrayOutCache<M>::flushMessages() {
     data.close();
     // add a request
     ShardID const& shardId = this->_config->globalShardIDs()[shard];
-    auto body = std::make_shared<std::string>(data.toJson());
-    requests.emplace_back("shard:" + shardId, rest::RequestType::POST,
-                          this->_baseUrl + Utils::messagesPath, body);
+    addMessagesRequest(requests, shardId, this->_baseUrl, data.slice());
   }
   size_t nrDone = 0;
   ClusterComm::instance()->performRequests(requests, 120, nrDone,
@@ -228,9 +243,7 @@ void CombiningOutCache<M>::flushMessages() {
     data.close();
     // add a request
     ShardID const& shardId = this->_config->globalShardIDs()[shard];
-    auto body = std::make_shared<std::string>(data.toJson());
-    requests.emplace_back("shard:" + shardId, rest::RequestType::POST,
-                          this->_baseUrl + Utils::messagesPath, body);
+    addMessagesRequest(requests, shardId, this->_baseUrl, data.slice());
   }
   size_t nrDone = 0;
   ClusterComm::instance()->performRequests(requests, 180, nrDone,
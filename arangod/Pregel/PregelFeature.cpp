@@ -203,6 +203,7 @@ void PregelFeature::handleWorkerRequest(TRI_vocbase_t* vocbase,
     std::shared_ptr<IWorker> w = Instance->worker(exeNum);
     if (!w) {
       Instance->addWorker(AlgoRegistry::createWorker(vocbase, body), exeNum);
+      w = Instance->worker(exeNum);
     } else if (path == Utils::startExecutionPath) {
       THROW_ARANGO_EXCEPTION_MESSAGE(
           TRI_ERROR_INTERNAL,
@@ -25,15 +25,18 @@
 
 #include "Basics/Common.h"
 #include "Basics/FileUtils.h"
+#include "Basics/MemoryArenas.h"
 #include "Basics/OpenFilesTracker.h"
 #include "Basics/files.h"
 #include "Basics/memory-map.h"
 #include "Logger/Logger.h"
+#include "VocBase/ticks.h"
 
 #include <cstddef>
 
 #ifdef __linux__
 #include <sys/mman.h>
+#include <unistd.h>
 #endif
 
 namespace arangodb {
@@ -78,7 +81,8 @@ struct TypedBuffer {
 
 template <typename T>
 class VectorTypedBuffer : public TypedBuffer<T> {
-  std::vector<T> _vector;
+  // allocated from the memory arena of Pregel
+  std::vector<T, MemoryArenaAllocator<T, MemoryArena::PREGEL>> _vector;
 
  public:
   VectorTypedBuffer(size_t entries) : _vector(entries) {
@@ -106,97 +110,54 @@ class VectorTypedBuffer : public TypedBuffer<T> {
   }
 };
 
-/// Portable read-only memory mapping (Windows and Linux)
+/// Portable memory mapping (Windows and Linux), backed by a temporary file
+/// so that the OS can write pages back to disk instead of keeping them in
+/// RAM or swap. This allows workers to process graphs larger than memory.
 /** Filesize limited by size_t, usually 2^32 or 2^64 */
 template <typename T>
 class MappedFileBuffer : public TypedBuffer<T> {
  public:
-#ifdef TRI_HAVE_ANONYMOUS_MMAP
-  MappedFileBuffer(size_t entries) : _size(entries) {
-#ifdef TRI_MMAP_ANONYMOUS
-    // fd -1 is required for "real" anonymous regions
-    _fd = -1;
-    int flags = TRI_MMAP_ANONYMOUS | MAP_SHARED;
-#else
-    // ugly workaround if MAP_ANONYMOUS is not available
-    _fd = TRI_TRACKED_OPEN_FILE("/dev/zero", O_RDWR | TRI_O_CLOEXEC);
-    if (_fd == -1) {
-      THROW_ARANGO_EXCEPTION(TRI_ERROR_INTERNAL);
-    }
-
-    int flags = MAP_PRIVATE;
-#endif
-
-    // memory map the data
-    _mappedSize = sizeof(T) * entries;
-    void* ptr;
-    int res = TRI_MMFile(nullptr, _mappedSize, PROT_WRITE | PROT_READ, flags,
-                         _fd, &_mmHandle, 0, &ptr);
-#ifdef MAP_ANONYMOUS
-// nothing to do
-#else
-    // close auxilliary file
-    TRI_TRACKED_CLOSE_FILE(_fd);
-    _fd = -1;
-#endif
-
-    if (res != TRI_ERROR_NO_ERROR) {
-      TRI_set_errno(res);
-
-      LOG_TOPIC(ERR, arangodb::Logger::FIXME)
-          << "cannot memory map anonymous region: " << TRI_last_error();
-      LOG_TOPIC(ERR, arangodb::Logger::FIXME)
-          << "The database directory might reside on a shared folder "
-             "(VirtualBox, VMWare) or an NFS "
-             "mounted volume which does not allow memory mapped files.";
-      THROW_ARANGO_EXCEPTION(TRI_ERROR_INTERNAL);
-    }
-    this->_ptr = (T*)ptr;
-    // return new TypedBuffer(StaticStrings::Empty, fd, mmHandle, initialSize,
-    // ptr);
-  }
-#else
   MappedFileBuffer(size_t entries) : _size(entries) {
     double tt = TRI_microtime();
-    std::string file = "pregel_" + std::to_string((uint64_t)tt) + ".mmap";
-    std::string filename = FileUtils::buildFilename(TRI_GetTempPath(), file);
+    std::string file = "pregel_" + std::to_string((uint64_t)(tt * 1000000)) +
+                       "_" + std::to_string(TRI_NewTickServer()) + ".mmap";
+    _filename = FileUtils::buildFilename(TRI_GetTempPath(), file);
 
     _mappedSize = sizeof(T) * _size;
-    _fd = TRI_CreateDatafile(filename, _mappedSize);
+    _fd = TRI_CreateDatafile(_filename, _mappedSize);
     if (_fd < 0) {
+      _filename.clear();
       THROW_ARANGO_EXCEPTION(TRI_ERROR_INTERNAL);
     }
 
-    // memory map the data
+    // memory map the data. the mapping is not populated on purpose, pages
+    // are only read from the file when they are accessed
     void* data;
     int flags = MAP_SHARED;
-#ifdef __linux__
-    // try populating the mapping already
-    flags |= MAP_POPULATE;
-#endif
     int res = TRI_MMFile(0, _mappedSize, PROT_WRITE | PROT_READ, flags, _fd,
                          &_mmHandle, 0, &data);
 
     if (res != TRI_ERROR_NO_ERROR) {
       TRI_set_errno(res);
-      TRI_TRACKED_CLOSE_FILE(fd);
+      TRI_TRACKED_CLOSE_FILE(_fd);
+      _fd = -1;
 
       // remove empty file
-      TRI_UnlinkFile(filename.c_str());
+      TRI_UnlinkFile(_filename.c_str());
 
       LOG_TOPIC(ERR, arangodb::Logger::FIXME) << "cannot memory map file '"
-                                              << filename << "': '"
+                                              << _filename << "': '"
                                               << TRI_errno_string(res) << "'";
       LOG_TOPIC(ERR, arangodb::Logger::FIXME)
           << "The database directory might reside on a shared folder "
              "(VirtualBox, VMWare) or an NFS-mounted volume which does not "
              "allow memory mapped files.";
+      _filename.clear();
       THROW_ARANGO_EXCEPTION(TRI_ERROR_INTERNAL);
     }
 
     this->_ptr = (T*)data;
   }
-#endif
 
   /// close file (see close() )
   ~MappedFileBuffer() { close(); }
@@ -221,8 +182,12 @@ class MappedFileBuffer : public TypedBuffer<T> {
     TRI_MMFileAdvise(this->_ptr, _mappedSize, TRI_MADVISE_DONTNEED);
   }
 
-  /// close file
+  /// close file, the file is deleted afterwards
   void close() override {
+    if (this->_ptr == nullptr) {
+      // already closed
+      return;
+    }
     int res = TRI_UNMMFile(this->_ptr, _mappedSize, _fd, &_mmHandle);
     if (res != TRI_ERROR_NO_ERROR) {
       // leave file open here as it will still be memory-mapped
@@ -237,6 +202,10 @@ class MappedFileBuffer : public TypedBuffer<T> {
             << "': " << res;
       }
     }
+    if (isPhysical()) {
+      TRI_UnlinkFile(_filename.c_str());
+      _filename.clear();
+    }
 
     this->_ptr = nullptr;
     _fd = -1;
@@ -263,6 +232,14 @@ class MappedFileBuffer : public TypedBuffer<T> {
 
 #ifdef __linux__
     size_t newMappedSize = sizeof(T) * newSize;
+    // the file must cover the whole mapping, accessing pages beyond its
+    // end raises SIGBUS
+    if (newMappedSize > _mappedSize &&
+        ftruncate(_fd, static_cast<off_t>(newMappedSize)) != 0) {
+      LOG_TOPIC(WARN, Logger::MMAP) << "cannot extend pregel mapped file '"
+                                    << _filename << "'";
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_SYS_ERROR);
+    }
     void* newPtr =
         mremap((void*)this->_ptr, _mappedSize, newMappedSize, MREMAP_MAYMOVE);
     if (newPtr != MAP_FAILED) {  // success
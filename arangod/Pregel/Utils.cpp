@@ -63,6 +63,8 @@ std::string const Utils::userParametersKey = "userparams";
 std::string const Utils::asyncModeKey = "asyncMode";
 std::string const Utils::lazyLoadingKey = "lazyloading";
 std::string const Utils::parallelismKey = "parallelism";
+std::string const Utils::useMemoryMapsKey = "useMemoryMaps";
+std::string const Utils::checkpointIntervalKey = "checkpointInterval";
 
 std::string const Utils::globalSuperstepKey = "gss";
 std::string const Utils::vertexCountKey = "vertexCount";
@@ -71,6 +73,7 @@ std::string const Utils::shardIdKey = "shrdId";
 std::string const Utils::messagesKey = "msgs";
 std::string const Utils::senderKey = "sender";
 std::string const Utils::recoveryMethodKey = "rmethod";
+std::string const Utils::checkpointRestoredKey = "checkpointRestored";
 std::string const Utils::storeResultsKey = "storeResults";
 std::string const Utils::aggregatorValuesKey = "aggregators";
 std::string const Utils::activeCountKey = "activeCount";
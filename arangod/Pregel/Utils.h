@@ -70,6 +70,8 @@ class Utils {
   static std::string const asyncModeKey;
   static std::string const lazyLoadingKey;
   static std::string const parallelismKey;
+  static std::string const useMemoryMapsKey;
+  static std::string const checkpointIntervalKey;
 
   /// Current global superstep
   static std::string const globalSuperstepKey;
@@ -92,6 +94,9 @@ class Utils {
   /// Recovery method name
   static std::string const recoveryMethodKey;
 
+  /// Tells the conductor whether a worker could restore its checkpoint
+  static std::string const checkpointRestoredKey;
+
   /// Tells workers to store the result into the collections
   /// otherwise dicard results
   static std::string const storeResultsKey;
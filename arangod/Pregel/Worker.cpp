@@ -31,9 +31,11 @@
 #include "Pregel/VertexComputation.h"
 #include "Pregel/WorkerConfig.h"
 
+#include "Basics/FileUtils.h"
 #include "Basics/MutexLocker.h"
 #include "Basics/ReadLocker.h"
 #include "Basics/WriteLocker.h"
+#include "Basics/files.h"
 #include "Cluster/ClusterComm.h"
 #include "Cluster/ServerState.h"
 #include "Scheduler/Scheduler.h"
@@ -41,6 +43,8 @@
 #include "VocBase/ticks.h"
 #include "VocBase/vocbase.h"
 
+#include <algorithm>
+
 #include <velocypack/Iterator.h>
 #include <velocypack/velocypack-aliases.h>
 
@@ -48,6 +52,10 @@ using namespace arangodb;
 using namespace arangodb::basics;
 using namespace arangodb::pregel;
 
+/// a superstep only visits the frontier if less than 1/n of the vertices
+/// are active or receive messages
+static size_t const sparseFraction = 20;
+
 #define MY_READ_LOCKER(obj, lock)                                              \
   ReadLocker<ReadWriteLock> obj(&lock, arangodb::basics::LockerType::BLOCKING, \
                                 true, __FILE__, __LINE__)
@@ -129,6 +137,10 @@ Worker<V, E, M>::~Worker() {
     delete cache;
   }
   _writeCache = nullptr;
+  if (_config.checkpointInterval() > 0) {
+    MUTEX_LOCKER(guard, _checkpointMutex);
+    FileUtils::remove(_checkpointPath());
+  }
 }
 
 template <typename V, typename E, typename M>
@@ -289,6 +301,13 @@ void Worker<V, E, M>::startGlobalStep(VPackSlice const& data) {
     THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_BAD_PARAMETER, "Wrong GSS");
   }
 
+  // the state at the start of a superstep, the conductor keeps track
+  // of the same supersteps
+  uint64_t interval = _config.checkpointInterval();
+  if (interval > 0 && gss > 0 && gss % interval == 0) {
+    _writeCheckpoint();
+  }
+
   _workerAggregators->resetValues();
   _conductorAggregators->setAggregatedValues(data);
   // execute context
@@ -316,7 +335,40 @@ void Worker<V, E, M>::_startProcessing() {
   TRI_ASSERT(SchedulerFeature::SCHEDULER != nullptr);
   rest::Scheduler* scheduler = SchedulerFeature::SCHEDULER;
 
+  // the frontier of the last superstep
+  _frontier.swap(_nextFrontier);
+  bool frontierComplete = _nextFrontierComplete;
+  _nextFrontier.clear();
+  _nextFrontierComplete =
+      !_config.asynchronousMode() && !_config.lazyLoading();
+
+  // like a direction optimizing BFS switch to the sparse mode as soon as
+  // scanning all vertices is much more expensive than finding the targets
   size_t total = _graphStore->localVertexCount();
+  bool sparse = false;
+  if (frontierComplete &&
+      (_frontier.size() + _readCache->containedMessageCount()) *
+              sparseFraction <
+          total) {
+    _sparseTargets = _frontier;
+    _readCache->forEach(
+        [this](PregelShard shard, PregelKey const& key, M const&) {
+          VertexEntry* entry = _graphStore->lookupVertex(shard, key);
+          if (entry != nullptr) {
+            _sparseTargets.push_back(entry);
+          }
+        });
+    // visit every vertex once, in memory order
+    std::sort(_sparseTargets.begin(), _sparseTargets.end());
+    _sparseTargets.erase(
+        std::unique(_sparseTargets.begin(), _sparseTargets.end()),
+        _sparseTargets.end());
+    total = _sparseTargets.size();
+    sparse = true;
+    LOG_TOPIC(DEBUG, Logger::PREGEL) << "Computing " << total
+                                     << " vertices in sparse mode";
+  }
+
   size_t delta = total / _config.parallelism();
   size_t start = 0, end = delta;
   if (delta < 100 || total < 100) {
@@ -327,14 +379,22 @@ void Worker<V, E, M>::_startProcessing() {
   }
   size_t i = 0;
   do {
-    scheduler->post([this, start, end, i] {
+    scheduler->post([this, start, end, i, sparse] {
       if (_state != WorkerState::COMPUTING) {
         LOG_TOPIC(WARN, Logger::PREGEL) << "Execution aborted prematurely.";
         return;
       }
-      auto vertices = _graphStore->vertexIterator(start, end);
+      bool lastThread;
+      if (sparse) {
+        PointerIterator<VertexEntry> vertices(_sparseTargets.data() + start,
+                                              end - start);
+        lastThread = _processVertices(i, vertices);
+      } else {
+        auto vertices = _graphStore->vertexIterator(start, end);
+        lastThread = _processVertices(i, vertices);
+      }
       // should work like a join operation
-      if (_processVertices(i, vertices) && _state == WorkerState::COMPUTING) {
+      if (lastThread && _state == WorkerState::COMPUTING) {
         _finishedProcessing();  // last thread turns the lights out
       }
     });
@@ -360,8 +420,9 @@ void Worker<V, E, M>::_initializeVertexContext(VertexContext<V, E, M>* ctx) {
 
 // internally called in a WORKER THREAD!!
 template <typename V, typename E, typename M>
-bool Worker<V, E, M>::_processVertices(
-    size_t threadId, RangeIterator<VertexEntry>& vertexIterator) {
+template <typename Iterator>
+bool Worker<V, E, M>::_processVertices(size_t threadId,
+                                       Iterator& vertexIterator) {
   double start = TRI_microtime();
 
   // thread local caches
@@ -389,6 +450,10 @@ bool Worker<V, E, M>::_processVertices(
   }
 
   size_t activeCount = 0;
+  // give up tracking once the frontier is too large to be useful
+  bool trackFrontier = _nextFrontierComplete;
+  size_t const frontierLimit = _graphStore->localVertexCount() / sparseFraction;
+  std::vector<VertexEntry*> frontier;
   for (VertexEntry* vertexEntry : vertexIterator) {
     MessageIterator<M> messages =
         _readCache->getMessages(vertexEntry->shard(), vertexEntry->key());
@@ -398,6 +463,13 @@ bool Worker<V, E, M>::_processVertices(
       vertexComputation->compute(messages);
       if (vertexEntry->active()) {
         activeCount++;
+        if (trackFrontier) {
+          frontier.push_back(vertexEntry);
+          if (frontier.size() > frontierLimit) {
+            trackFrontier = false;
+            frontier.clear();
+          }
+        }
       }
     }
     if (_state != WorkerState::COMPUTING) {
@@ -439,6 +511,15 @@ bool Worker<V, E, M>::_processVertices(
     _workerAggregators->aggregateValues(workerAggregator);
     _messageStats.accumulate(stats);
     _activeCount += activeCount;
+    if (_nextFrontierComplete) {
+      if (trackFrontier) {
+        _nextFrontier.insert(_nextFrontier.end(), frontier.begin(),
+                             frontier.end());
+      } else {
+        _nextFrontierComplete = false;
+        _nextFrontier.clear();
+      }
+    }
     _runningThreads--;
     lastThread = _runningThreads == 0;  // should work like a join operation
   }
@@ -637,18 +718,148 @@ void Worker<V, E, M>::aqlResult(VPackBuilder* b) const {
   b->close();
 }
 
+template <typename V, typename E, typename M>
+std::string Worker<V, E, M>::_checkpointPath() const {
+  return FileUtils::buildFilename(
+      TRI_GetTempPath(),
+      "pregel_checkpoint_" + std::to_string(_config.executionNumber()));
+}
+
+/// WARNING only call this while holding the _commandMutex
+/// Captures the vertex values and the messages for the current gss,
+/// the file is written in the background
+template <typename V, typename E, typename M>
+void Worker<V, E, M>::_writeCheckpoint() {
+  uint64_t gss = _config.globalSuperstep();
+  VPackBuilder vertices;
+  if (!_graphStore->snapshotVertices(vertices)) {
+    LOG_TOPIC(WARN, Logger::PREGEL)
+        << "Vertex values of this algorithm can not be checkpointed";
+    return;
+  }
+
+  VPackBuilder b;
+  b.openObject();
+  b.add(Utils::globalSuperstepKey, VPackValue(gss));
+  b.add(Utils::activeCountKey, VPackValue(_activeCount));
+  b.add(Utils::vertexShardsKey, VPackValue(VPackValueType::Array));
+  for (ShardID const& shard : _config.localVertexShardIDs()) {
+    b.add(VPackValue(shard));
+  }
+  b.close();
+  b.add("vertices", vertices.slice());
+  // flat list of shard, key and message
+  b.add(Utils::messagesKey, VPackValue(VPackValueType::Array));
+  _readCache->forEach(
+      [&](PregelShard shard, PregelKey const& key, M const& message) {
+        b.add(VPackValue(shard));
+        b.add(VPackValue(key));
+        _messageFormat->addValue(b, message);
+      });
+  b.close();
+  _workerAggregators->serializeValues(b);
+  b.close();
+
+  auto data = std::make_shared<std::string>(
+      reinterpret_cast<char const*>(b.data()), b.size());
+  TRI_ASSERT(SchedulerFeature::SCHEDULER != nullptr);
+  rest::Scheduler* scheduler = SchedulerFeature::SCHEDULER;
+  scheduler->post([this, gss, data] {
+    MUTEX_LOCKER(guard, _checkpointMutex);
+    if (_state == WorkerState::DONE || gss <= _checkpointGSS) {
+      return;
+    }
+    std::string path = _checkpointPath();
+    std::string tmp = path + ".tmp";
+    try {
+      FileUtils::spit(tmp, *data, true);
+    } catch (...) {
+      LOG_TOPIC(WARN, Logger::PREGEL) << "Could not write checkpoint " << tmp;
+      return;
+    }
+    if (TRI_RenameFile(tmp.c_str(), path.c_str()) != TRI_ERROR_NO_ERROR) {
+      LOG_TOPIC(WARN, Logger::PREGEL) << "Could not write checkpoint " << path;
+      return;
+    }
+    _checkpointGSS = gss;
+    LOG_TOPIC(DEBUG, Logger::PREGEL) << "Wrote checkpoint for gss " << gss;
+  });
+}
+
+/// WARNING only call this while holding the _commandMutex
+template <typename V, typename E, typename M>
+bool Worker<V, E, M>::_restoreCheckpoint(uint64_t gss) {
+  MUTEX_LOCKER(guard, _checkpointMutex);
+  if (gss == 0 || _checkpointGSS != gss) {
+    LOG_TOPIC(WARN, Logger::PREGEL) << "There is no checkpoint for gss " << gss;
+    return false;
+  }
+
+  std::string content;
+  try {
+    content = FileUtils::slurp(_checkpointPath());
+  } catch (...) {
+    LOG_TOPIC(WARN, Logger::PREGEL) << "Could not read checkpoint";
+    return false;
+  }
+  VPackSlice checkpoint(reinterpret_cast<uint8_t const*>(content.data()));
+  if (content.empty() || !checkpoint.isObject() ||
+      checkpoint.byteSize() != content.size()) {
+    return false;
+  }
+
+  // vertices are restored by their position in the graph store
+  VPackSlice shards = checkpoint.get(Utils::vertexShardsKey);
+  std::vector<ShardID> const& localShards = _config.localVertexShardIDs();
+  if (!shards.isArray() || shards.length() != localShards.size()) {
+    return false;
+  }
+  size_t i = 0;
+  for (VPackSlice shard : VPackArrayIterator(shards)) {
+    if (!shard.isEqualString(localShards[i++])) {
+      return false;
+    }
+  }
+  if (!_graphStore->restoreVertices(checkpoint.get("vertices"))) {
+    return false;
+  }
+
+  {
+    // the next prepareGlobalStep swaps these into the read cache
+    MY_WRITE_LOCKER(wguard, _cacheRWLock);
+    VPackArrayIterator it(checkpoint.get(Utils::messagesKey));
+    while (it.valid()) {
+      PregelShard shard = (PregelShard)it.value().getUInt();
+      it.next();
+      PregelKey key = it.value().copyString();
+      it.next();
+      M message;
+      _messageFormat->unwrapValue(it.value(), message);
+      it.next();
+      _writeCache->storeMessageNoLock(shard, key, message);
+    }
+  }
+
+  _activeCount = checkpoint.get(Utils::activeCountKey).getUInt();
+  _workerAggregators->resetValues();
+  _workerAggregators->setAggregatedValues(checkpoint);
+  return true;
+}
+
 template <typename V, typename E, typename M>
 void Worker<V, E, M>::startRecovery(VPackSlice const& data) {
   // other methods might lock _commandMutex
   MUTEX_LOCKER(guard, _commandMutex);
   VPackSlice method = data.get(Utils::recoveryMethodKey);
-  if (method.compareString(Utils::compensate) != 0) {
+  bool rollback = method.isEqualString(Utils::rollback);
+  if (!rollback && !method.isEqualString(Utils::compensate)) {
     LOG_TOPIC(ERR, Logger::PREGEL) << "Unsupported operation";
     return;
   }
-  // else if (method.compareString(Utils::rollback) == 0)
 
   _state = WorkerState::RECOVERING;
+  // recovery changes the active flags
+  _nextFrontierComplete = false;
   {
     MY_WRITE_LOCKER(guard, _cacheRWLock);
     _writeCache->clear();
@@ -659,6 +870,43 @@ void Worker<V, E, M>::startRecovery(VPackSlice const& data) {
   }
 
   VPackBuilder copy(data);
+  if (rollback) {
+    // a checkpoint only fits the shards which were loaded when writing it
+    WorkerConfig nextState(_config);
+    nextState.updateConfig(data);
+    bool sameShards =
+        nextState.globalShardIDs() == _config.globalShardIDs() &&
+        nextState.localVertexShardIDs() == _config.localVertexShardIDs();
+
+    TRI_ASSERT(SchedulerFeature::SCHEDULER != nullptr);
+    rest::Scheduler* scheduler = SchedulerFeature::SCHEDULER;
+    scheduler->post([this, copy, sameShards] {
+      MUTEX_LOCKER(guard, _commandMutex);
+      if (_state != WorkerState::RECOVERING) {
+        LOG_TOPIC(WARN, Logger::PREGEL) << "Rollback aborted prematurely.";
+        return;
+      }
+      uint64_t gss = copy.slice().get(Utils::globalSuperstepKey).getUInt();
+      bool restored = sameShards && _restoreCheckpoint(gss);
+      if (restored) {
+        _expectedGSS = gss;
+        LOG_TOPIC(INFO, Logger::PREGEL) << "Rolled back to gss " << gss;
+      }
+
+      VPackBuilder package;
+      package.openObject();
+      package.add(Utils::senderKey,
+                  VPackValue(ServerState::instance()->getId()));
+      package.add(Utils::executionNumberKey,
+                  VPackValue(_config.executionNumber()));
+      package.add(Utils::globalSuperstepKey, VPackValue(gss));
+      package.add(Utils::checkpointRestoredKey, VPackValue(restored));
+      package.close();
+      _callConductor(Utils::finishedRecoveryPath, package);
+    });
+    return;
+  }
+
   // hack to determine newly added vertices
   _preRecoveryTotal = _graphStore->localVertexCount();
   WorkerConfig nextState(_config);
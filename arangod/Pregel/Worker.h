@@ -125,19 +125,34 @@ class Worker : public IWorker {
   uint64_t _activeCount = 0;
   /// current number of running threads
   size_t _runningThreads = 0;
+  /// vertices which stayed active during the last superstep. Only
+  /// complete in the synchronous mode and while few vertices are active,
+  /// then a superstep can skip all other vertices without messages
+  std::vector<VertexEntry*> _frontier;
+  std::vector<VertexEntry*> _nextFrontier;
+  bool _nextFrontierComplete = false;
+  /// vertices computed during a sparse superstep
+  std::vector<VertexEntry*> _sparseTargets;
   /// During async mode this should keep track of the send messages
   std::atomic<uint64_t> _nextGSSSendMessageCount;
   /// if the worker has started sendng messages to the next GSS
   std::atomic<bool> _requestedNextGSS;
   std::unique_ptr<boost::asio::deadline_timer> _boost_timer;
+  /// serializes writing and reading the checkpoint file
+  mutable Mutex _checkpointMutex;
+  /// gss of the checkpoint stored on disk, 0 if there is none
+  uint64_t _checkpointGSS = 0;
 
   void _initializeMessageCaches();
   void _initializeVertexContext(VertexContext<V, E, M>* ctx);
   void _startProcessing();
-  bool _processVertices(size_t threadId,
-                        RangeIterator<VertexEntry>& vertexIterator);
+  template <typename Iterator>
+  bool _processVertices(size_t threadId, Iterator& vertexIterator);
   void _finishedProcessing();
   void _continueAsync();
+  std::string _checkpointPath() const;
+  void _writeCheckpoint();
+  bool _restoreCheckpoint(uint64_t gss);
   void _callConductor(std::string const& path, VPackBuilder const& message);
   void _callConductorWithResponse(std::string const& path,
                                   VPackBuilder const& message,
@@ -61,6 +61,12 @@ void WorkerConfig::updateConfig(VPackSlice params) {
     _parallelism =
         std::min(std::max((uint64_t)1, parallel.getUInt()), _parallelism);
   }
+  VPackSlice memoryMaps = userParams.get(Utils::useMemoryMapsKey);
+  _useMemoryMaps = memoryMaps.isBool() && memoryMaps.getBool();
+  VPackSlice checkpoints = userParams.get(Utils::checkpointIntervalKey);
+  if (checkpoints.isInteger() && !_asynchronousMode) {
+    _checkpointInterval = checkpoints.getUInt();
+  }
 
   // list of all shards, equal on all workers. Used to avoid storing strings of
   // shard names
@@ -60,6 +60,12 @@ class WorkerConfig {
 
   inline uint64_t parallelism() const { return _parallelism; }
 
+  /// store vertex and edge data in memory mapped temporary files
+  inline bool useMemoryMaps() const { return _useMemoryMaps; }
+
+  /// write a checkpoint every n supersteps, 0 disables checkpoints
+  inline uint64_t checkpointInterval() const { return _checkpointInterval; }
+
   inline std::string const& coordinatorId() const { return _coordinatorId; }
 
   inline TRI_vocbase_t* const& vocbase() const { return _vocbase; }
@@ -129,6 +135,10 @@ class WorkerConfig {
   bool _lazyLoading = false;
 
   uint64_t _parallelism = 1;
+  /// keep graph data in memory mapped files, even if it fits into RAM
+  bool _useMemoryMaps = false;
+  /// supersteps between two checkpoints
+  uint64_t _checkpointInterval = 0;
 
   std::string _coordinatorId;
   TRI_vocbase_t* _vocbase;
@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "ApplyWorkerPool.h"
+#include "Basics/ConditionLocker.h"
+#include "Logger/Logger.h"
+
+using namespace arangodb;
+
+ApplyWorkerPool::ApplyWorkerPool(size_t parallelism)
+    : _work(nullptr),
+      _generation(0),
+      _wanted(0),
+      _active(0),
+      _stopping(false) {
+  TRI_ASSERT(parallelism > 0);
+
+  _threads.reserve(parallelism - 1);
+  try {
+    for (size_t i = 1; i < parallelism; ++i) {
+      _threads.emplace_back([this]() { loop(); });
+    }
+  } catch (...) {
+    // could not start all threads. go on with the ones we have
+    LOG_TOPIC(WARN, Logger::REPLICATION)
+        << "could only start " << _threads.size()
+        << " replication apply threads";
+  }
+}
+
+ApplyWorkerPool::~ApplyWorkerPool() {
+  {
+    CONDITION_LOCKER(guard, _condition);
+    _stopping = true;
+    guard.broadcast();
+  }
+
+  for (auto& thread : _threads) {
+    thread.join();
+  }
+}
+
+/// @brief calls work on the calling thread and on up to threads - 1 pool
+/// threads
+void ApplyWorkerPool::run(std::function<void()> const& work, size_t threads) {
+  threads = (std::min)(threads, parallelism());
+
+  if (threads > 1) {
+    CONDITION_LOCKER(guard, _condition);
+    TRI_ASSERT(_work == nullptr);
+    TRI_ASSERT(_active == 0);
+    _work = &work;
+    _wanted = threads - 1;
+    ++_generation;
+    guard.broadcast();
+  }
+
+  // the calling thread takes its share as well
+  std::exception_ptr error;
+  try {
+    work();
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  if (threads > 1) {
+    CONDITION_LOCKER(guard, _condition);
+    // pool threads that have not joined yet would not find anything to do
+    _wanted = 0;
+    while (_active > 0) {
+      guard.wait();
+    }
+    _work = nullptr;
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+/// @brief main loop of a pool thread
+void ApplyWorkerPool::loop() {
+  uint64_t seen = 0;
+
+  CONDITION_LOCKER(guard, _condition);
+
+  while (true) {
+    while (!_stopping && _generation == seen) {
+      guard.wait();
+    }
+    if (_stopping) {
+      return;
+    }
+    seen = _generation;
+
+    if (_wanted == 0) {
+      // the run is complete without this thread
+      continue;
+    }
+    --_wanted;
+    ++_active;
+    std::function<void()> const* work = _work;
+
+    guard.unlock();
+    try {
+      (*work)();
+    } catch (std::exception const& ex) {
+      LOG_TOPIC(WARN, Logger::REPLICATION)
+          << "caught exception in replication apply thread: " << ex.what();
+    } catch (...) {
+      LOG_TOPIC(WARN, Logger::REPLICATION)
+          << "caught unknown exception in replication apply thread";
+    }
+    guard.lock();
+
+    if (--_active == 0) {
+      guard.broadcast();
+    }
+  }
+}
@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_REPLICATION_APPLY_WORKER_POOL_H
+#define ARANGOD_REPLICATION_APPLY_WORKER_POOL_H 1
+
+#include "Basics/Common.h"
+#include "Basics/ConditionVariable.h"
+
+#include <functional>
+#include <thread>
+
+namespace arangodb {
+
+/// @brief threads that help the continuous syncer to apply operations.
+/// the threads are started once and live as long as the pool, a run only
+/// wakes them up
+class ApplyWorkerPool {
+ public:
+  /// @brief a pool for runs on up to parallelism threads, the calling
+  /// thread included. parallelism - 1 threads are started
+  explicit ApplyWorkerPool(size_t parallelism);
+  ~ApplyWorkerPool();
+
+  ApplyWorkerPool(ApplyWorkerPool const&) = delete;
+  ApplyWorkerPool& operator=(ApplyWorkerPool const&) = delete;
+
+ public:
+  /// @brief maximal number of threads of a run, the calling thread included
+  size_t parallelism() const { return _threads.size() + 1; }
+
+  /// @brief calls work on the calling thread and on up to threads - 1 pool
+  /// threads, and returns when all calls have returned. work must take its
+  /// items from shared state, as pool threads may join the run late or not
+  /// at all. exceptions thrown by work on pool threads are dropped. only
+  /// one run at a time is allowed
+  void run(std::function<void()> const& work, size_t threads);
+
+ private:
+  /// @brief main loop of a pool thread
+  void loop();
+
+ private:
+  std::vector<std::thread> _threads;
+
+  /// @brief protects the members below
+  basics::ConditionVariable _condition;
+
+  /// @brief work of the current run, nullptr if there is none
+  std::function<void()> const* _work;
+
+  /// @brief number of the current run
+  uint64_t _generation;
+
+  /// @brief number of pool threads that may still join the current run
+  size_t _wanted;
+
+  /// @brief number of pool threads working on the current run
+  size_t _active;
+
+  bool _stopping;
+};
+
+}  // namespace arangodb
+
+#endif
@@ -24,6 +24,7 @@
 #include "ContinuousSyncer.h"
 #include "ApplicationFeatures/ApplicationServer.h"
 #include "Basics/Exceptions.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/Result.h"
 #include "Basics/ReadLocker.h"
 #include "Basics/StaticStrings.h"
@@ -36,9 +37,9 @@
 #include "RestServer/DatabaseFeature.h"
 #include "SimpleHttpClient/SimpleHttpClient.h"
 #include "SimpleHttpClient/SimpleHttpResult.h"
-#include "StorageEngine/EngineSelectorFeature.h"
 #include "StorageEngine/StorageEngine.h"
 #include "Utils/CollectionGuard.h"
+#include "Utils/OperationOptions.h"
 #include "Utils/SingleCollectionTransaction.h"
 #include "Transaction/Hints.h"
 #include "VocBase/LogicalCollection.h"
@@ -50,12 +51,15 @@
 #include <velocypack/Parser.h>
 #include <velocypack/Slice.h>
 #include <velocypack/velocypack-aliases.h>
+#include <atomic>
 
 using namespace arangodb;
 using namespace arangodb::basics;
 using namespace arangodb::httpclient;
 using namespace arangodb::rest;
 
+size_t const ContinuousSyncer::MaxBatchSize = 1000;
+
 ContinuousSyncer::ContinuousSyncer(
     TRI_vocbase_t* vocbase,
     TRI_replication_applier_configuration_t const* configuration,
@@ -72,7 +76,12 @@ ContinuousSyncer::ContinuousSyncer(
       _verbose(configuration->_verbose),
       _masterIs27OrHigher(false),
       _hasWrittenState(false),
-      _supportsSingleOperations(false) {
+      _applyParallelism(static_cast<size_t>(
+          (std::max)(configuration->_applyParallelism, uint64_t(1)))),
+      _applyWorkers(_applyParallelism),
+      _batchCid(0),
+      _batchSize(0),
+      _batchTick(0) {
   uint64_t c = configuration->_chunkSize;
   if (c == 0) {
     c = static_cast<uint64_t>(256 * 1024);  // 256 kb
@@ -92,10 +101,6 @@ ContinuousSyncer::ContinuousSyncer(
     _barrierId = barrierId;
     _barrierUpdateTime = TRI_microtime();
   }
-  
-  // FIXME: move this into engine code  
-  std::string engineName = EngineSelectorFeature::ENGINE->typeName();
-  _supportsSingleOperations = (engineName == "mmfiles");
 }
 
 ContinuousSyncer::~ContinuousSyncer() { 
@@ -478,21 +483,24 @@ int ContinuousSyncer::getLocalState(std::string& errorMsg) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief inserts a document, based on the VelocyPack provided
+/// @brief extracts the collection, the document and its key and revision
+/// from a document marker
 ////////////////////////////////////////////////////////////////////////////////
 
-int ContinuousSyncer::processDocument(TRI_replication_operation_e type,
-                                      VPackSlice const& slice,
-                                      std::string& errorMsg) {
+int ContinuousSyncer::parseDocumentMarker(VPackSlice const& slice,
+                                          TRI_voc_cid_t& cid, bool& isSystem,
+                                          VPackBuilder& builder,
+                                          VPackSlice& doc,
+                                          std::string& errorMsg) {
   // extract "cid"
-  TRI_voc_cid_t cid = getCid(slice);
+  cid = getCid(slice);
 
   if (cid == 0) {
     return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
   }
 
   // extract optional "cname"
-  bool isSystem = false;
+  isSystem = false;
   VPackSlice const cname = slice.get("cname");
 
   if (cname.isString()) {
@@ -509,7 +517,7 @@ int ContinuousSyncer::processDocument(TRI_replication_operation_e type,
   }
 
   // extract "data"
-  VPackSlice const doc = slice.get("data");
+  doc = slice.get("data");
 
   if (!doc.isObject()) {
     errorMsg = "invalid document format";
@@ -532,12 +540,32 @@ int ContinuousSyncer::processDocument(TRI_replication_operation_e type,
     return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
   }
 
-  VPackBuilder builder;
   builder.openObject();
   builder.add(StaticStrings::KeyString, key);
   builder.add(StaticStrings::RevString, rev);
   builder.close();
 
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts a document, based on the VelocyPack provided
+////////////////////////////////////////////////////////////////////////////////
+
+int ContinuousSyncer::processDocument(TRI_replication_operation_e type,
+                                      VPackSlice const& slice,
+                                      std::string& errorMsg) {
+  TRI_voc_cid_t cid;
+  bool isSystem;
+  VPackBuilder builder;
+  VPackSlice doc;
+
+  int res = parseDocumentMarker(slice, cid, isSystem, builder, doc, errorMsg);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
   VPackSlice const old = builder.slice();
 
   // extract "tid"
@@ -566,7 +594,7 @@ int ContinuousSyncer::processDocument(TRI_replication_operation_e type,
     }
 
     trx->addCollectionAtRuntime(cid, "", AccessMode::Type::EXCLUSIVE); 
-    int res = applyCollectionDumpMarker(*trx, trx->name(cid), type, old, doc, errorMsg);
+    res = applyCollectionDumpMarker(*trx, trx->name(cid), type, old, doc, errorMsg);
 
     if (res == TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED && isSystem) {
       // ignore unique constraint violations for system collections
@@ -577,33 +605,259 @@ int ContinuousSyncer::processDocument(TRI_replication_operation_e type,
   }
 
   else {
-    // standalone operation
-    // update the apply tick for all standalone operations
-    SingleCollectionTransaction trx(transaction::StandaloneContext::Create(_vocbase),
-                                            cid, AccessMode::Type::EXCLUSIVE);
-  
-    if (_supportsSingleOperations) {
-      trx.addHint(transaction::Hints::Hint::SINGLE_OPERATION);
+    // standalone operation, appended to the current batch
+    if (_batchTrx != nullptr && _batchCid != cid) {
+      res = finishBatch(errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
     }
 
-    Result res = trx.begin();
+    if (_batchTrx == nullptr) {
+      auto trx = std::make_unique<SingleCollectionTransaction>(
+          transaction::StandaloneContext::Create(_vocbase), cid,
+          AccessMode::Type::EXCLUSIVE);
+      Result result = trx->begin();
 
-    // fix error handling here when function returns result //////////////////////
-    if (!res.ok()) {
-      errorMsg = "unable to create replication transaction: " + res.errorMessage();
-      res.reset(res.errorNumber(),errorMsg);
-    } else {
-      res = applyCollectionDumpMarker(trx, trx.name(), type, old, doc, errorMsg); 
-      if (res.errorNumber() == TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED && isSystem) {
-        // ignore unique constraint violations for system collections
-        res.reset();
+      if (!result.ok()) {
+        errorMsg = "unable to create replication transaction: " +
+                   result.errorMessage();
+        return result.errorNumber();
       }
+
+      _batchTrx = std::move(trx);
+      _batchCid = cid;
     }
-    // fix error handling here when function returns result //////////////////////
 
-    res = trx.finish(res);
+    res = applyCollectionDumpMarker(*_batchTrx, _batchTrx->name(), type, old,
+                                    doc, errorMsg);
+
+    if (res == TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED && isSystem) {
+      // ignore unique constraint violations for system collections
+      res = TRI_ERROR_NO_ERROR;
+    }
+
+    ++_batchSize;
+    return res;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief commit the batch of standalone document operations
+////////////////////////////////////////////////////////////////////////////////
+
+int ContinuousSyncer::finishBatch(std::string& errorMsg) {
+  if (_batchTrx == nullptr) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  std::unique_ptr<SingleCollectionTransaction> trx(std::move(_batchTrx));
+  _batchSize = 0;
+
+  Result res = trx->commit();
+
+  if (!res.ok()) {
+    errorMsg = "unable to commit replication transaction: " + res.errorMessage();
     return res.errorNumber();
   }
+
+  // the operations of the batch are only applied now
+  WRITE_LOCKER_EVENTUAL(writeLocker, _applier->_statusLock);
+
+  if (_batchTick > _applier->_state._lastAppliedContinuousTick) {
+    _applier->_state._lastAppliedContinuousTick = _batchTick;
+  }
+
+  if (_ongoingTransactions.empty() &&
+      _batchTick > _applier->_state._safeResumeTick) {
+    _applier->_state._safeResumeTick = _batchTick;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a standalone document operation waiting to be applied
+////////////////////////////////////////////////////////////////////////////////
+
+struct ContinuousSyncer::PendingDocument {
+  std::shared_ptr<VPackBuilder> marker;
+  VPackBuilder old;
+  VPackSlice doc;
+  TRI_replication_operation_e type;
+  TRI_voc_cid_t cid;
+  bool isSystem;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief apply a run of standalone document operations, with the
+/// collections involved being written to concurrently
+////////////////////////////////////////////////////////////////////////////////
+
+int ContinuousSyncer::applyPendingDocuments(
+    std::vector<PendingDocument>& pending, TRI_voc_tick_t lastTick,
+    uint64_t& ignoreCount, std::string& errorMsg) {
+  if (pending.empty()) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  // operations on different collections do not depend on each other, only
+  // the order of the operations on the same collection must be kept
+  std::vector<std::vector<PendingDocument const*>> groups;
+  std::unordered_map<TRI_voc_cid_t, size_t> positions;
+
+  for (auto const& document : pending) {
+    auto it = positions.emplace(document.cid, groups.size());
+
+    if (it.second) {
+      groups.emplace_back();
+    }
+    groups[it.first->second].emplace_back(&document);
+  }
+
+  std::atomic<uint64_t> ignoreBudget(ignoreCount);
+
+  auto applyGroup = [&](std::vector<PendingDocument const*> const& group,
+                        std::string& msg) -> int {
+    std::unique_ptr<SingleCollectionTransaction> trx;
+    size_t count = 0;
+
+    for (auto const* document : group) {
+      if (trx == nullptr) {
+        trx.reset(new SingleCollectionTransaction(
+            transaction::StandaloneContext::Create(_vocbase), document->cid,
+            AccessMode::Type::EXCLUSIVE));
+        Result res = trx->begin();
+
+        if (!res.ok()) {
+          msg = "unable to create replication transaction: " +
+                res.errorMessage();
+          return res.errorNumber();
+        }
+      }
+
+      int res = applyCollectionDumpMarker(*trx, trx->name(), document->type,
+                                          document->old.slice(), document->doc,
+                                          msg);
+
+      if (res == TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED &&
+          document->isSystem) {
+        // ignore unique constraint violations for system collections
+        res = TRI_ERROR_NO_ERROR;
+      }
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        uint64_t budget = ignoreBudget.load();
+
+        do {
+          if (budget == 0) {
+            if (msg.empty()) {
+              msg = TRI_errno_string(res);
+            }
+            return res;
+          }
+        } while (!ignoreBudget.compare_exchange_weak(budget, budget - 1));
+
+        LOG_TOPIC(WARN, Logger::REPLICATION)
+            << "ignoring replication error for database '"
+            << _applier->databaseName() << "': "
+            << (msg.empty() ? TRI_errno_string(res) : msg);
+        msg.clear();
+      }
+
+      if (++count >= MaxBatchSize) {
+        Result commitResult = trx->commit();
+        trx.reset();
+        count = 0;
+
+        if (!commitResult.ok()) {
+          msg = "unable to commit replication transaction: " +
+                commitResult.errorMessage();
+          return commitResult.errorNumber();
+        }
+      }
+    }
+
+    if (trx != nullptr) {
+      Result res = trx->commit();
+
+      if (!res.ok()) {
+        msg = "unable to commit replication transaction: " +
+              res.errorMessage();
+        return res.errorNumber();
+      }
+    }
+
+    return TRI_ERROR_NO_ERROR;
+  };
+
+  // groups are handed out one at a time, so a collection with many
+  // operations does not keep the others waiting
+  std::atomic<size_t> next(0);
+  std::atomic<bool> failed(false);
+  Mutex resultMutex;
+  int result = TRI_ERROR_NO_ERROR;
+
+  auto work = [&]() {
+    while (!failed.load()) {
+      size_t current = next++;
+      if (current >= groups.size()) {
+        break;
+      }
+
+      std::string msg;
+      int res;
+      try {
+        res = applyGroup(groups[current], msg);
+      } catch (basics::Exception const& ex) {
+        res = ex.code();
+        msg = ex.what();
+      } catch (std::exception const& ex) {
+        res = TRI_ERROR_INTERNAL;
+        msg = ex.what();
+      }
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        failed = true;
+        MUTEX_LOCKER(locker, resultMutex);
+        if (result == TRI_ERROR_NO_ERROR) {
+          result = res;
+          errorMsg = msg;
+        }
+      }
+    }
+  };
+
+  // the calling thread takes its share of the groups as well
+  _applyWorkers.run(work, groups.size());
+
+  pending.clear();
+  ignoreCount = ignoreBudget.load();
+
+  if (result != TRI_ERROR_NO_ERROR) {
+    // groups may have been committed partially. the applied tick stays
+    // where it was, so everything is applied again after a restart
+    return result;
+  }
+
+  // all operations up to the last one of the run are applied now
+  WRITE_LOCKER_EVENTUAL(writeLocker, _applier->_statusLock);
+
+  if (lastTick > _applier->_state._lastProcessedContinuousTick) {
+    _applier->_state._lastProcessedContinuousTick = lastTick;
+  }
+
+  if (lastTick > _applier->_state._lastAppliedContinuousTick) {
+    _applier->_state._lastAppliedContinuousTick = lastTick;
+  }
+
+  if (_ongoingTransactions.empty() &&
+      lastTick > _applier->_state._safeResumeTick) {
+    _applier->_state._safeResumeTick = lastTick;
+  }
+
+  return TRI_ERROR_NO_ERROR;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -802,6 +1056,45 @@ int ContinuousSyncer::changeCollection(VPackSlice const& slice) {
   return guard.collection()->updateProperties(data, doSync).errorNumber();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief truncates a collection, based on the VelocyPack provided
+////////////////////////////////////////////////////////////////////////////////
+
+int ContinuousSyncer::truncateCollection(VPackSlice const& slice) {
+  if (!slice.isObject()) {
+    return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+  }
+
+  TRI_voc_cid_t cid = getCid(slice);
+  std::string const cname = getCName(slice);
+  arangodb::LogicalCollection* col = getCollectionByIdOrName(cid, cname);
+
+  if (col == nullptr) {
+    return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
+  }
+
+  SingleCollectionTransaction trx(
+      transaction::StandaloneContext::Create(_vocbase), col->cid(),
+      AccessMode::Type::EXCLUSIVE);
+  trx.addHint(transaction::Hints::Hint::ALLOW_RANGE_DELETE);
+
+  Result res = trx.begin();
+
+  if (!res.ok()) {
+    return res.errorNumber();
+  }
+
+  OperationOptions options;
+  OperationResult opRes = trx.truncate(col->name(), options);
+
+  res = trx.finish(opRes.code);
+
+  if (!opRes.successful()) {
+    return opRes.code;
+  }
+  return res.errorNumber();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief apply a single marker from the continuous log
 ////////////////////////////////////////////////////////////////////////////////
@@ -870,6 +1163,10 @@ int ContinuousSyncer::applyLogMarker(VPackSlice const& slice,
     return changeCollection(slice);
   }
 
+  else if (type == REPLICATION_COLLECTION_TRUNCATE) {
+    return truncateCollection(slice);
+  }
+
   else if (type == REPLICATION_INDEX_CREATE) {
     return createIndex(slice);
   }
@@ -895,6 +1192,21 @@ int ContinuousSyncer::applyLogMarker(VPackSlice const& slice,
   return TRI_ERROR_REPLICATION_UNEXPECTED_MARKER;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the marker is a document operation outside of a transaction
+////////////////////////////////////////////////////////////////////////////////
+
+static bool isStandaloneDocument(VPackSlice const& slice) {
+  int type = VelocyPackHelper::getNumericValue<int>(slice, "type", 0);
+
+  if (type != REPLICATION_MARKER_DOCUMENT && type != REPLICATION_MARKER_REMOVE) {
+    return false;
+  }
+
+  std::string const tid = VelocyPackHelper::getStringValue(slice, "tid", "");
+  return tid.empty() || StringUtils::uint64(tid.c_str(), tid.size()) == 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief apply the data from the continuous log
 ////////////////////////////////////////////////////////////////////////////////
@@ -911,6 +1223,18 @@ int ContinuousSyncer::applyLog(SimpleHttpResult* response,
   // buffer must end with a NUL byte
   TRI_ASSERT(*end == '\0');
 
+  // standalone document operations that are applied together, as soon as
+  // a marker arrives that may depend on them
+  std::vector<PendingDocument> pending;
+  TRI_voc_tick_t pendingTick = 0;
+
+  // operations applied so far are kept when we bail out with an error
+  TRI_DEFER(try {
+    std::string ignored;
+    finishBatch(ignored);
+  } catch (...) {
+  });
+
   while (p < end) {
     char const* q = strchr(p, '\n');
 
@@ -923,7 +1247,13 @@ int ContinuousSyncer::applyLog(SimpleHttpResult* response,
 
     if (lineLength < 2) {
       // we are done
-      return TRI_ERROR_NO_ERROR;
+      int res = applyPendingDocuments(pending, pendingTick, ignoreCount,
+                                      errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+      return finishBatch(errorMsg);
     }
 
     TRI_ASSERT(q <= end);
@@ -956,6 +1286,56 @@ int ContinuousSyncer::applyLog(SimpleHttpResult* response,
 
     //LOG_TOPIC(ERR, Logger::FIXME) << slice.toJson();
 
+    if (_applyParallelism > 1 && isStandaloneDocument(slice) &&
+        !skipMarker(firstRegularTick, slice)) {
+      PendingDocument document;
+      res = parseDocumentMarker(slice, document.cid, document.isSystem,
+                                document.old, document.doc, errorMsg);
+
+      if (res == TRI_ERROR_NO_ERROR) {
+        document.marker = builder;
+        document.type = static_cast<TRI_replication_operation_e>(
+            VelocyPackHelper::getNumericValue<int>(slice, "type", 0));
+
+        std::string const tick =
+            VelocyPackHelper::getStringValue(slice, "tick", "");
+
+        if (!tick.empty()) {
+          TRI_voc_tick_t newTick = static_cast<TRI_voc_tick_t>(
+              StringUtils::uint64(tick.c_str(), tick.size()));
+
+          if (newTick >= firstRegularTick && newTick > pendingTick) {
+            pendingTick = newTick;
+          }
+        }
+
+        pending.emplace_back(std::move(document));
+        continue;
+      }
+
+      // invalid markers are reported by the regular code path below
+      errorMsg.clear();
+    }
+
+    if (!pending.empty()) {
+      // everything else must see the operations before it
+      res = applyPendingDocuments(pending, pendingTick, ignoreCount, errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+    }
+
+    if (_batchTrx != nullptr && (_batchSize >= MaxBatchSize ||
+                                 !isStandaloneDocument(slice))) {
+      // everything else must see the operations of the batch
+      res = finishBatch(errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+    }
+
     if (skipMarker(firstRegularTick, slice)) {
       // entry is skipped
       res = TRI_ERROR_NO_ERROR;
@@ -995,6 +1375,16 @@ int ContinuousSyncer::applyLog(SimpleHttpResult* response,
     // update tick value
     WRITE_LOCKER_EVENTUAL(writeLocker, _applier->_statusLock);
 
+    if (_batchTrx != nullptr) {
+      // applied once the batch is committed
+      _batchTick = _applier->_state._lastProcessedContinuousTick;
+
+      if (skipped) {
+        ++_applier->_state._skippedOperations;
+      }
+      continue;
+    }
+
     if (_applier->_state._lastProcessedContinuousTick >
         _applier->_state._lastAppliedContinuousTick) {
       _applier->_state._lastAppliedContinuousTick =
@@ -1010,7 +1400,12 @@ int ContinuousSyncer::applyLog(SimpleHttpResult* response,
   }
 
   // reached the end
-  return TRI_ERROR_NO_ERROR;
+  int res = applyPendingDocuments(pending, pendingTick, ignoreCount, errorMsg);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+  return finishBatch(errorMsg);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -25,6 +25,7 @@
 #define ARANGOD_REPLICATION_CONTINUOUS_SYNCER_H 1
 
 #include "Basics/Common.h"
+#include "Replication/ApplyWorkerPool.h"
 #include "Replication/Syncer.h"
 #include "VocBase/replication-applier.h"
 
@@ -37,10 +38,12 @@ class SimpleHttpResult;
 }
 
 namespace velocypack {
+class Builder;
 class Slice;
 }
 
 class ReplicationTransaction;
+class SingleCollectionTransaction;
 
 enum RestrictType : uint32_t {
   RESTRICT_NONE,
@@ -133,6 +136,37 @@ class ContinuousSyncer : public Syncer {
   int processDocument(TRI_replication_operation_e, arangodb::velocypack::Slice const&,
                       std::string&);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief extracts the collection, the document and its key and revision
+  /// from a document marker
+  //////////////////////////////////////////////////////////////////////////////
+
+  int parseDocumentMarker(arangodb::velocypack::Slice const&, TRI_voc_cid_t&,
+                          bool&, arangodb::velocypack::Builder&,
+                          arangodb::velocypack::Slice&, std::string&);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief commit the batch of standalone document operations, and advance
+  /// the applied tick to its last operation
+  //////////////////////////////////////////////////////////////////////////////
+
+  int finishBatch(std::string&);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief a standalone document operation waiting to be applied
+  //////////////////////////////////////////////////////////////////////////////
+
+  struct PendingDocument;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief apply a run of standalone document operations, with the
+  /// collections involved being written to concurrently, and advance the
+  /// applied tick to the given tick
+  //////////////////////////////////////////////////////////////////////////////
+
+  int applyPendingDocuments(std::vector<PendingDocument>&, TRI_voc_tick_t,
+                            uint64_t&, std::string&);
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief renames a collection, based on the VelocyPack provided
   //////////////////////////////////////////////////////////////////////////////
@@ -146,6 +180,12 @@ class ContinuousSyncer : public Syncer {
 
   int changeCollection(arangodb::velocypack::Slice const&);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief truncates a collection, based on the VelocyPack provided
+  //////////////////////////////////////////////////////////////////////////////
+
+  int truncateCollection(arangodb::velocypack::Slice const&);
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief apply a single marker from the continuous log
   //////////////////////////////////////////////////////////////////////////////
@@ -253,10 +293,18 @@ class ContinuousSyncer : public Syncer {
   bool _hasWrittenState;
 
   //////////////////////////////////////////////////////////////////////////////
-  /// @brief whether we can use single operation transactions
+  /// @brief number of collections standalone document operations are applied
+  /// to concurrently
   //////////////////////////////////////////////////////////////////////////////
-  
-  bool _supportsSingleOperations;
+
+  size_t _applyParallelism;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief threads that apply standalone document operations together with
+  /// the syncer thread. they are started once for the lifetime of the syncer
+  //////////////////////////////////////////////////////////////////////////////
+
+  ApplyWorkerPool _applyWorkers;
 
   //////////////////////////////////////////////////////////////////////////////
   /// @brief which transactions were open and need to be treated specially
@@ -264,6 +312,27 @@ class ContinuousSyncer : public Syncer {
 
   std::unordered_map<TRI_voc_tid_t, ReplicationTransaction*>
       _ongoingTransactions;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief consecutive standalone document operations on the same collection
+  /// are applied in this transaction instead of one transaction each
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::unique_ptr<SingleCollectionTransaction> _batchTrx;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief collection, number of operations and last tick of the batch
+  //////////////////////////////////////////////////////////////////////////////
+
+  TRI_voc_cid_t _batchCid;
+  size_t _batchSize;
+  TRI_voc_tick_t _batchTick;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief maximum number of operations in a batch
+  //////////////////////////////////////////////////////////////////////////////
+
+  static size_t const MaxBatchSize;
 };
 }
 
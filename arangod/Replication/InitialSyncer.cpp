@@ -24,6 +24,7 @@
 #include "InitialSyncer.h"
 #include "ApplicationFeatures/ApplicationServer.h"
 #include "Basics/Exceptions.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/ReadLocker.h"
 #include "Basics/Result.h"
 #include "Basics/RocksDBUtils.h"
@@ -40,6 +41,7 @@
 #include "StorageEngine/PhysicalCollection.h"
 #include "StorageEngine/StorageEngine.h"
 #include "Transaction/Helpers.h"
+#include "Transaction/Hints.h"
 #include "Utils/CollectionGuard.h"
 #include "Utils/OperationOptions.h"
 #include "VocBase/LogicalCollection.h"
@@ -51,7 +53,9 @@
 #include <velocypack/Iterator.h>
 #include <velocypack/Slice.h>
 #include <velocypack/velocypack-aliases.h>
+#include <atomic>
 #include <cstring>
+#include <thread>
 
 using namespace arangodb;
 using namespace arangodb::basics;
@@ -940,6 +944,7 @@ int InitialSyncer::handleCollectionSync(arangodb::LogicalCollection* col,
     SingleCollectionTransaction trx(
         transaction::StandaloneContext::Create(_vocbase), col->cid(),
         AccessMode::Type::EXCLUSIVE);
+    trx.addHint(transaction::Hints::Hint::ALLOW_RANGE_DELETE);
 
     Result res = trx.begin();
 
@@ -1101,6 +1106,7 @@ int InitialSyncer::handleCollection(VPackSlice const& parameters,
           SingleCollectionTransaction trx(
               transaction::StandaloneContext::Create(_vocbase), col->cid(),
               AccessMode::Type::EXCLUSIVE);
+          trx.addHint(transaction::Hints::Hint::ALLOW_RANGE_DELETE);
 
           Result res = trx.begin();
 
@@ -1402,6 +1408,14 @@ int InitialSyncer::iterateCollections(
                        std::to_string(collections.size()) + " collections");
   setProgress(phaseMsg);
 
+  size_t parallelism = static_cast<size_t>(
+      (std::min)(_configuration._initialSyncParallelism,
+                 static_cast<uint64_t>(collections.size())));
+  if (phase == PHASE_DUMP && parallelism > 1) {
+    return dumpCollectionsParallel(collections, incremental, errorMsg,
+                                   parallelism);
+  }
+
   for (auto const& collection : collections) {
     VPackSlice const parameters = collection.first;
     VPackSlice const indexes = collection.second;
@@ -1418,3 +1432,89 @@ int InitialSyncer::iterateCollections(
   // all ok
   return TRI_ERROR_NO_ERROR;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief dump the data of multiple collections concurrently
+////////////////////////////////////////////////////////////////////////////////
+
+int InitialSyncer::dumpCollectionsParallel(
+    std::vector<std::pair<VPackSlice, VPackSlice>> const& collections,
+    bool incremental, std::string& errorMsg, size_t parallelism) {
+  // a SimpleHttpClient must not be shared between threads, so every thread
+  // gets a syncer with its own connection
+  std::vector<std::unique_ptr<InitialSyncer>> syncers;
+  for (size_t i = 0; i < parallelism; ++i) {
+    auto syncer = std::make_unique<InitialSyncer>(
+        _vocbase, &_configuration, _restrictCollections, _restrictType,
+        _verbose, _skipCreateDrop);
+    if (syncer->_client == nullptr) {
+      errorMsg = "could not connect to master";
+      return TRI_ERROR_INTERNAL;
+    }
+    syncer->_masterInfo = _masterInfo;
+    syncer->_leaderId = _leaderId;
+    syncer->_batchId = _batchId;
+    syncer->_batchUpdateTime = _batchUpdateTime;
+    syncer->_barrierId = _barrierId;
+    syncer->_barrierUpdateTime = _barrierUpdateTime;
+    syncer->_hasFlushed = true;
+    syncers.emplace_back(std::move(syncer));
+  }
+
+  // collections are handed out one at a time, so a few large collections
+  // do not keep all others waiting
+  std::atomic<size_t> next(0);
+  std::atomic<bool> failed(false);
+  Mutex resultMutex;
+  int result = TRI_ERROR_NO_ERROR;
+
+  std::vector<std::thread> threads;
+  threads.reserve(parallelism);
+  for (size_t i = 0; i < parallelism; ++i) {
+    InitialSyncer* syncer = syncers[i].get();
+    threads.emplace_back([&, syncer]() {
+      while (!failed.load()) {
+        size_t current = next++;
+        if (current >= collections.size()) {
+          break;
+        }
+
+        std::string msg;
+        int res;
+        try {
+          res = syncer->handleCollection(collections[current].first,
+                                         collections[current].second,
+                                         incremental, msg, PHASE_DUMP);
+        } catch (basics::Exception const& ex) {
+          res = ex.code();
+          msg = ex.what();
+        } catch (std::exception const& ex) {
+          res = TRI_ERROR_INTERNAL;
+          msg = ex.what();
+        }
+
+        if (res != TRI_ERROR_NO_ERROR) {
+          failed = true;
+          MUTEX_LOCKER(locker, resultMutex);
+          if (result == TRI_ERROR_NO_ERROR) {
+            result = res;
+            errorMsg = msg;
+          }
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (auto& syncer : syncers) {
+    // the batch and the barrier belong to this syncer, they must not be
+    // removed when the helpers are destroyed
+    syncer->_batchId = 0;
+    syncer->_barrierId = 0;
+  }
+
+  return result;
+}
@@ -254,6 +254,16 @@ class InitialSyncer : public Syncer {
                             arangodb::velocypack::Slice>> const&,
       bool, std::string&, sync_phase_e);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief dump the data of multiple collections concurrently, every thread
+  /// uses its own connection but shares the batch and barrier of this syncer
+  //////////////////////////////////////////////////////////////////////////////
+
+  int dumpCollectionsParallel(
+      std::vector<std::pair<arangodb::velocypack::Slice,
+                            arangodb::velocypack::Slice>> const&,
+      bool, std::string&, size_t);
+
   std::unordered_map<std::string, std::string> createHeaders() {
     return { {StaticStrings::ClusterCommSource, ServerState::instance()->getId()} };
   }
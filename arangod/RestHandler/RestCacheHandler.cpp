@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RestCacheHandler.h"
+#include "Cache/Cache.h"
+#include "Cache/CacheManagerFeature.h"
+#include "Cache/Common.h"
+#include "Cache/Manager.h"
+#include "Rest/HttpRequest.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/velocypack-aliases.h>
+
+#include <cmath>
+
+using namespace arangodb;
+using namespace arangodb::basics;
+using namespace arangodb::rest;
+
+namespace {
+/// @brief adds a hit rate, using null if it is not known
+void addRate(VPackBuilder& builder, char const* key, double rate) {
+  if (std::isnan(rate)) {
+    builder.add(key, VPackValue(VPackValueType::Null));
+  } else {
+    builder.add(key, VPackValue(rate));
+  }
+}
+}
+
+RestCacheHandler::RestCacheHandler(GeneralRequest* request,
+                                   GeneralResponse* response)
+    : RestBaseHandler(request, response) {}
+
+RestStatus RestCacheHandler::execute() {
+  auto const type = _request->requestType();
+
+  if (type != rest::RequestType::GET) {
+    generateError(rest::ResponseCode::METHOD_NOT_ALLOWED,
+                  TRI_ERROR_HTTP_METHOD_NOT_ALLOWED);
+    return RestStatus::DONE;
+  }
+
+  if (!_request->suffixes().empty()) {
+    generateError(rest::ResponseCode::BAD, TRI_ERROR_BAD_PARAMETER,
+                  "expecting GET /_admin/cache");
+    return RestStatus::DONE;
+  }
+
+  getStatistics();
+  return RestStatus::DONE;
+}
+
+void RestCacheHandler::getStatistics() {
+  cache::Manager* manager = CacheManagerFeature::MANAGER;
+
+  if (manager == nullptr) {
+    generateError(rest::ResponseCode::SERVICE_UNAVAILABLE,
+                  TRI_ERROR_SHUTTING_DOWN);
+    return;
+  }
+
+  auto rates = manager->globalHitRates();
+
+  VPackBuilder result;
+  result.openObject();
+  result.add("limit", VPackValue(manager->globalLimit()));
+  result.add("allocated", VPackValue(manager->globalAllocation()));
+  addRate(result, "hitRateLifetime", rates.first);
+  addRate(result, "hitRateRecent", rates.second);
+
+  result.add("caches", VPackValue(VPackValueType::Array));
+  for (auto const& stats : manager->cacheStatistics()) {
+    result.openObject();
+    result.add("name", VPackValue(stats.name));
+    result.add("type", VPackValue(stats.type == cache::CacheType::Plain
+                                      ? "plain"
+                                      : "transactional"));
+    result.add("usage", VPackValue(stats.usage));
+    result.add("usageLimit", VPackValue(stats.usageLimit));
+    result.add("allocated", VPackValue(stats.allocatedSize));
+    result.add("deserved", VPackValue(stats.deservedSize));
+    result.add("maxSize", VPackValue(stats.maxSize));
+    result.add("tableSize", VPackValue(stats.tableSize));
+    result.add("logSize", VPackValue(stats.logSize));
+    result.add("hits", VPackValue(stats.findHits));
+    result.add("misses", VPackValue(stats.findMisses));
+    result.add("inserts", VPackValue(stats.inserts));
+    result.add("evictions", VPackValue(stats.evictions));
+    result.add("rejections", VPackValue(stats.rejections));
+    result.add("migrations", VPackValue(stats.migrations));
+    result.add("compressedUsage", VPackValue(stats.compressedUsage));
+    result.add("compressedLimit", VPackValue(stats.compressedLimit));
+    result.add("compressedPromotions", VPackValue(stats.compressedPromotions));
+    addRate(result, "hitRateLifetime", stats.lifetimeHitRate);
+    addRate(result, "hitRateRecent", stats.windowedHitRate);
+    result.add("hitRateHistory", VPackValue(VPackValueType::Array));
+    for (double rate : stats.hitRateHistory) {
+      if (std::isnan(rate)) {
+        result.add(VPackValue(VPackValueType::Null));
+      } else {
+        result.add(VPackValue(rate));
+      }
+    }
+    result.close();
+    result.close();
+  }
+  result.close();
+
+  result.add("rebalancing", VPackValue(VPackValueType::Array));
+  for (auto const& record : manager->rebalanceHistory()) {
+    result.openObject();
+    result.add("time", VPackValue(record.timestamp));
+    result.add("caches", VPackValue(record.caches));
+    result.add("adjusted", VPackValue(record.adjusted));
+    result.add("shrunk", VPackValue(record.shrunk));
+    result.add("allocated", VPackValue(record.globalAllocation));
+    result.close();
+  }
+  result.close();
+  result.close();
+
+  generateResult(rest::ResponseCode::OK, result.slice());
+}
@@ -27,7 +27,9 @@
 #include "Basics/Exceptions.h"
 #include "Basics/MutexLocker.h"
 #include "Basics/StaticStrings.h"
+#include "Basics/StringUtils.h"
 #include "Basics/VelocyPackHelper.h"
+#include "Cluster/ServerState.h"
 #include "Utils/Cursor.h"
 #include "Utils/CursorRepository.h"
 #include "Transaction/Context.h"
@@ -53,6 +55,9 @@ RestStatus RestCursorHandler::execute() {
   // extract the sub-request type
   auto const type = _request->requestType();
 
+  // result batches can be big. let the transport compress them
+  _response->setAllowCompression(true);
+
   if (type == rest::RequestType::POST) {
     createCursor();
     return RestStatus::DONE;
@@ -83,13 +88,63 @@ bool RestCursorHandler::cancel() {
 /// this method is also used by derived classes
 ////////////////////////////////////////////////////////////////////////////////
 
-void RestCursorHandler::processQuery(VPackSlice const& slice) {
-  if (!slice.isObject()) {
+constexpr size_t RestCursorHandler::MaxOptimisticAttempts;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief how often a query is run before an error is reported
+////////////////////////////////////////////////////////////////////////////////
+
+size_t RestCursorHandler::maxQueryAttempts(VPackSlice const& options,
+                                           bool isCoordinator) {
+  // an optimistic query does not wait for locks of other transactions and
+  // is aborted on a write-write conflict instead. it is then run again, as
+  // an optimistic transaction never commits intermediately, so nothing of
+  // the aborted attempt has been committed. this does not hold on a
+  // coordinator, where the parts of the query on other DB servers may
+  // have been committed already
+  if (isCoordinator ||
+      !arangodb::basics::VelocyPackHelper::getBooleanValue(
+          options, "optimistic", false)) {
+    return 1;
+  }
+  return MaxOptimisticAttempts;
+}
+
+void RestCursorHandler::processQuery(VPackSlice const& body) {
+  if (!body.isObject()) {
     generateError(rest::ResponseCode::BAD, TRI_ERROR_QUERY_EMPTY);
     return;
   }
-  VPackSlice const querySlice = slice.get("query");
-  if (!querySlice.isString()) {
+
+  // a prepared statement provides the query string and the default options,
+  // the request only needs to carry the bind parameters
+  VPackSlice slice = body;
+  std::shared_ptr<arangodb::aql::PreparedQuery const> prepared;
+  VPackBuilder merged;
+  VPackSlice const preparedSlice = body.get("prepared");
+  if (!preparedSlice.isNone()) {
+    if (!preparedSlice.isString()) {
+      generateError(rest::ResponseCode::BAD, TRI_ERROR_TYPE_ERROR,
+                    "expecting string for <prepared>");
+      return;
+    }
+    prepared = _queryRegistry->lookupPrepared(
+        _vocbase,
+        arangodb::basics::StringUtils::uint64(preparedSlice.copyString()));
+    if (prepared == nullptr) {
+      generateError(rest::ResponseCode::NOT_FOUND, TRI_ERROR_QUERY_NOT_FOUND,
+                    "prepared query not found");
+      return;
+    }
+    merged = arangodb::basics::VelocyPackHelper::merge(
+        prepared->options->slice(), body, false, true);
+    slice = merged.slice();
+  }
+
+  VPackSlice querySlice = slice.get("query");
+  if (prepared != nullptr) {
+    querySlice = VPackSlice::noneSlice();
+  } else if (!querySlice.isString()) {
     generateError(rest::ResponseCode::BAD, TRI_ERROR_QUERY_EMPTY);
     return;
   }
@@ -110,16 +165,53 @@ void RestCursorHandler::processQuery(VPackSlice const& slice) {
   }
 
   auto options = std::make_shared<VPackBuilder>(buildOptions(slice));
+
+  if (arangodb::basics::VelocyPackHelper::getBooleanValue(
+          options->slice(), "stream", false)) {
+    if (prepared != nullptr) {
+      processStreamQuery(prepared->queryString, bindVarsBuilder, options,
+                         prepared->plans);
+    } else {
+      processStreamQuery(querySlice.copyString(), bindVarsBuilder, options,
+                         nullptr);
+    }
+    return;
+  }
+
   VPackValueLength l;
-  char const* queryString = querySlice.getString(l);
+  char const* queryString;
+  if (prepared != nullptr) {
+    queryString = prepared->queryString.data();
+    l = prepared->queryString.size();
+  } else {
+    queryString = querySlice.getString(l);
+  }
+
+  size_t const maxAttempts = maxQueryAttempts(
+      options->slice(), ServerState::instance()->isCoordinator());
+
+  auto execute = [&]() -> arangodb::aql::QueryResult {
+    for (size_t attempt = 1; true; ++attempt) {
+      arangodb::aql::Query query(
+          false, _vocbase,
+          arangodb::aql::QueryString(queryString, static_cast<size_t>(l)),
+          bindVarsBuilder, options, arangodb::aql::PART_MAIN);
+      if (prepared != nullptr) {
+        query.setPlanCache(prepared->plans);
+      }
 
-  arangodb::aql::Query query(false, _vocbase, arangodb::aql::QueryString(queryString, static_cast<size_t>(l)),
-                             bindVarsBuilder, options,
-                             arangodb::aql::PART_MAIN);
+      registerQuery(&query);
+      auto queryResult = query.execute(_queryRegistry);
+      unregisterQuery();
 
-  registerQuery(&query);
-  auto queryResult = query.execute(_queryRegistry);
-  unregisterQuery();
+      if (queryResult.code != TRI_ERROR_ARANGO_CONFLICT ||
+          attempt >= maxAttempts || wasCanceled()) {
+        return queryResult;
+      }
+    }
+  };
+
+  auto queryResult = execute();
 
   if (queryResult.code != TRI_ERROR_NO_ERROR) {
     if (queryResult.code == TRI_ERROR_REQUEST_CANCELED ||
@@ -223,7 +315,7 @@ void RestCursorHandler::processQuery(VPackSlice const& slice) {
 
       _response->setContentType(rest::ContentType::JSON);
       generateResult(_response->responseCode(), result.slice(),
-                     static_cast<VelocyPackCursor*>(cursor)->result()->context);
+                     cursor->context());
 
       cursors->release(cursor);
     } catch (...) {
@@ -233,6 +325,54 @@ void RestCursorHandler::processQuery(VPackSlice const& slice) {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief processes the query and returns the first batch of a streaming
+/// cursor. the results are not materialized, but fetched from the query
+/// batch by batch
+////////////////////////////////////////////////////////////////////////////////
+
+void RestCursorHandler::processStreamQuery(
+    std::string const& queryString,
+    std::shared_ptr<VPackBuilder> bindVarsBuilder,
+    std::shared_ptr<VPackBuilder> options,
+    std::shared_ptr<arangodb::aql::PlanCache> planCache) {
+  VPackSlice opts = options->slice();
+
+  size_t batchSize =
+      arangodb::basics::VelocyPackHelper::getNumericValue<size_t>(
+          opts, "batchSize", 1000);
+  double ttl = arangodb::basics::VelocyPackHelper::getNumericValue<double>(
+      opts, "ttl", 30);
+
+  auto cursors = _vocbase->cursorRepository();
+  TRI_ASSERT(cursors != nullptr);
+
+  // creating the cursor will prepare the query and throw if that fails
+  Cursor* cursor = cursors->createQueryStream(
+      queryString, bindVarsBuilder, options, batchSize, ttl, _queryRegistry,
+      std::move(planCache));
+
+  try {
+    resetResponse(rest::ResponseCode::CREATED);
+
+    VPackBuilder result;
+    result.openObject();
+    result.add("error", VPackValue(false));
+    result.add("code", VPackValue(static_cast<int>(_response->responseCode())));
+    cursor->dump(result);
+    result.close();
+
+    _response->setContentType(rest::ContentType::JSON);
+    generateResult(_response->responseCode(), result.slice(),
+                   cursor->context());
+
+    cursors->release(cursor);
+  } catch (...) {
+    cursors->release(cursor);
+    throw;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief register the currently running query
 ////////////////////////////////////////////////////////////////////////////////
@@ -377,6 +517,10 @@ std::shared_ptr<VPackBuilder> RestCursorHandler::buildExtra(
       extra->add(queryResult.profile->slice());
       queryResult.profile = nullptr;
     }
+    if (queryResult.plan != nullptr) {
+      extra->add("plan", queryResult.plan->slice());
+      queryResult.plan = nullptr;
+    }
     if (queryResult.warnings == nullptr) {
       extra->add("warnings", VPackValue(VPackValueType::Array));
       extra->close();
@@ -469,7 +613,7 @@ void RestCursorHandler::modifyCursor() {
 
     _response->setContentType(rest::ContentType::JSON);
     generateResult(rest::ResponseCode::OK, builder.slice(),
-                     static_cast<VelocyPackCursor*>(cursor)->result()->context);
+                   cursor->context());
 
     cursors->release(cursor);
   } catch (...) {
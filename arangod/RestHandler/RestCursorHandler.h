@@ -39,6 +39,7 @@ class Builder;
 class Slice;
 }
 namespace aql {
+class PlanCache;
 class Query;
 class QueryRegistry;
 }
@@ -73,6 +74,16 @@ class RestCursorHandler : public RestVocbaseBaseHandler {
   void processQuery(arangodb::velocypack::Slice const&);
 
  private:
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief processes the query and returns the first batch of a streaming
+  /// cursor. the plan cache is the one of a prepared statement, or nullptr
+  //////////////////////////////////////////////////////////////////////////////
+
+  void processStreamQuery(std::string const&,
+                          std::shared_ptr<arangodb::velocypack::Builder>,
+                          std::shared_ptr<arangodb::velocypack::Builder>,
+                          std::shared_ptr<arangodb::aql::PlanCache>);
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief register the currently running query
   //////////////////////////////////////////////////////////////////////////////
@@ -137,6 +148,23 @@ class RestCursorHandler : public RestVocbaseBaseHandler {
 
   void deleteCursor();
 
+ public:
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief how often an optimistic query is run before a conflict is
+  /// reported to the client
+  //////////////////////////////////////////////////////////////////////////////
+
+  static constexpr size_t MaxOptimisticAttempts = 3;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief how often a query with the given options is run before a
+  /// conflict is reported to the client. queries are only retried on
+  /// single servers and DB servers
+  //////////////////////////////////////////////////////////////////////////////
+
+  static size_t maxQueryAttempts(arangodb::velocypack::Slice const& options,
+                                 bool isCoordinator);
+
  private:
   //////////////////////////////////////////////////////////////////////////////
   /// @brief our query registry
@@ -214,6 +214,7 @@ bool RestDocumentHandler::readSingleDocument(bool generateBody) {
 
   OperationOptions options;
   options.ignoreRevs = true;
+  options.maxStaleness = extractMaxStaleness();
 
   TRI_voc_rid_t ifRid = extractRevision("if-match", isValidRevision);
   if (!isValidRevision) {
@@ -284,6 +285,21 @@ bool RestDocumentHandler::readSingleDocument(bool generateBody) {
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extracts the "maxStaleness" parameter, which is given in
+/// milliseconds. in a cluster, in-sync followers may answer reads that
+/// accept some staleness
+////////////////////////////////////////////////////////////////////////////////
+
+double RestDocumentHandler::extractMaxStaleness() const {
+  bool found;
+  std::string const& value = _request->value("maxStaleness", found);
+  if (!found) {
+    return 0.0;
+  }
+  return (std::max)(0.0, StringUtils::doubleDecimal(value) / 1000.0);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief was docuBlock REST_DOCUMENT_READ_HEAD
 ////////////////////////////////////////////////////////////////////////////////
@@ -610,6 +626,7 @@ bool RestDocumentHandler::readManyDocuments() {
   OperationOptions opOptions;
   opOptions.ignoreRevs =
       extractBooleanParameter(StaticStrings::IgnoreRevsString, true);
+  opOptions.maxStaleness = extractMaxStaleness();
 
   auto transactionContext(transaction::StandaloneContext::Create(_vocbase));
   SingleCollectionTransaction trx(transactionContext, collectionName,
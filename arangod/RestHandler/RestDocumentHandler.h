@@ -71,6 +71,9 @@ class RestDocumentHandler : public RestVocbaseBaseHandler {
 
   // deletes a document
   bool deleteDocument();
+
+  // the staleness a read accepts, in seconds
+  double extractMaxStaleness() const;
 };
 }
 
@@ -358,9 +358,16 @@ bool RestImportHandler::createFromJson(std::string const& type) {
   }
 
   // find and load collection given by name or identifier
+  bool const bulkLoad = extractBooleanParameter("bulkLoad", false);
+  // a bulk load needs the collection for itself
   SingleCollectionTransaction trx(
       transaction::StandaloneContext::Create(_vocbase), collectionName,
-      AccessMode::Type::WRITE);
+      bulkLoad ? AccessMode::Type::EXCLUSIVE : AccessMode::Type::WRITE);
+
+  if (bulkLoad) {
+    // let the storage engine bypass its regular write path if it can
+    trx.addHint(transaction::Hints::Hint::BULK_LOAD);
+  }
 
   // .............................................................................
   // inside write transaction
@@ -564,9 +571,16 @@ bool RestImportHandler::createFromVPack(std::string const& type) {
   }
 
   // find and load collection given by name or identifier
+  bool const bulkLoad = extractBooleanParameter("bulkLoad", false);
+  // a bulk load needs the collection for itself
   SingleCollectionTransaction trx(
       transaction::StandaloneContext::Create(_vocbase), collectionName,
-      AccessMode::Type::WRITE);
+      bulkLoad ? AccessMode::Type::EXCLUSIVE : AccessMode::Type::WRITE);
+
+  if (bulkLoad) {
+    // let the storage engine bypass its regular write path if it can
+    trx.addHint(transaction::Hints::Hint::BULK_LOAD);
+  }
 
   // .............................................................................
   // inside write transaction
@@ -745,9 +759,16 @@ bool RestImportHandler::createFromKeyValueList() {
   current = next + 1;
 
   // find and load collection given by name or identifier
+  bool const bulkLoad = extractBooleanParameter("bulkLoad", false);
+  // a bulk load needs the collection for itself
   SingleCollectionTransaction trx(
       transaction::StandaloneContext::Create(_vocbase), collectionName,
-      AccessMode::Type::WRITE);
+      bulkLoad ? AccessMode::Type::EXCLUSIVE : AccessMode::Type::WRITE);
+
+  if (bulkLoad) {
+    // let the storage engine bypass its regular write path if it can
+    trx.addHint(transaction::Hints::Hint::BULK_LOAD);
+  }
 
   // .............................................................................
   // inside write transaction
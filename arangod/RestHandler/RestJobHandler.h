@@ -46,6 +46,7 @@ class RestJobHandler : public RestBaseHandler {
   char const* name() const override final { return "RestJobHandler"; }
 
   bool isDirect() const override;
+  size_t queue() const override { return JobQueue::FAST_QUEUE; }
 
   //////////////////////////////////////////////////////////////////////////////
   /// @brief executes the handler
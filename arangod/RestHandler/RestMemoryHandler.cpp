@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+
+#include "RestMemoryHandler.h"
+#include "Basics/FileUtils.h"
+#include "Basics/MemoryArenas.h"
+#include "Basics/StringBuffer.h"
+#include "Basics/files.h"
+#include "Rest/HttpResponse.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+using namespace arangodb::basics;
+using namespace arangodb::rest;
+
+RestMemoryHandler::RestMemoryHandler(GeneralRequest* request,
+                                     GeneralResponse* response)
+    : RestBaseHandler(request, response) {}
+
+RestStatus RestMemoryHandler::execute() {
+  if (_request->requestType() != rest::RequestType::GET) {
+    generateError(rest::ResponseCode::METHOD_NOT_ALLOWED,
+                  TRI_ERROR_HTTP_METHOD_NOT_ALLOWED);
+    return RestStatus::DONE;
+  }
+
+  std::vector<std::string> const& suffixes = _request->suffixes();
+
+  if (suffixes.size() == 1 && suffixes[0] == "profile") {
+    heapProfile();
+    return RestStatus::DONE;
+  }
+
+  if (!suffixes.empty()) {
+    generateError(rest::ResponseCode::NOT_FOUND, TRI_ERROR_HTTP_NOT_FOUND);
+    return RestStatus::DONE;
+  }
+
+  VPackBuilder builder;
+  builder.openObject();
+  MemoryArenas::toVelocyPack(builder);
+  builder.close();
+  generateResult(rest::ResponseCode::OK, builder.slice());
+  return RestStatus::DONE;
+}
+
+/// @brief has jemalloc write a heap profile to a temporary file and returns
+/// its contents, for jeprof
+void RestMemoryHandler::heapProfile() {
+  auto response = dynamic_cast<HttpResponse*>(_response.get());
+
+  if (response == nullptr) {
+    generateError(rest::ResponseCode::BAD, TRI_ERROR_BAD_PARAMETER,
+                  "heap profiles are only available via HTTP");
+    return;
+  }
+
+  std::string filename;
+  {
+    char* name = nullptr;
+    std::string errorMessage;
+    long systemError;
+
+    if (TRI_GetTempName("heap", &name, false, systemError, errorMessage) !=
+        TRI_ERROR_NO_ERROR) {
+      generateError(rest::ResponseCode::SERVER_ERROR, TRI_ERROR_INTERNAL,
+                    "could not generate temp file: " + errorMessage);
+      return;
+    }
+
+    if (name == nullptr) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+
+    filename.append(name);
+    TRI_Free(TRI_CORE_MEM_ZONE, name);
+  }
+
+  Result res = MemoryArenas::dumpHeapProfile(filename);
+
+  if (res.fail()) {
+    generateError(res.is(TRI_ERROR_NOT_IMPLEMENTED)
+                      ? rest::ResponseCode::NOT_IMPLEMENTED
+                      : rest::ResponseCode::SERVER_ERROR,
+                  res.errorNumber(), res.errorMessage());
+    return;
+  }
+
+  resetResponse(rest::ResponseCode::OK);
+  response->setContentType(rest::ContentType::TEXT);
+  try {
+    FileUtils::slurp(filename, response->body());
+  } catch (...) {
+    FileUtils::remove(filename);
+    throw;
+  }
+  FileUtils::remove(filename);
+}
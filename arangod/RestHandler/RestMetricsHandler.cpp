@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RestMetricsHandler.h"
+#include "Basics/StringBuffer.h"
+#include "Rest/HttpResponse.h"
+#include "Statistics/RequestStatistics.h"
+#include "Statistics/StatisticsFeature.h"
+
+using namespace arangodb;
+using namespace arangodb::basics;
+using namespace arangodb::rest;
+
+namespace {
+/// @brief appends a label value, escaped as required by the text format
+void appendLabel(StringBuffer& buffer, std::string const& value) {
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      buffer.appendChar('\\');
+      buffer.appendChar(c);
+    } else if (c == '\n') {
+      buffer.appendText("\\n");
+    } else {
+      buffer.appendChar(c);
+    }
+  }
+}
+
+/// @brief appends one summary with the quantiles of all routes
+void appendSummary(
+    StringBuffer& buffer, char const* name, char const* help,
+    std::map<std::string, RequestStatistics::RouteFigures> const& routes,
+    StatisticsHistogram RequestStatistics::RouteFigures::*histogram) {
+  static double const QUANTILES[] = {0.5, 0.99, 0.999};
+
+  buffer.appendText("# HELP ").appendText(name).appendChar(' ');
+  buffer.appendText(help).appendChar('\n');
+  buffer.appendText("# TYPE ").appendText(name).appendText(" summary\n");
+
+  for (auto const& it : routes) {
+    StatisticsHistogram const& h = it.second.*histogram;
+
+    for (double q : QUANTILES) {
+      buffer.appendText(name).appendText("{route=\"");
+      appendLabel(buffer, it.first);
+      buffer.appendText("\",quantile=\"").appendDecimal(q);
+      buffer.appendText("\"} ").appendDecimal(h.percentile(q));
+      buffer.appendChar('\n');
+    }
+
+    buffer.appendText(name).appendText("_sum{route=\"");
+    appendLabel(buffer, it.first);
+    buffer.appendText("\"} ").appendDecimal(h._total).appendChar('\n');
+
+    buffer.appendText(name).appendText("_count{route=\"");
+    appendLabel(buffer, it.first);
+    buffer.appendText("\"} ").appendInteger(h._count).appendChar('\n');
+  }
+}
+}
+
+RestMetricsHandler::RestMetricsHandler(GeneralRequest* request,
+                                       GeneralResponse* response)
+    : RestBaseHandler(request, response) {}
+
+RestStatus RestMetricsHandler::execute() {
+  if (_request->requestType() != rest::RequestType::GET) {
+    generateError(rest::ResponseCode::METHOD_NOT_ALLOWED,
+                  TRI_ERROR_HTTP_METHOD_NOT_ALLOWED);
+    return RestStatus::DONE;
+  }
+
+  if (!StatisticsFeature::enabled()) {
+    generateError(rest::ResponseCode::NOT_FOUND, TRI_ERROR_HTTP_NOT_FOUND,
+                  "statistics are disabled");
+    return RestStatus::DONE;
+  }
+
+  auto response = dynamic_cast<HttpResponse*>(_response.get());
+
+  if (response == nullptr) {
+    generateError(rest::ResponseCode::BAD, TRI_ERROR_BAD_PARAMETER,
+                  "metrics are only available via HTTP");
+    return RestStatus::DONE;
+  }
+
+  std::map<std::string, RequestStatistics::RouteFigures> routes;
+  RequestStatistics::fillRoutes(routes);
+
+  resetResponse(rest::ResponseCode::OK);
+  response->setContentType(rest::ContentType::TEXT);
+
+  auto& buffer = response->body();
+  appendSummary(buffer, "arangodb_request_total_time_seconds",
+                "time between reading the request and sending the response",
+                routes, &RequestStatistics::RouteFigures::_totalTime);
+  appendSummary(buffer, "arangodb_request_handler_time_seconds",
+                "time spent executing the request handler", routes,
+                &RequestStatistics::RouteFigures::_requestTime);
+
+  return RestStatus::DONE;
+}
@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_REST_HANDLER_REST_METRICS_HANDLER_H
+#define ARANGOD_REST_HANDLER_REST_METRICS_HANDLER_H 1
+
+#include "RestHandler/RestBaseHandler.h"
+
+namespace arangodb {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reports the request latencies per route in the Prometheus text
+/// format via GET /_admin/metrics
+////////////////////////////////////////////////////////////////////////////////
+
+class RestMetricsHandler : public arangodb::RestBaseHandler {
+ public:
+  RestMetricsHandler(GeneralRequest*, GeneralResponse*);
+
+ public:
+  char const* name() const override final { return "RestMetricsHandler"; }
+  bool isDirect() const override { return true; }
+  RestStatus execute() override;
+};
+}
+
+#endif
@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+
+#include "RestProfilerHandler.h"
+#include "Basics/StringBuffer.h"
+#include "Rest/HttpResponse.h"
+#include "RestServer/ProfilerFeature.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+using namespace arangodb::basics;
+using namespace arangodb::rest;
+
+RestProfilerHandler::RestProfilerHandler(GeneralRequest* request,
+                                         GeneralResponse* response)
+    : RestBaseHandler(request, response) {}
+
+RestStatus RestProfilerHandler::execute() {
+  auto const type = _request->requestType();
+  if (type != rest::RequestType::GET && type != rest::RequestType::DELETE_REQ) {
+    generateError(rest::ResponseCode::METHOD_NOT_ALLOWED,
+                  TRI_ERROR_HTTP_METHOD_NOT_ALLOWED);
+    return RestStatus::DONE;
+  }
+
+  ProfilerFeature* profiler = ProfilerFeature::PROFILER;
+  if (profiler == nullptr || !profiler->isEnabled()) {
+    generateError(rest::ResponseCode::NOT_FOUND, TRI_ERROR_HTTP_NOT_FOUND,
+                  "profiler is disabled");
+    return RestStatus::DONE;
+  }
+
+  if (type == rest::RequestType::DELETE_REQ) {
+    profiler->reset();
+    VPackBuilder builder;
+    builder.openObject();
+    builder.add("error", VPackValue(false));
+    builder.add("code", VPackValue(static_cast<int>(rest::ResponseCode::OK)));
+    builder.close();
+    generateResult(rest::ResponseCode::OK, builder.slice());
+    return RestStatus::DONE;
+  }
+
+  auto response = dynamic_cast<HttpResponse*>(_response.get());
+
+  if (response == nullptr) {
+    generateError(rest::ResponseCode::BAD, TRI_ERROR_BAD_PARAMETER,
+                  "the profiler is only available via HTTP");
+    return RestStatus::DONE;
+  }
+
+  bool found;
+  std::string const& reset = _request->value("reset", found);
+
+  std::string stacks;
+  profiler->foldedStacks(stacks, found && reset == "true");
+
+  resetResponse(rest::ResponseCode::OK);
+  response->setContentType(rest::ContentType::TEXT);
+  response->body().appendText(stacks);
+
+  return RestStatus::DONE;
+}
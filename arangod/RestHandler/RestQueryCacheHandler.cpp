@@ -135,5 +135,11 @@ bool RestQueryCacheHandler::replaceProperties() {
 
   queryCache->setProperties(cacheProperties);
 
+  attribute = body.get("maxStaleness");
+
+  if (attribute.isNumber()) {
+    queryCache->setMaxStaleness(attribute.getNumber<uint64_t>());
+  }
+
   return readProperties();
 }
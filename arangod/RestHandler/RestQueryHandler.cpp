@@ -25,6 +25,7 @@
 
 #include "Aql/Query.h"
 #include "Aql/QueryList.h"
+#include "Aql/QueryRegistry.h"
 #include "Basics/conversions.h"
 #include "Basics/StringBuffer.h"
 #include "Basics/StringUtils.h"
@@ -35,8 +36,11 @@
 #include "Cluster/ClusterMethods.h"
 #include "Cluster/ServerState.h"
 #include "Rest/HttpRequest.h"
+#include "RestServer/QueryRegistryFeature.h"
 #include "VocBase/vocbase.h"
 
+#include <velocypack/Iterator.h>
+
 using namespace arangodb;
 using namespace arangodb::aql;
 using namespace arangodb::basics;
@@ -57,7 +61,12 @@ RestStatus RestQueryHandler::execute() {
   // execute one of the CRUD methods
   switch (type) {
     case rest::RequestType::DELETE_REQ:
-      deleteQuery();
+      if (!_request->suffixes().empty() &&
+          _request->suffixes()[0] == "prepare") {
+        deletePrepared();
+      } else {
+        deleteQuery();
+      }
       break;
     case rest::RequestType::GET:
       readQuery();
@@ -66,7 +75,12 @@ RestStatus RestQueryHandler::execute() {
       replaceProperties();
       break;
     case rest::RequestType::POST:
-      parseQuery();
+      if (!_request->suffixes().empty() &&
+          _request->suffixes()[0] == "prepare") {
+        prepareQuery();
+      } else {
+        parseQuery();
+      }
       break;
     default:
       generateNotImplemented("ILLEGAL " + DOCUMENT_PATH);
@@ -120,6 +134,10 @@ bool RestQueryHandler::readQuery(bool slow) {
     result.add("started", VPackValue(timeString));
     result.add("runTime", VPackValue(q.runTime));
     result.add("state", VPackValue(QueryExecutionState::toString(q.state)));
+    q.usage.toVelocyPack(result);
+    if (q.snippets != nullptr) {
+      result.add("snippets", q.snippets->slice());
+    }
     result.close();
   }
   result.close();
@@ -357,3 +375,127 @@ bool RestQueryHandler::parseQuery() {
   generateResult(rest::ResponseCode::OK, result.slice());
   return true;
 }
+
+/// @brief time to live of a prepared statement in seconds if not specified
+static constexpr double DefaultPreparedTtl = 600.0;
+
+bool RestQueryHandler::prepareQuery() {
+  auto const& suffixes = _request->suffixes();
+
+  if (suffixes.size() != 1) {
+    generateError(rest::ResponseCode::BAD, TRI_ERROR_HTTP_BAD_PARAMETER,
+                  "expecting POST /_api/query/prepare");
+    return true;
+  }
+
+  bool parseSuccess = true;
+  std::shared_ptr<VPackBuilder> parsedBody =
+      parseVelocyPackBody(parseSuccess);
+  if (!parseSuccess) {
+    // error message generated in parseVelocyPackBody
+    return true;
+  }
+
+  VPackSlice body = parsedBody.get()->slice();
+
+  if (!body.isObject()) {
+    generateError(rest::ResponseCode::BAD, TRI_ERROR_HTTP_BAD_PARAMETER,
+                  "expecting a JSON object as body");
+    return true;
+  }
+
+  VPackSlice querySlice = body.get("query");
+  if (!querySlice.isString()) {
+    generateError(rest::ResponseCode::BAD, TRI_ERROR_QUERY_EMPTY);
+    return true;
+  }
+  std::string queryString = querySlice.copyString();
+
+  Query query(false, _vocbase, QueryString(queryString), nullptr, nullptr,
+              PART_MAIN);
+
+  auto parseResult = query.parse();
+
+  if (parseResult.code != TRI_ERROR_NO_ERROR) {
+    generateError(rest::ResponseCode::BAD, parseResult.code,
+                  parseResult.details);
+    return true;
+  }
+
+  double ttl = VelocyPackHelper::getNumericValue<double>(
+      body, "preparedTtl", DefaultPreparedTtl);
+  if (ttl <= 0.0) {
+    ttl = DefaultPreparedTtl;
+  }
+
+  // all other attributes are the defaults for executing the statement
+  auto options = std::make_shared<VPackBuilder>();
+  options->openObject();
+  for (auto const& it : VPackObjectIterator(body)) {
+    std::string const key = it.key.copyString();
+    if (key != "query" && key != "bindVars" && key != "preparedTtl") {
+      options->add(key, it.value);
+    }
+  }
+  options->close();
+
+  std::vector<std::string> bindParameters(parseResult.bindParameters.begin(),
+                                          parseResult.bindParameters.end());
+  std::sort(bindParameters.begin(), bindParameters.end());
+
+  auto prepared = std::make_shared<PreparedQuery>(
+      std::move(queryString), options, std::move(bindParameters), ttl);
+  QueryId id =
+      QueryRegistryFeature::QUERY_REGISTRY->insertPrepared(_vocbase, prepared);
+
+  VPackBuilder result;
+  {
+    VPackObjectBuilder b(&result);
+    result.add("error", VPackValue(false));
+    result.add("code", VPackValue((int)rest::ResponseCode::CREATED));
+    result.add("id", VPackValue(StringUtils::itoa(id)));
+
+    result.add("collections", VPackValue(VPackValueType::Array));
+    for (auto const& it : parseResult.collectionNames) {
+      result.add(VPackValue(it));
+    }
+    result.close();  // collections
+
+    result.add("bindVars", VPackValue(VPackValueType::Array));
+    for (auto const& it : prepared->bindParameters) {
+      result.add(VPackValue(it));
+    }
+    result.close();  // bindVars
+  }
+
+  generateResult(rest::ResponseCode::CREATED, result.slice());
+  return true;
+}
+
+bool RestQueryHandler::deletePrepared() {
+  auto const& suffixes = _request->suffixes();
+
+  if (suffixes.size() != 2) {
+    generateError(rest::ResponseCode::BAD, TRI_ERROR_HTTP_BAD_PARAMETER,
+                  "expecting DELETE /_api/query/prepare/<id>");
+    return true;
+  }
+
+  QueryId id = StringUtils::uint64(suffixes[1]);
+  if (!QueryRegistryFeature::QUERY_REGISTRY->destroyPrepared(_vocbase, id)) {
+    generateError(rest::ResponseCode::NOT_FOUND, TRI_ERROR_QUERY_NOT_FOUND,
+                  "prepared query not found");
+    return true;
+  }
+
+  VPackBuilder result;
+  {
+    VPackObjectBuilder b(&result);
+    result.add("error", VPackValue(false));
+    result.add("code", VPackValue((int)rest::ResponseCode::OK));
+    result.add("id", VPackValue(suffixes[1]));
+  }
+
+  generateResult(rest::ResponseCode::OK, result.slice());
+  return true;
+}
@@ -90,6 +90,18 @@ class RestQueryHandler : public RestVocbaseBaseHandler {
   //////////////////////////////////////////////////////////////////////////////
 
   bool parseQuery();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief parses a query and registers it as prepared statement
+  //////////////////////////////////////////////////////////////////////////////
+
+  bool prepareQuery();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief removes a prepared statement
+  //////////////////////////////////////////////////////////////////////////////
+
+  bool deletePrepared();
 };
 }
 
@@ -231,9 +231,10 @@ void RestViewHandler::getViews() {
   std::vector<std::string> const& suffixes = _request->suffixes();
 
   if (suffixes.size() > 2 ||
-      ((suffixes.size() == 2) && (suffixes[1] != "properties"))) {
+      ((suffixes.size() == 2) && (suffixes[1] != "properties") &&
+       (suffixes[1] != "result"))) {
     generateError(rest::ResponseCode::BAD, TRI_ERROR_BAD_PARAMETER,
-                  "expecting GET /_api/view[/<view-name>[/properties]]");
+                  "expecting GET /_api/view[/<view-name>[/properties|/result]]");
     return;
   }
 
@@ -244,6 +245,8 @@ void RestViewHandler::getViews() {
     std::string const& name = suffixes[0];
     if (suffixes.size() == 1) {
       getSingleView(name);
+    } else if (suffixes[1] == "result") {
+      getViewResult(name);
     } else {
       getViewProperties(name);
     }
@@ -302,3 +305,33 @@ void RestViewHandler::getViewProperties(std::string const& name) {
                   TRI_ERROR_ARANGO_VIEW_NOT_FOUND);
   }
 }
+
+void RestViewHandler::getViewResult(std::string const& name) {
+  std::shared_ptr<LogicalView> view = _vocbase->lookupView(name);
+  if (view.get() == nullptr) {
+    generateError(rest::ResponseCode::NOT_FOUND,
+                  TRI_ERROR_ARANGO_VIEW_NOT_FOUND);
+    return;
+  }
+
+  VPackBuilder data;
+  auto result = view->getImplementation()->getResultVPack(data);
+  if (result.fail()) {
+    rest::ResponseCode httpCode;
+    switch (result.errorNumber()) {
+      case TRI_ERROR_NOT_IMPLEMENTED:
+        httpCode = rest::ResponseCode::NOT_IMPLEMENTED;
+        break;
+      case TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND:
+        httpCode = rest::ResponseCode::NOT_FOUND;
+        break;
+      default:
+        httpCode = rest::ResponseCode::SERVER_ERROR;
+        break;
+    }
+    generateError(httpCode, result.errorNumber(), result.errorMessage());
+    return;
+  }
+
+  generateResult(rest::ResponseCode::OK, data.slice());
+}
@@ -50,6 +50,7 @@ class RestViewHandler : public RestVocbaseBaseHandler {
 
   void getSingleView(std::string const&);
   void getViewProperties(std::string const&);
+  void getViewResult(std::string const&);
   void getListOfViews();
 };
 }
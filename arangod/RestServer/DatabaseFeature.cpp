@@ -61,6 +61,8 @@
 
 #include <velocypack/velocypack-aliases.h>
 
+#include <thread>
+
 using namespace arangodb;
 using namespace arangodb::application_features;
 using namespace arangodb::basics;
@@ -224,6 +226,7 @@ DatabaseFeature::DatabaseFeature(ApplicationServer* server)
       _ignoreDatafileErrors(false),
       _check30Revisions("true"),
       _throwCollectionNotLoadedError(false),
+      _openThreads(0),
       _vocbase(nullptr),
       _databasesLists(new DatabasesLists()),
       _isInitiallyEmpty(false),
@@ -291,6 +294,12 @@ void DatabaseFeature::collectOptions(std::shared_ptr<ProgramOptions> options) {
           &_check30Revisions,
           std::unordered_set<std::string>{"true", "false", "fail"}));
 
+  options->addHiddenOption(
+      "--database.open-threads",
+      "number of threads opening databases and their collections on startup "
+      "(0 = number of cores, at most 16)",
+      new UInt64Parameter(&_openThreads));
+
   // the following option was removed in 3.2 
   // index-creation is now automatically parallelized via the Boost ASIO thread pool
   options->addObsoleteOption(
@@ -322,6 +331,15 @@ void DatabaseFeature::validateOptions(std::shared_ptr<ProgramOptions> options) {
 
 void DatabaseFeature::prepare() {}
 
+size_t DatabaseFeature::openThreads() const {
+  if (_openThreads > 0) {
+    return static_cast<size_t>(_openThreads);
+  }
+  return (std::min)(
+      static_cast<size_t>((std::max)(1U, std::thread::hardware_concurrency())),
+      static_cast<size_t>(16));
+}
+
 void DatabaseFeature::start() {
   // set singleton
   DATABASE = this;
@@ -1192,6 +1210,8 @@ int DatabaseFeature::iterateDatabases(VPackSlice const& databases) {
   auto newLists = new DatabasesLists(*oldLists);
 
   try {
+    std::vector<VPackSlice> toOpen;
+
     for (auto const& it : VPackArrayIterator(databases)) {
       TRI_ASSERT(it.isObject());
 
@@ -1212,10 +1232,64 @@ int DatabaseFeature::iterateDatabases(VPackSlice const& databases) {
         break;
       }
 
-      // open the database and scan collections in it
+      toOpen.emplace_back(it);
+    }
+
+    // open the databases and scan the collections in them. the threads take
+    // the next database from the list until all are opened
+    std::vector<TRI_vocbase_t*> opened(toOpen.size(), nullptr);
+    std::atomic<size_t> next(0);
+    Mutex failureLock;
+    std::exception_ptr failure;
+
+    auto open = [&]() {
+      while (true) {
+        size_t const i = next++;
+        if (i >= toOpen.size()) {
+          return;
+        }
+        {
+          MUTEX_LOCKER(locker, failureLock);
+          if (failure) {
+            return;
+          }
+        }
+        try {
+          opened[i] = engine->openDatabase(toOpen[i], _upgrade);
+        } catch (...) {
+          MUTEX_LOCKER(locker, failureLock);
+          if (!failure) {
+            failure = std::current_exception();
+          }
+          return;
+        }
+      }
+    };
+
+    size_t numThreads = 1;
+    if (engine->supportsParallelDatabaseOpening()) {
+      numThreads = (std::max)((std::min)(toOpen.size(), openThreads()),
+                              static_cast<size_t>(1));
+    }
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < numThreads; ++i) {
+      threads.emplace_back(open);
+    }
+    open();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    if (failure) {
+      std::rethrow_exception(failure);
+    }
+
+    LOG_TOPIC(DEBUG, Logger::FIXME) << "opened " << opened.size()
+                                    << " database(s) using " << numThreads
+                                    << " thread(s)";
 
-      // try to open this database
-      TRI_vocbase_t* database = engine->openDatabase(it, _upgrade);
+    for (TRI_vocbase_t* database : opened) {
+      TRI_ASSERT(database != nullptr);
 
       try {
         database->addReplicationApplier(TRI_CreateReplicationApplier(database));
@@ -1225,7 +1299,7 @@ int DatabaseFeature::iterateDatabases(VPackSlice const& databases) {
         FATAL_ERROR_EXIT();
       }
 
-      if (databaseName == TRI_VOC_SYSTEM_DATABASE) {
+      if (database->name() == TRI_VOC_SYSTEM_DATABASE) {
         // found the system database
         TRI_ASSERT(_vocbase == nullptr);
         _vocbase = database;
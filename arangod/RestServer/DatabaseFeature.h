@@ -116,6 +116,9 @@ class DatabaseFeature final : public application_features::ApplicationFeature {
   bool waitForSync() const { return _defaultWaitForSync; }
   uint64_t maximalJournalSize() const { return _maximalJournalSize; }
 
+  /// @brief number of threads opening databases and collections on startup
+  size_t openThreads() const;
+
   void disableReplicationApplier() { _replicationApplier = false; }
   void enableCheckVersion() { _checkVersion = true; }
   void enableUpgrade() { _upgrade = true; }
@@ -158,6 +161,7 @@ class DatabaseFeature final : public application_features::ApplicationFeature {
   bool _ignoreDatafileErrors;
   std::string _check30Revisions;
   std::atomic<bool> _throwCollectionNotLoadedError;
+  uint64_t _openThreads;
 
   TRI_vocbase_t* _vocbase;
   std::unique_ptr<DatabaseManagerThread> _databaseManager;
@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryGovernorFeature.h"
+
+#include "Basics/MutexLocker.h"
+#include "Logger/Logger.h"
+#include "ProgramOptions/ProgramOptions.h"
+#include "ProgramOptions/Section.h"
+
+using namespace arangodb;
+using namespace arangodb::application_features;
+using namespace arangodb::options;
+
+MemoryGovernorFeature* MemoryGovernorFeature::GOVERNOR = nullptr;
+
+MemoryGovernorFeature::MemoryGovernorFeature(
+    application_features::ApplicationServer* server)
+    : ApplicationFeature(server, "MemoryGovernor"),
+      _budget(0),
+      _consumers(),
+      _queryAllowance(0),
+      _committed(0),
+      _queryMemory(0),
+      _rebalancedQueryMemory(0) {
+  setOptional(true);
+  requiresElevatedPrivileges(false);
+  startsAfter("Logger");
+}
+
+void MemoryGovernorFeature::collectOptions(
+    std::shared_ptr<ProgramOptions> options) {
+  options->addSection("server", "Server features");
+
+  options->addOption("--server.memory-budget",
+                     "memory in bytes shared by the caches, memtables and AQL "
+                     "queries; caches are shrunk when queries need memory "
+                     "(0 = no shared budget)",
+                     new UInt64Parameter(&_budget));
+}
+
+void MemoryGovernorFeature::validateOptions(
+    std::shared_ptr<ProgramOptions>) {
+  if (_budget > 0 && _budget < 16 * chunkSize) {
+    LOG_TOPIC(FATAL, arangodb::Logger::FIXME)
+        << "invalid value for `--server.memory-budget', need at least "
+        << (16 * chunkSize);
+    FATAL_ERROR_EXIT();
+  }
+}
+
+void MemoryGovernorFeature::prepare() {
+  _queryAllowance.store(_budget);
+  GOVERNOR = this;
+}
+
+void MemoryGovernorFeature::unprepare() {
+  GOVERNOR = nullptr;
+  MUTEX_LOCKER(guard, _lock);
+  _consumers.clear();
+}
+
+void MemoryGovernorFeature::registerConsumer(std::string const& name,
+                                             uint64_t preferred,
+                                             uint64_t minimum,
+                                             ResizeCallback const& resize) {
+  if (!isEnabled()) {
+    return;
+  }
+
+  MUTEX_LOCKER(guard, _lock);
+  if (!resize) {
+    minimum = preferred;
+  }
+  _consumers.emplace_back(
+      Consumer{name, preferred, (std::min)(minimum, preferred), preferred,
+               resize});
+
+  uint64_t reserved = 0;
+  for (auto const& c : _consumers) {
+    reserved += c.minimum;
+  }
+  if (reserved > _budget) {
+    LOG_TOPIC(WARN, arangodb::Logger::FIXME)
+        << "memory budget of " << _budget << " bytes is smaller than the "
+        << reserved << " bytes the registered consumers need at least";
+  }
+  rebalance();
+}
+
+void MemoryGovernorFeature::unregisterConsumer(std::string const& name) {
+  MUTEX_LOCKER(guard, _lock);
+  for (auto it = _consumers.begin(); it != _consumers.end(); ++it) {
+    if ((*it).name == name) {
+      _consumers.erase(it);
+      break;
+    }
+  }
+  rebalance();
+}
+
+bool MemoryGovernorFeature::borrowQueryMemory(uint64_t value) {
+  if (!isEnabled()) {
+    return true;
+  }
+
+  uint64_t previous = _queryMemory.fetch_add(value);
+  if (previous + value > _queryAllowance.load()) {
+    _queryMemory -= value;
+    return false;
+  }
+
+  if (previous + value + _committed.load() > _budget) {
+    // caches need to make room
+    MUTEX_LOCKER(guard, _lock);
+    rebalance();
+  }
+  return true;
+}
+
+void MemoryGovernorFeature::returnQueryMemory(uint64_t value) {
+  if (!isEnabled()) {
+    return;
+  }
+
+  uint64_t previous = _queryMemory.fetch_sub(value);
+  TRI_ASSERT(previous >= value);
+
+  // grow caches back once a noticeable share of the budget is free again,
+  // but do not hold up the query if someone is rebalancing already
+  TRY_MUTEX_LOCKER(guard, _lock);
+  if (guard.isLocked() &&
+      _rebalancedQueryMemory > (previous - value) + (_budget / 32)) {
+    rebalance();
+  }
+}
+
+void MemoryGovernorFeature::rebalance() {
+  uint64_t fixed = 0;
+  uint64_t minimum = 0;
+  uint64_t preferred = 0;
+  for (auto const& c : _consumers) {
+    if (c.resize) {
+      minimum += c.minimum;
+      preferred += c.preferred;
+    } else {
+      fixed += c.preferred;
+    }
+  }
+
+  uint64_t reserved = fixed + minimum;
+  _queryAllowance.store((_budget > reserved) ? (_budget - reserved) : 0);
+
+  uint64_t queries = _queryMemory.load();
+  _rebalancedQueryMemory = queries;
+  uint64_t available =
+      (_budget > fixed + queries) ? (_budget - fixed - queries) : 0;
+
+  // scale all resizable consumers by the same factor, but never below their
+  // minimum
+  double factor = 1.0;
+  if (preferred > available && preferred > 0) {
+    factor = static_cast<double>(available) / static_cast<double>(preferred);
+  }
+
+  uint64_t committed = fixed;
+  for (auto& c : _consumers) {
+    if (c.resize) {
+      uint64_t target = (std::max)(
+          c.minimum,
+          static_cast<uint64_t>(factor * static_cast<double>(c.preferred)));
+      if (target != c.current && c.resize(target)) {
+        LOG_TOPIC(DEBUG, arangodb::Logger::FIXME)
+            << "resized memory consumer '" << c.name << "' from "
+            << c.current << " to " << target << " bytes";
+        c.current = target;
+      }
+    }
+    committed += c.current;
+  }
+  _committed.store(committed);
+}
@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_REST_SERVER_MEMORY_GOVERNOR_FEATURE_H
+#define ARANGOD_REST_SERVER_MEMORY_GOVERNOR_FEATURE_H 1
+
+#include "ApplicationFeatures/ApplicationFeature.h"
+#include "Basics/Mutex.h"
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace arangodb {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Distributes a single memory budget between the hash cache, the
+/// RocksDB block cache and memtables, and AQL queries.
+///
+/// Memory consumers register with a preferred and a minimum size. Consumers
+/// without a resize callback (e.g. memtables) are accounted for with their
+/// preferred size. Queries borrow memory in chunks via their ResourceMonitor;
+/// when query memory grows, resizable consumers are shrunk proportionally
+/// towards their minimum, and grown back once queries release memory. A
+/// borrow fails once even minimum-sized consumers would not fit anymore.
+////////////////////////////////////////////////////////////////////////////////
+class MemoryGovernorFeature final
+    : public application_features::ApplicationFeature {
+ public:
+  static MemoryGovernorFeature* GOVERNOR;
+
+  // granularity at which queries borrow from the budget
+  static constexpr uint64_t chunkSize = 1024 * 1024;
+
+  // resize callback, returns whether the new size was applied
+  typedef std::function<bool(uint64_t)> ResizeCallback;
+
+ public:
+  explicit MemoryGovernorFeature(
+      application_features::ApplicationServer* server);
+
+ public:
+  void collectOptions(std::shared_ptr<options::ProgramOptions>) override final;
+  void validateOptions(std::shared_ptr<options::ProgramOptions>) override final;
+  void prepare() override final;
+  void unprepare() override final;
+
+ public:
+  bool isEnabled() const { return _budget > 0; }
+  uint64_t budget() const { return _budget; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Registers a memory consumer. A consumer without a resize callback
+  /// has a fixed size. The callback is invoked with the governor lock held and
+  /// must not call back into the governor.
+  //////////////////////////////////////////////////////////////////////////////
+  void registerConsumer(std::string const& name, uint64_t preferred,
+                        uint64_t minimum, ResizeCallback const& resize);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Unregisters a memory consumer, must be called before the
+  /// consumer's resize callback becomes invalid.
+  //////////////////////////////////////////////////////////////////////////////
+  void unregisterConsumer(std::string const& name);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Borrows query memory from the budget, shrinking caches if
+  /// necessary. Returns false if the budget is exhausted.
+  //////////////////////////////////////////////////////////////////////////////
+  bool borrowQueryMemory(uint64_t value);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Returns previously borrowed query memory.
+  //////////////////////////////////////////////////////////////////////////////
+  void returnQueryMemory(uint64_t value);
+
+  uint64_t queryMemory() const { return _queryMemory.load(); }
+
+ private:
+  struct Consumer {
+    std::string name;
+    uint64_t preferred;
+    uint64_t minimum;
+    uint64_t current;
+    ResizeCallback resize;
+  };
+
+  // recomputes the sizes of all resizable consumers, expects _lock to be held
+  void rebalance();
+
+ private:
+  uint64_t _budget;
+
+  Mutex _lock;
+  std::vector<Consumer> _consumers;
+  // memory which queries may borrow at most, protected by _lock
+  std::atomic<uint64_t> _queryAllowance;
+  // memory currently committed to consumers, protected by _lock
+  std::atomic<uint64_t> _committed;
+  std::atomic<uint64_t> _queryMemory;
+  // query memory at the time of the last rebalancing, protected by _lock
+  uint64_t _rebalancedQueryMemory;
+};
+}
+
+#endif
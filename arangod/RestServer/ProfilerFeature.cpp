@@ -0,0 +1,345 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "ProfilerFeature.h"
+
+#include "Basics/MutexLocker.h"
+#include "Basics/Thread.h"
+#include "Basics/WorkDescription.h"
+#include "GeneralServer/RestHandler.h"
+#include "Logger/Logger.h"
+#include "ProgramOptions/ProgramOptions.h"
+#include "ProgramOptions/Section.h"
+
+#ifndef _WIN32
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+using namespace arangodb;
+using namespace arangodb::application_features;
+using namespace arangodb::options;
+
+ProfilerFeature* ProfilerFeature::PROFILER = nullptr;
+
+namespace {
+/// @brief frames kept per sample
+size_t const MaxDepth = 64;
+
+/// @brief frames of the signal handler itself, which are skipped
+size_t const SkipFrames = 2;
+
+/// @brief samples buffered until the profiler thread collects them
+size_t const NumberOfSamples = 8192;
+
+/// @brief distinct stacks kept at most, further ones are counted as other
+size_t const MaxStacks = 100000;
+
+/// @brief a sample taken by the signal handler. state 0 means free, 1 means
+/// being written by the handler, 2 means ready for the profiler thread
+struct Sample {
+  std::atomic<int> state;
+  size_t depth;
+  char const* handler;
+  uint64_t queryId;
+  void* frames[MaxDepth];
+};
+
+Sample* Samples = nullptr;
+std::atomic<uint64_t> NextSample(0);
+std::atomic<uint64_t> DroppedSamples(0);
+
+#ifndef _WIN32
+/// @brief takes a sample of the interrupted thread. only the thread's own
+/// work descriptions are read, and they cannot go away while it is
+/// interrupted
+void ProfilerSignalHandler(int) {
+  int const savedErrno = errno;
+
+  Sample& sample = Samples[NextSample.fetch_add(1, std::memory_order_relaxed) %
+                           NumberOfSamples];
+  int expected = 0;
+  if (!sample.state.compare_exchange_strong(expected, 1,
+                                            std::memory_order_acquire)) {
+    // the profiler thread is behind
+    DroppedSamples.fetch_add(1, std::memory_order_relaxed);
+    errno = savedErrno;
+    return;
+  }
+
+  sample.handler = nullptr;
+  sample.queryId = 0;
+  WorkDescription* desc = Thread::currentWorkDescription();
+  while (desc != nullptr) {
+    if (desc->_type == WorkType::HANDLER && sample.handler == nullptr) {
+      rest::RestHandler* handler = desc->_data._handler._handler.get();
+      if (handler != nullptr) {
+        sample.handler = handler->name();
+      }
+    } else if ((desc->_type == WorkType::AQL_ID ||
+                desc->_type == WorkType::AQL_STRING) &&
+               sample.queryId == 0) {
+      sample.queryId = desc->_data._aql._id;
+    }
+    desc = desc->_prev.load(std::memory_order_relaxed);
+  }
+
+  int depth = backtrace(sample.frames, static_cast<int>(MaxDepth));
+  sample.depth = depth < 0 ? 0 : static_cast<size_t>(depth);
+
+  sample.state.store(2, std::memory_order_release);
+  errno = savedErrno;
+}
+#endif
+}
+
+namespace arangodb {
+class ProfilerThread final : public Thread {
+ public:
+  ProfilerThread() : Thread("Profiler") {}
+  ~ProfilerThread() { shutdown(); }
+
+ protected:
+  void run() override {
+    while (!isStopping()) {
+      usleep(250 * 1000);
+      try {
+        ProfilerFeature::PROFILER->collect();
+      } catch (std::exception const& ex) {
+        LOG_TOPIC(WARN, Logger::FIXME)
+            << "caught exception in profiler thread: " << ex.what();
+      }
+    }
+  }
+};
+}
+
+ProfilerFeature::ProfilerFeature(
+    application_features::ApplicationServer* server)
+    : ApplicationFeature(server, "Profiler"), _frequency(0) {
+  setOptional(true);
+  requiresElevatedPrivileges(false);
+  startsAfter("WorkMonitor");
+}
+
+ProfilerFeature::~ProfilerFeature() {}
+
+void ProfilerFeature::collectOptions(std::shared_ptr<ProgramOptions> options) {
+  options->addSection("server", "Server features");
+
+  options->addOption("--server.profiler-frequency",
+                     "samples per second of CPU time taken of the stacks of "
+                     "the server's threads, available via /_admin/profiler "
+                     "(0 = profiler off)",
+                     new UInt64Parameter(&_frequency));
+}
+
+void ProfilerFeature::validateOptions(std::shared_ptr<ProgramOptions>) {
+  if (_frequency > 1000) {
+    LOG_TOPIC(FATAL, arangodb::Logger::FIXME)
+        << "invalid value for `--server.profiler-frequency', must be at most "
+           "1000";
+    FATAL_ERROR_EXIT();
+  }
+#ifdef _WIN32
+  if (_frequency > 0) {
+    LOG_TOPIC(WARN, arangodb::Logger::FIXME)
+        << "the profiler is not supported on this platform";
+    _frequency = 0;
+  }
+#endif
+}
+
+void ProfilerFeature::start() {
+  if (!isEnabled()) {
+    return;
+  }
+
+#ifndef _WIN32
+  Samples = new Sample[NumberOfSamples];
+  for (size_t i = 0; i < NumberOfSamples; ++i) {
+    Samples[i].state.store(0);
+  }
+
+  // the first call of backtrace() loads libgcc, which must not happen in
+  // the signal handler
+  void* frames[2];
+  backtrace(frames, 2);
+
+  PROFILER = this;
+  _thread.reset(new ProfilerThread());
+  if (!_thread->start()) {
+    LOG_TOPIC(FATAL, arangodb::Logger::FIXME)
+        << "could not start profiler thread";
+    FATAL_ERROR_EXIT();
+  }
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = ProfilerSignalHandler;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGPROF, &action, nullptr);
+
+  // the timer counts the CPU time of all threads, the signal goes to the
+  // thread running when it expires
+  uint64_t const interval = 1000000 / _frequency;
+  struct itimerval timer;
+  timer.it_interval.tv_sec = static_cast<time_t>(interval / 1000000);
+  timer.it_interval.tv_usec = static_cast<suseconds_t>(interval % 1000000);
+  timer.it_value = timer.it_interval;
+  setitimer(ITIMER_PROF, &timer, nullptr);
+
+  LOG_TOPIC(INFO, arangodb::Logger::FIXME)
+      << "profiler samples the server's stacks " << _frequency
+      << " times per second of CPU time";
+#endif
+}
+
+void ProfilerFeature::stop() {
+  if (!isEnabled() || _thread == nullptr) {
+    return;
+  }
+
+#ifndef _WIN32
+  struct itimerval timer;
+  memset(&timer, 0, sizeof(timer));
+  setitimer(ITIMER_PROF, &timer, nullptr);
+  // a signal still pending must not terminate the process
+  signal(SIGPROF, SIG_IGN);
+#endif
+
+  _thread->beginShutdown();
+  _thread.reset();
+  PROFILER = nullptr;
+  // the samples are not freed, a handler may still run on another thread
+}
+
+void ProfilerFeature::collect() {
+  MUTEX_LOCKER(guard, _lock);
+
+  std::string stack;
+  for (size_t i = 0; i < NumberOfSamples; ++i) {
+    Sample& sample = Samples[i];
+    if (sample.state.load(std::memory_order_acquire) != 2) {
+      continue;
+    }
+
+    stack.clear();
+    if (sample.handler != nullptr) {
+      stack.append(sample.handler);
+    }
+    if (sample.queryId != 0) {
+      if (!stack.empty()) {
+        stack.push_back(';');
+      }
+      stack.append("AQL query ");
+      stack.append(std::to_string(sample.queryId));
+    }
+    for (size_t j = sample.depth; j > SkipFrames; --j) {
+      if (!stack.empty()) {
+        stack.push_back(';');
+      }
+      stack.append(symbol(sample.frames[j - 1]));
+    }
+    sample.state.store(0, std::memory_order_release);
+
+    if (_stacks.size() >= MaxStacks && _stacks.find(stack) == _stacks.end()) {
+      stack = "[other stacks]";
+    }
+    ++_stacks[stack];
+  }
+
+  uint64_t dropped = DroppedSamples.exchange(0);
+  if (dropped > 0) {
+    _stacks["[dropped samples]"] += dropped;
+  }
+}
+
+std::string const& ProfilerFeature::symbol(void* address) {
+  auto it = _symbols.find(address);
+  if (it != _symbols.end()) {
+    return (*it).second;
+  }
+
+  std::string name;
+#ifndef _WIN32
+  Dl_info info;
+  if (dladdr(address, &info) == 0) {
+    info.dli_fname = nullptr;
+    info.dli_sname = nullptr;
+  }
+  if (info.dli_sname != nullptr) {
+    int status = 0;
+    char* demangled =
+        abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    if (demangled != nullptr && status == 0) {
+      name = demangled;
+    } else {
+      name = info.dli_sname;
+    }
+    free(demangled);
+  } else if (info.dli_fname != nullptr) {
+    // no symbol available, keep the offset in the module, for addr2line
+    char const* file = strrchr(info.dli_fname, '/');
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "+0x%llx",
+             static_cast<unsigned long long>(
+                 reinterpret_cast<uintptr_t>(address) -
+                 reinterpret_cast<uintptr_t>(info.dli_fbase)));
+    name = (file == nullptr) ? info.dli_fname : file + 1;
+    name.append(buffer);
+  }
+#endif
+  if (name.empty()) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%p", address);
+    name = buffer;
+  }
+  // semicolons separate the frames
+  std::replace(name.begin(), name.end(), ';', ':');
+
+  return _symbols.emplace(address, std::move(name)).first->second;
+}
+
+void ProfilerFeature::foldedStacks(std::string& result, bool reset) {
+  collect();
+
+  MUTEX_LOCKER(guard, _lock);
+  for (auto const& it : _stacks) {
+    result.append(it.first);
+    result.push_back(' ');
+    result.append(std::to_string(it.second));
+    result.push_back('\n');
+  }
+  if (reset) {
+    _stacks.clear();
+  }
+}
+
+void ProfilerFeature::reset() {
+  collect();
+
+  MUTEX_LOCKER(guard, _lock);
+  _stacks.clear();
+}
@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_REST_SERVER_PROFILER_FEATURE_H
+#define ARANGOD_REST_SERVER_PROFILER_FEATURE_H 1
+
+#include "ApplicationFeatures/ApplicationFeature.h"
+#include "Basics/Mutex.h"
+
+namespace arangodb {
+class ProfilerThread;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Samples the stacks of the threads using CPU, at a configurable
+/// frequency of CPU time. The samples are taken in a SIGPROF handler, tagged
+/// with the REST handler and the AQL query the thread works on according to
+/// the WorkMonitor, and aggregated by a background thread into folded stacks,
+/// which can be turned into flame graphs.
+////////////////////////////////////////////////////////////////////////////////
+class ProfilerFeature final : public application_features::ApplicationFeature {
+ public:
+  static ProfilerFeature* PROFILER;
+
+ public:
+  explicit ProfilerFeature(application_features::ApplicationServer* server);
+  ~ProfilerFeature();
+
+ public:
+  void collectOptions(std::shared_ptr<options::ProgramOptions>) override final;
+  void validateOptions(std::shared_ptr<options::ProgramOptions>) override final;
+  void start() override final;
+  void stop() override final;
+
+ public:
+  bool isEnabled() const { return _frequency > 0; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief appends the stacks sampled so far in the folded format, one line
+  /// of semicolon-separated frames (outermost first) and a count per stack.
+  /// if reset is set, the stacks are forgotten afterwards
+  //////////////////////////////////////////////////////////////////////////////
+  void foldedStacks(std::string& result, bool reset);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief forgets the stacks sampled so far
+  //////////////////////////////////////////////////////////////////////////////
+  void reset();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief moves the samples taken by the signal handler into the stacks,
+  /// called by the profiler thread
+  //////////////////////////////////////////////////////////////////////////////
+  void collect();
+
+ private:
+  // name of a frame, symbols are resolved once per address
+  std::string const& symbol(void* address);
+
+ private:
+  uint64_t _frequency;
+
+  std::unique_ptr<ProfilerThread> _thread;
+
+  // protects the stacks and symbols
+  Mutex _lock;
+  std::unordered_map<std::string, uint64_t> _stacks;
+  std::unordered_map<void*, std::string> _symbols;
+};
+}
+
+#endif
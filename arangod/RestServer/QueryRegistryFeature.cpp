@@ -22,6 +22,7 @@
 
 #include "QueryRegistryFeature.h"
 
+#include "Aql/PlanCache.h"
 #include "Aql/Query.h"
 #include "Aql/QueryCache.h"
 #include "Aql/QueryRegistry.h"
@@ -41,9 +42,13 @@ QueryRegistryFeature::QueryRegistryFeature(ApplicationServer* server)
       _trackBindVars(true),
       _failOnWarning(false),
       _queryMemoryLimit(0),
+      _sortSpillThreshold(0),
+      _collectSpillThreshold(0),
       _slowQueryThreshold(10.0),
       _queryCacheMode("off"),
-      _queryCacheEntries(128) {
+      _queryCacheEntries(128),
+      _queryCacheMaxStaleness(0),
+      _planCacheEntries(0) {
   setOptional(false);
   requiresElevatedPrivileges(false);
   startsAfter("DatabasePath");
@@ -61,6 +66,12 @@ void QueryRegistryFeature::collectOptions(
 
   options->addOption("--query.memory-limit", "memory threshold for AQL queries (in bytes)",
                      new UInt64Parameter(&_queryMemoryLimit));
+  
+  options->addOption("--query.sort-spill-threshold", "memory threshold (in bytes) after which AQL SORT operations write sorted runs to temporary files (0 = never)",
+                     new UInt64Parameter(&_sortSpillThreshold));
+  
+  options->addOption("--query.collect-spill-threshold", "memory threshold (in bytes) after which hashed AQL COLLECT operations write rows of new groups to temporary files (0 = never)",
+                     new UInt64Parameter(&_collectSpillThreshold));
 
   options->addOption("--query.tracking", "whether to track slow AQL queries",
                      new BooleanParameter(&_trackSlowQueries));
@@ -81,6 +92,14 @@ void QueryRegistryFeature::collectOptions(
   options->addOption("--query.cache-entries",
                      "maximum number of results in query result cache per database",
                      new UInt64Parameter(&_queryCacheEntries));
+
+  options->addOption("--query.cache-max-staleness",
+                     "maximum age (in milliseconds) of invalidated results that may still be returned from the query result cache (0 = never return invalidated results)",
+                     new UInt64Parameter(&_queryCacheMaxStaleness));
+
+  options->addOption("--query.plan-cache-entries",
+                     "maximum number of execution plans in the AQL plan cache (0 = disable plan cache)",
+                     new UInt64Parameter(&_planCacheEntries));
 }
 
 void QueryRegistryFeature::prepare() {
@@ -88,6 +107,10 @@ void QueryRegistryFeature::prepare() {
   std::pair<std::string, size_t> cacheProperties{_queryCacheMode,
                                                  _queryCacheEntries};
   arangodb::aql::QueryCache::instance()->setProperties(cacheProperties);
+  arangodb::aql::QueryCache::instance()->setMaxStaleness(_queryCacheMaxStaleness);
+
+  // configure the plan cache
+  arangodb::aql::PlanCache::instance()->setMaxEntries(static_cast<size_t>(_planCacheEntries));
   
   // create the query registery
   _queryRegistry.reset(new aql::QueryRegistry());
@@ -48,15 +48,21 @@ class QueryRegistryFeature final : public application_features::ApplicationFeatu
   double slowQueryThreshold() const { return _slowQueryThreshold; }
   bool failOnWarning() const { return _failOnWarning; }
   uint64_t queryMemoryLimit() const { return _queryMemoryLimit; }
+  uint64_t sortSpillThreshold() const { return _sortSpillThreshold; }
+  uint64_t collectSpillThreshold() const { return _collectSpillThreshold; }
 
  private:
   bool _trackSlowQueries;
   bool _trackBindVars;
   bool _failOnWarning;
   uint64_t _queryMemoryLimit;
+  uint64_t _sortSpillThreshold;
+  uint64_t _collectSpillThreshold;
   double _slowQueryThreshold;
   std::string _queryCacheMode;
   uint64_t _queryCacheEntries;
+  uint64_t _queryCacheMaxStaleness;
+  uint64_t _planCacheEntries;
 
  public:
   aql::QueryRegistry* queryRegistry() const { return _queryRegistry.get(); }
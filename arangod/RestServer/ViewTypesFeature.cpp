@@ -24,6 +24,7 @@
 
 #include "ApplicationFeatures/ApplicationServer.h"
 
+#include "Views/AggregateView.h"
 #include "Views/LoggerView.h"
 
 using namespace arangodb;
@@ -44,6 +45,9 @@ ViewTypesFeature::ViewTypesFeature(ApplicationServer* server)
 void ViewTypesFeature::prepare() {
   // register the "logger" example view type
   registerViewImplementation(LoggerView::type, LoggerView::creator);
+
+  // register the "aggregate" view type
+  registerViewImplementation(AggregateView::type, AggregateView::creator);
 }
 
 void ViewTypesFeature::unprepare() { _viewCreators.clear(); }
@@ -50,7 +50,7 @@ static ExecutionCondition const NotInCoordinator = [] {
 AqlValue RocksDBAqlFunctions::Fulltext(
     arangodb::aql::Query* query, transaction::Methods* trx,
     VPackFunctionParameters const& parameters) {
-  ValidateParameters(parameters, "FULLTEXT", 3, 4);
+  ValidateParameters(parameters, "FULLTEXT", 3, 5);
 
   AqlValue collectionValue = ExtractFunctionParameterValue(trx, parameters, 0);
 
@@ -94,6 +94,17 @@ AqlValue RocksDBAqlFunctions::Fulltext(
     }
   }
 
+  // order the results by relevance
+  bool score = false;
+  if (parameters.size() >= 5) {
+    AqlValue scoreValue = ExtractFunctionParameterValue(trx, parameters, 4);
+    if (!scoreValue.isNull(true) && !scoreValue.isBoolean()) {
+      THROW_ARANGO_EXCEPTION_PARAMS(
+          TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH, "FULLTEXT");
+    }
+    score = scoreValue.toBoolean();
+  }
+
   auto resolver = trx->resolver();
   TRI_voc_cid_t cid = resolver->getCollectionIdLocal(collectionName);
   trx->addCollectionAtRuntime(cid, collectionName);
@@ -144,7 +155,7 @@ AqlValue RocksDBAqlFunctions::Fulltext(
   if (!res.ok()) {
     THROW_ARANGO_EXCEPTION_MESSAGE(res.errorNumber(), res.errorMessage());
   }
-  res = fulltextIndex->executeQuery(trx, parsedQuery, maxResults,
+  res = fulltextIndex->executeQuery(trx, parsedQuery, maxResults, score,
                                     *(builder.get()));
   if (!res.ok()) {
     THROW_ARANGO_EXCEPTION_MESSAGE(res.errorNumber(), res.errorMessage());
@@ -391,7 +402,7 @@ void RocksDBAqlFunctions::registerResources() {
   TRI_ASSERT(functions != nullptr);
 
   // fulltext functions
-  functions->add({"FULLTEXT", "AQL_FULLTEXT", ".h,.,.|.", true, false, true,
+  functions->add({"FULLTEXT", "AQL_FULLTEXT", ".h,.,.|.,.", true, false, true,
                   false, true, &RocksDBAqlFunctions::Fulltext,
                   NotInCoordinator});
   functions->add({"NEAR", "AQL_NEAR", ".h,.,.|.,.", true, false, true, false,
@@ -23,14 +23,30 @@
 #include "RocksDBBackgroundThread.h"
 #include "Basics/ConditionLocker.h"
 #include "RestServer/DatabaseFeature.h"
+#include "RocksDBEngine/RocksDBCacheHeatMap.h"
+#include "RocksDBEngine/RocksDBCollection.h"
 #include "RocksDBEngine/RocksDBCommon.h"
 #include "RocksDBEngine/RocksDBCounterManager.h"
 #include "RocksDBEngine/RocksDBEngine.h"
 #include "RocksDBEngine/RocksDBReplicationManager.h"
+#include "RocksDBEngine/RocksDBTtl.h"
+#include "Utils/CollectionGuard.h"
 #include "Utils/CursorRepository.h"
+#include "VocBase/LogicalCollection.h"
 
 using namespace arangodb;
 
+/// @brief interval in which collections are checked for changes that
+/// require new attribute statistics
+static constexpr double AnalyzeInterval = 60.0;
+
+/// @brief maximum number of collections analyzed per check, so that a
+/// single check does not take too long
+static constexpr size_t MaxAnalyzedCollections = 4;
+
+/// @brief interval in which the hot keys of the caches are persisted
+static constexpr double HeatMapInterval = 300.0;
+
 RocksDBBackgroundThread::RocksDBBackgroundThread(RocksDBEngine* eng,
                                                  double interval)
     : Thread("RocksDBThread"), _engine(eng), _interval(interval) {}
@@ -46,6 +62,9 @@ void RocksDBBackgroundThread::beginShutdown() {
 }
 
 void RocksDBBackgroundThread::run() {
+  double lastAnalyze = TRI_microtime();
+  double lastHeatMap = lastAnalyze;
+
   while (!isStopping()) {
     {
       CONDITION_LOCKER(guard, _condition);
@@ -54,6 +73,9 @@ void RocksDBBackgroundThread::run() {
 
     try {
       if (!isStopping()) {
+        if (DatabaseFeature::DATABASE != nullptr) {
+          adjustExpiredCounts();
+        }
         _engine->counterManager()->sync(false);
       }
 
@@ -76,6 +98,21 @@ void RocksDBBackgroundThread::run() {
             });
       }
 
+      if (!force && DatabaseFeature::DATABASE != nullptr &&
+          TRI_microtime() - lastAnalyze >= AnalyzeInterval) {
+        analyzeCollections();
+        lastAnalyze = TRI_microtime();
+      }
+
+      if (!force) {
+        // prefetch the hot keys of databases opened since the last run
+        RocksDBCacheHeatMap::startPrefetches();
+        if (TRI_microtime() - lastHeatMap >= HeatMapInterval) {
+          RocksDBCacheHeatMap::persist();
+          lastHeatMap = TRI_microtime();
+        }
+      }
+
       // determine which WAL files can be pruned
       _engine->determinePrunableWalFiles(minTick);
       // and then prune them when they expired
@@ -88,5 +125,97 @@ void RocksDBBackgroundThread::run() {
           << "caught unknown exception in rocksdb background";
     }
   }
+  try {
+    if (DatabaseFeature::DATABASE != nullptr) {
+      adjustExpiredCounts();
+    }
+  } catch (...) {
+  }
   _engine->counterManager()->sync(true);  // final write on shutdown
 }
+
+/// @brief refresh the attribute statistics of collections that changed
+/// considerably since they were last analyzed
+void RocksDBBackgroundThread::analyzeCollections() {
+  size_t analyzed = 0;
+  DatabaseFeature::DATABASE->enumerateDatabases(
+      [this, &analyzed](TRI_vocbase_t* vocbase) {
+        std::vector<TRI_voc_cid_t> ids;
+        for (auto* collection : vocbase->collections(false)) {
+          ids.emplace_back(collection->cid());
+        }
+
+        for (TRI_voc_cid_t cid : ids) {
+          if (analyzed >= MaxAnalyzedCollections || isStopping()) {
+            return;
+          }
+          LogicalCollection* collection = vocbase->lookupCollection(cid);
+          if (collection == nullptr || collection->deleted() ||
+              collection->status() != TRI_VOC_COL_STATUS_LOADED) {
+            // dropped meanwhile, or not loaded. analyzing must not load it
+            continue;
+          }
+
+          try {
+            // keeps the collection from being dropped or unloaded while it
+            // is analyzed
+            CollectionGuard guard(vocbase, cid);
+            auto physical = toRocksDBCollection(guard.collection());
+            if (guard.collection()->deleted() || !physical->needsAnalyze()) {
+              continue;
+            }
+            ++analyzed;
+            Result res = physical->analyze();
+            if (res.fail()) {
+              LOG_TOPIC(WARN, Logger::ENGINES)
+                  << "analyzing collection '" << guard.collection()->name()
+                  << "' failed: " << res.errorMessage();
+            }
+          } catch (basics::Exception const& ex) {
+            if (ex.code() != TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND) {
+              LOG_TOPIC(WARN, Logger::ENGINES)
+                  << "analyzing collection " << cid
+                  << " failed: " << ex.what();
+            }
+          }
+        }
+      });
+}
+
+/// @brief adjust the document counts of collections by the expired documents
+/// that compactions dropped since the last check. called right before the
+/// counters are synced, which persists the adjustments
+void RocksDBBackgroundThread::adjustExpiredCounts() {
+  for (auto const& it : RocksDBTtl::stealRemovals()) {
+    auto mapping = rocksutils::mapObjectToCollection(it.first);
+    if (mapping.first == 0 && mapping.second == 0) {
+      // collection has been dropped meanwhile
+      continue;
+    }
+    TRI_vocbase_t* vocbase =
+        DatabaseFeature::DATABASE->useDatabase(mapping.first);
+    if (vocbase == nullptr) {
+      continue;
+    }
+    TRI_DEFER(vocbase->release());
+
+    LogicalCollection* collection = vocbase->lookupCollection(mapping.second);
+    if (collection == nullptr) {
+      continue;
+    }
+    auto physical = toRocksDBCollection(collection);
+    uint64_t removed = it.second;
+    if (removed > physical->numberDocuments()) {
+      // only live documents are counted, so this happens only if a failed
+      // compaction counted some of them before
+      LOG_TOPIC(WARN, Logger::ENGINES)
+          << "compactions dropped " << removed
+          << " expired documents from collection '" << collection->name()
+          << "', which has only " << physical->numberDocuments();
+      removed = physical->numberDocuments();
+    }
+    physical->adjustNumberDocuments(-static_cast<int64_t>(removed));
+    _engine->counterManager()->updateCounter(
+        it.first, RocksDBCounterManager::CounterAdjustment(0, 0, removed, 0));
+  }
+}
@@ -55,6 +55,10 @@ class RocksDBBackgroundThread : public Thread {
 
  protected:
   void run() override;
+
+ private:
+  void analyzeCollections();
+  void adjustExpiredCounts();
 };
 }  // namespace arangodb
 
@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_ROCKSDB_ROCKSDB_BLOOM_FILTER_H
+#define ARANGOD_ROCKSDB_ROCKSDB_BLOOM_FILTER_H 1
+
+#include "Basics/Common.h"
+
+#include <atomic>
+
+namespace arangodb {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief blocked bloom filter over 64 bit hashes. all bits of a value are
+/// within one 64 byte block, one bit in each word of the block, so a lookup
+/// touches a single cache line. the low bits of the hash select the block,
+/// the upper 32 bits select the bits within the block.
+///
+/// values can only be added. inserts and lookups may run concurrently, the
+/// filter must not be destroyed or replaced while they do. the number of
+/// blocks is a power of two, so a filter can be grown without the original
+/// values: every block of the grown filter starts as a copy of the block its
+/// values were in before.
+////////////////////////////////////////////////////////////////////////////////
+
+class RocksDBBloomFilter {
+ public:
+  static constexpr size_t WordsPerBlock = 8;
+  static constexpr size_t BitsPerValue = 10;
+
+  /// @brief create a filter for about the given number of values
+  explicit RocksDBBloomFilter(uint64_t numValues)
+      : _numBlocks(1), _numInserted(0) {
+    uint64_t const bitsPerBlock = WordsPerBlock * 64;
+    while (_numBlocks * bitsPerBlock < numValues * BitsPerValue) {
+      _numBlocks <<= 1;
+    }
+    allocate();
+  }
+
+  RocksDBBloomFilter(RocksDBBloomFilter const&) = delete;
+  RocksDBBloomFilter& operator=(RocksDBBloomFilter const&) = delete;
+
+ public:
+  void insert(uint64_t hash) {
+    std::atomic<uint64_t>* block = blockFor(hash);
+    uint32_t const h = static_cast<uint32_t>(hash >> 32);
+    for (size_t i = 0; i < WordsPerBlock; ++i) {
+      block[i].fetch_or(mask(h, i), std::memory_order_relaxed);
+    }
+    _numInserted.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// @brief returns false if the value was definitely never inserted
+  bool mayContain(uint64_t hash) const {
+    std::atomic<uint64_t> const* block = blockFor(hash);
+    uint32_t const h = static_cast<uint32_t>(hash >> 32);
+    for (size_t i = 0; i < WordsPerBlock; ++i) {
+      uint64_t const m = mask(h, i);
+      if ((block[i].load(std::memory_order_relaxed) & m) != m) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// @brief number of values the filter holds at its intended false
+  /// positive rate of about one percent
+  uint64_t capacity() const {
+    return _numBlocks * WordsPerBlock * 64 / BitsPerValue;
+  }
+
+  /// @brief whether the false positive rate is above the intended one
+  bool isFull() const {
+    return _numInserted.load(std::memory_order_relaxed) > capacity();
+  }
+
+  size_t memoryUsage() const {
+    return static_cast<size_t>(_numBlocks * WordsPerBlock * sizeof(uint64_t));
+  }
+
+  /// @brief returns a filter with twice the capacity that answers
+  /// mayContain() with true for all values inserted into this one
+  std::unique_ptr<RocksDBBloomFilter> grow() const {
+    std::unique_ptr<RocksDBBloomFilter> grown(
+        new RocksDBBloomFilter(_numBlocks << 1, true));
+
+    for (uint64_t b = 0; b < grown->_numBlocks; ++b) {
+      std::atomic<uint64_t> const* from =
+          _words.get() + (b & (_numBlocks - 1)) * WordsPerBlock;
+      std::atomic<uint64_t>* to = grown->_words.get() + b * WordsPerBlock;
+      for (size_t i = 0; i < WordsPerBlock; ++i) {
+        to[i].store(from[i].load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+      }
+    }
+    grown->_numInserted.store(_numInserted.load(std::memory_order_relaxed));
+    return grown;
+  }
+
+ private:
+  RocksDBBloomFilter(uint64_t numBlocks, bool)
+      : _numBlocks(numBlocks), _numInserted(0) {
+    allocate();
+  }
+
+  void allocate() {
+    size_t const n = static_cast<size_t>(_numBlocks * WordsPerBlock);
+    _words.reset(new std::atomic<uint64_t>[n]);
+    for (size_t i = 0; i < n; ++i) {
+      _words[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  std::atomic<uint64_t>* blockFor(uint64_t hash) const {
+    return _words.get() + (hash & (_numBlocks - 1)) * WordsPerBlock;
+  }
+
+  static inline uint64_t mask(uint32_t h, size_t word) {
+    // odd multipliers, each maps the hash to another bit of its word
+    static uint32_t const salts[WordsPerBlock] = {
+        0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+        0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+    return uint64_t(1) << ((h * salts[word]) >> 26);
+  }
+
+ private:
+  uint64_t _numBlocks;
+  std::unique_ptr<std::atomic<uint64_t>[]> _words;
+  std::atomic<uint64_t> _numInserted;
+};
+
+}  // namespace arangodb
+
+#endif
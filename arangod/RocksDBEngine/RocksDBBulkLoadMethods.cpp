@@ -0,0 +1,620 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RocksDBBulkLoadMethods.h"
+#include "Basics/Exceptions.h"
+#include "Basics/VelocyPackHelper.h"
+#include "Basics/files.h"
+#include "Cluster/FollowerInfo.h"
+#include "Logger/Logger.h"
+#include "RocksDBEngine/RocksDBCollection.h"
+#include "RocksDBEngine/RocksDBColumnFamily.h"
+#include "RocksDBEngine/RocksDBCommon.h"
+#include "RocksDBEngine/RocksDBIndex.h"
+#include "RocksDBEngine/RocksDBKey.h"
+#include "RocksDBEngine/RocksDBKeyBounds.h"
+#include "RocksDBEngine/RocksDBTransactionCollection.h"
+#include "RocksDBEngine/RocksDBTransactionState.h"
+#include "VocBase/LogicalCollection.h"
+#include "VocBase/vocbase.h"
+
+#include <rocksdb/db.h>
+#include <rocksdb/env.h>
+#include <rocksdb/options.h>
+#include <rocksdb/sst_file_writer.h>
+#include <rocksdb/utilities/transaction_db.h>
+
+#include <velocypack/Builder.h>
+#include <velocypack/Iterator.h>
+#include <velocypack/velocypack-aliases.h>
+
+#include <queue>
+
+using namespace arangodb;
+
+namespace {
+
+/// @brief approximate bookkeeping overhead of a buffered entry
+constexpr size_t EntryOverhead = 64;
+
+/// @brief sequential reader for a sorted run file, which consists of
+/// entries of the form <key length> <value length> <key> <value>
+class RunReader {
+ public:
+  explicit RunReader(std::string const& file) : _file(file) {}
+
+  Result open() {
+    return rocksutils::convertStatus(rocksdb::Env::Default()->NewSequentialFile(
+        _file, &_input, rocksdb::EnvOptions()));
+  }
+
+  /// @brief read the next entry, returns false at the end of the run or
+  /// on error
+  bool next() {
+    char header[2 * sizeof(uint32_t)];
+    rocksdb::Slice slice;
+    if (!read(sizeof(header), slice, header) || slice.empty()) {
+      return false;
+    }
+    if (slice.size() != sizeof(header)) {
+      _status = Result(TRI_ERROR_INTERNAL, "truncated bulk load run file");
+      return false;
+    }
+    _key.resize(rocksutils::uint32FromPersistent(slice.data()));
+    _value.resize(
+        rocksutils::uint32FromPersistent(slice.data() + sizeof(uint32_t)));
+    return readInto(_key) && readInto(_value);
+  }
+
+  Result const& status() const { return _status; }
+  rocksdb::Slice key() const { return rocksdb::Slice(_key); }
+  rocksdb::Slice value() const { return rocksdb::Slice(_value); }
+
+ private:
+  bool read(size_t n, rocksdb::Slice& slice, char* scratch) {
+    rocksdb::Status s = _input->Read(n, &slice, scratch);
+    if (!s.ok()) {
+      _status = rocksutils::convertStatus(s);
+      return false;
+    }
+    return true;
+  }
+
+  bool readInto(std::string& out) {
+    if (out.empty()) {
+      return true;
+    }
+    rocksdb::Slice slice;
+    if (!read(out.size(), slice, &out[0])) {
+      return false;
+    }
+    if (slice.size() != out.size()) {
+      _status = Result(TRI_ERROR_INTERNAL, "truncated bulk load run file");
+      return false;
+    }
+    if (slice.data() != out.data()) {
+      out.assign(slice.data(), slice.size());
+    }
+    return true;
+  }
+
+ private:
+  std::string const _file;
+  std::unique_ptr<rocksdb::SequentialFile> _input;
+  std::string _key;
+  std::string _value;
+  Result _status;
+};
+
+/// @brief add an entry to an SST file. keys of the loaded documents and of
+/// non-unique index entries are unique by construction, so an equal key
+/// can only stem from a unique constraint violation within the load
+static Result AddToSstFile(rocksdb::SstFileWriter& writer,
+                           rocksdb::Comparator const* cmp,
+                           rocksdb::Slice const& key,
+                           rocksdb::Slice const& value, std::string& lastKey,
+                           bool& first) {
+  if (!first && cmp->Compare(key, rocksdb::Slice(lastKey)) == 0) {
+    return Result(TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED,
+                  "duplicate key in bulk load");
+  }
+  first = false;
+  lastKey.assign(key.data(), key.size());
+  return rocksutils::convertStatus(writer.Put(key, value));
+}
+
+}  // namespace
+
+RocksDBBulkLoadMethods::RocksDBBulkLoadMethods(RocksDBTransactionState* state,
+                                               std::string const& path,
+                                               size_t memoryLimit)
+    : RocksDBMethods(state),
+      _db(rocksutils::globalRocksDB()),
+      _path(path),
+      _memoryLimit(memoryLimit),
+      _memoryUsed(0),
+      _fileCounter(0),
+      _savePointMemory(0),
+      _keepPath(false) {
+  long systemError;
+  std::string errorMessage;
+  int res = TRI_CreateRecursiveDirectory(_path.c_str(), systemError,
+                                         errorMessage);
+  if (res != TRI_ERROR_NO_ERROR) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(
+        res, "cannot create bulk load directory '" + _path +
+                 "': " + errorMessage);
+  }
+}
+
+RocksDBBulkLoadMethods::~RocksDBBulkLoadMethods() {
+  if (_keepPath) {
+    return;
+  }
+  // ingested SST files have been moved into the database already, so this
+  // only removes leftovers of an aborted load and the marker of a finished
+  // ingest. the transaction has persisted its counters at this point
+  int res = TRI_RemoveDirectory(_path.c_str());
+  if (res != TRI_ERROR_NO_ERROR) {
+    LOG_TOPIC(WARN, Logger::ENGINES)
+        << "cannot remove bulk load directory '" << _path
+        << "': " << TRI_errno_string(res);
+  }
+}
+
+bool RocksDBBulkLoadMethods::Exists(rocksdb::ColumnFamilyHandle* cf,
+                                    RocksDBKey const& key) {
+  TRI_ASSERT(cf != nullptr);
+  std::string val;  // do not care about value
+  bool mayExist =
+      _db->KeyMayExist(readOptions(), cf, key.string(), &val, nullptr);
+  if (mayExist) {
+    rocksdb::Status s = _db->Get(readOptions(), cf, key.string(), &val);
+    return !s.IsNotFound();
+  }
+  return false;
+}
+
+arangodb::Result RocksDBBulkLoadMethods::Get(rocksdb::ColumnFamilyHandle* cf,
+                                             RocksDBKey const& key,
+                                             std::string* val) {
+  TRI_ASSERT(cf != nullptr);
+  rocksdb::Status s = _db->Get(readOptions(), cf, key.string(), val);
+  return s.ok() ? arangodb::Result() : rocksutils::convertStatus(s);
+}
+
+arangodb::Result RocksDBBulkLoadMethods::Put(rocksdb::ColumnFamilyHandle* cf,
+                                             RocksDBKey const& key,
+                                             rocksdb::Slice const& val,
+                                             rocksutils::StatusHint) {
+  TRI_ASSERT(cf != nullptr);
+  if (cf == RocksDBColumnFamily::geo() ||
+      cf == RocksDBColumnFamily::fulltext()) {
+    // these indexes read back their own entries while inserting
+    return Result(TRI_ERROR_NOT_IMPLEMENTED,
+                  "bulk load does not support geo and fulltext indexes");
+  }
+  _memoryUsed += key.string().size() + val.size() + EntryOverhead;
+  _buffers[cf].entries.emplace_back(key.string(), val.ToString());
+  return Result();
+}
+
+arangodb::Result RocksDBBulkLoadMethods::Delete(rocksdb::ColumnFamilyHandle*,
+                                                RocksDBKey const&) {
+  return Result(TRI_ERROR_NOT_IMPLEMENTED,
+                "bulk load only supports inserting documents");
+}
+
+std::unique_ptr<rocksdb::Iterator> RocksDBBulkLoadMethods::NewIterator(
+    rocksdb::ReadOptions const& opts, rocksdb::ColumnFamilyHandle* cf) {
+  TRI_ASSERT(cf != nullptr);
+  return std::unique_ptr<rocksdb::Iterator>(_db->NewIterator(opts, cf));
+}
+
+void RocksDBBulkLoadMethods::SetSavePoint() {
+  // save points are set between operations, so this is the place to spill
+  // the buffered entries without splitting an operation
+  if (_memoryUsed > _memoryLimit) {
+    Result res = spill();
+    if (res.fail()) {
+      THROW_ARANGO_EXCEPTION(res);
+    }
+  }
+  _savePoint.clear();
+  for (auto const& it : _buffers) {
+    _savePoint.emplace(it.first, it.second.entries.size());
+  }
+  _savePointMemory = _memoryUsed;
+}
+
+arangodb::Result RocksDBBulkLoadMethods::RollbackToSavePoint() {
+  for (auto& it : _buffers) {
+    auto sp = _savePoint.find(it.first);
+    size_t keep = (sp == _savePoint.end()) ? 0 : sp->second;
+    TRI_ASSERT(keep <= it.second.entries.size());
+    it.second.entries.resize(keep);
+  }
+  _memoryUsed = _savePointMemory;
+  return Result();
+}
+
+arangodb::Result RocksDBBulkLoadMethods::ingest() {
+  // build the SST files of all column families before ingesting any of
+  // them, so that a unique constraint violation leaves nothing behind
+  std::vector<std::pair<rocksdb::ColumnFamilyHandle*, std::string>> files;
+  for (auto& it : _buffers) {
+    std::string file;
+    Result res = writeSstFile(it.first, it.second, file);
+    if (res.fail()) {
+      return res;
+    }
+    if (!file.empty()) {
+      files.emplace_back(it.first, file);
+    }
+  }
+  _buffers.clear();
+  _memoryUsed = 0;
+
+  // rocksdb ingests the files of one column family at a time. the index
+  // entries go first, the documents last, so the documents only become
+  // visible once all of their index entries are in place
+  std::stable_partition(
+      files.begin(), files.end(),
+      [](std::pair<rocksdb::ColumnFamilyHandle*, std::string> const& file) {
+        return !RocksDBColumnFamily::isDocuments(file.first->GetID());
+      });
+
+  Result res = writeMarker("ingesting");
+  if (res.fail()) {
+    return res;
+  }
+
+  rocksdb::IngestExternalFileOptions options;
+  options.move_files = true;
+  for (auto const& it : files) {
+    rocksdb::Status s = _db->IngestExternalFile(
+        it.first, std::vector<std::string>{it.second}, options);
+    if (!s.ok()) {
+      LOG_TOPIC(ERR, Logger::ENGINES)
+          << "ingesting bulk load file '" << it.second
+          << "' failed: " << s.ToString();
+      res = rocksutils::convertStatus(s);
+      break;
+    }
+  }
+
+  if (res.fail()) {
+    // the collections were empty before, so removing all of their data
+    // undoes the files ingested so far
+    bool removed = true;
+    _state->allCollections([&removed](TransactionCollection* trxColl) {
+      Result r = removeLoadedData(trxColl->collection());
+      if (r.fail()) {
+        LOG_TOPIC(ERR, Logger::ENGINES)
+            << "cannot remove partially bulk loaded data of collection '"
+            << trxColl->collection()->name() << "': " << r.errorMessage();
+        removed = false;
+      }
+      return true;
+    });
+    if (!removed) {
+      // leave the marker in place, the next start removes the data
+      _keepPath = true;
+    }
+    return res;
+  }
+
+  // the counters are persisted after the ingest. until the marker is
+  // removed with the directory, a restart recounts the documents
+  return writeMarker("ingested");
+}
+
+arangodb::Result RocksDBBulkLoadMethods::checkPreconditions(
+    RocksDBTransactionState* state) {
+  TRI_vocbase_t* vocbase = state->vocbase();
+  // clients tailing the WAL of the database within their ttl
+  size_t const replicationClients = vocbase->getReplicationClients().size();
+
+  Result res;
+  state->allCollections([&](TransactionCollection* trxColl) {
+    LogicalCollection* collection = trxColl->collection();
+    RocksDBCollection* physical =
+        static_cast<RocksDBCollection*>(collection->getPhysical());
+    bool const exclusive = AccessMode::isExclusive(
+        static_cast<RocksDBTransactionCollection*>(trxColl)->accessType());
+
+    size_t followers = 0;
+    auto const& followerInfo = collection->followers();
+    if (followerInfo != nullptr) {
+      followers = followerInfo->get()->size();
+    }
+
+    res = checkCollection(collection->name(), exclusive,
+                          physical->numberDocuments(), followers,
+                          replicationClients);
+    return res.ok();
+  });
+  return res;
+}
+
+arangodb::Result RocksDBBulkLoadMethods::checkCollection(
+    std::string const& name, bool exclusive, uint64_t numberDocuments,
+    size_t numberFollowers, size_t numberReplicationClients) {
+  if (!exclusive) {
+    return Result(TRI_ERROR_BAD_PARAMETER,
+                  "bulk load into collection '" + name +
+                      "' requires an exclusive lock");
+  }
+  if (numberDocuments != 0) {
+    // the data is ingested without checking the existing documents
+    return Result(TRI_ERROR_BAD_PARAMETER,
+                  "bulk load requires collection '" + name + "' to be empty");
+  }
+  if (numberFollowers != 0 || numberReplicationClients != 0) {
+    // followers and replication clients only see what is in the WAL
+    return Result(TRI_ERROR_BAD_PARAMETER,
+                  "bulk load into collection '" + name +
+                      "' is not possible while it is replicated");
+  }
+  return Result();
+}
+
+std::string const RocksDBBulkLoadMethods::markerFile("ingest.json");
+
+RocksDBBulkLoadMethods::Recovery RocksDBBulkLoadMethods::recoveryAction(
+    VPackSlice marker) {
+  if (!marker.isObject()) {
+    return Recovery::NONE;
+  }
+  VPackSlice state = marker.get("state");
+  if (state.isString()) {
+    if (state.copyString() == "ingesting") {
+      return Recovery::REMOVE;
+    }
+    if (state.copyString() == "ingested") {
+      return Recovery::RECOUNT;
+    }
+  }
+  return Recovery::NONE;
+}
+
+void RocksDBBulkLoadMethods::recover(TRI_vocbase_t* vocbase,
+                                     VPackSlice marker) {
+  Recovery action = recoveryAction(marker);
+  VPackSlice collections = marker.get("collections");
+  if (action == Recovery::NONE || !collections.isArray()) {
+    return;
+  }
+
+  for (auto const& it : VPackArrayIterator(collections)) {
+    TRI_voc_cid_t cid = basics::VelocyPackHelper::stringUInt64(it);
+    LogicalCollection* collection = vocbase->lookupCollection(cid);
+    if (collection == nullptr) {
+      // dropped in the meantime
+      continue;
+    }
+
+    if (action == Recovery::REMOVE) {
+      LOG_TOPIC(WARN, Logger::ENGINES)
+          << "removing the data of an interrupted bulk load into collection '"
+          << collection->name() << "'";
+      Result res = removeLoadedData(collection);
+      if (res.fail()) {
+        LOG_TOPIC(ERR, Logger::ENGINES)
+            << "cannot remove data of interrupted bulk load into collection '"
+            << collection->name() << "': " << res.errorMessage();
+      }
+    }
+    static_cast<RocksDBCollection*>(collection->getPhysical())
+        ->recalculateCounts();
+  }
+}
+
+arangodb::Result RocksDBBulkLoadMethods::writeMarker(char const* state) {
+  VPackBuilder builder;
+  builder.openObject();
+  builder.add("database", VPackValue(std::to_string(_state->vocbase()->id())));
+  builder.add("collections", VPackValue(VPackValueType::Array));
+  _state->allCollections([&builder](TransactionCollection* trxColl) {
+    builder.add(VPackValue(std::to_string(trxColl->id())));
+    return true;
+  });
+  builder.close();
+  builder.add("state", VPackValue(state));
+  builder.close();
+
+  std::string const file = _path + TRI_DIR_SEPARATOR_STR + markerFile;
+  if (!basics::VelocyPackHelper::velocyPackToFile(file, builder.slice(),
+                                                  true)) {
+    return Result(TRI_ERROR_CANNOT_WRITE_FILE,
+                  "cannot write bulk load marker '" + file + "'");
+  }
+  return Result();
+}
+
+arangodb::Result RocksDBBulkLoadMethods::removeLoadedData(
+    LogicalCollection* collection) {
+  RocksDBCollection* physical =
+      static_cast<RocksDBCollection*>(collection->getPhysical());
+  Result res = rocksutils::removeLargeRange(
+      rocksutils::globalRocksDB(),
+      RocksDBKeyBounds::CollectionDocuments(physical->objectId()));
+
+  for (auto const& index : collection->getIndexes()) {
+    RocksDBIndex* rindex = static_cast<RocksDBIndex*>(index.get());
+    // edge index ranges must be removed without prefix iteration
+    bool const prefixSameAsStart =
+        index->type() != Index::TRI_IDX_TYPE_EDGE_INDEX;
+    Result r = rocksutils::removeLargeRange(
+        rocksutils::globalRocksDB(), rindex->getBounds(), prefixSameAsStart);
+    if (r.fail() && res.ok()) {
+      res = r;
+    }
+  }
+  return res;
+}
+
+std::string RocksDBBulkLoadMethods::nextFileName(char const* suffix) {
+  return _path + TRI_DIR_SEPARATOR_STR + std::to_string(++_fileCounter) +
+         suffix;
+}
+
+void RocksDBBulkLoadMethods::sortEntries(rocksdb::ColumnFamilyHandle* cf,
+                                         Buffer& buffer) {
+  rocksdb::Comparator const* cmp = cf->GetComparator();
+  std::sort(buffer.entries.begin(), buffer.entries.end(),
+            [cmp](Entry const& lhs, Entry const& rhs) {
+              return cmp->Compare(rocksdb::Slice(lhs.first),
+                                  rocksdb::Slice(rhs.first)) < 0;
+            });
+}
+
+arangodb::Result RocksDBBulkLoadMethods::spill() {
+  for (auto& it : _buffers) {
+    if (!it.second.entries.empty()) {
+      Result res = writeRun(it.first, it.second);
+      if (res.fail()) {
+        return res;
+      }
+    }
+  }
+  _memoryUsed = 0;
+  return Result();
+}
+
+arangodb::Result RocksDBBulkLoadMethods::writeRun(
+    rocksdb::ColumnFamilyHandle* cf, Buffer& buffer) {
+  sortEntries(cf, buffer);
+
+  std::string file = nextFileName(".run");
+  std::unique_ptr<rocksdb::WritableFile> output;
+  rocksdb::Status s = rocksdb::Env::Default()->NewWritableFile(
+      file, &output, rocksdb::EnvOptions());
+
+  char header[2 * sizeof(uint32_t)];
+  for (auto const& entry : buffer.entries) {
+    if (!s.ok()) {
+      break;
+    }
+    rocksutils::uint32ToPersistent(header,
+                                   static_cast<uint32_t>(entry.first.size()));
+    rocksutils::uint32ToPersistent(header + sizeof(uint32_t),
+                                   static_cast<uint32_t>(entry.second.size()));
+    s = output->Append(rocksdb::Slice(header, sizeof(header)));
+    if (s.ok()) {
+      s = output->Append(rocksdb::Slice(entry.first));
+    }
+    if (s.ok()) {
+      s = output->Append(rocksdb::Slice(entry.second));
+    }
+  }
+  if (s.ok()) {
+    s = output->Close();
+  }
+  if (!s.ok()) {
+    return rocksutils::convertStatus(s);
+  }
+
+  buffer.runs.emplace_back(std::move(file));
+  buffer.entries.clear();
+  buffer.entries.shrink_to_fit();
+  return Result();
+}
+
+arangodb::Result RocksDBBulkLoadMethods::writeSstFile(
+    rocksdb::ColumnFamilyHandle* cf, Buffer& buffer, std::string& file) {
+  if (buffer.entries.empty() && buffer.runs.empty()) {
+    return Result();
+  }
+
+  rocksdb::Comparator const* cmp = cf->GetComparator();
+  rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), _db->GetOptions(cf),
+                                cf);
+  file = nextFileName(".sst");
+  Result res = rocksutils::convertStatus(writer.Open(file));
+  if (res.fail()) {
+    return res;
+  }
+
+  std::string lastKey;
+  bool first = true;
+  if (buffer.runs.empty()) {
+    // everything fits into memory
+    sortEntries(cf, buffer);
+    for (auto const& entry : buffer.entries) {
+      res = AddToSstFile(writer, cmp, rocksdb::Slice(entry.first),
+                         rocksdb::Slice(entry.second), lastKey, first);
+      if (res.fail()) {
+        return res;
+      }
+    }
+  } else {
+    if (!buffer.entries.empty()) {
+      res = writeRun(cf, buffer);
+      if (res.fail()) {
+        return res;
+      }
+    }
+
+    // merge all sorted runs
+    std::vector<std::unique_ptr<RunReader>> readers;
+    auto greater = [cmp, &readers](size_t lhs, size_t rhs) {
+      return cmp->Compare(readers[lhs]->key(), readers[rhs]->key()) > 0;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(
+        greater);
+    for (auto const& run : buffer.runs) {
+      readers.emplace_back(new RunReader(run));
+      res = readers.back()->open();
+      if (res.fail()) {
+        return res;
+      }
+      if (readers.back()->next()) {
+        heap.push(readers.size() - 1);
+      } else if (readers.back()->status().fail()) {
+        return readers.back()->status();
+      }
+    }
+
+    while (!heap.empty()) {
+      size_t i = heap.top();
+      heap.pop();
+      RunReader* reader = readers[i].get();
+      res = AddToSstFile(writer, cmp, reader->key(), reader->value(), lastKey,
+                         first);
+      if (res.fail()) {
+        return res;
+      }
+      if (reader->next()) {
+        heap.push(i);
+      } else if (reader->status().fail()) {
+        return reader->status();
+      }
+    }
+
+    for (auto const& run : buffer.runs) {
+      TRI_UnlinkFile(run.c_str());
+    }
+    buffer.runs.clear();
+  }
+
+  return rocksutils::convertStatus(writer.Finish());
+}
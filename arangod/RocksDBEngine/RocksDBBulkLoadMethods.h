@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_ROCKSDB_ENGINE_BULK_LOAD_METHODS_H
+#define ARANGOD_ROCKSDB_ENGINE_BULK_LOAD_METHODS_H 1
+
+#include "Basics/Common.h"
+#include "RocksDBEngine/RocksDBMethods.h"
+
+#include <velocypack/Slice.h>
+
+struct TRI_vocbase_t;
+
+namespace arangodb {
+class LogicalCollection;
+
+/// @brief collects all writes of a bulk load instead of writing them to a
+/// rocksdb transaction. the writes are sorted per column family, spilled to
+/// temporary run files when they exceed the memory limit, and in the end
+/// merged into SST files that are ingested directly, bypassing WAL and
+/// memtables. lookups only see data committed before the bulk load, so
+/// duplicate keys within the loaded data are detected while merging. bulk
+/// loads are limited to empty collections, which makes removing all their
+/// data a complete rollback
+class RocksDBBulkLoadMethods final : public RocksDBMethods {
+ public:
+  RocksDBBulkLoadMethods(RocksDBTransactionState*, std::string const& path,
+                         size_t memoryLimit);
+  ~RocksDBBulkLoadMethods();
+
+  bool Exists(rocksdb::ColumnFamilyHandle*, RocksDBKey const&) override;
+  arangodb::Result Get(rocksdb::ColumnFamilyHandle*, RocksDBKey const& key,
+                       std::string* val) override;
+  arangodb::Result Put(
+      rocksdb::ColumnFamilyHandle*, RocksDBKey const& key,
+      rocksdb::Slice const& val,
+      rocksutils::StatusHint hint = rocksutils::StatusHint::none) override;
+  arangodb::Result Delete(rocksdb::ColumnFamilyHandle*,
+                          RocksDBKey const& key) override;
+  std::unique_ptr<rocksdb::Iterator> NewIterator(
+      rocksdb::ReadOptions const&, rocksdb::ColumnFamilyHandle*) override;
+
+  void SetSavePoint() override;
+  arangodb::Result RollbackToSavePoint() override;
+
+  /// @brief write all collected data into SST files and ingest them. the
+  /// documents are ingested last, and a failed ingest removes everything
+  /// ingested before. a marker file records the ingest until the
+  /// transaction is done, so that a crash in between can be repaired
+  arangodb::Result ingest();
+
+  /// @brief whether a transaction may bulk load. all its collections must
+  /// be empty and locked exclusively, and nobody may follow their changes,
+  /// because the loaded data never goes through the WAL
+  static arangodb::Result checkPreconditions(RocksDBTransactionState*);
+
+  /// @brief the checks of checkPreconditions for one collection
+  static arangodb::Result checkCollection(std::string const& name,
+                                          bool exclusive,
+                                          uint64_t numberDocuments,
+                                          size_t numberFollowers,
+                                          size_t numberReplicationClients);
+
+  /// @brief name of the marker file in the directory of a bulk load
+  static std::string const markerFile;
+
+  /// @brief repair of a load interrupted by a crash
+  enum class Recovery {
+    NONE,
+    REMOVE,  // ingest did not finish, remove all loaded data
+    RECOUNT  // ingest finished, the counters may not have been persisted
+  };
+
+  /// @brief repair needed for a load, according to its marker
+  static Recovery recoveryAction(arangodb::velocypack::Slice marker);
+
+  /// @brief repair a load interrupted by a crash, the marker belongs to
+  /// the given database
+  static void recover(TRI_vocbase_t*, arangodb::velocypack::Slice marker);
+
+ private:
+  typedef std::pair<std::string, std::string> Entry;
+
+  struct Buffer {
+    std::vector<Entry> entries;
+    std::vector<std::string> runs;
+  };
+
+  std::string nextFileName(char const* suffix);
+  void sortEntries(rocksdb::ColumnFamilyHandle*, Buffer&);
+  arangodb::Result spill();
+  arangodb::Result writeRun(rocksdb::ColumnFamilyHandle*, Buffer&);
+  arangodb::Result writeSstFile(rocksdb::ColumnFamilyHandle*, Buffer&,
+                                std::string& file);
+  arangodb::Result writeMarker(char const* state);
+
+  /// @brief remove all documents and index entries of a collection
+  static arangodb::Result removeLoadedData(LogicalCollection*);
+
+ private:
+  rocksdb::TransactionDB* _db;
+  /// directory for run and SST files
+  std::string const _path;
+  size_t const _memoryLimit;
+  /// approximate memory used by the buffered entries
+  size_t _memoryUsed;
+  uint64_t _fileCounter;
+  std::unordered_map<rocksdb::ColumnFamilyHandle*, Buffer> _buffers;
+  /// number of buffered entries per column family at the last save point
+  std::unordered_map<rocksdb::ColumnFamilyHandle*, size_t> _savePoint;
+  size_t _savePointMemory;
+  /// keep the directory and its marker, for the repair on the next start
+  bool _keepPath;
+};
+
+}  // namespace arangodb
+
+#endif
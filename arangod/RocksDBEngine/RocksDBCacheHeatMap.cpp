@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RocksDBCacheHeatMap.h"
+#include "Basics/MutexLocker.h"
+#include "Cache/CacheManagerFeature.h"
+#include "Cache/Manager.h"
+#include "Cluster/ServerState.h"
+#include "Logger/Logger.h"
+#include "RestServer/DatabaseFeature.h"
+#include "RocksDBEngine/RocksDBCollection.h"
+#include "Scheduler/Scheduler.h"
+#include "Scheduler/SchedulerFeature.h"
+#include "VocBase/LogicalCollection.h"
+#include "VocBase/vocbase.h"
+
+using namespace arangodb;
+
+/// @brief maximum number of background jobs prefetching heat maps at the
+/// same time, so that the prefetching does not occupy the whole scheduler
+static constexpr size_t MaxPrefetchJobs = 4;
+
+static Mutex PendingLock;
+static std::vector<TRI_voc_tick_t> PendingDatabases;
+
+namespace {
+/// @brief collections left to prefetch, shared by the prefetch jobs
+struct PrefetchQueue {
+  Mutex lock;
+  std::deque<std::pair<TRI_voc_tick_t, TRI_voc_cid_t>> collections;
+  std::atomic<size_t> running{0};
+  std::atomic<size_t> prefetched{0};
+  double const start = TRI_microtime();
+};
+}  // namespace
+
+static size_t PrefetchCollection(TRI_voc_tick_t databaseId,
+                                 TRI_voc_cid_t cid) {
+  TRI_vocbase_t* vocbase = DatabaseFeature::DATABASE->useDatabase(databaseId);
+  if (vocbase == nullptr) {
+    return 0;
+  }
+  TRI_DEFER(vocbase->release());
+
+  LogicalCollection* collection = vocbase->lookupCollection(cid);
+  if (collection == nullptr || collection->deleted()) {
+    return 0;
+  }
+  return toRocksDBCollection(collection)->prefetchCacheHeatMap();
+}
+
+static void RunPrefetchJob(std::shared_ptr<PrefetchQueue> queue) {
+  while (true) {
+    std::pair<TRI_voc_tick_t, TRI_voc_cid_t> next;
+    {
+      MUTEX_LOCKER(guard, queue->lock);
+      if (queue->collections.empty()) {
+        break;
+      }
+      next = queue->collections.front();
+      queue->collections.pop_front();
+    }
+    try {
+      queue->prefetched += PrefetchCollection(next.first, next.second);
+    } catch (std::exception const& ex) {
+      LOG_TOPIC(WARN, Logger::ENGINES)
+          << "prefetching cache heat map failed: " << ex.what();
+    } catch (...) {
+      LOG_TOPIC(WARN, Logger::ENGINES) << "prefetching cache heat map failed";
+    }
+  }
+
+  if (--queue->running == 0) {
+    LOG_TOPIC(INFO, Logger::ENGINES)
+        << "prefetched " << queue->prefetched.load()
+        << " hot cache keys in " << (TRI_microtime() - queue->start) << " s";
+  }
+}
+
+void RocksDBCacheHeatMap::persist() {
+  if (CacheManagerFeature::MANAGER == nullptr ||
+      DatabaseFeature::DATABASE == nullptr ||
+      ServerState::instance()->isCoordinator()) {
+    return;
+  }
+
+  // the shared pointers keep the caches alive while we use their addresses
+  auto frequencies = CacheManagerFeature::MANAGER->accessFrequencies();
+  std::unordered_map<cache::Cache const*, uint64_t> accesses;
+  uint64_t totalAccesses = 0;
+  for (auto const& it : frequencies) {
+    accesses[it.first.get()] += it.second;
+    totalAccesses += it.second;
+  }
+  if (totalAccesses == 0) {
+    // keep the heat maps of an idle server
+    return;
+  }
+
+  DatabaseFeature::DATABASE->enumerateDatabases(
+      [&accesses, totalAccesses](TRI_vocbase_t* vocbase) {
+        for (auto* collection : vocbase->collections(false)) {
+          toRocksDBCollection(collection)
+              ->serializeCacheHeatMap(accesses, totalAccesses);
+        }
+      });
+}
+
+void RocksDBCacheHeatMap::schedulePrefetch(TRI_voc_tick_t databaseId) {
+  if (ServerState::instance()->isCoordinator()) {
+    return;
+  }
+  MUTEX_LOCKER(guard, PendingLock);
+  PendingDatabases.emplace_back(databaseId);
+}
+
+void RocksDBCacheHeatMap::startPrefetches() {
+  if (SchedulerFeature::SCHEDULER == nullptr ||
+      DatabaseFeature::DATABASE == nullptr) {
+    // try again later
+    return;
+  }
+
+  std::vector<TRI_voc_tick_t> databases;
+  {
+    MUTEX_LOCKER(guard, PendingLock);
+    if (PendingDatabases.empty()) {
+      return;
+    }
+    databases.swap(PendingDatabases);
+  }
+
+  auto queue = std::make_shared<PrefetchQueue>();
+  for (auto const& databaseId : databases) {
+    TRI_vocbase_t* vocbase =
+        DatabaseFeature::DATABASE->useDatabase(databaseId);
+    if (vocbase == nullptr) {
+      continue;
+    }
+    TRI_DEFER(vocbase->release());
+    for (auto* collection : vocbase->collections(false)) {
+      queue->collections.emplace_back(databaseId, collection->cid());
+    }
+  }
+
+  size_t const jobs = (std::min)(MaxPrefetchJobs, queue->collections.size());
+  queue->running = jobs;
+  for (size_t i = 0; i < jobs; ++i) {
+    try {
+      SchedulerFeature::SCHEDULER->post([queue]() { RunPrefetchJob(queue); });
+    } catch (...) {
+      // run the job on this thread instead
+      RunPrefetchJob(queue);
+    }
+  }
+}
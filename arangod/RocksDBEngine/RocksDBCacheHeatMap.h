@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_ROCKSDB_ENGINE_ROCKSDB_CACHE_HEAT_MAP_H
+#define ARANGOD_ROCKSDB_ENGINE_ROCKSDB_CACHE_HEAT_MAP_H 1
+
+#include "Basics/Common.h"
+#include "VocBase/voc-types.h"
+
+namespace arangodb {
+
+/// @brief persists a sample of the hottest keys of the document and index
+/// caches, so that after a restart the caches can be filled with just these
+/// keys instead of scanning whole collections and indexes
+struct RocksDBCacheHeatMap {
+  /// @brief persist the hot keys of all caches. the keys are distributed
+  /// among the caches by the recent accesses the cache manager recorded
+  static void persist();
+
+  /// @brief schedule prefetching the heat maps of the collections of a
+  /// database, which happens once the scheduler is running
+  static void schedulePrefetch(TRI_voc_tick_t databaseId);
+
+  /// @brief start background jobs that prefetch the heat maps of the
+  /// scheduled databases' collections in parallel
+  static void startPrefetches();
+};
+
+}  // namespace arangodb
+
+#endif
@@ -22,6 +22,8 @@
 
 #include "RocksDBCollection.h"
 #include "Aql/PlanCache.h"
+#include "Basics/LocalTaskQueue.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/ReadLocker.h"
 #include "Basics/Result.h"
 #include "Basics/StaticStrings.h"
@@ -36,11 +38,14 @@
 #include "Cluster/CollectionLockState.h"
 #include "Indexes/Index.h"
 #include "Indexes/IndexIterator.h"
+#include "Random/RandomGenerator.h"
 #include "RestServer/DatabaseFeature.h"
 #include "RocksDBEngine/RocksDBCommon.h"
 #include "RocksDBEngine/RocksDBComparator.h"
 #include "RocksDBEngine/RocksDBCounterManager.h"
 #include "RocksDBEngine/RocksDBEngine.h"
+#include "RocksDBEngine/RocksDBGeoIndex.h"
+#include "RocksDBEngine/RocksDBIndexBuilder.h"
 #include "RocksDBEngine/RocksDBIterators.h"
 #include "RocksDBEngine/RocksDBKey.h"
 #include "RocksDBEngine/RocksDBLogValue.h"
@@ -59,6 +64,7 @@
 #include "Utils/Events.h"
 #include "Utils/OperationOptions.h"
 #include "Utils/SingleCollectionTransaction.h"
+#include "VocBase/AttributeStatistics.h"
 #include "VocBase/KeyGenerator.h"
 #include "VocBase/LogicalCollection.h"
 #include "VocBase/ticks.h"
@@ -79,17 +85,99 @@ static std::string const Empty;
 
 }  // namespace
 
+/// @brief number of documents sampled when analyzing a collection
+static constexpr uint64_t AnalyzeSampleSize = 1000;
+
+/// @brief collections with fewer documents are not analyzed
+static constexpr uint64_t AnalyzeMinDocuments = 100;
+
+/// @brief relative change of the number of documents after which a
+/// collection is analyzed again
+static constexpr double AnalyzeChangeThreshold = 0.2;
+
+/// @brief maximum number of edge attributes the edge indexes may store
+/// inline
+static constexpr size_t MaxEdgeStoredValues = 8;
+
+/// @brief parses and validates the edge attributes the edge indexes of the
+/// collection store inline
+static std::vector<std::string> ParseEdgeStoredValues(
+    LogicalCollection const* collection, VPackSlice info) {
+  std::vector<std::string> result;
+  VPackSlice values = info.get("edgeStoredValues");
+  if (values.isNone() || values.isNull()) {
+    return result;
+  }
+  if (!values.isArray()) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_BAD_PARAMETER,
+                                   "edgeStoredValues must be an array");
+  }
+  if (values.length() > 0 && collection->type() != TRI_COL_TYPE_EDGE) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(
+        TRI_ERROR_BAD_PARAMETER,
+        "edgeStoredValues is only supported for edge collections");
+  }
+  if (values.length() > MaxEdgeStoredValues) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(
+        TRI_ERROR_BAD_PARAMETER,
+        "edgeStoredValues must not contain more than " +
+            std::to_string(MaxEdgeStoredValues) + " attributes");
+  }
+  for (auto const& it : VPackArrayIterator(values)) {
+    if (!it.isString() || it.getStringLength() == 0) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(
+          TRI_ERROR_BAD_PARAMETER,
+          "edgeStoredValues must only contain attribute names");
+    }
+    std::string name = it.copyString();
+    // _from and _to are always stored, the other system attributes never
+    if (name[0] == '_' || name.find('.') != std::string::npos) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(
+          TRI_ERROR_BAD_PARAMETER,
+          "edgeStoredValues must only contain top-level non-system "
+          "attributes");
+    }
+    if (std::find(result.begin(), result.end(), name) == result.end()) {
+      result.emplace_back(std::move(name));
+    }
+  }
+  return result;
+}
+
+/// @brief number of hot cache keys persisted in total, distributed among
+/// all caches by their share of the recent cache accesses
+static constexpr double HeatMapKeys = 65536.0;
+
+/// @brief minimum number of hot keys persisted for a cache that was
+/// accessed recently
+static constexpr size_t MinHeatMapKeysPerCache = 64;
+
+/// @brief maximum number of WAL catch ups of a background index build
+/// before writers are blocked for the final one
+static constexpr size_t MaxIndexCatchUpRounds = 8;
+
+/// @brief number of changes a WAL catch up may find so that the remaining
+/// ones can be applied while writers are blocked
+static constexpr uint64_t MaxLockedIndexCatchUpOperations = 10000;
+
 RocksDBCollection::RocksDBCollection(LogicalCollection* collection,
                                      VPackSlice const& info)
     : PhysicalCollection(collection, info),
       _objectId(basics::VelocyPackHelper::stringUInt64(info, "objectId")),
+      _dedicatedColumnFamily(basics::VelocyPackHelper::getBooleanValue(
+          info, "dedicatedColumnFamily", false)),
+      _expireAfter(basics::VelocyPackHelper::getNumericValue<uint64_t>(
+          info, "expireAfter", 0)),
+      _edgeStoredValues(ParseEdgeStoredValues(collection, info)),
+      _documentsCF(nullptr),
       _numberDocuments(0),
       _revisionId(0),
       _needToPersistIndexEstimates(false),
       _hasGeoIndex(false),
       _cache(nullptr),
       _cachePresent(false),
-      _useCache(false) {
+      _useCache(basics::VelocyPackHelper::getBooleanValue(
+          info, "cacheEnabled", false)) {
   
   VPackSlice s = info.get("isVolatile");
   if (s.isBoolean() && s.getBoolean()) {
@@ -97,6 +185,12 @@ RocksDBCollection::RocksDBCollection(LogicalCollection* collection,
           TRI_ERROR_BAD_PARAMETER,
           "volatile collections are unsupported in the RocksDB engine");
   }
+  if (_expireAfter > 0 &&
+      _logicalCollection->type() == TRI_COL_TYPE_EDGE) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(
+        TRI_ERROR_BAD_PARAMETER,
+        "expireAfter is unsupported for edge collections");
+  }
   addCollectionMapping(_objectId, _logicalCollection->vocbase()->id(),
                        _logicalCollection->cid());
   if (_useCache) {
@@ -108,13 +202,19 @@ RocksDBCollection::RocksDBCollection(LogicalCollection* collection,
                                      PhysicalCollection* physical)
     : PhysicalCollection(collection, VPackSlice::emptyObjectSlice()),
       _objectId(static_cast<RocksDBCollection*>(physical)->_objectId),
+      _dedicatedColumnFamily(
+          static_cast<RocksDBCollection*>(physical)->_dedicatedColumnFamily),
+      _expireAfter(static_cast<RocksDBCollection*>(physical)->_expireAfter),
+      _edgeStoredValues(
+          static_cast<RocksDBCollection*>(physical)->_edgeStoredValues),
+      _documentsCF(nullptr),
       _numberDocuments(0),
       _revisionId(0),
       _needToPersistIndexEstimates(false),
       _hasGeoIndex(false),
       _cache(nullptr),
       _cachePresent(false),
-      _useCache(false) {
+      _useCache(static_cast<RocksDBCollection*>(physical)->_useCache) {
   addCollectionMapping(_objectId, _logicalCollection->vocbase()->id(),
                        _logicalCollection->cid());
   if (_useCache) {
@@ -162,9 +262,41 @@ void RocksDBCollection::getPropertiesVPack(velocypack::Builder& result) const {
   // objectId might be undefined on the coordinator
   TRI_ASSERT(result.isOpenObject());
   result.add("objectId", VPackValue(std::to_string(_objectId)));
+  if (_dedicatedColumnFamily) {
+    result.add("dedicatedColumnFamily", VPackValue(true));
+  }
+  if (_expireAfter > 0) {
+    result.add("expireAfter", VPackValue(_expireAfter));
+  }
+  if (!_edgeStoredValues.empty()) {
+    result.add(VPackValue("edgeStoredValues"));
+    result.openArray();
+    for (auto const& it : _edgeStoredValues) {
+      result.add(VPackValue(it));
+    }
+    result.close();
+  }
+  result.add("cacheEnabled", VPackValue(_useCache));
   TRI_ASSERT(result.isOpenObject());
 }
 
+rocksdb::ColumnFamilyHandle* RocksDBCollection::documentsColumnFamily()
+    const {
+  if (!_dedicatedColumnFamily) {
+    return RocksDBColumnFamily::documents();
+  }
+  rocksdb::ColumnFamilyHandle* cf = _documentsCF.load();
+  if (cf == nullptr) {
+    cf = RocksDBColumnFamily::documents(_objectId);
+    if (cf == RocksDBColumnFamily::documents()) {
+      // not yet created
+      return cf;
+    }
+    _documentsCF.store(cf);
+  }
+  return cf;
+}
+
 void RocksDBCollection::getPropertiesVPackCoordinator(
     velocypack::Builder& result) const {
   getPropertiesVPack(result);
@@ -230,8 +362,10 @@ void RocksDBCollection::open(bool ignoreErrors) {
 
   READ_LOCKER(guard, _indexesLock);
   for (std::shared_ptr<Index> it : _indexes) {
-    if (it->type() == Index::TRI_IDX_TYPE_GEO1_INDEX ||
-        it->type() == Index::TRI_IDX_TYPE_GEO2_INDEX) {
+    if ((it->type() == Index::TRI_IDX_TYPE_GEO1_INDEX ||
+         it->type() == Index::TRI_IDX_TYPE_GEO2_INDEX) &&
+        !static_cast<RocksDBGeoIndex*>(it.get())->usesCells()) {
+      // only the pot based geo index needs exclusive writes
       _hasGeoIndex = true;
     }
   }
@@ -416,6 +550,16 @@ std::shared_ptr<Index> RocksDBCollection::lookupIndex(
 std::shared_ptr<Index> RocksDBCollection::createIndex(
     transaction::Methods* trx, arangodb::velocypack::Slice const& info,
     bool& created) {
+  if (basics::VelocyPackHelper::getBooleanValue(info, "inBackground",
+                                                false) &&
+      !ServerState::instance()->isCoordinator() &&
+      trx->state()->collection(_logicalCollection->cid(),
+                               AccessMode::Type::WRITE) == nullptr) {
+    // a transaction that may write already holds the collection lock,
+    // which the background build needs to acquire in the end
+    return createIndexInBackground(info, created);
+  }
+
   // prevent concurrent dropping
   bool isLocked =
       trx->isLocked(_logicalCollection, AccessMode::Type::EXCLUSIVE);
@@ -431,6 +575,14 @@ std::shared_ptr<Index> RocksDBCollection::createIndex(
     }
   }
 
+  if (_expireAfter > 0) {
+    // compactions drop expired documents without visiting their index
+    // entries, which only works for the primary index
+    THROW_ARANGO_EXCEPTION_MESSAGE(
+        TRI_ERROR_BAD_PARAMETER,
+        "secondary indexes are unsupported for collections with expireAfter");
+  }
+
   StorageEngine* engine = EngineSelectorFeature::ENGINE;
   IndexFactory const* idxFactory = engine->indexFactory();
   TRI_ASSERT(idxFactory != nullptr);
@@ -456,6 +608,15 @@ std::shared_ptr<Index> RocksDBCollection::createIndex(
     THROW_ARANGO_EXCEPTION(res);
   }
 
+  res = publishIndex(idx);
+  if (res != TRI_ERROR_NO_ERROR) {
+    THROW_ARANGO_EXCEPTION(res);
+  }
+  created = true;
+  return idx;
+}
+
+int RocksDBCollection::publishIndex(std::shared_ptr<arangodb::Index> const& idx) {
   arangodb::aql::PlanCache::instance()->invalidate(
       _logicalCollection->vocbase());
   // Until here no harm is done if sth fails. The shared ptr will clean up. if
@@ -469,11 +630,13 @@ std::shared_ptr<Index> RocksDBCollection::createIndex(
 
   VPackBuilder indexInfo;
   idx->toVelocyPack(indexInfo, false, true);
-  res = static_cast<RocksDBEngine*>(engine)->writeCreateCollectionMarker(
-      _logicalCollection->vocbase()->id(), _logicalCollection->cid(),
-      builder.slice(), RocksDBLogValue::IndexCreate(
-                           _logicalCollection->vocbase()->id(),
-                           _logicalCollection->cid(), indexInfo.slice()));
+  int res = static_cast<RocksDBEngine*>(EngineSelectorFeature::ENGINE)
+                ->writeCreateCollectionMarker(
+                    _logicalCollection->vocbase()->id(),
+                    _logicalCollection->cid(), builder.slice(),
+                    RocksDBLogValue::IndexCreate(
+                        _logicalCollection->vocbase()->id(),
+                        _logicalCollection->cid(), indexInfo.slice()));
   if (res != TRI_ERROR_NO_ERROR) {
     // We could not persist the index creation. Better abort
     // Remove the Index in the local list again.
@@ -486,8 +649,85 @@ std::shared_ptr<Index> RocksDBCollection::createIndex(
       }
       ++i;
     }
-    THROW_ARANGO_EXCEPTION(res);
   }
+  return res;
+}
+
+std::shared_ptr<Index> RocksDBCollection::createIndexInBackground(
+    arangodb::velocypack::Slice const& info, bool& created) {
+  std::shared_ptr<Index> idx;
+  {
+    READ_LOCKER(guard, _indexesLock);
+    idx = findIndex(info, _indexes);
+    if (idx) {
+      created = false;
+      return idx;
+    }
+  }
+
+  if (_expireAfter > 0) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(
+        TRI_ERROR_BAD_PARAMETER,
+        "secondary indexes are unsupported for collections with expireAfter");
+  }
+
+  RocksDBEngine* engine =
+      static_cast<RocksDBEngine*>(EngineSelectorFeature::ENGINE);
+  idx = engine->indexFactory()->prepareIndexFromSlice(info, true,
+                                                       _logicalCollection,
+                                                       false);
+  TRI_ASSERT(idx != nullptr);
+  RocksDBIndex* ridx = static_cast<RocksDBIndex*>(idx.get());
+
+  // fill the index from a snapshot and follow the changes made meanwhile,
+  // while writers proceed
+  RocksDBIndexBuilder indexBuilder(_logicalCollection, ridx,
+                                   engine->indexBuildThreads());
+  Result res = indexBuilder.fill();
+  for (size_t round = 0; res.ok() && round < MaxIndexCatchUpRounds;
+       ++round) {
+    uint64_t numOperations = 0;
+    res = indexBuilder.catchUp(numOperations);
+    if (numOperations <= MaxLockedIndexCatchUpOperations) {
+      break;
+    }
+  }
+
+  std::shared_ptr<Index> existing;
+  if (res.ok()) {
+    // block writers only for applying the last few changes
+    res = lockWrite();
+    if (res.ok()) {
+      TRI_DEFER(unlockWrite());
+      uint64_t numOperations = 0;
+      res = indexBuilder.catchUp(numOperations);
+      if (res.ok()) {
+        READ_LOCKER(guard, _indexesLock);
+        existing = findIndex(info, _indexes);
+      }
+      if (res.ok() && existing == nullptr) {
+        std::shared_ptr<VPackBuilder> definition = idx->toVelocyPack(false);
+        engine->createIndex(_logicalCollection->vocbase(),
+                            _logicalCollection->cid(), idx->id(),
+                            definition->slice());
+        res = publishIndex(idx);
+      }
+    }
+  }
+
+  if (res.fail() || existing != nullptr) {
+    // remove what has been written so far
+    idx->drop();
+    if (res.fail()) {
+      THROW_ARANGO_EXCEPTION(res);
+    }
+    // the same index has been created concurrently
+    created = false;
+    return existing;
+  }
+
+  _needToPersistIndexEstimates = true;
+  globalRocksEngine()->counterManager()->markDirty(_objectId);
   created = true;
   return idx;
 }
@@ -666,6 +906,11 @@ void RocksDBCollection::invokeOnAllElements(
 // -- SECTION DML Operations --
 ///////////////////////////////////
 
+/// @brief minimum number of documents for which a truncate uses range
+/// deletions. the range tombstones slow down reads until they are compacted
+/// away, so small collections are better truncated document by document
+static constexpr uint64_t RangeDeleteThreshold = 32 * 1024;
+
 void RocksDBCollection::truncate(transaction::Methods* trx,
                                  OperationOptions& options) {
   // TODO FIXME -- improve transaction size
@@ -674,11 +919,21 @@ void RocksDBCollection::truncate(transaction::Methods* trx,
   auto state = RocksDBTransactionState::toState(trx);
   RocksDBMethods* mthd = state->rocksdbMethods();
 
+  if (state->hasHint(transaction::Hints::Hint::ALLOW_RANGE_DELETE) &&
+      !state->hasOperations() && _numberDocuments >= RangeDeleteThreshold) {
+    auto trxCollection = static_cast<RocksDBTransactionCollection*>(
+        state->findCollection(cid));
+    if (trxCollection != nullptr && trxCollection->isLockedExclusive()) {
+      truncateWithRangeDeletion(trx, options);
+      return;
+    }
+  }
+
   // delete documents
   RocksDBKeyBounds documentBounds =
       RocksDBKeyBounds::CollectionDocuments(this->objectId());
   rocksdb::Comparator const* cmp =
-      RocksDBColumnFamily::documents()->GetComparator();
+      documentsColumnFamily()->GetComparator();
   rocksdb::ReadOptions ro = mthd->readOptions();
   rocksdb::Slice const end = documentBounds.end();
   ro.iterate_upper_bound = &end;
@@ -696,13 +951,13 @@ void RocksDBCollection::truncate(transaction::Methods* trx,
         VPackSlice(iter->value().data()).get(StaticStrings::KeyString);
     TRI_ASSERT(key.isString());
 
-    blackListKey(iter->key().data(), static_cast<uint32_t>(iter->key().size()));
+    invalidateCachedDocument(RocksDBKey(iter->key()));
 
     // add possible log statement
     state->prepareOperation(cid, revId, StringRef(key),
                             TRI_VOC_DOCUMENT_OPERATION_REMOVE);
     Result r =
-        mthd->Delete(RocksDBColumnFamily::documents(), RocksDBKey(iter->key()));
+        mthd->Delete(documentsColumnFamily(), RocksDBKey(iter->key()));
     if (!r.ok()) {
       THROW_ARANGO_EXCEPTION(r);
     }
@@ -741,6 +996,57 @@ void RocksDBCollection::truncate(transaction::Methods* trx,
 #endif
 }
 
+void RocksDBCollection::truncateWithRangeDeletion(transaction::Methods* trx,
+                                                  OperationOptions& options) {
+  // the removed documents do not appear in the WAL. the marker lets the
+  // recovery reset the counter and the replication report the truncate
+  rocksdb::WriteBatch batch;
+  RocksDBLogValue log = RocksDBLogValue::CollectionTruncate(
+      _logicalCollection->vocbase()->id(), _logicalCollection->cid(),
+      _objectId);
+  rocksdb::Status s = batch.PutLogData(log.slice());
+
+  if (s.ok()) {
+    RocksDBKeyBounds bounds = RocksDBKeyBounds::CollectionDocuments(_objectId);
+    s = batch.DeleteRange(documentsColumnFamily(), bounds.start(),
+                          bounds.end());
+  }
+
+  READ_LOCKER(guard, _indexesLock);
+  for (std::shared_ptr<Index> const& index : _indexes) {
+    if (!s.ok()) {
+      break;
+    }
+    RocksDBIndex* rindex = static_cast<RocksDBIndex*>(index.get());
+    RocksDBKeyBounds bounds = rindex->getBounds();
+    s = batch.DeleteRange(rindex->columnFamily(), bounds.start(),
+                          bounds.end());
+  }
+
+  if (s.ok()) {
+    rocksdb::WriteOptions wo;
+    wo.sync = options.waitForSync;
+    s = globalRocksDB()->GetBaseDB()->Write(wo, &batch);
+  }
+  if (!s.ok()) {
+    THROW_ARANGO_EXCEPTION(rocksutils::convertStatus(s));
+  }
+
+  rocksdb::SequenceNumber seq = globalRocksDB()->GetLatestSequenceNumber();
+  TRI_voc_rid_t revisionId = TRI_HybridLogicalClock();
+  _numberDocuments = 0;
+  _revisionId = revisionId;
+  globalRocksEngine()->counterManager()->truncateCounter(_objectId, seq,
+                                                         revisionId);
+
+  for (std::shared_ptr<Index> const& index : _indexes) {
+    static_cast<RocksDBIndex*>(index.get())->afterTruncate();
+  }
+  // the document cache is keyed by revision ids, which are not reused, so
+  // its entries simply age out
+  _needToPersistIndexEstimates = true;
+}
+
 DocumentIdentifierToken RocksDBCollection::lookupKey(transaction::Methods* trx,
                                                      VPackSlice const& key) {
   TRI_ASSERT(key.isString());
@@ -800,45 +1106,9 @@ Result RocksDBCollection::insert(arangodb::transaction::Methods* trx,
   // note that we don't need it for this engine
   resultMarkerTick = 0;
 
-  VPackSlice fromSlice;
-  VPackSlice toSlice;
-
-  RocksDBOperationResult res;
-  bool const isEdgeCollection =
-      (_logicalCollection->type() == TRI_COL_TYPE_EDGE);
-
-  if (isEdgeCollection) {
-    // _from:
-    fromSlice = slice.get(StaticStrings::FromString);
-    if (!fromSlice.isString()) {
-      res.reset(TRI_ERROR_ARANGO_INVALID_EDGE_ATTRIBUTE);
-      return res.errorNumber();
-    }
-    VPackValueLength len;
-    char const* docId = fromSlice.getString(len);
-    size_t split;
-    if (!TRI_ValidateDocumentIdKeyGenerator(docId, static_cast<size_t>(len),
-                                            &split)) {
-      res.reset(TRI_ERROR_ARANGO_INVALID_EDGE_ATTRIBUTE);
-      return res.errorNumber();
-    }
-    // _to:
-    toSlice = slice.get(StaticStrings::ToString);
-    if (!toSlice.isString()) {
-      res.reset(TRI_ERROR_ARANGO_INVALID_EDGE_ATTRIBUTE);
-      return res.errorNumber();
-    }
-    docId = toSlice.getString(len);
-    if (!TRI_ValidateDocumentIdKeyGenerator(docId, static_cast<size_t>(len),
-                                            &split)) {
-      res.reset(TRI_ERROR_ARANGO_INVALID_EDGE_ATTRIBUTE);
-      return res.errorNumber();
-    }
-  }
-
   transaction::BuilderLeaser builder(trx);
-  res.reset(newObjectForInsert(trx, slice, fromSlice, toSlice, isEdgeCollection,
-                               *builder.get(), options.isRestore));
+  RocksDBOperationResult res(
+      newDocumentForInsert(trx, slice, *builder.get(), options.isRestore));
   if (res.fail()) {
     return res;
   }
@@ -858,16 +1128,16 @@ Result RocksDBCollection::insert(arangodb::transaction::Methods* trx,
 
   res = insertDocument(trx, revisionId, newSlice, options.waitForSync);
   if (res.ok()) {
-    Result lookupResult = lookupRevisionVPack(revisionId, trx, mdr, false);
-
-    if (lookupResult.fail()) {
-      return lookupResult;
-    }
+    // the stored document is the one we just built, so there is no need to
+    // read it back from the transaction's write batch
+    mdr.setManaged(newSlice.begin(), revisionId);
+    TRI_ASSERT(!mdr.empty());
 
     // report document and key size
     RocksDBOperationResult result = state->addOperation(
         _logicalCollection->cid(), revisionId,
-        TRI_VOC_DOCUMENT_OPERATION_INSERT, newSlice.byteSize(), res.keySize());
+        TRI_VOC_DOCUMENT_OPERATION_INSERT, newSlice.byteSize(), res.keySize(),
+        StringRef(newSlice.get(StaticStrings::KeyString)));
 
     // transaction size limit reached -- fail
     if (result.fail()) {
@@ -880,6 +1150,88 @@ Result RocksDBCollection::insert(arangodb::transaction::Methods* trx,
   return res;
 }
 
+void RocksDBCollection::insertMany(arangodb::transaction::Methods* trx,
+                                   arangodb::velocypack::Slice const documents,
+                                   OperationOptions& options,
+                                   TRI_voc_tick_t& resultMarkerTick, bool lock,
+                                   InsertCallback const& callback) {
+  TRI_ASSERT(documents.isArray());
+  resultMarkerTick = 0;
+
+  if (trx->isSingleOperationTransaction()) {
+    // a single operation writes a log entry of its own, see prepareOperation
+    PhysicalCollection::insertMany(trx, documents, options, resultMarkerTick,
+                                   lock, callback);
+    return;
+  }
+
+  // the new documents of a chunk, reused for all chunks
+  std::vector<VPackBuilder> builders(insertChunkSize);
+  std::vector<VPackSlice> originals;
+  std::vector<Result> results;
+  std::vector<std::pair<TRI_voc_rid_t, VPackSlice>> chunk;
+  std::vector<Result> chunkResults;
+  originals.reserve(insertChunkSize);
+  results.reserve(insertChunkSize);
+  chunk.reserve(insertChunkSize);
+
+  VPackArrayIterator it(documents);
+  while (it.valid()) {
+    originals.clear();
+    results.clear();
+    chunk.clear();
+
+    for (size_t i = 0; i < insertChunkSize && it.valid(); ++i, it.next()) {
+      VPackSlice const document = it.value();
+      originals.emplace_back(document);
+      if (!document.isObject()) {
+        results.emplace_back(TRI_ERROR_ARANGO_DOCUMENT_TYPE_INVALID);
+        continue;
+      }
+      builders[i].clear();
+      results.emplace_back(newDocumentForInsert(trx, document, builders[i],
+                                                options.isRestore));
+      if (results.back().ok()) {
+        VPackSlice const newSlice = builders[i].slice();
+        chunk.emplace_back(
+            transaction::helpers::extractRevFromDocument(newSlice), newSlice);
+      }
+    }
+
+    if (insertChunk(trx, chunk, chunkResults, options.waitForSync)) {
+      size_t next = 0;
+      for (size_t i = 0; i < originals.size(); ++i) {
+        ManagedDocumentResult mdr;
+        if (results[i].ok()) {
+          TRI_ASSERT(chunk[next].second.begin() == builders[i].slice().begin());
+          Result const& res = chunkResults[next];
+          if (res.ok()) {
+            mdr.setManaged(chunk[next].second.begin(), chunk[next].first);
+          }
+          ++next;
+          callback(res, mdr);
+        } else {
+          callback(results[i], mdr);
+        }
+      }
+    } else {
+      // nothing of the chunk was written. the documents are inserted one by
+      // one now, so that the failing ones get their own errors. their keys
+      // and revisions are generated anew
+      for (size_t i = 0; i < originals.size(); ++i) {
+        ManagedDocumentResult mdr;
+        if (results[i].ok()) {
+          TRI_voc_tick_t tick = 0;
+          Result res = insert(trx, originals[i], mdr, options, tick, lock);
+          callback(res, mdr);
+        } else {
+          callback(results[i], mdr);
+        }
+      }
+    }
+  }
+}
+
 Result RocksDBCollection::update(arangodb::transaction::Methods* trx,
                                  arangodb::velocypack::Slice const newSlice,
                                  arangodb::ManagedDocumentResult& mdr,
@@ -966,7 +1318,8 @@ Result RocksDBCollection::update(arangodb::transaction::Methods* trx,
     // report document and key size
     RocksDBOperationResult result = state->addOperation(
         _logicalCollection->cid(), revisionId,
-        TRI_VOC_DOCUMENT_OPERATION_UPDATE, newDoc.byteSize(), res.keySize());
+        TRI_VOC_DOCUMENT_OPERATION_UPDATE, newDoc.byteSize(), res.keySize(),
+        StringRef(newDoc.get(StaticStrings::KeyString)));
 
     // transaction size limit reached -- fail
     if (result.fail()) {
@@ -1060,7 +1413,8 @@ Result RocksDBCollection::replace(
     RocksDBOperationResult result =
         state->addOperation(_logicalCollection->cid(), revisionId,
                             TRI_VOC_DOCUMENT_OPERATION_REPLACE,
-                            newDoc.byteSize(), opResult.keySize());
+                            newDoc.byteSize(), opResult.keySize(),
+                            StringRef(newDoc.get(StaticStrings::KeyString)));
 
     // transaction size limit reached -- fail
     if (result.fail()) {
@@ -1133,7 +1487,7 @@ Result RocksDBCollection::remove(arangodb::transaction::Methods* trx,
     // report key size
     res = state->addOperation(_logicalCollection->cid(), revisionId,
                               TRI_VOC_DOCUMENT_OPERATION_REMOVE, 0,
-                              res.keySize());
+                              res.keySize(), StringRef(key));
     // transaction size limit reached -- fail
     if (res.fail()) {
       THROW_ARANGO_EXCEPTION(res);
@@ -1159,12 +1513,33 @@ void RocksDBCollection::figuresSpecific(
 
   uint64_t out = 0;
   db->GetApproximateSizes(
-      RocksDBColumnFamily::documents(), &r, 1, &out,
+      documentsColumnFamily(), &r, 1, &out,
       static_cast<uint8_t>(
           rocksdb::DB::SizeApproximationFlags::INCLUDE_MEMTABLES |
           rocksdb::DB::SizeApproximationFlags::INCLUDE_FILES));
 
   builder->add("documentsSize", VPackValue(out));
+
+  if (_dedicatedColumnFamily) {
+    // the column family holds the documents of this collection only
+    rocksdb::ColumnFamilyHandle* cf = documentsColumnFamily();
+    builder->add("columnFamily", VPackValue(VPackValueType::Object));
+    builder->add("name", VPackValue(cf->GetName()));
+    uint64_t value = 0;
+    if (db->GetIntProperty(cf, rocksdb::DB::Properties::kCurSizeAllMemTables,
+                           &value)) {
+      builder->add("memtables", VPackValue(value));
+    }
+    if (db->GetIntProperty(cf, rocksdb::DB::Properties::kTotalSstFilesSize,
+                           &value)) {
+      builder->add("sstFiles", VPackValue(value));
+    }
+    if (db->GetIntProperty(cf, rocksdb::DB::Properties::kEstimateLiveDataSize,
+                           &value)) {
+      builder->add("liveData", VPackValue(value));
+    }
+    builder->close();
+  }
 }
 
 /// @brief creates the initial indexes for the collection
@@ -1201,8 +1576,17 @@ void RocksDBCollection::addIndex(std::shared_ptr<arangodb::Index> idx) {
 
   TRI_UpdateTickServer(static_cast<TRI_voc_tick_t>(id));
   _indexes.emplace_back(idx);
-  if (idx->type() == Index::TRI_IDX_TYPE_GEO1_INDEX ||
-      idx->type() == Index::TRI_IDX_TYPE_GEO2_INDEX) {
+  if (_expireAfter > 0 &&
+      idx->type() == Index::TRI_IDX_TYPE_PRIMARY_INDEX) {
+    // let compactions drop the expired documents and their primary
+    // index entries
+    RocksDBTtl::add(_objectId, _expireAfter);
+    RocksDBTtl::add(static_cast<RocksDBIndex*>(idx.get())->objectId(),
+                    _expireAfter);
+  }
+  if ((idx->type() == Index::TRI_IDX_TYPE_GEO1_INDEX ||
+       idx->type() == Index::TRI_IDX_TYPE_GEO2_INDEX) &&
+      !static_cast<RocksDBGeoIndex*>(idx.get())->usesCells()) {
     _hasGeoIndex = true;
   }
 }
@@ -1335,6 +1719,7 @@ arangodb::Result RocksDBCollection::fillIndexes(
   }
   if (numDocsWritten > 0) {
     _needToPersistIndexEstimates = true;
+    globalRocksEngine()->counterManager()->markDirty(_objectId);
   }
 
   return res;
@@ -1365,6 +1750,44 @@ arangodb::RocksDBPrimaryIndex* RocksDBCollection::primaryIndex() const {
   return static_cast<arangodb::RocksDBPrimaryIndex*>(primary.get());
 }
 
+Result RocksDBCollection::newDocumentForInsert(
+    arangodb::transaction::Methods* trx, VPackSlice const slice,
+    VPackBuilder& builder, bool isRestore) const {
+  VPackSlice fromSlice;
+  VPackSlice toSlice;
+
+  bool const isEdgeCollection =
+      (_logicalCollection->type() == TRI_COL_TYPE_EDGE);
+
+  if (isEdgeCollection) {
+    // _from:
+    fromSlice = slice.get(StaticStrings::FromString);
+    if (!fromSlice.isString()) {
+      return TRI_ERROR_ARANGO_INVALID_EDGE_ATTRIBUTE;
+    }
+    VPackValueLength len;
+    char const* docId = fromSlice.getString(len);
+    size_t split;
+    if (!TRI_ValidateDocumentIdKeyGenerator(docId, static_cast<size_t>(len),
+                                            &split)) {
+      return TRI_ERROR_ARANGO_INVALID_EDGE_ATTRIBUTE;
+    }
+    // _to:
+    toSlice = slice.get(StaticStrings::ToString);
+    if (!toSlice.isString()) {
+      return TRI_ERROR_ARANGO_INVALID_EDGE_ATTRIBUTE;
+    }
+    docId = toSlice.getString(len);
+    if (!TRI_ValidateDocumentIdKeyGenerator(docId, static_cast<size_t>(len),
+                                            &split)) {
+      return TRI_ERROR_ARANGO_INVALID_EDGE_ATTRIBUTE;
+    }
+  }
+
+  return newObjectForInsert(trx, slice, fromSlice, toSlice, isEdgeCollection,
+                            builder, isRestore);
+}
+
 RocksDBOperationResult RocksDBCollection::insertDocument(
     arangodb::transaction::Methods* trx, TRI_voc_rid_t revisionId,
     VPackSlice const& doc, bool& waitForSync) const {
@@ -1376,10 +1799,8 @@ RocksDBOperationResult RocksDBCollection::insertDocument(
   RocksDBKey key(RocksDBKey::Document(_objectId, revisionId));
   RocksDBValue value(RocksDBValue::Document(doc));
 
-  blackListKey(key.string().data(), static_cast<uint32_t>(key.string().size()));
-
   RocksDBMethods* mthd = RocksDBTransactionState::toMethods(trx);
-  res = mthd->Put(RocksDBColumnFamily::documents(), key, value.string());
+  res = mthd->Put(documentsColumnFamily(), key, value.string());
   if (!res.ok()) {
     // set keysize that is passed up to the crud operations
     res.keySize(key.string().size());
@@ -1424,6 +1845,111 @@ RocksDBOperationResult RocksDBCollection::insertDocument(
   return res;
 }
 
+bool RocksDBCollection::insertChunk(
+    arangodb::transaction::Methods* trx,
+    std::vector<std::pair<TRI_voc_rid_t, VPackSlice>> const& documents,
+    std::vector<Result>& results, bool& waitForSync) const {
+  // Coordinator doesn't know index internals
+  TRI_ASSERT(!ServerState::instance()->isCoordinator());
+  TRI_ASSERT(trx->state()->isRunning());
+
+  results.clear();
+  if (documents.empty()) {
+    return true;
+  }
+
+  auto state = RocksDBTransactionState::toState(trx);
+  auto mthds = RocksDBTransactionState::toMethods(trx);
+  RocksDBSavePoint savePoint(mthds, false,
+                             [&state]() { state->resetLogState(); });
+
+  state->prepareOperation(_logicalCollection->cid(), documents.front().first,
+                          StringRef(), TRI_VOC_DOCUMENT_OPERATION_INSERT);
+
+  std::vector<Result> rejected(documents.size());
+  std::vector<std::pair<TRI_voc_rid_t, VPackSlice>> written;
+  written.reserve(documents.size());
+
+  {
+    READ_LOCKER(guard, _indexesLock);
+
+    // the primary index goes first, so that a document with an existing
+    // key is rejected before anything of it is written
+    std::shared_ptr<Index> primary;
+    for (std::shared_ptr<Index> const& idx : _indexes) {
+      if (idx->type() == Index::TRI_IDX_TYPE_PRIMARY_INDEX) {
+        primary = idx;
+        break;
+      }
+    }
+    TRI_ASSERT(primary != nullptr);
+
+    for (size_t i = 0; i < documents.size(); ++i) {
+      auto const& doc = documents[i];
+      Result res = primary->insert(trx, doc.first, doc.second, false);
+      if (res.is(TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED)) {
+        rejected[i] = res;
+        continue;
+      }
+      if (res.ok()) {
+        RocksDBKey key(RocksDBKey::Document(_objectId, doc.first));
+        RocksDBValue value(RocksDBValue::Document(doc.second));
+        res = mthds->Put(documentsColumnFamily(), key, value.string());
+      }
+      if (res.fail()) {
+        return false;
+      }
+      written.emplace_back(doc);
+    }
+
+    // a failing secondary index does not tell which document it failed
+    // for. the caller then inserts the documents one by one
+    auto queue = std::make_shared<basics::LocalTaskQueue>(nullptr);
+    for (std::shared_ptr<Index> const& idx : _indexes) {
+      if (idx.get() == primary.get()) {
+        continue;
+      }
+      idx->batchInsert(trx, written, queue);
+      if (queue->status() != TRI_ERROR_NO_ERROR) {
+        return false;
+      }
+    }
+  }
+
+  TRI_voc_cid_t const cid = _logicalCollection->cid();
+  for (auto const& doc : written) {
+    // the intermediate commit, if any, comes after the whole chunk
+    RocksDBOperationResult res = state->addOperation(
+        cid, doc.first, TRI_VOC_DOCUMENT_OPERATION_INSERT,
+        doc.second.byteSize(), 0,
+        StringRef(doc.second.get(StaticStrings::KeyString)), false);
+
+    // transaction size limit reached -- fail
+    if (res.fail()) {
+      THROW_ARANGO_EXCEPTION(res);
+    }
+  }
+  savePoint.commit();
+
+  results = std::move(rejected);
+
+  if (!written.empty()) {
+    if (_logicalCollection->waitForSync()) {
+      waitForSync = true;  // output parameter (by ref)
+    }
+    if (waitForSync) {
+      trx->state()->waitForSync(true);
+    }
+    _needToPersistIndexEstimates = true;
+  }
+
+  RocksDBOperationResult res = state->checkIntermediateCommit(0);
+  if (res.fail()) {
+    THROW_ARANGO_EXCEPTION(res);
+  }
+  return true;
+}
+
 RocksDBOperationResult RocksDBCollection::removeDocument(
     arangodb::transaction::Methods* trx, TRI_voc_rid_t revisionId,
     VPackSlice const& doc, bool isUpdate, bool& waitForSync) const {
@@ -1434,7 +1960,7 @@ RocksDBOperationResult RocksDBCollection::removeDocument(
 
   auto key = RocksDBKey::Document(_objectId, revisionId);
 
-  blackListKey(key.string().data(), static_cast<uint32_t>(key.string().size()));
+  invalidateCachedDocument(key);
 
   // prepare operation which adds log statements is called
   // from the outside. We do not need to DELETE a document from the
@@ -1443,7 +1969,7 @@ RocksDBOperationResult RocksDBCollection::removeDocument(
   // if (!isUpdate) {
   RocksDBMethods* mthd = RocksDBTransactionState::toMethods(trx);
   RocksDBOperationResult res =
-      mthd->Delete(RocksDBColumnFamily::documents(), key);
+      mthd->Delete(documentsColumnFamily(), key);
   if (!res.ok()) {
     return res;
   }
@@ -1545,6 +2071,11 @@ arangodb::Result RocksDBCollection::lookupRevisionVPack(
   TRI_ASSERT(trx->state()->isRunning());
   TRI_ASSERT(_objectId != 0);
 
+  if (isExpired(revisionId)) {
+    // hidden until a compaction removes it
+    return {TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND};
+  }
+
   auto key = RocksDBKey::Document(_objectId, revisionId);
 
   if (withCache && useCache()) {
@@ -1553,17 +2084,15 @@ arangodb::Result RocksDBCollection::lookupRevisionVPack(
     auto f = _cache->find(key.string().data(),
                           static_cast<uint32_t>(key.string().size()));
     if (f.found()) {
-      std::string* value = mdr.prepareStringUsage();
-      value->append(reinterpret_cast<char const*>(f.value()->value()),
-                    static_cast<size_t>(f.value()->valueSize));
-      mdr.setManagedAfterStringUsage(revisionId);
+      // reuses the result's buffer if it is large enough
+      mdr.setManaged(f.value()->value(), revisionId);
       return {TRI_ERROR_NO_ERROR};
     }
   }
 
   RocksDBMethods* mthd = RocksDBTransactionState::toMethods(trx);
   std::string* value = mdr.prepareStringUsage();
-  Result res = mthd->Get(RocksDBColumnFamily::documents(), key, value);
+  Result res = mthd->Get(documentsColumnFamily(), key, value);
   if (res.ok()) {
     if (withCache && useCache()) {
       TRI_ASSERT(_cache != nullptr);
@@ -1594,6 +2123,11 @@ arangodb::Result RocksDBCollection::lookupRevisionVPack(
   TRI_ASSERT(trx->state()->isRunning());
   TRI_ASSERT(_objectId != 0);
 
+  if (isExpired(revisionId)) {
+    // hidden until a compaction removes it
+    return {TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND};
+  }
+
   auto key = RocksDBKey::Document(_objectId, revisionId);
 
   if (withCache && useCache()) {
@@ -1610,7 +2144,7 @@ arangodb::Result RocksDBCollection::lookupRevisionVPack(
   std::string value;
   auto state = RocksDBTransactionState::toState(trx);
   RocksDBMethods* mthd = state->rocksdbMethods();
-  Result res = mthd->Get(RocksDBColumnFamily::documents(), key, &value);
+  Result res = mthd->Get(documentsColumnFamily(), key, &value);
   TRI_ASSERT(value.data());
   if (res.ok()) {
     if (withCache && useCache()) {
@@ -1803,7 +2337,7 @@ void RocksDBCollection::estimateSize(velocypack::Builder& builder) {
   rocksdb::Range r(bounds.start(), bounds.end());
   uint64_t out = 0, total = 0;
   db->GetApproximateSizes(
-      RocksDBColumnFamily::documents(), &r, 1, &out,
+      documentsColumnFamily(), &r, 1, &out,
       static_cast<uint8_t>(
           rocksdb::DB::SizeApproximationFlags::INCLUDE_MEMTABLES |
           rocksdb::DB::SizeApproximationFlags::INCLUDE_FILES));
@@ -1892,6 +2426,7 @@ void RocksDBCollection::recalculateIndexEstimates(
     idx->recalculateEstimates();
   }
   _needToPersistIndexEstimates = true;
+  globalRocksEngine()->counterManager()->markDirty(_objectId);
   trx.commit();
 }
 
@@ -1905,8 +2440,12 @@ void RocksDBCollection::createCache() const {
   TRI_ASSERT(_useCache);
   TRI_ASSERT(_cache.get() == nullptr);
   TRI_ASSERT(CacheManagerFeature::MANAGER != nullptr);
+  // documents are stored under their revision ids, and the contents of a
+  // revision never change. so the cache does not need to be transactional
+  // and entries only have to be removed when their revision is removed
   _cache = CacheManagerFeature::MANAGER->createCache(
-      cache::CacheType::Transactional);
+      cache::CacheType::Plain, false, UINT64_MAX,
+      _logicalCollection->dbName() + "/" + _logicalCollection->name());
   _cachePresent = (_cache.get() != nullptr);
   TRI_ASSERT(_useCache);
 }
@@ -1935,11 +2474,277 @@ arangodb::Result RocksDBCollection::serializeKeyGenerator(
 void RocksDBCollection::deserializeKeyGenerator(RocksDBCounterManager* mgr) {
   uint64_t value = mgr->stealKeyGenerator(_objectId);
   if (value > 0) {
-    std::string k(basics::StringUtils::itoa(value));
-    _logicalCollection->keyGenerator()->track(k.data(), k.size());
+    _logicalCollection->keyGenerator()->trackValue(value);
   }
 }
 
+std::shared_ptr<AttributeStatistics const>
+RocksDBCollection::attributeStatistics() const {
+  MUTEX_LOCKER(locker, _attributeStatisticsLock);
+  return _attributeStatistics;
+}
+
+bool RocksDBCollection::needsAnalyze() const {
+  uint64_t const current = _numberDocuments.load();
+  if (current < AnalyzeMinDocuments) {
+    return false;
+  }
+  auto statistics = attributeStatistics();
+  if (statistics == nullptr) {
+    return true;
+  }
+  double const previous =
+      static_cast<double>(statistics->numberOfDocuments());
+  double const diff = std::abs(static_cast<double>(current) - previous);
+  return diff > previous * AnalyzeChangeThreshold;
+}
+
+Result RocksDBCollection::analyze() {
+  rocksdb::TransactionDB* db = rocksutils::globalRocksDB();
+  rocksdb::Snapshot const* snapshot = db->GetSnapshot();
+  TRI_DEFER(db->ReleaseSnapshot(snapshot));
+
+  RocksDBKeyBounds bounds = RocksDBKeyBounds::CollectionDocuments(_objectId);
+  rocksdb::Slice const upper(bounds.end());
+
+  rocksdb::ReadOptions readOptions;
+  readOptions.snapshot = snapshot;
+  readOptions.fill_cache = false;
+  readOptions.iterate_upper_bound = &upper;
+  std::unique_ptr<rocksdb::Iterator> it(
+      db->NewIterator(readOptions, bounds.columnFamily()));
+
+  uint64_t const total = _numberDocuments.load();
+  auto statistics = std::make_shared<AttributeStatistics>();
+
+  if (total <= AnalyzeSampleSize) {
+    for (it->Seek(bounds.start()); it->Valid(); it->Next()) {
+      statistics->add(RocksDBValue::data(it->value()));
+    }
+  } else {
+    // revision ids are stored in little-endian byte order, so seeking to
+    // random revision ids spreads the samples over the whole key range
+    std::unordered_set<TRI_voc_rid_t> sampled;
+    sampled.reserve(AnalyzeSampleSize);
+    for (uint64_t i = 0;
+         i < 2 * AnalyzeSampleSize && sampled.size() < AnalyzeSampleSize;
+         ++i) {
+      RocksDBKey key = RocksDBKey::Document(
+          _objectId, RandomGenerator::interval(UINT64_MAX));
+      it->Seek(key.string());
+      if (!it->Valid()) {
+        continue;
+      }
+      TRI_voc_rid_t revisionId =
+          RocksDBKey::revisionId(RocksDBEntryType::Document, it->key());
+      if (sampled.emplace(revisionId).second) {
+        statistics->add(RocksDBValue::data(it->value()));
+      }
+    }
+  }
+
+  if (!it->status().ok()) {
+    return rocksutils::convertStatus(it->status());
+  }
+
+  statistics->finish(total);
+
+  VPackBuilder builder;
+  statistics->toVelocyPack(builder);
+  RocksDBKey key = RocksDBKey::AttributeStatisticsValue(_objectId);
+  RocksDBValue value = RocksDBValue::AttributeStatisticsValue(builder.slice());
+  rocksdb::Status s = db->Put(rocksdb::WriteOptions(),
+                              RocksDBColumnFamily::definitions(), key.string(),
+                              value.string());
+  if (!s.ok()) {
+    LOG_TOPIC(WARN, Logger::ENGINES)
+        << "writing attribute statistics failed";
+    return rocksutils::convertStatus(s);
+  }
+
+  MUTEX_LOCKER(locker, _attributeStatisticsLock);
+  _attributeStatistics = std::move(statistics);
+  return {TRI_ERROR_NO_ERROR};
+}
+
+void RocksDBCollection::deserializeAttributeStatistics() {
+  RocksDBKey key = RocksDBKey::AttributeStatisticsValue(_objectId);
+  std::string value;
+  rocksdb::Status s = rocksutils::globalRocksDB()->Get(
+      rocksdb::ReadOptions(), RocksDBColumnFamily::definitions(), key.string(),
+      &value);
+  if (!s.ok()) {
+    // never analyzed
+    return;
+  }
+
+  try {
+    auto statistics =
+        std::make_shared<AttributeStatistics>(RocksDBValue::data(value));
+    MUTEX_LOCKER(locker, _attributeStatisticsLock);
+    _attributeStatistics = std::move(statistics);
+  } catch (...) {
+    LOG_TOPIC(WARN, Logger::ENGINES)
+        << "ignoring invalid attribute statistics for collection '"
+        << _logicalCollection->name() << "'";
+  }
+}
+
+Result RocksDBCollection::serializeCacheHeatMap(
+    std::unordered_map<cache::Cache const*, uint64_t> const& accesses,
+    uint64_t totalAccesses) const {
+  auto addHotKeys = [&](VPackBuilder& builder, cache::Cache* cache) -> bool {
+    if (cache == nullptr || totalAccesses == 0) {
+      return false;
+    }
+    auto it = accesses.find(cache);
+    if (it == accesses.end()) {
+      // not accessed recently, so its keys are not worth prefetching
+      return false;
+    }
+    size_t limit = static_cast<size_t>(
+        HeatMapKeys * static_cast<double>(it->second) /
+        static_cast<double>(totalAccesses));
+    if (limit < MinHeatMapKeysPerCache) {
+      limit = MinHeatMapKeysPerCache;
+    }
+    std::vector<std::string> keys = cache->hotKeys(limit);
+    if (keys.empty()) {
+      return false;
+    }
+    builder.openArray();
+    for (auto const& key : keys) {
+      builder.add(VPackValuePair(key.data(), key.size(),
+                                 VPackValueType::Binary));
+    }
+    builder.close();
+    return true;
+  };
+
+  VPackBuilder builder;
+  bool empty = true;
+  builder.openObject();
+  builder.add(VPackValue("documents"));
+  if (!addHotKeys(builder, useCache() ? _cache.get() : nullptr)) {
+    builder.add(VPackValue(VPackValueType::Null));
+  } else {
+    empty = false;
+  }
+  builder.add(VPackValue("indexes"));
+  builder.openObject();
+  {
+    READ_LOCKER(guard, _indexesLock);
+    for (auto const& idx : _indexes) {
+      auto rocksIdx = static_cast<RocksDBIndex*>(idx.get());
+      if (rocksIdx->cache() == nullptr) {
+        continue;
+      }
+      builder.add(VPackValue(std::to_string(idx->id())));
+      if (!addHotKeys(builder, rocksIdx->cache())) {
+        builder.add(VPackValue(VPackValueType::Null));
+      } else {
+        empty = false;
+      }
+    }
+  }
+  builder.close();
+  builder.close();
+
+  if (empty) {
+    // keep the previous heat map if the collection was not used meanwhile
+    return {TRI_ERROR_NO_ERROR};
+  }
+
+  RocksDBKey key = RocksDBKey::CacheHeatMapValue(_objectId);
+  RocksDBValue value = RocksDBValue::CacheHeatMapValue(builder.slice());
+  rocksdb::Status s = rocksutils::globalRocksDB()->Put(
+      rocksdb::WriteOptions(), RocksDBColumnFamily::definitions(),
+      key.string(), value.string());
+  if (!s.ok()) {
+    LOG_TOPIC(WARN, Logger::ENGINES) << "writing cache heat map failed";
+    return rocksutils::convertStatus(s);
+  }
+  return {TRI_ERROR_NO_ERROR};
+}
+
+size_t RocksDBCollection::prefetchCacheHeatMap() {
+  RocksDBKey key = RocksDBKey::CacheHeatMapValue(_objectId);
+  std::string value;
+  rocksdb::Status s = rocksutils::globalRocksDB()->Get(
+      rocksdb::ReadOptions(), RocksDBColumnFamily::definitions(), key.string(),
+      &value);
+  if (!s.ok()) {
+    // no heat map persisted yet
+    return 0;
+  }
+
+  auto readKeys = [](VPackSlice slice) -> std::vector<std::string> {
+    std::vector<std::string> keys;
+    if (slice.isArray()) {
+      keys.reserve(static_cast<size_t>(slice.length()));
+      for (auto const& it : VPackArrayIterator(slice)) {
+        if (it.isBinary()) {
+          VPackValueLength length;
+          uint8_t const* data = it.getBinary(length);
+          keys.emplace_back(reinterpret_cast<char const*>(data),
+                            static_cast<size_t>(length));
+        }
+      }
+    }
+    return keys;
+  };
+
+  VPackSlice heatMap = RocksDBValue::data(value);
+  if (!heatMap.isObject()) {
+    return 0;
+  }
+
+  arangodb::SingleCollectionTransaction trx(
+      arangodb::transaction::StandaloneContext::Create(
+          _logicalCollection->vocbase()),
+      _logicalCollection->cid(), AccessMode::Type::READ);
+  Result res = trx.begin();
+  if (res.fail()) {
+    return 0;
+  }
+
+  size_t prefetched = 0;
+  if (useCache()) {
+    RocksDBMethods* mthd = RocksDBTransactionState::toMethods(&trx);
+    std::string document;
+    for (auto const& it : readKeys(heatMap.get("documents"))) {
+      // the keys are document keys, under which the cache stores documents
+      auto f = _cache->find(it.data(), static_cast<uint32_t>(it.size()));
+      if (f.found()) {
+        continue;
+      }
+      res = mthd->Get(documentsColumnFamily(), RocksDBKey(rocksdb::Slice(it)),
+                      &document);
+      if (res.ok()) {
+        auto entry = cache::CachedValue::construct(
+            it.data(), static_cast<uint32_t>(it.size()), document.data(),
+            static_cast<uint64_t>(document.size()));
+        auto status = _cache->insert(entry);
+        if (status.fail()) {
+          delete entry;
+        }
+      }
+      ++prefetched;
+    }
+  }
+
+  VPackSlice indexes = heatMap.get("indexes");
+  if (indexes.isObject()) {
+    for (auto const& idx : _logicalCollection->getIndexes()) {
+      auto keys = readKeys(indexes.get(std::to_string(idx->id())));
+      prefetched += static_cast<RocksDBIndex*>(idx.get())
+                        ->prefetchCacheKeys(&trx, keys);
+    }
+  }
+  trx.commit();
+  return prefetched;
+}
+
 void RocksDBCollection::disableCache() const {
   if (!_cachePresent) {
     return;
@@ -1955,15 +2760,16 @@ void RocksDBCollection::disableCache() const {
   TRI_ASSERT(_useCache);
 }
 
-// blacklist given key from transactional cache
-void RocksDBCollection::blackListKey(char const* data, std::size_t len) const {
+/// @brief remove a removed document revision from the document cache.
+/// inserts need no invalidation, as a new revision always gets a new key
+void RocksDBCollection::invalidateCachedDocument(RocksDBKey const& key) const {
   if (useCache()) {
     TRI_ASSERT(_cache != nullptr);
-    bool blacklisted = false;
-    while (!blacklisted) {
-      auto status = _cache->blacklist(data, static_cast<uint32_t>(len));
+    while (true) {
+      auto status = _cache->remove(key.string().data(),
+                                   static_cast<uint32_t>(key.string().size()));
       if (status.ok()) {
-        blacklisted = true;
+        break;
       } else if (status.errorNumber() == TRI_ERROR_SHUTTING_DOWN) {
         disableCache();
         break;
@@ -25,9 +25,11 @@
 #define ARANGOD_ROCKSDB_ENGINE_ROCKSDB_COLLECTION_H 1
 
 #include "Basics/Common.h"
+#include "Basics/Mutex.h"
 #include "Basics/ReadWriteLock.h"
 #include "Indexes/IndexLookupContext.h"
 #include "RocksDBEngine/RocksDBCommon.h"
+#include "RocksDBEngine/RocksDBTtl.h"
 #include "StorageEngine/PhysicalCollection.h"
 #include "VocBase/LogicalCollection.h"
 #include "VocBase/ManagedDocumentResult.h"
@@ -54,6 +56,9 @@ class RocksDBCollection final : public PhysicalCollection {
 
   constexpr static double defaultLockTimeout = 10.0 * 60.0;
 
+  /// @brief number of documents of an array insert written in one go
+  constexpr static size_t insertChunkSize = 1000;
+
  public:
  public:
   explicit RocksDBCollection(LogicalCollection*, VPackSlice const& info);
@@ -123,6 +128,10 @@ class RocksDBCollection final : public PhysicalCollection {
   ///////////////////////////////////
 
   void truncate(transaction::Methods* trx, OperationOptions& options) override;
+  /// truncate with range deletions outside of the transaction, only used if
+  /// the transaction allows it and locked the collection exclusively
+  void truncateWithRangeDeletion(transaction::Methods* trx,
+                                 OperationOptions& options);
   /// non transactional truncate, will continoiusly commit the deletes
   /// and no fully rollback on failure. Uses trx snapshots to isolate
   /// against newer PUTs
@@ -149,6 +158,14 @@ class RocksDBCollection final : public PhysicalCollection {
                 OperationOptions& options, TRI_voc_tick_t& resultMarkerTick,
                 bool lock) override;
 
+  /// @brief inserts the documents in chunks. the documents and primary
+  /// index entries of a chunk are written first, then each secondary index
+  /// gets the entries of the whole chunk at once
+  void insertMany(arangodb::transaction::Methods* trx,
+                  arangodb::velocypack::Slice const documents,
+                  OperationOptions& options, TRI_voc_tick_t& resultMarkerTick,
+                  bool lock, InsertCallback const& callback) override;
+
   Result update(arangodb::transaction::Methods* trx,
                 arangodb::velocypack::Slice const newSlice,
                 arangodb::ManagedDocumentResult& result,
@@ -181,6 +198,28 @@ class RocksDBCollection final : public PhysicalCollection {
   void adjustNumberDocuments(int64_t adjustment);
   uint64_t objectId() const { return _objectId; }
 
+  /// @brief whether or not the documents of the collection are stored in
+  /// a column family of their own
+  bool hasDedicatedColumnFamily() const { return _dedicatedColumnFamily; }
+
+  /// @brief the column family holding the documents of the collection
+  rocksdb::ColumnFamilyHandle* documentsColumnFamily() const;
+
+  /// @brief number of seconds after their last write after which documents
+  /// expire, 0 if they do not expire
+  uint64_t expireAfter() const { return _expireAfter; }
+
+  /// @brief edge attributes the edge indexes of the collection store inline
+  /// in addition to _from and _to
+  std::vector<std::string> const& edgeStoredValues() const {
+    return _edgeStoredValues;
+  }
+
+  /// @brief whether or not the document revision has expired
+  bool isExpired(TRI_voc_rid_t revisionId) const {
+    return _expireAfter > 0 && RocksDBTtl::isExpired(revisionId, _expireAfter);
+  }
+
   Result lookupDocumentToken(transaction::Methods* trx, arangodb::StringRef key,
                              RocksDBToken& token) const;
 
@@ -206,6 +245,32 @@ class RocksDBCollection final : public PhysicalCollection {
   Result serializeKeyGenerator(rocksdb::Transaction*) const;
   void deserializeKeyGenerator(arangodb::RocksDBCounterManager* mgr);
 
+  /// @brief attribute statistics from the last analysis of the collection
+  std::shared_ptr<AttributeStatistics const> attributeStatistics()
+      const override;
+
+  /// @brief whether the collection was never analyzed or its number of
+  /// documents changed considerably since it was last analyzed
+  bool needsAnalyze() const;
+
+  /// @brief sample the documents of the collection to build, persist and
+  /// publish new attribute statistics
+  Result analyze();
+
+  /// @brief load persisted attribute statistics
+  void deserializeAttributeStatistics();
+
+  /// @brief persist the hottest keys of the document cache and the index
+  /// caches. each cache contributes a share of the keys proportional to its
+  /// recent accesses, as reported by the cache manager
+  Result serializeCacheHeatMap(
+      std::unordered_map<cache::Cache const*, uint64_t> const& accesses,
+      uint64_t totalAccesses) const;
+
+  /// @brief look up the keys persisted by serializeCacheHeatMap and insert
+  /// them into the caches. returns the number of keys looked up
+  size_t prefetchCacheHeatMap();
+
  private:
   /// @brief return engine-specific figures
   void figuresSpecific(
@@ -216,16 +281,38 @@ class RocksDBCollection final : public PhysicalCollection {
   void addIndexCoordinator(std::shared_ptr<arangodb::Index> idx);
   int saveIndex(transaction::Methods* trx,
                 std::shared_ptr<arangodb::Index> idx);
+  /// @brief make a filled and persisted index available
+  int publishIndex(std::shared_ptr<arangodb::Index> const& idx);
+  /// @brief create and fill an index without blocking writers for the
+  /// duration of the fill
+  std::shared_ptr<Index> createIndexInBackground(
+      arangodb::velocypack::Slice const& info, bool& created);
 
   arangodb::Result fillIndexes(transaction::Methods*,
                                std::shared_ptr<arangodb::Index>);
 
   arangodb::RocksDBPrimaryIndex* primaryIndex() const;
 
+  /// @brief checks the _from and _to attributes of an edge and builds the
+  /// document to store
+  Result newDocumentForInsert(arangodb::transaction::Methods* trx,
+                              arangodb::velocypack::Slice const slice,
+                              arangodb::velocypack::Builder& builder,
+                              bool isRestore) const;
+
   arangodb::RocksDBOperationResult insertDocument(
       arangodb::transaction::Methods* trx, TRI_voc_rid_t revisionId,
       arangodb::velocypack::Slice const& doc, bool& waitForSync) const;
 
+  /// @brief writes a chunk of new documents. documents whose key exists
+  /// already are rejected with their own error in results. returns false
+  /// if any other write failed, the chunk is then rolled back completely
+  bool insertChunk(
+      arangodb::transaction::Methods* trx,
+      std::vector<std::pair<TRI_voc_rid_t, arangodb::velocypack::Slice>> const&
+          documents,
+      std::vector<Result>& results, bool& waitForSync) const;
+
   arangodb::RocksDBOperationResult removeDocument(
       arangodb::transaction::Methods* trx, TRI_voc_rid_t revisionId,
       arangodb::velocypack::Slice const& doc, bool isUpdate,
@@ -256,10 +343,16 @@ class RocksDBCollection final : public PhysicalCollection {
 
   inline bool useCache() const { return (_useCache && _cachePresent); }
 
-  void blackListKey(char const* data, std::size_t len) const;
+  void invalidateCachedDocument(RocksDBKey const& key) const;
 
  private:
   uint64_t const _objectId;  // rocksdb-specific object id for collection
+  bool const _dedicatedColumnFamily;
+  uint64_t const _expireAfter;
+  std::vector<std::string> const _edgeStoredValues;
+  // resolved lazily, the dedicated column family is created after the
+  // collection object
+  mutable std::atomic<rocksdb::ColumnFamilyHandle*> _documentsCF;
   std::atomic<uint64_t> _numberDocuments;
   std::atomic<TRI_voc_rid_t> _revisionId;
   mutable std::atomic<bool> _needToPersistIndexEstimates;
@@ -272,6 +365,9 @@ class RocksDBCollection final : public PhysicalCollection {
   // it's quicker than accessing the shared_ptr each time
   mutable bool _cachePresent;
   bool _useCache;
+
+  mutable Mutex _attributeStatisticsLock;
+  std::shared_ptr<AttributeStatistics const> _attributeStatistics;
 };
 
 inline RocksDBCollection* toRocksDBCollection(PhysicalCollection* physical) {
@@ -23,6 +23,11 @@
 #ifndef ARANGOD_ROCKSDB_ENGINE_COLUMN_FAMILY_H
 #define ARANGOD_ROCKSDB_ENGINE_COLUMN_FAMILY_H 1
 
+#include "Basics/Common.h"
+#include "Basics/ReadLocker.h"
+#include "Basics/ReadWriteLock.h"
+#include "Basics/StringUtils.h"
+
 #include <rocksdb/db.h>
 
 namespace arangodb {
@@ -46,6 +51,69 @@ struct RocksDBColumnFamily {
 
   static rocksdb::ColumnFamilyHandle* documents() { return _documents; }
 
+  /// documents column family of the collection with the given object id.
+  /// this is the shared documents family unless the collection was created
+  /// with a dedicated column family
+  static rocksdb::ColumnFamilyHandle* documents(uint64_t objectId) {
+    if (_numDedicated.load(std::memory_order_relaxed) > 0) {
+      READ_LOCKER(guard, _dedicatedLock);
+      auto it = _dedicated.find(objectId);
+      if (it != _dedicated.end()) {
+        return it->second;
+      }
+    }
+    return _documents;
+  }
+
+  /// whether or not the column family with the given id stores documents
+  static bool isDocuments(uint32_t id) {
+    if (id == _documents->GetID()) {
+      return true;
+    }
+    if (_numDedicated.load(std::memory_order_relaxed) > 0) {
+      READ_LOCKER(guard, _dedicatedLock);
+      return _dedicatedIds.find(id) != _dedicatedIds.end();
+    }
+    return false;
+  }
+
+  /// name of the dedicated documents column family of a collection
+  static std::string dedicatedName(uint64_t objectId) {
+    return DedicatedPrefix + std::to_string(objectId);
+  }
+
+  /// object id of the collection owning a dedicated documents column
+  /// family, 0 if the name is not one of a dedicated family
+  static uint64_t dedicatedObjectId(std::string const& name) {
+    if (name.compare(0, DedicatedPrefix.size(), DedicatedPrefix) != 0) {
+      return 0;
+    }
+    return basics::StringUtils::uint64(name.substr(DedicatedPrefix.size()));
+  }
+
+  /// the dedicated documents column families by collection object id
+  static std::vector<std::pair<uint64_t, rocksdb::ColumnFamilyHandle*>>
+  dedicated() {
+    std::vector<std::pair<uint64_t, rocksdb::ColumnFamilyHandle*>> result;
+    READ_LOCKER(guard, _dedicatedLock);
+    result.assign(_dedicated.begin(), _dedicated.end());
+    return result;
+  }
+
+  /// object ids of the dedicated column families that belong to none of
+  /// the given collections
+  static std::vector<uint64_t> orphaned(
+      std::vector<uint64_t> const& dedicated,
+      std::unordered_set<uint64_t> const& collections) {
+    std::vector<uint64_t> result;
+    for (uint64_t objectId : dedicated) {
+      if (collections.find(objectId) == collections.end()) {
+        result.emplace_back(objectId);
+      }
+    }
+    return result;
+  }
+
   static rocksdb::ColumnFamilyHandle* primary() { return _primary; }
 
   static rocksdb::ColumnFamilyHandle* edge() { return _edge; }
@@ -79,6 +147,9 @@ struct RocksDBColumnFamily {
     if (cf == _fulltext) {
       return "fulltext";
     }
+    if (isDocuments(cf->GetID())) {
+      return "documents";
+    }
     TRI_ASSERT(false);
     return "unknown";
   }
@@ -92,6 +163,13 @@ struct RocksDBColumnFamily {
   static rocksdb::ColumnFamilyHandle* _geo;
   static rocksdb::ColumnFamilyHandle* _fulltext;
   static std::vector<rocksdb::ColumnFamilyHandle*> _allHandles;
+
+  static std::string const DedicatedPrefix;
+  /// dedicated documents column families by collection object id
+  static basics::ReadWriteLock _dedicatedLock;
+  static std::unordered_map<uint64_t, rocksdb::ColumnFamilyHandle*> _dedicated;
+  static std::unordered_set<uint32_t> _dedicatedIds;
+  static std::atomic<size_t> _numDedicated;
 };
 
 }  // namespace arangodb
@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RocksDBCompactionThrottle.h"
+#include "Basics/ConditionLocker.h"
+#include "Logger/Logger.h"
+#include "Scheduler/Scheduler.h"
+#include "Scheduler/SchedulerFeature.h"
+
+using namespace arangodb;
+
+RocksDBCompactionThrottle::RocksDBCompactionThrottle(
+    std::shared_ptr<rocksdb::RateLimiter> limiter, int64_t maxRate,
+    bool autoTune, uint64_t queueLength)
+    : Thread("RocksDBThrottle"),
+      _limiter(limiter),
+      _maxRate(maxRate),
+      _minRate((std::max)(maxRate / MinRateFraction, static_cast<int64_t>(1))),
+      _autoTune(autoTune),
+      _queueLength(queueLength),
+      _numThrottles(0) {}
+
+RocksDBCompactionThrottle::~RocksDBCompactionThrottle() { shutdown(); }
+
+void RocksDBCompactionThrottle::beginShutdown() {
+  Thread::beginShutdown();
+
+  CONDITION_LOCKER(guard, _condition);
+  guard.signal();
+}
+
+void RocksDBCompactionThrottle::run() {
+  int64_t lastBytes = _limiter->GetTotalBytesThrough();
+
+  while (!isStopping()) {
+    {
+      CONDITION_LOCKER(guard, _condition);
+      guard.wait(static_cast<uint64_t>(Interval * 1000000.0));
+    }
+    if (isStopping()) {
+      break;
+    }
+
+    int64_t const bytes = _limiter->GetTotalBytesThrough();
+    int64_t const current = _limiter->GetBytesPerSecond();
+    int64_t const rate = nextRate(current, bytes - lastBytes);
+    lastBytes = bytes;
+
+    if (rate != current) {
+      LOG_TOPIC(TRACE, Logger::ROCKSDB)
+          << "adjusting rocksdb background write rate from " << current
+          << " to " << rate << " bytes/s";
+      _limiter->SetBytesPerSecond(rate);
+    }
+  }
+
+  // leave the configured limit behind for the final flushes
+  _limiter->SetBytesPerSecond(_maxRate);
+}
+
+int64_t RocksDBCompactionThrottle::nextRate(int64_t current,
+                                            int64_t bytesThrough) {
+  auto scheduler = SchedulerFeature::SCHEDULER;
+  if (_queueLength > 0 && scheduler != nullptr &&
+      scheduler->numQueued() > _queueLength) {
+    // requests are piling up, give them the disk
+    ++_numThrottles;
+    return (std::max)(current / 2, _minRate);
+  }
+
+  if (_autoTune) {
+    double const used = static_cast<double>(bytesThrough) /
+                        (static_cast<double>(current) * Interval);
+    if (used >= 0.9) {
+      // background writes are waiting for the limiter
+      return (std::min)(current + current / 4 + 1, _maxRate);
+    }
+    if (used < 0.5) {
+      return (std::max)(current - current / 10, _minRate);
+    }
+    return current;
+  }
+
+  // no pressure anymore, go back to the configured limit
+  return (std::min)(current + current / 4 + 1, _maxRate);
+}
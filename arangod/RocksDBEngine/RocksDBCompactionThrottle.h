@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_ROCKSDB_ENGINE_COMPACTION_THROTTLE_H
+#define ARANGOD_ROCKSDB_ENGINE_COMPACTION_THROTTLE_H 1
+
+#include "Basics/Common.h"
+#include "Basics/ConditionVariable.h"
+#include "Basics/Thread.h"
+
+#include <rocksdb/rate_limiter.h>
+
+namespace arangodb {
+
+/// @brief adjusts the rate limiter of flushes and compactions. while the
+/// scheduler queue is longer than the configured length, the limit is
+/// halved, so that background writes leave the disk to the requests.
+/// otherwise the limit recovers, or with auto tuning follows the usage:
+/// it grows while the limiter is drained and shrinks while it is idle
+class RocksDBCompactionThrottle : public Thread {
+ public:
+  /// @brief maxRate is the configured limit in bytes per second.
+  /// queueLength 0 disables throttling on the scheduler queue
+  RocksDBCompactionThrottle(std::shared_ptr<rocksdb::RateLimiter> limiter,
+                            int64_t maxRate, bool autoTune,
+                            uint64_t queueLength);
+  ~RocksDBCompactionThrottle();
+
+  void beginShutdown() override;
+
+  /// @brief number of adjustments caused by a long scheduler queue
+  uint64_t numThrottles() const { return _numThrottles.load(); }
+
+ protected:
+  void run() override;
+
+ private:
+  /// @brief computes the limit for the next interval
+  int64_t nextRate(int64_t current, int64_t bytesThrough);
+
+ private:
+  /// @brief interval (in seconds) in which the limit is adjusted
+  static constexpr double Interval = 0.25;
+
+  /// @brief the limit never drops below this fraction of the configured
+  /// rate, so that compactions still make progress under load
+  static constexpr int64_t MinRateFraction = 16;
+
+  std::shared_ptr<rocksdb::RateLimiter> _limiter;
+
+  int64_t const _maxRate;
+
+  int64_t const _minRate;
+
+  bool const _autoTune;
+
+  uint64_t const _queueLength;
+
+  std::atomic<uint64_t> _numThrottles;
+
+  arangodb::basics::ConditionVariable _condition;
+};
+}  // namespace arangodb
+
+#endif
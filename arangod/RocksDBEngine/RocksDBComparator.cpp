@@ -57,9 +57,14 @@ int RocksDBVPackComparator::compareIndexValues(
   VPackSlice const lSlice = VPackSlice(lhs.data() + sizeof(uint64_t));
   VPackSlice const rSlice = VPackSlice(rhs.data() + sizeof(uint64_t));
 
-  r = compareIndexedValues(lSlice, rSlice);
-  if (r != 0) {
-    return r;
+  // entries of a non-unique index often share their values and only differ
+  // in the revision id, and identical VelocyPack is always equal, so we can
+  // skip the value-wise comparison for them
+  if (!sameBytes(lSlice, rSlice)) {
+    r = compareIndexedValues(lSlice, rSlice);
+    if (r != 0) {
+      return r;
+    }
   }
 
   constexpr size_t offset = sizeof(uint64_t);
@@ -97,9 +102,9 @@ int RocksDBVPackComparator::compareIndexedValues(VPackSlice const& lhs,
 
   while (lhsIter.valid() || rhsIter.valid()) {
     size_t i = lhsIter.index();
-    int res = arangodb::basics::VelocyPackHelper::compare(
-        (i < lLength ? *lhsIter : VPackSlice::noneSlice()),
-        (i < rLength ? *rhsIter : VPackSlice::noneSlice()), true);
+    VPackSlice const l = (i < lLength ? *lhsIter : VPackSlice::noneSlice());
+    VPackSlice const r = (i < rLength ? *rhsIter : VPackSlice::noneSlice());
+    int res = compareIndexedValue(l, r);
     if (res != 0) {
       return res;
     }
@@ -113,3 +118,30 @@ int RocksDBVPackComparator::compareIndexedValues(VPackSlice const& lhs,
 
   return 0;
 }
+
+int RocksDBVPackComparator::compareIndexedValue(VPackSlice const& lhs,
+                                                VPackSlice const& rhs) const {
+  // integers of the same VelocyPack type are compared exactly by
+  // VelocyPackHelper::compare as well, but without the type weight
+  // lookup and the dispatch on the type
+  if (lhs.isSmallInt() || lhs.isInt()) {
+    if (rhs.isSmallInt() || rhs.isInt()) {
+      int64_t l = lhs.getIntUnchecked();
+      int64_t r = rhs.getIntUnchecked();
+      return (l == r ? 0 : (l < r ? -1 : 1));
+    }
+  } else if (lhs.isUInt() && rhs.isUInt()) {
+    uint64_t l = lhs.getUIntUnchecked();
+    uint64_t r = rhs.getUIntUnchecked();
+    return (l == r ? 0 : (l < r ? -1 : 1));
+  }
+
+  // strings are compared with the ICU collator, which is by far the most
+  // expensive part of a comparison. equal strings are common in indexes,
+  // and identical bytes are always equal for the collator too
+  if (sameBytes(lhs, rhs)) {
+    return 0;
+  }
+
+  return arangodb::basics::VelocyPackHelper::compare(lhs, rhs, true);
+}
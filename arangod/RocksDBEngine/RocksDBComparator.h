@@ -95,6 +95,24 @@ class RocksDBVPackComparator final : public rocksdb::Comparator {
   /// @brief A helper function for the actual VelocyPack comparison
   //////////////////////////////////////////////////////////////////////////////
   int compareIndexedValues(VPackSlice const& lhs, VPackSlice const& rhs) const;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Compares two members of the indexed VelocyPack arrays, with fast
+  /// paths for integers and identical values
+  //////////////////////////////////////////////////////////////////////////////
+  int compareIndexedValue(VPackSlice const& lhs, VPackSlice const& rhs) const;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Whether two VelocyPack values are byte-wise identical
+  //////////////////////////////////////////////////////////////////////////////
+  static inline bool sameBytes(VPackSlice const& lhs, VPackSlice const& rhs) {
+    if (lhs.head() != rhs.head()) {
+      return false;
+    }
+    auto const size = lhs.byteSize();
+    return (size == rhs.byteSize() &&
+            memcmp(lhs.start(), rhs.start(), static_cast<size_t>(size)) == 0);
+  }
 };
 
 }  // namespace arangodb
@@ -37,6 +37,7 @@
 #include "RocksDBEngine/RocksDBEdgeIndex.h"
 #include "RocksDBEngine/RocksDBKey.h"
 #include "RocksDBEngine/RocksDBKeyBounds.h"
+#include "RocksDBEngine/RocksDBLogValue.h"
 #include "RocksDBEngine/RocksDBVPackIndex.h"
 #include "RocksDBEngine/RocksDBValue.h"
 #include "StorageEngine/EngineSelectorFeature.h"
@@ -141,12 +142,14 @@ void RocksDBCounterManager::updateCounter(uint64_t objectId,
         it->second._sequenceNum = update.sequenceNumber();
         it->second._revisionId = update.revisionId();
       }
+      _dirty.insert(objectId);
     } else {
       // insert new counter
       _counters.emplace(std::make_pair(
           objectId,
           CMValue(update.sequenceNumber(), update.added() - update.removed(),
                   update.revisionId())));
+      _dirty.insert(objectId);
       needsSync = true;  // only count values from WAL if they are in the DB
     }
   }
@@ -162,6 +165,7 @@ arangodb::Result RocksDBCounterManager::setAbsoluteCounter(uint64_t objectId,
   auto it = _counters.find(objectId);
   if (it != _counters.end()) {
     it->second._count = value;
+    _dirty.insert(objectId);
   } else {
     // nothing to do as the counter has never been written it can not be set to
     // a value that would require correction. but we use the return value to
@@ -171,6 +175,23 @@ arangodb::Result RocksDBCounterManager::setAbsoluteCounter(uint64_t objectId,
   return res;
 }
 
+void RocksDBCounterManager::truncateCounter(uint64_t objectId,
+                                            rocksdb::SequenceNumber seq,
+                                            TRI_voc_rid_t revisionId) {
+  WRITE_LOCKER(guard, _rwLock);
+  auto it = _counters.find(objectId);
+  if (it != _counters.end()) {
+    it->second._count = 0;
+    if (seq > it->second._sequenceNum) {
+      it->second._sequenceNum = seq;
+      it->second._revisionId = revisionId;
+    }
+  } else {
+    _counters.emplace(objectId, CMValue(seq, 0, revisionId));
+  }
+  _dirty.insert(objectId);
+}
+
 void RocksDBCounterManager::removeCounter(uint64_t objectId) {
   WRITE_LOCKER(guard, _rwLock);
   auto const& it = _counters.find(objectId);
@@ -183,6 +204,12 @@ void RocksDBCounterManager::removeCounter(uint64_t objectId) {
     }
     _counters.erase(it);
   }
+  _dirty.erase(objectId);
+}
+
+void RocksDBCounterManager::markDirty(uint64_t objectId) {
+  WRITE_LOCKER(guard, _rwLock);
+  _dirty.insert(objectId);
 }
 
 /// Thread-Safe force sync
@@ -209,32 +236,69 @@ Result RocksDBCounterManager::sync(bool force) {
 
   TRI_DEFER(_syncing = false);
 
-  std::unordered_map<uint64_t, CMValue> copy;
-  {  // block all updates
+  std::unordered_set<uint64_t> dirty;
+  std::unordered_map<uint64_t, CMValue> values;
+  {  // block updates only while taking the changed values
     WRITE_LOCKER(guard, _rwLock);
-    copy = _counters;
+    dirty.swap(_dirty);
+    values.reserve(dirty.size());
+    for (uint64_t objectId : dirty) {
+      auto const& it = _counters.find(objectId);
+      if (it != _counters.end()) {
+        values.emplace(objectId, it->second);
+      }
+    }
   }
 
+  std::vector<uint64_t> const objectIds(dirty.begin(), dirty.end());
+  auto begin = objectIds.cbegin();
+  while (true) {
+    size_t const remaining = static_cast<size_t>(objectIds.cend() - begin);
+    auto end = begin + (remaining > SyncBatchSize ? SyncBatchSize : remaining);
+    // the server tick goes into the last batch
+    Result res = syncObjects(begin, end, values, end == objectIds.cend());
+    if (res.fail()) {
+      // everything not yet persisted is retried by the next sync
+      WRITE_LOCKER(guard, _rwLock);
+      for (auto it = begin; it != objectIds.cend(); ++it) {
+        if (_counters.find(*it) != _counters.end()) {
+          _dirty.insert(*it);
+        }
+      }
+      return res;
+    }
+    if (end == objectIds.cend()) {
+      break;
+    }
+    begin = end;
+  }
+
+  return Result();
+}
+
+Result RocksDBCounterManager::syncObjects(
+    std::vector<uint64_t>::const_iterator begin,
+    std::vector<uint64_t>::const_iterator end,
+    std::unordered_map<uint64_t, CMValue> const& values, bool withSettings) {
   rocksdb::WriteOptions writeOptions;
   rocksdb::TransactionDB* db = rocksutils::globalRocksDB();
   std::unique_ptr<rocksdb::Transaction> rtrx(
       db->BeginTransaction(writeOptions));
 
   VPackBuilder b;
-  for (std::pair<uint64_t, CMValue> const& pair : copy) {
-    // Skip values which we did not change
-    auto const& it = _syncedSeqNums.find(pair.first);
-    if (it != _syncedSeqNums.end() && it->second == pair.second._sequenceNum) {
+  for (auto it = begin; it != end; ++it) {
+    auto const& value = values.find(*it);
+    if (value == values.end()) {
       continue;
     }
 
     b.clear();
-    pair.second.serialize(b);
+    value->second.serialize(b);
 
-    RocksDBKey key = RocksDBKey::CounterValue(pair.first);
-    rocksdb::Slice value((char*)b.start(), b.size());
+    RocksDBKey key = RocksDBKey::CounterValue(value->first);
+    rocksdb::Slice slice((char*)b.start(), b.size());
     rocksdb::Status s = rtrx->Put(RocksDBColumnFamily::definitions(),
-                                  key.string(), value);
+                                  key.string(), slice);
     if (!s.ok()) {
       rtrx->Rollback();
       LOG_TOPIC(WARN, Logger::ENGINES) << "writing counters failed";
@@ -242,83 +306,74 @@ Result RocksDBCounterManager::sync(bool force) {
     }
   }
 
-  // now write global settings
-  b.clear();
-  b.openObject();
-  b.add("tick", VPackValue(std::to_string(TRI_CurrentTickServer())));
-  b.add("hlc", VPackValue(std::to_string(TRI_HybridLogicalClock())));
-  b.close();
+  if (withSettings) {
+    // now write global settings
+    b.clear();
+    b.openObject();
+    b.add("tick", VPackValue(std::to_string(TRI_CurrentTickServer())));
+    b.add("hlc", VPackValue(std::to_string(TRI_HybridLogicalClock())));
+    b.close();
 
-  VPackSlice slice = b.slice();
-  LOG_TOPIC(TRACE, Logger::ENGINES) << "writing settings: " << slice.toJson();
+    VPackSlice slice = b.slice();
+    LOG_TOPIC(TRACE, Logger::ENGINES) << "writing settings: " << slice.toJson();
 
-  RocksDBKey key = RocksDBKey::SettingsValue(RocksDBSettingsType::ServerTick);
-  rocksdb::Slice value(slice.startAs<char>(), slice.byteSize());
+    RocksDBKey key = RocksDBKey::SettingsValue(RocksDBSettingsType::ServerTick);
+    rocksdb::Slice value(slice.startAs<char>(), slice.byteSize());
 
-  rocksdb::Status s = rtrx->Put(RocksDBColumnFamily::definitions(),
-                                key.string(), value);
+    rocksdb::Status s = rtrx->Put(RocksDBColumnFamily::definitions(),
+                                  key.string(), value);
 
-  if (!s.ok()) {
-    LOG_TOPIC(WARN, Logger::ENGINES) << "writing settings failed";
-    rtrx->Rollback();
-    return rocksutils::convertStatus(s);
+    if (!s.ok()) {
+      LOG_TOPIC(WARN, Logger::ENGINES) << "writing settings failed";
+      rtrx->Rollback();
+      return rocksutils::convertStatus(s);
+    }
   }
 
   // Now persist the index estimates and key generators
-  {
-    for (auto const& pair : copy) {
-      auto dbColPair = rocksutils::mapObjectToCollection(pair.first);
-      if (dbColPair.second == 0 && dbColPair.first == 0) {
-        // collection with this objectID not known.Skip.
-        continue;
-      }
-      auto dbfeature =
-          ApplicationServer::getFeature<DatabaseFeature>("Database");
-      TRI_ASSERT(dbfeature != nullptr);
-      auto vocbase = dbfeature->useDatabase(dbColPair.first);
-      if (vocbase == nullptr) {
-        // Bad state, we have references to a database that is not known
-        // anymore.
-        // However let's just skip in production. Not allowed to crash.
-        // If we cannot find this infos during recovery we can either recompute
-        // or start fresh.
-        continue;
-      }
-      TRI_DEFER(vocbase->release());
-
-      auto collection = vocbase->lookupCollection(dbColPair.second);
-      if (collection == nullptr) {
-        // Bad state, we have references to a collection that is not known
-        // anymore.
-        // However let's just skip in production. Not allowed to crash.
-        // If we cannot find this infos during recovery we can either recompute
-        // or start fresh.
-        continue;
-      }
-      auto rocksCollection =
-          static_cast<RocksDBCollection*>(collection->getPhysical());
-      TRI_ASSERT(rocksCollection != nullptr);
-      Result res = rocksCollection->serializeIndexEstimates(rtrx.get());
-      if (!res.ok()) {
-        return res;
-      }
-
-      res = rocksCollection->serializeKeyGenerator(rtrx.get());
-      if (!res.ok()) {
-        return res;
-      }
+  auto dbfeature = ApplicationServer::getFeature<DatabaseFeature>("Database");
+  TRI_ASSERT(dbfeature != nullptr);
+  for (auto it = begin; it != end; ++it) {
+    auto dbColPair = rocksutils::mapObjectToCollection(*it);
+    if (dbColPair.second == 0 && dbColPair.first == 0) {
+      // collection with this objectID not known.Skip.
+      continue;
+    }
+    auto vocbase = dbfeature->useDatabase(dbColPair.first);
+    if (vocbase == nullptr) {
+      // Bad state, we have references to a database that is not known
+      // anymore.
+      // However let's just skip in production. Not allowed to crash.
+      // If we cannot find this infos during recovery we can either recompute
+      // or start fresh.
+      continue;
+    }
+    TRI_DEFER(vocbase->release());
+
+    auto collection = vocbase->lookupCollection(dbColPair.second);
+    if (collection == nullptr) {
+      // Bad state, we have references to a collection that is not known
+      // anymore.
+      // However let's just skip in production. Not allowed to crash.
+      // If we cannot find this infos during recovery we can either recompute
+      // or start fresh.
+      continue;
+    }
+    auto rocksCollection =
+        static_cast<RocksDBCollection*>(collection->getPhysical());
+    TRI_ASSERT(rocksCollection != nullptr);
+    Result res = rocksCollection->serializeIndexEstimates(rtrx.get());
+    if (!res.ok()) {
+      return res;
     }
-  }
 
-  // we have to commit all counters in one batch
-  s = rtrx->Commit();
-  if (s.ok()) {
-    for (std::pair<uint64_t, CMValue> const& pair : copy) {
-      _syncedSeqNums[pair.first] = pair.second._sequenceNum;
+    res = rocksCollection->serializeKeyGenerator(rtrx.get());
+    if (!res.ok()) {
+      return res;
     }
   }
 
-  return rocksutils::convertStatus(s);
+  return rocksutils::convertStatus(rtrx->Commit());
 }
 
 void RocksDBCounterManager::readSettings() {
@@ -379,12 +434,10 @@ void RocksDBCounterManager::readIndexEstimates() {
     try {
       if (RocksDBCuckooIndexEstimator<uint64_t>::isFormatSupported(
               estimateSerialisation)) {
+        // deserialized on first use
         _estimators.emplace(
             objectId,
-            std::make_pair(
-                lastSeqNumber,
-                std::make_unique<RocksDBCuckooIndexEstimator<uint64_t>>(
-                    estimateSerialisation)));
+            StoredEstimator(lastSeqNumber, estimateSerialisation.toString()));
       }
     } catch (...) {
       // Nothing to do, if the estimator fails to create we let it be recreated.
@@ -421,20 +474,41 @@ void RocksDBCounterManager::readKeyGenerators() {
   }
 }
 
+RocksDBCuckooIndexEstimator<uint64_t>*
+RocksDBCounterManager::StoredEstimator::estimator() {
+  if (_estimator == nullptr && !_serialized.empty()) {
+    try {
+      _estimator = std::make_unique<RocksDBCuckooIndexEstimator<uint64_t>>(
+          StringRef(_serialized.data(), _serialized.size()));
+    } catch (...) {
+      // the index recalculates its estimate
+    }
+    std::string().swap(_serialized);
+  }
+  return _estimator.get();
+}
+
 std::unique_ptr<RocksDBCuckooIndexEstimator<uint64_t>>
 RocksDBCounterManager::stealIndexEstimator(uint64_t objectId) {
-  std::unique_ptr<RocksDBCuckooIndexEstimator<uint64_t>> res(nullptr);
-  auto it = _estimators.find(objectId);
-  if (it != _estimators.end()) {
-    // We swap out the stored estimate in order to move it to the caller
-    res.swap(it->second.second);
-    // Drop the now empty estimator
-    _estimators.erase(objectId);
+  StoredEstimator stored;
+  {
+    // indexes of different collections take over their estimates
+    // concurrently
+    WRITE_LOCKER(guard, _rwLock);
+    auto it = _estimators.find(objectId);
+    if (it == _estimators.end()) {
+      return nullptr;
+    }
+    stored = std::move(it->second);
+    _estimators.erase(it);
   }
-  return res;
+  // deserialize outside of the lock
+  stored.estimator();
+  return std::move(stored._estimator);
 }
 
 uint64_t RocksDBCounterManager::stealKeyGenerator(uint64_t objectId) {
+  WRITE_LOCKER(guard, _rwLock);
   uint64_t res = 0;
   auto it = _generators.find(objectId);
   if (it != _generators.end()) {
@@ -470,9 +544,7 @@ void RocksDBCounterManager::readCounterValues() {
 
   while (iter->Valid() && cmp->Compare(iter->key(), bounds.end()) < 0) {
     uint64_t objectId = RocksDBKey::definitionsObjectId(iter->key());
-    auto const& it =
-        _counters.emplace(objectId, CMValue(VPackSlice(iter->value().data())));
-    _syncedSeqNums[objectId] = it.first->second._sequenceNum;
+    _counters.emplace(objectId, CMValue(VPackSlice(iter->value().data())));
 
     iter->Next();
   }
@@ -485,10 +557,9 @@ class WBReader final : public rocksdb::WriteBatch::Handler {
   // must be set by the counter manager
   std::unordered_map<uint64_t, rocksdb::SequenceNumber> seqStart;
   std::unordered_map<uint64_t, RocksDBCounterManager::CounterAdjustment> deltas;
-  std::unordered_map<
-      uint64_t,
-      std::pair<uint64_t,
-                std::unique_ptr<RocksDBCuckooIndexEstimator<uint64_t>>>>*
+  // collections truncated by range deletion. their deltas start from zero
+  std::unordered_set<uint64_t> truncated;
+  std::unordered_map<uint64_t, RocksDBCounterManager::StoredEstimator>*
       _estimators;
   std::unordered_map<uint64_t, uint64_t>* _generators;
   rocksdb::SequenceNumber currentSeqNum;
@@ -496,10 +567,7 @@ class WBReader final : public rocksdb::WriteBatch::Handler {
   uint64_t _maxHLC = 0;
 
   explicit WBReader(
-      std::unordered_map<
-          uint64_t,
-          std::pair<uint64_t,
-                    std::unique_ptr<RocksDBCuckooIndexEstimator<uint64_t>>>>*
+      std::unordered_map<uint64_t, RocksDBCounterManager::StoredEstimator>*
           estimators,
       std::unordered_map<uint64_t, uint64_t>* generators)
       : _estimators(estimators), _generators(generators), currentSeqNum(0) {}
@@ -515,19 +583,31 @@ class WBReader final : public rocksdb::WriteBatch::Handler {
 
   bool shouldHandleDocument(uint32_t column_family_id,
                             const rocksdb::Slice& key) {
-    if (column_family_id == RocksDBColumnFamily::documents()->GetID()) {
+    if (RocksDBColumnFamily::isDocuments(column_family_id)) {
       uint64_t objectId = RocksDBKey::objectId(key);
       auto const& it = seqStart.find(objectId);
       if (it != seqStart.end()) {
         if (deltas.find(objectId) == deltas.end()) {
           deltas.emplace(objectId, RocksDBCounterManager::CounterAdjustment());
         }
-        return it->second <= currentSeqNum;
+        // the synced counter value already contains all operations up to
+        // its sequence number
+        return it->second < currentSeqNum;
       }
     }
     return false;
   }
 
+  /// @brief the estimator of an index, if recovery has to apply the
+  /// current operation to it
+  RocksDBCuckooIndexEstimator<uint64_t>* findEstimator(uint64_t objectId) {
+    auto it = _estimators->find(objectId);
+    if (it == _estimators->end() || it->second._sequenceNum >= currentSeqNum) {
+      return nullptr;
+    }
+    return it->second.estimator();
+  }
+
   void storeMaxHLC(uint64_t hlc) {
     if (hlc > _maxHLC) {
       _maxHLC = hlc;
@@ -572,7 +652,7 @@ class WBReader final : public rocksdb::WriteBatch::Handler {
     //          - documents - _rev (revision as maxtick)
     //          - databases
 
-    if (column_family_id == RocksDBColumnFamily::documents()->GetID()) {
+    if (RocksDBColumnFamily::isDocuments(column_family_id)) {
       storeMaxHLC(RocksDBKey::revisionId(RocksDBEntryType::Document, key));
       storeLastKeyValue(RocksDBKey::objectId(key),
                         RocksDBValue::keyValue(value));
@@ -638,25 +718,56 @@ class WBReader final : public rocksdb::WriteBatch::Handler {
       // We have to adjust the estimate with an insert
       if (column_family_id == RocksDBColumnFamily::vpack()->GetID()) {
         uint64_t objectId = RocksDBKey::objectId(key);
-        auto it = _estimators->find(objectId);
-        if (it != _estimators->end() && it->second.first < currentSeqNum) {
+        auto estimator = findEstimator(objectId);
+        if (estimator != nullptr) {
           // We track estimates for this index
           uint64_t hash = RocksDBVPackIndex::HashForKey(key);
-          it->second.second->insert(hash);
+          estimator->insert(hash);
         }
       } else if (column_family_id == RocksDBColumnFamily::edge()->GetID()) {
         uint64_t objectId = RocksDBKey::objectId(key);
-        auto it = _estimators->find(objectId);
-        if (it != _estimators->end() && it->second.first < currentSeqNum) {
+        auto estimator = findEstimator(objectId);
+        if (estimator != nullptr) {
           // We track estimates for this index
           uint64_t hash = RocksDBEdgeIndex::HashForKey(key);
-          it->second.second->insert(hash);
+          estimator->insert(hash);
         }
       }
     }
     return rocksdb::Status();
   }
 
+  void LogData(rocksdb::Slice const& blob) override {
+    if (RocksDBLogValue::type(blob) != RocksDBLogType::CollectionTruncate) {
+      return;
+    }
+    // the documents were removed with a range deletion, so the count
+    // restarts at zero
+    uint64_t objectId = RocksDBLogValue::objectId(blob);
+    auto const& it = seqStart.find(objectId);
+    if (it != seqStart.end() && it->second < currentSeqNum) {
+      deltas[objectId] = RocksDBCounterManager::CounterAdjustment(
+          currentSeqNum, 0, 0, 0);
+      truncated.insert(objectId);
+    }
+  }
+
+  rocksdb::Status DeleteRangeCF(uint32_t column_family_id,
+                                const rocksdb::Slice& begin_key,
+                                const rocksdb::Slice&) override {
+    // range deletions are only written by a truncate, whose counter reset
+    // is handled by its log marker. index estimates are reset here
+    if (column_family_id == RocksDBColumnFamily::vpack()->GetID() ||
+        column_family_id == RocksDBColumnFamily::edge()->GetID()) {
+      uint64_t objectId = RocksDBKey::objectId(begin_key);
+      auto estimator = findEstimator(objectId);
+      if (estimator != nullptr) {
+        estimator->clear();
+      }
+    }
+    return rocksdb::Status();
+  }
+
   rocksdb::Status DeleteCF(uint32_t column_family_id,
                            const rocksdb::Slice& key) override {
     if (shouldHandleDocument(column_family_id, key)) {
@@ -674,19 +785,19 @@ class WBReader final : public rocksdb::WriteBatch::Handler {
       // We have to adjust the estimate with an remove
       if (column_family_id == RocksDBColumnFamily::vpack()->GetID()) {
         uint64_t objectId = RocksDBKey::objectId(key);
-        auto it = _estimators->find(objectId);
-        if (it != _estimators->end() && it->second.first < currentSeqNum) {
+        auto estimator = findEstimator(objectId);
+        if (estimator != nullptr) {
           // We track estimates for this index
           uint64_t hash = RocksDBVPackIndex::HashForKey(key);
-          it->second.second->remove(hash);
+          estimator->remove(hash);
         }
       } else if (column_family_id == RocksDBColumnFamily::edge()->GetID()) {
         uint64_t objectId = RocksDBKey::objectId(key);
-        auto it = _estimators->find(objectId);
-        if (it != _estimators->end() && it->second.first < currentSeqNum) {
+        auto estimator = findEstimator(objectId);
+        if (estimator != nullptr) {
           // We track estimates for this index
           uint64_t hash = RocksDBEdgeIndex::HashForKey(key);
-          it->second.second->remove(hash);
+          estimator->remove(hash);
         }
       }
     }
@@ -737,9 +848,13 @@ bool RocksDBCounterManager::parseRocksWAL() {
     auto const& it = _counters.find(pair.first);
     if (it != _counters.end()) {
       it->second._sequenceNum = start;
+      if (handler->truncated.find(pair.first) != handler->truncated.end()) {
+        it->second._count = 0;
+      }
       it->second._count += pair.second.added();
       it->second._count -= pair.second.removed();
       it->second._revisionId = pair.second._revisionId;
+      _dirty.insert(pair.first);
       LOG_TOPIC(TRACE, Logger::ENGINES)
           << "WAL recovered " << pair.second.added() << " PUTs and "
           << pair.second.removed() << " DELETEs for a total of "
@@ -35,6 +35,7 @@
 #include <velocypack/Builder.h>
 #include <velocypack/Slice.h>
 #include <atomic>
+#include <unordered_set>
 
 namespace rocksdb {
 class DB;
@@ -85,12 +86,41 @@ class RocksDBCounterManager {
   arangodb::Result setAbsoluteCounter(uint64_t objectId,
                                       uint64_t absouluteCount);
 
+  /// Thread-Safe reset a counter to zero after the collection was truncated
+  /// outside of a transaction, with the truncate marker at seq
+  void truncateCounter(uint64_t objectId, rocksdb::SequenceNumber seq,
+                       TRI_voc_rid_t revisionId);
+
   /// Thread-Safe remove a counter
   void removeCounter(uint64_t objectId);
 
-  /// Thread-Safe force sync
+  /// Thread-Safe mark the collection with this object id as changed, so
+  /// that the next sync persists its index estimates and key generator
+  void markDirty(uint64_t objectId);
+
+  /// Thread-Safe force sync. only persists the objects changed since the
+  /// last sync, in batches of SyncBatchSize objects. writers are only
+  /// blocked while the changed values are collected
   arangodb::Result sync(bool force);
 
+  /// @brief a stored index estimate. it is only deserialized when recovery
+  /// applies a change to it or when its index takes it over, which happens
+  /// concurrently for the collections opened on startup
+  struct StoredEstimator {
+    StoredEstimator() : _sequenceNum(0) {}
+    StoredEstimator(uint64_t sequenceNum, std::string&& serialized)
+        : _sequenceNum(sequenceNum), _serialized(std::move(serialized)) {}
+
+    /// @brief returns the estimator, deserializing it on first use. returns
+    /// nullptr if the stored estimate is invalid
+    arangodb::RocksDBCuckooIndexEstimator<uint64_t>* estimator();
+
+    /// @brief sequence number up to which the estimate was persisted
+    uint64_t _sequenceNum;
+    std::string _serialized;
+    std::unique_ptr<arangodb::RocksDBCuckooIndexEstimator<uint64_t>> _estimator;
+  };
+
   // Steal the index estimator that the recovery has built up to inject it into
   // an index.
   // NOTE: If this returns nullptr the recovery was not ably to find any
@@ -129,11 +159,21 @@ class RocksDBCounterManager {
     void serialize(arangodb::velocypack::Builder&) const;
   };
 
+  /// @brief number of objects persisted together in one batch by sync
+  static constexpr size_t SyncBatchSize = 256;
+
   void readCounterValues();
   void readSettings();
   void readIndexEstimates();
   void readKeyGenerators();
 
+  /// @brief persists the counters, index estimates and key generators of
+  /// the given objects in one batch, and the server tick if requested
+  arangodb::Result syncObjects(
+      std::vector<uint64_t>::const_iterator begin,
+      std::vector<uint64_t>::const_iterator end,
+      std::unordered_map<uint64_t, CMValue> const& values, bool withSettings);
+
   bool parseRocksWAL();
 
   //////////////////////////////////////////////////////////////////////////////
@@ -151,16 +191,12 @@ class RocksDBCounterManager {
   ///        Note the elements in this container will be moved into the
   ///        index classes and are only temporarily stored here during recovery.
   //////////////////////////////////////////////////////////////////////////////
-  std::unordered_map<
-      uint64_t,
-      std::pair<uint64_t,
-                std::unique_ptr<RocksDBCuckooIndexEstimator<uint64_t>>>>
-      _estimators;
+  std::unordered_map<uint64_t, StoredEstimator> _estimators;
 
   //////////////////////////////////////////////////////////////////////////////
-  /// @brief synced sequence numbers
+  /// @brief objects changed since the last sync
   //////////////////////////////////////////////////////////////////////////////
-  std::unordered_map<uint64_t, rocksdb::SequenceNumber> _syncedSeqNums;
+  std::unordered_set<uint64_t> _dirty;
 
   //////////////////////////////////////////////////////////////////////////////
   /// @brief currently syncing
@@ -173,7 +209,7 @@ class RocksDBCounterManager {
   rocksdb::DB* _db;
 
   //////////////////////////////////////////////////////////////////////////////
-  /// @brief protect _syncing and _counters
+  /// @brief protect _counters and _dirty
   //////////////////////////////////////////////////////////////////////////////
   mutable basics::ReadWriteLock _rwLock;
 };
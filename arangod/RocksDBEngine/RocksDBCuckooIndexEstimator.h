@@ -331,6 +331,26 @@ class RocksDBCuckooIndexEstimator {
     return found;
   }
 
+  uint32_t count(Key const& k) const {
+    // return the number of elements stored with the fingerprint of key k.
+    // This may be larger than the real number if other keys share the
+    // fingerprint, and smaller if elements with this key were cuckood out.
+    uint64_t hash1 = _hasherKey(k);
+    uint64_t pos1 = hashToPos(hash1);
+    uint16_t fingerprint = keyToFingerprint(k);
+    uint64_t hash2 = _hasherPosFingerprint(pos1, fingerprint);
+    uint64_t pos2 = hashToPos(hash2);
+    bool found = false;
+    {
+      READ_LOCKER(guard, _bucketLock);
+      Slot slot = findSlotNoCuckoo(pos1, pos2, fingerprint, found);
+      if (found) {
+        return *slot.counter();
+      }
+    }
+    return 0;
+  }
+
   bool insert(Key const& k) {
     // insert the key k
     //
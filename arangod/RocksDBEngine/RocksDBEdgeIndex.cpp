@@ -63,6 +63,8 @@ using namespace arangodb::basics;
 
 namespace {
 constexpr bool EdgeIndexFillBlockCache = false;
+// maximum number of vertices looked up in the cache together
+constexpr size_t EdgeIndexCacheBatchSize = 64;
 }
 
 RocksDBEdgeIndexIterator::RocksDBEdgeIndexIterator(
@@ -75,7 +77,8 @@ RocksDBEdgeIndexIterator::RocksDBEdgeIndexIterator(
       _index(index),
       _bounds(RocksDBKeyBounds::EdgeIndex(0)),
       _cache(cache),
-      _builderIterator(arangodb::basics::VelocyPackHelper::EmptyArrayValue()) {
+      _builderIterator(arangodb::basics::VelocyPackHelper::EmptyArrayValue()),
+      _findingsPosition(0) {
   keys.release();  // now we have ownership for _keys
   TRI_ASSERT(_keys != nullptr);
   TRI_ASSERT(_keys->slice().isArray());
@@ -84,7 +87,7 @@ RocksDBEdgeIndexIterator::RocksDBEdgeIndexIterator(
   // intentional copy of the options
   rocksdb::ReadOptions options = mthds->readOptions();
   options.fill_cache = EdgeIndexFillBlockCache;
-  _iterator = mthds->NewIterator(options, index->columnFamily());
+  _iterator = mthds->NewIterator(options, _bounds, _upperBound);
 }
 
 RocksDBEdgeIndexIterator::~RocksDBEdgeIndexIterator() {
@@ -98,6 +101,8 @@ void RocksDBEdgeIndexIterator::resetInplaceMemory() { _builder.clear(); }
 
 void RocksDBEdgeIndexIterator::reset() {
   resetInplaceMemory();
+  _findings.clear();
+  _findingsPosition = 0;
   _keysIterator.reset();
   _builderIterator =
       VPackArrayIterator(arangodb::basics::VelocyPackHelper::EmptyArrayValue());
@@ -115,6 +120,7 @@ bool RocksDBEdgeIndexIterator::next(TokenCallback const& cb, size_t limit) {
   }
 #endif
 
+  TRI_DEFER(_findings.clear());
   while (limit > 0) {
     while (_builderIterator.valid()) {
       // We still have unreturned edges in out memory.
@@ -153,7 +159,10 @@ bool RocksDBEdgeIndexIterator::next(TokenCallback const& cb, size_t limit) {
     if (_cache) {
       for (size_t attempts = 0; attempts < 10; ++attempts) {
         // Try to read from cache
-        auto finding = _cache->find(fromTo.data(), (uint32_t)fromTo.size());
+        auto finding =
+            (attempts == 0)
+                ? nextFinding(limit)
+                : _cache->find(fromTo.data(), (uint32_t)fromTo.size());
         if (finding.found()) {
           needRocksLookup = false;
           // We got sth. in the cache
@@ -218,6 +227,7 @@ bool RocksDBEdgeIndexIterator::nextExtra(ExtraCallback const& cb,
   }
 #endif
 
+  TRI_DEFER(_findings.clear());
   while (limit > 0) {
     while (_builderIterator.valid()) {
       // We still have unreturned edges in out memory.
@@ -226,8 +236,10 @@ bool RocksDBEdgeIndexIterator::nextExtra(ExtraCallback const& cb,
       RocksDBToken tkn{_builderIterator.value().getNumericValue<uint64_t>()};
       _builderIterator.next();
       TRI_ASSERT(_builderIterator.valid());
-      // For now we store the complete opposite _from/_to value
-      TRI_ASSERT(_builderIterator.value().isString());
+      // the opposite _from/_to value, or the partial edge if the index
+      // stores edge attributes
+      TRI_ASSERT(_builderIterator.value().isString() ||
+                 _builderIterator.value().isObject());
 
       cb(tkn, _builderIterator.value());
 
@@ -258,7 +270,10 @@ bool RocksDBEdgeIndexIterator::nextExtra(ExtraCallback const& cb,
     if (_cache) {
       for (size_t attempts = 0; attempts < 10; ++attempts) {
         // Try to read from cache
-        auto finding = _cache->find(fromTo.data(), (uint32_t)fromTo.size());
+        auto finding =
+            (attempts == 0)
+                ? nextFinding(limit)
+                : _cache->find(fromTo.data(), (uint32_t)fromTo.size());
         if (finding.found()) {
           needRocksLookup = false;
           // We got sth. in the cache
@@ -275,7 +290,8 @@ bool RocksDBEdgeIndexIterator::nextExtra(ExtraCallback const& cb,
               _builderIterator.next();
 
               TRI_ASSERT(_builderIterator.valid());
-              TRI_ASSERT(_builderIterator.value().isString());
+              TRI_ASSERT(_builderIterator.value().isString() ||
+                         _builderIterator.value().isObject());
               cb(tkn, _builderIterator.value());
 
               _builderIterator.next();
@@ -311,26 +327,59 @@ bool RocksDBEdgeIndexIterator::nextExtra(ExtraCallback const& cb,
   return _builderIterator.valid() || _keysIterator.valid();
 }
 
+cache::Finding RocksDBEdgeIndexIterator::nextFinding(size_t limit) {
+  TRI_ASSERT(_cache != nullptr);
+  if (_findingsPosition >= _findings.size()) {
+    // look up the current key and the ones following it in one go
+    std::vector<std::pair<void const*, uint32_t>> keys;
+    VPackArrayIterator it = _keysIterator;
+    while (it.valid() &&
+           keys.size() < (std::min)(limit, EdgeIndexCacheBatchSize)) {
+      VPackSlice fromToSlice = it.value();
+      if (fromToSlice.isObject()) {
+        fromToSlice = fromToSlice.get(StaticStrings::IndexEq);
+      }
+      TRI_ASSERT(fromToSlice.isString());
+      StringRef fromTo(fromToSlice);
+      keys.emplace_back(fromTo.data(), static_cast<uint32_t>(fromTo.size()));
+      it.next();
+    }
+    _cache->findBatch(keys, _findings);
+    _findingsPosition = 0;
+  }
+  TRI_ASSERT(_findingsPosition < _findings.size());
+  return std::move(_findings[_findingsPosition++]);
+}
+
 void RocksDBEdgeIndexIterator::lookupInRocksDB(StringRef fromTo) {
+  // release leased cache values before inserting into the cache
+  _findings.clear();
+
   // Bad case read from RocksDB
   _bounds = RocksDBKeyBounds::EdgeIndexVertex(_index->_objectId, fromTo);
+  // the iterator references _upperBound, which must follow the new bounds
+  _upperBound = _bounds.end();
   _iterator->Seek(_bounds.start());
   resetInplaceMemory();
   rocksdb::Comparator const* cmp = _index->comparator();
 
   cache::Cache* cc = _cache.get();
   _builder.openArray(true);
-  auto end = _bounds.end();
-  while (_iterator->Valid() && (cmp->Compare(_iterator->key(), end) < 0)) {
+  while (_iterator->Valid() &&
+         (cmp->Compare(_iterator->key(), _upperBound) < 0)) {
     TRI_voc_rid_t revisionId = RocksDBKey::revisionId(
         RocksDBEntryType::EdgeIndexValue, _iterator->key());
     RocksDBToken token(revisionId);
 
-    // adding revision ID and _from or _to value
+    // adding revision ID and _from or _to value, or the partial edge
     _builder.add(VPackValue(token.revisionId()));
-    StringRef vertexId = RocksDBValue::vertexId(_iterator->value());
-    _builder.add(VPackValuePair(vertexId.data(), vertexId.size(),
-                                VPackValueType::String));
+    if (_index->hasStoredValues()) {
+      _builder.add(RocksDBValue::data(_iterator->value()));
+    } else {
+      StringRef vertexId = RocksDBValue::vertexId(_iterator->value());
+      _builder.add(VPackValuePair(vertexId.data(), vertexId.size(),
+                                  VPackValueType::String));
+    }
 
     _iterator->Next();
   }
@@ -389,6 +438,15 @@ RocksDBEdgeIndex::RocksDBEdgeIndex(TRI_idx_iid_t iid,
   
   TRI_ASSERT(_cf == RocksDBColumnFamily::edge()); 
 
+  VPackSlice storedValues = info.get("storedValues");
+  if (storedValues.isArray()) {
+    for (auto const& it : VPackArrayIterator(storedValues)) {
+      if (it.isString()) {
+        _storedValues.emplace_back(it.copyString());
+      }
+    }
+  }
+
   if (!ServerState::instance()->isCoordinator()) {
     // We activate the estimator only on DBServers
     _estimator = std::make_unique<RocksDBCuckooIndexEstimator<uint64_t>>(
@@ -418,6 +476,17 @@ double RocksDBEdgeIndex::selectivityEstimateLocal(
   return _estimator->computeEstimate();
 }
 
+/// @brief the estimator counts the edges per vertex anyway, the counter
+/// for the vertex is its degree
+bool RocksDBEdgeIndex::estimateDegree(arangodb::StringRef const& vertexId,
+                                      uint64_t& degree) const {
+  TRI_ASSERT(_estimator != nullptr);
+  // NOTE: must hash the same way as insertInternal
+  std::hash<StringRef> hasher;
+  degree = _estimator->count(static_cast<uint64_t>(hasher(vertexId)));
+  return true;
+}
+
 /// @brief return a VelocyPack representation of the index
 void RocksDBEdgeIndex::toVelocyPack(VPackBuilder& builder, bool withFigures,
                                     bool forPersistence) const {
@@ -426,9 +495,51 @@ void RocksDBEdgeIndex::toVelocyPack(VPackBuilder& builder, bool withFigures,
   // add selectivity estimate hard-coded
   builder.add("unique", VPackValue(false));
   builder.add("sparse", VPackValue(false));
+  if (hasStoredValues()) {
+    builder.add(VPackValue("storedValues"));
+    builder.openArray();
+    for (auto const& it : _storedValues) {
+      builder.add(VPackValue(it));
+    }
+    builder.close();
+  }
+  builder.close();
+}
+
+void RocksDBEdgeIndex::buildStoredValues(VPackBuilder& builder,
+                                         VPackSlice const& doc) const {
+  builder.openObject();
+  builder.add(StaticStrings::FromString,
+              transaction::helpers::extractFromFromDocument(doc));
+  builder.add(StaticStrings::ToString,
+              transaction::helpers::extractToFromDocument(doc));
+  for (auto const& it : _storedValues) {
+    VPackSlice value = doc.get(it);
+    if (value.isNone()) {
+      // store missing attributes as null, so that the partial edge still
+      // covers them
+      builder.add(it, VPackValue(VPackValueType::Null));
+    } else {
+      builder.add(it, value);
+    }
+  }
   builder.close();
 }
 
+RocksDBValue RocksDBEdgeIndex::indexValue(transaction::Methods* trx,
+                                          VPackSlice const& doc) const {
+  if (!hasStoredValues()) {
+    VPackSlice toFrom =
+        _isFromIndex ? transaction::helpers::extractToFromDocument(doc)
+                     : transaction::helpers::extractFromFromDocument(doc);
+    TRI_ASSERT(toFrom.isString());
+    return RocksDBValue::EdgeIndexValue(StringRef(toFrom));
+  }
+  transaction::BuilderLeaser builder(trx);
+  buildStoredValues(*builder.get(), doc);
+  return RocksDBValue::EdgeIndexValue(builder->slice());
+}
+
 Result RocksDBEdgeIndex::insertInternal(transaction::Methods* trx,
                                         RocksDBMethods* mthd,
                                         TRI_voc_rid_t revisionId,
@@ -437,18 +548,14 @@ Result RocksDBEdgeIndex::insertInternal(transaction::Methods* trx,
   TRI_ASSERT(fromTo.isString());
   auto fromToRef = StringRef(fromTo);
   RocksDBKey key = RocksDBKey::EdgeIndexValue(_objectId, fromToRef, revisionId);
-  VPackSlice toFrom = _isFromIndex
-                          ? transaction::helpers::extractToFromDocument(doc)
-                          : transaction::helpers::extractFromFromDocument(doc);
-  TRI_ASSERT(toFrom.isString());
-  RocksDBValue value = RocksDBValue::EdgeIndexValue(StringRef(toFrom));
+  RocksDBValue value = indexValue(trx, doc);
 
   // blacklist key in cache
   blackListKey(fromToRef);
 
-  // acquire rocksdb transaction
-  Result r = mthd->Put(_cf, RocksDBKey(rocksdb::Slice(key.string())),
-                       value.string(), rocksutils::index);
+  // the key contains the revision id, so no other transaction writes it
+  Result r = mthd->PutUntracked(_cf, RocksDBKey(rocksdb::Slice(key.string())),
+                                value.string(), rocksutils::index);
   if (r.ok()) {
     std::hash<StringRef> hasher;
     uint64_t hash = static_cast<uint64_t>(hasher(fromToRef));
@@ -477,7 +584,8 @@ Result RocksDBEdgeIndex::removeInternal(transaction::Methods* trx,
   // blacklist key in cache
   blackListKey(fromToRef);
 
-  Result res = mthd->Delete(_cf, RocksDBKey(rocksdb::Slice(key.string())));
+  Result res =
+      mthd->DeleteUntracked(_cf, RocksDBKey(rocksdb::Slice(key.string())));
   if (res.ok()) {
     std::hash<StringRef> hasher;
     uint64_t hash = static_cast<uint64_t>(hasher(fromToRef));
@@ -493,6 +601,7 @@ void RocksDBEdgeIndex::batchInsert(
     std::vector<std::pair<TRI_voc_rid_t, VPackSlice>> const& documents,
     std::shared_ptr<arangodb::basics::LocalTaskQueue> queue) {
   auto* mthds = RocksDBTransactionState::toMethods(trx);
+  std::hash<StringRef> hasher;
   for (std::pair<TRI_voc_rid_t, VPackSlice> const& doc : documents) {
     // VPackSlice primaryKey = doc.second.get(StaticStrings::KeyString);
     VPackSlice fromTo = doc.second.get(_directionAttr);
@@ -501,13 +610,17 @@ void RocksDBEdgeIndex::batchInsert(
     RocksDBKey key =
         RocksDBKey::EdgeIndexValue(_objectId, fromToRef, doc.first);
 
+    RocksDBValue value = indexValue(trx, doc.second);
+
     blackListKey(fromToRef);
-    Result r = mthds->Put(_cf, RocksDBKey(rocksdb::Slice(key.string())),
-                          rocksdb::Slice(), rocksutils::index);
+    Result r =
+        mthds->PutUntracked(_cf, RocksDBKey(rocksdb::Slice(key.string())),
+                            value.string(), rocksutils::index);
     if (!r.ok()) {
       queue->setStatus(r.errorNumber());
       break;
     }
+    _estimator->insert(static_cast<uint64_t>(hasher(fromToRef)));
   }
 }
 
@@ -707,11 +820,15 @@ void RocksDBEdgeIndex::warmup(arangodb::transaction::Methods* trx) {
         builder.add(VPackValue(token.revisionId()));
 
         VPackSlice doc(mmdr.vpack());
-        VPackSlice toFrom =
-            _isFromIndex ? transaction::helpers::extractToFromDocument(doc)
-                         : transaction::helpers::extractFromFromDocument(doc);
-        TRI_ASSERT(toFrom.isString());
-        builder.add(toFrom);
+        if (hasStoredValues()) {
+          buildStoredValues(builder, doc);
+        } else {
+          VPackSlice toFrom =
+              _isFromIndex ? transaction::helpers::extractToFromDocument(doc)
+                           : transaction::helpers::extractFromFromDocument(doc);
+          TRI_ASSERT(toFrom.isString());
+          builder.add(toFrom);
+        }
 #ifdef USE_MAINTAINER_MODE
       } else {
         // Data Inconsistency.
@@ -747,6 +864,30 @@ void RocksDBEdgeIndex::warmup(arangodb::transaction::Methods* trx) {
   }
 }
 
+size_t RocksDBEdgeIndex::prefetchCacheKeys(
+    transaction::Methods* trx, std::vector<std::string> const& keys) {
+  if (!useCache() || keys.empty()) {
+    return 0;
+  }
+
+  transaction::BuilderLeaser builder(trx);
+  std::unique_ptr<VPackBuilder> searchValues(builder.steal());
+  searchValues->openArray();
+  for (auto const& it : keys) {
+    searchValues->add(VPackValue(it));
+  }
+  searchValues->close();
+
+  // the iterator puts every vertex it has to read from RocksDB into the
+  // cache, so we only need to exhaust it
+  ManagedDocumentResult mmdr;
+  RocksDBEdgeIndexIterator iterator(_collection, trx, &mmdr, this,
+                                    searchValues, _cache);
+  while (iterator.next([](DocumentIdentifierToken const&) {}, 1000)) {
+  }
+  return keys.size();
+}
+
 // ===================== Helpers ==================
 
 /// @brief create the iterator
@@ -837,6 +978,12 @@ bool RocksDBEdgeIndex::deserializeEstimate(RocksDBCounterManager* mgr) {
   return true;
 }
 
+void RocksDBEdgeIndex::afterTruncate() {
+  TRI_ASSERT(_estimator != nullptr);
+  _estimator->clear();
+  RocksDBIndex::afterTruncate();
+}
+
 void RocksDBEdgeIndex::recalculateEstimates() {
   TRI_ASSERT(_estimator != nullptr);
   _estimator->clear();
@@ -25,6 +25,7 @@
 #define ARANGOD_ROCKSDB_ENGINE_ROCKSDB_EDGE_INDEX_H 1
 
 #include "Basics/Common.h"
+#include "Cache/Finding.h"
 #include "Indexes/Index.h"
 #include "Indexes/IndexIterator.h"
 #include "RocksDBEngine/RocksDBCuckooIndexEstimator.h"
@@ -32,6 +33,7 @@
 #include "RocksDBEngine/RocksDBKey.h"
 #include "RocksDBEngine/RocksDBKeyBounds.h"
 #include "RocksDBEngine/RocksDBToken.h"
+#include "RocksDBEngine/RocksDBValue.h"
 #include "VocBase/voc-types.h"
 #include "VocBase/vocbase.h"
 
@@ -66,6 +68,7 @@ class RocksDBEdgeIndexIterator final : public IndexIterator {
   arangodb::StringRef getFromToFromIterator(
       arangodb::velocypack::ArrayIterator const&);
   void lookupInRocksDB(StringRef edgeKey);
+  cache::Finding nextFinding(size_t limit);
 
   std::unique_ptr<arangodb::velocypack::Builder> _keys;
   arangodb::velocypack::ArrayIterator _keysIterator;
@@ -74,9 +77,16 @@ class RocksDBEdgeIndexIterator final : public IndexIterator {
   // the following 2 values are required for correct batch handling
   std::unique_ptr<rocksdb::Iterator> _iterator;  // iterator position in rocksdb
   RocksDBKeyBounds _bounds;
+  rocksdb::Slice _upperBound;  // used for iterate_upper_bound
   std::shared_ptr<cache::Cache> _cache;
   arangodb::velocypack::ArrayIterator _builderIterator;
   arangodb::velocypack::Builder _builder;
+
+  // batched cache lookups for the current and the following keys. they
+  // lease cache values, so they are released before any cache insert and
+  // before returning to the caller
+  std::vector<cache::Finding> _findings;
+  size_t _findingsPosition;
 };
 
 class RocksDBEdgeIndex final : public RocksDBIndex {
@@ -107,6 +117,9 @@ class RocksDBEdgeIndex final : public RocksDBIndex {
   double selectivityEstimateLocal(
       arangodb::StringRef const* = nullptr) const override;
 
+  bool estimateDegree(arangodb::StringRef const& vertexId,
+                      uint64_t& degree) const override;
+
   void toVelocyPack(VPackBuilder&, bool, bool) const override;
 
   void batchInsert(
@@ -138,18 +151,34 @@ class RocksDBEdgeIndex final : public RocksDBIndex {
   /// @brief Warmup the index caches.
   void warmup(arangodb::transaction::Methods* trx) override;
 
+  /// @brief fill the index cache for the given vertex ids
+  size_t prefetchCacheKeys(transaction::Methods*,
+                           std::vector<std::string> const& keys) override;
+
   void serializeEstimate(std::string& output) const override;
 
   bool deserializeEstimate(arangodb::RocksDBCounterManager* mgr) override;
 
   void recalculateEstimates() override;
 
+  void afterTruncate() override;
+
   Result insertInternal(transaction::Methods*, RocksDBMethods*, TRI_voc_rid_t,
                         arangodb::velocypack::Slice const&) override;
 
   Result removeInternal(transaction::Methods*, RocksDBMethods*, TRI_voc_rid_t,
                         arangodb::velocypack::Slice const&) override;
 
+  /// @brief edge attributes stored inline in the index values in addition
+  /// to _from and _to
+  std::vector<std::string> const& storedValues() const {
+    return _storedValues;
+  }
+
+  /// @brief whether or not the index values hold stored edge attributes
+  /// rather than only the opposite vertex id
+  bool hasStoredValues() const { return !_storedValues.empty(); }
+
  protected:
   Result postprocessRemove(transaction::Methods* trx, rocksdb::Slice const& key,
                            rocksdb::Slice const& value) override;
@@ -168,8 +197,19 @@ class RocksDBEdgeIndex final : public RocksDBIndex {
   void handleValNode(VPackBuilder* keys,
                      arangodb::aql::AstNode const* valNode) const;
 
+  /// @brief build the partial edge stored inline in the index value,
+  /// consisting of _from, _to and the stored edge attributes
+  void buildStoredValues(arangodb::velocypack::Builder& builder,
+                         arangodb::velocypack::Slice const& doc) const;
+
+  /// @brief build the index value for an edge document, which is either the
+  /// opposite vertex id or the partial edge
+  RocksDBValue indexValue(transaction::Methods*,
+                          arangodb::velocypack::Slice const& doc) const;
+
   std::string _directionAttr;
   bool _isFromIndex;
+  std::vector<std::string> _storedValues;
 
   /// @brief A fixed size library to estimate the selectivity of the index.
   /// On insertion of a document we have to insert it into the estimator,
@@ -26,6 +26,7 @@
 #include "ApplicationFeatures/RocksDBOptionFeature.h"
 #include "Basics/Exceptions.h"
 #include "Basics/FileUtils.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/ReadLocker.h"
 #include "Basics/Result.h"
 #include "Basics/RocksDBLogger.h"
@@ -42,14 +43,19 @@
 #include "ProgramOptions/Section.h"
 #include "Rest/Version.h"
 #include "RestHandler/RestHandlerCreator.h"
+#include "RestServer/DatabaseFeature.h"
 #include "RestServer/DatabasePathFeature.h"
+#include "RestServer/MemoryGovernorFeature.h"
 #include "RestServer/ServerIdFeature.h"
 #include "RestServer/ViewTypesFeature.h"
 #include "RocksDBEngine/RocksDBAqlFunctions.h"
 #include "RocksDBEngine/RocksDBBackgroundThread.h"
+#include "RocksDBEngine/RocksDBBulkLoadMethods.h"
+#include "RocksDBEngine/RocksDBCacheHeatMap.h"
 #include "RocksDBEngine/RocksDBCollection.h"
 #include "RocksDBEngine/RocksDBColumnFamily.h"
 #include "RocksDBEngine/RocksDBCommon.h"
+#include "RocksDBEngine/RocksDBCompactionThrottle.h"
 #include "RocksDBEngine/RocksDBComparator.h"
 #include "RocksDBEngine/RocksDBCounterManager.h"
 #include "RocksDBEngine/RocksDBIncrementalSync.h"
@@ -59,17 +65,21 @@
 #include "RocksDBEngine/RocksDBLogValue.h"
 #include "RocksDBEngine/RocksDBOptimizerRules.h"
 #include "RocksDBEngine/RocksDBPrefixExtractor.h"
+#include "RocksDBEngine/RocksDBPrimaryIndex.h"
 #include "RocksDBEngine/RocksDBReplicationManager.h"
 #include "RocksDBEngine/RocksDBReplicationTailing.h"
 #include "RocksDBEngine/RocksDBRestHandlers.h"
+#include "RocksDBEngine/RocksDBSyncThread.h"
 #include "RocksDBEngine/RocksDBTransactionCollection.h"
 #include "RocksDBEngine/RocksDBTransactionContextData.h"
 #include "RocksDBEngine/RocksDBTransactionManager.h"
 #include "RocksDBEngine/RocksDBTransactionState.h"
+#include "RocksDBEngine/RocksDBTtl.h"
 #include "RocksDBEngine/RocksDBTypes.h"
 #include "RocksDBEngine/RocksDBV8Functions.h"
 #include "RocksDBEngine/RocksDBValue.h"
 #include "RocksDBEngine/RocksDBView.h"
+#include "RocksDBEngine/RocksDBWriteBufferTuner.h"
 #include "Transaction/Options.h"
 #include "VocBase/replication-applier.h"
 #include "VocBase/ticks.h"
@@ -80,19 +90,47 @@
 #include <rocksdb/filter_policy.h>
 #include <rocksdb/iterator.h>
 #include <rocksdb/options.h>
+#include <rocksdb/rate_limiter.h>
 #include <rocksdb/slice_transform.h>
 #include <rocksdb/statistics.h>
 #include <rocksdb/table.h>
 #include <rocksdb/transaction_log.h>
 #include <rocksdb/write_batch.h>
+#include <rocksdb/write_buffer_manager.h>
 
 #include <velocypack/Iterator.h>
 #include <velocypack/velocypack-aliases.h>
 
+#include <thread>
+
 using namespace arangodb;
 using namespace arangodb::application_features;
 using namespace arangodb::options;
 
+/// @brief translates the name of a compression option into the compression
+/// type. falls back to snappy if RocksDB was built without the library
+static rocksdb::CompressionType CompressionFromString(std::string const& name) {
+  rocksdb::CompressionType type = rocksdb::kSnappyCompression;
+  if (name == "none") {
+    return rocksdb::kNoCompression;
+  } else if (name == "lz4") {
+    type = rocksdb::kLZ4Compression;
+  } else if (name == "zlib") {
+    type = rocksdb::kZlibCompression;
+  } else if (name == "zstd") {
+    type = rocksdb::kZSTD;
+  }
+
+  auto supported = rocksdb::GetSupportedCompressions();
+  if (std::find(supported.begin(), supported.end(), type) == supported.end()) {
+    LOG_TOPIC(WARN, arangodb::Logger::ENGINES)
+        << "compression '" << name << "' is not supported by this build, "
+        << "using snappy instead";
+    return rocksdb::kSnappyCompression;
+  }
+  return type;
+}
+
 namespace arangodb {
 
 std::string const RocksDBEngine::EngineName("rocksdb");
@@ -106,21 +144,35 @@ rocksdb::ColumnFamilyHandle* RocksDBColumnFamily::_vpack(nullptr);
 rocksdb::ColumnFamilyHandle* RocksDBColumnFamily::_geo(nullptr);
 rocksdb::ColumnFamilyHandle* RocksDBColumnFamily::_fulltext(nullptr);
 std::vector<rocksdb::ColumnFamilyHandle*> RocksDBColumnFamily::_allHandles;
+std::string const RocksDBColumnFamily::DedicatedPrefix("Documents-");
+basics::ReadWriteLock RocksDBColumnFamily::_dedicatedLock;
+std::unordered_map<uint64_t, rocksdb::ColumnFamilyHandle*>
+    RocksDBColumnFamily::_dedicated;
+std::unordered_set<uint32_t> RocksDBColumnFamily::_dedicatedIds;
+std::atomic<size_t> RocksDBColumnFamily::_numDedicated(0);
 
 // create the storage engine
 RocksDBEngine::RocksDBEngine(application_features::ApplicationServer* server)
     : StorageEngine(server, EngineName, FeatureName, new RocksDBIndexFactory()),
       _db(nullptr),
+      _documentsTtlFilter(new RocksDBTtlCompactionFilter(true)),
+      _primaryTtlFilter(new RocksDBTtlCompactionFilter(false)),
       _vpackCmp(new RocksDBVPackComparator()),
       _maxTransactionSize(transaction::Options::defaultMaxTransactionSize),
       _intermediateCommitSize(
           transaction::Options::defaultIntermediateCommitSize),
       _intermediateCommitCount(
           transaction::Options::defaultIntermediateCommitCount),
-      _pruneWaitTime(10.0) {
+      _pruneWaitTime(10.0),
+      _groupCommitDelay(0),
+      _groupCommitSize(64),
+      _bulkLoadMemory(256 * 1024 * 1024),
+      _indexBuildThreads(4),
+      _scanThreads(1) {
   // inherits order from StorageEngine but requires "RocksDBOption" that is used
   // to configure this engine and the MMFiles PersistentIndexFeature
   startsAfter("RocksDBOption");
+  startsAfter("MemoryGovernor");
 }
 
 RocksDBEngine::~RocksDBEngine() { delete _db; }
@@ -154,6 +206,33 @@ void RocksDBEngine::collectOptions(
                      "timeout after which unused WAL files are deleted",
                      new DoubleParameter(&_pruneWaitTime));
 
+  options->addOption("--rocksdb.group-commit-delay",
+                     "maximum time (in milliseconds) transactions with "
+                     "waitForSync wait for others to share a WAL sync with "
+                     "(0 = sync each transaction on its own)",
+                     new UInt64Parameter(&_groupCommitDelay));
+
+  options->addOption("--rocksdb.group-commit-size",
+                     "number of waiting transactions after which a shared "
+                     "WAL sync is started without further delay",
+                     new UInt64Parameter(&_groupCommitSize));
+
+  options->addOption("--rocksdb.bulk-load-memory",
+                     "memory (in bytes) a bulk load may use for sorting "
+                     "before it writes sorted runs to temporary files",
+                     new UInt64Parameter(&_bulkLoadMemory));
+
+  options->addOption("--rocksdb.index-build-threads",
+                     "number of threads filling an index that is created "
+                     "in the background",
+                     new UInt64Parameter(&_indexBuildThreads));
+
+  options->addOption("--rocksdb.scan-threads",
+                     "number of threads reading a large full collection scan "
+                     "of a read-only transaction in parallel key ranges "
+                     "(1 = scan on the query's thread only)",
+                     new UInt64Parameter(&_scanThreads));
+
 #ifdef USE_ENTERPRISE
   collectEnterpriseOptions(options);
 #endif
@@ -214,6 +293,28 @@ void RocksDBEngine::start() {
       FATAL_ERROR_EXIT();
     }
   }
+
+  // remove the files of bulk loads interrupted by a shutdown or crash.
+  // loads that were interrupted while ingesting are repaired once their
+  // database is recovered
+  if (basics::FileUtils::isDirectory(bulkLoadPath())) {
+    for (auto const& dir : basics::FileUtils::listFiles(bulkLoadPath())) {
+      std::string const file = basics::FileUtils::buildFilename(
+          basics::FileUtils::buildFilename(bulkLoadPath(), dir),
+          RocksDBBulkLoadMethods::markerFile);
+      if (!basics::FileUtils::exists(file)) {
+        continue;
+      }
+      try {
+        _interruptedBulkLoads.emplace_back(
+            basics::VelocyPackHelper::velocyPackFromFile(file));
+      } catch (...) {
+        LOG_TOPIC(ERR, arangodb::Logger::ENGINES)
+            << "cannot read bulk load marker '" << file << "'";
+      }
+    }
+    TRI_RemoveDirectory(bulkLoadPath().c_str());
+  }
   
   // options imported set by RocksDBOptionFeature
   auto const* opts =
@@ -245,6 +346,22 @@ void RocksDBEngine::start() {
   // files may linger around forever and will not get removed
   _options.max_total_wal_size = opts->_maxTotalWalSize;
 
+  // one budget for the write buffers of all column families, so that the
+  // busy ones can use the memory the idle ones do not need
+  uint64_t totalWriteBufferSize = opts->_totalWriteBufferSize;
+  if (totalWriteBufferSize == 0 && MemoryGovernorFeature::GOVERNOR != nullptr &&
+      MemoryGovernorFeature::GOVERNOR->isEnabled()) {
+    totalWriteBufferSize = MemoryGovernorFeature::GOVERNOR->budget() / 4;
+  }
+  if (totalWriteBufferSize > 0) {
+    _writeBufferManager = std::make_shared<rocksdb::WriteBufferManager>(
+        static_cast<size_t>(totalWriteBufferSize));
+    _options.write_buffer_manager = _writeBufferManager;
+    // a smaller WAL limit would flush the write buffers before they are full
+    _options.max_total_wal_size =
+        (std::max)(_options.max_total_wal_size, totalWriteBufferSize);
+  }
+
   if (opts->_walDirectory.empty()) {
     _options.wal_dir = basics::FileUtils::buildFilename(_path, "journals");
   } else {
@@ -263,6 +380,15 @@ void RocksDBEngine::start() {
   }
 
   _options.max_background_jobs = static_cast<int>(opts->_maxBackgroundJobs);
+  _options.max_background_flushes =
+      static_cast<int>(opts->_maxBackgroundFlushes);
+  _options.max_background_compactions =
+      static_cast<int>(opts->_maxBackgroundCompactions);
+  if (opts->_rateLimit > 0) {
+    _rateLimiter.reset(rocksdb::NewGenericRateLimiter(
+        static_cast<int64_t>(opts->_rateLimit)));
+    _options.rate_limiter = _rateLimiter;
+  }
   _options.max_subcompactions = static_cast<int>(opts->_maxSubcompactions);
   _options.use_fsync = opts->_useFSync;
 
@@ -342,7 +468,6 @@ void RocksDBEngine::start() {
   // garbage collect them
   _options.WAL_size_limit_MB = 0;
   _options.memtable_prefix_bloom_size_ratio = 0.2;  // TODO: pick better value?
-  // TODO: enable memtable_insert_with_hint_prefix_extractor?
   _options.bloom_locality = 1;
 
   // cf options for definitons (dbs, collections, views, ...)
@@ -350,14 +475,44 @@ void RocksDBEngine::start() {
   
   // cf options with fixed 8 byte object id prefix for documents
   rocksdb::ColumnFamilyOptions fixedPrefCF(_options);
-  fixedPrefCF.prefix_extractor = std::shared_ptr<rocksdb::SliceTransform const>(rocksdb::NewFixedPrefixTransform(RocksDBKey::objectIdSize()));
+  fixedPrefCF.prefix_extractor =
+      rocksutils::prefixExtractor(RocksDBEntryType::Document);
+
+  // documents and primary index entries of collections with expireAfter
+  // are dropped by compactions once they expired. documents of a collection
+  // are inserted with ascending revisions, so the memtable can insert them
+  // next to the last insert of the same collection
+  rocksdb::ColumnFamilyOptions documentsCF(fixedPrefCF);
+  documentsCF.compaction_filter = _documentsTtlFilter.get();
+  documentsCF.memtable_insert_with_hint_prefix_extractor =
+      documentsCF.prefix_extractor;
+  // small documents of the same collection repeat their attribute names,
+  // which block compression handles poorly. with a dictionary, compactions
+  // into the last level sample the documents they write and prime the
+  // compressor of every block with the samples, so each file gets a
+  // dictionary fitting the current documents
+  rocksdb::CompressionType documentsCompression =
+      CompressionFromString(opts->_documentsCompression);
+  for (auto& it : documentsCF.compression_per_level) {
+    if (it != rocksdb::kNoCompression) {
+      it = documentsCompression;
+    }
+  }
+  documentsCF.compression_opts.max_dict_bytes =
+      static_cast<uint32_t>(opts->_documentsCompressionDictionarySize);
+
+  rocksdb::ColumnFamilyOptions primaryCF(fixedPrefCF);
+  primaryCF.compaction_filter = _primaryTtlFilter.get();
   
   // construct column family options with prefix containing indexed value
   rocksdb::ColumnFamilyOptions dynamicPrefCF(_options);
-  dynamicPrefCF.prefix_extractor = std::make_shared<RocksDBPrefixExtractor>();
+  dynamicPrefCF.prefix_extractor =
+      rocksutils::prefixExtractor(RocksDBEntryType::EdgeIndexValue);
   // also use hash-search based SST file format
   rocksdb::BlockBasedTableOptions tblo(table_options);
   tblo.index_type = rocksdb::BlockBasedTableOptions::IndexType::kHashSearch;
+  tblo.whole_key_filtering =
+      rocksutils::wholeKeyFiltering(RocksDBEntryType::EdgeIndexValue);
   dynamicPrefCF.table_factory = std::shared_ptr<rocksdb::TableFactory>(
       rocksdb::NewBlockBasedTableFactory(tblo));
   
@@ -365,17 +520,59 @@ void RocksDBEngine::start() {
   rocksdb::ColumnFamilyOptions vpackFixedPrefCF(fixedPrefCF);
   vpackFixedPrefCF.comparator = _vpackCmp.get();
 
+  // fulltext postings of a word share the object id and the word as key
+  // prefix. rocksdb delta encodes the keys of a data block between restart
+  // points, so fewer restart points store the postings more compactly
+  rocksdb::ColumnFamilyOptions fulltextCF(fixedPrefCF);
+  rocksdb::BlockBasedTableOptions fulltextTblo(table_options);
+  fulltextTblo.block_restart_interval = 64;
+  fulltextCF.table_factory = std::shared_ptr<rocksdb::TableFactory>(
+      rocksdb::NewBlockBasedTableFactory(fulltextTblo));
+
+  // dedicated documents column families of single collections. they use
+  // their own compaction style, compression, bloom filter and optionally
+  // their own block cache, so that large or write-heavy collections do not
+  // affect the others. dropping such a collection drops its column family
+  _dedicatedOptions = documentsCF;
+  if (opts->_dedicatedCompactionStyle == "universal") {
+    _dedicatedOptions.compaction_style = rocksdb::kCompactionStyleUniversal;
+    _dedicatedOptions.level_compaction_dynamic_level_bytes = false;
+  }
+  rocksdb::CompressionType dedicatedCompression =
+      CompressionFromString(opts->_dedicatedCompression);
+  for (auto& it : _dedicatedOptions.compression_per_level) {
+    if (it != rocksdb::kNoCompression) {
+      it = dedicatedCompression;
+    }
+  }
+  rocksdb::BlockBasedTableOptions dedicatedTblo(table_options);
+  if (opts->_dedicatedBlockCacheSize > 0) {
+    dedicatedTblo.block_cache = rocksdb::NewLRUCache(
+        opts->_dedicatedBlockCacheSize,
+        static_cast<int>(opts->_blockCacheShardBits));
+    dedicatedTblo.no_block_cache = false;
+    _dedicatedBlockCache = dedicatedTblo.block_cache;
+  }
+  if (opts->_dedicatedBloomFilterBits > 0) {
+    dedicatedTblo.filter_policy.reset(rocksdb::NewBloomFilterPolicy(
+        static_cast<int>(opts->_dedicatedBloomFilterBits), true));
+  } else {
+    dedicatedTblo.filter_policy.reset();
+  }
+  _dedicatedOptions.table_factory = std::shared_ptr<rocksdb::TableFactory>(
+      rocksdb::NewBlockBasedTableFactory(dedicatedTblo));
+
   // create column families
   std::vector<rocksdb::ColumnFamilyDescriptor> cfFamilies;
   // no prefix families for default column family (Has to be there)
   cfFamilies.emplace_back(rocksdb::kDefaultColumnFamilyName,
                           definitionsCF);                       // 0
-  cfFamilies.emplace_back("Documents", fixedPrefCF);            // 1
-  cfFamilies.emplace_back("PrimaryIndex", fixedPrefCF);         // 2
+  cfFamilies.emplace_back("Documents", documentsCF);            // 1
+  cfFamilies.emplace_back("PrimaryIndex", primaryCF);           // 2
   cfFamilies.emplace_back("EdgeIndex", dynamicPrefCF);         // 3
   cfFamilies.emplace_back("VPackIndex", vpackFixedPrefCF);      // 4
   cfFamilies.emplace_back("GeoIndex", fixedPrefCF);             // 5
-  cfFamilies.emplace_back("FulltextIndex", fixedPrefCF);        // 6
+  cfFamilies.emplace_back("FulltextIndex", fulltextCF);         // 6
   // DO NOT FORGET TO DESTROY THE CFs ON CLOSE
 
   std::vector<rocksdb::ColumnFamilyHandle*> cfHandles;
@@ -430,6 +627,13 @@ void RocksDBEngine::start() {
         
       }
 
+      // open the dedicated column families of existing collections
+      for (auto const& it : existingColumnFamilies) {
+        if (RocksDBColumnFamily::dedicatedObjectId(it) != 0) {
+          cfFamilies.emplace_back(it, _dedicatedOptions);
+        }
+      }
+
       if (existingColumnFamilies.size() < numberOfColumnFamilies) {
         LOG_TOPIC(FATAL, arangodb::Logger::STARTUP)
             << "unexpected number of column families found in database ("
@@ -472,8 +676,50 @@ void RocksDBEngine::start() {
   RocksDBColumnFamily::_vpack = cfHandles[4];
   RocksDBColumnFamily::_geo = cfHandles[5];
   RocksDBColumnFamily::_fulltext = cfHandles[6];
-  RocksDBColumnFamily::_allHandles = cfHandles;
+  RocksDBColumnFamily::_allHandles.assign(
+      cfHandles.begin(), cfHandles.begin() + numberOfColumnFamilies);
+  for (size_t i = numberOfColumnFamilies; i < cfHandles.size(); ++i) {
+    registerDedicatedColumnFamily(
+        RocksDBColumnFamily::dedicatedObjectId(cfFamilies[i].name),
+        cfHandles[i]);
+  }
   TRI_ASSERT(RocksDBColumnFamily::_definitions->GetID() == 0);
+
+  dropOrphanedColumnFamilies();
+
+  // account for memtables and block caches in the shared memory budget. the
+  // block caches can shrink when queries need memory, memtables cannot
+  if (MemoryGovernorFeature::GOVERNOR != nullptr) {
+    uint64_t memtables =
+        static_cast<uint64_t>(_options.write_buffer_size) *
+        static_cast<uint64_t>(_options.max_write_buffer_number) *
+        static_cast<uint64_t>(cfHandles.size());
+    if (_writeBufferManager != nullptr) {
+      memtables = static_cast<uint64_t>(_writeBufferManager->buffer_size());
+    }
+    MemoryGovernorFeature::GOVERNOR->registerConsumer(
+        "rocksdb-memtables", memtables, 0,
+        MemoryGovernorFeature::ResizeCallback());
+    std::shared_ptr<rocksdb::Cache> blockCache = table_options.block_cache;
+    if (blockCache != nullptr) {
+      MemoryGovernorFeature::GOVERNOR->registerConsumer(
+          "rocksdb-block-cache", opts->_blockCacheSize,
+          opts->_blockCacheSize / 4, [blockCache](uint64_t size) -> bool {
+            blockCache->SetCapacity(static_cast<size_t>(size));
+            return true;
+          });
+    }
+    std::shared_ptr<rocksdb::Cache> dedicatedCache = dedicatedTblo.block_cache;
+    if (dedicatedCache != nullptr && dedicatedCache != blockCache) {
+      MemoryGovernorFeature::GOVERNOR->registerConsumer(
+          "rocksdb-dedicated-block-cache", opts->_dedicatedBlockCacheSize,
+          opts->_dedicatedBlockCacheSize / 4,
+          [dedicatedCache](uint64_t size) -> bool {
+            dedicatedCache->SetCapacity(static_cast<size_t>(size));
+            return true;
+          });
+    }
+  }
   
   // try to find version
   const char version = rocksDBFormatVersion();
@@ -516,6 +762,52 @@ void RocksDBEngine::start() {
     TRI_ASSERT(false);
   }
 
+  if (_groupCommitDelay > 0) {
+    _syncThread.reset(new RocksDBSyncThread(
+        this, static_cast<double>(_groupCommitDelay) / 1000.0,
+        static_cast<size_t>(_groupCommitSize)));
+    if (!_syncThread->start()) {
+      LOG_TOPIC(ERR, Logger::ENGINES)
+          << "could not start rocksdb sync thread";
+      TRI_ASSERT(false);
+    }
+  }
+
+  if (_rateLimiter != nullptr &&
+      (opts->_rateLimitAutoTune || opts->_throttleQueueLength > 0)) {
+    _compactionThrottle.reset(new RocksDBCompactionThrottle(
+        _rateLimiter, static_cast<int64_t>(opts->_rateLimit),
+        opts->_rateLimitAutoTune, opts->_throttleQueueLength));
+    if (!_compactionThrottle->start()) {
+      LOG_TOPIC(ERR, Logger::ENGINES)
+          << "could not start rocksdb compaction throttle";
+      TRI_ASSERT(false);
+    }
+  }
+
+  if (opts->_adaptiveWriteBuffers && _options.write_buffer_size > 0) {
+    // without a shared budget the write buffers may grow to four times
+    // their configured size, with one to the share of a single column family
+    uint64_t const writeBufferSize =
+        static_cast<uint64_t>(_options.write_buffer_size);
+    uint64_t maxWriteBufferSize = writeBufferSize * 4;
+    if (_writeBufferManager != nullptr) {
+      maxWriteBufferSize =
+          static_cast<uint64_t>(_writeBufferManager->buffer_size()) /
+          static_cast<uint64_t>(_options.max_write_buffer_number);
+    }
+    _writeBufferTuner.reset(new RocksDBWriteBufferTuner(
+        _db, RocksDBColumnFamily::_allHandles, writeBufferSize,
+        maxWriteBufferSize, _options.max_write_buffer_number,
+        _options.level0_slowdown_writes_trigger,
+        _options.level0_stop_writes_trigger - 1));
+    if (!_writeBufferTuner->start()) {
+      LOG_TOPIC(ERR, Logger::ENGINES)
+          << "could not start rocksdb write buffer tuner";
+      TRI_ASSERT(false);
+    }
+  }
+
   if (!systemDatabaseExists()) {
     addSystemDatabase();
   }
@@ -525,8 +817,41 @@ void RocksDBEngine::stop() {
   if (!isEnabled()) {
     return;
   }
+  if (MemoryGovernorFeature::GOVERNOR != nullptr) {
+    MemoryGovernorFeature::GOVERNOR->unregisterConsumer("rocksdb-memtables");
+    MemoryGovernorFeature::GOVERNOR->unregisterConsumer("rocksdb-block-cache");
+    MemoryGovernorFeature::GOVERNOR->unregisterConsumer(
+        "rocksdb-dedicated-block-cache");
+  }
   replicationManager()->dropAll();
 
+  if (_writeBufferTuner) {
+    _writeBufferTuner->beginShutdown();
+
+    while (_writeBufferTuner->isRunning()) {
+      usleep(10000);
+    }
+    _writeBufferTuner.reset();
+  }
+
+  if (_compactionThrottle) {
+    _compactionThrottle->beginShutdown();
+
+    while (_compactionThrottle->isRunning()) {
+      usleep(10000);
+    }
+    _compactionThrottle.reset();
+  }
+
+  if (_syncThread) {
+    _syncThread->beginShutdown();
+
+    while (_syncThread->isRunning()) {
+      usleep(10000);
+    }
+    _syncThread.reset();
+  }
+
   if (_backgroundThread) {
     // stop the press
     _backgroundThread->beginShutdown();
@@ -908,7 +1233,17 @@ bool RocksDBEngine::inRecovery() {
 }
 
 void RocksDBEngine::recoveryDone(TRI_vocbase_t* vocbase) {
-  // nothing to do here
+  // repair bulk loads interrupted by a crash
+  std::string const id = std::to_string(vocbase->id());
+  for (auto const& marker : _interruptedBulkLoads) {
+    VPackSlice database = marker->slice().get("database");
+    if (database.isString() && database.copyString() == id) {
+      RocksDBBulkLoadMethods::recover(vocbase, marker->slice());
+    }
+  }
+
+  // fill the caches with the keys that were hot before the restart
+  RocksDBCacheHeatMap::schedulePrefetch(vocbase->id());
 }
 
 std::string RocksDBEngine::createCollection(
@@ -926,11 +1261,27 @@ std::string RocksDBEngine::createCollection(
     _counterManager->updateCounter(objectId.getUInt(), adj);
   }
 
+  // the column family must exist before the collection does
+  bool const dedicated = basics::VelocyPackHelper::getBooleanValue(
+      builder.slice(), "dedicatedColumnFamily", false);
+  if (dedicated) {
+    Result r = createDedicatedColumnFamily(
+        basics::VelocyPackHelper::stringUInt64(builder.slice(), "objectId"));
+    if (r.fail()) {
+      THROW_ARANGO_EXCEPTION(r);
+    }
+  }
+
   int res = writeCreateCollectionMarker(
       vocbase->id(), cid, builder.slice(),
       RocksDBLogValue::CollectionCreate(vocbase->id(), cid));
 
   if (res != TRI_ERROR_NO_ERROR) {
+    if (dedicated) {
+      // otherwise only dropped on the next startup
+      dropDedicatedColumnFamily(basics::VelocyPackHelper::stringUInt64(
+          builder.slice(), "objectId"));
+    }
     THROW_ARANGO_EXCEPTION(res);
   }
 
@@ -1001,6 +1352,10 @@ arangodb::Result RocksDBEngine::dropCollection(
   batch.PutLogData(logValue.slice());
   batch.Delete(RocksDBColumnFamily::definitions(),
       RocksDBKey::Collection(vocbase->id(), collection->cid()).string());
+  batch.Delete(RocksDBColumnFamily::definitions(),
+      RocksDBKey::AttributeStatisticsValue(coll->objectId()).string());
+  batch.Delete(RocksDBColumnFamily::definitions(),
+      RocksDBKey::CacheHeatMapValue(coll->objectId()).string());
   rocksdb::Status res = _db->Write(options, &batch);
 
   // TODO FAILURE Simulate !res.ok()
@@ -1014,6 +1369,10 @@ arangodb::Result RocksDBEngine::dropCollection(
 
   // Unregister counter
   _counterManager->removeCounter(coll->objectId());
+  if (coll->expireAfter() > 0) {
+    RocksDBTtl::remove(coll->objectId());
+    RocksDBTtl::remove(coll->primaryIndex()->objectId());
+  }
 
   // remove from map
   {
@@ -1024,7 +1383,12 @@ arangodb::Result RocksDBEngine::dropCollection(
   // delete documents
   RocksDBKeyBounds bounds =
       RocksDBKeyBounds::CollectionDocuments(coll->objectId());
-  auto result = rocksutils::removeLargeRange(_db, bounds);
+  Result result;
+  if (coll->hasDedicatedColumnFamily()) {
+    result = dropDedicatedColumnFamily(coll->objectId());
+  } else {
+    result = rocksutils::removeLargeRange(_db, bounds);
+  }
   // TODO FAILURE Simulate result.fail()
   if (result.fail()) {
     // We try to remove all documents.
@@ -1062,7 +1426,7 @@ arangodb::Result RocksDBEngine::dropCollection(
   // amount of documents. otherwise don't run compaction, because it will
   // slow things down a lot, especially during tests that create/drop LOTS
   // of collections
-  if (numberDocuments >= 16384) {
+  if (numberDocuments >= 16384 && !coll->hasDedicatedColumnFamily()) {
     coll->compact();
   }
 
@@ -1178,6 +1542,86 @@ void RocksDBEngine::addRestHandlers(rest::RestHandlerFactory* handlerFactory) {
   RocksDBRestHandlers::registerResources(handlerFactory);
 }
 
+Result RocksDBEngine::createDedicatedColumnFamily(uint64_t objectId) {
+  TRI_ASSERT(objectId != 0);
+  rocksdb::ColumnFamilyHandle* cf = nullptr;
+  rocksdb::Status s = _db->CreateColumnFamily(
+      _dedicatedOptions, RocksDBColumnFamily::dedicatedName(objectId), &cf);
+  if (!s.ok()) {
+    return rocksutils::convertStatus(s);
+  }
+  registerDedicatedColumnFamily(objectId, cf);
+  return Result();
+}
+
+void RocksDBEngine::registerDedicatedColumnFamily(
+    uint64_t objectId, rocksdb::ColumnFamilyHandle* cf) {
+  TRI_ASSERT(objectId != 0);
+  WRITE_LOCKER(guard, RocksDBColumnFamily::_dedicatedLock);
+  RocksDBColumnFamily::_dedicated[objectId] = cf;
+  RocksDBColumnFamily::_dedicatedIds.emplace(cf->GetID());
+  RocksDBColumnFamily::_numDedicated.store(
+      RocksDBColumnFamily::_dedicatedIds.size());
+  RocksDBColumnFamily::_allHandles.push_back(cf);
+}
+
+Result RocksDBEngine::dropDedicatedColumnFamily(uint64_t objectId) {
+  rocksdb::ColumnFamilyHandle* cf = nullptr;
+  {
+    WRITE_LOCKER(guard, RocksDBColumnFamily::_dedicatedLock);
+    auto it = RocksDBColumnFamily::_dedicated.find(objectId);
+    if (it == RocksDBColumnFamily::_dedicated.end()) {
+      return Result();
+    }
+    cf = it->second;
+    // the id stays known, so that WAL entries written before the drop are
+    // still recognized as documents. the handle is only destroyed on
+    // shutdown, so that iterators still referring to it stay valid
+    RocksDBColumnFamily::_dedicated.erase(it);
+  }
+  return rocksutils::convertStatus(_db->DropColumnFamily(cf));
+}
+
+void RocksDBEngine::dropOrphanedColumnFamilies() {
+  std::vector<uint64_t> dedicated;
+  for (auto const& it : RocksDBColumnFamily::dedicated()) {
+    dedicated.emplace_back(it.first);
+  }
+  if (dedicated.empty()) {
+    return;
+  }
+
+  // a column family is created before the definition of its collection is
+  // stored, and the definition of a dropped collection is removed before
+  // its column family. a crash in between leaves the column family behind
+  std::unordered_set<uint64_t> collections;
+  rocksdb::ReadOptions readOptions;
+  std::unique_ptr<rocksdb::Iterator> iter(
+      _db->NewIterator(readOptions, RocksDBColumnFamily::definitions()));
+  auto rSlice = rocksDBSlice(RocksDBEntryType::Collection);
+  for (iter->Seek(rSlice); iter->Valid() && iter->key().starts_with(rSlice);
+       iter->Next()) {
+    auto slice = VPackSlice(iter->value().data());
+    collections.emplace(
+        basics::VelocyPackHelper::stringUInt64(slice, "objectId"));
+  }
+
+  for (uint64_t objectId :
+       RocksDBColumnFamily::orphaned(dedicated, collections)) {
+    LOG_TOPIC(WARN, Logger::ENGINES)
+        << "dropping column family '"
+        << RocksDBColumnFamily::dedicatedName(objectId)
+        << "', which belongs to no collection";
+    Result res = dropDedicatedColumnFamily(objectId);
+    if (res.fail()) {
+      LOG_TOPIC(WARN, Logger::ENGINES)
+          << "unable to drop column family '"
+          << RocksDBColumnFamily::dedicatedName(objectId)
+          << "': " << res.errorMessage();
+    }
+  }
+}
+
 void RocksDBEngine::addCollectionMapping(uint64_t objectId, TRI_voc_tick_t did,
                                          TRI_voc_cid_t cid) {
   if (objectId == 0) {
@@ -1211,6 +1655,10 @@ arangodb::Result RocksDBEngine::syncWal() {
 #endif
 }
 
+std::string RocksDBEngine::bulkLoadPath() const {
+  return _path + TRI_DIR_SEPARATOR_STR + "bulk-load";
+}
+
 Result RocksDBEngine::createLoggerState(TRI_vocbase_t* vocbase,
                                         VPackBuilder& builder) {
   syncWal();
@@ -1261,6 +1709,13 @@ Result RocksDBEngine::createLoggerState(TRI_vocbase_t* vocbase,
 }
 
 void RocksDBEngine::determinePrunableWalFiles(TRI_voc_tick_t minTickToKeep) {
+  {
+    MUTEX_LOCKER(guard, _retainedWalLock);
+    if (!_retainedWalTicks.empty()) {
+      minTickToKeep = (std::min)(minTickToKeep, *_retainedWalTicks.begin());
+    }
+  }
+
   rocksdb::VectorLogPtr files;
 
   auto status = _db->GetSortedWalFiles(files);
@@ -1292,6 +1747,19 @@ void RocksDBEngine::determinePrunableWalFiles(TRI_voc_tick_t minTickToKeep) {
   }
 }
 
+void RocksDBEngine::retainWal(TRI_voc_tick_t tick) {
+  MUTEX_LOCKER(guard, _retainedWalLock);
+  _retainedWalTicks.insert(tick);
+}
+
+void RocksDBEngine::releaseWal(TRI_voc_tick_t tick) {
+  MUTEX_LOCKER(guard, _retainedWalLock);
+  auto it = _retainedWalTicks.find(tick);
+  if (it != _retainedWalTicks.end()) {
+    _retainedWalTicks.erase(it);
+  }
+}
+
 void RocksDBEngine::pruneWalFiles() {
   // go through the map of WAL files that we have already and check if they are
   // "expired"
@@ -1344,6 +1812,7 @@ Result RocksDBEngine::dropDatabase(TRI_voc_tick_t id) {
             basics::VelocyPackHelper::getBooleanValue(it, "unique", false);
         RocksDBKeyBounds bounds =
             RocksDBIndex::getBounds(type, objectId, unique);
+        RocksDBTtl::remove(objectId);
 
         res = rocksutils::removeLargeRange(_db, bounds);
         if (res.fail()) {
@@ -1365,12 +1834,18 @@ Result RocksDBEngine::dropDatabase(TRI_voc_tick_t id) {
         basics::VelocyPackHelper::stringUInt64(val.second.slice(), "objectId");
     // delete documents
     RocksDBKeyBounds bounds = RocksDBKeyBounds::CollectionDocuments(objectId);
-    res = rocksutils::removeLargeRange(_db, bounds);
+    if (basics::VelocyPackHelper::getBooleanValue(
+            val.second.slice(), "dedicatedColumnFamily", false)) {
+      res = dropDedicatedColumnFamily(objectId);
+    } else {
+      res = rocksutils::removeLargeRange(_db, bounds);
+    }
     if (res.fail()) {
       return res;
     }
     // delete collection meta-data
     _counterManager->removeCounter(objectId);
+    RocksDBTtl::remove(objectId);
     res = globalRocksDBRemove(RocksDBColumnFamily::definitions(),
                               val.first.string(), options);
     if (res.fail()) {
@@ -1501,6 +1976,8 @@ TRI_vocbase_t* RocksDBEngine::openExistingDatabase(TRI_voc_tick_t id,
     VPackSlice slice = builder.slice();
     TRI_ASSERT(slice.isArray());
 
+    std::vector<RocksDBCollection*> collections;
+
     for (auto const& it : VPackArrayIterator(slice)) {
       // we found a collection that is still active
       TRI_ASSERT(!it.get("id").isNone() || !it.get("cid").isNone());
@@ -1515,13 +1992,14 @@ TRI_vocbase_t* RocksDBEngine::openExistingDatabase(TRI_voc_tick_t id,
       auto physical =
           static_cast<RocksDBCollection*>(collection->getPhysical());
       TRI_ASSERT(physical != nullptr);
+      collections.emplace_back(physical);
 
-      physical->deserializeIndexEstimates(counterManager());
-      physical->deserializeKeyGenerator(counterManager());
       LOG_TOPIC(DEBUG, arangodb::Logger::FIXME) << "added document collection '"
                                                 << collection->name() << "'";
     }
 
+    loadCollectionStates(collections);
+
     return vocbase.release();
   } catch (std::exception const& ex) {
     LOG_TOPIC(ERR, arangodb::Logger::FIXME) << "error while opening database: "
@@ -1534,6 +2012,66 @@ TRI_vocbase_t* RocksDBEngine::openExistingDatabase(TRI_voc_tick_t id,
   }
 }
 
+/// @brief loads the index estimates, key generator values and attribute
+/// statistics of the collections of a database. only databases with many
+/// collections use more than one thread, the databases themselves are
+/// opened in parallel already
+void RocksDBEngine::loadCollectionStates(
+    std::vector<RocksDBCollection*> const& collections) {
+  static constexpr size_t CollectionsPerThread = 64;
+
+  std::atomic<size_t> next(0);
+  Mutex failureLock;
+  std::exception_ptr failure;
+
+  auto load = [&]() {
+    while (true) {
+      size_t const i = next++;
+      if (i >= collections.size()) {
+        return;
+      }
+      {
+        MUTEX_LOCKER(locker, failureLock);
+        if (failure) {
+          return;
+        }
+      }
+      try {
+        RocksDBCollection* physical = collections[i];
+        physical->deserializeIndexEstimates(counterManager());
+        physical->deserializeKeyGenerator(counterManager());
+        physical->deserializeAttributeStatistics();
+      } catch (...) {
+        MUTEX_LOCKER(locker, failureLock);
+        if (!failure) {
+          failure = std::current_exception();
+        }
+        return;
+      }
+    }
+  };
+
+  size_t numThreads = 1;
+  if (DatabaseFeature::DATABASE != nullptr) {
+    numThreads = (std::max)(
+        (std::min)(collections.size() / CollectionsPerThread,
+                   DatabaseFeature::DATABASE->openThreads()),
+        static_cast<size_t>(1));
+  }
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < numThreads; ++i) {
+    threads.emplace_back(load);
+  }
+  load();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+}
+
 RocksDBCounterManager* RocksDBEngine::counterManager() const {
   TRI_ASSERT(_counterManager);
   return _counterManager.get();
@@ -1639,12 +2177,53 @@ void RocksDBEngine::getStatistics(VPackBuilder& builder) const {
     }
   }
 
+  if (_dedicatedBlockCache != nullptr) {
+    builder.add("rocksdb.dedicated-block-cache-used",
+                VPackValue(_dedicatedBlockCache->GetUsage()));
+  }
+
   cache::Manager* manager = CacheManagerFeature::MANAGER;
   auto rates = manager->globalHitRates();
   builder.add("cache.size", VPackValue(manager->globalLimit()));
   builder.add("cache.used", VPackValue(manager->globalAllocation()));
   builder.add("cache.hit-rate-lifetime", VPackValue(rates.first));
   builder.add("cache.hit-rate-recent", VPackValue(rates.second));
+
+  if (_rateLimiter) {
+    builder.add("rate-limit.bytes-per-second",
+                VPackValue(_rateLimiter->GetBytesPerSecond()));
+    builder.add("rate-limit.bytes-through",
+                VPackValue(_rateLimiter->GetTotalBytesThrough()));
+  }
+  if (_compactionThrottle) {
+    builder.add("rate-limit.throttles",
+                VPackValue(_compactionThrottle->numThrottles()));
+  }
+
+  if (_writeBufferManager) {
+    builder.add("write-buffers.budget",
+                VPackValue(_writeBufferManager->buffer_size()));
+    builder.add("write-buffers.used",
+                VPackValue(_writeBufferManager->memory_usage()));
+  }
+  if (_writeBufferTuner) {
+    builder.add("write-buffers.size",
+                VPackValue(_writeBufferTuner->writeBufferSize()));
+    builder.add("write-buffers.slowdown-trigger",
+                VPackValue(_writeBufferTuner->slowdownTrigger()));
+    builder.add("write-buffers.writes-per-second",
+                VPackValue(_writeBufferTuner->writesPerSecond()));
+    builder.add("write-buffers.delayed-intervals",
+                VPackValue(_writeBufferTuner->numDelayed()));
+    builder.add("write-buffers.stopped-intervals",
+                VPackValue(_writeBufferTuner->numStopped()));
+  }
+
+  if (_syncThread) {
+    builder.add("group-commit.syncs", VPackValue(_syncThread->numSyncs()));
+    builder.add("group-commit.commits",
+                VPackValue(_syncThread->numSyncedCommits()));
+  }
   
   // print column family statistics
   builder.add("columnFamilies", VPackValue(VPackValueType::Object));
@@ -1655,6 +2234,9 @@ void RocksDBEngine::getStatistics(VPackBuilder& builder) const {
   addCf("vpack", RocksDBColumnFamily::vpack());
   addCf("geo", RocksDBColumnFamily::geo());
   addCf("fulltext", RocksDBColumnFamily::fulltext());
+  for (auto const& it : RocksDBColumnFamily::dedicated()) {
+    addCf(RocksDBColumnFamily::dedicatedName(it.first), it.second);
+  }
   builder.close();
 
   builder.close();
@@ -44,7 +44,12 @@ namespace arangodb {
 class PhysicalCollection;
 class PhysicalView;
 class RocksDBBackgroundThread;
+class RocksDBCollection;
+class RocksDBCompactionThrottle;
+class RocksDBSyncThread;
+class RocksDBTtlCompactionFilter;
 class RocksDBVPackComparator;
+class RocksDBWriteBufferTuner;
 class RocksDBCounterManager;
 class RocksDBReplicationManager;
 class RocksDBLogValue;
@@ -82,6 +87,9 @@ class RocksDBEngine final : public StorageEngine {
   void unprepare() override;
 
   bool supportsDfdb() const override { return false; }
+
+  bool supportsBackgroundIndexing() const override { return true; }
+  bool supportsParallelDatabaseOpening() const override { return true; }
   bool useRawDocumentPointers() override { return false; }
 
   TransactionManager* createTransactionManager() override;
@@ -237,9 +245,24 @@ class RocksDBEngine final : public StorageEngine {
   TRI_vocbase_t* openExistingDatabase(TRI_voc_tick_t id,
                                       std::string const& name,
                                       bool wasCleanShutdown, bool isUpgrade);
+  /// @brief loads the persisted states of the collections of a database
+  void loadCollectionStates(std::vector<RocksDBCollection*> const& collections);
 
   std::string getCompressionSupport() const;
 
+  /// @brief creates and registers the dedicated documents column family
+  /// of a collection
+  Result createDedicatedColumnFamily(uint64_t objectId);
+  /// @brief registers the handle of a dedicated documents column family
+  void registerDedicatedColumnFamily(uint64_t objectId,
+                                     rocksdb::ColumnFamilyHandle* cf);
+  /// @brief drops the dedicated documents column family of a collection
+  /// with all its documents
+  Result dropDedicatedColumnFamily(uint64_t objectId);
+  /// @brief drops the dedicated documents column families that belong to
+  /// no collection
+  void dropOrphanedColumnFamilies();
+
 #ifdef USE_ENTERPRISE
   void collectEnterpriseOptions(std::shared_ptr<options::ProgramOptions>);
   void validateEnterpriseOptions(std::shared_ptr<options::ProgramOptions>);
@@ -256,12 +279,41 @@ class RocksDBEngine final : public StorageEngine {
   RocksDBCounterManager* counterManager() const;
   RocksDBReplicationManager* replicationManager() const;
   arangodb::Result syncWal();
+  /// @brief keep the WAL files containing the given tick and all later ones
+  /// until the tick is released again
+  void retainWal(TRI_voc_tick_t tick);
+  void releaseWal(TRI_voc_tick_t tick);
+  /// @brief number of threads filling an index in the background
+  size_t indexBuildThreads() const {
+    return static_cast<size_t>(_indexBuildThreads);
+  }
+  /// @brief number of threads reading a full collection scan in parallel
+  size_t scanThreads() const {
+    return static_cast<size_t>(_scanThreads);
+  }
+  /// @brief directory for the temporary files of bulk loads
+  std::string bulkLoadPath() const;
+  /// @brief memory a bulk load may use before spilling sorted runs to disk
+  size_t bulkLoadMemory() const {
+    return static_cast<size_t>(_bulkLoadMemory);
+  }
+  /// @brief group commit thread, nullptr if group commit is disabled
+  RocksDBSyncThread* syncThread() const { return _syncThread.get(); }
 
  private:
   /// single rocksdb database used in this storage engine
   rocksdb::TransactionDB* _db;
   /// default read options
   rocksdb::Options _options;
+  /// options for dedicated documents column families of collections
+  rocksdb::ColumnFamilyOptions _dedicatedOptions;
+  /// block cache of the dedicated column families, nullptr if they use the
+  /// shared one
+  std::shared_ptr<rocksdb::Cache> _dedicatedBlockCache;
+  /// compaction filters dropping expired documents and their primary index
+  /// entries, must outlive the database
+  std::unique_ptr<RocksDBTtlCompactionFilter> _documentsTtlFilter;
+  std::unique_ptr<RocksDBTtlCompactionFilter> _primaryTtlFilter;
   /// arangodb comparator - requried because of vpack in keys
   std::unique_ptr<RocksDBVPackComparator> _vpackCmp;
   /// path used by rocksdb (inside _basePath)
@@ -275,6 +327,17 @@ class RocksDBEngine final : public StorageEngine {
   std::unique_ptr<RocksDBCounterManager> _counterManager;
   /// Background thread handling garbage collection etc
   std::unique_ptr<RocksDBBackgroundThread> _backgroundThread;
+  /// Thread syncing the WAL for groups of committing transactions
+  std::unique_ptr<RocksDBSyncThread> _syncThread;
+  /// limits the write rate of flushes and compactions, nullptr if unlimited
+  std::shared_ptr<rocksdb::RateLimiter> _rateLimiter;
+  /// Thread adjusting the rate limit to the foreground load
+  std::unique_ptr<RocksDBCompactionThrottle> _compactionThrottle;
+  /// shared budget of the write buffers of all column families, nullptr if
+  /// unlimited
+  std::shared_ptr<rocksdb::WriteBufferManager> _writeBufferManager;
+  /// Thread adjusting the write buffers to the write load
+  std::unique_ptr<RocksDBWriteBufferTuner> _writeBufferTuner;
   uint64_t _maxTransactionSize;       // maximum allowed size for a transaction
   uint64_t _intermediateCommitSize;   // maximum size for a
                                       // transaction before an
@@ -289,8 +352,29 @@ class RocksDBEngine final : public StorageEngine {
   // which WAL files can be pruned when
   std::unordered_map<std::string, double> _prunableWalFiles;
 
+  // ticks from which on WAL files must be kept for internal readers
+  Mutex _retainedWalLock;
+  std::multiset<TRI_voc_tick_t> _retainedWalTicks;
+
   // number of seconds to wait before an obsolete WAL file is actually pruned
   double _pruneWaitTime;
+
+  // maximum number of milliseconds a group commit waits for further
+  // transactions to join, 0 disables group commit
+  uint64_t _groupCommitDelay;
+  // number of waiting transactions that triggers a group commit immediately
+  uint64_t _groupCommitSize;
+
+  // memory (in bytes) a bulk load may use for buffering entries
+  uint64_t _bulkLoadMemory;
+  // markers of bulk loads interrupted by a crash, repaired after recovery
+  std::vector<std::shared_ptr<VPackBuilder>> _interruptedBulkLoads;
+
+  // number of threads filling an index in the background
+  uint64_t _indexBuildThreads;
+
+  // number of threads reading a full collection scan in parallel
+  uint64_t _scanThreads;
 };
 }  // namespace arangodb
 #endif
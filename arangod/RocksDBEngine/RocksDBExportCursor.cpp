@@ -29,6 +29,7 @@
 #include "StorageEngine/EngineSelectorFeature.h"
 #include "StorageEngine/PhysicalCollection.h"
 #include "StorageEngine/StorageEngine.h"
+#include "StorageEngine/TransactionState.h"
 #include "Transaction/Hints.h"
 #include "Transaction/StandaloneContext.h"
 #include "Utils/SingleCollectionTransaction.h"
@@ -48,7 +49,8 @@ using namespace arangodb;
 RocksDBExportCursor::RocksDBExportCursor(
     TRI_vocbase_t* vocbase, std::string const& name,
     CollectionExport::Restrictions const& restrictions, CursorId id,
-    size_t limit, size_t batchSize, double ttl, bool hasCount)
+    size_t limit, size_t batchSize, double ttl, bool hasCount,
+    bool readCommitted)
     : Cursor(id, batchSize, nullptr, ttl, hasCount),
       _vocbaseGuard(vocbase),
       _resolver(vocbase),
@@ -65,6 +67,7 @@ RocksDBExportCursor::RocksDBExportCursor(
   _trx.reset(new SingleCollectionTransaction(
       transaction::StandaloneContext::Create(_collection->vocbase()), _name,
       AccessMode::Type::READ));
+  _trx->state()->options().readCommitted = readCommitted;
 
   // already locked by guard above
   _trx->addHint(transaction::Hints::Hint::NO_USAGE_LOCK);
@@ -157,7 +160,11 @@ void RocksDBExportCursor::dump(VPackBuilder& builder) {
       return true;
     };
 
-    _iter->nextDocument(cb, n);
+    if (!_iter->nextDocument(cb, n) && _position < _size) {
+      // with read committed exports, documents may have been removed
+      // since the count was taken
+      _size = _position;
+    }
 
     builder.close();  // close Array
 
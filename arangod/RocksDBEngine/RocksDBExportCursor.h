@@ -45,9 +45,11 @@ class IndexIterator;
 
 class RocksDBExportCursor final : public Cursor {
  public:
+  /// @brief with readCommitted the export moves on to a new snapshot for
+  /// every batch, instead of holding on to one for the cursor's lifetime
   RocksDBExportCursor(TRI_vocbase_t*, std::string const&,
                       CollectionExport::Restrictions const&, CursorId, size_t,
-                      size_t, double, bool);
+                      size_t, double, bool, bool readCommitted = false);
 
   ~RocksDBExportCursor();
 
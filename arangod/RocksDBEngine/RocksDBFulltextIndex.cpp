@@ -36,6 +36,7 @@
 #include "RocksDBEngine/RocksDBToken.h"
 #include "RocksDBEngine/RocksDBTransactionState.h"
 #include "RocksDBEngine/RocksDBTypes.h"
+#include "RocksDBEngine/RocksDBValue.h"
 #include "StorageEngine/DocumentIdentifierToken.h"
 
 #include <rocksdb/utilities/transaction_db.h>
@@ -44,6 +45,7 @@
 #include <velocypack/velocypack-aliases.h>
 
 #include <algorithm>
+#include <cmath>
 
 using namespace arangodb;
 
@@ -186,22 +188,25 @@ Result RocksDBFulltextIndex::insertInternal(transaction::Methods* trx,
                                             RocksDBMethods* mthd,
                                             TRI_voc_rid_t revisionId,
                                             VPackSlice const& doc) {
-  std::set<std::string> words = wordlist(doc);
+  std::map<std::string, size_t> words = wordlist(doc);
   if (words.empty()) {
     return TRI_ERROR_NO_ERROR;
   }
 
-  // now we are going to construct the value to insert into rocksdb
-  // unique indexes have a different key structure
-  RocksDBValue value = RocksDBValue::VPackIndexValue();
+  // the document length is needed for relevance scoring
+  uint64_t length = 0;
+  for (auto const& it : words) {
+    length += it.second;
+  }
 
   int res = TRI_ERROR_NO_ERROR;
-  // size_t const count = words.size();
-  for (std::string const& word : words) {
-    RocksDBKey key =
-        RocksDBKey::FulltextIndexValue(_objectId, StringRef(word), revisionId);
+  for (auto const& it : words) {
+    RocksDBKey key = RocksDBKey::FulltextIndexValue(
+        _objectId, StringRef(it.first), revisionId);
+    RocksDBValue value = RocksDBValue::FulltextIndexValue(it.second, length);
 
-    Result r = mthd->Put(_cf, key, value.string(), rocksutils::index);
+    // the key contains the revision id, so no other transaction writes it
+    Result r = mthd->PutUntracked(_cf, key, value.string(), rocksutils::index);
     if (!r.ok()) {
       res = r.errorNumber();
       break;
@@ -214,19 +219,17 @@ Result RocksDBFulltextIndex::removeInternal(transaction::Methods* trx,
                                             RocksDBMethods* mthd,
                                             TRI_voc_rid_t revisionId,
                                             VPackSlice const& doc) {
-  std::set<std::string> words = wordlist(doc);
+  std::map<std::string, size_t> words = wordlist(doc);
   if (words.empty()) {
     return IndexResult(TRI_ERROR_NO_ERROR);
   }
 
-  // now we are going to construct the value to insert into rocksdb
-  // unique indexes have a different key structure
   int res = TRI_ERROR_NO_ERROR;
-  for (std::string const& word : words) {
-    RocksDBKey key =
-        RocksDBKey::FulltextIndexValue(_objectId, StringRef(word), revisionId);
+  for (auto const& it : words) {
+    RocksDBKey key = RocksDBKey::FulltextIndexValue(
+        _objectId, StringRef(it.first), revisionId);
 
-    Result r = mthd->Delete(_cf, key);
+    Result r = mthd->DeleteUntracked(_cf, key);
     if (!r.ok()) {
       res = r.errorNumber();
       break;
@@ -237,7 +240,8 @@ Result RocksDBFulltextIndex::removeInternal(transaction::Methods* trx,
 
 /// @brief walk over the attribute. Also Extract sub-attributes and elements in
 ///        list.
-static void ExtractWords(std::set<std::string>& words, VPackSlice const value,
+static void ExtractWords(std::map<std::string, size_t>& words,
+                         VPackSlice const value,
                          size_t minWordLength, int level) {
   if (value.isString()) {
     // extract the string value for the indexed attribute
@@ -261,8 +265,9 @@ static void ExtractWords(std::set<std::string>& words, VPackSlice const value,
 
 /// @brief callback function called by the fulltext index to determine the
 /// words to index for a specific document
-std::set<std::string> RocksDBFulltextIndex::wordlist(VPackSlice const& doc) {
-  std::set<std::string> words;
+std::map<std::string, size_t> RocksDBFulltextIndex::wordlist(
+    VPackSlice const& doc) {
+  std::map<std::string, size_t> words;
   VPackSlice const value = doc.get(_attr);
 
   if (!value.isString() && !value.isArray() && !value.isObject()) {
@@ -389,29 +394,48 @@ Result RocksDBFulltextIndex::parseQueryString(std::string const& qstr,
 
 Result RocksDBFulltextIndex::executeQuery(transaction::Methods* trx,
                                           FulltextQuery const& query,
-                                          size_t maxResults,
+                                          size_t maxResults, bool score,
                                           VPackBuilder& builder) {
-  std::set<TRI_voc_rid_t> resultSet;
+  auto physical = static_cast<RocksDBCollection*>(_collection->getPhysical());
+  uint64_t numDocuments = score ? physical->numberDocuments(trx) : 0;
+
+  std::map<TRI_voc_rid_t, double> resultSet;
   for (FulltextQueryToken const& token : query) {
-    applyQueryToken(trx, token, resultSet);
+    Result res = applyQueryToken(trx, token, score, numDocuments, resultSet);
+    if (!res.ok()) {
+      return res;
+    }
   }
 
-  auto physical = static_cast<RocksDBCollection*>(_collection->getPhysical());
   ManagedDocumentResult mmdr;
   if (maxResults == 0) {  // 0 appearantly means "all results"
     maxResults = SIZE_MAX;
   }
 
+  std::vector<std::pair<TRI_voc_rid_t, double>> results(resultSet.begin(),
+                                                        resultSet.end());
+  resultSet.clear();
+  if (score) {
+    // documents are only fetched for the best results
+    std::sort(results.begin(), results.end(),
+              [](std::pair<TRI_voc_rid_t, double> const& lhs,
+                 std::pair<TRI_voc_rid_t, double> const& rhs) {
+                if (lhs.second != rhs.second) {
+                  return lhs.second > rhs.second;
+                }
+                return lhs.first < rhs.first;
+              });
+  }
+
   builder.openArray();
   // get the first N results
-  std::set<TRI_voc_rid_t>::iterator it = resultSet.cbegin();
-  while (maxResults > 0 && it != resultSet.cend()) {
-    RocksDBToken token(*it);
+  for (auto it = results.cbegin(); maxResults > 0 && it != results.cend();
+       ++it) {
+    RocksDBToken token(it->first);
     if (token.revisionId() && physical->readDocument(trx, token, mmdr)) {
       mmdr.addToBuilder(builder, true);
       maxResults--;
     }
-    ++it;
   }
   builder.close();
 
@@ -428,9 +452,68 @@ static RocksDBKeyBounds MakeBounds(uint64_t oid,
   THROW_ARANGO_EXCEPTION(TRI_ERROR_NOT_IMPLEMENTED);
 }
 
-Result RocksDBFulltextIndex::applyQueryToken(
+/// @brief BM25 term frequency saturation
+static constexpr double BM25K1 = 1.2;
+
+/// @brief BM25 document length normalization
+static constexpr double BM25B = 0.75;
+
+/// @brief AND tokens look up each revision of the result set instead of
+/// scanning the posting list of the word if the result set is at most this
+/// large. rocksdb's block index serves as skip list for these lookups
+static constexpr size_t SeekIntersectionThreshold = 1000;
+
+namespace {
+struct FulltextPosting {
+  TRI_voc_rid_t revisionId;
+  uint64_t termFrequency;
+  uint64_t documentLength;
+};
+}
+
+Result RocksDBFulltextIndex::intersectBySeeks(
     transaction::Methods* trx, FulltextQueryToken const& token,
-    std::set<TRI_voc_rid_t>& resultSet) {
+    std::map<TRI_voc_rid_t, double>& resultSet) {
+  TRI_ASSERT(token.matchType == FulltextQueryToken::COMPLETE);
+  auto mthds = RocksDBTransactionState::toMethods(trx);
+  RocksDBKeyBounds bounds = MakeBounds(_objectId, token);
+  rocksdb::Slice end = bounds.end();
+
+  rocksdb::ReadOptions ro = mthds->readOptions();
+  ro.iterate_upper_bound = &end;
+  std::unique_ptr<rocksdb::Iterator> iter = mthds->NewIterator(ro, _cf);
+
+  for (auto it = resultSet.begin(); it != resultSet.end();) {
+    RocksDBKey key = RocksDBKey::FulltextIndexValue(
+        _objectId, StringRef(token.value), it->first);
+    rocksdb::Slice const wanted(key.string());
+    iter->Seek(wanted);
+    if (iter->Valid() && iter->key() == wanted) {
+      ++it;
+    } else {
+      rocksdb::Status s = iter->status();
+      if (!s.ok()) {
+        return rocksutils::convertStatus(s);
+      }
+      it = resultSet.erase(it);
+    }
+  }
+  return Result();
+}
+
+Result RocksDBFulltextIndex::applyQueryToken(
+    transaction::Methods* trx, FulltextQueryToken const& token, bool score,
+    uint64_t numDocuments, std::map<TRI_voc_rid_t, double>& resultSet) {
+  if (token.operation != FulltextQueryToken::OR && resultSet.empty()) {
+    // nothing to intersect with or to exclude from
+    return Result();
+  }
+  if (!score && token.operation == FulltextQueryToken::AND &&
+      token.matchType == FulltextQueryToken::COMPLETE &&
+      resultSet.size() <= SeekIntersectionThreshold) {
+    return intersectBySeeks(trx, token, resultSet);
+  }
+
   auto mthds = RocksDBTransactionState::toMethods(trx);
   // why can't I have an assignment operator when I want one
   RocksDBKeyBounds bounds = MakeBounds(_objectId, token);
@@ -442,38 +525,75 @@ Result RocksDBFulltextIndex::applyQueryToken(
   std::unique_ptr<rocksdb::Iterator> iter = mthds->NewIterator(ro, _cf);
   iter->Seek(bounds.start());
 
-  // set is used to perform an intersection with the result set
-  std::set<TRI_voc_rid_t> intersect;
-  // apply left to right logic, merging all current results with ALL previous
+  std::vector<FulltextPosting> postings;
+  uint64_t totalLength = 0;
+  uint64_t withLength = 0;
   while (iter->Valid() && cmp->Compare(iter->key(), end) < 0) {
     TRI_ASSERT(_objectId == RocksDBKey::objectId(iter->key()));
 
-    rocksdb::Status s = iter->status();
-    if (!s.ok()) {
-      return rocksutils::convertStatus(s);
-    }
-
-    TRI_voc_rid_t revId = RocksDBKey::revisionId(
+    FulltextPosting posting;
+    posting.revisionId = RocksDBKey::revisionId(
         RocksDBEntryType::FulltextIndexValue, iter->key());
-    if (token.operation == FulltextQueryToken::AND) {
-      intersect.insert(revId);
-    } else if (token.operation == FulltextQueryToken::OR) {
-      resultSet.insert(revId);
-    } else if (token.operation == FulltextQueryToken::EXCLUDE) {
-      resultSet.erase(revId);
+    if (score) {
+      RocksDBValue::fulltextStatistics(iter->value(), posting.termFrequency,
+                                       posting.documentLength);
+      if (posting.documentLength > 0) {
+        totalLength += posting.documentLength;
+        ++withLength;
+      }
     }
+    postings.emplace_back(posting);
     iter->Next();
   }
-  if (token.operation == FulltextQueryToken::AND) {
-    if (resultSet.empty() || intersect.empty()) {
-      resultSet.clear();
-    } else {
-      std::set<TRI_voc_rid_t> output;
-      std::set_intersection(resultSet.begin(), resultSet.end(),
-                            intersect.begin(), intersect.end(),
-                            std::inserter(output, output.begin()));
-      resultSet = std::move(output);
+  rocksdb::Status s = iter->status();
+  if (!s.ok()) {
+    return rocksutils::convertStatus(s);
+  }
+
+  // the average document length is estimated from the matching documents,
+  // the index does not keep statistics over all documents
+  double idf = 0.0;
+  double averageLength = 1.0;
+  if (score) {
+    double df = static_cast<double>(postings.size());
+    double n = (std::max)(static_cast<double>(numDocuments), df);
+    idf = std::log(1.0 + (n - df + 0.5) / (df + 0.5));
+    if (withLength > 0) {
+      averageLength = static_cast<double>(totalLength) / withLength;
+    }
+  }
+  auto weight = [&](FulltextPosting const& posting) -> double {
+    if (!score) {
+      return 0.0;
+    }
+    double tf = static_cast<double>(posting.termFrequency);
+    double length = posting.documentLength > 0
+                        ? static_cast<double>(posting.documentLength)
+                        : averageLength;
+    return idf * tf * (BM25K1 + 1.0) /
+           (tf + BM25K1 * (1.0 - BM25B + BM25B * length / averageLength));
+  };
+
+  // apply left to right logic, merging all current results with ALL previous
+  if (token.operation == FulltextQueryToken::OR) {
+    for (FulltextPosting const& posting : postings) {
+      resultSet[posting.revisionId] += weight(posting);
+    }
+  } else if (token.operation == FulltextQueryToken::EXCLUDE) {
+    for (FulltextPosting const& posting : postings) {
+      resultSet.erase(posting.revisionId);
+    }
+  } else if (token.operation == FulltextQueryToken::AND) {
+    std::map<TRI_voc_rid_t, double> output;
+    for (FulltextPosting const& posting : postings) {
+      auto it = resultSet.find(posting.revisionId);
+      if (it != resultSet.end()) {
+        // a prefix may match several words of the same document
+        auto inserted = output.emplace(posting.revisionId, it->second);
+        inserted.first->second += weight(posting);
+      }
     }
+    resultSet = std::move(output);
   }
   return Result();
 }
@@ -106,8 +106,11 @@ class RocksDBFulltextIndex final : public RocksDBIndex {
       TRI_voc_rid_t revisionId);
 
   arangodb::Result parseQueryString(std::string const&, FulltextQuery&);
+  /// @brief executes the query and adds up to maxResults documents to the
+  /// builder. with score set the documents are ordered by their BM25
+  /// relevance, otherwise in revision order
   arangodb::Result executeQuery(transaction::Methods* trx, FulltextQuery const&,
-                                size_t maxResults,
+                                size_t maxResults, bool score,
                                 velocypack::Builder& builder);
 
  protected:
@@ -121,7 +124,8 @@ class RocksDBFulltextIndex final : public RocksDBIndex {
                         arangodb::velocypack::Slice const&) override;
 
  private:
-  std::set<std::string> wordlist(arangodb::velocypack::Slice const&);
+  /// @brief the words of a document with their number of occurrences
+  std::map<std::string, size_t> wordlist(arangodb::velocypack::Slice const&);
 
   /// @brief the indexed attribute (path)
   std::vector<std::string> _attr;
@@ -129,9 +133,18 @@ class RocksDBFulltextIndex final : public RocksDBIndex {
   /// @brief minimum word length
   int _minWordLength;
 
+  /// @brief applies a token to the result set, which maps the matching
+  /// revisions to their score. numDocuments is only used for scoring
   arangodb::Result applyQueryToken(transaction::Methods* trx,
-                                   FulltextQueryToken const&,
-                                   std::set<TRI_voc_rid_t>& resultSet);
+                                   FulltextQueryToken const&, bool score,
+                                   uint64_t numDocuments,
+                                   std::map<TRI_voc_rid_t, double>& resultSet);
+
+  /// @brief intersects the result set with a complete word by looking up
+  /// each revision instead of scanning the whole posting list
+  arangodb::Result intersectBySeeks(transaction::Methods* trx,
+                                    FulltextQueryToken const&,
+                                    std::map<TRI_voc_rid_t, double>& resultSet);
 };
 }  // namespace arangodb
 
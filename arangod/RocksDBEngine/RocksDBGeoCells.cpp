@@ -0,0 +1,222 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RocksDBGeoCells.h"
+
+using namespace arangodb::rocksdbengine;
+
+/// @brief number of grid positions per axis on the deepest level
+static constexpr uint32_t GridSize = 1U << geocells::MaxLevel;
+
+/// @brief slack in meters added to every covered radius, so that rounding
+/// errors never exclude a point at the border of the cap
+static constexpr double CoveringSlack = 1.0;
+
+namespace {
+/// @brief a rectangle of grid positions on the deepest level, inclusive
+struct GridRect {
+  uint32_t xMin;
+  uint32_t xMax;
+  uint32_t yMin;
+  uint32_t yMax;
+};
+}
+
+/// @brief map a value from [min, max] onto the grid
+static uint32_t GridPosition(double value, double min, double max) {
+  double pos = (value - min) / (max - min) * static_cast<double>(GridSize);
+  if (pos <= 0.0 || std::isnan(pos)) {
+    return 0;
+  }
+  if (pos >= static_cast<double>(GridSize - 1)) {
+    return GridSize - 1;
+  }
+  return static_cast<uint32_t>(pos);
+}
+
+/// @brief position of a grid point on the Hilbert curve of the deepest level
+static uint64_t HilbertIndex(uint32_t x, uint32_t y) {
+  uint64_t d = 0;
+  for (uint32_t s = GridSize / 2; s > 0; s /= 2) {
+    uint32_t rx = (x & s) > 0 ? 1 : 0;
+    uint32_t ry = (y & s) > 0 ? 1 : 0;
+    d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+    // rotate the quadrant, so the curve inside it starts at its origin
+    if (ry == 0) {
+      if (rx == 1) {
+        x = GridSize - 1 - x;
+        y = GridSize - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+
+static GridRect MakeRect(double latMin, double latMax, double lonMin,
+                         double lonMax) {
+  return GridRect{GridPosition(lonMin, -180.0, 180.0),
+                  GridPosition(lonMax, -180.0, 180.0),
+                  GridPosition(latMin, -90.0, 90.0),
+                  GridPosition(latMax, -90.0, 90.0)};
+}
+
+/// @brief latitude/longitude rectangles that contain the spherical cap.
+/// caps crossing the antimeridian are split into two rectangles
+static std::vector<GridRect> CapBounds(double latitude, double longitude,
+                                       double radius) {
+  std::vector<GridRect> rects;
+  double const angle = (radius + CoveringSlack) / geocells::EarthRadius;
+
+  if (angle >= M_PI) {
+    rects.emplace_back(MakeRect(-90.0, 90.0, -180.0, 180.0));
+    return rects;
+  }
+
+  double const delta = angle * 180.0 / M_PI;
+  double const latMin = latitude - delta;
+  double const latMax = latitude + delta;
+
+  if (latMin <= -90.0 || latMax >= 90.0) {
+    // the cap contains a pole, and with it all longitudes
+    rects.emplace_back(MakeRect((std::max)(latMin, -90.0),
+                                (std::min)(latMax, 90.0), -180.0, 180.0));
+    return rects;
+  }
+
+  double const ratio = std::sin(angle) / std::cos(latitude * M_PI / 180.0);
+  if (ratio >= 1.0) {
+    rects.emplace_back(MakeRect(latMin, latMax, -180.0, 180.0));
+    return rects;
+  }
+
+  double const deltaLon = std::asin(ratio) * 180.0 / M_PI;
+  double const lonMin = longitude - deltaLon;
+  double const lonMax = longitude + deltaLon;
+
+  if (lonMin < -180.0) {
+    rects.emplace_back(MakeRect(latMin, latMax, lonMin + 360.0, 180.0));
+    rects.emplace_back(MakeRect(latMin, latMax, -180.0, lonMax));
+  } else if (lonMax > 180.0) {
+    rects.emplace_back(MakeRect(latMin, latMax, lonMin, 180.0));
+    rects.emplace_back(MakeRect(latMin, latMax, -180.0, lonMax - 360.0));
+  } else {
+    rects.emplace_back(MakeRect(latMin, latMax, lonMin, lonMax));
+  }
+  return rects;
+}
+
+/// @brief number of cells of a level needed to cover the rectangles
+static uint64_t CountCells(std::vector<GridRect> const& rects, int level) {
+  int const shift = geocells::MaxLevel - level;
+  uint64_t count = 0;
+  for (auto const& r : rects) {
+    count += static_cast<uint64_t>((r.xMax >> shift) - (r.xMin >> shift) + 1) *
+             static_cast<uint64_t>((r.yMax >> shift) - (r.yMin >> shift) + 1);
+  }
+  return count;
+}
+
+uint64_t geocells::cellId(double latitude, double longitude) {
+  return HilbertIndex(GridPosition(longitude, -180.0, 180.0),
+                      GridPosition(latitude, -90.0, 90.0));
+}
+
+std::vector<geocells::CellRange> geocells::coverCap(double latitude,
+                                                    double longitude,
+                                                    double radius,
+                                                    size_t maxCells) {
+  std::vector<GridRect> rects = CapBounds(latitude, longitude, radius);
+
+  // use the deepest level that needs no more than maxCells cells
+  int level = 0;
+  while (level < MaxLevel && CountCells(rects, level + 1) <= maxCells) {
+    ++level;
+  }
+
+  int const shift = MaxLevel - level;
+  uint64_t const span = uint64_t(1) << (2 * shift);
+
+  std::vector<CellRange> ranges;
+  for (auto const& r : rects) {
+    for (uint32_t x = r.xMin >> shift; x <= (r.xMax >> shift); ++x) {
+      for (uint32_t y = r.yMin >> shift; y <= (r.yMax >> shift); ++y) {
+        uint64_t first = HilbertIndex(x << shift, y << shift) & ~(span - 1);
+        ranges.emplace_back(first, first + span - 1);
+      }
+    }
+  }
+
+  mergeRanges(ranges);
+  return ranges;
+}
+
+void geocells::mergeRanges(std::vector<CellRange>& ranges) {
+  if (ranges.empty()) {
+    return;
+  }
+
+  std::sort(ranges.begin(), ranges.end());
+
+  size_t last = 0;
+  for (size_t i = 1; i < ranges.size(); ++i) {
+    if (ranges[i].first <= ranges[last].second + 1) {
+      ranges[last].second = (std::max)(ranges[last].second, ranges[i].second);
+    } else {
+      ranges[++last] = ranges[i];
+    }
+  }
+  ranges.resize(last + 1);
+}
+
+std::vector<geocells::CellRange> geocells::subtractRanges(
+    std::vector<CellRange> const& ranges,
+    std::vector<CellRange> const& exclude) {
+  std::vector<CellRange> result;
+  size_t j = 0;
+
+  for (auto const& r : ranges) {
+    uint64_t current = r.first;
+
+    // skip all excluded ranges that end before this range
+    while (j < exclude.size() && exclude[j].second < current) {
+      ++j;
+    }
+
+    size_t k = j;
+    while (k < exclude.size() && exclude[k].first <= r.second) {
+      if (exclude[k].first > current) {
+        result.emplace_back(current, exclude[k].first - 1);
+      }
+      current = exclude[k].second + 1;
+      if (exclude[k].second >= r.second) {
+        break;
+      }
+      ++k;
+    }
+
+    if (current <= r.second) {
+      result.emplace_back(current, r.second);
+    }
+  }
+
+  return result;
+}
@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_ROCKSDB_GEO_CELLS_H
+#define ARANGOD_ROCKSDB_GEO_CELLS_H 1
+
+#include "Basics/Common.h"
+
+#include <cmath>
+
+namespace arangodb {
+namespace rocksdbengine {
+namespace geocells {
+
+/// @brief the earth is divided into a grid of cells, which are numbered
+/// along a Hilbert curve. a cell of level k consists of four cells of level
+/// k + 1 with consecutive ids. cells of the deepest level are about 4 cm
+/// wide at the equator
+static constexpr int MaxLevel = 30;
+
+/// @brief mean earth radius in meters
+static constexpr double EarthRadius = 6371000.0;
+
+/// @brief maximum distance between two points on earth in meters
+static constexpr double MaxDistance = M_PI * EarthRadius;
+
+/// @brief an inclusive range of cell ids of the deepest level
+typedef std::pair<uint64_t, uint64_t> CellRange;
+
+/// @brief returns the id of the deepest level cell containing the point
+uint64_t cellId(double latitude, double longitude);
+
+/// @brief returns sorted and disjoint ranges of cell ids that contain all
+/// points within radius meters of the given point. the ranges are made up
+/// of at most maxCells cells of the same level, so the covering is coarse
+/// for small values of maxCells
+std::vector<CellRange> coverCap(double latitude, double longitude,
+                                double radius, size_t maxCells);
+
+/// @brief sorts the ranges and merges overlapping and adjacent ones
+void mergeRanges(std::vector<CellRange>& ranges);
+
+/// @brief returns the parts of ranges that are not contained in exclude.
+/// both inputs must be sorted and disjoint
+std::vector<CellRange> subtractRanges(std::vector<CellRange> const& ranges,
+                                      std::vector<CellRange> const& exclude);
+
+}  // namespace geocells
+}  // namespace rocksdbengine
+}  // namespace arangodb
+
+#endif
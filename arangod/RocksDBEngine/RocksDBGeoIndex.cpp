@@ -31,10 +31,12 @@
 #include "Indexes/IndexResult.h"
 #include "Logger/Logger.h"
 #include "RocksDBEngine/RocksDBCommon.h"
+#include "RocksDBEngine/RocksDBKey.h"
 #include "RocksDBEngine/RocksDBMethods.h"
 #include "RocksDBEngine/RocksDBToken.h"
 
 #include <rocksdb/db.h>
+#include <rocksdb/iterator.h>
 
 using namespace arangodb;
 using namespace arangodb::rocksdbengine;
@@ -57,32 +59,39 @@ RocksDBGeoIndexIterator::RocksDBGeoIndexIterator(
   evaluateCondition();
 }
 
-void RocksDBGeoIndexIterator::evaluateCondition() {
-  if (_condition) {
-    auto numMembers = _condition->numMembers();
+/// @brief extracts the parameters of a NEAR or WITHIN condition
+static void EvaluateCondition(arangodb::aql::AstNode const* condition,
+                              double& lat, double& lon, bool& near,
+                              double& radius, bool& inclusive) {
+  auto numMembers = condition->numMembers();
 
-    TRI_ASSERT(numMembers == 1);  // should only be an FCALL
-    auto fcall = _condition->getMember(0);
-    TRI_ASSERT(fcall->type == arangodb::aql::NODE_TYPE_FCALL);
-    TRI_ASSERT(fcall->numMembers() == 1);
-    auto args = fcall->getMember(0);
+  TRI_ASSERT(numMembers == 1);  // should only be an FCALL
+  auto fcall = condition->getMember(0);
+  TRI_ASSERT(fcall->type == arangodb::aql::NODE_TYPE_FCALL);
+  TRI_ASSERT(fcall->numMembers() == 1);
+  auto args = fcall->getMember(0);
 
-    numMembers = args->numMembers();
-    TRI_ASSERT(numMembers >= 3);
+  numMembers = args->numMembers();
+  TRI_ASSERT(numMembers >= 3);
 
-    _lat = args->getMember(1)->getDoubleValue();
-    _lon = args->getMember(2)->getDoubleValue();
+  lat = args->getMember(1)->getDoubleValue();
+  lon = args->getMember(2)->getDoubleValue();
 
-    if (numMembers == 3) {
-      // NEAR
-      _near = true;
-    } else {
-      // WITHIN
-      TRI_ASSERT(numMembers == 5);
-      _near = false;
-      _radius = args->getMember(3)->getDoubleValue();
-      _inclusive = args->getMember(4)->getBoolValue();
-    }
+  if (numMembers == 3) {
+    // NEAR
+    near = true;
+  } else {
+    // WITHIN
+    TRI_ASSERT(numMembers == 5);
+    near = false;
+    radius = args->getMember(3)->getDoubleValue();
+    inclusive = args->getMember(4)->getBoolValue();
+  }
+}
+
+void RocksDBGeoIndexIterator::evaluateCondition() {
+  if (_condition) {
+    EvaluateCondition(_condition, _lat, _lon, _near, _radius, _inclusive);
   } else {
     LOG_TOPIC(ERR, arangodb::Logger::FIXME)
         << "No condition passed to RocksDBGeoIndexIterator constructor";
@@ -222,6 +231,137 @@ void RocksDBGeoIndexIterator::createCursor(double lat, double lon) {
   replaceCursor(::GeoIndex_NewCursor(_index->_geoIndex, &_coor));
 }
 
+void RocksDBGeoIndexIterator::reset() { replaceCursor(nullptr); }
+
+/// @brief initial search radius of RocksDBGeoCellIterator in meters
+static constexpr double InitialSearchRadius = 500.0;
+
+/// @brief factor by which RocksDBGeoCellIterator widens its search radius
+static constexpr double SearchRadiusGrowth = 4.0;
+
+/// @brief maximum number of cells used to cover a search radius
+static constexpr size_t MaxCoveringCells = 16;
+
+RocksDBGeoCellIterator::RocksDBGeoCellIterator(
+    LogicalCollection* collection, transaction::Methods* trx,
+    ManagedDocumentResult* mmdr, RocksDBGeoIndex const* index,
+    double latitude, double longitude, double maxDistance, bool inclusive)
+    : IndexIterator(collection, trx, mmdr, index),
+      _index(index),
+      _iterator(),
+      _center(),
+      _maxDistance((std::min)(maxDistance, geocells::MaxDistance)),
+      _inclusive(inclusive || maxDistance >= geocells::MaxDistance),
+      _radius(0.0) {
+  _center.latitude = latitude;
+  _center.longitude = longitude;
+  _center.data = 0;
+
+  auto* mthds = RocksDBTransactionState::toMethods(trx);
+  // intentional copy of the read options
+  rocksdb::ReadOptions options = mthds->readOptions();
+  TRI_ASSERT(options.snapshot != nullptr);
+  TRI_ASSERT(options.prefix_same_as_start);
+  _iterator = mthds->NewIterator(options, RocksDBColumnFamily::geo());
+}
+
+RocksDBGeoCellIterator::~RocksDBGeoCellIterator() {}
+
+bool RocksDBGeoCellIterator::next(TokenCallback const& cb, size_t limit) {
+  TRI_ASSERT(limit > 0);
+
+  GeoCoordinate coordinate;
+  double distance;
+
+  while (limit > 0) {
+    if (!nextCoordinate(coordinate, distance)) {
+      return false;
+    }
+    cb(RocksDBToken(coordinate.data));
+    --limit;
+  }
+  return true;
+}
+
+void RocksDBGeoCellIterator::reset() {
+  _radius = 0.0;
+  _scanned.clear();
+  _candidates = decltype(_candidates)();
+}
+
+bool RocksDBGeoCellIterator::nextCoordinate(GeoCoordinate& coordinate,
+                                            double& distance) {
+  while (true) {
+    if (!_candidates.empty() && (_candidates.top().distance <= _radius ||
+                                 _radius >= _maxDistance)) {
+      // no unscanned point can be closer than this one
+      Candidate const& top = _candidates.top();
+      coordinate = top.coordinate;
+      distance = top.distance;
+      _candidates.pop();
+      return true;
+    }
+
+    if (_radius >= _maxDistance) {
+      return false;
+    }
+
+    expand();
+  }
+}
+
+void RocksDBGeoCellIterator::expand() {
+  if (_radius == 0.0) {
+    _radius = (std::min)(InitialSearchRadius, _maxDistance);
+  } else {
+    _radius = (std::min)(_radius * SearchRadiusGrowth, _maxDistance);
+  }
+
+  std::vector<geocells::CellRange> ranges = geocells::subtractRanges(
+      geocells::coverCap(_center.latitude, _center.longitude, _radius,
+                         MaxCoveringCells),
+      _scanned);
+
+  for (auto const& range : ranges) {
+    scanRange(range);
+  }
+
+  _scanned.insert(_scanned.end(), ranges.begin(), ranges.end());
+  geocells::mergeRanges(_scanned);
+}
+
+void RocksDBGeoCellIterator::scanRange(geocells::CellRange const& range) {
+  TRI_ASSERT(_trx->state()->isRunning());
+
+  RocksDBKey const lower =
+      RocksDBKey::GeoCellIndexValue(_index->objectId(), range.first, 0);
+  RocksDBKey const upper = RocksDBKey::GeoCellIndexValue(
+      _index->objectId(), range.second, UINT64_MAX);
+  rocksdb::Slice const end(upper.string());
+  rocksdb::Comparator const* cmp = _index->comparator();
+
+  for (_iterator->Seek(rocksdb::Slice(lower.string()));
+       _iterator->Valid() && cmp->Compare(_iterator->key(), end) <= 0;
+       _iterator->Next()) {
+    rocksdb::Slice value = _iterator->value();
+    TRI_ASSERT(value.size() == 2 * sizeof(uint64_t));
+
+    Candidate candidate;
+    candidate.coordinate.latitude =
+        rocksutils::intToDouble(rocksutils::uint64FromPersistent(value.data()));
+    candidate.coordinate.longitude = rocksutils::intToDouble(
+        rocksutils::uint64FromPersistent(value.data() + sizeof(uint64_t)));
+    candidate.coordinate.data = RocksDBKey::revisionId(
+        RocksDBEntryType::GeoCellIndexValue, _iterator->key());
+    candidate.distance = GeoIndex_distance(&_center, &candidate.coordinate);
+
+    if (candidate.distance < _maxDistance ||
+        (_inclusive && candidate.distance == _maxDistance)) {
+      _candidates.push(candidate);
+    }
+  }
+}
+
 /// @brief creates an IndexIterator for the given Condition
 IndexIterator* RocksDBGeoIndex::iteratorForCondition(
     transaction::Methods* trx, ManagedDocumentResult* mmdr,
@@ -230,18 +370,32 @@ IndexIterator* RocksDBGeoIndex::iteratorForCondition(
   TRI_IF_FAILURE("GeoIndex::noIterator") {
     THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
   }
+
+  if (_cells) {
+    TRI_ASSERT(node != nullptr);
+    double lat = 0.0;
+    double lon = 0.0;
+    bool near = true;
+    double radius = geocells::MaxDistance;
+    bool inclusive = true;
+    EvaluateCondition(node, lat, lon, near, radius, inclusive);
+
+    return new RocksDBGeoCellIterator(_collection, trx, mmdr, this, lat, lon,
+                                      radius, inclusive);
+  }
+
   return new RocksDBGeoIndexIterator(_collection, trx, mmdr, this, node,
                                      reference);
 }
 
-void RocksDBGeoIndexIterator::reset() { replaceCursor(nullptr); }
-
 RocksDBGeoIndex::RocksDBGeoIndex(TRI_idx_iid_t iid,
                                  arangodb::LogicalCollection* collection,
                                  VPackSlice const& info)
     : RocksDBIndex(iid, collection, info, RocksDBColumnFamily::geo(), false),
       _variant(INDEX_GEO_INDIVIDUAL_LAT_LON),
       _geoJson(false),
+      _cells(arangodb::basics::VelocyPackHelper::getBooleanValue(
+          info, "cells", false)),
       _geoIndex(nullptr) {
   TRI_ASSERT(iid != 0);
   _unique = false;
@@ -275,6 +429,11 @@ RocksDBGeoIndex::RocksDBGeoIndex(TRI_idx_iid_t iid,
         "RocksDBGeoIndex can only be created with one or two fields.");
   }
 
+  if (_cells) {
+    // cell based indexes do not use the pot tree
+    return;
+  }
+
   // cheap trick to get the last inserted pot and slot number
   rocksdb::TransactionDB* db = rocksutils::globalRocksDB();
   rocksdb::ReadOptions opts;
@@ -327,6 +486,9 @@ void RocksDBGeoIndex::toVelocyPack(VPackBuilder& builder, bool withFigures,
       _variant == INDEX_GEO_COMBINED_LON_LAT) {
     builder.add("geoJson", VPackValue(_geoJson));
   }
+  if (_cells) {
+    builder.add("cells", VPackValue(true));
+  }
 
   // geo indexes are always non-unique
   // geo indexes are always sparse.
@@ -385,6 +547,10 @@ bool RocksDBGeoIndex::matchesDefinition(VPackSlice const& info) const {
       return false;
     }
   }
+  if (_cells != arangodb::basics::VelocyPackHelper::getBooleanValue(
+                    info, "cells", false)) {
+    return false;
+  }
 
   // This check takes ordering of attributes into account.
   std::vector<arangodb::basics::AttributeName> translate;
@@ -405,57 +571,93 @@ bool RocksDBGeoIndex::matchesDefinition(VPackSlice const& info) const {
   return true;
 }
 
-/// internal insert function, set batch or trx before calling
-Result RocksDBGeoIndex::insertInternal(transaction::Methods* trx,
-                                       RocksDBMethods* mthd,
-                                       TRI_voc_rid_t revisionId,
-                                       velocypack::Slice const& doc) {
-  // GeoIndex is always exclusively write-locked with rocksdb
-  GeoIndex_setRocksMethods(_geoIndex, mthd);
-  TRI_DEFER(GeoIndex_clearRocks(_geoIndex));
-
-  double latitude;
-  double longitude;
-
+/// @brief extracts the coordinates of a document, returns false if the
+/// document does not carry valid coordinates for the index attributes
+bool RocksDBGeoIndex::coordinates(velocypack::Slice const& doc,
+                                  double& latitude, double& longitude) const {
   if (_variant == INDEX_GEO_INDIVIDUAL_LAT_LON) {
     VPackSlice lat = doc.get(_latitude);
     if (!lat.isNumber()) {
-      // Invalid, no insert. Index is sparse
-      return IndexResult(TRI_ERROR_NO_ERROR, this);
+      return false;
     }
 
     VPackSlice lon = doc.get(_longitude);
     if (!lon.isNumber()) {
-      // Invalid, no insert. Index is sparse
-      return IndexResult(TRI_ERROR_NO_ERROR, this);
+      return false;
     }
     latitude = lat.getNumericValue<double>();
     longitude = lon.getNumericValue<double>();
+    return true;
+  }
+
+  VPackSlice loc = doc.get(_location);
+  if (!loc.isArray() || loc.length() < 2) {
+    return false;
+  }
+  VPackSlice first = loc.at(0);
+  if (!first.isNumber()) {
+    return false;
+  }
+  VPackSlice second = loc.at(1);
+  if (!second.isNumber()) {
+    return false;
+  }
+  if (_geoJson) {
+    longitude = first.getNumericValue<double>();
+    latitude = second.getNumericValue<double>();
   } else {
-    VPackSlice loc = doc.get(_location);
-    if (!loc.isArray() || loc.length() < 2) {
-      // Invalid, no insert. Index is sparse
-      return IndexResult(TRI_ERROR_NO_ERROR, this);
-    }
-    VPackSlice first = loc.at(0);
-    if (!first.isNumber()) {
-      // Invalid, no insert. Index is sparse
-      return IndexResult(TRI_ERROR_NO_ERROR, this);
-    }
-    VPackSlice second = loc.at(1);
-    if (!second.isNumber()) {
-      // Invalid, no insert. Index is sparse
+    latitude = first.getNumericValue<double>();
+    longitude = second.getNumericValue<double>();
+  }
+  return true;
+}
+
+/// @brief whether or not coordinates can be stored in a cell index
+static bool ValidCellCoordinates(double latitude, double longitude) {
+  return latitude >= -90.0 && latitude <= 90.0 && longitude >= -180.0 &&
+         longitude <= 180.0;
+}
+
+/// internal insert function, set batch or trx before calling
+Result RocksDBGeoIndex::insertInternal(transaction::Methods* trx,
+                                       RocksDBMethods* mthd,
+                                       TRI_voc_rid_t revisionId,
+                                       velocypack::Slice const& doc) {
+  double latitude;
+  double longitude;
+
+  if (!coordinates(doc, latitude, longitude)) {
+    // Invalid, no insert. Index is sparse
+    return IndexResult(TRI_ERROR_NO_ERROR, this);
+  }
+
+  if (_cells) {
+    if (!ValidCellCoordinates(latitude, longitude)) {
+      LOG_TOPIC(DEBUG, arangodb::Logger::FIXME)
+          << "illegal geo-coordinates, ignoring entry";
       return IndexResult(TRI_ERROR_NO_ERROR, this);
     }
-    if (_geoJson) {
-      longitude = first.getNumericValue<double>();
-      latitude = second.getNumericValue<double>();
-    } else {
-      latitude = first.getNumericValue<double>();
-      longitude = second.getNumericValue<double>();
+
+    RocksDBKey key = RocksDBKey::GeoCellIndexValue(
+        _objectId, geocells::cellId(latitude, longitude), revisionId);
+    char value[2 * sizeof(uint64_t)];
+    rocksutils::uint64ToPersistent(value, rocksutils::doubleToInt(latitude));
+    rocksutils::uint64ToPersistent(value + sizeof(uint64_t),
+                                   rocksutils::doubleToInt(longitude));
+
+    // the key contains the revision id, so no other transaction writes it
+    Result r = mthd->PutUntracked(RocksDBColumnFamily::geo(), key,
+                                  rocksdb::Slice(value, sizeof(value)));
+    if (!r.ok()) {
+      return IndexResult(r.errorNumber(), this);
     }
+    return IndexResult(TRI_ERROR_NO_ERROR, this);
   }
 
+  // GeoIndex is always exclusively write-locked with rocksdb
+  GeoIndex_setRocksMethods(_geoIndex, mthd);
+  TRI_DEFER(GeoIndex_clearRocks(_geoIndex));
+
   // and insert into index
   GeoCoordinate gc;
   gc.latitude = latitude;
@@ -483,60 +685,37 @@ Result RocksDBGeoIndex::removeInternal(transaction::Methods* trx,
                                        RocksDBMethods* mthd,
                                        TRI_voc_rid_t revisionId,
                                        velocypack::Slice const& doc) {
-  // GeoIndex is always exclusively write-locked with rocksdb
-  GeoIndex_setRocksMethods(_geoIndex, RocksDBTransactionState::toMethods(trx));
-  TRI_DEFER(GeoIndex_clearRocks(_geoIndex));
-
   double latitude = 0.0;
   double longitude = 0.0;
-  bool ok = true;
 
-  if (_variant == INDEX_GEO_INDIVIDUAL_LAT_LON) {
-    VPackSlice lat = doc.get(_latitude);
-    VPackSlice lon = doc.get(_longitude);
-    if (!lat.isNumber()) {
-      ok = false;
-    } else {
-      latitude = lat.getNumericValue<double>();
-    }
-    if (!lon.isNumber()) {
-      ok = false;
-    } else {
-      longitude = lon.getNumericValue<double>();
+  if (!coordinates(doc, latitude, longitude)) {
+    return IndexResult(TRI_ERROR_NO_ERROR, this);
+  }
+
+  if (_cells) {
+    if (!ValidCellCoordinates(latitude, longitude)) {
+      return IndexResult(TRI_ERROR_NO_ERROR, this);
     }
-  } else {
-    VPackSlice loc = doc.get(_location);
-    if (!loc.isArray() || loc.length() < 2) {
-      ok = false;
-    } else {
-      VPackSlice first = loc.at(0);
-      if (!first.isNumber()) {
-        ok = false;
-      }
-      VPackSlice second = loc.at(1);
-      if (!second.isNumber()) {
-        ok = false;
-      }
-      if (ok) {
-        if (_geoJson) {
-          longitude = first.getNumericValue<double>();
-          latitude = second.getNumericValue<double>();
-        } else {
-          latitude = first.getNumericValue<double>();
-          longitude = second.getNumericValue<double>();
-        }
-      }
+
+    RocksDBKey key = RocksDBKey::GeoCellIndexValue(
+        _objectId, geocells::cellId(latitude, longitude), revisionId);
+    Result r = mthd->DeleteUntracked(RocksDBColumnFamily::geo(), key);
+    if (!r.ok()) {
+      return IndexResult(r.errorNumber(), this);
     }
+    return IndexResult(TRI_ERROR_NO_ERROR, this);
   }
 
-  if (ok) {
-    GeoCoordinate gc;
-    gc.latitude = latitude;
-    gc.longitude = longitude;
-    gc.data = static_cast<uint64_t>(revisionId);
-    // ignore non-existing elements in geo-index
-    GeoIndex_remove(_geoIndex, &gc);
-  }
+  // GeoIndex is always exclusively write-locked with rocksdb
+  GeoIndex_setRocksMethods(_geoIndex, RocksDBTransactionState::toMethods(trx));
+  TRI_DEFER(GeoIndex_clearRocks(_geoIndex));
+
+  GeoCoordinate gc;
+  gc.latitude = latitude;
+  gc.longitude = longitude;
+  gc.data = static_cast<uint64_t>(revisionId);
+  // ignore non-existing elements in geo-index
+  GeoIndex_remove(_geoIndex, &gc);
 
   return IndexResult(TRI_ERROR_NO_ERROR, this);
 }
@@ -564,6 +743,12 @@ int RocksDBGeoIndex::unload() {
 GeoCoordinates* RocksDBGeoIndex::withinQuery(transaction::Methods* trx,
                                              double lat, double lon,
                                              double radius) const {
+  if (_cells) {
+    RocksDBGeoCellIterator it(_collection, trx, nullptr, this, lat, lon,
+                              radius, true);
+    return cellQuery(it, SIZE_MAX);
+  }
+
   GeoCoordinate gc;
   gc.latitude = lat;
   gc.longitude = lon;
@@ -578,6 +763,12 @@ GeoCoordinates* RocksDBGeoIndex::withinQuery(transaction::Methods* trx,
 GeoCoordinates* RocksDBGeoIndex::nearQuery(transaction::Methods* trx,
                                            double lat, double lon,
                                            size_t count) const {
+  if (_cells) {
+    RocksDBGeoCellIterator it(_collection, trx, nullptr, this, lat, lon,
+                              geocells::MaxDistance, true);
+    return cellQuery(it, count);
+  }
+
   GeoCoordinate gc;
   gc.latitude = lat;
   gc.longitude = lon;
@@ -588,3 +779,43 @@ GeoCoordinates* RocksDBGeoIndex::nearQuery(transaction::Methods* trx,
   GeoIndex_clearRocks(_geoIndex);
   return coords;
 }
+
+/// @brief collects up to limit points from a cell iterator, ordered by
+/// distance. the result can be freed with GeoIndex_CoordinatesFree
+GeoCoordinates* RocksDBGeoIndex::cellQuery(RocksDBGeoCellIterator& it,
+                                           size_t limit) const {
+  std::vector<GeoCoordinate> coordinates;
+  std::vector<double> distances;
+
+  GeoCoordinate coordinate;
+  double distance;
+  while (coordinates.size() < limit && it.nextCoordinate(coordinate, distance)) {
+    coordinates.emplace_back(coordinate);
+    distances.emplace_back(distance);
+  }
+
+  if (coordinates.empty()) {
+    return nullptr;
+  }
+
+  auto result = static_cast<GeoCoordinates*>(
+      TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(GeoCoordinates), false));
+  if (result == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+  result->length = coordinates.size();
+  result->coordinates = static_cast<GeoCoordinate*>(
+      TRI_Allocate(TRI_UNKNOWN_MEM_ZONE,
+                   coordinates.size() * sizeof(GeoCoordinate), false));
+  result->distances = static_cast<double*>(TRI_Allocate(
+      TRI_UNKNOWN_MEM_ZONE, distances.size() * sizeof(double), false));
+  if (result->coordinates == nullptr || result->distances == nullptr) {
+    GeoIndex_CoordinatesFree(result);
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+  memcpy(result->coordinates, coordinates.data(),
+         coordinates.size() * sizeof(GeoCoordinate));
+  memcpy(result->distances, distances.data(),
+         distances.size() * sizeof(double));
+  return result;
+}
@@ -26,6 +26,7 @@
 
 #include "Basics/Common.h"
 #include "Indexes/IndexIterator.h"
+#include "RocksDBEngine/RocksDBGeoCells.h"
 #include "RocksDBEngine/RocksDBGeoIndexImpl.h"
 #include "RocksDBEngine/RocksDBIndex.h"
 #include "VocBase/voc-types.h"
@@ -33,8 +34,13 @@
 
 #include <velocypack/Builder.h>
 #include <velocypack/velocypack-aliases.h>
+#include <queue>
 #include <type_traits>
 
+namespace rocksdb {
+class Iterator;
+}
+
 namespace arangodb {
 
 // GeoCoordinate.data must be capable of storing revision ids
@@ -79,7 +85,68 @@ class RocksDBGeoIndexIterator final : public IndexIterator {
   double _radius;
 };
 
+/// @brief iterator for geo indexes that store their points under cell ids.
+/// the search radius starts small and is widened step by step. each step
+/// scans only the cell ranges not yet scanned, and returns the points that
+/// are known to be the closest ones, so results are produced in distance
+/// order
+class RocksDBGeoCellIterator final : public IndexIterator {
+ public:
+  RocksDBGeoCellIterator(LogicalCollection* collection,
+                         transaction::Methods* trx,
+                         ManagedDocumentResult* mmdr,
+                         RocksDBGeoIndex const* index, double latitude,
+                         double longitude, double maxDistance, bool inclusive);
+
+  ~RocksDBGeoCellIterator();
+
+  char const* typeName() const override { return "geo-cell-index-iterator"; }
+
+  bool next(TokenCallback const& cb, size_t limit) override;
+
+  void reset() override;
+
+  /// @brief produces the next closest point and its distance in meters.
+  /// returns false if there are no more points
+  bool nextCoordinate(arangodb::rocksdbengine::GeoCoordinate& coordinate,
+                      double& distance);
+
+ private:
+  struct Candidate {
+    double distance;
+    arangodb::rocksdbengine::GeoCoordinate coordinate;
+  };
+
+  struct CandidateGreater {
+    bool operator()(Candidate const& lhs, Candidate const& rhs) const {
+      return lhs.distance > rhs.distance;
+    }
+  };
+
+  /// @brief widens the search radius and scans the new cell ranges
+  void expand();
+
+  /// @brief adds all points of a cell range to the candidates
+  void scanRange(arangodb::rocksdbengine::geocells::CellRange const& range);
+
+  RocksDBGeoIndex const* _index;
+  std::unique_ptr<rocksdb::Iterator> _iterator;
+  arangodb::rocksdbengine::GeoCoordinate _center;
+  /// @brief no points farther away than this are returned
+  double const _maxDistance;
+  /// @brief whether points at exactly _maxDistance are returned
+  bool const _inclusive;
+  /// @brief all points within this distance have been scanned
+  double _radius;
+  /// @brief cell ranges scanned so far, sorted and disjoint
+  std::vector<arangodb::rocksdbengine::geocells::CellRange> _scanned;
+  /// @brief scanned points that have not been returned yet
+  std::priority_queue<Candidate, std::vector<Candidate>, CandidateGreater>
+      _candidates;
+};
+
 class RocksDBGeoIndex final : public RocksDBIndex {
+  friend class RocksDBGeoCellIterator;
   friend class RocksDBGeoIndexIterator;
 
  public:
@@ -148,6 +215,10 @@ class RocksDBGeoIndex final : public RocksDBIndex {
                                                      double, double,
                                                      size_t) const;
 
+  /// @brief whether the index stores its points under cell ids instead of
+  /// the pot tree of the original geo index
+  bool usesCells() const { return _cells; }
+
   bool isSame(std::vector<std::string> const& location, bool geoJson) const {
     return (!_location.empty() && _location == location && _geoJson == geoJson);
   }
@@ -168,6 +239,15 @@ class RocksDBGeoIndex final : public RocksDBIndex {
                         arangodb::velocypack::Slice const&) override;
 
  private:
+  /// @brief extracts the coordinates of a document. returns false if the
+  /// document has no valid coordinates
+  bool coordinates(velocypack::Slice const& doc, double& latitude,
+                   double& longitude) const;
+
+  /// @brief collects up to limit points of a cell iterator
+  arangodb::rocksdbengine::GeoCoordinates* cellQuery(
+      RocksDBGeoCellIterator& iterator, size_t limit) const;
+
   /// internal insert function, set batch or trx before calling
   int internalInsert(TRI_voc_rid_t, velocypack::Slice const&);
   /// internal remove function, set batch or trx before calling
@@ -185,7 +265,10 @@ class RocksDBGeoIndex final : public RocksDBIndex {
   /// reversed)
   bool _geoJson;
 
-  /// @brief the actual geo index
+  /// @brief whether the points are stored under cell ids
+  bool _cells;
+
+  /// @brief the actual geo index, only used if _cells is false
   arangodb::rocksdbengine::GeoIdx* _geoIndex;
 };
 }  // namespace arangodb
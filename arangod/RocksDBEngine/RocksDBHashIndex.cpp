@@ -92,6 +92,6 @@ bool RocksDBHashIndex::matchesDefinition(VPackSlice const& info) const {
       return false;
     }
   }
-  return true;
+  return partialFilterMatchesDefinition(info);
 }
 
@@ -157,7 +157,9 @@ void RocksDBIndex::createCache() {
   TRI_ASSERT(_cache.get() == nullptr);
   TRI_ASSERT(CacheManagerFeature::MANAGER != nullptr);
   _cache = CacheManagerFeature::MANAGER->createCache(
-      cache::CacheType::Transactional);
+      cache::CacheType::Transactional, false, UINT64_MAX,
+      _collection->dbName() + "/" + _collection->name() + "/" +
+          std::to_string(_iid));
   _cachePresent = (_cache.get() != nullptr);
   TRI_ASSERT(_useCache);
 }
@@ -262,6 +264,15 @@ void RocksDBIndex::truncate(transaction::Methods* trx) {
   }
 }
 
+void RocksDBIndex::afterTruncate() {
+  // the cached entries cannot be blacklisted one by one, so the whole cache
+  // is dropped and recreated
+  if (_cachePresent) {
+    disableCache();
+    createCache();
+  }
+}
+
 /// @brief return the memory usage of the index
 size_t RocksDBIndex::memory() const {
   rocksdb::TransactionDB* db = rocksutils::globalRocksDB();
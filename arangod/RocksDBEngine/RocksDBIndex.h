@@ -81,6 +81,10 @@ class RocksDBIndex : public Index {
 
   virtual void truncate(transaction::Methods*);
 
+  /// @brief called after all entries of the index were removed by a range
+  /// deletion outside of the transaction. resets the estimates and caches
+  virtual void afterTruncate();
+
   size_t memory() const override;
 
   int cleanup() override;
@@ -106,6 +110,17 @@ class RocksDBIndex : public Index {
   void createCache();
   void disableCache();
 
+  /// @brief the cache of the index, nullptr if the index has none
+  cache::Cache* cache() const { return useCache() ? _cache.get() : nullptr; }
+
+  /// @brief look up the given keys of the index cache, as returned by
+  /// cache::Cache::hotKeys, and insert the results into the cache.
+  /// returns the number of keys looked up
+  virtual size_t prefetchCacheKeys(transaction::Methods*,
+                                   std::vector<std::string> const& keys) {
+    return 0;
+  }
+
   virtual void serializeEstimate(std::string& output) const;
 
   virtual bool deserializeEstimate(RocksDBCounterManager* mgr);
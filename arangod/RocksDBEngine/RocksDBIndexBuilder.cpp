@@ -0,0 +1,376 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RocksDBIndexBuilder.h"
+#include "Basics/Exceptions.h"
+#include "Logger/Logger.h"
+#include "RocksDBEngine/RocksDBCollection.h"
+#include "RocksDBEngine/RocksDBCommon.h"
+#include "RocksDBEngine/RocksDBEngine.h"
+#include "RocksDBEngine/RocksDBIndex.h"
+#include "RocksDBEngine/RocksDBKey.h"
+#include "RocksDBEngine/RocksDBKeyBounds.h"
+#include "RocksDBEngine/RocksDBMethods.h"
+#include "RocksDBEngine/RocksDBParallelScan.h"
+#include "RocksDBEngine/RocksDBTransactionState.h"
+#include "StorageEngine/EngineSelectorFeature.h"
+#include "Transaction/StandaloneContext.h"
+#include "Utils/SingleCollectionTransaction.h"
+#include "VocBase/LogicalCollection.h"
+
+#include <rocksdb/db.h>
+#include <rocksdb/transaction_log.h>
+#include <rocksdb/utilities/transaction_db.h>
+#include <rocksdb/utilities/write_batch_with_index.h>
+#include <rocksdb/write_batch.h>
+
+#include <velocypack/Slice.h>
+#include <velocypack/velocypack-aliases.h>
+
+#include <thread>
+
+using namespace arangodb;
+
+namespace {
+
+/// @brief number of index insertions after which a write batch is written
+constexpr size_t BatchSize = 5000;
+
+/// @brief a document operation read from the WAL
+struct DocumentOperation {
+  DocumentOperation(TRI_voc_rid_t rid, bool insert, rocksdb::Slice document)
+      : revisionId(rid), isInsert(insert), document(document.ToString()) {}
+
+  TRI_voc_rid_t revisionId;
+  bool isInsert;
+  std::string document;
+};
+
+/// @brief collects the document operations of one collection from a WAL
+/// write batch
+class DocumentOperationCollector final : public rocksdb::WriteBatch::Handler {
+ public:
+  DocumentOperationCollector(uint32_t columnFamilyId, uint64_t objectId,
+                             std::vector<DocumentOperation>& operations)
+      : _columnFamilyId(columnFamilyId),
+        _objectId(objectId),
+        _operations(operations) {}
+
+  rocksdb::Status PutCF(uint32_t cf, rocksdb::Slice const& key,
+                        rocksdb::Slice const& value) override {
+    if (isOwnDocument(cf, key)) {
+      _operations.emplace_back(
+          RocksDBKey::revisionId(RocksDBEntryType::Document, key), true,
+          value);
+    }
+    return rocksdb::Status();
+  }
+
+  rocksdb::Status DeleteCF(uint32_t cf, rocksdb::Slice const& key) override {
+    if (isOwnDocument(cf, key)) {
+      _operations.emplace_back(
+          RocksDBKey::revisionId(RocksDBEntryType::Document, key), false,
+          rocksdb::Slice());
+    }
+    return rocksdb::Status();
+  }
+
+  rocksdb::Status SingleDeleteCF(uint32_t cf,
+                                 rocksdb::Slice const& key) override {
+    return DeleteCF(cf, key);
+  }
+
+  rocksdb::Status DeleteRangeCF(uint32_t cf, rocksdb::Slice const& begin,
+                                rocksdb::Slice const&) override {
+    if (isOwnDocument(cf, begin)) {
+      // the removed documents are unknown, so the index cannot follow
+      return rocksdb::Status::Aborted();
+    }
+    return rocksdb::Status();
+  }
+
+  rocksdb::Status MergeCF(uint32_t, rocksdb::Slice const&,
+                          rocksdb::Slice const&) override {
+    return rocksdb::Status();
+  }
+
+ private:
+  bool isOwnDocument(uint32_t cf, rocksdb::Slice const& key) const {
+    return cf == _columnFamilyId && key.size() >= 2 * sizeof(uint64_t) &&
+           RocksDBKey::objectId(key) == _objectId;
+  }
+
+ private:
+  uint32_t const _columnFamilyId;
+  uint64_t const _objectId;
+  std::vector<DocumentOperation>& _operations;
+};
+
+/// @brief whether the entries of an index can be written from several
+/// threads. unique indexes check existing entries, and the geo index
+/// maintains shared structures, so both need a single writer
+static bool AllowsParallelFill(RocksDBIndex const* index) {
+  switch (index->type()) {
+    case Index::TRI_IDX_TYPE_HASH_INDEX:
+    case Index::TRI_IDX_TYPE_SKIPLIST_INDEX:
+    case Index::TRI_IDX_TYPE_PERSISTENT_INDEX:
+      return !index->unique();
+    case Index::TRI_IDX_TYPE_FULLTEXT_INDEX:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static Result FlushBatch(rocksdb::WriteBatchWithIndex& batch) {
+  rocksdb::WriteOptions options;
+  rocksdb::Status s =
+      rocksutils::globalRocksDB()->GetBaseDB()->Write(options,
+                                                      batch.GetWriteBatch());
+  batch.Clear();
+  return rocksutils::convertStatus(s, rocksutils::StatusHint::index);
+}
+
+}  // namespace
+
+RocksDBIndexBuilder::RocksDBIndexBuilder(LogicalCollection* collection,
+                                         RocksDBIndex* index,
+                                         size_t numThreads)
+    : _collection(collection),
+      _physical(static_cast<RocksDBCollection*>(collection->getPhysical())),
+      _index(index),
+      _numThreads(numThreads),
+      _snapshot(nullptr),
+      _lastSequence(0) {}
+
+RocksDBIndexBuilder::~RocksDBIndexBuilder() {
+  if (_snapshot != nullptr) {
+    static_cast<RocksDBEngine*>(EngineSelectorFeature::ENGINE)
+        ->releaseWal(_snapshot->GetSequenceNumber());
+    rocksutils::globalRocksDB()->ReleaseSnapshot(_snapshot);
+  }
+}
+
+Result RocksDBIndexBuilder::fill() {
+  TRI_ASSERT(_snapshot == nullptr);
+  _snapshot = rocksutils::globalRocksDB()->GetSnapshot();
+  _lastSequence = _snapshot->GetSequenceNumber();
+  // the catch up needs all WAL files from the snapshot on
+  static_cast<RocksDBEngine*>(EngineSelectorFeature::ENGINE)
+      ->retainWal(_lastSequence);
+
+  // ranges of about the same size, see RocksDBParallelScan::split()
+  std::vector<std::string> const bounds = RocksDBParallelScan::split(
+      RocksDBKeyBounds::CollectionDocuments(_physical->objectId()),
+      AllowsParallelFill(_index) ? _numThreads : 1);
+  size_t const numRanges = bounds.size() - 1;
+
+  if (numRanges == 1) {
+    return fillRange(bounds[0], bounds[1]);
+  }
+
+  std::vector<Result> results(numRanges);
+  std::vector<std::thread> threads;
+  threads.reserve(numRanges);
+  for (size_t i = 0; i < numRanges; ++i) {
+    threads.emplace_back([this, i, &bounds, &results]() {
+      try {
+        results[i] = fillRange(bounds[i], bounds[i + 1]);
+      } catch (basics::Exception const& ex) {
+        results[i] = Result(ex.code(), ex.what());
+      } catch (std::exception const& ex) {
+        results[i] = Result(TRI_ERROR_INTERNAL, ex.what());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (auto const& res : results) {
+    if (res.fail()) {
+      return res;
+    }
+  }
+  return Result();
+}
+
+Result RocksDBIndexBuilder::fillRange(std::string const& lower,
+                                      std::string const& upper) {
+  SingleCollectionTransaction trx(
+      transaction::StandaloneContext::Create(_collection->vocbase()),
+      _collection->cid(), AccessMode::Type::READ);
+  Result res = trx.begin();
+  if (res.fail()) {
+    return res;
+  }
+
+  rocksdb::WriteBatchWithIndex batch(_index->columnFamily()->GetComparator(),
+                                     32 * 1024 * 1024);
+  RocksDBBatchedMethods batched(RocksDBTransactionState::toState(&trx),
+                                &batch);
+
+  rocksdb::ColumnFamilyHandle* cf = _physical->documentsColumnFamily();
+  rocksdb::Comparator const* cmp = cf->GetComparator();
+  rocksdb::ReadOptions options;
+  options.snapshot = _snapshot;
+  options.prefix_same_as_start = true;
+  options.fill_cache = false;
+  options.verify_checksums = false;
+  std::unique_ptr<rocksdb::Iterator> it(
+      rocksutils::globalRocksDB()->NewIterator(options, cf));
+
+  size_t count = 0;
+  for (it->Seek(lower); it->Valid(); it->Next()) {
+    if (cmp->Compare(it->key(), upper) >= 0) {
+      break;
+    }
+    TRI_voc_rid_t revisionId =
+        RocksDBKey::revisionId(RocksDBEntryType::Document, it->key());
+    res = _index->insertInternal(&trx, &batched, revisionId,
+                                 VPackSlice(it->value().data()));
+    if (res.fail()) {
+      break;
+    }
+    if (++count % BatchSize == 0) {
+      if (_collection->deleted()) {
+        res.reset(TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND);
+        break;
+      }
+      res = FlushBatch(batch);
+      if (res.fail()) {
+        break;
+      }
+    }
+  }
+  if (res.ok() && !it->status().ok()) {
+    res = rocksutils::convertStatus(it->status());
+  }
+  if (res.ok()) {
+    res = FlushBatch(batch);
+  }
+
+  trx.finish(res);
+  return res;
+}
+
+Result RocksDBIndexBuilder::catchUp(uint64_t& numOperations) {
+  TRI_ASSERT(_snapshot != nullptr);
+  numOperations = 0;
+
+  std::unique_ptr<rocksdb::TransactionLogIterator> iterator;
+  rocksdb::Status s =
+      static_cast<rocksdb::DB*>(rocksutils::globalRocksDB())
+          ->GetUpdatesSince(_lastSequence + 1, &iterator);
+  if (!s.ok()) {
+    return rocksutils::convertStatus(s, rocksutils::StatusHint::wal);
+  }
+
+  SingleCollectionTransaction trx(
+      transaction::StandaloneContext::Create(_collection->vocbase()),
+      _collection->cid(), AccessMode::Type::READ);
+  Result res = trx.begin();
+  if (res.fail()) {
+    return res;
+  }
+
+  rocksdb::WriteBatchWithIndex batch(_index->columnFamily()->GetComparator(),
+                                     32 * 1024 * 1024);
+  RocksDBBatchedMethods batched(RocksDBTransactionState::toState(&trx),
+                                &batch);
+  rocksdb::ColumnFamilyHandle* cf = _physical->documentsColumnFamily();
+  rocksdb::ReadOptions options;
+  options.snapshot = _snapshot;
+
+  std::vector<DocumentOperation> operations;
+  DocumentOperationCollector collector(cf->GetID(), _physical->objectId(),
+                                       operations);
+
+  for (; iterator->Valid() && res.ok(); iterator->Next()) {
+    s = iterator->status();
+    if (!s.ok()) {
+      res = rocksutils::convertStatus(s, rocksutils::StatusHint::wal);
+      break;
+    }
+    rocksdb::BatchResult wal = iterator->GetBatch();
+    if (wal.sequence <= _lastSequence) {
+      continue;
+    }
+
+    operations.clear();
+    s = wal.writeBatchPtr->Iterate(&collector);
+    if (s.IsAborted()) {
+      res.reset(TRI_ERROR_ARANGO_CONFLICT,
+                "documents were removed by range while building the index");
+      break;
+    } else if (!s.ok()) {
+      res = rocksutils::convertStatus(s);
+      break;
+    }
+
+    for (auto& op : operations) {
+      if (op.isInsert) {
+        res = _index->insertInternal(&trx, &batched, op.revisionId,
+                                     VPackSlice(op.document.data()));
+        _inserted.emplace(op.revisionId, std::move(op.document));
+      } else {
+        // a removed document either has been inserted during the build,
+        // or is part of the snapshot
+        auto found = _inserted.find(op.revisionId);
+        if (found != _inserted.end()) {
+          res = _index->removeInternal(&trx, &batched, op.revisionId,
+                                       VPackSlice(found->second.data()));
+          _inserted.erase(found);
+        } else {
+          std::string document;
+          RocksDBKey key =
+              RocksDBKey::Document(_physical->objectId(), op.revisionId);
+          s = rocksutils::globalRocksDB()->Get(options, cf, key.string(),
+                                               &document);
+          if (s.ok()) {
+            res = _index->removeInternal(&trx, &batched, op.revisionId,
+                                         VPackSlice(document.data()));
+          } else if (!s.IsNotFound()) {
+            res = rocksutils::convertStatus(s);
+          }
+        }
+      }
+      if (res.fail()) {
+        break;
+      }
+      if (++numOperations % BatchSize == 0) {
+        res = FlushBatch(batch);
+        if (res.fail()) {
+          break;
+        }
+      }
+    }
+
+    _lastSequence = wal.sequence + wal.writeBatchPtr->Count() - 1;
+  }
+
+  if (res.ok()) {
+    res = FlushBatch(batch);
+  }
+
+  trx.finish(res);
+  return res;
+}
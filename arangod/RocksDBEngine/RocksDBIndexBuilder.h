@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_ROCKSDB_ENGINE_INDEX_BUILDER_H
+#define ARANGOD_ROCKSDB_ENGINE_INDEX_BUILDER_H 1
+
+#include "Basics/Common.h"
+#include "Basics/Result.h"
+#include "VocBase/voc-types.h"
+
+#include <rocksdb/types.h>
+
+namespace rocksdb {
+class Snapshot;
+}
+
+namespace arangodb {
+
+class LogicalCollection;
+class RocksDBCollection;
+class RocksDBIndex;
+
+/// @brief fills a new index of a collection without blocking writers. the
+/// index is first filled from a snapshot of the collection, in parallel key
+/// ranges if the index type allows it. changes made to the collection after
+/// the snapshot are then applied from the WAL, until the caller blocks
+/// writers for a final catch up and publishes the index
+class RocksDBIndexBuilder {
+ public:
+  RocksDBIndexBuilder(LogicalCollection* collection, RocksDBIndex* index,
+                      size_t numThreads);
+  ~RocksDBIndexBuilder();
+
+  RocksDBIndexBuilder(RocksDBIndexBuilder const&) = delete;
+  RocksDBIndexBuilder& operator=(RocksDBIndexBuilder const&) = delete;
+
+  /// @brief fill the index with all documents in a snapshot of the collection
+  Result fill();
+
+  /// @brief apply the document operations that happened since the snapshot
+  /// or the previous catch up to the index. numOperations returns the number
+  /// of applied operations
+  Result catchUp(uint64_t& numOperations);
+
+ private:
+  Result fillRange(std::string const& lower, std::string const& upper);
+
+ private:
+  LogicalCollection* _collection;
+  RocksDBCollection* _physical;
+  RocksDBIndex* _index;
+  size_t _numThreads;
+  rocksdb::Snapshot const* _snapshot;
+  /// @brief all operations up to this sequence number are in the index
+  rocksdb::SequenceNumber _lastSequence;
+  /// @brief documents inserted since the snapshot, needed to remove their
+  /// index entries again when they are removed before the index is ready
+  std::unordered_map<TRI_voc_rid_t, std::string> _inserted;
+};
+
+}  // namespace arangodb
+
+#endif
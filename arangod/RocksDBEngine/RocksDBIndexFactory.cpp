@@ -22,11 +22,13 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "RocksDBIndexFactory.h"
+#include "Basics/AttributeNameParser.h"
 #include "Basics/StaticStrings.h"
 #include "Basics/StringUtils.h"
 #include "Basics/VelocyPackHelper.h"
 #include "Cluster/ServerState.h"
 #include "Indexes/Index.h"
+#include "RocksDBEngine/RocksDBCollection.h"
 #include "RocksDBEngine/RocksDBEdgeIndex.h"
 #include "RocksDBEngine/RocksDBEngine.h"
 #include "RocksDBEngine/RocksDBFulltextIndex.h"
@@ -130,6 +132,51 @@ static void ProcessIndexDeduplicateFlag(VPackSlice const definition,
   builder.add("deduplicate", VPackValue(dup));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief process the bloomFilter flag and add it to the json. the flag is
+/// only added when set, so definitions without it stay unchanged
+////////////////////////////////////////////////////////////////////////////////
+
+static void ProcessIndexBloomFilterFlag(VPackSlice const definition,
+                                        VPackBuilder& builder) {
+  if (basics::VelocyPackHelper::getBooleanValue(definition, "bloomFilter",
+                                                false)) {
+    builder.add("bloomFilter", VPackValue(true));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief process the partial filter and add it to the json. the filter maps
+/// attribute paths to the values a document must have to be indexed
+////////////////////////////////////////////////////////////////////////////////
+
+static int ProcessIndexPartialFilter(VPackSlice const definition,
+                                     VPackBuilder& builder) {
+  VPackSlice const filter = definition.get("partialFilter");
+
+  if (filter.isNone() || filter.isNull()) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  if (!filter.isObject() || filter.length() == 0) {
+    return TRI_ERROR_BAD_PARAMETER;
+  }
+
+  std::vector<basics::AttributeName> names;
+  for (auto const& it : VPackObjectIterator(filter)) {
+    names.clear();
+    TRI_ParseAttributeString(it.key.copyString(), names, false);
+
+    if (names.empty() || TRI_AttributeNamesHaveExpansion(names)) {
+      // array expansion is not supported in filters
+      return TRI_ERROR_BAD_PARAMETER;
+    }
+  }
+
+  builder.add("partialFilter", filter);
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief enhances the json of a hash index
 ////////////////////////////////////////////////////////////////////////////////
@@ -141,6 +188,8 @@ static int EnhanceJsonIndexHash(VPackSlice const definition,
     ProcessIndexSparseFlag(definition, builder, create);
     ProcessIndexUniqueFlag(definition, builder);
     ProcessIndexDeduplicateFlag(definition, builder);
+    ProcessIndexBloomFilterFlag(definition, builder);
+    res = ProcessIndexPartialFilter(definition, builder);
   }
   return res;
 }
@@ -156,6 +205,7 @@ static int EnhanceJsonIndexSkiplist(VPackSlice const definition,
     ProcessIndexSparseFlag(definition, builder, create);
     ProcessIndexUniqueFlag(definition, builder);
     ProcessIndexDeduplicateFlag(definition, builder);
+    res = ProcessIndexPartialFilter(definition, builder);
   }
   return res;
 }
@@ -171,6 +221,7 @@ static int EnhanceJsonIndexPersistent(VPackSlice const definition,
     ProcessIndexSparseFlag(definition, builder, create);
     ProcessIndexUniqueFlag(definition, builder);
     ProcessIndexDeduplicateFlag(definition, builder);
+    res = ProcessIndexPartialFilter(definition, builder);
   }
   return res;
 }
@@ -191,6 +242,19 @@ static void ProcessIndexGeoJsonFlag(VPackSlice const definition,
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief process the cells flag and add it to the json
+////////////////////////////////////////////////////////////////////////////////
+
+static void ProcessIndexGeoCellsFlag(VPackSlice const definition,
+                                     VPackBuilder& builder) {
+  // only add the flag if set, so that pot based index definitions stay as
+  // they were
+  if (basics::VelocyPackHelper::getBooleanValue(definition, "cells", false)) {
+    builder.add("cells", VPackValue(true));
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief enhances the json of a geo1 index
 ////////////////////////////////////////////////////////////////////////////////
@@ -206,6 +270,7 @@ static int EnhanceJsonIndexGeo1(VPackSlice const definition,
     builder.add("sparse", VPackValue(true));
     builder.add("unique", VPackValue(false));
     ProcessIndexGeoJsonFlag(definition, builder);
+    ProcessIndexGeoCellsFlag(definition, builder);
   }
   return res;
 }
@@ -225,6 +290,7 @@ static int EnhanceJsonIndexGeo2(VPackSlice const definition,
     builder.add("sparse", VPackValue(true));
     builder.add("unique", VPackValue(false));
     ProcessIndexGeoJsonFlag(definition, builder);
+    ProcessIndexGeoCellsFlag(definition, builder);
   }
   return res;
 }
@@ -311,6 +377,14 @@ int RocksDBIndexFactory::enhanceIndexDefinition(VPackSlice const definition,
 
   enhanced.add("type", VPackValue(Index::oldtypeName(type)));
 
+  if (create) {
+    // only relevant while creating the index, not stored with it
+    current = definition.get("inBackground");
+    if (current.isBoolean()) {
+      enhanced.add("inBackground", current);
+    }
+  }
+
   int res = TRI_ERROR_INTERNAL;
 
   switch (type) {
@@ -467,10 +541,24 @@ void RocksDBIndexFactory::fillSystemIndexes(
       std::make_shared<arangodb::RocksDBPrimaryIndex>(col, builder.slice()));
   // create edges indexes
   if (col->type() == TRI_COL_TYPE_EDGE) {
+    // the edge indexes store the configured edge attributes inline
+    VPackBuilder edgeBuilder;
+    edgeBuilder.openObject();
+    auto const& storedValues = toRocksDBCollection(col)->edgeStoredValues();
+    if (!storedValues.empty()) {
+      edgeBuilder.add(VPackValue("storedValues"));
+      edgeBuilder.openArray();
+      for (auto const& it : storedValues) {
+        edgeBuilder.add(VPackValue(it));
+      }
+      edgeBuilder.close();
+    }
+    edgeBuilder.close();
+
     systemIndexes.emplace_back(std::make_shared<arangodb::RocksDBEdgeIndex>(
-        1, col, builder.slice(), StaticStrings::FromString));
+        1, col, edgeBuilder.slice(), StaticStrings::FromString));
     systemIndexes.emplace_back(std::make_shared<arangodb::RocksDBEdgeIndex>(
-        2, col, builder.slice(), StaticStrings::ToString));
+        2, col, edgeBuilder.slice(), StaticStrings::ToString));
   }
 }
 
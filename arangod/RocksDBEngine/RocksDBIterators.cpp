@@ -25,15 +25,27 @@
 #include "Random/RandomGenerator.h"
 #include "RocksDBEngine/RocksDBCollection.h"
 #include "RocksDBEngine/RocksDBColumnFamily.h"
+#include "RocksDBEngine/RocksDBEngine.h"
 #include "RocksDBEngine/RocksDBMethods.h"
+#include "RocksDBEngine/RocksDBParallelScan.h"
 #include "RocksDBEngine/RocksDBPrimaryIndex.h"
 #include "RocksDBEngine/RocksDBTransactionState.h"
+#include "StorageEngine/EngineSelectorFeature.h"
 
 using namespace arangodb;
 
 namespace {
 constexpr bool AllIteratorFillBlockCache = true;
 constexpr bool AnyIteratorFillBlockCache = false;
+/// @brief read-ahead size for full collection scans. the all-iterator
+/// reads the collection's documents sequentially, so larger reads reduce
+/// the number of I/O requests a scan issues
+constexpr size_t AllIteratorReadaheadSize = 2 * 1024 * 1024;
+/// @brief minimal number of documents of a collection for a parallel scan,
+/// smaller collections are not worth starting threads for
+constexpr uint64_t ParallelScanMinDocuments = 100000;
+/// @brief number of chunks each thread of a parallel scan reads ahead
+constexpr size_t ParallelScanChunks = 2;
 }
 
 // ================ All Iterator ==================
@@ -43,13 +55,35 @@ RocksDBAllIndexIterator::RocksDBAllIndexIterator(
     ManagedDocumentResult* mmdr, RocksDBPrimaryIndex const* index, bool reverse)
     : IndexIterator(col, trx, mmdr, index),
       _reverse(reverse),
-      _bounds(RocksDBKeyBounds::CollectionDocuments(
-          static_cast<RocksDBCollection*>(col->getPhysical())->objectId())),
+      _byKey(RocksDBTransactionState::toState(trx)->canRefreshSnapshot()),
+      _bounds(_byKey
+                  ? RocksDBKeyBounds::PrimaryIndex(index->objectId())
+                  : RocksDBKeyBounds::CollectionDocuments(
+                        static_cast<RocksDBCollection*>(col->getPhysical())
+                            ->objectId())),
       _iterator(),
-      _cmp(RocksDBColumnFamily::documents()->GetComparator()) {
+      _cmp(_byKey ? index->comparator()
+                  : RocksDBColumnFamily::documents()->GetComparator()),
+      _fresh(true) {
+  createIterator();
+#ifdef ARANGODB_ENABLE_MAINTAINER_MODE
+  rocksdb::ColumnFamilyDescriptor desc;
+  _bounds.columnFamily()->GetDescriptor(&desc);
+  TRI_ASSERT(desc.options.prefix_extractor);
+#endif
+
+  if (reverse) {
+    _iterator->SeekForPrev(_bounds.end());
+  } else {
+    _iterator->Seek(_bounds.start());
+  }
+}
+
+RocksDBAllIndexIterator::~RocksDBAllIndexIterator() {}
+
+void RocksDBAllIndexIterator::createIterator() {
   // acquire rocksdb transaction
-  auto* mthds = RocksDBTransactionState::toMethods(trx);
-  rocksdb::ColumnFamilyHandle* cf = RocksDBColumnFamily::documents();
+  auto* mthds = RocksDBTransactionState::toMethods(_trx);
 
   // intentional copy of the read options
   rocksdb::ReadOptions options = mthds->readOptions();
@@ -57,21 +91,60 @@ RocksDBAllIndexIterator::RocksDBAllIndexIterator(
   TRI_ASSERT(options.prefix_same_as_start);
   options.fill_cache = AllIteratorFillBlockCache;
   options.verify_checksums = false;  // TODO evaluate
-  // options.readahead_size = 4 * 1024 * 1024;
-  _iterator = mthds->NewIterator(options, cf);
-#ifdef ARANGODB_ENABLE_MAINTAINER_MODE
-  rocksdb::ColumnFamilyDescriptor desc;
-  cf->GetDescriptor(&desc);
-  TRI_ASSERT(desc.options.prefix_extractor);
-#endif
+  options.readahead_size = AllIteratorReadaheadSize;
+  if (_reverse) {
+    _iterator = mthds->NewIterator(options, _bounds.columnFamily());
+  } else {
+    _iterator = mthds->NewIterator(options, _bounds, _upperBound);
+  }
+}
 
-  if (reverse) {
-    _iterator->SeekForPrev(_bounds.end());
+void RocksDBAllIndexIterator::refreshSnapshot() {
+  RocksDBTransactionState* state = RocksDBTransactionState::toState(_trx);
+  if (!state->canRefreshSnapshot() || !_iterator->Valid()) {
+    return;
+  }
+  TRI_ASSERT(_byKey);
+  // continue on the new snapshot with the first _key not yet returned, or
+  // with the next one if it has been removed in the meantime
+  std::string const position = _iterator->key().ToString();
+  state->refreshSnapshot();
+  createIterator();
+  if (_reverse) {
+    _iterator->SeekForPrev(position);
   } else {
-    _iterator->Seek(_bounds.start());
+    _iterator->Seek(position);
   }
 }
 
+void RocksDBAllIndexIterator::startParallelScan() {
+  TRI_ASSERT(_scan == nullptr);
+  size_t const numThreads =
+      static_cast<RocksDBEngine*>(EngineSelectorFeature::ENGINE)
+          ->scanThreads();
+  if (numThreads <= 1 || _reverse || _byKey ||
+      !RocksDBTransactionState::toState(_trx)->readsFromSnapshot() ||
+      !_iterator->Valid() ||
+      _collection->numberDocuments(_trx) < ParallelScanMinDocuments) {
+    return;
+  }
+
+  // a read-only transaction reads straight from its snapshot, so the
+  // threads see exactly the documents this iterator would
+  auto* mthds = RocksDBTransactionState::toMethods(_trx);
+  rocksdb::ReadOptions options = mthds->readOptions();
+  TRI_ASSERT(options.snapshot != nullptr);
+  options.fill_cache = AllIteratorFillBlockCache;
+  options.verify_checksums = false;
+  options.readahead_size = AllIteratorReadaheadSize;
+
+  _scan.reset(new RocksDBParallelScan(
+      RocksDBParallelScan::documentReaders(
+          options, _bounds.columnFamily(),
+          RocksDBParallelScan::split(_bounds, numThreads)),
+      ParallelScanChunks));
+}
+
 bool RocksDBAllIndexIterator::outOfRange() const {
   TRI_ASSERT(_trx->state()->isRunning());
   if (_reverse) {
@@ -83,6 +156,22 @@ bool RocksDBAllIndexIterator::outOfRange() const {
 
 bool RocksDBAllIndexIterator::next(TokenCallback const& cb, size_t limit) {
   TRI_ASSERT(_trx->state()->isRunning());
+  _fresh = false;
+
+  if (_scan != nullptr) {
+    TRI_voc_rid_t revisionId;
+    VPackSlice document;
+    while (limit > 0) {
+      if (!_scan->next(revisionId, document)) {
+        return false;
+      }
+      cb(RocksDBToken(revisionId));
+      --limit;
+    }
+    return true;
+  }
+
+  refreshSnapshot();
 
   if (limit == 0 || !_iterator->Valid() || outOfRange()) {
     // No limit no data, or we are actually done. The last call should have
@@ -97,7 +186,9 @@ bool RocksDBAllIndexIterator::next(TokenCallback const& cb, size_t limit) {
 #endif
 
     TRI_voc_rid_t revisionId =
-        RocksDBKey::revisionId(RocksDBEntryType::Document, _iterator->key());
+        _byKey ? RocksDBValue::revisionId(_iterator->value())
+               : RocksDBKey::revisionId(RocksDBEntryType::Document,
+                                        _iterator->key());
     cb(RocksDBToken(revisionId));
 
     --limit;
@@ -118,6 +209,29 @@ bool RocksDBAllIndexIterator::next(TokenCallback const& cb, size_t limit) {
 bool RocksDBAllIndexIterator::nextDocument(
     IndexIterator::DocumentCallback const& cb, size_t limit) {
   TRI_ASSERT(_trx->state()->isRunning());
+  if (_fresh) {
+    _fresh = false;
+    startParallelScan();
+  }
+
+  auto physical = static_cast<RocksDBCollection*>(_collection->getPhysical());
+
+  if (_scan != nullptr) {
+    TRI_voc_rid_t revisionId;
+    VPackSlice document;
+    while (limit > 0) {
+      if (!_scan->next(revisionId, document)) {
+        return false;
+      }
+      if (!physical->isExpired(revisionId)) {
+        cb(RocksDBToken(revisionId), document);
+        --limit;
+      }
+    }
+    return true;
+  }
+
+  refreshSnapshot();
 
   if (limit == 0 || !_iterator->Valid()) {
     // No limit no data, or we are actually done. The last call should have
@@ -127,9 +241,21 @@ bool RocksDBAllIndexIterator::nextDocument(
   }
 
   while (limit > 0) {
-    TRI_voc_rid_t revisionId = RocksDBKey::revisionId(RocksDBEntryType::Document, _iterator->key());
-    cb(RocksDBToken(revisionId), VPackSlice(_iterator->value().data()));
-    --limit;
+    if (_byKey) {
+      TRI_voc_rid_t revisionId = RocksDBValue::revisionId(_iterator->value());
+      if (!physical->isExpired(revisionId)) {
+        // the document is read from the same snapshot as the index entry
+        physical->readDocumentWithCallback(_trx, RocksDBToken(revisionId),
+                                           cb);
+        --limit;
+      }
+    } else {
+      TRI_voc_rid_t revisionId = RocksDBKey::revisionId(RocksDBEntryType::Document, _iterator->key());
+      if (!physical->isExpired(revisionId)) {
+        cb(RocksDBToken(revisionId), VPackSlice(_iterator->value().data()));
+        --limit;
+      }
+    }
 
     if (_reverse) {
       _iterator->Prev();
@@ -147,6 +273,17 @@ bool RocksDBAllIndexIterator::nextDocument(
   
 void RocksDBAllIndexIterator::skip(uint64_t count, uint64_t& skipped) {
   TRI_ASSERT(_trx->state()->isRunning());
+  _fresh = false;
+
+  if (_scan != nullptr) {
+    TRI_voc_rid_t revisionId;
+    VPackSlice document;
+    while (count > 0 && _scan->next(revisionId, document)) {
+      --count;
+      ++skipped;
+    }
+    return;
+  }
 
   while (count > 0 && _iterator->Valid()) {
     --count;
@@ -162,6 +299,8 @@ void RocksDBAllIndexIterator::skip(uint64_t count, uint64_t& skipped) {
 
 void RocksDBAllIndexIterator::reset() {
   TRI_ASSERT(_trx->state()->isRunning());
+  _scan.reset();
+  _fresh = true;
 
   if (_reverse) {
     _iterator->SeekForPrev(_bounds.end());
@@ -189,7 +328,9 @@ RocksDBAnyIndexIterator::RocksDBAnyIndexIterator(
   TRI_ASSERT(options.prefix_same_as_start);
   options.fill_cache = AnyIteratorFillBlockCache;
   options.verify_checksums = false;  // TODO evaluate
-  _iterator = mthds->NewIterator(options, RocksDBColumnFamily::documents());
+  _iterator = mthds->NewIterator(
+      options, static_cast<RocksDBCollection*>(col->getPhysical())
+                   ->documentsColumnFamily());
 
   _total = col->numberDocuments(trx);
   uint64_t off = RandomGenerator::interval(_total - 1);
@@ -251,10 +392,13 @@ bool RocksDBAnyIndexIterator::nextDocument(
     return false;
   }
 
+  auto physical = static_cast<RocksDBCollection*>(_collection->getPhysical());
   while (limit > 0) {
     TRI_voc_rid_t revisionId = RocksDBKey::revisionId(RocksDBEntryType::Document, _iterator->key());
-    cb(RocksDBToken(revisionId), VPackSlice(_iterator->value().data()));
-    --limit;
+    if (!physical->isExpired(revisionId)) {
+      cb(RocksDBToken(revisionId), VPackSlice(_iterator->value().data()));
+      --limit;
+    }
     _returned++;
     _iterator->Next();
     if (!_iterator->Valid() || outOfRange()) {
@@ -294,7 +438,7 @@ RocksDBSortedAllIterator::RocksDBSortedAllIterator(
   TRI_ASSERT(options.prefix_same_as_start);
   options.fill_cache = false; // only used for incremental sync
   options.verify_checksums = false;
-  _iterator = mthds->NewIterator(options, index->columnFamily());
+  _iterator = mthds->NewIterator(options, _bounds, _upperBound);
   _iterator->Seek(_bounds.start());
   TRI_ASSERT(index->columnFamily() == RocksDBColumnFamily::primary());
 }
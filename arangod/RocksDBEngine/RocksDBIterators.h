@@ -41,10 +41,13 @@ class Comparator;
 
 namespace arangodb {
 class RocksDBCollection;
+class RocksDBParallelScan;
 class RocksDBPrimaryIndex;
 
 /// @brief iterator over all documents in the collection
-/// basically sorted after revision ID
+/// basically sorted after revision ID. read committed transactions iterate
+/// the primary index instead, see refreshSnapshot(). large scans of
+/// read-only transactions are read in parallel, see startParallelScan()
 class RocksDBAllIndexIterator final : public IndexIterator {
  public:
   typedef std::function<void(DocumentIdentifierToken const& token,
@@ -55,7 +58,7 @@ class RocksDBAllIndexIterator final : public IndexIterator {
                           ManagedDocumentResult* mmdr,
                           RocksDBPrimaryIndex const* index, bool reverse);
 
-  ~RocksDBAllIndexIterator() {}
+  ~RocksDBAllIndexIterator();
 
   char const* typeName() const override { return "all-index-iterator"; }
 
@@ -68,10 +71,32 @@ class RocksDBAllIndexIterator final : public IndexIterator {
  private:
   bool outOfRange() const;
 
+  void createIterator();
+
+  /// @brief moves a read committed transaction to a new snapshot before
+  /// each batch, so that long scans do not hold back rocksdb's garbage
+  /// collection, and repositions the iterator on it. such scans iterate
+  /// the primary index: an updated document keeps its _key but gets a new
+  /// revision, so resuming by revision would return it again or miss it
+  void refreshSnapshot();
+
+  /// @brief reads the collection in parallel key ranges if the scan starts
+  /// with nextDocument(), the collection is large enough and the
+  /// transaction is read-only, so that all threads can read from its
+  /// snapshot. the documents are produced in the same order as without
+  void startParallelScan();
+
   bool const _reverse;
+  /// @brief whether the primary index is iterated, in _key order
+  bool const _byKey;
   RocksDBKeyBounds const _bounds;
+  rocksdb::Slice _upperBound;  // used for iterate_upper_bound
   std::unique_ptr<rocksdb::Iterator> _iterator;
   rocksdb::Comparator const* _cmp;
+  /// @brief whether nothing has been read since the last reset
+  bool _fresh;
+  /// @brief parallel scan replacing _iterator, nullptr if not used
+  std::unique_ptr<RocksDBParallelScan> _scan;
 };
 
 class RocksDBAnyIndexIterator final : public IndexIterator {
@@ -129,6 +154,7 @@ class RocksDBSortedAllIterator final : public IndexIterator {
   bool outOfRange() const;
 
   RocksDBKeyBounds const _bounds;
+  rocksdb::Slice _upperBound;  // used for iterate_upper_bound
   std::unique_ptr<rocksdb::Iterator> _iterator;
 #ifdef ARANGODB_ENABLE_MAINTAINER_MODE
   RocksDBPrimaryIndex const* _index;
@@ -92,6 +92,12 @@ RocksDBKey RocksDBKey::GeoIndexValue(uint64_t indexId, int32_t offset,
   return RocksDBKey(RocksDBEntryType::GeoIndexValue, indexId, norm);
 }
 
+RocksDBKey RocksDBKey::GeoCellIndexValue(uint64_t indexId, uint64_t cellId,
+                                         TRI_voc_rid_t revisionId) {
+  return RocksDBKey(RocksDBEntryType::GeoCellIndexValue, indexId, cellId,
+                    revisionId);
+}
+
 RocksDBKey RocksDBKey::View(TRI_voc_tick_t databaseId, TRI_voc_cid_t viewId) {
   return RocksDBKey(RocksDBEntryType::View, databaseId, viewId);
 }
@@ -116,6 +122,14 @@ RocksDBKey RocksDBKey::KeyGeneratorValue(uint64_t objectId) {
   return RocksDBKey(RocksDBEntryType::KeyGeneratorValue, objectId);
 }
 
+RocksDBKey RocksDBKey::AttributeStatisticsValue(uint64_t objectId) {
+  return RocksDBKey(RocksDBEntryType::AttributeStatisticsValue, objectId);
+}
+
+RocksDBKey RocksDBKey::CacheHeatMapValue(uint64_t objectId) {
+  return RocksDBKey(RocksDBEntryType::CacheHeatMapValue, objectId);
+}
+
 // ========================= Member methods ===========================
 
 RocksDBEntryType RocksDBKey::type(RocksDBKey const& key) {
@@ -199,6 +213,18 @@ std::pair<bool, int32_t> RocksDBKey::geoValues(rocksdb::Slice const& slice) {
   return std::pair<bool, int32_t>(isSlot, static_cast<int32_t>(val >> 32));
 }
 
+uint64_t RocksDBKey::geoCellId(rocksdb::Slice const& slice) {
+  TRI_ASSERT(slice.size() == sizeof(uint64_t) * 3);
+  // the cell id is stored big-endian, so keys sort by cell id
+  uint8_t const* p =
+      reinterpret_cast<uint8_t const*>(slice.data() + sizeof(uint64_t));
+  uint64_t value = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+    value = (value << 8) | p[i];
+  }
+  return value;
+}
+
 std::string const& RocksDBKey::string() const { return _buffer; }
 
 RocksDBKey::RocksDBKey(RocksDBEntryType type,
@@ -223,6 +249,8 @@ RocksDBKey::RocksDBKey(RocksDBEntryType type, uint64_t first)
     case RocksDBEntryType::CounterValue:
     case RocksDBEntryType::IndexEstimateValue:
     case RocksDBEntryType::KeyGeneratorValue:
+    case RocksDBEntryType::AttributeStatisticsValue:
+    case RocksDBEntryType::CacheHeatMapValue:
     case RocksDBEntryType::ReplicationApplierConfig: {
       _buffer.reserve(sizeof(char) + sizeof(uint64_t));
       _buffer.push_back(static_cast<char>(_type));
@@ -278,6 +306,27 @@ RocksDBKey::RocksDBKey(RocksDBEntryType type, uint64_t first, uint64_t second)
   }
 }
 
+RocksDBKey::RocksDBKey(RocksDBEntryType type, uint64_t first, uint64_t second,
+                       uint64_t third)
+    : _type(type), _buffer() {
+  switch (_type) {
+    case RocksDBEntryType::GeoCellIndexValue: {
+      // 8-byte object ID of index + 8-byte big-endian cell id +
+      // 8-byte revision ID
+      _buffer.reserve(3 * sizeof(uint64_t));
+      uint64ToPersistent(_buffer, first);
+      for (int shift = 56; shift >= 0; shift -= 8) {
+        _buffer.push_back(static_cast<char>((second >> shift) & 0xffU));
+      }
+      uint64ToPersistent(_buffer, third);
+      break;
+    }
+
+    default:
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_BAD_PARAMETER);
+  }
+}
+
 RocksDBKey::RocksDBKey(RocksDBEntryType type, uint64_t first,
                        VPackSlice const& second, uint64_t third)
     : _type(type), _buffer() {
@@ -408,7 +457,8 @@ TRI_voc_rid_t RocksDBKey::revisionId(RocksDBEntryType type, char const* data,
   switch (type) {
     case RocksDBEntryType::Document:
     case RocksDBEntryType::VPackIndexValue:
-    case RocksDBEntryType::FulltextIndexValue: {
+    case RocksDBEntryType::FulltextIndexValue:
+    case RocksDBEntryType::GeoCellIndexValue: {
       TRI_ASSERT(size >= (2 * sizeof(uint64_t)));
       // last 8 bytes should be the revision
       return uint64FromPersistent(data + size - sizeof(uint64_t));
@@ -125,6 +125,12 @@ class RocksDBKey {
   static RocksDBKey GeoIndexValue(uint64_t indexId, int32_t offset,
                                   bool isSlot);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Create a fully-specified key for a cell based geo index
+  //////////////////////////////////////////////////////////////////////////////
+  static RocksDBKey GeoCellIndexValue(uint64_t indexId, uint64_t cellId,
+                                      TRI_voc_rid_t revisionId);
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Create a fully-specified key for a view
   //////////////////////////////////////////////////////////////////////////////
@@ -156,6 +162,18 @@ class RocksDBKey {
   //////////////////////////////////////////////////////////////////////////////
   static RocksDBKey KeyGeneratorValue(uint64_t objectId);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Create a fully-specified key for the sampled attribute statistics
+  ///        of a collection
+  //////////////////////////////////////////////////////////////////////////////
+  static RocksDBKey AttributeStatisticsValue(uint64_t objectId);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Create a fully-specified key for the persisted hot cache keys of
+  ///        a collection and its indexes
+  //////////////////////////////////////////////////////////////////////////////
+  static RocksDBKey CacheHeatMapValue(uint64_t objectId);
+
  public:
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Extracts the type from a key
@@ -251,6 +269,13 @@ class RocksDBKey {
   //////////////////////////////////////////////////////////////////////////////
   static std::pair<bool, int32_t> geoValues(rocksdb::Slice const& slice);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Extracts the cell id
+  ///
+  /// May be called only on GeoCellIndexValues
+  //////////////////////////////////////////////////////////////////////////////
+  static uint64_t geoCellId(rocksdb::Slice const& slice);
+
   static constexpr size_t objectIdSize() { return sizeof(uint64_t); }
 
  public:
@@ -263,6 +288,8 @@ class RocksDBKey {
   explicit RocksDBKey(RocksDBEntryType type, RocksDBSettingsType st);
   RocksDBKey(RocksDBEntryType type, uint64_t first);
   RocksDBKey(RocksDBEntryType type, uint64_t first, uint64_t second);
+  RocksDBKey(RocksDBEntryType type, uint64_t first, uint64_t second,
+             uint64_t third);
   RocksDBKey(RocksDBEntryType type, uint64_t first, VPackSlice const& slice);
   RocksDBKey(RocksDBEntryType type, uint64_t first, VPackSlice const& second,
              TRI_voc_rid_t third);
@@ -287,6 +314,8 @@ class RocksDBKey {
       case RocksDBEntryType::IndexEstimateValue:
       case RocksDBEntryType::KeyGeneratorValue:
       case RocksDBEntryType::View:
+      case RocksDBEntryType::AttributeStatisticsValue:
+      case RocksDBEntryType::CacheHeatMapValue:
         return type;
       default:
         TRI_ASSERT(false);
@@ -188,6 +188,7 @@ uint64_t RocksDBKeyBounds::objectId() const {
     case RocksDBEntryType::VPackIndexValue:
     case RocksDBEntryType::UniqueVPackIndexValue:
     case RocksDBEntryType::GeoIndexValue:
+    case RocksDBEntryType::GeoCellIndexValue:
     case RocksDBEntryType::FulltextIndexValue: {
       TRI_ASSERT(_internals.buffer().size() > sizeof(uint64_t));
       return uint64FromPersistent(_internals.buffer().data());
@@ -204,7 +205,7 @@ uint64_t RocksDBKeyBounds::objectId() const {
 rocksdb::ColumnFamilyHandle* RocksDBKeyBounds::columnFamily() const {
   switch (_type) {
     case RocksDBEntryType::Document:
-      return RocksDBColumnFamily::documents();
+      return RocksDBColumnFamily::documents(objectId());
     case RocksDBEntryType::PrimaryIndexValue:
       return RocksDBColumnFamily::primary();
     case RocksDBEntryType::EdgeIndexValue:
@@ -215,6 +216,7 @@ rocksdb::ColumnFamilyHandle* RocksDBKeyBounds::columnFamily() const {
     case RocksDBEntryType::FulltextIndexValue:
       return RocksDBColumnFamily::fulltext();
     case RocksDBEntryType::GeoIndexValue:
+    case RocksDBEntryType::GeoCellIndexValue:
       return RocksDBColumnFamily::geo();
     case RocksDBEntryType::Database:
     case RocksDBEntryType::Collection:
@@ -224,6 +226,8 @@ rocksdb::ColumnFamilyHandle* RocksDBKeyBounds::columnFamily() const {
     case RocksDBEntryType::IndexEstimateValue:
     case RocksDBEntryType::KeyGeneratorValue:
     case RocksDBEntryType::View:
+    case RocksDBEntryType::AttributeStatisticsValue:
+    case RocksDBEntryType::CacheHeatMapValue:
       return RocksDBColumnFamily::definitions();
   }
   THROW_ARANGO_EXCEPTION(TRI_ERROR_TYPE_ERROR);
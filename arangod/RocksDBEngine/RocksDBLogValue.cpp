@@ -59,6 +59,13 @@ RocksDBLogValue RocksDBLogValue::CollectionChange(TRI_voc_tick_t dbid,
   return RocksDBLogValue(RocksDBLogType::CollectionChange, dbid, cid);
 }
 
+RocksDBLogValue RocksDBLogValue::CollectionTruncate(TRI_voc_tick_t dbid,
+                                                    TRI_voc_cid_t cid,
+                                                    uint64_t objectId) {
+  return RocksDBLogValue(RocksDBLogType::CollectionTruncate, dbid, cid,
+                         objectId);
+}
+
 RocksDBLogValue RocksDBLogValue::IndexCreate(TRI_voc_tick_t dbid,
                                              TRI_voc_cid_t cid,
                                              VPackSlice const& indexInfo) {
@@ -160,12 +167,13 @@ RocksDBLogValue::RocksDBLogValue(RocksDBLogType type, uint64_t dbId,
                                  uint64_t cid, uint64_t iid)
     : _buffer() {
   switch (type) {
-    case RocksDBLogType::IndexDrop: {
+    case RocksDBLogType::IndexDrop:
+    case RocksDBLogType::CollectionTruncate: {
       _buffer.reserve(sizeof(RocksDBLogType) + sizeof(uint64_t) * 3);
       _buffer.push_back(static_cast<char>(type));
       uint64ToPersistent(_buffer, dbId);
       uint64ToPersistent(_buffer, cid);
-      uint64ToPersistent(_buffer, iid);
+      uint64ToPersistent(_buffer, iid);  // index or object ID
       break;
     }
     default:
@@ -246,6 +254,7 @@ TRI_voc_tick_t RocksDBLogValue::databaseId(rocksdb::Slice const& slice) {
              type == RocksDBLogType::CollectionDrop ||
              type == RocksDBLogType::CollectionRename ||
              type == RocksDBLogType::CollectionChange ||
+             type == RocksDBLogType::CollectionTruncate ||
              type == RocksDBLogType::IndexCreate ||
              type == RocksDBLogType::IndexDrop ||
              type == RocksDBLogType::BeginTransaction ||
@@ -261,6 +270,7 @@ TRI_voc_cid_t RocksDBLogValue::collectionId(rocksdb::Slice const& slice) {
              type == RocksDBLogType::CollectionDrop ||
              type == RocksDBLogType::CollectionRename ||
              type == RocksDBLogType::CollectionChange ||
+             type == RocksDBLogType::CollectionTruncate ||
              type == RocksDBLogType::IndexCreate ||
              type == RocksDBLogType::IndexDrop ||
              type == RocksDBLogType::DocumentOperationsPrologue ||
@@ -291,6 +301,14 @@ TRI_idx_iid_t RocksDBLogValue::indexId(rocksdb::Slice const& slice) {
                               (2 * sizeof(uint64_t)));
 }
 
+uint64_t RocksDBLogValue::objectId(rocksdb::Slice const& slice) {
+  TRI_ASSERT(slice.size() >= sizeof(RocksDBLogType) + (3 * sizeof(uint64_t)));
+  RocksDBLogType type = static_cast<RocksDBLogType>(slice.data()[0]);
+  TRI_ASSERT(type == RocksDBLogType::CollectionTruncate);
+  return uint64FromPersistent(slice.data() + sizeof(RocksDBLogType) +
+                              (2 * sizeof(uint64_t)));
+}
+
 VPackSlice RocksDBLogValue::indexSlice(rocksdb::Slice const& slice) {
   TRI_ASSERT(slice.size() >= sizeof(RocksDBLogType) + sizeof(uint64_t) * 2);
   RocksDBLogType type = static_cast<RocksDBLogType>(slice.data()[0]);
@@ -54,6 +54,9 @@ class RocksDBLogValue {
                                           StringRef const& newName);
   static RocksDBLogValue CollectionChange(TRI_voc_tick_t vocbaseId,
                                           TRI_voc_cid_t cid);
+  static RocksDBLogValue CollectionTruncate(TRI_voc_tick_t vocbaseId,
+                                            TRI_voc_cid_t cid,
+                                            uint64_t objectId);
 
   static RocksDBLogValue IndexCreate(TRI_voc_tick_t vocbaseId,
                                      TRI_voc_cid_t cid,
@@ -86,6 +89,7 @@ class RocksDBLogValue {
   static TRI_voc_tid_t transactionId(rocksdb::Slice const&);
   static TRI_voc_cid_t collectionId(rocksdb::Slice const&);
   static TRI_idx_iid_t indexId(rocksdb::Slice const&);
+  static uint64_t objectId(rocksdb::Slice const&);
   static velocypack::Slice indexSlice(rocksdb::Slice const&);
   static arangodb::StringRef newCollectionName(rocksdb::Slice const&);
   static arangodb::StringRef documentKey(rocksdb::Slice const&);
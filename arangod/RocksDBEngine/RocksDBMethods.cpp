@@ -70,14 +70,23 @@ rocksdb::ReadOptions const& RocksDBMethods::readOptions() {
   return _state->_rocksReadOptions;
 }
 
+std::unique_ptr<rocksdb::Iterator> RocksDBMethods::NewIterator(
+    rocksdb::ReadOptions ro, RocksDBKeyBounds const& bounds,
+    rocksdb::Slice& upperBound) {
+  upperBound = bounds.end();
+  ro.iterate_upper_bound = &upperBound;
+  return this->NewIterator(ro, bounds.columnFamily());
+}
+
 #ifdef ARANGODB_ENABLE_MAINTAINER_MODE
 std::size_t RocksDBMethods::countInBounds(RocksDBKeyBounds const& bounds, bool isElementInRange) {
   std::size_t count = 0;
   
   //iterator is from read only / trx / writebatch
-  std::unique_ptr<rocksdb::Iterator> iter = this->NewIterator(this->readOptions(), bounds.columnFamily());
+  rocksdb::Slice end;
+  std::unique_ptr<rocksdb::Iterator> iter =
+      this->NewIterator(this->readOptions(), bounds, end);
   iter->Seek(bounds.start());
-  auto end = bounds.end();
   rocksdb::Comparator const * cmp = bounds.columnFamily()->GetComparator();
   
   // extra check to aviod extra comparisons with isElementInRage later;
@@ -97,6 +106,19 @@ std::size_t RocksDBMethods::countInBounds(RocksDBKeyBounds const& bounds, bool i
 };
 #endif
 
+arangodb::Result RocksDBMethods::PutUntracked(rocksdb::ColumnFamilyHandle* cf,
+                                              RocksDBKey const& key,
+                                              rocksdb::Slice const& val,
+                                              rocksutils::StatusHint hint) {
+  // only transactions lock and track their keys
+  return this->Put(cf, key, val, hint);
+}
+
+arangodb::Result RocksDBMethods::DeleteUntracked(
+    rocksdb::ColumnFamilyHandle* cf, RocksDBKey const& key) {
+  return this->Delete(cf, key);
+}
+
 // =================== RocksDBReadOnlyMethods ====================
 
 RocksDBReadOnlyMethods::RocksDBReadOnlyMethods(RocksDBTransactionState* state)
@@ -186,6 +208,23 @@ arangodb::Result RocksDBTrxMethods::Delete(rocksdb::ColumnFamilyHandle* cf,
   return s.ok() ? arangodb::Result() : rocksutils::convertStatus(s);
 }
 
+arangodb::Result RocksDBTrxMethods::PutUntracked(
+    rocksdb::ColumnFamilyHandle* cf, RocksDBKey const& key,
+    rocksdb::Slice const& val, rocksutils::StatusHint hint) {
+  TRI_ASSERT(cf != nullptr);
+  rocksdb::Status s =
+      _state->_rocksTransaction->PutUntracked(cf, key.string(), val);
+  return s.ok() ? arangodb::Result() : rocksutils::convertStatus(s, hint);
+}
+
+arangodb::Result RocksDBTrxMethods::DeleteUntracked(
+    rocksdb::ColumnFamilyHandle* cf, RocksDBKey const& key) {
+  TRI_ASSERT(cf != nullptr);
+  rocksdb::Status s =
+      _state->_rocksTransaction->DeleteUntracked(cf, key.string());
+  return s.ok() ? arangodb::Result() : rocksutils::convertStatus(s);
+}
+
 std::unique_ptr<rocksdb::Iterator> RocksDBTrxMethods::NewIterator(
     rocksdb::ReadOptions const& opts, rocksdb::ColumnFamilyHandle* cf) {
   TRI_ASSERT(cf != nullptr);
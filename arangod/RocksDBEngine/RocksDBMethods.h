@@ -77,6 +77,16 @@ class RocksDBMethods {
   virtual arangodb::Result Delete(rocksdb::ColumnFamilyHandle*,
                                   RocksDBKey const&) = 0;
 
+  /// @brief like Put and Delete, but the key is neither locked nor tracked
+  /// for conflicts. only for keys that no other transaction can write at
+  /// the same time, like index entries containing the revision id of their
+  /// document: writers of that document conflict on its primary key anyway
+  virtual arangodb::Result PutUntracked(
+      rocksdb::ColumnFamilyHandle*, RocksDBKey const&, rocksdb::Slice const&,
+      rocksutils::StatusHint hint = rocksutils::StatusHint::none);
+  virtual arangodb::Result DeleteUntracked(rocksdb::ColumnFamilyHandle*,
+                                           RocksDBKey const&);
+
   std::unique_ptr<rocksdb::Iterator> NewIterator(
       rocksdb::ColumnFamilyHandle* cf) {
     return this->NewIterator(this->readOptions(), cf);
@@ -84,6 +94,15 @@ class RocksDBMethods {
   virtual std::unique_ptr<rocksdb::Iterator> NewIterator(
       rocksdb::ReadOptions const&, rocksdb::ColumnFamilyHandle*) = 0;
 
+  /// @brief creates an iterator for a forward scan over the bounds. rocksdb
+  /// stops the iterator at bounds.end() and skips blocks and files behind
+  /// it. upperBound is referenced by the iterator, so it must outlive it.
+  /// an iterator that is reused for other bounds has to update upperBound
+  /// to the new end before seeking
+  std::unique_ptr<rocksdb::Iterator> NewIterator(rocksdb::ReadOptions ro,
+                                                 RocksDBKeyBounds const& bounds,
+                                                 rocksdb::Slice& upperBound);
+
   virtual void SetSavePoint() = 0;
   virtual arangodb::Result RollbackToSavePoint() = 0;
 
@@ -137,6 +156,13 @@ class RocksDBTrxMethods : public RocksDBMethods {
   arangodb::Result Delete(rocksdb::ColumnFamilyHandle*,
                           RocksDBKey const& key) override;
 
+  arangodb::Result PutUntracked(
+      rocksdb::ColumnFamilyHandle*, RocksDBKey const& key,
+      rocksdb::Slice const& val,
+      rocksutils::StatusHint hint = rocksutils::StatusHint::none) override;
+  arangodb::Result DeleteUntracked(rocksdb::ColumnFamilyHandle*,
+                                   RocksDBKey const& key) override;
+
   std::unique_ptr<rocksdb::Iterator> NewIterator(
       rocksdb::ReadOptions const&, rocksdb::ColumnFamilyHandle*) override;
 
@@ -32,6 +32,7 @@
 #include "Aql/OptimizerRule.h"
 #include "Aql/OptimizerRulesFeature.h"
 #include "Aql/SortNode.h"
+#include "Basics/StaticStrings.h"
 #include "Cluster/ServerState.h"
 #include "Indexes/Index.h"
 #include "VocBase/LogicalCollection.h"
@@ -63,12 +64,94 @@ class AttributeAccessReplacer final : public WalkerWorker<ExecutionNode> {
   std::vector<std::string> _attribute;
 };
 
+/// @brief mark an IndexNode with a projection as covering if the projected
+/// attribute (or one of its parents) is stored in the index, so that the
+/// documents do not need to be looked up
+static void MarkCoveringIndex(IndexNode* node) {
+  auto const& projection = node->projection();
+  TRI_ASSERT(!projection.empty());
+
+  if (node->getIndexes().size() != 1 ||
+      projection[0] == StaticStrings::IdString) {
+    // _id is not stored as a string in the index
+    return;
+  }
+
+  auto index = node->getIndexes()[0].getIndex();
+  if (!index->hasCoveringIterator()) {
+    return;
+  }
+
+  auto const& fields = index->fields();
+  for (size_t i = 0; i < fields.size(); ++i) {
+    auto const& field = fields[i];
+    if (field.size() > projection.size()) {
+      continue;
+    }
+
+    bool matches = true;
+    for (size_t j = 0; j < field.size(); ++j) {
+      if (field[j].shouldExpand || field[j].name != projection[j]) {
+        matches = false;
+        break;
+      }
+    }
+
+    if (matches) {
+      node->setCovering(i);
+      return;
+    }
+  }
+}
+
+/// @brief maximum number of top-level attributes for which a partial document
+/// is produced instead of the entire document
+static constexpr size_t MaxProjections = 8;
+
+/// @brief determine the top-level attributes of the out variable of a
+/// document producing node used by the nodes above it. returns false if the
+/// entire document is needed
+static bool CollectProjections(ExecutionNode* n, Variable const* v,
+                               std::vector<std::string>& projections) {
+  std::unordered_set<std::string> attributes;
+  std::unordered_set<Variable const*> vars;
+
+  ExecutionNode* current = n->getFirstParent();
+  while (current != nullptr) {
+    vars.clear();
+    current->getVariablesUsedHere(vars);
+
+    if (vars.find(v) != vars.end()) {
+      if (current->getType() != EN::CALCULATION) {
+        // original variable is used as a whole here
+        return false;
+      }
+      Expression* exp = static_cast<CalculationNode*>(current)->expression();
+      if (exp == nullptr || exp->node() == nullptr ||
+          !Ast::getReferencedAttributes(exp->node(), v, attributes)) {
+        return false;
+      }
+    }
+
+    current = current->getFirstParent();
+  }
+
+  if (attributes.empty() || attributes.size() > MaxProjections) {
+    return false;
+  }
+
+  projections.assign(attributes.begin(), attributes.end());
+  std::sort(projections.begin(), projections.end());
+  return true;
+}
+
 void RocksDBOptimizerRules::registerResources() {
   OptimizerRulesFeature::registerRule("reduce-extraction-to-projection", reduceExtractionToProjectionRule, 
                OptimizerRule::reduceExtractionToProjectionRule_pass6, false, true);
 }
 
-// simplify an EnumerationCollectionNode that fetches an entire document to a projection of this document
+// simplify an EnumerationCollectionNode or IndexNode that fetches an entire document to a projection of this document.
+// IndexNodes whose projection is stored in the index are additionally marked as covering
 void RocksDBOptimizerRules::reduceExtractionToProjectionRule(Optimizer* opt, 
                                                              std::unique_ptr<ExecutionPlan> plan, 
                                                              OptimizerRule const* rule) {
@@ -77,7 +160,7 @@ void RocksDBOptimizerRules::reduceExtractionToProjectionRule(Optimizer* opt,
   SmallVector<ExecutionNode*>::allocator_type::arena_type a;
   SmallVector<ExecutionNode*> nodes{a};
   
-  std::vector<ExecutionNode::NodeType> const types = {ExecutionNode::ENUMERATE_COLLECTION}; 
+  std::vector<ExecutionNode::NodeType> const types = {ExecutionNode::ENUMERATE_COLLECTION, ExecutionNode::INDEX}; 
   plan->findNodesOfType(nodes, types, true);
 
   bool modified = false;
@@ -161,7 +244,19 @@ void RocksDBOptimizerRules::reduceExtractionToProjectionRule(Optimizer* opt,
       std::reverse(attributeNames.begin(), attributeNames.end());
       e->setProjection(std::move(attributeNames));
 
+      if (n->getType() == EN::INDEX) {
+        MarkCoveringIndex(static_cast<IndexNode*>(n));
+      }
+
       modified = true;
+    } else if (e->projection().empty()) {
+      // the document is used for several attributes. produce a partial
+      // document with just these
+      std::vector<std::string> projections;
+      if (CollectProjections(n, v, projections)) {
+        e->setProjections(std::move(projections));
+        modified = true;
+      }
     }
   }
     
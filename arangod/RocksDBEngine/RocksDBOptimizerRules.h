@@ -36,7 +36,7 @@ struct OptimizerRule;
 struct RocksDBOptimizerRules {
   static void registerResources();
   
-  // simplify an EnumerationCollectionNode that fetches an entire document to a projection of this document
+  // simplify an EnumerationCollectionNode or IndexNode that fetches an entire document to a projection of this document
   static void reduceExtractionToProjectionRule(aql::Optimizer* opt, std::unique_ptr<aql::ExecutionPlan> plan, aql::OptimizerRule const* rule);
 };
 
@@ -0,0 +1,225 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RocksDBParallelScan.h"
+#include "Basics/ConditionLocker.h"
+#include "Basics/Exceptions.h"
+#include "RocksDBEngine/RocksDBCommon.h"
+#include "RocksDBEngine/RocksDBKey.h"
+#include "RocksDBEngine/RocksDBKeyBounds.h"
+
+#include <rocksdb/db.h>
+#include <rocksdb/iterator.h>
+#include <rocksdb/options.h>
+
+using namespace arangodb;
+
+constexpr size_t RocksDBParallelScan::ChunkDocuments;
+constexpr size_t RocksDBParallelScan::ChunkBytes;
+
+RocksDBParallelScan::RocksDBParallelScan(std::vector<RangeReader>&& readers,
+                                         size_t maxChunks)
+    : _maxChunks((std::max)(maxChunks, static_cast<size_t>(1))),
+      _readers(std::move(readers)),
+      _ranges(_readers.size()),
+      _stopping(false),
+      _range(0),
+      _position(0) {
+  _threads.reserve(_readers.size());
+  try {
+    for (size_t i = 0; i < _readers.size(); ++i) {
+      _threads.emplace_back([this, i]() { read(i, _readers[i]); });
+    }
+  } catch (...) {
+    stop();
+    throw;
+  }
+}
+
+RocksDBParallelScan::~RocksDBParallelScan() { stop(); }
+
+/// @brief the next document, false once all ranges are exhausted
+bool RocksDBParallelScan::next(TRI_voc_rid_t& revisionId,
+                               VPackSlice& document) {
+  while (true) {
+    if (_current != nullptr && _position < _current->documents.size()) {
+      auto const& entry = _current->documents[_position++];
+      revisionId = entry.first;
+      document = VPackSlice(_current->data.data() + entry.second);
+      return true;
+    }
+
+    _current.reset();
+    if (_range >= _ranges.size()) {
+      return false;
+    }
+
+    CONDITION_LOCKER(guard, _condition);
+    Range& range = _ranges[_range];
+    while (range.chunks.empty() && !range.done) {
+      guard.wait();
+    }
+
+    if (!range.chunks.empty()) {
+      _current = std::move(range.chunks.front());
+      range.chunks.pop_front();
+      _position = 0;
+      // the reader of the range may go on
+      guard.broadcast();
+      continue;
+    }
+
+    if (range.result.fail()) {
+      THROW_ARANGO_EXCEPTION(range.result);
+    }
+    ++_range;
+  }
+}
+
+/// @brief splits the bounds of a collection's documents into key ranges
+std::vector<std::string> RocksDBParallelScan::split(
+    RocksDBKeyBounds const& bounds, size_t numRanges) {
+  numRanges = (std::max)(static_cast<size_t>(1),
+                         (std::min)(numRanges, static_cast<size_t>(256)));
+
+  std::string const prefix = bounds.start().ToString();
+  std::vector<std::string> borders;
+  borders.reserve(numRanges + 1);
+  borders.emplace_back(prefix);
+  for (size_t i = 1; i < numRanges; ++i) {
+    borders.emplace_back(prefix);
+    borders.back().push_back(static_cast<char>(i * 256 / numRanges));
+  }
+  borders.emplace_back(bounds.end().ToString());
+  return borders;
+}
+
+/// @brief readers for the ranges between the borders
+std::vector<RocksDBParallelScan::RangeReader>
+RocksDBParallelScan::documentReaders(rocksdb::ReadOptions const& options,
+                                     rocksdb::ColumnFamilyHandle* cf,
+                                     std::vector<std::string> const& borders) {
+  TRI_ASSERT(options.snapshot != nullptr);
+  TRI_ASSERT(borders.size() >= 2);
+
+  /// @brief state of a reader, the iterator is created by its thread
+  struct DocumentRange {
+    rocksdb::ReadOptions options;
+    rocksdb::ColumnFamilyHandle* cf;
+    std::string lower;
+    std::string upper;
+    rocksdb::Slice upperBound;
+    std::unique_ptr<rocksdb::Iterator> iterator;
+  };
+
+  std::vector<RangeReader> readers;
+  readers.reserve(borders.size() - 1);
+
+  for (size_t i = 0; i + 1 < borders.size(); ++i) {
+    auto range = std::make_shared<DocumentRange>();
+    range->options = options;
+    range->cf = cf;
+    range->lower = borders[i];
+    range->upper = borders[i + 1];
+
+    readers.emplace_back([range](Chunk& chunk) -> bool {
+      if (range->iterator == nullptr) {
+        range->upperBound = rocksdb::Slice(range->upper);
+        range->options.iterate_upper_bound = &range->upperBound;
+        range->iterator.reset(
+            rocksutils::globalRocksDB()->NewIterator(range->options,
+                                                     range->cf));
+        range->iterator->Seek(range->lower);
+      }
+
+      rocksdb::Iterator* it = range->iterator.get();
+      while (it->Valid()) {
+        if (chunk.documents.size() >= ChunkDocuments ||
+            chunk.data.size() >= ChunkBytes) {
+          return true;
+        }
+        chunk.documents.emplace_back(
+            RocksDBKey::revisionId(RocksDBEntryType::Document, it->key()),
+            chunk.data.size());
+        chunk.data.append(it->value().data(), it->value().size());
+        it->Next();
+      }
+
+      if (!it->status().ok()) {
+        THROW_ARANGO_EXCEPTION(rocksutils::convertStatus(it->status()));
+      }
+      return false;
+    });
+  }
+
+  return readers;
+}
+
+/// @brief main loop of the thread reading range i
+void RocksDBParallelScan::read(size_t i, RangeReader const& reader) {
+  Result result;
+  bool more = true;
+
+  while (more) {
+    std::unique_ptr<Chunk> chunk(new Chunk);
+    try {
+      more = reader(*chunk);
+    } catch (basics::Exception const& ex) {
+      result.reset(ex.code(), ex.what());
+      more = false;
+    } catch (std::exception const& ex) {
+      result.reset(TRI_ERROR_INTERNAL, ex.what());
+      more = false;
+    }
+
+    CONDITION_LOCKER(guard, _condition);
+    Range& range = _ranges[i];
+    while (!_stopping && range.chunks.size() >= _maxChunks) {
+      guard.wait();
+    }
+    if (_stopping) {
+      return;
+    }
+
+    if (!chunk->documents.empty()) {
+      range.chunks.emplace_back(std::move(chunk));
+    }
+    if (!more) {
+      range.done = true;
+      range.result = result;
+    }
+    guard.broadcast();
+  }
+}
+
+/// @brief stop and join all threads
+void RocksDBParallelScan::stop() {
+  {
+    CONDITION_LOCKER(guard, _condition);
+    _stopping = true;
+    guard.broadcast();
+  }
+
+  for (auto& thread : _threads) {
+    thread.join();
+  }
+  _threads.clear();
+}
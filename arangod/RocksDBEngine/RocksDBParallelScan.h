@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_ROCKSDB_ENGINE_PARALLEL_SCAN_H
+#define ARANGOD_ROCKSDB_ENGINE_PARALLEL_SCAN_H 1
+
+#include "Basics/Common.h"
+#include "Basics/ConditionVariable.h"
+#include "Basics/Result.h"
+#include "VocBase/voc-types.h"
+
+#include <velocypack/Slice.h>
+
+#include <deque>
+#include <functional>
+#include <thread>
+
+namespace rocksdb {
+class ColumnFamilyHandle;
+struct ReadOptions;
+}
+
+namespace arangodb {
+class RocksDBKeyBounds;
+
+/// @brief reads the documents of a collection in key ranges, each range on
+/// its own thread. the threads read ahead into a few chunks per range. the
+/// consumer takes the ranges one after the other, so the documents are
+/// produced in the same order as by a sequential scan
+class RocksDBParallelScan {
+ public:
+  /// @brief documents read from a range in one go
+  struct Chunk {
+    /// @brief the documents, one after the other
+    std::string data;
+    /// @brief revision id and offset in data of each document
+    std::vector<std::pair<TRI_voc_rid_t, size_t>> documents;
+  };
+
+  /// @brief adds the next documents of a range to the (empty) chunk.
+  /// returns false once the range is exhausted. errors are thrown
+  typedef std::function<bool(Chunk&)> RangeReader;
+
+  /// @brief maximal number of documents of a chunk
+  static constexpr size_t ChunkDocuments = 1000;
+
+  /// @brief size of a chunk after which no more documents are added
+  static constexpr size_t ChunkBytes = 1024 * 1024;
+
+  /// @brief starts one thread per range reader. each of them keeps at most
+  /// maxChunks chunks that the consumer has not taken yet
+  RocksDBParallelScan(std::vector<RangeReader>&& readers, size_t maxChunks);
+  ~RocksDBParallelScan();
+
+  RocksDBParallelScan(RocksDBParallelScan const&) = delete;
+  RocksDBParallelScan& operator=(RocksDBParallelScan const&) = delete;
+
+ public:
+  /// @brief the next document, false once all ranges are exhausted. the
+  /// document stays valid until the next call. errors of a range are
+  /// thrown when the consumer reaches the end of its documents
+  bool next(TRI_voc_rid_t& revisionId, arangodb::velocypack::Slice& document);
+
+  /// @brief splits the bounds of a collection's documents into numRanges
+  /// key ranges. the first byte after the object id is the lowest byte of
+  /// the revision id, which is about evenly distributed. returns the
+  /// numRanges + 1 borders of the ranges
+  static std::vector<std::string> split(RocksDBKeyBounds const& bounds,
+                                        size_t numRanges);
+
+  /// @brief readers for the ranges between the borders, reading from a
+  /// column family with the given options. options must have a snapshot
+  static std::vector<RangeReader> documentReaders(
+      rocksdb::ReadOptions const& options, rocksdb::ColumnFamilyHandle* cf,
+      std::vector<std::string> const& borders);
+
+ private:
+  /// @brief the chunks of one range read ahead
+  struct Range {
+    Range() : done(false) {}
+
+    std::deque<std::unique_ptr<Chunk>> chunks;
+    bool done;
+    Result result;
+  };
+
+  /// @brief main loop of the thread reading range i
+  void read(size_t i, RangeReader const& reader);
+
+  /// @brief stop and join all threads
+  void stop();
+
+ private:
+  size_t const _maxChunks;
+
+  std::vector<RangeReader> _readers;
+
+  std::vector<std::thread> _threads;
+
+  /// @brief protects _ranges and _stopping
+  basics::ConditionVariable _condition;
+
+  std::vector<Range> _ranges;
+
+  bool _stopping;
+
+  /// @brief range the consumer currently takes documents from
+  size_t _range;
+
+  /// @brief chunk the consumer currently takes documents from
+  std::unique_ptr<Chunk> _current;
+
+  /// @brief next document of the current chunk
+  size_t _position;
+};
+
+}  // namespace arangodb
+
+#endif
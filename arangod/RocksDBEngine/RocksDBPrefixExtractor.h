@@ -27,6 +27,8 @@
 #define ARANGO_ROCKSDB_ROCKSDB_PREFIX_EXTRACTOR_H 1
 
 #include "Basics/Common.h"
+#include "RocksDBEngine/RocksDBKey.h"
+#include "RocksDBEngine/RocksDBTypes.h"
 
 #include <rocksdb/slice.h>
 #include <rocksdb/slice_transform.h>
@@ -34,6 +36,8 @@
 #include <velocypack/Slice.h>
 #include <velocypack/velocypack-aliases.h>
 
+#include <memory>
+
 namespace arangodb {
 
 class RocksDBPrefixExtractor final : public rocksdb::SliceTransform {
@@ -79,6 +83,42 @@ class RocksDBPrefixExtractor final : public rocksdb::SliceTransform {
   static const size_t _prefixLength[];
 };
 
+namespace rocksutils {
+
+/// @brief prefix extractor for the column family holding keys of the
+/// given type. edge index keys are prefixed with the object id and the
+/// _from / _to value, as all their lookups are scans for one vertex. all
+/// other index and document keys only share the 8 byte object id, because
+/// their scans span several values (ranges, word prefixes, geo cells)
+inline std::shared_ptr<rocksdb::SliceTransform const> prefixExtractor(
+    RocksDBEntryType type) {
+  switch (type) {
+    case RocksDBEntryType::EdgeIndexValue:
+      return std::make_shared<RocksDBPrefixExtractor>();
+    case RocksDBEntryType::Document:
+    case RocksDBEntryType::PrimaryIndexValue:
+    case RocksDBEntryType::VPackIndexValue:
+    case RocksDBEntryType::UniqueVPackIndexValue:
+    case RocksDBEntryType::FulltextIndexValue:
+    case RocksDBEntryType::GeoIndexValue:
+    case RocksDBEntryType::GeoCellIndexValue:
+      return std::shared_ptr<rocksdb::SliceTransform const>(
+          rocksdb::NewFixedPrefixTransform(RocksDBKey::objectIdSize()));
+    default:
+      // definitions are only read by full key or full scans
+      return nullptr;
+  }
+}
+
+/// @brief whether the bloom filters of the column family holding keys of
+/// the given type should also contain whole keys. edge index entries are
+/// never looked up by their full key, so their filters only hold prefixes
+inline bool wholeKeyFiltering(RocksDBEntryType type) {
+  return type != RocksDBEntryType::EdgeIndexValue;
+}
+
+}  // namespace rocksutils
+
 }  // namespace arangodb
 
 #endif
@@ -63,6 +63,8 @@ using namespace arangodb;
 
 namespace {
 constexpr bool PrimaryIndexFillBlockCache = false;
+// maximum number of keys looked up together by the iterator
+constexpr size_t PrimaryIndexLookupBatchSize = 1000;
 }
 
 // ================ Primary Index Iterator ================
@@ -102,12 +104,19 @@ bool RocksDBPrimaryIndexIterator::next(TokenCallback const& cb, size_t limit) {
   }
 
   while (limit > 0) {
-    // TODO: prevent copying of the value into result, as we don't need it here!
-    RocksDBToken token = _index->lookupKey(_trx, StringRef(*_iterator));
-    cb(token);
+    _batch.clear();
+    while (_batch.size() < (std::min)(limit, PrimaryIndexLookupBatchSize) &&
+           _iterator.valid()) {
+      _batch.emplace_back(*_iterator);
+      _iterator.next();
+    }
+
+    _index->lookupKeys(_trx, _batch, _tokens);
+    for (auto const& token : _tokens) {
+      cb(token);
+    }
 
-    --limit;
-    _iterator.next();
+    limit -= _batch.size();
     if (!_iterator.valid()) {
       return false;
     }
@@ -188,6 +197,101 @@ RocksDBToken RocksDBPrimaryIndex::lookupKey(transaction::Methods* trx,
   return RocksDBToken(RocksDBValue::revisionId(value));
 }
 
+void RocksDBPrimaryIndex::lookupKeys(
+    transaction::Methods* trx, std::vector<arangodb::StringRef> const& keys,
+    std::vector<RocksDBToken>& tokens) const {
+  tokens.clear();
+  if (keys.size() <= 1 || !useCache()) {
+    for (auto const& key : keys) {
+      tokens.emplace_back(lookupKey(trx, key));
+    }
+    return;
+  }
+
+  tokens.resize(keys.size());
+  std::vector<RocksDBKey> rocksKeys;
+  rocksKeys.reserve(keys.size());
+  for (auto const& key : keys) {
+    rocksKeys.emplace_back(RocksDBKey::PrimaryIndexValue(_objectId, key));
+  }
+
+  std::vector<bool> missing(keys.size(), true);
+  {
+    TRI_ASSERT(_cache != nullptr);
+    std::vector<std::pair<void const*, uint32_t>> cacheKeys;
+    cacheKeys.reserve(rocksKeys.size());
+    for (auto const& key : rocksKeys) {
+      cacheKeys.emplace_back(key.string().data(),
+                             static_cast<uint32_t>(key.string().size()));
+    }
+
+    // the findings lease their values, so they must be gone before we
+    // insert into the cache below
+    std::vector<cache::Finding> findings;
+    _cache->findBatch(cacheKeys, findings);
+    for (size_t i = 0; i < findings.size(); i++) {
+      if (findings[i].found()) {
+        rocksdb::Slice s(
+            reinterpret_cast<char const*>(findings[i].value()->value()),
+            static_cast<size_t>(findings[i].value()->valueSize));
+        tokens[i] = RocksDBToken(RocksDBValue::revisionId(s));
+        missing[i] = false;
+      }
+    }
+  }
+
+  RocksDBMethods* mthds = RocksDBTransactionState::toMethods(trx);
+  TRI_ASSERT(mthds->readOptions().snapshot != nullptr);
+
+  std::vector<cache::CachedValue*> entries;
+  auto value = RocksDBValue::Empty(RocksDBEntryType::PrimaryIndexValue);
+  for (size_t i = 0; i < rocksKeys.size(); i++) {
+    if (!missing[i]) {
+      continue;
+    }
+    value.buffer()->clear();
+    arangodb::Result r = mthds->Get(_cf, rocksKeys[i], value.buffer());
+    if (!r.ok()) {
+      continue;
+    }
+    tokens[i] = RocksDBToken(RocksDBValue::revisionId(value));
+    entries.emplace_back(cache::CachedValue::construct(
+        rocksKeys[i].string().data(),
+        static_cast<uint32_t>(rocksKeys[i].string().size()),
+        value.buffer()->data(),
+        static_cast<uint64_t>(value.buffer()->size())));
+  }
+
+  if (!entries.empty() && useCache()) {
+    TRI_ASSERT(_cache != nullptr);
+    // write entries back to cache
+    std::vector<Result> results;
+    _cache->insertBatch(entries, results);
+    for (size_t i = 0; i < entries.size(); i++) {
+      if (results[i].fail()) {
+        delete entries[i];
+      }
+    }
+  } else {
+    for (auto entry : entries) {
+      delete entry;
+    }
+  }
+}
+
+/// @brief whether or not an existing entry belongs to an expired document.
+/// such entries are overwritten, as they may not have been compacted away
+bool RocksDBPrimaryIndex::isExpiredEntry(RocksDBMethods* mthd,
+                                         RocksDBKey const& key) const {
+  auto physical = static_cast<RocksDBCollection*>(_collection->getPhysical());
+  if (physical->expireAfter() == 0) {
+    return false;
+  }
+  auto value = RocksDBValue::Empty(RocksDBEntryType::PrimaryIndexValue);
+  Result r = mthd->Get(_cf, key, value.buffer());
+  return r.ok() && physical->isExpired(RocksDBValue::revisionId(value));
+}
+
 Result RocksDBPrimaryIndex::insertInternal(transaction::Methods* trx,
                                            RocksDBMethods* mthd,
                                            TRI_voc_rid_t revisionId,
@@ -197,7 +301,7 @@ Result RocksDBPrimaryIndex::insertInternal(transaction::Methods* trx,
   auto value = RocksDBValue::PrimaryIndexValue(revisionId);
 
   // acquire rocksdb transaction
-  if (mthd->Exists(_cf, key)) {
+  if (mthd->Exists(_cf, key) && !isExpiredEntry(mthd, key)) {
     return TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED;
   }
 
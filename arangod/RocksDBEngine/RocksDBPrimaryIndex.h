@@ -69,6 +69,8 @@ class RocksDBPrimaryIndexIterator final : public IndexIterator {
   RocksDBPrimaryIndex* _index;
   std::unique_ptr<VPackBuilder> _keys;
   arangodb::velocypack::ArrayIterator _iterator;
+  std::vector<arangodb::StringRef> _batch;
+  std::vector<RocksDBToken> _tokens;
 };
 
 class RocksDBPrimaryIndex final : public RocksDBIndex {
@@ -107,6 +109,12 @@ class RocksDBPrimaryIndex final : public RocksDBIndex {
   RocksDBToken lookupKey(transaction::Methods* trx,
                          arangodb::StringRef key) const;
 
+  /// @brief looks up several keys, using one batched cache lookup for all
+  /// of them. tokens[i] is the result for keys[i]
+  void lookupKeys(transaction::Methods* trx,
+                  std::vector<arangodb::StringRef> const& keys,
+                  std::vector<RocksDBToken>& tokens) const;
+
   bool supportsFilterCondition(arangodb::aql::AstNode const*,
                                arangodb::aql::Variable const*, size_t, size_t&,
                                double&) const override;
@@ -138,6 +146,8 @@ class RocksDBPrimaryIndex final : public RocksDBIndex {
                            rocksdb::Slice const& value) override;
 
  private:
+  bool isExpiredEntry(RocksDBMethods*, RocksDBKey const&) const;
+
   /// @brief create the iterator, for a single attribute, IN operator
   IndexIterator* createInIterator(transaction::Methods*, ManagedDocumentResult*,
                                   arangodb::aql::AstNode const*,
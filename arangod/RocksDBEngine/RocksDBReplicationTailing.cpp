@@ -56,6 +56,8 @@ static TRI_replication_operation_e convertLogType(RocksDBLogType t) {
       return REPLICATION_COLLECTION_RENAME;
     case RocksDBLogType::CollectionChange:
       return REPLICATION_COLLECTION_CHANGE;
+    case RocksDBLogType::CollectionTruncate:
+      return REPLICATION_COLLECTION_TRUNCATE;
     case RocksDBLogType::IndexCreate:
       return REPLICATION_INDEX_CREATE;
     case RocksDBLogType::IndexDrop:
@@ -79,8 +81,7 @@ class WALParser : public rocksdb::WriteBatch::Handler {
  public:
   WALParser(TRI_vocbase_t* vocbase, bool includeSystem,
             TRI_voc_cid_t collectionId, VPackBuilder& builder)
-      : _documentsCF(RocksDBColumnFamily::documents()->GetID()),
-        _definitionsCF(RocksDBColumnFamily::definitions()->GetID()),
+      : _definitionsCF(RocksDBColumnFamily::definitions()->GetID()),
         _vocbase(vocbase),
         _includeSystem(includeSystem),
         _onlyCollectionId(collectionId),
@@ -160,6 +161,25 @@ class WALParser : public rocksdb::WriteBatch::Handler {
         }
         break;
       }
+      case RocksDBLogType::CollectionTruncate: {
+        // the documents are removed by range deletions, which are not
+        // printed. followers truncate their collection on this marker
+        TRI_voc_tick_t dbId = RocksDBLogValue::databaseId(blob);
+        TRI_voc_cid_t cid = RocksDBLogValue::collectionId(blob);
+        if (dbId == _vocbase->id() && shouldHandleCollection(cid)) {
+          _builder.openObject();
+          _builder.add("tick", VPackValue(std::to_string(_currentSequence)));
+          _builder.add("type", VPackValue(convertLogType(type)));
+          _builder.add("database", VPackValue(std::to_string(dbId)));
+          _builder.add("cid", VPackValue(std::to_string(cid)));
+          std::string const& cname = nameFromCid(cid);
+          if (!cname.empty()) {
+            _builder.add("cname", VPackValue(cname));
+          }
+          _builder.close();
+        }
+        break;
+      }
       case RocksDBLogType::ViewCreate: {
         // TODO
         break;
@@ -268,7 +288,7 @@ class WALParser : public rocksdb::WriteBatch::Handler {
       _lastLogType = RocksDBLogType::Invalid;
       _currentDbId = 0;
       _currentCollectionId = 0;
-    } else if (column_family_id == _documentsCF) {
+    } else if (RocksDBColumnFamily::isDocuments(column_family_id)) {
       TRI_ASSERT((_seenBeginTransaction && !_singleOp) ||
                  (!_seenBeginTransaction && _singleOp));
       // if real transaction, we need the trx id
@@ -308,6 +328,14 @@ class WALParser : public rocksdb::WriteBatch::Handler {
     return handleDeletion(column_family_id, key);
   }
 
+  rocksdb::Status DeleteRangeCF(uint32_t, rocksdb::Slice const&,
+                                rocksdb::Slice const&) override {
+    // range deletions are only written by a truncate, which is printed
+    // from its log marker
+    tick();
+    return rocksdb::Status();
+  }
+
   rocksdb::Status handleDeletion(uint32_t column_family_id,
                                  rocksdb::Slice const& key) {
     tick();
@@ -336,7 +364,7 @@ class WALParser : public rocksdb::WriteBatch::Handler {
         _builder.close();
         _builder.close();
       }
-    } else if (column_family_id == _documentsCF) {
+    } else if (RocksDBColumnFamily::isDocuments(column_family_id)) {
       // document removes, because of a drop is not transactional and
       // should not appear in the WAL. Allso fixes
       if (!(_seenBeginTransaction || _singleOp)) {
@@ -437,7 +465,7 @@ class WALParser : public rocksdb::WriteBatch::Handler {
         (RocksDBKey::type(key) == RocksDBEntryType::Collection ||
          RocksDBKey::type(key) == RocksDBEntryType::View)) {
       cid = RocksDBKey::collectionId(key);
-    } else if (column_family_id == _documentsCF) {
+    } else if (RocksDBColumnFamily::isDocuments(column_family_id)) {
       uint64_t objectId = RocksDBKey::objectId(key);
       auto mapping = mapObjectToCollection(objectId);
       if (mapping.first != _vocbase->id()) {
@@ -448,6 +476,10 @@ class WALParser : public rocksdb::WriteBatch::Handler {
       return false;
     }
 
+    return shouldHandleCollection(cid);
+  }
+
+  bool shouldHandleCollection(TRI_voc_cid_t cid) const {
     // only return results for one collection
     if (_onlyCollectionId != 0 && _onlyCollectionId != cid) {
       return false;
@@ -497,7 +529,6 @@ class WALParser : public rocksdb::WriteBatch::Handler {
   }
 
  private:
-  uint32_t const _documentsCF;
   uint32_t const _definitionsCF;
   
   // these parameters are relevant to determine if we can print
@@ -47,6 +47,9 @@ RocksDBRestExportHandler::RocksDBRestExportHandler(GeneralRequest* request,
     : RestVocbaseBaseHandler(request, response), _restrictions() {}
 
 RestStatus RocksDBRestExportHandler::execute() {
+  // exported batches can be big. let the transport compress them
+  _response->setAllowCompression(true);
+
   if (ServerState::instance()->isCoordinator()) {
     generateError(rest::ResponseCode::NOT_IMPLEMENTED,
                   TRI_ERROR_CLUSTER_UNSUPPORTED,
@@ -123,6 +126,13 @@ VPackBuilder RocksDBRestExportHandler::buildOptions(VPackSlice const& slice) {
     options.add("ttl", VPackValue(30));
   }
 
+  VPackSlice readCommitted = slice.get("readCommitted");
+  if (readCommitted.isBool()) {
+    options.add("readCommitted", readCommitted);
+  } else {
+    options.add("readCommitted", VPackValue(false));
+  }
+
   VPackSlice flushWait = slice.get("flushWait");
   if (flushWait.isNumber()) {
     options.add("flushWait", flushWait);
@@ -231,6 +241,8 @@ void RocksDBRestExportHandler::createCursor() {
       options, "ttl", 30);
   bool count = arangodb::basics::VelocyPackHelper::getBooleanValue(
       options, "count", false);
+  bool readCommitted = arangodb::basics::VelocyPackHelper::getBooleanValue(
+      options, "readCommitted", false);
 
   auto cursors = _vocbase->cursorRepository();
   TRI_ASSERT(cursors != nullptr);
@@ -239,7 +251,7 @@ void RocksDBRestExportHandler::createCursor() {
   {
     auto cursor = std::make_unique<RocksDBExportCursor>(
         _vocbase, name, _restrictions, TRI_NewTickServer(), limit, batchSize,
-        ttl, count);
+        ttl, count, readCommitted);
 
     cursor->use();
     c = cursors->addCursor(std::move(cursor));
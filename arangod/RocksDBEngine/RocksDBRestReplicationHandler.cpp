@@ -79,8 +79,37 @@ static int restoreDataParser(char const* ptr, char const* pos,
                              VPackBuilder& builder, VPackSlice& doc,
                              TRI_replication_operation_e& type);
 
+/// @brief whether a marker from the WAL passes the filters of logger-follow.
+/// removals only carry the key and revision of the document, so they pass
+/// any attribute filter
+static bool MatchesFollowFilter(VPackSlice marker, bool documentsOnly,
+                                VPackSlice filter) {
+  int const type = VelocyPackHelper::getNumericValue<int>(marker, "type", 0);
+
+  if (type == REPLICATION_MARKER_REMOVE) {
+    return true;
+  }
+  if (type != REPLICATION_MARKER_DOCUMENT) {
+    return !documentsOnly;
+  }
+  if (!filter.isObject()) {
+    return true;
+  }
+
+  VPackSlice document = marker.get("data");
+  for (auto it : VPackObjectIterator(filter)) {
+    VPackSlice value = document.get(it.key.copyString());
+    if (value.isNone() ||
+        VelocyPackHelper::compare(value, it.value, false) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
 uint64_t const RocksDBRestReplicationHandler::_defaultChunkSize = 128 * 1024;
 uint64_t const RocksDBRestReplicationHandler::_maxChunkSize = 128 * 1024 * 1024;
+double const RocksDBRestReplicationHandler::_maxLoggerFollowWait = 60.0;
 
 RocksDBRestReplicationHandler::RocksDBRestReplicationHandler(
     GeneralRequest* request, GeneralResponse* response)
@@ -119,7 +148,7 @@ RestStatus RocksDBRestReplicationHandler::execute() {
       handleCommandDetermineOpenTransactions();
     } else if (command == "batch") {
       if (ServerState::instance()->isCoordinator()) {
-        handleTrampolineCoordinator();
+        return handleTrampolineCoordinator();
       } else {
         handleCommandBatch();
       }
@@ -128,7 +157,7 @@ RestStatus RocksDBRestReplicationHandler::execute() {
         goto BAD_CALL;
       }
       if (ServerState::instance()->isCoordinator()) {
-        handleTrampolineCoordinator();
+        return handleTrampolineCoordinator();
       } else {
         handleCommandInventory();
       }
@@ -157,8 +186,11 @@ RestStatus RocksDBRestReplicationHandler::execute() {
         goto BAD_CALL;
       }
 
+      // dump chunks are large and compress well
+      _response->setAllowCompression(true);
+
       if (ServerState::instance()->isCoordinator()) {
-        handleTrampolineCoordinator();
+        return handleTrampolineCoordinator();
       } else {
         handleCommandDump();
       }
@@ -471,7 +503,7 @@ void RocksDBRestReplicationHandler::handleCommandBatch() {
 /// @brief forward a command in the coordinator case
 ////////////////////////////////////////////////////////////////////////////////
 
-void RocksDBRestReplicationHandler::handleTrampolineCoordinator() {
+RestStatus RocksDBRestReplicationHandler::handleTrampolineCoordinator() {
   bool useVst = false;
   if (_request->transportType() == Endpoint::TransportType::VST) {
     useVst = true;
@@ -486,7 +518,7 @@ void RocksDBRestReplicationHandler::handleTrampolineCoordinator() {
   if (DBserver.empty()) {
     generateError(rest::ResponseCode::BAD, TRI_ERROR_HTTP_BAD_PARAMETER,
                   "need \"DBserver\" parameter");
-    return;
+    return RestStatus::DONE;
   }
 
   std::string const& dbname = _request->databaseName();
@@ -515,10 +547,11 @@ void RocksDBRestReplicationHandler::handleTrampolineCoordinator() {
     // nullptr happens only during controlled shutdown
     generateError(rest::ResponseCode::BAD, TRI_ERROR_SHUTTING_DOWN,
                   "shutting down server");
-    return;
+    return RestStatus::DONE;
   }
 
-  std::unique_ptr<ClusterCommResult> res;
+  std::shared_ptr<std::string const> body;
+
   if (!useVst) {
     HttpRequest* httpRequest = dynamic_cast<HttpRequest*>(_request.get());
     if (httpRequest == nullptr) {
@@ -526,67 +559,87 @@ void RocksDBRestReplicationHandler::handleTrampolineCoordinator() {
                                      "invalid request type");
     }
 
-    // Send a synchronous request to that shard using ClusterComm:
-    res = cc->syncRequest("", TRI_NewTickServer(), "server:" + DBserver,
-                          _request->requestType(),
-                          "/_db/" + StringUtils::urlEncode(dbname) +
-                              _request->requestPath() + params,
-                          httpRequest->body(), *headers, 300.0);
+    body = std::make_shared<std::string const>(httpRequest->body());
   } else {
     // do we need to handle multiple payloads here - TODO
     // here we switch vorm vst to http?!
     // i am not allowed to change cluster comm!
-    res = cc->syncRequest("", TRI_NewTickServer(), "server:" + DBserver,
-                          _request->requestType(),
-                          "/_db/" + StringUtils::urlEncode(dbname) +
-                              _request->requestPath() + params,
-                          _request->payload().toJson(), *headers, 300.0);
-  }
+    body = std::make_shared<std::string const>(_request->payload().toJson());
+  }
+
+  std::string const destination = "server:" + DBserver;
+  std::string const path = "/_db/" + StringUtils::urlEncode(dbname) +
+                           _request->requestPath() + params;
+  auto const requestType = _request->requestType();
+  auto result = std::make_shared<ClusterCommResult>();
+
+  // do not block a thread while the DBserver is working, the handler
+  // continues as soon as the answer has arrived
+  auto send = [cc, destination, requestType, path, body, headers,
+               result](std::function<void()> next) {
+    auto headerFields =
+        std::make_unique<std::unordered_map<std::string, std::string>>(
+            *headers);
+    auto callback = std::make_shared<ClusterCommFunctionCallback>(
+        [result, next](ClusterCommResult* res) {
+          *result = *res;
+          next();
+        });
+
+    cc->asyncRequest("", TRI_NewTickServer(), destination, requestType, path,
+                     body, headerFields, callback, 300.0, true);
+  };
+
+  auto forward = [this, result, useVst]() {
+    ClusterCommResult const& res = *result;
+
+    if (res.status == CL_COMM_TIMEOUT) {
+      // No reply, we give up:
+      generateError(rest::ResponseCode::BAD, TRI_ERROR_CLUSTER_TIMEOUT,
+                    "timeout within cluster");
+      return;
+    }
+    if (res.status == CL_COMM_BACKEND_UNAVAILABLE) {
+      // there is no result
+      generateError(rest::ResponseCode::BAD, TRI_ERROR_CLUSTER_CONNECTION_LOST,
+                    "lost connection within cluster");
+      return;
+    }
+    if (res.status == CL_COMM_ERROR) {
+      // This could be a broken connection or an Http error:
+      TRI_ASSERT(nullptr != res.result && res.result->isComplete());
+      // In this case a proper HTTP error was reported by the DBserver,
+      // we simply forward the result.
+      // We intentionally fall through here.
+    }
 
-  if (res->status == CL_COMM_TIMEOUT) {
-    // No reply, we give up:
-    generateError(rest::ResponseCode::BAD, TRI_ERROR_CLUSTER_TIMEOUT,
-                  "timeout within cluster");
-    return;
-  }
-  if (res->status == CL_COMM_BACKEND_UNAVAILABLE) {
-    // there is no result
-    generateError(rest::ResponseCode::BAD, TRI_ERROR_CLUSTER_CONNECTION_LOST,
-                  "lost connection within cluster");
-    return;
-  }
-  if (res->status == CL_COMM_ERROR) {
-    // This could be a broken connection or an Http error:
-    TRI_ASSERT(nullptr != res->result && res->result->isComplete());
-    // In this case a proper HTTP error was reported by the DBserver,
-    // we simply forward the result.
-    // We intentionally fall through here.
-  }
+    bool dummy;
+    resetResponse(
+        static_cast<rest::ResponseCode>(res.result->getHttpReturnCode()));
 
-  bool dummy;
-  resetResponse(
-      static_cast<rest::ResponseCode>(res->result->getHttpReturnCode()));
+    _response->setContentType(
+        res.result->getHeaderField(StaticStrings::ContentTypeHeader, dummy));
 
-  _response->setContentType(
-      res->result->getHeaderField(StaticStrings::ContentTypeHeader, dummy));
+    if (!useVst) {
+      HttpResponse* httpResponse = dynamic_cast<HttpResponse*>(_response.get());
+      if (_response == nullptr) {
+        THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL,
+                                       "invalid response type");
+      }
+      httpResponse->body().swap(&(res.result->getBody()));
+    } else {
+      // TODO copy all payloads
+      VPackSlice slice = res.result->getBodyVelocyPack()->slice();
+      _response->setPayload(slice, true);  // do we need to generate the body?!
+    }
 
-  if (!useVst) {
-    HttpResponse* httpResponse = dynamic_cast<HttpResponse*>(_response.get());
-    if (_response == nullptr) {
-      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL,
-                                     "invalid response type");
+    auto const& resultHeaders = res.result->getHeaderFields();
+    for (auto const& it : resultHeaders) {
+      _response->setHeader(it.first, it.second);
     }
-    httpResponse->body().swap(&(res->result->getBody()));
-  } else {
-    // TODO copy all payloads
-    VPackSlice slice = res->result->getBodyVelocyPack()->slice();
-    _response->setPayload(slice, true);  // do we need to generate the body?!
-  }
+  };
 
-  auto const& resultHeaders = res->result->getHeaderFields();
-  for (auto const& it : resultHeaders) {
-    _response->setHeader(it.first, it.second);
-  }
+  return RestStatus::WAIT_FOR(send).then(forward).done();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -651,6 +704,42 @@ void RocksDBRestReplicationHandler::handleCommandLoggerFollow() {
     cid = c->cid();
   }
 
+  // only return document operations
+  bool documentsOnly = false;
+  std::string const& value7 = _request->value("documentsOnly", found);
+  if (found) {
+    documentsOnly = StringUtils::boolean(value7);
+  }
+
+  // only return documents in which all attributes of the filter object have
+  // the given values
+  std::shared_ptr<VPackBuilder> filter;
+  std::string const& value8 = _request->value("filter", found);
+  if (found) {
+    try {
+      filter = VPackParser::fromJson(value8);
+    } catch (...) {
+    }
+    if (filter == nullptr || !filter->slice().isObject()) {
+      generateError(rest::ResponseCode::BAD, TRI_ERROR_HTTP_BAD_PARAMETER,
+                    "invalid filter value");
+      return;
+    }
+  }
+
+  // wait up to the given number of seconds for new WAL entries, so that
+  // clients following the changes need not poll
+  std::string const& value9 = _request->value("wait", found);
+  if (found) {
+    double const waitTime = (std::min)(StringUtils::doubleDecimal(value9),
+                                       _maxLoggerFollowWait);
+    double const end = TRI_microtime() + waitTime;
+    while (latestSequenceNumber() <= tickStart && TRI_microtime() < end &&
+           !application_features::ApplicationServer::isStopping()) {
+      usleep(50 * 1000);
+    }
+  }
+
   std::shared_ptr<transaction::Context> transactionContext =
       transaction::StandaloneContext::Create(_vocbase);
 
@@ -660,6 +749,23 @@ void RocksDBRestReplicationHandler::handleCommandLoggerFollow() {
                         cid, builder);
   builder.close();
   auto data = builder.slice();
+  // the last included tick covers the markers removed by the filters too,
+  // so that clients continue after them
+  size_t const unfilteredLength = data.length();
+
+  VPackBuilder filtered(transactionContext->getVPackOptions());
+  if (documentsOnly || filter != nullptr) {
+    VPackSlice filterSlice =
+        (filter == nullptr) ? VPackSlice::noneSlice() : filter->slice();
+    filtered.openArray();
+    for (auto marker : VPackArrayIterator(data)) {
+      if (MatchesFollowFilter(marker, documentsOnly, filterSlice)) {
+        filtered.add(marker);
+      }
+    }
+    filtered.close();
+    data = filtered.slice();
+  }
 
   uint64_t const latest = latestSequenceNumber();
 
@@ -688,7 +794,7 @@ void RocksDBRestReplicationHandler::handleCommandLoggerFollow() {
                          checkMore ? "true" : "false");
   _response->setHeaderNC(
       TRI_REPLICATION_HEADER_LASTINCLUDED,
-      StringUtils::itoa((length == 0) ? 0 : result.maxTick()));
+      StringUtils::itoa((unfilteredLength == 0) ? 0 : result.maxTick()));
   _response->setHeaderNC(TRI_REPLICATION_HEADER_LASTTICK,
                          StringUtils::itoa(latest));
   _response->setHeaderNC(TRI_REPLICATION_HEADER_ACTIVE, "true");
@@ -1412,6 +1518,10 @@ void RocksDBRestReplicationHandler::handleCommandMakeSlave() {
       body, "sslProtocol", defaults._sslProtocol);
   config._chunkSize = VelocyPackHelper::getNumericValue<uint64_t>(
       body, "chunkSize", defaults._chunkSize);
+  config._initialSyncParallelism = VelocyPackHelper::getNumericValue<uint64_t>(
+      body, "initialSyncParallelism", defaults._initialSyncParallelism);
+  config._applyParallelism = VelocyPackHelper::getNumericValue<uint64_t>(
+      body, "applyParallelism", defaults._applyParallelism);
   config._autoStart = true;
   config._adaptivePolling = VelocyPackHelper::getBooleanValue(
       body, "adaptivePolling", defaults._adaptivePolling);
@@ -1605,6 +1715,8 @@ void RocksDBRestReplicationHandler::handleCommandSync() {
   config._includeSystem = includeSystem;
   config._verbose = verbose;
   config._useCollectionId = useCollectionId;
+  config._initialSyncParallelism = VelocyPackHelper::getNumericValue<uint64_t>(
+      body, "initialSyncParallelism", config._initialSyncParallelism);
 
   InitialSyncer syncer(_vocbase, &config, restrictCollections, restrictType,
                        verbose, false);
@@ -1731,6 +1843,10 @@ void RocksDBRestReplicationHandler::handleCommandApplierSetConfig() {
       body, "sslProtocol", config._sslProtocol);
   config._chunkSize = VelocyPackHelper::getNumericValue<uint64_t>(
       body, "chunkSize", config._chunkSize);
+  config._initialSyncParallelism = VelocyPackHelper::getNumericValue<uint64_t>(
+      body, "initialSyncParallelism", config._initialSyncParallelism);
+  config._applyParallelism = VelocyPackHelper::getNumericValue<uint64_t>(
+      body, "applyParallelism", config._applyParallelism);
   config._autoStart =
       VelocyPackHelper::getBooleanValue(body, "autoStart", config._autoStart);
   config._adaptivePolling = VelocyPackHelper::getBooleanValue(
@@ -53,6 +53,7 @@ class RocksDBRestReplicationHandler : public RestVocbaseBaseHandler {
   char const* name() const override final {
     return "RocksDBRestReplicationHandler";
   }
+  size_t queue() const override { return JobQueue::BACKGROUND_QUEUE; }
 
  private:
   //////////////////////////////////////////////////////////////////////////////
@@ -102,7 +103,7 @@ class RocksDBRestReplicationHandler : public RestVocbaseBaseHandler {
   /// @brief forward a command in the coordinator case
   //////////////////////////////////////////////////////////////////////////////
 
-  void handleTrampolineCoordinator();
+  RestStatus handleTrampolineCoordinator();
 
   //////////////////////////////////////////////////////////////////////////////
   /// @brief return the inventory (current replication and collection state)
@@ -314,6 +315,12 @@ class RocksDBRestReplicationHandler : public RestVocbaseBaseHandler {
 
   static uint64_t const _maxChunkSize;
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief maximum number of seconds logger-follow waits for new entries
+  //////////////////////////////////////////////////////////////////////////////
+
+  static double const _maxLoggerFollowWait;
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief condition locker to wake up holdReadLockCollection jobs
   //////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RocksDBSyncThread.h"
+#include "Basics/ConditionLocker.h"
+#include "Logger/Logger.h"
+#include "RocksDBEngine/RocksDBCommon.h"
+#include "RocksDBEngine/RocksDBEngine.h"
+
+using namespace arangodb;
+
+RocksDBSyncThread::RocksDBSyncThread(RocksDBEngine* engine, double maxDelay,
+                                     size_t batchSize)
+    : Thread("RocksDBSync"),
+      _engine(engine),
+      _maxDelay(maxDelay),
+      _batchSize((std::max)(batchSize, static_cast<size_t>(1))),
+      _waiting(0),
+      _syncedSeq(0),
+      _rounds(0),
+      _numSyncs(0),
+      _numSyncedCommits(0) {}
+
+RocksDBSyncThread::~RocksDBSyncThread() { shutdown(); }
+
+void RocksDBSyncThread::beginShutdown() {
+  Thread::beginShutdown();
+
+  // wake up the thread and all transactions waiting for it
+  CONDITION_LOCKER(guard, _condition);
+  guard.broadcast();
+}
+
+Result RocksDBSyncThread::waitForSync(rocksdb::SequenceNumber seq) {
+  {
+    CONDITION_LOCKER(guard, _condition);
+
+    uint64_t const startRound = _rounds;
+    ++_waiting;
+    // wake up the syncer, it decides itself whether the group is complete
+    guard.broadcast();
+
+    while (!isStopping()) {
+      if (_syncedSeq >= seq) {
+        --_waiting;
+        ++_numSyncedCommits;
+        return Result();
+      }
+      if (_rounds != startRound && _lastResult.fail()) {
+        // a sync we have been waiting for failed
+        --_waiting;
+        return _lastResult;
+      }
+      guard.wait();
+    }
+    --_waiting;
+  }
+
+  // the sync thread is going away, so sync ourselves
+  return _engine->syncWal();
+}
+
+uint64_t RocksDBSyncThread::numSyncs() const {
+  CONDITION_LOCKER(guard, _condition);
+  return _numSyncs;
+}
+
+uint64_t RocksDBSyncThread::numSyncedCommits() const {
+  CONDITION_LOCKER(guard, _condition);
+  return _numSyncedCommits;
+}
+
+void RocksDBSyncThread::run() {
+  while (!isStopping()) {
+    {
+      CONDITION_LOCKER(guard, _condition);
+      while (_waiting == 0 && !isStopping()) {
+        guard.wait(100000);
+      }
+
+      // keep the group open for further transactions until it is full
+      // or the maximum delay has passed
+      double const end = TRI_microtime() + _maxDelay;
+      while (_waiting < _batchSize && !isStopping()) {
+        double const remaining = end - TRI_microtime();
+        if (remaining <= 0.0) {
+          break;
+        }
+        guard.wait(static_cast<uint64_t>(remaining * 1000000.0));
+      }
+
+      if (isStopping()) {
+        break;
+      }
+    }
+
+    // everything up to this sequence number is in the WAL already, so
+    // one sync covers all transactions that are currently waiting
+    rocksdb::SequenceNumber seq = rocksutils::latestSequenceNumber();
+    Result res = _engine->syncWal();
+
+    if (res.fail()) {
+      LOG_TOPIC(WARN, Logger::ENGINES)
+          << "could not sync rocksdb WAL: " << res.errorMessage();
+    }
+
+    CONDITION_LOCKER(guard, _condition);
+    ++_rounds;
+    _lastResult = res;
+    if (res.ok()) {
+      ++_numSyncs;
+      if (seq > _syncedSeq) {
+        _syncedSeq = seq;
+      }
+    }
+    guard.broadcast();
+  }
+}
@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_ROCKSDB_ENGINE_SYNC_THREAD_H
+#define ARANGOD_ROCKSDB_ENGINE_SYNC_THREAD_H 1
+
+#include "Basics/Common.h"
+#include "Basics/ConditionVariable.h"
+#include "Basics/Result.h"
+#include "Basics/Thread.h"
+
+#include <rocksdb/types.h>
+
+namespace arangodb {
+
+class RocksDBEngine;
+
+/// @brief group commit for transactions that need to wait for sync.
+/// committing transactions write their data to the WAL without syncing it
+/// and then wait here, while this thread collects them and syncs the WAL
+/// once for the whole group
+class RocksDBSyncThread : public Thread {
+ public:
+  /// @brief maxDelay is the maximum time (in seconds) a group is held open
+  /// for further transactions to join, batchSize the number of waiting
+  /// transactions after which the WAL is synced immediately
+  RocksDBSyncThread(RocksDBEngine* engine, double maxDelay, size_t batchSize);
+  ~RocksDBSyncThread();
+
+  void beginShutdown() override;
+
+  /// @brief block until the WAL has been synced up to at least the given
+  /// sequence number
+  Result waitForSync(rocksdb::SequenceNumber seq);
+
+  /// @brief number of WAL syncs performed
+  uint64_t numSyncs() const;
+
+  /// @brief number of commits that were made durable by these syncs
+  uint64_t numSyncedCommits() const;
+
+ protected:
+  void run() override;
+
+ private:
+  RocksDBEngine* _engine;
+
+  double const _maxDelay;
+
+  size_t const _batchSize;
+
+  /// @brief protects all members below, and is used for signaling both
+  /// this thread and the waiting transactions
+  mutable arangodb::basics::ConditionVariable _condition;
+
+  /// @brief number of transactions currently waiting for a sync
+  size_t _waiting;
+
+  /// @brief sequence number up to which the WAL is known to be synced
+  rocksdb::SequenceNumber _syncedSeq;
+
+  /// @brief number of sync rounds completed, and the result of the last one
+  uint64_t _rounds;
+  Result _lastResult;
+
+  uint64_t _numSyncs;
+  uint64_t _numSyncedCommits;
+};
+}  // namespace arangodb
+
+#endif
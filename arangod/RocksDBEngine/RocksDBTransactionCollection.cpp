@@ -265,7 +265,8 @@ void RocksDBTransactionCollection::addOperation(
 }
 
 void RocksDBTransactionCollection::commitCounts() {
-  _initialNumberDocuments = _numInserts - _numRemoves;
+  // the committed operations are part of the count from now on
+  _initialNumberDocuments += _numInserts - _numRemoves;
   _operationSize = 0;
   _numInserts = 0;
   _numUpdates = 0;
@@ -59,12 +59,19 @@ class RocksDBTransactionCollection final : public TransactionCollection {
   /// @brief check whether a collection is locked at all
   bool isLocked() const override;
 
+  /// @brief check whether the collection is locked exclusively
+  bool isLockedExclusive() const {
+    return AccessMode::isExclusive(_lockType);
+  }
+
   /// @brief whether or not any write operations for the collection happened
   bool hasOperations() const override;
 
   void freeOperations(transaction::Methods* activeTrx,
                       bool mustRollback) override;
 
+  AccessMode::Type accessType() const override { return _accessType; }
+
   bool canAccess(AccessMode::Type accessType) const override;
   int updateUsage(AccessMode::Type accessType, int nestingLevel) override;
   int use(int nestingLevel) override;
@@ -82,6 +89,8 @@ class RocksDBTransactionCollection final : public TransactionCollection {
   /// @brief add an operation for a transaction collection
   void addOperation(TRI_voc_document_operation_e operationType,
                     uint64_t operationSize, TRI_voc_rid_t revisionId);
+  /// @brief adds the operations counted so far to the initial number of
+  /// documents and resets the counters, after an intermediate commit
   void commitCounts();
 
  private:
@@ -22,19 +22,20 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "RocksDBTransactionState.h"
-#include "Aql/QueryCache.h"
 #include "Basics/Exceptions.h"
 #include "Cache/CacheManagerFeature.h"
 #include "Cache/Manager.h"
 #include "Cache/Transaction.h"
 #include "Logger/Logger.h"
 #include "RestServer/TransactionManagerFeature.h"
+#include "RocksDBEngine/RocksDBBulkLoadMethods.h"
 #include "RocksDBEngine/RocksDBCollection.h"
 #include "RocksDBEngine/RocksDBCommon.h"
 #include "RocksDBEngine/RocksDBCounterManager.h"
 #include "RocksDBEngine/RocksDBEngine.h"
 #include "RocksDBEngine/RocksDBLogValue.h"
 #include "RocksDBEngine/RocksDBMethods.h"
+#include "RocksDBEngine/RocksDBSyncThread.h"
 #include "RocksDBEngine/RocksDBTransactionCollection.h"
 #include "StorageEngine/EngineSelectorFeature.h"
 #include "StorageEngine/StorageEngine.h"
@@ -68,6 +69,7 @@ RocksDBTransactionState::RocksDBTransactionState(
       _numInserts(0),
       _numUpdates(0),
       _numRemoves(0),
+      _numIntermediateCommits(0),
       _lastUsedCollection(0) {}
 
 /// @brief free a transaction container
@@ -96,6 +98,12 @@ Result RocksDBTransactionState::beginTransaction(transaction::Hints hints) {
 
   Result result = useCollections(_nestingLevel);
 
+  if (result.ok() && _nestingLevel == 0 &&
+      hasHint(transaction::Hints::Hint::BULK_LOAD)) {
+    // the collections are locked now, so their state cannot change anymore
+    result = RocksDBBulkLoadMethods::checkPreconditions(this);
+  }
+
   if (result.ok()) {
     // all valid
     if (_nestingLevel == 0) {
@@ -150,7 +158,18 @@ Result RocksDBTransactionState::beginTransaction(transaction::Hints hints) {
       } else {
         _rocksReadOptions.snapshot = _rocksTransaction->GetSnapshot();
       }
-      _rocksMethods.reset(new RocksDBTrxMethods(this));
+      if (hasHint(transaction::Hints::Hint::BULK_LOAD)) {
+        // the rocksdb transaction only carries the log markers then
+        RocksDBEngine* engine =
+            static_cast<RocksDBEngine*>(EngineSelectorFeature::ENGINE);
+        _rocksMethods.reset(new RocksDBBulkLoadMethods(
+            this,
+            engine->bulkLoadPath() + TRI_DIR_SEPARATOR_STR +
+                std::to_string(_id),
+            engine->bulkLoadMemory()));
+      } else {
+        _rocksMethods.reset(new RocksDBTrxMethods(this));
+      }
     }
 
   } else {
@@ -161,13 +180,21 @@ Result RocksDBTransactionState::beginTransaction(transaction::Hints hints) {
 }
 
 void RocksDBTransactionState::createTransaction() {
-  TRI_ASSERT(!_rocksTransaction);
-  // TODO intermediates
-
-  // start rocks transaction
+  // start rocks transaction. after an intermediate commit the handle of the
+  // committed transaction is reused, which keeps its allocations
   rocksdb::TransactionDB* db = rocksutils::globalRocksDB();
-  _rocksTransaction.reset(
-      db->BeginTransaction(_rocksWriteOptions, rocksdb::TransactionOptions()));
+  rocksdb::TransactionOptions trxOpts;
+  if (_options.optimistic) {
+    // writes are validated against our snapshot anyway, so waiting for the
+    // lock of another writer can only end in a conflict. fail right away
+    // and leave it to the caller to retry
+    trxOpts.lock_timeout = 0;
+  }
+  rocksdb::Transaction* trx =
+      db->BeginTransaction(_rocksWriteOptions, trxOpts, _rocksTransaction.get());
+  if (trx != _rocksTransaction.get()) {
+    _rocksTransaction.reset(trx);
+  }
   _rocksTransaction->SetSnapshot();
   if (!hasHint(transaction::Hints::Hint::SINGLE_OPERATION)) {
     RocksDBLogValue header =
@@ -183,15 +210,32 @@ arangodb::Result RocksDBTransactionState::internalCommit() {
   TRI_ASSERT(_rocksTransaction != nullptr);
 
   arangodb::Result result;
-  if (_rocksTransaction->GetNumKeys() > 0) {
+  bool const bulkLoad = hasHint(transaction::Hints::Hint::BULK_LOAD);
+  if (_rocksTransaction->GetNumKeys() > 0 || (bulkLoad && hasOperations())) {
+    RocksDBEngine* engine =
+        static_cast<RocksDBEngine*>(EngineSelectorFeature::ENGINE);
+    // with group commit, the WAL is synced after the commit together with
+    // other transactions. ingested files are synced by rocksdb itself
+    RocksDBSyncThread* syncThread =
+        (waitForSync() && !bulkLoad) ? engine->syncThread() : nullptr;
+
     // set wait for sync flag if required
-    if (waitForSync()) {
+    if (waitForSync() && syncThread == nullptr && !bulkLoad) {
       _rocksWriteOptions.sync = true;
       _rocksTransaction->SetWriteOptions(_rocksWriteOptions);
     }
 
-    // double t1 = TRI_microtime();
-    result = rocksutils::convertStatus(_rocksTransaction->Commit());
+    if (bulkLoad) {
+      result =
+          static_cast<RocksDBBulkLoadMethods*>(_rocksMethods.get())->ingest();
+      if (result.ok()) {
+        // the log markers describe data that never went through the WAL
+        result = rocksutils::convertStatus(_rocksTransaction->Rollback());
+      }
+    } else {
+      // double t1 = TRI_microtime();
+      result = rocksutils::convertStatus(_rocksTransaction->Commit());
+    }
     // double t2 = TRI_microtime();
     // if (t2 - t1 > 0.25) {
     //   LOG_TOPIC(ERR, Logger::FIXME)
@@ -224,18 +268,20 @@ arangodb::Result RocksDBTransactionState::internalCommit() {
             trxCollection->collection()->getPhysical());
         coll->adjustNumberDocuments(adjustment);
         coll->setRevision(collection->revision());
-        RocksDBEngine* engine =
-            static_cast<RocksDBEngine*>(EngineSelectorFeature::ENGINE);
 
         RocksDBCounterManager::CounterAdjustment update(
             latestSeq, collection->numInserts(), collection->numRemoves(),
             collection->revision());
         engine->counterManager()->updateCounter(coll->objectId(), update);
       }
+    }
 
-      // we need this in case of an intermediate commit. The number of
-      // initial documents is adjusted and numInserts / removes is set to 0
-      collection->commitCounts();
+    if (bulkLoad) {
+      // the loaded data cannot be recovered from the WAL, so the counters
+      // must be persisted right away
+      engine->counterManager()->sync(true);
+    } else if (syncThread != nullptr) {
+      result = syncThread->waitForSync(latestSeq);
     }
   } else {
     // don't write anything if the transaction is empty
@@ -248,7 +294,59 @@ arangodb::Result RocksDBTransactionState::internalCommit() {
     }
   }
 
-  _rocksTransaction.reset();
+  return result;
+}
+
+/// @brief commit the operations done so far and continue in a new rocksdb
+/// transaction. the collections stay in use and locked. reads move to a
+/// snapshot taken after the commit, so that they see the committed part of
+/// the transaction. iterators keep reading from the state they were created
+/// with
+arangodb::Result RocksDBTransactionState::intermediateCommit() {
+  TRI_ASSERT(!hasHint(transaction::Hints::Hint::BULK_LOAD));
+
+  arangodb::Result result = internalCommit();
+  if (!result.ok()) {
+    return result;
+  }
+  // the committed part stays even if the transaction aborts later, so the
+  // aggregate views must see it now
+  applyViewChanges();
+  ++_numIntermediateCommits;
+
+  // the committed operations become part of the collections' counts, the
+  // operations counted from now on are those of the new rocksdb transaction
+  for (auto& trxCollection : _collections) {
+    static_cast<RocksDBTransactionCollection*>(trxCollection)->commitCounts();
+  }
+
+  _numInserts = 0;
+  _numUpdates = 0;
+  _numRemoves = 0;
+#ifdef ARANGODB_ENABLE_MAINTAINER_MODE
+  _numLogdata = 0;
+#endif
+  // the next operation must write the prologue for its collection into the
+  // WAL entry of the new transaction
+  _lastUsedCollection = 0;
+
+  if (_cacheTx == nullptr) {
+    _cacheTx = CacheManagerFeature::MANAGER->beginTransaction(false);
+  }
+
+  createTransaction();
+  if (hasHint(transaction::Hints::Hint::READ_WRITES)) {
+    // the snapshot of the committed transaction is gone
+    _rocksReadOptions.snapshot = _rocksTransaction->GetSnapshot();
+  } else {
+    // the old snapshot does not contain the committed writes
+    rocksdb::TransactionDB* db = rocksutils::globalRocksDB();
+    rocksdb::Snapshot const* old = _snapshot;
+    _snapshot = db->GetSnapshot();
+    _rocksReadOptions.snapshot = _snapshot;
+    db->ReleaseSnapshot(old);
+  }
+
   return result;
 }
 
@@ -269,9 +367,14 @@ Result RocksDBTransactionState::commitTransaction(
       res = internalCommit();
       if (!res.ok()) {
         abortTransaction(activeTrx);
+      } else {
+        _rocksTransaction.reset();
       }
     }
     updateStatus(transaction::Status::COMMITTED);
+    if (res.ok()) {
+      applyViewChanges();
+    }
   }
 
   unuseCollections(_nestingLevel);
@@ -385,7 +488,7 @@ void RocksDBTransactionState::prepareOperation(
 RocksDBOperationResult RocksDBTransactionState::addOperation(
     TRI_voc_cid_t cid, TRI_voc_rid_t revisionId,
     TRI_voc_document_operation_e operationType, uint64_t operationSize,
-    uint64_t keySize) {
+    uint64_t keySize, StringRef const& key, bool intermediateCommit) {
   RocksDBOperationResult res;
 
   size_t currentSize =
@@ -412,11 +515,8 @@ RocksDBOperationResult RocksDBTransactionState::addOperation(
   // should not fail or fail with exception
   collection->addOperation(operationType, operationSize, revisionId);
 
-  // clear the query cache for this collection
-  if (arangodb::aql::QueryCache::instance()->mayBeActive()) {
-    arangodb::aql::QueryCache::instance()->invalidate(
-        _vocbase, collection->collectionName());
-  }
+  // clear the query cache results depending on the document
+  invalidateQueryCache(collection->collectionName(), key);
 
   switch (operationType) {
     case TRI_VOC_DOCUMENT_OPERATION_UNKNOWN:
@@ -433,21 +533,31 @@ RocksDBOperationResult RocksDBTransactionState::addOperation(
       break;
   }
 
+  if (intermediateCommit) {
+    res = checkIntermediateCommit(newSize - currentSize);
+  }
+  return res;
+}
+
+/// @brief performs an intermediate commit if a limit is reached
+RocksDBOperationResult RocksDBTransactionState::checkIntermediateCommit(
+    uint64_t newSize) {
+  RocksDBOperationResult res;
+
   auto numOperations = _numInserts + _numUpdates + _numRemoves;
+  uint64_t size =
+      _rocksTransaction->GetWriteBatch()->GetWriteBatch()->GetDataSize() +
+      newSize;
   // perform an intermediate commit
   // this will be done if either the "number of operations" or the
   // "transaction size" counters have reached their limit
-  if (_options.intermediateCommitCount <= numOperations ||
-      _options.intermediateCommitSize <= newSize) {
-    // LOG_TOPIC(ERR, Logger::FIXME) << "INTERMEDIATE COMMIT!";
-    internalCommit();
-    _numInserts = 0;
-    _numUpdates = 0;
-    _numRemoves = 0;
-#ifdef ARANGODB_ENABLE_MAINTAINER_MODE
-    _numLogdata = 0;
-#endif
-    createTransaction();
+  // a bulk load never commits intermediately, as its data is ingested
+  // only at the end. an optimistic transaction never does either, so that
+  // it can be retried after a conflict
+  if (!hasHint(transaction::Hints::Hint::BULK_LOAD) && !_options.optimistic &&
+      (_options.intermediateCommitCount <= numOperations ||
+       _options.intermediateCommitSize <= size)) {
+    res.reset(intermediateCommit());
   }
 
   return res;
@@ -458,6 +568,15 @@ RocksDBMethods* RocksDBTransactionState::rocksdbMethods() {
   return _rocksMethods.get();
 }
 
+void RocksDBTransactionState::refreshSnapshot() {
+  TRI_ASSERT(canRefreshSnapshot());
+  rocksdb::TransactionDB* db = rocksutils::globalRocksDB();
+  rocksdb::Snapshot const* old = _snapshot;
+  _snapshot = db->GetSnapshot();
+  _rocksReadOptions.snapshot = _snapshot;
+  db->ReleaseSnapshot(old);
+}
+
 uint64_t RocksDBTransactionState::sequenceNumber() const {
   if (_snapshot != nullptr) {
     return static_cast<uint64_t>(_snapshot->GetSequenceNumber());
@@ -93,20 +93,52 @@ class RocksDBTransactionState final : public TransactionState {
     return (_status == transaction::Status::ABORTED) && hasOperations();
   }
 
+  bool hasIntermediateCommits() const override {
+    return _numIntermediateCommits > 0;
+  }
+
   void prepareOperation(TRI_voc_cid_t collectionId, TRI_voc_rid_t revisionId,
                         StringRef const& key,
                         TRI_voc_document_operation_e operationType);
 
-  /// @brief add an operation for a transaction collection
+  /// @brief add an operation for a transaction collection. the key of the
+  /// modified document is used to invalidate dependent query cache results.
+  /// an empty key invalidates all results for the collection. without
+  /// intermediateCommit, the caller adds a batch of operations and calls
+  /// checkIntermediateCommit after the last of them
   RocksDBOperationResult addOperation(
       TRI_voc_cid_t collectionId, TRI_voc_rid_t revisionId,
       TRI_voc_document_operation_e operationType, uint64_t operationSize,
-      uint64_t keySize);
+      uint64_t keySize, StringRef const& key = StringRef(),
+      bool intermediateCommit = true);
+
+  /// @brief performs an intermediate commit if the number of operations or
+  /// the size of the transaction (including newSize bytes about to be
+  /// added) have reached their limits
+  RocksDBOperationResult checkIntermediateCommit(uint64_t newSize);
 
   RocksDBMethods* rocksdbMethods();
 
   uint64_t sequenceNumber() const;
 
+  /// @brief whether this is a read only transaction, which reads straight
+  /// from a snapshot of the database that other threads can read as well
+  bool readsFromSnapshot() const {
+    return _snapshot != nullptr && isReadOnlyTransaction();
+  }
+
+  /// @brief whether this is a read committed read only transaction, which
+  /// may move on to newer snapshots
+  bool canRefreshSnapshot() const {
+    return _snapshot != nullptr && isReadOnlyTransaction() &&
+           _options.readCommitted;
+  }
+
+  /// @brief moves a read committed transaction to a new snapshot, so that
+  /// rocksdb can drop the versions overwritten since the old one was taken.
+  /// iterators keep reading from the state they were created with
+  void refreshSnapshot();
+
   static RocksDBTransactionState* toState(transaction::Methods* trx) {
     TRI_ASSERT(trx != nullptr);
     TransactionState* state = trx->state();
@@ -124,6 +156,7 @@ class RocksDBTransactionState final : public TransactionState {
  private:
   void createTransaction();
   arangodb::Result internalCommit();
+  arangodb::Result intermediateCommit();
 
  private:
   /// rocksdb transaction may be null
@@ -145,6 +178,9 @@ class RocksDBTransactionState final : public TransactionState {
   uint64_t _numUpdates;
   uint64_t _numRemoves;
 
+  /// number of intermediate commits done so far
+  uint64_t _numIntermediateCommits;
+
   /// Last collection used for transaction
   TRI_voc_cid_t _lastUsedCollection;
 #ifdef ARANGODB_ENABLE_MAINTAINER_MODE
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RocksDBTtl.h"
+#include "Basics/HybridLogicalClock.h"
+#include "Basics/MutexLocker.h"
+#include "Basics/ReadLocker.h"
+#include "Basics/ReadWriteLock.h"
+#include "Basics/WriteLocker.h"
+#include "RocksDBEngine/RocksDBColumnFamily.h"
+#include "RocksDBEngine/RocksDBCommon.h"
+#include "RocksDBEngine/RocksDBKey.h"
+#include "RocksDBEngine/RocksDBTypes.h"
+#include "RocksDBEngine/RocksDBValue.h"
+
+using namespace arangodb;
+
+static basics::ReadWriteLock TtlLock;
+static std::unordered_map<uint64_t, uint64_t> TtlObjects;
+/// @brief number of registered objects, checked before taking the lock so
+/// that compactions of databases without expiring collections stay cheap
+static std::atomic<size_t> NumTtlObjects(0);
+
+static Mutex RemovalsLock;
+static std::unordered_map<uint64_t, uint64_t> Removals;
+
+void RocksDBTtl::add(uint64_t objectId, uint64_t expireAfter) {
+  TRI_ASSERT(objectId != 0);
+  TRI_ASSERT(expireAfter > 0);
+  WRITE_LOCKER(guard, TtlLock);
+  TtlObjects[objectId] = expireAfter;
+  NumTtlObjects.store(TtlObjects.size());
+}
+
+void RocksDBTtl::remove(uint64_t objectId) {
+  WRITE_LOCKER(guard, TtlLock);
+  TtlObjects.erase(objectId);
+  NumTtlObjects.store(TtlObjects.size());
+}
+
+uint64_t RocksDBTtl::expireAfter(uint64_t objectId) {
+  if (NumTtlObjects.load(std::memory_order_relaxed) == 0) {
+    return 0;
+  }
+  READ_LOCKER(guard, TtlLock);
+  auto it = TtlObjects.find(objectId);
+  if (it == TtlObjects.end()) {
+    return 0;
+  }
+  return it->second;
+}
+
+bool RocksDBTtl::isExpired(TRI_voc_rid_t revisionId, uint64_t expireAfter) {
+  uint64_t const written =
+      basics::HybridLogicalClock::extractTime(revisionId);
+  uint64_t const now = static_cast<uint64_t>(TRI_microtime() * 1000.0);
+  return written + expireAfter * 1000 <= now;
+}
+
+std::unordered_map<uint64_t, uint64_t> RocksDBTtl::stealRemovals() {
+  std::unordered_map<uint64_t, uint64_t> result;
+  MUTEX_LOCKER(guard, RemovalsLock);
+  result.swap(Removals);
+  return result;
+}
+
+void RocksDBTtl::countRemoval(uint64_t objectId) {
+  MUTEX_LOCKER(guard, RemovalsLock);
+  ++Removals[objectId];
+}
+
+/// @brief looks the document entry up in the database. the entry being
+/// compacted is still visible until the compaction finishes, unless a newer
+/// tombstone hides it
+static bool IsLiveDocument(uint64_t objectId, rocksdb::Slice const& key) {
+  rocksdb::TransactionDB* db = rocksutils::globalRocksDB();
+  if (db == nullptr) {
+    return false;
+  }
+  rocksdb::ReadOptions options;
+  options.fill_cache = false;
+  std::string value;
+  return db->GetBaseDB()
+      ->Get(options, RocksDBColumnFamily::documents(objectId), key, &value)
+      .ok();
+}
+
+RocksDBTtlCompactionFilter::RocksDBTtlCompactionFilter(bool documents)
+    : _documents(documents), _isLive(IsLiveDocument) {}
+
+bool RocksDBTtlCompactionFilter::Filter(int, rocksdb::Slice const& key,
+                                        rocksdb::Slice const& existingValue,
+                                        std::string*, bool*) const {
+  uint64_t const objectId = RocksDBKey::objectId(key);
+  uint64_t const expireAfter = RocksDBTtl::expireAfter(objectId);
+  if (expireAfter == 0) {
+    return false;
+  }
+
+  TRI_voc_rid_t revisionId;
+  if (_documents) {
+    revisionId = RocksDBKey::revisionId(RocksDBEntryType::Document, key);
+  } else {
+    revisionId = RocksDBValue::revisionId(existingValue);
+  }
+  if (!RocksDBTtl::isExpired(revisionId, expireAfter)) {
+    return false;
+  }
+
+  if (_documents && _isLive(objectId, key)) {
+    RocksDBTtl::countRemoval(objectId);
+  }
+  return true;
+}
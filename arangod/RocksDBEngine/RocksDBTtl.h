@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_ROCKSDB_ENGINE_ROCKSDB_TTL_H
+#define ARANGOD_ROCKSDB_ENGINE_ROCKSDB_TTL_H 1
+
+#include "Basics/Common.h"
+#include "VocBase/voc-types.h"
+
+#include <rocksdb/compaction_filter.h>
+
+#include <functional>
+
+namespace arangodb {
+
+/// @brief registry of the collections whose documents expire. a document of
+/// such a collection expires the configured number of seconds after it was
+/// last written, which is the time encoded in its revision id. expired
+/// documents are hidden from reads and dropped from the documents and
+/// primary index column families when these are compacted
+struct RocksDBTtl {
+  /// @brief registers the object id of a collection or of its primary index
+  static void add(uint64_t objectId, uint64_t expireAfter);
+
+  /// @brief unregisters an object id
+  static void remove(uint64_t objectId);
+
+  /// @brief number of seconds after which the documents of the object expire,
+  /// 0 if they do not expire
+  static uint64_t expireAfter(uint64_t objectId);
+
+  /// @brief whether or not a document revision written expireAfter seconds
+  /// ago or earlier has expired
+  static bool isExpired(TRI_voc_rid_t revisionId, uint64_t expireAfter);
+
+  /// @brief takes the numbers of documents dropped by compactions since the
+  /// last call, by collection object id. only the removals of documents that
+  /// were still live are counted. the background thread applies them to the
+  /// counters right before it syncs them, so they are lost only if the server
+  /// crashes between a compaction and the next counter sync
+  static std::unordered_map<uint64_t, uint64_t> stealRemovals();
+
+ private:
+  friend class RocksDBTtlCompactionFilter;
+  static void countRemoval(uint64_t objectId);
+};
+
+/// @brief compaction filter dropping expired documents, or the primary index
+/// entries of expired documents
+class RocksDBTtlCompactionFilter final : public rocksdb::CompactionFilter {
+ public:
+  /// @brief checks whether a document entry, given by the collection's object
+  /// id and the key, has not been removed yet
+  typedef std::function<bool(uint64_t, rocksdb::Slice const&)> LiveCheck;
+
+  explicit RocksDBTtlCompactionFilter(bool documents);
+
+  RocksDBTtlCompactionFilter(bool documents, LiveCheck const& isLive)
+      : _documents(documents), _isLive(isLive) {}
+
+  bool Filter(int level, rocksdb::Slice const& key,
+              rocksdb::Slice const& existingValue, std::string* newValue,
+              bool* valueChanged) const override;
+
+  char const* Name() const override {
+    return _documents ? "RocksDBTtlDocuments" : "RocksDBTtlPrimaryIndex";
+  }
+
+ private:
+  /// @brief whether documents or primary index entries are filtered
+  bool const _documents;
+
+  /// @brief a compaction also visits old revisions and removed documents
+  /// whose tombstones sit in a higher level. these were already subtracted
+  /// from the document count and must not be counted again
+  LiveCheck const _isLive;
+};
+
+}  // namespace arangodb
+
+#endif
@@ -115,6 +115,25 @@ static rocksdb::Slice KeyGeneratorValue(
     reinterpret_cast<std::underlying_type<RocksDBEntryType>::type*>(
         &keyGeneratorValue),
     1);
+
+static RocksDBEntryType attributeStatisticsValue =
+    RocksDBEntryType::AttributeStatisticsValue;
+static rocksdb::Slice AttributeStatisticsValue(
+    reinterpret_cast<std::underlying_type<RocksDBEntryType>::type*>(
+        &attributeStatisticsValue),
+    1);
+
+static RocksDBEntryType geoCellIndexValue = RocksDBEntryType::GeoCellIndexValue;
+static rocksdb::Slice GeoCellIndexValue(
+    reinterpret_cast<std::underlying_type<RocksDBEntryType>::type*>(
+        &geoCellIndexValue),
+    1);
+
+static RocksDBEntryType cacheHeatMapValue = RocksDBEntryType::CacheHeatMapValue;
+static rocksdb::Slice CacheHeatMapValue(
+    reinterpret_cast<std::underlying_type<RocksDBEntryType>::type*>(
+        &cacheHeatMapValue),
+    1);
 }
 
 char const* arangodb::rocksDBEntryTypeName(arangodb::RocksDBEntryType type) {
@@ -149,6 +168,12 @@ char const* arangodb::rocksDBEntryTypeName(arangodb::RocksDBEntryType type) {
       return "IndexEstimateValue";
     case arangodb::RocksDBEntryType::KeyGeneratorValue:
       return "KeyGeneratorValue";
+    case arangodb::RocksDBEntryType::AttributeStatisticsValue:
+      return "AttributeStatisticsValue";
+    case arangodb::RocksDBEntryType::GeoCellIndexValue:
+      return "GeoCellIndexValue";
+    case arangodb::RocksDBEntryType::CacheHeatMapValue:
+      return "CacheHeatMapValue";
   }
   return "Invalid";
 }
@@ -187,6 +212,8 @@ char const* arangodb::rocksDBLogTypeName(arangodb::RocksDBLogType type) {
       return "SinglePut";
     case arangodb::RocksDBLogType::SingleRemove:
       return "SingleRemove";
+    case arangodb::RocksDBLogType::CollectionTruncate:
+      return "CollectionTruncate";
     case arangodb::RocksDBLogType::Invalid:
       return "Invalid";
   }
@@ -225,6 +252,12 @@ rocksdb::Slice const& arangodb::rocksDBSlice(RocksDBEntryType const& type) {
       return IndexEstimateValue;
     case RocksDBEntryType::KeyGeneratorValue:
       return KeyGeneratorValue;
+    case RocksDBEntryType::AttributeStatisticsValue:
+      return AttributeStatisticsValue;
+    case RocksDBEntryType::GeoCellIndexValue:
+      return GeoCellIndexValue;
+    case RocksDBEntryType::CacheHeatMapValue:
+      return CacheHeatMapValue;
   }
 
   return Document;  // avoids warning - errorslice instead ?!
@@ -50,7 +50,10 @@ enum class RocksDBEntryType : char {
   GeoIndexValue = ';',
   IndexEstimateValue = '<',
   KeyGeneratorValue = '=',
-  View = '>'
+  View = '>',
+  AttributeStatisticsValue = '?',
+  GeoCellIndexValue = '@',
+  CacheHeatMapValue = 'A'
 };
 
 char const* rocksDBEntryTypeName(RocksDBEntryType);
@@ -72,7 +75,8 @@ enum class RocksDBLogType : char {
   DocumentOperationsPrologue = '=',
   DocumentRemove = '>',
   SinglePut = '?',
-  SingleRemove = '@'
+  SingleRemove = '@',
+  CollectionTruncate = 'A'
 };
   
 enum class RocksDBSettingsType : char {
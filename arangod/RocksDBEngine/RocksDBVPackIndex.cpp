@@ -26,8 +26,11 @@
 #include "RocksDBVPackIndex.h"
 #include "Aql/AstNode.h"
 #include "Aql/SortCondition.h"
+#include "Basics/MutexLocker.h"
+#include "Basics/ReadLocker.h"
 #include "Basics/StaticStrings.h"
 #include "Basics/VelocyPackHelper.h"
+#include "Basics/WriteLocker.h"
 #include "Indexes/IndexResult.h"
 #include "RocksDBEngine/RocksDBCollection.h"
 #include "RocksDBEngine/RocksDBColumnFamily.h"
@@ -81,57 +84,118 @@ static std::vector<arangodb::basics::AttributeName> const KeyAttribute{
 RocksDBVPackIndexIterator::RocksDBVPackIndexIterator(
     LogicalCollection* collection, transaction::Methods* trx,
     ManagedDocumentResult* mmdr, arangodb::RocksDBVPackIndex const* index,
-    bool reverse, bool singleElementFetch, RocksDBKeyBounds&& bounds)
+    bool reverse, bool singleElementFetch,
+    std::vector<RocksDBKeyBounds>&& bounds)
     : IndexIterator(collection, trx, mmdr, index),
       _index(index),
       _cmp(index->comparator()),
       _reverse(reverse),
       _singleElementFetch(singleElementFetch),
-      _bounds(std::move(bounds)) {
+      _bounds(std::move(bounds)),
+      _currentBounds(0) {
   TRI_ASSERT(index->columnFamily() == RocksDBColumnFamily::vpack());
+  TRI_ASSERT(!_bounds.empty());
 
   RocksDBMethods* mthds = RocksDBTransactionState::toMethods(trx);
   rocksdb::ReadOptions options = mthds->readOptions();
   if (!reverse) {
     // we need to have a pointer to a slice for the upper bound
     // so we need to assign the slice to an instance variable here
-    _upperBound = _bounds.end();
+    _upperBound = _bounds.back().end();
     options.iterate_upper_bound = &_upperBound;
   }
 
   TRI_ASSERT(options.prefix_same_as_start);
   _iterator = mthds->NewIterator(options, index->columnFamily());
-  if (reverse) {
-    _iterator->SeekForPrev(_bounds.end());
-  } else {
-    _iterator->Seek(_bounds.start());
-  }
+  seekToCurrentRange();
 }
 
 /// @brief Reset the cursor
 void RocksDBVPackIndexIterator::reset() {
   TRI_ASSERT(_trx->state()->isRunning());
 
+  _currentBounds = 0;
+  seekToCurrentRange();
+}
+
+/// @brief position the iterator at the start of the current range
+void RocksDBVPackIndexIterator::seekToCurrentRange() {
+  // ranges are walked from the last to the first one in reverse mode
+  RocksDBKeyBounds const& bounds =
+      _bounds[_reverse ? _bounds.size() - 1 - _currentBounds : _currentBounds];
+
   if (_reverse) {
-    _iterator->SeekForPrev(_bounds.end());
+    _iterator->SeekForPrev(bounds.end());
   } else {
-    _iterator->Seek(_bounds.start());
+    _iterator->Seek(bounds.start());
   }
 }
 
-bool RocksDBVPackIndexIterator::outOfRange() const {
-  TRI_ASSERT(_trx->state()->isRunning());
-  if (_reverse) {
-    return (_cmp->Compare(_iterator->key(), _bounds.start()) < 0);
+/// @brief move to the next element, skipping to the next range if only
+/// a single element is fetched per range
+void RocksDBVPackIndexIterator::advance() {
+  if (_singleElementFetch) {
+    // we only need to fetch a single element per range. this is a useful
+    // optimization because seeking forwards or backwards with the iterator
+    // can be very expensive
+    ++_currentBounds;
+  } else if (_reverse) {
+    _iterator->Prev();
   } else {
-    return (_cmp->Compare(_iterator->key(), _bounds.end()) > 0);
+    _iterator->Next();
+  }
+}
+
+/// @brief make sure the iterator points to an element within the current
+/// range or one of the following ones. returns false if there are no
+/// more elements
+bool RocksDBVPackIndexIterator::positionInRange() {
+  while (_currentBounds < _bounds.size()) {
+    RocksDBKeyBounds const& bounds =
+        _bounds[_reverse ? _bounds.size() - 1 - _currentBounds
+                         : _currentBounds];
+
+    if (_reverse) {
+      if (!_iterator->Valid() ||
+          _cmp->Compare(_iterator->key(), bounds.end()) > 0) {
+        // range not yet reached
+        _iterator->SeekForPrev(bounds.end());
+        if (!_iterator->Valid()) {
+          // no more elements in any of the remaining ranges
+          break;
+        }
+      }
+      if (_cmp->Compare(_iterator->key(), bounds.start()) >= 0) {
+        return true;
+      }
+    } else {
+      if (!_iterator->Valid() ||
+          _cmp->Compare(_iterator->key(), bounds.start()) < 0) {
+        // range not yet reached
+        _iterator->Seek(bounds.start());
+        if (!_iterator->Valid()) {
+          // no more elements in any of the remaining ranges
+          break;
+        }
+      }
+      if (_cmp->Compare(_iterator->key(), bounds.end()) <= 0) {
+        return true;
+      }
+    }
+
+    // iterator is beyond the current range. it may already be positioned
+    // in one of the following ranges, so check them without seeking
+    ++_currentBounds;
   }
+
+  _currentBounds = _bounds.size();
+  return false;
 }
 
 bool RocksDBVPackIndexIterator::next(TokenCallback const& cb, size_t limit) {
   TRI_ASSERT(_trx->state()->isRunning());
 
-  if (limit == 0 || !_iterator->Valid() || outOfRange()) {
+  if (limit == 0 || !positionInRange()) {
     // No limit no data, or we are actually done. The last call should have
     // returned false
     TRI_ASSERT(limit > 0);  // Someone called with limit == 0. Api broken
@@ -141,27 +205,42 @@ bool RocksDBVPackIndexIterator::next(TokenCallback const& cb, size_t limit) {
   while (limit > 0) {
     TRI_ASSERT(_index->objectId() == RocksDBKey::objectId(_iterator->key()));
 
-    TRI_voc_rid_t revisionId =
-        _index->_unique
-            ? RocksDBValue::revisionId(_iterator->value())
-            : RocksDBKey::revisionId(_bounds.type(), _iterator->key());
-    cb(RocksDBToken(revisionId));
+    cb(RocksDBToken(currentRevisionId()));
+
+    --limit;
+    advance();
 
-    if (_singleElementFetch) {
-      // we only need to fetch a single element from the index and are done then
-      // this is a useful optimization because seeking forwards or backwards
-      // with the iterator can be very expensive
+    if (!positionInRange()) {
       return false;
     }
+  }
+
+  return true;
+}
+
+/// @brief Get the indexed values of the next limit many elements. the
+/// values are taken from the index key, so the documents are not read
+bool RocksDBVPackIndexIterator::nextCovering(DocumentCallback const& cb,
+                                             size_t limit) {
+  TRI_ASSERT(_trx->state()->isRunning());
+
+  if (limit == 0 || !positionInRange()) {
+    // No limit no data, or we are actually done. The last call should have
+    // returned false
+    TRI_ASSERT(limit > 0);  // Someone called with limit == 0. Api broken
+    return false;
+  }
+
+  while (limit > 0) {
+    TRI_ASSERT(_index->objectId() == RocksDBKey::objectId(_iterator->key()));
+
+    cb(RocksDBToken(currentRevisionId()),
+       RocksDBKey::indexedVPack(_iterator->key()));
 
     --limit;
-    if (_reverse) {
-      _iterator->Prev();
-    } else {
-      _iterator->Next();
-    }
+    advance();
 
-    if (!_iterator->Valid() || outOfRange()) {
+    if (!positionInRange()) {
       return false;
     }
   }
@@ -169,6 +248,13 @@ bool RocksDBVPackIndexIterator::next(TokenCallback const& cb, size_t limit) {
   return true;
 }
 
+/// @brief revision id of the current element
+TRI_voc_rid_t RocksDBVPackIndexIterator::currentRevisionId() const {
+  return _index->_unique
+             ? RocksDBValue::revisionId(_iterator->value())
+             : RocksDBKey::revisionId(_bounds[0].type(), _iterator->key());
+}
+
 uint64_t RocksDBVPackIndex::HashForKey(const rocksdb::Slice& key) {
   // NOTE: This function needs to use the same hashing on the
   // indexed VPack as the initial inserter does
@@ -185,7 +271,10 @@ RocksDBVPackIndex::RocksDBVPackIndex(TRI_idx_iid_t iid,
           info, "deduplicate", true)),
       _useExpansion(false),
       _allowPartialIndex(true),
-      _estimator(nullptr) {
+      _estimator(nullptr),
+      _useBloomFilter(arangodb::basics::VelocyPackHelper::getBooleanValue(
+          info, "bloomFilter", false)),
+      _bloomFilterReady(false) {
   TRI_ASSERT(_cf == RocksDBColumnFamily::vpack());
 
   if (!_unique && !ServerState::instance()->isCoordinator()) {
@@ -195,6 +284,13 @@ RocksDBVPackIndex::RocksDBVPackIndex(TRI_idx_iid_t iid,
         RocksDBIndex::ESTIMATOR_SIZE);
     TRI_ASSERT(_estimator != nullptr);
   }
+
+  if (_useBloomFilter) {
+    // created before any entry can be inserted through this object, so the
+    // filter misses at most the entries that are already stored. these are
+    // added by fillBloomFilter()
+    _bloomFilter.reset(new RocksDBBloomFilter(BloomFilterInitialSize));
+  }
   TRI_ASSERT(!_fields.empty());
 
   TRI_ASSERT(iid != 0);
@@ -207,6 +303,25 @@ RocksDBVPackIndex::RocksDBVPackIndex(TRI_idx_iid_t iid,
       break;
     }
   }
+
+  VPackSlice const filter = info.get("partialFilter");
+
+  if (filter.isObject() && filter.length() > 0) {
+    _partialFilter.add(filter);
+
+    for (auto const& it : VPackObjectIterator(_partialFilter.slice())) {
+      _filterFields.emplace_back();
+      TRI_ParseAttributeString(it.key.copyString(), _filterFields.back(),
+                               false);
+
+      _filterPaths.emplace_back();
+      for (auto const& name : _filterFields.back()) {
+        _filterPaths.back().emplace_back(name.name);
+      }
+
+      _filterValues.emplace_back(it.value);
+    }
+  }
 }
 
 /// @brief destroy the index
@@ -229,9 +344,57 @@ void RocksDBVPackIndex::toVelocyPack(VPackBuilder& builder, bool withFigures,
   builder.add("unique", VPackValue(_unique));
   builder.add("sparse", VPackValue(_sparse));
   builder.add("deduplicate", VPackValue(_deduplicate));
+  if (isPartial()) {
+    builder.add("partialFilter", _partialFilter.slice());
+  }
+  if (_useBloomFilter) {
+    builder.add("bloomFilter", VPackValue(true));
+  }
   builder.close();
 }
 
+int RocksDBVPackIndex::load() {
+  int res = RocksDBIndex::load();
+
+  if (res == TRI_ERROR_NO_ERROR && _useBloomFilter &&
+      !ServerState::instance()->isCoordinator()) {
+    // the collection is being loaded, so nothing writes to the index and
+    // the filter can be rebuilt without the values of removed entries
+    fillBloomFilter(true);
+  }
+
+  return res;
+}
+
+/// @brief Test if this index matches the definition
+bool RocksDBVPackIndex::matchesDefinition(VPackSlice const& info) const {
+  return Index::matchesDefinition(info) &&
+         partialFilterMatchesDefinition(info);
+}
+
+/// @brief whether the partial filter of a definition is the same as the
+/// one of this index
+bool RocksDBVPackIndex::partialFilterMatchesDefinition(
+    VPackSlice const& info) const {
+  if (!info.get("id").isNone()) {
+    // the id alone decides
+    return true;
+  }
+
+  VPackSlice const filter = info.get("partialFilter");
+
+  if (!filter.isObject() || filter.length() == 0) {
+    return !isPartial();
+  }
+
+  if (!isPartial()) {
+    return false;
+  }
+
+  return arangodb::basics::VelocyPackHelper::compare(
+             filter, _partialFilter.slice(), false) == 0;
+}
+
 /// @brief whether or not the index is implicitly unique
 /// this can be the case if the index is not declared as unique,
 /// but contains a unique attribute such as _key
@@ -501,11 +664,37 @@ void RocksDBVPackIndex::fillPaths(std::vector<std::vector<std::string>>& paths,
   }
 }
 
+/// @brief whether the document is covered by the partial filter. a missing
+/// attribute counts as null
+bool RocksDBVPackIndex::matchesPartialFilter(VPackSlice const& doc) const {
+  size_t const n = _filterPaths.size();
+
+  for (size_t i = 0; i < n; ++i) {
+    VPackSlice value = doc.get(_filterPaths[i]);
+
+    if (value.isNone()) {
+      value = arangodb::basics::VelocyPackHelper::NullValue();
+    }
+
+    if (arangodb::basics::VelocyPackHelper::compare(value, _filterValues[i],
+                                                    false) != 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 /// @brief inserts a document into the index
 Result RocksDBVPackIndex::insertInternal(transaction::Methods* trx,
                                          RocksDBMethods* mthds,
                                          TRI_voc_rid_t revisionId,
                                          VPackSlice const& doc) {
+  if (isPartial() && !matchesPartialFilter(doc)) {
+    // document is not covered by this index
+    return IndexResult(TRI_ERROR_NO_ERROR, this);
+  }
+
   std::vector<RocksDBKey> elements;
   std::vector<uint64_t> hashes;
   int res;
@@ -528,16 +717,18 @@ Result RocksDBVPackIndex::insertInternal(transaction::Methods* trx,
   for (size_t i = 0; i < count; ++i) {
     RocksDBKey& key = elements[i];
     if (_unique) {
-      RocksDBValue existing =
-          RocksDBValue::Empty(RocksDBEntryType::UniqueVPackIndexValue);
       if (mthds->Exists(_cf, key)) {
         res = TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED;
       }
     }
 
     if (res == TRI_ERROR_NO_ERROR) {
+      // unique entries must be locked, so concurrent inserts of the same
+      // values conflict. other entries contain the revision id
       arangodb::Result r =
-          mthds->Put(_cf, key, value.string(), rocksutils::index);
+          _unique ? mthds->Put(_cf, key, value.string(), rocksutils::index)
+                  : mthds->PutUntracked(_cf, key, value.string(),
+                                        rocksutils::index);
       if (!r.ok()) {
         // auto status =
         //    rocksutils::convertStatus(s, rocksutils::StatusHint::index);
@@ -547,7 +738,11 @@ Result RocksDBVPackIndex::insertInternal(transaction::Methods* trx,
 
     if (res != TRI_ERROR_NO_ERROR) {
       for (size_t j = 0; j < i; ++j) {
-        mthds->Delete(_cf, elements[j]);
+        if (_unique) {
+          mthds->Delete(_cf, elements[j]);
+        } else {
+          mthds->DeleteUntracked(_cf, elements[j]);
+        }
       }
 
       if (res == TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED && !_unique) {
@@ -565,6 +760,16 @@ Result RocksDBVPackIndex::insertInternal(transaction::Methods* trx,
       TRI_ASSERT(!_unique);
       _estimator->insert(it);
     }
+
+    if (_useBloomFilter) {
+      // unique indexes do not compute hashes for the estimator
+      std::vector<uint64_t> filterHashes;
+      filterHashes.reserve(count);
+      for (auto const& key : elements) {
+        filterHashes.push_back(RocksDBKey::indexedVPack(key).normalizedHash());
+      }
+      insertIntoBloomFilter(filterHashes);
+    }
   }
 
   return IndexResult(res, this);
@@ -574,6 +779,11 @@ Result RocksDBVPackIndex::removeInternal(transaction::Methods* trx,
                                          RocksDBMethods* mthds,
                                          TRI_voc_rid_t revisionId,
                                          VPackSlice const& doc) {
+  if (isPartial() && !matchesPartialFilter(doc)) {
+    // document was never indexed
+    return IndexResult(TRI_ERROR_NO_ERROR, this);
+  }
+
   std::vector<RocksDBKey> elements;
   std::vector<uint64_t> hashes;
 
@@ -590,7 +800,8 @@ Result RocksDBVPackIndex::removeInternal(transaction::Methods* trx,
 
   size_t const count = elements.size();
   for (size_t i = 0; i < count; ++i) {
-    arangodb::Result r = mthds->Delete(_cf, elements[i]);
+    arangodb::Result r = _unique ? mthds->Delete(_cf, elements[i])
+                                 : mthds->DeleteUntracked(_cf, elements[i]);
     if (!r.ok()) {
       res = r.errorNumber();
     }
@@ -613,6 +824,16 @@ Result RocksDBVPackIndex::removeInternal(transaction::Methods* trx,
 RocksDBVPackIndexIterator* RocksDBVPackIndex::lookup(
     transaction::Methods* trx, ManagedDocumentResult* mmdr,
     VPackSlice const searchValues, bool reverse) const {
+  bool singleElementFetch = false;
+  std::vector<RocksDBKeyBounds> bounds;
+  bounds.emplace_back(boundsForLookup(searchValues, singleElementFetch));
+  return new RocksDBVPackIndexIterator(_collection, trx, mmdr, this, reverse,
+                                       singleElementFetch, std::move(bounds));
+}
+
+/// @brief build the key range for a lookup
+RocksDBKeyBounds RocksDBVPackIndex::boundsForLookup(
+    VPackSlice const searchValues, bool& singleElementFetch) const {
   TRI_ASSERT(searchValues.isArray());
   TRI_ASSERT(searchValues.length() <= _fields.size());
 
@@ -703,15 +924,13 @@ RocksDBVPackIndexIterator* RocksDBVPackIndex::lookup(
     }
   }
 
-  bool const singleElementFetch = (_unique && lastNonEq.isNone() &&
-                                   searchValues.length() == _fields.size());
+  singleElementFetch = (_unique && lastNonEq.isNone() &&
+                        searchValues.length() == _fields.size());
 
-  RocksDBKeyBounds bounds = _unique ? RocksDBKeyBounds::UniqueVPackIndex(
-                                          _objectId, leftBorder, rightBorder)
-                                    : RocksDBKeyBounds::VPackIndex(
-                                          _objectId, leftBorder, rightBorder);
-  return new RocksDBVPackIndexIterator(_collection, trx, mmdr, this, reverse,
-                                       singleElementFetch, std::move(bounds));
+  return _unique ? RocksDBKeyBounds::UniqueVPackIndex(_objectId, leftBorder,
+                                                      rightBorder)
+                 : RocksDBKeyBounds::VPackIndex(_objectId, leftBorder,
+                                                rightBorder);
 }
 
 bool RocksDBVPackIndex::accessFitsIndex(
@@ -872,6 +1091,13 @@ bool RocksDBVPackIndex::supportsFilterCondition(
     }
   }
 
+  if (isPartial() && !conditionImpliesPartialFilter(node, reference)) {
+    // the condition may select documents that are not in the index
+    estimatedItems = itemsInIndex;
+    estimatedCost = static_cast<double>(estimatedItems);
+    return false;
+  }
+
   std::unordered_map<size_t, std::vector<arangodb::aql::AstNode const*>> found;
   std::unordered_set<std::string> nonNullAttributes;
   size_t values = 0;
@@ -998,14 +1224,63 @@ bool RocksDBVPackIndex::supportsFilterCondition(
   return false;
 }
 
+/// @brief whether the condition only selects documents covered by the
+/// partial filter
+bool RocksDBVPackIndex::conditionImpliesPartialFilter(
+    arangodb::aql::AstNode const* node,
+    arangodb::aql::Variable const* reference) const {
+  size_t const n = _filterFields.size();
+
+  for (size_t i = 0; i < n; ++i) {
+    bool implied = false;
+
+    for (size_t j = 0; j < node->numMembers() && !implied; ++j) {
+      auto op = node->getMemberUnchecked(j);
+
+      if (op->type != arangodb::aql::NODE_TYPE_OPERATOR_BINARY_EQ) {
+        continue;
+      }
+
+      for (size_t k = 0; k < 2 && !implied; ++k) {
+        auto access = op->getMember(k);
+        auto value = op->getMember(1 - k);
+
+        if (!value->isConstant()) {
+          continue;
+        }
+
+        std::pair<arangodb::aql::Variable const*,
+                  std::vector<arangodb::basics::AttributeName>>
+            attributeData;
+
+        if (!access->isAttributeAccessForVariable(attributeData) ||
+            attributeData.first != reference ||
+            !arangodb::basics::AttributeName::isIdentical(
+                attributeData.second, _filterFields[i], false)) {
+          continue;
+        }
+
+        implied = (arangodb::basics::VelocyPackHelper::compare(
+                       value->computeValue(), _filterValues[i], false) == 0);
+      }
+    }
+
+    if (!implied) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 bool RocksDBVPackIndex::supportsSortCondition(
     arangodb::aql::SortCondition const* sortCondition,
     arangodb::aql::Variable const* reference, size_t itemsInIndex,
     double& estimatedCost, size_t& coveredAttributes) const {
   TRI_ASSERT(sortCondition != nullptr);
 
-  if (!_sparse) {
-    // only non-sparse indexes can be used for sorting
+  if (!_sparse && !isPartial()) {
+    // only non-sparse, non-partial indexes can be used for sorting
     if (!_useExpansion && sortCondition->isUnidirectional() &&
         sortCondition->isOnlyAttributeAccess()) {
       coveredAttributes = sortCondition->coveredAttributes(reference, _fields);
@@ -1231,28 +1506,33 @@ IndexIterator* RocksDBVPackIndex::iteratorForCondition(
     VPackBuilder expandedSearchValues;
     expandInSearchValues(searchValues.slice(), expandedSearchValues);
     VPackSlice expandedSlice = expandedSearchValues.slice();
-    std::vector<IndexIterator*> iterators;
-    try {
-      for (auto const& val : VPackArrayIterator(expandedSlice)) {
-        auto iterator = lookup(trx, mmdr, val, reverse);
-        try {
-          iterators.push_back(iterator);
-        } catch (...) {
-          // avoid leak
-          delete iterator;
-          throw;
-        }
-      }
-      if (reverse) {
-        std::reverse(iterators.begin(), iterators.end());
-      }
-    } catch (...) {
-      for (auto& it : iterators) {
-        delete it;
-      }
-      throw;
+
+    std::vector<VPackSlice> lookups;
+    lookups.reserve(static_cast<size_t>(expandedSlice.length()));
+    for (auto const& val : VPackArrayIterator(expandedSlice)) {
+      lookups.emplace_back(val);
     }
-    return new MultiIndexIterator(_collection, trx, mmdr, this, iterators);
+
+    if (_useBloomFilter) {
+      removeMissingLookups(lookups);
+    }
+
+    // the expanded lookups are sorted by their IN values, so their ranges
+    // are in index order and can all be walked with a single iterator
+    bool singleElementFetch = false;
+    std::vector<RocksDBKeyBounds> bounds;
+    bounds.reserve(lookups.size());
+    for (auto const& val : lookups) {
+      bounds.emplace_back(boundsForLookup(val, singleElementFetch));
+    }
+
+    if (bounds.empty()) {
+      // IN with an empty list, a non-list or only values that are not in
+      // the index
+      return new EmptyIndexIterator(_collection, trx, mmdr, this);
+    }
+    return new RocksDBVPackIndexIterator(_collection, trx, mmdr, this, reverse,
+                                         singleElementFetch, std::move(bounds));
   }
 
   VPackSlice searchSlice = searchValues.slice();
@@ -1422,6 +1702,14 @@ bool RocksDBVPackIndex::deserializeEstimate(RocksDBCounterManager* mgr) {
   return true;
 }
 
+void RocksDBVPackIndex::afterTruncate() {
+  if (!unique()) {
+    TRI_ASSERT(_estimator != nullptr);
+    _estimator->clear();
+  }
+  RocksDBIndex::afterTruncate();
+}
+
 void RocksDBVPackIndex::recalculateEstimates() {
   if (ServerState::instance()->isCoordinator()) {
     return;
@@ -1442,6 +1730,118 @@ void RocksDBVPackIndex::recalculateEstimates() {
                             bounds.columnFamily());
 }
 
+void RocksDBVPackIndex::fillBloomFilter(bool reset) {
+  TRI_ASSERT(_useBloomFilter);
+  MUTEX_LOCKER(locker, _bloomFilterFillLock);
+
+  if (reset) {
+    WRITE_LOCKER(guard, _bloomFilterLock);
+    _bloomFilterReady.store(false);
+    _bloomFilter.reset(new RocksDBBloomFilter(BloomFilterInitialSize));
+  } else if (_bloomFilterReady.load()) {
+    // filled by another thread meanwhile
+    return;
+  }
+
+  try {
+    std::vector<uint64_t> hashes;
+    hashes.reserve(BloomFilterBatchSize);
+
+    RocksDBKeyBounds bounds = getBounds();
+    rocksutils::iterateBounds(bounds,
+                              [this, &hashes](rocksdb::Iterator* it) {
+                                hashes.push_back(
+                                    RocksDBVPackIndex::HashForKey(it->key()));
+                                if (hashes.size() == BloomFilterBatchSize) {
+                                  insertIntoBloomFilter(hashes);
+                                  hashes.clear();
+                                }
+                              },
+                              bounds.columnFamily());
+    insertIntoBloomFilter(hashes);
+  } catch (std::exception const& ex) {
+    // the index works without the filter, the next IN lookup retries
+    LOG_TOPIC(WARN, arangodb::Logger::FIXME)
+        << "unable to fill bloom filter of index " << _iid << ": "
+        << ex.what();
+    return;
+  }
+
+  _bloomFilterReady.store(true);
+}
+
+void RocksDBVPackIndex::insertIntoBloomFilter(
+    std::vector<uint64_t> const& hashes) {
+  {
+    READ_LOCKER(guard, _bloomFilterLock);
+    for (auto const& hash : hashes) {
+      _bloomFilter->insert(hash);
+    }
+    if (!_bloomFilter->isFull()) {
+      return;
+    }
+  }
+
+  WRITE_LOCKER(guard, _bloomFilterLock);
+  if (_bloomFilter->isFull()) {
+    _bloomFilter = _bloomFilter->grow();
+  }
+}
+
+void RocksDBVPackIndex::removeMissingLookups(
+    std::vector<VPackSlice>& lookups) {
+  TRI_ASSERT(_useBloomFilter);
+
+  if (!_bloomFilterReady.load()) {
+    // first use of a new index, or loading the collection has not
+    // completed the filter
+    fillBloomFilter(false);
+  }
+
+  // only lookups with an equality condition for every attribute can be
+  // checked, they are looking for an entry with exactly these values
+  std::vector<uint64_t> hashes;
+  std::vector<bool> checkable;
+  hashes.reserve(lookups.size());
+  checkable.reserve(lookups.size());
+
+  VPackBuilder values;
+  for (auto const& lookup : lookups) {
+    bool complete = (lookup.length() == _fields.size());
+    values.clear();
+    values.openArray();
+    if (complete) {
+      for (auto const& it : VPackArrayIterator(lookup)) {
+        VPackSlice eq = it.get(StaticStrings::IndexEq);
+        if (eq.isNone()) {
+          complete = false;
+          break;
+        }
+        values.add(eq);
+      }
+    }
+    values.close();
+
+    // must be the same hash as HashForKey() computes for the entries
+    hashes.push_back(complete ? values.slice().normalizedHash() : 0);
+    checkable.push_back(complete);
+  }
+
+  READ_LOCKER(guard, _bloomFilterLock);
+  if (!_bloomFilterReady.load()) {
+    // filling the filter has failed
+    return;
+  }
+
+  size_t j = 0;
+  for (size_t i = 0; i < lookups.size(); ++i) {
+    if (!checkable[i] || _bloomFilter->mayContain(hashes[i])) {
+      lookups[j++] = lookups[i];
+    }
+  }
+  lookups.resize(j);
+}
+
 Result RocksDBVPackIndex::postprocessRemove(transaction::Methods* trx,
                                             rocksdb::Slice const& key,
                                             rocksdb::Slice const& value) {
@@ -27,8 +27,12 @@
 #define ARANGOD_ROCKSDB_ROCKSDB_VPACK_INDEX_H 1
 
 #include "Aql/AstNode.h"
+#include "Basics/AttributeNameParser.h"
 #include "Basics/Common.h"
+#include "Basics/Mutex.h"
+#include "Basics/ReadWriteLock.h"
 #include "Indexes/IndexIterator.h"
+#include "RocksDBEngine/RocksDBBloomFilter.h"
 #include "RocksDBEngine/RocksDBCuckooIndexEstimator.h"
 #include "RocksDBEngine/RocksDBIndex.h"
 #include "RocksDBEngine/RocksDBKey.h"
@@ -38,6 +42,7 @@
 #include "VocBase/vocbase.h"
 
 #include <velocypack/Buffer.h>
+#include <velocypack/Builder.h>
 #include <velocypack/Slice.h>
 
 namespace rocksdb {
@@ -57,6 +62,11 @@ class Methods;
 }
 
 /// @brief Iterator structure for RocksDB. We require a start and stop node
+/// for each range to look up. multiple ranges (as produced by IN lookups)
+/// must be sorted in index order and must not overlap. they are all walked
+/// with the same RocksDB iterator, so the results are produced in index
+/// order, and a seek is only done if the next range is not reached by the
+/// iterator anyway
 class RocksDBVPackIndexIterator final : public IndexIterator {
  private:
   friend class RocksDBVPackIndex;
@@ -67,7 +77,7 @@ class RocksDBVPackIndexIterator final : public IndexIterator {
                             ManagedDocumentResult* mmdr,
                             arangodb::RocksDBVPackIndex const* index,
                             bool reverse, bool singleElementFetch,
-                            RocksDBKeyBounds&& bounds);
+                            std::vector<RocksDBKeyBounds>&& bounds);
 
   ~RocksDBVPackIndexIterator() = default;
 
@@ -76,21 +86,40 @@ class RocksDBVPackIndexIterator final : public IndexIterator {
     return "rocksdb-unique-index-iterator";
   }
 
+  bool hasCovering() const override { return true; }
+
   /// @brief Get the next limit many element in the index
   bool next(TokenCallback const& cb, size_t limit) override;
 
+  /// @brief Get the indexed values of the next limit many elements
+  bool nextCovering(DocumentCallback const& cb, size_t limit) override;
+
   /// @brief Reset the cursor
   void reset() override;
 
  private:
-  bool outOfRange() const;
+  /// @brief position the iterator at the start of the current range
+  void seekToCurrentRange();
+
+  /// @brief move to the next element, skipping to the next range if only
+  /// a single element is fetched per range
+  void advance();
+
+  /// @brief make sure the iterator points to an element within the current
+  /// range or one of the following ones. returns false if there are no
+  /// more elements
+  bool positionInRange();
+
+  /// @brief revision id of the current element
+  TRI_voc_rid_t currentRevisionId() const;
 
   arangodb::RocksDBVPackIndex const* _index;
   rocksdb::Comparator const* _cmp;
   std::unique_ptr<rocksdb::Iterator> _iterator;
   bool const _reverse;
   bool const _singleElementFetch;
-  RocksDBKeyBounds _bounds;
+  std::vector<RocksDBKeyBounds> _bounds;
+  size_t _currentBounds;
   rocksdb::Slice _upperBound;  // used for iterate_upper_bound
 };
 
@@ -109,15 +138,24 @@ class RocksDBVPackIndex : public RocksDBIndex {
 
   bool hasSelectivityEstimate() const override { return true; }
 
+  bool hasCoveringIterator() const override { return true; }
+
   double selectivityEstimateLocal(
       arangodb::StringRef const* = nullptr) const override;
 
   void toVelocyPack(VPackBuilder&, bool, bool) const override;
 
+  int load() override;
+
   bool allowExpansion() const override { return true; }
 
   bool canBeDropped() const override { return true; }
 
+  bool matchesDefinition(VPackSlice const& info) const override;
+
+  /// @brief whether or not only documents matching a filter are indexed
+  bool isPartial() const { return !_filterPaths.empty(); }
+
   /// @brief return the attribute paths
   std::vector<std::vector<std::string>> const& paths() const { return _paths; }
 
@@ -138,6 +176,10 @@ class RocksDBVPackIndex : public RocksDBIndex {
                                     arangodb::velocypack::Slice const,
                                     bool reverse) const;
 
+  /// @brief build the key range for a lookup
+  RocksDBKeyBounds boundsForLookup(arangodb::velocypack::Slice const,
+                                   bool& singleElementFetch) const;
+
   bool supportsFilterCondition(arangodb::aql::AstNode const*,
                                arangodb::aql::Variable const*, size_t, size_t&,
                                double&) const override;
@@ -161,7 +203,13 @@ class RocksDBVPackIndex : public RocksDBIndex {
 
   void recalculateEstimates() override;
 
+  void afterTruncate() override;
+
  protected:
+  /// @brief whether the partial filter of a definition is the same as the
+  /// one of this index
+  bool partialFilterMatchesDefinition(VPackSlice const& info) const;
+
   Result insertInternal(transaction::Methods*, RocksDBMethods*, TRI_voc_rid_t,
                         arangodb::velocypack::Slice const&) override;
 
@@ -187,6 +235,35 @@ class RocksDBVPackIndex : public RocksDBIndex {
       size_t& values, std::unordered_set<std::string>& nonNullAttributes,
       bool) const;
 
+  /// @brief whether the document is covered by the partial filter
+  bool matchesPartialFilter(VPackSlice const& doc) const;
+
+  /// @brief initial capacity of the bloom filter, in values
+  static constexpr uint64_t BloomFilterInitialSize = 4096;
+
+  /// @brief number of hashes added to the bloom filter at once while
+  /// filling it
+  static constexpr size_t BloomFilterBatchSize = 1000;
+
+  /// @brief fills the bloom filter from the index entries. with reset, the
+  /// filter is replaced by an empty one first, which drops the values of
+  /// removed entries. this must only happen while there are no writers
+  void fillBloomFilter(bool reset);
+
+  /// @brief adds hashes of indexed values to the bloom filter, and grows
+  /// it when it is full
+  void insertIntoBloomFilter(std::vector<uint64_t> const& hashes);
+
+  /// @brief removes the lookups of an IN list that fix all attributes to
+  /// values which are not in the index according to the bloom filter
+  void removeMissingLookups(std::vector<VPackSlice>& lookups);
+
+  /// @brief whether the condition only selects documents covered by the
+  /// partial filter, i.e. it contains an equality comparison with the same
+  /// value for every attribute of the filter
+  bool conditionImpliesPartialFilter(arangodb::aql::AstNode const*,
+                                     arangodb::aql::Variable const*) const;
+
  private:
   /// @brief return the number of paths
   inline size_t numPaths() const { return _paths.size(); }
@@ -236,10 +313,38 @@ class RocksDBVPackIndex : public RocksDBIndex {
   /// @brief whether or not partial indexing is allowed
   bool _allowPartialIndex;
 
+  /// @brief the partial filter, an object mapping attribute paths to the
+  /// values documents must have to be indexed. empty if all documents are
+  /// indexed
+  arangodb::velocypack::Builder _partialFilter;
+
+  /// @brief the attributes of the partial filter, as attribute names and as
+  /// paths, and the values they are compared to (pointing into
+  /// _partialFilter)
+  std::vector<std::vector<arangodb::basics::AttributeName>> _filterFields;
+  std::vector<std::vector<std::string>> _filterPaths;
+  std::vector<arangodb::velocypack::Slice> _filterValues;
+
   /// @brief A fixed size library to estimate the selectivity of the index.
   /// On insertion of a document we have to insert it into the estimator,
   /// On removal we have to remove it in the estimator as well.
   std::unique_ptr<RocksDBCuckooIndexEstimator<uint64_t>> _estimator;
+
+  /// @brief whether or not the index keeps a bloom filter of its values
+  bool const _useBloomFilter;
+
+  /// @brief in-memory bloom filter over the hashes of all indexed values,
+  /// which lets IN lookups skip the values that are not in the index. only
+  /// inserts are reflected, removed values stay in the filter until it is
+  /// rebuilt on the next load. the pointer is protected by _bloomFilterLock,
+  /// the filter itself can be used concurrently
+  std::unique_ptr<RocksDBBloomFilter> _bloomFilter;
+  basics::ReadWriteLock _bloomFilterLock;
+
+  /// @brief whether the filter contains all index entries, i.e. the entries
+  /// from before the index object was created have been added
+  std::atomic<bool> _bloomFilterReady;
+  Mutex _bloomFilterFillLock;
 };
 }  // namespace arangodb
 
@@ -51,10 +51,33 @@ RocksDBValue RocksDBValue::EdgeIndexValue(arangodb::StringRef const& vertexId) {
   return RocksDBValue(RocksDBEntryType::EdgeIndexValue, vertexId);
 }
 
+RocksDBValue RocksDBValue::EdgeIndexValue(VPackSlice const& storedValues) {
+  return RocksDBValue(RocksDBEntryType::EdgeIndexValue, storedValues);
+}
+
 RocksDBValue RocksDBValue::VPackIndexValue() {
   return RocksDBValue(RocksDBEntryType::VPackIndexValue);
 }
 
+RocksDBValue RocksDBValue::FulltextIndexValue(uint64_t termFrequency,
+                                              uint64_t documentLength) {
+  TRI_ASSERT(termFrequency > 0 && documentLength > 0);
+  RocksDBValue value(RocksDBEntryType::FulltextIndexValue);
+  // both numbers are stored as unsigned LEB128 varints, which takes a single
+  // byte for most words
+  uint8_t buffer[2 * 10];
+  uint8_t* p = &buffer[0];
+  VPackValueLength n = VPackValueLength(termFrequency);
+  arangodb::velocypack::storeVariableValueLength<false>(p, n);
+  p += arangodb::velocypack::getVariableValueLength(n);
+  n = VPackValueLength(documentLength);
+  arangodb::velocypack::storeVariableValueLength<false>(p, n);
+  p += arangodb::velocypack::getVariableValueLength(n);
+  value._buffer.append(reinterpret_cast<char const*>(&buffer[0]),
+                       static_cast<size_t>(p - &buffer[0]));
+  return value;
+}
+
 RocksDBValue RocksDBValue::UniqueVPackIndexValue(TRI_voc_rid_t revisionId) {
   return RocksDBValue(RocksDBEntryType::UniqueVPackIndexValue, revisionId);
 }
@@ -71,6 +94,14 @@ RocksDBValue RocksDBValue::KeyGeneratorValue(VPackSlice const& data) {
   return RocksDBValue(RocksDBEntryType::KeyGeneratorValue, data);
 }
 
+RocksDBValue RocksDBValue::AttributeStatisticsValue(VPackSlice const& data) {
+  return RocksDBValue(RocksDBEntryType::AttributeStatisticsValue, data);
+}
+
+RocksDBValue RocksDBValue::CacheHeatMapValue(VPackSlice const& data) {
+  return RocksDBValue(RocksDBEntryType::CacheHeatMapValue, data);
+}
+
 RocksDBValue RocksDBValue::Empty(RocksDBEntryType type) {
   return RocksDBValue(type);
 }
@@ -87,6 +118,22 @@ TRI_voc_rid_t RocksDBValue::revisionId(std::string const& s) {
   return revisionId(s.data(), s.size());
 }
 
+void RocksDBValue::fulltextStatistics(rocksdb::Slice const& slice,
+                                      uint64_t& termFrequency,
+                                      uint64_t& documentLength) {
+  if (slice.size() < 2) {
+    // value written by an older version
+    termFrequency = 1;
+    documentLength = 0;
+    return;
+  }
+  uint8_t const* p = reinterpret_cast<uint8_t const*>(slice.data());
+  termFrequency = arangodb::velocypack::readVariableValueLength<false>(p);
+  p += arangodb::velocypack::getVariableValueLength(termFrequency);
+  TRI_ASSERT(p < reinterpret_cast<uint8_t const*>(slice.data()) + slice.size());
+  documentLength = arangodb::velocypack::readVariableValueLength<false>(p);
+}
+
 StringRef RocksDBValue::vertexId(rocksdb::Slice const& s) {
   return vertexId(s.data(), s.size());
 }
@@ -139,7 +186,10 @@ RocksDBValue::RocksDBValue(RocksDBEntryType type, VPackSlice const& data)
     case RocksDBEntryType::Collection:
     case RocksDBEntryType::Document:
     case RocksDBEntryType::View:
+    case RocksDBEntryType::EdgeIndexValue:
     case RocksDBEntryType::KeyGeneratorValue:
+    case RocksDBEntryType::AttributeStatisticsValue:
+    case RocksDBEntryType::CacheHeatMapValue:
     case RocksDBEntryType::ReplicationApplierConfig: {
       _buffer.reserve(static_cast<size_t>(data.byteSize()));
       _buffer.append(reinterpret_cast<char const*>(data.begin()),
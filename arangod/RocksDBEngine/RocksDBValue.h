@@ -50,11 +50,16 @@ class RocksDBValue {
   static RocksDBValue Document(VPackSlice const& data);
   static RocksDBValue PrimaryIndexValue(TRI_voc_rid_t revisionId);
   static RocksDBValue EdgeIndexValue(arangodb::StringRef const& vertexId);
+  static RocksDBValue EdgeIndexValue(VPackSlice const& storedValues);
   static RocksDBValue VPackIndexValue();
+  static RocksDBValue FulltextIndexValue(uint64_t termFrequency,
+                                         uint64_t documentLength);
   static RocksDBValue UniqueVPackIndexValue(TRI_voc_rid_t revisionId);
   static RocksDBValue View(VPackSlice const& data);
   static RocksDBValue ReplicationApplierConfig(VPackSlice const& data);
   static RocksDBValue KeyGeneratorValue(VPackSlice const& data);
+  static RocksDBValue AttributeStatisticsValue(VPackSlice const& data);
+  static RocksDBValue CacheHeatMapValue(VPackSlice const& data);
 
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Used to construct an empty value of the given type for retrieval
@@ -79,11 +84,24 @@ class RocksDBValue {
   //////////////////////////////////////////////////////////////////////////////
   static StringRef vertexId(rocksdb::Slice const&);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Extracts the number of occurrences of the word and the number of
+  /// words of the document from a value
+  ///
+  /// May be called only on FulltextIndexValue values. Values written before
+  /// these statistics were stored are empty and yield a term frequency of 1
+  /// and a document length of 0.
+  //////////////////////////////////////////////////////////////////////////////
+  static void fulltextStatistics(rocksdb::Slice const&,
+                                 uint64_t& termFrequency,
+                                 uint64_t& documentLength);
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Extracts the VelocyPack data from a value
   ///
   /// May be called only values of the following types: Database, Collection,
-  /// Document, and View. Other types will throw.
+  /// Document, and View, as well as EdgeIndexValue values of edge indexes
+  /// with stored values. Other types will throw.
   //////////////////////////////////////////////////////////////////////////////
   static VPackSlice data(RocksDBValue const&);
   static VPackSlice data(rocksdb::Slice const&);
@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RocksDBWriteBufferTuner.h"
+#include "Basics/ConditionLocker.h"
+#include "Logger/Logger.h"
+
+#include <rocksdb/db.h>
+
+using namespace arangodb;
+
+RocksDBWriteBufferTuner::RocksDBWriteBufferTuner(
+    rocksdb::DB* db, std::vector<rocksdb::ColumnFamilyHandle*> const& cfs,
+    uint64_t writeBufferSize, uint64_t maxWriteBufferSize,
+    int maxWriteBufferNumber, int64_t slowdownTrigger,
+    int64_t maxSlowdownTrigger)
+    : Thread("RocksDBWriteBuffers"),
+      _db(db),
+      _cfs(cfs),
+      _minWriteBufferSize(writeBufferSize),
+      _maxWriteBufferSize((std::max)(writeBufferSize, maxWriteBufferSize)),
+      _maxWriteBufferNumber(maxWriteBufferNumber),
+      _minSlowdownTrigger(slowdownTrigger),
+      _maxSlowdownTrigger((std::max)(slowdownTrigger, maxSlowdownTrigger)),
+      _writeBufferSize(writeBufferSize),
+      _slowdownTrigger(slowdownTrigger),
+      _numDelayed(0),
+      _numStopped(0),
+      _writesPerSecond(0) {}
+
+RocksDBWriteBufferTuner::~RocksDBWriteBufferTuner() { shutdown(); }
+
+void RocksDBWriteBufferTuner::beginShutdown() {
+  Thread::beginShutdown();
+
+  CONDITION_LOCKER(guard, _condition);
+  guard.signal();
+}
+
+void RocksDBWriteBufferTuner::run() {
+  uint64_t lastSequence = _db->GetLatestSequenceNumber();
+  uint64_t idle = 0;
+
+  while (!isStopping()) {
+    {
+      CONDITION_LOCKER(guard, _condition);
+      guard.wait(static_cast<uint64_t>(Interval * 1000000.0));
+    }
+    if (isStopping()) {
+      break;
+    }
+
+    uint64_t const sequence = _db->GetLatestSequenceNumber();
+    uint64_t const writes = sequence - lastSequence;
+    lastSequence = sequence;
+    _writesPerSecond.store(static_cast<uint64_t>(writes / Interval));
+
+    uint64_t delayedRate = 0;
+    uint64_t stopped = 0;
+    _db->GetIntProperty(rocksdb::DB::Properties::kActualDelayedWriteRate,
+                        &delayedRate);
+    _db->GetIntProperty(rocksdb::DB::Properties::kIsWriteStopped, &stopped);
+
+    // flushes fall behind if a column family is about to run out of
+    // write buffers
+    bool behind = false;
+    for (auto cf : _cfs) {
+      uint64_t immutable = 0;
+      if (_db->GetIntProperty(cf, rocksdb::DB::Properties::kNumImmutableMemTable,
+                              &immutable) &&
+          immutable + 1 >= static_cast<uint64_t>(_maxWriteBufferNumber)) {
+        behind = true;
+        break;
+      }
+    }
+
+    if (delayedRate > 0) {
+      ++_numDelayed;
+    }
+    if (stopped > 0) {
+      ++_numStopped;
+    }
+
+    uint64_t const size = _writeBufferSize.load();
+    int64_t const trigger = _slowdownTrigger.load();
+    uint64_t nextSize = size;
+    int64_t nextTrigger = trigger;
+
+    if (delayedRate > 0 || stopped > 0 || behind) {
+      idle = 0;
+      nextSize = (std::min)(size * 2, _maxWriteBufferSize);
+      if ((delayedRate > 0 || stopped > 0) && trigger > 0) {
+        // a negative trigger disables the slowdown by level-0 files
+        nextTrigger = (std::min)(trigger + (std::max)(trigger / 4,
+                                                      static_cast<int64_t>(1)),
+                                 _maxSlowdownTrigger);
+      }
+    } else if (writes == 0) {
+      if (++idle >= IdleIntervals) {
+        idle = 0;
+        nextSize = (std::max)(size / 2, _minWriteBufferSize);
+        nextTrigger = _minSlowdownTrigger;
+      }
+    } else {
+      idle = 0;
+    }
+
+    if (nextSize != size || nextTrigger != trigger) {
+      LOG_TOPIC(DEBUG, Logger::ROCKSDB)
+          << "adjusting rocksdb write buffer size from " << size << " to "
+          << nextSize << ", level-0 slowdown trigger from " << trigger
+          << " to " << nextTrigger;
+      _writeBufferSize.store(nextSize);
+      _slowdownTrigger.store(nextTrigger);
+      apply();
+    }
+  }
+}
+
+void RocksDBWriteBufferTuner::apply() {
+  std::unordered_map<std::string, std::string> options{
+      {"write_buffer_size", std::to_string(_writeBufferSize.load())},
+      {"level0_slowdown_writes_trigger",
+       std::to_string(_slowdownTrigger.load())}};
+
+  for (auto cf : _cfs) {
+    rocksdb::Status s = _db->SetOptions(cf, options);
+    if (!s.ok()) {
+      LOG_TOPIC(WARN, Logger::ROCKSDB)
+          << "could not adjust write buffer options: " << s.ToString();
+    }
+  }
+}
@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_ROCKSDB_ENGINE_WRITE_BUFFER_TUNER_H
+#define ARANGOD_ROCKSDB_ENGINE_WRITE_BUFFER_TUNER_H 1
+
+#include "Basics/Common.h"
+#include "Basics/ConditionVariable.h"
+#include "Basics/Thread.h"
+
+namespace rocksdb {
+class ColumnFamilyHandle;
+class DB;
+}
+
+namespace arangodb {
+
+/// @brief adjusts the write buffer size and the level-0 slowdown trigger of
+/// the column families to the write load. while writes are delayed or
+/// stopped, or flushes fall behind the ingest, the write buffers grow, so
+/// that fewer and larger level-0 files are written, and the slowdown
+/// trigger rises towards the stop trigger. after a while without writes
+/// both go back to the configured values, returning the memory
+class RocksDBWriteBufferTuner : public Thread {
+ public:
+  /// @brief writeBufferSize and slowdownTrigger are the configured values,
+  /// maxWriteBufferSize and maxSlowdownTrigger the upper limits
+  RocksDBWriteBufferTuner(rocksdb::DB* db,
+                          std::vector<rocksdb::ColumnFamilyHandle*> const& cfs,
+                          uint64_t writeBufferSize, uint64_t maxWriteBufferSize,
+                          int maxWriteBufferNumber, int64_t slowdownTrigger,
+                          int64_t maxSlowdownTrigger);
+  ~RocksDBWriteBufferTuner();
+
+  void beginShutdown() override;
+
+  /// @brief number of intervals in which writes were delayed
+  uint64_t numDelayed() const { return _numDelayed.load(); }
+
+  /// @brief number of intervals in which writes were stopped
+  uint64_t numStopped() const { return _numStopped.load(); }
+
+  /// @brief writes per second in the last interval
+  uint64_t writesPerSecond() const { return _writesPerSecond.load(); }
+
+  /// @brief current write buffer size of the column families
+  uint64_t writeBufferSize() const { return _writeBufferSize.load(); }
+
+  /// @brief current level-0 slowdown trigger of the column families
+  int64_t slowdownTrigger() const { return _slowdownTrigger.load(); }
+
+ protected:
+  void run() override;
+
+ private:
+  /// @brief applies the current values to all column families
+  void apply();
+
+ private:
+  /// @brief interval (in seconds) in which the load is observed
+  static constexpr double Interval = 1.0;
+
+  /// @brief number of intervals without writes after which the values are
+  /// lowered again
+  static constexpr uint64_t IdleIntervals = 30;
+
+  rocksdb::DB* _db;
+
+  std::vector<rocksdb::ColumnFamilyHandle*> const _cfs;
+
+  uint64_t const _minWriteBufferSize;
+
+  uint64_t const _maxWriteBufferSize;
+
+  int const _maxWriteBufferNumber;
+
+  int64_t const _minSlowdownTrigger;
+
+  int64_t const _maxSlowdownTrigger;
+
+  std::atomic<uint64_t> _writeBufferSize;
+
+  std::atomic<int64_t> _slowdownTrigger;
+
+  std::atomic<uint64_t> _numDelayed;
+
+  std::atomic<uint64_t> _numStopped;
+
+  std::atomic<uint64_t> _writesPerSecond;
+
+  arangodb::basics::ConditionVariable _condition;
+};
+}  // namespace arangodb
+
+#endif
@@ -33,7 +33,8 @@ using namespace arangodb;
 
 Acceptor::Acceptor(boost::asio::io_service& ioService, Endpoint* endpoint)
   : _ioService(ioService),
-    _endpoint(endpoint) {
+    _endpoint(endpoint),
+    _reusePort(false) {
 }
 
 std::unique_ptr<Acceptor> Acceptor::factory(
@@ -40,6 +40,10 @@ class Acceptor {
     virtual void close() = 0;
     virtual void asyncAccept(AcceptHandler const& handler) = 0;
     std::unique_ptr<Socket> movePeer() { return std::move(_peer); };
+
+    // several acceptors may listen on the same port, must be called
+    // before open
+    void setReusePort(bool value) { _reusePort = value; }
   
   public:
     static std::unique_ptr<Acceptor> factory(
@@ -52,6 +56,7 @@ class Acceptor {
     boost::asio::io_service& _ioService;
     Endpoint* _endpoint;
     std::unique_ptr<Socket> _peer;
+    bool _reusePort;
 };
 }
 #endif
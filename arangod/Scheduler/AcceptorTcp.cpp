@@ -68,6 +68,15 @@ void AcceptorTcp::open() {
       boost::asio::ip::tcp::acceptor::reuse_address(
         ((EndpointIp*)_endpoint)->reuseAddress()));
 
+#ifdef SO_REUSEPORT
+  if (_reusePort) {
+    // the kernel distributes the connections over all acceptors
+    _acceptor.set_option(
+        boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(
+            true));
+  }
+#endif
+
   _acceptor.bind(asioEndpoint, err);
   if (err) {
     LOG_TOPIC(ERR, Logger::COMMUNICATION) << "unable to bind endpoint: " << err.message();
@@ -87,11 +96,9 @@ void AcceptorTcp::asyncAccept(AcceptHandler const& handler) {
 
 void AcceptorTcp::createPeer() {
   if (_endpoint->encryption() == Endpoint::EncryptionType::SSL) {
-    _peer.reset(new SocketTcp(_ioService, SslServerFeature::SSL->createSslContext(), true));
+    _peer.reset(new SocketTcp(_ioService, SslServerFeature::SSL->sslContext(), true));
   } else {
-    _peer.reset(new SocketTcp(
-        _ioService,
-        boost::asio::ssl::context(boost::asio::ssl::context::method::sslv23),
-        false));
+    _peer.reset(
+        new SocketTcp(_ioService, Socket::unencryptedContext(), false));
   }
 }
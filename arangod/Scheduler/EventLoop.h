@@ -35,13 +35,18 @@ class Scheduler;
 }
 
 struct EventLoop {
-  EventLoop(boost::asio::io_service* ioService, rest::Scheduler* scheduler)
-      : _ioService(ioService), _scheduler(scheduler) {}
+  EventLoop(boost::asio::io_service* ioService, rest::Scheduler* scheduler,
+            bool reactor = false)
+      : _ioService(ioService), _scheduler(scheduler), _reactor(reactor) {}
 
   EventLoop() : EventLoop(nullptr, nullptr) {}
 
   boost::asio::io_service* _ioService;
   rest::Scheduler* _scheduler;
+
+  // the io_service is owned by a single reactor thread and not by the
+  // scheduler threads
+  bool _reactor;
 };
 }
 
@@ -44,6 +44,9 @@ class Job {
   rest::GeneralServer* _server;
   std::shared_ptr<rest::RestHandler> _handler;
   std::function<void(std::shared_ptr<rest::RestHandler>)> _callback;
+
+  // time the job entered the JobQueue
+  double _queueStart;
 };
 }
 
@@ -105,15 +105,56 @@ class JobQueueThread final
 };
 }  // namespace arangodb
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      static data
+// -----------------------------------------------------------------------------
+
+uint64_t const JobQueue::QUEUE_WEIGHTS[JobQueue::NUMBER_OF_QUEUES] = {8, 4, 2,
+                                                                      1};
+
+double const JobQueue::TARGET_SOJOURN = 0.1;
+double const JobQueue::SOJOURN_INTERVAL = 1.0;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
 
 JobQueue::JobQueue(size_t maxQueueSize, rest::Scheduler* scheduler)
-    : _maxQueueSize(static_cast<int64_t>(maxQueueSize)),
-      _queue(maxQueueSize == 0 ? 512 : maxQueueSize),
-      _queueSize(0),
-      _queueThread(new JobQueueThread(this, scheduler)) {}
+    : _queueSize(0),
+      _currentLane(CLUSTER_QUEUE),
+      _queueThread(new JobQueueThread(this, scheduler)) {
+  int64_t limit = static_cast<int64_t>(maxQueueSize);
+
+  for (size_t i = 0; i < NUMBER_OF_QUEUES; ++i) {
+    Lane& lane = _lanes[i];
+
+    // cluster-internal requests must not be rejected because clients
+    // flooded the server, background work gets a smaller share
+    if (limit == 0) {
+      lane._maxQueueSize = 0;
+    } else if (i == CLUSTER_QUEUE) {
+      lane._maxQueueSize = 2 * limit;
+    } else if (i == BACKGROUND_QUEUE) {
+      lane._maxQueueSize = (std::max)(limit / 4, static_cast<int64_t>(1));
+    } else {
+      lane._maxQueueSize = limit;
+    }
+
+    lane._queue.reset(new boost::lockfree::queue<Job*>(
+        lane._maxQueueSize == 0 ? 512 : lane._maxQueueSize));
+    lane._credits = QUEUE_WEIGHTS[i];
+  }
+}
+
+JobQueue::~JobQueue() {
+  Job* job = nullptr;
+
+  for (auto& lane : _lanes) {
+    while (lane._queue->pop(job)) {
+      delete job;
+    }
+  }
+}
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    public methods
@@ -123,6 +164,78 @@ void JobQueue::start() { _queueThread->start(); }
 
 void JobQueue::beginShutdown() { _queueThread->beginShutdown(); }
 
+bool JobQueue::queue(std::unique_ptr<Job> job) {
+  size_t const laneId = laneOf(job.get());
+  Lane& lane = _lanes[laneId];
+
+  try {
+    if (0 < lane._maxQueueSize && lane._maxQueueSize <= lane._queueSize) {
+      ++lane._rejected;
+      wakeup();
+      return false;
+    }
+
+    // shed low-priority work early instead of letting it wait until the
+    // client gives up
+    if (isSheddable(laneId) && lane._overloaded.load()) {
+      ++lane._rejected;
+      wakeup();
+      return false;
+    }
+
+    job->_queueStart = TRI_microtime();
+
+    if (!lane._queue->push(job.get())) {
+      wakeup();
+      return false;
+    }
+
+    job.release();
+    ++lane._queueSize;
+    ++_queueSize;
+  } catch (...) {
+    wakeup();
+    return false;
+  }
+
+  wakeup();
+  return true;
+}
+
+bool JobQueue::pop(Job*& job) {
+  // every lane is visited at least once with a full set of credits, so an
+  // empty result means that all lanes were empty
+  for (size_t i = 0; i < 2 * NUMBER_OF_QUEUES; ++i) {
+    Lane& lane = _lanes[_currentLane];
+
+    if (0 < lane._credits && lane._queue->pop(job)) {
+      --lane._credits;
+      --lane._queueSize;
+      --_queueSize;
+
+      if (job != nullptr) {
+        double now = TRI_microtime();
+        updateSojourn(lane, now - job->_queueStart, now);
+        return true;
+      }
+
+      continue;
+    }
+
+    if (lane._queueSize.load() == 0) {
+      // a drained lane is not overloaded
+      lane._firstAboveTime = 0.0;
+      lane._overloaded = false;
+    }
+
+    // lane exhausted or empty, refill its credits and serve the next one
+    lane._credits = QUEUE_WEIGHTS[_currentLane];
+    _currentLane = (_currentLane + 1) % NUMBER_OF_QUEUES;
+  }
+
+  return false;
+}
+
 void JobQueue::wakeup() {
   CONDITION_LOCKER(guard, _queueCondition);
   guard.signal();
@@ -134,3 +247,48 @@ void JobQueue::waitForWork() {
   CONDITION_LOCKER(guard, _queueCondition);
   guard.wait(WAIT_TIME);
 }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+size_t JobQueue::laneOf(Job const* job) {
+  if (job->_handler == nullptr) {
+    return STANDARD_QUEUE;
+  }
+
+  size_t lane = job->_handler->queue();
+
+  if (lane >= NUMBER_OF_QUEUES) {
+    return STANDARD_QUEUE;
+  }
+
+  return lane;
+}
+
+bool JobQueue::isSheddable(size_t lane) {
+  return lane == STANDARD_QUEUE || lane == BACKGROUND_QUEUE;
+}
+
+// CoDel: a single slow job does not matter, the lane is overloaded if the
+// waiting time stays above the target for a whole interval
+void JobQueue::updateSojourn(Lane& lane, double sojourn, double now) {
+  lane._sojournTime = sojourn;
+
+  if (sojourn < TARGET_SOJOURN) {
+    lane._firstAboveTime = 0.0;
+
+    if (lane._overloaded.load()) {
+      lane._overloaded = false;
+      LOG_TOPIC(DEBUG, Logger::THREADS)
+          << "queue latency is back to normal, accepting jobs again";
+    }
+  } else if (lane._firstAboveTime == 0.0) {
+    lane._firstAboveTime = now + SOJOURN_INTERVAL;
+  } else if (lane._firstAboveTime <= now && !lane._overloaded.load()) {
+    lane._overloaded = true;
+    LOG_TOPIC(DEBUG, Logger::THREADS)
+        << "queue latency above " << TARGET_SOJOURN
+        << " s, shedding low-priority jobs";
+  }
+}
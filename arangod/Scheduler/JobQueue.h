@@ -41,60 +41,91 @@ class JobQueueThread;
 
 class JobQueue {
  public:
-  // ordered by priority (highst prio first)
-  static size_t const AQL_QUEUE = 1;
+  // lanes, ordered by priority (highest prio first)
+  //
+  // CLUSTER_QUEUE:    cluster-internal traffic (agency, /_api/aql, callbacks)
+  // FAST_QUEUE:       cheap client requests
+  // STANDARD_QUEUE:   everything else, including long-running client requests
+  // BACKGROUND_QUEUE: replication, dumps and other bulk operations
+  static size_t const CLUSTER_QUEUE = 0;
+  static size_t const FAST_QUEUE = 1;
   static size_t const STANDARD_QUEUE = 2;
+  static size_t const BACKGROUND_QUEUE = 3;
+
+  static size_t const NUMBER_OF_QUEUES = 4;
+
+  // the number of jobs taken from a lane before the next lane is served
+  static uint64_t const QUEUE_WEIGHTS[NUMBER_OF_QUEUES];
+
+  // admission control: once the jobs of a lane waited longer than
+  // TARGET_SOJOURN for at least SOJOURN_INTERVAL seconds, the lane is
+  // overloaded and low-priority lanes reject new jobs until the waiting
+  // time drops below the target again
+  static double const TARGET_SOJOURN;
+  static double const SOJOURN_INTERVAL;
 
  public:
   JobQueue(size_t maxQueueSize, rest::Scheduler*);
+  ~JobQueue();
 
  public:
   void start();
   void beginShutdown();
 
   int64_t queueSize() const { return _queueSize; }
+  int64_t queueSize(size_t lane) const { return _lanes[lane]._queueSize; }
 
-  bool queue(std::unique_ptr<Job> job) {
-    try {
-      if (0 < _maxQueueSize && _maxQueueSize <= _queueSize) {
-        wakeup();
-        return false;
-      }
-
-      if (!_queue.push(job.get())) {
-        wakeup();
-        return false;
-      }
-
-      job.release();
-      ++_queueSize;
-    } catch (...) {
-      wakeup();
-      return false;
-    }
+  // waiting time of the last job taken from the lane, in seconds
+  double sojournTime(size_t lane) const { return _lanes[lane]._sojournTime; }
+  bool isOverloaded(size_t lane) const { return _lanes[lane]._overloaded; }
+  uint64_t rejected(size_t lane) const { return _lanes[lane]._rejected; }
 
-    wakeup();
-    return true;
-  }
+  // queues a job in the lane declared by its handler
+  bool queue(std::unique_ptr<Job> job);
 
-  bool pop(Job*& job) {
-    bool ok = _queue.pop(job) && job != nullptr;
-
-    if (ok) {
-      --_queueSize;
-    }
-
-    return ok;
-  }
+  // takes the next job using weighted round robin over the lanes, must
+  // only be called from the queue thread
+  bool pop(Job*& job);
 
   void wakeup();
   void waitForWork();
 
  private:
-  int64_t const _maxQueueSize;
-  boost::lockfree::queue<Job*> _queue;
+  struct Lane {
+    Lane()
+        : _maxQueueSize(0),
+          _queueSize(0),
+          _credits(0),
+          _firstAboveTime(0.0),
+          _sojournTime(0.0),
+          _overloaded(false),
+          _rejected(0) {}
+
+    int64_t _maxQueueSize;
+    std::unique_ptr<boost::lockfree::queue<Job*>> _queue;
+    std::atomic<int64_t> _queueSize;
+    uint64_t _credits;
+
+    // only used by the queue thread
+    double _firstAboveTime;
+
+    std::atomic<double> _sojournTime;
+    std::atomic<bool> _overloaded;
+    std::atomic<uint64_t> _rejected;
+  };
+
+  static size_t laneOf(Job const*);
+  static bool isSheddable(size_t lane);
+
+  void updateSojourn(Lane&, double sojourn, double now);
+
+ private:
+  Lane _lanes[NUMBER_OF_QUEUES];
   std::atomic<int64_t> _queueSize;
 
+  // lane currently served by pop(), only used by the queue thread
+  size_t _currentLane;
+
   basics::ConditionVariable _queueCondition;
 
   std::shared_ptr<JobQueueThread> _queueThread;
@@ -48,6 +48,10 @@ class ListenTask : virtual public rest::Task {
  public:
   Endpoint* endpoint() const { return _endpoint; }
 
+  // allows other listen tasks to bind the same endpoint, must be called
+  // before start
+  void setReusePort(bool value) { _acceptor->setReusePort(value); }
+
   bool start();
   void stop();
 
@@ -41,6 +41,7 @@
 #include "Scheduler/JobGuard.h"
 #include "Scheduler/JobQueue.h"
 #include "Scheduler/Task.h"
+#include "Scheduler/WorkStealingQueue.h"
 
 #include <thread>
 
@@ -48,6 +49,30 @@ using namespace arangodb;
 using namespace arangodb::basics;
 using namespace arangodb::rest;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     work stealing
+// -----------------------------------------------------------------------------
+
+namespace {
+// queue of the current SchedulerThread, nullptr in all other threads
+thread_local WorkStealingQueue* LOCAL_QUEUE = nullptr;
+
+// picks the victim of a steal, does not need to be a good random generator
+thread_local uint64_t STEAL_SEED = 0;
+
+uint64_t nextVictim() {
+  if (STEAL_SEED == 0) {
+    STEAL_SEED = reinterpret_cast<uintptr_t>(&STEAL_SEED) | 1;
+  }
+
+  STEAL_SEED ^= STEAL_SEED << 13;
+  STEAL_SEED ^= STEAL_SEED >> 7;
+  STEAL_SEED ^= STEAL_SEED << 17;
+
+  return STEAL_SEED;
+}
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                            SchedulerManagerThread
 // -----------------------------------------------------------------------------
@@ -81,6 +106,44 @@ class SchedulerManagerThread : public Thread {
 };
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     ReactorThread
+// -----------------------------------------------------------------------------
+
+namespace {
+class ReactorThread : public Thread {
+ public:
+  ReactorThread(Scheduler* scheduler, boost::asio::io_service* service)
+      : Thread("SchedulerReactor"), _scheduler(scheduler), _service(service) {}
+
+  ~ReactorThread() { shutdown(); }
+
+ public:
+  void run() {
+    // the reactor owns its io_service, all I/O of the connections accepted
+    // here is handled by this thread only
+    while (!_scheduler->isStopping()) {
+      try {
+        _service->run();
+        break;
+      } catch (std::exception const& ex) {
+        LOG_TOPIC(ERR, Logger::THREADS)
+            << "reactor loop caught exception, restarting: " << ex.what();
+      } catch (...) {
+        LOG_TOPIC(ERR, Logger::THREADS)
+            << "reactor loop caught an error, restarting";
+      }
+    }
+
+    _scheduler->threadDone(this);
+  }
+
+ private:
+  Scheduler* _scheduler;
+  boost::asio::io_service* _service;
+};
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   SchedulerThread
 // -----------------------------------------------------------------------------
@@ -100,6 +163,7 @@ class SchedulerThread : public Thread {
                                       << _scheduler->infoStatus() << ")";
 
     auto start = std::chrono::steady_clock::now();
+    auto queue = _scheduler->registerQueue();
 
     try {
       static size_t EVERY_LOOP = 1000;
@@ -109,7 +173,12 @@ class SchedulerThread : public Thread {
       bool doDecrement = true;
 
       while (!_scheduler->isStopping()) {
-        _service->run_one();
+        if (_scheduler->runQueued(queue.get())) {
+          // keep the reactor going while there is queued work
+          _service->poll_one();
+        } else {
+          _scheduler->waitForWork();
+        }
 
         if (++counter > EVERY_LOOP) {
           counter = 0;
@@ -152,6 +221,7 @@ class SchedulerThread : public Thread {
       _scheduler->startNewThread();
     }
 
+    _scheduler->unregisterQueue(queue);
     _scheduler->threadDone(this);
   }
 
@@ -179,7 +249,13 @@ Scheduler::Scheduler(uint64_t nrMinimum, uint64_t nrDesired, uint64_t nrMaximum,
       _nrWorking(0),
       _nrQueued(0),
       _nrBlocked(0),
-      _nrRunning(0) {
+      _nrRunning(0),
+      _queues(std::make_shared<std::vector<std::shared_ptr<WorkStealingQueue>>>()),
+      _nrStealable(0),
+      _nrSleeping(0),
+      _nextQueue(0),
+      _nrReactors(0),
+      _pinReactors(false) {
   // setup signal handlers
   initializeSignalHandlers();
 }
@@ -200,17 +276,134 @@ Scheduler::~Scheduler() {
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
 
+void Scheduler::setReactorThreads(uint64_t nrReactors, bool pin) {
+  TRI_ASSERT(_ioService == nullptr);
+  _nrReactors = nrReactors;
+  _pinReactors = pin;
+}
+
+std::vector<EventLoop> Scheduler::reactorLoops() {
+  std::vector<EventLoop> loops;
+  loops.reserve(_reactorServices.size());
+
+  for (auto& service : _reactorServices) {
+    loops.emplace_back(service.get(), this, true);
+  }
+
+  return loops;
+}
+
+
 void Scheduler::post(std::function<void()> callback) {
   ++_nrQueued;
 
-  _ioService.get()->post([this, callback]() {
+  std::function<void()> wrapped = [this, callback]() {
     JobGuard guard(this);
     guard.work();
 
     --_nrQueued;
 
     callback();
-  });
+  };
+
+  if (pushQueued(wrapped)) {
+    return;
+  }
+
+  // no SchedulerThread is accepting work, fall back to the io_service
+  _ioService.get()->post(std::move(wrapped));
+}
+
+std::shared_ptr<WorkStealingQueue> Scheduler::registerQueue() {
+  auto queue = std::make_shared<WorkStealingQueue>();
+
+  {
+    MUTEX_LOCKER(guard, _queuesLock);
+
+    auto queues = std::make_shared<std::vector<std::shared_ptr<WorkStealingQueue>>>(
+        *std::atomic_load(&_queues));
+    queues->emplace_back(queue);
+    std::atomic_store(&_queues, queues);
+  }
+
+  LOCAL_QUEUE = queue.get();
+  return queue;
+}
+
+void Scheduler::unregisterQueue(std::shared_ptr<WorkStealingQueue> const& queue) {
+  LOCAL_QUEUE = nullptr;
+
+  {
+    MUTEX_LOCKER(guard, _queuesLock);
+
+    auto queues = std::make_shared<std::vector<std::shared_ptr<WorkStealingQueue>>>(
+        *std::atomic_load(&_queues));
+    queues->erase(std::remove(queues->begin(), queues->end(), queue),
+                  queues->end());
+    std::atomic_store(&_queues, queues);
+  }
+
+  // hand over the work this thread did not get to
+  auto rest = queue->close();
+  _nrStealable -= static_cast<int64_t>(rest.size());
+
+  for (auto& callback : rest) {
+    if (!pushQueued(callback)) {
+      _ioService.get()->post(std::move(callback));
+    }
+  }
+}
+
+bool Scheduler::runQueued(WorkStealingQueue* own) {
+  std::function<void()> callback;
+
+  if (own == nullptr || !own->pop(callback)) {
+    // the counter is only a hint, it is updated after the queues
+    if (_nrStealable.load() <= 0) {
+      return false;
+    }
+
+    auto queues = std::atomic_load(&_queues);
+    size_t n = queues->size();
+
+    if (n == 0) {
+      return false;
+    }
+
+    size_t start = static_cast<size_t>(nextVictim() % n);
+    bool found = false;
+
+    for (size_t i = 0; i < n; ++i) {
+      auto& victim = (*queues)[(start + i) % n];
+
+      if (victim.get() != own && 0 < victim->size() &&
+          victim->steal(callback)) {
+        found = true;
+        break;
+      }
+    }
+
+    if (!found) {
+      return false;
+    }
+  }
+
+  --_nrStealable;
+  callback();
+
+  return true;
+}
+
+void Scheduler::waitForWork() {
+  // announce the sleep before checking for work, pushQueued() does it the
+  // other way round, so one of both sees the other
+  ++_nrSleeping;
+
+  if (_nrStealable.load() <= 0) {
+    _ioService->run_one();
+  }
+
+  --_nrSleeping;
 }
 
 bool Scheduler::start(ConditionVariable* cv) {
@@ -226,6 +419,7 @@ bool Scheduler::start(ConditionVariable* cv) {
   }
 
   startManagerThread();
+  startReactorThreads();
   startRebalancer();
 
   // initialize the queue handling
@@ -245,6 +439,40 @@ void Scheduler::startIoService() {
   _managerGuard.reset(new boost::asio::io_service::work(*_managerService));
 }
 
+void Scheduler::startReactorThreads() {
+  size_t const cores = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+  for (uint64_t i = 0; i < _nrReactors; ++i) {
+    _reactorServices.emplace_back(new boost::asio::io_service(1));
+    _reactorGuards.emplace_back(
+        new boost::asio::io_service::work(*_reactorServices.back()));
+  }
+
+  MUTEX_LOCKER(guard, _threadsLock);
+
+  for (uint64_t i = 0; i < _nrReactors; ++i) {
+    auto thread = new ReactorThread(this, _reactorServices[i].get());
+
+    try {
+      _threads.emplace(thread);
+    } catch (...) {
+      delete thread;
+      throw;
+    }
+
+    if (_pinReactors) {
+      thread->setProcessorAffinity(i % cores);
+    }
+
+    thread->start();
+  }
+
+  if (_nrReactors > 0) {
+    LOG_TOPIC(DEBUG, Logger::THREADS) << "started " << _nrReactors
+                                      << " reactor threads";
+  }
+}
+
 void Scheduler::startRebalancer() {
   std::chrono::milliseconds interval(100);
   _threadManager.reset(new boost::asio::steady_timer(*_managerService));
@@ -344,15 +572,59 @@ bool Scheduler::queue(std::unique_ptr<Job> job) {
   return _jobQueue->queue(std::move(job));
 }
 
+bool Scheduler::pushQueued(std::function<void()>& callback) {
+  bool ok = false;
+
+  if (LOCAL_QUEUE != nullptr) {
+    // continuation of the work of this thread, keep it hot in this thread
+    ok = LOCAL_QUEUE->pushLocal(callback);
+  }
+
+  if (!ok) {
+    auto queues = std::atomic_load(&_queues);
+    size_t n = queues->size();
+
+    for (size_t i = 0; i < n && !ok; ++i) {
+      ok = (*queues)[_nextQueue++ % n]->push(callback);
+    }
+  }
+
+  if (!ok) {
+    return false;
+  }
+
+  ++_nrStealable;
+  wakeupThread();
+
+  return true;
+}
+
+void Scheduler::wakeupThread() {
+  if (_nrSleeping.load() > 0) {
+    // lets one sleeping SchedulerThread return from run_one
+    _ioService->post([]() {});
+  }
+}
+
 std::string Scheduler::infoStatus() {
   auto jobQueue = _jobQueue.get();
   auto queueSize = (jobQueue == nullptr) ? 0 : jobQueue->queueSize();
 
+  std::string lanes;
+
+  if (jobQueue != nullptr) {
+    for (size_t i = 0; i < JobQueue::NUMBER_OF_QUEUES; ++i) {
+      lanes += (i == 0 ? "" : "/") + std::to_string(jobQueue->queueSize(i));
+    }
+  } else {
+    lanes = "-";
+  }
+
   return "working: " + std::to_string(_nrWorking) + ", queued: " +
          std::to_string(_nrQueued) + ", blocked: " +
          std::to_string(_nrBlocked) + ", running: " +
          std::to_string(_nrRunning) + ", outstanding: " +
-         std::to_string(queueSize) + ", min/des/max: " +
+         std::to_string(queueSize) + " (" + lanes + "), min/des/max: " +
          std::to_string(_nrMinimum) + "/" + std::to_string(_nrDesired) + "/" +
          std::to_string(_nrMaximum);
 }
@@ -424,6 +696,12 @@ void Scheduler::beginShutdown() {
   _serviceGuard.reset();
   _ioService->stop();
 
+  _reactorGuards.clear();
+
+  for (auto& service : _reactorServices) {
+    service->stop();
+  }
+
   // set the flag AFTER stopping the threads
   _stopping = true;
 }
@@ -453,6 +731,7 @@ void Scheduler::shutdown() {
   // - delete io service
   WorkMonitor::clearWorkDescriptions();
 
+  _reactorServices.clear();
   _managerService.reset();
   _ioService.reset();
 }
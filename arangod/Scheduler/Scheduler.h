@@ -40,6 +40,7 @@
 namespace arangodb {
 class JobQueue;
 class JobGuard;
+class WorkStealingQueue;
 
 namespace basics {
 class ConditionVariable;
@@ -73,6 +74,13 @@ class Scheduler {
     return EventLoop{_ioService.get(), this};
   }
 
+  // event loops of the reactor threads, empty if the scheduler threads
+  // handle all I/O themselves
+  std::vector<EventLoop> reactorLoops();
+
+  // must be called before start
+  void setReactorThreads(uint64_t nrReactors, bool pin);
+
   void post(std::function<void()> callback);
 
   bool start(basics::ConditionVariable*);
@@ -94,6 +102,11 @@ class Scheduler {
 
   uint64_t minimum() const { return _nrMinimum; }
 
+  JobQueue const* jobQueue() const { return _jobQueue.get(); }
+
+  // number of jobs waiting for a worker thread
+  uint64_t numQueued() const { return _nrQueued.load(); }
+
   uint64_t incRunning() { return ++_nrRunning; }
   uint64_t decRunning() { return --_nrRunning; }
 
@@ -102,6 +115,12 @@ class Scheduler {
   void startNewThread();
   void threadDone(Thread*);
   void deleteOldThreads();
+
+  // work stealing, used by the scheduler threads
+  std::shared_ptr<WorkStealingQueue> registerQueue();
+  void unregisterQueue(std::shared_ptr<WorkStealingQueue> const&);
+  bool runQueued(WorkStealingQueue*);
+  void waitForWork();
   
   void stopRebalancer() noexcept;
 
@@ -112,9 +131,13 @@ class Scheduler {
   void blockThread() { ++_nrBlocked; }
   void unblockThread() { --_nrBlocked; }
 
+  bool pushQueued(std::function<void()>& callback);
+  void wakeupThread();
+
   void startIoService();
   void startRebalancer();
   void startManagerThread();
+  void startReactorThreads();
   void rebalanceThreads();
 
  private:
@@ -147,12 +170,32 @@ class Scheduler {
 
   std::unique_ptr<JobQueue> _jobQueue;
 
+  // queues of the SchedulerThreads, copied on write
+  Mutex _queuesLock;
+  std::shared_ptr<std::vector<std::shared_ptr<WorkStealingQueue>>> _queues;
+
+  // number of callbacks in the queues of the SchedulerThreads
+  std::atomic<int64_t> _nrStealable;
+
+  // number of SchedulerThreads waiting in the io_service for work
+  std::atomic<uint64_t> _nrSleeping;
+
+  // queue receiving the next callback posted from outside the scheduler
+  std::atomic<uint64_t> _nextQueue;
+
   boost::shared_ptr<boost::asio::io_service::work> _serviceGuard;
   std::unique_ptr<boost::asio::io_service> _ioService;
 
   boost::shared_ptr<boost::asio::io_service::work> _managerGuard;
   std::unique_ptr<boost::asio::io_service> _managerService;
 
+  // number of reactor threads, each one runs its own io_service
+  uint64_t _nrReactors;
+  bool _pinReactors;
+
+  std::vector<boost::shared_ptr<boost::asio::io_service::work>> _reactorGuards;
+  std::vector<std::unique_ptr<boost::asio::io_service>> _reactorServices;
+
   std::unique_ptr<boost::asio::steady_timer> _threadManager;
   std::function<void(const boost::system::error_code&)> _threadHandler;
 
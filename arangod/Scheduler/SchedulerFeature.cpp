@@ -78,6 +78,16 @@ void SchedulerFeature::collectOptions(
                      "maximum queue length for pending operations (use 0 for unrestricted)",
                      new UInt64Parameter(&_queueSize));
 
+  options->addOption("--server.io-threads",
+                     "number of reactor threads handling the connections, "
+                     "each one with its own event loop (use 0 to handle "
+                     "the I/O in the scheduler threads)",
+                     new UInt64Parameter(&_nrIoThreads));
+
+  options->addOption("--server.pin-io-threads",
+                     "pin the reactor threads to cores",
+                     new BooleanParameter(&_pinIoThreads));
+
   options->addOldOption("scheduler.threads", "server.threads");
 }
 
@@ -265,6 +275,8 @@ void SchedulerFeature::buildScheduler() {
                                   _nrMaximalThreads,
                                   _queueSize);
 
+  _scheduler->setReactorThreads(_nrIoThreads, _pinIoThreads);
+
   SCHEDULER = _scheduler.get();
 }
 
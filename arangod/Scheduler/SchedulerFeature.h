@@ -57,6 +57,8 @@ class SchedulerFeature final : public application_features::ApplicationFeature {
   uint64_t _nrMinimalThreads = 0;
   uint64_t _nrMaximalThreads = 0;
   uint64_t _queueSize = 0;
+  uint64_t _nrIoThreads = 0;
+  bool _pinIoThreads = false;
 
  public:
   size_t concurrency() const {
@@ -24,20 +24,28 @@
 
 using namespace arangodb;
 
-bool Socket::handshake() {
-  if (!_encrypted) {
-    return true;
+void Socket::asyncHandshake(HandshakeHandler const& handler) {
+  if (!_encrypted || _handshakeDone) {
+    handler(boost::system::error_code());
+    return;
   }
 
-  if (_handshakeDone) {
-    return true;
-  }
-  
-  bool ok = sslHandshake();
+  asyncSslHandshake([this, handler](boost::system::error_code const& ec) {
+    if (!ec) {
+      _handshakeDone = true;
+    }
 
-  if (ok) {
-    _handshakeDone = true;
-  }
+    handler(ec);
+  });
+}
+
+std::shared_ptr<boost::asio::ssl::context> const&
+Socket::unencryptedContext() {
+  // the SSL stream wrapping an unencrypted socket is never used, but
+  // creating a context for every connection is expensive
+  static std::shared_ptr<boost::asio::ssl::context> const context =
+      std::make_shared<boost::asio::ssl::context>(
+          boost::asio::ssl::context::method::sslv23);
 
-  return ok;
+  return context;
 }
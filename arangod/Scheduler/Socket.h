@@ -39,65 +39,10 @@ typedef std::function<void(const boost::system::error_code& ec,
                            std::size_t transferred)>
     AsyncHandler;
 
-namespace socketcommon {
-template <typename T>
-bool doSslHandshake(T& socket) {
-  boost::system::error_code ec;
-
-  uint64_t tries = 0;
-  double start = 0.0;
-
-  while (true) {
-    ec.assign(boost::system::errc::success,
-	boost::system::generic_category());
-    socket.handshake(
-	boost::asio::ssl::stream_base::handshake_type::server, ec);
-
-    if (ec.value() != boost::asio::error::would_block) {
-      break;
-    }
-
-    // got error EWOULDBLOCK and need to try again
-    ++tries;
-
-    // following is a helpless fix for connections hanging in the handshake
-    // phase forever. we've seen this happening when the underlying peer
-    // connection was closed during the handshake.
-    // with the helpless fix, handshakes will be aborted it they take longer 
-    // than x seconds. a proper fix is to make the handshake run asynchronously
-    // and somehow signal it that the connection got closed. apart from that
-    // running it asynchronously will not block the scheduler thread as it 
-    // does now. anyway, even the helpless fix allows self-healing of busy
-    // scheduler threads after a network failure
-    if (tries == 1) {
-      // capture start time of handshake
-      start = TRI_microtime();
-    } else if (tries % 50 == 0) {
-      // check if we have spent more than x seconds handshaking and then abort
-      TRI_ASSERT(start != 0.0);
-
-      if (TRI_microtime() - start >= 3) {
-	ec.assign(boost::asio::error::connection_reset,
-	    boost::system::generic_category());
-	LOG_TOPIC(DEBUG, Logger::COMMUNICATION) << "forcefully shutting down connection after wait time";
-	break;
-      } else {
-	usleep(10000);
-      }
-    }
-
-    // next iteration
-  }
-
-  if (ec) {
-    LOG_TOPIC(ERR, Logger::COMMUNICATION)
-        << "unable to perform ssl handshake: " << ec.message() << " : "
-        << ec.value();
-    return false;
-  }
-  return true;
-}
+typedef std::function<void(const boost::system::error_code& ec)>
+    HandshakeHandler;
 
+namespace socketcommon {
 template <typename T>
 size_t doWrite(T& socket, basics::StringBuffer* buffer,
                boost::system::error_code& ec) {
@@ -110,6 +55,18 @@ void doAsyncWrite(T& socket, boost::asio::mutable_buffers_1 const& buffer,
   return boost::asio::async_write(socket, buffer, handler);
 }
 template <typename T>
+size_t doWriteBuffers(T& socket,
+                      std::vector<boost::asio::const_buffer> const& buffers,
+                      boost::system::error_code& ec) {
+  return socket.write_some(buffers, ec);
+}
+template <typename T>
+void doAsyncWriteBuffers(T& socket,
+                         std::vector<boost::asio::const_buffer> const& buffers,
+                         AsyncHandler const& handler) {
+  return boost::asio::async_write(socket, buffers, handler);
+}
+template <typename T>
 size_t doRead(T& socket, boost::asio::mutable_buffers_1 const& buffer,
               boost::system::error_code& ec) {
   return socket.read_some(buffer, ec);
@@ -124,7 +81,7 @@ void doAsyncRead(T& socket, boost::asio::mutable_buffers_1 const& buffer,
 class Socket {
  public:
   Socket(boost::asio::io_service& ioService,
-         boost::asio::ssl::context&& context, bool encrypted)
+         std::shared_ptr<boost::asio::ssl::context> context, bool encrypted)
       : _ioService(ioService),
         _context(std::move(context)),
         _encrypted(encrypted) {}
@@ -137,11 +94,25 @@ class Socket {
   virtual int peerPort() = 0;
 
   bool isEncrypted() const { return _encrypted; }
-  bool handshake();
+
+  // performs the SSL handshake without blocking the calling thread, the
+  // handler is called right away for unencrypted sockets
+  void asyncHandshake(HandshakeHandler const& handler);
+
+  // context for unencrypted sockets, shared by all of them
+  static std::shared_ptr<boost::asio::ssl::context> const& unencryptedContext();
+
   virtual size_t write(basics::StringBuffer* buffer,
                        boost::system::error_code& ec) = 0;
   virtual void asyncWrite(boost::asio::mutable_buffers_1 const& buffer,
                           AsyncHandler const& handler) = 0;
+  // scatter-gather variants, writing several buffers with one system call
+  virtual size_t writeBuffers(
+      std::vector<boost::asio::const_buffer> const& buffers,
+      boost::system::error_code& ec) = 0;
+  virtual void asyncWriteBuffers(
+      std::vector<boost::asio::const_buffer> const& buffers,
+      AsyncHandler const& handler) = 0;
   virtual size_t read(boost::asio::mutable_buffers_1 const& buffer,
                       boost::system::error_code& ec) = 0;
   virtual std::size_t available(boost::system::error_code& ec) = 0;
@@ -168,13 +139,15 @@ class Socket {
   }
 
  protected:
-  virtual bool sslHandshake() = 0;
+  virtual void asyncSslHandshake(HandshakeHandler const& handler) = 0;
   virtual void shutdownReceive(boost::system::error_code& ec) = 0;
   virtual void shutdownSend(boost::system::error_code& ec) = 0;
 
  public:
   boost::asio::io_service& _ioService;
-  boost::asio::ssl::context _context;
+  // shared by all connections of an endpoint, so that SSL sessions can be
+  // resumed
+  std::shared_ptr<boost::asio::ssl::context> _context;
 
   bool _encrypted;
   bool _handshakeDone = false;
@@ -66,11 +66,8 @@ SocketTask::SocketTask(arangodb::EventLoop loop,
   ConnectionStatistics::SET_START(_connectionStatistics);
 
   if (!skipInit) {
+    // the SSL handshake is done asynchronously in start()
     _peer->setNonBlocking(true);
-    if (!_peer->handshake()) {
-      _closedSend = true;
-      _closedReceive = true;
-    }
   }
 }
 
@@ -125,13 +122,45 @@ void SocketTask::start() {
       << _connectionInfo.clientPort;
 
   auto self = shared_from_this();
-  _loop._scheduler->post([self, this]() { asyncReadSome(); });
+
+  if (_peer->isEncrypted()) {
+    {
+      // a client that never finishes the handshake is closed by the
+      // keep-alive timer, the first request cancels it
+      MUTEX_LOCKER(locker, _lock);
+      resetKeepAlive();
+    }
+
+    _peer->asyncHandshake([self, this](boost::system::error_code const& ec) {
+      if (ec) {
+        LOG_TOPIC(DEBUG, Logger::COMMUNICATION)
+            << "unable to perform ssl handshake: " << ec.message();
+        closeStream();
+        return;
+      }
+
+      asyncReadSome();
+    });
+
+    return;
+  }
+
+  postIo([self, this]() { asyncReadSome(); });
 }
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 protected methods
 // -----------------------------------------------------------------------------
 
+void SocketTask::postIo(std::function<void()> callback) {
+  if (_loop._reactor) {
+    // stay on the reactor owning the connection
+    _loop._ioService->post(std::move(callback));
+  } else {
+    _loop._scheduler->post(std::move(callback));
+  }
+}
+
 // caller must hold the _lock
 void SocketTask::addWriteBuffer(WriteBuffer& buffer) {
   _lock.assertLockedByCurrentThread();
@@ -144,7 +173,7 @@ void SocketTask::addWriteBuffer(WriteBuffer& buffer) {
   {
     auto self = shared_from_this();
 
-    _loop._scheduler->post([self, this]() {
+    postIo([self, this]() {
       MUTEX_LOCKER(locker, _lock);
       processAll();
     });
@@ -170,36 +199,31 @@ void SocketTask::writeWriteBuffer() {
     return;
   }
 
-  size_t total = _writeBuffer._buffer->length();
-  size_t written = 0;
+  std::vector<boost::asio::const_buffer> buffers;
+  size_t total = collectWriteBuffers(buffers);
 
   if (!_peer->isEncrypted()) {
     boost::system::error_code err;
     err.clear();
 
     while (true) {
-      RequestStatistics::SET_WRITE_START(_writeBuffer._statistics);
-      written = _peer->write(_writeBuffer._buffer, err);
+      size_t written = _peer->writeBuffers(buffers, err);
 
       if (err) {
         break;
       }
 
-      RequestStatistics::ADD_SENT_BYTES(_writeBuffer._statistics, written);
+      if (!consumeWriteBuffers(written)) {
+        return;
+      }
 
       if (written != total) {
         // unable to write everything at once, might be a lot of data
-        // above code does not update the buffer positon
         break;
       }
 
-      if (!completedWriteBuffer()) {
-        return;
-      }
-
-      // try to send next buffer
-      total = _writeBuffer._buffer->length();
-      written = 0;
+      // try to send the next buffers
+      total = collectWriteBuffers(buffers);
     }
 
     // write could have blocked which is the only acceptable error
@@ -209,13 +233,14 @@ void SocketTask::writeWriteBuffer() {
       closeStreamNoLock();
       return;
     }
+
+    collectWriteBuffers(buffers);
   }
 
   // so the code could have blocked at this point or not all data
-  // was written in one go, begin writing at offset (written)
+  // was written in one go, continue with the remaining data
   auto self = shared_from_this();
-  _peer->asyncWrite(boost::asio::buffer(_writeBuffer._buffer->begin() + written,
-                                        total - written),
+  _peer->asyncWriteBuffers(buffers,
                     [self, this](const boost::system::error_code& ec,
                                  std::size_t transferred) {
                       MUTEX_LOCKER(locker, _lock);
@@ -224,16 +249,13 @@ void SocketTask::writeWriteBuffer() {
                         return;
                       }
 
-                      RequestStatistics::ADD_SENT_BYTES(
-                          _writeBuffer._statistics, transferred);
-
                       if (ec) {
                         LOG_TOPIC(DEBUG, Logger::COMMUNICATION)
                             << "write on stream failed with: " << ec.message();
                         closeStreamNoLock();
                       } else {
-                        if (completedWriteBuffer()) {
-                          _loop._scheduler->post([self, this]() {
+                        if (consumeWriteBuffers(transferred)) {
+                          postIo([self, this]() {
                             MUTEX_LOCKER(locker, _lock);
                             writeWriteBuffer();
                           });
@@ -241,6 +263,63 @@ void SocketTask::writeWriteBuffer() {
                       }
                     });
 }
+
+// caller must hold the _lock
+size_t SocketTask::collectWriteBuffers(
+    std::vector<boost::asio::const_buffer>& buffers) {
+  // upper bound for the number of buffers in one scatter-gather write,
+  // well below IOV_MAX
+  static size_t const MaxWriteBuffers = 64;
+
+  _lock.assertLockedByCurrentThread();
+  TRI_ASSERT(!_writeBuffer.empty());
+
+  buffers.clear();
+
+  if (_writeOffset == 0) {
+    RequestStatistics::SET_WRITE_START(_writeBuffer._statistics);
+  }
+
+  size_t total = _writeBuffer._buffer->length() - _writeOffset;
+  buffers.emplace_back(_writeBuffer._buffer->begin() + _writeOffset, total);
+
+  for (auto& it : _writeBuffers) {
+    if (buffers.size() >= MaxWriteBuffers) {
+      break;
+    }
+
+    RequestStatistics::SET_WRITE_START(it._statistics);
+    buffers.emplace_back(it._buffer->begin(), it._buffer->length());
+    total += it._buffer->length();
+  }
+
+  return total;
+}
+
+// caller must hold the _lock, returns true if there is more to write
+bool SocketTask::consumeWriteBuffers(size_t written) {
+  _lock.assertLockedByCurrentThread();
+
+  while (!_writeBuffer.empty()) {
+    size_t left = _writeBuffer._buffer->length() - _writeOffset;
+
+    if (written < left) {
+      RequestStatistics::ADD_SENT_BYTES(_writeBuffer._statistics, written);
+      _writeOffset += written;
+      return true;
+    }
+
+    RequestStatistics::ADD_SENT_BYTES(_writeBuffer._statistics, left);
+    written -= left;
+    _writeOffset = 0;
+
+    if (!completedWriteBuffer()) {
+      return false;
+    }
+  }
+
+  return false;
+}
     
 StringBuffer* SocketTask::leaseStringBuffer(size_t length) {
   _lock.assertLockedByCurrentThread();
@@ -559,7 +638,7 @@ void SocketTask::asyncReadSome() {
             _readBuffer.increaseLength(transferred);
 
             if (processAll()) {
-              _loop._scheduler->post([self, this]() { asyncReadSome(); });
+              postIo([self, this]() { asyncReadSome(); });
             }
 
             compactify();
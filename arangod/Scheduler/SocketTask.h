@@ -61,6 +61,9 @@ class SocketTask : virtual public Task {
   void start();
 
  protected:
+  // runs I/O continuations on the event loop owning this connection
+  void postIo(std::function<void()> callback);
+
   // caller will hold the _lock
   virtual bool processRead(double startTime) = 0;
   virtual void compactify() {}
@@ -168,6 +171,8 @@ class SocketTask : virtual public Task {
  private:
   void writeWriteBuffer();
   bool completedWriteBuffer();
+  size_t collectWriteBuffers(std::vector<boost::asio::const_buffer>&);
+  bool consumeWriteBuffers(size_t written);
 
   bool reserveMemory();
   bool trySyncRead();
@@ -179,6 +184,9 @@ class SocketTask : virtual public Task {
   WriteBuffer _writeBuffer;
   std::list<WriteBuffer> _writeBuffers;
 
+  // bytes of _writeBuffer already written
+  size_t _writeOffset = 0;
+
   std::unique_ptr<Socket> _peer;
   boost::posix_time::milliseconds _keepAliveTimeout;
   boost::asio::deadline_timer _keepAliveTimer;
@@ -44,6 +44,28 @@ void SocketTcp::asyncWrite(boost::asio::mutable_buffers_1 const& buffer,
   }
 }
 
+size_t SocketTcp::writeBuffers(
+    std::vector<boost::asio::const_buffer> const& buffers,
+    boost::system::error_code& ec) {
+  MUTEX_LOCKER(guard, _lock);
+  if (_encrypted) {
+    return socketcommon::doWriteBuffers(_sslSocket, buffers, ec);
+  } else {
+    return socketcommon::doWriteBuffers(_socket, buffers, ec);
+  }
+}
+
+void SocketTcp::asyncWriteBuffers(
+    std::vector<boost::asio::const_buffer> const& buffers,
+    AsyncHandler const& handler) {
+  MUTEX_LOCKER(guard, _lock);
+  if (_encrypted) {
+    return socketcommon::doAsyncWriteBuffers(_sslSocket, buffers, handler);
+  } else {
+    return socketcommon::doAsyncWriteBuffers(_socket, buffers, handler);
+  }
+}
+
 size_t SocketTcp::read(boost::asio::mutable_buffers_1 const& buffer,
                        boost::system::error_code& ec) {
   MUTEX_LOCKER(guard, _lock);
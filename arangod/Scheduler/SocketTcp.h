@@ -32,9 +32,9 @@ namespace arangodb {
 class SocketTcp final : public Socket {
  public:
   SocketTcp(boost::asio::io_service& ioService,
-            boost::asio::ssl::context&& context, bool encrypted)
+            std::shared_ptr<boost::asio::ssl::context> context, bool encrypted)
       : Socket(ioService, std::move(context), encrypted),
-        _sslSocket(ioService, _context),
+        _sslSocket(ioService, *_context),
         _socket(_sslSocket.next_layer()),
         _peerEndpoint() {}
 
@@ -52,9 +52,10 @@ class SocketTcp final : public Socket {
 
   int peerPort() override { return _peerEndpoint.port(); }
 
-  bool sslHandshake() override {
+  void asyncSslHandshake(HandshakeHandler const& handler) override {
     MUTEX_LOCKER(guard, _lock);
-    return socketcommon::doSslHandshake(_sslSocket);
+    _sslSocket.async_handshake(
+        boost::asio::ssl::stream_base::handshake_type::server, handler);
   }
 
   size_t write(basics::StringBuffer* buffer,
@@ -63,6 +64,12 @@ class SocketTcp final : public Socket {
   void asyncWrite(boost::asio::mutable_buffers_1 const& buffer,
                   AsyncHandler const& handler) override;
 
+  size_t writeBuffers(std::vector<boost::asio::const_buffer> const& buffers,
+                      boost::system::error_code& ec) override;
+
+  void asyncWriteBuffers(std::vector<boost::asio::const_buffer> const& buffers,
+                         AsyncHandler const& handler) override;
+
   size_t read(boost::asio::mutable_buffers_1 const& buffer,
               boost::system::error_code& ec) override;
 
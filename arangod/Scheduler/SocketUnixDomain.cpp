@@ -32,6 +32,12 @@ size_t SocketUnixDomain::write(basics::StringBuffer* buffer, boost::system::erro
 void SocketUnixDomain::asyncWrite(boost::asio::mutable_buffers_1 const& buffer, AsyncHandler const& handler) {
   return socketcommon::doAsyncWrite(_socket, buffer, handler);
 }
+size_t SocketUnixDomain::writeBuffers(std::vector<boost::asio::const_buffer> const& buffers, boost::system::error_code& ec) {
+  return socketcommon::doWriteBuffers(_socket, buffers, ec);
+}
+void SocketUnixDomain::asyncWriteBuffers(std::vector<boost::asio::const_buffer> const& buffers, AsyncHandler const& handler) {
+  return socketcommon::doAsyncWriteBuffers(_socket, buffers, handler);
+}
 size_t SocketUnixDomain::read(boost::asio::mutable_buffers_1 const& buffer, boost::system::error_code& ec) {
   return socketcommon::doRead(_socket, buffer, ec);
 }
@@ -34,7 +34,8 @@ class StringBuffer;
 
 class SocketUnixDomain final : public Socket {
   public:
-    SocketUnixDomain(boost::asio::io_service& ioService, boost::asio::ssl::context&& context)
+    SocketUnixDomain(boost::asio::io_service& ioService,
+                     std::shared_ptr<boost::asio::ssl::context> context)
         : Socket(ioService, std::move(context), false),
           _socket(ioService),
           _peerEndpoint() {}
@@ -47,11 +48,17 @@ class SocketUnixDomain final : public Socket {
     
     int peerPort() override { return 0; }
     
-    bool sslHandshake() override { return false; }
+    void asyncSslHandshake(HandshakeHandler const& handler) override {
+      handler(boost::asio::error::operation_not_supported);
+    }
     
     size_t write(basics::StringBuffer* buffer, boost::system::error_code& ec) override;
     
     void asyncWrite(boost::asio::mutable_buffers_1 const& buffer, AsyncHandler const& handler) override;
+
+    size_t writeBuffers(std::vector<boost::asio::const_buffer> const& buffers, boost::system::error_code& ec) override;
+
+    void asyncWriteBuffers(std::vector<boost::asio::const_buffer> const& buffers, AsyncHandler const& handler) override;
     
     size_t read(boost::asio::mutable_buffers_1 const& buffer, boost::system::error_code& ec) override;
     
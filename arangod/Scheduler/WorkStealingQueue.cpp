@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Dr. Frank Celler
+////////////////////////////////////////////////////////////////////////////////
+
+#include "WorkStealingQueue.h"
+
+#include "Basics/MutexLocker.h"
+
+using namespace arangodb;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+WorkStealingQueue::WorkStealingQueue()
+    : _closed(false), _lifoRuns(0), _size(0) {}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+bool WorkStealingQueue::pushLocal(std::function<void()>& callback) {
+  MUTEX_LOCKER(guard, _lock);
+
+  if (_closed) {
+    return false;
+  }
+
+  // the previous occupant of the slot becomes ordinary work
+  if (_lifoSlot) {
+    _queue.emplace_back(std::move(_lifoSlot));
+  }
+
+  _lifoSlot = std::move(callback);
+  ++_size;
+
+  return true;
+}
+
+bool WorkStealingQueue::push(std::function<void()>& callback) {
+  MUTEX_LOCKER(guard, _lock);
+
+  if (_closed) {
+    return false;
+  }
+
+  _queue.emplace_back(std::move(callback));
+  ++_size;
+
+  return true;
+}
+
+bool WorkStealingQueue::pop(std::function<void()>& callback) {
+  MUTEX_LOCKER(guard, _lock);
+
+  if (_lifoSlot && (_lifoRuns < MAX_LIFO_RUNS || _queue.empty())) {
+    callback = std::move(_lifoSlot);
+    _lifoSlot = nullptr;
+    ++_lifoRuns;
+    --_size;
+
+    return true;
+  }
+
+  _lifoRuns = 0;
+
+  if (_queue.empty()) {
+    return false;
+  }
+
+  callback = std::move(_queue.front());
+  _queue.pop_front();
+  --_size;
+
+  return true;
+}
+
+bool WorkStealingQueue::steal(std::function<void()>& callback) {
+  MUTEX_LOCKER(guard, _lock);
+
+  if (!_queue.empty()) {
+    callback = std::move(_queue.front());
+    _queue.pop_front();
+    --_size;
+
+    return true;
+  }
+
+  // the owner is busy with something else, otherwise it would have taken
+  // the slot already
+  if (_lifoSlot) {
+    callback = std::move(_lifoSlot);
+    _lifoSlot = nullptr;
+    --_size;
+
+    return true;
+  }
+
+  return false;
+}
+
+std::vector<std::function<void()>> WorkStealingQueue::close() {
+  MUTEX_LOCKER(guard, _lock);
+
+  std::vector<std::function<void()>> result;
+  result.reserve(_queue.size() + 1);
+
+  if (_lifoSlot) {
+    result.emplace_back(std::move(_lifoSlot));
+    _lifoSlot = nullptr;
+  }
+
+  for (auto& callback : _queue) {
+    result.emplace_back(std::move(callback));
+  }
+
+  _queue.clear();
+  _closed = true;
+  _size = 0;
+
+  return result;
+}
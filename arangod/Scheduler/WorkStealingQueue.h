@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Dr. Frank Celler
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_SCHEDULER_WORK_STEALING_QUEUE_H
+#define ARANGOD_SCHEDULER_WORK_STEALING_QUEUE_H 1
+
+#include "Basics/Common.h"
+
+#include "Basics/Mutex.h"
+
+namespace arangodb {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief queue of a single scheduler thread
+///
+/// The owning thread takes work from the LIFO slot first, which holds the
+/// callback it posted last, e.g. the continuation of the handler it just
+/// ran, and from the front of the queue otherwise. Other threads steal from
+/// the front. Callbacks from threads outside of the scheduler are appended
+/// at the back.
+////////////////////////////////////////////////////////////////////////////////
+
+class WorkStealingQueue {
+  WorkStealingQueue(WorkStealingQueue const&) = delete;
+  WorkStealingQueue& operator=(WorkStealingQueue const&) = delete;
+
+ public:
+  WorkStealingQueue();
+
+ public:
+  // number of callbacks in the queue, including the LIFO slot
+  size_t size() const { return _size.load(std::memory_order_relaxed); }
+
+  // posts a callback from the owning thread, the callback is moved only if
+  // the queue accepts it
+  bool pushLocal(std::function<void()>& callback);
+
+  // posts a callback from another thread
+  bool push(std::function<void()>& callback);
+
+  // takes the next callback, only called by the owning thread
+  bool pop(std::function<void()>& callback);
+
+  // takes the oldest callback, called by other threads
+  bool steal(std::function<void()>& callback);
+
+  // rejects all further callbacks and returns the ones not yet executed
+  std::vector<std::function<void()>> close();
+
+ private:
+  // number of consecutive callbacks taken from the LIFO slot before the
+  // front of the queue is served
+  static size_t const MAX_LIFO_RUNS = 3;
+
+  mutable Mutex _lock;
+
+  bool _closed;
+  std::function<void()> _lifoSlot;
+  std::deque<std::function<void()>> _queue;
+  size_t _lifoRuns;
+
+  std::atomic<size_t> _size;
+};
+}
+
+#endif
@@ -36,6 +36,11 @@ using namespace arangodb::basics;
 
 arangodb::Mutex RequestStatistics::_dataLock;
 
+std::string const RequestStatistics::OTHER_ROUTE("other");
+
+std::unordered_map<std::string, RequestStatistics::RouteFigures>
+    RequestStatistics::_routes;
+
 std::unique_ptr<RequestStatistics[]> RequestStatistics::_statisticsBuffer;
 
 boost::lockfree::queue<RequestStatistics*,
@@ -151,6 +156,8 @@ void RequestStatistics::process(RequestStatistics* statistics) {
       TRI_BytesSentDistributionStatistics->addFigure(statistics->_sentBytes);
       TRI_BytesReceivedDistributionStatistics->addFigure(
           statistics->_receivedBytes);
+
+      processRoute(statistics, totalTime, requestTime);
     }
   }
 
@@ -173,6 +180,27 @@ void RequestStatistics::process(RequestStatistics* statistics) {
   }
 }
 
+// caller must hold the _dataLock
+void RequestStatistics::processRoute(RequestStatistics* statistics,
+                                     double totalTime, double requestTime) {
+  if (statistics->_route.empty()) {
+    return;
+  }
+
+  auto it = _routes.find(statistics->_route);
+
+  if (it == _routes.end()) {
+    // the number of routes is bounded by the registered handlers, but
+    // guard against unexpected growth
+    std::string const& route =
+        _routes.size() < MAX_ROUTES ? statistics->_route : OTHER_ROUTE;
+    it = _routes.emplace(route, RouteFigures()).first;
+  }
+
+  it->second._totalTime.addFigure(totalTime);
+  it->second._requestTime.addFigure(requestTime);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    public methods
 // -----------------------------------------------------------------------------
@@ -213,6 +241,18 @@ void RequestStatistics::fill(StatisticsDistribution& totalTime,
   bytesReceived = *TRI_BytesReceivedDistributionStatistics;
 }
 
+void RequestStatistics::fillRoutes(std::map<std::string, RouteFigures>& routes) {
+  if (!StatisticsFeature::enabled()) {
+    return;
+  }
+
+  MUTEX_LOCKER(mutexLocker, _dataLock);
+
+  for (auto const& it : _routes) {
+    routes.emplace(it.first, it.second);
+  }
+}
+
 std::string RequestStatistics::timingsCsv() {
   std::stringstream ss;
 
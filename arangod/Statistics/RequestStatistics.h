@@ -35,6 +35,17 @@
 
 namespace arangodb {
 class RequestStatistics {
+ public:
+  // latencies of all requests served by one route
+  struct RouteFigures {
+    basics::StatisticsHistogram _totalTime;
+    basics::StatisticsHistogram _requestTime;
+  };
+
+  // routes beyond this number are accounted as OTHER_ROUTE
+  static size_t const MAX_ROUTES = 256;
+  static std::string const OTHER_ROUTE;
+
  public:
   static void initialize();
   static void shutdown();
@@ -61,6 +72,12 @@ class RequestStatistics {
     }
   }
 
+  static void SET_ROUTE(RequestStatistics* stat, std::string const& route) {
+    if (stat != nullptr) {
+      stat->_route = route;
+    }
+  }
+
   static void SET_READ_START(RequestStatistics* stat, double start) {
     if (stat != nullptr) {
       if (stat->_readStart == 0.0) {
@@ -147,6 +164,8 @@ class RequestStatistics {
                    basics::StatisticsDistribution& bytesSent,
                    basics::StatisticsDistribution& bytesReceived);
 
+  static void fillRoutes(std::map<std::string, RouteFigures>& routes);
+
   std::string timingsCsv();
   std::string to_string();
   void trace_log();
@@ -166,7 +185,11 @@ class RequestStatistics {
                                 boost::lockfree::capacity<QUEUE_SIZE>>
       _finishedList;
 
+  static std::unordered_map<std::string, RouteFigures> _routes;
+
   static void process(RequestStatistics*);
+  static void processRoute(RequestStatistics*, double totalTime,
+                           double requestTime);
 
   RequestStatistics() { reset(); }
 
@@ -183,6 +206,7 @@ class RequestStatistics {
     _receivedBytes = 0.0;
     _sentBytes = 0.0;
     _requestType = rest::RequestType::ILLEGAL;
+    _route.clear();
     _async = false;
     _tooLarge = false;
     _executeError = false;
@@ -206,6 +230,7 @@ class RequestStatistics {
   double _sentBytes;
 
   rest::RequestType _requestType;
+  std::string _route;  // prefix of the handler
 
   bool _async;
   bool _tooLarge;
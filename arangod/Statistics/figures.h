@@ -92,6 +92,126 @@ struct StatisticsDistribution {
   std::vector<double> _cuts;
   std::vector<uint64_t> _counts;
 };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a log-linear histogram of durations for percentiles
+///
+/// values are recorded in microseconds. Every power of two is split into
+/// SUB_BUCKETS buckets of equal width, so a percentile is off by less than
+/// 1 / SUB_BUCKETS of its value, independent of its magnitude.
+////////////////////////////////////////////////////////////////////////////////
+
+struct StatisticsHistogram {
+  static size_t const SUB_BUCKET_BITS = 4;
+  static size_t const SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+  // up to 2^40 microseconds, longer durations end up in the last bucket
+  static size_t const MAGNITUDES = 40;
+  static size_t const NUMBER_OF_BUCKETS = (MAGNITUDES + 1) * SUB_BUCKETS;
+
+  StatisticsHistogram()
+      : _count(0), _total(0.0), _max(0.0), _counts(NUMBER_OF_BUCKETS, 0) {}
+
+  void addFigure(double seconds) {
+    if (seconds < 0.0) {
+      seconds = 0.0;
+    }
+
+    ++_count;
+    _total += seconds;
+
+    if (seconds > _max) {
+      _max = seconds;
+    }
+
+    ++_counts[bucket(static_cast<uint64_t>(seconds * 1000000.0))];
+  }
+
+  // adds all durations recorded by another histogram
+  void add(StatisticsHistogram const& other) {
+    _count += other._count;
+    _total += other._total;
+
+    if (other._max > _max) {
+      _max = other._max;
+    }
+
+    for (size_t i = 0; i < NUMBER_OF_BUCKETS; ++i) {
+      _counts[i] += other._counts[i];
+    }
+  }
+
+  // returns the smallest recorded duration that is not exceeded by the
+  // given fraction of all durations, in seconds
+  double percentile(double fraction) const {
+    if (_count == 0) {
+      return 0.0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(std::ceil(fraction * _count));
+
+    if (target == 0) {
+      target = 1;
+    }
+
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < NUMBER_OF_BUCKETS; ++i) {
+      seen += _counts[i];
+
+      if (seen >= target) {
+        if (seen == _count) {
+          // the largest value is in this bucket and known exactly
+          return _max;
+        }
+
+        return (std::min)(value(i) / 1000000.0, _max);
+      }
+    }
+
+    return _max;
+  }
+
+  static size_t bucket(uint64_t micros) {
+    if (micros < SUB_BUCKETS) {
+      return static_cast<size_t>(micros);
+    }
+
+    size_t magnitude = 0;
+
+    for (uint64_t v = micros; v > 1; v >>= 1) {
+      ++magnitude;
+    }
+
+    size_t shift = magnitude - SUB_BUCKET_BITS;
+
+    if (shift >= MAGNITUDES) {
+      return NUMBER_OF_BUCKETS - 1;
+    }
+
+    size_t sub = static_cast<size_t>(micros >> shift) & (SUB_BUCKETS - 1);
+    return (shift + 1) * SUB_BUCKETS + sub;
+  }
+
+  // the middle of a bucket, buckets below SUB_BUCKETS are exact
+  static double value(size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+      return static_cast<double>(bucket);
+    }
+
+    size_t shift = bucket / SUB_BUCKETS - 1;
+    uint64_t sub = bucket % SUB_BUCKETS;
+    uint64_t lower = (SUB_BUCKETS + sub) << shift;
+    uint64_t upper = (SUB_BUCKETS + sub + 1) << shift;
+
+    return (lower + upper) / 2.0;
+  }
+
+  uint64_t _count;
+  double _total;
+  double _max;
+  std::vector<uint64_t> _counts;
+};
 }
 }
 
@@ -32,8 +32,10 @@
 #include "Indexes/Index.h"
 #include "StorageEngine/TransactionState.h"
 #include "Transaction/Methods.h"
+#include "Utils/OperationOptions.h"
 #include "VocBase/KeyGenerator.h"
 #include "VocBase/LogicalCollection.h"
+#include "VocBase/ManagedDocumentResult.h"
 #include "VocBase/ticks.h"
 #include "VocBase/vocbase.h"
 
@@ -219,6 +221,31 @@ void PhysicalCollection::mergeObjectsForUpdate(
   b.close();
 }
 
+/// @brief inserts the documents of an array one by one
+void PhysicalCollection::insertMany(transaction::Methods* trx,
+                                    VPackSlice const documents,
+                                    OperationOptions& options,
+                                    TRI_voc_tick_t& resultMarkerTick, bool lock,
+                                    InsertCallback const& callback) {
+  TRI_ASSERT(documents.isArray());
+  resultMarkerTick = 0;
+
+  for (auto const& document : VPackArrayIterator(documents)) {
+    ManagedDocumentResult result;
+    if (!document.isObject()) {
+      callback(Result(TRI_ERROR_ARANGO_DOCUMENT_TYPE_INVALID), result);
+      continue;
+    }
+
+    TRI_voc_tick_t tick = 0;
+    Result res = insert(trx, document, result, options, tick, lock);
+    if (tick > resultMarkerTick) {
+      resultMarkerTick = tick;
+    }
+    callback(res, result);
+  }
+}
+
 /// @brief new object for insert, computes the hash of the key
 int PhysicalCollection::newObjectForInsert(
     transaction::Methods* trx, VPackSlice const& value,
@@ -37,6 +37,7 @@ namespace transaction {
 class Methods;
 }
 
+class AttributeStatistics;
 struct DocumentIdentifierToken;
 class Index;
 class IndexIterator;
@@ -156,6 +157,20 @@ class PhysicalCollection {
                         OperationOptions& options,
                         TRI_voc_tick_t& resultMarkerTick, bool lock) = 0;
 
+  /// @brief called with the result of each document of an array insert, in
+  /// the order of the array. result holds the new document on success
+  typedef std::function<void(Result const&, ManagedDocumentResult const&)>
+      InsertCallback;
+
+  /// @brief inserts the documents of an array, reporting each of them to
+  /// callback. a failed document does not stop the others. the default
+  /// implementation inserts the documents one by one
+  virtual void insertMany(arangodb::transaction::Methods* trx,
+                          arangodb::velocypack::Slice const documents,
+                          OperationOptions& options,
+                          TRI_voc_tick_t& resultMarkerTick, bool lock,
+                          InsertCallback const& callback);
+
   virtual Result update(arangodb::transaction::Methods* trx,
                         arangodb::velocypack::Slice const newSlice,
                         ManagedDocumentResult& result,
@@ -191,6 +206,14 @@ class PhysicalCollection {
   virtual void deferDropCollection(
       std::function<bool(LogicalCollection*)> callback) = 0;
 
+  /// @brief returns the sampled attribute statistics of the collection, or
+  /// a nullptr if the engine does not collect them or the collection has
+  /// not been analyzed yet
+  virtual std::shared_ptr<AttributeStatistics const> attributeStatistics()
+      const {
+    return nullptr;
+  }
+
  protected:
   /// @brief Inject figures that are specific to StorageEngine
   virtual void figuresSpecific(
@@ -87,6 +87,14 @@ class StorageEngine : public application_features::ApplicationFeature {
 
   virtual bool supportsDfdb() const = 0;
 
+  /// @brief whether indexes can be filled without an exclusive lock on
+  /// their collection
+  virtual bool supportsBackgroundIndexing() const = 0;
+
+  /// @brief whether openDatabase can be called for different databases
+  /// concurrently on server startup
+  virtual bool supportsParallelDatabaseOpening() const = 0;
+
   virtual TransactionManager* createTransactionManager() = 0;
   virtual transaction::ContextData* createTransactionContextData() = 0;
   virtual TransactionState* createTransactionState(TRI_vocbase_t*, transaction::Options const&) = 0;
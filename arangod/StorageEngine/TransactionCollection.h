@@ -75,6 +75,9 @@ class TransactionCollection {
   
   virtual void freeOperations(transaction::Methods* activeTrx, bool mustRollback) = 0;
   
+  /// @brief the access type the collection was added to the transaction with
+  virtual AccessMode::Type accessType() const = 0;
+
   virtual bool canAccess(AccessMode::Type accessType) const = 0;
   virtual int updateUsage(AccessMode::Type accessType, int nestingLevel) = 0;
   virtual int use(int nestingLevel) = 0;
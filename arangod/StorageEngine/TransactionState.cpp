@@ -33,10 +33,13 @@
 #include "Transaction/Methods.h"
 #include "Transaction/Options.h"
 #include "Utils/ExecContext.h"
+#include "Views/AggregateView.h"
 #include "VocBase/ticks.h"
 
 using namespace arangodb;
 
+size_t const TransactionState::MaxQueryCacheKeys = 1000;
+
 /// @brief transaction type
 TransactionState::TransactionState(TRI_vocbase_t* vocbase,
                                    transaction::Options const& options)
@@ -314,6 +317,40 @@ int TransactionState::releaseCollections() {
   return TRI_ERROR_NO_ERROR;
 }
 
+/// @brief remember a document change for the aggregate views on the
+/// collection. oldDoc is none for inserts and newDoc is none for removals
+void TransactionState::trackViewChange(TRI_voc_cid_t cid,
+                                       arangodb::velocypack::Slice oldDoc,
+                                       arangodb::velocypack::Slice newDoc) {
+  if (!AggregateView::hasViews()) {
+    return;
+  }
+  if (_viewChanges == nullptr) {
+    _viewChanges.reset(new AggregateViewChanges());
+  }
+  _viewChanges->track(cid, oldDoc, newDoc);
+}
+
+/// @brief remember a truncate for the aggregate views on the collection
+void TransactionState::trackViewTruncate(TRI_voc_cid_t cid) {
+  if (!AggregateView::hasViews()) {
+    return;
+  }
+  if (_viewChanges == nullptr) {
+    _viewChanges.reset(new AggregateViewChanges());
+  }
+  _viewChanges->truncate(cid);
+}
+
+/// @brief apply the document changes of the transaction to the aggregate
+/// views. called on every commit, while the collections are still locked
+void TransactionState::applyViewChanges() {
+  if (_viewChanges != nullptr) {
+    _viewChanges->apply();
+    _viewChanges.reset();
+  }
+}
+
 /// @brief clear the query cache for all collections that were modified by
 /// the transaction
 void TransactionState::clearQueryCache() {
@@ -324,9 +361,22 @@ void TransactionState::clearQueryCache() {
   try {
     std::vector<std::string> collections;
     for (auto& trxCollection : _collections) {
-      if (trxCollection->hasOperations()) {
-        // we're only interested in collections that may have been modified
-        collections.emplace_back(trxCollection->collectionName());
+      if (!trxCollection->hasOperations()) {
+        continue;
+      }
+      // we're only interested in collections that may have been modified
+      std::string const& name = trxCollection->collectionName();
+      auto it = _queryCacheKeys.find(name);
+
+      if (it != _queryCacheKeys.end() &&
+          _queryCacheCollections.find(name) == _queryCacheCollections.end()) {
+        // only individual documents were modified
+        for (auto const& key : (*it).second) {
+          arangodb::aql::QueryCache::instance()->invalidate(_vocbase, name,
+                                                            key);
+        }
+      } else {
+        collections.emplace_back(name);
       }
     }
 
@@ -340,6 +390,38 @@ void TransactionState::clearQueryCache() {
   }
 }
 
+/// @brief invalidate the query cache results that depend on a document
+/// modified by the transaction, and remember the key so the results can be
+/// invalidated again at commit
+void TransactionState::invalidateQueryCache(std::string const& collection,
+                                            StringRef const& key) {
+  auto queryCache = arangodb::aql::QueryCache::instance();
+
+  if (!queryCache->mayBeActive()) {
+    return;
+  }
+
+  if (key.empty() ||
+      _queryCacheCollections.find(collection) != _queryCacheCollections.end()) {
+    queryCache->invalidate(_vocbase, collection);
+    _queryCacheCollections.emplace(collection);
+    _queryCacheKeys.erase(collection);
+    return;
+  }
+
+  std::string k = key.toString();
+  queryCache->invalidate(_vocbase, collection, k);
+
+  auto& keys = _queryCacheKeys[collection];
+  if (keys.size() >= MaxQueryCacheKeys) {
+    // too many keys to remember
+    _queryCacheCollections.emplace(collection);
+    _queryCacheKeys.erase(collection);
+    return;
+  }
+  keys.emplace(std::move(k));
+}
+
 /// @brief update the status of a transaction
 void TransactionState::updateStatus(transaction::Status status) {
   TRI_ASSERT(_status == transaction::Status::CREATED ||
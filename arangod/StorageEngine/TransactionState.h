@@ -27,6 +27,7 @@
 #include "Basics/Common.h"
 #include "Basics/Result.h"
 #include "Basics/SmallVector.h"
+#include "Basics/StringRef.h"
 #include "Cluster/ServerState.h"
 #include "Transaction/Hints.h"
 #include "Transaction/Options.h"
@@ -35,6 +36,8 @@
 #include "VocBase/AccessMode.h"
 #include "VocBase/voc-types.h"
 
+#include <velocypack/Slice.h>
+
 #ifdef ARANGODB_ENABLE_MAINTAINER_MODE
 
 #define LOG_TRX(trx, level)                        \
@@ -56,6 +59,7 @@ namespace transaction {
 class Methods;
 struct Options;
 }
+class AggregateViewChanges;
 class TransactionCollection;
 
 /// @brief transaction type
@@ -155,18 +159,30 @@ class TransactionState {
 
   TransactionCollection* findCollection(TRI_voc_cid_t cid) const;
 
-  void setType(AccessMode::Type type);
+  /// @brief remember a document change for the aggregate views on the
+  /// collection. oldDoc is none for inserts and newDoc is none for removals
+  void trackViewChange(TRI_voc_cid_t cid, arangodb::velocypack::Slice oldDoc,
+                       arangodb::velocypack::Slice newDoc);
 
- protected:
-  /// @brief find a collection in the transaction's list of collections
-  TransactionCollection* findCollection(TRI_voc_cid_t cid,
-                                        size_t& position) const;
+  /// @brief remember a truncate for the aggregate views on the collection
+  void trackViewTruncate(TRI_voc_cid_t cid);
+
+  void setType(AccessMode::Type type);
 
   /// @brief whether or not a transaction is read-only
   bool isReadOnlyTransaction() const {
     return (_type == AccessMode::Type::READ);
   }
 
+  /// @brief whether the transaction has committed some of its operations
+  /// intermediately already
+  virtual bool hasIntermediateCommits() const { return false; }
+
+ protected:
+  /// @brief find a collection in the transaction's list of collections
+  TransactionCollection* findCollection(TRI_voc_cid_t cid,
+                                        size_t& position) const;
+
   /// @brief release collection locks for a transaction
   int releaseCollections();
 
@@ -174,7 +190,24 @@ class TransactionState {
   /// the transaction
   void clearQueryCache();
 
+  /// @brief apply the document changes of the transaction to the aggregate
+  /// views. called on every commit, including intermediate commits, while
+  /// the collections are still locked
+  void applyViewChanges();
+
+  /// @brief invalidate the query cache results that depend on a document
+  /// modified by the transaction, and remember the key so the results can be
+  /// invalidated again at commit. an empty key invalidates all results for
+  /// the collection
+  void invalidateQueryCache(std::string const& collection,
+                            arangodb::StringRef const& key);
+
  protected:
+  /// @brief maximum number of modified keys remembered per collection for the
+  /// query cache invalidation at commit. beyond this, all results for the
+  /// collection are invalidated
+  static size_t const MaxQueryCacheKeys;
+
   TRI_vocbase_t* _vocbase;      // vocbase
   TRI_voc_tid_t _id;            // local trx id
   AccessMode::Type _type;       // access type (read|write)
@@ -193,6 +226,18 @@ class TransactionState {
   int _nestingLevel;
 
   transaction::Options _options;
+
+  /// @brief modified document keys per collection, for the query cache
+  std::unordered_map<std::string, std::unordered_set<std::string>>
+      _queryCacheKeys;
+
+  /// @brief collections that need to be invalidated in full in the query
+  /// cache
+  std::unordered_set<std::string> _queryCacheCollections;
+
+  /// @brief document changes for the aggregate views, created on the first
+  /// change to a collection with views
+  std::unique_ptr<AggregateViewChanges> _viewChanges;
 };
 }
 
@@ -47,7 +47,9 @@ class Hints {
     NO_USAGE_LOCK = 256,
     RECOVERY = 512,
     NO_DLD = 1024, // disable deadlock detection
-    READ_WRITES = 2048 // do not use snapshot
+    READ_WRITES = 2048, // do not use snapshot
+    BULK_LOAD = 4096, // write data files directly, if supported by the engine
+    ALLOW_RANGE_DELETE = 8192 // truncate outside of the transaction, if supported
   };
 
   Hints() : _value(0) {}
@@ -38,6 +38,7 @@
 #include "Cluster/ClusterMethods.h"
 #include "Cluster/FollowerInfo.h"
 #include "Cluster/ServerState.h"
+#include "Cluster/SynchronousReplicationBatcher.h"
 #include "Indexes/Index.h"
 #include "Logger/Logger.h"
 #include "RocksDBEngine/RocksDBEngine.h"
@@ -1394,6 +1395,21 @@ OperationResult transaction::Methods::insertLocal(
   VPackBuilder resultBuilder;
   TRI_voc_tick_t maxTick = 0;
 
+  // builds the result of an inserted document
+  auto reportDocument = [&](ManagedDocumentResult const& result) {
+    TRI_ASSERT(!result.empty());
+    _state->trackViewChange(cid, VPackSlice::noneSlice(),
+                            VPackSlice(result.vpack()));
+
+    StringRef keyString(transaction::helpers::extractKeyFromDocument(
+        VPackSlice(result.vpack())));
+
+    buildDocumentIdentity(collection, resultBuilder, cid, keyString,
+                          transaction::helpers::extractRevFromDocument(
+                              VPackSlice(result.vpack())),
+                          0, nullptr, options.returnNew ? &result : nullptr);
+  };
+
   auto workForOneDocument = [&](VPackSlice const value) -> Result {
     if (!value.isObject()) {
       return TRI_ERROR_ARANGO_DOCUMENT_TYPE_INVALID;
@@ -1411,21 +1427,11 @@ OperationResult transaction::Methods::insertLocal(
     }
 
     if (!res.ok()) {
-      // Error reporting in the babies case is done outside of here,
       // in the single document case no body needs to be created at all.
       return res;
     }
 
-    TRI_ASSERT(!result.empty());
-
-    StringRef keyString(transaction::helpers::extractKeyFromDocument(
-        VPackSlice(result.vpack())));
-
-    buildDocumentIdentity(collection, resultBuilder, cid, keyString,
-                          transaction::helpers::extractRevFromDocument(
-                              VPackSlice(result.vpack())),
-                          0, nullptr, options.returnNew ? &result : nullptr);
-
+    reportDocument(result);
     return TRI_ERROR_NO_ERROR;
   };
 
@@ -1434,12 +1440,19 @@ OperationResult transaction::Methods::insertLocal(
   std::unordered_map<int, size_t> countErrorCodes;
   if (multiCase) {
     VPackArrayBuilder b(&resultBuilder);
-    for (auto const& s : VPackArrayIterator(value)) {
-      res = workForOneDocument(s);
-      if (res.fail()) {
-        createBabiesError(resultBuilder, countErrorCodes, res, options.silent);
-      }
-    }
+    // the storage engine may write the documents in batches, the results
+    // are reported in the order of the documents nevertheless
+    collection->insertMany(
+        this, value, options, maxTick,
+        !isLocked(collection, AccessMode::Type::WRITE),
+        [&](Result const& res, ManagedDocumentResult const& result) {
+          if (res.fail()) {
+            createBabiesError(resultBuilder, countErrorCodes, res,
+                              options.silent);
+          } else {
+            reportDocument(result);
+          }
+        });
     // With babies the reporting is handled in the body of the result
     res = Result(TRI_ERROR_NO_ERROR);
   } else {
@@ -1499,64 +1512,17 @@ OperationResult transaction::Methods::insertLocal(
           itResult.next();
         }
       } else {
+        VPackArrayBuilder guard(&payload);
         doOneDoc(value, ourResult);
         count++;
       }
       if (count > 0) {
-        auto body = std::make_shared<std::string>();
-        *body = payload.slice().toJson();
-
-        // Now prepare the requests:
-        std::vector<ClusterCommRequest> requests;
-        for (auto const& f : *followers) {
-          requests.emplace_back("server:" + f, arangodb::rest::RequestType::POST,
-              path, body);
-        }
-        auto cc = arangodb::ClusterComm::instance();
-        if (cc != nullptr) {
-          // nullptr only happens on controlled shutdown
-          size_t nrDone = 0;
-          size_t nrGood = cc->performRequests(requests, chooseTimeout(count),
-                                              nrDone, Logger::REPLICATION, false);
-          if (nrGood < followers->size()) {
-            // If any would-be-follower refused to follow there must be a
-            // new leader in the meantime, in this case we must not allow
-            // this operation to succeed, we simply return with a refusal
-            // error (note that we use the follower version, since we have
-            // lost leadership):
-            if (findRefusal(requests)) {
-              return OperationResult(TRI_ERROR_CLUSTER_SHARD_LEADER_RESIGNED);
-            }
-
-            // Otherwise we drop all followers that were not successful:
-            for (size_t i = 0; i < followers->size(); ++i) {
-              bool replicationWorked =
-                requests[i].done &&
-                requests[i].result.status == CL_COMM_RECEIVED &&
-                (requests[i].result.answer_code ==
-                 rest::ResponseCode::ACCEPTED ||
-                 requests[i].result.answer_code == rest::ResponseCode::CREATED);
-              if (replicationWorked) {
-                bool found;
-                requests[i].result.answer->header(StaticStrings::ErrorCodes,
-                    found);
-                replicationWorked = !found;
-              }
-              if (!replicationWorked) {
-                auto const& followerInfo = collection->followers();
-                if (followerInfo->remove((*followers)[i])) {
-                  LOG_TOPIC(WARN, Logger::REPLICATION)
-                    << "insertLocal: dropping follower " << (*followers)[i]
-                    << " for shard " << collectionName;
-                } else {
-                  LOG_TOPIC(ERR, Logger::REPLICATION)
-                    << "insertLocal: could not drop follower "
-                    << (*followers)[i] << " for shard " << collectionName;
-                  THROW_ARANGO_EXCEPTION(TRI_ERROR_CLUSTER_COULD_NOT_DROP_FOLLOWER);
-                }
-              }
-            }
-          }
+        Result replicationRes =
+            SynchronousReplicationBatcher::instance()->replicate(
+                collection, arangodb::rest::RequestType::POST,
+                path, payload.slice(), count, followers, chooseTimeout(count));
+        if (replicationRes.fail()) {
+          return OperationResult(replicationRes.errorNumber());
         }
       }
     }
@@ -1759,6 +1725,8 @@ OperationResult transaction::Methods::modifyLocal(
 
     TRI_ASSERT(!result.empty());
     TRI_ASSERT(!previous.empty());
+    _state->trackViewChange(cid, VPackSlice(previous.vpack()),
+                            VPackSlice(result.vpack()));
 
     StringRef key(newVal.get(StaticStrings::KeyString));
     buildDocumentIdentity(collection, resultBuilder, cid, key,
@@ -1852,62 +1820,15 @@ OperationResult transaction::Methods::modifyLocal(
           count++;
         }
         if (count > 0) {
-          auto body = std::make_shared<std::string>();
-          *body = payload.slice().toJson();
-
-          // Now prepare the requests:
-          std::vector<ClusterCommRequest> requests;
-          for (auto const& f : *followers) {
-            requests.emplace_back("server:" + f,
-                operation == TRI_VOC_DOCUMENT_OPERATION_REPLACE
-                ? arangodb::rest::RequestType::PUT
-                : arangodb::rest::RequestType::PATCH,
-                path, body);
-          }
-          size_t nrDone = 0;
-          size_t nrGood = cc->performRequests(requests, chooseTimeout(count),
-                                              nrDone, Logger::REPLICATION, false);
-          if (nrGood < followers->size()) {
-            // If any would-be-follower refused to follow there must be a
-            // new leader in the meantime, in this case we must not allow
-            // this operation to succeed, we simply return with a refusal
-            // error (note that we use the follower version, since we have
-            // lost leadership):
-            if (findRefusal(requests)) {
-              return OperationResult(TRI_ERROR_CLUSTER_SHARD_LEADER_RESIGNED);
-            }
-
-            // Otherwise we drop all followers that were not successful:
-            for (size_t i = 0; i < followers->size(); ++i) {
-              bool replicationWorked =
-                requests[i].done &&
-                requests[i].result.status == CL_COMM_RECEIVED &&
-                (requests[i].result.answer_code ==
-                 rest::ResponseCode::ACCEPTED ||
-                 requests[i].result.answer_code == rest::ResponseCode::OK);
-              if (replicationWorked) {
-                bool found;
-                requests[i].result.answer->header(StaticStrings::ErrorCodes,
-                    found);
-                replicationWorked = !found;
-              }
-              if (!replicationWorked) {
-                auto const& followerInfo = collection->followers();
-                if (followerInfo->remove((*followers)[i])) {
-                  LOG_TOPIC(WARN, Logger::REPLICATION)
-                    << "modifyLocal: dropping follower " << (*followers)[i]
-                    << " for shard " << collectionName;
-                } else {
-                  LOG_TOPIC(ERR, Logger::REPLICATION)
-                    << "modifyLocal: could not drop follower "
-                    << (*followers)[i] << " for shard " << collectionName;
-                  THROW_ARANGO_EXCEPTION(TRI_ERROR_CLUSTER_COULD_NOT_DROP_FOLLOWER);
-                }
-                LOG_TOPIC(ERR, Logger::REPLICATION)
-                  << "modifyLocal: dropping follower " << (*followers)[i]
-                  << " for shard " << collectionName;
-              }
-            }
+          Result replicationRes =
+              SynchronousReplicationBatcher::instance()->replicate(
+                  collection,
+                  operation == TRI_VOC_DOCUMENT_OPERATION_REPLACE
+                      ? arangodb::rest::RequestType::PUT
+                      : arangodb::rest::RequestType::PATCH,
+                  path, payload.slice(), count, followers, chooseTimeout(count));
+          if (replicationRes.fail()) {
+            return OperationResult(replicationRes.errorNumber());
           }
         }
       }
@@ -2049,6 +1970,8 @@ OperationResult transaction::Methods::removeLocal(
     }
 
     TRI_ASSERT(!previous.empty());
+    _state->trackViewChange(cid, VPackSlice(previous.vpack()),
+                            VPackSlice::noneSlice());
     buildDocumentIdentity(collection, resultBuilder, cid, key, actualRevision,
                           0, options.returnOld ? &previous : nullptr, nullptr);
 
@@ -2134,57 +2057,12 @@ OperationResult transaction::Methods::removeLocal(
           count++;
         }
         if (count > 0) {
-          auto body = std::make_shared<std::string>();
-          *body = payload.slice().toJson();
-
-          // Now prepare the requests:
-          std::vector<ClusterCommRequest> requests;
-          for (auto const& f : *followers) {
-            requests.emplace_back("server:" + f,
-                arangodb::rest::RequestType::DELETE_REQ, path,
-                body);
-          }
-          size_t nrDone = 0;
-          size_t nrGood = cc->performRequests(requests, chooseTimeout(count),
-                                              nrDone, Logger::REPLICATION, false);
-          if (nrGood < followers->size()) {
-            // If any would-be-follower refused to follow there must be a
-            // new leader in the meantime, in this case we must not allow
-            // this operation to succeed, we simply return with a refusal
-            // error (note that we use the follower version, since we have
-            // lost leadership):
-            if (findRefusal(requests)) {
-              return OperationResult(TRI_ERROR_CLUSTER_SHARD_LEADER_RESIGNED);
-            }
-
-            // we drop all followers that were not successful:
-            for (size_t i = 0; i < followers->size(); ++i) {
-              bool replicationWorked =
-                requests[i].done &&
-                requests[i].result.status == CL_COMM_RECEIVED &&
-                (requests[i].result.answer_code ==
-                 rest::ResponseCode::ACCEPTED ||
-                 requests[i].result.answer_code == rest::ResponseCode::OK);
-              if (replicationWorked) {
-                bool found;
-                requests[i].result.answer->header(StaticStrings::ErrorCodes,
-                    found);
-                replicationWorked = !found;
-              }
-              if (!replicationWorked) {
-                auto const& followerInfo = collection->followers();
-                if (followerInfo->remove((*followers)[i])) {
-                  LOG_TOPIC(WARN, Logger::REPLICATION)
-                    << "removeLocal: dropping follower " << (*followers)[i]
-                    << " for shard " << collectionName;
-                } else {
-                  LOG_TOPIC(ERR, Logger::REPLICATION)
-                    << "removeLocal: could not drop follower "
-                    << (*followers)[i] << " for shard " << collectionName;
-                  THROW_ARANGO_EXCEPTION(TRI_ERROR_CLUSTER_COULD_NOT_DROP_FOLLOWER);
-                }
-              }
-            }
+          Result replicationRes =
+              SynchronousReplicationBatcher::instance()->replicate(
+                  collection, arangodb::rest::RequestType::DELETE_REQ,
+                  path, payload.slice(), count, followers, chooseTimeout(count));
+          if (replicationRes.fail()) {
+            return OperationResult(replicationRes.errorNumber());
           }
         }
       }
@@ -2334,6 +2212,7 @@ OperationResult transaction::Methods::truncateLocal(
     unlock(trxCollection(cid), AccessMode::Type::WRITE);
     return OperationResult(ex.code(), ex.what());
   }
+  _state->trackViewTruncate(cid);
 
   // Now see whether or not we have to do synchronous replication:
   if (_state->isDBServer()) {
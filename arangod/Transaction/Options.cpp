@@ -39,7 +39,9 @@ Options::Options()
       intermediateCommitSize(defaultIntermediateCommitSize),
       intermediateCommitCount(defaultIntermediateCommitCount),
       allowImplicitCollections(true),
-      waitForSync(false) {}
+      waitForSync(false),
+      readCommitted(false),
+      optimistic(false) {}
   
 void Options::setLimits(uint64_t maxTransactionSize, uint64_t intermediateCommitSize, uint64_t intermediateCommitCount) {
   defaultMaxTransactionSize = maxTransactionSize;
@@ -74,6 +76,14 @@ void Options::fromVelocyPack(arangodb::velocypack::Slice const& slice) {
   if (value.isBool()) {
     waitForSync = value.getBool();
   }
+  value = slice.get("readCommitted");
+  if (value.isBool()) {
+    readCommitted = value.getBool();
+  }
+  value = slice.get("optimistic");
+  if (value.isBool()) {
+    optimistic = value.getBool();
+  }
 }
  
 /// @brief add the options to an opened vpack builder 
@@ -86,4 +96,6 @@ void Options::toVelocyPack(arangodb::velocypack::Builder& builder) const {
   builder.add("intermediateCommitCount", VPackValue(intermediateCommitCount));
   builder.add("allowImplicitCollections", VPackValue(allowImplicitCollections));
   builder.add("waitForSync", VPackValue(waitForSync));
+  builder.add("readCommitted", VPackValue(readCommitted));
+  builder.add("optimistic", VPackValue(optimistic));
 }
@@ -54,10 +54,22 @@ struct Options {
   /// @brief time (in seconds) that is spent waiting for a lock
   double lockTimeout;
   uint64_t maxTransactionSize;
+  /// @brief a write transaction commits the operations done so far once
+  /// their size or number reaches one of these limits, and then continues.
+  /// operations committed this way are not rolled back if the transaction
+  /// is aborted later
   uint64_t intermediateCommitSize;
   uint64_t intermediateCommitCount;
   bool allowImplicitCollections; 
   bool waitForSync;
+  /// @brief long running reads may move on to newer snapshots between
+  /// batches, and then see data committed after the transaction started
+  bool readCommitted;
+  /// @brief do not wait for locks held by other transactions. a write to a
+  /// key locked or changed by another transaction fails immediately with a
+  /// conflict, which the caller may retry. optimistic transactions do not
+  /// commit intermediately, so they are limited by maxTransactionSize
+  bool optimistic;
 };
 
 }
@@ -24,7 +24,6 @@
 #include "CollectionNameResolver.h"
 
 #include "Basics/Common.h"
-#include "Basics/ReadLocker.h"
 #include "Basics/StringUtils.h"
 #include "Cluster/ClusterInfo.h"
 #include "VocBase/LogicalCollection.h"
@@ -263,14 +262,14 @@ std::string CollectionNameResolver::localNameLookup(TRI_voc_cid_t cid) const {
   std::string name;
 
   if (ServerState::isDBServer(_serverRole)) {
-    READ_LOCKER(readLocker, _vocbase->_collectionsLock);
+    auto names = _vocbase->collectionNamesSnapshot();
 
-    auto it = _vocbase->_collectionsById.find(cid);
+    auto it = names->byId.find(cid);
 
-    if (it != _vocbase->_collectionsById.end()) {
+    if (it != names->byId.end()) {
       if ((*it).second->planId() == (*it).second->cid()) {
         // DBserver local case
-        name = (*it).second->name();
+        name = names->namesById.at(cid);
       } else {
         // DBserver case of a shard:
         name = arangodb::basics::StringUtils::itoa((*it).second->planId());
@@ -22,7 +22,13 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "Cursor.h"
+#include "Aql/AqlItemBlock.h"
+#include "Aql/ExecutionBlock.h"
+#include "Aql/ExecutionEngine.h"
+#include "Aql/Query.h"
+#include "Basics/Exceptions.h"
 #include "Transaction/Context.h"
+#include "Transaction/Methods.h"
 #include "VocBase/vocbase.h"
 
 #include <velocypack/Builder.h>
@@ -54,6 +60,10 @@ VPackSlice Cursor::extra() const {
   return _extra->slice();
 }
 
+std::shared_ptr<transaction::Context> Cursor::context() const {
+  return std::shared_ptr<transaction::Context>();
+}
+
 VelocyPackCursor::VelocyPackCursor(TRI_vocbase_t* vocbase, CursorId id,
                                    aql::QueryResult&& result, size_t batchSize,
                                    std::shared_ptr<VPackBuilder> extra,
@@ -88,6 +98,10 @@ VPackSlice VelocyPackCursor::next() {
 /// @brief return the cursor size
 size_t VelocyPackCursor::count() const { return _iterator.size(); }
 
+std::shared_ptr<transaction::Context> VelocyPackCursor::context() const {
+  return _result.context;
+}
+
 void VelocyPackCursor::dump(VPackBuilder& builder) {
   try {
     size_t const n = batchSize();
@@ -146,3 +160,182 @@ void VelocyPackCursor::dump(VPackBuilder& builder) {
     THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "internal error during VPackCursor::dump");
   }
 }
+
+QueryStreamCursor::QueryStreamCursor(TRI_vocbase_t* vocbase, CursorId id,
+                                     std::string const& query,
+                                     std::shared_ptr<VPackBuilder> bindVars,
+                                     std::shared_ptr<VPackBuilder> opts,
+                                     size_t batchSize, double ttl,
+                                     aql::QueryRegistry* registry,
+                                     std::shared_ptr<aql::PlanCache> planCache)
+    : Cursor(id, batchSize, nullptr, ttl, false),
+      _vocbaseGuard(vocbase),
+      _queryString(query),
+      _blockPosition(0) {
+  // the query string must outlive the query, so the query refers to
+  // our own copy of it
+  _query.reset(new aql::Query(
+      false, vocbase, aql::QueryString(_queryString), bindVars, opts,
+      aql::PART_MAIN));
+  _query->setPlanCache(std::move(planCache));
+
+  // will throw if it fails
+  _query->prepareStreaming(registry);
+  _context = _query->trx()->transactionContext();
+}
+
+QueryStreamCursor::~QueryStreamCursor() {
+  // the block must be returned before the query and its engine go away.
+  // destroying an unfinished query aborts its transaction
+  _block.reset();
+  _query.reset();
+}
+
+/// @brief check whether the cursor contains more data
+bool QueryStreamCursor::hasNext() {
+  if (fetchBlock()) {
+    return true;
+  }
+
+  _isDeleted = true;
+  return false;
+}
+
+/// @brief return the next element (not implemented)
+VPackSlice QueryStreamCursor::next() {
+  // results are only available batch-wise via dump()
+  THROW_ARANGO_EXCEPTION_MESSAGE(
+      TRI_ERROR_NOT_IMPLEMENTED,
+      "streaming cursors do not support reading single results");
+}
+
+/// @brief return the cursor size. the size of a streamed result is not
+/// known in advance
+size_t QueryStreamCursor::count() const { return 0; }
+
+std::shared_ptr<transaction::Context> QueryStreamCursor::context() const {
+  return _context;
+}
+
+/// @brief make _block point to a block with unread rows
+bool QueryStreamCursor::fetchBlock() {
+  if (_block != nullptr && _blockPosition < _block->size()) {
+    return true;
+  }
+
+  _block.reset();
+  _blockPosition = 0;
+
+  if (_query == nullptr || _query->engine() == nullptr) {
+    // already finished
+    return false;
+  }
+
+  // at most one block of results is buffered in the cursor
+  _block.reset(_query->engine()->getSome(
+      1, aql::ExecutionBlock::DefaultBatchSize()));
+
+  if (_block == nullptr) {
+    // no more results
+    finish();
+    return false;
+  }
+
+  TRI_ASSERT(_block->size() > 0);
+  return true;
+}
+
+/// @brief commit the query and keep its statistics and warnings
+void QueryStreamCursor::finish() {
+  aql::QueryResult result = _query->finishStreaming();
+
+  if (result.code != TRI_ERROR_NO_ERROR) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(result.code, result.details);
+  }
+
+  // build "extra" attribute
+  _finalExtra = std::make_shared<VPackBuilder>();
+  VPackObjectBuilder b(_finalExtra.get());
+  if (result.stats != nullptr) {
+    VPackSlice stats = result.stats->slice();
+    if (!stats.isNone()) {
+      _finalExtra->add("stats", stats);
+    }
+  }
+  if (result.profile != nullptr) {
+    _finalExtra->add("profile", result.profile->slice());
+  }
+  if (result.plan != nullptr) {
+    _finalExtra->add("plan", result.plan->slice());
+  }
+  if (result.warnings == nullptr) {
+    _finalExtra->add("warnings", VPackValue(VPackValueType::Array));
+    _finalExtra->close();
+  } else {
+    _finalExtra->add("warnings", result.warnings->slice());
+  }
+}
+
+void QueryStreamCursor::dump(VPackBuilder& builder) {
+  // never keep a V8 context until the next batch, which may be requested
+  // from another thread
+  TRI_DEFER(if (_query != nullptr) { _query->exitContext(); });
+
+  try {
+    size_t const n = batchSize();
+    // reserve an arbitrary number of bytes for the result to save
+    // some reallocs
+    // (not accurate, but the actual size is unknown anyway)
+    builder.buffer()->reserve((std::min)(n, static_cast<size_t>(10000)) * 32);
+
+    VPackOptions const* oldOptions = builder.options;
+
+    builder.options = _context->getVPackOptionsForDump();
+
+    aql::RegisterId const resultRegister =
+        (_query->engine() != nullptr) ? _query->engine()->resultRegister() : 0;
+
+    builder.add("result", VPackValue(VPackValueType::Array));
+    size_t i = 0;
+    while (i < n && fetchBlock()) {
+      aql::AqlValue const& val =
+          _block->getValueReference(_blockPosition, resultRegister);
+
+      if (!val.isEmpty()) {
+        val.toVelocyPack(_query->trx(), builder, false);
+        ++i;
+      }
+      ++_blockPosition;
+    }
+    builder.close();
+
+    // this will finish the query if there are no more results, so the
+    // final statistics are available in the last batch
+    bool const hasMore = hasNext();
+    builder.add("hasMore", VPackValue(hasMore));
+
+    if (hasMore) {
+      builder.add("id", VPackValue(std::to_string(id())));
+    } else if (_finalExtra != nullptr) {
+      builder.add("extra", _finalExtra->slice());
+    }
+
+    builder.add("cached", VPackValue(false));
+
+    if (!hasMore) {
+      // mark the cursor as deleted
+      this->deleted();
+    }
+    builder.options = oldOptions;
+  } catch (arangodb::basics::Exception const& ex) {
+    // a failed query cannot be continued
+    this->deleted();
+    THROW_ARANGO_EXCEPTION_MESSAGE(ex.code(), ex.what());
+  } catch (std::exception const& ex) {
+    this->deleted();
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, ex.what());
+  } catch (...) {
+    this->deleted();
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "internal error during QueryStreamCursor::dump");
+  }
+}
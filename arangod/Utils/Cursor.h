@@ -31,11 +31,22 @@
 
 #include <velocypack/Iterator.h>
 
+#include <atomic>
+
 namespace arangodb {
 namespace velocypack {
 class Builder;
 class Slice;
 }
+namespace aql {
+class AqlItemBlock;
+class PlanCache;
+class Query;
+class QueryRegistry;
+}
+namespace transaction {
+class Context;
+}
 
 typedef TRI_voc_tick_t CursorId;
 
@@ -84,6 +95,16 @@ class Cursor {
     _expires = TRI_microtime() + _ttl;
   }
 
+  /// @brief marks the cursor as used, unless another thread uses it already
+  bool tryUse() {
+    bool expected = false;
+    if (!_isUsed.compare_exchange_strong(expected, true)) {
+      return false;
+    }
+    _expires = TRI_microtime() + _ttl;
+    return true;
+  }
+
   void release() {
     TRI_ASSERT(_isUsed);
     _isUsed = false;
@@ -99,6 +120,9 @@ class Cursor {
 
   virtual void dump(VPackBuilder&) = 0;
 
+  /// @brief the transaction context to use for dumping the results
+  virtual std::shared_ptr<transaction::Context> context() const;
+
  protected:
   CursorId const _id;
   size_t const _batchSize;
@@ -107,8 +131,8 @@ class Cursor {
   double _ttl;
   double _expires;
   bool const _hasCount;
-  bool _isDeleted;
-  bool _isUsed;
+  std::atomic<bool> _isDeleted;
+  std::atomic<bool> _isUsed;
 };
 
 class VelocyPackCursor final : public Cursor {
@@ -132,6 +156,8 @@ class VelocyPackCursor final : public Cursor {
 
   void dump(VPackBuilder&) override final;
 
+  std::shared_ptr<transaction::Context> context() const override final;
+
  private:
   VocbaseGuard _vocbaseGuard;
   aql::QueryResult _result;
@@ -139,6 +165,51 @@ class VelocyPackCursor final : public Cursor {
   bool _cached;
 };
 
+/// @brief a cursor that keeps the query alive and pulls its results from
+/// the execution engine batch by batch, instead of materializing the whole
+/// result up front. the query's transaction (and thus its locks) is held
+/// until the last batch has been fetched or the cursor is destroyed
+class QueryStreamCursor final : public Cursor {
+ public:
+  QueryStreamCursor(TRI_vocbase_t*, CursorId, std::string const&,
+                    std::shared_ptr<arangodb::velocypack::Builder>,
+                    std::shared_ptr<arangodb::velocypack::Builder>, size_t,
+                    double, aql::QueryRegistry*,
+                    std::shared_ptr<aql::PlanCache>);
+
+  ~QueryStreamCursor();
+
+ public:
+  CursorType type() const override final { return CURSOR_VPACK; }
+
+  bool hasNext() override final;
+
+  arangodb::velocypack::Slice next() override final;
+
+  size_t count() const override final;
+
+  void dump(VPackBuilder&) override final;
+
+  std::shared_ptr<transaction::Context> context() const override final;
+
+ private:
+  /// @brief make _block point to a block with unread rows, fetching it
+  /// from the engine if required. finishes the query when it is exhausted
+  bool fetchBlock();
+
+  /// @brief commit the query and keep its statistics and warnings
+  void finish();
+
+ private:
+  VocbaseGuard _vocbaseGuard;
+  std::string const _queryString;
+  std::unique_ptr<aql::Query> _query;
+  std::shared_ptr<transaction::Context> _context;
+  std::unique_ptr<aql::AqlItemBlock> _block;
+  size_t _blockPosition;
+  std::shared_ptr<arangodb::velocypack::Builder> _finalExtra;
+};
+
 }
 
 #endif
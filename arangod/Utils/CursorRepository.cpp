@@ -22,7 +22,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "CursorRepository.h"
-#include "Basics/MutexLocker.h"
+#include "Basics/ReadLocker.h"
+#include "Basics/WriteLocker.h"
 #include "Logger/Logger.h"
 #include "VocBase/ticks.h"
 #include "VocBase/vocbase.h"
@@ -39,9 +40,7 @@ size_t const CursorRepository::MaxCollectCount = 32;
 ////////////////////////////////////////////////////////////////////////////////
 
 CursorRepository::CursorRepository(TRI_vocbase_t* vocbase)
-    : _vocbase(vocbase), _lock(), _cursors() {
-  _cursors.reserve(64);
-}
+    : _vocbase(vocbase) {}
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief destroy a cursor repository
@@ -71,14 +70,14 @@ CursorRepository::~CursorRepository() {
     ++tries;
   }
 
-  {
-    MUTEX_LOCKER(mutexLocker, _lock);
+  for (auto& shard : _shards) {
+    WRITE_LOCKER(writeLocker, shard.lock);
 
-    for (auto it : _cursors) {
+    for (auto it : shard.cursors) {
       delete it.second;
     }
 
-    _cursors.clear();
+    shard.cursors.clear();
   }
 }
 
@@ -94,8 +93,9 @@ Cursor* CursorRepository::addCursor(std::unique_ptr<Cursor> cursor) {
   CursorId const id = cursor->id();
 
   {
-    MUTEX_LOCKER(mutexLocker, _lock);
-    _cursors.emplace(id, cursor.get());
+    Shard& shard = shardFor(id);
+    WRITE_LOCKER(writeLocker, shard.lock);
+    shard.cursors.emplace(id, cursor.get());
   }
 
   return cursor.release();
@@ -123,6 +123,28 @@ Cursor* CursorRepository::createFromQueryResult(
   return addCursor(std::move(cursor));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a cursor that streams the results of the query and stores
+/// it in the registry. this will prepare the query, and throw if that fails
+////////////////////////////////////////////////////////////////////////////////
+
+Cursor* CursorRepository::createQueryStream(
+    std::string const& query, std::shared_ptr<VPackBuilder> bindVars,
+    std::shared_ptr<VPackBuilder> opts, size_t batchSize, double ttl,
+    aql::QueryRegistry* registry, std::shared_ptr<aql::PlanCache> planCache) {
+  TRI_ASSERT(!query.empty());
+
+  CursorId const id = TRI_NewTickServer();
+
+  std::unique_ptr<Cursor> cursor;
+  cursor.reset(new QueryStreamCursor(
+      _vocbase, id, query, bindVars, opts, batchSize, ttl, registry,
+      std::move(planCache)));
+  cursor->use();
+
+  return addCursor(std::move(cursor));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief remove a cursor by id
 ////////////////////////////////////////////////////////////////////////////////
@@ -131,10 +153,11 @@ bool CursorRepository::remove(CursorId id, Cursor::CursorType type) {
   arangodb::Cursor* cursor = nullptr;
 
   {
-    MUTEX_LOCKER(mutexLocker, _lock);
+    Shard& shard = shardFor(id);
+    WRITE_LOCKER(writeLocker, shard.lock);
 
-    auto it = _cursors.find(id);
-    if (it == _cursors.end()) {
+    auto it = shard.cursors.find(id);
+    if (it == shard.cursors.end()) {
       // not found
       return false;
     }
@@ -158,7 +181,7 @@ bool CursorRepository::remove(CursorId id, Cursor::CursorType type) {
     }
 
     // cursor not in use by someone else
-    _cursors.erase(it);
+    shard.cursors.erase(it);
   }
 
   TRI_ASSERT(cursor != nullptr);
@@ -178,10 +201,13 @@ Cursor* CursorRepository::find(CursorId id, Cursor::CursorType type, bool& busy)
   busy = false;
 
   {
-    MUTEX_LOCKER(mutexLocker, _lock);
+    // the read lock keeps the cursor from being removed, and the usage flag
+    // keeps other threads from using it at the same time
+    Shard& shard = shardFor(id);
+    READ_LOCKER(readLocker, shard.lock);
 
-    auto it = _cursors.find(id);
-    if (it == _cursors.end()) {
+    auto it = shard.cursors.find(id);
+    if (it == shard.cursors.end()) {
       // not found
       return nullptr;
     }
@@ -198,12 +224,10 @@ Cursor* CursorRepository::find(CursorId id, Cursor::CursorType type, bool& busy)
       return nullptr;
     }
 
-    if (cursor->isUsed()) {
+    if (!cursor->tryUse()) {
       busy = true;
       return nullptr;
     }
-
-    cursor->use();
   }
 
   return cursor;
@@ -214,18 +238,29 @@ Cursor* CursorRepository::find(CursorId id, Cursor::CursorType type, bool& busy)
 ////////////////////////////////////////////////////////////////////////////////
 
 void CursorRepository::release(Cursor* cursor) {
+  Shard& shard = shardFor(cursor->id());
+
   {
-    MUTEX_LOCKER(mutexLocker, _lock);
+    // a cursor can only be marked as deleted by other threads while they
+    // hold the write lock
+    READ_LOCKER(readLocker, shard.lock);
 
     TRI_ASSERT(cursor->isUsed());
-    cursor->release();
 
     if (!cursor->isDeleted()) {
+      cursor->release();
       return;
     }
+  }
+
+  {
+    WRITE_LOCKER(writeLocker, shard.lock);
+
+    TRI_ASSERT(cursor->isUsed());
+    cursor->release();
 
     // remove from the list
-    _cursors.erase(cursor->id());
+    shard.cursors.erase(cursor->id());
   }
 
   // and free the cursor
@@ -237,11 +272,13 @@ void CursorRepository::release(Cursor* cursor) {
 ////////////////////////////////////////////////////////////////////////////////
 
 bool CursorRepository::containsUsedCursor() {
-  MUTEX_LOCKER(mutexLocker, _lock);
+  for (auto& shard : _shards) {
+    READ_LOCKER(readLocker, shard.lock);
 
-  for (auto it : _cursors) {
-    if (it.second->isUsed()) {
-      return true;
+    for (auto it : shard.cursors) {
+      if (it.second->isUsed()) {
+        return true;
+      }
     }
   }
 
@@ -259,35 +296,42 @@ bool CursorRepository::garbageCollect(bool force) {
   try {
     found.reserve(MaxCollectCount);
 
-    MUTEX_LOCKER(mutexLocker, _lock);
+    for (auto& shard : _shards) {
+      if (!force && found.size() >= MaxCollectCount) {
+        break;
+      }
 
-    for (auto it = _cursors.begin(); it != _cursors.end(); /* no hoisting */) {
-      auto cursor = (*it).second;
+      WRITE_LOCKER(writeLocker, shard.lock);
 
-      if (cursor->isUsed()) {
-        // must not destroy used cursors
-        ++it;
-        continue;
-      }
+      for (auto it = shard.cursors.begin();
+           it != shard.cursors.end(); /* no hoisting */) {
+        auto cursor = (*it).second;
 
-      if (force || cursor->expires() < now) {
-        cursor->deleted();
-      }
+        if (cursor->isUsed()) {
+          // must not destroy used cursors
+          ++it;
+          continue;
+        }
 
-      if (cursor->isDeleted()) {
-        try {
-          found.emplace_back(cursor);
-          it = _cursors.erase(it);
-        } catch (...) {
-          // stop iteration
-          break;
+        if (force || cursor->expires() < now) {
+          cursor->deleted();
         }
 
-        if (!force && found.size() >= MaxCollectCount) {
-          break;
+        if (cursor->isDeleted()) {
+          try {
+            found.emplace_back(cursor);
+            it = shard.cursors.erase(it);
+          } catch (...) {
+            // stop iteration
+            break;
+          }
+
+          if (!force && found.size() >= MaxCollectCount) {
+            break;
+          }
+        } else {
+          ++it;
         }
-      } else {
-        ++it;
       }
     }
   } catch (...) {
@@ -25,7 +25,7 @@
 #define ARANGOD_UTILS_CURSOR_REPOSITORY_H 1
 
 #include "Basics/Common.h"
-#include "Basics/Mutex.h"
+#include "Basics/ReadWriteLock.h"
 #include "Utils/Cursor.h"
 #include "VocBase/voc-types.h"
 
@@ -37,6 +37,8 @@ class Builder;
 }
 
 namespace aql {
+class PlanCache;
+class QueryRegistry;
 struct QueryResult;
 }
 
@@ -74,6 +76,18 @@ class CursorRepository {
       aql::QueryResult&&, size_t, std::shared_ptr<arangodb::velocypack::Builder>,
       double, bool);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief creates a cursor that streams the results of the query and
+  /// stores it in the registry. the plan cache is nullptr for the global one
+  /// the cursor will be returned with the usage flag set to true. it must be
+  /// returned later using release()
+  //////////////////////////////////////////////////////////////////////////////
+
+  Cursor* createQueryStream(
+      std::string const&, std::shared_ptr<arangodb::velocypack::Builder>,
+      std::shared_ptr<arangodb::velocypack::Builder>, size_t, double,
+      aql::QueryRegistry*, std::shared_ptr<aql::PlanCache>);
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief remove a cursor by id
   //////////////////////////////////////////////////////////////////////////////
@@ -114,16 +128,30 @@ class CursorRepository {
   TRI_vocbase_t* _vocbase;
 
   //////////////////////////////////////////////////////////////////////////////
-  /// @brief mutex for the cursors repository
+  /// @brief number of independently locked parts of the repository. cursors
+  /// are assigned to a shard by their id
   //////////////////////////////////////////////////////////////////////////////
 
-  Mutex _lock;
+  static constexpr size_t NumberOfShards = 16;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief one part of the repository. finding and releasing a cursor only
+  /// needs the read lock, the usage flag of the cursor makes sure only one
+  /// thread uses it. adding and removing cursors needs the write lock
+  //////////////////////////////////////////////////////////////////////////////
+
+  struct Shard {
+    basics::ReadWriteLock lock;
+    std::unordered_map<CursorId, Cursor*> cursors;
+  };
+
+  Shard& shardFor(CursorId id) { return _shards[id % NumberOfShards]; }
 
   //////////////////////////////////////////////////////////////////////////////
-  /// @brief list of current cursors
+  /// @brief the shards with the current cursors
   //////////////////////////////////////////////////////////////////////////////
 
-  std::unordered_map<CursorId, Cursor*> _cursors;
+  Shard _shards[NumberOfShards];
 
   //////////////////////////////////////////////////////////////////////////////
   /// @brief maximum number of cursors to garbage-collect in one go
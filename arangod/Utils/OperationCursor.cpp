@@ -44,6 +44,10 @@ bool OperationCursor::hasMore() {
 
 bool OperationCursor::hasExtra() const { return indexIterator()->hasExtra(); }
 
+bool OperationCursor::hasCovering() const {
+  return indexIterator()->hasCovering();
+}
+
 void OperationCursor::reset() {
   code = TRI_ERROR_NO_ERROR;
 
@@ -133,6 +137,50 @@ bool OperationCursor::nextDocument(IndexIterator::DocumentCallback const& callba
   return _hasMore;
 }
 
+/// @brief Calls cb with the indexed attribute values of the next batchSize
+///        many elements. Can only be called on indexes that support it.
+///        NOTE: This will throw on OUT_OF_MEMORY
+bool OperationCursor::nextCovering(IndexIterator::DocumentCallback const& callback,
+                                   uint64_t batchSize) {
+  TRI_ASSERT(hasCovering());
+
+  if (!hasMore()) {
+    return false;
+  }
+  
+  if (batchSize == UINT64_MAX) {
+    batchSize = _batchSize;
+  }
+  
+  size_t atMost = static_cast<size_t>(batchSize > _limit ? _limit : batchSize);
+  
+#ifdef ARANGODB_ENABLE_MAINTAINER_MODE
+  // We add wrapper around Callback that validates that
+  // the callback has been called at least once.
+  bool called = false;
+  auto cb = [&](DocumentIdentifierToken const& token, VPackSlice slice) {
+    called = true;
+    callback(token, slice);
+  };
+  _hasMore = _indexIterator->nextCovering(cb, atMost);
+  if (_hasMore) {
+    // If the index says it has more elements than it need
+    // to call callback at least once.
+    // Otherweise progress is not guaranteed.
+    TRI_ASSERT(called);
+  }
+#else
+  _hasMore = _indexIterator->nextCovering(callback, atMost);
+#endif
+  
+  if (_hasMore) {
+    // We got atMost many callbacks
+    TRI_ASSERT(_limit >= atMost);
+    _limit -= atMost;
+  }
+  return _hasMore;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 /// @brief Calls cb for the next batchSize many elements
 ///        Uses the getExtra feature of indexes. Can only be called on those
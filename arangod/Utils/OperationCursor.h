@@ -91,6 +91,8 @@ struct OperationCursor {
 
   bool hasExtra() const;
 
+  bool hasCovering() const;
+
 /// @brief Reset the cursor
   void reset();
 
@@ -104,6 +106,11 @@ struct OperationCursor {
 
   bool nextDocument(IndexIterator::DocumentCallback const& callback,
                     uint64_t batchSize);
+
+/// @brief Calls cb with the indexed attribute values of the next batchSize
+///        many elements. Can only be called if hasCovering() is true
+  bool nextCovering(IndexIterator::DocumentCallback const& callback,
+                    uint64_t batchSize);
   
 /// @brief convenience function to retrieve all results
   void all(IndexIterator::TokenCallback const& callback) {
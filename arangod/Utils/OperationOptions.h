@@ -32,7 +32,8 @@ struct OperationOptions {
   OperationOptions() 
       : recoveryData(nullptr), waitForSync(false), keepNull(true),
         mergeObjects(true), silent(false), ignoreRevs(true),
-        returnOld(false), returnNew(false), isRestore(false) {}
+        returnOld(false), returnNew(false), isRestore(false),
+        maxStaleness(0.0) {}
 
   // original marker, set by an engine's recovery procedure only!
   void* recoveryData;
@@ -62,6 +63,10 @@ struct OperationOptions {
   // this option is there to ensure _key values once set can be restored by replicated and arangorestore
   bool isRestore;
 
+  // for reads on a coordinator: the number of seconds the result may lag
+  // behind the shard leader. if positive, in-sync followers may answer
+  double maxStaleness;
+
   // for synchronous replication operations, we have to mark them such that
   // we can deny them if we are a (new) leader, and that we can deny other
   // operation if we are merely a follower. Finally, we must deny replications
@@ -50,7 +50,8 @@ std::string const GlobalContextMethods::CodeWarmupExports =
 V8Context::V8Context(size_t id, v8::Isolate* isolate)
     : _id(id), _isolate(isolate), _locker(nullptr), 
       _numExecutions(0), _creationStamp(TRI_microtime()), 
-      _lastGcStamp(0.0), _hasActiveExternals(false) {}
+      _lastGcStamp(0.0), _hasActiveExternals(false),
+      _heapSize(0), _heapSizeAfterGc(0), _numGcs(0), _gcTime(0.0) {}
 
 void V8Context::lockAndEnter() {
   TRI_ASSERT(_isolate != nullptr);
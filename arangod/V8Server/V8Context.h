@@ -129,6 +129,15 @@ class V8Context {
   double _lastGcStamp;
   bool _hasActiveExternals;
 
+  /// @brief used heap size after the last request and after the last full
+  /// garbage collection
+  size_t _heapSize;
+  size_t _heapSizeAfterGc;
+
+  /// @brief number of full garbage collections and time spent in them
+  uint64_t _numGcs;
+  double _gcTime;
+
   Mutex _globalMethodsLock;
   std::vector<GlobalContextMethods::MethodType> _globalMethods;
 
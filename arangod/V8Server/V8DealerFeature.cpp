@@ -31,6 +31,7 @@
 #include "Basics/ArangoGlobalContext.h"
 #include "Basics/ConditionLocker.h"
 #include "Basics/FileUtils.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/StringUtils.h"
 #include "Basics/TimedAction.h"
 #include "Basics/WorkMonitor.h"
@@ -93,6 +94,7 @@ V8DealerFeature::V8DealerFeature(
     : application_features::ApplicationFeature(server, "V8Dealer"),
       _gcFrequency(30.0),
       _gcInterval(1000),
+      _gcHeapGrowth(32 * 1024 * 1024),
       _nrMaxContexts(0),
       _nrMinContexts(0),
       _nrInflightContexts(0),
@@ -104,7 +106,8 @@ V8DealerFeature::V8DealerFeature(
       _nrAdditionalContexts(0),
       _minimumContexts(1),
       _forceNrContexts(0),
-      _contextsModificationBlockers(0) {
+      _contextsModificationBlockers(0),
+      _lastContextWait(0.0) {
   setOptional(false);
   requiresElevatedPrivileges(false);
   startsAfter("Action");
@@ -129,6 +132,12 @@ void V8DealerFeature::collectOptions(std::shared_ptr<ProgramOptions> options) {
       "JavaScript request-based garbage collection interval (each x requests)",
       new UInt64Parameter(&_gcInterval));
 
+  options->addHiddenOption(
+      "--javascript.gc-heap-growth",
+      "JavaScript heap-based garbage collection threshold (growth of the "
+      "used heap in bytes since the last garbage collection)",
+      new UInt64Parameter(&_gcHeapGrowth));
+
   options->addOption("--javascript.app-path", "directory for Foxx applications",
                      new StringParameter(&_appPath));
 
@@ -248,29 +257,20 @@ void V8DealerFeature::start() {
   defineBoolean("ALLOW_ADMIN_EXECUTE", _allowAdminExecute);
 
   // setup instances
+  std::vector<V8Context*> contexts = buildContexts(static_cast<size_t>(_nrMinContexts));
+
   {
     CONDITION_LOCKER(guard, _contextCondition);
     _contexts.reserve(static_cast<size_t>(_nrMaxContexts));
     _busyContexts.reserve(static_cast<size_t>(_nrMaxContexts));
     _freeContexts.reserve(static_cast<size_t>(_nrMaxContexts));
     _dirtyContexts.reserve(static_cast<size_t>(_nrMaxContexts));
-  
-    for (size_t i = 0; i < _nrMinContexts; ++i) {
-      V8Context* context = buildContext(nextId());
-      try {
-        _contexts.push_back(context);
-      } catch (...) {
-        delete context;
-        throw;
-      }
-    }
+
+    _contexts = contexts;
   
     TRI_ASSERT(_contexts.size() > 0); 
     TRI_ASSERT(_contexts.size() <= _nrMaxContexts);  
     for (auto& context : _contexts) {
-      // apply context update is only run on contexts that no other
-      // threads can see (yet)
-      applyContextUpdate(context);
       _freeContexts.push_back(context);
     }
   }
@@ -305,6 +305,59 @@ V8Context* V8DealerFeature::addContext() {
   }
 }
 
+/// @brief builds the initial contexts. every context has its own isolate,
+/// so they are built and updated by several threads at the same time
+std::vector<V8Context*> V8DealerFeature::buildContexts(size_t n) {
+  std::vector<V8Context*> contexts(n, nullptr);
+  std::vector<size_t> ids;
+  for (size_t i = 0; i < n; ++i) {
+    ids.push_back(nextId());
+  }
+
+  std::atomic<size_t> next(0);
+  Mutex failureLock;
+  std::exception_ptr failure;
+
+  auto build = [&]() {
+    size_t i;
+    while ((i = next++) < n) {
+      try {
+        contexts[i] = buildContext(ids[i]);
+        // apply context update is only run on contexts that no other
+        // threads can see (yet)
+        applyContextUpdate(contexts[i]);
+      } catch (...) {
+        MUTEX_LOCKER(locker, failureLock);
+        if (!failure) {
+          failure = std::current_exception();
+        }
+        return;
+      }
+    }
+  };
+
+  size_t numThreads = (std::min)(
+      n, static_cast<size_t>((std::max)(1U, std::thread::hardware_concurrency())));
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < numThreads; ++i) {
+    threads.emplace_back(build);
+  }
+  build();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (failure) {
+    for (auto& context : contexts) {
+      delete context;
+    }
+    std::rethrow_exception(failure);
+  }
+
+  LOG_TOPIC(DEBUG, Logger::V8) << "built " << n << " V8 contexts using " << numThreads << " thread(s)";
+  return contexts;
+}
+
 void V8DealerFeature::unprepare() {
   // turn off memory allocation failures before going into v8 code 
   TRI_DisallowMemoryFailures();
@@ -395,9 +448,10 @@ void V8DealerFeature::collectGarbage() {
         if (context == nullptr && !_dirtyContexts.empty()) {
           context = _dirtyContexts.back();
           _dirtyContexts.pop_back();
-          if (context->_numExecutions < 50 && !context->_hasActiveExternals) {
-            // don't collect this one yet. it doesn't have externals, so there
-            // is no urge for garbage collection
+          if (!needsGarbageCollection(context)) {
+            // don't collect this one yet. its heap has hardly grown and it
+            // doesn't have externals, so there is no urge for garbage
+            // collection
             _freeContexts.emplace_back(context);
             context = nullptr;
           } else {
@@ -455,21 +509,37 @@ void V8DealerFeature::collectGarbage() {
             hasActiveExternals = v8g->hasActiveExternals();
           }
           localContext->Exit();
+
+          v8::HeapStatistics stats;
+          isolate->GetHeapStatistics(&stats);
+          context->_heapSizeAfterGc = stats.used_heap_size();
         }
 
         // update garbage collection statistics
+        double const gcTime = TRI_microtime() - lastGc;
         context->_hasActiveExternals = hasActiveExternals;
         context->_numExecutions = 0;
         context->_lastGcStamp = lastGc;
+        context->_heapSize = context->_heapSizeAfterGc;
+        context->_gcTime += gcTime;
+        ++context->_numGcs;
+
+        LOG_TOPIC(DEBUG, arangodb::Logger::V8) << "collected V8 garbage in context #" << context->_id
+                  << " in " << Logger::FIXED(gcTime) << " s, used heap: " << context->_heapSizeAfterGc
+                  << ", garbage collections: " << context->_numGcs
+                  << ", total time: " << Logger::FIXED(context->_gcTime) << " s";
 
         {
           CONDITION_LOCKER(guard, _contextCondition);
 
           double const minAge = 15.0;
 
+          // don't shrink while requests still had to wait for a context
+          // recently, they would only have to build it again
           if (_contexts.size() > _nrMinContexts && 
               !context->isDefault() &&
               context->age() > minAge &&
+              TRI_microtime() - _lastContextWait > minAge &&
               _contextsModificationBlockers == 0) {
             // remove the extra context as it is not needed anymore
             _contexts.erase(std::remove_if(_contexts.begin(), _contexts.end(), [&context](V8Context* c) {
@@ -729,6 +799,7 @@ V8Context* V8DealerFeature::enterContext(TRI_vocbase_t* vocbase,
       TRI_ASSERT(guard.isLocked());
 
       LOG_TOPIC(TRACE, arangodb::Logger::V8) << "waiting for unused V8 context";
+      _lastContextWait = TRI_microtime();
 
       if (!_dirtyContexts.empty()) {
         // we'll use a dirty context in this case
@@ -875,6 +946,21 @@ void V8DealerFeature::exitLockedContext(V8Context* context) {
 
   // update data for later garbage collection
   {
+    v8::HeapStatistics stats;
+    isolate->GetHeapStatistics(&stats);
+    size_t const heapSize = stats.used_heap_size();
+
+    if (heapSize > context->_heapSize + _gcHeapGrowth / 8) {
+      // the request left garbage behind. give V8 a moment to collect the
+      // young generation or do incremental marking steps now, so that a
+      // full collection becomes necessary less often
+      isolate->IdleNotification(1);
+      isolate->GetHeapStatistics(&stats);
+      context->_heapSize = stats.used_heap_size();
+    } else {
+      context->_heapSize = heapSize;
+    }
+
     TRI_GET_GLOBALS();
     context->_hasActiveExternals = v8g->hasActiveExternals();
     ++context->_numExecutions;
@@ -936,7 +1022,14 @@ void V8DealerFeature::exitContext(V8Context* context) {
 
     // postpone garbage collection for standard contexts
     double lastGc = gc->getLastGcStamp();
-    if (context->_lastGcStamp + _gcFrequency < lastGc) {
+    if (context->_heapSize > context->_heapSizeAfterGc + _gcHeapGrowth) {
+      LOG_TOPIC(TRACE, arangodb::Logger::V8) << "V8 context has reached GC heap growth threshold and will be "
+                    "scheduled for GC";
+      performGarbageCollection = true;
+    } else if (!context->_hasActiveExternals) {
+      // only the heap matters, and V8 collects the young generation by
+      // itself
+    } else if (context->_lastGcStamp + _gcFrequency < lastGc) {
       LOG_TOPIC(TRACE, arangodb::Logger::V8) << "V8 context has reached GC timeout threshold and will be "
                     "scheduled for GC";
       performGarbageCollection = true;
@@ -1103,6 +1196,14 @@ void V8DealerFeature::shutdownContexts() {
   LOG_TOPIC(DEBUG, arangodb::Logger::V8) << "V8 contexts are shut down";
 }
 
+/// @brief whether a full garbage collection in an unused context is worth
+/// it: the context holds external resources that are only freed by the GC,
+/// or its heap has grown noticeably since its last collection
+bool V8DealerFeature::needsGarbageCollection(V8Context const* context) const {
+  return context->_hasActiveExternals ||
+         context->_heapSize > context->_heapSizeAfterGc + _gcHeapGrowth / 8;
+}
+
 V8Context* V8DealerFeature::pickFreeContextForGc() {
   int const n = (int)_freeContexts.size();
 
@@ -1121,8 +1222,7 @@ V8Context* V8DealerFeature::pickFreeContextForGc() {
 
   for (int i = n - 1; i > 0; --i) {
     // check if there's actually anything to clean up in the context
-    if (_freeContexts[i]->_numExecutions < 50 &&
-        !_freeContexts[i]->_hasActiveExternals) {
+    if (!needsGarbageCollection(_freeContexts[i])) {
       continue;
     }
 
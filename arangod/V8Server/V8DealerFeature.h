@@ -54,6 +54,7 @@ class V8DealerFeature final : public application_features::ApplicationFeature {
  private:
   double _gcFrequency;
   uint64_t _gcInterval;
+  uint64_t _gcHeapGrowth; // heap growth (bytes) that triggers a full GC
   std::string _appPath;
   std::string _startupDirectory;
   std::vector<std::string> _moduleDirectory;
@@ -101,7 +102,9 @@ class V8DealerFeature final : public application_features::ApplicationFeature {
   uint64_t nextId() { return _nextId++; }
   V8Context* addContext();
   V8Context* buildContext(size_t id);
+  std::vector<V8Context*> buildContexts(size_t n);
   V8Context* pickFreeContextForGc();
+  bool needsGarbageCollection(V8Context const* context) const;
   void shutdownContext(V8Context* context);
   void unblockContextsModification();
   void loadJavaScriptFileInternal(std::string const& file, V8Context* context,
@@ -131,6 +134,7 @@ class V8DealerFeature final : public application_features::ApplicationFeature {
   size_t _minimumContexts;
   size_t _forceNrContexts;
   size_t _contextsModificationBlockers;
+  double _lastContextWait; // last time a thread found no free context
 
   JSLoader _startupLoader;
 
@@ -2791,6 +2791,8 @@ static void JS_TruncateVocbaseCol(
   SingleCollectionTransaction trx(
       transaction::V8Context::Create(collection->vocbase(), true),
                                   collection->cid(), t);
+  // only used by the engine if the collection is locked exclusively
+  trx.addHint(transaction::Hints::Hint::ALLOW_RANGE_DELETE);
 
   Result res = trx.begin();
   if (!res.ok()) {
@@ -284,6 +284,13 @@ static void JS_SynchronizeReplication(
     }
   }
 
+  if (object->Has(TRI_V8_ASCII_STRING("initialSyncParallelism"))) {
+    if (object->Get(TRI_V8_ASCII_STRING("initialSyncParallelism"))->IsNumber()) {
+      config._initialSyncParallelism = TRI_ObjectToUInt64(
+          object->Get(TRI_V8_ASCII_STRING("initialSyncParallelism")), true);
+    }
+  }
+
   if (object->Has(TRI_V8_ASCII_STRING("includeSystem"))) {
     if (object->Get(TRI_V8_ASCII_STRING("includeSystem"))->IsBoolean()) {
       config._includeSystem = TRI_ObjectToBoolean(
@@ -524,6 +531,21 @@ static void JS_ConfigureApplierReplication(
       }
     }
 
+    if (object->Has(TRI_V8_ASCII_STRING("initialSyncParallelism"))) {
+      if (object->Get(TRI_V8_ASCII_STRING("initialSyncParallelism"))
+              ->IsNumber()) {
+        config._initialSyncParallelism = TRI_ObjectToUInt64(
+            object->Get(TRI_V8_ASCII_STRING("initialSyncParallelism")), true);
+      }
+    }
+
+    if (object->Has(TRI_V8_ASCII_STRING("applyParallelism"))) {
+      if (object->Get(TRI_V8_ASCII_STRING("applyParallelism"))->IsNumber()) {
+        config._applyParallelism = TRI_ObjectToUInt64(
+            object->Get(TRI_V8_ASCII_STRING("applyParallelism")), true);
+      }
+    }
+
     if (object->Has(TRI_V8_ASCII_STRING("autoStart"))) {
       if (object->Get(TRI_V8_ASCII_STRING("autoStart"))->IsBoolean()) {
         config._autoStart =
@@ -27,6 +27,9 @@
 #include "Basics/StringUtils.h"
 #include "Basics/process-utils.h"
 #include "Rest/GeneralRequest.h"
+#include "Scheduler/JobQueue.h"
+#include "Scheduler/Scheduler.h"
+#include "Scheduler/SchedulerFeature.h"
 #include "Statistics/ConnectionStatistics.h"
 #include "Statistics/RequestStatistics.h"
 #include "Statistics/ServerStatistics.h"
@@ -83,6 +86,31 @@ static void FillDistribution(v8::Isolate* isolate, v8::Handle<v8::Object> list,
   list->Set(name, result);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the percentiles of a histogram
+////////////////////////////////////////////////////////////////////////////////
+
+static void FillHistogram(v8::Isolate* isolate, v8::Handle<v8::Object> list,
+                          v8::Handle<v8::String> name,
+                          StatisticsHistogram const& histogram) {
+  v8::Handle<v8::Object> result = v8::Object::New(isolate);
+
+  result->Set(TRI_V8_ASCII_STRING("sum"),
+              v8::Number::New(isolate, histogram._total));
+  result->Set(TRI_V8_ASCII_STRING("count"),
+              v8::Number::New(isolate, (double)histogram._count));
+  result->Set(TRI_V8_ASCII_STRING("max"),
+              v8::Number::New(isolate, histogram._max));
+  result->Set(TRI_V8_ASCII_STRING("p50"),
+              v8::Number::New(isolate, histogram.percentile(0.5)));
+  result->Set(TRI_V8_ASCII_STRING("p99"),
+              v8::Number::New(isolate, histogram.percentile(0.99)));
+  result->Set(TRI_V8_ASCII_STRING("p999"),
+              v8::Number::New(isolate, histogram.percentile(0.999)));
+
+  list->Set(name, result);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief returns server statistics
 ///
@@ -91,6 +119,7 @@ static void FillDistribution(v8::Isolate* isolate, v8::Handle<v8::Object> list,
 /// Returns information about the server:
 ///
 /// - `uptime`: time since server start in seconds.
+/// - `scheduler`: admission control state of the job queue lanes.
 ////////////////////////////////////////////////////////////////////////////////
 
 static void JS_ServerStatistics(
@@ -107,6 +136,39 @@ static void JS_ServerStatistics(
   result->Set(TRI_V8_ASCII_STRING("physicalMemory"),
               v8::Number::New(isolate, (double)TRI_PhysicalMemory));
 
+  auto scheduler = SchedulerFeature::SCHEDULER;
+  JobQueue const* jobQueue =
+      (scheduler == nullptr) ? nullptr : scheduler->jobQueue();
+
+  if (jobQueue != nullptr) {
+    static char const* const LANES[JobQueue::NUMBER_OF_QUEUES] = {
+        "cluster", "fast", "standard", "background"};
+
+    v8::Handle<v8::Object> lanes = v8::Object::New(isolate);
+
+    for (size_t i = 0; i < JobQueue::NUMBER_OF_QUEUES; ++i) {
+      v8::Handle<v8::Object> lane = v8::Object::New(isolate);
+
+      lane->Set(TRI_V8_ASCII_STRING("queued"),
+                v8::Number::New(isolate, (double)jobQueue->queueSize(i)));
+      lane->Set(TRI_V8_ASCII_STRING("sojournTime"),
+                v8::Number::New(isolate, jobQueue->sojournTime(i)));
+      lane->Set(TRI_V8_ASCII_STRING("overloaded"),
+                v8::Boolean::New(isolate, jobQueue->isOverloaded(i)));
+      lane->Set(TRI_V8_ASCII_STRING("rejected"),
+                v8::Number::New(isolate, (double)jobQueue->rejected(i)));
+
+      lanes->Set(TRI_V8_ASCII_STRING(LANES[i]), lane);
+    }
+
+    v8::Handle<v8::Object> sched = v8::Object::New(isolate);
+    sched->Set(TRI_V8_ASCII_STRING("targetSojournTime"),
+               v8::Number::New(isolate, JobQueue::TARGET_SOJOURN));
+    sched->Set(TRI_V8_ASCII_STRING("lanes"), lanes);
+
+    result->Set(TRI_V8_ASCII_STRING("scheduler"), sched);
+  }
+
   TRI_V8_RETURN(result);
   TRI_V8_TRY_CATCH_END
 }
@@ -173,6 +235,22 @@ static void JS_ClientStatistics(
   FillDistribution(isolate, result, TRI_V8_ASCII_STRING("bytesReceived"),
                    bytesReceived);
 
+  std::map<std::string, RequestStatistics::RouteFigures> routeFigures;
+  RequestStatistics::fillRoutes(routeFigures);
+
+  v8::Handle<v8::Object> routes = v8::Object::New(isolate);
+
+  for (auto const& it : routeFigures) {
+    v8::Handle<v8::Object> route = v8::Object::New(isolate);
+    FillHistogram(isolate, route, TRI_V8_ASCII_STRING("totalTime"),
+                  it.second._totalTime);
+    FillHistogram(isolate, route, TRI_V8_ASCII_STRING("requestTime"),
+                  it.second._requestTime);
+    routes->Set(TRI_V8_STD_STRING(it.first), route);
+  }
+
+  result->Set(TRI_V8_ASCII_STRING("routes"), routes);
+
   TRI_V8_RETURN(result);
   TRI_V8_TRY_CATCH_END
 }
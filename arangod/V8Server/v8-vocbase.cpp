@@ -987,6 +987,10 @@ static void JS_ExecuteAqlJson(v8::FunctionCallbackInfo<v8::Value> const& args) {
     result->ForceSet(TRI_V8_ASCII_STRING("profile"),
                      TRI_VPackToV8(isolate, queryResult.profile->slice()));
   }
+  if (queryResult.plan != nullptr) {
+    result->ForceSet(TRI_V8_ASCII_STRING("plan"),
+                     TRI_VPackToV8(isolate, queryResult.plan->slice()));
+  }
   if (queryResult.warnings == nullptr) {
     result->ForceSet(TRI_V8_ASCII_STRING("warnings"), v8::Array::New(isolate));
   } else {
@@ -1093,6 +1097,10 @@ static void JS_ExecuteAql(v8::FunctionCallbackInfo<v8::Value> const& args) {
     result->ForceSet(TRI_V8_ASCII_STRING("profile"),
                      TRI_VPackToV8(isolate, queryResult.profile->slice()));
   }
+  if (queryResult.plan != nullptr) {
+    result->ForceSet(TRI_V8_ASCII_STRING("plan"),
+                     TRI_VPackToV8(isolate, queryResult.plan->slice()));
+  }
   if (queryResult.warnings == nullptr) {
     result->ForceSet(TRI_V8_ASCII_STRING("warnings"), v8::Array::New(isolate));
   } else {
@@ -1184,6 +1192,24 @@ static void JS_QueriesPropertiesAql(
   TRI_V8_TRY_CATCH_END
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the resources a query used to its description
+////////////////////////////////////////////////////////////////////////////////
+
+static void SetQueryUsage(v8::Isolate* isolate, v8::Handle<v8::Object> obj,
+                          aql::QueryUsageStats const& usage) {
+  obj->Set(TRI_V8_ASCII_STRING("memoryUsage"),
+           v8::Number::New(isolate, static_cast<double>(usage.memoryUsage)));
+  obj->Set(TRI_V8_ASCII_STRING("peakMemoryUsage"),
+           v8::Number::New(isolate, static_cast<double>(usage.peakMemoryUsage)));
+  obj->Set(TRI_V8_ASCII_STRING("cpuTime"),
+           v8::Number::New(isolate, usage.cpuTime));
+  obj->Set(TRI_V8_ASCII_STRING("rowsProcessed"),
+           v8::Number::New(isolate, static_cast<double>(usage.rowsProcessed)));
+  obj->Set(TRI_V8_ASCII_STRING("blockReads"),
+           v8::Number::New(isolate, static_cast<double>(usage.blockReads)));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief returns the list of currently running queries
 ////////////////////////////////////////////////////////////////////////////////
@@ -1227,6 +1253,7 @@ static void JS_QueriesCurrentAql(
       obj->Set(TRI_V8_ASCII_STRING("runTime"),
                v8::Number::New(isolate, q.runTime));
       obj->Set(TRI_V8_ASCII_STRING("state"), TRI_V8_STD_STRING(aql::QueryExecutionState::toString(q.state)));
+      SetQueryUsage(isolate, obj, q.usage);
       result->Set(i++, obj);
     }
 
@@ -1284,6 +1311,10 @@ static void JS_QueriesSlowAql(v8::FunctionCallbackInfo<v8::Value> const& args) {
       obj->Set(TRI_V8_ASCII_STRING("runTime"),
                v8::Number::New(isolate, q.runTime));
       obj->Set(TRI_V8_ASCII_STRING("state"), TRI_V8_STD_STRING(aql::QueryExecutionState::toString(q.state)));
+      SetQueryUsage(isolate, obj, q.usage);
+      if (q.snippets != nullptr) {
+        obj->Set(TRI_V8_ASCII_STRING("snippets"), TRI_VPackToV8(isolate, q.snippets->slice()));
+      }
       result->Set(i++, obj);
     }
 
@@ -1387,6 +1418,11 @@ static void JS_QueryCachePropertiesAql(
 
     // set mode and max elements
     queryCache->setProperties(cacheProperties);
+
+    if (obj->Has(TRI_V8_ASCII_STRING("maxStaleness"))) {
+      queryCache->setMaxStaleness(static_cast<uint64_t>(
+          TRI_ObjectToUInt64(obj->Get(TRI_V8_ASCII_STRING("maxStaleness")), false)));
+    }
   }
 
   auto properties = queryCache->properties();
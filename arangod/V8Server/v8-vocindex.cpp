@@ -54,6 +54,7 @@
 #include "VocBase/modes.h"
 
 #include <velocypack/Builder.h>
+#include <velocypack/Collection.h>
 #include <velocypack/Iterator.h>
 #include <velocypack/velocypack-aliases.h>
 
@@ -352,6 +353,145 @@ static void JS_CreateEdgeCollectionVocbase(
   TRI_V8_TRY_CATCH_END
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates many collections at once. in a cluster, all of them are
+/// added to the Plan with one agency transaction
+/// db._createCollections([<properties>, ...], <options>)
+////////////////////////////////////////////////////////////////////////////////
+
+static void JS_CreateCollectionsVocbase(
+    v8::FunctionCallbackInfo<v8::Value> const& args) {
+  TRI_V8_TRY_CATCH_BEGIN(isolate);
+  v8::HandleScope scope(isolate);
+
+  TRI_vocbase_t* vocbase = GetContextVocBase(isolate);
+
+  if (vocbase == nullptr) {
+    TRI_V8_THROW_EXCEPTION(TRI_ERROR_ARANGO_DATABASE_NOT_FOUND);
+  }
+
+  if (args.Length() < 1 || args.Length() > 2 || !args[0]->IsArray()) {
+    TRI_V8_THROW_EXCEPTION_USAGE("_createCollections(<collections>, <options>)");
+  }
+  if (TRI_GetOperationModeServer() == TRI_VOCBASE_MODE_NO_CREATE) {
+    TRI_V8_THROW_EXCEPTION(TRI_ERROR_ARANGO_READ_ONLY);
+  }
+
+  AuthenticationFeature* auth = FeatureCacheFeature::instance()->authenticationFeature();
+  if (auth->isActive() && ExecContext::CURRENT != nullptr) {
+    AuthLevel level = auth->canUseDatabase(ExecContext::CURRENT->user(),
+                                           vocbase->name());
+    if (level != AuthLevel::RW) {
+      TRI_V8_THROW_EXCEPTION(TRI_ERROR_FORBIDDEN);
+    }
+  }
+
+  PREVENT_EMBEDDED_TRANSACTION();
+
+  VPackBuilder input;
+  int res = TRI_V8ToVPack(isolate, input, args[0], false);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_V8_THROW_EXCEPTION(res);
+  }
+
+  // the type can be given as "edge" or "document" like in _create
+  VPackBuilder definitions;
+  definitions.openArray();
+  std::vector<std::string> names;
+  for (auto const& it : VPackArrayIterator(input.slice())) {
+    if (!it.isObject() || !it.get("name").isString()) {
+      TRI_V8_THROW_TYPE_ERROR(
+          "<collections> must be an array of objects with a name");
+    }
+    names.emplace_back(it.get("name").copyString());
+
+    TRI_col_type_e collectionType = TRI_COL_TYPE_DOCUMENT;
+    VPackSlice type = it.get("type");
+    if ((type.isString() && type.copyString() == "edge") ||
+        (type.isNumber() && type.getNumber<int>() == TRI_COL_TYPE_EDGE)) {
+      collectionType = TRI_COL_TYPE_EDGE;
+    }
+    VPackBuilder typeBuilder;
+    typeBuilder.openObject();
+    typeBuilder.add("type", VPackValue(static_cast<int>(collectionType)));
+    typeBuilder.close();
+    definitions.add(
+        VPackCollection::merge(it, typeBuilder.slice(), false).slice());
+  }
+  definitions.close();
+
+  v8::Handle<v8::Array> result = v8::Array::New(isolate);
+  uint32_t i = 0;
+
+  if (ServerState::instance()->isCoordinator()) {
+    bool createWaitsForSyncReplication =
+      application_features::ApplicationServer::getFeature<ClusterFeature>("Cluster")->createWaitsForSyncReplication();
+
+    if (args.Length() >= 2 && args[1]->IsObject()) {
+      v8::Handle<v8::Object> obj = args[1]->ToObject();
+      auto v8WaitForSyncReplication = obj->Get(TRI_V8_ASCII_STRING("waitForSyncReplication"));
+      if (!v8WaitForSyncReplication->IsUndefined()) {
+        createWaitsForSyncReplication = TRI_ObjectToBoolean(v8WaitForSyncReplication);
+      }
+    }
+
+    std::vector<VPackSlice> parameters;
+    for (auto const& it : VPackArrayIterator(definitions.slice())) {
+      parameters.emplace_back(it);
+    }
+
+    auto cols = ClusterMethods::createCollectionsOnCoordinator(
+        vocbase, parameters, false, createWaitsForSyncReplication);
+
+    for (auto& col : cols) {
+      v8::Handle<v8::Value> wrapped = WrapCollection(isolate, col.release());
+      if (wrapped.IsEmpty()) {
+        TRI_V8_THROW_EXCEPTION_MEMORY();
+      }
+      result->Set(i++, wrapped);
+    }
+  } else {
+    try {
+      for (auto const& it : VPackArrayIterator(definitions.slice())) {
+        arangodb::LogicalCollection const* collection =
+            vocbase->createCollection(it);
+        TRI_ASSERT(collection != nullptr);
+
+        v8::Handle<v8::Value> wrapped = WrapCollection(isolate, collection);
+        if (wrapped.IsEmpty()) {
+          TRI_V8_THROW_EXCEPTION_MEMORY();
+        }
+        result->Set(i++, wrapped);
+      }
+    } catch (basics::Exception const& ex) {
+      TRI_V8_THROW_EXCEPTION_MESSAGE(ex.code(), ex.what());
+    } catch (std::exception const& ex) {
+      TRI_V8_THROW_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, ex.what());
+    } catch (...) {
+      TRI_V8_THROW_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL,
+                                     "cannot create collections");
+    }
+  }
+
+  // in case of success we grant the creating user RW access, but not
+  // on system collections
+  if (ExecContext::CURRENT != nullptr &&
+      (ServerState::instance()->isCoordinator() ||
+       !ServerState::instance()->isRunningInCluster())) {
+    auth->authInfo()->updateUser(ExecContext::CURRENT->user(),
+                                 [&](AuthUserEntry& entry) {
+      for (auto const& name : names) {
+        if (name[0] != '_') {
+          entry.grantCollection(vocbase->name(), name, AuthLevel::RW);
+        }
+      }
+    });
+  }
+  TRI_V8_RETURN(result);
+  TRI_V8_TRY_CATCH_END
+}
+
 void TRI_InitV8IndexArangoDB(v8::Isolate* isolate,
                              v8::Handle<v8::ObjectTemplate> rt) {
   TRI_AddMethodVocbase(isolate, rt, TRI_V8_ASCII_STRING("_create"),
@@ -362,6 +502,9 @@ void TRI_InitV8IndexArangoDB(v8::Isolate* isolate,
   TRI_AddMethodVocbase(isolate, rt,
                        TRI_V8_ASCII_STRING("_createDocumentCollection"),
                        JS_CreateDocumentCollectionVocbase);
+  TRI_AddMethodVocbase(isolate, rt,
+                       TRI_V8_ASCII_STRING("_createCollections"),
+                       JS_CreateCollectionsVocbase);
 }
 
 void TRI_InitV8IndexCollection(v8::Isolate* isolate,
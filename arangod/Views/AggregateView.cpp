@@ -0,0 +1,335 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Views/AggregateView.h"
+#include "Basics/Exceptions.h"
+#include "Basics/MutexLocker.h"
+#include "Basics/ReadLocker.h"
+#include "Basics/Result.h"
+#include "Basics/WriteLocker.h"
+#include "Logger/Logger.h"
+#include "Transaction/StandaloneContext.h"
+#include "Utils/OperationCursor.h"
+#include "Utils/SingleCollectionTransaction.h"
+#include "VocBase/LogicalCollection.h"
+#include "VocBase/LogicalView.h"
+#include "VocBase/ManagedDocumentResult.h"
+#include "VocBase/vocbase.h"
+
+#include <velocypack/Collection.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+
+std::string AggregateView::type("aggregate");
+
+basics::ReadWriteLock AggregateView::_registryLock;
+std::unordered_multimap<TRI_voc_cid_t,
+                        std::shared_ptr<AggregateView::Materialization>>
+    AggregateView::_registry;
+std::atomic<size_t> AggregateView::_numberOfViews(0);
+
+std::unique_ptr<ViewImplementation> AggregateView::creator(
+    LogicalView* view, arangodb::velocypack::Slice const& info, bool isNew) {
+  LOG_TOPIC(TRACE, Logger::VIEWS)
+      << "called AggregateView::creator with data: " << info.toJson()
+      << ", isNew: " << isNew;
+
+  return std::make_unique<AggregateView>(ConstructionGuard(), view, info,
+                                         isNew);
+}
+
+AggregateView::AggregateView(ConstructionGuard const&, LogicalView* logical,
+                             arangodb::velocypack::Slice const& info,
+                             bool isNew)
+    : ViewImplementation(logical, info) {
+  AggregateDefinition definition;
+  Result res =
+      AggregateDefinition::fromVelocyPack(info.get("properties"), definition);
+  if (res.fail()) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(res.errorNumber(), res.errorMessage());
+  }
+  _materialization = std::make_shared<Materialization>(definition);
+}
+
+AggregateView::~AggregateView() {
+  unregisterMaterialization(_materialization);
+}
+
+void AggregateView::materializations(
+    TRI_voc_cid_t cid, std::vector<std::shared_ptr<Materialization>>& result) {
+  READ_LOCKER(locker, _registryLock);
+
+  auto range = _registry.equal_range(cid);
+  for (auto it = range.first; it != range.second; ++it) {
+    result.emplace_back((*it).second);
+  }
+}
+
+void AggregateView::registerMaterialization(
+    std::shared_ptr<Materialization> const& materialization,
+    TRI_voc_cid_t cid) {
+  WRITE_LOCKER(locker, _registryLock);
+
+  if (materialization->cid == cid) {
+    return;
+  }
+  if (materialization->cid == 0) {
+    ++_numberOfViews;
+  } else {
+    auto range = _registry.equal_range(materialization->cid);
+    for (auto it = range.first; it != range.second; ++it) {
+      if ((*it).second == materialization) {
+        _registry.erase(it);
+        break;
+      }
+    }
+  }
+  materialization->cid = cid;
+  _registry.emplace(cid, materialization);
+}
+
+void AggregateView::unregisterMaterialization(
+    std::shared_ptr<Materialization> const& materialization) {
+  WRITE_LOCKER(locker, _registryLock);
+
+  if (materialization->cid == 0) {
+    return;
+  }
+  auto range = _registry.equal_range(materialization->cid);
+  for (auto it = range.first; it != range.second; ++it) {
+    if ((*it).second == materialization) {
+      _registry.erase(it);
+      --_numberOfViews;
+      break;
+    }
+  }
+  materialization->cid = 0;
+}
+
+arangodb::Result AggregateView::updateProperties(
+    arangodb::velocypack::Slice const& slice, bool partialUpdate, bool doSync) {
+  MUTEX_LOCKER(locker, _lock);
+
+  VPackBuilder merged;
+  if (partialUpdate) {
+    VPackBuilder current;
+    current.openObject();
+    _materialization->definition.toVelocyPack(current);
+    current.close();
+    merged = VPackCollection::merge(current.slice(), slice, false);
+  } else {
+    merged.add(slice);
+  }
+
+  AggregateDefinition definition;
+  Result res = AggregateDefinition::fromVelocyPack(merged.slice(), definition);
+  if (res.fail()) {
+    return res;
+  }
+
+  // the new state is built on the next read
+  unregisterMaterialization(_materialization);
+  _materialization = std::make_shared<Materialization>(definition);
+  return {};
+}
+
+void AggregateView::getPropertiesVPack(velocypack::Builder& builder) const {
+  MUTEX_LOCKER(locker, _lock);
+  _materialization->definition.toVelocyPack(builder);
+}
+
+arangodb::Result AggregateView::getResultVPack(velocypack::Builder& builder) {
+  std::shared_ptr<Materialization> materialization;
+  {
+    MUTEX_LOCKER(locker, _lock);
+    materialization = _materialization;
+  }
+
+  {
+    READ_LOCKER(locker, materialization->lock);
+    if (materialization->valid) {
+      materialization->state->toVelocyPack(builder);
+      return {};
+    }
+  }
+
+  Result res = rebuild(materialization);
+  if (res.fail()) {
+    return res;
+  }
+
+  READ_LOCKER(locker, materialization->lock);
+  materialization->state->toVelocyPack(builder);
+  return {};
+}
+
+arangodb::Result AggregateView::rebuild(
+    std::shared_ptr<Materialization> const& materialization) {
+  MUTEX_LOCKER(rebuildLocker, materialization->rebuildLock);
+  {
+    READ_LOCKER(locker, materialization->lock);
+    if (materialization->valid) {
+      // another thread was faster
+      return {};
+    }
+  }
+
+  TRI_vocbase_t* vocbase = _logicalView->vocbase();
+  std::string const& name = materialization->definition.collection;
+  LogicalCollection* collection = vocbase->lookupCollection(name);
+  if (collection == nullptr) {
+    return {TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND,
+            "collection '" + name + "' of view '" + _logicalView->name() +
+                "' not found"};
+  }
+
+  // changes are tracked from now on, but only applied to a valid state
+  registerMaterialization(materialization, collection->cid());
+
+  // the exclusive lock waits for the running write transactions, which apply
+  // their changes while they hold their locks, and keeps new ones from
+  // writing until the new state is in place
+  SingleCollectionTransaction trx(
+      transaction::StandaloneContext::Create(vocbase), collection->cid(),
+      AccessMode::Type::EXCLUSIVE);
+  Result res = trx.begin();
+  if (res.fail()) {
+    return res;
+  }
+
+  auto state =
+      std::make_unique<AggregateViewState>(materialization->definition);
+  AggregateViewState::Contribution contribution;
+
+  ManagedDocumentResult mmdr;
+  std::unique_ptr<OperationCursor> cursor =
+      trx.indexScan(name, transaction::Methods::CursorType::ALL, &mmdr, 0,
+                    UINT64_MAX, 1000, false);
+  if (cursor->failed()) {
+    return {cursor->code};
+  }
+  cursor->allDocuments([&](DocumentIdentifierToken const&, VPackSlice doc) {
+    AggregateViewState::contribution(materialization->definition, doc,
+                                     contribution);
+    state->add(contribution);
+  });
+
+  {
+    WRITE_LOCKER(locker, materialization->lock);
+    materialization->state = std::move(state);
+    materialization->valid = true;
+  }
+
+  return trx.commit();
+}
+
+void AggregateView::open() {
+  // the state is not persisted, it is built on the first read
+}
+
+void AggregateView::drop() {
+  MUTEX_LOCKER(locker, _lock);
+  unregisterMaterialization(_materialization);
+}
+
+void AggregateViewChanges::track(TRI_voc_cid_t cid, VPackSlice oldDoc,
+                                 VPackSlice newDoc) {
+  std::vector<std::shared_ptr<AggregateView::Materialization>> views;
+  AggregateView::materializations(cid, views);
+
+  for (auto const& view : views) {
+    track(view, oldDoc, newDoc);
+  }
+}
+
+void AggregateViewChanges::track(
+    std::shared_ptr<AggregateView::Materialization> const& view,
+    VPackSlice oldDoc, VPackSlice newDoc) {
+  auto it = std::find_if(
+      _changes.begin(), _changes.end(),
+      [&view](decltype(_changes)::value_type const& changes) {
+        return changes.first == view;
+      });
+  if (it == _changes.end()) {
+    _changes.emplace_back(view, std::vector<Change>());
+    it = _changes.end() - 1;
+  }
+
+  Change change;
+  if (oldDoc.isObject()) {
+    change.hasRemoved = true;
+    AggregateViewState::contribution(view->definition, oldDoc, change.removed);
+  }
+  if (newDoc.isObject()) {
+    change.hasAdded = true;
+    AggregateViewState::contribution(view->definition, newDoc, change.added);
+  }
+  (*it).second.emplace_back(std::move(change));
+}
+
+void AggregateViewChanges::truncate(TRI_voc_cid_t cid) {
+  std::vector<std::shared_ptr<AggregateView::Materialization>> views;
+  AggregateView::materializations(cid, views);
+
+  for (auto const& view : views) {
+    auto it = std::find_if(
+        _changes.begin(), _changes.end(),
+        [&view](decltype(_changes)::value_type const& changes) {
+          return changes.first == view;
+        });
+    if (it == _changes.end()) {
+      _changes.emplace_back(view, std::vector<Change>());
+      it = _changes.end() - 1;
+    }
+
+    // the changes before the truncate do not matter anymore
+    (*it).second.clear();
+    Change change;
+    change.truncate = true;
+    (*it).second.emplace_back(std::move(change));
+  }
+}
+
+void AggregateViewChanges::apply() {
+  for (auto const& it : _changes) {
+    auto const& view = it.first;
+    WRITE_LOCKER(locker, view->lock);
+
+    if (!view->valid) {
+      // the state is rebuilt with a full scan on the next read
+      continue;
+    }
+
+    for (auto const& change : it.second) {
+      if (change.truncate) {
+        view->state->clear();
+        continue;
+      }
+      if (change.hasRemoved) {
+        view->state->remove(change.removed);
+      }
+      if (change.hasAdded) {
+        view->state->add(change.added);
+      }
+    }
+  }
+  _changes.clear();
+}
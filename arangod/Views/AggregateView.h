@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_VIEWS_AGGREGATE_VIEW_H
+#define ARANGOD_VIEWS_AGGREGATE_VIEW_H 1
+
+#include "Basics/Common.h"
+#include "Basics/Mutex.h"
+#include "Basics/ReadWriteLock.h"
+#include "Views/AggregateViewState.h"
+#include "VocBase/ViewImplementation.h"
+#include "VocBase/voc-types.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/Slice.h>
+
+#include <atomic>
+
+namespace arangodb {
+class Result;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief view holding the result of a grouped aggregation over a collection
+/// (see AggregateDefinition). the result is built with a full scan on the
+/// first read and then maintained from the document changes of the write
+/// transactions on the collection, which are applied when the transactions
+/// commit. reading the view therefore does not scan the collection again.
+////////////////////////////////////////////////////////////////////////////////
+
+class AggregateView final : public ViewImplementation {
+ public:
+  /// @brief the state of a view and its lock. transactions with buffered
+  /// changes hold on to it, so it may outlive the view
+  struct Materialization {
+    explicit Materialization(AggregateDefinition const& definition)
+        : definition(definition),
+          state(new AggregateViewState(definition)),
+          cid(0),
+          valid(false) {}
+
+    AggregateDefinition const definition;
+    /// @brief protects state and valid
+    basics::ReadWriteLock lock;
+    std::unique_ptr<AggregateViewState> state;
+    /// @brief collection the view is registered for, 0 if it is not
+    TRI_voc_cid_t cid;
+    /// @brief whether state reflects the collection. changes are not
+    /// applied to an invalid state, it is rebuilt on the next read
+    bool valid;
+    /// @brief serializes rebuilds
+    Mutex rebuildLock;
+  };
+
+  static std::string type;
+  static std::unique_ptr<ViewImplementation> creator(
+      LogicalView*, arangodb::velocypack::Slice const& info, bool isNew);
+
+  /// @brief whether any aggregate view is registered. checked for every
+  /// document written, so that transactions look up views only if needed
+  static bool hasViews() {
+    return _numberOfViews.load(std::memory_order_relaxed) > 0;
+  }
+
+  /// @brief the views registered for a collection
+  static void materializations(
+      TRI_voc_cid_t cid,
+      std::vector<std::shared_ptr<Materialization>>& result);
+
+ private:
+  // we require it in the constructor of AggregateView so we can ensure any
+  // constructor calls are coming from the AggregateView's creator method
+  struct ConstructionGuard {};
+
+ public:
+  AggregateView(ConstructionGuard const&, LogicalView* logical,
+                arangodb::velocypack::Slice const& info, bool isNew);
+  ~AggregateView();
+
+  arangodb::Result updateProperties(arangodb::velocypack::Slice const& slice,
+                                    bool partialUpdate, bool doSync) override;
+
+  /// @brief export properties
+  void getPropertiesVPack(velocypack::Builder&) const override;
+
+  /// @brief export the groups and their aggregated values
+  arangodb::Result getResultVPack(velocypack::Builder&) override;
+
+  /// @brief opens an existing view
+  void open() override;
+
+  void drop() override;
+
+ private:
+  /// @brief registers the view for its collection and builds its state with
+  /// a full scan
+  arangodb::Result rebuild(std::shared_ptr<Materialization> const&);
+
+  static void registerMaterialization(
+      std::shared_ptr<Materialization> const&, TRI_voc_cid_t cid);
+
+  static void unregisterMaterialization(
+      std::shared_ptr<Materialization> const&);
+
+ private:
+  /// @brief protects _materialization
+  mutable Mutex _lock;
+  std::shared_ptr<Materialization> _materialization;
+
+  static basics::ReadWriteLock _registryLock;
+  static std::unordered_multimap<TRI_voc_cid_t,
+                                 std::shared_ptr<Materialization>>
+      _registry;
+  static std::atomic<size_t> _numberOfViews;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief document changes of a transaction for the aggregate views on the
+/// collections it writes to. only the contributions of the documents are
+/// kept, and they are applied to the views whenever the transaction commits,
+/// including intermediate commits
+////////////////////////////////////////////////////////////////////////////////
+
+class AggregateViewChanges {
+ public:
+  /// @brief remembers a document change. oldDoc is none for inserts and
+  /// newDoc is none for removals
+  void track(TRI_voc_cid_t cid, arangodb::velocypack::Slice oldDoc,
+             arangodb::velocypack::Slice newDoc);
+
+  /// @brief remembers a document change for a single view
+  void track(std::shared_ptr<AggregateView::Materialization> const& view,
+             arangodb::velocypack::Slice oldDoc,
+             arangodb::velocypack::Slice newDoc);
+
+  /// @brief remembers that the collection was truncated
+  void truncate(TRI_voc_cid_t cid);
+
+  /// @brief applies the changes to the views and forgets them, so that the
+  /// changes of an intermediate commit are not applied again later
+  void apply();
+
+ private:
+  struct Change {
+    bool truncate = false;
+    bool hasRemoved = false;
+    bool hasAdded = false;
+    AggregateViewState::Contribution removed;
+    AggregateViewState::Contribution added;
+  };
+
+  /// @brief changes per view, in the order of the operations
+  std::vector<std::pair<std::shared_ptr<AggregateView::Materialization>,
+                        std::vector<Change>>>
+      _changes;
+};
+}  // namespace arangodb
+
+#endif
@@ -0,0 +1,328 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Views/AggregateViewState.h"
+#include "Basics/Exceptions.h"
+
+#include <velocypack/Iterator.h>
+#include <velocypack/velocypack-aliases.h>
+
+#include <cmath>
+
+using namespace arangodb;
+
+static bool FunctionFromString(std::string const& name,
+                               AggregateDefinition::Function& result) {
+  if (name == "COUNT" || name == "LENGTH") {
+    result = AggregateDefinition::Function::COUNT;
+  } else if (name == "SUM") {
+    result = AggregateDefinition::Function::SUM;
+  } else if (name == "MIN") {
+    result = AggregateDefinition::Function::MIN;
+  } else if (name == "MAX") {
+    result = AggregateDefinition::Function::MAX;
+  } else if (name == "AVERAGE" || name == "AVG") {
+    result = AggregateDefinition::Function::AVERAGE;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static char const* FunctionToString(AggregateDefinition::Function function) {
+  switch (function) {
+    case AggregateDefinition::Function::COUNT:
+      return "COUNT";
+    case AggregateDefinition::Function::SUM:
+      return "SUM";
+    case AggregateDefinition::Function::MIN:
+      return "MIN";
+    case AggregateDefinition::Function::MAX:
+      return "MAX";
+    case AggregateDefinition::Function::AVERAGE:
+      return "AVERAGE";
+  }
+  return "COUNT";
+}
+
+Result AggregateDefinition::fromVelocyPack(VPackSlice slice,
+                                           AggregateDefinition& result) {
+  if (!slice.isObject()) {
+    return {TRI_ERROR_BAD_PARAMETER, "expecting view properties object"};
+  }
+
+  VPackSlice collection = slice.get("collection");
+  if (!collection.isString() || collection.getStringLength() == 0) {
+    return {TRI_ERROR_BAD_PARAMETER,
+            "expecting <collection> to be specified as string"};
+  }
+  result.collection = collection.copyString();
+
+  result.groupBy.clear();
+  VPackSlice groupBy = slice.get("groupBy");
+  if (!groupBy.isNone()) {
+    if (!groupBy.isArray()) {
+      return {TRI_ERROR_BAD_PARAMETER,
+              "expecting <groupBy> to be an array of attribute names"};
+    }
+    for (auto const& attribute : VPackArrayIterator(groupBy)) {
+      if (!attribute.isString() || attribute.getStringLength() == 0) {
+        return {TRI_ERROR_BAD_PARAMETER,
+                "expecting <groupBy> to be an array of attribute names"};
+      }
+      result.groupBy.emplace_back(attribute.copyString());
+    }
+  }
+
+  result.aggregates.clear();
+  VPackSlice aggregates = slice.get("aggregates");
+  if (!aggregates.isObject() || aggregates.length() == 0) {
+    return {TRI_ERROR_BAD_PARAMETER,
+            "expecting <aggregates> to be a non-empty object"};
+  }
+  for (auto const& it : VPackObjectIterator(aggregates)) {
+    Aggregate aggregate;
+    aggregate.name = it.key.copyString();
+
+    VPackSlice function = it.value.get("function");
+    if (!function.isString() ||
+        !FunctionFromString(function.copyString(), aggregate.function)) {
+      return {TRI_ERROR_BAD_PARAMETER,
+              "expecting <function> of aggregate '" + aggregate.name +
+                  "' to be one of COUNT, SUM, MIN, MAX, AVERAGE"};
+    }
+
+    VPackSlice attribute = it.value.get("attribute");
+    if (attribute.isString()) {
+      aggregate.attribute = attribute.copyString();
+    }
+    if (aggregate.attribute.empty() && aggregate.function != Function::COUNT) {
+      return {TRI_ERROR_BAD_PARAMETER,
+              "expecting <attribute> of aggregate '" + aggregate.name +
+                  "' to be specified as string"};
+    }
+
+    result.aggregates.emplace_back(std::move(aggregate));
+  }
+
+  return {};
+}
+
+void AggregateDefinition::toVelocyPack(VPackBuilder& builder) const {
+  TRI_ASSERT(builder.isOpenObject());
+  builder.add("collection", VPackValue(collection));
+
+  builder.add("groupBy", VPackValue(VPackValueType::Array));
+  for (auto const& attribute : groupBy) {
+    builder.add(VPackValue(attribute));
+  }
+  builder.close();
+
+  builder.add("aggregates", VPackValue(VPackValueType::Object));
+  for (auto const& aggregate : aggregates) {
+    builder.add(aggregate.name, VPackValue(VPackValueType::Object));
+    builder.add("function", VPackValue(FunctionToString(aggregate.function)));
+    if (!aggregate.attribute.empty()) {
+      builder.add("attribute", VPackValue(aggregate.attribute));
+    }
+    builder.close();
+  }
+  builder.close();
+}
+
+AggregateViewState::AggregateViewState(AggregateDefinition const& definition)
+    : _definition(definition) {}
+
+void AggregateViewState::Value::add(double number) {
+  // integral numbers within the range of int64_t are summed up exactly
+  if (number == std::trunc(number) && number >= -9223372036854775808.0 &&
+      number < 9223372036854775808.0) {
+    int64_t const value = static_cast<int64_t>(number);
+    if ((value >= 0 && integralSum <= INT64_MAX - value) ||
+        (value < 0 && integralSum >= INT64_MIN - value)) {
+      integralSum += value;
+      return;
+    }
+  }
+
+  // Neumaier summation, keeps the low-order bits lost by each addition
+  double const result = sum + number;
+  if (std::abs(sum) >= std::abs(number)) {
+    compensation += (sum - result) + number;
+  } else {
+    compensation += (number - result) + sum;
+  }
+  sum = result;
+}
+
+bool AggregateViewState::keepsValues(size_t index) const {
+  auto function = _definition.aggregates[index].function;
+  return (function == AggregateDefinition::Function::MIN ||
+          function == AggregateDefinition::Function::MAX);
+}
+
+void AggregateViewState::contribution(AggregateDefinition const& definition,
+                                      VPackSlice document,
+                                      Contribution& result) {
+  // numbers are stored as doubles, so that 1 and 1.0 end up in the same
+  // group like they do in COLLECT
+  VPackBuilder group;
+  group.openArray();
+  for (auto const& attribute : definition.groupBy) {
+    VPackSlice value = document.get(attribute);
+    if (value.isNone()) {
+      group.add(VPackValue(VPackValueType::Null));
+    } else if (value.isNumber()) {
+      group.add(VPackValue(value.getNumber<double>()));
+    } else {
+      group.add(value);
+    }
+  }
+  group.close();
+  result.group.assign(reinterpret_cast<char const*>(group.slice().begin()),
+                      group.slice().byteSize());
+
+  result.values.clear();
+  result.values.reserve(definition.aggregates.size());
+  for (auto const& aggregate : definition.aggregates) {
+    double number = std::nan("");
+    if (!aggregate.attribute.empty()) {
+      VPackSlice value = document.get(aggregate.attribute);
+      if (value.isNumber()) {
+        number = value.getNumber<double>();
+      }
+    }
+    result.values.emplace_back(number);
+  }
+}
+
+void AggregateViewState::add(Contribution const& contribution) {
+  TRI_ASSERT(contribution.values.size() == _definition.aggregates.size());
+
+  Group& group = _groups[contribution.group];
+  if (group.values.empty()) {
+    group.values.resize(_definition.aggregates.size());
+  }
+  ++group.count;
+
+  for (size_t i = 0; i < contribution.values.size(); ++i) {
+    double const number = contribution.values[i];
+    if (std::isnan(number)) {
+      continue;
+    }
+    Value& value = group.values[i];
+    value.add(number);
+    ++value.count;
+    if (keepsValues(i)) {
+      ++value.values[number];
+    }
+  }
+}
+
+void AggregateViewState::remove(Contribution const& contribution) {
+  TRI_ASSERT(contribution.values.size() == _definition.aggregates.size());
+
+  auto it = _groups.find(contribution.group);
+  if (it == _groups.end()) {
+    // the document was added before the state was built
+    return;
+  }
+
+  Group& group = (*it).second;
+  if (--group.count == 0) {
+    _groups.erase(it);
+    return;
+  }
+
+  for (size_t i = 0; i < contribution.values.size(); ++i) {
+    double const number = contribution.values[i];
+    if (std::isnan(number)) {
+      continue;
+    }
+    Value& value = group.values[i];
+    if (--value.count == 0) {
+      // drop whatever rounding error is left
+      value.integralSum = 0;
+      value.sum = 0.0;
+      value.compensation = 0.0;
+    } else {
+      value.add(-number);
+    }
+    if (keepsValues(i)) {
+      auto found = value.values.find(number);
+      if (found != value.values.end() && --(*found).second == 0) {
+        value.values.erase(found);
+      }
+    }
+  }
+}
+
+void AggregateViewState::toVelocyPack(VPackBuilder& builder) const {
+  builder.openArray();
+  for (auto const& it : _groups) {
+    Group const& group = it.second;
+    builder.openObject();
+
+    VPackArrayIterator values(VPackSlice(it.first.data()));
+    for (auto const& attribute : _definition.groupBy) {
+      builder.add(attribute, values.value());
+      values.next();
+    }
+
+    for (size_t i = 0; i < _definition.aggregates.size(); ++i) {
+      auto const& aggregate = _definition.aggregates[i];
+      Value const& value = group.values[i];
+
+      switch (aggregate.function) {
+        case AggregateDefinition::Function::COUNT:
+          builder.add(aggregate.name, VPackValue(group.count));
+          break;
+        case AggregateDefinition::Function::SUM:
+          builder.add(aggregate.name, VPackValue(value.total()));
+          break;
+        case AggregateDefinition::Function::MIN:
+        case AggregateDefinition::Function::MAX:
+          if (value.values.empty()) {
+            builder.add(aggregate.name, VPackValue(VPackValueType::Null));
+          } else if (aggregate.function ==
+                     AggregateDefinition::Function::MIN) {
+            builder.add(aggregate.name,
+                        VPackValue(value.values.begin()->first));
+          } else {
+            builder.add(aggregate.name,
+                        VPackValue(value.values.rbegin()->first));
+          }
+          break;
+        case AggregateDefinition::Function::AVERAGE:
+          if (value.count == 0) {
+            builder.add(aggregate.name, VPackValue(VPackValueType::Null));
+          } else {
+            double const average =
+                value.total() / static_cast<double>(value.count);
+            builder.add(aggregate.name, VPackValue(average));
+          }
+          break;
+      }
+    }
+
+    builder.close();
+  }
+  builder.close();
+}
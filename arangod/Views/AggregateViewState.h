@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_VIEWS_AGGREGATE_VIEW_STATE_H
+#define ARANGOD_VIEWS_AGGREGATE_VIEW_STATE_H 1
+
+#include "Basics/Common.h"
+#include "Basics/Result.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/Slice.h>
+
+namespace arangodb {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief definition of the aggregation an aggregate view maintains. it is
+/// the equivalent of
+///
+///   FOR doc IN <collection>
+///     COLLECT g1 = doc.<groupBy[0]>, ...
+///     AGGREGATE a1 = <function>(doc.<attribute>), ...
+///
+/// and is given in the view properties as
+///
+///   { "collection": "...", "groupBy": ["..."],
+///     "aggregates": { "a1": { "function": "SUM", "attribute": "..." } } }
+////////////////////////////////////////////////////////////////////////////////
+
+struct AggregateDefinition {
+  enum class Function { COUNT, SUM, MIN, MAX, AVERAGE };
+
+  struct Aggregate {
+    std::string name;
+    Function function;
+    std::string attribute;
+  };
+
+  std::string collection;
+  std::vector<std::string> groupBy;
+  std::vector<Aggregate> aggregates;
+
+  /// @brief parses the definition from view properties
+  static arangodb::Result fromVelocyPack(arangodb::velocypack::Slice slice,
+                                         AggregateDefinition& result);
+
+  /// @brief adds the definition's attributes to an open object
+  void toVelocyPack(arangodb::velocypack::Builder& builder) const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the groups and aggregated values of an aggregate view. documents
+/// are added and removed one by one, so the state can be maintained from the
+/// changes of write transactions instead of being recomputed.
+///
+/// only numbers are aggregated by SUM, MIN, MAX and AVERAGE, other values are
+/// ignored. MIN and MAX keep all values of their group so that removals can
+/// be applied, the other functions keep only sums and counts. integral values
+/// are summed up exactly, other values with a compensated summation, so that
+/// adding and removing the same documents does not make the sums drift
+////////////////////////////////////////////////////////////////////////////////
+
+class AggregateViewState {
+ public:
+  /// @brief what a single document contributes to the state
+  struct Contribution {
+    /// @brief vpack array of the document's group values, used as the key
+    /// of the group
+    std::string group;
+    /// @brief aggregated value per aggregate, NaN if the document does not
+    /// provide a number
+    std::vector<double> values;
+  };
+
+  explicit AggregateViewState(AggregateDefinition const& definition);
+
+  AggregateViewState(AggregateViewState const&) = delete;
+  AggregateViewState& operator=(AggregateViewState const&) = delete;
+
+ public:
+  /// @brief computes the contribution of a document
+  static void contribution(AggregateDefinition const& definition,
+                           arangodb::velocypack::Slice document,
+                           Contribution& result);
+
+  void add(Contribution const& contribution);
+
+  void remove(Contribution const& contribution);
+
+  void clear() { _groups.clear(); }
+
+  size_t numberOfGroups() const { return _groups.size(); }
+
+  /// @brief builds an array with one object per group, containing the group
+  /// attributes and the aggregated values
+  void toVelocyPack(arangodb::velocypack::Builder& builder) const;
+
+ private:
+  struct Value {
+    /// @brief exact sum of the integral values
+    int64_t integralSum = 0;
+    /// @brief sum of the other values and its running compensation
+    double sum = 0.0;
+    double compensation = 0.0;
+    uint64_t count = 0;
+    /// @brief all values with their number of occurrences, for MIN and MAX
+    std::map<double, uint64_t> values;
+
+    /// @brief adds a number to the sum, or subtracts it
+    void add(double number);
+
+    /// @brief the sum of all numbers added
+    double total() const {
+      return static_cast<double>(integralSum) + (sum + compensation);
+    }
+  };
+
+  struct Group {
+    uint64_t count = 0;
+    std::vector<Value> values;
+  };
+
+  /// @brief whether the values of an aggregate must be kept
+  bool keepsValues(size_t index) const;
+
+ private:
+  AggregateDefinition const _definition;
+  std::unordered_map<std::string, Group> _groups;
+};
+}
+
+#endif
@@ -0,0 +1,275 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "AttributeStatistics.h"
+#include "Basics/Exceptions.h"
+
+#include <velocypack/Iterator.h>
+#include <velocypack/ValueType.h>
+#include <velocypack/velocypack-aliases.h>
+
+#include <cmath>
+
+using namespace arangodb;
+
+constexpr uint32_t HyperLogLog::BucketBits;
+constexpr uint32_t HyperLogLog::NumBuckets;
+constexpr size_t AttributeStatistics::MaxAttributes;
+constexpr size_t AttributeStatistics::MaxCommonValues;
+constexpr size_t AttributeStatistics::MaxTrackedValues;
+
+HyperLogLog::HyperLogLog() { memset(_buckets, 0, sizeof(_buckets)); }
+
+void HyperLogLog::add(uint64_t hash) {
+  uint32_t const bucket = static_cast<uint32_t>(hash & (NumBuckets - 1));
+  uint64_t rest = hash >> BucketBits;
+
+  // position of the lowest set bit of the remaining hash
+  uint8_t rank = 1;
+  while ((rest & 1) == 0 && rank <= 64 - BucketBits) {
+    ++rank;
+    rest >>= 1;
+  }
+
+  if (rank > _buckets[bucket]) {
+    _buckets[bucket] = rank;
+  }
+}
+
+double HyperLogLog::estimate() const {
+  double const m = static_cast<double>(NumBuckets);
+  double sum = 0.0;
+  size_t zeros = 0;
+
+  for (uint32_t i = 0; i < NumBuckets; ++i) {
+    sum += std::ldexp(1.0, -static_cast<int>(_buckets[i]));
+    if (_buckets[i] == 0) {
+      ++zeros;
+    }
+  }
+
+  double const alpha = 0.7213 / (1.0 + 1.079 / m);
+  double estimate = alpha * m * m / sum;
+
+  if (estimate <= 2.5 * m && zeros > 0) {
+    // small range correction (linear counting)
+    estimate = m * std::log(m / static_cast<double>(zeros));
+  }
+  return estimate;
+}
+
+void HyperLogLog::restore(uint8_t const* data, size_t length) {
+  if (length == NumBuckets) {
+    memcpy(_buckets, data, NumBuckets);
+  }
+}
+
+AttributeStatistics::AttributeStatistics() : _samples(0), _documents(0) {}
+
+AttributeStatistics::AttributeStatistics(VPackSlice const& slice)
+    : AttributeStatistics() {
+  if (!slice.isObject()) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL,
+                                   "attribute statistics are not an object");
+  }
+
+  _samples = slice.get("samples").getNumber<uint64_t>();
+  _documents = slice.get("documents").getNumber<uint64_t>();
+
+  for (auto const& it : VPackObjectIterator(slice.get("attributes"))) {
+    Attribute& attribute = _attributes[it.key.copyString()];
+    attribute.present = it.value.get("present").getNumber<uint64_t>();
+
+    VPackSlice sketch = it.value.get("sketch");
+    if (sketch.isBinary()) {
+      VPackValueLength length;
+      uint8_t const* data = sketch.getBinary(length);
+      attribute.sketch.restore(data, static_cast<size_t>(length));
+    }
+
+    for (auto const& value : VPackArrayIterator(it.value.get("common"))) {
+      attribute.commonValues.emplace_back(value.at(0).getNumber<uint64_t>(),
+                                          value.at(1).getNumber<uint64_t>());
+    }
+  }
+}
+
+void AttributeStatistics::add(VPackSlice const& document) {
+  TRI_ASSERT(document.isObject());
+  ++_samples;
+
+  for (auto const& it : VPackObjectIterator(document, true)) {
+    if (it.value.isNull()) {
+      continue;
+    }
+
+    std::string name = it.key.copyString();
+    auto found = _attributes.find(name);
+    if (found == _attributes.end()) {
+      if (_attributes.size() >= MaxAttributes) {
+        continue;
+      }
+      found = _attributes.emplace(std::move(name), Attribute()).first;
+    }
+
+    Attribute& attribute = (*found).second;
+    uint64_t const hash = it.value.normalizedHash();
+    ++attribute.present;
+    attribute.sketch.add(hash);
+
+    auto counted = attribute.counts.find(hash);
+    if (counted != attribute.counts.end()) {
+      ++(*counted).second;
+    } else if (attribute.counts.size() < MaxTrackedValues) {
+      attribute.counts.emplace(hash, 1);
+    }
+  }
+}
+
+void AttributeStatistics::finish(uint64_t numberOfDocuments) {
+  _documents = numberOfDocuments;
+
+  for (auto& it : _attributes) {
+    Attribute& attribute = it.second;
+    attribute.commonValues.clear();
+
+    for (auto const& counted : attribute.counts) {
+      if (counted.second > 1) {
+        // values seen only once are not common
+        attribute.commonValues.emplace_back(counted);
+      }
+    }
+    std::sort(attribute.commonValues.begin(), attribute.commonValues.end(),
+              [](std::pair<uint64_t, uint64_t> const& lhs,
+                 std::pair<uint64_t, uint64_t> const& rhs) {
+                return lhs.second > rhs.second;
+              });
+    if (attribute.commonValues.size() > MaxCommonValues) {
+      attribute.commonValues.resize(MaxCommonValues);
+    }
+
+    attribute.counts.clear();
+  }
+}
+
+double AttributeStatistics::distinctValues(Attribute const& attribute) const {
+  double present = static_cast<double>(attribute.present);
+  double distinct = (std::min)(attribute.sketch.estimate(), present);
+
+  // the sketch has a standard error of about 6.5%, so the threshold leaves
+  // room for estimates well below the real number of distinct values
+  if (distinct >= 0.8 * present && _samples > 0) {
+    // almost all sampled values are distinct, so the attribute is probably
+    // (close to) unique and has more distinct values than the sample shows
+    distinct = present * static_cast<double>(_documents) /
+               static_cast<double>(_samples);
+  }
+  return (std::max)(1.0, distinct);
+}
+
+bool AttributeStatistics::equalitySelectivity(std::string const& name,
+                                              VPackSlice const& value,
+                                              double& result) const {
+  auto found = _attributes.find(name);
+  if (found == _attributes.end() || _samples == 0) {
+    return false;
+  }
+
+  Attribute const& attribute = (*found).second;
+  double const samples = static_cast<double>(_samples);
+  double const present = static_cast<double>(attribute.present);
+
+  if (value.isNull()) {
+    // null also matches documents without the attribute
+    result = (samples - present) / samples;
+  } else {
+    double const distinct = distinctValues(attribute);
+
+    if (value.isNone()) {
+      // value unknown: assume a uniform distribution
+      result = present / samples / distinct;
+    } else {
+      uint64_t const hash = value.normalizedHash();
+      double common = 0.0;
+      result = -1.0;
+
+      for (auto const& it : attribute.commonValues) {
+        if (it.first == hash) {
+          result = static_cast<double>(it.second) / samples;
+          break;
+        }
+        common += static_cast<double>(it.second);
+      }
+
+      if (result < 0.0) {
+        // not a common value: spread the remaining documents evenly over
+        // the remaining values
+        double const rest = (std::max)(0.0, present - common);
+        double const restDistinct = (std::max)(
+            1.0, distinct - static_cast<double>(attribute.commonValues.size()));
+        result = rest / samples / restDistinct;
+      }
+    }
+  }
+
+  if (_documents > 0) {
+    // at least a single document may always match
+    result = (std::max)(result, 1.0 / static_cast<double>(_documents));
+  }
+  result = (std::min)(1.0, result);
+  return true;
+}
+
+bool AttributeStatistics::distinctValues(std::string const& name,
+                                         double& result) const {
+  auto found = _attributes.find(name);
+  if (found == _attributes.end() || _samples == 0) {
+    return false;
+  }
+  result = distinctValues((*found).second);
+  return true;
+}
+
+void AttributeStatistics::toVelocyPack(VPackBuilder& builder) const {
+  builder.openObject();
+  builder.add("samples", VPackValue(_samples));
+  builder.add("documents", VPackValue(_documents));
+  builder.add("attributes", VPackValue(VPackValueType::Object));
+  for (auto const& it : _attributes) {
+    builder.add(it.first, VPackValue(VPackValueType::Object));
+    builder.add("present", VPackValue(it.second.present));
+    builder.add("sketch",
+                VPackValuePair(it.second.sketch.buckets(),
+                               HyperLogLog::NumBuckets,
+                               VPackValueType::Binary));
+    builder.add("common", VPackValue(VPackValueType::Array));
+    for (auto const& value : it.second.commonValues) {
+      builder.openArray();
+      builder.add(VPackValue(value.first));
+      builder.add(VPackValue(value.second));
+      builder.close();
+    }
+    builder.close();
+    builder.close();
+  }
+  builder.close();
+  builder.close();
+}
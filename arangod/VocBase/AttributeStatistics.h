@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_VOCBASE_ATTRIBUTE_STATISTICS_H
+#define ARANGOD_VOCBASE_ATTRIBUTE_STATISTICS_H 1
+
+#include "Basics/Common.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/Slice.h>
+
+namespace arangodb {
+
+/// @brief a HyperLogLog sketch estimating the number of distinct values
+/// that were added to it
+class HyperLogLog {
+ public:
+  static constexpr uint32_t BucketBits = 8;
+  static constexpr uint32_t NumBuckets = 1 << BucketBits;
+
+  HyperLogLog();
+
+  /// @brief add the hash of a value
+  void add(uint64_t hash);
+
+  /// @brief estimated number of distinct values added
+  double estimate() const;
+
+  uint8_t const* buckets() const { return _buckets; }
+
+  /// @brief restore the buckets from a serialized sketch. ignores input of
+  /// the wrong size
+  void restore(uint8_t const* data, size_t length);
+
+ private:
+  uint8_t _buckets[NumBuckets];
+};
+
+/// @brief per-attribute statistics of a collection, built from a sample of
+/// its documents. only top-level attributes are considered
+class AttributeStatistics {
+ public:
+  /// @brief maximum number of attributes for which statistics are kept
+  static constexpr size_t MaxAttributes = 64;
+
+  /// @brief maximum number of most common values kept per attribute
+  static constexpr size_t MaxCommonValues = 8;
+
+  /// @brief maximum number of distinct values counted per attribute while
+  /// sampling, in order to determine the most common values
+  static constexpr size_t MaxTrackedValues = 1024;
+
+  AttributeStatistics();
+
+  /// @brief restore statistics from VelocyPack
+  explicit AttributeStatistics(arangodb::velocypack::Slice const&);
+
+  AttributeStatistics(AttributeStatistics const&) = delete;
+  AttributeStatistics& operator=(AttributeStatistics const&) = delete;
+
+  /// @brief add a sampled document
+  void add(arangodb::velocypack::Slice const& document);
+
+  /// @brief finish sampling. <numberOfDocuments> is the number of documents
+  /// in the collection at the time of sampling
+  void finish(uint64_t numberOfDocuments);
+
+  /// @brief number of documents in the collection when it was sampled
+  uint64_t numberOfDocuments() const { return _documents; }
+
+  /// @brief number of sampled documents
+  uint64_t numberOfSamples() const { return _samples; }
+
+  /// @brief estimated fraction of documents for which <attribute> is equal
+  /// to <value>. if <value> is none, the value is considered to be unknown.
+  /// returns false if there are no statistics for the attribute
+  bool equalitySelectivity(std::string const& attribute,
+                           arangodb::velocypack::Slice const& value,
+                           double& result) const;
+
+  /// @brief estimated number of distinct values of <attribute> in the
+  /// collection. returns false if there are no statistics for the attribute
+  bool distinctValues(std::string const& attribute, double& result) const;
+
+  void toVelocyPack(arangodb::velocypack::Builder&) const;
+
+ private:
+  struct Attribute {
+    Attribute() : present(0) {}
+
+    /// @brief number of sampled documents with a non-null value
+    uint64_t present;
+
+    /// @brief sketch of the distinct values
+    HyperLogLog sketch;
+
+    /// @brief hashes of the most common values and their number of
+    /// occurrences in the sample, ordered by decreasing occurrences
+    std::vector<std::pair<uint64_t, uint64_t>> commonValues;
+
+    /// @brief occurrences in the sample per value hash. only used while
+    /// sampling
+    std::unordered_map<uint64_t, uint64_t> counts;
+  };
+
+  /// @brief estimated number of distinct values of an attribute
+  double distinctValues(Attribute const&) const;
+
+  std::unordered_map<std::string, Attribute> _attributes;
+
+  /// @brief number of sampled documents
+  uint64_t _samples;
+
+  /// @brief number of documents in the collection when it was sampled
+  uint64_t _documents;
+};
+
+}  // namespace arangodb
+
+#endif
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGOD_VOC_BASE_AUTH_CACHE_H
+#define ARANGOD_VOC_BASE_AUTH_CACHE_H 1
+
+#include "Basics/Common.h"
+#include "Basics/ReadLocker.h"
+#include "Basics/ReadWriteLock.h"
+#include "Basics/WriteLocker.h"
+#include "Basics/fasthash.h"
+
+#include <atomic>
+
+namespace arangodb {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cache of authentication results, keyed by the credentials the
+/// client sent (basic auth secret or JWT). the credentials are hashed to
+/// pick one of several shards, each with its own lock, and lookups only
+/// take the read lock of their shard, so threads checking different tokens
+/// do not contend and threads checking the same token only share a lock.
+///
+/// the cache has a generation that clear() increments. a result computed
+/// before a clear() must not be stored after it, because it may be based on
+/// user data that has changed meanwhile. callers therefore fetch the
+/// generation before they compute a result and pass it to put().
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+class AuthCache {
+ public:
+  static constexpr size_t NumberOfShards = 16;
+
+  /// @brief create a cache for up to maxSize entries in total
+  explicit AuthCache(size_t maxSize)
+      : _maxShardSize((std::max)(maxSize / NumberOfShards, size_t(1))),
+        _generation(0) {}
+
+  AuthCache(AuthCache const&) = delete;
+  AuthCache& operator=(AuthCache const&) = delete;
+
+ public:
+  uint64_t generation() const {
+    return _generation.load(std::memory_order_acquire);
+  }
+
+  /// @brief copies the cached result for key into result, returns false if
+  /// there is none
+  bool get(std::string const& key, T& result) const {
+    Shard const& shard = shardFor(key);
+    READ_LOCKER(locker, shard.lock);
+
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end()) {
+      return false;
+    }
+    result = it->second;
+    return true;
+  }
+
+  /// @brief stores the result for key, unless the cache was cleared since
+  /// generation was fetched. if the shard is full, an arbitrary entry is
+  /// evicted
+  void put(std::string const& key, T const& value, uint64_t generation) {
+    Shard& shard = shardFor(key);
+    WRITE_LOCKER(locker, shard.lock);
+
+    if (_generation.load(std::memory_order_acquire) != generation) {
+      return;
+    }
+
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end()) {
+      it->second = value;
+      return;
+    }
+
+    if (shard.entries.size() >= _maxShardSize) {
+      shard.entries.erase(shard.entries.begin());
+    }
+    shard.entries.emplace(key, value);
+  }
+
+  void remove(std::string const& key) {
+    Shard& shard = shardFor(key);
+    WRITE_LOCKER(locker, shard.lock);
+    shard.entries.erase(key);
+  }
+
+  /// @brief removes all entries and invalidates all generations fetched
+  /// before
+  void clear() {
+    for (auto& shard : _shards) {
+      shard.lock.writeLock();
+    }
+
+    _generation.fetch_add(1, std::memory_order_release);
+    for (auto& shard : _shards) {
+      shard.entries.clear();
+    }
+
+    for (auto& shard : _shards) {
+      shard.lock.unlock();
+    }
+  }
+
+ private:
+  struct Shard {
+    mutable basics::ReadWriteLock lock;
+    std::unordered_map<std::string, T> entries;
+  };
+
+  Shard& shardFor(std::string const& key) {
+    return _shards[fasthash64(key.data(), key.size(), 0xdeadbeef) %
+                   NumberOfShards];
+  }
+
+  Shard const& shardFor(std::string const& key) const {
+    return _shards[fasthash64(key.data(), key.size(), 0xdeadbeef) %
+                   NumberOfShards];
+  }
+
+ private:
+  size_t const _maxShardSize;
+  std::atomic<uint64_t> _generation;
+  Shard _shards[NumberOfShards];
+};
+}
+
+#endif
@@ -57,6 +57,7 @@ using namespace arangodb::rest;
 
 AuthInfo::AuthInfo(std::unique_ptr<AuthenticationHandler>&& handler)
     : _outdated(true),
+      _authBasicCache(16384),
       _authJwtCache(16384),
       _jwtSecret(""),
       _queryRegistry(nullptr),
@@ -67,13 +68,10 @@ AuthInfo::~AuthInfo() {
   {
     WRITE_LOCKER(readLocker, _authInfoLock);
     _authInfo.clear();
-    _authBasicCache.clear();
   }
 
-  {
-    WRITE_LOCKER(writeLocker, _authJwtLock);
-    _authJwtCache.clear();
-  }
+  _authBasicCache.clear();
+  _authJwtCache.clear();
 }
 
 void AuthInfo::setJwtSecret(std::string const& jwtSecret) {
@@ -774,14 +772,15 @@ AuthResult AuthInfo::checkAuthenticationBasic(std::string const& secret) {
     return AuthResult();
   }
 
-  {
-    READ_LOCKER(guard, _authInfoLock);
-    auto const& it = _authBasicCache.find(secret);
-    if (it != _authBasicCache.end()) {
-      return it->second;
-    }
+  AuthResult cached;
+  if (_authBasicCache.get(secret, cached)) {
+    return cached;
   }
 
+  // fetched before the users are read, so that the result is not cached
+  // if the users change while the password is checked
+  uint64_t const generation = _authBasicCache.generation();
+
   std::string const up = StringUtils::decodeBase64(secret);
   std::string::size_type n = up.find(':', 0);
   if (n == std::string::npos || n == 0 || n + 1 > up.size()) {
@@ -795,52 +794,34 @@ AuthResult AuthInfo::checkAuthenticationBasic(std::string const& secret) {
   std::string password = up.substr(n + 1);
 
   AuthResult result = checkPassword(username, password);
-  {
-    WRITE_LOCKER(guard, _authInfoLock);
 
-    if (result._authorized) {
-      if (!_authBasicCache.emplace(secret, result).second) {
-        // insertion did not work - probably another thread did insert the
-        // same data right now
-        // erase it and re-insert our version
-        _authBasicCache.erase(secret);
-        _authBasicCache.emplace(secret, result);
-      }
-    } else {
-      _authBasicCache.erase(secret);
-    }
+  if (result._authorized) {
+    _authBasicCache.put(secret, result, generation);
+  } else {
+    _authBasicCache.remove(secret);
   }
 
   return result;
 }
 
 AuthResult AuthInfo::checkAuthenticationJWT(std::string const& jwt) {
-  try {
-    // note that we need the write lock here because it is an LRU
-    // cache. reading from it will move the read entry to the start of
-    // the cache's linked list. so acquiring just a read-lock is
-    // insufficient!!
-    WRITE_LOCKER(writeLocker, _authJwtLock);
-    // intentionally copy the entry from the cache
-    AuthJwtResult result = _authJwtCache.get(jwt);
-
-    if (result._expires) {
-      std::chrono::system_clock::time_point now =
-          std::chrono::system_clock::now();
-
-      if (now >= result._expireTime) {
-        try {
-          _authJwtCache.remove(jwt);
-        } catch (std::range_error const&) {
-        }
-        return AuthResult();
-      }
+  AuthJwtResult cached;
+
+  // a token that was verified before is neither parsed nor verified again,
+  // only its expiry is checked
+  if (_authJwtCache.get(jwt, cached)) {
+    if (cached._expires &&
+        std::chrono::system_clock::now() >= cached._expireTime) {
+      _authJwtCache.remove(jwt);
+      return AuthResult();
     }
-    return (AuthResult)result;
-  } catch (std::range_error const&) {
-    // mop: not found
+    return (AuthResult)cached;
   }
 
+  // fetched before the signature is verified, so that the result is not
+  // cached if the secret changes meanwhile
+  uint64_t const generation = _authJwtCache.generation();
+
   std::vector<std::string> const parts = StringUtils::split(jwt, '.');
 
   if (parts.size() != 3) {
@@ -874,8 +855,7 @@ AuthResult AuthInfo::checkAuthenticationJWT(std::string const& jwt) {
     return AuthResult();
   }
 
-  WRITE_LOCKER(writeLocker, _authJwtLock);
-  _authJwtCache.put(jwt, result);
+  _authJwtCache.put(jwt, result, generation);
   return (AuthResult)result;
 }
 
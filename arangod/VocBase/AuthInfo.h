@@ -27,13 +27,13 @@
 #include "ApplicationFeatures/ApplicationFeature.h"
 #include "Aql/QueryRegistry.h"
 #include "Basics/Common.h"
-#include "Basics/LruCache.h"
 #include "Basics/Mutex.h"
 #include "Basics/ReadWriteLock.h"
 #include "Basics/Result.h"
 #include "Rest/CommonDefines.h"
 #include "Utils/Authentication.h"
 #include "Utils/ExecContext.h"
+#include "VocBase/AuthCache.h"
 #include "VocBase/AuthUserEntry.h"
 
 #include <velocypack/Builder.h>
@@ -138,9 +138,8 @@ class AuthInfo {
   std::atomic<bool> _outdated;
 
   std::unordered_map<std::string, AuthUserEntry> _authInfo;
-  std::unordered_map<std::string, arangodb::AuthResult> _authBasicCache;
-  arangodb::basics::LruCache<std::string, arangodb::AuthJwtResult>
-      _authJwtCache;
+  AuthCache<arangodb::AuthResult> _authBasicCache;
+  AuthCache<arangodb::AuthJwtResult> _authJwtCache;
   std::string _jwtSecret;
   aql::QueryRegistry* _queryRegistry;
   std::unique_ptr<AuthenticationHandler> _authenticationHandler;
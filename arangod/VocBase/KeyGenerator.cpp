@@ -84,6 +84,10 @@ KeyGenerator::GeneratorType KeyGenerator::generatorType(
     return KeyGenerator::TYPE_AUTOINCREMENT;
   }
 
+  if (typeName == PaddedKeyGenerator::name()) {
+    return KeyGenerator::TYPE_PADDED;
+  }
+
   // error
   return KeyGenerator::TYPE_UNKNOWN;
 }
@@ -112,8 +116,18 @@ KeyGenerator* KeyGenerator::factory(VPackSlice const& options) {
         options, "allowUserKeys", allowUserKeys);
   }
 
-  if (type == TYPE_TRADITIONAL) {
-    return new TraditionalKeyGenerator(allowUserKeys);
+  if (type == TYPE_TRADITIONAL || type == TYPE_PADDED) {
+    bool reserveBlocks = false;
+
+    if (readOptions) {
+      reserveBlocks = arangodb::basics::VelocyPackHelper::getBooleanValue(
+          options, "reserveBlocks", reserveBlocks);
+    }
+
+    if (type == TYPE_PADDED) {
+      return new PaddedKeyGenerator(allowUserKeys, reserveBlocks);
+    }
+    return new TraditionalKeyGenerator(allowUserKeys, reserveBlocks);
   }
 
   else if (type == TYPE_AUTOINCREMENT) {
@@ -192,8 +206,104 @@ std::shared_ptr<VPackBuilder> KeyGenerator::toVelocyPack() const {
 }
 
 /// @brief create the key generator
-TraditionalKeyGenerator::TraditionalKeyGenerator(bool allowUserKeys)
-    : KeyGenerator(allowUserKeys), _lastValue(0) {}
+TickKeyGenerator::TickKeyGenerator(bool allowUserKeys, bool reserveBlocks)
+    : KeyGenerator(allowUserKeys),
+      _reserveBlocks(reserveBlocks),
+      _lastValue(0),
+      _lastTracked(0) {
+  if (_reserveBlocks) {
+    _blocks.reset(new Block[NumberOfBlocks]);
+  }
+}
+
+/// @brief destroy the key generator
+TickKeyGenerator::~TickKeyGenerator() {}
+
+/// @brief returns a tick greater than all tracked values
+uint64_t TickKeyGenerator::generateTick() {
+  if (_reserveBlocks) {
+    return generateTickFromBlock();
+  }
+
+  TRI_voc_tick_t const tick = TRI_NewTickServer();
+  uint64_t last = _lastValue.load(std::memory_order_relaxed);
+
+  while (true) {
+    uint64_t const next = (tick > last) ? tick : last + 1;
+
+    if (next == UINT64_MAX) {
+      // sanity check
+      return 0;
+    }
+    if (_lastValue.compare_exchange_weak(last, next,
+                                         std::memory_order_relaxed)) {
+      return next;
+    }
+  }
+}
+
+/// @brief returns the next tick of the calling thread's block, reserving a
+/// new block from the global tick counter if the block is used up
+uint64_t TickKeyGenerator::generateTickFromBlock() {
+  static std::atomic<size_t> nextThread(0);
+  // threads are assigned to the blocks round robin on their first call
+  static thread_local size_t const thread = nextThread.fetch_add(1);
+
+  Block& block = _blocks[thread % NumberOfBlocks];
+  MUTEX_LOCKER(mutexLocker, block.lock);
+
+  uint64_t const tracked = _lastTracked.load(std::memory_order_relaxed);
+
+  if (block.next == block.end || block.next <= tracked) {
+    // tracked user keys must not be generated again
+    TRI_UpdateTickServer(tracked);
+
+    uint64_t const first = TRI_NewTicksServer(BlockSize);
+
+    if (first >= UINT64_MAX - BlockSize) {
+      // sanity check
+      return 0;
+    }
+    block.next = first;
+    block.end = first + BlockSize;
+    updateMax(_lastValue, block.end - 1);
+  }
+
+  return block.next++;
+}
+
+/// @brief makes sure all ticks generated later are greater than value
+void TickKeyGenerator::trackValue(uint64_t value) {
+  updateMax(_lastValue, value);
+  if (_reserveBlocks) {
+    updateMax(_lastTracked, value);
+  }
+}
+
+void TickKeyGenerator::updateMax(std::atomic<uint64_t>& value,
+                                 uint64_t candidate) {
+  uint64_t current = value.load(std::memory_order_relaxed);
+
+  while (candidate > current &&
+         !value.compare_exchange_weak(current, candidate,
+                                      std::memory_order_relaxed)) {
+  }
+}
+
+/// @brief add the attributes common to all tick based generators
+void TickKeyGenerator::addToVelocyPack(VPackBuilder& builder) const {
+  builder.add("allowUserKeys", VPackValue(_allowUserKeys));
+  if (_reserveBlocks) {
+    builder.add("reserveBlocks", VPackValue(true));
+  }
+  builder.add("lastValue",
+              VPackValue(_lastValue.load(std::memory_order_relaxed)));
+}
+
+/// @brief create the key generator
+TraditionalKeyGenerator::TraditionalKeyGenerator(bool allowUserKeys,
+                                                 bool reserveBlocks)
+    : TickKeyGenerator(allowUserKeys, reserveBlocks) {}
 
 /// @brief destroy the key generator
 TraditionalKeyGenerator::~TraditionalKeyGenerator() {}
@@ -219,20 +329,9 @@ bool TraditionalKeyGenerator::validateKey(char const* key, size_t len) {
 
 /// @brief generate a key
 std::string TraditionalKeyGenerator::generate() {
-  TRI_voc_tick_t tick = TRI_NewTickServer();
-  
-  {
-    MUTEX_LOCKER(mutexLocker, _lock);
-
-    if (tick <= _lastValue) {
-      tick = ++_lastValue;
-    } else {
-      _lastValue = tick;
-    }
-  }
+  uint64_t const tick = generateTick();
 
-  if (tick == UINT64_MAX) {
-    // sanity check
+  if (tick == 0) {
     return "";
   }
   return arangodb::basics::StringUtils::itoa(tick);
@@ -259,23 +358,88 @@ void TraditionalKeyGenerator::track(char const* p, size_t length) {
   // check the numeric key part
   if (length > 0 && p[0] >= '0' && p[0] <= '9') {
     // potentially numeric key
-    uint64_t value = StringUtils::uint64(p, length);
+    trackValue(StringUtils::uint64(p, length));
+  }
+}
+
+/// @brief create a VPack representation of the generator
+void TraditionalKeyGenerator::toVelocyPack(VPackBuilder& builder) const {
+  TRI_ASSERT(!builder.isClosed());
+  builder.add("type", VPackValue(name()));
+  addToVelocyPack(builder);
+}
+
+/// @brief create the key generator
+PaddedKeyGenerator::PaddedKeyGenerator(bool allowUserKeys, bool reserveBlocks)
+    : TickKeyGenerator(allowUserKeys, reserveBlocks) {}
+
+/// @brief destroy the key generator
+PaddedKeyGenerator::~PaddedKeyGenerator() {}
+
+/// @brief generate a key
+std::string PaddedKeyGenerator::generate() {
+  uint64_t tick = generateTick();
+
+  if (tick == 0) {
+    return "";
+  }
+
+  static char const digits[] = "0123456789abcdef";
+  std::string key(KeyLength, '0');
+
+  for (size_t i = KeyLength; i > 0; --i) {
+    key[i - 1] = digits[tick & 0xf];
+    tick >>= 4;
+  }
+  return key;
+}
+
+/// @brief validate a key
+int PaddedKeyGenerator::validate(char const* p, size_t length,
+                                 bool isRestore) {
+  int res = globalCheck(p, length, isRestore);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  // validate user-supplied key
+  if (!TraditionalKeyGenerator::validateKey(p, length)) {
+    return TRI_ERROR_ARANGO_DOCUMENT_KEY_BAD;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+/// @brief track usage of a key
+void PaddedKeyGenerator::track(char const* p, size_t length) {
+  // only keys that look like generated ones can collide with them
+  if (length != KeyLength) {
+    return;
+  }
+
+  uint64_t value = 0;
 
-    MUTEX_LOCKER(mutexLocker, _lock);
+  for (size_t i = 0; i < KeyLength; ++i) {
+    char const c = p[i];
 
-    if (value > _lastValue) {
-      // and update our last value
-      _lastValue = value;
+    if (c >= '0' && c <= '9') {
+      value = (value << 4) | static_cast<uint64_t>(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      value = (value << 4) | static_cast<uint64_t>(c - 'a' + 10);
+    } else {
+      return;
     }
   }
+
+  trackValue(value);
 }
 
 /// @brief create a VPack representation of the generator
-void TraditionalKeyGenerator::toVelocyPack(VPackBuilder& builder) const {
+void PaddedKeyGenerator::toVelocyPack(VPackBuilder& builder) const {
   TRI_ASSERT(!builder.isClosed());
   builder.add("type", VPackValue(name()));
-  builder.add("allowUserKeys", VPackValue(_allowUserKeys));
-  builder.add("lastValue", VPackValue(_lastValue));
+  addToVelocyPack(builder);
 }
 
 /// @brief create the generator
@@ -312,27 +476,26 @@ bool AutoIncrementKeyGenerator::validateKey(char const* key, size_t len) {
 /// @brief generate a key
 std::string AutoIncrementKeyGenerator::generate() {
   uint64_t keyValue;
+  uint64_t lastValue = _lastValue.load(std::memory_order_relaxed);
 
-  {
-    MUTEX_LOCKER(mutexLocker, _lock);
-
+  do {
     // user has not specified a key, generate one based on algorithm
-    if (_lastValue < _offset) {
+    if (lastValue < _offset) {
       keyValue = _offset;
     } else {
       keyValue =
-          _lastValue + _increment - ((_lastValue - _offset) % _increment);
+          lastValue + _increment - ((lastValue - _offset) % _increment);
     }
 
     // bounds and sanity checks
-    if (keyValue == UINT64_MAX || keyValue < _lastValue) {
+    if (keyValue == UINT64_MAX || keyValue < lastValue) {
       return "";
     }
 
-    TRI_ASSERT(keyValue > _lastValue);
-    // update our last value
-    _lastValue = keyValue;
-  }
+    TRI_ASSERT(keyValue > lastValue);
+    // update our last value, unless another thread did so meanwhile
+  } while (!_lastValue.compare_exchange_weak(lastValue, keyValue,
+                                             std::memory_order_relaxed));
 
   return arangodb::basics::StringUtils::itoa(keyValue);
 }
@@ -350,14 +513,7 @@ int AutoIncrementKeyGenerator::validate(char const* p, size_t length, bool isRes
     return TRI_ERROR_ARANGO_DOCUMENT_KEY_BAD;
   }
 
-  uint64_t intValue = arangodb::basics::StringUtils::uint64(p, length);
-    
-  MUTEX_LOCKER(mutexLocker, _lock);
-
-  if (intValue > _lastValue) {
-    // update our last value
-    _lastValue = intValue;
-  }
+  trackValue(arangodb::basics::StringUtils::uint64(p, length));
 
   return TRI_ERROR_NO_ERROR;
 }
@@ -366,14 +522,17 @@ int AutoIncrementKeyGenerator::validate(char const* p, size_t length, bool isRes
 void AutoIncrementKeyGenerator::track(char const* p, size_t length) {
   // check the numeric key part
   if (length > 0 && p[0] >= '0' && p[0] <= '9') {
-    uint64_t value = StringUtils::uint64(p, length);
-  
-    MUTEX_LOCKER(mutexLocker, _lock);
+    trackValue(StringUtils::uint64(p, length));
+  }
+}
 
-    if (value > _lastValue) {
-      // and update our last value
-      _lastValue = value;
-    }
+/// @brief raises _lastValue to value if it is lower
+void AutoIncrementKeyGenerator::trackValue(uint64_t value) {
+  uint64_t current = _lastValue.load(std::memory_order_relaxed);
+
+  while (value > current &&
+         !_lastValue.compare_exchange_weak(current, value,
+                                           std::memory_order_relaxed)) {
   }
 }
 
@@ -384,7 +543,8 @@ void AutoIncrementKeyGenerator::toVelocyPack(VPackBuilder& builder) const {
   builder.add("allowUserKeys", VPackValue(_allowUserKeys));
   builder.add("offset", VPackValue(_offset));
   builder.add("increment", VPackValue(_increment));
-  builder.add("lastValue", VPackValue(_lastValue));
+  builder.add("lastValue",
+              VPackValue(_lastValue.load(std::memory_order_relaxed)));
 }
 
 /// @brief validate a document id (collection name + / + document key)
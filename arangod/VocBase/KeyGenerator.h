@@ -29,6 +29,7 @@
 #include "VocBase/vocbase.h"
 
 #include <array>
+#include <atomic>
 
 /// @brief maximum length of a key in a collection
 #define TRI_VOC_KEY_MAX_LENGTH (254)
@@ -45,7 +46,8 @@ class KeyGenerator {
   enum GeneratorType {
     TYPE_UNKNOWN = 0,
     TYPE_TRADITIONAL = 1,
-    TYPE_AUTOINCREMENT = 2
+    TYPE_AUTOINCREMENT = 2,
+    TYPE_PADDED = 3
   };
 
  protected:
@@ -78,6 +80,10 @@ class KeyGenerator {
   /// @brief track usage of a key
   virtual void track(char const* p, size_t length) = 0;
 
+  /// @brief track a value as reported in the lastValue attribute of the
+  /// generator's VelocyPack representation
+  virtual void trackValue(uint64_t value) = 0;
+
   /// @brief return a VelocyPack representation of the generator
   std::shared_ptr<arangodb::velocypack::Builder> toVelocyPack() const;
 
@@ -95,10 +101,72 @@ class KeyGenerator {
   static std::array<bool, 256> LookupTable;
 };
 
-class TraditionalKeyGenerator final : public KeyGenerator {
+/// @brief base class of the generators whose keys are made from server ticks.
+/// by default every key takes a new tick from the global tick counter. with
+/// reserveBlocks, threads instead take ticks from blocks they reserve from
+/// the global counter, so that inserting threads do not contend on it. keys
+/// of one thread are then still ascending, but keys generated concurrently by
+/// different threads are not ordered by their generation time anymore
+class TickKeyGenerator : public KeyGenerator {
  public:
+  /// @brief number of ticks reserved at once
+  static constexpr uint64_t BlockSize = 256;
+
+  /// @brief number of blocks in use at the same time
+  static constexpr size_t NumberOfBlocks = 16;
+
+ protected:
   /// @brief create the generator
-  explicit TraditionalKeyGenerator(bool);
+  TickKeyGenerator(bool allowUserKeys, bool reserveBlocks);
+
+ public:
+  /// @brief destroy the generator
+  ~TickKeyGenerator();
+
+ public:
+  bool trackKeys() const override { return true; }
+
+  /// @brief makes sure all ticks generated later are greater than value
+  void trackValue(uint64_t value) override final;
+
+ protected:
+  /// @brief returns a tick greater than all tracked values, or 0 if the
+  /// ticks are exhausted
+  uint64_t generateTick();
+
+  /// @brief add the attributes common to all tick based generators
+  void addToVelocyPack(arangodb::velocypack::Builder&) const;
+
+ private:
+  uint64_t generateTickFromBlock();
+
+  static void updateMax(std::atomic<uint64_t>& value, uint64_t candidate);
+
+ private:
+  struct Block {
+    arangodb::Mutex lock;
+    uint64_t next = 0;
+    uint64_t end = 0;
+    // keep blocks used by different threads on different cache lines
+    char padding[64];
+  };
+
+  bool const _reserveBlocks;
+
+  /// @brief highest value generated, reserved or tracked
+  std::atomic<uint64_t> _lastValue;
+
+  /// @brief highest value tracked, only used with reserveBlocks
+  std::atomic<uint64_t> _lastTracked;
+
+  std::unique_ptr<Block[]> _blocks;
+};
+
+/// @brief generates the keys as decimal numbers
+class TraditionalKeyGenerator final : public TickKeyGenerator {
+ public:
+  /// @brief create the generator
+  TraditionalKeyGenerator(bool allowUserKeys, bool reserveBlocks);
 
   /// @brief destroy the generator
   ~TraditionalKeyGenerator();
@@ -108,9 +176,6 @@ class TraditionalKeyGenerator final : public KeyGenerator {
   static bool validateKey(char const* key, size_t len);
 
  public:
-  
-  bool trackKeys() const override { return true; }
-
   /// @brief generate a key
   std::string generate() override;
 
@@ -125,11 +190,38 @@ class TraditionalKeyGenerator final : public KeyGenerator {
 
   /// @brief build a VelocyPack representation of the generator in the builder
   virtual void toVelocyPack(arangodb::velocypack::Builder&) const override;
+};
 
- private:
-  arangodb::Mutex _lock;
+/// @brief generates the keys as hex numbers of fixed length, so that their
+/// lexicographical order is the order of the ticks. new documents are then
+/// appended at the end of the primary index, which is cheaper to insert into
+/// and to compact for RocksDB than keys spread over the whole index
+class PaddedKeyGenerator final : public TickKeyGenerator {
+ public:
+  /// @brief length of the generated keys
+  static constexpr size_t KeyLength = 16;
+
+  /// @brief create the generator
+  PaddedKeyGenerator(bool allowUserKeys, bool reserveBlocks);
+
+  /// @brief destroy the generator
+  ~PaddedKeyGenerator();
+
+ public:
+  /// @brief generate a key
+  std::string generate() override;
+
+  /// @brief validate a key
+  int validate(char const* p, size_t length, bool isRestore) override;
+
+  /// @brief track usage of a key
+  void track(char const* p, size_t length) override final;
 
-  uint64_t _lastValue;
+  /// @brief return the generator name (must be lowercase)
+  static std::string name() { return "padded"; }
+
+  /// @brief build a VelocyPack representation of the generator in the builder
+  virtual void toVelocyPack(arangodb::velocypack::Builder&) const override;
 };
 
 class AutoIncrementKeyGenerator final : public KeyGenerator {
@@ -160,13 +252,14 @@ class AutoIncrementKeyGenerator final : public KeyGenerator {
   /// @brief return the generator name (must be lowercase)
   static std::string name() { return "autoincrement"; }
 
+  /// @brief raises the last value assigned to value if it is lower
+  void trackValue(uint64_t value) override final;
+
   /// @brief build a VelocyPack representation of the generator in the builder
   virtual void toVelocyPack(arangodb::velocypack::Builder&) const override;
 
  private:
-  arangodb::Mutex _lock;
-
-  uint64_t _lastValue;  // last value assigned
+  std::atomic<uint64_t> _lastValue;  // last value assigned
 
   uint64_t _offset;  // start value
 
@@ -161,6 +161,7 @@ LogicalCollection::LogicalCollection(LogicalCollection const& other)
       _replicationFactor(other.replicationFactor()),
       _numberOfShards(other.numberOfShards()),
       _allowUserKeys(other.allowUserKeys()),
+      _shardBoundaries(other._shardBoundaries),
       _shardIds(new ShardMap()),  // Not needed
       _vocbase(other.vocbase()),
       _keyOptions(other._keyOptions),
@@ -328,6 +329,38 @@ LogicalCollection::LogicalCollection(TRI_vocbase_t* vocbase,
                                    "invalid number of shard keys");
   }
 
+  VPackSlice boundariesSlice = info.get("shardBoundaries");
+  if (!boundariesSlice.isNone() && !boundariesSlice.isNull()) {
+    // range sharding: the documents are distributed by comparing their
+    // only shard key with the sorted boundaries
+    if (!boundariesSlice.isArray()) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_BAD_PARAMETER,
+                                     "shardBoundaries must be an array");
+    }
+    if (_shardKeys.size() != 1 || _isSmart || isSatellite()) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(
+          TRI_ERROR_BAD_PARAMETER,
+          "shardBoundaries require exactly one shard key");
+    }
+    if (boundariesSlice.length() + 1 != _numberOfShards) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(
+          TRI_ERROR_BAD_PARAMETER,
+          "numberOfShards must be one more than the number of shardBoundaries");
+    }
+    VPackSlice previous;
+    for (auto const& boundary : VPackArrayIterator(boundariesSlice)) {
+      if (!previous.isNone() &&
+          basics::VelocyPackHelper::compare(previous, boundary, true) >= 0) {
+        THROW_ARANGO_EXCEPTION_MESSAGE(
+            TRI_ERROR_BAD_PARAMETER,
+            "shardBoundaries must be sorted and unique");
+      }
+      previous = boundary;
+    }
+    _shardBoundaries = std::make_shared<VPackBuilder>();
+    _shardBoundaries->add(boundariesSlice);
+  }
+
   auto shardsSlice = info.get("shards");
   if (shardsSlice.isObject()) {
     for (auto const& shardSlice : VPackObjectIterator(shardsSlice)) {
@@ -659,6 +692,10 @@ std::vector<std::string> const& LogicalCollection::shardKeys() const {
   return _shardKeys;
 }
 
+std::shared_ptr<VPackBuilder> LogicalCollection::shardBoundaries() const {
+  return _shardBoundaries;
+}
+
 std::shared_ptr<ShardMap> LogicalCollection::shardIds() const {
   // TODO make threadsafe update on the cache.
   return _shardIds;
@@ -902,6 +939,10 @@ void LogicalCollection::toVelocyPack(VPackBuilder& result, bool translateCids,
   }
   result.close();  // shardKeys
 
+  if (_shardBoundaries != nullptr) {
+    result.add("shardBoundaries", _shardBoundaries->slice());
+  }
+
   if (!_avoidServers.empty()) {
     result.add(VPackValue("avoidServers"));
     result.openArray();
@@ -1086,6 +1127,17 @@ Result LogicalCollection::insert(transaction::Methods* trx,
                                lock);
 }
 
+/// @brief inserts the documents of an array into a collection
+void LogicalCollection::insertMany(
+    transaction::Methods* trx, VPackSlice const documents,
+    OperationOptions& options, TRI_voc_tick_t& resultMarkerTick, bool lock,
+    std::function<void(Result const&, ManagedDocumentResult const&)> const&
+        callback) {
+  resultMarkerTick = 0;
+  getPhysical()->insertMany(trx, documents, options, resultMarkerTick, lock,
+                            callback);
+}
+
 /// @brief updates a document or edge in a collection
 Result LogicalCollection::update(transaction::Methods* trx,
                                  VPackSlice const newSlice,
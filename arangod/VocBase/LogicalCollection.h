@@ -26,6 +26,7 @@
 #define ARANGOD_VOCBASE_LOGICAL_COLLECTION_H 1
 
 #include "Basics/Common.h"
+#include "Basics/DistributedReadWriteLock.h"
 #include "Basics/ReadWriteLock.h"
 #include "Indexes/IndexIterator.h"
 #include "VocBase/voc-types.h"
@@ -36,6 +37,7 @@
 namespace arangodb {
 
 namespace velocypack {
+class Builder;
 class Slice;
 }
 
@@ -226,6 +228,10 @@ class LogicalCollection {
   bool allowUserKeys() const;
   virtual bool usesDefaultShardKeys() const;
   std::vector<std::string> const& shardKeys() const;
+  // the sorted upper bounds of all but the last shard of a range-sharded
+  // collection, nullptr if the collection is hash-sharded
+  std::shared_ptr<velocypack::Builder> shardBoundaries() const;
+  bool isRangeSharded() const { return _shardBoundaries != nullptr; }
   std::shared_ptr<ShardMap> shardIds() const;
   // return a filtered list of the collection's shards
   std::shared_ptr<ShardMap> shardIds(
@@ -298,6 +304,10 @@ class LogicalCollection {
   Result insert(transaction::Methods*, velocypack::Slice const,
                 ManagedDocumentResult& result, OperationOptions&,
                 TRI_voc_tick_t&, bool);
+  void insertMany(transaction::Methods*, velocypack::Slice const,
+                  OperationOptions&, TRI_voc_tick_t&, bool,
+                  std::function<void(Result const&,
+                                     ManagedDocumentResult const&)> const&);
   Result update(transaction::Methods*, velocypack::Slice const,
                 ManagedDocumentResult& result, OperationOptions&,
                 TRI_voc_tick_t&, bool, TRI_voc_rid_t& prevRev,
@@ -323,7 +333,7 @@ class LogicalCollection {
   ///        created and only on Sinlge/DBServer
   void persistPhysicalCollection();
 
-  basics::ReadWriteLock& lock() { return _lock; }
+  basics::DistributedReadWriteLock& lock() { return _lock; }
 
   /// @brief Defer a callback to be executed when the collection
   ///        can be dropped. The callback is supposed to drop
@@ -407,6 +417,9 @@ class LogicalCollection {
   size_t _numberOfShards;
   bool const _allowUserKeys;
   std::vector<std::string> _shardKeys;
+  // shard i holds the shard key values v with
+  // boundaries[i - 1] <= v < boundaries[i]
+  std::shared_ptr<velocypack::Builder> _shardBoundaries;
   // This is shared_ptr because it is thread-safe
   // A thread takes a copy of this, another one updates this
   // the first one still has a valid copy
@@ -421,7 +434,10 @@ class LogicalCollection {
 
   std::unique_ptr<PhysicalCollection> _physical;
 
-  mutable basics::ReadWriteLock _lock;  // lock protecting the status and name
+  // lock protecting the status and name. it is read-locked by every
+  // transaction using the collection, so the readers are spread over
+  // several cache lines
+  mutable basics::DistributedReadWriteLock _lock;
 
   mutable basics::ReadWriteLock _infoLock;  // lock protecting the info
 
@@ -244,10 +244,19 @@ static Result EnsureIndexLocal(arangodb::LogicalCollection* collection,
   TRI_ASSERT(collection != nullptr);
   READ_LOCKER(readLocker, collection->vocbase()->_inventoryLock);
 
+  // an index built in the background must not lock out writers, it locks
+  // the collection itself when the index is ready
+  bool const inBackground =
+      create &&
+      EngineSelectorFeature::ENGINE->supportsBackgroundIndexing() &&
+      basics::VelocyPackHelper::getBooleanValue(definition, "inBackground",
+                                                false);
+
   SingleCollectionTransaction trx(
       transaction::StandaloneContext::Create(collection->vocbase()),
       collection->cid(),
-      create ? AccessMode::Type::EXCLUSIVE : AccessMode::Type::READ);
+      (create && !inBackground) ? AccessMode::Type::EXCLUSIVE
+                                : AccessMode::Type::READ);
 
   Result res = trx.begin();
   if (!res.ok()) {
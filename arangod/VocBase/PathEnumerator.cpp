@@ -62,7 +62,9 @@ bool DepthFirstEnumerator::next() {
   }
 
   while (true) {
-    if (_enumeratedPath.edges.size() < _opts->maxDepth) {
+    if (_enumeratedPath.edges.size() < _opts->maxDepth &&
+        !_traverser->isPrunedVertex(
+            StringRef(_enumeratedPath.vertices.back()))) {
       // We are not done with this path, so
       // we reserve the cursor for next depth
       auto cursor = _opts->nextCursor(
@@ -73,7 +75,7 @@ bool DepthFirstEnumerator::next() {
       }
     } else {
       if (!_enumeratedPath.edges.empty()) {
-        // This path is at the end. cut the last step
+        // This path is at the end or pruned. cut the last step
         _enumeratedPath.vertices.pop_back();
         _enumeratedPath.edges.pop_back();
       }
@@ -86,7 +88,8 @@ bool DepthFirstEnumerator::next() {
 
       if (_opts->hasEdgeFilter(_enumeratedPath.edges.size(), cursorId)) {
         VPackSlice e = edge;
-        if (edge.isString()) {
+        if (!_opts->edgeFilterCoveredBy(edge, _enumeratedPath.edges.size(),
+                                        cursorId)) {
           e = _opts->cache()->lookupToken(eid.get());
         }
         if (!_traverser->edgeMatchesConditions(
@@ -191,15 +194,19 @@ arangodb::aql::AqlValue DepthFirstEnumerator::pathToAqlValue(
   result.openObject();
   result.add(VPackValue("edges"));
   result.openArray();
-  for (auto const& it : _enumeratedPath.edges) {
-    TRI_ASSERT(it != nullptr);
-    _opts->cache()->insertIntoResult(it.get(), result);
+  if (_opts->producePathsEdges) {
+    for (auto const& it : _enumeratedPath.edges) {
+      TRI_ASSERT(it != nullptr);
+      _opts->cache()->insertIntoResult(it.get(), result);
+    }
   }
   result.close();
   result.add(VPackValue("vertices"));
   result.openArray();
-  for (auto const& it : _enumeratedPath.vertices) {
-    _traverser->addVertexToVelocyPack(StringRef(it), result);
+  if (_opts->producePathsVertices) {
+    for (auto const& it : _enumeratedPath.vertices) {
+      _traverser->addVertexToVelocyPack(StringRef(it), result);
+    }
   }
   result.close();
   result.close();
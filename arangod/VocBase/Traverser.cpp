@@ -85,15 +85,15 @@ bool Traverser::UniqueVertexGetter::getVertex(VPackSlice edge, std::vector<Strin
     TRI_ASSERT(toAdd.isString());
   }
   
-  StringRef toAddStr = _traverser->traverserCache()->persistString(StringRef(toAdd));
+  auto cache = _traverser->traverserCache();
+  size_t id = cache->persistStringId(StringRef(toAdd));
   // First check if we visited it. If not, then mark
-  if (_returnedVertices.find(toAddStr) != _returnedVertices.end()) {
+  if (!_returnedVertices.insert(id)) {
     // This vertex is not unique.
-    _traverser->traverserCache()->increaseFilterCounter();
+    cache->increaseFilterCounter();
     return false;
-  } else {
-    _returnedVertices.emplace(toAddStr);
   }
+  StringRef toAddStr = cache->persistedString(id);
 
   if (!_traverser->vertexMatchesConditions(toAdd, result.size())) {
     return false;
@@ -114,14 +114,14 @@ bool Traverser::UniqueVertexGetter::getSingleVertex(arangodb::velocypack::Slice
     TRI_ASSERT(resSlice.isString());
   }
   
-  result = _traverser->traverserCache()->persistString(StringRef(resSlice));
+  auto cache = _traverser->traverserCache();
+  size_t id = cache->persistStringId(StringRef(resSlice));
+  result = cache->persistedString(id);
   // First check if we visited it. If not, then mark
-  if (_returnedVertices.find(result) != _returnedVertices.end()) {
+  if (!_returnedVertices.insert(id)) {
     // This vertex is not unique.
-    _traverser->traverserCache()->increaseFilterCounter();
+    cache->increaseFilterCounter();
     return false;
-  } else {
-    _returnedVertices.emplace(result);
   }
   return _traverser->vertexMatchesConditions(resSlice, depth);
 }
@@ -129,7 +129,8 @@ bool Traverser::UniqueVertexGetter::getSingleVertex(arangodb::velocypack::Slice
 void Traverser::UniqueVertexGetter::reset(arangodb::StringRef const& startVertex) {
   _returnedVertices.clear();
   // The startVertex always counts as visited!
-  _returnedVertices.emplace(startVertex);
+  _returnedVertices.insert(
+      _traverser->traverserCache()->persistStringId(startVertex));
 }
 
 Traverser::Traverser(arangodb::traverser::TraverserOptions* opts,
@@ -175,6 +176,17 @@ bool arangodb::traverser::Traverser::vertexMatchesConditions(VPackSlice v, uint6
   return true;
 }
 
+bool arangodb::traverser::Traverser::isPrunedVertex(StringRef vid) {
+  if (!_opts->hasPrune()) {
+    return false;
+  }
+  // We always need to destroy this vertex
+  aql::AqlValue vertex = fetchVertexData(vid);
+  bool pruned = _opts->isPrunedVertex(vertex.slice());
+  vertex.destroy();
+  return pruned;
+}
+
 bool arangodb::traverser::Traverser::next() {
   TRI_ASSERT(!_done);
   bool res = _enumerator->next();
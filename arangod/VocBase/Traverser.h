@@ -33,6 +33,7 @@
 #include "Graph/AttributeWeightShortestPathFinder.h"
 #include "Graph/ConstantWeightShortestPathFinder.h"
 #include "Graph/ShortestPathFinder.h"
+#include "Graph/VertexIdSet.h"
 #include "Transaction/Helpers.h"
 #include "VocBase/PathEnumerator.h"
 #include "VocBase/voc-types.h"
@@ -171,7 +172,8 @@ class Traverser {
     void reset(arangodb::StringRef const&) override;
 
    private:
-    std::unordered_set<arangodb::StringRef> _returnedVertices;
+    /// @brief returned vertices, by the number the traverser cache assigned
+    graph::VertexIdSet _returnedVertices;
   };
 
 
@@ -287,6 +289,10 @@ class Traverser {
 
   bool vertexMatchesConditions(arangodb::velocypack::Slice, uint64_t);
 
+  /// @brief whether the edges of the vertex must not be followed, because
+  ///        it matches the prune option
+  bool isPrunedVertex(StringRef vid);
+
   void allowOptimizedNeighbors();
     
  protected:
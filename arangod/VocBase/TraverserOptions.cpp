@@ -48,7 +48,9 @@ TraverserOptions::TraverserOptions(transaction::Methods* trx)
       maxDepth(1),
       useBreadthFirst(false),
       uniqueVertices(UniquenessLevel::NONE),
-      uniqueEdges(UniquenessLevel::PATH) {}
+      uniqueEdges(UniquenessLevel::PATH),
+      producePathsVertices(true),
+      producePathsEdges(true) {}
 
 TraverserOptions::TraverserOptions(transaction::Methods* trx,
                                    VPackSlice const& obj)
@@ -59,7 +61,9 @@ TraverserOptions::TraverserOptions(transaction::Methods* trx,
       maxDepth(1),
       useBreadthFirst(false),
       uniqueVertices(UniquenessLevel::NONE),
-      uniqueEdges(UniquenessLevel::PATH) {
+      uniqueEdges(UniquenessLevel::PATH),
+      producePathsVertices(true),
+      producePathsEdges(true) {
   TRI_ASSERT(obj.isObject());
 
 #ifdef ARANGODB_ENABLE_MAINTAINER_MODE
@@ -98,6 +102,13 @@ TraverserOptions::TraverserOptions(transaction::Methods* trx,
   } else {
     uniqueEdges = TraverserOptions::UniquenessLevel::PATH;
   }
+
+  setPruneVertices(obj.get("prune"));
+
+  producePathsVertices =
+      VPackHelper::getBooleanValue(obj, "producePathsVertices", true);
+  producePathsEdges =
+      VPackHelper::getBooleanValue(obj, "producePathsEdges", true);
 }
 
 arangodb::traverser::TraverserOptions::TraverserOptions(
@@ -109,7 +120,9 @@ arangodb::traverser::TraverserOptions::TraverserOptions(
       maxDepth(1),
       useBreadthFirst(false),
       uniqueVertices(UniquenessLevel::NONE),
-      uniqueEdges(UniquenessLevel::PATH) {
+      uniqueEdges(UniquenessLevel::PATH),
+      producePathsVertices(true),
+      producePathsEdges(true) {
 #ifdef ARANGODB_ENABLE_MAINTAINER_MODE
   VPackSlice type = info.get("type");
   TRI_ASSERT(type.isString());
@@ -230,6 +243,8 @@ arangodb::traverser::TraverserOptions::TraverserOptions(
     }
     _baseVertexExpression = new aql::Expression(query->ast(), read);
   }
+
+  setPruneVertices(info.get("prune"));
   // Check for illegal option combination:
   TRI_ASSERT(uniqueEdges != TraverserOptions::UniquenessLevel::GLOBAL);
   TRI_ASSERT(uniqueVertices != TraverserOptions::UniquenessLevel::GLOBAL ||
@@ -245,7 +260,12 @@ arangodb::traverser::TraverserOptions::TraverserOptions(
       maxDepth(other.maxDepth),
       useBreadthFirst(other.useBreadthFirst),
       uniqueVertices(other.uniqueVertices),
-      uniqueEdges(other.uniqueEdges) {
+      uniqueEdges(other.uniqueEdges),
+      producePathsVertices(other.producePathsVertices),
+      producePathsEdges(other.producePathsEdges) {
+  if (other.hasPrune()) {
+    setPruneVertices(other._pruneVertices.slice());
+  }
   TRI_ASSERT(other._baseLookupInfos.empty());
   TRI_ASSERT(other._depthLookupInfo.empty());
   TRI_ASSERT(other._vertexExpressions.empty());
@@ -296,6 +316,13 @@ void TraverserOptions::toVelocyPack(VPackBuilder& builder) const {
       break;
   }
 
+  if (hasPrune()) {
+    builder.add("prune", _pruneVertices.slice());
+  }
+
+  builder.add("producePathsVertices", VPackValue(producePathsVertices));
+  builder.add("producePathsEdges", VPackValue(producePathsEdges));
+
   builder.add("type", VPackValue("traversal"));
 }
 
@@ -395,6 +422,10 @@ void TraverserOptions::buildEngineInfo(VPackBuilder& result) const {
     result.close();
   }
 
+  if (hasPrune()) {
+    result.add("prune", _pruneVertices.slice());
+  }
+
   result.close();
 }
 
@@ -434,6 +465,24 @@ bool TraverserOptions::hasEdgeFilter(int64_t depth, size_t cursorId) const {
   return expression != nullptr;
 }
 
+bool TraverserOptions::edgeFilterCoveredBy(VPackSlice edge, int64_t depth,
+                                           size_t cursorId) const {
+  if (edge.isString()) {
+    return false;
+  }
+  if (!isPartialEdge(edge)) {
+    return true;
+  }
+
+  auto specific = _depthLookupInfo.find(depth);
+  if (specific != _depthLookupInfo.end()) {
+    TRI_ASSERT(specific->second.size() > cursorId);
+    return specific->second[cursorId].expressionCoveredBy(edge, _tmpVar);
+  }
+  TRI_ASSERT(_baseLookupInfos.size() > cursorId);
+  return _baseLookupInfos[cursorId].expressionCoveredBy(edge, _tmpVar);
+}
+
 
 bool TraverserOptions::evaluateEdgeExpression(arangodb::velocypack::Slice edge,
                                               StringRef vertexId,
@@ -500,6 +549,41 @@ bool TraverserOptions::evaluateVertexExpression(
   return evaluateExpression(expression, vertex);
 }
 
+void TraverserOptions::setPruneVertices(VPackSlice prune) {
+  _pruneVertices.clear();
+  if (prune.isNone() || prune.isNull()) {
+    return;
+  }
+  if (!prune.isObject()) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(
+        TRI_ERROR_BAD_PARAMETER,
+        "prune: expecting an object of attribute values");
+  }
+  if (prune.length() > 0) {
+    _pruneVertices.add(prune);
+  }
+}
+
+bool TraverserOptions::isPrunedVertex(VPackSlice vertex) const {
+  if (!hasPrune()) {
+    return false;
+  }
+  if (vertex.isExternal()) {
+    vertex = vertex.resolveExternal();
+  }
+  if (!vertex.isObject()) {
+    return false;
+  }
+  for (auto const& it : VPackObjectIterator(_pruneVertices.slice())) {
+    VPackSlice value = vertex.get(it.key.copyString());
+    if (value.isNone() ||
+        VPackHelper::compare(value, it.value, false) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
 EdgeCursor* arangodb::traverser::TraverserOptions::nextCursor(
     ManagedDocumentResult* mmdr, StringRef vid, uint64_t depth) {
   if (_isCoordinator) {
@@ -31,6 +31,8 @@
 #include "StorageEngine/TransactionState.h"
 #include "Transaction/Methods.h"
 
+#include <velocypack/Builder.h>
+
 namespace arangodb {
 class ManagedDocumentResult;
 
@@ -69,6 +71,10 @@ struct TraverserOptions : public graph::BaseOptions {
 
   aql::Expression* _baseVertexExpression;
 
+  /// @brief attribute values of vertices that are returned but not expanded,
+  ///        an empty builder if nothing is pruned
+  arangodb::velocypack::Builder _pruneVertices;
+
   arangodb::traverser::ClusterTraverser* _traverser;
 
  public:
@@ -82,6 +88,13 @@ struct TraverserOptions : public graph::BaseOptions {
 
   UniquenessLevel uniqueEdges;
 
+  /// @brief whether the path output contains the vertices respectively the
+  ///        edges. the optimizer turns these off if the query does not read
+  ///        them, the skipped component is returned as an empty array
+  bool producePathsVertices;
+
+  bool producePathsEdges;
+
   explicit TraverserOptions(transaction::Methods* trx);
 
   TraverserOptions(transaction::Methods* trx, arangodb::velocypack::Slice const& definition);
@@ -113,12 +126,28 @@ struct TraverserOptions : public graph::BaseOptions {
   bool vertexHasFilter(uint64_t) const;
 
   bool hasEdgeFilter(int64_t, size_t) const;
+
+  /// @brief whether or not the edge filter can be evaluated on the edge as
+  /// handed out by the edge cursor, which is either the opposite vertex id,
+  /// the complete edge or a partial edge with the attributes stored inline
+  /// in the edge index. if not, the edge document must be looked up
+  bool edgeFilterCoveredBy(arangodb::velocypack::Slice edge, int64_t depth,
+                           size_t cursorId) const;
   
   bool evaluateEdgeExpression(arangodb::velocypack::Slice, StringRef vertexId,
                               uint64_t, size_t) const;
 
   bool evaluateVertexExpression(arangodb::velocypack::Slice, uint64_t) const;
 
+  /// @brief set the prune option, an object of attribute values
+  void setPruneVertices(arangodb::velocypack::Slice);
+
+  bool hasPrune() const { return !_pruneVertices.isEmpty(); }
+
+  /// @brief whether the traversal must not follow the edges of this vertex,
+  ///        i.e. it has all attribute values of the prune option
+  bool isPrunedVertex(arangodb::velocypack::Slice) const;
+
   graph::EdgeCursor* nextCursor(ManagedDocumentResult*, StringRef vid, uint64_t);
 
   void linkTraverser(arangodb::traverser::ClusterTraverser*);
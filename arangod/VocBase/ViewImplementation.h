@@ -25,6 +25,7 @@
 #define ARANGOD_VOCBASE_VIEW_IMPLEMENTATION_H 1
 
 #include "Basics/Common.h"
+#include "Basics/Result.h"
 #include "VocBase/voc-types.h"
 
 #include <velocypack/Builder.h>
@@ -58,6 +59,13 @@ class ViewImplementation {
   /// not close the Builder
   virtual void getPropertiesVPack(velocypack::Builder&) const = 0;
 
+  /// @brief called when the data held by a view is read. the implementation
+  /// adds a single value to the VelocyPack Builder passed into the method.
+  /// views that do not hold any data need not implement it
+  virtual arangodb::Result getResultVPack(velocypack::Builder&) {
+    return TRI_ERROR_NOT_IMPLEMENTED;
+  }
+
   /// @brief opens an existing view when the server is restarted
   virtual void open() = 0;
 
@@ -245,6 +245,18 @@ static int LoadConfiguration(TRI_vocbase_t* vocbase,
     config->_initialSyncMaxWaitTime = static_cast<uint64_t>(value.getNumber<double>() * 1000.0 * 1000.0);
   }
 
+  value = slice.get("initialSyncParallelism");
+
+  if (value.isNumber()) {
+    config->_initialSyncParallelism = value.getNumber<uint64_t>();
+  }
+
+  value = slice.get("applyParallelism");
+
+  if (value.isNumber()) {
+    config->_applyParallelism = value.getNumber<uint64_t>();
+  }
+
   value = slice.get("idleMinWaitTime");
 
   if (value.isNumber()) {
@@ -442,6 +454,8 @@ TRI_replication_applier_configuration_t::
       _idleMaxWaitTime(5 * 500 * 1000),
       _initialSyncMaxWaitTime(300 * 1000 * 1000),
       _autoResyncRetries(2),
+      _initialSyncParallelism(1),
+      _applyParallelism(1),
       _sslProtocol(0),
       _autoStart(false),
       _adaptivePolling(true),
@@ -500,6 +514,8 @@ void TRI_replication_applier_configuration_t::toVelocyPack(
   builder.add("adaptivePolling", VPackValue(_adaptivePolling));
   builder.add("autoResync", VPackValue(_autoResync));
   builder.add("autoResyncRetries", VPackValue(_autoResyncRetries));
+  builder.add("initialSyncParallelism", VPackValue(_initialSyncParallelism));
+  builder.add("applyParallelism", VPackValue(_applyParallelism));
   builder.add("includeSystem", VPackValue(_includeSystem));
   builder.add("requireFromPresent", VPackValue(_requireFromPresent));
   builder.add("verbose", VPackValue(_verbose));
@@ -805,6 +821,8 @@ void TRI_replication_applier_configuration_t::update(
   _idleMinWaitTime = src->_idleMinWaitTime;
   _idleMaxWaitTime = src->_idleMaxWaitTime;
   _autoResyncRetries = src->_autoResyncRetries;
+  _initialSyncParallelism = src->_initialSyncParallelism;
+  _applyParallelism = src->_applyParallelism;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -57,6 +57,8 @@ class TRI_replication_applier_configuration_t {
   uint64_t _idleMaxWaitTime;  // 5 * 500 * 1000
   uint64_t _initialSyncMaxWaitTime;
   uint64_t _autoResyncRetries;
+  uint64_t _initialSyncParallelism;  // collections dumped concurrently
+  uint64_t _applyParallelism;  // collections applied to concurrently
   uint32_t _sslProtocol;
   bool _autoStart;
   bool _adaptivePolling;
@@ -48,6 +48,12 @@ TRI_voc_tick_t TRI_HybridLogicalClock(TRI_voc_tick_t received) {
 /// @brief create a new tick
 TRI_voc_tick_t TRI_NewTickServer() { return ++CurrentTick; }
 
+/// @brief reserve count consecutive ticks, returns the first one
+TRI_voc_tick_t TRI_NewTicksServer(uint64_t count) {
+  TRI_ASSERT(count > 0);
+  return CurrentTick.fetch_add(count) + 1;
+}
+
 /// @brief updates the tick counter, with lock
 void TRI_UpdateTickServer(TRI_voc_tick_t tick) {
   TRI_voc_tick_t t = tick;
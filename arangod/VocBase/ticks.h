@@ -38,6 +38,9 @@ TRI_voc_tick_t TRI_HybridLogicalClock(TRI_voc_tick_t received);
 /// @brief create a new tick
 TRI_voc_tick_t TRI_NewTickServer();
 
+/// @brief reserve count consecutive ticks, returns the first one
+TRI_voc_tick_t TRI_NewTicksServer(uint64_t count);
+
 /// @brief updates the tick counter, with lock
 void TRI_UpdateTickServer(TRI_voc_tick_t);
 
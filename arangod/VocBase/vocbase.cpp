@@ -193,6 +193,8 @@ void TRI_vocbase_t::registerCollection(
 
     collection->setStatus(TRI_VOC_COL_STATUS_UNLOADED);
     TRI_ASSERT(_collectionsByName.size() == _collectionsById.size());
+
+    publishCollectionNames();
   }
 }
 
@@ -217,9 +219,29 @@ bool TRI_vocbase_t::unregisterCollection(
   // post-condition
   TRI_ASSERT(_collectionsByName.size() == _collectionsById.size());
 
+  publishCollectionNames();
+
   return true;
 }
 
+/// @brief rebuilds the snapshot of collection names and ids
+/// caller must hold _collectionsLock in write mode
+void TRI_vocbase_t::publishCollectionNames() {
+  auto names = std::make_shared<CollectionNames>();
+  names->byName.reserve(_collectionsByName.size());
+  names->byId.reserve(_collectionsByName.size());
+  names->namesById.reserve(_collectionsByName.size());
+
+  for (auto const& it : _collectionsByName) {
+    names->byName.emplace(it.first, it.second);
+    names->byId.emplace(it.second->cid(), it.second);
+    names->namesById.emplace(it.second->cid(), it.first);
+  }
+
+  std::atomic_store(&_collectionNames,
+                    std::shared_ptr<CollectionNames const>(std::move(names)));
+}
+
 /// @brief adds a new view
 /// caller must hold _viewLock in write mode or set doLock
 void TRI_vocbase_t::registerView(bool doLock,
@@ -723,6 +745,7 @@ void TRI_vocbase_t::shutdown() {
     WRITE_LOCKER(readLocker, _collectionsLock);
     _collectionsByName.clear();
     _collectionsById.clear();
+    publishCollectionNames();
   }
 
   // free dead collections (already dropped but pointers still around)
@@ -821,15 +844,15 @@ std::shared_ptr<VPackBuilder> TRI_vocbase_t::inventory(
 /// the name is fetched under a lock to make this thread-safe.
 /// returns empty string if the collection does not exist.
 std::string TRI_vocbase_t::collectionName(TRI_voc_cid_t id) {
-  READ_LOCKER(readLocker, _collectionsLock);
+  auto names = collectionNamesSnapshot();
 
-  auto it = _collectionsById.find(id);
+  auto it = names->namesById.find(id);
 
-  if (it == _collectionsById.end()) {
+  if (it == names->namesById.end()) {
     return StaticStrings::Empty;
   }
 
-  return (*it).second->name();
+  return (*it).second;
 }
 
 /// @brief looks up a collection by name
@@ -846,11 +869,11 @@ LogicalCollection* TRI_vocbase_t::lookupCollection(std::string const& name) {
   }
 
   // otherwise we'll look up the collection by name
-  READ_LOCKER(readLocker, _collectionsLock);
+  auto names = collectionNamesSnapshot();
 
-  auto it = _collectionsByName.find(name);
+  auto it = names->byName.find(name);
 
-  if (it == _collectionsByName.end()) {
+  if (it == names->byName.end()) {
     return nullptr;
   }
   return (*it).second;
@@ -887,11 +910,11 @@ LogicalCollection* TRI_vocbase_t::lookupCollectionNoLock(
 
 /// @brief looks up a collection by identifier
 LogicalCollection* TRI_vocbase_t::lookupCollection(TRI_voc_cid_t id) {
-  READ_LOCKER(readLocker, _collectionsLock);
+  auto names = collectionNamesSnapshot();
 
-  auto it = _collectionsById.find(id);
+  auto it = names->byId.find(id);
 
-  if (it == _collectionsById.end()) {
+  if (it == names->byId.end()) {
     return nullptr;
   }
   return (*it).second;
@@ -1179,6 +1202,8 @@ int TRI_vocbase_t::renameCollection(arangodb::LogicalCollection* collection,
   }
   TRI_ASSERT(_collectionsByName.size() == _collectionsById.size());
 
+  publishCollectionNames();
+
   locker.unlock();
   writeLocker.unlock();
 
@@ -1437,6 +1462,7 @@ TRI_vocbase_t::TRI_vocbase_t(TRI_vocbase_type_e type, TRI_voc_tick_t id,
       _refCount(0),
       _state(TRI_vocbase_t::State::NORMAL),
       _isOwnAppsDirectory(true),
+      _collectionNames(std::make_shared<CollectionNames const>()),
       _deadlockDetector(false),
       _userStructures(nullptr) {
   _queries.reset(new arangodb::aql::QueryList(this));
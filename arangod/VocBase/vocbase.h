@@ -27,6 +27,7 @@
 #include "Basics/Common.h"
 #include "Basics/ConditionVariable.h"
 #include "Basics/DeadlockDetector.h"
+#include "Basics/DistributedReadWriteLock.h"
 #include "Basics/Exceptions.h"
 #include "Basics/ReadWriteLock.h"
 #include "Basics/StringUtils.h"
@@ -136,6 +137,13 @@ struct TRI_vocbase_t {
     FAILED_VERSION = 3
   };
 
+  /// @brief immutable snapshot of the collections by name and by id
+  struct CollectionNames {
+    std::unordered_map<std::string, arangodb::LogicalCollection*> byName;
+    std::unordered_map<TRI_voc_cid_t, arangodb::LogicalCollection*> byId;
+    std::unordered_map<TRI_voc_cid_t, std::string> namesById;
+  };
+
   TRI_vocbase_t(TRI_vocbase_type_e type, TRI_voc_tick_t id,
                 std::string const& name);
   ~TRI_vocbase_t();
@@ -158,7 +166,9 @@ struct TRI_vocbase_t {
   State _state;
   bool _isOwnAppsDirectory;
 
-  arangodb::basics::ReadWriteLock _collectionsLock;  // collection iterator lock
+  // collection iterator lock, read-locked by useCollection() whenever a
+  // transaction starts
+  arangodb::basics::DistributedReadWriteLock _collectionsLock;
   std::vector<arangodb::LogicalCollection*>
       _collections;  // pointers to ALL collections
   std::vector<arangodb::LogicalCollection*>
@@ -171,6 +181,10 @@ struct TRI_vocbase_t {
   std::unordered_map<TRI_voc_cid_t, arangodb::LogicalCollection*>
       _collectionsById;  // collections by id
 
+  // copy of the two maps above that is replaced as a whole on every change
+  // of them, so lookups can read it without acquiring _collectionsLock
+  std::shared_ptr<CollectionNames const> _collectionNames;
+
   arangodb::basics::ReadWriteLock _viewsLock;  // views management lock
   std::unordered_map<std::string, std::shared_ptr<arangodb::LogicalView>>
       _viewsByName;  // views by name
@@ -273,6 +287,13 @@ struct TRI_vocbase_t {
   /// returns empty string if the collection does not exist.
   std::string collectionName(TRI_voc_cid_t id);
 
+  /// @brief returns the current snapshot of all collection names and ids.
+  /// it is replaced when a collection is created, dropped or renamed, a
+  /// snapshot once obtained never changes
+  std::shared_ptr<CollectionNames const> collectionNamesSnapshot() const {
+    return std::atomic_load(&_collectionNames);
+  }
+
   /// @brief looks up a collection by name
   arangodb::LogicalCollection* lookupCollection(std::string const& name);
   /// @brief looks up a collection by identifier
@@ -365,6 +386,10 @@ struct TRI_vocbase_t {
   /// This function is called when a collection is dropped.
   bool unregisterCollection(arangodb::LogicalCollection* collection);
 
+  /// @brief rebuilds the snapshot of collection names and ids from
+  /// _collectionsByName. caller must hold _collectionsLock in write mode
+  void publishCollectionNames();
+
   /// @brief creates a new collection, worker function
   arangodb::LogicalCollection* createCollectionWorker(
       arangodb::velocypack::Slice parameters);
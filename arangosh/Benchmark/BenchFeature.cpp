@@ -27,7 +27,10 @@
 #include <iostream>
 
 #include "ApplicationFeatures/ApplicationServer.h"
+#include "Basics/FileUtils.h"
 #include "Basics/StringUtils.h"
+#include "Basics/process-utils.h"
+#include "Basics/system-functions.h"
 #include "Benchmark/BenchmarkCounter.h"
 #include "Benchmark/BenchmarkOperation.h"
 #include "Benchmark/BenchmarkThread.h"
@@ -37,6 +40,12 @@
 #include "SimpleHttpClient/SimpleHttpClient.h"
 #include "SimpleHttpClient/SimpleHttpResult.h"
 
+#include <velocypack/Builder.h>
+#include <velocypack/Parser.h>
+#include <velocypack/velocypack-aliases.h>
+
+#include <sys/utsname.h>
+
 using namespace arangodb;
 using namespace arangodb::arangobench;
 using namespace arangodb::basics;
@@ -70,9 +79,15 @@ BenchFeature::BenchFeature(application_features::ApplicationServer* server,
       _quiet(false),
       _runs(1),
       _junitReportFile(""),
+      _jsonReportFile(""),
+      _baselineFile(""),
+      _maxRegression(10.0),
       _replicationFactor(1),
       _numberOfShards(1),
       _waitForSync(false),
+      _readRatio(80),
+      _zipfSkew(0.99),
+      _rate(0.0),
       _result(result) {
   requiresElevatedPrivileges(false);
   setOptional(false);
@@ -92,6 +107,12 @@ void BenchFeature::collectOptions(std::shared_ptr<ProgramOptions> options) {
   options->addOption("--requests", "total number of operations",
                      new UInt64Parameter(&_operations));
 
+  options->addOption("--rate",
+                     "target number of operations per second of all threads "
+                     "together. 0 means each thread sends its next request as "
+                     "soon as it has the previous response",
+                     new DoubleParameter(&_rate));
+
   options->addOption("--batch-size",
                      "number of operations in one batch (0 disables batching)",
                      new UInt64Parameter(&_batchSize));
@@ -132,7 +153,12 @@ void BenchFeature::collectOptions(std::shared_ptr<ProgramOptions> options) {
                                            "multitrx",
                                            "multi-collection",
                                            "aqlinsert",
-                                           "aqlv8"};
+                                           "aqlv8",
+                                           "aqltraversal",
+                                           "aqljoin",
+                                           "aqlcollect",
+                                           "aqlpaging",
+                                           "mixed-read-write"};
 
   options->addOption(
       "--test-case", "test case to use",
@@ -141,6 +167,16 @@ void BenchFeature::collectOptions(std::shared_ptr<ProgramOptions> options) {
   options->addOption("--complexity", "complexity parameter for the test",
                      new UInt64Parameter(&_complexity));
 
+  options->addOption(
+      "--read-ratio",
+      "percentage of read operations in the mixed-read-write test case",
+      new UInt64Parameter(&_readRatio));
+
+  options->addOption("--zipf-skew",
+                     "skew of the Zipf distribution of the documents accessed "
+                     "by the aql and mixed-read-write test cases (0 = uniform)",
+                     new DoubleParameter(&_zipfSkew));
+
   options->addOption("--delay",
                      "use a startup delay (necessary only when run in series)",
                      new BooleanParameter(&_delay));
@@ -149,6 +185,21 @@ void BenchFeature::collectOptions(std::shared_ptr<ProgramOptions> options) {
                      "filename to write junit style report to",
                      new StringParameter(&_junitReportFile));
 
+  options->addOption("--json-report-file",
+                     "filename to write a JSON report with all results and "
+                     "latency percentiles to",
+                     new StringParameter(&_jsonReportFile));
+
+  options->addOption("--baseline-file",
+                     "JSON report of an earlier run to compare the results "
+                     "with, fails if the throughput dropped too much",
+                     new StringParameter(&_baselineFile));
+
+  options->addOption("--max-regression",
+                     "percentage by which the operations per second may drop "
+                     "below the ones of the --baseline-file",
+                     new DoubleParameter(&_maxRegression));
+
   options->addOption(
       "--runs", "run test n times (and calculate statistics based on median)",
       new UInt64Parameter(&_runs));
@@ -188,6 +239,21 @@ void BenchFeature::start() {
   *_result = ret;
   ARANGOBENCH = this;
 
+  if (_rate < 0.0) {
+    LOG_TOPIC(FATAL, arangodb::Logger::FIXME) << "invalid value for --rate";
+    FATAL_ERROR_EXIT();
+  }
+
+  if (_maxRegression < 0.0) {
+    LOG_TOPIC(FATAL, arangodb::Logger::FIXME) << "invalid value for --max-regression";
+    FATAL_ERROR_EXIT();
+  }
+
+  if (_readRatio > 100) {
+    LOG_TOPIC(FATAL, arangodb::Logger::FIXME) << "invalid value for --read-ratio, expecting a percentage";
+    FATAL_ERROR_EXIT();
+  }
+
   std::unique_ptr<BenchmarkOperation> benchmark(GetTestCase(_testCase));
 
   if (benchmark == nullptr) {
@@ -211,6 +277,9 @@ void BenchFeature::start() {
   // speed
   realStep += 10000;
 
+  // with a target rate, every thread sends at a fixed rate of its own
+  double const interval = _rate > 0.0 ? _concurreny / _rate : 0.0;
+
   std::vector<BenchmarkThread*> threads;
 
   bool ok = true;
@@ -226,8 +295,10 @@ void BenchFeature::start() {
       BenchmarkThread* thread = new BenchmarkThread(
           benchmark.get(), &startCondition, &BenchFeature::updateStartCounter,
           static_cast<int>(i), (unsigned long)_batchSize, &operationsCounter,
-          client, _keepAlive, _async, _verbose);
+          client, _keepAlive, _async, _verbose, interval);
       thread->setOffset((size_t)(i * realStep));
+      // spread the requests of all threads evenly
+      thread->setStartDelay(interval * i / _concurreny);
       thread->start();
       threads.push_back(thread);
     }
@@ -289,19 +360,22 @@ void BenchFeature::start() {
         operationsCounter.incompleteFailures(), requestTime,
     });
     for (size_t i = 0; i < static_cast<size_t>(_concurreny); ++i) {
+      for (auto const& it : threads[i]->latencies()) {
+        _latencies[it.first].add(it.second);
+      }
       delete threads[i];
     }
     threads.clear();
   }
   std::cout << std::endl;
 
-  report(client, results);
+  bool const reported = report(client, results);
   if (!ok) {
     std::cout << "At least one of the runs produced failures!" << std::endl;
   }
   benchmark->tearDown();
 
-  if (!ok) {
+  if (!ok || !reported) {
     ret = EXIT_FAILURE;
   }
 
@@ -320,7 +394,11 @@ bool BenchFeature::report(ClientFeature* client,
             << ", replication factor: " << _replicationFactor
             << ", number of shards: " << _numberOfShards
             << ", wait for sync: " << (_waitForSync ? "true" : "false")
-            << ", concurrency level (threads): " << _concurreny << std::endl;
+            << ", concurrency level (threads): " << _concurreny;
+  if (_rate > 0.0) {
+    std::cout << ", target rate: " << _rate << " operations/s";
+  }
+  std::cout << std::endl;
 
   std::cout << "Test case: " << _testCase << ", complexity: " << _complexity
             << ", database: '" << client->databaseName() << "', collection: '"
@@ -357,11 +435,256 @@ bool BenchFeature::report(ClientFeature* client,
     output = results[0];
   }
   printResult(output);
-  if (_junitReportFile.empty()) {
-    return true;
+  printLatencies();
+
+  bool ok = true;
+  if (!_junitReportFile.empty()) {
+    ok = writeJunitReport(output) && ok;
+  }
+  if (!_jsonReportFile.empty()) {
+    ok = writeJsonReport(client, results, output) && ok;
+  }
+  if (!_baselineFile.empty()) {
+    ok = compareWithBaseline(output) && ok;
+  }
+
+  return ok;
+}
+
+void BenchFeature::printLatencies() {
+  if (_latencies.empty()) {
+    return;
+  }
+
+  std::cout << "Request latencies (all runs"
+            << (_rate > 0.0 ? ", measured from the scheduled send time" : "")
+            << "):" << std::endl;
+
+  for (auto const& it : _latencies) {
+    basics::StatisticsHistogram const& h = it.second;
+
+    std::cout << "  " << GeneralRequest::translateMethod(it.first)
+              << ": count " << h._count << ", avg " << std::fixed
+              << (h._count > 0 ? h._total / h._count : 0.0) << " s, p50 "
+              << h.percentile(0.5) << " s, p99 " << h.percentile(0.99)
+              << " s, p99.9 " << h.percentile(0.999) << " s, max " << h._max
+              << " s" << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+bool BenchFeature::writeJsonReport(ClientFeature* client,
+                                   std::vector<BenchRunResult> const& results,
+                                   BenchRunResult const& result) {
+  auto addResult = [this](VPackBuilder& builder, BenchRunResult const& r) {
+    builder.openObject();
+    builder.add("time", VPackValue(r.time));
+    builder.add("requestTime", VPackValue(r.requestTime));
+    builder.add("operationsPerSecond",
+                VPackValue(r.time > 0.0 ? _operations / r.time : 0.0));
+    builder.add("failures", VPackValue(r.failures));
+    builder.add("incomplete", VPackValue(r.incomplete));
+    builder.close();
+  };
+
+  VPackBuilder builder;
+  builder.openObject();
+  builder.add("testCase", VPackValue(_testCase));
+  builder.add("complexity", VPackValue(_complexity));
+  builder.add("requests", VPackValue(_operations));
+  builder.add("concurrency", VPackValue(_concurreny));
+  builder.add("batchSize", VPackValue(_batchSize));
+  builder.add("keepAlive", VPackValue(_keepAlive));
+  builder.add("async", VPackValue(_async));
+  builder.add("readRatio", VPackValue(_readRatio));
+  builder.add("zipfSkew", VPackValue(_zipfSkew));
+  builder.add("rate", VPackValue(_rate));
+  builder.add("replicationFactor", VPackValue(_replicationFactor));
+  builder.add("numberOfShards", VPackValue(_numberOfShards));
+  builder.add("waitForSync", VPackValue(_waitForSync));
+
+  builder.add("metadata", VPackValue(VPackValueType::Object));
+  addMetadata(client, builder);
+  builder.close();
+
+  builder.add("runs", VPackValue(VPackValueType::Array));
+  for (auto const& r : results) {
+    addResult(builder, r);
+  }
+  builder.close();
+
+  builder.add(VPackValue("result"));
+  addResult(builder, result);
+
+  // latencies in seconds
+  builder.add("latencies", VPackValue(VPackValueType::Object));
+  for (auto const& it : _latencies) {
+    basics::StatisticsHistogram const& h = it.second;
+
+    builder.add(GeneralRequest::translateMethod(it.first),
+                VPackValue(VPackValueType::Object));
+    builder.add("count", VPackValue(h._count));
+    builder.add("avg",
+                VPackValue(h._count > 0 ? h._total / h._count : 0.0));
+    builder.add("p50", VPackValue(h.percentile(0.5)));
+    builder.add("p99", VPackValue(h.percentile(0.99)));
+    builder.add("p999", VPackValue(h.percentile(0.999)));
+    builder.add("max", VPackValue(h._max));
+    builder.close();
+  }
+  builder.close();
+  builder.close();
+
+  std::ofstream outfile(_jsonReportFile, std::ofstream::binary);
+  if (!outfile.is_open()) {
+    std::cerr << "Could not open JSON Report File: " << _jsonReportFile
+              << std::endl;
+    return false;
+  }
+
+  bool ok = false;
+  try {
+    outfile << builder.slice().toJson() << '\n';
+    ok = true;
+  } catch (...) {
+    std::cerr << "Got an exception writing to JSON report file "
+              << _jsonReportFile;
+    ok = false;
+  }
+  outfile.close();
+  return ok;
+}
+
+/// @brief adds the machine the benchmark ran on and the server it ran
+/// against, so that reports from different setups are not mixed up
+void BenchFeature::addMetadata(ClientFeature* client, VPackBuilder& builder) {
+  std::time_t t = std::time(nullptr);
+  char date[255];
+  memset(date, 0, sizeof(date));
+  strftime(date, sizeof(date) - 1, "%FT%T%z", std::localtime(&t));
+  builder.add("date", VPackValue(date));
+
+  builder.add("hostname", VPackValue(utilities::hostname()));
+  builder.add("processors", VPackValue(TRI_numberProcessors()));
+  builder.add("physicalMemory", VPackValue(TRI_PhysicalMemory));
+  struct utsname name;
+  if (uname(&name) == 0) {
+    builder.add("os", VPackValue(std::string(name.sysname) + " " +
+                                 name.release + " " + name.machine));
+  }
+
+  // the server side
+  std::unique_ptr<SimpleHttpClient> httpClient;
+  try {
+    httpClient = client->createHttpClient();
+  } catch (...) {
+    return;
+  }
+  auto addFromServer = [&](std::string const& url, std::string const& key,
+                           std::string const& attribute) {
+    std::unique_ptr<SimpleHttpResult> result(
+        httpClient->request(rest::RequestType::GET, url, nullptr, 0));
+    if (result == nullptr || !result->isComplete() ||
+        result->getHttpReturnCode() != 200) {
+      return;
+    }
+    try {
+      auto body = result->getBodyVelocyPack();
+      VPackSlice value = body->slice().get(attribute);
+      if (value.isString()) {
+        builder.add(key, value);
+      }
+    } catch (...) {
+    }
+  };
+  addFromServer("/_api/version", "serverVersion", "version");
+  addFromServer("/_api/engine", "engine", "name");
+  addFromServer("/_admin/server/role", "role", "role");
+}
+
+/// @brief compares the result with the one of an earlier JSON report
+bool BenchFeature::compareWithBaseline(BenchRunResult const& result) {
+  std::shared_ptr<VPackBuilder> baseline;
+  try {
+    baseline = VPackParser::fromJson(FileUtils::slurp(_baselineFile));
+  } catch (...) {
+    std::cerr << "Could not read baseline file: " << _baselineFile
+              << std::endl;
+    return false;
+  }
+  VPackSlice slice = baseline->slice();
+
+  // only runs with the same parameters are comparable
+  bool comparable = slice.isObject() &&
+                    slice.get("testCase").isString() &&
+                    slice.get("testCase").copyString() == _testCase;
+  for (auto const& it : std::vector<std::pair<char const*, uint64_t>>{
+           {"complexity", _complexity},
+           {"requests", _operations},
+           {"concurrency", _concurreny},
+           {"batchSize", _batchSize}}) {
+    if (!comparable) {
+      break;
+    }
+    VPackSlice value = slice.get(it.first);
+    comparable = value.isNumber() && value.getNumber<uint64_t>() == it.second;
+  }
+  if (!comparable) {
+    std::cerr << "Baseline file " << _baselineFile
+              << " was recorded with a different test case, complexity, "
+                 "number of requests, concurrency or batch size"
+              << std::endl;
+    return false;
+  }
+
+  VPackSlice base = slice.get("result").get("operationsPerSecond");
+  if (!base.isNumber() || base.getNumber<double>() <= 0.0) {
+    std::cerr << "Baseline file " << _baselineFile
+              << " does not contain a valid result" << std::endl;
+    return false;
   }
 
-  return writeJunitReport(output);
+  double const baseRate = base.getNumber<double>();
+  double const rate = result.time > 0.0 ? _operations / result.time : 0.0;
+  double const change = (rate - baseRate) / baseRate * 100.0;
+
+  std::cout << "Comparison with baseline " << _baselineFile;
+  VPackSlice metadata = slice.get("metadata");
+  if (metadata.isObject() && metadata.get("date").isString()) {
+    std::cout << " (" << metadata.get("date").copyString() << ")";
+  }
+  std::cout << ":" << std::endl
+            << "  operations per second: " << std::fixed << rate
+            << ", baseline " << baseRate << ", change " << std::showpos
+            << change << std::noshowpos << " %" << std::endl;
+
+  VPackSlice latencies = slice.get("latencies");
+  for (auto const& it : _latencies) {
+    VPackSlice p99;
+    if (latencies.isObject()) {
+      VPackSlice method =
+          latencies.get(GeneralRequest::translateMethod(it.first));
+      if (method.isObject()) {
+        p99 = method.get("p99");
+      }
+    }
+    if (p99.isNumber()) {
+      std::cout << "  " << GeneralRequest::translateMethod(it.first)
+                << " p99: " << it.second.percentile(0.99) << " s, baseline "
+                << p99.getNumber<double>() << " s" << std::endl;
+    }
+  }
+  std::cout << std::endl;
+
+  if (change < -_maxRegression) {
+    LOG_TOPIC(ERR, arangodb::Logger::FIXME)
+        << "operations per second dropped by " << -change
+        << " % compared to the baseline, more than the allowed "
+        << _maxRegression << " %";
+    return false;
+  }
+  return true;
 }
 
 bool BenchFeature::writeJunitReport(BenchRunResult const& result) {
@@ -429,6 +752,13 @@ void BenchFeature::printResult(BenchRunResult const& result) {
             << std::endl
             << std::endl;
 
+  if (_rate > 0.0 && (double)_operations / result.time < 0.95 * _rate) {
+    LOG_TOPIC(WARN, arangodb::Logger::FIXME)
+        << "the target rate of " << _rate
+        << " operations per second was not reached, consider increasing "
+           "--concurrency";
+  }
+
   if (result.failures > 0) {
     LOG_TOPIC(WARN, arangodb::Logger::FIXME) << result.failures << " arangobench request(s) failed!";
   }
@@ -24,6 +24,8 @@
 #define ARANGODB_BENCHMARK_BENCH_FEATURE_H 1
 
 #include "ApplicationFeatures/ApplicationFeature.h"
+#include "Rest/CommonDefines.h"
+#include "Statistics/figures.h"
 
 namespace arangodb {
 
@@ -67,15 +69,25 @@ class BenchFeature final : public application_features::ApplicationFeature {
   bool quit() const { return _quiet; }
   uint64_t runs() const { return _runs; }
   std::string const& junitReportFile() const { return _junitReportFile; }
+  std::string const& jsonReportFile() const { return _jsonReportFile; }
+  std::string const& baselineFile() const { return _baselineFile; }
   uint64_t replicationFactor() const { return _replicationFactor; }
   uint64_t numberOfShards() const { return _numberOfShards; }
   bool waitForSync() const { return _waitForSync; }
+  uint64_t readRatio() const { return _readRatio; }
+  double zipfSkew() const { return _zipfSkew; }
+  double rate() const { return _rate; }
 
  private:
   void status(std::string const& value);
   bool report(ClientFeature*, std::vector<BenchRunResult>);
   void printResult(BenchRunResult const& result);
+  void printLatencies();
   bool writeJunitReport(BenchRunResult const& result);
+  bool writeJsonReport(ClientFeature*, std::vector<BenchRunResult> const& results,
+                       BenchRunResult const& result);
+  void addMetadata(ClientFeature*, velocypack::Builder&);
+  bool compareWithBaseline(BenchRunResult const& result);
 
  private:
   bool _async;
@@ -92,13 +104,22 @@ class BenchFeature final : public application_features::ApplicationFeature {
   bool _quiet;
   uint64_t _runs;
   std::string _junitReportFile;
+  std::string _jsonReportFile;
+  std::string _baselineFile;
+  double _maxRegression;
   uint64_t _replicationFactor;
   uint64_t _numberOfShards;
   bool _waitForSync;
+  uint64_t _readRatio;
+  double _zipfSkew;
+  double _rate;
 
  private:
   int* _result;
 
+  // request latencies of all runs, by request type
+  std::map<rest::RequestType, basics::StatisticsHistogram> _latencies;
+
  private:
   static void updateStartCounter();
   static int getStartCounter();
@@ -36,6 +36,7 @@
 #include "Logger/Logger.h"
 #include "Rest/HttpResponse.h"
 #include "Shell/ClientFeature.h"
+#include "Statistics/figures.h"
 #include "SimpleHttpClient/GeneralClientConnection.h"
 #include "SimpleHttpClient/SimpleHttpClient.h"
 #include "SimpleHttpClient/SimpleHttpResult.h"
@@ -50,7 +51,7 @@ class BenchmarkThread : public arangodb::Thread {
                   int threadNumber, const unsigned long batchSize,
                   BenchmarkCounter<unsigned long>* operationsCounter,
                   ClientFeature* client, bool keepAlive, bool async,
-                  bool verbose)
+                  bool verbose, double interval)
       : Thread("BenchmarkThread"),
         _operation(operation),
         _startCondition(condition),
@@ -70,6 +71,9 @@ class BenchmarkThread : public arangodb::Thread {
         _offset(0),
         _counter(0),
         _time(0.0),
+        _interval(interval),
+        _startDelay(0.0),
+        _nextSendTime(0.0),
         _verbose(verbose) {
     _errorHeader =
         basics::StringUtils::tolower(StaticStrings::Errors);
@@ -131,6 +135,10 @@ class BenchmarkThread : public arangodb::Thread {
       guard.wait();
     }
 
+    if (_interval > 0.0) {
+      _nextSendTime = TRI_microtime() + _startDelay;
+    }
+
     while (!isStopping()) {
       unsigned long numOps = _operationsCounter->next(_batchSize);
 
@@ -138,11 +146,26 @@ class BenchmarkThread : public arangodb::Thread {
         break;
       }
 
+      // open loop: requests are sent at fixed times, independent of how long
+      // earlier requests took. latencies are measured from these times, so
+      // the time a request had to wait for its predecessors is included
+      double intendedTime = 0.0;
+
+      if (_interval > 0.0) {
+        intendedTime = _nextSendTime;
+        _nextSendTime += _interval * numOps;
+
+        double const now = TRI_microtime();
+        if (intendedTime > now) {
+          usleep(static_cast<TRI_usleep_t>((intendedTime - now) * 1000000.0));
+        }
+      }
+
       if (_batchSize < 1) {
-        executeSingleRequest();
+        executeSingleRequest(intendedTime);
       } else {
         try {
-          executeBatchRequest(numOps);
+          executeBatchRequest(numOps, intendedTime);
         } catch (arangodb::basics::Exception const& ex) {
           LOG_TOPIC(FATAL, arangodb::Logger::FIXME) << "Caught exception during test execution: " << ex.code()
                      << " " << ex.what();
@@ -189,7 +212,8 @@ class BenchmarkThread : public arangodb::Thread {
   /// @brief execute a batch request with numOperations parts
   //////////////////////////////////////////////////////////////////////////////
 
-  void executeBatchRequest(const unsigned long numOperations) {
+  void executeBatchRequest(const unsigned long numOperations,
+                           double intendedTime) {
     static char const boundary[] = "XXXarangobench-benchmarkXXX";
     size_t blen = strlen(boundary);
 
@@ -255,7 +279,10 @@ class BenchmarkThread : public arangodb::Thread {
     httpclient::SimpleHttpResult* result = _httpClient->request(
         rest::RequestType::POST, "/_api/batch", batchPayload.c_str(),
         batchPayload.length(), _headers);
-    _time += TRI_microtime() - start;
+    double const end = TRI_microtime();
+    _time += end - start;
+    _latencies[rest::RequestType::POST].addFigure(
+        end - (intendedTime > 0.0 ? intendedTime : start));
 
     if (result == nullptr || !result->isComplete()) {
       if (result != nullptr) {
@@ -318,7 +345,7 @@ class BenchmarkThread : public arangodb::Thread {
   /// @brief execute a single request
   //////////////////////////////////////////////////////////////////////////////
 
-  void executeSingleRequest() {
+  void executeSingleRequest(double intendedTime) {
     size_t const threadCounter = _counter++;
     size_t const globalCounter = _offset + threadCounter;
     rest::RequestType const type =
@@ -336,7 +363,10 @@ class BenchmarkThread : public arangodb::Thread {
     double start = TRI_microtime();
     httpclient::SimpleHttpResult* result =
         _httpClient->request(type, url, payload, payloadLength, _headers);
-    _time += TRI_microtime() - start;
+    double const end = TRI_microtime();
+    _time += end - start;
+    _latencies[type].addFigure(end -
+                               (intendedTime > 0.0 ? intendedTime : start));
 
     if (mustFree) {
       TRI_Free(TRI_UNKNOWN_MEM_ZONE, (void*)payload);
@@ -376,12 +406,28 @@ class BenchmarkThread : public arangodb::Thread {
 
   void setOffset(size_t offset) { _offset = offset; }
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief set the delay of the first request in open loop mode
+  //////////////////////////////////////////////////////////////////////////////
+
+  void setStartDelay(double delay) { _startDelay = delay; }
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief return the total time accumulated by the thread
   //////////////////////////////////////////////////////////////////////////////
 
   double getTime() const { return _time; }
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief return the request latencies of the thread, by request type. in
+  /// batch mode, every batch is one POST request
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::map<rest::RequestType, basics::StatisticsHistogram> const& latencies()
+      const {
+    return _latencies;
+  }
+
  private:
   //////////////////////////////////////////////////////////////////////////////
   /// @brief the operation to benchmark
@@ -491,6 +537,31 @@ class BenchmarkThread : public arangodb::Thread {
 
   double _time;
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief request latencies, by request type
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::map<rest::RequestType, basics::StatisticsHistogram> _latencies;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief seconds between two operations of this thread in open loop
+  /// mode, 0 in closed loop mode
+  //////////////////////////////////////////////////////////////////////////////
+
+  double const _interval;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief delay of the first request in open loop mode
+  //////////////////////////////////////////////////////////////////////////////
+
+  double _startDelay;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief the time the next request is due in open loop mode
+  //////////////////////////////////////////////////////////////////////////////
+
+  double _nextSendTime;
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief lower-case error header we look for
   //////////////////////////////////////////////////////////////////////////////
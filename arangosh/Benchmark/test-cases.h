@@ -23,8 +23,13 @@
 
 #include "Basics/Common.h"
 
+#include "Basics/fasthash.h"
+#include "Basics/tri-strings.h"
 #include "Random/RandomGenerator.h"
 
+#include <velocypack/Builder.h>
+#include <velocypack/velocypack-aliases.h>
+
 static bool DeleteCollection(SimpleHttpClient*, std::string const&);
 
 static bool CreateCollection(SimpleHttpClient*, std::string const&, int const);
@@ -35,6 +40,93 @@ static bool CreateDocument(SimpleHttpClient*, std::string const&,
 static bool CreateIndex(SimpleHttpClient*, std::string const&,
                         std::string const&, std::string const&);
 
+static bool RunQuery(SimpleHttpClient*, std::string const&, VPackSlice);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of documents the aql and mixed-read-write tests work on
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const KeySpace = 10000;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a pseudo-random value in [0, 1) for an operation. url(), type()
+/// and payload() are called separately for the same operation, so they
+/// must all derive the same random choices from the operation's counter
+////////////////////////////////////////////////////////////////////////////////
+
+static double RandomValue(size_t globalCounter, uint64_t seed) {
+  return (fasthash64_uint64(globalCounter, seed) >> 11) *
+         (1.0 / 9007199254740992.0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Zipf distribution over the ranks 0 .. n - 1, rank 0 being the most
+/// frequent one. a skew of 0 gives a uniform distribution
+////////////////////////////////////////////////////////////////////////////////
+
+struct ZipfDistribution {
+  ZipfDistribution(size_t n, double skew) : _cdf(n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+      sum += 1.0 / std::pow(static_cast<double>(i + 1), skew);
+      _cdf[i] = sum;
+    }
+    for (auto& value : _cdf) {
+      value /= sum;
+    }
+  }
+
+  /// @brief maps a value from [0, 1) to a rank
+  size_t rank(double value) const {
+    auto it = std::lower_bound(_cdf.begin(), _cdf.end(), value);
+
+    if (it == _cdf.end()) {
+      return _cdf.size() - 1;
+    }
+    return static_cast<size_t>(it - _cdf.begin());
+  }
+
+  std::vector<double> _cdf;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief base for tests that run one AQL query per operation
+////////////////////////////////////////////////////////////////////////////////
+
+struct AqlQueryTest : public BenchmarkOperation {
+  AqlQueryTest() : BenchmarkOperation() {}
+
+  void tearDown() override {}
+
+  std::string url(int const threadNumber, size_t const threadCounter,
+                  size_t const globalCounter) override {
+    return std::string("/_api/cursor");
+  }
+
+  rest::RequestType type(int const threadNumber, size_t const threadCounter,
+                         size_t const globalCounter) override {
+    return rest::RequestType::POST;
+  }
+
+  char const* payload(size_t* length, int const threadNumber,
+                      size_t const threadCounter, size_t const globalCounter,
+                      bool* mustFree) override {
+    VPackBuilder builder;
+    builder.openObject();
+    buildQuery(builder, globalCounter);
+    builder.close();
+
+    std::string const body = builder.slice().toJson();
+
+    *length = body.size();
+    *mustFree = true;
+    return TRI_DuplicateString(TRI_UNKNOWN_MEM_ZONE, body.c_str(), body.size());
+  }
+
+  /// @brief adds "query" and "bindVars" of the operation to the open object
+  virtual void buildQuery(VPackBuilder& builder, size_t globalCounter) = 0;
+};
+
 struct VersionTest : public BenchmarkOperation {
   VersionTest() : BenchmarkOperation() { _url = "/_api/version"; }
 
@@ -1518,6 +1610,277 @@ struct AqlV8Test : public BenchmarkOperation {
   }
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief graph traversals of depth 1 .. complexity, starting at vertices
+/// picked from a Zipf distribution. every vertex has three outgoing edges
+////////////////////////////////////////////////////////////////////////////////
+
+struct AqlTraversalTest : public AqlQueryTest {
+  AqlTraversalTest()
+      : AqlQueryTest(), _vertices(KeySpace, ARANGOBENCH->zipfSkew()) {}
+
+  bool setUp(SimpleHttpClient* client) override {
+    std::string const edges = ARANGOBENCH->collection() + "Edges";
+
+    VPackBuilder vertexVars;
+    vertexVars.openObject();
+    vertexVars.add("@vertices", VPackValue(ARANGOBENCH->collection()));
+    vertexVars.add("n", VPackValue(KeySpace));
+    vertexVars.close();
+
+    VPackBuilder edgeVars;
+    edgeVars.openObject();
+    edgeVars.add("@edges", VPackValue(edges));
+    edgeVars.add("prefix", VPackValue(ARANGOBENCH->collection() + "/v"));
+    edgeVars.add("n", VPackValue(KeySpace));
+    edgeVars.close();
+
+    return DeleteCollection(client, ARANGOBENCH->collection()) &&
+           DeleteCollection(client, edges) &&
+           CreateCollection(client, ARANGOBENCH->collection(), 2) &&
+           CreateCollection(client, edges, 3) &&
+           RunQuery(client,
+                    "FOR i IN 0..@n - 1 INSERT { _key: CONCAT('v', i), value: "
+                    "i } INTO @@vertices",
+                    vertexVars.slice()) &&
+           RunQuery(client,
+                    "FOR i IN 0..@n - 1 FOR j IN 1..3 INSERT { _from: "
+                    "CONCAT(@prefix, i), _to: CONCAT(@prefix, (i * 7 + j * "
+                    "1009) % @n) } INTO @@edges",
+                    edgeVars.slice());
+  }
+
+  void buildQuery(VPackBuilder& builder, size_t globalCounter) override {
+    size_t const start = _vertices.rank(RandomValue(globalCounter, 1));
+
+    builder.add("query",
+                VPackValue("FOR v IN 1..@depth OUTBOUND @start @@edges "
+                           "RETURN v.value"));
+    builder.add("bindVars", VPackValue(VPackValueType::Object));
+    builder.add("depth", VPackValue(ARANGOBENCH->complexity()));
+    builder.add("start", VPackValue(ARANGOBENCH->collection() + "/v" +
+                                    StringUtils::itoa(start)));
+    builder.add("@edges", VPackValue(ARANGOBENCH->collection() + "Edges"));
+    builder.close();
+  }
+
+  ZipfDistribution const _vertices;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief joins a customer, picked from a Zipf distribution, with its ten
+/// orders in another collection, through the primary and a hash index
+////////////////////////////////////////////////////////////////////////////////
+
+struct AqlJoinTest : public AqlQueryTest {
+  AqlJoinTest()
+      : AqlQueryTest(), _customers(KeySpace, ARANGOBENCH->zipfSkew()) {}
+
+  bool setUp(SimpleHttpClient* client) override {
+    std::string const orders = ARANGOBENCH->collection() + "Orders";
+
+    VPackBuilder customerVars;
+    customerVars.openObject();
+    customerVars.add("@customers", VPackValue(ARANGOBENCH->collection()));
+    customerVars.add("n", VPackValue(KeySpace));
+    customerVars.close();
+
+    VPackBuilder orderVars;
+    orderVars.openObject();
+    orderVars.add("@orders", VPackValue(orders));
+    orderVars.add("n", VPackValue(KeySpace));
+    orderVars.close();
+
+    return DeleteCollection(client, ARANGOBENCH->collection()) &&
+           DeleteCollection(client, orders) &&
+           CreateCollection(client, ARANGOBENCH->collection(), 2) &&
+           CreateCollection(client, orders, 2) &&
+           CreateIndex(client, orders, "hash", "[\"customer\"]") &&
+           RunQuery(client,
+                    "FOR i IN 0..@n - 1 INSERT { _key: CONCAT('c', i), name: "
+                    "CONCAT('customer', i) } INTO @@customers",
+                    customerVars.slice()) &&
+           RunQuery(client,
+                    "FOR i IN 0..@n - 1 FOR j IN 1..10 INSERT { customer: "
+                    "CONCAT('c', i), amount: (i * j) % 100 } INTO @@orders",
+                    orderVars.slice());
+  }
+
+  void buildQuery(VPackBuilder& builder, size_t globalCounter) override {
+    size_t const customer = _customers.rank(RandomValue(globalCounter, 1));
+
+    builder.add("query",
+                VPackValue("FOR c IN @@customers FILTER c._key == @key "
+                           "FOR o IN @@orders FILTER o.customer == c._key "
+                           "RETURN { name: c.name, amount: o.amount }"));
+    builder.add("bindVars", VPackValue(VPackValueType::Object));
+    builder.add("key", VPackValue("c" + StringUtils::itoa(customer)));
+    builder.add("@customers", VPackValue(ARANGOBENCH->collection()));
+    builder.add("@orders", VPackValue(ARANGOBENCH->collection() + "Orders"));
+    builder.close();
+  }
+
+  ZipfDistribution const _customers;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief groups a random range of 1000 documents, found through a skiplist
+/// index, and aggregates every group
+////////////////////////////////////////////////////////////////////////////////
+
+struct AqlCollectTest : public AqlQueryTest {
+  AqlCollectTest() : AqlQueryTest() {}
+
+  bool setUp(SimpleHttpClient* client) override {
+    VPackBuilder bindVars;
+    bindVars.openObject();
+    bindVars.add("@collection", VPackValue(ARANGOBENCH->collection()));
+    bindVars.add("n", VPackValue(KeySpace));
+    bindVars.close();
+
+    return DeleteCollection(client, ARANGOBENCH->collection()) &&
+           CreateCollection(client, ARANGOBENCH->collection(), 2) &&
+           CreateIndex(client, ARANGOBENCH->collection(), "skiplist",
+                       "[\"value\"]") &&
+           RunQuery(client,
+                    "FOR i IN 0..@n - 1 INSERT { value: i, group: i % 100 } "
+                    "INTO @@collection",
+                    bindVars.slice());
+  }
+
+  void buildQuery(VPackBuilder& builder, size_t globalCounter) override {
+    size_t const from = static_cast<size_t>(RandomValue(globalCounter, 1) *
+                                            (KeySpace - 1000));
+
+    builder.add("query",
+                VPackValue("FOR d IN @@collection FILTER d.value >= @from && "
+                           "d.value < @from + 1000 COLLECT g = d.group "
+                           "AGGREGATE total = SUM(d.value), n = LENGTH(1) "
+                           "RETURN { g, total, n }"));
+    builder.add("bindVars", VPackValue(VPackValueType::Object));
+    builder.add("from", VPackValue(from));
+    builder.add("@collection", VPackValue(ARANGOBENCH->collection()));
+    builder.close();
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads pages of 100 documents in index order, the page is picked
+/// from a Zipf distribution so the first pages are read most
+////////////////////////////////////////////////////////////////////////////////
+
+struct AqlPagingTest : public AqlQueryTest {
+  static size_t const PageSize = 100;
+
+  AqlPagingTest()
+      : AqlQueryTest(), _pages(KeySpace / PageSize, ARANGOBENCH->zipfSkew()) {}
+
+  bool setUp(SimpleHttpClient* client) override {
+    VPackBuilder bindVars;
+    bindVars.openObject();
+    bindVars.add("@collection", VPackValue(ARANGOBENCH->collection()));
+    bindVars.add("n", VPackValue(KeySpace));
+    bindVars.close();
+
+    return DeleteCollection(client, ARANGOBENCH->collection()) &&
+           CreateCollection(client, ARANGOBENCH->collection(), 2) &&
+           CreateIndex(client, ARANGOBENCH->collection(), "skiplist",
+                       "[\"value\"]") &&
+           RunQuery(client,
+                    "FOR i IN 0..@n - 1 INSERT { value: i, name: CONCAT('test', "
+                    "i) } INTO @@collection",
+                    bindVars.slice());
+  }
+
+  void buildQuery(VPackBuilder& builder, size_t globalCounter) override {
+    size_t const page = _pages.rank(RandomValue(globalCounter, 1));
+
+    builder.add("query",
+                VPackValue("FOR d IN @@collection SORT d.value "
+                           "LIMIT @offset, @count RETURN d"));
+    builder.add("bindVars", VPackValue(VPackValueType::Object));
+    builder.add("offset", VPackValue(page * PageSize));
+    builder.add("count", VPackValue(PageSize));
+    builder.add("@collection", VPackValue(ARANGOBENCH->collection()));
+    builder.close();
+  }
+
+  ZipfDistribution const _pages;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief document reads and updates at the ratio given by --read-ratio, on
+/// keys picked from a Zipf distribution
+////////////////////////////////////////////////////////////////////////////////
+
+struct MixedReadWriteTest : public BenchmarkOperation {
+  MixedReadWriteTest()
+      : BenchmarkOperation(), _keys(KeySpace, ARANGOBENCH->zipfSkew()) {}
+
+  bool setUp(SimpleHttpClient* client) override {
+    VPackBuilder bindVars;
+    bindVars.openObject();
+    bindVars.add("@collection", VPackValue(ARANGOBENCH->collection()));
+    bindVars.add("n", VPackValue(KeySpace));
+    bindVars.close();
+
+    return DeleteCollection(client, ARANGOBENCH->collection()) &&
+           CreateCollection(client, ARANGOBENCH->collection(), 2) &&
+           RunQuery(client,
+                    "FOR i IN 0..@n - 1 INSERT { _key: CONCAT('k', i), value: "
+                    "i } INTO @@collection",
+                    bindVars.slice());
+  }
+
+  void tearDown() override {}
+
+  std::string url(int const threadNumber, size_t const threadCounter,
+                  size_t const globalCounter) override {
+    size_t const key = _keys.rank(RandomValue(globalCounter, 2));
+
+    return std::string("/_api/document/" + ARANGOBENCH->collection() + "/k" +
+                       StringUtils::itoa(key));
+  }
+
+  rest::RequestType type(int const threadNumber, size_t const threadCounter,
+                         size_t const globalCounter) override {
+    if (isRead(globalCounter)) {
+      return rest::RequestType::GET;
+    }
+    return rest::RequestType::PATCH;
+  }
+
+  char const* payload(size_t* length, int const threadNumber,
+                      size_t const threadCounter, size_t const globalCounter,
+                      bool* mustFree) override {
+    if (isRead(globalCounter)) {
+      *length = 0;
+      *mustFree = false;
+      return (char const*)nullptr;
+    }
+
+    TRI_string_buffer_t* buffer;
+    buffer = TRI_CreateSizedStringBuffer(TRI_UNKNOWN_MEM_ZONE, 64);
+
+    TRI_AppendStringStringBuffer(buffer, "{\"value\":");
+    TRI_AppendUInt64StringBuffer(buffer, (uint64_t)globalCounter);
+    TRI_AppendCharStringBuffer(buffer, '}');
+
+    *length = TRI_LengthStringBuffer(buffer);
+    *mustFree = true;
+    char* ptr = TRI_StealStringBuffer(buffer);
+    TRI_FreeStringBuffer(TRI_UNKNOWN_MEM_ZONE, buffer);
+
+    return (char const*)ptr;
+  }
+
+  bool isRead(size_t globalCounter) const {
+    return RandomValue(globalCounter, 1) * 100.0 < ARANGOBENCH->readRatio();
+  }
+
+  ZipfDistribution const _keys;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief delete a collection
 ////////////////////////////////////////////////////////////////////////////////
@@ -1636,6 +1999,38 @@ static bool CreateDocument(SimpleHttpClient* client,
   return !failed;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief run an AQL query
+////////////////////////////////////////////////////////////////////////////////
+
+static bool RunQuery(SimpleHttpClient* client, std::string const& query,
+                     VPackSlice bindVars) {
+  std::unordered_map<std::string, std::string> headerFields;
+  SimpleHttpResult* result = nullptr;
+
+  VPackBuilder builder;
+  builder.openObject();
+  builder.add("query", VPackValue(query));
+  builder.add("bindVars", bindVars);
+  builder.close();
+
+  std::string const payload = builder.slice().toJson();
+  result = client->request(rest::RequestType::POST, "/_api/cursor",
+                           payload.c_str(), payload.size(), headerFields);
+
+  bool failed = true;
+
+  if (result != nullptr) {
+    if (result->getHttpReturnCode() == 201) {
+      failed = false;
+    }
+
+    delete result;
+  }
+
+  return !failed;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the test case for a name
 ////////////////////////////////////////////////////////////////////////////////
@@ -1701,6 +2096,21 @@ static BenchmarkOperation* GetTestCase(std::string const& name) {
   if (name == "aqlv8") {
     return new AqlV8Test();
   }
+  if (name == "aqltraversal") {
+    return new AqlTraversalTest();
+  }
+  if (name == "aqljoin") {
+    return new AqlJoinTest();
+  }
+  if (name == "aqlcollect") {
+    return new AqlCollectTest();
+  }
+  if (name == "aqlpaging") {
+    return new AqlPagingTest();
+  }
+  if (name == "mixed-read-write") {
+    return new MixedReadWriteTest();
+  }
 
   return nullptr;
 }
@@ -23,7 +23,9 @@
 #include "DumpFeature.h"
 
 #include "ApplicationFeatures/ApplicationServer.h"
+#include "Basics/Exceptions.h"
 #include "Basics/FileUtils.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/OpenFilesTracker.h"
 #include "Basics/StringUtils.h"
 #include "Basics/VelocyPackHelper.h"
@@ -43,6 +45,7 @@
 #include <velocypack/velocypack-aliases.h>
 
 #include <iostream>
+#include <thread>
 
 using namespace arangodb;
 using namespace arangodb::basics;
@@ -66,10 +69,10 @@ DumpFeature::DumpFeature(application_features::ApplicationServer* server,
       _tickStart(0),
       _tickEnd(0),
       _compat28(false),
+      _threadCount(2),
       _result(result),
       _batchId(0),
-      _clusterMode(false),
-      _stats{0, 0, 0} {
+      _clusterMode(false) {
   requiresElevatedPrivileges(false);
   setOptional(false);
   startsAfter("Client");
@@ -128,6 +131,10 @@ void DumpFeature::collectOptions(
   options->addOption("--compat28",
                      "produce a dump compatible with ArangoDB 2.8",
                      new BooleanParameter(&_compat28));
+
+  options->addOption("--threads",
+                     "maximum number of collections/shards to dump in parallel",
+                     new UInt32Parameter(&_threadCount));
 }
 
 void DumpFeature::validateOptions(
@@ -152,6 +159,10 @@ void DumpFeature::validateOptions(
     _maxChunkSize = _chunkSize;
   }
 
+  if (_threadCount == 0) {
+    _threadCount = 1;
+  }
+
   if (_tickStart < _tickEnd) {
     LOG_TOPIC(FATAL, arangodb::Logger::FIXME)
         << "invalid values for --tick-start or --tick-end";
@@ -215,8 +226,31 @@ void DumpFeature::prepare() {
   }
 }
 
+DumpFeature::DumpFile::~DumpFile() {
+  if (fd >= 0) {
+    TRI_TRACKED_CLOSE_FILE(fd);
+  }
+}
+
+// create a connection to the server, configured like the main one
+std::unique_ptr<SimpleHttpClient> DumpFeature::createClient() {
+  ClientFeature* client =
+      application_features::ApplicationServer::getFeature<ClientFeature>(
+          "Client");
+
+  std::unique_ptr<SimpleHttpClient> httpClient = client->createHttpClient();
+
+  httpClient->params().setLocationRewriter(static_cast<void*>(client),
+                                           &rewriteLocation);
+  httpClient->params().setUserNamePassword("/", client->username(),
+                                           client->password());
+
+  return httpClient;
+}
+
 // start a batch
-int DumpFeature::startBatch(std::string DBserver, std::string& errorMsg) {
+int DumpFeature::startBatch(SimpleHttpClient& client, std::string DBserver,
+                            uint64_t& batchId, std::string& errorMsg) {
   std::string const url = "/_api/replication/batch";
   std::string const body = "{\"ttl\":300}";
 
@@ -225,12 +259,12 @@ int DumpFeature::startBatch(std::string DBserver, std::string& errorMsg) {
     urlExt = "?DBserver=" + DBserver;
   }
 
-  std::unique_ptr<SimpleHttpResult> response(_httpClient->request(
+  std::unique_ptr<SimpleHttpResult> response(client.request(
       rest::RequestType::POST, url + urlExt, body.c_str(), body.size()));
 
   if (response == nullptr || !response->isComplete()) {
     errorMsg =
-        "got invalid response from server: " + _httpClient->getErrorMessage();
+        "got invalid response from server: " + client.getErrorMessage();
 
     if (_force) {
       return TRI_ERROR_NO_ERROR;
@@ -260,50 +294,53 @@ int DumpFeature::startBatch(std::string DBserver, std::string& errorMsg) {
   std::string const id =
       arangodb::basics::VelocyPackHelper::getStringValue(resBody, "id", "");
 
-  _batchId = StringUtils::uint64(id);
+  batchId = StringUtils::uint64(id);
 
   return TRI_ERROR_NO_ERROR;
 }
 
 // prolongs a batch
-void DumpFeature::extendBatch(std::string DBserver) {
-  TRI_ASSERT(_batchId > 0);
+void DumpFeature::extendBatch(SimpleHttpClient& client, std::string DBserver,
+                              uint64_t batchId) {
+  TRI_ASSERT(batchId > 0);
 
   std::string const url =
-      "/_api/replication/batch/" + StringUtils::itoa(_batchId);
+      "/_api/replication/batch/" + StringUtils::itoa(batchId);
   std::string const body = "{\"ttl\":300}";
   std::string urlExt;
   if (!DBserver.empty()) {
     urlExt = "?DBserver=" + DBserver;
   }
 
-  std::unique_ptr<SimpleHttpResult> response(_httpClient->request(
+  std::unique_ptr<SimpleHttpResult> response(client.request(
       rest::RequestType::PUT, url + urlExt, body.c_str(), body.size()));
 
   // ignore any return value
 }
 
 // end a batch
-void DumpFeature::endBatch(std::string DBserver) {
-  TRI_ASSERT(_batchId > 0);
+void DumpFeature::endBatch(SimpleHttpClient& client, std::string DBserver,
+                           uint64_t& batchId) {
+  TRI_ASSERT(batchId > 0);
 
   std::string const url =
-      "/_api/replication/batch/" + StringUtils::itoa(_batchId);
+      "/_api/replication/batch/" + StringUtils::itoa(batchId);
   std::string urlExt;
   if (!DBserver.empty()) {
     urlExt = "?DBserver=" + DBserver;
   }
 
-  _batchId = 0;
+  batchId = 0;
 
-  std::unique_ptr<SimpleHttpResult> response(_httpClient->request(
+  std::unique_ptr<SimpleHttpResult> response(client.request(
       rest::RequestType::DELETE_REQ, url + urlExt, nullptr, 0));
 
   // ignore any return value
 }
 
 /// @brief dump a single collection
-int DumpFeature::dumpCollection(int fd, std::string const& cid,
+int DumpFeature::dumpCollection(SimpleHttpClient& client, int fd,
+                                std::string const& cid,
                                 std::string const& name, uint64_t maxTick,
                                 std::string& errorMsg) {
   uint64_t chunkSize = _chunkSize;
@@ -330,11 +367,11 @@ int DumpFeature::dumpCollection(int fd, std::string const& cid,
     _stats._totalBatches++;
 
     std::unique_ptr<SimpleHttpResult> response(
-        _httpClient->request(rest::RequestType::GET, url, nullptr, 0));
+        client.request(rest::RequestType::GET, url, nullptr, 0));
 
     if (response == nullptr || !response->isComplete()) {
       errorMsg =
-          "got invalid response from server: " + _httpClient->getErrorMessage();
+          "got invalid response from server: " + client.getErrorMessage();
 
       return TRI_ERROR_INTERNAL;
     }
@@ -545,6 +582,10 @@ int DumpFeature::runDump(std::string& dbName, std::string& errorMsg) {
     restrictList.insert(std::pair<std::string, bool>(_collections[i], true));
   }
 
+  // the data of the collections is dumped after all structure files have
+  // been written
+  std::vector<DumpJob> jobs;
+
   // iterate over collections
   for (VPackSlice const& collection : VPackArrayIterator(collections)) {
     if (!collection.isObject()) {
@@ -643,47 +684,48 @@ int DumpFeature::runDump(std::string& dbName, std::string& errorMsg) {
       fileName = _outputDirectory + TRI_DIR_SEPARATOR_STR + name + "_" +
                  hexString + ".data.json";
 
-      int fd;
-
-      // remove an existing file first
-      if (TRI_ExistsFile(fileName.c_str())) {
-        TRI_UnlinkFile(fileName.c_str());
-      }
+      jobs.emplace_back([this, cid, name, fileName, maxTick](
+          SimpleHttpClient& client, std::string& msg) -> int {
+        // remove an existing file first
+        if (TRI_ExistsFile(fileName.c_str())) {
+          TRI_UnlinkFile(fileName.c_str());
+        }
 
-      fd = TRI_TRACKED_CREATE_FILE(fileName.c_str(),
-                                   O_CREAT | O_EXCL | O_RDWR | TRI_O_CLOEXEC,
-                                   S_IRUSR | S_IWUSR);
+        int fd = TRI_TRACKED_CREATE_FILE(
+            fileName.c_str(), O_CREAT | O_EXCL | O_RDWR | TRI_O_CLOEXEC,
+            S_IRUSR | S_IWUSR);
 
-      if (fd < 0) {
-        errorMsg = "cannot write to file '" + fileName + "'";
+        if (fd < 0) {
+          msg = "cannot write to file '" + fileName + "'";
 
-        return TRI_ERROR_CANNOT_WRITE_FILE;
-      }
+          return TRI_ERROR_CANNOT_WRITE_FILE;
+        }
 
-      extendBatch("");
-      int res =
-          dumpCollection(fd, std::to_string(cid), name, maxTick, errorMsg);
+        extendBatch(client, "", _batchId);
+        int res = dumpCollection(client, fd, std::to_string(cid), name,
+                                 maxTick, msg);
 
-      TRI_TRACKED_CLOSE_FILE(fd);
+        TRI_TRACKED_CLOSE_FILE(fd);
 
-      if (res != TRI_ERROR_NO_ERROR) {
-        if (errorMsg.empty()) {
-          errorMsg = "cannot write to file '" + fileName + "'";
+        if (res != TRI_ERROR_NO_ERROR && msg.empty()) {
+          msg = "cannot write to file '" + fileName + "'";
         }
 
         return res;
-      }
+      });
     }
   }
 
-  return TRI_ERROR_NO_ERROR;
+  return runJobs(jobs, errorMsg);
 }
 
 /// @brief dump a single shard, that is a collection on a DBserver
-int DumpFeature::dumpShard(int fd, std::string const& DBserver,
-                           std::string const& name, std::string& errorMsg) {
+int DumpFeature::dumpShard(SimpleHttpClient& client, DumpFile& file,
+                           std::string const& DBserver,
+                           std::string const& name, uint64_t batchId,
+                           std::string& errorMsg) {
   std::string const baseUrl = "/_api/replication/dump?DBserver=" + DBserver +
-                              "&batchId=" + StringUtils::itoa(_batchId) +
+                              "&batchId=" + StringUtils::itoa(batchId) +
                               "&collection=" + name + "&chunkSize=" +
                               StringUtils::itoa(_chunkSize) + "&ticks=false";
 
@@ -700,11 +742,11 @@ int DumpFeature::dumpShard(int fd, std::string const& DBserver,
     _stats._totalBatches++;
 
     std::unique_ptr<SimpleHttpResult> response(
-        _httpClient->request(rest::RequestType::GET, url, nullptr, 0));
+        client.request(rest::RequestType::GET, url, nullptr, 0));
 
     if (response == nullptr || !response->isComplete()) {
       errorMsg =
-          "got invalid response from server: " + _httpClient->getErrorMessage();
+          "got invalid response from server: " + client.getErrorMessage();
 
       return TRI_ERROR_INTERNAL;
     }
@@ -753,7 +795,12 @@ int DumpFeature::dumpShard(int fd, std::string const& DBserver,
     if (res == TRI_ERROR_NO_ERROR) {
       StringBuffer const& body = response->getBody();
 
-      if (!TRI_WritePointer(fd, body.c_str(), body.length())) {
+      // the shards of a collection share its data file. a chunk only
+      // contains complete lines, so chunks of different shards may follow
+      // each other in any order
+      MUTEX_LOCKER(locker, file.mutex);
+
+      if (!TRI_WritePointer(file.fd, body.c_str(), body.length())) {
         res = TRI_ERROR_CANNOT_WRITE_FILE;
       } else {
         _stats._totalWritten += (uint64_t)body.length();
@@ -830,6 +877,10 @@ int DumpFeature::runClusterDump(std::string& errorMsg) {
     restrictList.insert(std::pair<std::string, bool>(_collections[i], true));
   }
 
+  // the shards are dumped after all structure files have been written
+  std::vector<DumpJob> jobs;
+  std::vector<std::pair<std::string, std::shared_ptr<DumpFile>>> files;
+
   // iterate over collections
   for (auto const& collection : VPackArrayIterator(collections)) {
     if (!collection.isObject()) {
@@ -955,6 +1006,9 @@ int DumpFeature::runClusterDump(std::string& errorMsg) {
         return TRI_ERROR_CANNOT_WRITE_FILE;
       }
 
+      auto file = std::make_shared<DumpFile>(fd);
+      files.emplace_back(fileName, file);
+
       // First we have to go through all the shards, what are they?
       VPackSlice const shards = parameters.get("shards");
 
@@ -966,7 +1020,6 @@ int DumpFeature::runClusterDump(std::string& errorMsg) {
 
         if (!it.value.isArray() || it.value.length() == 0 ||
             !it.value[0].isString()) {
-          TRI_TRACKED_CLOSE_FILE(fd);
           errorMsg = "unexpected value for 'shards' attribute";
 
           return TRI_ERROR_BAD_PARAMETER;
@@ -974,38 +1027,126 @@ int DumpFeature::runClusterDump(std::string& errorMsg) {
 
         std::string DBserver = it.value[0].copyString();
 
-        if (_progress) {
-          std::cout << "# Dumping shard '" << shardName << "' from DBserver '"
-                    << DBserver << "' ..." << std::endl;
-        }
-        res = startBatch(DBserver, errorMsg);
-        if (res != TRI_ERROR_NO_ERROR) {
-          TRI_TRACKED_CLOSE_FILE(fd);
-          return res;
-        }
-        res = dumpShard(fd, DBserver, shardName, errorMsg);
-        if (res != TRI_ERROR_NO_ERROR) {
-          TRI_TRACKED_CLOSE_FILE(fd);
+        jobs.emplace_back([this, file, shardName, DBserver](
+            SimpleHttpClient& client, std::string& msg) -> int {
+          if (_progress) {
+            std::string const line = "# Dumping shard '" + shardName +
+                                     "' from DBserver '" + DBserver +
+                                     "' ...\n";
+            std::cout << line << std::flush;
+          }
+
+          uint64_t batchId = 0;
+          int res = startBatch(client, DBserver, batchId, msg);
+
+          if (res != TRI_ERROR_NO_ERROR || batchId == 0) {
+            return res;
+          }
+
+          res = dumpShard(client, *file, DBserver, shardName, batchId, msg);
+          endBatch(client, DBserver, batchId);
+
           return res;
-        }
-        endBatch(DBserver);
+        });
       }
+    }
+  }
 
-      res = TRI_TRACKED_CLOSE_FILE(fd);
+  res = runJobs(jobs, errorMsg);
 
-      if (res != TRI_ERROR_NO_ERROR) {
-        if (errorMsg.empty()) {
-          errorMsg = "cannot write to file '" + fileName + "'";
-        }
+  for (auto& it : files) {
+    int closeRes = TRI_TRACKED_CLOSE_FILE(it.second->fd);
+    it.second->fd = -1;
+
+    if (res == TRI_ERROR_NO_ERROR && closeRes != TRI_ERROR_NO_ERROR) {
+      errorMsg = "cannot write to file '" + it.first + "'";
+      res = closeRes;
+    }
+  }
 
+  return res;
+}
+
+// run the dump jobs, on up to _threadCount connections at the same time
+int DumpFeature::runJobs(std::vector<DumpJob> const& jobs,
+                         std::string& errorMsg) {
+  size_t const threadCount =
+      (std::min)(static_cast<size_t>(_threadCount), jobs.size());
+
+  if (threadCount <= 1) {
+    for (auto const& job : jobs) {
+      int res = job(*_httpClient, errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
         return res;
       }
     }
+
+    return TRI_ERROR_NO_ERROR;
   }
 
-  return TRI_ERROR_NO_ERROR;
+  // a SimpleHttpClient must not be shared between threads, so every thread
+  // but the first one gets its own connection
+  std::vector<std::unique_ptr<SimpleHttpClient>> clients;
+  for (size_t i = 1; i < threadCount; ++i) {
+    clients.emplace_back(createClient());
+  }
+
+  // jobs are handed out one at a time, so a few large collections do not
+  // keep all others waiting
+  std::atomic<size_t> next(0);
+  std::atomic<bool> failed(false);
+  Mutex resultMutex;
+  int result = TRI_ERROR_NO_ERROR;
+
+  auto work = [&](SimpleHttpClient& client) {
+    while (!failed.load()) {
+      size_t current = next++;
+      if (current >= jobs.size()) {
+        break;
+      }
+
+      std::string msg;
+      int res;
+      try {
+        res = jobs[current](client, msg);
+      } catch (basics::Exception const& ex) {
+        res = ex.code();
+        msg = ex.what();
+      } catch (std::exception const& ex) {
+        res = TRI_ERROR_INTERNAL;
+        msg = ex.what();
+      }
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        failed = true;
+        MUTEX_LOCKER(locker, resultMutex);
+        if (result == TRI_ERROR_NO_ERROR) {
+          result = res;
+          errorMsg = msg;
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(clients.size());
+  for (auto& client : clients) {
+    SimpleHttpClient* c = client.get();
+    threads.emplace_back([&work, c]() { work(*c); });
+  }
+
+  work(*_httpClient);
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return result;
 }
 
+
+
 void DumpFeature::start() {
   ClientFeature* client =
       application_features::ApplicationServer::getFeature<ClientFeature>(
@@ -1015,7 +1156,7 @@ void DumpFeature::start() {
   *_result = ret;
 
   try {
-    _httpClient = client->createHttpClient();
+    _httpClient = createClient();
   } catch (...) {
     LOG_TOPIC(FATAL, arangodb::Logger::FIXME)
         << "cannot create server connection, giving up!";
@@ -1024,10 +1165,6 @@ void DumpFeature::start() {
 
   std::string dbName = client->databaseName();
 
-  _httpClient->params().setLocationRewriter(static_cast<void*>(client),
-                                   &rewriteLocation);
-  _httpClient->params().setUserNamePassword("/", client->username(), client->password());
-
   std::string const versionString = _httpClient->getServerVersion();
 
   if (!_httpClient->isConnected()) {
@@ -1092,7 +1229,7 @@ void DumpFeature::start() {
 
   try {
     if (!_clusterMode) {
-      res = startBatch("", errorMsg);
+      res = startBatch(*_httpClient, "", _batchId, errorMsg);
 
       if (res != TRI_ERROR_NO_ERROR && _force) {
         res = TRI_ERROR_NO_ERROR;
@@ -1103,7 +1240,7 @@ void DumpFeature::start() {
       }
 
       if (_batchId > 0) {
-        endBatch("");
+        endBatch(*_httpClient, "", _batchId);
       }
     } else {
       res = runClusterDump(errorMsg);
@@ -24,10 +24,12 @@
 #define ARANGODB_DUMP_DUMP_FEATURE_H 1
 
 #include "ApplicationFeatures/ApplicationFeature.h"
+#include "Basics/Mutex.h"
 #include "V8Client/ArangoClientHelper.h"
 
 namespace arangodb {
 namespace httpclient {
+class SimpleHttpClient;
 class SimpleHttpResult;
 }
 
@@ -57,19 +59,40 @@ class DumpFeature final : public application_features::ApplicationFeature,
   uint64_t _tickStart;
   uint64_t _tickEnd;
   bool _compat28;
+  uint32_t _threadCount;
 
  private:
-  int startBatch(std::string DBserver, std::string& errorMsg);
-  void extendBatch(std::string DBserver);
-  void endBatch(std::string DBserver);
-  int dumpCollection(int fd, std::string const& collectionId,
-                     std::string const& name, uint64_t maxTick,
-                     std::string& errorMsg);
+  // a data file that is written to by several threads, one chunk at a time
+  struct DumpFile {
+    explicit DumpFile(int fd) : fd(fd) {}
+    ~DumpFile();
+
+    int fd;
+    Mutex mutex;
+  };
+
+  // dumps one collection or shard, using the given connection
+  typedef std::function<int(httpclient::SimpleHttpClient&, std::string&)>
+      DumpJob;
+
+ private:
+  std::unique_ptr<httpclient::SimpleHttpClient> createClient();
+  int startBatch(httpclient::SimpleHttpClient& client, std::string DBserver,
+                 uint64_t& batchId, std::string& errorMsg);
+  void extendBatch(httpclient::SimpleHttpClient& client, std::string DBserver,
+                   uint64_t batchId);
+  void endBatch(httpclient::SimpleHttpClient& client, std::string DBserver,
+                uint64_t& batchId);
+  int dumpCollection(httpclient::SimpleHttpClient& client, int fd,
+                     std::string const& collectionId, std::string const& name,
+                     uint64_t maxTick, std::string& errorMsg);
   void flushWal();
   int runDump(std::string& dbName, std::string& errorMsg);
-  int dumpShard(int fd, std::string const& DBserver, std::string const& name,
-                std::string& errorMsg);
+  int dumpShard(httpclient::SimpleHttpClient& client, DumpFile& file,
+                std::string const& DBserver, std::string const& name,
+                uint64_t batchId, std::string& errorMsg);
   int runClusterDump(std::string& errorMsg);
+  int runJobs(std::vector<DumpJob> const& jobs, std::string& errorMsg);
 
  private:
   int* _result;
@@ -80,11 +103,11 @@ class DumpFeature final : public application_features::ApplicationFeature,
   // cluster mode flag
   bool _clusterMode;
 
-  // statistics
+  // statistics, updated by all dump threads
   struct {
-    uint64_t _totalBatches;
-    uint64_t _totalCollections;
-    uint64_t _totalWritten;
+    std::atomic<uint64_t> _totalBatches{0};
+    std::atomic<uint64_t> _totalCollections{0};
+    std::atomic<uint64_t> _totalWritten{0};
   } _stats;
 };
 }
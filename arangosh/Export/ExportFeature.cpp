@@ -24,6 +24,7 @@
 
 #include "ApplicationFeatures/ApplicationServer.h"
 #include "Basics/FileUtils.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/OpenFilesTracker.h"
 #include "Basics/StringUtils.h"
 #include "Logger/Logger.h"
@@ -37,6 +38,8 @@
 #include <boost/property_tree/detail/xml_parser_utils.hpp>
 #include <regex>
 #include <iostream>
+#include <thread>
+#include <zlib.h>
 
 using namespace arangodb;
 using namespace arangodb::basics;
@@ -44,6 +47,127 @@ using namespace arangodb::httpclient;
 using namespace arangodb::options;
 using namespace boost::property_tree::xml_parser;
 
+namespace arangodb {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an output file of the export. writes are collected in a buffer and
+/// only written out in large blocks, optionally gzip compressed
+////////////////////////////////////////////////////////////////////////////////
+
+class ExportFile {
+ public:
+  static constexpr size_t BufferSize = 1024 * 1024;
+
+  ExportFile(std::string const& fileName, bool compress)
+      : _fileName(fileName), _fd(-1), _compress(compress), firstLine(true) {
+    // remove an existing file first
+    if (TRI_ExistsFile(fileName.c_str())) {
+      TRI_UnlinkFile(fileName.c_str());
+    }
+
+    _fd = TRI_TRACKED_CREATE_FILE(fileName.c_str(),
+                                  O_CREAT | O_EXCL | O_RDWR | TRI_O_CLOEXEC,
+                                  S_IRUSR | S_IWUSR);
+
+    if (_fd < 0) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CANNOT_WRITE_FILE,
+                                     "cannot write to file '" + fileName + "'");
+    }
+
+    if (_compress) {
+      memset(&_zstream, 0, sizeof(_zstream));
+      // 15 + 16: default window size, gzip header and trailer
+      if (deflateInit2(&_zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16,
+                       8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        TRI_TRACKED_CLOSE_FILE(_fd);
+        THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_OUT_OF_MEMORY,
+                                       "cannot initialize compression");
+      }
+    }
+
+    _buffer.reserve(BufferSize);
+  }
+
+  ~ExportFile() {
+    if (_fd >= 0) {
+      if (_compress) {
+        deflateEnd(&_zstream);
+      }
+      TRI_TRACKED_CLOSE_FILE(_fd);
+    }
+  }
+
+  ExportFile(ExportFile const&) = delete;
+  ExportFile& operator=(ExportFile const&) = delete;
+
+  void write(std::string const& data) {
+    _buffer.append(data);
+
+    if (_buffer.size() >= BufferSize) {
+      flush(false);
+    }
+  }
+
+  /// @brief writes out all buffered data and closes the file
+  void close() {
+    flush(true);
+
+    if (_compress) {
+      deflateEnd(&_zstream);
+    }
+    TRI_TRACKED_CLOSE_FILE(_fd);
+    _fd = -1;
+  }
+
+ private:
+  void flush(bool finish) {
+    if (!_compress) {
+      writeOut(_buffer.data(), _buffer.size());
+      _buffer.clear();
+      return;
+    }
+
+    char out[64 * 1024];
+    _zstream.next_in = reinterpret_cast<Bytef*>(&_buffer[0]);
+    _zstream.avail_in = static_cast<uInt>(_buffer.size());
+
+    int res;
+    do {
+      _zstream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+      _zstream.avail_out = sizeof(out);
+      res = deflate(&_zstream, finish ? Z_FINISH : Z_NO_FLUSH);
+
+      if (res == Z_STREAM_ERROR) {
+        THROW_ARANGO_EXCEPTION_MESSAGE(
+            TRI_ERROR_INTERNAL, "cannot compress data for '" + _fileName + "'");
+      }
+      writeOut(out, sizeof(out) - _zstream.avail_out);
+    } while (_zstream.avail_out == 0 || (finish && res != Z_STREAM_END));
+
+    _buffer.clear();
+  }
+
+  void writeOut(char const* data, size_t length) {
+    if (length > 0 && !TRI_WritePointer(_fd, data, length)) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CANNOT_WRITE_FILE,
+                                     "cannot write to file '" + _fileName + "'");
+    }
+  }
+
+ private:
+  std::string const _fileName;
+  int _fd;
+  bool const _compress;
+  z_stream _zstream;
+  std::string _buffer;
+
+ public:
+  /// @brief whether no document was written to the file yet
+  bool firstLine;
+};
+
+}
+
 ExportFeature::ExportFeature(application_features::ApplicationServer* server,
                              int* result)
     : ApplicationFeature(server, "Export"),
@@ -57,10 +181,10 @@ ExportFeature::ExportFeature(application_features::ApplicationServer* server,
       _outputDirectory(),
       _overwrite(false),
       _progress(true),
-      _firstLine(true),
+      _compressOutput(false),
+      _threadCount(2),
       _skippedDeepNested(0),
       _httpRequestsDone(0),
-      _currentCollection(),
       _currentGraph(),
       _result(result) {
   requiresElevatedPrivileges(false);
@@ -102,6 +226,14 @@ void ExportFeature::collectOptions(
   options->addOption("--progress", "show progress",
                      new BooleanParameter(&_progress));
 
+  options->addOption("--threads",
+                     "number of collections to export in parallel",
+                     new UInt32Parameter(&_threadCount));
+
+  options->addOption("--compress-output",
+                     "compress the output files with gzip",
+                     new BooleanParameter(&_compressOutput));
+
   options->addOption("--fields",
                      "comma separated list of fileds to export into a csv file",
                      new StringParameter(&_csvFieldOptions));
@@ -169,6 +301,16 @@ void ExportFeature::validateOptions(
 
     boost::split(_csvFields, _csvFieldOptions, boost::is_any_of(","));
   }
+
+  if (_threadCount < 1) {
+    LOG_TOPIC(WARN, Logger::CONFIG) << "capping --threads value to " << 1;
+    _threadCount = 1;
+  }
+  if (_threadCount > TRI_numberProcessors()) {
+    LOG_TOPIC(WARN, Logger::CONFIG) << "capping --threads value to "
+                                    << TRI_numberProcessors();
+    _threadCount = static_cast<uint32_t>(TRI_numberProcessors());
+  }
 }
 
 void ExportFeature::prepare() {
@@ -230,16 +372,13 @@ void ExportFeature::start() {
   std::unique_ptr<SimpleHttpClient> httpClient;
 
   try {
-    httpClient = client->createHttpClient();
+    httpClient = createHttpClient(client);
   } catch (...) {
     LOG_TOPIC(FATAL, Logger::COMMUNICATION)
         << "cannot create server connection, giving up!";
     FATAL_ERROR_EXIT();
   }
 
-  httpClient->params().setLocationRewriter(static_cast<void*>(client), &rewriteLocation);
-  httpClient->params().setUserNamePassword("/", client->username(), client->password());
-
   // must stay here in order to establish the connection
   httpClient->getServerVersion();
 
@@ -265,11 +404,10 @@ void ExportFeature::start() {
   if (_typeExport == "json" || _typeExport == "jsonl" || _typeExport == "xml" ||
       _typeExport == "csv") {
     if (_collections.size()) {
-      collectionExport(httpClient.get());
+      collectionExport(client, httpClient.get());
 
       for (auto const& collection : _collections) {
-        std::string filePath = _outputDirectory + TRI_DIR_SEPARATOR_STR +
-                               collection + "." + _typeExport;
+        std::string filePath = outputFileName(collection);
         int64_t fileSize = TRI_SizeFile(filePath.c_str());
 
         if (0 < fileSize) {
@@ -279,13 +417,12 @@ void ExportFeature::start() {
     } else if (!_query.empty()) {
       queryExport(httpClient.get());
         
-      std::string filePath = _outputDirectory + TRI_DIR_SEPARATOR_STR + "query." + _typeExport;
+      std::string filePath = outputFileName("query");
       exportedSize += TRI_SizeFile(filePath.c_str());
     }
   } else if (_typeExport == "xgmml" && _graphName.size()) {
     graphExport(httpClient.get());
-    std::string filePath = _outputDirectory + TRI_DIR_SEPARATOR_STR +
-                           _graphName + "." + _typeExport;
+    std::string filePath = outputFileName(_graphName);
     int64_t fileSize = TRI_SizeFile(filePath.c_str());
 
     if (0 < fileSize) {
@@ -300,134 +437,195 @@ void ExportFeature::start() {
   *_result = ret;
 }
 
-void ExportFeature::collectionExport(SimpleHttpClient* httpClient) {
-  std::string errorMsg;
-
-  for (auto const& collection : _collections) {
-    if (_progress) {
-      std::cout << "# Exporting collection '" << collection << "'..."
-                << std::endl;
-    }
+std::unique_ptr<SimpleHttpClient> ExportFeature::createHttpClient(
+    ClientFeature* client) {
+  std::unique_ptr<SimpleHttpClient> httpClient = client->createHttpClient();
 
-    _currentCollection = collection;
-
-    std::string fileName = _outputDirectory + TRI_DIR_SEPARATOR_STR +
-                           collection + "." + _typeExport;
+  httpClient->params().setLocationRewriter(static_cast<void*>(client), &rewriteLocation);
+  httpClient->params().setUserNamePassword("/", client->username(), client->password());
 
-    // remove an existing file first
-    if (TRI_ExistsFile(fileName.c_str())) {
-      TRI_UnlinkFile(fileName.c_str());
-    }
+  return httpClient;
+}
 
-    std::string const url = "_api/cursor";
+std::string ExportFeature::outputFileName(std::string const& name) const {
+  std::string fileName =
+      _outputDirectory + TRI_DIR_SEPARATOR_STR + name + "." + _typeExport;
 
-    VPackBuilder post;
-    post.openObject();
-    post.add("query", VPackValue("FOR doc IN @@collection RETURN doc"));
-    post.add("bindVars", VPackValue(VPackValueType::Object));
-    post.add("@collection", VPackValue(collection));
-    post.close();
-    post.close();
+  if (_compressOutput) {
+    fileName.append(".gz");
+  }
 
-    std::shared_ptr<VPackBuilder> parsedBody =
-        httpCall(httpClient, url, rest::RequestType::POST, post.toJson());
-    VPackSlice body = parsedBody->slice();
+  return fileName;
+}
 
-    int fd =
-        TRI_TRACKED_CREATE_FILE(fileName.c_str(), O_CREAT | O_EXCL | O_RDWR | TRI_O_CLOEXEC,
-                   S_IRUSR | S_IWUSR);
+void ExportFeature::collectionExport(ClientFeature* client,
+                                     SimpleHttpClient* httpClient) {
+  size_t const numThreads =
+      (std::min)(static_cast<size_t>(_threadCount), _collections.size());
 
-    if (fd < 0) {
-      errorMsg = "cannot write to file '" + fileName + "'";
-      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CANNOT_WRITE_FILE, errorMsg);
+  if (numThreads <= 1) {
+    for (auto const& collection : _collections) {
+      exportCollection(httpClient, collection);
     }
+    return;
+  }
 
-    TRI_DEFER(TRI_TRACKED_CLOSE_FILE(fd));
-
-    writeFirstLine(fd, fileName, collection);
+  // every thread has its own connection and takes the next collection
+  // that is not yet exported
+  std::atomic<size_t> next(0);
+  Mutex errorMutex;
+  std::exception_ptr error;
 
-    writeBatch(fd, VPackArrayIterator(body.get("result")), fileName);
+  auto work = [&](SimpleHttpClient* httpClient) {
+    while (true) {
+      size_t const i = next++;
 
-    while (body.hasKey("id")) {
-      std::string const url = "/_api/cursor/" + body.get("id").copyString();
-      parsedBody = httpCall(httpClient, url, rest::RequestType::PUT);
-      body = parsedBody->slice();
+      if (i >= _collections.size()) {
+        return;
+      }
 
-      writeBatch(fd, VPackArrayIterator(body.get("result")), fileName);
+      try {
+        exportCollection(httpClient, _collections[i]);
+      } catch (...) {
+        MUTEX_LOCKER(guard, errorMutex);
+        if (error == nullptr) {
+          error = std::current_exception();
+        }
+        // let the other threads stop early
+        next = _collections.size();
+        return;
+      }
     }
+  };
 
-    if (_typeExport == "json") {
-      std::string closingBracket = "\n]";
-      writeToFile(fd, closingBracket, fileName);
-    } else if (_typeExport == "xml") {
-      std::string xmlFooter = "</collection>";
-      writeToFile(fd, xmlFooter, fileName);
-    }
+  std::vector<std::unique_ptr<SimpleHttpClient>> httpClients;
+  for (size_t i = 1; i < numThreads; ++i) {
+    httpClients.emplace_back(createHttpClient(client));
   }
-}
 
-void ExportFeature::queryExport(SimpleHttpClient* httpClient) {
-  std::string errorMsg;
-
-  if (_progress) {
-    std::cout << "# Running AQL query '" << _query << "'..." << std::endl;
+  std::vector<std::thread> threads;
+  threads.reserve(httpClients.size());
+  for (auto& c : httpClients) {
+    threads.emplace_back(work, c.get());
   }
 
-  std::string fileName = _outputDirectory + TRI_DIR_SEPARATOR_STR + "query." + _typeExport;
+  work(httpClient);
 
-  // remove an existing file first
-  if (TRI_ExistsFile(fileName.c_str())) {
-    TRI_UnlinkFile(fileName.c_str());
+  for (auto& t : threads) {
+    t.join();
   }
 
-  std::string const url = "_api/cursor";
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+void ExportFeature::exportCollection(SimpleHttpClient* httpClient,
+                                     std::string const& collection) {
+  if (_progress) {
+    std::cout << "# Exporting collection '" << collection << "'..."
+              << std::endl;
+  }
 
   VPackBuilder post;
   post.openObject();
-  post.add("query", VPackValue(_query));
+  post.add("query", VPackValue("FOR doc IN @@collection RETURN doc"));
+  post.add("bindVars", VPackValue(VPackValueType::Object));
+  post.add("@collection", VPackValue(collection));
+  post.close();
   post.close();
 
-  std::shared_ptr<VPackBuilder> parsedBody =
-      httpCall(httpClient, url, rest::RequestType::POST, post.toJson());
-  VPackSlice body = parsedBody->slice();
+  ExportFile file(outputFileName(collection), _compressOutput);
+
+  writeFirstLine(file, collection);
 
-  int fd =
-      TRI_TRACKED_CREATE_FILE(fileName.c_str(), O_CREAT | O_EXCL | O_RDWR | TRI_O_CLOEXEC,
-                  S_IRUSR | S_IWUSR);
+  exportCursor(httpClient, post, file, collection, false);
 
-  if (fd < 0) {
-    errorMsg = "cannot write to file '" + fileName + "'";
-    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CANNOT_WRITE_FILE, errorMsg);
+  if (_typeExport == "json") {
+    std::string closingBracket = "\n]";
+    writeToFile(file, closingBracket);
+  } else if (_typeExport == "xml") {
+    std::string xmlFooter = "</collection>";
+    writeToFile(file, xmlFooter);
   }
 
-  TRI_DEFER(TRI_TRACKED_CLOSE_FILE(fd));
+  file.close();
+}
 
-  writeFirstLine(fd, fileName, "");
+void ExportFeature::queryExport(SimpleHttpClient* httpClient) {
+  if (_progress) {
+    std::cout << "# Running AQL query '" << _query << "'..." << std::endl;
+  }
 
-  writeBatch(fd, VPackArrayIterator(body.get("result")), fileName);
+  VPackBuilder post;
+  post.openObject();
+  post.add("query", VPackValue(_query));
+  post.close();
 
-  while (body.hasKey("id")) {
-    std::string const url = "/_api/cursor/" + body.get("id").copyString();
-    parsedBody = httpCall(httpClient, url, rest::RequestType::PUT);
-    body = parsedBody->slice();
+  ExportFile file(outputFileName("query"), _compressOutput);
 
-    writeBatch(fd, VPackArrayIterator(body.get("result")), fileName);
-  }
+  writeFirstLine(file, "");
+
+  exportCursor(httpClient, post, file, "", false);
 
   if (_typeExport == "json") {
     std::string closingBracket = "\n]";
-    writeToFile(fd, closingBracket, fileName);
+    writeToFile(file, closingBracket);
   } else if (_typeExport == "xml") {
     std::string xmlFooter = "</collection>";
-    writeToFile(fd, xmlFooter, fileName);
+    writeToFile(file, xmlFooter);
   }
+
+  file.close();
 }
 
-void ExportFeature::writeFirstLine(int fd, std::string const& fileName, std::string const& collection) {
-  _firstLine = true;
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs the query in post and writes all its results to the file. the
+/// cursor is a streaming one, so the server only produces one batch at a
+/// time instead of the whole result
+////////////////////////////////////////////////////////////////////////////////
+
+void ExportFeature::exportCursor(SimpleHttpClient* httpClient,
+                                 VPackBuilder const& post, ExportFile& file,
+                                 std::string const& collection, bool graph) {
+  VPackBuilder body;
+  body.openObject();
+  for (auto const& it : VPackObjectIterator(post.slice())) {
+    body.add(it.key.copyString(), it.value);
+  }
+  body.add("batchSize", VPackValue(1000));
+  body.add("options", VPackValue(VPackValueType::Object));
+  body.add("stream", VPackValue(true));
+  body.close();
+  body.close();
+
+  std::shared_ptr<VPackBuilder> parsedBody =
+      httpCall(httpClient, "_api/cursor", rest::RequestType::POST,
+               body.toJson(), collection);
+  VPackSlice result = parsedBody->slice();
+
+  while (true) {
+    if (graph) {
+      writeGraphBatch(file, VPackArrayIterator(result.get("result")));
+    } else {
+      writeBatch(file, VPackArrayIterator(result.get("result")));
+    }
+
+    if (!result.hasKey("id")) {
+      break;
+    }
+
+    std::string const url = "/_api/cursor/" + result.get("id").copyString();
+    parsedBody = httpCall(httpClient, url, rest::RequestType::PUT, "", collection);
+    result = parsedBody->slice();
+  }
+}
+
+void ExportFeature::writeFirstLine(ExportFile& file, std::string const& collection) {
+  file.firstLine = true;
   if (_typeExport == "json") {
     std::string openingBracket = "[";
-    writeToFile(fd, openingBracket, fileName);
+    writeToFile(file, openingBracket);
 
   } else if (_typeExport == "xml") {
     std::string xmlHeader =
@@ -435,7 +633,7 @@ void ExportFeature::writeFirstLine(int fd, std::string const& fileName, std::str
         "<collection name=\"";
     xmlHeader.append(encode_char_entities(collection));
     xmlHeader.append("\">\n");
-    writeToFile(fd, xmlHeader, fileName);
+    writeToFile(file, xmlHeader);
 
   } else if (_typeExport == "csv") {
     std::string firstLine = "";
@@ -449,11 +647,11 @@ void ExportFeature::writeFirstLine(int fd, std::string const& fileName, std::str
       }
     }
     firstLine += "\n";
-    writeToFile(fd, firstLine, fileName);
+    writeToFile(file, firstLine);
   }
 }
 
-void ExportFeature::writeBatch(int fd, VPackArrayIterator it, std::string const& fileName) {
+void ExportFeature::writeBatch(ExportFile& file, VPackArrayIterator it) {
   std::string line;
   line.reserve(1024);
 
@@ -462,19 +660,19 @@ void ExportFeature::writeBatch(int fd, VPackArrayIterator it, std::string const&
       line.clear();
       line += doc.toJson();
       line.push_back('\n');
-      writeToFile(fd, line, fileName);
+      writeToFile(file, line);
     }
   } else if (_typeExport == "json") {
     for (auto const& doc : it) {
       line.clear();
-      if (!_firstLine) {
+      if (!file.firstLine) {
         line.append(",\n  ", 4);
       } else {
         line.append("\n  ", 3);
-        _firstLine = false;
+        file.firstLine = false;
       }
       line += doc.toJson();
-      writeToFile(fd, line, fileName);
+      writeToFile(file, line);
     }
   } else if (_typeExport == "csv") {
     for (auto const& doc : it) {
@@ -514,7 +712,7 @@ void ExportFeature::writeBatch(int fd, VPackArrayIterator it, std::string const&
         line.append(value);
       }
       line.append("\n");
-      writeToFile(fd, line, fileName);
+      writeToFile(file, line);
     }
   } else if (_typeExport == "xml") {
     for (auto const& doc : it) {
@@ -522,28 +720,25 @@ void ExportFeature::writeBatch(int fd, VPackArrayIterator it, std::string const&
       line.append("<doc key=\"");
       line.append(encode_char_entities(doc.get("_key").copyString()));
       line.append("\">\n");
-      writeToFile(fd, line, fileName);
+      writeToFile(file, line);
       for (auto const& att : VPackObjectIterator(doc)) {
-        xgmmlWriteOneAtt(fd, fileName, att.value, att.key.copyString(), 2);
+        xgmmlWriteOneAtt(file, att.value, att.key.copyString(), 2);
       }
       line.clear();
       line.append("</doc>\n");
-      writeToFile(fd, line, fileName);
+      writeToFile(file, line);
     }
   }
 }
 
-void ExportFeature::writeToFile(int fd, std::string const& line,
-                                std::string const& fileName) {
-  if (!TRI_WritePointer(fd, line.c_str(), line.size())) {
-    std::string errorMsg = "cannot write to file '" + fileName + "'";
-    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CANNOT_WRITE_FILE, errorMsg);
-  }
+void ExportFeature::writeToFile(ExportFile& file, std::string const& line) {
+  file.write(line);
 }
 
 std::shared_ptr<VPackBuilder> ExportFeature::httpCall(
     SimpleHttpClient* httpClient, std::string const& url,
-    rest::RequestType requestType, std::string postBody) {
+    rest::RequestType requestType, std::string postBody,
+    std::string const& collection) {
   std::string errorMsg;
 
   std::unique_ptr<SimpleHttpResult> response(
@@ -563,8 +758,8 @@ std::shared_ptr<VPackBuilder> ExportFeature::httpCall(
       if (_currentGraph.size()) {
         LOG_TOPIC(FATAL, Logger::CONFIG) << "Graph '" << _currentGraph
                                          << "' not found.";
-      } else if (_currentCollection.size()) {
-        LOG_TOPIC(FATAL, Logger::CONFIG) << "Collection " << _currentCollection
+      } else if (collection.size()) {
+        LOG_TOPIC(FATAL, Logger::CONFIG) << "Collection " << collection
                                          << " not found.";
       }
 
@@ -637,35 +832,19 @@ void ExportFeature::graphExport(SimpleHttpClient* httpClient) {
     }
   }
 
-  std::string fileName =
-      _outputDirectory + TRI_DIR_SEPARATOR_STR + _graphName + "." + _typeExport;
-
-  // remove an existing file first
-  if (TRI_ExistsFile(fileName.c_str())) {
-    TRI_UnlinkFile(fileName.c_str());
-  }
-
-  int fd =
-      TRI_TRACKED_CREATE_FILE(fileName.c_str(), O_CREAT | O_EXCL | O_RDWR | TRI_O_CLOEXEC,
-                 S_IRUSR | S_IWUSR);
-
-  if (fd < 0) {
-    errorMsg = "cannot write to file '" + fileName + "'";
-    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CANNOT_WRITE_FILE, errorMsg);
-  }
-  TRI_DEFER(TRI_TRACKED_CLOSE_FILE(fd));
+  ExportFile file(outputFileName(_graphName), _compressOutput);
 
   std::string xmlHeader =
       R"(<?xml version="1.0" encoding="UTF-8" standalone="yes"?>
 <graph label=")";
-  writeToFile(fd, xmlHeader, fileName);
-  writeToFile(fd, _graphName, fileName);
+  writeToFile(file, xmlHeader);
+  writeToFile(file, _graphName);
 
   xmlHeader = R"(" 
 xmlns="http://www.cs.rpi.edu/XGMML" 
 directed="1">
 )";
-  writeToFile(fd, xmlHeader, fileName);
+  writeToFile(file, xmlHeader);
 
   for (auto const& collection : _collections) {
     if (_progress) {
@@ -673,8 +852,6 @@ directed="1">
                 << std::endl;
     }
 
-    std::string const url = "_api/cursor";
-
     VPackBuilder post;
     post.openObject();
     post.add("query", VPackValue("FOR doc IN @@collection RETURN doc"));
@@ -683,22 +860,12 @@ directed="1">
     post.close();
     post.close();
 
-    std::shared_ptr<VPackBuilder> parsedBody =
-        httpCall(httpClient, url, rest::RequestType::POST, post.toJson());
-    VPackSlice body = parsedBody->slice();
-
-    writeGraphBatch(fd, VPackArrayIterator(body.get("result")), fileName);
-
-    while (body.hasKey("id")) {
-      std::string const url = "/_api/cursor/" + body.get("id").copyString();
-      parsedBody = httpCall(httpClient, url, rest::RequestType::PUT);
-      body = parsedBody->slice();
-
-      writeGraphBatch(fd, VPackArrayIterator(body.get("result")), fileName);
-    }
+    exportCursor(httpClient, post, file, collection, true);
   }
   std::string closingGraphTag = "</graph>\n";
-  writeToFile(fd, closingGraphTag, fileName);
+  writeToFile(file, closingGraphTag);
+
+  file.close();
 
   if (_skippedDeepNested) {
     std::cout << "skipped " << _skippedDeepNested
@@ -706,8 +873,7 @@ directed="1">
   }
 }
 
-void ExportFeature::writeGraphBatch(int fd, VPackArrayIterator it,
-                                    std::string const& fileName) {
+void ExportFeature::writeGraphBatch(ExportFile& file, VPackArrayIterator it) {
   std::string xmlTag;
 
   for (auto const& doc : it) {
@@ -721,21 +887,21 @@ void ExportFeature::writeGraphBatch(int fd, VPackArrayIterator it,
           "\" source=\"" + encode_char_entities(doc.get("_from").copyString()) +
           "\" target=\"" + encode_char_entities(doc.get("_to").copyString()) +
           "\"";
-      writeToFile(fd, xmlTag, fileName);
+      writeToFile(file, xmlTag);
       if (!_xgmmlLabelOnly) {
         xmlTag = ">\n";
-        writeToFile(fd, xmlTag, fileName);
+        writeToFile(file, xmlTag);
 
         for (auto const& it : VPackObjectIterator(doc)) {
-          xgmmlWriteOneAtt(fd, fileName, it.value, it.key.copyString());
+          xgmmlWriteOneAtt(file, it.value, it.key.copyString());
         }
 
         xmlTag = "</edge>\n";
-        writeToFile(fd, xmlTag, fileName);
+        writeToFile(file, xmlTag);
 
       } else {
         xmlTag = " />\n";
-        writeToFile(fd, xmlTag, fileName);
+        writeToFile(file, xmlTag);
       }
 
     } else {
@@ -746,28 +912,27 @@ void ExportFeature::writeGraphBatch(int fd, VPackArrayIterator it,
                                    ? doc.get(_xgmmlLabelAttribute).copyString()
                                    : "Default-Label") +
           "\" id=\"" + encode_char_entities(doc.get("_id").copyString()) + "\"";
-      writeToFile(fd, xmlTag, fileName);
+      writeToFile(file, xmlTag);
       if (!_xgmmlLabelOnly) {
         xmlTag = ">\n";
-        writeToFile(fd, xmlTag, fileName);
+        writeToFile(file, xmlTag);
 
         for (auto const& it : VPackObjectIterator(doc)) {
-          xgmmlWriteOneAtt(fd, fileName, it.value, it.key.copyString());
+          xgmmlWriteOneAtt(file, it.value, it.key.copyString());
         }
 
         xmlTag = "</node>\n";
-        writeToFile(fd, xmlTag, fileName);
+        writeToFile(file, xmlTag);
 
       } else {
         xmlTag = " />\n";
-        writeToFile(fd, xmlTag, fileName);
+        writeToFile(file, xmlTag);
       }
     }
   }
 }
 
-void ExportFeature::xgmmlWriteOneAtt(int fd, std::string const& fileName,
-                                     VPackSlice const& slice,
+void ExportFeature::xgmmlWriteOneAtt(ExportFile& file, VPackSlice const& slice,
                                      std::string const& name, int deep) {
   std::string value, type, xmlTag;
 
@@ -805,37 +970,37 @@ void ExportFeature::xgmmlWriteOneAtt(int fd, std::string const& fileName,
     xmlTag = "  <att name=\"" + encode_char_entities(name) +
              "\" type=\"string\" value=\"" +
              encode_char_entities(slice.toString()) + "\"/>\n";
-    writeToFile(fd, xmlTag, fileName);
+    writeToFile(file, xmlTag);
     return;
   }
 
   if (!type.empty()) {
     xmlTag = "  <att name=\"" + encode_char_entities(name) + "\" type=\"" +
              type + "\" value=\"" + encode_char_entities(value) + "\"/>\n";
-    writeToFile(fd, xmlTag, fileName);
+    writeToFile(file, xmlTag);
 
   } else if (slice.isArray()) {
     xmlTag =
         "  <att name=\"" + encode_char_entities(name) + "\" type=\"list\">\n";
-    writeToFile(fd, xmlTag, fileName);
+    writeToFile(file, xmlTag);
 
     for (auto const& val : VPackArrayIterator(slice)) {
-      xgmmlWriteOneAtt(fd, fileName, val, name, deep + 1);
+      xgmmlWriteOneAtt(file, val, name, deep + 1);
     }
 
     xmlTag = "  </att>\n";
-    writeToFile(fd, xmlTag, fileName);
+    writeToFile(file, xmlTag);
 
   } else if (slice.isObject()) {
     xmlTag =
         "  <att name=\"" + encode_char_entities(name) + "\" type=\"list\">\n";
-    writeToFile(fd, xmlTag, fileName);
+    writeToFile(file, xmlTag);
 
     for (auto const& it : VPackObjectIterator(slice)) {
-      xgmmlWriteOneAtt(fd, fileName, it.value, it.key.copyString(), deep + 1);
+      xgmmlWriteOneAtt(file, it.value, it.key.copyString(), deep + 1);
     }
 
     xmlTag = "  </att>\n";
-    writeToFile(fd, xmlTag, fileName);
+    writeToFile(file, xmlTag);
   }
 }
@@ -26,6 +26,8 @@
 #include "ApplicationFeatures/ApplicationFeature.h"
 #include "V8Client/ArangoClientHelper.h"
 #include "lib/Rest/CommonDefines.h"
+
+#include <atomic>
 #include <velocypack/Iterator.h>
 #include <velocypack/velocypack-aliases.h>
 
@@ -35,6 +37,8 @@ class GeneralClientConnection;
 class SimpleHttpClient;
 class SimpleHttpResult;
 }
+class ClientFeature;
+class ExportFile;
 
 class ExportFeature final : public application_features::ApplicationFeature,
                                public ArangoClientHelper {
@@ -50,16 +54,25 @@ class ExportFeature final : public application_features::ApplicationFeature,
   void start() override final;
 
  private:
-  void collectionExport(httpclient::SimpleHttpClient* httpClient);
+  std::unique_ptr<httpclient::SimpleHttpClient> createHttpClient(
+      ClientFeature* client);
+  void collectionExport(ClientFeature* client,
+                        httpclient::SimpleHttpClient* httpClient);
+  void exportCollection(httpclient::SimpleHttpClient* httpClient,
+                        std::string const& collection);
   void queryExport(httpclient::SimpleHttpClient* httpClient);
-  void writeFirstLine(int fd, std::string const& fileName, std::string const& collection);
-  void writeBatch(int fd, VPackArrayIterator it, std::string const& fileName);
+  void exportCursor(httpclient::SimpleHttpClient* httpClient,
+                    VPackBuilder const& post, ExportFile& file,
+                    std::string const& collection, bool graph);
+  std::string outputFileName(std::string const& name) const;
+  void writeFirstLine(ExportFile& file, std::string const& collection);
+  void writeBatch(ExportFile& file, VPackArrayIterator it);
   void graphExport(httpclient::SimpleHttpClient* httpClient);
-  void writeGraphBatch(int fd, VPackArrayIterator it, std::string const& fileName);
-  void xgmmlWriteOneAtt(int fd, std::string const& fileName, VPackSlice const& slice, std::string const& name, int deep = 0);
+  void writeGraphBatch(ExportFile& file, VPackArrayIterator it);
+  void xgmmlWriteOneAtt(ExportFile& file, VPackSlice const& slice, std::string const& name, int deep = 0);
 
-  void writeToFile(int fd, std::string const& string, std::string const& fileName);
-  std::shared_ptr<VPackBuilder> httpCall(httpclient::SimpleHttpClient* httpClient, std::string const& url, arangodb::rest::RequestType, std::string postBody = "");
+  void writeToFile(ExportFile& file, std::string const& string);
+  std::shared_ptr<VPackBuilder> httpCall(httpclient::SimpleHttpClient* httpClient, std::string const& url, arangodb::rest::RequestType, std::string postBody = "", std::string const& collection = "");
 
  private:
   std::vector<std::string> _collections;
@@ -74,11 +87,11 @@ class ExportFeature final : public application_features::ApplicationFeature,
   std::string _outputDirectory;
   bool _overwrite;
   bool _progress;
+  bool _compressOutput;
+  uint32_t _threadCount;
 
-  bool _firstLine;
   uint64_t _skippedDeepNested;
-  uint64_t _httpRequestsDone;
-  std::string _currentCollection;
+  std::atomic<uint64_t> _httpRequestsDone;
   std::string _currentGraph;
 
   int* _result;
@@ -55,6 +55,8 @@ ImportFeature::ImportFeature(application_features::ApplicationServer* server,
       _createCollectionType("document"),
       _typeImport("json"),
       _overwrite(false),
+      _bulkLoad(false),
+      _velocyPack(false),
       _quote("\""),
       _separator(""),
       _progress(true),
@@ -142,6 +144,20 @@ void ImportFeature::collectOptions(
       "from the collection)",
       new BooleanParameter(&_overwrite));
 
+  options->addOption(
+      "--bulk-load",
+      "let the server write the first chunk of data directly into data "
+      "files instead of going through its regular write path, if the "
+      "storage engine supports it. requires an empty collection that is "
+      "not replicated",
+      new BooleanParameter(&_bulkLoad));
+
+  options->addOption(
+      "--velocypack",
+      "convert JSON input to VelocyPack on the client, so the server does "
+      "not have to parse it",
+      new BooleanParameter(&_velocyPack));
+
   options->addOption("--quote", "quote character(s), used for csv",
                      new StringParameter(&_quote));
 
@@ -334,6 +350,8 @@ void ImportFeature::start() {
   ih.setConversion(_convert);
   ih.setRowsToSkip(static_cast<size_t>(_rowsToSkip));
   ih.setOverwrite(_overwrite);
+  ih.setBulkLoad(_bulkLoad);
+  ih.setVelocyPack(_velocyPack);
   ih.useBackslash(_useBackslash);
 
   std::unordered_map<std::string, std::string> translations;
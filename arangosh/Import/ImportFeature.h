@@ -58,6 +58,8 @@ class ImportFeature final : public application_features::ApplicationFeature,
   std::string _typeImport;
   std::vector<std::string> _translations;
   bool _overwrite;
+  bool _bulkLoad;
+  bool _velocyPack;
   std::string _quote;
   std::string _separator;
   bool _progress;
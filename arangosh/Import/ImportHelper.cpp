@@ -151,6 +151,8 @@ ImportHelper::ImportHelper(ClientFeature const* client,
       _convert(true),
       _createCollection(false),
       _overwrite(false),
+      _bulkLoad(false),
+      _velocyPack(false),
       _progress(false),
       _firstChunk(true),
       _numberLines(0),
@@ -771,6 +773,12 @@ void ImportHelper::sendCsvBuffer() {
   if (!_toCollectionPrefix.empty()) {
     url += "&toPrefix=" + StringUtils::urlEncode(_toCollectionPrefix);
   }
+  // only the first chunk can be bulk loaded, as bulk loads require an
+  // empty collection. the other chunks wait until it is done
+  bool const bulkLoad = _bulkLoad && _firstChunk;
+  if (bulkLoad) {
+    url += "&bulkLoad=true";
+  }
   if (_firstChunk && _overwrite) {
     // url += "&overwrite=true";
     truncateCollection();
@@ -780,6 +788,9 @@ void ImportHelper::sendCsvBuffer() {
   SenderThread* t = findSender();
   if (t != nullptr) {
     t->sendData(url, &_outputBuffer);
+    if (bulkLoad) {
+      waitForSenders();
+    }
   }
 
   _outputBuffer.reset();
@@ -811,6 +822,12 @@ void ImportHelper::sendJsonBuffer(char const* str, size_t len, bool isObject) {
   if (!_toCollectionPrefix.empty()) {
     url += "&toPrefix=" + StringUtils::urlEncode(_toCollectionPrefix);
   }
+  // only the first chunk can be bulk loaded, as bulk loads require an
+  // empty collection. the other chunks wait until it is done
+  bool const bulkLoad = _bulkLoad && _firstChunk;
+  if (bulkLoad) {
+    url += "&bulkLoad=true";
+  }
   if (_firstChunk && _overwrite) {
     // url += "&overwrite=true";
     truncateCollection();
@@ -819,9 +836,18 @@ void ImportHelper::sendJsonBuffer(char const* str, size_t len, bool isObject) {
 
   SenderThread* t = findSender();
   if (t != nullptr) {
+    SenderThread::Conversion conversion = SenderThread::ConvertNone;
+    if (_velocyPack) {
+      conversion =
+          isObject ? SenderThread::ConvertArray : SenderThread::ConvertLines;
+    }
+
     StringBuffer buff(TRI_UNKNOWN_MEM_ZONE, len, false);
     buff.appendText(str, len);
-    t->sendData(url, &buff);
+    t->sendData(url, &buff, conversion);
+    if (bulkLoad) {
+      waitForSenders();
+    }
   }
 }
 
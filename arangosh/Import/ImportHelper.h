@@ -160,6 +160,20 @@ class ImportHelper {
 
   void setOverwrite(bool value) { _overwrite = value; }
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief whether or not the server should bulk load the data
+  //////////////////////////////////////////////////////////////////////////////
+
+  void setBulkLoad(bool value) { _bulkLoad = value; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief whether or not JSON input is sent to the server as VelocyPack.
+  /// the conversion is done by the sender threads, so chunks are parsed in
+  /// parallel
+  //////////////////////////////////////////////////////////////////////////////
+
+  void setVelocyPack(bool value) { _velocyPack = value; }
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief set the number of rows to skip
   //////////////////////////////////////////////////////////////////////////////
@@ -270,6 +284,8 @@ class ImportHelper {
   bool _convert;
   bool _createCollection;
   bool _overwrite;
+  bool _bulkLoad;
+  bool _velocyPack;
   bool _progress;
   bool _firstChunk;
 
@@ -24,6 +24,7 @@
 #include "Basics/Common.h"
 #include "Basics/ConditionLocker.h"
 #include "Basics/MutexLocker.h"
+#include "Basics/StaticStrings.h"
 #include "Basics/StringBuffer.h"
 #include "Basics/StringUtils.h"
 #include "Basics/VelocyPackHelper.h"
@@ -33,6 +34,8 @@
 
 #include <velocypack/Builder.h>
 #include <velocypack/Iterator.h>
+#include <velocypack/Options.h>
+#include <velocypack/Parser.h>
 #include <velocypack/velocypack-aliases.h>
 
 using namespace arangodb;
@@ -44,6 +47,7 @@ SenderThread::SenderThread(
     : Thread("Import Sender"),
       _client(client.release()),
       _data(TRI_UNKNOWN_MEM_ZONE, false),
+      _conversion(ConvertNone),
       _hasError(false),
       _idle(true),
       _ready(false),
@@ -63,10 +67,12 @@ void SenderThread::beginShutdown() {
 }
 
 void SenderThread::sendData(std::string const& url,
-                            arangodb::basics::StringBuffer* data) {
+                            arangodb::basics::StringBuffer* data,
+                            Conversion conversion) {
   TRI_ASSERT(_idle && !_hasError);
   _url = url;
   _data.swap(data);
+  _conversion = conversion;
 
   // wake up the thread that may be waiting in run()
   CONDITION_LOCKER(guard, _condition);
@@ -110,9 +116,22 @@ void SenderThread::run() {
       if (_data.length() > 0) {
         TRI_ASSERT(!_idle && !_url.empty());
 
-        std::unique_ptr<httpclient::SimpleHttpResult> result(
-            _client->request(rest::RequestType::POST, _url, _data.c_str(),
-                             _data.length()));
+        std::unique_ptr<httpclient::SimpleHttpResult> result;
+        VPackBuilder builder;
+
+        if (_conversion != ConvertNone && convertData(builder)) {
+          // the server can use the documents as they are
+          static std::unordered_map<std::string, std::string> const headers{
+              {StaticStrings::ContentTypeHeader, StaticStrings::MimeTypeVPack}};
+          VPackSlice slice = builder.slice();
+          result.reset(_client->request(
+              rest::RequestType::POST, _url,
+              reinterpret_cast<char const*>(slice.begin()), slice.byteSize(),
+              headers));
+        } else {
+          result.reset(_client->request(rest::RequestType::POST, _url,
+                                        _data.c_str(), _data.length()));
+        }
 
         handleResult(result.get());
 
@@ -192,3 +211,33 @@ void SenderThread::handleResult(httpclient::SimpleHttpResult* result) {
       arangodb::basics::VelocyPackHelper::getNumericValue<size_t>(body,
                                                                   "ignored", 0);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts the JSON data into a VelocyPack array of documents. returns
+/// false if the data cannot be parsed, it is then sent as is and the server
+/// reports the invalid documents with their line numbers
+////////////////////////////////////////////////////////////////////////////////
+
+bool SenderThread::convertData(VPackBuilder& builder) const {
+  try {
+    if (_conversion == ConvertArray) {
+      VPackParser parser(builder);
+      parser.parse(_data.c_str(), _data.length());
+      return builder.slice().isArray();
+    }
+
+    TRI_ASSERT(_conversion == ConvertLines);
+
+    // one document per line, all of them go into the same array
+    VPackOptions options;
+    options.clearBuilderBeforeParse = false;
+    VPackParser parser(builder, &options);
+
+    builder.openArray();
+    parser.parse(_data.c_str(), _data.length(), true);
+    builder.close();
+    return true;
+  } catch (...) {
+    return false;
+  }
+}
@@ -28,6 +28,8 @@
 #include "Basics/Thread.h"
 #include "SimpleHttpClient/SimpleHttpClient.h"
 
+#include <velocypack/Builder.h>
+
 namespace arangodb {
 namespace basics {
 class StringBuffer;
@@ -45,6 +47,13 @@ class SenderThread : public arangodb::Thread {
   SenderThread(SenderThread const&) = delete;
   SenderThread& operator=(SenderThread const&) = delete;
 
+ public:
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief how the data is converted before it is sent
+  //////////////////////////////////////////////////////////////////////////////
+
+  enum Conversion { ConvertNone = 0, ConvertLines, ConvertArray };
+
  public:
   explicit SenderThread(std::unique_ptr<httpclient::SimpleHttpClient>&&,
                         ImportStatistics* stats);
@@ -55,7 +64,8 @@ class SenderThread : public arangodb::Thread {
   /// @brief imports a delimited file
   //////////////////////////////////////////////////////////////////////////////
 
-  void sendData(std::string const& url, basics::StringBuffer* sender);
+  void sendData(std::string const& url, basics::StringBuffer* sender,
+                Conversion conversion = ConvertNone);
 
   bool hasError();
   /// Ready to start sending
@@ -76,6 +86,7 @@ class SenderThread : public arangodb::Thread {
   httpclient::SimpleHttpClient* _client;
   std::string _url;
   basics::StringBuffer _data;
+  Conversion _conversion;
   bool _hasError;
   bool _idle;
   bool _ready;
@@ -83,6 +94,7 @@ class SenderThread : public arangodb::Thread {
   ImportStatistics* _stats;
   std::string _errorMessage;
   void handleResult(httpclient::SimpleHttpResult* result);
+  bool convertData(arangodb::velocypack::Builder& builder) const;
 };
 }
 }
@@ -23,7 +23,10 @@
 #include "RestoreFeature.h"
 
 #include "ApplicationFeatures/ApplicationServer.h"
+#include "Basics/Exceptions.h"
 #include "Basics/FileUtils.h"
+#include "Basics/Mutex.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/OpenFilesTracker.h"
 #include "Basics/StringUtils.h"
 #include "Basics/VelocyPackHelper.h"
@@ -44,6 +47,7 @@
 #include <velocypack/velocypack-aliases.h>
 
 #include <iostream>
+#include <thread>
 
 using namespace arangodb;
 using namespace arangodb::basics;
@@ -69,8 +73,8 @@ RestoreFeature::RestoreFeature(application_features::ApplicationServer* server,
       _clusterMode(false),
       _defaultNumberOfShards(1),
       _defaultReplicationFactor(1),
-      _result(result),
-      _stats{0, 0, 0} {
+      _threadCount(2),
+      _result(result) {
   requiresElevatedPrivileges(false);
   setOptional(false);
   startsAfter("Client");
@@ -133,6 +137,12 @@ void RestoreFeature::collectOptions(
   options->addOption(
     "--force", "continue restore even in the face of some server-side errors",
     new BooleanParameter(&_force));
+
+  options->addOption(
+      "--threads",
+      "maximum number of collections to restore data and indexes for in "
+      "parallel",
+      new UInt32Parameter(&_threadCount));
 }
 
 void RestoreFeature::validateOptions(
@@ -153,6 +163,10 @@ void RestoreFeature::validateOptions(
   if (_chunkSize < 1024 * 128) {
     _chunkSize = 1024 * 128;
   }
+
+  if (_threadCount == 0) {
+    _threadCount = 1;
+  }
 }
 
 void RestoreFeature::prepare() {
@@ -181,6 +195,22 @@ void RestoreFeature::prepare() {
   }
 }
 
+// create a connection to the server, configured like the main one
+std::unique_ptr<SimpleHttpClient> RestoreFeature::createClient() {
+  ClientFeature* client =
+      application_features::ApplicationServer::getFeature<ClientFeature>(
+          "Client");
+
+  std::unique_ptr<SimpleHttpClient> httpClient = client->createHttpClient();
+
+  httpClient->params().setLocationRewriter(static_cast<void*>(client),
+                                           &rewriteLocation);
+  httpClient->params().setUserNamePassword("/", client->username(),
+                                           client->password());
+
+  return httpClient;
+}
+
 int RestoreFeature::tryCreateDatabase(ClientFeature* client,
                                       std::string const& name) {
   VPackBuilder builder;
@@ -283,18 +313,19 @@ int RestoreFeature::sendRestoreCollection(VPackSlice const& slice,
   return TRI_ERROR_NO_ERROR;
 }
 
-int RestoreFeature::sendRestoreIndexes(VPackSlice const& slice,
+int RestoreFeature::sendRestoreIndexes(SimpleHttpClient& client,
+                                       VPackSlice const& slice,
                                        std::string& errorMsg) {
   std::string const url = "/_api/replication/restore-indexes?force=" +
                           std::string(_force ? "true" : "false");
   std::string const body = slice.toJson();
 
-  std::unique_ptr<SimpleHttpResult> response(_httpClient->request(
+  std::unique_ptr<SimpleHttpResult> response(client.request(
       rest::RequestType::PUT, url, body.c_str(), body.size()));
 
   if (response == nullptr || !response->isComplete()) {
     errorMsg =
-        "got invalid response from server: " + _httpClient->getErrorMessage();
+        "got invalid response from server: " + client.getErrorMessage();
 
     return TRI_ERROR_INTERNAL;
   }
@@ -313,7 +344,8 @@ int RestoreFeature::sendRestoreIndexes(VPackSlice const& slice,
   return TRI_ERROR_NO_ERROR;
 }
 
-int RestoreFeature::sendRestoreData(std::string const& cname,
+int RestoreFeature::sendRestoreData(SimpleHttpClient& client,
+                                    std::string const& cname,
                                     char const* buffer, size_t bufferSize,
                                     std::string& errorMsg) {
   std::string const url = "/_api/replication/restore-data?collection=" +
@@ -322,11 +354,11 @@ int RestoreFeature::sendRestoreData(std::string const& cname,
                           (_force ? "true" : "false");
 
   std::unique_ptr<SimpleHttpResult> response(
-      _httpClient->request(rest::RequestType::PUT, url, buffer, bufferSize));
+      client.request(rest::RequestType::PUT, url, buffer, bufferSize));
 
   if (response == nullptr || !response->isComplete()) {
     errorMsg =
-        "got invalid response from server: " + _httpClient->getErrorMessage();
+        "got invalid response from server: " + client.getErrorMessage();
 
     return TRI_ERROR_INTERNAL;
   }
@@ -345,6 +377,174 @@ int RestoreFeature::sendRestoreData(std::string const& cname,
   return TRI_ERROR_NO_ERROR;
 }
 
+int RestoreFeature::restoreData(SimpleHttpClient& client,
+                                std::string const& cname,
+                                std::string const& collectionType,
+                                std::string& errorMsg) {
+  // import data. check if we have a datafile
+  std::string datafile =
+      _inputDirectory + TRI_DIR_SEPARATOR_STR + cname + "_" +
+      arangodb::rest::SslInterface::sslMD5(cname) + ".data.json";
+  if (!TRI_ExistsFile(datafile.c_str())) {
+    datafile =
+        _inputDirectory + TRI_DIR_SEPARATOR_STR + cname + ".data.json";
+  }
+
+  if (!TRI_ExistsFile(datafile.c_str())) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  // found a datafile
+
+  if (_progress) {
+    std::string const line = "# Loading data into " + collectionType +
+                             " collection '" + cname + "'...\n";
+    std::cout << line << std::flush;
+  }
+
+  int fd = TRI_TRACKED_OPEN_FILE(datafile.c_str(), O_RDONLY | TRI_O_CLOEXEC);
+
+  if (fd < 0) {
+    errorMsg = "cannot open collection data file '" + datafile + "'";
+
+    return TRI_ERROR_INTERNAL;
+  }
+
+  StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE);
+
+  while (true) {
+    if (buffer.reserve(16384) != TRI_ERROR_NO_ERROR) {
+      TRI_TRACKED_CLOSE_FILE(fd);
+      errorMsg = "out of memory";
+
+      return TRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    ssize_t numRead = TRI_READ(fd, buffer.end(), 16384);
+
+    if (numRead < 0) {
+      // error while reading
+      int res = TRI_errno();
+      TRI_TRACKED_CLOSE_FILE(fd);
+      errorMsg = std::string(TRI_errno_string(res));
+
+      return res;
+    }
+
+    // read something
+    buffer.increaseLength(numRead);
+
+    _stats._totalRead += (uint64_t)numRead;
+
+    if (buffer.length() < _chunkSize && numRead > 0) {
+      // still continue reading
+      continue;
+    }
+
+    // do we have a buffer?
+    if (buffer.length() > 0) {
+      // look for the last \n in the buffer
+      char* found = (char*)memrchr((const void*)buffer.begin(), '\n',
+                                   buffer.length());
+      size_t length;
+
+      if (found == nullptr) {
+        // no \n found...
+        if (numRead == 0) {
+          // we're at the end. send the complete buffer anyway
+          length = buffer.length();
+        } else {
+          // read more
+          continue;
+        }
+      } else {
+        // found a \n somewhere
+        length = found - buffer.begin();
+      }
+
+      _stats._totalBatches++;
+
+      int res =
+          sendRestoreData(client, cname, buffer.begin(), length, errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        if (errorMsg.empty()) {
+          errorMsg = std::string(TRI_errno_string(res));
+        } else {
+          errorMsg =
+              std::string(TRI_errno_string(res)) + ": " + errorMsg;
+        }
+
+        if (_force) {
+          std::cerr << errorMsg << std::endl;
+          continue;
+        }
+        TRI_TRACKED_CLOSE_FILE(fd);
+
+        return res;
+      }
+
+      buffer.erase_front(length);
+    }
+
+    if (numRead == 0) {
+      // EOF
+      break;
+    }
+  }
+
+  TRI_TRACKED_CLOSE_FILE(fd);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+int RestoreFeature::restoreDataAndIndexes(SimpleHttpClient& client,
+                                          VPackSlice const& collection,
+                                          std::string& errorMsg) {
+  VPackSlice const parameters = collection.get("parameters");
+  VPackSlice const indexes = collection.get("indexes");
+  std::string const cname =
+      arangodb::basics::VelocyPackHelper::getStringValue(parameters, "name",
+                                                         "");
+  int type = arangodb::basics::VelocyPackHelper::getNumericValue<int>(
+      parameters, "type", 2);
+
+  std::string const collectionType(type == 2 ? "document" : "edge");
+
+  if (_importData) {
+    int res = restoreData(client, cname, collectionType, errorMsg);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+  }
+
+  if (_importStructure) {
+    // re-create indexes
+    if (indexes.length() > 0) {
+      // we actually have indexes
+      if (_progress) {
+        std::string const line =
+            "# Creating indexes for collection '" + cname + "'...\n";
+        std::cout << line << std::flush;
+      }
+
+      int res = sendRestoreIndexes(client, collection, errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        if (_force) {
+          std::cerr << errorMsg << std::endl;
+          errorMsg.clear();
+          return TRI_ERROR_NO_ERROR;
+        }
+        return TRI_ERROR_INTERNAL;
+      }
+    }
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 static bool SortCollections(VPackSlice const& l, VPackSlice const& r) {
   VPackSlice const left = l.get("parameters");
   VPackSlice const right = r.get("parameters");
@@ -481,12 +681,12 @@ int RestoreFeature::processInputDirectory(std::string& errorMsg) {
 
     std::sort(collections.begin(), collections.end(), SortCollections);
 
-    StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE);
+    // step 2: create the collections. this happens one after the other,
+    // in the order determined above
+    std::vector<VPackSlice> created;
 
-    // step2: run the actual import
     for (VPackSlice const& collection : collections) {
       VPackSlice const parameters = collection.get("parameters");
-      VPackSlice const indexes = collection.get("indexes");
       std::string const cname =
           arangodb::basics::VelocyPackHelper::getStringValue(parameters, "name",
                                                              "");
@@ -519,140 +719,83 @@ int RestoreFeature::processInputDirectory(std::string& errorMsg) {
       }
       _stats._totalCollections++;
 
-      if (_importData) {
-        // import data. check if we have a datafile
-        std::string datafile =
-            _inputDirectory + TRI_DIR_SEPARATOR_STR + cname + "_" +
-            arangodb::rest::SslInterface::sslMD5(cname) + ".data.json";
-        if (!TRI_ExistsFile(datafile.c_str())) {
-          datafile =
-              _inputDirectory + TRI_DIR_SEPARATOR_STR + cname + ".data.json";
-        }
-
-        if (TRI_ExistsFile(datafile.c_str())) {
-          // found a datafile
+      created.emplace_back(collection);
+    }
 
-          if (_progress) {
-            std::cout << "# Loading data into " << collectionType
-                      << " collection '" << cname << "'..." << std::endl;
-          }
+    // step 3: load the data and create the indexes. collections do not
+    // depend on each other anymore, so up to _threadCount of them are
+    // restored at the same time, each over its own connection
+    size_t const threadCount =
+        (std::min)(static_cast<size_t>(_threadCount), created.size());
 
-          int fd = TRI_TRACKED_OPEN_FILE(datafile.c_str(), O_RDONLY | TRI_O_CLOEXEC);
+    if (threadCount <= 1) {
+      for (VPackSlice const& collection : created) {
+        int res = restoreDataAndIndexes(*_httpClient, collection, errorMsg);
 
-          if (fd < 0) {
-            errorMsg = "cannot open collection data file '" + datafile + "'";
+        if (res != TRI_ERROR_NO_ERROR) {
+          return res;
+        }
+      }
 
-            return TRI_ERROR_INTERNAL;
-          }
+      return TRI_ERROR_NO_ERROR;
+    }
 
-          buffer.clear();
-
-          while (true) {
-            if (buffer.reserve(16384) != TRI_ERROR_NO_ERROR) {
-              TRI_TRACKED_CLOSE_FILE(fd);
-              errorMsg = "out of memory";
-
-              return TRI_ERROR_OUT_OF_MEMORY;
-            }
-
-            ssize_t numRead = TRI_READ(fd, buffer.end(), 16384);
-
-            if (numRead < 0) {
-              // error while reading
-              int res = TRI_errno();
-              TRI_TRACKED_CLOSE_FILE(fd);
-              errorMsg = std::string(TRI_errno_string(res));
-
-              return res;
-            }
-
-            // read something
-            buffer.increaseLength(numRead);
-
-            _stats._totalRead += (uint64_t)numRead;
-
-            if (buffer.length() < _chunkSize && numRead > 0) {
-              // still continue reading
-              continue;
-            }
-
-            // do we have a buffer?
-            if (buffer.length() > 0) {
-              // look for the last \n in the buffer
-              char* found = (char*)memrchr((const void*)buffer.begin(), '\n',
-                                           buffer.length());
-              size_t length;
-
-              if (found == nullptr) {
-                // no \n found...
-                if (numRead == 0) {
-                  // we're at the end. send the complete buffer anyway
-                  length = buffer.length();
-                } else {
-                  // read more
-                  continue;
-                }
-              } else {
-                // found a \n somewhere
-                length = found - buffer.begin();
-              }
-
-              _stats._totalBatches++;
-
-              int res =
-                  sendRestoreData(cname, buffer.begin(), length, errorMsg);
-
-              if (res != TRI_ERROR_NO_ERROR) {
-                if (errorMsg.empty()) {
-                  errorMsg = std::string(TRI_errno_string(res));
-                } else {
-                  errorMsg =
-                      std::string(TRI_errno_string(res)) + ": " + errorMsg;
-                }
-
-                if (_force) {
-                  std::cerr << errorMsg << std::endl;
-                  continue;
-                }
-                TRI_TRACKED_CLOSE_FILE(fd);
-
-                return res;
-              }
-
-              buffer.erase_front(length);
-            }
-
-            if (numRead == 0) {
-              // EOF
-              break;
-            }
-          }
+    std::vector<std::unique_ptr<SimpleHttpClient>> clients;
+    for (size_t i = 1; i < threadCount; ++i) {
+      clients.emplace_back(createClient());
+    }
 
-          TRI_TRACKED_CLOSE_FILE(fd);
+    // collections are handed out one at a time, so a few large collections
+    // do not keep all others waiting
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+    Mutex resultMutex;
+    int result = TRI_ERROR_NO_ERROR;
+
+    auto work = [&](SimpleHttpClient& client) {
+      while (!failed.load()) {
+        size_t current = next++;
+        if (current >= created.size()) {
+          break;
         }
-      }
-
-      if (_importStructure) {
-        // re-create indexes
-        if (indexes.length() > 0) {
-          // we actually have indexes
-          if (_progress) {
-            std::cout << "# Creating indexes for collection '" << cname
-                      << "'..." << std::endl;
-          }
 
-          int res = sendRestoreIndexes(collection, errorMsg);
+        std::string msg;
+        int res;
+        try {
+          res = restoreDataAndIndexes(client, created[current], msg);
+        } catch (basics::Exception const& ex) {
+          res = ex.code();
+          msg = ex.what();
+        } catch (std::exception const& ex) {
+          res = TRI_ERROR_INTERNAL;
+          msg = ex.what();
+        }
 
-          if (res != TRI_ERROR_NO_ERROR) {
-            if (_force) {
-              std::cerr << errorMsg << std::endl;
-              continue;
-            }
-            return TRI_ERROR_INTERNAL;
+        if (res != TRI_ERROR_NO_ERROR) {
+          failed = true;
+          MUTEX_LOCKER(locker, resultMutex);
+          if (result == TRI_ERROR_NO_ERROR) {
+            result = res;
+            errorMsg = msg;
           }
         }
       }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(clients.size());
+    for (auto& client : clients) {
+      SimpleHttpClient* c = client.get();
+      threads.emplace_back([&work, c]() { work(*c); });
+    }
+
+    work(*_httpClient);
+
+    for (auto& thread : threads) {
+      thread.join();
     }
+
+    return result;
   } catch (...) {
     errorMsg = "out of memory";
     return TRI_ERROR_OUT_OF_MEMORY;
@@ -669,7 +812,7 @@ void RestoreFeature::start() {
   *_result = ret;
 
   try {
-    _httpClient = client->createHttpClient();
+    _httpClient = createClient();
   } catch (...) {
     LOG_TOPIC(FATAL, arangodb::Logger::FIXME)
         << "cannot create server connection, giving up!";
@@ -678,10 +821,6 @@ void RestoreFeature::start() {
 
   std::string dbName = client->databaseName();
 
-  _httpClient->params().setLocationRewriter(static_cast<void*>(client),
-                                   &rewriteLocation);
-  _httpClient->params().setUserNamePassword("/", client->username(), client->password());
-
   int err = TRI_ERROR_NO_ERROR;
   std::string versionString = _httpClient->getServerVersion(&err);
 
@@ -31,6 +31,7 @@
 
 namespace arangodb {
 namespace httpclient {
+class SimpleHttpClient;
 class SimpleHttpResult;
 }
 
@@ -64,24 +65,34 @@ class RestoreFeature final
   bool _clusterMode;
   uint64_t _defaultNumberOfShards;
   uint64_t _defaultReplicationFactor;
+  uint32_t _threadCount;
 
  private:
+  std::unique_ptr<httpclient::SimpleHttpClient> createClient();
   int tryCreateDatabase(ClientFeature*, std::string const& name);
   int sendRestoreCollection(VPackSlice const& slice, std::string const& name,
                             std::string& errorMsg);
-  int sendRestoreIndexes(VPackSlice const& slice, std::string& errorMsg);
-  int sendRestoreData(std::string const& cname, char const* buffer,
+  int sendRestoreIndexes(httpclient::SimpleHttpClient& client,
+                         VPackSlice const& slice, std::string& errorMsg);
+  int sendRestoreData(httpclient::SimpleHttpClient& client,
+                      std::string const& cname, char const* buffer,
                       size_t bufferSize, std::string& errorMsg);
+  int restoreData(httpclient::SimpleHttpClient& client,
+                  std::string const& cname, std::string const& collectionType,
+                  std::string& errorMsg);
+  int restoreDataAndIndexes(httpclient::SimpleHttpClient& client,
+                            VPackSlice const& collection,
+                            std::string& errorMsg);
   int processInputDirectory(std::string& errorMsg);
 
  private:
   int* _result;
 
-  // statistics
+  // statistics, updated by all restore threads
   struct {
-    uint64_t _totalBatches;
-    uint64_t _totalCollections;
-    uint64_t _totalRead;
+    std::atomic<uint64_t> _totalBatches{0};
+    std::atomic<uint64_t> _totalCollections{0};
+    std::atomic<uint64_t> _totalRead{0};
   } _stats;
 };
 }
@@ -0,0 +1,210 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertTrue, assertFalse, assertNotEqual, arango */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for streaming cursors
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("@arangodb").db;
+var errors = require("@arangodb").errors;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function cursorStreamSuite () {
+  var cn = "UnitTestsCursorStream";
+  var n = 5000;
+  // V8() forces the calculation to be executed in a V8 context
+  var query = "FOR d IN " + cn + " SORT d.value RETURN V8(d.value * 2)";
+
+  var expected = function () {
+    var result = [];
+    for (var i = 0; i < n; ++i) {
+      result.push(i * 2);
+    }
+    return result;
+  };
+
+  var open = function (batchSize) {
+    var result = arango.POST("/_api/cursor", JSON.stringify({
+      query: query,
+      batchSize: batchSize,
+      options: { stream: true }
+    }));
+    assertFalse(result.error, JSON.stringify(result));
+    assertEqual(201, result.code);
+    return result;
+  };
+
+  var next = function (id) {
+    return arango.PUT("/_api/cursor/" + encodeURIComponent(id), "");
+  };
+
+  // reads all remaining batches of a cursor
+  var drain = function (result) {
+    var values = result.result;
+    var batches = 1;
+    while (result.hasMore) {
+      var id = result.id;
+      result = next(id);
+      assertFalse(result.error, JSON.stringify(result));
+      values = values.concat(result.result);
+      ++batches;
+    }
+    return { values: values, batches: batches };
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop(cn);
+      var c = db._create(cn);
+      var docs = [];
+      for (var i = 0; i < n; ++i) {
+        docs.push({ value: i });
+      }
+      c.insert(docs);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop(cn);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a V8 expression is evaluated over several batches
+////////////////////////////////////////////////////////////////////////////////
+
+    testStreamV8ExpressionBatches : function () {
+      var result = open(100);
+      assertTrue(result.hasMore);
+      assertEqual(100, result.result.length);
+
+      var all = drain(result);
+      assertEqual(n / 100, all.batches);
+      assertEqual(expected(), all.values);
+
+      // the same as the non-streaming cursor
+      assertEqual(db._query(query).toArray(), all.values);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that idle streaming cursors do not keep V8 contexts
+////////////////////////////////////////////////////////////////////////////////
+
+    testStreamV8ContextsAreReleased : function () {
+      // more open cursors than the server has V8 contexts
+      var cursors = [];
+      for (var i = 0; i < 64; ++i) {
+        var result = open(10);
+        assertTrue(result.hasMore);
+        assertEqual(10, result.result.length);
+        cursors.push(result);
+      }
+
+      // a context is still available for other V8 expressions
+      var other = db._query("FOR i IN 1..10 RETURN V8(i + 1)").toArray();
+      assertEqual(10, other.length);
+      assertEqual(11, other[9]);
+
+      // and for the next batches of all cursors
+      cursors = cursors.map(function (cursor) {
+        var result = next(cursor.id);
+        assertFalse(result.error, JSON.stringify(result));
+        assertEqual(10, result.result.length);
+        return result;
+      });
+
+      cursors.forEach(function (cursor) {
+        assertEqual(expected().slice(20), drain(cursor).values);
+      });
+
+      other = db._query("FOR i IN 1..10 RETURN V8(i + 1)").toArray();
+      assertEqual(10, other.length);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a streaming query is listed and can be killed
+////////////////////////////////////////////////////////////////////////////////
+
+    testStreamQueryListAndKill : function () {
+      var result = open(100);
+      assertTrue(result.hasMore);
+
+      var current = arango.GET("/_api/query/current");
+      var queries = current.filter(function (q) {
+        return q.query === query;
+      });
+      assertEqual(1, queries.length, JSON.stringify(current));
+      assertNotEqual(undefined, queries[0].id);
+
+      var killed = arango.DELETE("/_api/query/" + encodeURIComponent(queries[0].id));
+      assertFalse(killed.error, JSON.stringify(killed));
+
+      // already fetched results may still be returned, but the query must
+      // fail before it produces all of its results
+      var id = result.id;
+      var fetched = result.result.length;
+      while (true) {
+        result = next(id);
+        if (result.error) {
+          break;
+        }
+        fetched += result.result.length;
+        assertTrue(result.hasMore);
+        assertTrue(fetched < n);
+      }
+      assertEqual(errors.ERROR_QUERY_KILLED.code, result.errorNum);
+
+      // the killed cursor is gone
+      result = next(id);
+      assertTrue(result.error);
+      assertEqual(404, result.code);
+      assertEqual(errors.ERROR_CURSOR_NOT_FOUND.code, result.errorNum);
+
+      // and the query is no longer listed
+      current = arango.GET("/_api/query/current");
+      assertEqual([], current.filter(function (q) {
+        return q.query === query;
+      }));
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(cursorStreamSuite);
+
+return jsunity.done();
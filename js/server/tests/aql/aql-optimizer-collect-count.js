@@ -0,0 +1,213 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertNotEqual, AQL_EXECUTE, AQL_EXPLAIN */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for COLLECT WITH COUNT using the count method
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("@arangodb").db;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerCollectCountTestSuite () {
+  var cn = "UnitTestsCollection";
+  // more than one skip batch of the count block (10000)
+  var n = 12000;
+  var c;
+
+  var collectMethods = function (query) {
+    return AQL_EXPLAIN(query).plan.nodes.filter(function (node) {
+      return node.type === "CollectNode";
+    }).map(function (node) {
+      return node.collectOptions.method;
+    });
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop(cn);
+      c = db._create(cn);
+      c.ensureIndex({ type: "skiplist", fields: [ "value" ] });
+      db._query("FOR i IN 0.." + (n - 1) + " INSERT { value: i } INTO " + cn);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop(cn);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the count method is used for a count without groups
+////////////////////////////////////////////////////////////////////////////////
+
+    testCountMethod : function () {
+      assertEqual([ "count" ], collectMethods("FOR d IN " + cn + " COLLECT WITH COUNT INTO n RETURN n"));
+      assertEqual([ "count" ], collectMethods("FOR d IN " + cn + " FILTER d.value >= 10 COLLECT WITH COUNT INTO n RETURN n"));
+      collectMethods("FOR d IN " + cn + " COLLECT v = d.value % 2 WITH COUNT INTO n RETURN [ v, n ]").forEach(function (method) {
+        assertNotEqual("count", method);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts the whole collection
+////////////////////////////////////////////////////////////////////////////////
+
+    testCountCollection : function () {
+      var result = AQL_EXECUTE("FOR d IN " + cn + " COLLECT WITH COUNT INTO n RETURN n").json;
+      assertEqual([ n ], result);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts an empty collection
+////////////////////////////////////////////////////////////////////////////////
+
+    testCountEmpty : function () {
+      c.truncate();
+      var result = AQL_EXECUTE("FOR d IN " + cn + " COLLECT WITH COUNT INTO n RETURN n").json;
+      assertEqual([ 0 ], result);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts documents after a LIMIT, which skips before the count
+////////////////////////////////////////////////////////////////////////////////
+
+    testCountAfterLimit : function () {
+      var queries = [
+        [ "FOR d IN " + cn + " LIMIT 0, 10 COLLECT WITH COUNT INTO n RETURN n", 10 ],
+        [ "FOR d IN " + cn + " LIMIT 100, 1000 COLLECT WITH COUNT INTO n RETURN n", 1000 ],
+        [ "FOR d IN " + cn + " LIMIT 11000, 5000 COLLECT WITH COUNT INTO n RETURN n", 1000 ],
+        [ "FOR d IN " + cn + " LIMIT " + (n - 1) + ", 100 COLLECT WITH COUNT INTO n RETURN n", 1 ],
+        [ "FOR d IN " + cn + " LIMIT " + n + ", 100 COLLECT WITH COUNT INTO n RETURN n", 0 ],
+        [ "FOR d IN " + cn + " LIMIT 500, " + n + " COLLECT WITH COUNT INTO n RETURN n", n - 500 ]
+      ];
+
+      queries.forEach(function (query) {
+        assertEqual([ "count" ], collectMethods(query[0]), query[0]);
+        assertEqual([ query[1] ], AQL_EXECUTE(query[0]).json, query[0]);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief skips the result of the count
+////////////////////////////////////////////////////////////////////////////////
+
+    testCountSkipped : function () {
+      var result = AQL_EXECUTE("FOR d IN " + cn + " COLLECT WITH COUNT INTO n LIMIT 1, 1 RETURN n").json;
+      assertEqual([ ], result);
+
+      result = AQL_EXECUTE("FOR d IN " + cn + " COLLECT WITH COUNT INTO n LIMIT 0, 1 RETURN n").json;
+      assertEqual([ n ], result);
+
+      result = AQL_EXECUTE("FOR i IN 1..3 LET x = (FOR d IN " + cn + " COLLECT WITH COUNT INTO n RETURN n) LIMIT 1, 5 RETURN x[0]").json;
+      assertEqual([ n, n ], result);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts the collection for several input rows
+////////////////////////////////////////////////////////////////////////////////
+
+    testCountInnerLoop : function () {
+      var result = AQL_EXECUTE("FOR i IN 1..3 FOR d IN " + cn + " COLLECT WITH COUNT INTO n RETURN n").json;
+      assertEqual([ 3 * n ], result);
+
+      result = AQL_EXECUTE("FOR i IN 1..3 FOR d IN " + cn + " LIMIT 5, 20000 COLLECT WITH COUNT INTO n RETURN n").json;
+      assertEqual([ 3 * n - 5 ], result);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts the matches of an index
+////////////////////////////////////////////////////////////////////////////////
+
+    testCountIndex : function () {
+      var result = AQL_EXECUTE("FOR d IN " + cn + " FILTER d.value >= 1000 COLLECT WITH COUNT INTO n RETURN n").json;
+      assertEqual([ n - 1000 ], result);
+
+      result = AQL_EXECUTE("FOR d IN " + cn + " FILTER d.value >= 1000 LIMIT 10, 100 COLLECT WITH COUNT INTO n RETURN n").json;
+      assertEqual([ 100 ], result);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts inside a write transaction that has modified the collection
+////////////////////////////////////////////////////////////////////////////////
+
+    testCountWriteTransaction : function () {
+      var result = db._executeTransaction({
+        collections: { write: cn },
+        action: function (params) {
+          var db = require("@arangodb").db;
+          var c = db._collection(params.cn);
+          for (var i = 0; i < 10; ++i) {
+            c.insert({ value: -1 });
+          }
+          c.remove(c.byExample({ value: 0 }).toArray()[0]);
+          return db._query("FOR d IN " + params.cn + " COLLECT WITH COUNT INTO n RETURN n").toArray();
+        },
+        params: { cn: cn }
+      });
+      assertEqual([ n + 9 ], result);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts inside an exclusive transaction that has modified the
+/// collection
+////////////////////////////////////////////////////////////////////////////////
+
+    testCountExclusiveTransaction : function () {
+      var result = db._executeTransaction({
+        collections: { exclusive: cn },
+        action: function (params) {
+          var db = require("@arangodb").db;
+          var c = db._collection(params.cn);
+          for (var i = 0; i < 10; ++i) {
+            c.insert({ value: -1 });
+          }
+          var result = db._query("FOR d IN " + params.cn + " COLLECT WITH COUNT INTO n RETURN n").toArray();
+          db._query("FOR d IN " + params.cn + " FILTER d.value < 100 REMOVE d IN " + params.cn);
+          return result.concat(db._query("FOR d IN " + params.cn + " LIMIT 5, " + (2 * n) + " COLLECT WITH COUNT INTO n RETURN n").toArray());
+        },
+        params: { cn: cn }
+      });
+      assertEqual([ n + 10, n - 100 - 5 ], result);
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerCollectCountTestSuite);
+
+return jsunity.done();
@@ -0,0 +1,299 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertNotEqual, assertTrue, AQL_EXPLAIN, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for optimizer rules collect-in-cluster and
+/// distribute-limit-to-cluster
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("@arangodb").db;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for collect-in-cluster
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerRuleCollectTestSuite () {
+  var ruleName = "collect-in-cluster";
+  var cn = "UnitTestsOptimizer";
+  var n = 1000;
+  var paramDisabled = { optimizer: { rules: [ "+all", "-" + ruleName ] } };
+
+  // the node types of the plan, from the singleton upwards
+  var nodeTypes = function (query) {
+    return AQL_EXPLAIN(query).plan.nodes.map(function (node) {
+      return node.type;
+    });
+  };
+
+  // the query produces the same results with and without the rule
+  var checkResults = function (query) {
+    var expected = AQL_EXECUTE(query, { }, paramDisabled).json;
+    assertEqual(expected, AQL_EXECUTE(query).json, query);
+    return expected;
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop(cn);
+      var c = db._create(cn, { numberOfShards: 4 });
+      var docs = [];
+      for (var i = 0; i < n; ++i) {
+        docs.push({ value: i, group: i % 7, mixed: (i === 500 ? "foo" : i) });
+      }
+      c.insert(docs);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop(cn);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the COLLECT is split into a partial COLLECT on the DB
+/// servers and a COLLECT on the coordinator
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleSplitsCollect : function () {
+      var queries = [
+        "FOR d IN " + cn + " COLLECT WITH COUNT INTO cnt RETURN cnt",
+        "FOR d IN " + cn + " COLLECT g = d.group WITH COUNT INTO cnt RETURN [ g, cnt ]",
+        "FOR d IN " + cn + " COLLECT g = d.group OPTIONS { method: 'hash' } WITH COUNT INTO cnt SORT g RETURN [ g, cnt ]",
+        "FOR d IN " + cn + " COLLECT g = d.group AGGREGATE s = SUM(d.value), mn = MIN(d.value), mx = MAX(d.value), l = LENGTH(d), a = AVERAGE(d.value) RETURN [ g, s, mn, mx, l, a ]",
+        "FOR d IN " + cn + " COLLECT AGGREGATE c = COUNT(d), a = AVG(d.value) RETURN [ c, a ]",
+        "FOR d IN " + cn + " COLLECT g = d.group RETURN g",
+        "FOR d IN " + cn + " RETURN DISTINCT d.group"
+      ];
+
+      queries.forEach(function (query) {
+        var result = AQL_EXPLAIN(query);
+        assertNotEqual(-1, result.plan.rules.indexOf(ruleName), query);
+
+        var types = nodeTypes(query);
+        var remote = types.indexOf("RemoteNode");
+        var gather = types.indexOf("GatherNode");
+        assertNotEqual(-1, remote, query);
+        assertTrue(types.slice(0, remote).indexOf("CollectNode") !== -1, query);
+        assertTrue(types.slice(gather).indexOf("CollectNode") !== -1, query);
+
+        checkResults(query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the merged results against the documents
+////////////////////////////////////////////////////////////////////////////////
+
+    testResults : function () {
+      var result = checkResults("FOR d IN " + cn + " COLLECT WITH COUNT INTO cnt RETURN cnt");
+      assertEqual([ n ], result);
+
+      result = checkResults("FOR d IN " + cn + " COLLECT g = d.group AGGREGATE s = SUM(d.value), mn = MIN(d.value), mx = MAX(d.value), l = LENGTH(d), a = AVERAGE(d.value) RETURN [ g, s, mn, mx, l, a ]");
+      assertEqual(7, result.length);
+      result.forEach(function (row) {
+        var values = [];
+        for (var i = row[0]; i < n; i += 7) {
+          values.push(i);
+        }
+        var sum = values.reduce(function (a, b) { return a + b; }, 0);
+        assertEqual([ row[0], sum, values[0], values[values.length - 1], values.length, sum / values.length ], row);
+      });
+
+      result = checkResults("FOR d IN " + cn + " FILTER d.value >= 10000 COLLECT AGGREGATE c = COUNT(d), s = SUM(d.value), a = AVERAGE(d.value), mn = MIN(d.value) RETURN [ c, s, a, mn ]");
+      assertEqual([ [ 0, 0, null, null ] ], result);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a value that is not a number makes the merged SUM and
+/// AVERAGE null, as on a single server
+////////////////////////////////////////////////////////////////////////////////
+
+    testInvalidValues : function () {
+      var result = checkResults("FOR d IN " + cn + " COLLECT g = d.group AGGREGATE s = SUM(d.mixed), a = AVERAGE(d.mixed) RETURN [ g, s, a ]");
+      assertEqual(7, result.length);
+      result.forEach(function (row) {
+        if (row[0] === 500 % 7) {
+          assertEqual([ row[0], null, null ], row);
+        } else {
+          assertNotEqual(null, row[1]);
+          assertNotEqual(null, row[2]);
+        }
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the rule has no effect on COLLECTs that need all values
+/// of a group on the coordinator
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleNoEffect : function () {
+      var queries = [
+        "FOR d IN " + cn + " COLLECT g = d.group INTO docs RETURN [ g, LENGTH(docs) ]",
+        "FOR d IN " + cn + " COLLECT g = d.group INTO values = d.value RETURN [ g, LENGTH(values) ]",
+        "FOR d IN " + cn + " COLLECT g = d.group AGGREGATE s = STDDEV_POPULATION(d.value) RETURN [ g, s ]",
+        "FOR d IN " + cn + " COLLECT g = d.group AGGREGATE s = SUM(d.value), v = VARIANCE(d.value) RETURN [ g, s, v ]",
+        "FOR d IN " + cn + " LIMIT 10 COLLECT WITH COUNT INTO cnt RETURN cnt"
+      ];
+
+      queries.forEach(function (query) {
+        var result = AQL_EXPLAIN(query);
+        assertEqual(-1, result.plan.rules.indexOf(ruleName), query);
+        checkResults(query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that DB servers do not collect below a data modification
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleNoEffectModification : function () {
+      var query = "FOR d IN " + cn + " FILTER d.value < 10 UPDATE d WITH { updated: true } IN " + cn + " COLLECT WITH COUNT INTO cnt RETURN cnt";
+      var result = AQL_EXPLAIN(query);
+      assertEqual(-1, result.plan.rules.indexOf(ruleName), query);
+      assertEqual([ 10 ], AQL_EXECUTE(query).json);
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for distribute-limit-to-cluster
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerRuleLimitTestSuite () {
+  var ruleName = "distribute-limit-to-cluster";
+  var cn = "UnitTestsOptimizer";
+  var n = 1000;
+  var paramDisabled = { optimizer: { rules: [ "+all", "-" + ruleName ] } };
+
+  // the limits of the LimitNodes on the DB servers
+  var dbServerLimits = function (query, options) {
+    var nodes = AQL_EXPLAIN(query, { }, options || { }).plan.nodes;
+    var limits = [];
+    for (var i = 0; i < nodes.length && nodes[i].type !== "RemoteNode"; ++i) {
+      if (nodes[i].type === "LimitNode") {
+        limits.push([ nodes[i].offset, nodes[i].limit ]);
+      }
+    }
+    return limits;
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop(cn);
+      var c = db._create(cn, { numberOfShards: 4 });
+      var docs = [];
+      for (var i = 0; i < n; ++i) {
+        docs.push({ value: i });
+      }
+      c.insert(docs);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop(cn);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that each DB server only produces offset + limit rows
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleLimits : function () {
+      var queries = [
+        [ "FOR d IN " + cn + " SORT d.value LIMIT 10 RETURN d.value", 10 ],
+        [ "FOR d IN " + cn + " SORT d.value LIMIT 5, 10 RETURN d.value", 15 ],
+        [ "FOR d IN " + cn + " SORT d.value DESC LET v = d.value * 2 LIMIT 990, 20 RETURN v", 1010 ],
+        [ "FOR d IN " + cn + " FILTER d.value % 2 == 0 SORT d.value LIMIT 3, 4 RETURN d.value", 7 ]
+      ];
+
+      queries.forEach(function (query) {
+        var result = AQL_EXPLAIN(query[0]);
+        assertNotEqual(-1, result.plan.rules.indexOf(ruleName), query[0]);
+        assertEqual([ [ 0, query[1] ] ], dbServerLimits(query[0]), query[0]);
+
+        var expected = AQL_EXECUTE(query[0], { }, paramDisabled).json;
+        assertEqual(expected, AQL_EXECUTE(query[0]).json, query[0]);
+      });
+
+      assertEqual([ 5, 6, 7, 8 ], AQL_EXECUTE("FOR d IN " + cn + " SORT d.value LIMIT 5, 4 RETURN d.value").json);
+      assertEqual([ 19, 18 ], AQL_EXECUTE("FOR d IN " + cn + " SORT d.value DESC LIMIT 980, 2 RETURN d.value").json);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that an unsorted LIMIT returns the requested number of rows
+////////////////////////////////////////////////////////////////////////////////
+
+    testUnsorted : function () {
+      var query = "FOR d IN " + cn + " LIMIT 7, 20 RETURN d.value";
+      assertEqual([ [ 0, 27 ] ], dbServerLimits(query));
+      assertEqual(20, AQL_EXECUTE(query).json.length);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the rule has no effect where all rows are needed
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleNoEffect : function () {
+      var query = "FOR d IN " + cn + " SORT d.value LIMIT 10 RETURN d.value";
+      var options = { fullCount: true };
+      var result = AQL_EXPLAIN(query, { }, options);
+      assertEqual(-1, result.plan.rules.indexOf(ruleName));
+      assertEqual([ ], dbServerLimits(query, options));
+      result = AQL_EXECUTE(query, { }, options);
+      assertEqual(n, result.stats.fullCount);
+
+      query = "FOR d IN " + cn + " SORT d.value LIMIT 10, 0 RETURN d.value";
+      assertEqual(-1, AQL_EXPLAIN(query).plan.rules.indexOf(ruleName));
+
+      query = "FOR d IN " + cn + " FILTER d.value < 10 REMOVE d IN " + cn + " LIMIT 2 RETURN OLD.value";
+      assertEqual(-1, AQL_EXPLAIN(query).plan.rules.indexOf(ruleName));
+      assertEqual(2, AQL_EXECUTE(query).json.length);
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suites
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerRuleCollectTestSuite);
+jsunity.run(optimizerRuleLimitTestSuite);
+
+return jsunity.done();
@@ -0,0 +1,190 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertTrue, AQL_EXPLAIN, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for optimizer rule interchange-adjacent-enumerations with
+/// long runs of FOR loops
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("@arangodb").db;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerRuleTestSuite () {
+  var ruleName = "interchange-adjacent-enumerations";
+  var cn = "UnitTestsOptimizer";
+  // collection sizes, the last collection has the ids the others refer to
+  var sizes = [ 20, 15, 10, 8, 5 ];
+  // various choices to control the optimizer:
+  var paramNone     = { optimizer: { rules: [ "-all" ] } };
+  var paramEnabled  = { optimizer: { rules: [ "-all", "+" + ruleName ] } };
+  var paramDisabled = { optimizer: { rules: [ "+all", "-" + ruleName ] } };
+
+  var names = sizes.map(function (size, i) {
+    return cn + (i + 1);
+  });
+
+  // the order of the loops in the plan, by collection name or variable
+  var loops = function (plan) {
+    return plan.nodes.filter(function (node) {
+      return [ "EnumerateCollectionNode", "IndexNode", "EnumerateListNode" ].indexOf(node.type) !== -1;
+    }).map(function (node) {
+      if (node.type === "EnumerateListNode") {
+        return node.outVariable.name;
+      }
+      return node.collection;
+    });
+  };
+
+  var numberOfPlans = function (query) {
+    return AQL_EXPLAIN(query, { }, { allPlans: true, optimizer: paramEnabled.optimizer }).plans.length;
+  };
+
+  // the query produces the same results with and without the rule
+  var checkResults = function (query, expected) {
+    assertEqual(expected, AQL_EXECUTE(query, { }, paramEnabled).json, query);
+    assertEqual(expected, AQL_EXECUTE(query, { }, paramDisabled).json, query);
+    assertEqual(expected, AQL_EXECUTE(query).json, query);
+  };
+
+  // a join of all collections, in the order of the collections
+  var join = "FOR a IN " + names[0] + " FOR b IN " + names[1] + " FOR c IN " + names[2] + " FOR d IN " + names[3] + " FOR e IN " + names[4] + " FILTER a.e == e.id && b.e == e.id && c.e == e.id && d.e == e.id && e.id == 3 ";
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      names.forEach(function (name, i) {
+        db._drop(name);
+        var c = db._create(name);
+        var docs = [];
+        for (var j = 0; j < sizes[i]; ++j) {
+          if (i === names.length - 1) {
+            docs.push({ id: j });
+          } else {
+            docs.push({ value: j, e: j % 5, list: [ j, -j ] });
+          }
+        }
+        c.insert(docs);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      names.forEach(function (name) {
+        db._drop(name);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the rule has no effect when explicitly disabled
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleDisabled : function () {
+      var query = join + "COLLECT WITH COUNT INTO n RETURN n";
+      var result = AQL_EXPLAIN(query, { }, paramNone);
+      assertEqual([ ], result.plan.rules);
+      assertEqual(names, loops(result.plan));
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that runs of up to 4 loops are still permuted exhaustively
+////////////////////////////////////////////////////////////////////////////////
+
+    testShortRunsPermuted : function () {
+      assertEqual(2, numberOfPlans("FOR a IN " + names[0] + " FOR b IN " + names[1] + " RETURN 1"));
+      assertEqual(6, numberOfPlans("FOR a IN " + names[0] + " FOR b IN " + names[1] + " FOR c IN " + names[2] + " RETURN 1"));
+      assertEqual(24, numberOfPlans("FOR a IN " + names[0] + " FOR b IN " + names[1] + " FOR c IN " + names[2] + " FOR d IN " + names[3] + " RETURN 1"));
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a long run gets a single greedy order, with the
+/// smallest collections and the most selective filters outermost
+////////////////////////////////////////////////////////////////////////////////
+
+    testLongRunGreedy : function () {
+      var query = join + "COLLECT WITH COUNT INTO n RETURN n";
+
+      // the original order and the greedy order
+      assertEqual(2, numberOfPlans(query));
+
+      var result = AQL_EXPLAIN(query, { }, paramEnabled);
+      assertEqual([ ruleName ], result.plan.rules);
+      assertEqual(names.slice().reverse(), loops(result.plan));
+
+      // 4 * 3 * 2 * 1 documents with e == 3
+      checkResults(query, [ 24 ]);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a run that is already in the greedy order is kept
+////////////////////////////////////////////////////////////////////////////////
+
+    testLongRunAlreadyOrdered : function () {
+      var query = "FOR e IN " + names[4] + " FOR d IN " + names[3] + " FOR c IN " + names[2] + " FOR b IN " + names[1] + " FOR a IN " + names[0] + " FILTER a.e == e.id && b.e == e.id && c.e == e.id && d.e == e.id && e.id == 3 COLLECT WITH COUNT INTO n RETURN n";
+
+      assertEqual(1, numberOfPlans(query));
+      var result = AQL_EXPLAIN(query, { }, paramEnabled);
+      assertEqual([ ], result.plan.rules);
+      checkResults(query, [ 24 ]);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a loop over another loop's variable stays inside of it
+////////////////////////////////////////////////////////////////////////////////
+
+    testLongRunDependencies : function () {
+      // x iterates over y directly, so there is no calculation between the
+      // loops and all 5 of them form a single run
+      var query = "FOR y IN [ [ 3, 8 ], [ 13 ] ] FOR b IN " + names[1] + " FOR c IN " + names[2] + " FOR x IN y FOR e IN " + names[4] + " FILTER b.e == e.id && c.e == e.id && e.id == 3 && b.value == x SORT x, c.value RETURN [ x, b.value, c.value ]";
+
+      var result = AQL_EXPLAIN(query, { }, paramEnabled);
+      assertEqual([ ruleName ], result.plan.rules);
+      var order = loops(result.plan);
+      assertEqual(5, order.length);
+      assertEqual(names[4], order[0], order);
+      assertTrue(order.indexOf("y") < order.indexOf("x"), order);
+
+      // b.value is one of 3, 8, 13 and c.value one of 3, 8 for e == 3
+      checkResults(query, [ [ 3, 3, 3 ], [ 3, 3, 8 ], [ 8, 8, 3 ], [ 8, 8, 8 ], [ 13, 13, 3 ], [ 13, 13, 8 ] ]);
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerRuleTestSuite);
+
+return jsunity.done();
@@ -0,0 +1,257 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertNotEqual, assertTrue, AQL_EXPLAIN, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for optimizer rule optimize-subqueries
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("@arangodb").db;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerRuleTestSuite () {
+  var ruleName = "optimize-subqueries";
+  var cn = "UnitTestsOptimizer";
+  // various choices to control the optimizer:
+  var paramNone     = { optimizer: { rules: [ "-all" ] } };
+  var paramEnabled  = { optimizer: { rules: [ "-all", "+" + ruleName ] } };
+  var paramDisabled = { optimizer: { rules: [ "+all", "-" + ruleName ] } };
+
+  // the node types inside the subqueries of a plan
+  var subqueryNodeTypes = function (plan) {
+    var types = [];
+    plan.nodes.forEach(function (node) {
+      if (node.type === "SubqueryNode") {
+        types.push(node.subquery.nodes.map(function (node) {
+          return node.type;
+        }));
+      }
+    });
+    return types;
+  };
+
+  // the query produces the same results with and without the rule
+  var checkResults = function (query, expected) {
+    var result = AQL_EXECUTE(query, { }, paramEnabled).json;
+    assertEqual(expected, result, query);
+    assertEqual(expected, AQL_EXECUTE(query, { }, paramDisabled).json, query);
+    assertEqual(expected, AQL_EXECUTE(query).json, query);
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop(cn);
+      var c = db._create(cn);
+      for (var i = 0; i < 20; ++i) {
+        c.insert({ value: i % 5 });
+      }
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop(cn);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the rule has no effect when explicitly disabled
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleDisabled : function () {
+      var queries = [
+        "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) RETURN LENGTH(x)",
+        "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) RETURN FIRST(x)"
+      ];
+
+      queries.forEach(function (query) {
+        var result = AQL_EXPLAIN(query, { }, paramNone);
+        assertEqual([ ], result.plan.rules, query);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the rule has no effect on subqueries that do not qualify
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleNoEffect : function () {
+      var queries = [
+        // the subquery result is used directly
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) RETURN x", [ [ 1 ], [ 1, 2 ], [ 1, 2, 3 ] ] ],
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) RETURN x[1]", [ null, 2, 2 ] ],
+        // other functions
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) RETURN LAST(x)", [ 1, 2, 3 ] ],
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) RETURN SUM(x)", [ 1, 3, 6 ] ],
+        // used in LENGTH and elsewhere
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) RETURN [ LENGTH(x), x ]", [ [ 1, [ 1 ] ], [ 2, [ 1, 2 ] ], [ 3, [ 1, 2, 3 ] ] ] ],
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) LET y = LENGTH(x) RETURN [ y, LAST(x) ]", [ [ 1, 1 ], [ 2, 2 ], [ 3, 3 ] ] ],
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) FILTER LENGTH(x) > 1 RETURN x", [ [ 1, 2 ], [ 1, 2, 3 ] ] ],
+        // used in LENGTH and FIRST
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j * 2) RETURN [ LENGTH(x), FIRST(x) ]", [ [ 1, 2 ], [ 2, 2 ], [ 3, 2 ] ] ],
+        // used outside of a calculation
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) COLLECT y = x WITH COUNT INTO n RETURN [ LENGTH(y), n ]", [ [ 1, 1 ], [ 2, 1 ], [ 3, 1 ] ] ],
+        [ "FOR i IN 1..2 LET x = (FOR j IN 1..i RETURN j) FOR k IN x RETURN LENGTH(x)", [ 1, 2, 2 ] ],
+        // the subquery is already limited to one row
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..i LIMIT 1 RETURN j) RETURN FIRST(x)", [ 1, 1, 1 ] ],
+        // the subquery result is not used at all
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) RETURN i", [ 1, 2, 3 ] ]
+      ];
+
+      queries.forEach(function (query) {
+        var result = AQL_EXPLAIN(query[0], { }, paramEnabled);
+        assertEqual([ ], result.plan.rules, query[0]);
+        checkResults(query[0], query[1]);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a modifying subquery is not changed
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleNoEffectModification : function () {
+      var query = "FOR i IN 1..3 LET x = (FOR j IN 1..i INSERT { value: -1 } INTO " + cn + " RETURN NEW) RETURN LENGTH(x)";
+
+      var result = AQL_EXPLAIN(query, { }, paramEnabled);
+      assertEqual(-1, result.plan.rules.indexOf(ruleName), query);
+
+      assertEqual([ 1, 2, 3 ], AQL_EXECUTE(query, { }, paramEnabled).json);
+      // all documents were inserted
+      assertEqual(6, db[cn].byExample({ value: -1 }).count());
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the subquery result is counted for LENGTH and COUNT
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleCount : function () {
+      var queries = [
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) RETURN LENGTH(x)", [ 1, 2, 3 ] ],
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) RETURN COUNT(x)", [ 1, 2, 3 ] ],
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) RETURN LENGTH(x) + COUNT(x) * 10", [ 11, 22, 33 ] ],
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) FILTER LENGTH(x) > 1 RETURN i", [ 2, 3 ] ],
+        [ "FOR i IN 0..4 LET x = (FOR d IN " + cn + " FILTER d.value == i RETURN d) RETURN LENGTH(x)", [ 4, 4, 4, 4, 4 ] ],
+        [ "FOR i IN 0..4 LET x = (FOR d IN " + cn + " FILTER d.value < i RETURN d) RETURN { i, n: COUNT(x) }", [ { i: 0, n: 0 }, { i: 1, n: 4 }, { i: 2, n: 8 }, { i: 3, n: 12 }, { i: 4, n: 16 } ] ]
+      ];
+
+      queries.forEach(function (query) {
+        var result = AQL_EXPLAIN(query[0], { }, paramEnabled);
+        assertEqual([ ruleName ], result.plan.rules, query[0]);
+
+        var types = subqueryNodeTypes(result.plan);
+        assertEqual(1, types.length, query[0]);
+        // the subquery returns the count of its rows
+        assertEqual([ "CollectNode", "ReturnNode" ], types[0].slice(-2), query[0]);
+
+        checkResults(query[0], query[1]);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that empty subqueries are counted as 0 and have no first row
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleEmpty : function () {
+      var queries = [
+        [ "FOR i IN 1..3 LET x = (FOR j IN [ ] RETURN j) RETURN LENGTH(x)", [ 0, 0, 0 ] ],
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..10 FILTER j > i * 3 RETURN j) RETURN COUNT(x)", [ 7, 4, 1 ] ],
+        [ "FOR i IN 1..3 LET x = (FOR d IN " + cn + " FILTER d.value == 99 RETURN d) RETURN LENGTH(x)", [ 0, 0, 0 ] ],
+        [ "FOR i IN 1..3 LET x = (FOR j IN [ ] RETURN j) RETURN FIRST(x)", [ null, null, null ] ],
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..3 FILTER j > i RETURN j) RETURN FIRST(x)", [ 2, 3, null ] ]
+      ];
+
+      queries.forEach(function (query) {
+        var result = AQL_EXPLAIN(query[0], { }, paramEnabled);
+        assertEqual([ ruleName ], result.plan.rules, query[0]);
+        checkResults(query[0], query[1]);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the subquery is limited to one row for FIRST
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleFirst : function () {
+      var queries = [
+        [ "FOR i IN 1..3 LET x = (FOR j IN i..5 RETURN j) RETURN FIRST(x)", [ 1, 2, 3 ] ],
+        [ "FOR i IN 1..3 LET x = (FOR j IN i..5 RETURN j) RETURN [ i, FIRST(x) ]", [ [ 1, 1 ], [ 2, 2 ], [ 3, 3 ] ] ],
+        [ "FOR i IN 1..3 LET x = (FOR j IN 1..5 SORT j DESC RETURN j * i) RETURN FIRST(x)", [ 5, 10, 15 ] ],
+        [ "FOR i IN 1..3 LET x = (FOR j IN i..5 LIMIT 2 RETURN j) RETURN FIRST(x)", [ 1, 2, 3 ] ]
+      ];
+
+      queries.forEach(function (query) {
+        var result = AQL_EXPLAIN(query[0], { }, paramEnabled);
+        assertEqual([ ruleName ], result.plan.rules, query[0]);
+
+        var limits = [ ];
+        result.plan.nodes.forEach(function (node) {
+          if (node.type === "SubqueryNode") {
+            limits = node.subquery.nodes.filter(function (node) {
+              return node.type === "LimitNode";
+            });
+          }
+        });
+        assertNotEqual(0, limits.length, query[0]);
+        // the injected LIMIT is right before the RETURN
+        assertEqual(0, limits[limits.length - 1].offset, query[0]);
+        assertEqual(1, limits[limits.length - 1].limit, query[0]);
+
+        checkResults(query[0], query[1]);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that several subqueries are optimized independently
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleMultipleSubqueries : function () {
+      var query = "FOR i IN 1..3 LET x = (FOR j IN 1..i RETURN j) LET y = (FOR j IN i..3 RETURN j) LET z = (FOR j IN 1..i RETURN j) RETURN [ LENGTH(x), FIRST(y), z ]";
+
+      var result = AQL_EXPLAIN(query, { }, paramEnabled);
+      assertEqual([ ruleName ], result.plan.rules);
+      var types = subqueryNodeTypes(result.plan);
+      assertEqual(3, types.length);
+      assertTrue(types.some(function (t) { return t.indexOf("CollectNode") !== -1; }));
+      assertTrue(types.some(function (t) { return t.indexOf("LimitNode") !== -1; }));
+
+      checkResults(query, [ [ 1, 1, [ 1 ] ], [ 2, 2, [ 1, 2 ] ], [ 3, 3, [ 1, 2, 3 ] ] ]);
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerRuleTestSuite);
+
+return jsunity.done();
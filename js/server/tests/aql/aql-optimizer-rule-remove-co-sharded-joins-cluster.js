@@ -0,0 +1,180 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertNotEqual, AQL_EXPLAIN, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for optimizer rule remove-co-sharded-joins
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("@arangodb").db;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerRuleTestSuite () {
+  var ruleName = "remove-co-sharded-joins";
+  // outer collection, co-sharded collection, independent collection
+  var cn1 = "UnitTestsOptimizer1";
+  var cn2 = "UnitTestsOptimizer2";
+  var cn3 = "UnitTestsOptimizer3";
+  // the same with custom shard keys
+  var cn4 = "UnitTestsOptimizer4";
+  var cn5 = "UnitTestsOptimizer5";
+  var n = 100;
+  var paramDisabled = { optimizer: { rules: [ "+all", "-" + ruleName ] } };
+
+  var count = function (plan, type) {
+    return plan.nodes.filter(function (node) {
+      return node.type === type;
+    }).length;
+  };
+
+  // sorts the result, so that it does not depend on the shard order
+  var sorted = function (result) {
+    return result.map(function (row) {
+      return JSON.stringify(row);
+    }).sort();
+  };
+
+  var dropCollections = function () {
+    [ cn5, cn4, cn3, cn2, cn1 ].forEach(function (cn) {
+      db._drop(cn);
+    });
+  };
+
+  // the query produces the same results with and without the rule
+  var checkResults = function (query, expectedLength) {
+    var expected = AQL_EXECUTE(query, { }, paramDisabled).json;
+    assertEqual(expectedLength, expected.length, query);
+    assertEqual(sorted(expected), sorted(AQL_EXECUTE(query).json), query);
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      dropCollections();
+      db._create(cn1, { numberOfShards: 4 });
+      db._create(cn2, { numberOfShards: 4, distributeShardsLike: cn1 });
+      db._create(cn3, { numberOfShards: 4 });
+      db._create(cn4, { numberOfShards: 3, shardKeys: [ "value" ] });
+      db._create(cn5, { numberOfShards: 3, shardKeys: [ "ref" ], distributeShardsLike: cn4 });
+
+      var docs = [], refs = [];
+      for (var i = 0; i < n; ++i) {
+        docs.push({ _key: "test" + i, value: i });
+        refs.push({ _key: "test" + i, ref: i, other: i % 10 });
+      }
+      db[cn1].insert(docs);
+      db[cn2].insert(refs);
+      db[cn3].insert(refs);
+      db[cn4].insert(docs.map(function (doc) { return { value: doc.value }; }));
+      db[cn5].insert(refs.map(function (doc) { return { ref: doc.ref, other: doc.other }; }));
+      // a second matching document for some of the outer documents
+      db[cn5].insert({ ref: 7, other: -1 });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      dropCollections();
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that joins of co-sharded collections on the shard keys run in
+/// one DB server part
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleJoinsOnShardKeys : function () {
+      var queries = [
+        // index lookup on the primary index
+        [ "FOR a IN " + cn1 + " FOR b IN " + cn2 + " FILTER b._key == a._key RETURN [ a.value, b.ref ]", n ],
+        [ "FOR a IN " + cn1 + " FOR b IN " + cn2 + " FILTER a._key == b._key && b.other == 3 RETURN [ a.value, b.ref ]", 10 ],
+        // custom shard keys, no index
+        [ "FOR a IN " + cn4 + " FOR b IN " + cn5 + " FILTER b.ref == a.value RETURN [ a.value, b.other ]", n + 1 ],
+        [ "FOR a IN " + cn4 + " FILTER a.value < 10 FOR b IN " + cn5 + " FILTER a.value == b.ref SORT b.other RETURN [ a.value, b.other ]", 11 ]
+      ];
+
+      queries.forEach(function (query) {
+        var result = AQL_EXPLAIN(query[0]);
+        assertNotEqual(-1, result.plan.rules.indexOf(ruleName), query[0]);
+        assertEqual(0, count(result.plan, "ScatterNode"), query[0]);
+        assertEqual(1, count(result.plan, "RemoteNode"), query[0]);
+        assertEqual(1, count(result.plan, "GatherNode"), query[0]);
+
+        checkResults(query[0], query[1]);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a sorted join is still sorted when the parts are merged
+////////////////////////////////////////////////////////////////////////////////
+
+    testSortedJoin : function () {
+      var query = "FOR a IN " + cn4 + " FOR b IN " + cn5 + " FILTER b.ref == a.value SORT b.ref DESC, b.other LIMIT 5 RETURN [ b.ref, b.other ]";
+      assertNotEqual(-1, AQL_EXPLAIN(query).plan.rules.indexOf(ruleName));
+      assertEqual([ [ 99, 9 ], [ 98, 8 ], [ 97, 7 ], [ 96, 6 ], [ 95, 5 ] ], AQL_EXECUTE(query).json);
+
+      query = "FOR a IN " + cn4 + " FOR b IN " + cn5 + " FILTER b.ref == a.value && a.value == 7 SORT b.other RETURN b.other";
+      assertEqual([ -1, 7 ], AQL_EXECUTE(query).json);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the rule has no effect on other joins
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleNoEffect : function () {
+      var queries = [
+        // the collections are not co-sharded
+        [ "FOR a IN " + cn1 + " FOR b IN " + cn3 + " FILTER b._key == a._key RETURN [ a.value, b.ref ]", n ],
+        // not joined on the shard keys
+        [ "FOR a IN " + cn1 + " FOR b IN " + cn2 + " FILTER b.ref == a.value RETURN [ a.value, b.ref ]", n ],
+        [ "FOR a IN " + cn4 + " FOR b IN " + cn5 + " FILTER b.other == a.value RETURN [ a.value, b.other ]", n ],
+        [ "FOR a IN " + cn4 + " FOR b IN " + cn5 + " FILTER b.ref == a.value || b.ref == a.value + 1 RETURN [ a.value, b.other ]", 2 * n + 1 ],
+        // the shard key is compared with another attribute of the outer document
+        [ "FOR a IN " + cn1 + " FOR b IN " + cn2 + " FILTER b._key == CONCAT('test', a.value + 1) RETURN [ a.value, b.ref ]", n - 1 ]
+      ];
+
+      queries.forEach(function (query) {
+        var result = AQL_EXPLAIN(query[0]);
+        assertEqual(-1, result.plan.rules.indexOf(ruleName), query[0]);
+        checkResults(query[0], query[1]);
+      });
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerRuleTestSuite);
+
+return jsunity.done();
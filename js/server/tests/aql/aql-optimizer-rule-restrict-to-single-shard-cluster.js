@@ -0,0 +1,159 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertNotEqual, AQL_EXPLAIN, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for optimizer rule restrict-to-single-shard
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("@arangodb").db;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerRuleTestSuite () {
+  var ruleName = "restrict-to-single-shard";
+  // default shard key, custom shard keys, range sharding
+  var cn1 = "UnitTestsOptimizer1";
+  var cn2 = "UnitTestsOptimizer2";
+  var cn3 = "UnitTestsOptimizer3";
+  var n = 300;
+  var paramDisabled = { optimizer: { rules: [ "+all", "-" + ruleName ] } };
+
+  var dropCollections = function () {
+    [ cn1, cn2, cn3 ].forEach(function (cn) {
+      db._drop(cn);
+    });
+  };
+
+  // sorts the result, so that it does not depend on the shard order
+  var sorted = function (result) {
+    return result.map(function (row) {
+      return JSON.stringify(row);
+    }).sort();
+  };
+
+  // the query produces the same results with and without the rule
+  var checkResults = function (query, expectedLength) {
+    var expected = AQL_EXECUTE(query, { }, paramDisabled).json;
+    assertEqual(expectedLength, expected.length, query);
+    assertEqual(sorted(expected), sorted(AQL_EXECUTE(query).json), query);
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      dropCollections();
+      db._create(cn1, { numberOfShards: 5 });
+      db._create(cn2, { numberOfShards: 5, shardKeys: [ "a", "b" ] });
+      db._create(cn3, { numberOfShards: 3, shardKeys: [ "value" ], shardBoundaries: [ 100, 200 ] });
+
+      var docs = [];
+      for (var i = 0; i < n; ++i) {
+        docs.push({ _key: "test" + i, value: i, a: i % 10, b: "b" + (i % 3) });
+      }
+      db[cn1].insert(docs);
+      db[cn2].insert(docs.map(function (doc) { return { value: doc.value, a: doc.a, b: doc.b }; }));
+      db[cn3].insert(docs.map(function (doc) { return { value: doc.value }; }));
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      dropCollections();
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that reads pinning all shard keys are restricted
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleRestricts : function () {
+      var queries = [
+        [ "FOR d IN " + cn1 + " FILTER d._key == 'test17' RETURN d.value", 1 ],
+        [ "FOR d IN " + cn1 + " FILTER d._key == 'missing' RETURN d.value", 0 ],
+        [ "FOR d IN " + cn1 + " FILTER 'test17' == d._key && d.value == 17 RETURN d.value", 1 ],
+        [ "FOR d IN " + cn2 + " FILTER d.a == 4 && d.b == 'b1' RETURN d.value", 10 ],
+        [ "FOR d IN " + cn2 + " FILTER d.a == 4 FILTER d.b == 'b1' SORT d.value LIMIT 3 RETURN d.value", 3 ],
+        // both reads of the collection go to the same shard
+        [ "FOR x IN " + cn1 + " FILTER x._key == 'test3' FOR y IN " + cn1 + " FILTER y._key == 'test3' RETURN [ x.value, y.value ]", 1 ],
+        // range sharding
+        [ "FOR d IN " + cn3 + " FILTER d.value >= 120 && d.value < 150 RETURN d.value", 30 ],
+        [ "FOR d IN " + cn3 + " FILTER d.value == 250 RETURN d.value", 1 ],
+        // two of the three shards
+        [ "FOR d IN " + cn3 + " FILTER d.value > 90 && d.value <= 110 RETURN d.value", 20 ]
+      ];
+
+      queries.forEach(function (query) {
+        var result = AQL_EXPLAIN(query[0]);
+        assertNotEqual(-1, result.plan.rules.indexOf(ruleName), query[0]);
+        checkResults(query[0], query[1]);
+      });
+
+      assertEqual([ 17 ], AQL_EXECUTE(queries[0][0]).json);
+      assertEqual([ 4, 34, 64 ], AQL_EXECUTE(queries[4][0]).json);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that other reads are not restricted
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleNoEffect : function () {
+      var queries = [
+        [ "FOR d IN " + cn1 + " RETURN d.value", n ],
+        [ "FOR d IN " + cn1 + " FILTER d.value == 17 RETURN d.value", 1 ],
+        [ "FOR d IN " + cn1 + " FILTER d._key IN [ 'test1', 'test2' ] RETURN d.value", 2 ],
+        [ "FOR d IN " + cn1 + " FILTER d._key == 'test1' || d._key == 'test2' RETURN d.value", 2 ],
+        // only one of the shard keys is pinned
+        [ "FOR d IN " + cn2 + " FILTER d.a == 4 RETURN d.value", 30 ],
+        // the keys are compared with non-constant values
+        [ "FOR d IN " + cn2 + " FILTER d.a == d.value % 10 && d.b == 'b1' RETURN d.value", 100 ],
+        // one of the reads of the collection is not restricted
+        [ "FOR x IN " + cn1 + " FILTER x._key == 'test3' FOR y IN " + cn1 + " FILTER y.value == x.value + 1 RETURN [ x.value, y.value ]", 1 ],
+        // the collection is modified
+        [ "FOR d IN " + cn1 + " FILTER d._key == 'test5' UPDATE d WITH { updated: true } IN " + cn1 + " RETURN NEW.value", 1 ]
+      ];
+
+      queries.forEach(function (query) {
+        var result = AQL_EXPLAIN(query[0]);
+        assertEqual(-1, result.plan.rules.indexOf(ruleName), query[0]);
+        checkResults(query[0], query[1]);
+      });
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerRuleTestSuite);
+
+return jsunity.done();
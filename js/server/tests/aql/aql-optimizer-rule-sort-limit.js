@@ -0,0 +1,203 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, AQL_EXPLAIN, AQL_EXECUTE */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for optimizer rule sort-limit
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("@arangodb").db;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerRuleTestSuite () {
+  var ruleName = "sort-limit";
+  var cn = "UnitTestsOptimizer";
+  // various choices to control the optimizer:
+  var paramNone     = { optimizer: { rules: [ "-all" ] } };
+  var paramEnabled  = { optimizer: { rules: [ "-all", "+" + ruleName ] } };
+  var paramDisabled = { optimizer: { rules: [ "+all", "-" + ruleName ] } };
+
+  // the limits of the SortNodes of a plan
+  var sortLimits = function (query, params) {
+    return AQL_EXPLAIN(query, { }, params).plan.nodes.filter(function (node) {
+      return node.type === "SortNode";
+    }).map(function (node) {
+      return node.limit;
+    });
+  };
+
+  // the query produces the same results with and without the rule
+  var checkResults = function (query, expected) {
+    assertEqual(expected, AQL_EXECUTE(query, { }, paramEnabled).json, query);
+    assertEqual(expected, AQL_EXECUTE(query, { }, paramDisabled).json, query);
+    assertEqual(expected, AQL_EXECUTE(query).json, query);
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop(cn);
+      var c = db._create(cn);
+      var docs = [];
+      for (var i = 0; i < 2000; ++i) {
+        // value is unique, group has 10 different values
+        docs.push({ _key: "test" + i, value: (i * 7919) % 2000, group: i % 10 });
+      }
+      c.insert(docs);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop(cn);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the rule has no effect when explicitly disabled
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleDisabled : function () {
+      var query = "FOR d IN " + cn + " SORT d.value LIMIT 10 RETURN d.value";
+      var result = AQL_EXPLAIN(query, { }, paramNone);
+      assertEqual([ ], result.plan.rules);
+      assertEqual([ 0 ], sortLimits(query, paramNone));
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the rule has no effect on sorts that are not limited
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleNoEffect : function () {
+      var queries = [
+        "FOR d IN " + cn + " SORT d.value RETURN d.value",
+        // the limit is not directly after the sort
+        "FOR d IN " + cn + " SORT d.value FILTER d.group == 1 LIMIT 10 RETURN d.value",
+        "FOR d IN " + cn + " SORT d.value FOR i IN 1..2 LIMIT 10 RETURN d.value",
+        "FOR d IN " + cn + " SORT d.value COLLECT g = d.group INTO values LIMIT 2 RETURN g",
+        // fullCount needs all rows
+        "FOR d IN " + cn + " SORT d.value LIMIT 10 RETURN d.value",
+        // the limit is 0
+        "FOR d IN " + cn + " SORT d.value LIMIT 10, 0 RETURN d.value"
+      ];
+      var options = [ { }, { }, { }, { }, { fullCount: true }, { } ];
+
+      queries.forEach(function (query, i) {
+        var params = { optimizer: paramEnabled.optimizer, fullCount: options[i].fullCount };
+        var result = AQL_EXPLAIN(query, { }, params);
+        assertEqual([ ], result.plan.rules, query);
+        sortLimits(query, params).forEach(function (limit) {
+          assertEqual(0, limit, query);
+        });
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the sort is limited to offset + limit rows
+////////////////////////////////////////////////////////////////////////////////
+
+    testRuleLimits : function () {
+      var queries = [
+        [ "FOR d IN " + cn + " SORT d.value LIMIT 10 RETURN d.value", 10 ],
+        [ "FOR d IN " + cn + " SORT d.value LIMIT 5, 10 RETURN d.value", 15 ],
+        [ "FOR d IN " + cn + " SORT d.value LIMIT 1990, 100 RETURN d.value", 2090 ],
+        [ "FOR d IN " + cn + " SORT d.value DESC LET v = d.value * 2 LIMIT 3 RETURN v", 3 ],
+        [ "FOR d IN " + cn + " SORT d.group, d.value DESC LIMIT 20 RETURN d.value", 20 ]
+      ];
+
+      queries.forEach(function (query) {
+        var result = AQL_EXPLAIN(query[0], { }, paramEnabled);
+        assertEqual([ ruleName ], result.plan.rules, query[0]);
+        assertEqual([ query[1] ], sortLimits(query[0], paramEnabled), query[0]);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the results of limited sorts
+////////////////////////////////////////////////////////////////////////////////
+
+    testResults : function () {
+      var range = function (from, to, step) {
+        var result = [];
+        for (var i = from; step > 0 ? i < to : i > to; i += step) {
+          result.push(i);
+        }
+        return result;
+      };
+
+      checkResults("FOR d IN " + cn + " SORT d.value LIMIT 10 RETURN d.value", range(0, 10, 1));
+      checkResults("FOR d IN " + cn + " SORT d.value LIMIT 5, 10 RETURN d.value", range(5, 15, 1));
+      checkResults("FOR d IN " + cn + " SORT d.value DESC LIMIT 3 RETURN d.value * 2", [ 3998, 3996, 3994 ]);
+      checkResults("FOR d IN " + cn + " SORT d.value LIMIT 1995, 100 RETURN d.value", range(1995, 2000, 1));
+      checkResults("FOR d IN " + cn + " SORT d.value LIMIT 2000, 10 RETURN d.value", [ ]);
+      checkResults("FOR d IN " + cn + " FILTER d.value < 5 SORT d.value DESC LIMIT 10 RETURN d.value", [ 4, 3, 2, 1, 0 ]);
+      checkResults("FOR d IN " + cn + " SORT d.group DESC, d.value LIMIT 3 RETURN [ d.group, d.value ]", [ [ 9, 1 ], [ 9, 11 ], [ 9, 21 ] ]);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that rows with equal sort values keep their input order
+////////////////////////////////////////////////////////////////////////////////
+
+    testTies : function () {
+      var query = "FOR i IN 1..100 SORT i % 3 LIMIT 2, 5 RETURN i";
+      assertEqual([ ruleName ], AQL_EXPLAIN(query, { }, paramEnabled).plan.rules);
+      assertEqual([ 9, 12, 15, 18, 21 ], AQL_EXECUTE(query, { }, paramEnabled).json);
+
+      query = "FOR i IN 1..100 SORT i % 2 DESC LIMIT 4 RETURN i";
+      assertEqual([ 1, 3, 5, 7 ], AQL_EXECUTE(query, { }, paramEnabled).json);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test a limited sort that is executed once per outer row
+////////////////////////////////////////////////////////////////////////////////
+
+    testSubquery : function () {
+      var query = "FOR g IN 0..2 LET top = (FOR d IN " + cn + " FILTER d.group == g SORT d.value DESC LIMIT 2 RETURN d.value) RETURN top";
+      assertEqual([ ruleName ], AQL_EXPLAIN(query, { }, paramEnabled).plan.rules);
+
+      var expected = [0, 1, 2].map(function (g) {
+        return db._query("FOR d IN " + cn + " FILTER d.group == @g RETURN d.value", { g: g }).toArray().sort(function (l, r) {
+          return r - l;
+        }).slice(0, 2);
+      });
+      checkResults(query, expected);
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerRuleTestSuite);
+
+return jsunity.done();
@@ -0,0 +1,151 @@
+/*jshint globalstrict:false, strict:false, maxlen: 500 */
+/*global assertEqual, assertTrue, fail, AQL_EXPLAIN */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for the FILTER estimates from attribute statistics
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("@arangodb").db;
+var internal = require("internal");
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function optimizerSelectivityTestSuite () {
+  var cn1 = "UnitTestsSelectivity1";
+  var cn2 = "UnitTestsSelectivity2";
+  var n = 2000;
+
+  var filterEstimates = function (query) {
+    return AQL_EXPLAIN(query).plan.nodes.filter(function (node) {
+      return node.type === "FilterNode";
+    }).map(function (node) {
+      return node.estimatedNrItems;
+    });
+  };
+
+  var collections = function (query) {
+    return AQL_EXPLAIN(query).plan.nodes.filter(function (node) {
+      return node.type === "EnumerateCollectionNode";
+    }).map(function (node) {
+      return node.collection;
+    });
+  };
+
+  // the statistics are gathered by the background thread once a minute
+  var waitForStatistics = function (query) {
+    for (var i = 0; i < 300; ++i) {
+      if (filterEstimates(query)[0] < n) {
+        return;
+      }
+      internal.wait(1, false);
+    }
+    fail();
+  };
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      [ cn1, cn2 ].forEach(function (cn) {
+        db._drop(cn);
+        db._create(cn);
+        // status is "a" in 90% of the documents, "b" in 10%, value is unique
+        db._query("FOR i IN 0.." + (n - 1) + " INSERT { value: i, status: i % 10 == 0 ? 'b' : 'a' } INTO " + cn);
+      });
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop(cn1);
+      db._drop(cn2);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the FILTER estimates follow the distribution of the values once
+/// the collection has statistics
+////////////////////////////////////////////////////////////////////////////////
+
+    testFilterEstimates : function () {
+      var common = "FOR d IN " + cn1 + " FILTER d.status == 'a' RETURN d";
+      var rare = "FOR d IN " + cn1 + " FILTER d.status == 'b' RETURN d";
+      var unique = "FOR d IN " + cn1 + " FILTER d.value == 5 RETURN d";
+      var none = "FOR d IN " + cn1 + " FILTER d.status == 'a' && d.status == 'b' RETURN d";
+
+      // without statistics a FILTER does not reduce the estimate
+      assertEqual([ n ], filterEstimates(common));
+      assertEqual([ n ], filterEstimates(unique));
+
+      waitForStatistics(unique);
+
+      var estimate = filterEstimates(common)[0];
+      assertTrue(estimate > 0.8 * n && estimate < n, estimate);
+      estimate = filterEstimates(rare)[0];
+      assertTrue(estimate > 0.05 * n && estimate < 0.15 * n, estimate);
+      estimate = filterEstimates(unique)[0];
+      assertTrue(estimate >= 1 && estimate < 10, estimate);
+      estimate = filterEstimates(none)[0];
+      assertTrue(estimate >= 1 && estimate < 0.15 * n, estimate);
+      estimate = filterEstimates("FOR d IN " + cn1 + " FILTER d.status IN [ 'a', 'b' ] RETURN d")[0];
+      assertTrue(estimate > 0.9 * n, estimate);
+      estimate = filterEstimates("FOR d IN " + cn1 + " FILTER d.status != 'a' RETURN d")[0];
+      assertTrue(estimate < 0.2 * n, estimate);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the loop with the selective FILTER becomes the outer loop once
+/// the collections have statistics
+////////////////////////////////////////////////////////////////////////////////
+
+    testJoinOrder : function () {
+      var query = "FOR x IN " + cn1 + " FILTER x.status == 'a' FOR y IN " + cn2 + " FILTER y.value == 5 RETURN [ x.value, y.value ]";
+
+      waitForStatistics("FOR d IN " + cn1 + " FILTER d.value == 5 RETURN d");
+      waitForStatistics("FOR d IN " + cn2 + " FILTER d.value == 5 RETURN d");
+
+      assertEqual([ cn2, cn1 ], collections(query));
+      var result = db._query(query).toArray();
+      assertEqual(0.9 * n, result.length);
+      result.forEach(function (row) {
+        assertEqual(5, row[1]);
+      });
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(optimizerSelectivityTestSuite);
+
+return jsunity.done();
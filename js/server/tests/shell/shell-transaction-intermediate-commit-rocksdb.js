@@ -0,0 +1,182 @@
+/*jshint globalstrict:false, strict:false */
+/*global assertEqual, assertTrue */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tests for transactions with intermediate commits
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+var jsunity = require("jsunity");
+var db = require("@arangodb").db;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite
+////////////////////////////////////////////////////////////////////////////////
+
+function transactionIntermediateCommitSuite () {
+  var cn = "UnitTestsTransaction";
+  var c;
+
+  return {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set up
+////////////////////////////////////////////////////////////////////////////////
+
+    setUp : function () {
+      db._drop(cn);
+      c = db._create(cn);
+      var docs = [];
+      for (var i = 0; i < 1000; ++i) {
+        docs.push({ _key: "old" + i, value: i });
+      }
+      c.insert(docs);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tear down
+////////////////////////////////////////////////////////////////////////////////
+
+    tearDown : function () {
+      db._drop(cn);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the count includes the documents from before the transaction and
+/// the committed and uncommitted parts of the transaction
+////////////////////////////////////////////////////////////////////////////////
+
+    testCountAfterIntermediateCommits : function () {
+      var result = db._executeTransaction({
+        collections: { write: cn },
+        intermediateCommitCount: 100,
+        action: function (params) {
+          var db = require("@arangodb").db;
+          var c = db._collection(params.cn);
+          var counts = [ c.count() ];
+
+          // 10 intermediate commits and 50 uncommitted inserts
+          for (var i = 0; i < 1050; ++i) {
+            c.insert({ _key: "new" + i, value: 1000 + i });
+          }
+          counts.push(c.count());
+          counts.push(db._query("FOR d IN " + params.cn + " COLLECT WITH COUNT INTO n RETURN n").toArray()[0]);
+
+          // 3 more intermediate commits
+          for (i = 0; i < 300; ++i) {
+            c.remove("old" + i);
+          }
+          counts.push(c.count());
+          counts.push(db._query("FOR d IN " + params.cn + " COLLECT WITH COUNT INTO n RETURN n").toArray()[0]);
+          return counts;
+        },
+        params: { cn: cn }
+      });
+
+      assertEqual([ 1000, 2050, 2050, 1750, 1750 ], result);
+      assertEqual(1750, c.count());
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief documents written before an intermediate commit can be read
+/// afterwards, by key and by AQL
+////////////////////////////////////////////////////////////////////////////////
+
+    testReadsAfterIntermediateCommits : function () {
+      var result = db._executeTransaction({
+        collections: { write: cn },
+        intermediateCommitCount: 100,
+        action: function (params) {
+          var db = require("@arangodb").db;
+          var c = db._collection(params.cn);
+
+          for (var i = 0; i < 250; ++i) {
+            c.insert({ _key: "new" + i, value: 1000 + i });
+          }
+          for (i = 0; i < 150; ++i) {
+            c.update("old" + i, { updated: true });
+          }
+
+          var result = {
+            first: c.document("new0").value,
+            last: c.document("new249").value,
+            old: c.document("old999").value,
+            updated: c.document("old0").updated,
+            inserted: db._query("FOR d IN " + params.cn + " FILTER d.value >= 1000 RETURN d._key").toArray().length,
+            updatedQuery: db._query("FOR d IN " + params.cn + " FILTER d.updated == true RETURN d._key").toArray().length
+          };
+          return result;
+        },
+        params: { cn: cn }
+      });
+
+      assertEqual(1000, result.first);
+      assertEqual(1249, result.last);
+      assertEqual(999, result.old);
+      assertTrue(result.updated);
+      assertEqual(250, result.inserted);
+      assertEqual(150, result.updatedQuery);
+
+      assertEqual(1250, c.count());
+      assertEqual(1249, c.document("new249").value);
+      assertTrue(c.document("old149").updated);
+    },
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the committed parts stay when the transaction aborts later
+////////////////////////////////////////////////////////////////////////////////
+
+    testAbortAfterIntermediateCommits : function () {
+      var aborted = false;
+      try {
+        db._executeTransaction({
+          collections: { write: cn },
+          intermediateCommitCount: 100,
+          action: function (params) {
+            var db = require("@arangodb").db;
+            var c = db._collection(params.cn);
+            for (var i = 0; i < 150; ++i) {
+              c.insert({ _key: "new" + i });
+            }
+            throw "abort";
+          },
+          params: { cn: cn }
+        });
+      } catch (err) {
+        aborted = true;
+      }
+
+      assertTrue(aborted);
+      assertEqual(1100, c.count());
+      assertEqual(1100, db._query("FOR d IN " + cn + " RETURN 1").toArray().length);
+    }
+
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the test suite
+////////////////////////////////////////////////////////////////////////////////
+
+jsunity.run(transactionIntermediateCommitSuite);
+
+return jsunity.done();
@@ -52,8 +52,15 @@ RocksDBOptionFeature::RocksDBOptionFeature(
     application_features::ApplicationServer* server)
     : application_features::ApplicationFeature(server, "RocksDBOption"),
       _transactionLockTimeout(rocksDBTrxDefaults.transaction_lock_timeout),
+      _dedicatedCompactionStyle("level"),
+      _dedicatedCompression("snappy"),
+      _documentsCompression("snappy"),
+      _documentsCompressionDictionarySize(0),
+      _dedicatedBlockCacheSize(0),
+      _dedicatedBloomFilterBits(10),
       _writeBufferSize(rocksDBDefaults.write_buffer_size),
       _maxWriteBufferNumber(rocksDBDefaults.max_write_buffer_number),
+      _totalWriteBufferSize(0),
       _maxTotalWalSize(80 << 20),
       _delayedWriteRate(rocksDBDefaults.delayed_write_rate),
       _minWriteBufferNumberToMerge(
@@ -64,6 +71,8 @@ RocksDBOptionFeature::RocksDBOptionFeature(
       _maxBytesForLevelMultiplier(
           rocksDBDefaults.max_bytes_for_level_multiplier),
       _maxBackgroundJobs(rocksDBDefaults.max_background_jobs),
+      _maxBackgroundFlushes(rocksDBDefaults.max_background_flushes),
+      _maxBackgroundCompactions(rocksDBDefaults.max_background_compactions),
       _maxSubcompactions(rocksDBDefaults.max_subcompactions),
       _numThreadsHigh(0),
       _numThreadsLow(0),
@@ -74,9 +83,13 @@ RocksDBOptionFeature::RocksDBOptionFeature(
       _tableBlockSize(std::max(rocksDBTableOptionsDefaults.block_size, static_cast<decltype(rocksDBTableOptionsDefaults.block_size)>(16 * 1024))),
       _recycleLogFileNum(rocksDBDefaults.recycle_log_file_num),
       _compactionReadaheadSize(2 * 1024 * 1024),//rocksDBDefaults.compaction_readahead_size
+      _rateLimit(0),
+      _throttleQueueLength(0),
       _level0CompactionTrigger(2),
       _level0SlowdownTrigger(rocksDBDefaults.level0_slowdown_writes_trigger),
       _level0StopTrigger(rocksDBDefaults.level0_stop_writes_trigger),
+      _rateLimitAutoTune(false),
+      _adaptiveWriteBuffers(false),
       _enablePipelinedWrite(rocksDBDefaults.enable_pipelined_write),
       _optimizeFiltersForHits(rocksDBDefaults.optimize_filters_for_hits),
       _useDirectReads(rocksDBDefaults.use_direct_reads),
@@ -129,6 +142,19 @@ void RocksDBOptionFeature::collectOptions(
                      "maximum number of write buffers that built up in memory",
                      new UInt64Parameter(&_maxWriteBufferNumber));
   
+  options->addOption("--rocksdb.total-write-buffer-size",
+                     "maximum amount of memory used by the write buffers of "
+                     "all column families, a full budget triggers flushes "
+                     "(0 = a quarter of the memory budget if set, else "
+                     "unlimited)",
+                     new UInt64Parameter(&_totalWriteBufferSize));
+
+  options->addOption("--rocksdb.adaptive-write-buffers",
+                     "if true, grow the write buffers and the level-0 "
+                     "slowdown trigger while writes are stalled, and shrink "
+                     "them back when writes are idle",
+                     new BooleanParameter(&_adaptiveWriteBuffers));
+
   options->addOption("--rocksdb.max-total-wal-size",
                      "maximum total size of WAL files that will force flush stale column families",
                      new UInt64Parameter(&_maxTotalWalSize));
@@ -209,6 +235,18 @@ void RocksDBOptionFeature::collectOptions(
       "Maximum number of concurrent background jobs (compactions and flushes)",
       new Int32Parameter(&_maxBackgroundJobs));
 
+  options->addOption("--rocksdb.max-background-flushes",
+                     "maximum number of concurrent flushes, run in the high "
+                     "priority thread pool (-1 = derive from "
+                     "max-background-jobs)",
+                     new Int32Parameter(&_maxBackgroundFlushes));
+
+  options->addOption("--rocksdb.max-background-compactions",
+                     "maximum number of concurrent compactions, run in the "
+                     "low priority thread pool (-1 = derive from "
+                     "max-background-jobs)",
+                     new Int32Parameter(&_maxBackgroundCompactions));
+
   options->addOption("--rocksdb.max-subcompactions",
                      "maximum number of concurrent subjobs for a background "
                      "compaction",
@@ -260,6 +298,59 @@ void RocksDBOptionFeature::collectOptions(
       "reads.",
       new UInt64Parameter(&_compactionReadaheadSize));
 
+  options->addOption("--rocksdb.rate-limit",
+                     "maximum number of bytes per second written by flushes "
+                     "and compactions. flushes take precedence (0 = unlimited)",
+                     new UInt64Parameter(&_rateLimit));
+
+  options->addOption("--rocksdb.rate-limit-auto-tune",
+                     "if true, adjust the rate limit to the background write "
+                     "load, between 1/16 of and the full rate-limit",
+                     new BooleanParameter(&_rateLimitAutoTune));
+
+  options->addOption("--rocksdb.throttle-queue-length",
+                     "lower the rate limit while more requests than this wait "
+                     "in the scheduler queue (0 = never)",
+                     new UInt64Parameter(&_throttleQueueLength));
+
+  options->addOption("--rocksdb.dedicated-compaction-style",
+                     "compaction style of the column families of collections "
+                     "created with a dedicated column family",
+                     new DiscreteValuesParameter<StringParameter>(
+                         &_dedicatedCompactionStyle,
+                         std::unordered_set<std::string>{"level", "universal"}));
+
+  options->addOption("--rocksdb.dedicated-compression",
+                     "compression of the compressed levels of dedicated "
+                     "column families",
+                     new DiscreteValuesParameter<StringParameter>(
+                         &_dedicatedCompression,
+                         std::unordered_set<std::string>{"none", "snappy", "lz4", "zlib", "zstd"}));
+
+  options->addOption("--rocksdb.documents-compression",
+                     "compression of the compressed levels of the documents "
+                     "column family",
+                     new DiscreteValuesParameter<StringParameter>(
+                         &_documentsCompression,
+                         std::unordered_set<std::string>{"none", "snappy", "lz4", "zlib", "zstd"}));
+
+  options->addOption("--rocksdb.documents-compression-dictionary-size",
+                     "maximum size in bytes of the dictionary that compactions "
+                     "sample from the documents they write into the last "
+                     "level, used with lz4, zlib and zstd compression of "
+                     "documents (0 = no dictionary)",
+                     new UInt64Parameter(&_documentsCompressionDictionarySize));
+
+  options->addOption("--rocksdb.dedicated-block-cache-size",
+                     "size of a separate block cache in bytes shared by all "
+                     "dedicated column families (0 = use the regular block cache)",
+                     new UInt64Parameter(&_dedicatedBlockCacheSize));
+
+  options->addOption("--rocksdb.dedicated-bloom-filter-bits",
+                     "number of bloom filter bits per key in dedicated column "
+                     "families (0 = no bloom filter)",
+                     new UInt64Parameter(&_dedicatedBloomFilterBits));
+
   options->addHiddenOption("--rocksdb.wal-recovery-skip-corrupted",
                            "skip corrupted records in WAL recovery",
                            new BooleanParameter(&_skipCorrupted));
@@ -300,6 +391,22 @@ void RocksDBOptionFeature::validateOptions(
         << "invalid value for '--rocksdb.num-threads-priority-low'";
     FATAL_ERROR_EXIT();
   }
+  if (_maxBackgroundFlushes < -1 || _maxBackgroundFlushes > 64) {
+    LOG_TOPIC(FATAL, arangodb::Logger::FIXME)
+        << "invalid value for '--rocksdb.max-background-flushes'";
+    FATAL_ERROR_EXIT();
+  }
+  if (_maxBackgroundCompactions < -1 || _maxBackgroundCompactions > 256) {
+    LOG_TOPIC(FATAL, arangodb::Logger::FIXME)
+        << "invalid value for '--rocksdb.max-background-compactions'";
+    FATAL_ERROR_EXIT();
+  }
+  if (_rateLimit == 0 && (_rateLimitAutoTune || _throttleQueueLength > 0)) {
+    LOG_TOPIC(WARN, arangodb::Logger::FIXME)
+        << "'--rocksdb.rate-limit-auto-tune' and "
+           "'--rocksdb.throttle-queue-length' have no effect without "
+           "'--rocksdb.rate-limit'";
+  }
   if (_maxSubcompactions > _numThreadsLow) {
     _maxSubcompactions = _numThreadsLow;
   }
@@ -308,6 +415,23 @@ void RocksDBOptionFeature::validateOptions(
         << "invalid value for '--rocksdb.block-cache-shard-bits'";
     FATAL_ERROR_EXIT();
   }
+  if (_dedicatedBloomFilterBits > 64) {
+    LOG_TOPIC(FATAL, arangodb::Logger::FIXME)
+        << "invalid value for '--rocksdb.dedicated-bloom-filter-bits'";
+    FATAL_ERROR_EXIT();
+  }
+  if (_documentsCompressionDictionarySize > (1 << 30)) {
+    LOG_TOPIC(FATAL, arangodb::Logger::FIXME)
+        << "invalid value for '--rocksdb.documents-compression-dictionary-size'";
+    FATAL_ERROR_EXIT();
+  }
+  if (_documentsCompressionDictionarySize > 0 &&
+      (_documentsCompression == "none" || _documentsCompression == "snappy")) {
+    LOG_TOPIC(WARN, arangodb::Logger::FIXME)
+        << "'--rocksdb.documents-compression-dictionary-size' has no effect "
+        << "with '--rocksdb.documents-compression " << _documentsCompression
+        << "'";
+  }
 }
 
 void RocksDBOptionFeature::start() {
@@ -320,11 +444,23 @@ void RocksDBOptionFeature::start() {
   if (_numThreadsLow == 0) {
     _numThreadsLow = clamped;
   }
+  // flushes run in the high and compactions in the low priority pool, so
+  // each pool needs enough threads for its jobs
+  if (_maxBackgroundFlushes > 0 &&
+      _numThreadsHigh < static_cast<uint32_t>(_maxBackgroundFlushes)) {
+    _numThreadsHigh = static_cast<uint32_t>(_maxBackgroundFlushes);
+  }
+  if (_maxBackgroundCompactions > 0 &&
+      _numThreadsLow < static_cast<uint32_t>(_maxBackgroundCompactions)) {
+    _numThreadsLow = static_cast<uint32_t>(_maxBackgroundCompactions);
+  }
 
   LOG_TOPIC(TRACE, Logger::ROCKSDB) << "using RocksDB options:"
                                     << " wal_dir: " << _walDirectory << "'"
                                     << ", write_buffer_size: " << _writeBufferSize
                                     << ", max_write_buffer_number: " << _maxWriteBufferNumber
+                                    << ", total_write_buffer_size: " << _totalWriteBufferSize
+                                    << ", adaptive_write_buffers: " << std::boolalpha << _adaptiveWriteBuffers
                                     << ", max_total_wal_size: " << _maxTotalWalSize
                                     << ", delayed_write_rate: " << _delayedWriteRate
                                     << ", min_write_buffer_number_to_merge: " << _minWriteBufferNumberToMerge
@@ -333,6 +469,8 @@ void RocksDBOptionFeature::start() {
                                     << ", max_bytes_for_level_base: " << _maxBytesForLevelBase
                                     << ", max_bytes_for_level_multiplier: " << _maxBytesForLevelMultiplier
                                     << ", max_background_jobs: " << _maxBackgroundJobs
+                                    << ", max_background_flushes: " << _maxBackgroundFlushes
+                                    << ", max_background_compactions: " << _maxBackgroundCompactions
                                     << ", max_sub_compactions: " << _maxSubcompactions
                                     << ", num_threads_high: " << _numThreadsHigh
                                     << ", num_threads_low: " << _numThreadsLow
@@ -341,6 +479,9 @@ void RocksDBOptionFeature::start() {
                                     << ", table_block_size: " << _tableBlockSize
                                     << ", recycle_log_file_num: " << _recycleLogFileNum 
                                     << ", compaction_read_ahead_size: " << _compactionReadaheadSize
+                                    << ", rate_limit: " << _rateLimit
+                                    << ", rate_limit_auto_tune: " << std::boolalpha << _rateLimitAutoTune
+                                    << ", throttle_queue_length: " << _throttleQueueLength
                                     << ", level0_compaction_trigger: " << _level0CompactionTrigger
                                     << ", level0_slowdown_trigger: " << _level0SlowdownTrigger
                                     << ", enable_pipelined_write: " << _enablePipelinedWrite
@@ -348,5 +489,11 @@ void RocksDBOptionFeature::start() {
                                     << ", use_direct_reads: " << _useDirectReads
                                     << ", use_direct_io_for_flush_and_compaction: " << _useDirectIoForFlushAndCompaction
                                     << ", use_fsync: " << _useFSync
-                                    << ", dynamic_level_bytes: " << std::boolalpha << _dynamicLevelBytes;
+                                    << ", dynamic_level_bytes: " << std::boolalpha << _dynamicLevelBytes
+                                    << ", dedicated_compaction_style: " << _dedicatedCompactionStyle
+                                    << ", dedicated_compression: " << _dedicatedCompression
+                                    << ", documents_compression: " << _documentsCompression
+                                    << ", documents_compression_dictionary_size: " << _documentsCompressionDictionarySize
+                                    << ", dedicated_block_cache_size: " << _dedicatedBlockCacheSize
+                                    << ", dedicated_bloom_filter_bits: " << _dedicatedBloomFilterBits;
 }
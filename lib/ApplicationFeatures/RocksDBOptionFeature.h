@@ -49,8 +49,15 @@ class RocksDBOptionFeature final
 
   int64_t _transactionLockTimeout;
   std::string _walDirectory;
+  std::string _dedicatedCompactionStyle;
+  std::string _dedicatedCompression;
+  std::string _documentsCompression;
+  uint64_t _documentsCompressionDictionarySize;
+  uint64_t _dedicatedBlockCacheSize;
+  uint64_t _dedicatedBloomFilterBits;
   uint64_t _writeBufferSize;
   uint64_t _maxWriteBufferNumber;
+  uint64_t _totalWriteBufferSize;
   uint64_t _maxTotalWalSize;
   uint64_t _delayedWriteRate;
   uint64_t _minWriteBufferNumberToMerge;
@@ -59,6 +66,8 @@ class RocksDBOptionFeature final
   uint64_t _maxBytesForLevelBase;
   double _maxBytesForLevelMultiplier;
   int32_t _maxBackgroundJobs;
+  int32_t _maxBackgroundFlushes;
+  int32_t _maxBackgroundCompactions;
   uint64_t _maxSubcompactions;
   uint32_t _numThreadsHigh;
   uint32_t _numThreadsLow;
@@ -67,9 +76,13 @@ class RocksDBOptionFeature final
   uint64_t _tableBlockSize;
   uint64_t _recycleLogFileNum;
   uint64_t _compactionReadaheadSize;
+  uint64_t _rateLimit;
+  uint64_t _throttleQueueLength;
   int64_t _level0CompactionTrigger;
   int64_t _level0SlowdownTrigger;
   int64_t _level0StopTrigger;
+  bool _rateLimitAutoTune;
+  bool _adaptiveWriteBuffers;
   bool _enablePipelinedWrite;
   bool _optimizeFiltersForHits;
   bool _useDirectReads;
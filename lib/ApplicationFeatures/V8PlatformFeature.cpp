@@ -22,6 +22,7 @@
 
 #include "ApplicationFeatures/V8PlatformFeature.h"
 
+#include "Basics/MemoryArenas.h"
 #include "Basics/MutexLocker.h"
 #include "Basics/StringUtils.h"
 #include "Logger/Logger.h"
@@ -33,6 +34,7 @@ using namespace arangodb::basics;
 using namespace arangodb::options;
 
 namespace {
+/// @brief allocates the external memory of V8 from its own memory arena
 class ArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
  public:
   virtual void* Allocate(size_t length) override {
@@ -40,9 +42,11 @@ class ArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
     return data == nullptr ? data : memset(data, 0, length);
   }
   virtual void* AllocateUninitialized(size_t length) override {
-    return malloc(length);
+    return MemoryArenas::allocate(MemoryArena::V8, length);
+  }
+  virtual void Free(void* data, size_t length) override {
+    MemoryArenas::deallocate(MemoryArena::V8, data, length);
   }
-  virtual void Free(void* data, size_t) override { free(data); }
 };
 
 static void gcPrologueCallback(v8::Isolate* isolate, v8::GCType type,
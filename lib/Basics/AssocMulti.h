@@ -331,11 +331,10 @@ class AssocMulti {
     allBuckets.reset(
         new std::vector<std::vector<DocumentsPerBucket>>(_buckets.size()));
 
-    auto doInsertBinding = [&](
-        UserData* userData, Element const& element, uint64_t hashByKey,
-        Bucket& b, bool const overwrite, bool const checkEquality) -> Element {
-      return doInsert(userData, element, hashByKey, b, overwrite,
-                      checkEquality);
+    auto doBulkInsertBinding = [&](UserData* userData,
+                                   DocumentsPerBucket& documents,
+                                   Bucket& b) -> void {
+      doBulkInsert(userData, documents, b);
     };
 
     try {
@@ -343,7 +342,7 @@ class AssocMulti {
       for (size_t i = 0; i < allBuckets->size(); i++) {
         std::shared_ptr<Inserter> worker;
         worker.reset(new Inserter(queue, contextDestroyer, &_buckets,
-                                  doInsertBinding, i, contextCreator(),
+                                  doBulkInsertBinding, i, contextCreator(),
                                   allBuckets));
         inserters->emplace_back(worker);
       }
@@ -536,6 +535,41 @@ class AssocMulti {
     return Element();
   }
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief adds all elements of a partition to a bucket. the bucket is
+  /// resized once up front, and the elements are inserted in the order of
+  /// their home slots, so that probing walks the table sequentially instead
+  /// of jumping around randomly. elements with the same key keep their
+  /// relative order. this is used when building an index, so elements are
+  /// not checked for equality
+  //////////////////////////////////////////////////////////////////////////////
+
+  void doBulkInsert(UserData* userData,
+                    std::vector<std::pair<Element, uint64_t>>& documents,
+                    Bucket& b) {
+    if (documents.empty()) {
+      return;
+    }
+
+    uint64_t const expected = b._nrUsed + documents.size();
+    if (2 * b._nrAlloc < 3 * expected) {
+      // leave some room so that doInsert does not resize again
+      resizeInternal(userData, b, 2 * expected + 1);
+    }
+
+    uint64_t const n = b._nrAlloc;
+    std::stable_sort(documents.begin(), documents.end(),
+                     [this, n](std::pair<Element, uint64_t> const& lhs,
+                               std::pair<Element, uint64_t> const& rhs) {
+                       return (hashToIndex(lhs.second) % n) <
+                              (hashToIndex(rhs.second) % n);
+                     });
+
+    for (auto const& it : documents) {
+      doInsert(userData, it.first, it.second, b, true, false);
+    }
+  }
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief insertFirst, special version of insert, when it is known that the
   /// element is the first in the hash with its key, and the hash of the key
@@ -83,9 +83,7 @@ class MultiInserterTask : public LocalTask {
 
   std::function<void(void*)> _contextDestroyer;
   std::vector<Bucket>* _buckets;
-  std::function<Element(void*, Element const&, uint64_t, Bucket&, bool const,
-                        bool const)>
-      _doInsert;
+  std::function<void(void*, DocumentsPerBucket&, Bucket&)> _doBulkInsert;
 
   size_t _i;
   void* _userData;
@@ -96,15 +94,13 @@ class MultiInserterTask : public LocalTask {
   MultiInserterTask(
       std::shared_ptr<LocalTaskQueue> queue, std::function<void(void*)> contextDestroyer,
       std::vector<Bucket>* buckets,
-      std::function<Element(void*, Element const&, uint64_t, Bucket&,
-                            bool const, bool const)>
-          doInsert,
+      std::function<void(void*, DocumentsPerBucket&, Bucket&)> doBulkInsert,
       size_t i, void* userData,
       std::shared_ptr<std::vector<std::vector<DocumentsPerBucket>>> allBuckets)
       : LocalTask(queue),
         _contextDestroyer(contextDestroyer),
         _buckets(buckets),
-        _doInsert(doInsert),
+        _doBulkInsert(doBulkInsert),
         _i(i),
         _userData(userData),
         _allBuckets(allBuckets) {}
@@ -126,15 +122,23 @@ class MultiInserterTask : public LocalTask {
 
                 return lhs[0].first < rhs[0].first;
               });
-    // now actually insert them
+    // now actually insert them, all at once
     try {
       Bucket& b = (*_buckets)[static_cast<size_t>(_i)];
 
+      DocumentsPerBucket documents;
+      size_t total = 0;
       for (auto const& it : (*_allBuckets)[_i]) {
-        for (auto const& it2 : it) {
-          _doInsert(_userData, it2.first, it2.second, b, true, false);
-        }
+        total += it.size();
+      }
+      documents.reserve(total);
+      for (auto& it : (*_allBuckets)[_i]) {
+        documents.insert(documents.end(), it.begin(), it.end());
+        // free the partition's memory early
+        DocumentsPerBucket().swap(it);
       }
+
+      _doBulkInsert(_userData, documents, b);
     } catch (...) {
       _queue->setStatus(TRI_ERROR_INTERNAL);
     }
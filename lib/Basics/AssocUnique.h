@@ -73,7 +73,12 @@ class AssocUnique {
 
  private:
   std::vector<Bucket> _buckets;
+  // mask for the bucket ids of the current split round. buckets below
+  // _splitPointer have already been split in this round and are addressed
+  // with the next round's mask
   size_t _bucketsMask;
+  size_t _splitPointer;
+  size_t _initialBuckets;
 
   HashKeyFuncType const _hashKey;
   HashElementFuncType const _hashElement;
@@ -108,6 +113,8 @@ class AssocUnique {
     }
     numberBuckets = nr;
     _bucketsMask = nr - 1;
+    _splitPointer = 0;
+    _initialBuckets = nr;
 
     _buckets.resize(numberBuckets);
 
@@ -142,6 +149,108 @@ class AssocUnique {
  private:
   static uint64_t initialSize() { return 251; }
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief number of elements in a bucket after which the next bucket in
+  /// line is split. this bounds the duration of the rehash triggered by a
+  /// single insert
+  //////////////////////////////////////////////////////////////////////////////
+
+  static uint64_t maxBucketSize() { return 1ULL << 19; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief maximum number of buckets created by splitting. buckets still
+  /// resize individually once this number is reached
+  //////////////////////////////////////////////////////////////////////////////
+
+  static size_t maxBuckets() { return 4096; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief determines the bucket for a hash value
+  //////////////////////////////////////////////////////////////////////////////
+
+  size_t bucketIndex(uint64_t hash) const {
+    size_t i = static_cast<size_t>(hash & _bucketsMask);
+    if (i < _splitPointer) {
+      i = static_cast<size_t>(hash & ((_bucketsMask << 1) | 1));
+    }
+    return i;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief splits the next bucket in line (linear hashing). the elements of
+  /// the bucket are distributed over the bucket itself and a newly appended
+  /// bucket, so only a single bucket is rehashed at a time, and the other
+  /// buckets stay untouched
+  //////////////////////////////////////////////////////////////////////////////
+
+  void splitBucket(UserData* userData) {
+    size_t const from = _splitPointer;
+    size_t const to = from + _bucketsMask + 1;
+    uint64_t const mask = (_bucketsMask << 1) | 1;
+    TRI_ASSERT(to == _buckets.size());
+
+    // make sure the final append cannot fail
+    _buckets.reserve(_buckets.size() + 1);
+
+    Bucket const& source = _buckets[from];
+    uint64_t const targetSize =
+        TRI_NearPrime((std::max)(initialSize(), source._nrUsed + 1));
+
+    Bucket first;
+    first.allocate(targetSize);
+    Bucket second;
+    second.allocate(targetSize);
+
+    if (source._nrUsed > 0) {
+      for (uint64_t j = 0; j < source._nrAlloc; j++) {
+        Element const& element = source._table[j];
+
+        if (element) {
+          uint64_t const hash = _hashElement(userData, element);
+          Bucket& target = ((hash & mask) == from) ? first : second;
+          uint64_t const n = target._nrAlloc;
+          uint64_t i, k;
+          i = k = hash % n;
+
+          for (; i < n && target._table[i]; ++i)
+            ;
+          if (i == n) {
+            for (i = 0; i < k && target._table[i]; ++i)
+              ;
+          }
+
+          target._table[i] = element;
+          ++target._nrUsed;
+        }
+      }
+    }
+
+    _buckets[from] = std::move(first);
+    _buckets.emplace_back(std::move(second));
+
+    if (++_splitPointer > _bucketsMask) {
+      // all buckets of this round have been split
+      _bucketsMask = mask;
+      _splitPointer = 0;
+    }
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief check whether the next bucket should be split, after a bucket
+  /// has grown to the given number of elements
+  //////////////////////////////////////////////////////////////////////////////
+
+  bool checkSplit(UserData* userData, uint64_t nrUsed) {
+    if (nrUsed > maxBucketSize() && _buckets.size() < maxBuckets()) {
+      try {
+        splitBucket(userData);
+      } catch (...) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief resizes the array
   //////////////////////////////////////////////////////////////////////////////
@@ -213,6 +322,23 @@ class AssocUnique {
     return true;
   }
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief split buckets until the expected number of elements fits into
+  /// buckets of at most maxBucketSize() elements. this is cheap while the
+  /// buckets are still small, e.g. before a bulk load
+  //////////////////////////////////////////////////////////////////////////////
+
+  void splitForSize(UserData* userData, uint64_t expected) {
+    try {
+      while (expected / _buckets.size() > maxBucketSize() &&
+             _buckets.size() < maxBuckets()) {
+        splitBucket(userData);
+      }
+    } catch (...) {
+      // not splitting is not an error
+    }
+  }
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief Finds the element at the given position in the buckets.
   ///        Iterates using the given step size
@@ -277,6 +403,12 @@ class AssocUnique {
   void truncate(CallbackElementFuncType callback) {
     for (auto& b : _buckets) {
       invokeOnAllElements(callback, b);
+    }
+    // go back to the initial number of buckets
+    _buckets.resize(_initialBuckets);
+    _bucketsMask = _initialBuckets - 1;
+    _splitPointer = 0;
+    for (auto& b : _buckets) {
       b.deallocate();
       b.allocate(initialSize());
     }
@@ -334,6 +466,7 @@ class AssocUnique {
   //////////////////////////////////////////////////////////////////////////////
 
   int resize(UserData* userData, size_t size) {
+    splitForSize(userData, size);
     size /= _buckets.size();
     for (auto& b : _buckets) {
       if (2 * (2 * size + 1) < 3 * b._nrUsed) {
@@ -372,7 +505,7 @@ class AssocUnique {
 
   Element find(UserData* userData, Element const& element) const {
     uint64_t i = _hashElement(userData, element);
-    Bucket const& b = _buckets[i & _bucketsMask];
+    Bucket const& b = _buckets[bucketIndex(i)];
 
     uint64_t const n = b._nrAlloc;
     i = i % n;
@@ -405,7 +538,7 @@ class AssocUnique {
   Element findByKey(UserData* userData, Key const* key) const {
     uint64_t hash = _hashKey(userData, key);
     uint64_t i = hash;
-    uint64_t bucketId = i & _bucketsMask;
+    uint64_t bucketId = bucketIndex(i);
     Bucket const& b = _buckets[static_cast<size_t>(bucketId)];
 
     uint64_t const n = b._nrAlloc;
@@ -434,7 +567,7 @@ class AssocUnique {
   Element* findByKeyRef(UserData* userData, Key const* key) const {
     uint64_t hash = _hashKey(userData, key);
     uint64_t i = hash;
-    uint64_t bucketId = i & _bucketsMask;
+    uint64_t bucketId = bucketIndex(i);
     Bucket const& b = _buckets[static_cast<size_t>(bucketId)];
 
     uint64_t const n = b._nrAlloc;
@@ -471,7 +604,7 @@ class AssocUnique {
                     BucketPosition& position, uint64_t& hash) const {
     hash = _hashKey(userData, key);
     uint64_t i = hash;
-    uint64_t bucketId = i & _bucketsMask;
+    uint64_t bucketId = bucketIndex(i);
     Bucket const& b = _buckets[static_cast<size_t>(bucketId)];
 
     uint64_t const n = b._nrAlloc;
@@ -508,13 +641,20 @@ class AssocUnique {
 
   int insert(UserData* userData, Element const& element) {
     uint64_t hash = _hashElement(userData, element);
-    Bucket& b = _buckets[hash & _bucketsMask];
+    Bucket& b = _buckets[bucketIndex(hash)];
 
     if (!checkResize(userData, b, 0)) {
       return TRI_ERROR_OUT_OF_MEMORY;
     }
 
-    return doInsert(userData, element, b, hash);
+    int res = doInsert(userData, element, b, hash);
+
+    if (res == TRI_ERROR_NO_ERROR) {
+      // a failed split leaves the table intact, so it is not an error
+      checkSplit(userData, b._nrUsed);
+    }
+
+    return res;
   }
 
   //////////////////////////////////////////////////////////////////////////////
@@ -543,6 +683,9 @@ class AssocUnique {
       return TRI_ERROR_OUT_OF_MEMORY;
     }
 
+    // a failed split leaves the table intact, so it is not an error
+    checkSplit(userData, b._nrUsed);
+
     return TRI_ERROR_NO_ERROR;
   }
 
@@ -562,6 +705,15 @@ class AssocUnique {
 
     std::vector<Element> const& elements = *(data.get());
 
+    // split buckets up front, as the inserter tasks only resize buckets
+    uint64_t const expected = size() + elements.size();
+    if (expected / _buckets.size() > maxBucketSize() &&
+        _buckets.size() < maxBuckets()) {
+      void* userData = contextCreator();
+      splitForSize(userData, expected);
+      contextDestroyer(userData);
+    }
+
     // set number of partitioners sensibly
     size_t numThreads = _buckets.size();
     if (elements.size() < numThreads) {
@@ -627,7 +779,7 @@ class AssocUnique {
         worker.reset(new Partitioner(queue, _hashElement, contextDestroyer,
                                      data, lower, upper, contextCreator(),
                                      bucketFlags, bucketMapLocker, allBuckets,
-                                     inserters));
+                                     inserters, _bucketsMask, _splitPointer));
         queue->enqueue(worker);
       }
     } catch (...) {
@@ -682,7 +834,7 @@ class AssocUnique {
   Element removeByKey(UserData* userData, Key const* key) {
     uint64_t hash = _hashKey(userData, key);
     uint64_t i = hash;
-    Bucket& b = _buckets[i & _bucketsMask];
+    Bucket& b = _buckets[bucketIndex(i)];
 
     uint64_t const n = b._nrAlloc;
     i = i % n;
@@ -714,7 +866,7 @@ class AssocUnique {
 
   Element remove(UserData* userData, Element const& element) {
     uint64_t i = _hashElement(userData, element);
-    Bucket& b = _buckets[i & _bucketsMask];
+    Bucket& b = _buckets[bucketIndex(i)];
 
     uint64_t const n = b._nrAlloc;
     i = i % n;
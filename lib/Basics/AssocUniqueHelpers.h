@@ -137,6 +137,7 @@ class UniquePartitionerTask : public LocalTask {
   std::shared_ptr<std::vector<std::shared_ptr<Inserter>>> _inserters;
 
   uint64_t _bucketsMask;
+  size_t _splitPointer;
 
  public:
   UniquePartitionerTask(
@@ -148,7 +149,8 @@ class UniquePartitionerTask : public LocalTask {
       std::shared_ptr<std::vector<std::atomic<size_t>>> bucketFlags,
       std::shared_ptr<std::vector<arangodb::Mutex>> bucketMapLocker,
       std::shared_ptr<std::vector<std::vector<DocumentsPerBucket>>> allBuckets,
-      std::shared_ptr<std::vector<std::shared_ptr<Inserter>>> inserters)
+      std::shared_ptr<std::vector<std::shared_ptr<Inserter>>> inserters,
+      uint64_t bucketsMask, size_t splitPointer)
       : LocalTask(queue),
         _hashElement(hashElement),
         _contextDestroyer(contextDestroyer),
@@ -161,7 +163,8 @@ class UniquePartitionerTask : public LocalTask {
         _bucketMapLocker(bucketMapLocker),
         _allBuckets(allBuckets),
         _inserters(inserters),
-        _bucketsMask(_allBuckets->size() - 1) {}
+        _bucketsMask(bucketsMask),
+        _splitPointer(splitPointer) {}
 
   void run() {
     try {
@@ -172,6 +175,10 @@ class UniquePartitionerTask : public LocalTask {
       for (size_t i = _lower; i < _upper; ++i) {
         uint64_t hashByKey = _hashElement(_userData, (*_elements)[i]);
         auto bucketId = hashByKey & _bucketsMask;
+        if (bucketId < _splitPointer) {
+          // bucket was already split in the current round
+          bucketId = hashByKey & ((_bucketsMask << 1) | 1);
+        }
 
         partitions[bucketId].emplace_back((*_elements)[i], hashByKey);
       }
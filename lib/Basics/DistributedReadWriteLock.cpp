@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "DistributedReadWriteLock.h"
+
+#include <thread>
+
+using namespace arangodb::basics;
+
+static size_t const CacheLineSize = 64;
+
+/// @brief number of slots of each lock, a power of two, so that every core
+/// can have its own
+static size_t NumberOfSlots() {
+  static size_t const result = []() -> size_t {
+    size_t const cores = std::thread::hardware_concurrency();
+    size_t n = 1;
+    while (n < cores && n < 64) {
+      n <<= 1;
+    }
+    return n;
+  }();
+  return result;
+}
+
+/// @brief number of the current thread, used to pick its slot
+static size_t ThreadNumber() {
+  static std::atomic<size_t> next(0);
+  static thread_local size_t const number = next++;
+  return number;
+}
+
+DistributedReadWriteLock::DistributedReadWriteLock()
+    : _memory(nullptr), _slots(nullptr), _writer(false), _writeLocked(false) {
+  static_assert(sizeof(Slot) == CacheLineSize, "invalid slot size");
+
+  size_t const n = NumberOfSlots();
+  _memory = new char[n * sizeof(Slot) + CacheLineSize - 1];
+  uintptr_t aligned = reinterpret_cast<uintptr_t>(_memory);
+  aligned = (aligned + CacheLineSize - 1) & ~(CacheLineSize - 1);
+  _slots = reinterpret_cast<Slot*>(aligned);
+  for (size_t i = 0; i < n; ++i) {
+    new (&_slots[i].readers) std::atomic<int64_t>(0);
+  }
+}
+
+DistributedReadWriteLock::~DistributedReadWriteLock() { delete[] _memory; }
+
+DistributedReadWriteLock::Slot& DistributedReadWriteLock::slot() {
+  return _slots[ThreadNumber() & (NumberOfSlots() - 1)];
+}
+
+int64_t DistributedReadWriteLock::readers() const {
+  int64_t result = 0;
+  size_t const n = NumberOfSlots();
+  for (size_t i = 0; i < n; ++i) {
+    result += _slots[i].readers.load();
+  }
+  return result;
+}
+
+void DistributedReadWriteLock::notifyWriter() {
+  // taking the mutex makes sure the writer either sees the changed slot
+  // or is already waiting
+  std::unique_lock<std::mutex> guard(_mutex);
+  _bell.notify_all();
+}
+
+/// @brief locks for writing
+void DistributedReadWriteLock::writeLock() {
+  std::unique_lock<std::mutex> guard(_mutex);
+  while (true) {
+    bool expected = false;
+    if (_writer.compare_exchange_strong(expected, true)) {
+      break;
+    }
+    _bell.wait(guard);
+  }
+  // new readers back off from now on, wait for the ones we have
+  while (readers() != 0) {
+    _bell.wait(guard);
+  }
+  _writeLocked.store(true);
+}
+
+/// @brief locks for writing, but only tries
+bool DistributedReadWriteLock::tryWriteLock() {
+  bool expected = false;
+  if (!_writer.compare_exchange_strong(expected, true)) {
+    return false;
+  }
+  if (readers() != 0) {
+    {
+      std::unique_lock<std::mutex> guard(_mutex);
+      _writer.store(false);
+    }
+    _bell.notify_all();
+    return false;
+  }
+  _writeLocked.store(true);
+  return true;
+}
+
+/// @brief locks for reading
+void DistributedReadWriteLock::readLock() {
+  Slot& s = slot();
+  while (true) {
+    s.readers.fetch_add(1);
+    if (!_writer.load()) {
+      return;
+    }
+    // back off until the writer is done
+    s.readers.fetch_sub(1);
+    std::unique_lock<std::mutex> guard(_mutex);
+    _bell.notify_all();
+    while (_writer.load()) {
+      _bell.wait(guard);
+    }
+  }
+}
+
+/// @brief locks for reading, tries only
+bool DistributedReadWriteLock::tryReadLock() {
+  Slot& s = slot();
+  s.readers.fetch_add(1);
+  if (!_writer.load()) {
+    return true;
+  }
+  s.readers.fetch_sub(1);
+  notifyWriter();
+  return false;
+}
+
+/// @brief releases the read-lock or write-lock
+void DistributedReadWriteLock::unlock() {
+  // there are no readers while the write lock is held
+  if (_writeLocked.load()) {
+    unlockWrite();
+  } else {
+    unlockRead();
+  }
+}
+
+/// @brief releases the read-lock
+void DistributedReadWriteLock::unlockRead() {
+  slot().readers.fetch_sub(1);
+  if (_writer.load()) {
+    notifyWriter();
+  }
+}
+
+/// @brief releases the write-lock
+void DistributedReadWriteLock::unlockWrite() {
+  _writeLocked.store(false);
+  {
+    std::unique_lock<std::mutex> guard(_mutex);
+    _writer.store(false);
+  }
+  _bell.notify_all();
+}
@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_DISTRIBUTED_READ_WRITE_LOCK_H
+#define ARANGODB_BASICS_DISTRIBUTED_READ_WRITE_LOCK_H 1
+
+#include "Basics/Common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace arangodb {
+namespace basics {
+
+/// @brief read-write lock for read-mostly data, can be used instead of
+/// ReadWriteLock. the readers are counted in a number of slots on separate
+/// cache lines, each thread uses one of them. so readers on different cores
+/// do not contend, while a writer has to look at all slots.
+/// like ReadWriteLockCPP11, a lock may be released by another thread than
+/// the one that acquired it, and writers are preferred: as long as a writer
+/// waits, no new read locks are granted
+class DistributedReadWriteLock {
+  DistributedReadWriteLock(DistributedReadWriteLock const&) = delete;
+  DistributedReadWriteLock& operator=(DistributedReadWriteLock const&) =
+      delete;
+
+ public:
+  DistributedReadWriteLock();
+  ~DistributedReadWriteLock();
+
+  /// @brief locks for writing
+  void writeLock();
+
+  /// @brief locks for writing, but only tries
+  bool tryWriteLock();
+
+  /// @brief locks for reading
+  void readLock();
+
+  /// @brief locks for reading, tries only
+  bool tryReadLock();
+
+  /// @brief releases the read-lock or write-lock
+  void unlock();
+
+  /// @brief releases the read-lock
+  void unlockRead();
+
+  /// @brief releases the write-lock
+  void unlockWrite();
+
+ private:
+  /// @brief number of readers of one slot. a read lock released by another
+  /// thread is subtracted from that thread's slot, so single slots can be
+  /// negative, only their sum is the number of readers
+  struct Slot {
+    std::atomic<int64_t> readers;
+    char padding[64 - sizeof(std::atomic<int64_t>)];
+  };
+
+  /// @brief the slot of the current thread
+  Slot& slot();
+
+  /// @brief sum of all slots
+  int64_t readers() const;
+
+  /// @brief wakes up a writer waiting for the readers
+  void notifyWriter();
+
+ private:
+  /// @brief memory of the slots, the slots themselves start at the next
+  /// cache line
+  char* _memory;
+  Slot* _slots;
+
+  /// @brief set while a writer holds the lock or waits for the readers
+  std::atomic<bool> _writer;
+
+  /// @brief set while a writer holds the lock
+  std::atomic<bool> _writeLocked;
+
+  /// @brief a mutex and a condition variable for waiting, only used if
+  /// readers and a writer meet
+  std::mutex _mutex;
+  std::condition_variable _bell;
+};
+}
+}
+
+#endif
@@ -131,6 +131,7 @@ struct IndexBucket {
         mem = (mem / pageSize) * pageSize;
         void* memptr = reinterpret_cast<void*>(mem);
         TRI_MMFileAdvise(memptr, totalSize, TRI_MADVISE_RANDOM);
+        TRI_MMFileApplyPolicies(memptr, totalSize, _file == -1);
       }
 #endif
 
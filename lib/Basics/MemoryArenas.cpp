@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryArenas.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/velocypack-aliases.h>
+
+#ifdef ARANGODB_HAVE_JEMALLOC
+#include <jemalloc/jemalloc.h>
+#endif
+
+#include <mutex>
+
+using namespace arangodb;
+
+#ifdef ARANGODB_HAVE_JEMALLOC
+namespace {
+/// @brief jemalloc indexes of the arenas, created on first use
+uint32_t Arenas[MemoryArenas::numberOfArenas];
+std::once_flag ArenasCreated;
+
+void CreateArenas() {
+  for (size_t i = 0; i < MemoryArenas::numberOfArenas; ++i) {
+    unsigned arena = 0;
+    size_t size = sizeof(arena);
+    if (mallctl("arenas.extend", &arena, &size, nullptr, 0) == 0) {
+      Arenas[i] = static_cast<uint32_t>(arena);
+    } else {
+      Arenas[i] = UINT32_MAX;
+    }
+  }
+}
+
+/// @brief flags for mallocx and dallocx. the thread cache belongs to the
+/// thread's own arena, so it is bypassed
+int Flags(uint32_t arena) {
+  return static_cast<int>(MALLOCX_ARENA(arena) | MALLOCX_TCACHE_NONE);
+}
+
+/// @brief reads a statistics value, 0 if not available
+template <typename T = size_t>
+uint64_t Statistic(std::string const& name) {
+  T value = 0;
+  size_t size = sizeof(value);
+  if (mallctl(name.c_str(), &value, &size, nullptr, 0) != 0) {
+    return 0;
+  }
+  return static_cast<uint64_t>(value);
+}
+}
+#endif
+
+bool MemoryArenas::isSupported() {
+#ifdef ARANGODB_HAVE_JEMALLOC
+  return true;
+#else
+  return false;
+#endif
+}
+
+char const* MemoryArenas::name(MemoryArena arena) {
+  switch (arena) {
+    case MemoryArena::AQL:
+      return "aql";
+    case MemoryArena::CACHE:
+      return "cache";
+    case MemoryArena::PREGEL:
+      return "pregel";
+    case MemoryArena::V8:
+      return "v8";
+  }
+  return "unknown";
+}
+
+uint32_t MemoryArenas::index(MemoryArena arena) {
+#ifdef ARANGODB_HAVE_JEMALLOC
+  std::call_once(ArenasCreated, CreateArenas);
+  return Arenas[static_cast<size_t>(arena)];
+#else
+  return UINT32_MAX;
+#endif
+}
+
+void* MemoryArenas::allocate(MemoryArena arena, size_t size) {
+#ifdef ARANGODB_HAVE_JEMALLOC
+  uint32_t const i = index(arena);
+  if (i != UINT32_MAX) {
+    return mallocx((std::max)(size, static_cast<size_t>(1)), Flags(i));
+  }
+#endif
+  return malloc(size);
+}
+
+void MemoryArenas::deallocate(MemoryArena arena, void* data, size_t size) {
+  if (data == nullptr) {
+    return;
+  }
+#ifdef ARANGODB_HAVE_JEMALLOC
+  uint32_t const i = index(arena);
+  if (i != UINT32_MAX) {
+    dallocx(data, Flags(i));
+    return;
+  }
+#endif
+  free(data);
+}
+
+uint32_t MemoryArenas::bindThread(uint32_t arena) {
+#ifdef ARANGODB_HAVE_JEMALLOC
+  if (arena == UINT32_MAX) {
+    return UINT32_MAX;
+  }
+  unsigned previous = 0;
+  unsigned next = arena;
+  size_t size = sizeof(previous);
+  if (mallctl("thread.arena", &previous, &size, &next, sizeof(next)) == 0) {
+    return static_cast<uint32_t>(previous);
+  }
+#endif
+  return UINT32_MAX;
+}
+
+void MemoryArenas::toVelocyPack(VPackBuilder& builder) {
+  builder.add("jemalloc", VPackValue(isSupported()));
+
+#ifdef ARANGODB_HAVE_JEMALLOC
+  // the statistics are only updated when the epoch is advanced
+  uint64_t epoch = 1;
+  size_t size = sizeof(epoch);
+  mallctl("epoch", &epoch, &size, &epoch, size);
+
+  for (char const* name : {"allocated", "active", "metadata", "resident",
+                           "mapped", "retained"}) {
+    builder.add(name, VPackValue(Statistic(std::string("stats.") + name)));
+  }
+
+  uint64_t const pageSize = Statistic("arenas.page");
+  builder.add("arenas", VPackValue(VPackValueType::Object));
+  for (size_t i = 0; i < numberOfArenas; ++i) {
+    MemoryArena const arena = static_cast<MemoryArena>(i);
+    uint32_t const jemallocIndex = index(arena);
+    if (jemallocIndex == UINT32_MAX) {
+      continue;
+    }
+    std::string const prefix =
+        "stats.arenas." + std::to_string(jemallocIndex) + ".";
+    builder.add(name(arena), VPackValue(VPackValueType::Object));
+    builder.add("index", VPackValue(jemallocIndex));
+    builder.add("allocated",
+                VPackValue(Statistic(prefix + "small.allocated") +
+                           Statistic(prefix + "large.allocated") +
+                           Statistic(prefix + "huge.allocated")));
+    builder.add("active", VPackValue(Statistic(prefix + "pactive") * pageSize));
+    builder.add("dirty", VPackValue(Statistic(prefix + "pdirty") * pageSize));
+    builder.add("mapped", VPackValue(Statistic(prefix + "mapped")));
+    builder.add("threads", VPackValue(Statistic<unsigned>(prefix + "nthreads")));
+    builder.close();
+  }
+  builder.close();
+#endif
+}
+
+Result MemoryArenas::dumpHeapProfile(std::string const& filename) {
+#ifdef ARANGODB_HAVE_JEMALLOC
+  bool active = false;
+  size_t size = sizeof(active);
+  if (mallctl("opt.prof", &active, &size, nullptr, 0) != 0 || !active) {
+    return {TRI_ERROR_NOT_IMPLEMENTED,
+            "heap profiling is not active, start the server with "
+            "MALLOC_CONF=prof:true"};
+  }
+  char const* file = filename.c_str();
+  int res = mallctl("prof.dump", nullptr, nullptr, &file, sizeof(file));
+  if (res != 0) {
+    return {TRI_ERROR_INTERNAL, "could not write heap profile to '" +
+                                    filename + "': " + strerror(res)};
+  }
+  return {};
+#else
+  return {TRI_ERROR_NOT_IMPLEMENTED, "the server is not built with jemalloc"};
+#endif
+}
@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_MEMORY_ARENAS_H
+#define ARANGODB_BASICS_MEMORY_ARENAS_H 1
+
+#include "Basics/Common.h"
+#include "Basics/Result.h"
+
+namespace arangodb {
+namespace velocypack {
+class Builder;
+}
+
+/// @brief subsystems with their own jemalloc arena, so that their memory
+/// shows up separately in the allocator statistics
+enum class MemoryArena : uint8_t { AQL = 0, CACHE = 1, PREGEL = 2, V8 = 3 };
+
+/// @brief allocation from the arenas of the subsystems. without jemalloc,
+/// everything is allocated with malloc and there are no statistics
+class MemoryArenas {
+ public:
+  static constexpr size_t numberOfArenas = 4;
+
+  /// @brief whether the arenas are available
+  static bool isSupported();
+
+  /// @brief name of an arena, as used in the statistics
+  static char const* name(MemoryArena);
+
+  /// @brief allocates memory from an arena, returns nullptr if out of memory
+  static void* allocate(MemoryArena, size_t size);
+
+  /// @brief frees memory allocated from an arena
+  static void deallocate(MemoryArena, void* data, size_t size);
+
+  /// @brief adds the statistics of the allocator and the arenas to an open
+  /// object
+  static void toVelocyPack(velocypack::Builder&);
+
+  /// @brief writes a heap profile to the file, requires the server to be
+  /// started with heap profiling (MALLOC_CONF=prof:true)
+  static Result dumpHeapProfile(std::string const& filename);
+
+ private:
+  friend class MemoryArenaScope;
+
+  /// @brief binds the current thread's allocations to an arena, returns the
+  /// arena it used before, or UINT32_MAX if the arenas are not available
+  static uint32_t bindThread(uint32_t arena);
+
+  /// @brief jemalloc index of an arena, or UINT32_MAX if not available
+  static uint32_t index(MemoryArena);
+};
+
+/// @brief routes all allocations of the current thread to the arena of a
+/// subsystem while it lives. small allocations may still be served from
+/// the thread's cache, so the attribution is not exact
+class MemoryArenaScope {
+  MemoryArenaScope(MemoryArenaScope const&) = delete;
+  MemoryArenaScope& operator=(MemoryArenaScope const&) = delete;
+
+ public:
+  explicit MemoryArenaScope(MemoryArena arena)
+      : _previous(MemoryArenas::bindThread(MemoryArenas::index(arena))) {}
+
+  ~MemoryArenaScope() {
+    if (_previous != UINT32_MAX) {
+      MemoryArenas::bindThread(_previous);
+    }
+  }
+
+ private:
+  uint32_t _previous;
+};
+
+/// @brief standard allocator using the arena of a subsystem
+template <typename T, MemoryArena Arena>
+class MemoryArenaAllocator {
+ public:
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind {
+    typedef MemoryArenaAllocator<U, Arena> other;
+  };
+
+  MemoryArenaAllocator() noexcept {}
+
+  template <typename U>
+  MemoryArenaAllocator(MemoryArenaAllocator<U, Arena> const&) noexcept {}
+
+  T* allocate(size_t n) {
+    void* data = MemoryArenas::allocate(Arena, n * sizeof(T));
+    if (data == nullptr) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(data);
+  }
+
+  void deallocate(T* data, size_t n) noexcept {
+    MemoryArenas::deallocate(Arena, data, n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(MemoryArenaAllocator<U, Arena> const&) const noexcept {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(MemoryArenaAllocator<U, Arena> const&) const noexcept {
+    return false;
+  }
+};
+}
+
+#endif
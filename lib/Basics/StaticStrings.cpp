@@ -27,6 +27,7 @@ using namespace arangodb;
 // constants
 std::string const StaticStrings::Base64("base64");
 std::string const StaticStrings::Binary("binary");
+std::string const StaticStrings::Deflate("deflate");
 std::string const StaticStrings::Empty("");
 std::string const StaticStrings::N1800("1800");
 
@@ -111,8 +112,10 @@ std::string const StaticStrings::MultiPartContentType("multipart/form-data");
 std::string const StaticStrings::NoSniff("nosniff");
 std::string const StaticStrings::Origin("origin");
 std::string const StaticStrings::Queue("x-arango-queue");
+std::string const StaticStrings::RetryAfter("retry-after");
 std::string const StaticStrings::Server("server");
 std::string const StaticStrings::StartThread("x-arango-start-thread");
+std::string const StaticStrings::TraceIdHeader("x-arango-trace-id");
 std::string const StaticStrings::WwwAuthenticate("www-authenticate");
 std::string const StaticStrings::XContentTypeOptions("x-content-type-options");
 
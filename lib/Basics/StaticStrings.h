@@ -33,6 +33,7 @@ class StaticStrings {
   // constants
   static std::string const Base64;
   static std::string const Binary;
+  static std::string const Deflate;
   static std::string const Empty;
   static std::string const N1800;
 
@@ -106,8 +107,10 @@ class StaticStrings {
   static std::string const NoSniff;
   static std::string const Origin;
   static std::string const Queue;
+  static std::string const RetryAfter;
   static std::string const Server;
   static std::string const StartThread;
+  static std::string const TraceIdHeader;
   static std::string const WwwAuthenticate;
   static std::string const XContentTypeOptions;
 
@@ -397,6 +397,29 @@ char* Utf8Helper::toupper(TRI_memory_zone_t* zone, char const* src,
 bool Utf8Helper::tokenize(std::set<std::string>& words,
                           std::string const& text, size_t minimalLength,
                           size_t maximalLength, bool lowerCase) {
+  return tokenize(
+      [&words](std::string&& word) { words.emplace(std::move(word)); }, text,
+      minimalLength, maximalLength, lowerCase);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Extract the words from a UTF-8 string and count them.
+////////////////////////////////////////////////////////////////////////////////
+
+bool Utf8Helper::tokenize(std::map<std::string, size_t>& words,
+                          std::string const& text, size_t minimalLength,
+                          size_t maximalLength, bool lowerCase) {
+  return tokenize([&words](std::string&& word) { ++words[std::move(word)]; },
+                  text, minimalLength, maximalLength, lowerCase);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Call the callback for each word of a UTF-8 string.
+////////////////////////////////////////////////////////////////////////////////
+
+bool Utf8Helper::tokenize(std::function<void(std::string&&)> const& callback,
+                          std::string const& text, size_t minimalLength,
+                          size_t maximalLength, bool lowerCase) {
   UErrorCode status = U_ZERO_ERROR;
   UnicodeString word;
 
@@ -481,8 +504,8 @@ bool Utf8Helper::tokenize(std::set<std::string>& words,
                                        chunkLength, &utf8WordLength);
       if (utf8Word != nullptr) {
         std::string word(utf8Word, utf8WordLength);
-        words.emplace(word);
         TRI_Free(TRI_UNKNOWN_MEM_ZONE, utf8Word);
+        callback(std::move(word));
       }
     }
   }
@@ -140,6 +140,24 @@ class Utf8Helper {
                 size_t minimalWordLength, size_t maximalWordLength,
                 bool lowerCase);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief returns the words of a UTF-8 string with the number of their
+  /// occurrences
+  //////////////////////////////////////////////////////////////////////////////
+
+  bool tokenize(std::map<std::string, size_t>& words, std::string const& text,
+                size_t minimalWordLength, size_t maximalWordLength,
+                bool lowerCase);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief calls the callback for every word of a UTF-8 string, including
+  /// repeated words
+  //////////////////////////////////////////////////////////////////////////////
+
+  bool tokenize(std::function<void(std::string&&)> const& callback,
+                std::string const& text, size_t minimalWordLength,
+                size_t maximalWordLength, bool lowerCase);
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief builds a regex matcher for the specified pattern
   //////////////////////////////////////////////////////////////////////////////
@@ -33,10 +33,67 @@
 #include <velocypack/Slice.h>
 #include <velocypack/velocypack-aliases.h>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define USE_SSE2_STRING_SCAN 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
 using namespace arangodb::basics;
 
 static size_t const MinReserveValue = 32;
 
+/// @brief returns the number of bytes at the start of [p, e) that can be
+/// copied into the JSON output as they are, i.e. bytes that are neither
+/// control characters, double quotes, backslashes, forward slashes (if they
+/// are to be escaped) nor part of a multi-byte UTF-8 sequence.
+/// with SSE2 this checks 16 bytes at a time, which is much faster than
+/// looking up each byte in the escape table for the long mostly-ASCII
+/// strings typically found in documents
+static size_t PlainPrefixLength(uint8_t const* p, uint8_t const* e,
+                                bool escapeForwardSlashes) {
+  uint8_t const* start = p;
+
+#ifdef USE_SSE2_STRING_SCAN
+  __m128i const controlLimit = _mm_set1_epi8(0x20);
+  __m128i const quote = _mm_set1_epi8('"');
+  __m128i const backslash = _mm_set1_epi8('\\');
+  __m128i const slash =
+      _mm_set1_epi8(escapeForwardSlashes ? '/' : '"');
+
+  while (e - p >= 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+    // a signed comparison catches both control characters and bytes >= 0x80
+    __m128i special = _mm_or_si128(
+        _mm_or_si128(_mm_cmplt_epi8(v, controlLimit), _mm_cmpeq_epi8(v, quote)),
+        _mm_or_si128(_mm_cmpeq_epi8(v, backslash), _mm_cmpeq_epi8(v, slash)));
+    int mask = _mm_movemask_epi8(special);
+    if (mask != 0) {
+#ifdef _MSC_VER
+      unsigned long index;
+      _BitScanForward(&index, static_cast<unsigned long>(mask));
+      return static_cast<size_t>(p - start) + index;
+#else
+      return static_cast<size_t>(p - start) + __builtin_ctz(mask);
+#endif
+    }
+    p += 16;
+  }
+#endif
+
+  while (p < e) {
+    uint8_t c = *p;
+    if (c < 0x20U || c >= 0x80U || c == '"' || c == '\\' ||
+        (c == '/' && escapeForwardSlashes)) {
+      break;
+    }
+    ++p;
+  }
+  return static_cast<size_t>(p - start);
+}
+
 void VelocyPackDumper::handleUnsupportedType(VPackSlice const* slice) {
   TRI_string_buffer_t* buffer = _buffer->stringBuffer(); 
 
@@ -310,6 +367,16 @@ void VelocyPackDumper::appendString(char const* src, VPackValueLength len) {
   uint8_t const* p = reinterpret_cast<uint8_t const*>(src);
   uint8_t const* e = p + len;
   while (p < e) {
+    // copy runs of characters that need no escaping at once
+    size_t plain = PlainPrefixLength(p, e, options->escapeForwardSlashes);
+    if (plain > 0) {
+      TRI_AppendStringUnsafeStringBuffer(buffer, reinterpret_cast<char const*>(p), plain);
+      p += plain;
+      if (p == e) {
+        break;
+      }
+    }
+
     uint8_t c = *p;
 
     if ((c & 0x80U) == 0) {
@@ -393,14 +460,20 @@ void VelocyPackDumper::appendString(char const* src, VPackValueLength len) {
 }
 
 void VelocyPackDumper::dumpValue(VPackSlice const* slice, VPackSlice const* base) {
+  TRI_string_buffer_t* buffer = _buffer->stringBuffer(); 
+  
+  int res;
   if (base == nullptr) {
     base = slice;
+    // top-level value: the JSON is rarely shorter than the VelocyPack, so
+    // reserve that much at once instead of growing the buffer repeatedly
+    // while dumping. the reservation is still checked for each value
+    res = TRI_ReserveStringBuffer(
+        buffer, (std::max)(static_cast<size_t>(slice->byteSize()), size_t(32)));
+  } else {
+    // alloc at least 32 bytes  
+    res = TRI_ReserveStringBuffer(buffer, 32);
   }
-  
-  TRI_string_buffer_t* buffer = _buffer->stringBuffer(); 
-  
-  // alloc at least 32 bytes  
-  int res = TRI_ReserveStringBuffer(buffer, 32);
      
   if (res != TRI_ERROR_NO_ERROR) {
     THROW_ARANGO_EXCEPTION(res);
@@ -409,12 +409,22 @@ static const uint32_t Crc32Lookup[8][256] = {
      0xc451b7cc, 0x8d6dcaeb, 0x56294d82, 0x1f1530a5}};
 
 /// @brief Detection of Intel SSE4.2 extensions at runtime:
-#if ENABLE_ASM_CRC32 == 1
+#if ENABLE_ASM_CRC32 == 1 || TRI_HAVE_CRC32_INTRINSICS == 1
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <nmmintrin.h>
+#else
 #include <cpuid.h>
 #include <x86intrin.h>
+#endif
 
 static bool HasSSE42() {
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 1);
+  return (info[2] & 0x100000) != 0;
+#else
   unsigned int eax, ebx, ecx, edx;
   if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
     if ((ecx & 0x100000) != 0) {
@@ -425,33 +435,43 @@ static bool HasSSE42() {
   } else {
     return false;
   }
+#endif
 }
 
-// The following is currently not used, it is a fallback for the case
-// that the pure assembler source cannot be assembled or linked for
-// some reason.
+#endif
 
-#if 0
-extern "C" uint32_t TRI_BlockCrc32_intrinsics(uint32_t value,
-                                              char const* data,
-                                              size_t length) {
+/// @brief CRC32 value of data block, using the crc32 instruction of SSE4.2
+///
+/// this is used for builds without the hand-optimized assembler code (e.g.
+/// with ASM_OPTIMIZATIONS turned off or with MSVC). the crc32 instruction
+/// computes the same polynomial (Castagnoli) as Crc32Lookup, so the results
+/// are identical to the ones of TRI_BlockCrc32_C. the function is compiled
+/// for SSE4.2 regardless of the compiler flags and must only be called after
+/// the CPU was checked to support it
+#if TRI_HAVE_CRC32_INTRINSICS == 1
+extern "C"
+#ifndef _MSC_VER
+__attribute__((target("sse4.2")))
+#endif
+uint32_t TRI_BlockCrc32_Intrinsics(uint32_t value, char const* data,
+                                   size_t length) {
   uint64_t tmp = value;
-  auto p = reinterpret_cast<uint64_t const*>(data);
   while (length >= 8) {
-    tmp = _mm_crc32_u64(tmp, *p++);
+    uint64_t word;
+    memcpy(&word, data, sizeof(uint64_t));
+    tmp = _mm_crc32_u64(tmp, word);
+    data += 8;
     length -= 8;
   }
-  auto p2 = reinterpret_cast<unsigned char const*>(p);
   value = static_cast<uint32_t>(tmp);
+  auto p = reinterpret_cast<unsigned char const*>(data);
   while (length-- > 0) {
-    value = _mm_crc32_u8(value, *p2++);
+    value = _mm_crc32_u8(value, *p++);
   }
   return value;
 }
 #endif
 
-#endif
-
 /// @brief CRC32 value of data block
 ///
 /// optimized code to process 8 bytes at a time. provides a substantial speedup
@@ -497,13 +517,16 @@ extern "C" {
 #endif
   }
 
-#if ENABLE_ASM_CRC32 == 1
+#if ENABLE_ASM_CRC32 == 1 || TRI_HAVE_CRC32_INTRINSICS == 1
   static uint32_t TRI_BlockCrc32_Detect(uint32_t hash,
                                         char const* data,
                                         size_t length) {
     if (HasSSE42()) {
+#if ENABLE_ASM_CRC32 == 1
       TRI_BlockCrc32 = TRI_BlockCrc32_SSE42;
-      //TRI_BlockCrc32 = TRI_BlockCrc32_intrinsics;
+#else
+      TRI_BlockCrc32 = TRI_BlockCrc32_Intrinsics;
+#endif
     } else {
       TRI_BlockCrc32 = TRI_BlockCrc32_C;
     }
@@ -50,13 +50,29 @@ static constexpr uint32_t TRI_FinalCrc32(uint32_t value) {
   return (value ^ 0xffffffff); 
 }
 
-/// @brief CRC32 value of data block
+/// @brief whether the CRC32 can be computed with SSE4.2 intrinsics. this is
+/// only used if the assembler version is not compiled in
+#if ENABLE_ASM_CRC32 != 1 &&                                       \
+    ((defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))) || \
+     (defined(_MSC_VER) && defined(_M_X64)))
+#define TRI_HAVE_CRC32_INTRINSICS 1
+#else
+#define TRI_HAVE_CRC32_INTRINSICS 0
+#endif
+
+/// @brief CRC32 value of data block. TRI_BlockCrc32 points to the fastest
+/// implementation the CPU supports, which is determined on its first call
 extern "C" {
 
 #if ENABLE_ASM_CRC32 == 1
   uint32_t TRI_BlockCrc32_SSE42(uint32_t, char const* data, size_t length);
 #endif
 
+#if TRI_HAVE_CRC32_INTRINSICS == 1
+  uint32_t TRI_BlockCrc32_Intrinsics(uint32_t, char const* data,
+                                     size_t length);
+#endif
+
   uint32_t TRI_BlockCrc32_C(uint32_t hash, char const* data, size_t length);
   extern uint32_t (*TRI_BlockCrc32)(uint32_t hash,
                                     char const* data,
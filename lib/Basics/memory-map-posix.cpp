@@ -26,13 +26,45 @@
 #ifdef TRI_HAVE_POSIX_MMAP
 
 #include "Logger/Logger.h"
+#include "Basics/files.h"
 #include "Basics/tri-strings.h"
 
 #include <sys/mman.h>
 
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 using namespace arangodb;
 
 namespace {
+/// @brief maximum number of NUMA nodes considered for interleaving
+static constexpr int MaxNumaNodes = 64;
+
+/// @brief whether or not large mappings should use transparent huge pages
+static bool UseHugePages = false;
+
+/// @brief whether or not large mappings should be interleaved over all
+/// NUMA nodes
+static bool UseInterleave = false;
+
+/// @brief number of NUMA nodes of the machine, determined when the
+/// policies are set
+static int NumaNodes = 1;
+
+static int CountNumaNodes() {
+  int n = 0;
+  while (n < MaxNumaNodes &&
+         TRI_IsDirectory(("/sys/devices/system/node/node" + std::to_string(n))
+                             .c_str())) {
+    ++n;
+  }
+  return (n == 0 ? 1 : n);
+}
+
 static std::string flagify(int flags) {
   std::string result;
 
@@ -100,6 +132,28 @@ int TRI_FlushMMFile(int fileDescriptor, void* startingAddress,
   return TRI_ERROR_SYS_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts writing back a range of a memory mapped file
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_StartFlushMMFile(int fileDescriptor, int64_t offset,
+                         size_t numOfBytesToFlush) {
+#ifdef __linux__
+  // pages dirtied via a shared mapping are dirty in the page cache, so
+  // sync_file_range picks them up
+  int res = sync_file_range(fileDescriptor, static_cast<off64_t>(offset),
+                            static_cast<off64_t>(numOfBytesToFlush),
+                            SYNC_FILE_RANGE_WRITE);
+
+  if (res != 0) {
+    TRI_set_errno(TRI_ERROR_SYS_ERROR);
+    return TRI_ERROR_SYS_ERROR;
+  }
+#endif
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // @brief memory map a file
 ////////////////////////////////////////////////////////////////////////////////
@@ -206,6 +260,64 @@ int TRI_MMFileAdvise(void* memoryAddress, size_t numOfBytes, int advice) {
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the process-wide policies for large memory mappings
+///
+/// must be called before any mapping is created, as the values are not
+/// protected against concurrent access
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetMMFilePolicies(bool hugePages, bool interleave) {
+  UseHugePages = hugePages;
+  UseInterleave = interleave;
+  NumaNodes = (interleave ? CountNumaNodes() : 1);
+
+  if (hugePages && TRI_MADVISE_HUGEPAGE == 0) {
+    LOG_TOPIC(WARN, Logger::MMAP)
+        << "transparent huge pages are not supported on this platform";
+  }
+  if (interleave && NumaNodes < 2) {
+    LOG_TOPIC(INFO, Logger::MMAP)
+        << "not interleaving memory mappings as there is only one NUMA node";
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief applies the policies set via TRI_SetMMFilePolicies to a mapping
+///
+/// MADV_HUGEPAGE is only applied to anonymous memory. Linux ignores it for
+/// shared file-backed mappings, so it is not even attempted for datafiles
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_MMFileApplyPolicies(void* memoryAddress, size_t numOfBytes,
+                            bool anonymous) {
+  int res = TRI_ERROR_NO_ERROR;
+
+  if (UseHugePages && anonymous && TRI_MADVISE_HUGEPAGE != 0) {
+    res = TRI_MMFileAdvise(memoryAddress, numOfBytes, TRI_MADVISE_HUGEPAGE);
+  }
+
+#if defined(__linux__) && defined(SYS_mbind)
+  if (UseInterleave && NumaNodes > 1) {
+    unsigned long nodemask = (NumaNodes >= MaxNumaNodes)
+                                 ? ~0UL
+                                 : ((1UL << NumaNodes) - 1);
+
+    LOG_TOPIC(TRACE, Logger::MMAP) << "interleaving range " << Logger::RANGE(memoryAddress, numOfBytes) << " over " << NumaNodes << " NUMA nodes";
+
+    if (syscall(SYS_mbind, memoryAddress, numOfBytes, MPOL_INTERLEAVE,
+                &nodemask, static_cast<unsigned long>(NumaNodes) + 1,
+                0) != 0) {
+      int err = errno;
+      LOG_TOPIC(WARN, Logger::MMAP) << "mbind for range " << Logger::RANGE(memoryAddress, numOfBytes) << " failed with: " << strerror(err);
+      res = TRI_ERROR_INTERNAL;
+    }
+  }
+#endif
+
+  return res;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief locks a region in memory
 ////////////////////////////////////////////////////////////////////////////////
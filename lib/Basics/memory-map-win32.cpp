@@ -86,6 +86,16 @@ int TRI_FlushMMFile(int fileDescriptor, void* startingAddress,
   return TRI_ERROR_SYS_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts writing back a range of a memory mapped file
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_StartFlushMMFile(int fileDescriptor, int64_t offset,
+                         size_t numOfBytesToFlush) {
+  // not supported, the following flush does all the work
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief maps a file on disk onto memory
 ////////////////////////////////////////////////////////////////////////////////
@@ -325,6 +335,23 @@ int TRI_MMFileAdvise(void*, size_t, int) {
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the process-wide policies for large memory mappings
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetMMFilePolicies(bool, bool) {
+  // Not on Windows
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief applies the policies set via TRI_SetMMFilePolicies to a mapping
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_MMFileApplyPolicies(void*, size_t, bool) {
+  // Not on Windows
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief locks a region in memory
 ////////////////////////////////////////////////////////////////////////////////
@@ -60,6 +60,15 @@
 int TRI_FlushMMFile(int fileDescriptor, void* startingAddress,
                     size_t numOfBytesToFlush, int flags);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts writing back a range of a memory mapped file without
+/// waiting for the write to finish. this does not make the data durable, it
+/// only shortens a following TRI_FlushMMFile. does nothing where unsupported
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_StartFlushMMFile(int fileDescriptor, int64_t offset,
+                         size_t numOfBytesToFlush);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief maps a file on disk onto memory
 ////////////////////////////////////////////////////////////////////////////////
@@ -88,6 +97,26 @@ int TRI_ProtectMMFile(void* memoryAddress, size_t numOfBytesToProtect,
 
 int TRI_MMFileAdvise(void* memoryAddress, size_t numOfBytes, int advice);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the process-wide policies for large memory mappings
+///
+/// hugePages requests transparent huge pages for anonymous memory such as
+/// large index buckets, interleave spreads the pages of a mapping over all
+/// NUMA nodes. both are ignored where unsupported
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetMMFilePolicies(bool hugePages, bool interleave);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief applies the policies set via TRI_SetMMFilePolicies to a mapping
+///
+/// anonymous must be false for file-backed mappings. huge pages are only
+/// requested for anonymous memory
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_MMFileApplyPolicies(void* memoryAddress, size_t numOfBytes,
+                            bool anonymous);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief locks a region in memory
 ////////////////////////////////////////////////////////////////////////////////
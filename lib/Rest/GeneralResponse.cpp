@@ -482,4 +482,5 @@ GeneralResponse::GeneralResponse(ResponseCode responseCode)
       _connectionType(ConnectionType::C_NONE),
       _options(velocypack::Options::Defaults),
       _generateBody(false),
+      _allowCompression(false),
       _contentTypeRequested(ContentType::UNSET) {}
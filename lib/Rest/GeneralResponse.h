@@ -61,6 +61,8 @@ class GeneralResponse {
   // response code from integer error code
   static ResponseCode responseCode(int);
 
+  ContentType contentType() const { return _contentType; }
+
   /// @brief set content-type this sets the contnt type like you expect it
   void setContentType(ContentType type) { _contentType = type; }
 
@@ -174,6 +176,23 @@ class GeneralResponse {
                                   bool resolveExternals, bool bodySkipped) {}
 
   virtual int reservePayload(std::size_t size) { return TRI_ERROR_NO_ERROR; }
+
+  // approximate number of bytes held by the response, used to account
+  // for responses that are kept around, e.g. by the async job manager
+  virtual std::size_t memoryUsage() const {
+    std::size_t total = sizeof(*this);
+
+    for (auto const& it : _headers) {
+      total += it.first.size() + it.second.size();
+    }
+
+    for (auto const& it : _vpackPayloads) {
+      total += it.size();
+    }
+
+    return total;
+  }
+
   bool generateBody() const { return _generateBody; };  // used for head
   virtual bool setGenerateBody(bool) {
     return _generateBody;
@@ -181,6 +200,11 @@ class GeneralResponse {
       // resonses
   void setOptions(VPackOptions options) { _options = std::move(options); };
 
+  // allows the transport to compress the body if the client accepts a
+  // compressed response
+  void setAllowCompression(bool value) { _allowCompression = value; }
+  bool allowCompression() const { return _allowCompression; }
+
  protected:
   ResponseCode _responseCode;  // http response code
   std::unordered_map<std::string, std::string>
@@ -192,6 +216,7 @@ class GeneralResponse {
   ConnectionType _connectionType;
   velocypack::Options _options;
   bool _generateBody;
+  bool _allowCompression;
   ContentType _contentTypeRequested;
 };
 }
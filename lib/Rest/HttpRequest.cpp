@@ -391,9 +391,11 @@ void HttpRequest::parseHeader(size_t length) {
           *valueEnd = '\0';
         }
 
-        if (keyBegin < keyEnd) {
-          setHeader(keyBegin, keyEnd - keyBegin, valueBegin,
-                    valueEnd - valueBegin);
+        if (keyBegin < keyEnd &&
+            !handleSpecialHeader(keyBegin, keyEnd - keyBegin, valueBegin,
+                                 valueEnd - valueBegin)) {
+          _headerRefs.emplace_back(StringRef(keyBegin, keyEnd - keyBegin),
+                                   StringRef(valueBegin, valueEnd - valueBegin));
         }
       }
 
@@ -413,7 +415,8 @@ void HttpRequest::parseHeader(size_t length) {
 
         // use empty value
         if (keyBegin < keyEnd) {
-          setHeader(keyBegin, keyEnd - keyBegin);
+          _headerRefs.emplace_back(StringRef(keyBegin, keyEnd - keyBegin),
+                                   StringRef());
         }
       }
     }
@@ -546,12 +549,30 @@ void HttpRequest::setHeader(char const* key, size_t keyLength,
   TRI_ASSERT(key != nullptr);
   TRI_ASSERT(value != nullptr);
 
+  if (handleSpecialHeader(key, keyLength, value, valueLength)) {
+    return;
+  }
+
+  materializeHeaders();
+  _headers[std::string(key, keyLength)] = std::string(value, valueLength);
+}
+
+/// @brief sets a key-only header
+void HttpRequest::setHeader(char const* key, size_t keyLength) {
+  materializeHeaders();
+  _headers[std::string(key, keyLength)] = StaticStrings::Empty;
+}
+
+/// @brief evaluates headers, which are not stored in the headers map or
+/// which change the request. Returns true if the header must not be stored
+bool HttpRequest::handleSpecialHeader(char const* key, size_t keyLength,
+                                      char const* value, size_t valueLength) {
   if (keyLength == StaticStrings::ContentLength.size() &&
       memcmp(key, StaticStrings::ContentLength.c_str(), keyLength) ==
           0) {  // 14 = strlen("content-length")
     _contentLength = StringUtils::int64(value, valueLength);
     // do not store this header
-    return;
+    return true;
   }
 
   if (keyLength == StaticStrings::Accept.size() && 
@@ -564,13 +585,13 @@ void HttpRequest::setHeader(char const* key, size_t keyLength,
       memcmp(key, StaticStrings::ContentTypeHeader.c_str(), keyLength) == 0 &&
       memcmp(value, StaticStrings::MimeTypeVPack.c_str(), valueLength) == 0) {
     _contentType = ContentType::VPACK;
-    return;
+    return true;
   }
 
   if (keyLength == 6 &&
       memcmp(key, "cookie", keyLength) == 0) {  // 6 = strlen("cookie")
     parseCookies(value, valueLength);
-    return;
+    return true;
   }
 
   if (_allowMethodOverride && keyLength >= 13 && *key == 'x' &&
@@ -588,16 +609,20 @@ void HttpRequest::setHeader(char const* key, size_t keyLength,
       _type = findRequestType(overriddenType.c_str(), overriddenType.size());
 
       // don't insert this header!!
-      return;
+      return true;
     }
   }
 
-  _headers[std::string(key, keyLength)] = std::string(value, valueLength);
+  return false;
 }
 
-/// @brief sets a key-only header
-void HttpRequest::setHeader(char const* key, size_t keyLength) {
-  _headers[std::string(key, keyLength)] = StaticStrings::Empty;
+/// @brief copies the headers found by parseHeader into the headers map
+void HttpRequest::materializeHeaders() const {
+  for (auto const& it : _headerRefs) {
+    _headers[it.first.toString()] = it.second.toString();
+  }
+
+  _headerRefs.clear();
 }
 
 void HttpRequest::setCookie(char* key, size_t length, char const* value) {
@@ -736,6 +761,8 @@ void HttpRequest::setBody(char const* body, size_t length) {
   _body[length] = '\0';
 }
 
+void HttpRequest::setBody(std::string&& body) { _body = std::move(body); }
+
 VPackSlice HttpRequest::payload(VPackOptions const* options) {
   TRI_ASSERT(options != nullptr);
 
@@ -762,13 +789,21 @@ std::string const& HttpRequest::header(std::string const& key,
                                        bool& found) const {
   auto it = _headers.find(key);
 
-  if (it == _headers.end()) {
-    found = false;
-    return StaticStrings::Empty;
+  if (it != _headers.end()) {
+    found = true;
+    return it->second;
   }
 
-  found = true;
-  return it->second;
+  // the last occurrence of a header wins, as it does in the headers map
+  for (auto ref = _headerRefs.rbegin(); ref != _headerRefs.rend(); ++ref) {
+    if (ref->first == key) {
+      found = true;
+      return _headers.emplace(key, ref->second.toString()).first->second;
+    }
+  }
+
+  found = false;
+  return StaticStrings::Empty;
 }
 
 std::string const& HttpRequest::header(std::string const& key) const {
@@ -25,6 +25,7 @@
 #ifndef ARANGODB_REST_HTTP_REQUEST_H
 #define ARANGODB_REST_HTTP_REQUEST_H 1
 
+#include "Basics/StringRef.h"
 #include "Endpoint/ConnectionInfo.h"
 #include "Rest/GeneralRequest.h"
 
@@ -80,6 +81,7 @@ class HttpRequest final : public GeneralRequest {
   std::string const& header(std::string const& key) const override;
   std::string const& header(std::string const& key, bool& found) const override;
   std::unordered_map<std::string, std::string> const& headers() const override {
+    materializeHeaders();
     return _headers;
   }
 
@@ -102,6 +104,7 @@ class HttpRequest final : public GeneralRequest {
 
   std::string const& body() const;
   void setBody(char const* body, size_t length);
+  void setBody(std::string&& body);
 
   // Payload
   VPackSlice payload(arangodb::velocypack::Options const*) override final;
@@ -131,6 +134,9 @@ class HttpRequest final : public GeneralRequest {
 
  private:
   void parseHeader(size_t length);
+  bool handleSpecialHeader(char const* key, size_t keyLength,
+                           char const* value, size_t valueLength);
+  void materializeHeaders() const;
   void setValues(char* buffer, char* end);
   void setCookie(char* key, size_t length, char const* value);
   void parseCookies(char const* buffer, size_t length);
@@ -146,8 +152,12 @@ class HttpRequest final : public GeneralRequest {
   bool _allowMethodOverride;
   std::shared_ptr<velocypack::Builder> _vpackBuilder;
 
+  // headers found by parseHeader, pointing into _header. They are only
+  // copied into _headers when they are looked up
+  mutable std::vector<std::pair<StringRef, StringRef>> _headerRefs;
+
   // previously in base class
-  std::unordered_map<std::string, std::string>
+  mutable std::unordered_map<std::string, std::string>
       _headers;  // is set by httpRequest: parseHeaders -> setHeaders
   std::unordered_map<std::string, std::string> _values;
   std::unordered_map<std::string, std::vector<std::string>> _arrayValues;
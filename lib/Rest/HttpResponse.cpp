@@ -30,6 +30,7 @@
 #include <velocypack/velocypack-aliases.h>
 
 #include "Basics/Exceptions.h"
+#include "Basics/StaticStrings.h"
 #include "Basics/StringBuffer.h"
 #include "Basics/StringUtils.h"
 #include "Basics/VPackStringBufferAdapter.h"
@@ -123,6 +124,17 @@ void HttpResponse::setCookie(std::string const& name, std::string const& value,
   _cookies.emplace_back(buffer->c_str());
 }
 
+int HttpResponse::deflate(size_t bufferSize) {
+  int res = _body.deflate(bufferSize);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  setHeaderNC(StaticStrings::ContentEncoding, StaticStrings::Deflate);
+  return TRI_ERROR_NO_ERROR;
+}
+
 void HttpResponse::headResponse(size_t size) {
   _body.clear();
   _isHeadResponse = true;
@@ -85,6 +85,10 @@ class HttpResponse : public GeneralResponse {
     return _generateBody = generateBody;
   }  // used for head-responses
   int reservePayload(std::size_t size) override { return _body.reserve(size); }
+
+  std::size_t memoryUsage() const override {
+    return GeneralResponse::memoryUsage() + _body.length();
+  }
   void addPayloadPostHook(VPackSlice const&, VPackOptions const* options,
                           bool resolveExternals, bool bodySkipped) override;
 
@@ -94,6 +98,7 @@ class HttpResponse : public GeneralResponse {
 
  private:
   // the body must already be set. deflate is then run on the existing body
+  // and the content-encoding header is set accordingly
   int deflate(size_t = 16384);
 
  private:
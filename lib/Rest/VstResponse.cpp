@@ -65,6 +65,15 @@ VPackMessageNoOwnBuffer VstResponse::prepareForNetwork() {
   builder.add(VPackValue(int(2)));  // 2 == response
   builder.add(
       VPackValue(static_cast<int>(meta::underlyingValue(_responseCode))));
+  if (!_headers.empty()) {
+    // the optional fourth element carries the response headers, which
+    // cluster-internal clients need (e.g. the error codes header)
+    builder.openObject();
+    for (auto const& it : _headers) {
+      builder.add(it.first, VPackValue(it.second));
+    }
+    builder.close();
+  }
   builder.close();
   _header = builder.steal();
   if (_vpackPayloads.empty()) {
@@ -47,6 +47,12 @@ class SimpleHttpCommunicatorResult: public SimpleHttpResult {
     virtual size_t getContentLength() const override { return _response->body().length(); }
     arangodb::basics::StringBuffer& getBody() override { return _response->body(); }
     std::shared_ptr<VPackBuilder> getBodyVelocyPack(VPackOptions const& options) const override {
+      if (_response->contentType() == rest::ContentType::VPACK) {
+        // VST delivers VelocyPack already, no need to go through JSON
+        auto builder = std::make_shared<VPackBuilder>(&options);
+        builder->add(VPackSlice(_response->body().c_str()));
+        return builder;
+      }
       return VPackParser::fromJson(_response->body().c_str(), _response->body().length(), &options);
     }
     virtual enum resultTypes getResultType() const override {
@@ -23,6 +23,7 @@
 #include "SslServerFeature.h"
 
 #include "Basics/FileUtils.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/locks.h"
 #include "Logger/Logger.h"
 #include "ProgramOptions/ProgramOptions.h"
@@ -41,6 +42,7 @@ SslServerFeature::SslServerFeature(
       _cafile(),
       _keyfile(),
       _sessionCache(false),
+      _preferServerCiphers(false),
       _cipherList("HIGH:!EXPORT:!aNULL@STRENGTH"),
       _sslProtocol(TLS_V12),
       _sslOptions(boost::asio::ssl::context::default_workarounds | boost::asio::ssl::context::single_dh_use),
@@ -71,6 +73,11 @@ void SslServerFeature::collectOptions(std::shared_ptr<ProgramOptions> options) {
                      "enable the session cache for connections",
                      new BooleanParameter(&_sessionCache));
 
+  options->addOption("--ssl.prefer-server-ciphers",
+                     "use the order of the cipher list instead of the "
+                     "client's preferences",
+                     new BooleanParameter(&_preferServerCiphers));
+
   options->addOption("--ssl.cipher-list",
                      "ssl ciphers to use, see OpenSSL documentation",
                      new StringParameter(&_cipherList));
@@ -110,6 +117,11 @@ void SslServerFeature::prepare() {
 }
 
 void SslServerFeature::unprepare() {
+  {
+    MUTEX_LOCKER(guard, _contextLock);
+    _context.reset();
+  }
+
   LOG_TOPIC(TRACE, arangodb::Logger::SSL) << "unpreparing ssl: "
                                           << stringifySslOptions(_sslOptions);
 }
@@ -180,6 +192,11 @@ boost::asio::ssl::context SslServerFeature::createSslContext() const {
     // set options
     sslContext.set_options(static_cast<long>(_sslOptions));
 
+    if (_preferServerCiphers) {
+      // allows preferring cheap ciphers such as ECDHE-ECDSA with AES-GCM
+      SSL_CTX_set_options(nativeContext, SSL_OP_CIPHER_SERVER_PREFERENCE);
+    }
+
     if (!_cipherList.empty()) {
       if (SSL_CTX_set_cipher_list(nativeContext, _cipherList.c_str()) != 1) {
         LOG_TOPIC(ERR, arangodb::Logger::SSL) << "cannot set SSL cipher list '"
@@ -295,6 +312,17 @@ boost::asio::ssl::context SslServerFeature::createSslContext() const {
   }
 }
 
+std::shared_ptr<boost::asio::ssl::context> SslServerFeature::sslContext() {
+  MUTEX_LOCKER(guard, _contextLock);
+
+  if (_context == nullptr) {
+    _context =
+        std::make_shared<boost::asio::ssl::context>(createSslContext());
+  }
+
+  return _context;
+}
+
 std::string SslServerFeature::stringifySslOptions(uint64_t opts) const {
   std::string result;
 
@@ -24,6 +24,7 @@
 #define ARANGODB_APPLICATION_FEATURES_SSL_SERVER_FEATURE_H 1
 
 #include "ApplicationFeatures/ApplicationFeature.h"
+#include "Basics/Mutex.h"
 
 // needs to come first
 #include "Ssl/ssl-helper.h"
@@ -50,10 +51,15 @@ class SslServerFeature : public application_features::ApplicationFeature {
  public:
   virtual boost::asio::ssl::context createSslContext() const;
 
+  // the context shared by all incoming connections, created on first use.
+  // sharing it allows clients to resume their SSL sessions
+  std::shared_ptr<boost::asio::ssl::context> sslContext();
+
  protected:
   std::string _cafile;
   std::string _keyfile;
   bool _sessionCache;
+  bool _preferServerCiphers;
   std::string _cipherList;
   uint64_t _sslProtocol;
   uint64_t _sslOptions;
@@ -64,6 +70,9 @@ class SslServerFeature : public application_features::ApplicationFeature {
 
  private:
   std::string _rctx;
+
+  Mutex _contextLock;
+  std::shared_ptr<boost::asio::ssl::context> _context;
 };
 }
 
@@ -51,6 +51,324 @@ static inline v8::Handle<v8::Value> ObjectVPackString(v8::Isolate* isolate,
   return TRI_V8_PAIR_STRING(val, l);
 }
 
+/// @brief minimum size of a VPack object to be converted lazily. smaller
+/// objects are cheaper to convert right away
+static VPackValueLength const LazyObjectMinSize = 4096;
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a lazily converted VPack object. the V8 object starts out without
+/// properties and owns a copy of the VPack object. the attributes are
+/// converted as soon as the V8 object is accessed in any way, and the copy
+/// is freed then. nested objects are converted lazily again, so only the
+/// parts of a document that are actually used are converted
+////////////////////////////////////////////////////////////////////////////////
+
+struct LazyVPackObject {
+  LazyVPackObject(v8::Isolate* isolate, VPackSlice const& slice)
+      : isolate(isolate),
+        data(slice.startAs<char>(), static_cast<size_t>(slice.byteSize())) {
+    isolate->AdjustAmountOfExternalAllocatedMemory(
+        static_cast<int64_t>(data.size()));
+  }
+
+  ~LazyVPackObject() {
+    isolate->AdjustAmountOfExternalAllocatedMemory(
+        -static_cast<int64_t>(data.size()));
+  }
+
+  bool isConverted() const { return data.empty(); }
+
+  v8::Isolate* isolate;
+  std::string data;
+  v8::Persistent<v8::Object> handle;
+};
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a VPack value can be converted without the options and
+/// the base slice it was handed in with, i.e. it does not contain custom
+/// types, translated attribute names or external values
+////////////////////////////////////////////////////////////////////////////////
+
+static bool IsSelfContained(VPackSlice const& slice, int level) {
+  if (level > MaxLevels) {
+    return false;
+  }
+
+  switch (slice.type()) {
+    case VPackValueType::Custom:
+    case VPackValueType::External:
+      return false;
+    case VPackValueType::Array: {
+      for (auto const& it : VPackArrayIterator(slice)) {
+        if (!IsSelfContained(it, level + 1)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case VPackValueType::Object: {
+      for (auto const& it : VPackObjectIterator(slice, true)) {
+        if (!it.key.isString() || !IsSelfContained(it.value, level + 1)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    default:
+      return true;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether an attribute can be left to the named property
+/// interceptors of a lazy object. array indexes are handled by indexed
+/// interceptors, and the interceptors are not asked for properties found
+/// on the prototype chain
+////////////////////////////////////////////////////////////////////////////////
+
+static bool IsLazyAttributeName(VPackSlice const& key) {
+  VPackValueLength l;
+  char const* p = key.getString(l);
+
+  bool isIndex = (l > 0);
+  for (VPackValueLength i = 0; i < l && isIndex; ++i) {
+    isIndex = (p[i] >= '0' && p[i] <= '9');
+  }
+  if (isIndex) {
+    return false;
+  }
+
+  if (l >= 2 && p[0] == '_' && p[1] == '_') {
+    // __proto__, __defineGetter__ etc.
+    return false;
+  }
+
+  static char const* const prototypeNames[] = {
+      "constructor", "hasOwnProperty", "isPrototypeOf",
+      "propertyIsEnumerable", "toLocaleString", "toString", "valueOf"};
+
+  arangodb::StringRef name(p, static_cast<size_t>(l));
+  for (auto const& it : prototypeNames) {
+    if (name == it) {
+      return false;
+    }
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts the attributes of a lazy object into properties
+////////////////////////////////////////////////////////////////////////////////
+
+static void ConvertLazyObject(v8::Isolate* isolate,
+                              v8::Local<v8::Object> object) {
+  auto lazy = static_cast<LazyVPackObject*>(
+      object->GetAlignedPointerFromInternalField(0));
+
+  if (lazy->isConverted()) {
+    return;
+  }
+
+  // mark the object as converted first, adding the properties calls the
+  // interceptors again
+  std::string data;
+  data.swap(lazy->data);
+  isolate->AdjustAmountOfExternalAllocatedMemory(
+      -static_cast<int64_t>(data.size()));
+
+  VPackSlice slice(data.data());
+  auto context = isolate->GetCurrentContext();
+
+  for (auto const& it : VPackObjectIterator(slice, true)) {
+    VPackValueLength l;
+    char const* p = it.key.getString(l);
+    object
+        ->CreateDataProperty(context, TRI_V8_PAIR_STRING(p, l),
+                             TRI_VPackToV8(isolate, it.value,
+                                           &VPackOptions::Defaults, &slice))
+        .FromMaybe(false);
+
+    if (arangodb::V8PlatformFeature::isOutOfMemory(isolate)) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief interceptors of lazy objects. they are only called for properties
+/// that the object does not have (yet). all of them convert the object and
+/// then perform the operation on the converted object
+////////////////////////////////////////////////////////////////////////////////
+
+static void LazyObjectGetter(v8::Local<v8::Name> name,
+                             v8::PropertyCallbackInfo<v8::Value> const& info) {
+  v8::Isolate* isolate = info.GetIsolate();
+  try {
+    ConvertLazyObject(isolate, info.Holder());
+  } catch (arangodb::basics::Exception const& ex) {
+    TRI_V8_THROW_EXCEPTION(ex.code());
+  } catch (...) {
+    TRI_V8_THROW_EXCEPTION(TRI_ERROR_INTERNAL);
+  }
+
+  v8::Local<v8::Value> value;
+  if (info.Holder()
+          ->GetRealNamedProperty(isolate->GetCurrentContext(), name)
+          .ToLocal(&value)) {
+    info.GetReturnValue().Set(value);
+  }
+}
+
+static void LazyObjectSetter(v8::Local<v8::Name> name,
+                             v8::Local<v8::Value> value,
+                             v8::PropertyCallbackInfo<v8::Value> const& info) {
+  v8::Isolate* isolate = info.GetIsolate();
+  auto lazy = static_cast<LazyVPackObject*>(
+      info.Holder()->GetAlignedPointerFromInternalField(0));
+  if (lazy->isConverted()) {
+    // regular assignment of a new property
+    return;
+  }
+
+  try {
+    ConvertLazyObject(isolate, info.Holder());
+  } catch (arangodb::basics::Exception const& ex) {
+    TRI_V8_THROW_EXCEPTION(ex.code());
+  } catch (...) {
+    TRI_V8_THROW_EXCEPTION(TRI_ERROR_INTERNAL);
+  }
+
+  info.Holder()
+      ->CreateDataProperty(isolate->GetCurrentContext(), name, value)
+      .FromMaybe(false);
+  info.GetReturnValue().Set(value);
+}
+
+static void LazyObjectQuery(v8::Local<v8::Name> name,
+                            v8::PropertyCallbackInfo<v8::Integer> const& info) {
+  v8::Isolate* isolate = info.GetIsolate();
+  try {
+    ConvertLazyObject(isolate, info.Holder());
+  } catch (arangodb::basics::Exception const& ex) {
+    TRI_V8_THROW_EXCEPTION(ex.code());
+  } catch (...) {
+    TRI_V8_THROW_EXCEPTION(TRI_ERROR_INTERNAL);
+  }
+
+  if (info.Holder()
+          ->HasRealNamedProperty(isolate->GetCurrentContext(), name)
+          .FromMaybe(false)) {
+    info.GetReturnValue().Set(static_cast<int32_t>(v8::None));
+  }
+}
+
+static void LazyObjectDeleter(v8::Local<v8::Name> name,
+                              v8::PropertyCallbackInfo<v8::Boolean> const& info) {
+  v8::Isolate* isolate = info.GetIsolate();
+  auto lazy = static_cast<LazyVPackObject*>(
+      info.Holder()->GetAlignedPointerFromInternalField(0));
+  if (lazy->isConverted()) {
+    return;
+  }
+
+  try {
+    ConvertLazyObject(isolate, info.Holder());
+  } catch (arangodb::basics::Exception const& ex) {
+    TRI_V8_THROW_EXCEPTION(ex.code());
+  } catch (...) {
+    TRI_V8_THROW_EXCEPTION(TRI_ERROR_INTERNAL);
+  }
+
+  info.GetReturnValue().Set(
+      info.Holder()->Delete(isolate->GetCurrentContext(), name).FromMaybe(false));
+}
+
+static void LazyObjectEnumerator(v8::PropertyCallbackInfo<v8::Array> const& info) {
+  v8::Isolate* isolate = info.GetIsolate();
+  auto lazy = static_cast<LazyVPackObject*>(
+      info.Holder()->GetAlignedPointerFromInternalField(0));
+  if (lazy->isConverted()) {
+    return;
+  }
+
+  // the names must be those of the object's own properties, which it only
+  // has after the conversion
+  VPackSlice slice(lazy->data.data());
+  v8::Handle<v8::Array> names =
+      v8::Array::New(isolate, static_cast<int>(slice.length()));
+  uint32_t j = 0;
+  for (auto const& it : VPackObjectIterator(slice, true)) {
+    VPackValueLength l;
+    char const* p = it.key.getString(l);
+    names->Set(j++, TRI_V8_PAIR_STRING(p, l));
+  }
+
+  try {
+    ConvertLazyObject(isolate, info.Holder());
+  } catch (arangodb::basics::Exception const& ex) {
+    TRI_V8_THROW_EXCEPTION(ex.code());
+  } catch (...) {
+    TRI_V8_THROW_EXCEPTION(TRI_ERROR_INTERNAL);
+  }
+
+  info.GetReturnValue().Set(names);
+}
+
+static void LazyObjectWeakCallback(
+    v8::WeakCallbackInfo<LazyVPackObject> const& data) {
+  auto lazy = data.GetParameter();
+  lazy->handle.Reset();
+  delete lazy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a lazily converted V8 object, or returns an empty handle
+/// if the VPack object must be converted right away
+////////////////////////////////////////////////////////////////////////////////
+
+static v8::Handle<v8::Object> LazyVPackObjectNew(v8::Isolate* isolate,
+                                                VPackSlice const& slice) {
+  for (auto const& it : VPackObjectIterator(slice, true)) {
+    if (!it.key.isString() || !IsLazyAttributeName(it.key) ||
+        !IsSelfContained(it.value, 1)) {
+      return v8::Handle<v8::Object>();
+    }
+  }
+
+  TRI_GET_GLOBALS();
+
+  if (v8g->VPackTempl.IsEmpty()) {
+    v8::Local<v8::ObjectTemplate> rt = v8::ObjectTemplate::New(isolate);
+    rt->SetInternalFieldCount(1);
+    rt->SetHandler(v8::NamedPropertyHandlerConfiguration(
+        LazyObjectGetter, LazyObjectSetter, LazyObjectQuery, LazyObjectDeleter,
+        LazyObjectEnumerator, v8::Local<v8::Value>(),
+        static_cast<v8::PropertyHandlerFlags>(
+            static_cast<int>(v8::PropertyHandlerFlags::kNonMasking) |
+            static_cast<int>(v8::PropertyHandlerFlags::kOnlyInterceptStrings))));
+    v8g->VPackTempl.Reset(isolate, rt);
+  }
+
+  v8::Local<v8::ObjectTemplate> rt =
+      v8::Local<v8::ObjectTemplate>::New(isolate, v8g->VPackTempl);
+  v8::Local<v8::Object> object;
+  if (!rt->NewInstance(isolate->GetCurrentContext()).ToLocal(&object)) {
+    return v8::Handle<v8::Object>();
+  }
+
+  auto lazy = new LazyVPackObject(isolate, slice);
+  object->SetAlignedPointerInInternalField(0, lazy);
+  lazy->handle.Reset(isolate, object);
+  lazy->handle.SetWeak(lazy, LazyObjectWeakCallback,
+                       v8::WeakCallbackType::kParameter);
+
+  return object;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief converts a VelocyValueType::Object into a V8 object
 ////////////////////////////////////////////////////////////////////////////////
@@ -60,6 +378,14 @@ static v8::Handle<v8::Value> ObjectVPackObject(v8::Isolate* isolate,
                                                VPackOptions const* options,
                                                VPackSlice const* base) {
   TRI_ASSERT(slice.isObject());
+
+  if (slice.byteSize() >= LazyObjectMinSize) {
+    v8::Handle<v8::Object> lazy = LazyVPackObjectNew(isolate, slice);
+    if (!lazy.IsEmpty()) {
+      return lazy;
+    }
+  }
+
   v8::Handle<v8::Object> object = v8::Object::New(isolate);
 
   if (object.IsEmpty()) {
@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "Agency/Agent.h"
+#include "Agency/Constituent.h"
+
+using namespace arangodb::consensus;
+
+namespace {
+TimePoint at(double seconds) {
+  return TimePoint() +
+         std::chrono::duration_cast<TimePoint::duration>(
+             std::chrono::duration<double>(seconds));
+}
+}
+
+TEST_CASE("ReadLease", "[agency]") {
+  /// @brief the lease follows the send time acknowledged by a majority
+  SECTION("test_lease_from_send_time") {
+    // 5 agents, 2 followers needed besides the leader
+    auto expiry = Agent::leaseExpiry({at(100), at(103), at(101), at(90)}, 2,
+                                     5.0);
+    CHECK(expiry == at(106));
+  }
+
+  /// @brief no lease without enough acknowledgements in the current term
+  SECTION("test_no_lease") {
+    CHECK(Agent::leaseExpiry({at(100)}, 2, 5.0) == TimePoint());
+    CHECK(Agent::leaseExpiry({at(100), TimePoint()}, 2, 5.0) == TimePoint());
+  }
+
+  /// @brief followers refuse votes within the election timeout after they
+  /// heard from their leader, so the lease cannot outlast its leadership
+  SECTION("test_vote_stickiness") {
+    CHECK(Constituent::leaderRecentlySeen(104.0, 100.0, 5.0));
+    CHECK_FALSE(Constituent::leaderRecentlySeen(105.5, 100.0, 5.0));
+    CHECK_FALSE(Constituent::leaderRecentlySeen(104.0, 0.0, 5.0));
+
+    // a follower received the request sent at 103 not before 103, and
+    // refuses votes until 108 at least, after the lease ended at 106
+    TimePoint const received = at(103.5);
+    double const receivedSeconds =
+        std::chrono::duration<double>(received.time_since_epoch()).count();
+    CHECK(Constituent::leaderRecentlySeen(106.0, receivedSeconds, 5.0));
+  }
+}
@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "Aql/Aggregator.h"
+#include "Basics/VelocyPackHelper.h"
+
+using namespace arangodb;
+using namespace arangodb::aql;
+
+namespace {
+/// @brief runs an aggregator over the values and returns its result
+AqlValue aggregate(std::string const& type,
+                   std::vector<AqlValue> const& values) {
+  auto aggregator = Aggregator::fromTypeString(nullptr, type);
+  for (auto const& value : values) {
+    aggregator->reduce(value);
+  }
+  return aggregator->stealValue();
+}
+
+/// @brief runs the DB server part of an aggregator over each shard's values
+/// and merges the partial results with the coordinator part
+AqlValue aggregateDistributed(
+    std::string const& type,
+    std::vector<std::vector<AqlValue>> const& shards) {
+  std::vector<AqlValue> partials;
+  for (auto const& values : shards) {
+    partials.emplace_back(
+        aggregate(Aggregator::pushToDBServerAs(type), values));
+  }
+  AqlValue result = aggregate(Aggregator::runOnCoordinatorAs(type), partials);
+  for (auto& partial : partials) {
+    partial.destroy();
+  }
+  return result;
+}
+}
+
+TEST_CASE("Aggregator", "[aql]") {
+  AqlValue const null(basics::VelocyPackHelper::NullValue());
+
+  /// @brief SUM ignores null values
+  SECTION("test_sum_null") {
+    AqlValue result = aggregate(
+        "SUM", {AqlValue(int64_t(3)), null, AqlValue(int64_t(4))});
+    CHECK(result.toDouble(nullptr) == 7.0);
+    result.destroy();
+  }
+
+  /// @brief a distributed SUM has the result of a SUM on a single server
+  SECTION("test_sum_distributed") {
+    AqlValue result = aggregateDistributed(
+        "SUM", {{AqlValue(int64_t(3)), null}, {AqlValue(int64_t(4))}});
+    CHECK(result.toDouble(nullptr) == 7.0);
+    result.destroy();
+  }
+
+  /// @brief a value that makes a shard's SUM invalid makes the distributed
+  /// SUM invalid, too
+  SECTION("test_sum_distributed_invalid") {
+    AqlValue single = aggregate(
+        "SUM", {AqlValue(int64_t(3)), AqlValue(std::string("foo")),
+                AqlValue(int64_t(4))});
+    CHECK(single.isNull(false));
+    single.destroy();
+
+    CHECK(Aggregator::runOnCoordinatorAs("SUM") == "SUM_STEP2");
+    AqlValue result = aggregateDistributed(
+        "SUM", {{AqlValue(int64_t(3)), AqlValue(std::string("foo"))},
+                {AqlValue(int64_t(4))}});
+    CHECK(result.isNull(false));
+    result.destroy();
+  }
+
+  /// @brief a distributed AVERAGE with an invalid shard is invalid
+  SECTION("test_average_distributed_invalid") {
+    AqlValue result = aggregateDistributed(
+        "AVERAGE", {{AqlValue(int64_t(3))}, {AqlValue(std::string("foo"))}});
+    CHECK(result.isNull(false));
+    result.destroy();
+
+    result = aggregateDistributed(
+        "AVERAGE", {{AqlValue(int64_t(3)), null}, {AqlValue(int64_t(5))}});
+    CHECK(result.toDouble(nullptr) == 4.0);
+    result.destroy();
+  }
+}
@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "Aql/CollectBlock.h"
+
+using namespace arangodb::aql;
+
+TEST_CASE("CollectSpillPolicy", "[aql]") {
+  /// @brief nothing is frozen below the threshold
+  SECTION("test_below_threshold") {
+    CollectSpillPolicy policy(1000, 4);
+    policy.add(0, 500);
+    policy.add(1, 499);
+    for (size_t i = 0; i < 4; ++i) {
+      CHECK_FALSE(policy.isFrozen(i));
+    }
+  }
+
+  /// @brief the largest partitions holding half of the memory are frozen
+  /// together
+  SECTION("test_freeze_batch") {
+    CollectSpillPolicy policy(100, 4);
+    policy.add(0, 30);
+    policy.add(1, 30);
+    policy.add(2, 30);
+    CHECK_FALSE(policy.isFrozen(0));
+    policy.add(3, 20);
+    CHECK(policy.isFrozen(0));
+    CHECK(policy.isFrozen(1));
+    CHECK_FALSE(policy.isFrozen(2));
+    CHECK_FALSE(policy.isFrozen(3));
+  }
+
+  /// @brief new groups after the threshold do not freeze a partition each,
+  /// the next batch is frozen after another share of the threshold
+  SECTION("test_next_batch") {
+    CollectSpillPolicy policy(1600, 16);
+    policy.add(0, 1000);
+    policy.add(1, 700);
+    CHECK(policy.isFrozen(0));
+    CHECK_FALSE(policy.isFrozen(1));
+
+    policy.add(1, 50);
+    policy.add(2, 40);
+    CHECK_FALSE(policy.isFrozen(1));
+    CHECK_FALSE(policy.isFrozen(2));
+
+    policy.add(2, 20);
+    CHECK(policy.isFrozen(1));
+    CHECK_FALSE(policy.isFrozen(2));
+    CHECK(policy.memoryUsage() == 1810);
+  }
+
+  /// @brief a spilled partition is split on other bits of the hash
+  SECTION("test_partition_levels") {
+    CollectSpillPolicy policy(100, 16);
+    size_t const hash = size_t(1) << 28;
+    CHECK(policy.partition(hash, 0) == 0);
+    CHECK(policy.partition(hash, 1) == 1);
+    CHECK(policy.partition(hash, 2) == 0);
+  }
+}
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "Aql/AqlItemBlock.h"
+#include "Aql/AstNode.h"
+#include "Aql/ColumnarExpression.h"
+#include "Aql/ResourceUsage.h"
+#include "Aql/Variable.h"
+
+using namespace arangodb::aql;
+
+namespace {
+/// @brief the expression <op>(a, b) > limit, or just <op>(a, b) without a
+/// limit, over the variables a and b
+struct TestExpression {
+  TestExpression(AstNodeType op, bool compare, double limit)
+      : a("a", 0),
+        b("b", 1),
+        refA(NODE_TYPE_REFERENCE),
+        refB(NODE_TYPE_REFERENCE),
+        arithmetic(op),
+        constant(NODE_TYPE_VALUE, VALUE_TYPE_DOUBLE),
+        comparison(NODE_TYPE_OPERATOR_BINARY_GT) {
+    refA.setData(&a);
+    refB.setData(&b);
+    arithmetic.addMember(&refA);
+    arithmetic.addMember(&refB);
+    constant.setDoubleValue(limit);
+    comparison.addMember(&arithmetic);
+    comparison.addMember(&constant);
+    root = compare ? &comparison : &arithmetic;
+  }
+
+  std::unique_ptr<ColumnarExpression> create() {
+    return ColumnarExpression::create(root, {&a, &b}, {0, 1});
+  }
+
+  Variable a;
+  Variable b;
+  AstNode refA;
+  AstNode refB;
+  AstNode arithmetic;
+  AstNode constant;
+  AstNode comparison;
+  AstNode const* root;
+};
+
+void fill(AqlItemBlock& block, std::vector<std::pair<double, double>> const& rows) {
+  for (size_t i = 0; i < rows.size(); ++i) {
+    block.setValue(i, 0, AqlValue(rows[i].first));
+    block.setValue(i, 1, AqlValue(rows[i].second));
+  }
+}
+}
+
+TEST_CASE("ColumnarExpression", "[aql]") {
+  ResourceMonitor monitor;
+
+  /// @brief finite results are computed block-wise
+  SECTION("test_finite") {
+    TestExpression expression(NODE_TYPE_OPERATOR_BINARY_TIMES, false, 0.0);
+    auto columnar = expression.create();
+    REQUIRE(columnar != nullptr);
+
+    AqlItemBlock block(&monitor, 2, 3);
+    fill(block, {{2.0, 3.0}, {-1.5, 4.0}});
+    REQUIRE(columnar->execute(nullptr, &block, 2));
+    CHECK(block.getValueReference(0, 2).slice().getNumber<double>() == 6.0);
+    CHECK(block.getValueReference(1, 2).slice().getNumber<double>() == -6.0);
+  }
+
+  /// @brief an overflowing result is left to the row-wise code path, which
+  /// turns it into null
+  SECTION("test_overflow") {
+    TestExpression expression(NODE_TYPE_OPERATOR_BINARY_TIMES, false, 0.0);
+    auto columnar = expression.create();
+    REQUIRE(columnar != nullptr);
+
+    AqlItemBlock block(&monitor, 2, 3);
+    fill(block, {{2.0, 3.0}, {1e308, 10.0}});
+    CHECK_FALSE(columnar->execute(nullptr, &block, 2));
+    CHECK(block.getValueReference(0, 2).isEmpty());
+  }
+
+  /// @brief an overflowing intermediate result is not compared as infinity
+  SECTION("test_overflow_compared") {
+    TestExpression expression(NODE_TYPE_OPERATOR_BINARY_TIMES, true, 5.0);
+    auto columnar = expression.create();
+    REQUIRE(columnar != nullptr);
+
+    AqlItemBlock block(&monitor, 1, 3);
+    fill(block, {{1e308, 10.0}});
+    CHECK_FALSE(columnar->execute(nullptr, &block, 2));
+
+    AqlItemBlock finite(&monitor, 1, 3);
+    fill(finite, {{1e300, 10.0}});
+    REQUIRE(columnar->execute(nullptr, &finite, 2));
+    CHECK(finite.getValueReference(0, 2).slice().getBool());
+  }
+}
@@ -0,0 +1,241 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "Aql/AqlValue.h"
+#include "Aql/HashJoinBlock.h"
+#include "Basics/VelocyPackHelper.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/Iterator.h>
+#include <velocypack/Parser.h>
+#include <velocypack/Value.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb::aql;
+using arangodb::basics::VelocyPackHelper;
+
+namespace {
+
+/// @brief a join result, the index of the probe row and the z attribute of
+/// the matching document
+typedef std::pair<size_t, int64_t> Match;
+
+/// @brief attribute access with AQL semantics. a missing attribute is null
+VPackSlice attribute(VPackSlice value, std::vector<std::string> const& path) {
+  for (auto const& name : path) {
+    if (!value.isObject()) {
+      return VPackSlice::nullSlice();
+    }
+    value = value.get(name);
+    if (value.isNone()) {
+      return VPackSlice::nullSlice();
+    }
+  }
+  return value;
+}
+
+/// @brief the rest of the FILTER condition, d.z > p.min
+bool recheck(VPackSlice probe, VPackSlice document) {
+  return VelocyPackHelper::compare(attribute(document, {"z"}),
+                                   attribute(probe, {"min"}), true) > 0;
+}
+
+/// @brief the matches of the hash join, optionally with the FILTER applied
+/// to them
+std::vector<Match> hashJoin(VPackSlice probes, VPackSlice documents,
+                            std::vector<std::string> const& probeAttribute,
+                            std::vector<std::string> const& buildAttribute,
+                            bool filter) {
+  VPackBuilder keys;
+  HashJoinBlock::buildKeys(nullptr, documents, buildAttribute, keys);
+  REQUIRE(documents.length() == keys.slice().length());
+
+  HashJoinBlock::HashTable table;
+  HashJoinBlock::fillHashTable(documents, keys.slice(), table);
+  REQUIRE(documents.length() == table.size());
+
+  std::vector<Match> result;
+  size_t i = 0;
+  for (auto const& probe : VPackArrayIterator(probes)) {
+    AqlValue value(AqlValueHintNoCopy(probe.begin()));
+    auto matches = HashJoinBlock::lookup(nullptr, table, value, probeAttribute);
+    for (; matches.first != matches.second; ++matches.first) {
+      VPackSlice document = (*matches.first).second;
+      if (!filter || recheck(probe, document)) {
+        result.emplace_back(i, document.get("z").getInt());
+      }
+    }
+    ++i;
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+/// @brief the matches of the nested-loop plan, FOR p IN probes FOR d IN
+/// documents FILTER d.<build> == p.<probe> [&& d.z > p.min]
+std::vector<Match> nestedLoop(VPackSlice probes, VPackSlice documents,
+                              std::vector<std::string> const& probeAttribute,
+                              std::vector<std::string> const& buildAttribute,
+                              bool filter) {
+  std::vector<Match> result;
+  size_t i = 0;
+  for (auto const& probe : VPackArrayIterator(probes)) {
+    for (auto const& document : VPackArrayIterator(documents)) {
+      if (VelocyPackHelper::compare(attribute(document, buildAttribute),
+                                    attribute(probe, probeAttribute),
+                                    true) == 0 &&
+          (!filter || recheck(probe, document))) {
+        result.emplace_back(i, document.get("z").getInt());
+      }
+    }
+    ++i;
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+std::vector<int64_t> matchesOf(std::vector<Match> const& result, size_t probe) {
+  std::vector<int64_t> z;
+  for (auto const& it : result) {
+    if (it.first == probe) {
+      z.emplace_back(it.second);
+    }
+  }
+  return z;
+}
+
+// the build side. z identifies the documents
+char const* const Documents =
+    "["
+    "{\"y\":1,\"z\":1},{\"y\":1,\"z\":2},{\"y\":1,\"z\":3},"
+    "{\"y\":2,\"z\":4},{\"y\":2.0,\"z\":5},"
+    "{\"y\":null,\"z\":6},{\"z\":7},"
+    "{\"y\":\"1\",\"z\":8},{\"y\":false,\"z\":9},"
+    "{\"y\":[1,2],\"z\":10},{\"y\":{\"a\":1},\"z\":11},"
+    "{\"y\":{\"a\":1,\"b\":2},\"z\":12}"
+    "]";
+
+// the probe side
+char const* const Probes =
+    "["
+    "{\"x\":1,\"min\":0},{\"x\":1,\"min\":2},{\"x\":2,\"min\":4},"
+    "{\"x\":null,\"min\":0},{\"min\":0},{\"x\":\"1\",\"min\":0},"
+    "{\"x\":false,\"min\":0},{\"x\":0,\"min\":0},"
+    "{\"x\":[1,2],\"min\":0},{\"x\":{\"a\":1},\"min\":0},"
+    "{\"x\":3,\"min\":0}"
+    "]";
+
+}  // namespace
+
+TEST_CASE("HashJoinBlock", "[aql]") {
+  /// @brief the build side is accounted with at least the memory of its
+  /// documents and keys, and grows with the number of hash table entries
+  SECTION("test_memory_usage") {
+    VPackBuilder documents;
+    VPackBuilder keys;
+    size_t const empty = HashJoinBlock::memoryUsage(documents, keys, 0, 0);
+
+    documents.openArray();
+    keys.openArray();
+    for (int i = 0; i < 1000; ++i) {
+      documents.openObject();
+      documents.add("value", VPackValue(std::string(100, 'x')));
+      documents.close();
+      keys.add(VPackValue(i));
+    }
+    documents.close();
+    keys.close();
+
+    size_t const filled = HashJoinBlock::memoryUsage(documents, keys, 0, 0);
+    CHECK(filled >= empty + documents.size() + keys.size());
+
+    size_t const table =
+        HashJoinBlock::memoryUsage(documents, keys, 1000, 1031);
+    CHECK(table >= filled + 1000 * 2 * sizeof(VPackSlice) +
+                       1031 * sizeof(void*));
+  }
+
+  /// @brief all documents with the same build key are joined
+  SECTION("test_duplicate_build_keys") {
+    auto documents = VPackParser::fromJson(Documents);
+    auto probes = VPackParser::fromJson(Probes);
+
+    auto result = hashJoin(probes->slice(), documents->slice(), {"x"}, {"y"},
+                           false);
+    CHECK(nestedLoop(probes->slice(), documents->slice(), {"x"}, {"y"},
+                     false) == result);
+
+    CHECK((std::vector<int64_t>{1, 2, 3}) == matchesOf(result, 0));
+    CHECK((std::vector<int64_t>{1, 2, 3}) == matchesOf(result, 1));
+    // integers and doubles with the same value are equal
+    CHECK((std::vector<int64_t>{4, 5}) == matchesOf(result, 2));
+    // no conversion between types
+    CHECK((std::vector<int64_t>{8}) == matchesOf(result, 5));
+    CHECK((std::vector<int64_t>{9}) == matchesOf(result, 6));
+    CHECK(matchesOf(result, 7).empty());
+    // arrays and objects are compared by value
+    CHECK((std::vector<int64_t>{10}) == matchesOf(result, 8));
+    CHECK((std::vector<int64_t>{11}) == matchesOf(result, 9));
+    CHECK(matchesOf(result, 10).empty());
+  }
+
+  /// @brief null and missing attributes are equal, on both sides
+  SECTION("test_null_and_missing_attributes") {
+    auto documents = VPackParser::fromJson(Documents);
+    auto probes = VPackParser::fromJson(Probes);
+
+    auto result = hashJoin(probes->slice(), documents->slice(), {"x"}, {"y"},
+                           false);
+    CHECK(nestedLoop(probes->slice(), documents->slice(), {"x"}, {"y"},
+                     false) == result);
+    CHECK((std::vector<int64_t>{6, 7}) == matchesOf(result, 3));
+    CHECK((std::vector<int64_t>{6, 7}) == matchesOf(result, 4));
+
+    // sub-attributes of values that are not objects are null
+    result = hashJoin(probes->slice(), documents->slice(), {"x", "a"},
+                      {"y", "a"}, false);
+    CHECK(nestedLoop(probes->slice(), documents->slice(), {"x", "a"},
+                     {"y", "a"}, false) == result);
+    CHECK((std::vector<int64_t>{11, 12}) == matchesOf(result, 9));
+    CHECK((std::vector<int64_t>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10}) ==
+          matchesOf(result, 0));
+  }
+
+  /// @brief the FILTER that is kept after the hash join removes the matches
+  /// that fail the rest of its condition
+  SECTION("test_filter_recheck") {
+    auto documents = VPackParser::fromJson(Documents);
+    auto probes = VPackParser::fromJson(Probes);
+
+    auto unfiltered = hashJoin(probes->slice(), documents->slice(), {"x"},
+                               {"y"}, false);
+    auto result = hashJoin(probes->slice(), documents->slice(), {"x"}, {"y"},
+                           true);
+    CHECK(nestedLoop(probes->slice(), documents->slice(), {"x"}, {"y"},
+                     true) == result);
+    CHECK(result.size() < unfiltered.size());
+
+    CHECK((std::vector<int64_t>{1, 2, 3}) == matchesOf(result, 0));
+    CHECK((std::vector<int64_t>{3}) == matchesOf(result, 1));
+    CHECK((std::vector<int64_t>{5}) == matchesOf(result, 2));
+  }
+}
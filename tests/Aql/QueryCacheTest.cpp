@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "Aql/QueryCache.h"
+#include "Aql/QueryString.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb::aql;
+
+namespace {
+QueryCacheResultEntry* createEntry(uint64_t hash, QueryString const& query,
+                                   QueryCacheKeys const& keys) {
+  auto result = std::make_shared<VPackBuilder>();
+  result->openArray();
+  result->close();
+  return new QueryCacheResultEntry(hash, query, result, {"c"}, keys,
+                                   QueryCacheRevisions());
+}
+
+bool contains(QueryCacheDatabaseEntry& cache, uint64_t hash,
+              QueryString const& query) {
+  QueryCacheResultEntryGuard guard(cache.lookup(hash, query));
+  return guard.get() != nullptr;
+}
+}
+
+TEST_CASE("QueryCache", "[aql]") {
+  QueryString const byKey(std::string("FOR d IN c FILTER d._key == 'k1' RETURN d"));
+  QueryString const fallback(std::string("RETURN DOCUMENT('c/k2')"));
+
+  /// @brief results without tracked keys, e.g. of plans with functions that
+  /// may read documents, are invalidated by a write to any document
+  SECTION("test_key_invalidation") {
+    QueryCacheDatabaseEntry cache;
+    QueryCacheKeys keys;
+    keys["c"].emplace("k1");
+    cache.store(1, createEntry(1, byKey, keys));
+    cache.store(2, createEntry(2, fallback, QueryCacheKeys()));
+
+    cache.invalidate("c", "k3");
+    CHECK(contains(cache, 1, byKey));
+    CHECK_FALSE(contains(cache, 2, fallback));
+
+    cache.invalidate("c", "k1");
+    CHECK_FALSE(contains(cache, 1, byKey));
+  }
+
+  /// @brief invalidated results are only served while stale results are
+  /// allowed
+  SECTION("test_stale") {
+    QueryCache::instance()->setMaxStaleness(60000);
+    {
+      QueryCacheDatabaseEntry cache;
+      cache.store(1, createEntry(1, fallback, QueryCacheKeys()));
+      cache.invalidate("c");
+      CHECK(contains(cache, 1, fallback));
+    }
+    QueryCache::instance()->setMaxStaleness(0);
+
+    QueryCacheDatabaseEntry cache;
+    cache.store(1, createEntry(1, fallback, QueryCacheKeys()));
+    cache.invalidate("c");
+    CHECK_FALSE(contains(cache, 1, fallback));
+  }
+}
@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "Aql/PlanCache.h"
+#include "Aql/QueryRegistry.h"
+#include "Basics/Exceptions.h"
+
+#include <velocypack/Builder.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace arangodb;
+using namespace arangodb::aql;
+
+namespace {
+std::shared_ptr<PreparedQuery> createPrepared(double ttl) {
+  return std::make_shared<PreparedQuery>(
+      "FOR doc IN test FILTER doc.value == @value RETURN doc",
+      std::make_shared<velocypack::Builder>(),
+      std::vector<std::string>{"value"}, ttl);
+}
+}
+
+TEST_CASE("QueryRegistry", "[aql]") {
+  /// @brief a prepared statement is found in its database only, and keeps
+  /// its plans for the statement's lifetime
+  SECTION("test_prepared_lookup") {
+    QueryRegistry registry;
+    auto prepared = createPrepared(600.0);
+    CHECK(prepared->plans->maxEntries() == PreparedQuery::MaxPlans);
+
+    QueryId id = registry.insertPrepared("db1", prepared);
+    CHECK(registry.numberPrepared() == 1);
+
+    auto found = registry.lookupPrepared("db1", id);
+    REQUIRE(found != nullptr);
+    CHECK(found->queryString == prepared->queryString);
+    CHECK(found->plans == prepared->plans);
+    CHECK(registry.lookupPrepared("db2", id) == nullptr);
+
+    CHECK_FALSE(registry.destroyPrepared("db2", id));
+    CHECK(registry.destroyPrepared("db1", id));
+    CHECK(registry.lookupPrepared("db1", id) == nullptr);
+    CHECK(registry.numberPrepared() == 0);
+
+    // the statement stays usable for a caller that looked it up before
+    CHECK(found->plans->maxEntries() == PreparedQuery::MaxPlans);
+  }
+
+  /// @brief unused prepared statements expire
+  SECTION("test_prepared_expire") {
+    QueryRegistry registry;
+    QueryId expiring = registry.insertPrepared("db", createPrepared(0.01));
+    QueryId kept = registry.insertPrepared("db", createPrepared(600.0));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    registry.expireQueries();
+
+    CHECK(registry.lookupPrepared("db", expiring) == nullptr);
+    CHECK(registry.lookupPrepared("db", kept) != nullptr);
+    CHECK(registry.numberPrepared() == 1);
+  }
+
+  /// @brief the number of prepared statements is limited
+  SECTION("test_prepared_limit") {
+    QueryRegistry registry;
+    std::vector<QueryId> ids;
+    for (size_t i = 0; i < QueryRegistry::MaxPrepared; ++i) {
+      ids.emplace_back(registry.insertPrepared("db", createPrepared(600.0)));
+    }
+
+    try {
+      registry.insertPrepared("other", createPrepared(600.0));
+      FAIL("expected an exception");
+    } catch (basics::Exception const& ex) {
+      CHECK(ex.code() == TRI_ERROR_RESOURCE_LIMIT);
+    }
+    CHECK(registry.numberPrepared() == QueryRegistry::MaxPrepared);
+
+    CHECK(registry.destroyPrepared("db", ids.front()));
+    registry.insertPrepared("other", createPrepared(600.0));
+    CHECK(registry.numberPrepared() == QueryRegistry::MaxPrepared);
+  }
+}
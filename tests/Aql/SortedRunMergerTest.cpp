@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "Aql/AqlItemBlock.h"
+#include "Aql/ResourceUsage.h"
+#include "Aql/SortedRunMerger.h"
+#include "Aql/SpillFile.h"
+
+using namespace arangodb::aql;
+
+namespace {
+int64_t value(AqlItemBlock const* block, size_t pos, RegisterId reg) {
+  return block->getValueReference(pos, reg).slice().getNumber<int64_t>();
+}
+
+int compare(AqlItemBlock const* a, size_t posA, AqlItemBlock const* b,
+            size_t posB) {
+  int64_t left = value(a, posA, 0);
+  int64_t right = value(b, posB, 0);
+  return left < right ? -1 : (left > right ? 1 : 0);
+}
+
+/// @brief writes a run of (key, tag) rows, two rows per block
+std::unique_ptr<SpillFile> createRun(
+    ResourceMonitor* monitor,
+    std::vector<std::pair<int64_t, int64_t>> const& rows) {
+  std::unique_ptr<SpillFile> file(new SpillFile(nullptr));
+  for (size_t i = 0; i < rows.size(); i += 2) {
+    size_t const n = (std::min)(rows.size() - i, size_t(2));
+    AqlItemBlock block(monitor, n, 2);
+    for (size_t j = 0; j < n; ++j) {
+      block.setValue(j, 0, AqlValue(rows[i + j].first));
+      block.setValue(j, 1, AqlValue(rows[i + j].second));
+    }
+    file->write(&block);
+  }
+  return file;
+}
+}
+
+TEST_CASE("SortedRunMerger", "[aql]") {
+  ResourceMonitor monitor;
+
+  /// @brief rows are produced in order, and the merger reports remaining
+  /// rows until the last one was produced or skipped
+  SECTION("test_fill_skip") {
+    SortedRunMerger merger(&monitor, compare);
+    merger.addRun(createRun(&monitor, {{1, 0}, {3, 0}, {5, 0}}));
+    merger.addRun(createRun(&monitor, {{2, 0}, {4, 0}, {6, 0}, {7, 0}}));
+    merger.start();
+
+    AqlItemBlock block(&monitor, 3, 2);
+    REQUIRE(merger.fill(&block) == 3);
+    CHECK(value(&block, 0, 0) == 1);
+    CHECK(value(&block, 1, 0) == 2);
+    CHECK(value(&block, 2, 0) == 3);
+    CHECK(merger.hasMore());
+
+    CHECK(merger.skip(2) == 2);
+    CHECK(merger.hasMore());
+
+    AqlItemBlock rest(&monitor, 3, 2);
+    REQUIRE(merger.fill(&rest) == 2);
+    CHECK(value(&rest, 0, 0) == 6);
+    CHECK(value(&rest, 1, 0) == 7);
+    CHECK_FALSE(merger.hasMore());
+    CHECK(merger.skip(10) == 0);
+  }
+
+  /// @brief skipping over the end returns the number of rows actually left
+  SECTION("test_skip_all") {
+    SortedRunMerger merger(&monitor, compare);
+    merger.addRun(createRun(&monitor, {{1, 0}, {2, 0}, {3, 0}}));
+    merger.start();
+
+    CHECK(merger.skip(10) == 3);
+    CHECK_FALSE(merger.hasMore());
+    CHECK(merger.numberOfRuns() == 0);
+  }
+
+  /// @brief equal rows are produced in the order of the runs
+  SECTION("test_stable") {
+    SortedRunMerger merger(&monitor, compare);
+    merger.addRun(createRun(&monitor, {{1, 0}, {2, 0}}));
+    merger.addRun(createRun(&monitor, {{1, 1}, {2, 1}}));
+    merger.addRun(createRun(&monitor, {{1, 2}}));
+    merger.start();
+
+    AqlItemBlock block(&monitor, 5, 2);
+    REQUIRE(merger.fill(&block) == 5);
+    CHECK(value(&block, 0, 1) == 0);
+    CHECK(value(&block, 1, 1) == 1);
+    CHECK(value(&block, 2, 1) == 2);
+    CHECK(value(&block, 3, 1) == 0);
+    CHECK(value(&block, 4, 1) == 1);
+  }
+
+  /// @brief an empty run is ignored
+  SECTION("test_empty_run") {
+    SortedRunMerger merger(&monitor, compare);
+    merger.addRun(createRun(&monitor, {}));
+    merger.start();
+    CHECK_FALSE(merger.hasMore());
+  }
+}
@@ -0,0 +1,321 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for AssocUnique
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include "Basics/AssocUnique.h"
+#include "Basics/LocalTaskQueue.h"
+#include "Basics/asio-helper.h"
+#include "Basics/fasthash.h"
+
+#include <thread>
+
+using namespace arangodb::basics;
+
+namespace {
+
+struct Entry {
+  uint64_t key;
+  uint64_t value;
+};
+
+typedef AssocUnique<uint64_t, Entry*> Hash;
+
+// number of elements in a bucket after which the next bucket is split,
+// the same as AssocUnique::maxBucketSize()
+uint64_t const MaxBucketSize = 1ULL << 19;
+
+uint64_t HashKey(void*, uint64_t const* key) {
+  return fasthash64_uint64(*key, 0x12345678);
+}
+
+uint64_t HashElement(void*, Entry* const& element) {
+  return fasthash64_uint64(element->key, 0x12345678);
+}
+
+bool IsEqualKeyElement(void*, uint64_t const* key, uint64_t,
+                       Entry* const& element) {
+  return *key == element->key;
+}
+
+bool IsEqualElementElement(void*, Entry* const& left, Entry* const& right) {
+  return left == right;
+}
+
+bool IsEqualElementElementByKey(void*, Entry* const& left,
+                                Entry* const& right) {
+  return left->key == right->key;
+}
+
+std::unique_ptr<Hash> createHash() {
+  return std::unique_ptr<Hash>(new Hash(HashKey, HashElement,
+                                        IsEqualKeyElement,
+                                        IsEqualElementElement,
+                                        IsEqualElementElementByKey, 1));
+}
+
+std::vector<Entry> createEntries(size_t n) {
+  std::vector<Entry> entries(n);
+  for (size_t i = 0; i < n; ++i) {
+    entries[i].key = i;
+    entries[i].value = i * 2;
+  }
+  return entries;
+}
+
+void insertAll(Hash& hash, std::vector<Entry>& entries) {
+  for (auto& it : entries) {
+    REQUIRE(TRI_ERROR_NO_ERROR == hash.insert(nullptr, &it));
+  }
+}
+
+void checkAll(Hash& hash, std::vector<Entry>& entries) {
+  for (auto& it : entries) {
+    REQUIRE(&it == hash.findByKey(nullptr, &it.key));
+    REQUIRE(&it == hash.find(nullptr, &it));
+  }
+}
+
+}  // namespace
+
+TEST_CASE("AssocUniqueTest", "[assocunique]") {
+  /// @brief splitting a bucket through inserts
+  SECTION("test_split_on_insert") {
+    auto hash = createHash();
+    std::vector<Entry> entries = createEntries(MaxBucketSize + 1000);
+
+    size_t i = 0;
+    for (; i <= MaxBucketSize; ++i) {
+      REQUIRE(TRI_ERROR_NO_ERROR == hash->insert(nullptr, &entries[i]));
+    }
+    // the single bucket has exceeded the limit and was split
+    CHECK(2 == hash->buckets());
+
+    for (; i < entries.size(); ++i) {
+      REQUIRE(TRI_ERROR_NO_ERROR == hash->insert(nullptr, &entries[i]));
+    }
+    CHECK(entries.size() == hash->size());
+    checkAll(*hash, entries);
+  }
+
+  /// @brief lookups and removals after split rounds
+  SECTION("test_split_rounds") {
+    auto hash = createHash();
+    std::vector<Entry> entries = createEntries(1000);
+    insertAll(*hash, entries);
+
+    // 1 -> 2 -> 3 buckets, the second round is only partly done
+    REQUIRE(TRI_ERROR_NO_ERROR == hash->resize(nullptr, 3 * MaxBucketSize));
+    CHECK(3 == hash->buckets());
+    CHECK(entries.size() == hash->size());
+    checkAll(*hash, entries);
+
+    // finish the second round and start the third one
+    REQUIRE(TRI_ERROR_NO_ERROR == hash->resize(nullptr, 5 * MaxBucketSize));
+    CHECK(5 == hash->buckets());
+    CHECK(entries.size() == hash->size());
+    checkAll(*hash, entries);
+
+    // remove every other element
+    for (size_t i = 0; i < entries.size(); i += 2) {
+      REQUIRE(&entries[i] == hash->removeByKey(nullptr, &entries[i].key));
+      REQUIRE(nullptr == hash->removeByKey(nullptr, &entries[i].key));
+    }
+    CHECK(entries.size() / 2 == hash->size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+      if (i % 2 == 0) {
+        CHECK(nullptr == hash->findByKey(nullptr, &entries[i].key));
+      } else {
+        CHECK(&entries[i] == hash->findByKey(nullptr, &entries[i].key));
+      }
+    }
+
+    // remove by element, and put the removed ones back
+    for (size_t i = 1; i < entries.size(); i += 4) {
+      REQUIRE(&entries[i] == hash->remove(nullptr, &entries[i]));
+      REQUIRE(nullptr == hash->remove(nullptr, &entries[i]));
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+      if (i % 2 == 0 || i % 4 == 1) {
+        REQUIRE(TRI_ERROR_NO_ERROR == hash->insert(nullptr, &entries[i]));
+      }
+    }
+    CHECK(entries.size() == hash->size());
+    checkAll(*hash, entries);
+
+    // keys stay unique in all buckets
+    for (auto& it : entries) {
+      Entry other{it.key, 0};
+      CHECK(TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED ==
+            hash->insert(nullptr, &other));
+    }
+    CHECK(entries.size() == hash->size());
+  }
+
+  /// @brief truncate goes back to the initial number of buckets
+  SECTION("test_truncate") {
+    auto hash = createHash();
+    std::vector<Entry> entries = createEntries(1000);
+    insertAll(*hash, entries);
+    REQUIRE(TRI_ERROR_NO_ERROR == hash->resize(nullptr, 3 * MaxBucketSize));
+    REQUIRE(3 == hash->buckets());
+
+    size_t found = 0;
+    hash->truncate([&found](Entry*&) -> bool {
+      ++found;
+      return true;
+    });
+    CHECK(entries.size() == found);
+    CHECK(1 == hash->buckets());
+    CHECK(0 == hash->size());
+    CHECK(hash->isEmpty());
+    for (auto& it : entries) {
+      CHECK(nullptr == hash->findByKey(nullptr, &it.key));
+    }
+
+    insertAll(*hash, entries);
+    CHECK(entries.size() == hash->size());
+    checkAll(*hash, entries);
+  }
+
+  /// @brief batchInsert distributes the elements over split buckets
+  SECTION("test_batch_insert") {
+    auto hash = createHash();
+    std::vector<Entry> entries = createEntries(10000);
+    // insert some of the elements before splitting
+    for (size_t i = 0; i < 100; ++i) {
+      REQUIRE(TRI_ERROR_NO_ERROR == hash->insert(nullptr, &entries[i]));
+    }
+    REQUIRE(TRI_ERROR_NO_ERROR == hash->resize(nullptr, 3 * MaxBucketSize));
+    REQUIRE(3 == hash->buckets());
+
+    boost::asio::io_service ioService;
+    std::unique_ptr<boost::asio::io_service::work> work(
+        new boost::asio::io_service::work(ioService));
+    std::thread runner([&ioService]() { ioService.run(); });
+
+    auto contextCreator = []() -> void* { return nullptr; };
+    auto contextDestroyer = [](void*) {};
+
+    auto runBatch = [&](std::vector<Entry*> const& elements) -> int {
+      auto queue = std::make_shared<LocalTaskQueue>(&ioService);
+      hash->batchInsert(contextCreator, contextDestroyer,
+                        std::make_shared<std::vector<Entry*>>(elements),
+                        queue);
+      queue->dispatchAndWait();
+      return queue->status();
+    };
+
+    std::vector<Entry*> elements;
+    for (size_t i = 100; i < entries.size(); ++i) {
+      elements.emplace_back(&entries[i]);
+    }
+    CHECK(TRI_ERROR_NO_ERROR == runBatch(elements));
+    CHECK(entries.size() == hash->size());
+    checkAll(*hash, entries);
+
+    // a key that is already present fails the batch
+    Entry duplicate{42, 0};
+    CHECK(TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED ==
+          runBatch(std::vector<Entry*>{&duplicate}));
+    CHECK(&entries[42] == hash->findByKey(nullptr, &duplicate.key));
+
+    work.reset();
+    ioService.stop();
+    runner.join();
+  }
+
+  /// @brief iteration visits all elements of all buckets once
+  SECTION("test_iteration") {
+    auto hash = createHash();
+
+    BucketPosition position;
+    uint64_t total = 42;
+    CHECK(nullptr == hash->findSequential(nullptr, position, total));
+    CHECK(0 == total);
+
+    std::vector<Entry> entries = createEntries(1000);
+    insertAll(*hash, entries);
+    REQUIRE(TRI_ERROR_NO_ERROR == hash->resize(nullptr, 5 * MaxBucketSize));
+    REQUIRE(5 == hash->buckets());
+
+    // forwards. the first call sets the total
+    std::unordered_set<Entry*> seen;
+    position = BucketPosition();
+    total = 0;
+    while (Entry* e = hash->findSequential(nullptr, position, total)) {
+      CHECK(seen.emplace(e).second);
+      CHECK(entries.size() == total);
+    }
+    CHECK(entries.size() == seen.size());
+
+    // a restart does not modify the total
+    seen.clear();
+    position.reset();
+    total = 42;
+    while (Entry* e = hash->findSequential(nullptr, position, total)) {
+      CHECK(seen.emplace(e).second);
+    }
+    CHECK(entries.size() == seen.size());
+    CHECK(42 == total);
+
+    // continuing at a position
+    seen.clear();
+    position = BucketPosition();
+    for (size_t i = 0; i < 500; ++i) {
+      Entry* e = hash->findSequential(nullptr, position, total);
+      REQUIRE(nullptr != e);
+      CHECK(seen.emplace(e).second);
+    }
+    BucketPosition saved = position;
+    while (Entry* e = hash->findSequential(nullptr, position, total)) {
+      CHECK(seen.emplace(e).second);
+    }
+    CHECK(entries.size() == seen.size());
+    CHECK(entries.size() == total);
+    CHECK(saved.bucketId < hash->buckets());
+
+    // backwards
+    seen.clear();
+    position = BucketPosition();
+    while (Entry* e = hash->findSequentialReverse(nullptr, position)) {
+      CHECK(seen.emplace(e).second);
+    }
+    CHECK(entries.size() == seen.size());
+
+    // random order. the total is the capacity of all buckets
+    seen.clear();
+    BucketPosition initial;
+    position = BucketPosition();
+    uint64_t step = 0;
+    while (Entry* e =
+               hash->findRandom(nullptr, initial, position, step, total)) {
+      CHECK(seen.emplace(e).second);
+    }
+    CHECK(entries.size() == seen.size());
+    CHECK(hash->capacity() == total);
+  }
+}
@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for DistributedReadWriteLock
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include "Basics/DistributedReadWriteLock.h"
+#include "Basics/ReadLocker.h"
+#include "Basics/WriteLocker.h"
+
+#include <thread>
+
+using namespace arangodb::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+TEST_CASE("DistributedReadWriteLockTest", "[locks]") {
+  DistributedReadWriteLock lock;
+
+  /// @brief readers share the lock, writers exclude everyone
+  SECTION("test_exclusion") {
+    CHECK(lock.tryReadLock());
+    CHECK(lock.tryReadLock());
+    CHECK_FALSE(lock.tryWriteLock());
+    lock.unlock();
+    lock.unlock();
+
+    CHECK(lock.tryWriteLock());
+    CHECK_FALSE(lock.tryReadLock());
+    CHECK_FALSE(lock.tryWriteLock());
+    lock.unlock();
+
+    CHECK(lock.tryReadLock());
+    lock.unlockRead();
+  }
+
+  /// @brief a read lock can be released by another thread
+  SECTION("test_unlock_other_thread") {
+    lock.readLock();
+    std::thread([&lock]() { lock.unlock(); }).join();
+    CHECK(lock.tryWriteLock());
+    lock.unlockWrite();
+  }
+
+  /// @brief writers are not lost between concurrent readers
+  SECTION("test_concurrent") {
+    uint64_t value = 0;
+    std::atomic<bool> inconsistent(false);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 4; ++i) {
+      threads.emplace_back([&, i]() {
+        for (size_t j = 0; j < 10000; ++j) {
+          if (j % 10 == i) {
+            WRITE_LOCKER(locker, lock);
+            uint64_t old = value;
+            value = old + 1;
+          } else {
+            READ_LOCKER(locker, lock);
+            uint64_t old = value;
+            std::this_thread::yield();
+            if (value != old) {
+              inconsistent = true;
+            }
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    CHECK_FALSE(inconsistent.load());
+    CHECK(value == 4000);
+  }
+}
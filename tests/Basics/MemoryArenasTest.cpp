@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for MemoryArenas
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include "Basics/MemoryArenas.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+TEST_CASE("MemoryArenasTest", "[memory]") {
+  /// @brief memory of an arena can be used and freed
+  SECTION("test_allocate") {
+    void* data = MemoryArenas::allocate(MemoryArena::CACHE, 1024 * 1024);
+    REQUIRE(data != nullptr);
+    memset(data, 1, 1024 * 1024);
+    MemoryArenas::deallocate(MemoryArena::CACHE, data, 1024 * 1024);
+  }
+
+  /// @brief containers work with the arena allocator
+  SECTION("test_allocator") {
+    std::vector<uint64_t, MemoryArenaAllocator<uint64_t, MemoryArena::PREGEL>>
+        values;
+    for (uint64_t i = 0; i < 100000; ++i) {
+      values.push_back(i);
+    }
+    CHECK(values.size() == 100000);
+    CHECK(values[99999] == 99999);
+  }
+
+  /// @brief a thread can be bound to an arena temporarily
+  SECTION("test_scope") {
+    MemoryArenaScope scope(MemoryArena::AQL);
+    std::unique_ptr<char[]> data(new char[4096]);
+    CHECK(data != nullptr);
+  }
+
+  /// @brief the statistics report whether jemalloc is used
+  SECTION("test_statistics") {
+    VPackBuilder builder;
+    builder.openObject();
+    MemoryArenas::toVelocyPack(builder);
+    builder.close();
+    CHECK(builder.slice().get("jemalloc").getBool() ==
+          MemoryArenas::isSupported());
+    if (MemoryArenas::isSupported()) {
+      CHECK(builder.slice().get("arenas").hasKey("cache"));
+    }
+  }
+}
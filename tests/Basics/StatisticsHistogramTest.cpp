@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for StatisticsHistogram
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include "Statistics/figures.h"
+
+using namespace arangodb::basics;
+
+TEST_CASE("StatisticsHistogramTest", "[statistics]") {
+
+SECTION("test_empty") {
+  StatisticsHistogram h;
+
+  CHECK(h._count == 0);
+  CHECK(h.percentile(0.5) == 0.0);
+  CHECK(h.percentile(0.999) == 0.0);
+}
+
+SECTION("test_buckets_are_contiguous") {
+  size_t last = 0;
+
+  for (uint64_t v = 0; v < (1 << 20); ++v) {
+    size_t bucket = StatisticsHistogram::bucket(v);
+    CHECK((bucket == last || bucket == last + 1));
+    last = bucket;
+  }
+
+  CHECK(StatisticsHistogram::bucket(UINT64_MAX) ==
+        StatisticsHistogram::NUMBER_OF_BUCKETS - 1);
+}
+
+SECTION("test_small_values_are_exact") {
+  for (size_t i = 0; i < StatisticsHistogram::SUB_BUCKETS; ++i) {
+    CHECK(StatisticsHistogram::value(StatisticsHistogram::bucket(i)) ==
+          static_cast<double>(i));
+  }
+}
+
+SECTION("test_percentiles") {
+  StatisticsHistogram h;
+
+  // 1 ms .. 1000 ms
+  for (int i = 1; i <= 1000; ++i) {
+    h.addFigure(i / 1000.0);
+  }
+
+  CHECK(h._count == 1000);
+  CHECK(h._max == 1.0);
+
+  // the relative error is bounded by the width of a bucket
+  CHECK(std::abs(h.percentile(0.5) - 0.5) < 0.5 / 16);
+  CHECK(std::abs(h.percentile(0.99) - 0.99) < 0.99 / 16);
+  CHECK(h.percentile(0.999) <= 1.0);
+  CHECK(h.percentile(1.0) == 1.0);
+}
+
+SECTION("test_tail") {
+  StatisticsHistogram h;
+
+  for (int i = 0; i < 999; ++i) {
+    h.addFigure(0.001);
+  }
+  h.addFigure(2.0);
+
+  CHECK(h.percentile(0.99) < 0.0011);
+  CHECK(h.percentile(1.0) == 2.0);
+}
+
+SECTION("test_add") {
+  StatisticsHistogram a;
+  StatisticsHistogram b;
+
+  for (int i = 1; i <= 500; ++i) {
+    a.addFigure(i / 1000.0);
+    b.addFigure((i + 500) / 1000.0);
+  }
+
+  a.add(b);
+
+  CHECK(a._count == 1000);
+  CHECK(a._max == 1.0);
+  CHECK(std::abs(a.percentile(0.5) - 0.5) < 0.5 / 16);
+  CHECK(a.percentile(1.0) == 1.0);
+}
+}
@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include "Basics/StringBuffer.h"
+#include "Basics/VelocyPackDumper.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/Options.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+using namespace arangodb::basics;
+
+namespace {
+std::string dump(VPackSlice slice,
+                 VPackOptions const* options = &VPackOptions::Defaults) {
+  StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE, false);
+  VelocyPackDumper dumper(&buffer, options);
+  dumper.dumpValue(slice);
+  return std::string(buffer.c_str(), buffer.length());
+}
+
+std::string dumpString(std::string const& value,
+                       VPackOptions const* options = &VPackOptions::Defaults) {
+  VPackBuilder builder;
+  builder.add(VPackValue(value));
+  return dump(builder.slice(), options);
+}
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+TEST_CASE("VelocyPackDumperTest", "[vpack]") {
+  /// @brief characters that must be escaped are found at any position,
+  /// including behind long runs of plain characters
+  SECTION("test_escape_positions") {
+    std::string const prefix("abcdefghijklmnopqrstuvwxyz0123456789");
+
+    for (size_t i = 0; i < prefix.size(); ++i) {
+      std::string value = prefix.substr(0, i);
+      CHECK(dumpString(value + "\"" + value) ==
+            "\"" + value + "\\\"" + value + "\"");
+      CHECK(dumpString(value + "\\" + value) ==
+            "\"" + value + "\\\\" + value + "\"");
+      CHECK(dumpString(value + "\n" + value) ==
+            "\"" + value + "\\n" + value + "\"");
+      CHECK(dumpString(value + "\x01" + value) ==
+            "\"" + value + "\\u0001" + value + "\"");
+      CHECK(dumpString(value + "\xc3\xa4" + value) ==
+            "\"" + value + "\xc3\xa4" + value + "\"");
+    }
+  }
+
+  /// @brief forward slashes are only escaped on request
+  SECTION("test_escape_forward_slashes") {
+    std::string const value("http://www.example.com/some/long/path/to/a/file");
+
+    VPackOptions options;
+    options.escapeForwardSlashes = false;
+    CHECK(dumpString(value, &options) == "\"" + value + "\"");
+
+    options.escapeForwardSlashes = true;
+    CHECK(dumpString(value, &options) ==
+          "\"http:\\/\\/www.example.com\\/some\\/long\\/path\\/to\\/a\\/file\"");
+  }
+
+  /// @brief non-ASCII characters are escaped on request
+  SECTION("test_escape_unicode") {
+    VPackOptions options;
+    options.escapeUnicode = true;
+    CHECK(dumpString("some text before the umlaut \xc3\xa4 and after it",
+                     &options) ==
+          "\"some text before the umlaut \\u00E4 and after it\"");
+  }
+
+  /// @brief nested values
+  SECTION("test_object") {
+    VPackBuilder builder;
+    builder.openObject();
+    builder.add("name", VPackValue("a rather long string value"));
+    builder.add("value", VPackValue(42));
+    builder.add("list", VPackValue(VPackValueType::Array));
+    builder.add(VPackValue(1.5));
+    builder.add(VPackValue(false));
+    builder.close();
+    builder.close();
+
+    CHECK(dump(builder.slice()) ==
+          "{\"name\":\"a rather long string value\",\"value\":42,"
+          "\"list\":[1.5,false]}");
+  }
+}
@@ -511,6 +511,26 @@ SECTION("tst_crc32_utf8") {
   CHECK((uint64_t) 1426740181ULL ==   TRI_FinalCrc32(TRI_BlockCrc32(TRI_InitialCrc32(), buffer.c_str(), strlen(buffer.c_str()))));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the crc32 implementation picked at runtime computes the
+/// same values as the portable one, for all lengths and alignments
+////////////////////////////////////////////////////////////////////////////////
+
+SECTION("tst_crc32_implementations") {
+  std::string buffer;
+  for (size_t i = 0; i < 256; ++i) {
+    buffer.push_back(static_cast<char>((i * 97) ^ (i >> 3)));
+  }
+
+  for (size_t offset = 0; offset < 8; ++offset) {
+    for (size_t length = 0; length + offset <= buffer.size(); ++length) {
+      char const* data = buffer.c_str() + offset;
+      CHECK(TRI_BlockCrc32_C(TRI_InitialCrc32(), data, length) ==
+            TRI_BlockCrc32(TRI_InitialCrc32(), data, length));
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief generate tests
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MicroBenchmark.h"
+
+#include "Aql/AqlValue.h"
+#include "Basics/VelocyPackHelper.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/Parser.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+using namespace arangodb::aql;
+using namespace arangodb::benchmarks;
+
+// AqlValue::Compare needs a transaction only for the vpack options of its
+// context. for values of the same vpack based type it compares the slices
+// with VelocyPackHelper::compare, which is what is measured here, together
+// with the construction of the values in the way the executors create them.
+
+namespace {
+void compareValues(MicroBenchmarkState& state, AqlValue left,
+                   AqlValue right) {
+  state.measure([&](uint64_t) {
+    doNotOptimize(basics::VelocyPackHelper::compare(left.slice(),
+                                                    right.slice(), true));
+  });
+
+  left.destroy();
+  right.destroy();
+}
+}
+
+MICRO_BENCHMARK(AqlValue_create_int) {
+  state.measure([&](uint64_t i) {
+    AqlValue value(static_cast<int64_t>(i));
+    doNotOptimize(value.slice().head());
+  });
+}
+
+MICRO_BENCHMARK(AqlValue_create_double) {
+  state.measure([&](uint64_t i) {
+    AqlValue value(static_cast<double>(i) + 0.5);
+    doNotOptimize(value.slice().head());
+  });
+}
+
+MICRO_BENCHMARK(AqlValue_create_short_string) {
+  std::string const s("customer");
+
+  state.measure([&](uint64_t) {
+    AqlValue value(s);
+    doNotOptimize(value.slice().head());
+    value.destroy();
+  });
+}
+
+MICRO_BENCHMARK(AqlValue_create_long_string) {
+  std::string const s(
+      "the quick brown fox jumps over the lazy dog, again and again");
+
+  state.measure([&](uint64_t) {
+    AqlValue value(s);
+    doNotOptimize(value.slice().head());
+    value.destroy();
+  });
+}
+
+MICRO_BENCHMARK(AqlValue_copy_object) {
+  auto document = VPackParser::fromJson(
+      "{\"_key\": \"12345\", \"name\": \"foo\", \"age\": 42, "
+      "\"tags\": [\"a\", \"b\", \"c\"]}");
+  AqlValue value(document->slice());
+
+  state.measure([&](uint64_t) {
+    AqlValue copy = value.clone();
+    doNotOptimize(copy.slice().head());
+    copy.destroy();
+  });
+
+  value.destroy();
+}
+
+MICRO_BENCHMARK(AqlValue_compare_int) {
+  compareValues(state, AqlValue(int64_t(123456)), AqlValue(int64_t(123457)));
+}
+
+MICRO_BENCHMARK(AqlValue_compare_double) {
+  compareValues(state, AqlValue(123456.25), AqlValue(123456.5));
+}
+
+MICRO_BENCHMARK(AqlValue_compare_string) {
+  compareValues(state, AqlValue(std::string("customer-0000012345")),
+                AqlValue(std::string("customer-0000012346")));
+}
+
+MICRO_BENCHMARK(AqlValue_compare_object) {
+  auto left = VPackParser::fromJson(
+      "{\"_key\": \"12345\", \"name\": \"foo\", \"age\": 42}");
+  auto right = VPackParser::fromJson(
+      "{\"_key\": \"12345\", \"name\": \"foo\", \"age\": 43}");
+  compareValues(state, AqlValue(left->slice()), AqlValue(right->slice()));
+}
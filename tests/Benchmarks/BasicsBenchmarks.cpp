@@ -0,0 +1,180 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MicroBenchmark.h"
+
+#include "Basics/AssocMulti.h"
+#include "Basics/VelocyPackHelper.h"
+#include "Basics/fasthash.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/Parser.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+using namespace arangodb::benchmarks;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        AssocMulti
+// -----------------------------------------------------------------------------
+
+namespace {
+struct Element {
+  uint64_t key;
+  uint64_t value;
+};
+
+// each key has this many values, as in a non-unique hash index
+uint64_t const ValuesPerKey = 4;
+uint64_t const NumberOfElements = 100000;
+
+uint64_t HashKey(void*, uint64_t const* key) {
+  return fasthash64_uint64(*key, 0x12345678);
+}
+
+uint64_t HashElement(void*, void* const& e, bool byKey) {
+  Element const* element = static_cast<Element const*>(e);
+  return fasthash64_uint64(byKey ? element->key : element->value, 0x12345678);
+}
+
+bool IsEqualKeyElement(void*, uint64_t const* key, void* const& e) {
+  return *key == static_cast<Element const*>(e)->key;
+}
+
+bool IsEqualElementElement(void*, void* const& l, void* const& r) {
+  return static_cast<Element const*>(l)->value ==
+         static_cast<Element const*>(r)->value;
+}
+
+bool IsEqualElementElementByKey(void*, void* const& l, void* const& r) {
+  return static_cast<Element const*>(l)->key ==
+         static_cast<Element const*>(r)->key;
+}
+
+typedef basics::AssocMulti<uint64_t, void*, uint32_t, true> MultiIndex;
+
+std::unique_ptr<MultiIndex> createMultiIndex() {
+  return std::make_unique<MultiIndex>(HashKey, HashElement, IsEqualKeyElement,
+                                      IsEqualElementElement,
+                                      IsEqualElementElementByKey);
+}
+
+std::vector<Element> createElements() {
+  std::vector<Element> elements(NumberOfElements);
+  for (uint64_t i = 0; i < NumberOfElements; ++i) {
+    elements[i].key = i / ValuesPerKey;
+    elements[i].value = i;
+  }
+  return elements;
+}
+}
+
+MICRO_BENCHMARK(AssocMulti_insert) {
+  auto elements = createElements();
+  std::unique_ptr<MultiIndex> index = createMultiIndex();
+
+  state.measure([&](uint64_t i) {
+    uint64_t const n = i % NumberOfElements;
+    if (n == 0 && i != 0) {
+      // start over with an empty index, the resizes are part of the cost
+      index = createMultiIndex();
+    }
+    doNotOptimize(index->insert(nullptr, &elements[n], false, false));
+  });
+}
+
+MICRO_BENCHMARK(AssocMulti_lookupByKey) {
+  auto elements = createElements();
+  auto index = createMultiIndex();
+  for (auto& element : elements) {
+    index->insert(nullptr, &element, false, false);
+  }
+
+  std::vector<void*> result;
+  state.measure([&](uint64_t i) {
+    uint64_t const key = (i * 7919) % (NumberOfElements / ValuesPerKey);
+    result.clear();
+    index->lookupByKey(nullptr, &key, result);
+    doNotOptimize(result.size());
+  });
+}
+
+MICRO_BENCHMARK(AssocMulti_lookup) {
+  auto elements = createElements();
+  auto index = createMultiIndex();
+  for (auto& element : elements) {
+    index->insert(nullptr, &element, false, false);
+  }
+
+  state.measure([&](uint64_t i) {
+    void* element = &elements[(i * 7919) % NumberOfElements];
+    doNotOptimize(index->lookup(nullptr, element));
+  });
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                         VelocyPackHelper::compare
+// -----------------------------------------------------------------------------
+
+namespace {
+void compareJson(MicroBenchmarkState& state, char const* left,
+                 char const* right) {
+  auto l = VPackParser::fromJson(left);
+  auto r = VPackParser::fromJson(right);
+  VPackSlice const ls = l->slice();
+  VPackSlice const rs = r->slice();
+
+  state.measure([&](uint64_t) {
+    doNotOptimize(basics::VelocyPackHelper::compare(ls, rs, true));
+  });
+}
+}
+
+MICRO_BENCHMARK(VelocyPackHelper_compare_int) {
+  compareJson(state, "123456", "123457");
+}
+
+MICRO_BENCHMARK(VelocyPackHelper_compare_int_double) {
+  compareJson(state, "123456", "123456.5");
+}
+
+MICRO_BENCHMARK(VelocyPackHelper_compare_string_ascii) {
+  compareJson(state, "\"the quick brown fox jumps over the lazy dog\"",
+              "\"the quick brown fox jumps over the lazy cat\"");
+}
+
+MICRO_BENCHMARK(VelocyPackHelper_compare_string_utf8) {
+  compareJson(state, "\"Grüße aus Köln, über den Rhein\"",
+              "\"Grüße aus Köln, über die Brücke\"");
+}
+
+MICRO_BENCHMARK(VelocyPackHelper_compare_array) {
+  compareJson(state, "[1, 2, 3, \"foo\", [4, 5, 6], true, null]",
+              "[1, 2, 3, \"foo\", [4, 5, 7], true, null]");
+}
+
+MICRO_BENCHMARK(VelocyPackHelper_compare_object) {
+  compareJson(state,
+              "{\"name\": \"foo\", \"age\": 42, \"tags\": [\"a\", \"b\"], "
+              "\"address\": {\"city\": \"Cologne\", \"zip\": \"50667\"}}",
+              "{\"name\": \"foo\", \"age\": 42, \"tags\": [\"a\", \"b\"], "
+              "\"address\": {\"city\": \"Cologne\", \"zip\": \"50668\"}}");
+}
@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MicroBenchmark.h"
+
+#include "Cache/Cache.h"
+#include "Cache/Common.h"
+#include "Cache/Manager.h"
+
+using namespace arangodb;
+using namespace arangodb::benchmarks;
+using namespace arangodb::cache;
+
+namespace {
+uint64_t const CacheLimit = 16 * 1024 * 1024;
+
+// small enough to fit into the cache, so that lookups of these keys hit
+uint64_t const WorkingSet = 16384;
+
+void fill(std::shared_ptr<Cache> const& cache) {
+  for (uint64_t i = 0; i < WorkingSet; ++i) {
+    CachedValue* value =
+        CachedValue::construct(&i, sizeof(uint64_t), &i, sizeof(uint64_t));
+    if (!cache->insert(value).ok()) {
+      delete value;
+    }
+  }
+}
+}
+
+MICRO_BENCHMARK(PlainCache_insert) {
+  Manager manager(nullptr, 4 * CacheLimit);
+  auto cache = manager.createCache(CacheType::Plain, false, CacheLimit);
+
+  state.measure([&](uint64_t i) {
+    uint64_t const key = i % WorkingSet;
+    CachedValue* value =
+        CachedValue::construct(&key, sizeof(uint64_t), &i, sizeof(uint64_t));
+    if (!cache->insert(value).ok()) {
+      delete value;
+    }
+  });
+
+  manager.destroyCache(cache);
+}
+
+MICRO_BENCHMARK(PlainCache_find_hit) {
+  Manager manager(nullptr, 4 * CacheLimit);
+  auto cache = manager.createCache(CacheType::Plain, false, CacheLimit);
+  fill(cache);
+
+  state.measure([&](uint64_t i) {
+    uint64_t const key = (i * 7919) % WorkingSet;
+    doNotOptimize(cache->find(&key, sizeof(uint64_t)).found());
+  });
+
+  manager.destroyCache(cache);
+}
+
+MICRO_BENCHMARK(PlainCache_find_miss) {
+  Manager manager(nullptr, 4 * CacheLimit);
+  auto cache = manager.createCache(CacheType::Plain, false, CacheLimit);
+  fill(cache);
+
+  state.measure([&](uint64_t i) {
+    uint64_t const key = WorkingSet + i;
+    doNotOptimize(cache->find(&key, sizeof(uint64_t)).found());
+  });
+
+  manager.destroyCache(cache);
+}
+
+MICRO_BENCHMARK(PlainCache_remove_insert) {
+  Manager manager(nullptr, 4 * CacheLimit);
+  auto cache = manager.createCache(CacheType::Plain, false, CacheLimit);
+  fill(cache);
+
+  state.measure([&](uint64_t i) {
+    uint64_t const key = (i * 7919) % WorkingSet;
+    cache->remove(&key, sizeof(uint64_t));
+    CachedValue* value =
+        CachedValue::construct(&key, sizeof(uint64_t), &i, sizeof(uint64_t));
+    if (!cache->insert(value).ok()) {
+      delete value;
+    }
+  });
+
+  manager.destroyCache(cache);
+}
@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MicroBenchmark.h"
+
+#include "Basics/StringRef.h"
+#include "MMFiles/MMFilesSkiplist.h"
+#include "RocksDBEngine/RocksDBComparator.h"
+#include "RocksDBEngine/RocksDBKey.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/Parser.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+using namespace arangodb::benchmarks;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   MMFilesSkiplist
+// -----------------------------------------------------------------------------
+
+namespace {
+uint64_t const SkiplistSize = 100000;
+
+int CmpElmElm(void*, uint64_t const* left, uint64_t const* right,
+              MMFilesSkiplistCmpType) {
+  if (*left != *right) {
+    return *left < *right ? -1 : 1;
+  }
+  return 0;
+}
+
+int CmpKeyElm(void*, uint64_t const* left, uint64_t const* right) {
+  if (*left != *right) {
+    return *left < *right ? -1 : 1;
+  }
+  return 0;
+}
+
+void FreeElm(uint64_t*) {}
+
+typedef MMFilesSkiplist<uint64_t, uint64_t> Skiplist;
+
+/// @brief the even numbers below 2 * SkiplistSize in a scrambled order
+std::vector<uint64_t> createValues() {
+  std::vector<uint64_t> values(SkiplistSize);
+  for (uint64_t i = 0; i < SkiplistSize; ++i) {
+    values[i] = ((i * 7919) % SkiplistSize) * 2;
+  }
+  return values;
+}
+}
+
+MICRO_BENCHMARK(MMFilesSkiplist_insert_remove) {
+  auto values = createValues();
+  Skiplist skiplist(CmpElmElm, CmpKeyElm, FreeElm, true, false);
+  for (auto& value : values) {
+    skiplist.insert(nullptr, &value);
+  }
+
+  // odd values are not contained, so the size stays the same
+  uint64_t value;
+  state.measure([&](uint64_t i) {
+    value = ((i * 7919) % SkiplistSize) * 2 + 1;
+    skiplist.insert(nullptr, &value);
+    skiplist.remove(nullptr, &value);
+  });
+}
+
+MICRO_BENCHMARK(MMFilesSkiplist_lookup) {
+  auto values = createValues();
+  Skiplist skiplist(CmpElmElm, CmpKeyElm, FreeElm, true, false);
+  for (auto& value : values) {
+    skiplist.insert(nullptr, &value);
+  }
+
+  state.measure([&](uint64_t i) {
+    doNotOptimize(skiplist.lookup(nullptr, &values[i % SkiplistSize]));
+  });
+}
+
+MICRO_BENCHMARK(MMFilesSkiplist_leftKeyLookup) {
+  auto values = createValues();
+  Skiplist skiplist(CmpElmElm, CmpKeyElm, FreeElm, true, false);
+  for (auto& value : values) {
+    skiplist.insert(nullptr, &value);
+  }
+
+  state.measure([&](uint64_t i) {
+    uint64_t const key = (i * 104729) % (2 * SkiplistSize);
+    doNotOptimize(skiplist.leftKeyLookup(nullptr, &key));
+  });
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        RocksDBKey
+// -----------------------------------------------------------------------------
+
+MICRO_BENCHMARK(RocksDBKey_Document) {
+  state.measure([&](uint64_t i) {
+    RocksDBKey key = RocksDBKey::Document(12345, i);
+    doNotOptimize(key.string().size());
+  });
+}
+
+MICRO_BENCHMARK(RocksDBKey_PrimaryIndexValue) {
+  std::string const primaryKey("customer-0000012345");
+  StringRef const ref(primaryKey);
+
+  state.measure([&](uint64_t) {
+    RocksDBKey key = RocksDBKey::PrimaryIndexValue(12345, ref);
+    doNotOptimize(key.string().size());
+  });
+}
+
+MICRO_BENCHMARK(RocksDBKey_VPackIndexValue) {
+  auto values = VPackParser::fromJson("[\"Cologne\", 50667, true]");
+  VPackSlice const slice = values->slice();
+
+  state.measure([&](uint64_t i) {
+    RocksDBKey key = RocksDBKey::VPackIndexValue(12345, slice, i);
+    doNotOptimize(key.string().size());
+  });
+}
+
+MICRO_BENCHMARK(RocksDBKey_decode_Document) {
+  RocksDBKey const key = RocksDBKey::Document(12345, 67890);
+  rocksdb::Slice const slice(key.string());
+
+  state.measure([&](uint64_t) {
+    doNotOptimize(RocksDBKey::objectId(slice));
+    doNotOptimize(
+        RocksDBKey::revisionId(RocksDBEntryType::Document, slice));
+  });
+}
+
+MICRO_BENCHMARK(RocksDBKey_decode_PrimaryIndexValue) {
+  RocksDBKey const key =
+      RocksDBKey::PrimaryIndexValue(12345, "customer-0000012345");
+  rocksdb::Slice const slice(key.string());
+
+  state.measure([&](uint64_t) {
+    doNotOptimize(RocksDBKey::primaryKey(slice).size());
+  });
+}
+
+MICRO_BENCHMARK(RocksDBVPackComparator_Compare) {
+  auto left = VPackParser::fromJson("[\"Cologne\", 50667, true]");
+  auto right = VPackParser::fromJson("[\"Cologne\", 50668, true]");
+  RocksDBKey const l = RocksDBKey::VPackIndexValue(12345, left->slice(), 1);
+  RocksDBKey const r = RocksDBKey::VPackIndexValue(12345, right->slice(), 2);
+  rocksdb::Slice const ls(l.string());
+  rocksdb::Slice const rs(r.string());
+  RocksDBVPackComparator cmp;
+
+  state.measure([&](uint64_t) { doNotOptimize(cmp.Compare(ls, rs)); });
+}
@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TESTS_BENCHMARKS_MICRO_BENCHMARK_H
+#define TESTS_BENCHMARKS_MICRO_BENCHMARK_H 1
+
+#include "Basics/Common.h"
+
+#include <chrono>
+
+namespace arangodb {
+namespace benchmarks {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief state handed to a benchmark. a benchmark does its setup first and
+/// then calls measure() exactly once, only the loop inside measure() is
+/// timed. the runner calls a benchmark repeatedly with a growing number of
+/// iterations until a run takes long enough to be measured reliably.
+////////////////////////////////////////////////////////////////////////////////
+
+class MicroBenchmarkState {
+ public:
+  explicit MicroBenchmarkState(uint64_t iterations)
+      : _iterations(iterations), _elapsed(0.0) {}
+
+ public:
+  uint64_t iterations() const { return _iterations; }
+
+  /// @brief elapsed time of the measured loop in seconds
+  double elapsed() const { return _elapsed; }
+
+  /// @brief calls op(i) for every iteration i and records the time taken
+  template <typename F>
+  void measure(F&& op) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < _iterations; ++i) {
+      op(i);
+    }
+    _elapsed = std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+  }
+
+ private:
+  uint64_t const _iterations;
+  double _elapsed;
+};
+
+typedef void (*MicroBenchmarkFunction)(MicroBenchmarkState&);
+
+struct MicroBenchmarkEntry {
+  char const* name;
+  MicroBenchmarkFunction function;
+};
+
+/// @brief all benchmarks of the executable, in registration order
+inline std::vector<MicroBenchmarkEntry>& microBenchmarks() {
+  static std::vector<MicroBenchmarkEntry> benchmarks;
+  return benchmarks;
+}
+
+struct MicroBenchmarkRegistrar {
+  MicroBenchmarkRegistrar(char const* name, MicroBenchmarkFunction function) {
+    microBenchmarks().push_back(MicroBenchmarkEntry{name, function});
+  }
+};
+
+/// @brief keeps the compiler from optimizing away the computation of value
+template <typename T>
+inline void doNotOptimize(T const& value) {
+#ifdef _WIN32
+  static volatile char const* sink;
+  sink = reinterpret_cast<char const*>(&value);
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+}  // namespace benchmarks
+}  // namespace arangodb
+
+#define MICRO_BENCHMARK(name)                                         \
+  static void name(arangodb::benchmarks::MicroBenchmarkState&);       \
+  static arangodb::benchmarks::MicroBenchmarkRegistrar name##Registrar( \
+      #name, &name);                                                  \
+  static void name(arangodb::benchmarks::MicroBenchmarkState& state)
+
+#endif
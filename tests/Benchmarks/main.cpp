@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MicroBenchmark.h"
+
+#include "Basics/VelocyPackHelper.h"
+#include "Logger/Logger.h"
+#include "Random/RandomGenerator.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/Iterator.h>
+#include <velocypack/velocypack-aliases.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+using namespace arangodb;
+using namespace arangodb::benchmarks;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs the registered micro benchmarks
+///
+///   --filter <string>      only run benchmarks whose name contains the string
+///   --min-time <seconds>   minimum duration of a single measurement
+///   --repetitions <n>      number of measurements, the median is reported
+///   --json <file>          write the results to the file
+///   --baseline <file>      compare with the results of an earlier --json run
+///   --tolerance <fraction> allowed slowdown against the baseline
+///
+/// the exit code is 1 if a benchmark is slower than its baseline by more
+/// than the tolerance, so that CI can keep the output of the last good run
+/// as the baseline of the next one.
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+struct BenchmarkResult {
+  std::string name;
+  uint64_t iterations;
+  double nsPerOp;
+};
+
+BenchmarkResult run(MicroBenchmarkEntry const& entry, double minTime,
+           size_t repetitions) {
+  // find a number of iterations that takes at least minTime
+  uint64_t iterations = 1;
+  while (true) {
+    MicroBenchmarkState state(iterations);
+    entry.function(state);
+
+    if (state.elapsed() >= minTime || iterations >= (uint64_t(1) << 40)) {
+      break;
+    }
+
+    uint64_t next;
+    if (state.elapsed() < minTime / 100.0) {
+      next = iterations * 100;
+    } else {
+      next = static_cast<uint64_t>(1.2 * iterations * minTime /
+                                   state.elapsed());
+    }
+    iterations = (std::max)(next, iterations + 1);
+  }
+
+  std::vector<double> measurements;
+  for (size_t i = 0; i < repetitions; ++i) {
+    MicroBenchmarkState state(iterations);
+    entry.function(state);
+    measurements.push_back(state.elapsed() * 1.0e9 / iterations);
+  }
+  std::sort(measurements.begin(), measurements.end());
+
+  return BenchmarkResult{entry.name, iterations,
+                         measurements[measurements.size() / 2]};
+}
+
+void usage(char const* argv0) {
+  std::cerr << "usage: " << argv0
+            << " [--filter <string>] [--min-time <seconds>]"
+               " [--repetitions <n>] [--json <file>] [--baseline <file>]"
+               " [--tolerance <fraction>]"
+            << std::endl;
+}
+}
+
+int main(int argc, char* argv[]) {
+  std::string filter;
+  std::string jsonFile;
+  std::string baselineFile;
+  double minTime = 0.2;
+  size_t repetitions = 5;
+  double tolerance = 0.2;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string const arg(argv[i]);
+    if (i + 1 >= argc) {
+      usage(argv[0]);
+      return 2;
+    }
+    std::string const value(argv[++i]);
+
+    if (arg == "--filter") {
+      filter = value;
+    } else if (arg == "--min-time") {
+      minTime = std::stod(value);
+    } else if (arg == "--repetitions") {
+      repetitions = (std::max)(static_cast<size_t>(std::stoul(value)), size_t(1));
+    } else if (arg == "--json") {
+      jsonFile = value;
+    } else if (arg == "--baseline") {
+      baselineFile = value;
+    } else if (arg == "--tolerance") {
+      tolerance = std::stod(value);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  RandomGenerator::initialize(RandomGenerator::RandomType::MERSENNE);
+  Logger::initialize(false);
+
+  std::vector<BenchmarkResult> results;
+  for (auto const& entry : microBenchmarks()) {
+    if (!filter.empty() &&
+        std::string(entry.name).find(filter) == std::string::npos) {
+      continue;
+    }
+    results.push_back(run(entry, minTime, repetitions));
+
+    BenchmarkResult const& result = results.back();
+    std::cout << std::left << std::setw(48) << result.name << std::right
+              << std::setw(14) << std::fixed << std::setprecision(2)
+              << result.nsPerOp << " ns/op" << std::setw(14)
+              << result.iterations << " iterations" << std::endl;
+  }
+
+  int ret = 0;
+
+  if (!jsonFile.empty()) {
+    VPackBuilder builder;
+    builder.openObject();
+    builder.add("benchmarks", VPackValue(VPackValueType::Array));
+    for (auto const& result : results) {
+      builder.openObject();
+      builder.add("name", VPackValue(result.name));
+      builder.add("iterations", VPackValue(result.iterations));
+      builder.add("nsPerOp", VPackValue(result.nsPerOp));
+      builder.close();
+    }
+    builder.close();
+    builder.close();
+
+    if (!basics::VelocyPackHelper::velocyPackToFile(jsonFile, builder.slice(),
+                                                    false)) {
+      std::cerr << "cannot write results to '" << jsonFile << "'"
+                << std::endl;
+      ret = 2;
+    }
+  }
+
+  if (!baselineFile.empty()) {
+    std::shared_ptr<VPackBuilder> baseline;
+    try {
+      baseline = basics::VelocyPackHelper::velocyPackFromFile(baselineFile);
+    } catch (...) {
+    }
+
+    VPackSlice benchmarks;
+    if (baseline != nullptr) {
+      benchmarks = baseline->slice().get("benchmarks");
+    }
+    if (!benchmarks.isArray()) {
+      std::cerr << "cannot read baseline from '" << baselineFile << "'"
+                << std::endl;
+      ret = 2;
+    } else {
+      for (auto const& it : VPackArrayIterator(benchmarks)) {
+        std::string const name = basics::VelocyPackHelper::getStringValue(
+            it, "name", "");
+        double const expected = basics::VelocyPackHelper::getNumericValue<
+            double>(it, "nsPerOp", 0.0);
+
+        auto result = std::find_if(
+            results.begin(), results.end(),
+            [&name](BenchmarkResult const& r) { return r.name == name; });
+        if (result == results.end() || expected <= 0.0) {
+          continue;
+        }
+
+        if (result->nsPerOp > expected * (1.0 + tolerance)) {
+          std::cerr << "regression in " << name << ": " << std::fixed
+                    << std::setprecision(2) << result->nsPerOp
+                    << " ns/op, baseline " << expected << " ns/op"
+                    << std::endl;
+          if (ret == 0) {
+            ret = 1;
+          }
+        }
+      }
+    }
+  }
+
+  Logger::shutdown();
+  return ret;
+}
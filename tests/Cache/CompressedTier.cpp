@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for arangodb::cache::CompressedTier
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Cache/CompressedTier.h"
+#include "Basics/Common.h"
+#include "Cache/CachedValue.h"
+
+#include "catch.hpp"
+
+#include <stdint.h>
+#include <string>
+
+using namespace arangodb::cache;
+
+TEST_CASE("cache::CompressedTier", "[cache]") {
+  SECTION("test that a disabled tier stores nothing") {
+    CompressedTier tier;
+    uint64_t k = 1;
+    std::string v(1024, 'a');
+    CachedValue* cv = CachedValue::construct(&k, sizeof(uint64_t), v.data(),
+                                             v.size());
+
+    REQUIRE(!tier.isEnabled());
+    tier.store(cv);
+    REQUIRE(0ULL == tier.usage());
+    REQUIRE(nullptr == tier.take(&k, sizeof(uint64_t)));
+    delete cv;
+  }
+
+  SECTION("test that stored values can be taken back exactly once") {
+    CompressedTier tier;
+    tier.setLimit(1024 * 1024);
+    uint64_t k = 1;
+    std::string v(1024, 'a');
+    CachedValue* cv = CachedValue::construct(&k, sizeof(uint64_t), v.data(),
+                                             v.size());
+
+    tier.store(cv);
+    REQUIRE(0ULL < tier.usage());
+    REQUIRE(cv->size() > tier.usage());
+
+    CachedValue* copy = tier.take(&k, sizeof(uint64_t));
+    REQUIRE(nullptr != copy);
+    REQUIRE(copy->sameKey(&k, sizeof(uint64_t)));
+    REQUIRE(v.size() == copy->valueSize);
+    REQUIRE(0 == memcmp(v.data(), copy->value(), v.size()));
+    REQUIRE(0ULL == tier.usage());
+    REQUIRE(1ULL == tier.promotions());
+    REQUIRE(nullptr == tier.take(&k, sizeof(uint64_t)));
+
+    delete copy;
+    delete cv;
+  }
+
+  SECTION("test that the tier evicts down to its limit") {
+    CompressedTier tier;
+    tier.setLimit(1024 * 1024);
+    std::string v(1024, 'a');
+    for (uint64_t k = 0; k < 1024; k++) {
+      CachedValue* cv = CachedValue::construct(&k, sizeof(uint64_t), v.data(),
+                                               v.size());
+      tier.store(cv);
+      delete cv;
+    }
+    uint64_t usage = tier.usage();
+    REQUIRE(0ULL < usage);
+
+    tier.setLimit(usage / 2);
+    REQUIRE(usage / 2 >= tier.usage());
+
+    // oldest entries are dropped first
+    uint64_t k = 0;
+    REQUIRE(nullptr == tier.take(&k, sizeof(uint64_t)));
+    k = 1023;
+    CachedValue* copy = tier.take(&k, sizeof(uint64_t));
+    REQUIRE(nullptr != copy);
+    delete copy;
+
+    tier.setLimit(0);
+    REQUIRE(0ULL == tier.usage());
+  }
+}
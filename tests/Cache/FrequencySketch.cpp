@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for arangodb::cache::FrequencySketch
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Cache/FrequencySketch.h"
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include <stdint.h>
+
+using namespace arangodb::cache;
+
+namespace {
+// copied, so that catch does not need a definition of the static member
+uint64_t const maxCount = FrequencySketch::maxCount;
+}
+
+TEST_CASE("cache::FrequencySketch", "[cache]") {
+  SECTION("test allocation size") {
+    // at least one word per row, otherwise rounded up to a power of two
+    REQUIRE(4 * sizeof(std::atomic<uint64_t>) ==
+            FrequencySketch::allocationSize(1));
+    REQUIRE(4 * sizeof(std::atomic<uint64_t>) ==
+            FrequencySketch::allocationSize(16));
+    REQUIRE(4 * 2 * sizeof(std::atomic<uint64_t>) ==
+            FrequencySketch::allocationSize(17));
+    REQUIRE(4 * 256 * sizeof(std::atomic<uint64_t>) ==
+            FrequencySketch::allocationSize(4096));
+  }
+
+  SECTION("test estimates") {
+    FrequencySketch sketch(1024);
+
+    for (uint32_t hash = 1; hash <= 1000; hash++) {
+      REQUIRE(0ULL == sketch.estimate(hash));
+    }
+
+    for (size_t i = 0; i < 5; i++) {
+      sketch.recordAccess(42);
+    }
+    REQUIRE(5ULL == sketch.estimate(42));
+
+    for (size_t i = 0; i < 3; i++) {
+      sketch.recordAccess(43);
+    }
+    REQUIRE(3ULL <= sketch.estimate(43));
+    REQUIRE(5ULL <= sketch.estimate(42));
+
+    // counters saturate
+    for (size_t i = 0; i < 20; i++) {
+      sketch.recordAccess(42);
+    }
+    REQUIRE(maxCount == sketch.estimate(42));
+
+    sketch.clear();
+    REQUIRE(0ULL == sketch.estimate(42));
+    REQUIRE(0ULL == sketch.estimate(43));
+  }
+
+  SECTION("test that estimates never fall below the access counts") {
+    FrequencySketch sketch(256);
+
+    // fewer accesses than the sample size, so nothing is halved
+    for (uint32_t hash = 1; hash <= 200; hash++) {
+      for (uint32_t i = 0; i < hash % 10; i++) {
+        sketch.recordAccess(hash);
+      }
+    }
+    for (uint32_t hash = 1; hash <= 200; hash++) {
+      REQUIRE(static_cast<uint64_t>(hash % 10) <= sketch.estimate(hash));
+    }
+  }
+
+  SECTION("test admission decisions") {
+    FrequencySketch sketch(4096);
+
+    for (size_t i = 0; i < 8; i++) {
+      sketch.recordAccess(1);
+    }
+    for (size_t i = 0; i < 2; i++) {
+      sketch.recordAccess(2);
+    }
+
+    // an entry displaces a candidate only if it was accessed more often
+    REQUIRE(sketch.estimate(1) > sketch.estimate(2));
+    REQUIRE(!(sketch.estimate(2) > sketch.estimate(1)));
+    // an entry that was never accessed never displaces anything
+    REQUIRE(!(sketch.estimate(3) > sketch.estimate(2)));
+    REQUIRE(!(sketch.estimate(3) > sketch.estimate(4)));
+  }
+
+  SECTION("test that counters decay") {
+    FrequencySketch sketch(1024);
+    uint32_t const hot = 42;
+    uint32_t const recent = 43;
+
+    for (size_t i = 0; i < 2 * maxCount; i++) {
+      sketch.recordAccess(hot);
+    }
+    REQUIRE(maxCount == sketch.estimate(hot));
+
+    // other accesses until the counters are halved, which happens after
+    // about 10 * 1024 of them
+    uint32_t other = 1000000;
+    while (sketch.estimate(hot) == maxCount) {
+      sketch.recordAccess(other++);
+      REQUIRE(other < 1000000 + 20 * 1024);
+    }
+    // saturated counters are halved exactly, without bits from their
+    // neighbours
+    REQUIRE(maxCount / 2 == sketch.estimate(hot));
+
+    // an entry accessed after the halving now wins over the formerly hot one
+    for (size_t i = 0; i < 10; i++) {
+      sketch.recordAccess(recent);
+    }
+    REQUIRE(sketch.estimate(recent) > sketch.estimate(hot));
+  }
+}
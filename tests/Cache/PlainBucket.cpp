@@ -197,4 +197,71 @@ TEST_CASE("cache::PlainBucket", "[cache]") {
       delete ptrs[i];
     }
   }
+
+  SECTION("verify that misses are detected without locking") {
+    auto bucket = std::make_unique<PlainBucket>();
+    bool success;
+
+    uint32_t hashes[11] = {
+        1, 2, 3,
+        4, 5, 6,
+        7, 8, 9,
+        10, 11};  // don't have to be real, but should be unique and non-zero
+    uint64_t keys[11] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    uint64_t values[11] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    CachedValue* ptrs[11];
+    for (size_t i = 0; i < 11; i++) {
+      ptrs[i] = CachedValue::construct(&(keys[i]), sizeof(uint64_t),
+                                       &(values[i]), sizeof(uint64_t));
+    }
+
+    // empty bucket
+    for (size_t i = 0; i < 11; i++) {
+      REQUIRE(!bucket->mayContain(hashes[i]));
+    }
+
+    // fill all slots, so that every slot is compared
+    success = bucket->lock(-1LL);
+    REQUIRE(success);
+    for (size_t i = 0; i < 10; i++) {
+      bucket->insert(hashes[i], ptrs[i]);
+    }
+    bucket->unlock();
+    for (size_t i = 0; i < 10; i++) {
+      REQUIRE(bucket->mayContain(hashes[i]));
+    }
+    REQUIRE(!bucket->mayContain(hashes[10]));
+
+    // removed entries are misses
+    success = bucket->lock(-1LL);
+    REQUIRE(success);
+    CachedValue* res = bucket->remove(hashes[9], ptrs[9]->key(), ptrs[9]->keySize);
+    REQUIRE(res == ptrs[9]);
+    res = bucket->remove(hashes[0], ptrs[0]->key(), ptrs[0]->keySize);
+    REQUIRE(res == ptrs[0]);
+    bucket->unlock();
+    REQUIRE(!bucket->mayContain(hashes[0]));
+    REQUIRE(!bucket->mayContain(hashes[9]));
+    REQUIRE(bucket->mayContain(hashes[5]));
+
+    // a locked bucket may be modified concurrently
+    success = bucket->lock(-1LL);
+    REQUIRE(success);
+    REQUIRE(bucket->mayContain(hashes[10]));
+    bucket->unlock();
+    REQUIRE(!bucket->mayContain(hashes[10]));
+
+    // the entries of a migrated bucket are elsewhere
+    success = bucket->lock(-1LL);
+    REQUIRE(success);
+    bucket->_state.toggleFlag(State::Flag::migrated);
+    REQUIRE(bucket->isMigrated());
+    bucket->unlock();
+    REQUIRE(bucket->mayContain(hashes[10]));
+
+    // cleanup
+    for (size_t i = 0; i < 11; i++) {
+      delete ptrs[i];
+    }
+  }
 }
@@ -161,6 +161,150 @@ TEST_CASE("cache::PlainCache", "[cache][!hide][longRunning]") {
     manager.destroyCache(cache);
   }
 
+  SECTION("test that batch insertion and lookup work as expected") {
+    uint64_t cacheLimit = 256 * 1024;
+    Manager manager(nullptr, 4 * cacheLimit);
+    auto cache = manager.createCache(CacheType::Plain, false, cacheLimit);
+
+    std::vector<uint64_t> keys;
+    for (uint64_t i = 0; i < 2048; i++) {
+      keys.emplace_back(i);
+    }
+
+    // insert the first half only
+    std::vector<CachedValue*> values;
+    for (uint64_t i = 0; i < 1024; i++) {
+      values.emplace_back(CachedValue::construct(&keys[i], sizeof(uint64_t),
+                                                 &keys[i], sizeof(uint64_t)));
+    }
+    std::vector<Result> results;
+    cache->insertBatch(values, results);
+    REQUIRE(results.size() == values.size());
+
+    std::vector<std::pair<void const*, uint32_t>> lookups;
+    for (auto const& key : keys) {
+      lookups.emplace_back(&key, static_cast<uint32_t>(sizeof(uint64_t)));
+    }
+    std::vector<Finding> findings;
+    cache->findBatch(lookups, findings);
+    REQUIRE(findings.size() == lookups.size());
+    for (uint64_t i = 0; i < 2048; i++) {
+      if (i < 1024 && results[i].ok()) {
+        REQUIRE(findings[i].found());
+        REQUIRE(0 == memcmp(findings[i].value()->value(), &i,
+                            sizeof(uint64_t)));
+      } else {
+        REQUIRE(!findings[i].found());
+      }
+    }
+    findings.clear();
+
+    for (size_t i = 0; i < values.size(); i++) {
+      if (results[i].fail()) {
+        delete values[i];
+      }
+    }
+
+    manager.destroyCache(cache);
+  }
+
+  SECTION("test that evicted values are promoted from the compressed tier") {
+    uint64_t cacheLimit = 256 * 1024;
+    Manager manager(nullptr, 4 * cacheLimit);
+    auto cache = manager.createCache(CacheType::Plain, false, cacheLimit);
+    cache->setCompressedTierLimit(16 * 1024 * 1024);
+
+    std::string payload(128, 'x');
+    std::vector<bool> inserted(8192, false);
+    for (uint64_t i = 0; i < 8192; i++) {
+      // a miss first, so that the admission filter lets the key displace
+      // older entries
+      REQUIRE(!cache->find(&i, sizeof(uint64_t)).found());
+      CachedValue* value = CachedValue::construct(&i, sizeof(uint64_t),
+                                                  payload.data(),
+                                                  payload.size());
+      auto status = cache->insert(value);
+      if (status.ok()) {
+        inserted[i] = true;
+      } else {
+        delete value;
+      }
+    }
+
+    for (uint64_t i = 0; i < 8192; i++) {
+      auto f = cache->find(&i, sizeof(uint64_t));
+      if (f.found()) {
+        REQUIRE(inserted[i]);
+        REQUIRE(payload.size() == f.value()->valueSize);
+        REQUIRE(0 == memcmp(payload.data(), f.value()->value(),
+                            payload.size()));
+      }
+    }
+    REQUIRE(0ULL < cache->statistics().compressedPromotions);
+
+    // removal also drops the compressed copy
+    for (uint64_t i = 0; i < 8192; i++) {
+      auto status = cache->remove(&i, sizeof(uint64_t));
+      REQUIRE(status.ok());
+      auto f = cache->find(&i, sizeof(uint64_t));
+      REQUIRE(!f.found());
+    }
+    REQUIRE(0ULL == cache->statistics().compressedUsage);
+
+    manager.destroyCache(cache);
+  }
+
+  SECTION("test that the admission filter protects frequently used entries") {
+    uint64_t cacheLimit = 256 * 1024;
+    Manager manager(nullptr, 4 * cacheLimit);
+    auto cache = manager.createCache(CacheType::Plain, false, cacheLimit);
+
+    // hot entries, looked up repeatedly
+    for (uint64_t i = 0; i < 128; i++) {
+      CachedValue* value =
+          CachedValue::construct(&i, sizeof(uint64_t), &i, sizeof(uint64_t));
+      auto status = cache->insert(value);
+      REQUIRE(status.ok());
+      for (size_t j = 0; j < 5; j++) {
+        REQUIRE(cache->find(&i, sizeof(uint64_t)).found());
+      }
+    }
+
+    // entries that are never looked up cannot displace the hot ones once
+    // their buckets are full
+    for (uint64_t i = 1024; i < 1024 + 16384; i++) {
+      CachedValue* value =
+          CachedValue::construct(&i, sizeof(uint64_t), &i, sizeof(uint64_t));
+      auto status = cache->insert(value);
+      if (status.fail()) {
+        delete value;
+      }
+    }
+    REQUIRE(0ULL < cache->statistics().rejections);
+    for (uint64_t i = 0; i < 128; i++) {
+      REQUIRE(cache->find(&i, sizeof(uint64_t)).found());
+    }
+
+    // new entries that were looked up more often than the hot ones are
+    // admitted. each one is removed again, so that they do not compete with
+    // each other
+    uint64_t rejections = cache->statistics().rejections;
+    for (uint64_t i = 1024 + 16384; i < 1024 + 16384 + 1024; i++) {
+      for (size_t j = 0; j < 10; j++) {
+        REQUIRE(!cache->find(&i, sizeof(uint64_t)).found());
+      }
+      CachedValue* value =
+          CachedValue::construct(&i, sizeof(uint64_t), &i, sizeof(uint64_t));
+      auto status = cache->insert(value);
+      REQUIRE(status.ok());
+      REQUIRE(cache->find(&i, sizeof(uint64_t)).found());
+      REQUIRE(cache->remove(&i, sizeof(uint64_t)).ok());
+    }
+    REQUIRE(rejections == cache->statistics().rejections);
+
+    manager.destroyCache(cache);
+  }
+
   SECTION("verify that cache can indeed grow when it runs out of space") {
     uint64_t minimumUsage = 1024 * 1024;
     MockScheduler scheduler(4);
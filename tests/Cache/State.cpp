@@ -31,6 +31,8 @@
 #include "catch.hpp"
 
 #include <stdint.h>
+#include <atomic>
+#include <thread>
 
 using namespace arangodb::cache;
 
@@ -96,4 +98,116 @@ TEST_CASE("cache::State", "[cache]") {
     REQUIRE(!state.isSet(State::Flag::migrated));
     state.unlock();
   }
+
+  SECTION("test snapshot and validate") {
+    State state;
+    bool success;
+
+    uint32_t initial = state.snapshot();
+    REQUIRE(!State::isSet(initial, State::Flag::locked));
+    REQUIRE(state.validate(initial));
+    REQUIRE(state.validate(initial));
+
+    // locking invalidates the snapshot
+    success = state.lock();
+    REQUIRE(success);
+    uint32_t locked = state.snapshot();
+    REQUIRE(State::isSet(locked, State::Flag::locked));
+    REQUIRE(!state.validate(initial));
+    REQUIRE(state.validate(locked));
+
+    // unlocking does not restore the old state, the version has changed
+    state.unlock();
+    uint32_t unlocked = state.snapshot();
+    REQUIRE(!State::isSet(unlocked, State::Flag::locked));
+    REQUIRE(initial != unlocked);
+    REQUIRE(!state.validate(initial));
+    REQUIRE(!state.validate(locked));
+    REQUIRE(state.validate(unlocked));
+
+    // flags are visible in snapshots
+    success = state.lock();
+    REQUIRE(success);
+    state.toggleFlag(State::Flag::migrated);
+    state.unlock();
+    uint32_t migrated = state.snapshot();
+    REQUIRE(State::isSet(migrated, State::Flag::migrated));
+    REQUIRE(!State::isSet(migrated, State::Flag::locked));
+    REQUIRE(!state.validate(unlocked));
+
+    // clear resets the flags but keeps counting versions
+    success = state.lock();
+    REQUIRE(success);
+    state.clear();
+    REQUIRE(state.isLocked());
+    REQUIRE(!state.isSet(State::Flag::migrated));
+    state.unlock();
+    uint32_t cleared = state.snapshot();
+    REQUIRE(!State::isSet(cleared, State::Flag::migrated));
+    REQUIRE(!State::isSet(cleared, State::Flag::locked));
+    for (uint32_t old : {initial, unlocked, migrated}) {
+      REQUIRE(old != cleared);
+    }
+  }
+
+  SECTION("test version wrap-around") {
+    State state;
+    bool success;
+
+    success = state.lock();
+    REQUIRE(success);
+    state.toggleFlag(State::Flag::migrated);
+    state.unlock();
+    uint32_t initial = state.snapshot();
+
+    // the version has 22 bits, after 2^22 unlocks it is back where it started
+    uint32_t repeated = 0;
+    for (uint32_t i = 0; i < (1U << 22); i++) {
+      state.lock();
+      state.unlock();
+      if (state.snapshot() == initial) {
+        repeated++;
+      }
+    }
+    REQUIRE(1UL == repeated);
+    REQUIRE(initial == state.snapshot());
+    REQUIRE(!state.isLocked());
+    REQUIRE(state.isSet(State::Flag::migrated));
+  }
+
+  SECTION("test optimistic reads with a concurrent writer") {
+    State state;
+    // written together under the lock, so a validated read sees equal values
+    std::atomic<uint64_t> first(0);
+    std::atomic<uint64_t> second(0);
+    std::atomic<bool> done(false);
+
+    std::thread writer([&]() {
+      for (uint64_t i = 1; i <= 100000; i++) {
+        state.lock();
+        first.store(i, std::memory_order_relaxed);
+        second.store(i, std::memory_order_relaxed);
+        state.unlock();
+      }
+      done.store(true);
+    });
+
+    while (!done.load()) {
+      uint32_t snapshot = state.snapshot();
+      if (State::isSet(snapshot, State::Flag::locked)) {
+        continue;
+      }
+      uint64_t a = first.load(std::memory_order_relaxed);
+      uint64_t b = second.load(std::memory_order_relaxed);
+      if (state.validate(snapshot)) {
+        REQUIRE(a == b);
+      }
+    }
+    writer.join();
+
+    uint32_t snapshot = state.snapshot();
+    REQUIRE(state.validate(snapshot));
+    REQUIRE(100000ULL == first.load());
+    REQUIRE(100000ULL == second.load());
+  }
 }
@@ -305,4 +305,67 @@ TEST_CASE("cache::TransactionalBucket", "[cache]") {
       delete ptrs[i];
     }
   }
+
+  SECTION("verify that misses are detected without locking") {
+    auto bucket = std::make_unique<TransactionalBucket>();
+    bool success;
+
+    uint32_t hashes[9] = {
+        1, 2, 3, 4, 5, 6, 7,
+        8, 9};  // don't have to be real, but should be unique and non-zero
+    uint64_t keys[9] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    uint64_t values[9] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    CachedValue* ptrs[9];
+    for (size_t i = 0; i < 9; i++) {
+      ptrs[i] = CachedValue::construct(&(keys[i]), sizeof(uint64_t),
+                                       &(values[i]), sizeof(uint64_t));
+    }
+
+    // empty bucket
+    for (size_t i = 0; i < 9; i++) {
+      REQUIRE(!bucket->mayContain(hashes[i]));
+    }
+
+    // fill all slots, so that every slot is compared
+    success = bucket->lock(-1LL);
+    REQUIRE(success);
+    for (size_t i = 0; i < 8; i++) {
+      bucket->insert(hashes[i], ptrs[i]);
+    }
+    bucket->unlock();
+    for (size_t i = 0; i < 8; i++) {
+      REQUIRE(bucket->mayContain(hashes[i]));
+    }
+    REQUIRE(!bucket->mayContain(hashes[8]));
+
+    // blacklisting removes the entry, and a miss is correct for it
+    success = bucket->lock(-1LL);
+    REQUIRE(success);
+    bucket->updateBlacklistTerm(1ULL);
+    bucket->blacklist(hashes[7], ptrs[7]->key(), ptrs[7]->keySize);
+    REQUIRE(bucket->isBlacklisted(hashes[7]));
+    bucket->unlock();
+    REQUIRE(!bucket->mayContain(hashes[7]));
+    REQUIRE(bucket->mayContain(hashes[3]));
+
+    // a locked bucket may be modified concurrently
+    success = bucket->lock(-1LL);
+    REQUIRE(success);
+    REQUIRE(bucket->mayContain(hashes[8]));
+    bucket->unlock();
+    REQUIRE(!bucket->mayContain(hashes[8]));
+
+    // the entries of a migrated bucket are elsewhere
+    success = bucket->lock(-1LL);
+    REQUIRE(success);
+    bucket->_state.toggleFlag(State::Flag::migrated);
+    REQUIRE(bucket->isMigrated());
+    bucket->unlock();
+    REQUIRE(bucket->mayContain(hashes[8]));
+
+    // cleanup
+    for (size_t i = 0; i < 9; i++) {
+      delete ptrs[i];
+    }
+  }
 }
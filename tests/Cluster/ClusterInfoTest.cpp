@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "Cluster/ClusterInfo.h"
+
+#include <velocypack/Parser.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+
+namespace {
+size_t count(char const* value, bool includeEqual) {
+  auto boundaries = VPackParser::fromJson("[10, 20, \"m\"]");
+  return ClusterInfo::countShardBoundaries(
+      boundaries->slice(), VPackParser::fromJson(value)->slice(),
+      includeEqual);
+}
+}
+
+TEST_CASE("ClusterInfo range sharding", "[cluster]") {
+  /// @brief values are assigned to the shard of the range they fall into
+  SECTION("test_responsible_position") {
+    CHECK(count("null", true) == 0);
+    CHECK(count("9.5", true) == 0);
+    CHECK(count("10", true) == 1);
+    CHECK(count("19", true) == 1);
+    CHECK(count("20", true) == 2);
+    CHECK(count("\"a\"", true) == 2);
+    CHECK(count("\"m\"", true) == 3);
+    CHECK(count("[]", true) == 3);
+  }
+
+  /// @brief an exclusive upper bound does not need the shard starting at it
+  SECTION("test_exclusive_upper_bound") {
+    CHECK(count("10", false) == 0);
+    CHECK(count("11", false) == 1);
+    CHECK(count("\"m\"", false) == 2);
+  }
+}
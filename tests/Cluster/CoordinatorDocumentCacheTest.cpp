@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "Cluster/CoordinatorDocumentCache.h"
+
+#include <velocypack/Parser.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+
+TEST_CASE("CoordinatorDocumentCache", "[cluster]") {
+  CoordinatorDocumentCache::initialize(60.0);
+  CoordinatorDocumentCache* cache = CoordinatorDocumentCache::instance();
+  REQUIRE(cache != nullptr);
+
+  /// @brief a ticket stays current while the key is not written to
+  SECTION("test_ticket_current") {
+    auto ticket = cache->ticket("1", StringRef("a"));
+    CHECK(cache->isCurrent("1", StringRef("a"), ticket));
+  }
+
+  /// @brief a read that started before a write must not store its result
+  SECTION("test_write_during_read") {
+    auto ticket = cache->ticket("1", StringRef("a"));
+    cache->invalidate("1", StringRef("a"));
+    CHECK_FALSE(cache->isCurrent("1", StringRef("a"), ticket));
+
+    // reads that start after the write may store their result
+    auto next = cache->ticket("1", StringRef("a"));
+    CHECK(cache->isCurrent("1", StringRef("a"), next));
+  }
+
+  /// @brief writes given as documents or document arrays count as well
+  SECTION("test_write_documents") {
+    auto ticket = cache->ticket("1", StringRef("b"));
+    auto documents =
+        VPackParser::fromJson("[{\"_key\": \"c\"}, {\"_key\": \"b\"}]");
+    cache->invalidate("1", documents->slice());
+    CHECK_FALSE(cache->isCurrent("1", StringRef("b"), ticket));
+  }
+
+  /// @brief a truncate makes all tickets outdated
+  SECTION("test_truncate_during_read") {
+    auto ticket = cache->ticket("2", StringRef("x"));
+    cache->invalidateAll();
+    CHECK_FALSE(cache->isCurrent("2", StringRef("x"), ticket));
+  }
+
+  CoordinatorDocumentCache::cleanup();
+}
@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "Cluster/DBServerAgencySync.h"
+
+#include <velocypack/Parser.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+
+namespace {
+std::unordered_map<std::string, uint64_t> fingerprints(char const* plan,
+                                                       char const* current) {
+  std::unordered_map<std::string, uint64_t> result;
+  DBServerAgencySync::fingerprints(VPackParser::fromJson(plan)->slice(),
+                                   VPackParser::fromJson(current)->slice(),
+                                   "PRMR-1", result);
+  return result;
+}
+
+char const* plan =
+    "{\"Databases\": {\"a\": {\"id\": \"1\"}, \"b\": {\"id\": \"2\"}}, "
+    "\"Collections\": {"
+    "\"a\": {\"100\": {\"name\": \"c\", \"shards\": "
+    "{\"s1\": [\"PRMR-1\"], \"s2\": [\"PRMR-2\"]}}}, "
+    "\"b\": {\"200\": {\"name\": \"d\", \"shards\": {\"s3\": [\"PRMR-2\"]}}}}}";
+}
+
+TEST_CASE("DBServerAgencySync fingerprints", "[cluster]") {
+  auto const base = fingerprints(plan, "{}");
+  REQUIRE(base.size() == 2);
+
+  SECTION("collections on other servers do not matter") {
+    auto other = fingerprints(
+        "{\"Databases\": {\"a\": {\"id\": \"1\"}, \"b\": {\"id\": \"2\"}}, "
+        "\"Collections\": {"
+        "\"a\": {\"100\": {\"name\": \"c\", \"shards\": "
+        "{\"s1\": [\"PRMR-1\"], \"s2\": [\"PRMR-2\"]}}}, "
+        "\"b\": {\"200\": {\"name\": \"d\", \"shards\": "
+        "{\"s3\": [\"PRMR-2\"]}}, "
+        "\"201\": {\"name\": \"e\", \"shards\": {\"s4\": [\"PRMR-3\"]}}}}}",
+        "{}");
+    CHECK(other == base);
+  }
+
+  SECTION("changed collections on this server change the database") {
+    auto other = fingerprints(
+        "{\"Databases\": {\"a\": {\"id\": \"1\"}, \"b\": {\"id\": \"2\"}}, "
+        "\"Collections\": {"
+        "\"a\": {\"100\": {\"name\": \"c\", \"waitForSync\": true, "
+        "\"shards\": {\"s1\": [\"PRMR-1\"], \"s2\": [\"PRMR-2\"]}}}, "
+        "\"b\": {\"200\": {\"name\": \"d\", \"shards\": "
+        "{\"s3\": [\"PRMR-2\"]}}}}}",
+        "{}");
+    CHECK(other["a"] != base.at("a"));
+    CHECK(other["b"] == base.at("b"));
+  }
+
+  SECTION("the Current of our shards changes the database") {
+    auto other = fingerprints(
+        plan,
+        "{\"Collections\": {\"a\": {\"100\": {\"s1\": "
+        "{\"servers\": [\"PRMR-1\"]}, \"s2\": {\"servers\": [\"PRMR-2\"]}}}}}");
+    auto again = fingerprints(
+        plan,
+        "{\"Collections\": {\"a\": {\"100\": {\"s1\": "
+        "{\"servers\": [\"PRMR-1\"]}, \"s2\": {\"servers\": []}}}}}");
+    CHECK(other["a"] != base.at("a"));
+    CHECK(again["a"] == other["a"]);
+  }
+}
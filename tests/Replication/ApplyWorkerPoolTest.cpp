@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "Replication/ApplyWorkerPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+
+using namespace arangodb;
+
+TEST_CASE("ApplyWorkerPool", "[replication]") {
+  /// @brief with a parallelism of 1 the work runs on the calling thread only
+  SECTION("test_sequential") {
+    ApplyWorkerPool pool(1);
+    CHECK(pool.parallelism() == 1);
+
+    std::thread::id id;
+    size_t calls = 0;
+    pool.run([&]() {
+      id = std::this_thread::get_id();
+      ++calls;
+    }, 4);
+    CHECK(calls == 1);
+    CHECK(id == std::this_thread::get_id());
+  }
+
+  /// @brief all items are taken exactly once, and the same threads are
+  /// used for consecutive runs
+  SECTION("test_items") {
+    ApplyWorkerPool pool(4);
+    CHECK(pool.parallelism() == 4);
+
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+
+    for (size_t i = 0; i < 50; ++i) {
+      std::vector<std::atomic<int>> items(100);
+      for (auto& item : items) {
+        item = 0;
+      }
+      std::atomic<size_t> next(0);
+
+      pool.run([&]() {
+        {
+          std::lock_guard<std::mutex> locker(mutex);
+          threads.emplace(std::this_thread::get_id());
+        }
+        size_t current;
+        while ((current = next++) < items.size()) {
+          ++items[current];
+        }
+      }, items.size());
+
+      for (auto const& item : items) {
+        CHECK(item.load() == 1);
+      }
+    }
+    // the calling thread and at most 3 pool threads, however many runs
+    CHECK(threads.size() <= 4);
+  }
+
+  /// @brief the requested number of threads works concurrently
+  SECTION("test_concurrent") {
+    ApplyWorkerPool pool(4);
+
+    std::atomic<size_t> entered(0);
+    std::atomic<size_t> calls(0);
+    bool together = true;
+
+    pool.run([&]() {
+      ++calls;
+      ++entered;
+      auto end = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+      while (entered.load() < 3) {
+        if (std::chrono::steady_clock::now() > end) {
+          together = false;
+          break;
+        }
+        std::this_thread::yield();
+      }
+    }, 3);
+
+    CHECK(together);
+    CHECK(calls.load() == 3);
+  }
+
+  /// @brief an exception of the calling thread is rethrown after the pool
+  /// threads have returned, and the pool can be used again
+  SECTION("test_exception") {
+    ApplyWorkerPool pool(2);
+    std::thread::id caller = std::this_thread::get_id();
+
+    CHECK_THROWS(pool.run([&]() {
+      if (std::this_thread::get_id() == caller) {
+        throw std::runtime_error("failed");
+      }
+    }, 2));
+
+    std::atomic<size_t> calls(0);
+    pool.run([&]() { ++calls; }, 1);
+    CHECK(calls.load() == 1);
+  }
+}
@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "RestHandler/RestCursorHandler.h"
+#include "Transaction/Options.h"
+
+#include <velocypack/Parser.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+
+TEST_CASE("RestCursorHandler", "[rest]") {
+  /// @brief only optimistic queries are retried
+  SECTION("test_retry_optimistic") {
+    auto optimistic = VPackParser::fromJson("{\"optimistic\":true}");
+    auto plain = VPackParser::fromJson("{}");
+    CHECK(RestCursorHandler::maxQueryAttempts(optimistic->slice(), false) ==
+          RestCursorHandler::MaxOptimisticAttempts);
+    CHECK(RestCursorHandler::maxQueryAttempts(plain->slice(), false) == 1);
+  }
+
+  /// @brief coordinators never retry, other DB servers may have committed
+  /// their part of the query already
+  SECTION("test_no_retry_on_coordinator") {
+    auto optimistic = VPackParser::fromJson("{\"optimistic\":true}");
+    CHECK(RestCursorHandler::maxQueryAttempts(optimistic->slice(), true) == 1);
+  }
+
+  /// @brief the option reaches the transaction, which then does not commit
+  /// intermediately
+  SECTION("test_transaction_option") {
+    auto optimistic = VPackParser::fromJson("{\"optimistic\":true}");
+    transaction::Options options;
+    CHECK_FALSE(options.optimistic);
+    options.fromVelocyPack(optimistic->slice());
+    CHECK(options.optimistic);
+  }
+}
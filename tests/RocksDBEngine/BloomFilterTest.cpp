@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include "RocksDBEngine/RocksDBBloomFilter.h"
+
+#include <random>
+
+using namespace arangodb;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+TEST_CASE("RocksDBBloomFilter", "[rocksdbbloomfilter]") {
+  /// @brief inserted values are always found, others rarely
+  SECTION("test_insert_lookup") {
+    std::mt19937_64 rng(42);
+    RocksDBBloomFilter filter(10000);
+
+    std::vector<uint64_t> values;
+    for (size_t i = 0; i < 10000; ++i) {
+      values.push_back(rng());
+      filter.insert(values.back());
+    }
+    CHECK_FALSE(filter.isFull());
+
+    for (auto const& value : values) {
+      CHECK(filter.mayContain(value));
+    }
+
+    size_t falsePositives = 0;
+    for (size_t i = 0; i < 100000; ++i) {
+      if (filter.mayContain(rng())) {
+        ++falsePositives;
+      }
+    }
+    CHECK(falsePositives < 3000);
+  }
+
+  /// @brief a grown filter still contains all values
+  SECTION("test_grow") {
+    std::mt19937_64 rng(23);
+    std::unique_ptr<RocksDBBloomFilter> filter(new RocksDBBloomFilter(100));
+    uint64_t const capacity = filter->capacity();
+
+    std::vector<uint64_t> values;
+    for (size_t i = 0; i < 5000; ++i) {
+      values.push_back(rng());
+      filter->insert(values.back());
+      if (filter->isFull()) {
+        filter = filter->grow();
+      }
+    }
+
+    CHECK(filter->capacity() > capacity);
+    CHECK_FALSE(filter->isFull());
+    for (auto const& value : values) {
+      CHECK(filter->mayContain(value));
+    }
+  }
+}
@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include "RocksDBEngine/RocksDBBulkLoadMethods.h"
+
+#include <velocypack/Parser.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+TEST_CASE("RocksDBBulkLoadMethods", "[rocksdbbulkload]") {
+  /// @brief an empty, exclusively locked and unreplicated collection can be
+  /// bulk loaded
+  SECTION("test_preconditions_ok") {
+    CHECK(RocksDBBulkLoadMethods::checkCollection("test", true, 0, 0, 0).ok());
+  }
+
+  /// @brief a shared write lock would let concurrent inserts through
+  SECTION("test_requires_exclusive") {
+    Result res = RocksDBBulkLoadMethods::checkCollection("test", false, 0, 0, 0);
+    CHECK(res.errorNumber() == TRI_ERROR_BAD_PARAMETER);
+  }
+
+  /// @brief existing documents would be overwritten without unique checks
+  SECTION("test_requires_empty") {
+    Result res = RocksDBBulkLoadMethods::checkCollection("test", true, 1, 0, 0);
+    CHECK(res.errorNumber() == TRI_ERROR_BAD_PARAMETER);
+  }
+
+  /// @brief followers and replication clients would never see the data
+  SECTION("test_requires_unreplicated") {
+    CHECK(RocksDBBulkLoadMethods::checkCollection("test", true, 0, 1, 0)
+              .fail());
+    CHECK(RocksDBBulkLoadMethods::checkCollection("test", true, 0, 0, 2)
+              .fail());
+  }
+
+  /// @brief an interrupted ingest removes the data, a finished one recounts
+  SECTION("test_recovery_action") {
+    auto ingesting = VPackParser::fromJson(
+        "{\"database\":\"1\",\"collections\":[\"42\"],\"state\":\"ingesting\"}");
+    auto ingested = VPackParser::fromJson(
+        "{\"database\":\"1\",\"collections\":[\"42\"],\"state\":\"ingested\"}");
+    auto unknown = VPackParser::fromJson("{\"state\":\"foo\"}");
+    auto invalid = VPackParser::fromJson("[]");
+
+    CHECK(RocksDBBulkLoadMethods::recoveryAction(ingesting->slice()) ==
+          RocksDBBulkLoadMethods::Recovery::REMOVE);
+    CHECK(RocksDBBulkLoadMethods::recoveryAction(ingested->slice()) ==
+          RocksDBBulkLoadMethods::Recovery::RECOUNT);
+    CHECK(RocksDBBulkLoadMethods::recoveryAction(unknown->slice()) ==
+          RocksDBBulkLoadMethods::Recovery::NONE);
+    CHECK(RocksDBBulkLoadMethods::recoveryAction(invalid->slice()) ==
+          RocksDBBulkLoadMethods::Recovery::NONE);
+  }
+}
@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include "RocksDBEngine/RocksDBColumnFamily.h"
+
+using namespace arangodb;
+
+TEST_CASE("RocksDBColumnFamily", "[rocksdb]") {
+  /// @brief the object id of a collection is found from the name of its
+  /// dedicated column family
+  SECTION("test_dedicated_name") {
+    std::string const name = RocksDBColumnFamily::dedicatedName(4711);
+    CHECK(RocksDBColumnFamily::dedicatedObjectId(name) == 4711);
+    CHECK(RocksDBColumnFamily::dedicatedObjectId("documents") == 0);
+    CHECK(RocksDBColumnFamily::dedicatedObjectId("default") == 0);
+  }
+
+  /// @brief column families of collections that do not exist are orphaned
+  SECTION("test_orphaned") {
+    std::vector<uint64_t> const dedicated{1, 2, 3};
+    CHECK(RocksDBColumnFamily::orphaned(dedicated, {1, 2, 3}).empty());
+    CHECK(RocksDBColumnFamily::orphaned(dedicated, {1, 3, 4}) ==
+          std::vector<uint64_t>{2});
+    CHECK(RocksDBColumnFamily::orphaned(dedicated, {}) == dedicated);
+    CHECK(RocksDBColumnFamily::orphaned({}, {1}).empty());
+  }
+}
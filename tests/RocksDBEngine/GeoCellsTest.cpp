@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include "RocksDBEngine/RocksDBGeoCells.h"
+#include "RocksDBEngine/RocksDBKey.h"
+#include "RocksDBEngine/RocksDBTypes.h"
+
+#include <cmath>
+#include <random>
+
+using namespace arangodb;
+using namespace arangodb::rocksdbengine;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private helpers
+// -----------------------------------------------------------------------------
+
+static double Distance(double lat1, double lon1, double lat2, double lon2) {
+  double const toRad = M_PI / 180.0;
+  double dLat = (lat2 - lat1) * toRad;
+  double dLon = (lon2 - lon1) * toRad;
+  double a = std::sin(dLat / 2) * std::sin(dLat / 2) +
+             std::cos(lat1 * toRad) * std::cos(lat2 * toRad) *
+                 std::sin(dLon / 2) * std::sin(dLon / 2);
+  return 2.0 * geocells::EarthRadius * std::asin(std::sqrt((std::min)(a, 1.0)));
+}
+
+static bool Covered(std::vector<geocells::CellRange> const& ranges,
+                    uint64_t id) {
+  for (auto const& r : ranges) {
+    if (r.first <= id && id <= r.second) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+/// @brief test geo cell coverings
+TEST_CASE("RocksDBGeoCellsTest", "[rocksdbgeocells]") {
+  /// @brief neighbouring points share the prefix of their cell ids
+  SECTION("test_cell_locality") {
+    uint64_t a = geocells::cellId(50.9375, 6.9603);
+    uint64_t b = geocells::cellId(50.9376, 6.9604);
+    uint64_t c = geocells::cellId(-33.8688, 151.2093);
+
+    CHECK((a >> 40) == (b >> 40));
+    CHECK((a >> 40) != (c >> 40));
+    CHECK(geocells::cellId(50.9375, 6.9603) == a);
+  }
+
+  /// @brief all points within the radius are covered
+  SECTION("test_cover_cap") {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> lat(-90.0, 90.0);
+    std::uniform_real_distribution<double> lon(-180.0, 180.0);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+
+    double const radii[] = {10.0, 1000.0, 100000.0, 2000000.0};
+    for (int i = 0; i < 200; ++i) {
+      double cLat = lat(rng);
+      double cLon = lon(rng);
+      for (double radius : radii) {
+        auto ranges = geocells::coverCap(cLat, cLon, radius, 16);
+        REQUIRE(!ranges.empty());
+        for (size_t j = 1; j < ranges.size(); ++j) {
+          CHECK(ranges[j - 1].second < ranges[j].first);
+        }
+
+        double span = radius / geocells::EarthRadius * 180.0 / M_PI;
+        for (int k = 0; k < 50; ++k) {
+          double pLat = (std::max)(-90.0, (std::min)(90.0, cLat + unit(rng) * span));
+          double pLon = cLon + unit(rng) * span * 4.0;
+          if (pLon > 180.0) {
+            pLon -= 360.0;
+          } else if (pLon < -180.0) {
+            pLon += 360.0;
+          }
+          if (pLon < -180.0 || pLon > 180.0 ||
+              Distance(cLat, cLon, pLat, pLon) > radius) {
+            continue;
+          }
+          CHECK(Covered(ranges, geocells::cellId(pLat, pLon)));
+        }
+      }
+    }
+  }
+
+  /// @brief the poles and the antimeridian are covered
+  SECTION("test_cover_cap_edges") {
+    auto north = geocells::coverCap(89.9999, 0.0, 1000.0, 16);
+    CHECK(Covered(north, geocells::cellId(89.9999, 180.0)));
+    CHECK(Covered(north, geocells::cellId(90.0, -90.0)));
+
+    auto dateline = geocells::coverCap(0.0, 179.9999, 1000.0, 16);
+    CHECK(Covered(dateline, geocells::cellId(0.0, -179.9999)));
+    CHECK(Covered(dateline, geocells::cellId(0.0, 179.9999)));
+  }
+
+  /// @brief ranges are merged and subtracted
+  SECTION("test_merge_subtract") {
+    std::vector<geocells::CellRange> ranges{{10, 20}, {0, 5}, {6, 8}, {15, 30}};
+    geocells::mergeRanges(ranges);
+    REQUIRE(ranges.size() == 2);
+    CHECK(ranges[0] == geocells::CellRange(0, 8));
+    CHECK(ranges[1] == geocells::CellRange(10, 30));
+
+    std::vector<geocells::CellRange> exclude{{3, 4}, {10, 12}, {29, 40}};
+    auto rest = geocells::subtractRanges(ranges, exclude);
+    REQUIRE(rest.size() == 3);
+    CHECK(rest[0] == geocells::CellRange(0, 2));
+    CHECK(rest[1] == geocells::CellRange(5, 8));
+    CHECK(rest[2] == geocells::CellRange(13, 28));
+
+    CHECK(geocells::subtractRanges(ranges, ranges).empty());
+  }
+
+  /// @brief cell index keys sort by cell id within an index
+  SECTION("test_cell_key") {
+    RocksDBKey key1 = RocksDBKey::GeoCellIndexValue(5, 0x0102, 7);
+    RocksDBKey key2 = RocksDBKey::GeoCellIndexValue(5, 0x0201, 1);
+    auto const& s1 = key1.string();
+
+    CHECK(s1.size() == 3 * sizeof(uint64_t));
+    CHECK(s1 == std::string("\5\0\0\0\0\0\0\0\0\0\0\0\0\0\1\2\7\0\0\0\0\0\0\0",
+                            24));
+    CHECK(key1.string() < key2.string());
+    CHECK(RocksDBKey::geoCellId(key1.string()) == 0x0102);
+    CHECK(RocksDBKey::revisionId(RocksDBEntryType::GeoCellIndexValue,
+                                 key1.string()) == 7);
+  }
+}
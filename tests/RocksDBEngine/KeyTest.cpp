@@ -37,6 +37,8 @@
 #include "RocksDBEngine/RocksDBPrefixExtractor.h"
 #include "RocksDBEngine/RocksDBTypes.h"
 
+#include <velocypack/Parser.h>
+
 using namespace arangodb;
 
 // -----------------------------------------------------------------------------
@@ -398,4 +400,52 @@ TEST_CASE("RocksDBKeyBoundsTest", "[rocksdbkeybounds]") {
     CHECK(cmp->Compare(key6.string(), key7.string()) < 0);
     CHECK(cmp->Compare(key4.string(), key7.string()) < 0);
   }
+
+  /// @brief test that the comparator orders index values like
+  /// VelocyPackHelper::compare
+  SECTION("test_vpack_comparator_order") {
+    auto cmp = std::make_unique<RocksDBVPackComparator>();
+
+    std::vector<std::shared_ptr<VPackBuilder>> values;
+    for (char const* json :
+         {"[null]", "[false]", "[true]", "[-5]", "[-1.5]", "[0]", "[1]",
+          "[2.5]", "[300]", "[18446744073709551615]", "[\"A\"]",
+          "[\"a\"]", "[\"b\"]", "[\"b\", 1]", "[[1, 2]]", "[{}]"}) {
+      values.emplace_back(VPackParser::fromJson(json));
+    }
+
+    for (auto const& l : values) {
+      for (auto const& r : values) {
+        int expected = basics::VelocyPackHelper::compare(l->slice(),
+                                                         r->slice(), true);
+        RocksDBKey lKey = RocksDBKey::VPackIndexValue(1, l->slice(), 33);
+        RocksDBKey rKey = RocksDBKey::VPackIndexValue(1, r->slice(), 33);
+        int actual = cmp->Compare(lKey.string(), rKey.string());
+        CHECK((expected < 0) == (actual < 0));
+        CHECK((expected == 0) == (actual == 0));
+      }
+    }
+  }
+
+  /// @brief read committed scans resume after the last _key returned. the
+  /// primary index entry of a document keeps its position when the
+  /// document is updated, its document entry does not
+  SECTION("test_scan_resume_position") {
+    RocksDBKeyBounds bounds = RocksDBKeyBounds::PrimaryIndex(7);
+    RocksDBKey a = RocksDBKey::PrimaryIndexValue(7, "a");
+    RocksDBKey b = RocksDBKey::PrimaryIndexValue(7, "b");
+    RocksDBKey c = RocksDBKey::PrimaryIndexValue(7, "c");
+
+    CHECK(bounds.start().compare(a.string()) < 0);
+    CHECK(a.string().compare(b.string()) < 0);
+    CHECK(b.string().compare(c.string()) < 0);
+    CHECK(rocksdb::Slice(c.string()).compare(bounds.end()) < 0);
+
+    // an update of "b" writes a new document entry, which a scan resuming by
+    // document key would return again
+    RocksDBKey before = RocksDBKey::Document(7, 1000);
+    RocksDBKey after = RocksDBKey::Document(7, 1001);
+    CHECK(before.string() != after.string());
+    CHECK(RocksDBKey::PrimaryIndexValue(7, "b").string() == b.string());
+  }
 }
@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include "Basics/Exceptions.h"
+#include "RocksDBEngine/RocksDBKeyBounds.h"
+#include "RocksDBEngine/RocksDBParallelScan.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+
+namespace {
+/// @brief a reader producing the given number of documents, the document
+/// with revision id r is the number r
+RocksDBParallelScan::RangeReader numbers(TRI_voc_rid_t first, size_t count) {
+  auto next = std::make_shared<TRI_voc_rid_t>(first);
+  TRI_voc_rid_t const end = first + count;
+
+  return [next, end](RocksDBParallelScan::Chunk& chunk) -> bool {
+    while (*next < end) {
+      if (chunk.documents.size() >= RocksDBParallelScan::ChunkDocuments) {
+        return true;
+      }
+      VPackBuilder builder;
+      builder.add(VPackValue(*next));
+      chunk.documents.emplace_back(*next, chunk.data.size());
+      chunk.data.append(builder.slice().startAs<char>(),
+                        builder.slice().byteSize());
+      ++*next;
+    }
+    return false;
+  };
+}
+
+/// @brief takes all documents of the scan, checking that they are numbered
+/// as their revision ids
+std::vector<TRI_voc_rid_t> drain(RocksDBParallelScan& scan) {
+  std::vector<TRI_voc_rid_t> result;
+  TRI_voc_rid_t revisionId;
+  VPackSlice document;
+  while (scan.next(revisionId, document)) {
+    CHECK(document.getNumber<TRI_voc_rid_t>() == revisionId);
+    result.emplace_back(revisionId);
+  }
+  return result;
+}
+}
+
+TEST_CASE("RocksDBParallelScan", "[rocksdb]") {
+  /// @brief the ranges are produced one after the other, each in its order
+  SECTION("test_order") {
+    std::vector<RocksDBParallelScan::RangeReader> readers;
+    readers.emplace_back(numbers(0, 2500));
+    readers.emplace_back(numbers(10000, 1));
+    readers.emplace_back(numbers(20000, 3000));
+    RocksDBParallelScan scan(std::move(readers), 2);
+
+    std::vector<TRI_voc_rid_t> expected;
+    for (TRI_voc_rid_t i = 0; i < 2500; ++i) {
+      expected.emplace_back(i);
+    }
+    expected.emplace_back(10000);
+    for (TRI_voc_rid_t i = 20000; i < 23000; ++i) {
+      expected.emplace_back(i);
+    }
+    CHECK(drain(scan) == expected);
+
+    TRI_voc_rid_t revisionId;
+    VPackSlice document;
+    CHECK_FALSE(scan.next(revisionId, document));
+  }
+
+  /// @brief empty ranges are passed over
+  SECTION("test_empty_ranges") {
+    std::vector<RocksDBParallelScan::RangeReader> readers;
+    readers.emplace_back(numbers(0, 0));
+    readers.emplace_back(numbers(5, 2));
+    readers.emplace_back(numbers(9, 0));
+    RocksDBParallelScan scan(std::move(readers), 1);
+
+    CHECK(drain(scan) == (std::vector<TRI_voc_rid_t>{5, 6}));
+  }
+
+  /// @brief the error of a range is thrown once the documents read before
+  /// it have been produced
+  SECTION("test_error") {
+    auto chunks = std::make_shared<size_t>(0);
+    auto inner = numbers(100, 5000);
+
+    std::vector<RocksDBParallelScan::RangeReader> readers;
+    readers.emplace_back(numbers(0, 10));
+    readers.emplace_back([chunks, inner](RocksDBParallelScan::Chunk& chunk) {
+      if (++*chunks > 1) {
+        THROW_ARANGO_EXCEPTION(TRI_ERROR_INTERNAL);
+      }
+      return inner(chunk);
+    });
+    readers.emplace_back(numbers(10000, 10));
+    RocksDBParallelScan scan(std::move(readers), 2);
+
+    TRI_voc_rid_t revisionId;
+    VPackSlice document;
+    size_t count = 0;
+    try {
+      while (scan.next(revisionId, document)) {
+        ++count;
+      }
+      CHECK(false);
+    } catch (basics::Exception const& ex) {
+      CHECK(ex.code() == TRI_ERROR_INTERNAL);
+    }
+    CHECK(count == 10 + RocksDBParallelScan::ChunkDocuments);
+  }
+
+  /// @brief destroying the scan stops readers that have not finished
+  SECTION("test_stop") {
+    std::vector<RocksDBParallelScan::RangeReader> readers;
+    for (size_t i = 0; i < 4; ++i) {
+      readers.emplace_back(numbers(i * 1000000, 1000000));
+    }
+    RocksDBParallelScan scan(std::move(readers), 2);
+
+    TRI_voc_rid_t revisionId;
+    VPackSlice document;
+    REQUIRE(scan.next(revisionId, document));
+    CHECK(revisionId == 0);
+  }
+
+  /// @brief the borders of the ranges are ordered and cover the bounds
+  SECTION("test_split") {
+    RocksDBKeyBounds const bounds = RocksDBKeyBounds::CollectionDocuments(42);
+
+    auto borders = RocksDBParallelScan::split(bounds, 4);
+    REQUIRE(borders.size() == 5);
+    CHECK(borders.front() == bounds.start().ToString());
+    CHECK(borders.back() == bounds.end().ToString());
+    for (size_t i = 1; i < borders.size(); ++i) {
+      CHECK(borders[i - 1] < borders[i]);
+    }
+    CHECK(static_cast<uint8_t>(borders[2].back()) == 128);
+
+    CHECK(RocksDBParallelScan::split(bounds, 0).size() == 2);
+    CHECK(RocksDBParallelScan::split(bounds, 1).size() == 2);
+    CHECK(RocksDBParallelScan::split(bounds, 1000).size() == 257);
+  }
+}
@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include "Basics/HybridLogicalClock.h"
+#include "RocksDBEngine/RocksDBKey.h"
+#include "RocksDBEngine/RocksDBTtl.h"
+#include "RocksDBEngine/RocksDBValue.h"
+
+using namespace arangodb;
+
+namespace {
+uint64_t const CollectionId = 4711;
+uint64_t const IndexId = 4712;
+
+/// @brief a revision written at the given time in milliseconds
+TRI_voc_rid_t revision(uint64_t time) {
+  return basics::HybridLogicalClock::assembleTimeStamp(time, 1);
+}
+
+TRI_voc_rid_t oldRevision() { return revision(1000); }
+
+TRI_voc_rid_t newRevision() {
+  return revision(static_cast<uint64_t>(TRI_microtime() * 1000.0));
+}
+
+uint64_t removals() {
+  auto removed = RocksDBTtl::stealRemovals();
+  auto it = removed.find(CollectionId);
+  return it == removed.end() ? 0 : it->second;
+}
+}
+
+TEST_CASE("RocksDBTtl", "[rocksdb]") {
+  RocksDBTtl::add(CollectionId, 60);
+  RocksDBTtl::add(IndexId, 60);
+  RocksDBTtl::stealRemovals();
+
+  bool live = true;
+  RocksDBTtlCompactionFilter documents(
+      true, [&live](uint64_t, rocksdb::Slice const&) { return live; });
+  RocksDBTtlCompactionFilter primary(
+      false, [&live](uint64_t, rocksdb::Slice const&) { return live; });
+
+  /// @brief expired live documents are dropped and counted
+  SECTION("test_expired_live") {
+    RocksDBKey key = RocksDBKey::Document(CollectionId, oldRevision());
+    CHECK(documents.Filter(0, key.string(), rocksdb::Slice(), nullptr,
+                           nullptr));
+    CHECK(removals() == 1);
+  }
+
+  /// @brief old revisions and removed documents are dropped, but they were
+  /// subtracted from the count already
+  SECTION("test_expired_removed") {
+    live = false;
+    RocksDBKey key = RocksDBKey::Document(CollectionId, oldRevision());
+    CHECK(documents.Filter(0, key.string(), rocksdb::Slice(), nullptr,
+                           nullptr));
+    CHECK(removals() == 0);
+  }
+
+  /// @brief documents that have not expired yet are kept
+  SECTION("test_not_expired") {
+    RocksDBKey key = RocksDBKey::Document(CollectionId, newRevision());
+    CHECK_FALSE(documents.Filter(0, key.string(), rocksdb::Slice(), nullptr,
+                                 nullptr));
+    RocksDBKey other = RocksDBKey::Document(CollectionId + 100, oldRevision());
+    CHECK_FALSE(documents.Filter(0, other.string(), rocksdb::Slice(), nullptr,
+                                 nullptr));
+    CHECK(removals() == 0);
+  }
+
+  /// @brief primary index entries are dropped but not counted
+  SECTION("test_primary_index") {
+    RocksDBKey key = RocksDBKey::PrimaryIndexValue(IndexId, "abc");
+    RocksDBValue value = RocksDBValue::PrimaryIndexValue(oldRevision());
+    CHECK(primary.Filter(0, key.string(), value.string(), nullptr, nullptr));
+    CHECK(removals() == 0);
+  }
+
+  RocksDBTtl::remove(CollectionId);
+  RocksDBTtl::remove(IndexId);
+}
@@ -0,0 +1,210 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include "Views/AggregateView.h"
+#include "Views/AggregateViewState.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/Iterator.h>
+#include <velocypack/Parser.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+
+namespace {
+AggregateDefinition createDefinition() {
+  auto properties = VPackParser::fromJson(
+      "{\"collection\": \"orders\", \"groupBy\": [\"country\"], "
+      "\"aggregates\": {\"count\": {\"function\": \"COUNT\"}, "
+      "\"total\": {\"function\": \"SUM\", \"attribute\": \"amount\"}, "
+      "\"smallest\": {\"function\": \"MIN\", \"attribute\": \"amount\"}, "
+      "\"average\": {\"function\": \"AVG\", \"attribute\": \"amount\"}}}");
+
+  AggregateDefinition definition;
+  REQUIRE(AggregateDefinition::fromVelocyPack(properties->slice(), definition)
+              .ok());
+  return definition;
+}
+
+void apply(AggregateViewState& state, AggregateDefinition const& definition,
+           char const* json, bool add) {
+  auto document = VPackParser::fromJson(json);
+  AggregateViewState::Contribution contribution;
+  AggregateViewState::contribution(definition, document->slice(),
+                                   contribution);
+  if (add) {
+    state.add(contribution);
+  } else {
+    state.remove(contribution);
+  }
+}
+
+VPackSlice findGroup(VPackBuilder const& result, std::string const& country) {
+  for (auto const& group : VPackArrayIterator(result.slice())) {
+    if (group.get("country").copyString() == country) {
+      return group;
+    }
+  }
+  return VPackSlice::noneSlice();
+}
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+TEST_CASE("AggregateViewState", "[views]") {
+  /// @brief invalid definitions are rejected
+  SECTION("test_definition") {
+    AggregateDefinition definition;
+    CHECK(AggregateDefinition::fromVelocyPack(
+              VPackParser::fromJson("{\"aggregates\": {}}")->slice(),
+              definition)
+              .fail());
+    CHECK(AggregateDefinition::fromVelocyPack(
+              VPackParser::fromJson(
+                  "{\"collection\": \"c\", \"aggregates\": "
+                  "{\"a\": {\"function\": \"MEDIAN\", \"attribute\": \"x\"}}}")
+                  ->slice(),
+              definition)
+              .fail());
+    CHECK(AggregateDefinition::fromVelocyPack(
+              VPackParser::fromJson(
+                  "{\"collection\": \"c\", \"aggregates\": "
+                  "{\"a\": {\"function\": \"SUM\"}}}")
+                  ->slice(),
+              definition)
+              .fail());
+  }
+
+  /// @brief added and removed documents are reflected in the groups
+  SECTION("test_add_remove") {
+    AggregateDefinition definition = createDefinition();
+    AggregateViewState state(definition);
+
+    apply(state, definition, "{\"country\": \"DE\", \"amount\": 10}", true);
+    apply(state, definition, "{\"country\": \"DE\", \"amount\": 5}", true);
+    apply(state, definition, "{\"country\": \"DE\", \"amount\": \"x\"}", true);
+    apply(state, definition, "{\"country\": \"FR\", \"amount\": 1}", true);
+    CHECK(state.numberOfGroups() == 2);
+
+    VPackBuilder result;
+    state.toVelocyPack(result);
+    VPackSlice de = findGroup(result, "DE");
+    REQUIRE(de.isObject());
+    CHECK(de.get("count").getNumber<uint64_t>() == 3);
+    CHECK(de.get("total").getNumber<double>() == 15.0);
+    CHECK(de.get("smallest").getNumber<double>() == 5.0);
+    CHECK(de.get("average").getNumber<double>() == 7.5);
+
+    apply(state, definition, "{\"country\": \"DE\", \"amount\": 5}", false);
+    result.clear();
+    state.toVelocyPack(result);
+    de = findGroup(result, "DE");
+    REQUIRE(de.isObject());
+    CHECK(de.get("count").getNumber<uint64_t>() == 2);
+    CHECK(de.get("total").getNumber<double>() == 10.0);
+    CHECK(de.get("smallest").getNumber<double>() == 10.0);
+
+    apply(state, definition, "{\"country\": \"FR\", \"amount\": 1}", false);
+    CHECK(state.numberOfGroups() == 1);
+  }
+
+  /// @brief numbers of different types end up in the same group
+  SECTION("test_number_groups") {
+    auto properties = VPackParser::fromJson(
+        "{\"collection\": \"c\", \"groupBy\": [\"value\"], "
+        "\"aggregates\": {\"count\": {\"function\": \"COUNT\"}}}");
+    AggregateDefinition definition;
+    REQUIRE(
+        AggregateDefinition::fromVelocyPack(properties->slice(), definition)
+            .ok());
+    AggregateViewState state(definition);
+
+    apply(state, definition, "{\"value\": 1}", true);
+    apply(state, definition, "{\"value\": 1.0}", true);
+    apply(state, definition, "{}", true);
+    CHECK(state.numberOfGroups() == 2);
+  }
+
+  /// @brief adding and removing documents does not make the sums drift
+  SECTION("test_sum_drift") {
+    AggregateDefinition definition = createDefinition();
+    AggregateViewState state(definition);
+
+    apply(state, definition, "{\"country\": \"DE\", \"amount\": 1}", true);
+    apply(state, definition, "{\"country\": \"DE\", \"amount\": 1e17}",
+          true);
+    apply(state, definition, "{\"country\": \"DE\", \"amount\": 0.5}", true);
+    apply(state, definition, "{\"country\": \"DE\", \"amount\": 1e300}",
+          true);
+    apply(state, definition, "{\"country\": \"DE\", \"amount\": 1e17}",
+          false);
+    apply(state, definition, "{\"country\": \"DE\", \"amount\": 1e300}",
+          false);
+
+    for (int i = 0; i < 1000; ++i) {
+      apply(state, definition, "{\"country\": \"DE\", \"amount\": 0.1}",
+            true);
+    }
+    for (int i = 0; i < 1000; ++i) {
+      apply(state, definition, "{\"country\": \"DE\", \"amount\": 0.1}",
+            false);
+    }
+
+    VPackBuilder result;
+    state.toVelocyPack(result);
+    VPackSlice de = findGroup(result, "DE");
+    REQUIRE(de.isObject());
+    CHECK(de.get("count").getNumber<uint64_t>() == 2);
+    CHECK(de.get("total").getNumber<double>() == 1.5);
+    CHECK(de.get("average").getNumber<double>() == 0.75);
+  }
+
+  /// @brief changes are forgotten once applied, so the changes applied by an
+  /// intermediate commit are not applied again by the final commit
+  SECTION("test_apply_intermediate") {
+    auto view = std::make_shared<AggregateView::Materialization>(
+        createDefinition());
+    view->valid = true;
+
+    AggregateViewChanges changes;
+    auto first = VPackParser::fromJson("{\"country\": \"DE\", \"amount\": 2}");
+    changes.track(view, VPackSlice::noneSlice(), first->slice());
+    changes.apply();
+
+    auto second =
+        VPackParser::fromJson("{\"country\": \"DE\", \"amount\": 3}");
+    changes.track(view, VPackSlice::noneSlice(), second->slice());
+    changes.apply();
+
+    VPackBuilder result;
+    view->state->toVelocyPack(result);
+    VPackSlice de = findGroup(result, "DE");
+    REQUIRE(de.isObject());
+    CHECK(de.get("count").getNumber<uint64_t>() == 2);
+    CHECK(de.get("total").getNumber<double>() == 5.0);
+  }
+}
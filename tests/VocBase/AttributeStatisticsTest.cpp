@@ -0,0 +1,284 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include "VocBase/AttributeStatistics.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/velocypack-aliases.h>
+
+using namespace arangodb;
+
+namespace {
+/// @brief a value for the hash functions
+VPackBuilder value(std::string const& v) {
+  VPackBuilder builder;
+  builder.add(VPackValue(v));
+  return builder;
+}
+
+/// @brief 1000 documents: status is "a" in 500 of them, "b" in 300 and
+/// unique in the others. unique is different in all documents. sparse is
+/// set in 100 documents, null in 100 and missing in the others
+void sample(AttributeStatistics& statistics) {
+  for (size_t i = 0; i < 1000; ++i) {
+    VPackBuilder document;
+    document.openObject();
+    if (i < 500) {
+      document.add("status", VPackValue("a"));
+    } else if (i < 800) {
+      document.add("status", VPackValue("b"));
+    } else {
+      document.add("status", VPackValue("u" + std::to_string(i)));
+    }
+    document.add("unique", VPackValue(i));
+    if (i % 10 == 0) {
+      document.add("sparse", VPackValue(i % 3));
+    } else if (i % 10 == 1) {
+      document.add("sparse", VPackValue(VPackValueType::Null));
+    }
+    document.close();
+    statistics.add(document.slice());
+  }
+}
+}
+
+TEST_CASE("HyperLogLog", "[statistics]") {
+  /// @brief an empty sketch estimates no values
+  SECTION("test_empty") {
+    HyperLogLog sketch;
+    CHECK(sketch.estimate() == 0.0);
+  }
+
+  /// @brief the estimates are close to the number of distinct values, and
+  /// duplicates are not counted
+  SECTION("test_estimate") {
+    for (size_t n : {10, 100, 1000, 10000, 100000}) {
+      HyperLogLog sketch;
+      for (size_t i = 0; i < n; ++i) {
+        uint64_t hash =
+            value("value" + std::to_string(i)).slice().normalizedHash();
+        sketch.add(hash);
+        sketch.add(hash);
+      }
+      double const estimate = sketch.estimate();
+      CHECK(estimate > 0.8 * n);
+      CHECK(estimate < 1.2 * n);
+    }
+  }
+
+  /// @brief a sketch is restored from its buckets, input of the wrong size
+  /// is ignored
+  SECTION("test_restore") {
+    HyperLogLog sketch;
+    for (uint64_t i = 0; i < 1000; ++i) {
+      sketch.add(value(std::to_string(i)).slice().normalizedHash());
+    }
+
+    HyperLogLog restored;
+    restored.restore(sketch.buckets(), HyperLogLog::NumBuckets);
+    CHECK(restored.estimate() == sketch.estimate());
+
+    HyperLogLog ignored;
+    ignored.restore(sketch.buckets(), HyperLogLog::NumBuckets - 1);
+    CHECK(ignored.estimate() == 0.0);
+  }
+}
+
+TEST_CASE("AttributeStatistics", "[statistics]") {
+  /// @brief without samples or for unknown attributes nothing is estimated
+  SECTION("test_unknown") {
+    AttributeStatistics statistics;
+    double result;
+    CHECK_FALSE(statistics.equalitySelectivity("status", value("a").slice(),
+                                               result));
+    CHECK_FALSE(statistics.distinctValues("status", result));
+
+    sample(statistics);
+    statistics.finish(1000);
+    CHECK(statistics.numberOfSamples() == 1000);
+    CHECK(statistics.numberOfDocuments() == 1000);
+    CHECK_FALSE(statistics.equalitySelectivity("missing", value("a").slice(),
+                                               result));
+    CHECK_FALSE(statistics.distinctValues("missing", result));
+  }
+
+  /// @brief most common values are estimated by their share of the sample
+  SECTION("test_common_values") {
+    AttributeStatistics statistics;
+    sample(statistics);
+    statistics.finish(1000);
+
+    double result;
+    REQUIRE(statistics.equalitySelectivity("status", value("a").slice(),
+                                           result));
+    CHECK(result == Approx(0.5));
+    REQUIRE(statistics.equalitySelectivity("status", value("b").slice(),
+                                           result));
+    CHECK(result == Approx(0.3));
+  }
+
+  /// @brief other values share the documents without a common value
+  SECTION("test_rare_values") {
+    AttributeStatistics statistics;
+    sample(statistics);
+    statistics.finish(1000);
+
+    double result;
+    REQUIRE(statistics.equalitySelectivity("status", value("u900").slice(),
+                                           result));
+    // 200 documents with about 200 distinct values
+    CHECK(result > 0.0008);
+    CHECK(result < 0.0013);
+
+    double unknown;
+    REQUIRE(statistics.equalitySelectivity("status", VPackSlice::noneSlice(),
+                                           unknown));
+    // all 1000 documents over about 202 distinct values
+    CHECK(unknown > 1.0 / 250);
+    CHECK(unknown < 1.0 / 170);
+  }
+
+  /// @brief null matches the documents with a null or without a value
+  SECTION("test_null") {
+    AttributeStatistics statistics;
+    sample(statistics);
+    statistics.finish(1000);
+
+    double result;
+    REQUIRE(statistics.equalitySelectivity("sparse", VPackSlice::nullSlice(),
+                                           result));
+    CHECK(result == Approx(0.9));
+    REQUIRE(statistics.equalitySelectivity("sparse", value("x").slice(),
+                                           result));
+    CHECK(result <= 0.1);
+
+    REQUIRE(statistics.distinctValues("sparse", result));
+    CHECK(result == Approx(3.0).epsilon(0.1));
+  }
+
+  /// @brief an attribute unique in the sample is assumed to be unique in
+  /// the whole collection
+  SECTION("test_unique") {
+    AttributeStatistics statistics;
+    sample(statistics);
+    statistics.finish(50000);
+
+    double result;
+    REQUIRE(statistics.distinctValues("unique", result));
+    CHECK(result == Approx(50000.0));
+
+    REQUIRE(statistics.equalitySelectivity("unique", VPackSlice::noneSlice(),
+                                           result));
+    CHECK(result == Approx(1.0 / 50000.0));
+
+    REQUIRE(statistics.distinctValues("status", result));
+    CHECK(result > 170.0);
+    CHECK(result < 250.0);
+  }
+
+  /// @brief the estimates are at least one document of the collection
+  SECTION("test_minimum") {
+    AttributeStatistics statistics;
+    sample(statistics);
+    statistics.finish(100);
+
+    double result;
+    REQUIRE(statistics.equalitySelectivity("status", value("u900").slice(),
+                                           result));
+    CHECK(result == Approx(0.01));
+  }
+
+  /// @brief only the most common values and attributes up to the limits are
+  /// kept
+  SECTION("test_limits") {
+    AttributeStatistics statistics;
+    for (size_t i = 0; i < 100; ++i) {
+      VPackBuilder document;
+      document.openObject();
+      for (size_t j = 0; j < AttributeStatistics::MaxAttributes + 10; ++j) {
+        document.add("a" + std::to_string(j), VPackValue(i % 20));
+      }
+      document.close();
+      statistics.add(document.slice());
+    }
+    statistics.finish(100);
+
+    size_t known = 0;
+    for (size_t j = 0; j < AttributeStatistics::MaxAttributes + 10; ++j) {
+      double result;
+      if (statistics.distinctValues("a" + std::to_string(j), result)) {
+        ++known;
+      }
+    }
+    CHECK(known == AttributeStatistics::MaxAttributes);
+
+    // 20 values with 5 occurrences each, but only 8 of them are kept as
+    // common values. the others are estimated from the rest
+    VPackBuilder builder;
+    statistics.toVelocyPack(builder);
+    CHECK(builder.slice().get("attributes").get("a0").get("common").length() ==
+          AttributeStatistics::MaxCommonValues);
+    for (size_t i = 0; i < 20; ++i) {
+      VPackBuilder v;
+      v.add(VPackValue(i));
+      double result;
+      REQUIRE(statistics.equalitySelectivity("a0", v.slice(), result));
+      CHECK(result == Approx(0.05).epsilon(0.2));
+    }
+  }
+
+  /// @brief statistics restored from VelocyPack give the same estimates
+  SECTION("test_velocypack") {
+    AttributeStatistics statistics;
+    sample(statistics);
+    statistics.finish(5000);
+
+    VPackBuilder builder;
+    statistics.toVelocyPack(builder);
+    AttributeStatistics restored(builder.slice());
+
+    CHECK(restored.numberOfSamples() == 1000);
+    CHECK(restored.numberOfDocuments() == 5000);
+    VPackBuilder a = value("a");
+    VPackBuilder u900 = value("u900");
+    for (std::string const& attribute : {"status", "unique", "sparse"}) {
+      for (VPackSlice v : {a.slice(), u900.slice(), VPackSlice::nullSlice(),
+                           VPackSlice::noneSlice()}) {
+        double expected;
+        double result;
+        REQUIRE(statistics.equalitySelectivity(attribute, v, expected));
+        REQUIRE(restored.equalitySelectivity(attribute, v, result));
+        CHECK(result == expected);
+      }
+      double expected;
+      double result;
+      REQUIRE(statistics.distinctValues(attribute, expected));
+      REQUIRE(restored.distinctValues(attribute, result));
+      CHECK(result == expected);
+    }
+
+    CHECK_THROWS(AttributeStatistics(VPackSlice::nullSlice()));
+  }
+}
@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include "VocBase/AuthCache.h"
+
+using namespace arangodb;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+TEST_CASE("AuthCache", "[authcache]") {
+  /// @brief stored entries are found until they are removed
+  SECTION("test_put_get_remove") {
+    AuthCache<int> cache(1024);
+    int value = 0;
+
+    CHECK_FALSE(cache.get("foo", value));
+
+    cache.put("foo", 42, cache.generation());
+    REQUIRE(cache.get("foo", value));
+    CHECK(value == 42);
+
+    cache.put("foo", 23, cache.generation());
+    REQUIRE(cache.get("foo", value));
+    CHECK(value == 23);
+
+    cache.remove("foo");
+    CHECK_FALSE(cache.get("foo", value));
+  }
+
+  /// @brief results computed before a clear are not stored
+  SECTION("test_generation") {
+    AuthCache<int> cache(1024);
+    int value = 0;
+
+    uint64_t const generation = cache.generation();
+    cache.put("foo", 1, generation);
+    cache.clear();
+    CHECK_FALSE(cache.get("foo", value));
+
+    cache.put("bar", 2, generation);
+    CHECK_FALSE(cache.get("bar", value));
+
+    cache.put("bar", 3, cache.generation());
+    REQUIRE(cache.get("bar", value));
+    CHECK(value == 3);
+  }
+
+  /// @brief the cache does not grow beyond its size
+  SECTION("test_eviction") {
+    AuthCache<int> cache(AuthCache<int>::NumberOfShards * 4);
+
+    for (int i = 0; i < 10000; ++i) {
+      cache.put("key" + std::to_string(i), i, cache.generation());
+    }
+
+    size_t found = 0;
+    for (int i = 0; i < 10000; ++i) {
+      int value = 0;
+      if (cache.get("key" + std::to_string(i), value)) {
+        CHECK(value == i);
+        ++found;
+      }
+    }
+    CHECK(found <= AuthCache<int>::NumberOfShards * 4);
+    CHECK(found > 0);
+  }
+}
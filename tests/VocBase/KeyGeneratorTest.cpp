@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2017 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "catch.hpp"
+
+#include "Basics/StringUtils.h"
+#include "VocBase/KeyGenerator.h"
+
+#include <velocypack/Builder.h>
+#include <velocypack/Parser.h>
+#include <velocypack/velocypack-aliases.h>
+
+#include <thread>
+
+using namespace arangodb;
+
+namespace {
+std::unique_ptr<KeyGenerator> createGenerator(char const* json) {
+  auto options = VPackParser::fromJson(json);
+  return std::unique_ptr<KeyGenerator>(KeyGenerator::factory(options->slice()));
+}
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+TEST_CASE("KeyGenerator", "[keygenerator]") {
+  /// @brief padded keys have a fixed length and sort like their ticks
+  SECTION("test_padded_order") {
+    auto generator = createGenerator("{\"type\": \"padded\"}");
+
+    std::string last;
+    for (size_t i = 0; i < 1000; ++i) {
+      std::string key = generator->generate();
+      CHECK(key.size() == PaddedKeyGenerator::KeyLength);
+      CHECK(key > last);
+      last = key;
+    }
+  }
+
+  /// @brief generated keys are greater than tracked ones
+  SECTION("test_padded_track") {
+    auto generator = createGenerator("{\"type\": \"padded\"}");
+
+    std::string const tracked("00ff000000000000");
+    generator->track(tracked.data(), tracked.size());
+    CHECK(generator->generate() > tracked);
+  }
+
+  /// @brief keys taken from reserved blocks are unique across threads and
+  /// ascending within each thread
+  SECTION("test_reserve_blocks") {
+    auto generator =
+        createGenerator("{\"type\": \"traditional\", \"reserveBlocks\": true}");
+
+    size_t const numThreads = 8;
+    size_t const numKeys = 10000;
+    std::vector<std::vector<uint64_t>> keys(numThreads);
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < numThreads; ++t) {
+      threads.emplace_back([&generator, &keys, t, numKeys]() {
+        for (size_t i = 0; i < numKeys; ++i) {
+          keys[t].push_back(
+              basics::StringUtils::uint64(generator->generate()));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    std::vector<uint64_t> all;
+    for (auto const& k : keys) {
+      CHECK(std::is_sorted(k.begin(), k.end()));
+      all.insert(all.end(), k.begin(), k.end());
+    }
+    std::sort(all.begin(), all.end());
+    CHECK(std::adjacent_find(all.begin(), all.end()) == all.end());
+  }
+
+  /// @brief tracked keys are not generated again with reserved blocks
+  SECTION("test_reserve_blocks_track") {
+    auto generator =
+        createGenerator("{\"type\": \"traditional\", \"reserveBlocks\": true}");
+
+    uint64_t const first = basics::StringUtils::uint64(generator->generate());
+    generator->trackValue(first + 10);
+    CHECK(basics::StringUtils::uint64(generator->generate()) > first + 10);
+  }
+}